@@ -13,6 +13,7 @@
 
 #include <memory>
 
+#include "absl/types/optional.h"
 #include "api/audio/audio_frame.h"
 #include "rtc_base/refcount.h"
 
@@ -35,6 +36,14 @@ class AudioMixer : public rtc::RefCountInterface {
       kError,   // The audio_frame will not be used.
     };
 
+    // The level of received audio, as signaled by the RFC 6464 audio level
+    // header extension.
+    struct AudioLevel {
+      // The level in -dBov, from 0 (loudest) to 127 (silence).
+      int level_dbov = 127;
+      bool voice_activity = false;
+    };
+
     // Overwrites |audio_frame|. The data_ field is overwritten with
     // 10 ms of new audio (either 1 or 2 interleaved channels) at
     // |sample_rate_hz|. All fields in |audio_frame| must be updated.
@@ -48,6 +57,13 @@ class AudioMixer : public rtc::RefCountInterface {
     // with this sample rate or higher will not cause quality loss.
     virtual int PreferredSampleRate() const = 0;
 
+    // Returns the level of the most recently received audio, which is known
+    // before the audio is decoded and lets a mixer choose which sources to
+    // ask for audio. Returns nothing if the level is unknown.
+    virtual absl::optional<AudioLevel> ReceivedAudioLevel() const {
+      return absl::nullopt;
+    }
+
     virtual ~Source() {}
   };
 
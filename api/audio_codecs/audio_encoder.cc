@@ -96,6 +96,8 @@ void AudioEncoder::OnReceivedRtt(int rtt_ms) {}
 
 void AudioEncoder::OnReceivedOverhead(size_t overhead_bytes_per_packet) {}
 
+void AudioEncoder::OnReceivedCpuUsage(int cpu_usage_percent) {}
+
 void AudioEncoder::SetReceiverFrameLengthRange(int min_frame_length_ms,
                                                int max_frame_length_ms) {}
 
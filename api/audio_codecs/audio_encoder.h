@@ -229,6 +229,11 @@ class AudioEncoder {
   // bytes that will be added to each packet the encoder generates.
   virtual void OnReceivedOverhead(size_t overhead_bytes_per_packet);
 
+  // Provides the CPU usage of the system, in percent, as estimated from the
+  // time spent encoding video, to allow the encoder to lower its complexity
+  // when the CPU is overused.
+  virtual void OnReceivedCpuUsage(int cpu_usage_percent);
+
   // To allow encoder to adapt its frame length, it must be provided the frame
   // length range that receivers can accept.
   virtual void SetReceiverFrameLengthRange(int min_frame_length_ms,
@@ -86,6 +86,12 @@ class DataChannelObserver {
   virtual void OnMessage(const DataBuffer& buffer) = 0;
   // The data channel's buffered_amount has changed.
   virtual void OnBufferedAmountChange(uint64_t previous_amount) {}
+  // Returning true lets an open, unordered SCTP data channel call OnMessage
+  // directly on the network thread, without a hop to the signaling thread.
+  // The other callbacks are still called on the signaling thread. Messages
+  // delivered this way aren't counted in the channel's messagesReceived and
+  // bytesReceived stats.
+  virtual bool IsOkToCallOnTheNetworkThread() { return false; }
 
  protected:
   virtual ~DataChannelObserver() = default;
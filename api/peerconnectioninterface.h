@@ -111,6 +111,7 @@
 #include "rtc_base/platform_file.h"
 #include "rtc_base/rtccertificate.h"
 #include "rtc_base/rtccertificategenerator.h"
+#include "rtc_base/rtccertificatepool.h"
 #include "rtc_base/socketaddress.h"
 #include "rtc_base/sslcertificate.h"
 #include "rtc_base/sslstreamadapter.h"
@@ -563,6 +564,26 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
     // correctly. This flag will be deprecated soon. Do not rely on it.
     bool active_reset_srtp_params = false;
 
+    // If set to true, the AES-GCM crypto suites from RFC 7714 are offered and
+    // preferred for SRTP, in addition to the crypto options of the factory.
+    // AES-GCM authenticates a packet as part of its encryption, which costs
+    // much less than the separate HMAC-SHA1 of the AES-CM crypto suites with
+    // hardware AES, e.g. on the links between the SFUs of a cascade. GCM will
+    // only be used if both sides enable it; the "srtpCipher" of the transport
+    // stats shows the crypto suite in use.
+    bool enable_gcm_crypto_suites = false;
+
+    // The options of the SCTP association of the data channels, in bytes for
+    // the buffer sizes. With the usrsctp defaults of 256 kB, a bulk transfer
+    // sends at most a buffer per round trip, which is far below the link rate
+    // on high-RTT paths. The receive buffer bounds the window of the peer.
+    // |sctp_max_burst| is the number of packets sent at once as the congestion
+    // window opens, and H-TCP grows the window back faster after a loss.
+    absl::optional<int> sctp_send_buffer_size;
+    absl::optional<int> sctp_receive_buffer_size;
+    absl::optional<int> sctp_max_burst;
+    bool sctp_use_htcp_congestion_control = false;
+
     //
     // Don't forget to update operator== if adding something.
     //
@@ -1212,6 +1233,11 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
 
     // Sets crypto related options, e.g. enabled cipher suites.
     rtc::CryptoOptions crypto_options;
+
+    // Keeps certificates generated ahead of time for the PeerConnections
+    // created without a certificate or certificate generator. Disabled by
+    // default.
+    rtc::RTCCertificatePool::Config certificate_pool;
   };
 
   // Set the options to be used for subsequently created PeerConnections.
@@ -17,6 +17,7 @@
 #include <utility>
 #include <vector>
 
+#include "rtc_base/buffer.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -76,6 +77,12 @@ class RTCStats {
   // object, listing all of its members (names and values).
   std::string ToJson() const;
 
+  // Appends a compact binary representation of the stats object to |buffer|,
+  // see |RTCStatsReport::ToBinary|. Only the defined members are written, as
+  // their index in |Members| followed by their value, so the names are not
+  // part of the output.
+  void ToBinary(rtc::Buffer* buffer) const;
+
   // Downcasts the stats object to an |RTCStats| subclass |T|. DCHECKs that the
   // object is of type |T|.
   template <typename T>
@@ -346,6 +353,11 @@ class RTCNonStandardStatsMember : public RTCStatsMember<T> {
   explicit RTCNonStandardStatsMember(RTCNonStandardStatsMember<T>&& other)
       : RTCStatsMember<T>(std::move(other)) {}
 
+  T& operator=(const T& value) { return RTCStatsMember<T>::operator=(value); }
+  T& operator=(const T&& value) {
+    return RTCStatsMember<T>::operator=(std::move(value));
+  }
+
   bool is_standardized() const override { return false; }
 };
 }  // namespace webrtc
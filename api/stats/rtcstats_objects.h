@@ -319,6 +319,10 @@ class RTCPeerConnectionStats final : public RTCStats {
 
   RTCStatsMember<uint32_t> data_channels_opened;
   RTCStatsMember<uint32_t> data_channels_closed;
+  // Non-standard. The memory held by video frames in the whole process, see
+  // webrtc::VideoMemoryAccountant.
+  RTCNonStandardStatsMember<uint64_t> video_memory_bytes;
+  RTCNonStandardStatsMember<uint64_t> video_memory_peak_bytes;
 };
 
 // https://w3c.github.io/webrtc-stats/#streamstats-dict*
@@ -399,6 +403,13 @@ class RTCInboundRTPStreamStats final : public RTCRTPStreamStats {
   // TODO(hbos): Collect and populate this value. https://bugs.webrtc.org/7065
   RTCStatsMember<double> gap_discard_rate;
   RTCStatsMember<uint32_t> frames_decoded;
+  // Non-standard. Percentiles of the time spent by the timing frames of a
+  // video stream in each stage of the pipeline, from capture to render. The
+  // percentiles are in milliseconds, in the order of the stage names.
+  RTCStatsMember<std::vector<std::string>> frame_latency_stages;
+  RTCStatsMember<std::vector<double>> frame_latency_p50;
+  RTCStatsMember<std::vector<double>> frame_latency_p95;
+  RTCStatsMember<std::vector<double>> frame_latency_p99;
 };
 
 // https://w3c.github.io/webrtc-stats/#outboundrtpstats-dict*
@@ -438,6 +449,8 @@ class RTCTransportStats final : public RTCStats {
   RTCStatsMember<std::string> selected_candidate_pair_id;
   RTCStatsMember<std::string> local_certificate_id;
   RTCStatsMember<std::string> remote_certificate_id;
+  // The SRTP crypto suite in use, e.g. "AEAD_AES_128_GCM".
+  RTCStatsMember<std::string> srtp_cipher;
 };
 
 }  // namespace webrtc
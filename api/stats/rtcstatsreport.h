@@ -70,6 +70,17 @@ class RTCStatsReport : public rtc::RefCountInterface {
   // Takes ownership of all the stats in |victim|, leaving it empty.
   void TakeMembersFrom(rtc::scoped_refptr<RTCStatsReport> victim);
 
+  // Computes what changed since the |previous| report, which acts as the cursor
+  // of a poller that only wants to process the differences. Appends to
+  // |changed| the stats of this report that are not in |previous|, or whose
+  // members differ from the stats with the same ID in |previous| (timestamps
+  // are not compared), and to |removed| the stats of |previous| that have no
+  // counterpart in this report. Both are in ID order and point into the
+  // reports, which must outlive their use. Either output may be null.
+  void GetDelta(const RTCStatsReport& previous,
+                std::vector<const RTCStats*>* changed,
+                std::vector<const RTCStats*>* removed) const;
+
   // Stats iterators. Stats are ordered lexicographically on |RTCStats::id|.
   ConstIterator begin() const;
   ConstIterator end() const;
@@ -90,6 +101,18 @@ class RTCStatsReport : public rtc::RefCountInterface {
   // listing all of its stats objects.
   std::string ToJson() const;
 
+  // Appends a compact binary representation of the report to |buffer|, which
+  // the caller may reuse between reports to avoid reallocations. Unsigned
+  // integers are written as base 128 varints, signed ones as zigzag varints,
+  // doubles and timestamps as 8 little endian bytes, strings as their varint
+  // length followed by their bytes and sequences as their varint size followed
+  // by their elements. Bools are a single byte. The report is its timestamp
+  // and its number of stats objects as 4 little endian bytes, followed by the
+  // stats objects. A stats object is its type, ID, timestamp and number of
+  // defined members, followed by the index in |RTCStats::Members| and value
+  // of each defined member.
+  void ToBinary(rtc::Buffer* buffer) const;
+
   friend class rtc::RefCountedObject<RTCStatsReport>;
 
  private:
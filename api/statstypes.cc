@@ -576,6 +576,20 @@ const char* StatsReport::Value::display_name() const {
       return "localCertificateId";
     case kStatsValueNameAdaptationChanges:
       return "googAdaptationChanges";
+    case kStatsValueNameApmEchoCancellerTimeUs:
+      return "googApmEchoCancellerTimeUs";
+    case kStatsValueNameApmGainControlTimeUs:
+      return "googApmGainControlTimeUs";
+    case kStatsValueNameApmGainController2TimeUs:
+      return "googApmGainController2TimeUs";
+    case kStatsValueNameApmHighPassFilterTimeUs:
+      return "googApmHighPassFilterTimeUs";
+    case kStatsValueNameApmLevelEstimatorTimeUs:
+      return "googApmLevelEstimatorTimeUs";
+    case kStatsValueNameApmNoiseSuppressorTimeUs:
+      return "googApmNoiseSuppressorTimeUs";
+    case kStatsValueNameApmVoiceDetectionTimeUs:
+      return "googApmVoiceDetectionTimeUs";
     case kStatsValueNameNacksReceived:
       return "googNacksReceived";
     case kStatsValueNameNacksSent:
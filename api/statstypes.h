@@ -137,6 +137,13 @@ class StatsReport {
     kStatsValueNameAccelerateRate,
     kStatsValueNameActualEncBitrate,
     kStatsValueNameAdaptationChanges,
+    kStatsValueNameApmEchoCancellerTimeUs,
+    kStatsValueNameApmGainControlTimeUs,
+    kStatsValueNameApmGainController2TimeUs,
+    kStatsValueNameApmHighPassFilterTimeUs,
+    kStatsValueNameApmLevelEstimatorTimeUs,
+    kStatsValueNameApmNoiseSuppressorTimeUs,
+    kStatsValueNameApmVoiceDetectionTimeUs,
     kStatsValueNameAvailableReceiveBandwidth,
     kStatsValueNameAvailableSendBandwidth,
     kStatsValueNameAvgEncodeMs,
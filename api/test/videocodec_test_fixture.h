@@ -105,6 +105,11 @@ class VideoCodecTestFixture {
     // If set to true, the encoding will run in real-time.
     bool measure_cpu = false;
 
+    // If > 0: PSNR and SSIM are calculated on this many separate threads, so
+    // that they don't hold up encoding and decoding. Ignored if |measure_cpu|
+    // is set, as the metrics are skipped then.
+    size_t quality_calc_threads = 0;
+
     // If > 0: forces the encoder to create a keyframe every Nth frame.
     size_t keyframe_interval = 0;
 
@@ -13,6 +13,7 @@
 #include <utility>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/video_memory_accountant.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/refcountedobject.h"
 #include "third_party/libyuv/include/libyuv/convert.h"
@@ -52,9 +53,14 @@ I010Buffer::I010Buffer(int width,
   RTC_DCHECK_GE(stride_y, width);
   RTC_DCHECK_GE(stride_u, (width + 1) / 2);
   RTC_DCHECK_GE(stride_v, (width + 1) / 2);
+  VideoMemoryAccountant::OnAllocated(
+      I010DataSize(height_, stride_y_, stride_u_, stride_v_));
 }
 
-I010Buffer::~I010Buffer() {}
+I010Buffer::~I010Buffer() {
+  VideoMemoryAccountant::OnReleased(
+      I010DataSize(height_, stride_y_, stride_u_, stride_v_));
+}
 
 // static
 rtc::scoped_refptr<I010Buffer> I010Buffer::Create(int width, int height) {
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <utility>
 
+#include "api/video/video_memory_accountant.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "third_party/libyuv/include/libyuv/convert.h"
@@ -54,9 +55,14 @@ I420Buffer::I420Buffer(int width,
   RTC_DCHECK_GE(stride_y, width);
   RTC_DCHECK_GE(stride_u, (width + 1) / 2);
   RTC_DCHECK_GE(stride_v, (width + 1) / 2);
+  VideoMemoryAccountant::OnAllocated(
+      I420DataSize(height_, stride_y_, stride_u_, stride_v_));
 }
 
-I420Buffer::~I420Buffer() {}
+I420Buffer::~I420Buffer() {
+  VideoMemoryAccountant::OnReleased(
+      I420DataSize(height_, stride_y_, stride_u_, stride_v_));
+}
 
 // static
 rtc::scoped_refptr<I420Buffer> I420Buffer::Create(int width, int height) {
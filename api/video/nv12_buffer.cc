@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "api/video/nv12_buffer.h"
+
+#include <string.h>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_memory_accountant.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/refcountedobject.h"
+#include "third_party/libyuv/include/libyuv/convert.h"
+#include "third_party/libyuv/include/libyuv/convert_from.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+#include "third_party/libyuv/include/libyuv/scale.h"
+
+// Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
+static const int kBufferAlignment = 64;
+
+namespace webrtc {
+
+namespace {
+
+int NV12DataSize(int height, int stride_y, int stride_uv) {
+  return stride_y * height + stride_uv * ((height + 1) / 2);
+}
+
+}  // namespace
+
+NV12Buffer::NV12Buffer(int width, int height, int stride_y, int stride_uv)
+    : width_(width),
+      height_(height),
+      stride_y_(stride_y),
+      stride_uv_(stride_uv),
+      data_(static_cast<uint8_t*>(
+          AlignedMalloc(NV12DataSize(height, stride_y, stride_uv),
+                        kBufferAlignment))) {
+  RTC_DCHECK_GT(width, 0);
+  RTC_DCHECK_GT(height, 0);
+  RTC_DCHECK_GE(stride_y, width);
+  RTC_DCHECK_GE(stride_uv, 2 * ((width + 1) / 2));
+  VideoMemoryAccountant::OnAllocated(
+      NV12DataSize(height_, stride_y_, stride_uv_));
+}
+
+NV12Buffer::~NV12Buffer() {
+  VideoMemoryAccountant::OnReleased(
+      NV12DataSize(height_, stride_y_, stride_uv_));
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width, int height) {
+  return new rtc::RefCountedObject<NV12Buffer>(width, height, width,
+                                               2 * ((width + 1) / 2));
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Create(int width,
+                                                  int height,
+                                                  int stride_y,
+                                                  int stride_uv) {
+  return new rtc::RefCountedObject<NV12Buffer>(width, height, stride_y,
+                                               stride_uv);
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Copy(
+    const NV12BufferInterface& source) {
+  const int width = source.width();
+  const int height = source.height();
+  rtc::scoped_refptr<NV12Buffer> buffer = Create(width, height);
+  RTC_CHECK_EQ(0, libyuv::NV12Copy(source.DataY(), source.StrideY(),
+                                   source.DataUV(), source.StrideUV(),
+                                   buffer->MutableDataY(), buffer->StrideY(),
+                                   buffer->MutableDataUV(), buffer->StrideUV(),
+                                   width, height));
+  return buffer;
+}
+
+// static
+rtc::scoped_refptr<NV12Buffer> NV12Buffer::Copy(
+    const I420BufferInterface& source) {
+  const int width = source.width();
+  const int height = source.height();
+  rtc::scoped_refptr<NV12Buffer> buffer = Create(width, height);
+  RTC_CHECK_EQ(
+      0, libyuv::I420ToNV12(
+             source.DataY(), source.StrideY(), source.DataU(), source.StrideU(),
+             source.DataV(), source.StrideV(), buffer->MutableDataY(),
+             buffer->StrideY(), buffer->MutableDataUV(), buffer->StrideUV(),
+             width, height));
+  return buffer;
+}
+
+rtc::scoped_refptr<I420BufferInterface> NV12Buffer::ToI420() {
+  rtc::scoped_refptr<I420Buffer> i420_buffer =
+      I420Buffer::Create(width(), height());
+  libyuv::NV12ToI420(DataY(), StrideY(), DataUV(), StrideUV(),
+                     i420_buffer->MutableDataY(), i420_buffer->StrideY(),
+                     i420_buffer->MutableDataU(), i420_buffer->StrideU(),
+                     i420_buffer->MutableDataV(), i420_buffer->StrideV(),
+                     width(), height());
+  return i420_buffer;
+}
+
+int NV12Buffer::width() const {
+  return width_;
+}
+
+int NV12Buffer::height() const {
+  return height_;
+}
+
+const uint8_t* NV12Buffer::DataY() const {
+  return data_.get();
+}
+const uint8_t* NV12Buffer::DataUV() const {
+  return data_.get() + UVOffset();
+}
+
+int NV12Buffer::StrideY() const {
+  return stride_y_;
+}
+int NV12Buffer::StrideUV() const {
+  return stride_uv_;
+}
+
+uint8_t* NV12Buffer::MutableDataY() {
+  return const_cast<uint8_t*>(DataY());
+}
+uint8_t* NV12Buffer::MutableDataUV() {
+  return const_cast<uint8_t*>(DataUV());
+}
+
+size_t NV12Buffer::UVOffset() const {
+  return stride_y_ * height_;
+}
+
+void NV12Buffer::InitializeData() {
+  memset(data_.get(), 0, NV12DataSize(height_, stride_y_, stride_uv_));
+}
+
+void NV12Buffer::CropAndScaleFrom(const NV12BufferInterface& src,
+                                  int offset_x,
+                                  int offset_y,
+                                  int crop_width,
+                                  int crop_height) {
+  RTC_CHECK_LE(crop_width, src.width());
+  RTC_CHECK_LE(crop_height, src.height());
+  RTC_CHECK_LE(crop_width + offset_x, src.width());
+  RTC_CHECK_LE(crop_height + offset_y, src.height());
+  RTC_CHECK_GE(offset_x, 0);
+  RTC_CHECK_GE(offset_y, 0);
+
+  // Make sure offset is even so that u/v plane becomes aligned.
+  const int uv_offset_x = offset_x / 2;
+  const int uv_offset_y = offset_y / 2;
+  offset_x = uv_offset_x * 2;
+  offset_y = uv_offset_y * 2;
+
+  const uint8_t* y_plane = src.DataY() + src.StrideY() * offset_y + offset_x;
+  const uint8_t* uv_plane =
+      src.DataUV() + src.StrideUV() * uv_offset_y + uv_offset_x * 2;
+  const int crop_chroma_width = (crop_width + 1) / 2;
+  const int crop_chroma_height = (crop_height + 1) / 2;
+
+  if (crop_width == width() && crop_height == height()) {
+    libyuv::NV12Copy(y_plane, src.StrideY(), uv_plane, src.StrideUV(),
+                     MutableDataY(), StrideY(), MutableDataUV(), StrideUV(),
+                     width(), height());
+    return;
+  }
+
+  libyuv::ScalePlane(y_plane, src.StrideY(), crop_width, crop_height,
+                     MutableDataY(), StrideY(), width(), height(),
+                     libyuv::kFilterBox);
+
+  // libyuv has no scaler for interleaved planes, so the chroma samples are
+  // split into temporary planes, scaled and interleaved again.
+  const int chroma_width = ChromaWidth();
+  const int chroma_height = ChromaHeight();
+  const int src_plane_size = crop_chroma_width * crop_chroma_height;
+  const int dst_plane_size = chroma_width * chroma_height;
+  std::unique_ptr<uint8_t, AlignedFreeDeleter> tmp(static_cast<uint8_t*>(
+      AlignedMalloc(2 * (src_plane_size + dst_plane_size), kBufferAlignment)));
+  uint8_t* const src_u = tmp.get();
+  uint8_t* const src_v = src_u + src_plane_size;
+  uint8_t* const dst_u = src_v + src_plane_size;
+  uint8_t* const dst_v = dst_u + dst_plane_size;
+  libyuv::SplitUVPlane(uv_plane, src.StrideUV(), src_u, crop_chroma_width,
+                       src_v, crop_chroma_width, crop_chroma_width,
+                       crop_chroma_height);
+  libyuv::ScalePlane(src_u, crop_chroma_width, crop_chroma_width,
+                     crop_chroma_height, dst_u, chroma_width, chroma_width,
+                     chroma_height, libyuv::kFilterBox);
+  libyuv::ScalePlane(src_v, crop_chroma_width, crop_chroma_width,
+                     crop_chroma_height, dst_v, chroma_width, chroma_width,
+                     chroma_height, libyuv::kFilterBox);
+  libyuv::MergeUVPlane(dst_u, chroma_width, dst_v, chroma_width,
+                       MutableDataUV(), StrideUV(), chroma_width,
+                       chroma_height);
+}
+
+void NV12Buffer::ScaleFrom(const NV12BufferInterface& src) {
+  CropAndScaleFrom(src, 0, 0, src.width(), src.height());
+}
+
+}  // namespace webrtc
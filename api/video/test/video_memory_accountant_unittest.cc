@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video/video_memory_accountant.h"
+
+#include "api/video/i420_buffer.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(VideoMemoryAccountantTest, CountsI420Buffers) {
+  const int64_t allocated_bytes = VideoMemoryAccountant::allocated_bytes();
+  {
+    rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(64, 32);
+    EXPECT_EQ(allocated_bytes + 64 * 32 * 3 / 2,
+              VideoMemoryAccountant::allocated_bytes());
+    EXPECT_GE(VideoMemoryAccountant::peak_allocated_bytes(),
+              VideoMemoryAccountant::allocated_bytes());
+  }
+  EXPECT_EQ(allocated_bytes, VideoMemoryAccountant::allocated_bytes());
+}
+
+TEST(VideoMemoryAccountantTest, IsOverCap) {
+  EXPECT_FALSE(VideoMemoryAccountant::IsOverCap());
+
+  VideoMemoryAccountant::SetCapBytes(VideoMemoryAccountant::allocated_bytes() +
+                                     1000);
+  EXPECT_FALSE(VideoMemoryAccountant::IsOverCap());
+  VideoMemoryAccountant::OnAllocated(2000);
+  EXPECT_TRUE(VideoMemoryAccountant::IsOverCap());
+  VideoMemoryAccountant::OnReleased(2000);
+  EXPECT_FALSE(VideoMemoryAccountant::IsOverCap());
+
+  VideoMemoryAccountant::SetCapBytes(0);
+}
+
+}  // namespace webrtc
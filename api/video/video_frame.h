@@ -22,6 +22,17 @@ namespace webrtc {
 
 class VideoFrame {
  public:
+  // The part of the frame that changed since the previous frame of the source,
+  // in pixels of this frame.
+  struct UpdateRect {
+    bool IsEmpty() const { return width == 0 || height == 0; }
+
+    int offset_x;
+    int offset_y;
+    int width;
+    int height;
+  };
+
   // Preferred way of building VideoFrame objects.
   class Builder {
    public:
@@ -37,6 +48,7 @@ class VideoFrame {
     Builder& set_ntp_time_ms(int64_t ntp_time_ms);
     Builder& set_rotation(VideoRotation rotation);
     Builder& set_color_space(const ColorSpace& color_space);
+    Builder& set_update_rect(const UpdateRect& update_rect);
 
    private:
     rtc::scoped_refptr<webrtc::VideoFrameBuffer> video_frame_buffer_;
@@ -45,6 +57,7 @@ class VideoFrame {
     int64_t ntp_time_ms_ = 0;
     VideoRotation rotation_ = kVideoRotation_0;
     absl::optional<ColorSpace> color_space_;
+    absl::optional<UpdateRect> update_rect_;
   };
 
   // To be deprecated. Migrate all use to Builder.
@@ -113,6 +126,15 @@ class VideoFrame {
   // Set Color space when available.
   absl::optional<ColorSpace> color_space() const { return color_space_; }
 
+  // Set by sources that know which part of the frame changed, e.g. screen
+  // capturers. Not set if the whole frame may have changed. An empty rect
+  // means that the frame is the same as the previous one, which encoders may
+  // skip or encode as a tiny frame.
+  absl::optional<UpdateRect> update_rect() const { return update_rect_; }
+  void set_update_rect(const UpdateRect& update_rect) {
+    update_rect_ = update_rect;
+  }
+
   // Get render time in milliseconds.
   // TODO(nisse): Deprecated. Migrate all users to timestamp_us().
   int64_t render_time_ms() const;
@@ -133,7 +155,8 @@ class VideoFrame {
              uint32_t timestamp_rtp,
              int64_t ntp_time_ms,
              VideoRotation rotation,
-             const absl::optional<ColorSpace>& color_space);
+             const absl::optional<ColorSpace>& color_space,
+             const absl::optional<UpdateRect>& update_rect);
 
   // An opaque reference counted handle that stores the pixel data.
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> video_frame_buffer_;
@@ -142,6 +165,7 @@ class VideoFrame {
   int64_t timestamp_us_;
   VideoRotation rotation_;
   absl::optional<ColorSpace> color_space_;
+  absl::optional<UpdateRect> update_rect_;
 };
 
 }  // namespace webrtc
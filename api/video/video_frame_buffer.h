@@ -22,6 +22,7 @@ class I420BufferInterface;
 class I420ABufferInterface;
 class I444BufferInterface;
 class I010BufferInterface;
+class NV12BufferInterface;
 
 // Base class for frame buffers of different types of pixel format and storage.
 // The tag in type() indicates how the data is represented, and each type is
@@ -49,6 +50,7 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
     kI420A,
     kI444,
     kI010,
+    kNV12,
   };
 
   // This function specifies in what pixel format the data is stored in.
@@ -65,6 +67,24 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   // software encoders.
   virtual rtc::scoped_refptr<I420BufferInterface> ToI420() = 0;
 
+  // Returns a buffer of the same type with the |crop_width| x |crop_height|
+  // rectangle at (|offset_x|, |offset_y|) scaled to |scaled_width| x
+  // |scaled_height|, e.g. a texture cropped and scaled on the GPU, without
+  // converting the pixel data to I420. Meant for kNative buffers, used when
+  // the frame is adapted or encoded in several resolutions. The default
+  // returns null, which means the buffer can't be scaled that way.
+  virtual rtc::scoped_refptr<VideoFrameBuffer> CropAndScaleNative(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height);
+
+  // Same as CropAndScaleNative() on the whole buffer.
+  virtual rtc::scoped_refptr<VideoFrameBuffer> ScaleNative(int scaled_width,
+                                                           int scaled_height);
+
   // These functions should only be called if type() is of the correct type.
   // Calling with a different type will result in a crash.
   // TODO(magjed): Return raw pointers for GetI420 once deprecated interface is
@@ -77,6 +97,8 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   const I444BufferInterface* GetI444() const;
   I010BufferInterface* GetI010();
   const I010BufferInterface* GetI010() const;
+  NV12BufferInterface* GetNV12();
+  const NV12BufferInterface* GetNV12() const;
 
  protected:
   ~VideoFrameBuffer() override {}
@@ -172,6 +194,48 @@ class I010BufferInterface : public PlanarYuv16BBuffer {
   ~I010BufferInterface() override {}
 };
 
+// This interface represents formats with a full resolution luma plane and
+// one plane of interleaved chroma samples.
+class BiplanarYuvBuffer : public VideoFrameBuffer {
+ public:
+  virtual int ChromaWidth() const = 0;
+  virtual int ChromaHeight() const = 0;
+
+  // Returns the number of steps(in terms of Data*() return type) between
+  // successive rows for a given plane.
+  virtual int StrideY() const = 0;
+  virtual int StrideUV() const = 0;
+
+ protected:
+  ~BiplanarYuvBuffer() override {}
+};
+
+// This interface represents 8-bit color depth biplanar formats: Type::kNV12.
+class BiplanarYuv8Buffer : public BiplanarYuvBuffer {
+ public:
+  // Returns pointer to the pixel data for a given plane. The memory is owned by
+  // the VideoFrameBuffer object and must not be freed by the caller.
+  virtual const uint8_t* DataY() const = 0;
+  virtual const uint8_t* DataUV() const = 0;
+
+ protected:
+  ~BiplanarYuv8Buffer() override {}
+};
+
+// Represents Type::kNV12. NV12 is YUV 4:2:0 with the U and V samples
+// interleaved in the second plane, UVUV..., as produced by many cameras and
+// consumed by hardware encoders.
+class NV12BufferInterface : public BiplanarYuv8Buffer {
+ public:
+  Type type() const override;
+
+  int ChromaWidth() const final;
+  int ChromaHeight() const final;
+
+ protected:
+  ~NV12BufferInterface() override {}
+};
+
 }  // namespace webrtc
 
 #endif  // API_VIDEO_VIDEO_FRAME_BUFFER_H_
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video/video_memory_accountant.h"
+
+#include <atomic>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+std::atomic<int64_t> g_allocated_bytes(0);
+std::atomic<int64_t> g_peak_allocated_bytes(0);
+std::atomic<int64_t> g_cap_bytes(0);
+
+}  // namespace
+
+void VideoMemoryAccountant::OnAllocated(size_t bytes) {
+  const int64_t allocated_bytes =
+      g_allocated_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak_allocated_bytes =
+      g_peak_allocated_bytes.load(std::memory_order_relaxed);
+  while (allocated_bytes > peak_allocated_bytes &&
+         !g_peak_allocated_bytes.compare_exchange_weak(
+             peak_allocated_bytes, allocated_bytes,
+             std::memory_order_relaxed)) {
+  }
+}
+
+void VideoMemoryAccountant::OnReleased(size_t bytes) {
+  const int64_t allocated_bytes =
+      g_allocated_bytes.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+  RTC_DCHECK_GE(allocated_bytes, 0);
+}
+
+int64_t VideoMemoryAccountant::allocated_bytes() {
+  return g_allocated_bytes.load(std::memory_order_relaxed);
+}
+
+int64_t VideoMemoryAccountant::peak_allocated_bytes() {
+  return g_peak_allocated_bytes.load(std::memory_order_relaxed);
+}
+
+void VideoMemoryAccountant::SetCapBytes(int64_t cap_bytes) {
+  RTC_DCHECK_GE(cap_bytes, 0);
+  g_cap_bytes.store(cap_bytes, std::memory_order_relaxed);
+}
+
+int64_t VideoMemoryAccountant::cap_bytes() {
+  return g_cap_bytes.load(std::memory_order_relaxed);
+}
+
+bool VideoMemoryAccountant::IsOverCap() {
+  const int64_t cap_bytes = g_cap_bytes.load(std::memory_order_relaxed);
+  return cap_bytes > 0 &&
+         g_allocated_bytes.load(std::memory_order_relaxed) > cap_bytes;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_VIDEO_VIDEO_MEMORY_ACCOUNTANT_H_
+#define API_VIDEO_VIDEO_MEMORY_ACCOUNTANT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+
+// Process-wide count of the memory held by video frames: the pixel buffers
+// allocated by I420Buffer, I010Buffer and NV12Buffer, wherever they are,
+// e.g. in capturers, buffer pools, render queues or encoder and decoder
+// internals, and the bitstreams of received frames waiting to be decoded.
+//
+// With a cap set, VideoStreamEncoder and VideoReceiveStream drop frames
+// instead of queueing them while the count is over the cap. All the methods
+// are thread safe.
+class VideoMemoryAccountant {
+ public:
+  static void OnAllocated(size_t bytes);
+  static void OnReleased(size_t bytes);
+
+  static int64_t allocated_bytes();
+  // The highest count since the process started.
+  static int64_t peak_allocated_bytes();
+
+  // A cap of 0, the default, disables it.
+  static void SetCapBytes(int64_t cap_bytes);
+  static int64_t cap_bytes();
+  static bool IsOverCap();
+};
+
+}  // namespace webrtc
+
+#endif  // API_VIDEO_VIDEO_MEMORY_ACCOUNTANT_H_
@@ -11,6 +11,7 @@
 #ifndef API_VIDEO_VIDEO_SOURCE_INTERFACE_H_
 #define API_VIDEO_VIDEO_SOURCE_INTERFACE_H_
 
+#include <functional>
 #include <limits>
 
 #include "absl/types/optional.h"
@@ -41,6 +42,11 @@ struct VideoSinkWants {
   absl::optional<int> target_pixel_count;
   // Tells the source the maximum framerate the sink wants.
   int max_framerate_fps = std::numeric_limits<int>::max();
+  // Tells the source that the sink drops the frames delivered while this
+  // returns true, e.g. when an encoder is still behind on earlier frames.
+  // Sources can then skip converting and scaling such frames. Called on the
+  // thread delivering frames, as long as the sink is added to the source.
+  std::function<bool()> is_busy;
 };
 
 template <typename VideoFrameT>
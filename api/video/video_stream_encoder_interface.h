@@ -89,6 +89,13 @@ class VideoStreamEncoderInterface : public rtc::VideoSinkInterface<VideoFrame> {
   virtual void SetBitrateAllocationObserver(
       VideoBitrateAllocationObserver* bitrate_observer) = 0;
 
+  // Pauses the encoding of the simulcast streams that |active_layers| marks
+  // inactive, and resumes the others, without reconfiguring the encoder: the
+  // streams get no bitrate, which encoders take as a cue to skip them. A
+  // resumed stream starts with a key frame. Overrides the |active| flags of
+  // the encoder configuration, till called again.
+  virtual void SetActiveLayers(std::vector<bool> active_layers) = 0;
+
   // Creates and configures an encoder with the given |config|. The
   // |max_data_payload_length| is used to support single NAL unit
   // packetization for H.264.
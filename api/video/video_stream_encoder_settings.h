@@ -22,6 +22,15 @@ struct VideoStreamEncoderSettings {
   // cpu adaptation.
   bool experiment_cpu_load_estimator = false;
 
+  // Makes cpu adaptation first speed up the encoder, at the cost of some
+  // quality per bit, and only then reduce the resolution or framerate.
+  bool encoder_speed_adaptation = false;
+
+  // Makes sources drop the frames that arrive while another frame is waiting
+  // to be encoded, before they are converted and scaled, instead of dropping
+  // them on the encoder queue.
+  bool drop_frames_at_source = false;
+
   // Ownership stays with WebrtcVideoEngine (delegated from PeerConnection).
   VideoEncoderFactory* encoder_factory = nullptr;
 };
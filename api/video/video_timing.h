@@ -116,6 +116,15 @@ struct TimingFrameInfo {
   uint8_t flags;  // Flags indicating validity and/or why tracing was triggered.
 };
 
+// Percentiles of the time the timing frames of a stream spent in one stage of
+// the video pipeline, from capture on the sender to render on the receiver.
+struct FrameLatencyStageStats {
+  std::string stage;
+  int64_t p50_ms = 0;
+  int64_t p95_ms = 0;
+  int64_t p99_ms = 0;
+};
+
 }  // namespace webrtc
 
 #endif  // API_VIDEO_VIDEO_TIMING_H_
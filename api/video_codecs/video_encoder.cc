@@ -94,10 +94,22 @@ VideoEncoder::ScalingSettings VideoEncoder::GetScalingSettings() const {
   return ScalingSettings::kOff;
 }
 
+bool VideoEncoder::SetSpeedSteps(int steps) {
+  return steps == 0;
+}
+
+bool VideoEncoder::Reconfigure(const VideoCodec& codec_settings) {
+  return false;
+}
+
 bool VideoEncoder::SupportsNativeHandle() const {
   return false;
 }
 
+bool VideoEncoder::SupportsNV12() const {
+  return false;
+}
+
 const char* VideoEncoder::ImplementationName() const {
   return "unknown";
 }
@@ -200,7 +200,24 @@ class VideoEncoder {
   // quality scaler must implement this method.
   virtual ScalingSettings GetScalingSettings() const;
 
+  // Makes the encoder use a speed setting |steps| faster than the one it
+  // selected in InitEncode, trading compression efficiency for less cpu usage,
+  // e.g. when the cpu is overused. InitEncode resets the steps to zero.
+  // Returns false, leaving the speed unchanged, if the encoder has no setting
+  // that fast.
+  virtual bool SetSpeedSteps(int steps);
+
+  // Applies |codec_settings| without reinitializing the encoder, where they
+  // differ from those of the last InitEncode() or Reconfigure() call only in
+  // resolution and bitrate limits. Returns false if the change requires
+  // InitEncode(), which the caller must then call before the next Encode().
+  virtual bool Reconfigure(const VideoCodec& codec_settings);
+
   virtual bool SupportsNativeHandle() const;
+  // Returns true if the encoder takes VideoFrameBuffer::Type::kNV12 frames
+  // as they are, e.g. a hardware encoder consuming NV12. Other encoders are
+  // given such frames converted to I420.
+  virtual bool SupportsNV12() const;
   virtual const char* ImplementationName() const;
 };
 }  // namespace webrtc
@@ -91,7 +91,10 @@ class VideoEncoderSoftwareFallbackWrapper final : public VideoEncoder {
   int32_t SetRateAllocation(const VideoBitrateAllocation& bitrate_allocation,
                             uint32_t framerate) override;
   bool SupportsNativeHandle() const override;
+  bool SupportsNV12() const override;
   ScalingSettings GetScalingSettings() const override;
+  bool SetSpeedSteps(int steps) override;
+  bool Reconfigure(const VideoCodec& codec_settings) override;
   const char* ImplementationName() const override;
 
  private:
@@ -299,6 +302,11 @@ bool VideoEncoderSoftwareFallbackWrapper::SupportsNativeHandle() const {
                                : encoder_->SupportsNativeHandle();
 }
 
+bool VideoEncoderSoftwareFallbackWrapper::SupportsNV12() const {
+  return use_fallback_encoder_ ? fallback_encoder_->SupportsNV12()
+                               : encoder_->SupportsNV12();
+}
+
 VideoEncoder::ScalingSettings
 VideoEncoderSoftwareFallbackWrapper::GetScalingSettings() const {
   if (forced_fallback_possible_) {
@@ -314,6 +322,25 @@ VideoEncoderSoftwareFallbackWrapper::GetScalingSettings() const {
   return encoder_->GetScalingSettings();
 }
 
+bool VideoEncoderSoftwareFallbackWrapper::SetSpeedSteps(int steps) {
+  return use_fallback_encoder_ ? fallback_encoder_->SetSpeedSteps(steps)
+                               : encoder_->SetSpeedSteps(steps);
+}
+
+bool VideoEncoderSoftwareFallbackWrapper::Reconfigure(
+    const VideoCodec& codec_settings) {
+  // With forced fallback, the resolution selects the encoder to use, which
+  // InitEncode decides.
+  if (forced_fallback_possible_)
+    return false;
+  bool reconfigured = use_fallback_encoder_
+                          ? fallback_encoder_->Reconfigure(codec_settings)
+                          : encoder_->Reconfigure(codec_settings);
+  if (reconfigured)
+    codec_settings_ = codec_settings;
+  return reconfigured;
+}
+
 const char* VideoEncoderSoftwareFallbackWrapper::ImplementationName() const {
   return use_fallback_encoder_ ? fallback_encoder_->ImplementationName()
                                : encoder_->ImplementationName();
@@ -250,6 +250,11 @@ int AudioReceiveStream::PreferredSampleRate() const {
   return channel_proxy_->PreferredSampleRate();
 }
 
+absl::optional<AudioMixer::Source::AudioLevel>
+AudioReceiveStream::ReceivedAudioLevel() const {
+  return channel_proxy_->ReceivedAudioLevel();
+}
+
 int AudioReceiveStream::id() const {
   RTC_DCHECK_RUN_ON(&worker_thread_checker_);
   return config_.rtp.remote_ssrc;
@@ -77,6 +77,7 @@ class AudioReceiveStream final : public webrtc::AudioReceiveStream,
                                        AudioFrame* audio_frame) override;
   int Ssrc() const override;
   int PreferredSampleRate() const override;
+  absl::optional<AudioLevel> ReceivedAudioLevel() const override;
 
   // Syncable
   int id() const override;
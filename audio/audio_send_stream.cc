@@ -17,6 +17,7 @@
 #include "audio/audio_state.h"
 #include "audio/channel_proxy.h"
 #include "audio/conversion.h"
+#include "audio/shared_audio_encoder.h"
 #include "call/rtp_transport_controller_send_interface.h"
 #include "modules/audio_coding/codecs/cng/audio_encoder_cng.h"
 #include "rtc_base/checks.h"
@@ -278,6 +279,13 @@ void AudioSendStream::ConfigureStream(
 
   if (stream->sending_) {
     ReconfigureBitrateObserver(stream, new_config);
+    if (old_config.pacer_fast_lane != new_config.pacer_fast_lane ||
+        old_config.rtp.ssrc != new_config.rtp.ssrc) {
+      RtpPacketSender* packet_sender = stream->transport_->packet_sender();
+      packet_sender->SetAudioFastLane(old_config.rtp.ssrc, false);
+      packet_sender->SetAudioFastLane(new_config.rtp.ssrc,
+                                      new_config.pacer_fast_lane);
+    }
   }
   stream->config_ = new_config;
 }
@@ -301,6 +309,8 @@ void AudioSendStream::Start() {
                              config_.bitrate_priority,
                              has_transport_sequence_number);
   }
+  if (config_.pacer_fast_lane)
+    transport_->packet_sender()->SetAudioFastLane(config_.rtp.ssrc, true);
   channel_proxy_->StartSend();
   sending_ = true;
   audio_state()->AddSendingStream(this, encoder_sample_rate_hz_,
@@ -314,6 +324,8 @@ void AudioSendStream::Stop() {
   }
 
   RemoveBitrateObserver();
+  if (config_.pacer_fast_lane)
+    transport_->packet_sender()->SetAudioFastLane(config_.rtp.ssrc, false);
   channel_proxy_->StopSend();
   sending_ = false;
   audio_state()->RemoveSendingStream(this);
@@ -525,6 +537,11 @@ bool AudioSendStream::SetupSendCodec(AudioSendStream* stream,
     return false;
   }
 
+  if (new_config.shared_encoder) {
+    encoder = new_config.shared_encoder->CreateStreamEncoder(
+        spec.payload_type, std::move(encoder));
+  }
+
   // If other side does not support audio TWCC and WebRTC-Audio-ABWENoTWCC is
   // not enabled, do not update target audio bitrate if we are in
   // WebRTC-Audio-SendSideBwe-For-Video experiment
@@ -583,17 +600,19 @@ bool AudioSendStream::ReconfigureSendCodec(AudioSendStream* stream,
 
   if (new_config.send_codec_spec == old_config.send_codec_spec &&
       new_config.audio_network_adaptor_config ==
-          old_config.audio_network_adaptor_config) {
+          old_config.audio_network_adaptor_config &&
+      new_config.shared_encoder == old_config.shared_encoder) {
     return true;
   }
 
-  // If we have no encoder, or the format or payload type's changed, create a
-  // new encoder.
+  // If we have no encoder, or the format, payload type or shared encoder has
+  // changed, create a new encoder.
   if (!old_config.send_codec_spec ||
       new_config.send_codec_spec->format !=
           old_config.send_codec_spec->format ||
       new_config.send_codec_spec->payload_type !=
-          old_config.send_codec_spec->payload_type) {
+          old_config.send_codec_spec->payload_type ||
+      new_config.shared_encoder != old_config.shared_encoder) {
     return SetupSendCodec(stream, new_config);
   }
 
@@ -339,7 +339,7 @@ TEST(AudioSendStreamTest, ConfigToString) {
       "send_codec_spec: {nack_enabled: true, transport_cc_enabled: false, "
       "cng_payload_type: 42, payload_type: 103, "
       "format: {name: isac, clockrate_hz: 16000, num_channels: 1, "
-      "parameters: {}}}}",
+      "parameters: {}}}, shared_encoder: nullptr}",
       config.ToString());
 }
 
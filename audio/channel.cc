@@ -190,6 +190,10 @@ class RtpPacketSenderProxy : public RtpPacketSender {
     RTC_NOTREACHED();
   }
 
+  void SetAudioFastLane(uint32_t ssrc, bool enabled) override {
+    RTC_NOTREACHED();
+  }
+
  private:
   rtc::ThreadChecker thread_checker_;
   rtc::CriticalSection crit_;
@@ -499,6 +503,12 @@ int Channel::PreferredSampleRate() const {
                   audio_coding_->PlayoutFrequency());
 }
 
+absl::optional<AudioMixer::Source::AudioLevel> Channel::ReceivedAudioLevel()
+    const {
+  rtc::CritScope lock(&received_audio_level_lock_);
+  return received_audio_level_;
+}
+
 Channel::Channel(rtc::TaskQueue* encoder_queue,
                  ProcessThread* module_process_thread,
                  AudioDeviceModule* audio_device_module,
@@ -867,6 +877,13 @@ void Channel::OnRtpPacket(const RtpPacketReceived& packet) {
   // Store playout timestamp for the received RTP packet
   UpdatePlayoutTimestamp(false);
 
+  if (header.extension.hasAudioLevel) {
+    rtc::CritScope lock(&received_audio_level_lock_);
+    received_audio_level_.emplace();
+    received_audio_level_->level_dbov = header.extension.audioLevel;
+    received_audio_level_->voice_activity = header.extension.voiceActivity;
+  }
+
   header.payload_type_frequency =
       rtp_payload_registry_->GetPayloadTypeFrequency(header.payloadType);
   if (header.payload_type_frequency >= 0) {
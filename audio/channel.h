@@ -266,6 +266,8 @@ class Channel
 
   int PreferredSampleRate() const;
 
+  absl::optional<AudioMixer::Source::AudioLevel> ReceivedAudioLevel() const;
+
   bool Playing() const { return channel_state_.Get().playing; }
   bool Sending() const { return channel_state_.Get().sending; }
   RtpRtcp* RtpRtcpModulePtr() const { return _rtpRtcpModule.get(); }
@@ -364,6 +366,12 @@ class Channel
 
   rtc::CriticalSection ts_stats_lock_;
 
+  // Level of the latest received packet, from the audio level header
+  // extension.
+  rtc::CriticalSection received_audio_level_lock_;
+  absl::optional<AudioMixer::Source::AudioLevel> received_audio_level_
+      RTC_GUARDED_BY(received_audio_level_lock_);
+
   std::unique_ptr<rtc::TimestampWrapAroundHandler> rtp_ts_wraparound_handler_;
   // The rtp timestamp of the first played out audio frame.
   int64_t capture_start_rtp_time_stamp_;
@@ -243,6 +243,12 @@ int ChannelProxy::PreferredSampleRate() const {
   return channel_->PreferredSampleRate();
 }
 
+absl::optional<AudioMixer::Source::AudioLevel>
+ChannelProxy::ReceivedAudioLevel() const {
+  RTC_DCHECK_RUNS_SERIALIZED(&audio_thread_race_checker_);
+  return channel_->ReceivedAudioLevel();
+}
+
 void ChannelProxy::ProcessAndEncodeAudio(
     std::unique_ptr<AudioFrame> audio_frame) {
   RTC_DCHECK_RUNS_SERIALIZED(&audio_thread_race_checker_);
@@ -73,6 +73,8 @@ class MockVoEChannelProxy : public voe::ChannelProxy {
                AudioMixer::Source::AudioFrameInfo(int sample_rate_hz,
                                                   AudioFrame* audio_frame));
   MOCK_CONST_METHOD0(PreferredSampleRate, int());
+  MOCK_CONST_METHOD0(ReceivedAudioLevel,
+                     absl::optional<AudioMixer::Source::AudioLevel>());
   // GMock doesn't like move-only types, like std::unique_ptr.
   virtual void ProcessAndEncodeAudio(std::unique_ptr<AudioFrame> audio_frame) {
     ProcessAndEncodeAudioForMock(&audio_frame);
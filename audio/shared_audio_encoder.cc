@@ -0,0 +1,437 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio/shared_audio_encoder.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "modules/include/module_common_types_public.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+// How far, in 10 ms blocks, a stream can lag behind the stream that is the
+// furthest ahead and still get the encoded audio of every block.
+constexpr size_t kNumBufferedBlocks = 8;
+
+}  // namespace
+
+// The encoder of one send stream. Calls from the stream are aggregated with
+// those of the other streams by the SharedAudioEncoder.
+class SharedAudioEncoder::StreamEncoder : public AudioEncoder {
+ public:
+  StreamEncoder(SharedAudioEncoder* shared_encoder,
+                int payload_type,
+                uint32_t first_timestamp)
+      : payload_type(payload_type),
+        first_timestamp(first_timestamp),
+        shared_encoder_(shared_encoder) {}
+
+  ~StreamEncoder() override { shared_encoder_->RemoveStream(this); }
+
+  int SampleRateHz() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->SampleRateHz();
+  }
+
+  size_t NumChannels() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->NumChannels();
+  }
+
+  int RtpTimestampRateHz() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->RtpTimestampRateHz();
+  }
+
+  size_t Num10MsFramesInNextPacket() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->Num10MsFramesInNextPacket();
+  }
+
+  size_t Max10MsFramesInAPacket() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->Max10MsFramesInAPacket();
+  }
+
+  int GetTargetBitrate() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->GetTargetBitrate();
+  }
+
+  // The input that the other streams have fed to the shared encoder is not
+  // discarded.
+  void Reset() override {}
+
+  bool SetFec(bool enable) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    fec = enable;
+    return shared_encoder_->UpdateFec();
+  }
+
+  bool SetDtx(bool enable) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    dtx = enable;
+    return shared_encoder_->UpdateDtx();
+  }
+
+  bool GetDtx() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->GetDtx();
+  }
+
+  bool SetApplication(Application application) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->SetApplication(application);
+  }
+
+  void SetMaxPlaybackRate(int frequency_hz) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    max_playback_rate_hz = frequency_hz;
+    shared_encoder_->UpdateMaxPlaybackRate();
+  }
+
+  bool EnableAudioNetworkAdaptor(const std::string& config_string,
+                                 RtcEventLog* event_log) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->EnableAudioNetworkAdaptor(config_string,
+                                                                event_log);
+  }
+
+  void DisableAudioNetworkAdaptor() override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    shared_encoder_->encoder_->DisableAudioNetworkAdaptor();
+  }
+
+  void OnReceivedUplinkPacketLossFraction(
+      float uplink_packet_loss_fraction) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    packet_loss_fraction = uplink_packet_loss_fraction;
+    shared_encoder_->UpdatePacketLoss();
+  }
+
+  void OnReceivedUplinkRecoverablePacketLossFraction(
+      float uplink_recoverable_packet_loss_fraction) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    recoverable_packet_loss_fraction = uplink_recoverable_packet_loss_fraction;
+    shared_encoder_->UpdateRecoverablePacketLoss();
+  }
+
+  void OnReceivedUplinkBandwidth(
+      int target_audio_bitrate_bps,
+      absl::optional<int64_t> bwe_period_ms) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    target_bitrate_bps = target_audio_bitrate_bps;
+    shared_encoder_->UpdateBitrate(bwe_period_ms);
+  }
+
+  void OnReceivedRtt(int rtt_ms) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    this->rtt_ms = rtt_ms;
+    shared_encoder_->UpdateRtt();
+  }
+
+  void OnReceivedOverhead(size_t overhead_bytes_per_packet) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    this->overhead_bytes_per_packet = overhead_bytes_per_packet;
+    shared_encoder_->UpdateOverhead();
+  }
+
+  void OnReceivedCpuUsage(int cpu_usage_percent) override {
+    // The CPU usage is the same for all the streams.
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    shared_encoder_->encoder_->OnReceivedCpuUsage(cpu_usage_percent);
+  }
+
+  void SetReceiverFrameLengthRange(int min_frame_length_ms,
+                                   int max_frame_length_ms) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    frame_length_range_ms =
+        std::make_pair(min_frame_length_ms, max_frame_length_ms);
+    shared_encoder_->UpdateFrameLengthRange();
+  }
+
+  ANAStats GetANAStats() const override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    return shared_encoder_->encoder_->GetANAStats();
+  }
+
+  const int payload_type;
+  // The timestamp of the first block encoded after the stream was added.
+  const uint32_t first_timestamp;
+
+  // Guarded by the |crit_| of the SharedAudioEncoder.
+  // Added to the RTP timestamps of the stream to get those of the shared
+  // encoder. Set when the stream encodes its first block.
+  absl::optional<uint32_t> timestamp_offset;
+  absl::optional<int> target_bitrate_bps;
+  absl::optional<float> packet_loss_fraction;
+  absl::optional<float> recoverable_packet_loss_fraction;
+  absl::optional<int> rtt_ms;
+  absl::optional<size_t> overhead_bytes_per_packet;
+  absl::optional<bool> fec;
+  absl::optional<bool> dtx;
+  absl::optional<int> max_playback_rate_hz;
+  absl::optional<std::pair<int, int>> frame_length_range_ms;
+
+ protected:
+  EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
+                         rtc::ArrayView<const int16_t> audio,
+                         rtc::Buffer* encoded) override {
+    return shared_encoder_->Encode(this, rtp_timestamp, audio, encoded);
+  }
+
+ private:
+  SharedAudioEncoder* const shared_encoder_;
+};
+
+SharedAudioEncoder::EncodedBlock::EncodedBlock() = default;
+SharedAudioEncoder::EncodedBlock::~EncodedBlock() = default;
+
+SharedAudioEncoder::SharedAudioEncoder() : blocks_(kNumBufferedBlocks) {}
+
+SharedAudioEncoder::~SharedAudioEncoder() {
+  RTC_DCHECK(streams_.empty());
+}
+
+std::unique_ptr<AudioEncoder> SharedAudioEncoder::CreateStreamEncoder(
+    int payload_type,
+    std::unique_ptr<AudioEncoder> encoder) {
+  RTC_DCHECK(encoder);
+  rtc::CritScope lock(&crit_);
+  if (!encoder_) {
+    RTC_DCHECK(streams_.empty());
+    encoder_ = std::move(encoder);
+  } else if (encoder->SampleRateHz() != encoder_->SampleRateHz() ||
+             encoder->NumChannels() != encoder_->NumChannels()) {
+    RTC_LOG(LS_WARNING) << "Stream encoder does not match the shared encoder, "
+                           "encoding the stream separately.";
+    return encoder;
+  }
+  auto stream =
+      absl::make_unique<StreamEncoder>(this, payload_type, next_timestamp_);
+  streams_.push_back(stream.get());
+  RTC_LOG(LS_INFO) << "Added stream to shared audio encoder, "
+                   << streams_.size() << " streams.";
+  return std::move(stream);
+}
+
+size_t SharedAudioEncoder::NumStreamsForTesting() const {
+  rtc::CritScope lock(&crit_);
+  return streams_.size();
+}
+
+void SharedAudioEncoder::RemoveStream(StreamEncoder* stream) {
+  rtc::CritScope lock(&crit_);
+  auto it = std::find(streams_.begin(), streams_.end(), stream);
+  RTC_DCHECK(it != streams_.end());
+  streams_.erase(it);
+  if (!streams_.empty()) {
+    // The remaining streams may be less constrained.
+    UpdateAll();
+    return;
+  }
+  encoder_.reset();
+  next_timestamp_ = 0;
+  for (EncodedBlock& block : blocks_)
+    block.valid = false;
+}
+
+AudioEncoder::EncodedInfo SharedAudioEncoder::Encode(
+    StreamEncoder* stream,
+    uint32_t rtp_timestamp,
+    rtc::ArrayView<const int16_t> audio,
+    rtc::Buffer* encoded) {
+  rtc::CritScope lock(&crit_);
+  const uint32_t timestamps_per_block = encoder_->RtpTimestampRateHz() / 100;
+  if (!stream->timestamp_offset) {
+    // A new stream starts with the first block encoded after it was added, or
+    // with the next block to be encoded if that one is no longer buffered.
+    const uint32_t first_timestamp = FindBlock(stream->first_timestamp)
+                                         ? stream->first_timestamp
+                                         : next_timestamp_;
+    stream->timestamp_offset = first_timestamp - rtp_timestamp;
+  }
+  const uint32_t timestamp = rtp_timestamp + *stream->timestamp_offset;
+
+  const EncodedBlock* block = FindBlock(timestamp);
+  if (!block) {
+    if (timestamp != next_timestamp_ &&
+        !IsNewerTimestamp(timestamp, next_timestamp_)) {
+      // The block has already been dropped from |blocks_|. Skip it, and
+      // continue with the next block to be encoded.
+      RTC_LOG(LS_WARNING) << "Stream lags behind the shared audio encoder, "
+                             "dropping a block.";
+      stream->timestamp_offset =
+          next_timestamp_ - timestamps_per_block - rtp_timestamp;
+      return AudioEncoder::EncodedInfo();
+    }
+    // This stream is the first to ask for the block. Any block that was
+    // skipped since the last one is not encoded.
+    EncodedBlock& new_block = blocks_[next_block_];
+    next_block_ = (next_block_ + 1) % blocks_.size();
+    new_block.payload.Clear();
+    new_block.info = encoder_->Encode(timestamp, audio, &new_block.payload);
+    new_block.timestamp = timestamp;
+    new_block.valid = true;
+    next_timestamp_ = timestamp + timestamps_per_block;
+    block = &new_block;
+  }
+
+  encoded->AppendData(block->payload);
+  AudioEncoder::EncodedInfo info = block->info;
+  info.encoded_timestamp -= *stream->timestamp_offset;
+  info.payload_type = stream->payload_type;
+  for (AudioEncoder::EncodedInfoLeaf& redundant : info.redundant)
+    redundant.encoded_timestamp -= *stream->timestamp_offset;
+  return info;
+}
+
+const SharedAudioEncoder::EncodedBlock* SharedAudioEncoder::FindBlock(
+    uint32_t timestamp) const {
+  for (const EncodedBlock& block : blocks_) {
+    if (block.valid && block.timestamp == timestamp)
+      return &block;
+  }
+  return nullptr;
+}
+
+void SharedAudioEncoder::UpdateBitrate(
+    absl::optional<int64_t> bwe_period_ms) {
+  absl::optional<int> target_bitrate_bps;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->target_bitrate_bps) {
+      target_bitrate_bps = std::min(
+          target_bitrate_bps.value_or(*stream->target_bitrate_bps),
+          *stream->target_bitrate_bps);
+    }
+  }
+  if (target_bitrate_bps)
+    encoder_->OnReceivedUplinkBandwidth(*target_bitrate_bps, bwe_period_ms);
+}
+
+void SharedAudioEncoder::UpdatePacketLoss() {
+  absl::optional<float> packet_loss_fraction;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->packet_loss_fraction) {
+      packet_loss_fraction = std::max(packet_loss_fraction.value_or(0.f),
+                                      *stream->packet_loss_fraction);
+    }
+  }
+  if (packet_loss_fraction)
+    encoder_->OnReceivedUplinkPacketLossFraction(*packet_loss_fraction);
+}
+
+void SharedAudioEncoder::UpdateRecoverablePacketLoss() {
+  absl::optional<float> packet_loss_fraction;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->recoverable_packet_loss_fraction) {
+      packet_loss_fraction =
+          std::max(packet_loss_fraction.value_or(0.f),
+                   *stream->recoverable_packet_loss_fraction);
+    }
+  }
+  if (packet_loss_fraction) {
+    encoder_->OnReceivedUplinkRecoverablePacketLossFraction(
+        *packet_loss_fraction);
+  }
+}
+
+void SharedAudioEncoder::UpdateRtt() {
+  absl::optional<int> rtt_ms;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->rtt_ms)
+      rtt_ms = std::max(rtt_ms.value_or(0), *stream->rtt_ms);
+  }
+  if (rtt_ms)
+    encoder_->OnReceivedRtt(*rtt_ms);
+}
+
+void SharedAudioEncoder::UpdateOverhead() {
+  absl::optional<size_t> overhead_bytes_per_packet;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->overhead_bytes_per_packet) {
+      overhead_bytes_per_packet =
+          std::max(overhead_bytes_per_packet.value_or(0),
+                   *stream->overhead_bytes_per_packet);
+    }
+  }
+  if (overhead_bytes_per_packet)
+    encoder_->OnReceivedOverhead(*overhead_bytes_per_packet);
+}
+
+bool SharedAudioEncoder::UpdateFec() {
+  absl::optional<bool> fec;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->fec)
+      fec = fec.value_or(false) || *stream->fec;
+  }
+  return !fec || encoder_->SetFec(*fec);
+}
+
+bool SharedAudioEncoder::UpdateDtx() {
+  absl::optional<bool> dtx;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->dtx)
+      dtx = dtx.value_or(true) && *stream->dtx;
+  }
+  return !dtx || encoder_->SetDtx(*dtx);
+}
+
+void SharedAudioEncoder::UpdateMaxPlaybackRate() {
+  absl::optional<int> max_playback_rate_hz;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->max_playback_rate_hz) {
+      max_playback_rate_hz =
+          std::min(max_playback_rate_hz.value_or(*stream->max_playback_rate_hz),
+                   *stream->max_playback_rate_hz);
+    }
+  }
+  if (max_playback_rate_hz)
+    encoder_->SetMaxPlaybackRate(*max_playback_rate_hz);
+}
+
+void SharedAudioEncoder::UpdateFrameLengthRange() {
+  // The frame lengths that all the receivers accept.
+  absl::optional<std::pair<int, int>> range_ms;
+  for (const StreamEncoder* stream : streams_) {
+    if (!stream->frame_length_range_ms)
+      continue;
+    if (!range_ms) {
+      range_ms = stream->frame_length_range_ms;
+    } else {
+      range_ms->first =
+          std::max(range_ms->first, stream->frame_length_range_ms->first);
+      range_ms->second =
+          std::min(range_ms->second, stream->frame_length_range_ms->second);
+    }
+  }
+  if (range_ms && range_ms->first <= range_ms->second)
+    encoder_->SetReceiverFrameLengthRange(range_ms->first, range_ms->second);
+}
+
+void SharedAudioEncoder::UpdateAll() {
+  UpdateBitrate(absl::nullopt);
+  UpdatePacketLoss();
+  UpdateRecoverablePacketLoss();
+  UpdateRtt();
+  UpdateOverhead();
+  UpdateFec();
+  UpdateDtx();
+  UpdateMaxPlaybackRate();
+  UpdateFrameLengthRange();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef AUDIO_SHARED_AUDIO_ENCODER_H_
+#define AUDIO_SHARED_AUDIO_ENCODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/audio_codecs/audio_encoder.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Encodes the audio of one source once for several AudioSendStreams, e.g. when
+// the same mixed audio is sent to many receivers over separate
+// PeerConnections. Set as AudioSendStream::Config::shared_encoder of each of
+// the streams, which then packetize and send the same encoded audio
+// independently, instead of each encoding it with its own AudioEncoder.
+//
+// Each 10 ms block is encoded by the first stream that asks for it, and the
+// output is handed to the others when they ask for the same block. The streams
+// must therefore be fed identical audio. Each stream keeps its own RTP
+// timestamps and payload type.
+//
+// Since all the streams send the same encoding, the network adaptation of the
+// encoder is the one of the most constrained stream: it runs at the lowest
+// target bitrate, with the highest packet loss, round trip time and overhead
+// among the streams. FEC is enabled if any stream enables it, and DTX only if
+// all the streams that have set it enable it. Other settings, such as the
+// audio network adaptor, apply to all the streams.
+//
+// The shared encoder must outlive the streams. It is thread safe.
+class SharedAudioEncoder {
+ public:
+  SharedAudioEncoder();
+  ~SharedAudioEncoder();
+
+  // Returns the encoder used by one send stream, which sends the encoded audio
+  // with |payload_type|. Takes |encoder| as the shared encoder if the stream is
+  // the only one, and otherwise discards it. If |encoder| has a different
+  // sample rate or number of channels than the shared encoder, it is returned
+  // as is and the stream encodes on its own.
+  std::unique_ptr<AudioEncoder> CreateStreamEncoder(
+      int payload_type,
+      std::unique_ptr<AudioEncoder> encoder);
+
+  size_t NumStreamsForTesting() const;
+
+ private:
+  class StreamEncoder;
+
+  // The output of encoding one 10 ms block.
+  struct EncodedBlock {
+    EncodedBlock();
+    ~EncodedBlock();
+
+    bool valid = false;
+    uint32_t timestamp = 0;
+    rtc::Buffer payload;
+    AudioEncoder::EncodedInfo info;
+  };
+
+  void RemoveStream(StreamEncoder* stream);
+  AudioEncoder::EncodedInfo Encode(StreamEncoder* stream,
+                                   uint32_t rtp_timestamp,
+                                   rtc::ArrayView<const int16_t> audio,
+                                   rtc::Buffer* encoded);
+  const EncodedBlock* FindBlock(uint32_t timestamp) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Apply the settings of all the streams to |encoder_|.
+  void UpdateBitrate(absl::optional<int64_t> probing_interval_ms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdatePacketLoss() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateRecoverablePacketLoss() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateRtt() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateOverhead() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  bool UpdateFec() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  bool UpdateDtx() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateMaxPlaybackRate() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateFrameLengthRange() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateAll() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  rtc::CriticalSection crit_;
+  std::unique_ptr<AudioEncoder> encoder_ RTC_GUARDED_BY(crit_);
+  std::vector<StreamEncoder*> streams_ RTC_GUARDED_BY(crit_);
+  // The blocks are encoded with timestamps of their own, which the timestamps
+  // of each stream are mapped to.
+  uint32_t next_timestamp_ RTC_GUARDED_BY(crit_) = 0;
+  // The most recently encoded blocks, which the streams that have not yet
+  // asked for them can still get.
+  std::vector<EncodedBlock> blocks_ RTC_GUARDED_BY(crit_);
+  size_t next_block_ RTC_GUARDED_BY(crit_) = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedAudioEncoder);
+};
+
+}  // namespace webrtc
+
+#endif  // AUDIO_SHARED_AUDIO_ENCODER_H_
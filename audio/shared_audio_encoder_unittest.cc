@@ -0,0 +1,182 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio/shared_audio_encoder.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/mock_audio_encoder.h"
+
+namespace webrtc {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+constexpr int kSampleRateHz = 48000;
+constexpr int kSamplesPer10Ms = kSampleRateHz / 100;
+constexpr int kPayloadType1 = 111;
+constexpr int kPayloadType2 = 96;
+
+std::unique_ptr<NiceMock<MockAudioEncoder>> CreateMockEncoder(
+    int sample_rate_hz) {
+  auto encoder = absl::make_unique<NiceMock<MockAudioEncoder>>();
+  ON_CALL(*encoder, SampleRateHz()).WillByDefault(Return(sample_rate_hz));
+  ON_CALL(*encoder, RtpTimestampRateHz()).WillByDefault(Return(sample_rate_hz));
+  ON_CALL(*encoder, NumChannels()).WillByDefault(Return(1));
+  ON_CALL(*encoder, Max10MsFramesInAPacket()).WillByDefault(Return(1));
+  ON_CALL(*encoder, Num10MsFramesInNextPacket()).WillByDefault(Return(1));
+  return encoder;
+}
+
+// Encodes each block into a single byte, the first sample of the block, and
+// timestamps it in the timeline of the encoder.
+AudioEncoder::EncodedInfo EncodeFirstSample(uint32_t timestamp,
+                                            rtc::ArrayView<const int16_t> audio,
+                                            rtc::Buffer* encoded) {
+  encoded->AppendData(static_cast<uint8_t>(audio[0]));
+  AudioEncoder::EncodedInfo info;
+  info.encoded_bytes = 1;
+  info.encoded_timestamp = timestamp;
+  return info;
+}
+
+}  // namespace
+
+TEST(SharedAudioEncoderTest, EncodesEachBlockOnce) {
+  SharedAudioEncoder shared_encoder;
+  auto mock_encoder = CreateMockEncoder(kSampleRateHz);
+  EXPECT_CALL(*mock_encoder, EncodeImpl(_, _, _))
+      .Times(3)
+      .WillRepeatedly(Invoke(EncodeFirstSample));
+  std::unique_ptr<AudioEncoder> encoder1 = shared_encoder.CreateStreamEncoder(
+      kPayloadType1, std::move(mock_encoder));
+  std::unique_ptr<AudioEncoder> encoder2 = shared_encoder.CreateStreamEncoder(
+      kPayloadType2, CreateMockEncoder(kSampleRateHz));
+  EXPECT_EQ(2u, shared_encoder.NumStreamsForTesting());
+
+  // The streams start at different RTP timestamps.
+  const uint32_t kStartTimestamp1 = 1000;
+  const uint32_t kStartTimestamp2 = 0xFFFFFF00;
+  std::vector<int16_t> audio(kSamplesPer10Ms);
+  for (int k = 0; k < 3; ++k) {
+    audio[0] = k + 1;
+    rtc::Buffer encoded1;
+    rtc::Buffer encoded2;
+    const AudioEncoder::EncodedInfo info1 = encoder1->Encode(
+        kStartTimestamp1 + k * kSamplesPer10Ms, audio, &encoded1);
+    const AudioEncoder::EncodedInfo info2 = encoder2->Encode(
+        kStartTimestamp2 + k * kSamplesPer10Ms, audio, &encoded2);
+
+    ASSERT_EQ(1u, encoded1.size());
+    EXPECT_EQ(encoded1, encoded2);
+    EXPECT_EQ(k + 1, encoded1[0]);
+    EXPECT_EQ(kPayloadType1, info1.payload_type);
+    EXPECT_EQ(kPayloadType2, info2.payload_type);
+    EXPECT_EQ(kStartTimestamp1 + k * kSamplesPer10Ms, info1.encoded_timestamp);
+    EXPECT_EQ(kStartTimestamp2 + k * kSamplesPer10Ms, info2.encoded_timestamp);
+  }
+
+  encoder2.reset();
+  EXPECT_EQ(1u, shared_encoder.NumStreamsForTesting());
+  encoder1.reset();
+  EXPECT_EQ(0u, shared_encoder.NumStreamsForTesting());
+}
+
+TEST(SharedAudioEncoderTest, LaggingStreamGetsTheBlocksEncodedBefore) {
+  SharedAudioEncoder shared_encoder;
+  auto mock_encoder = CreateMockEncoder(kSampleRateHz);
+  EXPECT_CALL(*mock_encoder, EncodeImpl(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke(EncodeFirstSample));
+  std::unique_ptr<AudioEncoder> encoder1 = shared_encoder.CreateStreamEncoder(
+      kPayloadType1, std::move(mock_encoder));
+  std::unique_ptr<AudioEncoder> encoder2 = shared_encoder.CreateStreamEncoder(
+      kPayloadType2, CreateMockEncoder(kSampleRateHz));
+
+  std::vector<int16_t> audio(kSamplesPer10Ms);
+  rtc::Buffer encoded1;
+  audio[0] = 1;
+  encoder1->Encode(0, audio, &encoded1);
+  audio[0] = 2;
+  encoder1->Encode(kSamplesPer10Ms, audio, &encoded1);
+
+  // The second stream asks for the same blocks later, with other audio, and
+  // gets the same encoding.
+  rtc::Buffer encoded2;
+  audio[0] = 3;
+  encoder2->Encode(0, audio, &encoded2);
+  encoder2->Encode(kSamplesPer10Ms, audio, &encoded2);
+  EXPECT_EQ(encoded1, encoded2);
+}
+
+TEST(SharedAudioEncoderTest, TargetBitrateIsTheLowestOfTheStreams) {
+  SharedAudioEncoder shared_encoder;
+  auto mock_encoder = CreateMockEncoder(kSampleRateHz);
+  MockAudioEncoder* mock_encoder_ptr = mock_encoder.get();
+  std::unique_ptr<AudioEncoder> encoder1 = shared_encoder.CreateStreamEncoder(
+      kPayloadType1, std::move(mock_encoder));
+  std::unique_ptr<AudioEncoder> encoder2 = shared_encoder.CreateStreamEncoder(
+      kPayloadType2, CreateMockEncoder(kSampleRateHz));
+
+  EXPECT_CALL(*mock_encoder_ptr, OnReceivedUplinkBandwidth(32000, _));
+  encoder1->OnReceivedUplinkBandwidth(32000, absl::nullopt);
+  EXPECT_CALL(*mock_encoder_ptr, OnReceivedUplinkBandwidth(24000, _));
+  encoder2->OnReceivedUplinkBandwidth(24000, absl::nullopt);
+  EXPECT_CALL(*mock_encoder_ptr, OnReceivedUplinkBandwidth(24000, _));
+  encoder1->OnReceivedUplinkBandwidth(40000, absl::nullopt);
+  testing::Mock::VerifyAndClearExpectations(mock_encoder_ptr);
+
+  // Without the most constrained stream, the encoder follows the other one.
+  EXPECT_CALL(*mock_encoder_ptr, OnReceivedUplinkBandwidth(40000, _));
+  encoder2.reset();
+}
+
+TEST(SharedAudioEncoderTest, FecAndPacketLossFollowTheWorstStream) {
+  SharedAudioEncoder shared_encoder;
+  auto mock_encoder = CreateMockEncoder(kSampleRateHz);
+  MockAudioEncoder* mock_encoder_ptr = mock_encoder.get();
+  std::unique_ptr<AudioEncoder> encoder1 = shared_encoder.CreateStreamEncoder(
+      kPayloadType1, std::move(mock_encoder));
+  std::unique_ptr<AudioEncoder> encoder2 = shared_encoder.CreateStreamEncoder(
+      kPayloadType2, CreateMockEncoder(kSampleRateHz));
+
+  EXPECT_CALL(*mock_encoder_ptr, SetFec(true)).WillOnce(Return(true));
+  EXPECT_TRUE(encoder1->SetFec(true));
+  EXPECT_CALL(*mock_encoder_ptr, SetFec(true)).WillOnce(Return(true));
+  encoder2->SetFec(false);
+
+  EXPECT_CALL(*mock_encoder_ptr, OnReceivedUplinkPacketLossFraction(0.1f));
+  encoder1->OnReceivedUplinkPacketLossFraction(0.1f);
+  EXPECT_CALL(*mock_encoder_ptr, OnReceivedUplinkPacketLossFraction(0.1f));
+  encoder2->OnReceivedUplinkPacketLossFraction(0.05f);
+  testing::Mock::VerifyAndClearExpectations(mock_encoder_ptr);
+}
+
+TEST(SharedAudioEncoderTest, DoesNotShareEncoderWithOtherSampleRate) {
+  SharedAudioEncoder shared_encoder;
+  std::unique_ptr<AudioEncoder> encoder1 = shared_encoder.CreateStreamEncoder(
+      kPayloadType1, CreateMockEncoder(kSampleRateHz));
+  auto mock_encoder = CreateMockEncoder(16000);
+  AudioEncoder* mock_encoder_ptr = mock_encoder.get();
+  std::unique_ptr<AudioEncoder> encoder2 = shared_encoder.CreateStreamEncoder(
+      kPayloadType2, std::move(mock_encoder));
+  EXPECT_EQ(mock_encoder_ptr, encoder2.get());
+  EXPECT_EQ(1u, shared_encoder.NumStreamsForTesting());
+}
+
+}  // namespace webrtc
@@ -30,8 +30,12 @@ std::string AudioSendStream::Config::ToString() const {
   ss << ", send_transport: " << (send_transport ? "(Transport)" : "null");
   ss << ", min_bitrate_bps: " << min_bitrate_bps;
   ss << ", max_bitrate_bps: " << max_bitrate_bps;
+  if (pacer_fast_lane)
+    ss << ", pacer_fast_lane: on";
   ss << ", send_codec_spec: "
      << (send_codec_spec ? send_codec_spec->ToString() : "<unset>");
+  ss << ", shared_encoder: "
+     << (shared_encoder ? "(SharedAudioEncoder)" : "nullptr");
   ss << '}';
   return ss.str();
 }
@@ -28,6 +28,8 @@
 
 namespace webrtc {
 
+class SharedAudioEncoder;
+
 class AudioFrame;
 
 class AudioSendStream {
@@ -99,6 +101,12 @@ class AudioSendStream {
 
     double bitrate_priority = 1.0;
 
+    // If set, packets are sent to the network on the encoding thread whenever
+    // the pacer has budget for them, instead of from the pacer queue, where
+    // they can wait behind bursts of video. Sent bytes still count against
+    // the pacing budget if audio is accounted for.
+    bool pacer_fast_lane = false;
+
     // Defines whether to turn on audio network adaptor, and defines its config
     // string.
     absl::optional<std::string> audio_network_adaptor_config;
@@ -128,6 +136,12 @@ class AudioSendStream {
 
     // Track ID as specified during track creation.
     std::string track_id;
+
+    // If set, the stream sends the audio encoded by this encoder, which is
+    // shared with the other streams that have it set, instead of encoding its
+    // audio itself. The encoder made from |send_codec_spec| is only used by
+    // the first stream. Must outlive the stream.
+    SharedAudioEncoder* shared_encoder = nullptr;
   };
 
   virtual ~AudioSendStream() = default;
@@ -63,7 +63,9 @@ BitrateAllocator::BitrateAllocator(LimitObserver* limit_observer)
       has_packet_feedback_(false),
       bitrate_allocation_strategy_(nullptr),
       transmission_max_bitrate_multiplier_(
-          GetTransmissionMaxBitrateMultiplier()) {
+          GetTransmissionMaxBitrateMultiplier()),
+      skip_unchanged_network_updates_(webrtc::field_trial::IsEnabled(
+          "WebRTC-BitrateAllocator-SkipUnchangedUpdates")) {
   sequenced_checker_.Detach();
 }
 
@@ -109,8 +111,11 @@ void BitrateAllocator::OnNetworkChanged(uint32_t target_bitrate_bps,
 
   for (auto& config : bitrate_observer_configs_) {
     uint32_t allocated_bitrate = allocation[config.observer];
-    uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
-        allocated_bitrate, last_fraction_loss_, last_rtt_, last_bwe_period_ms_);
+    uint32_t protection_bitrate = 0;
+    if (!UpdateObserver(&config, allocated_bitrate,
+                        skip_unchanged_network_updates_, &protection_bitrate)) {
+      continue;
+    }
 
     if (allocated_bitrate == 0 && config.allocated_bitrate_bps > 0) {
       if (target_bitrate_bps > 0)
@@ -168,9 +173,13 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
     allocation = AllocateBitrates(last_bitrate_bps_);
     for (auto& config : bitrate_observer_configs_) {
       uint32_t allocated_bitrate = allocation[config.observer];
-      uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
-          allocated_bitrate, last_fraction_loss_, last_rtt_,
-          last_bwe_period_ms_);
+      uint32_t protection_bitrate = 0;
+      // Only the new observer and the ones whose allocation changed need an
+      // update; the network state is the same.
+      if (!UpdateObserver(&config, allocated_bitrate, true,
+                          &protection_bitrate)) {
+        continue;
+      }
       config.allocated_bitrate_bps = allocated_bitrate;
       if (allocated_bitrate > 0)
         config.media_ratio = MediaRatio(allocated_bitrate, protection_bitrate);
@@ -186,6 +195,24 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
   UpdateAllocationLimits();
 }
 
+bool BitrateAllocator::UpdateObserver(ObserverConfig* config,
+                                      uint32_t allocated_bitrate,
+                                      bool skip_if_unchanged,
+                                      uint32_t* protection_bitrate) {
+  if (skip_if_unchanged && config->allocated_bitrate_bps == allocated_bitrate &&
+      config->notified_fraction_loss == last_fraction_loss_ &&
+      config->notified_rtt == last_rtt_ &&
+      config->notified_bwe_period_ms == last_bwe_period_ms_) {
+    return false;
+  }
+  *protection_bitrate = config->observer->OnBitrateUpdated(
+      allocated_bitrate, last_fraction_loss_, last_rtt_, last_bwe_period_ms_);
+  config->notified_fraction_loss = last_fraction_loss_;
+  config->notified_rtt = last_rtt_;
+  config->notified_bwe_period_ms = last_bwe_period_ms_;
+  return true;
+}
+
 void BitrateAllocator::UpdateAllocationLimits() {
   uint32_t total_requested_padding_bitrate = 0;
   uint32_t total_requested_min_bitrate = 0;
@@ -157,6 +157,11 @@ class BitrateAllocator : public BitrateAllocatorInterface {
     // observers, it should be allocated twice the bitrate above its min.
     double bitrate_priority;
     bool has_packet_feedback;
+    // The network state that the observer was last updated with, along with
+    // |allocated_bitrate_bps|.
+    uint8_t notified_fraction_loss = 0;
+    int64_t notified_rtt = 0;
+    int64_t notified_bwe_period_ms = 0;
 
     uint32_t LastAllocatedBitrate() const;
     // The minimum bitrate required by this observer, including
@@ -164,6 +169,17 @@ class BitrateAllocator : public BitrateAllocatorInterface {
     uint32_t MinBitrateWithHysteresis() const;
   };
 
+  // Calls OnBitrateUpdated() on the observer of |config|. If
+  // |skip_if_unchanged|, the call is skipped when the observer was last
+  // updated with the same allocation and network state, which keeps adding a
+  // stream to a call, or a network update that moves few allocations, from
+  // reconfiguring every encoder. Returns false if skipped.
+  bool UpdateObserver(ObserverConfig* config,
+                      uint32_t allocated_bitrate,
+                      bool skip_if_unchanged,
+                      uint32_t* protection_bitrate)
+      RTC_RUN_ON(&sequenced_checker_);
+
   // Calculates the minimum requested send bitrate and max padding bitrate and
   // calls LimitObserver::OnAllocationLimitsChanged.
   void UpdateAllocationLimits() RTC_RUN_ON(&sequenced_checker_);
@@ -246,6 +262,10 @@ class BitrateAllocator : public BitrateAllocatorInterface {
   std::unique_ptr<rtc::BitrateAllocationStrategy> bitrate_allocation_strategy_
       RTC_GUARDED_BY(&sequenced_checker_);
   const uint8_t transmission_max_bitrate_multiplier_;
+  // Observers report the protection bitrate, which also depends on their own
+  // state, and which the allocator then learns less often, so skipping
+  // unchanged allocations on network updates is behind a field trial.
+  const bool skip_unchanged_network_updates_;
 };
 
 }  // namespace webrtc
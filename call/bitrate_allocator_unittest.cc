@@ -14,6 +14,7 @@
 
 #include "call/bitrate_allocator.h"
 #include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -52,7 +53,8 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
         last_fraction_loss_(0),
         last_rtt_ms_(0),
         last_probing_interval_ms_(0),
-        protection_ratio_(0.0) {}
+        protection_ratio_(0.0),
+        num_updates_(0) {}
 
   void SetBitrateProtectionRatio(double protection_ratio) {
     protection_ratio_ = protection_ratio;
@@ -66,6 +68,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
     last_fraction_loss_ = fraction_loss;
     last_rtt_ms_ = rtt;
     last_probing_interval_ms_ = probing_interval_ms;
+    ++num_updates_;
     return bitrate_bps * protection_ratio_;
   }
   uint32_t last_bitrate_bps_;
@@ -73,6 +76,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
   int64_t last_rtt_ms_;
   int last_probing_interval_ms_;
   double protection_ratio_;
+  int num_updates_;
 };
 
 namespace {
@@ -594,6 +598,76 @@ TEST_F(BitrateAllocatorTest, PassProbingInterval) {
   allocator_->RemoveObserver(&observer);
 }
 
+TEST_F(BitrateAllocatorTest, AddObserverOnlyUpdatesChangedObservers) {
+  TestBitrateObserver observer_1;
+  TestBitrateObserver observer_2;
+  TestBitrateObserver observer_3;
+  AddObserver(&observer_1, 100000, 100000, 0, true, "",
+              kDefaultBitratePriority);
+  AddObserver(&observer_2, 100000, 1000000, 0, true, "",
+              kDefaultBitratePriority);
+  EXPECT_EQ(2, observer_1.num_updates_);
+  EXPECT_EQ(1, observer_2.num_updates_);
+  EXPECT_EQ(100000u, observer_1.last_bitrate_bps_);
+  EXPECT_EQ(200000u, observer_2.last_bitrate_bps_);
+
+  // Observer 2 loses bitrate to observer 3, observer 1 is still at its max
+  // and isn't updated.
+  AddObserver(&observer_3, 100000, 1000000, 0, true, "",
+              kDefaultBitratePriority);
+  EXPECT_EQ(2, observer_1.num_updates_);
+  EXPECT_EQ(2, observer_2.num_updates_);
+  EXPECT_EQ(1, observer_3.num_updates_);
+  EXPECT_EQ(100000u, observer_2.last_bitrate_bps_);
+  EXPECT_EQ(100000u, observer_3.last_bitrate_bps_);
+
+  // Network updates reach every observer.
+  allocator_->OnNetworkChanged(300000, 0, 0, kDefaultProbingIntervalMs);
+  EXPECT_EQ(3, observer_1.num_updates_);
+  EXPECT_EQ(3, observer_2.num_updates_);
+  EXPECT_EQ(2, observer_3.num_updates_);
+
+  allocator_->RemoveObserver(&observer_1);
+  allocator_->RemoveObserver(&observer_2);
+  allocator_->RemoveObserver(&observer_3);
+}
+
+TEST(BitrateAllocatorSkipUnchangedTest, SkipsUnchangedNetworkUpdates) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-BitrateAllocator-SkipUnchangedUpdates/Enabled/");
+  NiceMock<MockLimitObserver> limit_observer;
+  BitrateAllocator allocator(&limit_observer);
+  allocator.OnNetworkChanged(300000, 0, 0, kDefaultProbingIntervalMs);
+  TestBitrateObserver observer_1;
+  TestBitrateObserver observer_2;
+  allocator.AddObserver(&observer_1, {100000, 100000, 0, true, "",
+                                      kDefaultBitratePriority, false});
+  allocator.AddObserver(&observer_2, {100000, 500000, 0, true, "",
+                                      kDefaultBitratePriority, false});
+  EXPECT_EQ(2, observer_1.num_updates_);
+  EXPECT_EQ(1, observer_2.num_updates_);
+
+  // A repeated update changes nothing.
+  allocator.OnNetworkChanged(300000, 0, 0, kDefaultProbingIntervalMs);
+  EXPECT_EQ(2, observer_1.num_updates_);
+  EXPECT_EQ(1, observer_2.num_updates_);
+
+  // Only observer 2 takes the extra bitrate.
+  allocator.OnNetworkChanged(400000, 0, 0, kDefaultProbingIntervalMs);
+  EXPECT_EQ(2, observer_1.num_updates_);
+  EXPECT_EQ(2, observer_2.num_updates_);
+  EXPECT_EQ(300000u, observer_2.last_bitrate_bps_);
+
+  // A change of the network state reaches both.
+  allocator.OnNetworkChanged(400000, 10, 0, kDefaultProbingIntervalMs);
+  EXPECT_EQ(3, observer_1.num_updates_);
+  EXPECT_EQ(3, observer_2.num_updates_);
+  EXPECT_EQ(10, observer_1.last_fraction_loss_);
+
+  allocator.RemoveObserver(&observer_1);
+  allocator.RemoveObserver(&observer_2);
+}
+
 TEST_F(BitrateAllocatorTest, PriorityRateOneObserverBasic) {
   TestBitrateObserver observer;
   const uint32_t kMinSendBitrateBps = 10;
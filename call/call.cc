@@ -29,6 +29,7 @@
 #include "call/receive_time_calculator.h"
 #include "call/rtp_stream_receiver_controller.h"
 #include "call/rtp_transport_controller_send.h"
+#include "call/ssrc_table.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_receive_stream_config.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_send_stream_config.h"
 #include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
@@ -61,6 +62,7 @@
 #include "system_wrappers/include/cpu_info.h"
 #include "system_wrappers/include/metrics.h"
 #include "video/call_stats.h"
+#include "video/rtp_streams_sync_service.h"
 #include "video/send_delay_stats.h"
 #include "video/stats_counter.h"
 #include "video/video_receive_stream.h"
@@ -246,8 +248,8 @@ class Call final : public webrtc::Call,
       RTC_EXCLUSIVE_LOCKS_REQUIRED(receive_crit_);
 
   void NotifyBweOfReceivedPacket(const RtpPacketReceived& packet,
-                                 MediaType media_type)
-      RTC_SHARED_LOCKS_REQUIRED(receive_crit_);
+                                 MediaType media_type,
+                                 bool use_send_side_bwe);
 
   void UpdateSendHistograms(int64_t first_sent_packet_ms)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(&bitrate_crit_);
@@ -260,6 +262,8 @@ class Call final : public webrtc::Call,
   const int num_cpu_cores_;
   const std::unique_ptr<ProcessThread> module_process_thread_;
   const std::unique_ptr<CallStats> call_stats_;
+  // Syncs the video receive streams with their audio streams.
+  RtpStreamsSyncService rtp_streams_sync_service_;
   const std::unique_ptr<BitrateAllocator> bitrate_allocator_;
   Call::Config config_;
   rtc::SequencedTaskChecker configuration_sequence_checker_;
@@ -311,8 +315,10 @@ class Call final : public webrtc::Call,
     // send side BWE are negotiated.
     const bool use_send_side_bwe;
   };
-  std::map<uint32_t, ReceiveRtpConfig> receive_rtp_config_
-      RTC_GUARDED_BY(receive_crit_);
+  // Looked up for every received packet without taking |receive_crit_|.
+  // Modified only with |receive_crit_| held, which serializes the writers.
+  using ReceiveRtpConfigTable = ConcurrentSsrcTable<ReceiveRtpConfig>;
+  ReceiveRtpConfigTable receive_rtp_config_;
 
   std::unique_ptr<RWLockWrapper> send_crit_;
   // Audio and Video send streams are owned by the client that creates them.
@@ -454,6 +460,8 @@ Call::Call(const Call::Config& config,
       receive_side_cc_.GetRemoteBitrateEstimator(true), RTC_FROM_HERE);
   module_process_thread_->RegisterModule(call_stats_.get(), RTC_FROM_HERE);
   module_process_thread_->RegisterModule(&receive_side_cc_, RTC_FROM_HERE);
+  module_process_thread_->RegisterModule(&rtp_streams_sync_service_,
+                                         RTC_FROM_HERE);
   module_process_thread_->Start();
 }
 
@@ -470,6 +478,7 @@ Call::~Call() {
       receive_side_cc_.GetRemoteBitrateEstimator(true));
   module_process_thread_->DeRegisterModule(&receive_side_cc_);
   module_process_thread_->DeRegisterModule(call_stats_.get());
+  module_process_thread_->DeRegisterModule(&rtp_streams_sync_service_);
   module_process_thread_->Stop();
   call_stats_->DeregisterStatsObserver(&receive_side_cc_);
   call_stats_->DeregisterStatsObserver(transport_send_->GetCallStatsObserver());
@@ -654,7 +663,7 @@ webrtc::AudioReceiveStream* Call::CreateAudioReceiveStream(
       module_process_thread_.get(), config, config_.audio_state, event_log_);
   {
     WriteLockScoped write_lock(*receive_crit_);
-    receive_rtp_config_.emplace(config.rtp.remote_ssrc,
+    receive_rtp_config_.Emplace(config.rtp.remote_ssrc,
                                 ReceiveRtpConfig(config));
     audio_receive_streams_.insert(receive_stream);
 
@@ -693,7 +702,7 @@ void Call::DestroyAudioReceiveStream(
       sync_stream_mapping_.erase(it);
       ConfigureSync(sync_group);
     }
-    receive_rtp_config_.erase(ssrc);
+    receive_rtp_config_.Erase(ssrc);
   }
   UpdateAggregateNetworkState();
   delete audio_receive_stream;
@@ -802,7 +811,8 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   VideoReceiveStream* receive_stream = new VideoReceiveStream(
       &video_receiver_controller_, num_cpu_cores_,
       transport_send_ptr_->packet_router(), std::move(configuration),
-      module_process_thread_.get(), call_stats_.get());
+      module_process_thread_.get(), call_stats_.get(),
+      config_.decode_scheduler, &rtp_streams_sync_service_);
 
   const webrtc::VideoReceiveStream::Config& config = receive_stream->config();
   {
@@ -812,10 +822,10 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
       // stream. Since the transport_send_cc negotiation is per payload
       // type, we may get an incorrect value for the rtx stream, but
       // that is unlikely to matter in practice.
-      receive_rtp_config_.emplace(config.rtp.rtx_ssrc,
+      receive_rtp_config_.Emplace(config.rtp.rtx_ssrc,
                                   ReceiveRtpConfig(config));
     }
-    receive_rtp_config_.emplace(config.rtp.remote_ssrc,
+    receive_rtp_config_.Emplace(config.rtp.remote_ssrc,
                                 ReceiveRtpConfig(config));
     video_receive_streams_.insert(receive_stream);
     ConfigureSync(config.sync_group);
@@ -839,9 +849,9 @@ void Call::DestroyVideoReceiveStream(
     WriteLockScoped write_lock(*receive_crit_);
     // Remove all ssrcs pointing to a receive stream. As RTX retransmits on a
     // separate SSRC there can be either one or two.
-    receive_rtp_config_.erase(config.rtp.remote_ssrc);
+    receive_rtp_config_.Erase(config.rtp.remote_ssrc);
     if (config.rtp.rtx_ssrc) {
-      receive_rtp_config_.erase(config.rtp.rtx_ssrc);
+      receive_rtp_config_.Erase(config.rtp.rtx_ssrc);
     }
     video_receive_streams_.erase(receive_stream_impl);
     ConfigureSync(config.sync_group);
@@ -868,18 +878,18 @@ FlexfecReceiveStream* Call::CreateFlexfecReceiveStream(
     // FlexfecReceiveStream implements RtpPacketSinkInterface itself,
     // and hence its constructor passes its |this| pointer to
     // video_receiver_controller_->CreateStream(). Calling the
-    // constructor while holding |receive_crit_| ensures that we don't
-    // call OnRtpPacket until the constructor is finished and the
-    // object is in a valid state.
+    // constructor before its SSRC is added to |receive_rtp_config_|
+    // ensures that we don't call OnRtpPacket until the constructor is
+    // finished and the object is in a valid state.
     // TODO(nisse): Fix constructor so that it can be moved outside of
     // this locked scope.
     receive_stream = new FlexfecReceiveStreamImpl(
         &video_receiver_controller_, config, recovered_packet_receiver,
         call_stats_.get(), module_process_thread_.get());
 
-    RTC_DCHECK(receive_rtp_config_.find(config.remote_ssrc) ==
-               receive_rtp_config_.end());
-    receive_rtp_config_.emplace(config.remote_ssrc, ReceiveRtpConfig(config));
+    bool inserted = receive_rtp_config_.Emplace(config.remote_ssrc,
+                                                ReceiveRtpConfig(config));
+    RTC_DCHECK(inserted);
   }
 
   // TODO(brandtr): Store config in RtcEventLog here.
@@ -897,7 +907,7 @@ void Call::DestroyFlexfecReceiveStream(FlexfecReceiveStream* receive_stream) {
 
     const FlexfecReceiveStream::Config& config = receive_stream->GetConfig();
     uint32_t ssrc = config.remote_ssrc;
-    receive_rtp_config_.erase(ssrc);
+    receive_rtp_config_.Erase(ssrc);
 
     // Remove all SSRCs pointing to the FlexfecReceiveStreamImpl to be
     // destroyed.
@@ -1222,7 +1232,7 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
   TRACE_EVENT0("webrtc", "Call::DeliverRtp");
 
   RtpPacketReceived parsed_packet;
-  if (!parsed_packet.Parse(std::move(packet)))
+  if (!parsed_packet.ParseWithLazyExtensions(std::move(packet)))
     return DELIVERY_PACKET_ERROR;
 
   if (packet_time_us != -1) {
@@ -1243,22 +1253,24 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
   RTC_DCHECK(media_type == MediaType::AUDIO || media_type == MediaType::VIDEO ||
              is_keep_alive_packet);
 
-  ReadLockScoped read_lock(*receive_crit_);
-  auto it = receive_rtp_config_.find(parsed_packet.Ssrc());
-  if (it == receive_rtp_config_.end()) {
+  ReceiveRtpConfigTable::ReadScope receive_rtp_config(&receive_rtp_config_);
+  const ReceiveRtpConfig* config =
+      receive_rtp_config.Find(parsed_packet.Ssrc());
+  if (!config) {
     RTC_LOG(LS_ERROR) << "receive_rtp_config_ lookup failed for ssrc "
                       << parsed_packet.Ssrc();
     // Destruction of the receive stream, including deregistering from the
-    // RtpDemuxer, is not protected by the |receive_crit_| lock. But
-    // deregistering in the |receive_rtp_config_| map is protected by that lock.
-    // So by not passing the packet on to demuxing in this case, we prevent
-    // incoming packets to be passed on via the demuxer to a receive stream
-    // which is being torned down.
+    // RtpDemuxer, is not synchronized with packet delivery. But deregistering
+    // in |receive_rtp_config_| waits for all readers that may still see the
+    // stream's config. So by not passing the packet on to demuxing in this
+    // case, we prevent incoming packets to be passed on via the demuxer to a
+    // receive stream which is being torned down.
     return DELIVERY_UNKNOWN_SSRC;
   }
-  parsed_packet.IdentifyExtensions(it->second.extensions);
+  parsed_packet.IdentifyExtensions(config->extensions);
 
-  NotifyBweOfReceivedPacket(parsed_packet, media_type);
+  NotifyBweOfReceivedPacket(parsed_packet, media_type,
+                            config->use_send_side_bwe);
 
   // RateCounters expect input parameter as int, save it as int,
   // instead of converting each time it is passed to RateCounter::Add below.
@@ -1312,20 +1324,21 @@ void Call::OnRecoveredPacket(const uint8_t* packet, size_t length) {
 
   parsed_packet.set_recovered(true);
 
-  ReadLockScoped read_lock(*receive_crit_);
-  auto it = receive_rtp_config_.find(parsed_packet.Ssrc());
-  if (it == receive_rtp_config_.end()) {
+  ReceiveRtpConfigTable::ReadScope receive_rtp_config(&receive_rtp_config_);
+  const ReceiveRtpConfig* config =
+      receive_rtp_config.Find(parsed_packet.Ssrc());
+  if (!config) {
     RTC_LOG(LS_ERROR) << "receive_rtp_config_ lookup failed for ssrc "
                       << parsed_packet.Ssrc();
     // Destruction of the receive stream, including deregistering from the
-    // RtpDemuxer, is not protected by the |receive_crit_| lock. But
-    // deregistering in the |receive_rtp_config_| map is protected by that lock.
-    // So by not passing the packet on to demuxing in this case, we prevent
-    // incoming packets to be passed on via the demuxer to a receive stream
-    // which is being torn down.
+    // RtpDemuxer, is not synchronized with packet delivery. But deregistering
+    // in |receive_rtp_config_| waits for all readers that may still see the
+    // stream's config. So by not passing the packet on to demuxing in this
+    // case, we prevent incoming packets to be passed on via the demuxer to a
+    // receive stream which is being torn down.
     return;
   }
-  parsed_packet.IdentifyExtensions(it->second.extensions);
+  parsed_packet.IdentifyExtensions(config->extensions);
 
   // TODO(brandtr): Update here when we support protecting audio packets too.
   parsed_packet.set_payload_type_frequency(kVideoPayloadTypeFrequency);
@@ -1333,11 +1346,8 @@ void Call::OnRecoveredPacket(const uint8_t* packet, size_t length) {
 }
 
 void Call::NotifyBweOfReceivedPacket(const RtpPacketReceived& packet,
-                                     MediaType media_type) {
-  auto it = receive_rtp_config_.find(packet.Ssrc());
-  bool use_send_side_bwe =
-      (it != receive_rtp_config_.end()) && it->second.use_send_side_bwe;
-
+                                     MediaType media_type,
+                                     bool use_send_side_bwe) {
   RTPHeader header;
   packet.GetHeader(&header);
 
@@ -20,6 +20,7 @@
 namespace webrtc {
 
 class AudioProcessing;
+class DecodeScheduler;
 class RtcEventLog;
 
 struct CallConfig {
@@ -49,6 +50,11 @@ struct CallConfig {
 
   // Network controller factory to use for this call.
   NetworkControllerFactoryInterface* network_controller_factory = nullptr;
+
+  // Decode scheduler, possibly shared between multiple calls. If set, the
+  // video receive streams decode on its workers instead of starting a decode
+  // thread each.
+  DecodeScheduler* decode_scheduler = nullptr;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,715 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Load generator for many concurrent Call instances. Call i sends
+// --streams_per_call video streams to call i + 1 and receives as many from
+// call i - 1, so that all calls form a ring in which every call both sends
+// and receives, like the legs of an SFU. Frames are produced by FakeEncoder
+// and consumed by FakeDecoder, and packets travel over DirectTransport
+// through a SimulatedNetwork.
+//
+// After a warm-up period, reports the process CPU usage per stream, the CPU
+// usage of each task queue and thread, and the achieved throughput, so that
+// the number of streams at which the stack saturates can be found by
+// increasing --num_calls and --streams_per_call.
+//
+// With --bottleneck_kbps, the media of all calls instead shares one
+// bottleneck of a test::NetworkEmulation, optionally with --tcp_flows
+// competing TCP-like flows, and the fairness between the streams and the
+// queueing delay of the bottleneck are reported as well.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "call/call.h"
+#include "call/simulated_network.h"
+#include "logging/rtc_event_log/rtc_event_log.h"
+#include "media/base/videobroadcaster.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/dispatch_stats.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/clock.h"
+#include "system_wrappers/include/field_trial_default.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/call_test.h"
+#include "test/constants.h"
+#include "test/cross_traffic.h"
+#include "test/direct_transport.h"
+#include "test/encoder_settings.h"
+#include "test/fake_decoder.h"
+#include "test/fake_encoder.h"
+#include "test/fake_videorenderer.h"
+#include "test/field_trial.h"
+#include "test/frame_generator_capturer.h"
+#include "test/function_video_encoder_factory.h"
+#include "test/gtest.h"
+#include "test/network_emulation.h"
+#include "test/run_test.h"
+#include "test/single_threaded_task_queue.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace flags {
+
+DEFINE_int(num_calls, 2, "Number of Call instances, at least 2.");
+static int NumCalls() {
+  return static_cast<int>(FLAG_num_calls);
+}
+
+DEFINE_int(streams_per_call,
+           4,
+           "Number of video streams each call sends, and receives.");
+static int StreamsPerCall() {
+  return static_cast<int>(FLAG_streams_per_call);
+}
+
+DEFINE_int(call_threads,
+           4,
+           "Number of threads running the calls and their simulated network "
+           "links.");
+static int CallThreads() {
+  return static_cast<int>(FLAG_call_threads);
+}
+
+DEFINE_int(warmup_s, 10, "Time to let the bitrates ramp up, in seconds.");
+static int WarmupSeconds() {
+  return static_cast<int>(FLAG_warmup_s);
+}
+
+DEFINE_int(duration_s, 30, "Measurement duration, in seconds.");
+static int DurationSeconds() {
+  return static_cast<int>(FLAG_duration_s);
+}
+
+DEFINE_int(width, 320, "Video width.");
+static int Width() {
+  return static_cast<int>(FLAG_width);
+}
+
+DEFINE_int(height, 180, "Video height.");
+static int Height() {
+  return static_cast<int>(FLAG_height);
+}
+
+DEFINE_int(fps, 30, "Frames per second.");
+static int Fps() {
+  return static_cast<int>(FLAG_fps);
+}
+
+DEFINE_int(max_bitrate_kbps, 300, "Maximum bitrate of each stream.");
+static int MaxBitrateKbps() {
+  return static_cast<int>(FLAG_max_bitrate_kbps);
+}
+
+DEFINE_int(link_capacity_kbps,
+           0,
+           "Capacity of the link between two calls, 0 for unlimited.");
+static int LinkCapacityKbps() {
+  return static_cast<int>(FLAG_link_capacity_kbps);
+}
+
+DEFINE_int(queue_delay_ms, 10, "One-way delay of the links.");
+static int QueueDelayMs() {
+  return static_cast<int>(FLAG_queue_delay_ms);
+}
+
+DEFINE_int(loss_percent, 0, "Random packet loss of the links.");
+static int LossPercent() {
+  return static_cast<int>(FLAG_loss_percent);
+}
+
+DEFINE_int(bottleneck_kbps,
+           0,
+           "If not 0, the media of all calls shares one link of this capacity "
+           "instead of having a link per call. The feedback takes a link "
+           "without a capacity limit. --queue_delay_ms and --loss_percent "
+           "apply to both.");
+static int BottleneckKbps() {
+  return static_cast<int>(FLAG_bottleneck_kbps);
+}
+
+DEFINE_int(bottleneck_queue_packets,
+           100,
+           "Queue length of the bottleneck, 0 for unlimited.");
+static int BottleneckQueuePackets() {
+  return static_cast<int>(FLAG_bottleneck_queue_packets);
+}
+
+DEFINE_int(tcp_flows,
+           0,
+           "Number of TCP-like bulk transfers competing with the calls for "
+           "the bottleneck.");
+static int TcpFlows() {
+  return static_cast<int>(FLAG_tcp_flows);
+}
+
+DEFINE_string(
+    force_fieldtrials,
+    "",
+    "Field trials control experimental feature code which can be forced. "
+    "E.g. running with --force_fieldtrials=WebRTC-FooFeature/Enable/"
+    " will assign the group Enable to field trial WebRTC-FooFeature. Multiple "
+    "trials are separated by \"/\"");
+
+DEFINE_string(
+    isolated_script_test_perf_output,
+    "",
+    "Path where the perf results should be stored in the JSON format described "
+    "by "
+    "https://github.com/catapult-project/catapult/blob/master/dashboard/docs/"
+    "data-format.md.");
+
+DEFINE_bool(logs, false, "print logs to stderr");
+
+DEFINE_bool(help, false, "prints this message");
+
+}  // namespace flags
+
+namespace {
+
+const uint8_t kPayloadType = test::CallTest::kFakeVideoSendPayloadType;
+const uint32_t kFirstSendSsrc = 0x10000;
+const uint32_t kFirstReceiverLocalSsrc = 0x80000;
+// Streams decoding less than this share of the frame rate are counted as
+// saturated.
+const double kSaturatedFramerateRatio = 0.9;
+
+// Reports the packets sent by the streams of |call| to it, like
+// test::DirectTransport does for the call it is created with. The
+// DirectTransports of this test deliver to a call on another queue, where
+// they can't signal the network state of the sending call.
+class SentPacketTransport : public Transport {
+ public:
+  SentPacketTransport(Clock* clock, Call* call, Transport* transport)
+      : clock_(clock), call_(call), transport_(transport) {}
+
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override {
+    call_->OnSentPacket(
+        rtc::SentPacket(options.packet_id, clock_->TimeInMilliseconds()));
+    return transport_->SendRtp(packet, length, options);
+  }
+
+  bool SendRtcp(const uint8_t* packet, size_t length) override {
+    return transport_->SendRtcp(packet, length);
+  }
+
+ private:
+  Clock* const clock_;
+  Call* const call_;
+  Transport* const transport_;
+};
+
+// Delivers the packets arriving at an emulated endpoint to a call on its
+// queue.
+class QueuedPacketReceiver : public test::EmulatedNetworkReceiverInterface {
+ public:
+  QueuedPacketReceiver(test::SingleThreadedTaskQueueForTesting* queue,
+                       PacketReceiver* receiver)
+      : queue_(queue), receiver_(receiver) {}
+
+  void OnPacketReceived(test::EmulatedPacket packet) override {
+    PacketReceiver* receiver = receiver_;
+    rtc::CopyOnWriteBuffer payload = std::move(packet.payload);
+    const int64_t arrival_time_us = packet.arrival_time_us;
+    queue_->PostTask([receiver, payload, arrival_time_us]() {
+      receiver->DeliverPacket(MediaType::ANY, payload, arrival_time_us);
+    });
+  }
+
+ private:
+  test::SingleThreadedTaskQueueForTesting* const queue_;
+  PacketReceiver* const receiver_;
+};
+
+// A Call with its streams and the transports of its outgoing packets. The
+// call and its streams live on |queue|. A call must be fed on its own queue,
+// so each transport is created and destroyed on the queue of the call it
+// delivers to, which also runs its simulated network.
+struct CallEndpoint {
+  test::SingleThreadedTaskQueueForTesting* queue = nullptr;
+  std::unique_ptr<RtcEventLog> event_log;
+  std::unique_ptr<Call> call;
+  std::unique_ptr<test::FrameGeneratorCapturer> capturer;
+  // Feeds the frames of |capturer| to all send streams.
+  rtc::VideoBroadcaster broadcaster;
+  std::vector<VideoSendStream*> send_streams;
+  std::vector<VideoReceiveStream*> receive_streams;
+  std::vector<std::unique_ptr<VideoDecoder>> decoders;
+  // |rtp_transport| carries the send streams' packets to the next call, and
+  // |rtcp_transport| the receive streams' feedback to the previous one.
+  std::unique_ptr<test::DirectTransport> rtp_transport;
+  std::unique_ptr<test::DirectTransport> rtcp_transport;
+  std::unique_ptr<SentPacketTransport> send_transport;
+  // With --bottleneck_kbps, the packets take these transports instead. Media
+  // and feedback leave from different endpoints, since with two calls they
+  // go to the same call over different links.
+  test::EmulatedEndpoint* rtp_endpoint = nullptr;
+  test::EmulatedEndpoint* rtcp_endpoint = nullptr;
+  std::unique_ptr<test::EmulatedCallTransport> emulated_rtp_transport;
+  std::unique_ptr<test::EmulatedCallTransport> emulated_rtcp_transport;
+  std::unique_ptr<QueuedPacketReceiver> packet_receiver;
+
+  Transport* RtpTransport() {
+    if (emulated_rtp_transport)
+      return emulated_rtp_transport.get();
+    return send_transport.get();
+  }
+  Transport* RtcpTransport() {
+    if (emulated_rtcp_transport)
+      return emulated_rtcp_transport.get();
+    return rtcp_transport.get();
+  }
+};
+
+struct LoadSnapshot {
+  int64_t time_ns = 0;
+  int64_t process_cpu_ns = 0;
+  std::vector<int64_t> queue_cpu_ns;
+  std::vector<int64_t> frames_decoded;
+  std::vector<double> stream_bitrates_bps;
+  int64_t send_bitrate_bps = 0;
+  int64_t receive_bitrate_bps = 0;
+  std::vector<int64_t> tcp_bytes_acked;
+};
+
+class CallLoadTest {
+ public:
+  CallLoadTest()
+      : clock_(Clock::GetRealTimeClock()),
+        encoder_factory_([this]() {
+          auto encoder = absl::make_unique<test::FakeEncoder>(clock_);
+          encoder->SetMaxBitrate(flags::MaxBitrateKbps());
+          return encoder;
+        }),
+        trace_(std::to_string(flags::NumCalls()) + "_calls_" +
+               std::to_string(flags::StreamsPerCall()) + "_streams") {
+    for (int i = 0; i < flags::CallThreads(); ++i)
+      queues_.emplace_back(new test::SingleThreadedTaskQueueForTesting("Call"));
+  }
+
+  void Run() {
+    SetUp();
+
+    SleepMs(flags::WarmupSeconds() * 1000);
+    if (bottleneck_)
+      bottleneck_->ResetStats();
+    rtc::DispatchStatsRecorder::ResetStats();
+    rtc::DispatchStatsRecorder::StartRecording(0);
+    const LoadSnapshot start = TakeSnapshot();
+    SleepMs(flags::DurationSeconds() * 1000);
+    const LoadSnapshot end = TakeSnapshot();
+    rtc::DispatchStatsRecorder::StopRecording();
+
+    PrintResults(start, end);
+    if (bottleneck_)
+      PrintBottleneckResults(start, end);
+    TearDown();
+  }
+
+ private:
+  void SetUp() {
+    const int num_calls = flags::NumCalls();
+    for (int i = 0; i < num_calls; ++i) {
+      endpoints_.emplace_back(new CallEndpoint());
+      CallEndpoint* endpoint = endpoints_.back().get();
+      endpoint->queue = queues_[i % queues_.size()].get();
+      endpoint->queue->SendTask([endpoint]() {
+        endpoint->event_log = RtcEventLog::CreateNull();
+        Call::Config config(endpoint->event_log.get());
+        config.bitrate_config.max_bitrate_bps =
+            flags::StreamsPerCall() * flags::MaxBitrateKbps() * 1000;
+        endpoint->call.reset(Call::Create(config));
+        endpoint->call->SignalChannelNetworkState(MediaType::AUDIO,
+                                                  kNetworkUp);
+        endpoint->call->SignalChannelNetworkState(MediaType::VIDEO,
+                                                  kNetworkUp);
+      });
+    }
+
+    if (flags::BottleneckKbps() > 0) {
+      SetUpEmulation();
+    } else {
+      for (int i = 0; i < num_calls; ++i) {
+        CallEndpoint* endpoint = endpoints_[i].get();
+        CallEndpoint* next = endpoints_[(i + 1) % num_calls].get();
+        CallEndpoint* previous =
+            endpoints_[(i + num_calls - 1) % num_calls].get();
+        next->queue->SendTask([endpoint, next]() {
+          endpoint->rtp_transport = CreateTransport(next);
+        });
+        previous->queue->SendTask([endpoint, previous]() {
+          endpoint->rtcp_transport = CreateTransport(previous);
+        });
+        endpoint->send_transport = absl::make_unique<SentPacketTransport>(
+            clock_, endpoint->call.get(), endpoint->rtp_transport.get());
+      }
+    }
+
+    for (int i = 0; i < num_calls; ++i) {
+      CallEndpoint* endpoint = endpoints_[i].get();
+      const size_t first_send_stream = i * flags::StreamsPerCall();
+      const size_t first_receive_stream =
+          ((i + num_calls - 1) % num_calls) * flags::StreamsPerCall();
+      endpoint->queue->SendTask([&]() {
+        for (int j = 0; j < flags::StreamsPerCall(); ++j) {
+          CreateSendStream(first_send_stream + j, endpoint);
+          CreateReceiveStream(first_receive_stream + j, endpoint);
+        }
+        StartStreams(endpoint);
+      });
+    }
+  }
+
+  // Routes the media of all calls through |bottleneck_|, along with the TCP
+  // flows, and the feedback through a link without a capacity limit.
+  void SetUpEmulation() {
+    const int num_calls = flags::NumCalls();
+    emulation_ = absl::make_unique<test::NetworkEmulation>();
+    SimulatedNetwork::Config feedback_config;
+    feedback_config.queue_delay_ms = flags::QueueDelayMs();
+    feedback_config.loss_percent = flags::LossPercent();
+    SimulatedNetwork::Config bottleneck_config = feedback_config;
+    bottleneck_config.link_capacity_kbps = flags::BottleneckKbps();
+    bottleneck_config.queue_length_packets = flags::BottleneckQueuePackets();
+    bottleneck_ = emulation_->CreateNode(bottleneck_config);
+    test::EmulatedNetworkNode* feedback_link =
+        emulation_->CreateNode(feedback_config);
+
+    for (const auto& endpoint : endpoints_) {
+      endpoint->rtp_endpoint = emulation_->CreateEndpoint();
+      endpoint->rtcp_endpoint = emulation_->CreateEndpoint();
+      endpoint->packet_receiver = absl::make_unique<QueuedPacketReceiver>(
+          endpoint->queue, endpoint->call->Receiver());
+      endpoint->rtp_endpoint->SetReceiver(endpoint->packet_receiver.get());
+      endpoint->rtcp_endpoint->SetReceiver(endpoint->packet_receiver.get());
+    }
+    for (int i = 0; i < num_calls; ++i) {
+      CallEndpoint* endpoint = endpoints_[i].get();
+      CallEndpoint* next = endpoints_[(i + 1) % num_calls].get();
+      CallEndpoint* previous =
+          endpoints_[(i + num_calls - 1) % num_calls].get();
+      emulation_->CreateRoute(endpoint->rtp_endpoint, {bottleneck_},
+                              next->rtp_endpoint);
+      emulation_->CreateRoute(endpoint->rtcp_endpoint, {feedback_link},
+                              previous->rtcp_endpoint);
+      endpoint->queue->SendTask([endpoint, next, previous]() {
+        endpoint->emulated_rtp_transport =
+            absl::make_unique<test::EmulatedCallTransport>(
+                endpoint->rtp_endpoint, next->rtp_endpoint,
+                endpoint->call.get());
+        endpoint->emulated_rtcp_transport =
+            absl::make_unique<test::EmulatedCallTransport>(
+                endpoint->rtcp_endpoint, previous->rtcp_endpoint, nullptr);
+      });
+    }
+
+    for (int i = 0; i < flags::TcpFlows(); ++i) {
+      test::EmulatedEndpoint* sender = emulation_->CreateEndpoint();
+      test::EmulatedEndpoint* receiver = emulation_->CreateEndpoint();
+      emulation_->CreateRoute(sender, {bottleneck_}, receiver);
+      emulation_->CreateRoute(receiver, {feedback_link}, sender);
+      tcp_flows_.push_back(absl::make_unique<test::TcpCrossTraffic>(
+          emulation_.get(), sender, receiver, test::TcpCrossTraffic::Config()));
+    }
+    emulation_->Start();
+    for (const auto& flow : tcp_flows_)
+      flow->Start();
+  }
+
+  // Creates a transport delivering to the call of |receiver|. Must be called
+  // on the queue of |receiver|.
+  static std::unique_ptr<test::DirectTransport> CreateTransport(
+      CallEndpoint* receiver) {
+    FakeNetworkPipe::Config network_config;
+    network_config.link_capacity_kbps = flags::LinkCapacityKbps();
+    network_config.queue_delay_ms = flags::QueueDelayMs();
+    network_config.loss_percent = flags::LossPercent();
+    auto transport = absl::make_unique<test::DirectTransport>(
+        receiver->queue, network_config, nullptr,
+        std::map<uint8_t, MediaType>{{kPayloadType, MediaType::VIDEO}});
+    transport->SetReceiver(receiver->call->Receiver());
+    return transport;
+  }
+
+  // The |index|th stream is sent by call |index| / --streams_per_call, and
+  // received by the next call.
+  void CreateSendStream(size_t index, CallEndpoint* endpoint) {
+    VideoSendStream::Config send_config(endpoint->RtpTransport());
+    send_config.encoder_settings.encoder_factory = &encoder_factory_;
+    send_config.rtp.payload_name = "FAKE";
+    send_config.rtp.payload_type = kPayloadType;
+    send_config.rtp.ssrcs.push_back(kFirstSendSsrc + index);
+    send_config.rtp.extensions = RtpExtensions();
+    send_config.rtp.nack.rtp_history_ms = test::CallTest::kNackRtpHistoryMs;
+    VideoEncoderConfig encoder_config;
+    test::FillEncoderConfiguration(kVideoCodecGeneric, 1, &encoder_config);
+    encoder_config.max_bitrate_bps = flags::MaxBitrateKbps() * 1000;
+    endpoint->send_streams.push_back(endpoint->call->CreateVideoSendStream(
+        std::move(send_config), std::move(encoder_config)));
+  }
+
+  void CreateReceiveStream(size_t index, CallEndpoint* endpoint) {
+    VideoReceiveStream::Config receive_config(endpoint->RtcpTransport());
+    receive_config.rtp.remote_ssrc = kFirstSendSsrc + index;
+    receive_config.rtp.local_ssrc = kFirstReceiverLocalSsrc + index;
+    receive_config.rtp.transport_cc = true;
+    receive_config.rtp.extensions = RtpExtensions();
+    receive_config.rtp.nack.rtp_history_ms = test::CallTest::kNackRtpHistoryMs;
+    receive_config.renderer = &renderer_;
+    VideoReceiveStream::Decoder decoder =
+        test::CreateMatchingDecoder(kPayloadType, "FAKE");
+    endpoint->decoders.emplace_back(decoder.decoder);
+    receive_config.decoders.push_back(decoder);
+    endpoint->receive_streams.push_back(
+        endpoint->call->CreateVideoReceiveStream(std::move(receive_config)));
+  }
+
+  static std::vector<RtpExtension> RtpExtensions() {
+    return {RtpExtension(RtpExtension::kTransportSequenceNumberUri,
+                         test::kTransportSequenceNumberExtensionId)};
+  }
+
+  void StartStreams(CallEndpoint* endpoint) {
+    endpoint->capturer.reset(test::FrameGeneratorCapturer::Create(
+        flags::Width(), flags::Height(), absl::nullopt, absl::nullopt,
+        flags::Fps(), clock_));
+    endpoint->capturer->AddOrUpdateSink(&endpoint->broadcaster,
+                                        rtc::VideoSinkWants());
+    for (VideoSendStream* send_stream : endpoint->send_streams) {
+      send_stream->SetSource(&endpoint->broadcaster,
+                             DegradationPreference::MAINTAIN_FRAMERATE);
+      send_stream->Start();
+    }
+    for (VideoReceiveStream* receive_stream : endpoint->receive_streams)
+      receive_stream->Start();
+    endpoint->capturer->Start();
+  }
+
+  void TearDown() {
+    for (const auto& endpoint : endpoints_) {
+      CallEndpoint* endpoint_ptr = endpoint.get();
+      endpoint->queue->SendTask([endpoint_ptr]() {
+        endpoint_ptr->capturer->Stop();
+        Call* call = endpoint_ptr->call.get();
+        for (VideoSendStream* send_stream : endpoint_ptr->send_streams) {
+          send_stream->Stop();
+          call->DestroyVideoSendStream(send_stream);
+        }
+        for (VideoReceiveStream* receive_stream :
+             endpoint_ptr->receive_streams) {
+          receive_stream->Stop();
+          call->DestroyVideoReceiveStream(receive_stream);
+        }
+        endpoint_ptr->capturer.reset();
+        endpoint_ptr->decoders.clear();
+      });
+    }
+    // The transports deliver to the calls, so the calls go last. Stopping
+    // the emulation flushes its packets to the queues of the calls.
+    emulation_.reset();
+    tcp_flows_.clear();
+    const int num_calls = flags::NumCalls();
+    for (int i = 0; i < num_calls; ++i) {
+      CallEndpoint* endpoint = endpoints_[i].get();
+      endpoint->send_transport.reset();
+      endpoints_[(i + 1) % num_calls]->queue->SendTask(
+          [endpoint]() { endpoint->rtp_transport.reset(); });
+      endpoints_[(i + num_calls - 1) % num_calls]->queue->SendTask(
+          [endpoint]() { endpoint->rtcp_transport.reset(); });
+    }
+    for (const auto& endpoint : endpoints_) {
+      CallEndpoint* endpoint_ptr = endpoint.get();
+      endpoint->queue->SendTask([endpoint_ptr]() {
+        endpoint_ptr->emulated_rtp_transport.reset();
+        endpoint_ptr->emulated_rtcp_transport.reset();
+        endpoint_ptr->call.reset();
+      });
+    }
+    endpoints_.clear();
+  }
+
+  LoadSnapshot TakeSnapshot() {
+    LoadSnapshot snapshot;
+    snapshot.time_ns = rtc::TimeNanos();
+    snapshot.process_cpu_ns = rtc::GetProcessCpuTimeNanos();
+    for (const auto& queue : queues_) {
+      int64_t cpu_ns = 0;
+      queue->SendTask([&cpu_ns]() { cpu_ns = rtc::GetThreadCpuTimeNanos(); });
+      snapshot.queue_cpu_ns.push_back(cpu_ns);
+    }
+    for (const auto& endpoint : endpoints_) {
+      CallEndpoint* endpoint_ptr = endpoint.get();
+      endpoint->queue->SendTask([endpoint_ptr, &snapshot]() {
+        for (VideoSendStream* send_stream : endpoint_ptr->send_streams) {
+          for (const auto& substream : send_stream->GetStats().substreams)
+            snapshot.send_bitrate_bps += substream.second.total_bitrate_bps;
+        }
+        for (VideoReceiveStream* receive_stream :
+             endpoint_ptr->receive_streams) {
+          const VideoReceiveStream::Stats stats = receive_stream->GetStats();
+          snapshot.frames_decoded.push_back(stats.frames_decoded);
+          snapshot.stream_bitrates_bps.push_back(stats.total_bitrate_bps);
+          snapshot.receive_bitrate_bps += stats.total_bitrate_bps;
+        }
+      });
+    }
+    for (const auto& flow : tcp_flows_)
+      snapshot.tcp_bytes_acked.push_back(flow->GetStats().bytes_acked);
+    return snapshot;
+  }
+
+  void PrintResults(const LoadSnapshot& start, const LoadSnapshot& end) {
+    const double elapsed_ns = end.time_ns - start.time_ns;
+    const int num_streams = flags::NumCalls() * flags::StreamsPerCall();
+    // CPU usage in percent of one core.
+    const double process_cpu =
+        100.0 * (end.process_cpu_ns - start.process_cpu_ns) / elapsed_ns;
+    test::PrintResult("cpu_usage", "", trace_, process_cpu, "%", true);
+    // Every stream is both encoded and sent by one call, and received and
+    // decoded by another.
+    test::PrintResult("cpu_usage_per_stream", "", trace_,
+                      process_cpu / num_streams, "%", true);
+
+    for (size_t i = 0; i < queues_.size(); ++i) {
+      const double cpu =
+          100.0 * (end.queue_cpu_ns[i] - start.queue_cpu_ns[i]) / elapsed_ns;
+      test::PrintResult("thread_cpu_usage", "",
+                        trace_ + "_call_thread_" + std::to_string(i), cpu, "%",
+                        false);
+    }
+    // Threads which don't run on a TaskQueue or rtc::Thread, like the
+    // decoding threads, are only included in the process CPU usage. Queues
+    // which share a name, like the encoder queues, are summed up, so they may
+    // use more than 100%.
+    for (const rtc::DispatchQueueStats& queue :
+         rtc::DispatchStatsRecorder::GetStats()) {
+      test::PrintResult("thread_cpu_usage", "", trace_ + "_" + queue.queue_name,
+                        100.0 * queue.cpu_time_ns / elapsed_ns, "%", false);
+    }
+
+    std::vector<double> decode_fps;
+    int saturated_streams = 0;
+    for (size_t i = 0; i < end.frames_decoded.size(); ++i) {
+      const double fps = (end.frames_decoded[i] - start.frames_decoded[i]) *
+                         rtc::kNumNanosecsPerSec / elapsed_ns;
+      decode_fps.push_back(fps);
+      if (fps < kSaturatedFramerateRatio * flags::Fps())
+        ++saturated_streams;
+    }
+    test::PrintResultList("decode_fps", "", trace_, decode_fps, "fps", false);
+    test::PrintResult("min_decode_fps", "", trace_,
+                      *std::min_element(decode_fps.begin(), decode_fps.end()),
+                      "fps", true);
+    test::PrintResult("saturated_streams", "", trace_, saturated_streams,
+                      "streams", true);
+    test::PrintResult("send_bitrate", "", trace_, end.send_bitrate_bps / 1000.0,
+                      "kbps", true);
+    test::PrintResult("receive_bitrate", "", trace_,
+                      end.receive_bitrate_bps / 1000.0, "kbps", true);
+  }
+
+  // Reports how the calls and the TCP flows shared the bottleneck.
+  void PrintBottleneckResults(const LoadSnapshot& start,
+                              const LoadSnapshot& end) {
+    const double elapsed_s =
+        static_cast<double>(end.time_ns - start.time_ns) /
+        rtc::kNumNanosecsPerSec;
+    const test::EmulatedNetworkNode::Stats stats = bottleneck_->GetStats();
+    test::PrintResult("bottleneck_utilization", "", trace_,
+                      100.0 * stats.bytes_forwarded * 8 / elapsed_s /
+                          (flags::BottleneckKbps() * 1000.0),
+                      "%", true);
+    test::PrintResult("bottleneck_delay_p50", "", trace_,
+                      stats.DelayPercentileMs(50), "ms", false);
+    test::PrintResult("bottleneck_delay_p95", "", trace_,
+                      stats.DelayPercentileMs(95), "ms", true);
+    test::PrintResult("bottleneck_drops", "", trace_, stats.packets_dropped,
+                      "packets", false);
+    test::PrintResult(
+        "stream_fairness", "", trace_,
+        test::NetworkEmulation::FairnessIndex(end.stream_bitrates_bps),
+        "jain_index", true);
+    if (tcp_flows_.empty())
+      return;
+    std::vector<double> tcp_kbps;
+    for (size_t i = 0; i < tcp_flows_.size(); ++i) {
+      tcp_kbps.push_back((end.tcp_bytes_acked[i] - start.tcp_bytes_acked[i]) *
+                         8 / elapsed_s / 1000);
+    }
+    test::PrintResultList("tcp_throughput", "", trace_, tcp_kbps, "kbps",
+                          false);
+    test::PrintResult("tcp_fairness", "", trace_,
+                      test::NetworkEmulation::FairnessIndex(tcp_kbps),
+                      "jain_index", false);
+  }
+
+  Clock* const clock_;
+  test::FunctionVideoEncoderFactory encoder_factory_;
+  test::FakeVideoRenderer renderer_;
+  const std::string trace_;
+  std::vector<std::unique_ptr<test::SingleThreadedTaskQueueForTesting>>
+      queues_;
+  std::vector<std::unique_ptr<CallEndpoint>> endpoints_;
+  std::unique_ptr<test::NetworkEmulation> emulation_;
+  test::EmulatedNetworkNode* bottleneck_ = nullptr;
+  std::vector<std::unique_ptr<test::TcpCrossTraffic>> tcp_flows_;
+};
+
+void CallLoad() {
+  CallLoadTest test;
+  test.Run();
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (webrtc::flags::FLAG_help) {
+    rtc::FlagList::Print(nullptr, false);
+    return 0;
+  }
+
+  rtc::LogMessage::SetLogToStderr(webrtc::flags::FLAG_logs);
+
+  RTC_CHECK_GE(webrtc::flags::NumCalls(), 2);
+  RTC_CHECK_GE(webrtc::flags::StreamsPerCall(), 1);
+  RTC_CHECK_GE(webrtc::flags::CallThreads(), 1);
+  RTC_CHECK_GE(webrtc::flags::BottleneckKbps(), 0);
+  RTC_CHECK(webrtc::flags::TcpFlows() == 0 ||
+            webrtc::flags::BottleneckKbps() > 0)
+      << "--tcp_flows needs --bottleneck_kbps.";
+
+  webrtc::test::ValidateFieldTrialsStringOrDie(
+      webrtc::flags::FLAG_force_fieldtrials);
+  // InitFieldTrialsFromString stores the char*, so the char array must outlive
+  // the application.
+  webrtc::field_trial::InitFieldTrialsFromString(
+      webrtc::flags::FLAG_force_fieldtrials);
+
+  webrtc::test::RunTest(webrtc::CallLoad);
+
+  std::string chartjson_result_file =
+      webrtc::flags::FLAG_isolated_script_test_perf_output;
+  if (!chartjson_result_file.empty()) {
+    webrtc::test::WritePerfResults(chartjson_result_file);
+  }
+  return 0;
+}
@@ -63,7 +63,7 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    sink_by_ssrc_.emplace(ssrc, sink);
+    sink_by_ssrc_.Emplace(ssrc, sink);
   }
 
   for (uint8_t payload_type : criteria.payload_types) {
@@ -71,6 +71,7 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
   }
 
   RefreshKnownMids();
+  resolved_sink_by_ssrc_.Clear();
 
   return true;
 }
@@ -103,7 +104,7 @@ bool RtpDemuxer::CriteriaWouldConflict(
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    if (sink_by_ssrc_.find(ssrc) != sink_by_ssrc_.end()) {
+    if (sink_by_ssrc_.Contains(ssrc)) {
       return true;
     }
   }
@@ -143,16 +144,25 @@ void RtpDemuxer::AddSink(const std::string& rsid,
 bool RtpDemuxer::RemoveSink(const RtpPacketSinkInterface* sink) {
   RTC_DCHECK(sink);
   size_t num_removed = RemoveFromMapByValue(&sink_by_mid_, sink) +
-                       RemoveFromMapByValue(&sink_by_ssrc_, sink) +
+                       sink_by_ssrc_.EraseIf(
+                           [sink](uint32_t, RtpPacketSinkInterface* value) {
+                             return value == sink;
+                           }) +
                        RemoveFromMultimapByValue(&sinks_by_pt_, sink) +
                        RemoveFromMapByValue(&sink_by_mid_and_rsid_, sink) +
                        RemoveFromMapByValue(&sink_by_rsid_, sink);
   RefreshKnownMids();
+  resolved_sink_by_ssrc_.Clear();
   return num_removed > 0;
 }
 
+void RtpDemuxer::set_use_mid(bool use_mid) {
+  use_mid_ = use_mid;
+  resolved_sink_by_ssrc_.Clear();
+}
+
 bool RtpDemuxer::OnRtpPacket(const RtpPacketReceived& packet) {
-  RtpPacketSinkInterface* sink = ResolveSink(packet);
+  RtpPacketSinkInterface* sink = LookupSink(packet);
   if (sink != nullptr) {
     sink->OnRtpPacket(packet);
     return true;
@@ -160,6 +170,66 @@ bool RtpDemuxer::OnRtpPacket(const RtpPacketReceived& packet) {
   return false;
 }
 
+size_t RtpDemuxer::OnRtpPackets(
+    rtc::ArrayView<const RtpPacketReceived> packets) {
+  size_t forwarded = 0;
+  size_t run_begin = 0;
+  RtpPacketSinkInterface* run_sink = nullptr;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    const RtpPacketReceived& packet = packets[i];
+    // Without MID or RSID, the sink only depends on the SSRC bindings, which
+    // resolving the first packet of the run has already settled.
+    if (run_sink != nullptr && packet.Ssrc() == packets[run_begin].Ssrc() &&
+        !HasBindingExtensions(packet)) {
+      continue;
+    }
+    if (run_sink != nullptr) {
+      run_sink->OnRtpPackets(packets.subview(run_begin, i - run_begin));
+      forwarded += i - run_begin;
+    }
+    run_begin = i;
+    run_sink = LookupSink(packet);
+  }
+  if (run_sink != nullptr) {
+    run_sink->OnRtpPackets(
+        packets.subview(run_begin, packets.size() - run_begin));
+    forwarded += packets.size() - run_begin;
+  }
+  return forwarded;
+}
+
+RtpPacketSinkInterface* RtpDemuxer::LookupSink(
+    const RtpPacketReceived& packet) {
+  const uint32_t ssrc = packet.Ssrc();
+  if (!HasBindingExtensions(packet)) {
+    RtpPacketSinkInterface* const* resolved_sink =
+        resolved_sink_by_ssrc_.Find(ssrc);
+    if (resolved_sink != nullptr) {
+      return *resolved_sink;
+    }
+  }
+
+  RtpPacketSinkInterface* sink = ResolveSink(packet);
+  // Once the SSRC is bound to the sink that the packet went to, resolving a
+  // later packet of the SSRC without MID or RSID takes the same branch of
+  // ResolveSink() with the same result, and binds nothing new. If the packet
+  // was dropped, or the binding limit was hit, the result may depend on the
+  // payload type, so such SSRCs stay on the slow path.
+  RtpPacketSinkInterface* const* bound_sink = sink_by_ssrc_.Find(ssrc);
+  if (sink != nullptr && bound_sink != nullptr && *bound_sink == sink) {
+    resolved_sink_by_ssrc_.InsertOrAssign(ssrc, sink);
+  } else {
+    resolved_sink_by_ssrc_.Erase(ssrc);
+  }
+  return sink;
+}
+
+bool RtpDemuxer::HasBindingExtensions(const RtpPacketReceived& packet) const {
+  return (use_mid_ && packet.HasExtension<RtpMid>()) ||
+         packet.HasExtension<RepairedRtpStreamId>() ||
+         packet.HasExtension<RtpStreamId>();
+}
+
 RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
     const RtpPacketReceived& packet) {
   // See the BUNDLE spec for high level reference to this algorithm:
@@ -187,28 +257,22 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
 
   std::string* mid = nullptr;
   if (has_mid) {
-    mid_by_ssrc_[ssrc] = packet_mid;
+    mid_by_ssrc_.InsertOrAssign(ssrc, packet_mid);
     mid = &packet_mid;
   } else {
     // If the packet does not include a MID header extension, check if there is
     // a latched MID for the SSRC.
-    const auto it = mid_by_ssrc_.find(ssrc);
-    if (it != mid_by_ssrc_.end()) {
-      mid = &it->second;
-    }
+    mid = mid_by_ssrc_.Find(ssrc);
   }
 
   std::string* rsid = nullptr;
   if (has_rsid) {
-    rsid_by_ssrc_[ssrc] = packet_rsid;
+    rsid_by_ssrc_.InsertOrAssign(ssrc, packet_rsid);
     rsid = &packet_rsid;
   } else {
     // If the packet does not include an RRID/RSID header extension, check if
     // there is a latched RSID for the SSRC.
-    const auto it = rsid_by_ssrc_.find(ssrc);
-    if (it != rsid_by_ssrc_.end()) {
-      rsid = &it->second;
-    }
+    rsid = rsid_by_ssrc_.Find(ssrc);
   }
 
   // If MID and/or RSID is specified, prioritize that for demuxing the packet.
@@ -250,9 +314,9 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
 
   // We trust signaled SSRC more than payload type which is likely to conflict
   // between streams.
-  const auto ssrc_sink_it = sink_by_ssrc_.find(ssrc);
-  if (ssrc_sink_it != sink_by_ssrc_.end()) {
-    return ssrc_sink_it->second;
+  RtpPacketSinkInterface* const* ssrc_sink = sink_by_ssrc_.Find(ssrc);
+  if (ssrc_sink != nullptr) {
+    return *ssrc_sink;
   }
 
   // Legacy senders will only signal payload type, support that as last resort.
@@ -346,14 +410,14 @@ bool RtpDemuxer::AddSsrcSinkBinding(uint32_t ssrc,
     return false;
   }
 
-  auto result = sink_by_ssrc_.emplace(ssrc, sink);
-  auto it = result.first;
+  auto result = sink_by_ssrc_.Emplace(ssrc, sink);
+  RtpPacketSinkInterface** bound_sink = result.first;
   bool inserted = result.second;
   if (inserted) {
     return true;
   }
-  if (it->second != sink) {
-    it->second = sink;
+  if (*bound_sink != sink) {
+    *bound_sink = sink;
     return true;
   }
   return false;
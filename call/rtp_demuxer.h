@@ -17,6 +17,9 @@
 #include <utility>
 #include <vector>
 
+#include "api/array_view.h"
+#include "call/ssrc_table.h"
+
 namespace webrtc {
 
 class RtpPacketReceived;
@@ -126,6 +129,13 @@ class RtpDemuxer {
   // if the packet was forwarded and false if the packet was dropped.
   bool OnRtpPacket(const RtpPacketReceived& packet);
 
+  // Demuxes a burst of packets, with the same result as calling OnRtpPacket()
+  // for each of them in order. Runs of consecutive packets with the same SSRC
+  // are resolved once, unless a packet carries a MID or RSID that may rebind
+  // the SSRC, and are forwarded with a single OnRtpPackets() call to the sink.
+  // Returns the number of packets forwarded.
+  size_t OnRtpPackets(rtc::ArrayView<const RtpPacketReceived> packets);
+
   // The Observer will be notified when an attribute (e.g., RSID, MID, etc.) is
   // bound to an SSRC.
   void RegisterSsrcBindingObserver(SsrcBindingObserver* observer);
@@ -139,7 +149,7 @@ class RtpDemuxer {
 
   // Configure whether to look at the MID header extension when demuxing
   // incoming RTP packets. By default this is enabled.
-  void set_use_mid(bool use_mid) { use_mid_ = use_mid; }
+  void set_use_mid(bool use_mid);
 
  private:
   // Returns true if adding a sink with the given criteria would cause conflicts
@@ -152,6 +162,15 @@ class RtpDemuxer {
   // If the packet should be dropped, this method returns null.
   RtpPacketSinkInterface* ResolveSink(const RtpPacketReceived& packet);
 
+  // Returns the sink for the packet from resolved_sink_by_ssrc_ if its SSRC
+  // is settled there and the packet can't rebind it, otherwise runs
+  // ResolveSink() and updates resolved_sink_by_ssrc_ with the result.
+  RtpPacketSinkInterface* LookupSink(const RtpPacketReceived& packet);
+
+  // Returns true if the packet has header extensions that ResolveSink() uses
+  // to bind its SSRC.
+  bool HasBindingExtensions(const RtpPacketReceived& packet) const;
+
   // Used by the ResolveSink algorithm.
   RtpPacketSinkInterface* ResolveSinkByMid(const std::string& mid,
                                            uint32_t ssrc);
@@ -175,7 +194,7 @@ class RtpDemuxer {
   // SSRC mapping which receives all MID, payload type, or RSID to SSRC bindings
   // discovered when demuxing packets).
   std::map<std::string, RtpPacketSinkInterface*> sink_by_mid_;
-  std::map<uint32_t, RtpPacketSinkInterface*> sink_by_ssrc_;
+  SsrcTable<RtpPacketSinkInterface*> sink_by_ssrc_;
   std::multimap<uint8_t, RtpPacketSinkInterface*> sinks_by_pt_;
   std::map<std::pair<std::string, std::string>, RtpPacketSinkInterface*>
       sink_by_mid_and_rsid_;
@@ -190,8 +209,14 @@ class RtpDemuxer {
   // received.
   // This is stored separately from the sink mappings because if a sink is
   // removed we want to still remember these associations.
-  std::map<uint32_t, std::string> mid_by_ssrc_;
-  std::map<uint32_t, std::string> rsid_by_ssrc_;
+  SsrcTable<std::string> mid_by_ssrc_;
+  SsrcTable<std::string> rsid_by_ssrc_;
+
+  // The final sink of each SSRC whose packets without MID or RSID would be
+  // routed to the sink it is bound to in sink_by_ssrc_, whatever their payload
+  // type. Such packets skip the MID/RSID/SSRC/payload type cascade of
+  // ResolveSink(). Cleared whenever the sinks change, i.e., on renegotiation.
+  SsrcTable<RtpPacketSinkInterface*> resolved_sink_by_ssrc_;
 
   // Adds a binding from the SSRC to the given sink. Returns true if there was
   // not already a sink bound to the SSRC or if the sink replaced a different
@@ -13,6 +13,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "call/ssrc_binding_observer.h"
@@ -212,6 +213,22 @@ class RtpDemuxerTest : public testing::Test {
   uint16_t next_sequence_number_ = 1;
 };
 
+// Records the sequence numbers of each burst handed to OnRtpPackets().
+class BatchRecordingSink : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override {
+    batches.push_back({packet.SequenceNumber()});
+  }
+  void OnRtpPackets(rtc::ArrayView<const RtpPacketReceived> packets) override {
+    std::vector<uint16_t> batch;
+    for (const RtpPacketReceived& packet : packets)
+      batch.push_back(packet.SequenceNumber());
+    batches.push_back(batch);
+  }
+
+  std::vector<std::vector<uint16_t>> batches;
+};
+
 MATCHER_P(SamePacketAs, other, "") {
   return arg.Ssrc() == other.Ssrc() &&
          arg.SequenceNumber() == other.SequenceNumber();
@@ -1478,6 +1495,112 @@ TEST_F(RtpDemuxerTest, MaliciousPeerCannotCauseMemoryOveruse) {
   }
 }
 
+TEST_F(RtpDemuxerTest, SettledSsrcRoutedToNewSinkAfterRenegotiation) {
+  constexpr uint32_t ssrc = 10;
+  MockRtpPacketSink old_sink;
+  AddSinkOnlySsrc(ssrc, &old_sink);
+
+  auto packet = CreatePacketWithSsrc(ssrc);
+  EXPECT_CALL(old_sink, OnRtpPacket(SamePacketAs(*packet))).Times(1);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*packet));
+
+  RemoveSink(&old_sink);
+  MockRtpPacketSink new_sink;
+  AddSinkOnlySsrc(ssrc, &new_sink);
+  packet = CreatePacketWithSsrc(ssrc);
+  EXPECT_CALL(old_sink, OnRtpPacket(_)).Times(0);
+  EXPECT_CALL(new_sink, OnRtpPacket(SamePacketAs(*packet))).Times(1);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*packet));
+}
+
+TEST_F(RtpDemuxerTest, SettledSsrcNotRoutedAfterSinkRemoved) {
+  constexpr uint32_t ssrc = 10;
+  constexpr uint8_t payload_type = 30;
+  MockRtpPacketSink sink;
+  RtpDemuxerCriteria criteria;
+  criteria.payload_types = {payload_type};
+  AddSink(criteria, &sink);
+
+  auto packet = CreatePacketWithSsrc(ssrc);
+  packet->SetPayloadType(payload_type);
+  EXPECT_CALL(sink, OnRtpPacket(_)).Times(2);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*packet));
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc)));
+
+  RemoveSink(&sink);
+  EXPECT_CALL(sink, OnRtpPacket(_)).Times(0);
+  EXPECT_FALSE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc)));
+}
+
+TEST_F(RtpDemuxerTest, OnRtpPacketsForwardsRunsOfSameSsrc) {
+  constexpr uint32_t ssrc1 = 10;
+  constexpr uint32_t ssrc2 = 20;
+  constexpr uint32_t unknown_ssrc = 30;
+  BatchRecordingSink sink1;
+  BatchRecordingSink sink2;
+  AddSinkOnlySsrc(ssrc1, &sink1);
+  AddSinkOnlySsrc(ssrc2, &sink2);
+
+  std::vector<RtpPacketReceived> packets;
+  for (uint32_t ssrc :
+       {ssrc1, ssrc1, ssrc1, ssrc2, ssrc2, unknown_ssrc, ssrc1}) {
+    packets.push_back(*CreatePacketWithSsrc(ssrc));
+  }
+
+  EXPECT_EQ(6u, demuxer_.OnRtpPackets(packets));
+  EXPECT_EQ(sink1.batches,
+            (std::vector<std::vector<uint16_t>>{{1, 2, 3}, {7}}));
+  EXPECT_EQ(sink2.batches, (std::vector<std::vector<uint16_t>>{{4, 5}}));
+}
+
+TEST_F(RtpDemuxerTest, OnRtpPacketsBindsMidOnceForRun) {
+  constexpr uint32_t ssrc = 10;
+  const std::string mid = "mid";
+  BatchRecordingSink sink;
+  AddSinkOnlyMid(mid, &sink);
+  MockSsrcBindingObserver observer;
+  RegisterSsrcBindingObserver(&observer);
+  EXPECT_CALL(observer, OnSsrcBoundToMid(mid, ssrc)).Times(1);
+
+  std::vector<RtpPacketReceived> packets;
+  packets.push_back(*CreatePacketWithSsrcMid(ssrc, mid));
+  packets.push_back(*CreatePacketWithSsrc(ssrc));
+  packets.push_back(*CreatePacketWithSsrc(ssrc));
+
+  EXPECT_EQ(3u, demuxer_.OnRtpPackets(packets));
+  EXPECT_EQ(sink.batches, (std::vector<std::vector<uint16_t>>{{1, 2, 3}}));
+}
+
+TEST_F(RtpDemuxerTest, OnRtpPacketsDropsPacketWithUnknownMidWithinRun) {
+  constexpr uint32_t ssrc = 10;
+  BatchRecordingSink sink;
+  AddSinkOnlyMid("mid", &sink);
+
+  std::vector<RtpPacketReceived> packets;
+  packets.push_back(*CreatePacketWithSsrcMid(ssrc, "mid"));
+  packets.push_back(*CreatePacketWithSsrcMid(ssrc, "unknown"));
+  packets.push_back(*CreatePacketWithSsrc(ssrc));
+
+  // Same result as demuxing the packets one by one.
+  EXPECT_EQ(2u, demuxer_.OnRtpPackets(packets));
+  EXPECT_EQ(sink.batches, (std::vector<std::vector<uint16_t>>{{1}, {3}}));
+}
+
+TEST_F(RtpDemuxerTest, OnRtpPacketsDefaultsToOnRtpPacket) {
+  constexpr uint32_t ssrc = 10;
+  MockRtpPacketSink sink;
+  AddSinkOnlySsrc(ssrc, &sink);
+
+  std::vector<RtpPacketReceived> packets;
+  packets.push_back(*CreatePacketWithSsrc(ssrc));
+  packets.push_back(*CreatePacketWithSsrc(ssrc));
+
+  InSequence sequence;
+  EXPECT_CALL(sink, OnRtpPacket(SamePacketAs(packets[0]))).Times(1);
+  EXPECT_CALL(sink, OnRtpPacket(SamePacketAs(packets[1]))).Times(1);
+  EXPECT_EQ(2u, demuxer_.OnRtpPackets(packets));
+}
+
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 
 TEST_F(RtpDemuxerTest, CriteriaMustBeNonEmpty) {
@@ -10,15 +10,22 @@
 #ifndef CALL_RTP_PACKET_SINK_INTERFACE_H_
 #define CALL_RTP_PACKET_SINK_INTERFACE_H_
 
-namespace webrtc {
+#include "api/array_view.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
 
-class RtpPacketReceived;
+namespace webrtc {
 
 // This class represents a receiver of already parsed RTP packets.
 class RtpPacketSinkInterface {
  public:
   virtual ~RtpPacketSinkInterface() = default;
   virtual void OnRtpPacket(const RtpPacketReceived& packet) = 0;
+  // Receives consecutive packets of one stream, in order. Sinks that can
+  // amortize per-packet work over a burst may override this.
+  virtual void OnRtpPackets(rtc::ArrayView<const RtpPacketReceived> packets) {
+    for (const RtpPacketReceived& packet : packets)
+      OnRtpPacket(packet);
+  }
 };
 
 }  // namespace webrtc
@@ -0,0 +1,358 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_stream_forwarder.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "modules/rtp_rtcp/include/rtp_rtcp.h"
+#include "modules/rtp_rtcp/source/rtp_generic_frame_descriptor.h"
+#include "modules/rtp_rtcp/source/rtp_generic_frame_descriptor_extension.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kVideoPayloadTypeFrequencyKhz = 90;
+// Decisions are kept for the frames that reordered packets may belong to.
+constexpr size_t kMaxNumDecisions = 32;
+// Sequence number offsets are kept for as many drops.
+constexpr size_t kMaxNumSequenceNumberOffsets = 64;
+
+bool ParseVp8Descriptor(rtc::ArrayView<const uint8_t> payload,
+                        bool* first_packet,
+                        bool* key_frame,
+                        bool* layer_sync,
+                        int* temporal_layer,
+                        int* picture_id,
+                        size_t* picture_id_offset,
+                        bool* long_picture_id,
+                        int* tl0_pic_idx,
+                        size_t* tl0_pic_idx_offset) {
+  // RFC 7741, section 4.2.
+  if (payload.empty())
+    return false;
+  const bool extended = (payload[0] & 0x80) != 0;
+  const bool start_of_partition = (payload[0] & 0x10) != 0;
+  const int partition_id = payload[0] & 0x07;
+  size_t offset = 1;
+  if (extended) {
+    if (payload.size() <= offset)
+      return false;
+    const uint8_t extension = payload[offset++];
+    if (extension & 0x80) {
+      if (payload.size() <= offset)
+        return false;
+      *picture_id_offset = offset;
+      *long_picture_id = (payload[offset] & 0x80) != 0;
+      if (*long_picture_id) {
+        if (payload.size() <= offset + 1)
+          return false;
+        *picture_id = ((payload[offset] & 0x7F) << 8) | payload[offset + 1];
+        offset += 2;
+      } else {
+        *picture_id = payload[offset++];
+      }
+    }
+    if (extension & 0x40) {
+      if (payload.size() <= offset)
+        return false;
+      *tl0_pic_idx_offset = offset;
+      *tl0_pic_idx = payload[offset++];
+    }
+    if (extension & 0x30) {
+      if (payload.size() <= offset)
+        return false;
+      if (extension & 0x20) {
+        *temporal_layer = payload[offset] >> 6;
+        *layer_sync = (payload[offset] & 0x20) != 0;
+      }
+      ++offset;
+    }
+  }
+  *first_packet = start_of_partition && partition_id == 0;
+  if (*first_packet) {
+    if (payload.size() <= offset)
+      return false;
+    // The inverse key frame flag of the VP8 payload header.
+    *key_frame = (payload[offset] & 0x01) == 0;
+  }
+  return true;
+}
+
+int LowestSpatialLayer(uint8_t spatial_layers_bitmask) {
+  for (int sid = 0; sid < 8; ++sid) {
+    if (spatial_layers_bitmask & (1 << sid))
+      return sid;
+  }
+  return 0;
+}
+
+}  // namespace
+
+RtpStreamForwarder::RtpStreamForwarder(const Config& config)
+    : config_(config) {
+  RTC_DCHECK(config_.sender);
+}
+
+RtpStreamForwarder::~RtpStreamForwarder() = default;
+
+void RtpStreamForwarder::Select(const Selection& selection) {
+  bool request_key_frame = false;
+  {
+    rtc::CritScope lock(&crit_);
+    if (current_ && current_->ssrc == selection.ssrc &&
+        selection.max_spatial_layer <= current_->max_spatial_layer &&
+        selection.max_temporal_layer <= current_->max_temporal_layer) {
+      current_ = selection;
+      pending_.reset();
+      return;
+    }
+    pending_ = selection;
+    // Temporal layers of VP8 can be added at layer sync frames.
+    request_key_frame =
+        !(config_.codec == kVideoCodecVP8 && current_ &&
+          current_->ssrc == selection.ssrc &&
+          selection.max_spatial_layer <= current_->max_spatial_layer);
+  }
+  if (request_key_frame && config_.key_frame_requester)
+    config_.key_frame_requester->RequestKeyFrame(selection.ssrc);
+}
+
+void RtpStreamForwarder::OnKeyFrameRequest() {
+  uint32_t ssrc = 0;
+  {
+    rtc::CritScope lock(&crit_);
+    if (pending_) {
+      ssrc = pending_->ssrc;
+    } else if (current_) {
+      ssrc = current_->ssrc;
+    } else {
+      return;
+    }
+  }
+  if (config_.key_frame_requester)
+    config_.key_frame_requester->RequestKeyFrame(ssrc);
+}
+
+void RtpStreamForwarder::OnRtpPacket(const RtpPacketReceived& packet) {
+  FrameInfo info;
+  const bool parsed = ParseFrameInfo(packet, &info);
+
+  rtc::CritScope lock(&crit_);
+  if (parsed && info.first_packet && pending_ &&
+      pending_->ssrc == packet.Ssrc() && CanSwitchAt(info)) {
+    if (!current_ || current_->ssrc != packet.Ssrc())
+      SwitchSource(packet, info);
+    current_ = pending_;
+    pending_.reset();
+  }
+  if (!current_ || current_->ssrc != packet.Ssrc())
+    return;
+
+  const int64_t sequence_number =
+      sequence_number_unwrapper_.Unwrap(packet.SequenceNumber());
+  if (!parsed) {
+    DropPacket(sequence_number);
+    return;
+  }
+  if (info.first_packet) {
+    const FrameDecision* decision =
+        FindDecision(packet.Timestamp(), sequence_number);
+    // Unless the packet is a duplicate.
+    if (!decision || decision->first_sequence_number != sequence_number)
+      AddDecision(packet, sequence_number, info);
+  }
+  const FrameDecision* decision =
+      FindDecision(packet.Timestamp(), sequence_number);
+  if (!decision || !decision->forward) {
+    DropPacket(sequence_number);
+    return;
+  }
+  ForwardPacket(packet, sequence_number, info, *decision);
+}
+
+bool RtpStreamForwarder::ParseFrameInfo(const RtpPacketReceived& packet,
+                                        FrameInfo* info) const {
+  if (config_.codec == kVideoCodecVP8) {
+    info->last_packet_of_layer = packet.Marker();
+    return ParseVp8Descriptor(
+        packet.payload(), &info->first_packet, &info->key_frame,
+        &info->layer_sync, &info->temporal_layer, &info->picture_id,
+        &info->picture_id_offset, &info->long_picture_id, &info->tl0_pic_idx,
+        &info->tl0_pic_idx_offset);
+  }
+  RtpGenericFrameDescriptor descriptor;
+  if (packet.payload().empty() ||
+      !packet.GetExtension<RtpGenericFrameDescriptorExtension>(&descriptor)) {
+    return false;
+  }
+  info->first_packet = descriptor.FirstPacketInSubFrame();
+  info->last_packet_of_layer = descriptor.LastPacketInSubFrame();
+  if (info->first_packet) {
+    info->key_frame = descriptor.FrameDependenciesDiffs().empty();
+    info->temporal_layer = descriptor.TemporalLayer();
+    info->spatial_layer =
+        LowestSpatialLayer(descriptor.SpatialLayersBitmask());
+  }
+  return true;
+}
+
+bool RtpStreamForwarder::CanSwitchAt(const FrameInfo& info) const {
+  if (info.key_frame)
+    return true;
+  return config_.codec == kVideoCodecVP8 && info.layer_sync && current_ &&
+         current_->ssrc == pending_->ssrc &&
+         pending_->max_spatial_layer <= current_->max_spatial_layer;
+}
+
+bool RtpStreamForwarder::ShouldForward(const FrameInfo& info) const {
+  return info.temporal_layer <= current_->max_temporal_layer &&
+         info.spatial_layer <= current_->max_spatial_layer;
+}
+
+void RtpStreamForwarder::SwitchSource(const RtpPacketReceived& packet,
+                                      const FrameInfo& info) {
+  sequence_number_unwrapper_ = SeqNumUnwrapper<uint16_t>();
+  const int64_t sequence_number =
+      sequence_number_unwrapper_.Unwrap(packet.SequenceNumber());
+  highest_sequence_number_ = sequence_number - 1;
+  sequence_number_offsets_.clear();
+  decisions_.clear();
+  if (!sent_any_) {
+    // The first source keeps its sequence numbers and timestamps.
+    min_out_sequence_number_ = std::numeric_limits<int64_t>::min();
+    sequence_number_offsets_[sequence_number] =
+        packet.SequenceNumber() - sequence_number;
+    timestamp_offset_ = 0;
+    tl0_pic_idx_offset_ = 0;
+    return;
+  }
+  // Sequence numbers continue where the previous source stopped, and the
+  // timestamps move on by the time that has passed since its last packet.
+  min_out_sequence_number_ = highest_out_sequence_number_ + 1;
+  sequence_number_offsets_[sequence_number] =
+      min_out_sequence_number_ - sequence_number;
+  const int64_t elapsed_ms =
+      std::max<int64_t>(1, packet.arrival_time_ms() - last_out_time_ms_);
+  timestamp_offset_ = last_out_timestamp_ +
+                      static_cast<uint32_t>(elapsed_ms *
+                                            kVideoPayloadTypeFrequencyKhz) -
+                      packet.Timestamp();
+  tl0_pic_idx_offset_ = last_out_tl0_pic_idx_ >= 0 && info.tl0_pic_idx >= 0
+                            ? last_out_tl0_pic_idx_ + 1 - info.tl0_pic_idx
+                            : 0;
+}
+
+void RtpStreamForwarder::AddDecision(const RtpPacketReceived& packet,
+                                     int64_t sequence_number,
+                                     const FrameInfo& info) {
+  FrameDecision decision;
+  decision.timestamp = packet.Timestamp();
+  decision.first_sequence_number = sequence_number;
+  decision.forward = ShouldForward(info);
+  decision.spatial_layer = info.spatial_layer;
+  decision.out_picture_id = -1;
+  decision.out_tl0_pic_idx = -1;
+  if (decision.forward && info.picture_id >= 0) {
+    // Picture IDs of the forwarded frames are consecutive.
+    decision.out_picture_id = last_out_picture_id_ >= 0
+                                  ? (last_out_picture_id_ + 1) & 0x7FFF
+                                  : info.picture_id;
+    last_out_picture_id_ = decision.out_picture_id;
+  }
+  if (decision.forward && info.tl0_pic_idx >= 0) {
+    decision.out_tl0_pic_idx = (info.tl0_pic_idx + tl0_pic_idx_offset_) & 0xFF;
+    last_out_tl0_pic_idx_ = decision.out_tl0_pic_idx;
+  }
+  decisions_.push_back(decision);
+  if (decisions_.size() > kMaxNumDecisions)
+    decisions_.pop_front();
+}
+
+const RtpStreamForwarder::FrameDecision* RtpStreamForwarder::FindDecision(
+    uint32_t timestamp,
+    int64_t sequence_number) const {
+  // The (sub)frame that the packet belongs to is the last one of its
+  // timestamp that starts at or before it.
+  const FrameDecision* found = nullptr;
+  for (const FrameDecision& decision : decisions_) {
+    if (decision.timestamp == timestamp &&
+        decision.first_sequence_number <= sequence_number &&
+        (!found ||
+         decision.first_sequence_number > found->first_sequence_number)) {
+      found = &decision;
+    }
+  }
+  return found;
+}
+
+void RtpStreamForwarder::DropPacket(int64_t sequence_number) {
+  // A dropped packet that arrives late has already got its sequence number,
+  // and leaves a gap.
+  if (sequence_number <= highest_sequence_number_ ||
+      sequence_number_offsets_.empty()) {
+    return;
+  }
+  highest_sequence_number_ = sequence_number;
+  const int64_t offset = (--sequence_number_offsets_.end())->second;
+  sequence_number_offsets_[sequence_number + 1] = offset - 1;
+  if (sequence_number_offsets_.size() > kMaxNumSequenceNumberOffsets)
+    sequence_number_offsets_.erase(sequence_number_offsets_.begin());
+}
+
+void RtpStreamForwarder::ForwardPacket(const RtpPacketReceived& packet,
+                                       int64_t sequence_number,
+                                       const FrameInfo& info,
+                                       const FrameDecision& decision) {
+  auto it = sequence_number_offsets_.upper_bound(sequence_number);
+  if (it == sequence_number_offsets_.begin())
+    return;
+  const int64_t out_sequence_number = sequence_number + (--it)->second;
+  if (out_sequence_number < min_out_sequence_number_)
+    return;
+  highest_sequence_number_ =
+      std::max(highest_sequence_number_, sequence_number);
+
+  const rtc::ArrayView<const uint8_t> payload = packet.payload();
+  payload_.assign(payload.begin(), payload.end());
+  if (decision.out_picture_id >= 0 && info.picture_id >= 0) {
+    if (info.long_picture_id) {
+      payload_[info.picture_id_offset] =
+          0x80 | ((decision.out_picture_id >> 8) & 0x7F);
+      payload_[info.picture_id_offset + 1] = decision.out_picture_id & 0xFF;
+    } else {
+      payload_[info.picture_id_offset] = decision.out_picture_id & 0x7F;
+    }
+  }
+  if (decision.out_tl0_pic_idx >= 0 && info.tl0_pic_idx >= 0)
+    payload_[info.tl0_pic_idx_offset] = decision.out_tl0_pic_idx;
+
+  // With upper spatial layers dropped, the frame ends with the highest
+  // forwarded one.
+  const bool marker = packet.Marker() ||
+                      (info.last_packet_of_layer &&
+                       decision.spatial_layer == current_->max_spatial_layer);
+  const uint32_t out_timestamp = packet.Timestamp() + timestamp_offset_;
+  if (!sent_any_ || out_sequence_number > highest_out_sequence_number_) {
+    sent_any_ = true;
+    highest_out_sequence_number_ = out_sequence_number;
+    last_out_timestamp_ = out_timestamp;
+    last_out_time_ms_ = packet.arrival_time_ms();
+  }
+  config_.sender->SendRtpPayload(
+      packet.PayloadType(), marker,
+      static_cast<uint16_t>(out_sequence_number), out_timestamp,
+      packet.arrival_time_ms(), payload_);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_RTP_STREAM_FORWARDER_H_
+#define CALL_RTP_STREAM_FORWARDER_H_
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "common_types.h"  // NOLINT(build/include)
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/numerics/sequence_number_util.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class RtpRtcp;
+
+// Forwards received video to one outgoing stream without decoding it, as a
+// selective forwarding unit does. Of the packets of one or more source
+// streams, e.g. the simulcast streams of a sender, it forwards those of the
+// selected source and layers, rewritten into one continuous stream: sequence
+// numbers, RTP timestamps and, for VP8, picture IDs and TL0PICIDX. Dropped
+// packets leave no gaps. A switch to another source or to more layers waits
+// for a frame that the receivers can decode from, and requests a key frame.
+//
+// Packets are sent with RtpRtcp::SendRtpPayload() of the module of the
+// outgoing stream, so that its pacer and packet history are used, and NACKs
+// are answered by the module. A source RTX stream can be unwrapped by an
+// RtxReceiveStream in front of the forwarder.
+class RtpStreamForwarder : public RtpPacketSinkInterface {
+ public:
+  static constexpr int kAllLayers = 7;
+
+  class KeyFrameRequester {
+   public:
+    virtual void RequestKeyFrame(uint32_t source_ssrc) = 0;
+
+   protected:
+    virtual ~KeyFrameRequester() {}
+  };
+
+  struct Config {
+    // Must outlive the forwarder. Either may be called on the thread that
+    // delivers packets, or that selects layers.
+    RtpRtcp* sender = nullptr;
+    KeyFrameRequester* key_frame_requester = nullptr;
+    // VP8 payload descriptors are parsed for layers and key frames. For other
+    // codecs, these are read from the generic frame descriptor extension, and
+    // packets without it are dropped.
+    VideoCodecType codec = kVideoCodecVP8;
+  };
+
+  struct Selection {
+    uint32_t ssrc = 0;
+    // The highest layers to forward.
+    int max_temporal_layer = kAllLayers;
+    int max_spatial_layer = kAllLayers;
+  };
+
+  explicit RtpStreamForwarder(const Config& config);
+  ~RtpStreamForwarder() override;
+
+  // Dropping layers of the current source takes effect at the next frame.
+  // Other switches take effect at the next key frame of |selection.ssrc|, or,
+  // for more temporal layers of VP8, at the next layer sync frame; till then
+  // the current selection is forwarded.
+  void Select(const Selection& selection);
+
+  // To be called when a receiver of the outgoing stream asks for a key frame.
+  void OnKeyFrameRequest();
+
+  // RtpPacketSinkInterface.
+  void OnRtpPacket(const RtpPacketReceived& packet) override;
+
+ private:
+  // What is known about the (sub)frame of a packet.
+  struct FrameInfo {
+    bool first_packet = false;
+    bool last_packet_of_layer = false;
+    // Only valid for the first packet of a (sub)frame.
+    bool key_frame = false;
+    bool layer_sync = false;
+    int temporal_layer = 0;
+    int spatial_layer = 0;
+    // VP8 only, -1 if absent. The offsets are those of the fields in the
+    // payload.
+    int picture_id = -1;
+    size_t picture_id_offset = 0;
+    bool long_picture_id = false;
+    int tl0_pic_idx = -1;
+    size_t tl0_pic_idx_offset = 0;
+  };
+
+  // The decision taken for a (sub)frame at its first packet, for the packets
+  // that follow, in whatever order.
+  struct FrameDecision {
+    uint32_t timestamp;
+    int64_t first_sequence_number;
+    bool forward;
+    int spatial_layer;
+    int out_picture_id;
+    int out_tl0_pic_idx;
+  };
+
+  bool ParseFrameInfo(const RtpPacketReceived& packet, FrameInfo* info) const;
+  bool CanSwitchAt(const FrameInfo& info) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  bool ShouldForward(const FrameInfo& info) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void SwitchSource(const RtpPacketReceived& packet, const FrameInfo& info)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void AddDecision(const RtpPacketReceived& packet,
+                   int64_t sequence_number,
+                   const FrameInfo& info) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  const FrameDecision* FindDecision(uint32_t timestamp,
+                                    int64_t sequence_number) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void DropPacket(int64_t sequence_number) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void ForwardPacket(const RtpPacketReceived& packet,
+                     int64_t sequence_number,
+                     const FrameInfo& info,
+                     const FrameDecision& decision)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const Config config_;
+
+  rtc::CriticalSection crit_;
+  absl::optional<Selection> current_ RTC_GUARDED_BY(crit_);
+  absl::optional<Selection> pending_ RTC_GUARDED_BY(crit_);
+
+  // Rewriting of the current source.
+  SeqNumUnwrapper<uint16_t> sequence_number_unwrapper_ RTC_GUARDED_BY(crit_);
+  int64_t highest_sequence_number_ RTC_GUARDED_BY(crit_) = 0;
+  // Map from the first source sequence number that it applies to, to the
+  // offset of outgoing sequence numbers, which shrinks by one for every
+  // dropped packet.
+  std::map<int64_t, int64_t> sequence_number_offsets_ RTC_GUARDED_BY(crit_);
+  // Outgoing sequence numbers below this one belong to the previous source.
+  int64_t min_out_sequence_number_ RTC_GUARDED_BY(crit_) = 0;
+  uint32_t timestamp_offset_ RTC_GUARDED_BY(crit_) = 0;
+  int tl0_pic_idx_offset_ RTC_GUARDED_BY(crit_) = 0;
+  std::deque<FrameDecision> decisions_ RTC_GUARDED_BY(crit_);
+
+  // The outgoing stream.
+  bool sent_any_ RTC_GUARDED_BY(crit_) = false;
+  int64_t highest_out_sequence_number_ RTC_GUARDED_BY(crit_) = 0;
+  uint32_t last_out_timestamp_ RTC_GUARDED_BY(crit_) = 0;
+  int64_t last_out_time_ms_ RTC_GUARDED_BY(crit_) = 0;
+  int last_out_picture_id_ RTC_GUARDED_BY(crit_) = -1;
+  int last_out_tl0_pic_idx_ RTC_GUARDED_BY(crit_) = -1;
+  std::vector<uint8_t> payload_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpStreamForwarder);
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_RTP_STREAM_FORWARDER_H_
@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "call/rtp_stream_forwarder.h"
+#include "modules/rtp_rtcp/mocks/mock_rtp_rtcp.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+constexpr int kPayloadType = 96;
+constexpr uint32_t kSsrc1 = 1111;
+constexpr uint32_t kSsrc2 = 2222;
+
+class MockKeyFrameRequester : public RtpStreamForwarder::KeyFrameRequester {
+ public:
+  MOCK_METHOD1(RequestKeyFrame, void(uint32_t));
+};
+
+struct SentPacket {
+  uint16_t sequence_number;
+  uint32_t timestamp;
+  bool marker;
+  int picture_id;
+  int tl0_pic_idx;
+};
+
+struct Vp8Frame {
+  bool key_frame;
+  int temporal_layer;
+  bool layer_sync;
+  int picture_id;
+  int tl0_pic_idx;
+};
+
+// A VP8 packet with a 15 bit picture ID, TL0PICIDX and TID.
+RtpPacketReceived Vp8Packet(uint32_t ssrc,
+                            uint16_t sequence_number,
+                            uint32_t timestamp,
+                            const Vp8Frame& frame,
+                            bool first_packet,
+                            bool marker) {
+  const uint8_t payload[] = {
+      static_cast<uint8_t>(0x80 | (first_packet ? 0x10 : 0)),
+      0xE0,
+      static_cast<uint8_t>(0x80 | (frame.picture_id >> 8)),
+      static_cast<uint8_t>(frame.picture_id & 0xFF),
+      static_cast<uint8_t>(frame.tl0_pic_idx),
+      static_cast<uint8_t>((frame.temporal_layer << 6) |
+                           (frame.layer_sync ? 0x20 : 0)),
+      static_cast<uint8_t>(frame.key_frame ? 0x00 : 0x01),
+      0xEE};
+  RtpPacketReceived packet;
+  packet.SetPayloadType(kPayloadType);
+  packet.SetSsrc(ssrc);
+  packet.SetSequenceNumber(sequence_number);
+  packet.SetTimestamp(timestamp);
+  packet.SetMarker(marker);
+  uint8_t* data = packet.AllocatePayload(sizeof(payload));
+  memcpy(data, payload, sizeof(payload));
+  packet.set_arrival_time_ms(timestamp / 90);
+  return packet;
+}
+
+class RtpStreamForwarderTest : public ::testing::Test {
+ protected:
+  RtpStreamForwarderTest() {
+    ON_CALL(sender_, SendRtpPayload(_, _, _, _, _, _))
+        .WillByDefault(Invoke([this](int8_t payload_type, bool marker,
+                                     uint16_t sequence_number,
+                                     uint32_t timestamp,
+                                     int64_t capture_time_ms,
+                                     rtc::ArrayView<const uint8_t> payload) {
+          EXPECT_EQ(kPayloadType, payload_type);
+          sent_.push_back({sequence_number, timestamp, marker,
+                           ((payload[2] & 0x7F) << 8) | payload[3],
+                           payload[4]});
+          return true;
+        }));
+    RtpStreamForwarder::Config config;
+    config.sender = &sender_;
+    config.key_frame_requester = &requester_;
+    forwarder_.reset(new RtpStreamForwarder(config));
+  }
+
+  void Select(uint32_t ssrc, int max_temporal_layer) {
+    RtpStreamForwarder::Selection selection;
+    selection.ssrc = ssrc;
+    selection.max_temporal_layer = max_temporal_layer;
+    forwarder_->Select(selection);
+  }
+
+  // Sends a frame of one packet.
+  void SendFrame(uint32_t ssrc,
+                 uint16_t sequence_number,
+                 uint32_t timestamp,
+                 const Vp8Frame& frame) {
+    forwarder_->OnRtpPacket(
+        Vp8Packet(ssrc, sequence_number, timestamp, frame, true, true));
+  }
+
+  NiceMock<MockRtpRtcp> sender_;
+  NiceMock<MockKeyFrameRequester> requester_;
+  std::unique_ptr<RtpStreamForwarder> forwarder_;
+  std::vector<SentPacket> sent_;
+};
+
+}  // namespace
+
+TEST_F(RtpStreamForwarderTest, SwitchesSourceAtKeyFrame) {
+  EXPECT_CALL(requester_, RequestKeyFrame(kSsrc1));
+  Select(kSsrc1, RtpStreamForwarder::kAllLayers);
+  SendFrame(kSsrc1, 100, 9000, {true, 0, false, 10, 5});
+  SendFrame(kSsrc1, 101, 12000, {false, 0, false, 11, 6});
+
+  EXPECT_CALL(requester_, RequestKeyFrame(kSsrc2));
+  Select(kSsrc2, RtpStreamForwarder::kAllLayers);
+  // Till its key frame, the new source is dropped and the old one forwarded.
+  SendFrame(kSsrc2, 5000, 700000, {false, 0, false, 300, 40});
+  SendFrame(kSsrc1, 102, 15000, {false, 0, false, 12, 7});
+  SendFrame(kSsrc2, 5001, 703000, {true, 0, false, 301, 41});
+  SendFrame(kSsrc1, 103, 18000, {false, 0, false, 13, 8});
+  SendFrame(kSsrc2, 5002, 706000, {false, 0, false, 302, 42});
+
+  ASSERT_EQ(5u, sent_.size());
+  for (size_t i = 0; i < sent_.size(); ++i) {
+    EXPECT_EQ(100 + i, sent_[i].sequence_number);
+    EXPECT_EQ(10 + static_cast<int>(i), sent_[i].picture_id);
+    EXPECT_EQ(5 + static_cast<int>(i), sent_[i].tl0_pic_idx);
+  }
+  // The new source continues the timestamps of the old one.
+  EXPECT_EQ(9000u, sent_[0].timestamp);
+  EXPECT_EQ(15000u, sent_[2].timestamp);
+  EXPECT_GT(sent_[3].timestamp, sent_[2].timestamp);
+  EXPECT_EQ(sent_[3].timestamp + 3000, sent_[4].timestamp);
+}
+
+TEST_F(RtpStreamForwarderTest, DropsTemporalLayersWithoutGaps) {
+  Select(kSsrc1, 1);
+  const int kTemporalLayers[] = {0, 2, 1, 2, 0, 2, 1, 2};
+  for (int i = 0; i < 8; ++i) {
+    SendFrame(kSsrc1, 100 + i, 3000 * i,
+              {i == 0, kTemporalLayers[i], false, 50 + i, i / 4});
+  }
+  ASSERT_EQ(4u, sent_.size());
+  for (size_t i = 0; i < sent_.size(); ++i) {
+    EXPECT_EQ(100 + i, sent_[i].sequence_number);
+    EXPECT_EQ(50 + static_cast<int>(i), sent_[i].picture_id);
+    EXPECT_EQ(6000u * i, sent_[i].timestamp);
+  }
+
+  // More temporal layers are added at a layer sync frame, without a key frame
+  // request.
+  EXPECT_CALL(requester_, RequestKeyFrame(_)).Times(0);
+  Select(kSsrc1, RtpStreamForwarder::kAllLayers);
+  SendFrame(kSsrc1, 108, 24000, {false, 2, false, 58, 2});
+  SendFrame(kSsrc1, 109, 27000, {false, 1, true, 59, 2});
+  SendFrame(kSsrc1, 110, 30000, {false, 2, false, 60, 2});
+  ASSERT_EQ(6u, sent_.size());
+  EXPECT_EQ(104, sent_[4].sequence_number);
+  EXPECT_EQ(54, sent_[4].picture_id);
+  EXPECT_EQ(105, sent_[5].sequence_number);
+  EXPECT_EQ(55, sent_[5].picture_id);
+}
+
+TEST_F(RtpStreamForwarderTest, KeepsOrderOfReorderedPackets) {
+  Select(kSsrc1, 0);
+  const Vp8Frame kFrame1 = {true, 0, false, 1, 0};
+  const Vp8Frame kFrame2 = {false, 1, false, 2, 0};
+  const Vp8Frame kFrame3 = {false, 0, false, 3, 1};
+  // Frame 1 is packets 1-2, frame 2, which is dropped, 3, frame 3 4-5.
+  forwarder_->OnRtpPacket(Vp8Packet(kSsrc1, 1, 0, kFrame1, true, false));
+  forwarder_->OnRtpPacket(Vp8Packet(kSsrc1, 3, 3000, kFrame2, true, true));
+  forwarder_->OnRtpPacket(Vp8Packet(kSsrc1, 4, 6000, kFrame3, true, false));
+  forwarder_->OnRtpPacket(Vp8Packet(kSsrc1, 5, 6000, kFrame3, false, true));
+  forwarder_->OnRtpPacket(Vp8Packet(kSsrc1, 2, 0, kFrame1, false, true));
+
+  ASSERT_EQ(4u, sent_.size());
+  EXPECT_EQ(1, sent_[0].sequence_number);
+  EXPECT_EQ(3, sent_[1].sequence_number);
+  EXPECT_EQ(2, sent_[1].picture_id);
+  EXPECT_EQ(4, sent_[2].sequence_number);
+  EXPECT_TRUE(sent_[2].marker);
+  EXPECT_EQ(2, sent_[3].sequence_number);
+  EXPECT_EQ(1, sent_[3].picture_id);
+  EXPECT_TRUE(sent_[3].marker);
+}
+
+TEST_F(RtpStreamForwarderTest, RequestsKeyFrameOfSelectedSource) {
+  forwarder_->OnKeyFrameRequest();
+  Select(kSsrc1, RtpStreamForwarder::kAllLayers);
+  EXPECT_CALL(requester_, RequestKeyFrame(kSsrc1));
+  forwarder_->OnKeyFrameRequest();
+}
+
+}  // namespace webrtc
@@ -54,6 +54,12 @@ bool RtpStreamReceiverController::OnRtpPacket(const RtpPacketReceived& packet) {
   return demuxer_.OnRtpPacket(packet);
 }
 
+size_t RtpStreamReceiverController::OnRtpPackets(
+    rtc::ArrayView<const RtpPacketReceived> packets) {
+  rtc::CritScope cs(&lock_);
+  return demuxer_.OnRtpPackets(packets);
+}
+
 bool RtpStreamReceiverController::AddSink(uint32_t ssrc,
                                           RtpPacketSinkInterface* sink) {
   rtc::CritScope cs(&lock_);
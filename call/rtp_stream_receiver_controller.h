@@ -43,6 +43,7 @@ class RtpStreamReceiverController
 
   // TODO(nisse): Not yet responsible for parsing.
   bool OnRtpPacket(const RtpPacketReceived& packet);
+  size_t OnRtpPackets(rtc::ArrayView<const RtpPacketReceived> packets);
 
  private:
   class Receiver : public RtpStreamReceiverInterface {
@@ -188,6 +188,10 @@ void RtpTransportControllerSend::SetPacingFactor(float pacing_factor) {
 void RtpTransportControllerSend::SetQueueTimeLimit(int limit_ms) {
   pacer_.SetQueueTimeLimit(limit_ms);
 }
+void RtpTransportControllerSend::SetStreamAllocation(uint32_t ssrc,
+                                                     uint32_t bitrate_bps) {
+  pacer_.SetStreamAllocation(ssrc, bitrate_bps);
+}
 CallStatsObserver* RtpTransportControllerSend::GetCallStatsObserver() {
   return send_side_cc_.get();
 }
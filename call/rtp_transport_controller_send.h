@@ -80,6 +80,7 @@ class RtpTransportControllerSend final
   void SetKeepAliveConfig(const RtpKeepAliveConfig& config);
   void SetPacingFactor(float pacing_factor) override;
   void SetQueueTimeLimit(int limit_ms) override;
+  void SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) override;
   CallStatsObserver* GetCallStatsObserver() override;
   void RegisterPacketFeedbackObserver(
       PacketFeedbackObserver* observer) override;
@@ -123,6 +123,9 @@ class RtpTransportControllerSendInterface {
 
   virtual void SetPacingFactor(float pacing_factor) = 0;
   virtual void SetQueueTimeLimit(int limit_ms) = 0;
+  // Sets the bitrate the BitrateAllocator gave to the RTP stream with |ssrc|,
+  // used by the pacer to share the link between streams.
+  virtual void SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) = 0;
 
   virtual CallStatsObserver* GetCallStatsObserver() = 0;
 
@@ -0,0 +1,417 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/shared_rtp_transport_controller_send.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/types/optional.h"
+#include "api/transport/network_control.h"
+#include "call/rtp_transport_controller_send.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/task_queue.h"
+
+namespace webrtc {
+
+// Owns the controller shared by all Calls attached with one path key, and is
+// the only target rate observer of that controller.
+class SharedRtpTransportControllerSendPool::SharedController
+    : public TargetTransferRateObserver {
+ public:
+  explicit SharedController(
+      std::unique_ptr<RtpTransportControllerSendInterface> controller)
+      : controller_(std::move(controller)) {
+    controller_->RegisterTargetTransferRateObserver(this);
+  }
+  ~SharedController() override { RTC_DCHECK(attachments_.empty()); }
+
+  RtpTransportControllerSendInterface* controller() {
+    return controller_.get();
+  }
+
+  void AddAttachment(Attachment* attachment) {
+    rtc::CritScope cs(&crit_);
+    RTC_DCHECK(attachments_.find(attachment) == attachments_.end());
+    attachments_[attachment];
+  }
+
+  // Returns true if |attachment| was the last one.
+  bool RemoveAttachment(Attachment* attachment) {
+    rtc::CritScope cs(&crit_);
+    attachments_.erase(attachment);
+    if (attachments_.empty())
+      return true;
+    UpdateAllocationLimits();
+    UpdateNetworkAvailability();
+    UpdatePerPacketFeedbackAvailable();
+    UpdateBitrateWithoutFeedback();
+    PostDistribution();
+    return false;
+  }
+
+  void SetTargetTransferRateObserver(Attachment* attachment,
+                                     TargetTransferRateObserver* observer) {
+    rtc::CritScope cs(&crit_);
+    AttachmentState& state = attachments_[attachment];
+    RTC_DCHECK(state.observer == nullptr);
+    state.observer = observer;
+    // Give the new Call its share of the current estimate, instead of leaving
+    // it without any until the estimate changes.
+    PostDistribution();
+  }
+
+  void SetAllocatedSendBitrateLimits(Attachment* attachment,
+                                     int min_send_bitrate_bps,
+                                     int max_padding_bitrate_bps,
+                                     int total_bitrate_bps) {
+    rtc::CritScope cs(&crit_);
+    AttachmentState& state = attachments_[attachment];
+    state.min_send_bitrate_bps = min_send_bitrate_bps;
+    state.max_padding_bitrate_bps = max_padding_bitrate_bps;
+    state.total_bitrate_bps = total_bitrate_bps;
+    UpdateAllocationLimits();
+    // Posted rather than run here, since this is called by the BitrateAllocator
+    // that the distribution would call back into.
+    PostDistribution();
+  }
+
+  void SetNetworkAvailability(Attachment* attachment, bool network_available) {
+    rtc::CritScope cs(&crit_);
+    attachments_[attachment].network_available = network_available;
+    UpdateNetworkAvailability();
+  }
+
+  void SetPerPacketFeedbackAvailable(Attachment* attachment, bool available) {
+    rtc::CritScope cs(&crit_);
+    attachments_[attachment].per_packet_feedback_available = available;
+    UpdatePerPacketFeedbackAvailable();
+  }
+
+  void SetAllocatedBitrateWithoutFeedback(Attachment* attachment,
+                                          uint32_t bitrate_bps) {
+    rtc::CritScope cs(&crit_);
+    attachments_[attachment].bitrate_without_feedback_bps = bitrate_bps;
+    UpdateBitrateWithoutFeedback();
+  }
+
+  // Implements TargetTransferRateObserver.
+  void OnTargetTransferRate(TargetTransferRate msg) override {
+    rtc::CritScope cs(&crit_);
+    last_target_rate_ = msg;
+    DistributeTargetRate();
+  }
+
+ private:
+  struct AttachmentState {
+    TargetTransferRateObserver* observer = nullptr;
+    int min_send_bitrate_bps = 0;
+    int max_padding_bitrate_bps = 0;
+    int total_bitrate_bps = 0;
+    bool network_available = false;
+    bool per_packet_feedback_available = false;
+    uint32_t bitrate_without_feedback_bps = 0;
+  };
+
+  void UpdateAllocationLimits() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    int min_send_bitrate_bps = 0;
+    int max_padding_bitrate_bps = 0;
+    int total_bitrate_bps = 0;
+    for (const auto& it : attachments_) {
+      min_send_bitrate_bps += it.second.min_send_bitrate_bps;
+      max_padding_bitrate_bps += it.second.max_padding_bitrate_bps;
+      total_bitrate_bps += it.second.total_bitrate_bps;
+    }
+    controller_->SetAllocatedSendBitrateLimits(
+        min_send_bitrate_bps, max_padding_bitrate_bps, total_bitrate_bps);
+  }
+
+  // The network is up as long as it is up for any of the Calls.
+  void UpdateNetworkAvailability() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    bool network_available = false;
+    for (const auto& it : attachments_)
+      network_available |= it.second.network_available;
+    if (network_available_ == network_available)
+      return;
+    network_available_ = network_available;
+    controller_->OnNetworkAvailability(network_available);
+  }
+
+  void UpdatePerPacketFeedbackAvailable() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    bool available = false;
+    for (const auto& it : attachments_)
+      available |= it.second.per_packet_feedback_available;
+    if (per_packet_feedback_available_ == available)
+      return;
+    per_packet_feedback_available_ = available;
+    controller_->SetPerPacketFeedbackAvailable(available);
+  }
+
+  void UpdateBitrateWithoutFeedback() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    uint32_t bitrate_bps = 0;
+    for (const auto& it : attachments_)
+      bitrate_bps += it.second.bitrate_without_feedback_bps;
+    controller_->SetAllocatedBitrateWithoutFeedback(bitrate_bps);
+  }
+
+  void PostDistribution() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    if (!last_target_rate_)
+      return;
+    // The task queue belongs to |controller_|, which is destroyed first, so
+    // the task can not outlive this object.
+    controller_->GetWorkerQueue()->PostTask([this] {
+      rtc::CritScope cs(&crit_);
+      DistributeTargetRate();
+    });
+  }
+
+  void DistributeTargetRate() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    if (!last_target_rate_)
+      return;
+    std::vector<const AttachmentState*> receivers;
+    for (const auto& it : attachments_) {
+      if (it.second.observer)
+        receivers.push_back(&it.second);
+    }
+    if (receivers.empty())
+      return;
+
+    const int64_t target_bps = last_target_rate_->target_rate.bps();
+    std::vector<int64_t> shares_bps(receivers.size(), 0);
+    int64_t min_sum_bps = 0;
+    int64_t demand_sum_bps = 0;
+    for (const AttachmentState* state : receivers) {
+      min_sum_bps += state->min_send_bitrate_bps;
+      demand_sum_bps += std::max(
+          0, state->total_bitrate_bps - state->min_send_bitrate_bps);
+    }
+    if (target_bps < min_sum_bps) {
+      // Not even the minimums fit, scale them all down alike.
+      for (size_t i = 0; i < receivers.size(); ++i) {
+        shares_bps[i] =
+            target_bps * receivers[i]->min_send_bitrate_bps / min_sum_bps;
+      }
+    } else {
+      int64_t remaining_bps = target_bps - min_sum_bps;
+      const int64_t demand_bps = std::min(remaining_bps, demand_sum_bps);
+      for (size_t i = 0; i < receivers.size(); ++i) {
+        const AttachmentState& state = *receivers[i];
+        shares_bps[i] = state.min_send_bitrate_bps;
+        if (demand_sum_bps > 0) {
+          const int64_t demand_of_call_bps = std::max(
+              0, state.total_bitrate_bps - state.min_send_bitrate_bps);
+          const int64_t extra_bps =
+              demand_bps * demand_of_call_bps / demand_sum_bps;
+          shares_bps[i] += extra_bps;
+          remaining_bps -= extra_bps;
+        }
+      }
+      // Whatever no Call asked for is split evenly, so that each of them can
+      // still see that there is headroom.
+      for (size_t i = 0; i < receivers.size(); ++i)
+        shares_bps[i] += remaining_bps / receivers.size();
+    }
+
+    for (size_t i = 0; i < receivers.size(); ++i) {
+      TargetTransferRate share = *last_target_rate_;
+      share.target_rate = DataRate::bps(shares_bps[i]);
+      receivers[i]->observer->OnTargetTransferRate(share);
+    }
+  }
+
+  rtc::CriticalSection crit_;
+  std::map<Attachment*, AttachmentState> attachments_ RTC_GUARDED_BY(crit_);
+  absl::optional<TargetTransferRate> last_target_rate_ RTC_GUARDED_BY(crit_);
+  bool network_available_ RTC_GUARDED_BY(crit_) = false;
+  bool per_packet_feedback_available_ RTC_GUARDED_BY(crit_) = false;
+  // Declared last, so that its threads are stopped before anything they may
+  // call into is destroyed.
+  const std::unique_ptr<RtpTransportControllerSendInterface> controller_;
+};
+
+// The transport controller of one attached Call. Everything that is state of
+// the network path goes straight to the shared controller, while the Call's
+// bitrate limits and network state are combined with those of the other Calls
+// first.
+class SharedRtpTransportControllerSendPool::Attachment
+    : public RtpTransportControllerSendInterface {
+ public:
+  Attachment(SharedRtpTransportControllerSendPool* pool,
+             const std::string& path_key,
+             SharedController* shared)
+      : pool_(pool),
+        path_key_(path_key),
+        shared_(shared),
+        controller_(shared->controller()) {}
+  ~Attachment() override { pool_->Detach(path_key_, this); }
+
+  rtc::TaskQueue* GetWorkerQueue() override {
+    return controller_->GetWorkerQueue();
+  }
+  PacketRouter* packet_router() override {
+    return controller_->packet_router();
+  }
+  RtpVideoSenderInterface* CreateRtpVideoSender(
+      const std::vector<uint32_t>& ssrcs,
+      std::map<uint32_t, RtpState> suspended_ssrcs,
+      const std::map<uint32_t, RtpPayloadState>& states,
+      const RtpConfig& rtp_config,
+      const RtcpConfig& rtcp_config,
+      Transport* send_transport,
+      const RtpSenderObservers& observers,
+      RtcEventLog* event_log) override {
+    return controller_->CreateRtpVideoSender(
+        ssrcs, std::move(suspended_ssrcs), states, rtp_config, rtcp_config,
+        send_transport, observers, event_log);
+  }
+  void DestroyRtpVideoSender(
+      RtpVideoSenderInterface* rtp_video_sender) override {
+    controller_->DestroyRtpVideoSender(rtp_video_sender);
+  }
+  TransportFeedbackObserver* transport_feedback_observer() override {
+    return controller_->transport_feedback_observer();
+  }
+  RtpPacketSender* packet_sender() override {
+    return controller_->packet_sender();
+  }
+  const RtpKeepAliveConfig& keepalive_config() const override {
+    return controller_->keepalive_config();
+  }
+  void SetAllocatedSendBitrateLimits(int min_send_bitrate_bps,
+                                     int max_padding_bitrate_bps,
+                                     int total_bitrate_bps) override {
+    shared_->SetAllocatedSendBitrateLimits(this, min_send_bitrate_bps,
+                                           max_padding_bitrate_bps,
+                                           total_bitrate_bps);
+  }
+  void SetPacingFactor(float pacing_factor) override {
+    controller_->SetPacingFactor(pacing_factor);
+  }
+  void SetQueueTimeLimit(int limit_ms) override {
+    controller_->SetQueueTimeLimit(limit_ms);
+  }
+  void SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) override {
+    controller_->SetStreamAllocation(ssrc, bitrate_bps);
+  }
+  CallStatsObserver* GetCallStatsObserver() override {
+    return controller_->GetCallStatsObserver();
+  }
+  void RegisterPacketFeedbackObserver(
+      PacketFeedbackObserver* observer) override {
+    controller_->RegisterPacketFeedbackObserver(observer);
+  }
+  void DeRegisterPacketFeedbackObserver(
+      PacketFeedbackObserver* observer) override {
+    controller_->DeRegisterPacketFeedbackObserver(observer);
+  }
+  void RegisterTargetTransferRateObserver(
+      TargetTransferRateObserver* observer) override {
+    shared_->SetTargetTransferRateObserver(this, observer);
+  }
+  void OnNetworkRouteChanged(const std::string& transport_name,
+                             const rtc::NetworkRoute& network_route) override {
+    controller_->OnNetworkRouteChanged(transport_name, network_route);
+  }
+  void OnNetworkAvailability(bool network_available) override {
+    shared_->SetNetworkAvailability(this, network_available);
+  }
+  RtcpBandwidthObserver* GetBandwidthObserver() override {
+    return controller_->GetBandwidthObserver();
+  }
+  int64_t GetPacerQueuingDelayMs() const override {
+    return controller_->GetPacerQueuingDelayMs();
+  }
+  int64_t GetFirstPacketTimeMs() const override {
+    return controller_->GetFirstPacketTimeMs();
+  }
+  void EnablePeriodicAlrProbing(bool enable) override {
+    controller_->EnablePeriodicAlrProbing(enable);
+  }
+  void OnSentPacket(const rtc::SentPacket& sent_packet) override {
+    controller_->OnSentPacket(sent_packet);
+  }
+  void SetPerPacketFeedbackAvailable(bool available) override {
+    shared_->SetPerPacketFeedbackAvailable(this, available);
+  }
+  void SetSdpBitrateParameters(const BitrateConstraints& constraints) override {
+    controller_->SetSdpBitrateParameters(constraints);
+  }
+  void SetClientBitratePreferences(
+      const BitrateSettings& preferences) override {
+    controller_->SetClientBitratePreferences(preferences);
+  }
+  void SetAllocatedBitrateWithoutFeedback(uint32_t bitrate_bps) override {
+    shared_->SetAllocatedBitrateWithoutFeedback(this, bitrate_bps);
+  }
+
+ private:
+  SharedRtpTransportControllerSendPool* const pool_;
+  const std::string path_key_;
+  SharedController* const shared_;
+  RtpTransportControllerSendInterface* const controller_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(Attachment);
+};
+
+SharedRtpTransportControllerSendPool::SharedRtpTransportControllerSendPool(
+    ControllerFactory controller_factory)
+    : controller_factory_(std::move(controller_factory)) {}
+
+SharedRtpTransportControllerSendPool::SharedRtpTransportControllerSendPool(
+    Clock* clock,
+    RtcEventLog* event_log,
+    NetworkControllerFactoryInterface* network_controller_factory,
+    const BitrateConstraints& bitrate_config)
+    : SharedRtpTransportControllerSendPool(
+          [clock, event_log, network_controller_factory, bitrate_config]()
+              -> std::unique_ptr<RtpTransportControllerSendInterface> {
+            return absl::make_unique<RtpTransportControllerSend>(
+                clock, event_log, network_controller_factory, bitrate_config);
+          }) {}
+
+SharedRtpTransportControllerSendPool::~SharedRtpTransportControllerSendPool() {
+  RTC_DCHECK(controllers_.empty());
+}
+
+std::unique_ptr<RtpTransportControllerSendInterface>
+SharedRtpTransportControllerSendPool::Attach(const std::string& path_key) {
+  rtc::CritScope cs(&crit_);
+  std::unique_ptr<SharedController>& shared = controllers_[path_key];
+  if (!shared)
+    shared = absl::make_unique<SharedController>(controller_factory_());
+  auto attachment = absl::make_unique<Attachment>(this, path_key, shared.get());
+  shared->AddAttachment(attachment.get());
+  return std::move(attachment);
+}
+
+size_t SharedRtpTransportControllerSendPool::NumSharedControllers() const {
+  rtc::CritScope cs(&crit_);
+  return controllers_.size();
+}
+
+void SharedRtpTransportControllerSendPool::Detach(const std::string& path_key,
+                                                  Attachment* attachment) {
+  std::unique_ptr<SharedController> last;
+  {
+    rtc::CritScope cs(&crit_);
+    auto it = controllers_.find(path_key);
+    RTC_DCHECK(it != controllers_.end());
+    if (it->second->RemoveAttachment(attachment)) {
+      last = std::move(it->second);
+      controllers_.erase(it);
+    }
+  }
+  // Destroyed without holding |crit_|, since stopping the controller waits for
+  // its threads, which may be calling into the pool's Calls.
+}
+
+}  // namespace webrtc
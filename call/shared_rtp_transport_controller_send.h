@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_SHARED_RTP_TRANSPORT_CONTROLLER_SEND_H_
+#define CALL_SHARED_RTP_TRANSPORT_CONTROLLER_SEND_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "api/bitrate_constraints.h"
+#include "call/rtp_transport_controller_send_interface.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+
+namespace webrtc {
+class Clock;
+class NetworkControllerFactoryInterface;
+class RtcEventLog;
+
+// Lets Calls that send to the same remote endpoint share one congestion
+// controller and pacer, instead of each probing and estimating the same
+// bottleneck on its own. Every Call gets a transport controller of its own
+// from Attach(), which it is created with through Call::Create(). Calls
+// attached with the same path key share the underlying
+// RtpTransportControllerSend, which lives as long as any of them is attached.
+//
+// The shared target rate is split between the Calls according to the bitrate
+// limits their BitrateAllocators report: every Call first gets its minimum
+// send bitrate, the rest is split in proportion to how much more each Call
+// could use, and what is left after that is split evenly. Each Call's
+// BitrateAllocator then divides its share among its own streams as usual.
+//
+// The pool must outlive all transport controllers it has handed out.
+class SharedRtpTransportControllerSendPool {
+ public:
+  using ControllerFactory =
+      std::function<std::unique_ptr<RtpTransportControllerSendInterface>()>;
+
+  // Creates the shared controllers with |controller_factory|, for tests.
+  explicit SharedRtpTransportControllerSendPool(
+      ControllerFactory controller_factory);
+  SharedRtpTransportControllerSendPool(
+      Clock* clock,
+      RtcEventLog* event_log,
+      NetworkControllerFactoryInterface* network_controller_factory,
+      const BitrateConstraints& bitrate_config);
+  ~SharedRtpTransportControllerSendPool();
+
+  // Returns a transport controller for one Call that sends over the network
+  // path identified by |path_key|, e.g. the remote address of the selected
+  // candidate pair.
+  std::unique_ptr<RtpTransportControllerSendInterface> Attach(
+      const std::string& path_key);
+
+  size_t NumSharedControllers() const;
+
+ private:
+  class SharedController;
+  class Attachment;
+
+  void Detach(const std::string& path_key, Attachment* attachment);
+
+  const ControllerFactory controller_factory_;
+  rtc::CriticalSection crit_;
+  std::map<std::string, std::unique_ptr<SharedController>> controllers_
+      RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedRtpTransportControllerSendPool);
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_SHARED_RTP_TRANSPORT_CONTROLLER_SEND_H_
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/shared_rtp_transport_controller_send.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "api/transport/network_control.h"
+#include "call/test/mock_rtp_transport_controller_send.h"
+#include "rtc_base/task_queue_for_test.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SaveArg;
+
+class FakeTargetTransferRateObserver : public TargetTransferRateObserver {
+ public:
+  void OnTargetTransferRate(TargetTransferRate msg) override {
+    target_bps = msg.target_rate.bps();
+  }
+
+  int64_t target_bps = -1;
+};
+
+class SharedRtpTransportControllerSendPoolTest : public ::testing::Test {
+ protected:
+  SharedRtpTransportControllerSendPoolTest()
+      : queue_("SharedTransportTest"),
+        pool_([this]() -> std::unique_ptr<RtpTransportControllerSendInterface> {
+          auto controller =
+              absl::make_unique<NiceMock<MockRtpTransportControllerSend>>();
+          ON_CALL(*controller, GetWorkerQueue()).WillByDefault(Return(&queue_));
+          EXPECT_CALL(*controller, RegisterTargetTransferRateObserver(_))
+              .WillOnce(SaveArg<0>(&shared_observer_));
+          controllers_.push_back(controller.get());
+          return std::move(controller);
+        }) {}
+
+  void SetTargetRate(int64_t bps) {
+    TargetTransferRate msg;
+    msg.target_rate = DataRate::bps(bps);
+    shared_observer_->OnTargetTransferRate(msg);
+  }
+
+  // Runs the distribution tasks posted so far.
+  void Flush() {
+    queue_.SendTask([] {});
+  }
+
+  rtc::test::TaskQueueForTest queue_;
+  std::vector<NiceMock<MockRtpTransportControllerSend>*> controllers_;
+  TargetTransferRateObserver* shared_observer_ = nullptr;
+  SharedRtpTransportControllerSendPool pool_;
+};
+
+}  // namespace
+
+TEST_F(SharedRtpTransportControllerSendPoolTest, SharesControllerPerPathKey) {
+  auto first = pool_.Attach("remote-a");
+  auto second = pool_.Attach("remote-a");
+  auto other = pool_.Attach("remote-b");
+  EXPECT_EQ(2u, controllers_.size());
+  EXPECT_EQ(2u, pool_.NumSharedControllers());
+
+  first.reset();
+  EXPECT_EQ(2u, pool_.NumSharedControllers());
+  second.reset();
+  EXPECT_EQ(1u, pool_.NumSharedControllers());
+  other.reset();
+  EXPECT_EQ(0u, pool_.NumSharedControllers());
+}
+
+TEST_F(SharedRtpTransportControllerSendPoolTest, SumsAllocationLimits) {
+  auto first = pool_.Attach("remote");
+  auto second = pool_.Attach("remote");
+  ASSERT_EQ(1u, controllers_.size());
+  EXPECT_CALL(*controllers_[0], SetAllocatedSendBitrateLimits(100, 10, 500));
+  first->SetAllocatedSendBitrateLimits(100, 10, 500);
+  EXPECT_CALL(*controllers_[0], SetAllocatedSendBitrateLimits(300, 30, 1500));
+  second->SetAllocatedSendBitrateLimits(200, 20, 1000);
+  // The limits of a detached Call no longer count.
+  EXPECT_CALL(*controllers_[0], SetAllocatedSendBitrateLimits(200, 20, 1000));
+  first.reset();
+}
+
+TEST_F(SharedRtpTransportControllerSendPoolTest,
+       NetworkIsAvailableIfAvailableForAnyCall) {
+  auto first = pool_.Attach("remote");
+  auto second = pool_.Attach("remote");
+  ASSERT_EQ(1u, controllers_.size());
+  EXPECT_CALL(*controllers_[0], OnNetworkAvailability(true)).Times(1);
+  first->OnNetworkAvailability(true);
+  second->OnNetworkAvailability(true);
+  first->OnNetworkAvailability(false);
+  EXPECT_CALL(*controllers_[0], OnNetworkAvailability(false)).Times(1);
+  second->OnNetworkAvailability(false);
+}
+
+TEST_F(SharedRtpTransportControllerSendPoolTest, SplitsTargetRateByDemand) {
+  FakeTargetTransferRateObserver first_observer;
+  FakeTargetTransferRateObserver second_observer;
+  auto first = pool_.Attach("remote");
+  auto second = pool_.Attach("remote");
+  first->RegisterTargetTransferRateObserver(&first_observer);
+  second->RegisterTargetTransferRateObserver(&second_observer);
+  first->SetAllocatedSendBitrateLimits(100000, 0, 300000);
+  second->SetAllocatedSendBitrateLimits(100000, 0, 700000);
+
+  // Minimums first, then the rest in proportion to what is asked for on top.
+  SetTargetRate(600000);
+  EXPECT_EQ(100000 + 100000, first_observer.target_bps);
+  EXPECT_EQ(100000 + 300000, second_observer.target_bps);
+
+  // Below the sum of the minimums, they are scaled down.
+  SetTargetRate(100000);
+  EXPECT_EQ(50000, first_observer.target_bps);
+  EXPECT_EQ(50000, second_observer.target_bps);
+
+  // More than asked for is shared evenly.
+  SetTargetRate(1200000);
+  EXPECT_EQ(300000 + 100000, first_observer.target_bps);
+  EXPECT_EQ(700000 + 100000, second_observer.target_bps);
+
+  first.reset();
+  second.reset();
+}
+
+TEST_F(SharedRtpTransportControllerSendPoolTest,
+       RedistributesWhenCallsComeAndGo) {
+  FakeTargetTransferRateObserver first_observer;
+  FakeTargetTransferRateObserver second_observer;
+  auto first = pool_.Attach("remote");
+  first->RegisterTargetTransferRateObserver(&first_observer);
+  SetTargetRate(500000);
+  EXPECT_EQ(500000, first_observer.target_bps);
+
+  // A new Call gets its share without waiting for the estimate to change.
+  auto second = pool_.Attach("remote");
+  second->RegisterTargetTransferRateObserver(&second_observer);
+  Flush();
+  EXPECT_EQ(250000, first_observer.target_bps);
+  EXPECT_EQ(250000, second_observer.target_bps);
+
+  second.reset();
+  Flush();
+  EXPECT_EQ(500000, first_observer.target_bps);
+  first.reset();
+}
+
+}  // namespace webrtc
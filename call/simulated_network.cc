@@ -100,9 +100,18 @@ bool SimulatedNetwork::EnqueuePacket(PacketInFlightInfo packet) {
 }
 
 absl::optional<int64_t> SimulatedNetwork::NextDeliveryTimeUs() const {
+  rtc::CritScope crit(&process_lock_);
+  absl::optional<int64_t> next_time_us;
   if (!delay_link_.empty())
-    return delay_link_.begin()->arrival_time_us;
-  return absl::nullopt;
+    next_time_us = delay_link_.front().arrival_time_us;
+  // A packet leaving the capacity link is delivered at the earliest when it
+  // leaves, so the next call to DequeueDeliverablePackets() must not be later.
+  if (!capacity_link_.empty() &&
+      (!next_time_us ||
+       capacity_link_.front().arrival_time_us < *next_time_us)) {
+    next_time_us = capacity_link_.front().arrival_time_us;
+  }
+  return next_time_us;
 }
 std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
     int64_t receive_time_us) {
@@ -118,6 +127,7 @@ std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
   }
   {
     rtc::CritScope crit(&process_lock_);
+    std::vector<PacketDeliveryInfo> packets_to_deliver;
     // Check the capacity link first.
     if (!capacity_link_.empty()) {
       int64_t last_arrival_time_us =
@@ -134,6 +144,8 @@ std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
         if ((bursting_ && random_.Rand<double>() < prob_loss_bursting) ||
             (!bursting_ && random_.Rand<double>() < prob_start_bursting)) {
           bursting_ = true;
+          packets_to_deliver.emplace_back(PacketDeliveryInfo(
+              packet.packet, PacketDeliveryInfo::kNotReceived));
           continue;
         } else {
           bursting_ = false;
@@ -170,7 +182,6 @@ std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
       }
     }
 
-    std::vector<PacketDeliveryInfo> packets_to_deliver;
     // Check the extra delay queue.
     while (!delay_link_.empty() &&
            time_now_us >= delay_link_.front().arrival_time_us) {
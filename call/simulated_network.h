@@ -38,9 +38,12 @@ class SimulatedNetwork : public NetworkSimulationInterface {
 
   // NetworkSimulationInterface
   bool EnqueuePacket(PacketInFlightInfo packet) override;
+  // Lost packets are returned with a receive time of
+  // PacketDeliveryInfo::kNotReceived.
   std::vector<PacketDeliveryInfo> DequeueDeliverablePackets(
       int64_t receive_time_us) override;
 
+  // The next time DequeueDeliverablePackets() may return packets.
   absl::optional<int64_t> NextDeliveryTimeUs() const override;
 
  private:
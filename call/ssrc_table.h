@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_SSRC_TABLE_H_
+#define CALL_SSRC_TABLE_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/sleep.h"
+
+namespace webrtc {
+
+// Open addressing hash table keyed on SSRC, for the per-packet lookups on the
+// receive path. Entries live inline in one array, found by linear probing from
+// a Fibonacci hash of the SSRC, and erasing shifts the rest of the probe
+// sequence back instead of leaving tombstones. Pointers to values are
+// invalidated by any insertion or erasure.
+template <typename T>
+class SsrcTable {
+ public:
+  SsrcTable() = default;
+  SsrcTable(const SsrcTable&) = default;
+  SsrcTable(SsrcTable&&) = default;
+  SsrcTable& operator=(const SsrcTable&) = default;
+  SsrcTable& operator=(SsrcTable&&) = default;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Returns nullptr if |ssrc| is not in the table.
+  T* Find(uint32_t ssrc) {
+    return const_cast<T*>(static_cast<const SsrcTable*>(this)->Find(ssrc));
+  }
+  const T* Find(uint32_t ssrc) const {
+    if (size_ == 0)
+      return nullptr;
+    for (size_t i = Index(ssrc);; i = (i + 1) & Mask()) {
+      const Slot& slot = slots_[i];
+      if (!slot.value)
+        return nullptr;
+      if (slot.ssrc == ssrc)
+        return &*slot.value;
+    }
+  }
+
+  bool Contains(uint32_t ssrc) const { return Find(ssrc) != nullptr; }
+
+  // Constructs a value for |ssrc| from |args|, unless there already is one.
+  // Returns the value for |ssrc| and whether it was inserted, like
+  // std::map::emplace.
+  template <typename... Args>
+  std::pair<T*, bool> Emplace(uint32_t ssrc, Args&&... args) {
+    T* existing = Find(ssrc);
+    if (existing)
+      return std::make_pair(existing, false);
+    if ((size_ + 1) * 4 > slots_.size() * 3)
+      Rehash(std::max<size_t>(kMinCapacity, slots_.size() * 2));
+    size_t i = Index(ssrc);
+    while (slots_[i].value)
+      i = (i + 1) & Mask();
+    slots_[i].ssrc = ssrc;
+    slots_[i].value.emplace(std::forward<Args>(args)...);
+    ++size_;
+    return std::make_pair(&*slots_[i].value, true);
+  }
+
+  // Sets the value for |ssrc|, replacing any previous one.
+  void InsertOrAssign(uint32_t ssrc, T value) {
+    T* existing = Find(ssrc);
+    if (existing) {
+      *existing = std::move(value);
+    } else {
+      Emplace(ssrc, std::move(value));
+    }
+  }
+
+  // Returns true if |ssrc| was in the table.
+  bool Erase(uint32_t ssrc) {
+    if (size_ == 0)
+      return false;
+    size_t hole = Index(ssrc);
+    while (true) {
+      if (!slots_[hole].value)
+        return false;
+      if (slots_[hole].ssrc == ssrc)
+        break;
+      hole = (hole + 1) & Mask();
+    }
+    slots_[hole].value.reset();
+    --size_;
+    // Move later entries of the probe sequence into the hole, unless their
+    // home slot is after the hole, so that Find() never stops early.
+    for (size_t i = (hole + 1) & Mask(); slots_[i].value;
+         i = (i + 1) & Mask()) {
+      size_t home = Index(slots_[i].ssrc);
+      if (((i - home) & Mask()) < ((i - hole) & Mask()))
+        continue;
+      slots_[hole].ssrc = slots_[i].ssrc;
+      slots_[hole].value.emplace(std::move(*slots_[i].value));
+      slots_[i].value.reset();
+      hole = i;
+    }
+    return true;
+  }
+
+  // Erases all entries for which |predicate(ssrc, value)| returns true, and
+  // returns how many there were.
+  template <typename Predicate>
+  size_t EraseIf(Predicate predicate) {
+    std::vector<uint32_t> matches;
+    for (const Slot& slot : slots_) {
+      if (slot.value && predicate(slot.ssrc, *slot.value))
+        matches.push_back(slot.ssrc);
+    }
+    for (uint32_t ssrc : matches)
+      Erase(ssrc);
+    return matches.size();
+  }
+
+  void Clear() {
+    slots_.clear();
+    size_ = 0;
+  }
+
+ private:
+  static constexpr size_t kMinCapacity = 8;
+
+  struct Slot {
+    uint32_t ssrc = 0;
+    absl::optional<T> value;
+  };
+
+  size_t Mask() const { return slots_.size() - 1; }
+
+  size_t Index(uint32_t ssrc) const {
+    // Fibonacci hashing, so that SSRCs of one endpoint, which are often close
+    // to each other, still spread over the table.
+    return static_cast<size_t>((ssrc * 2654435769u) >> (32 - capacity_log2_));
+  }
+
+  void Rehash(size_t capacity) {
+    RTC_DCHECK_EQ(capacity & (capacity - 1), 0u);
+    std::vector<Slot> old_slots(capacity);
+    old_slots.swap(slots_);
+    capacity_log2_ = 0;
+    while ((size_t{1} << capacity_log2_) < capacity)
+      ++capacity_log2_;
+    for (Slot& slot : old_slots) {
+      if (!slot.value)
+        continue;
+      size_t i = Index(slot.ssrc);
+      while (slots_[i].value)
+        i = (i + 1) & Mask();
+      slots_[i].ssrc = slot.ssrc;
+      slots_[i].value.emplace(std::move(*slot.value));
+    }
+  }
+
+  std::vector<Slot> slots_;
+  int capacity_log2_ = 0;
+  size_t size_ = 0;
+};
+
+// SsrcTable for a few writers and many readers, where readers never block.
+// It keeps two copies of the table. Readers pin the current copy with a
+// counter, writers modify the other copy, publish it and wait for readers of
+// the previous copy to leave before bringing that one up to date too.
+//
+// Writers must be serialized by the caller. A write returns only once no
+// reader can observe the previous contents, so erasing an SSRC and then
+// destroying what its value referred to is safe. Consequently, a write must
+// not be made from a thread that holds a ReadScope on the same table.
+template <typename T>
+class ConcurrentSsrcTable {
+ private:
+  struct Instance {
+    mutable std::atomic<int> readers{0};
+    SsrcTable<T> table;
+  };
+
+ public:
+  class ReadScope {
+   public:
+    explicit ReadScope(const ConcurrentSsrcTable* table)
+        : instance_(table->Acquire()) {}
+    ReadScope(const ReadScope&) = delete;
+    ReadScope& operator=(const ReadScope&) = delete;
+    ~ReadScope() {
+      instance_->readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    // The returned value stays valid for the lifetime of this scope.
+    const T* Find(uint32_t ssrc) const { return instance_->table.Find(ssrc); }
+
+   private:
+    const Instance* const instance_;
+  };
+
+  ConcurrentSsrcTable() : current_(&instances_[0]) {}
+  ConcurrentSsrcTable(const ConcurrentSsrcTable&) = delete;
+  ConcurrentSsrcTable& operator=(const ConcurrentSsrcTable&) = delete;
+
+  // Inserts a copy of |value| for |ssrc|, unless there already is a value.
+  // Returns true if inserted.
+  bool Emplace(uint32_t ssrc, const T& value) {
+    return Modify([ssrc, &value](SsrcTable<T>* table) {
+      return table->Emplace(ssrc, value).second;
+    });
+  }
+
+  // Returns true if |ssrc| was in the table.
+  bool Erase(uint32_t ssrc) {
+    return Modify(
+        [ssrc](SsrcTable<T>* table) { return table->Erase(ssrc); });
+  }
+
+ private:
+  const Instance* Acquire() const {
+    while (true) {
+      const Instance* instance = current_.load(std::memory_order_seq_cst);
+      instance->readers.fetch_add(1, std::memory_order_seq_cst);
+      // The writer may have switched copies in between, and must then not
+      // wait for this reader.
+      if (current_.load(std::memory_order_seq_cst) == instance)
+        return instance;
+      instance->readers.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  template <typename Modification>
+  bool Modify(Modification modification) {
+    Instance* active = current_.load(std::memory_order_relaxed);
+    Instance* standby =
+        active == &instances_[0] ? &instances_[1] : &instances_[0];
+    WaitForReaders(standby);
+    bool result = modification(&standby->table);
+    current_.store(standby, std::memory_order_seq_cst);
+    WaitForReaders(active);
+    modification(&active->table);
+    return result;
+  }
+
+  static void WaitForReaders(const Instance* instance) {
+    while (instance->readers.load(std::memory_order_seq_cst) != 0)
+      SleepMs(0);
+  }
+
+  Instance instances_[2];
+  std::atomic<Instance*> current_;
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_SSRC_TABLE_H_
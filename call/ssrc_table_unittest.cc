@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/ssrc_table.h"
+
+#include <atomic>
+#include <map>
+#include <string>
+
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+TEST(SsrcTableTest, StartsEmpty) {
+  SsrcTable<int> table;
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(nullptr, table.Find(1));
+  EXPECT_FALSE(table.Erase(1));
+}
+
+TEST(SsrcTableTest, EmplaceDoesNotOverwrite) {
+  SsrcTable<std::string> table;
+  auto result = table.Emplace(1234, "first");
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ("first", *result.first);
+
+  result = table.Emplace(1234, "second");
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("first", *result.first);
+
+  table.InsertOrAssign(1234, "third");
+  EXPECT_EQ(1u, table.size());
+  ASSERT_TRUE(table.Find(1234));
+  EXPECT_EQ("third", *table.Find(1234));
+}
+
+TEST(SsrcTableTest, MatchesMapUnderRandomOperations) {
+  // Small key range, so that probe sequences collide and erasure has to move
+  // entries around.
+  Random random(1234);
+  SsrcTable<uint32_t> table;
+  std::map<uint32_t, uint32_t> reference;
+  for (int i = 0; i < 10000; ++i) {
+    uint32_t ssrc = random.Rand(0u, 200u) * 0x10000u;
+    if (random.Rand(0, 2) == 0) {
+      EXPECT_EQ(reference.erase(ssrc) == 1, table.Erase(ssrc));
+    } else {
+      EXPECT_EQ(reference.emplace(ssrc, i).second,
+                table.Emplace(ssrc, i).second);
+    }
+    ASSERT_EQ(reference.size(), table.size());
+  }
+  for (uint32_t ssrc = 0; ssrc <= 200; ++ssrc) {
+    auto it = reference.find(ssrc * 0x10000u);
+    const uint32_t* value = table.Find(ssrc * 0x10000u);
+    if (it == reference.end()) {
+      EXPECT_EQ(nullptr, value);
+    } else {
+      ASSERT_TRUE(value);
+      EXPECT_EQ(it->second, *value);
+    }
+  }
+}
+
+TEST(SsrcTableTest, EraseIf) {
+  SsrcTable<int> table;
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc)
+    table.Emplace(ssrc, ssrc % 3);
+  EXPECT_EQ(34u, table.EraseIf([](uint32_t, int value) { return value == 0; }));
+  EXPECT_EQ(66u, table.size());
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc)
+    EXPECT_EQ(ssrc % 3 != 0, table.Contains(ssrc));
+}
+
+TEST(ConcurrentSsrcTableTest, ReadsSeeCompletedWrites) {
+  ConcurrentSsrcTable<std::string> table;
+  EXPECT_TRUE(table.Emplace(1, "one"));
+  EXPECT_FALSE(table.Emplace(1, "uno"));
+  {
+    ConcurrentSsrcTable<std::string>::ReadScope scope(&table);
+    ASSERT_TRUE(scope.Find(1));
+    EXPECT_EQ("one", *scope.Find(1));
+    EXPECT_EQ(nullptr, scope.Find(2));
+  }
+  EXPECT_TRUE(table.Erase(1));
+  EXPECT_FALSE(table.Erase(1));
+  ConcurrentSsrcTable<std::string>::ReadScope scope(&table);
+  EXPECT_EQ(nullptr, scope.Find(1));
+}
+
+struct ReaderContext {
+  ConcurrentSsrcTable<uint32_t>* table;
+  std::atomic<bool> stop{false};
+  std::atomic<int> errors{0};
+};
+
+void ReadUntilStopped(void* context) {
+  ReaderContext* ctx = static_cast<ReaderContext*>(context);
+  while (!ctx->stop.load()) {
+    ConcurrentSsrcTable<uint32_t>::ReadScope scope(ctx->table);
+    for (uint32_t ssrc = 0; ssrc < 64; ++ssrc) {
+      const uint32_t* value = scope.Find(ssrc);
+      if (value && *value != ssrc * 2)
+        ++ctx->errors;
+    }
+  }
+}
+
+TEST(ConcurrentSsrcTableTest, ConcurrentReadersSeeConsistentValues) {
+  ConcurrentSsrcTable<uint32_t> table;
+  ReaderContext context;
+  context.table = &table;
+  rtc::PlatformThread reader(&ReadUntilStopped, &context, "Reader");
+  reader.Start();
+  for (int round = 0; round < 20; ++round) {
+    for (uint32_t ssrc = 0; ssrc < 64; ++ssrc)
+      table.Emplace(ssrc, ssrc * 2);
+    for (uint32_t ssrc = 0; ssrc < 64; ++ssrc)
+      table.Erase(ssrc);
+  }
+  context.stop.store(true);
+  reader.Stop();
+  EXPECT_EQ(0, context.errors.load());
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -86,9 +86,19 @@ std::string VideoReceiveStream::Config::ToString() const {
   ss << ", rtp: " << rtp.ToString();
   ss << ", renderer: " << (renderer ? "(renderer)" : "nullptr");
   ss << ", render_delay_ms: " << render_delay_ms;
+  if (decode_immediately)
+    ss << ", decode_immediately: on";
+  if (encoded_frame_sink)
+    ss << ", encoded_frame_sink: (sink)";
+  if (max_spatial_layer)
+    ss << ", max_spatial_layer: " << *max_spatial_layer;
+  if (max_temporal_layer)
+    ss << ", max_temporal_layer: " << *max_temporal_layer;
   if (!sync_group.empty())
     ss << ", sync_group: " << sync_group;
   ss << ", target_delay_ms: " << target_delay_ms;
+  if (!jitter_estimator_state.empty())
+    ss << ", jitter_estimator_state: " << jitter_estimator_state;
   ss << '}';
 
   return ss.str();
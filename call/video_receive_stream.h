@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "api/call/transport.h"
 #include "api/rtp_headers.h"
 #include "api/rtpparameters.h"
@@ -33,6 +34,10 @@ namespace webrtc {
 class RtpPacketSinkInterface;
 class VideoDecoder;
 
+namespace video_coding {
+class EncodedFrame;
+}  // namespace video_coding
+
 class VideoReceiveStream {
  public:
   // TODO(mflodman) Move all these settings to VideoDecoder and move the
@@ -43,7 +48,9 @@ class VideoReceiveStream {
     ~Decoder();
     std::string ToString() const;
 
-    // The actual decoder instance.
+    // The actual decoder instance. May only be null, for all decoders, if
+    // |encoded_frame_sink| is set, in which case received frames are not
+    // decoded at all.
     VideoDecoder* decoder = nullptr;
 
     // Received RTP packets with this payload type will be sent to this decoder
@@ -105,6 +112,9 @@ class VideoReceiveStream {
     // Timing frame info: all important timestamps for a full lifetime of a
     // single 'timing frame'.
     absl::optional<webrtc::TimingFrameInfo> timing_frame_info;
+    // Percentiles of the time spent per pipeline stage by the timing frames
+    // received so far.
+    std::vector<FrameLatencyStageStats> frame_latency_stages;
   };
 
   struct Config {
@@ -196,9 +206,17 @@ class VideoReceiveStream {
     // Transport for outgoing packets (RTCP).
     Transport* rtcp_send_transport = nullptr;
 
-    // Must not be 'nullptr' when the stream is started.
+    // Must not be 'nullptr' when the stream is started, unless frames aren't
+    // decoded.
     rtc::VideoSinkInterface<VideoFrame>* renderer = nullptr;
 
+    // If set, receives every complete frame whose references have been
+    // received, in decoding order, before it is decoded. For recording or
+    // forwarding the received stream. Called on the decoding thread, or on the
+    // network thread if the |decoders| have no decoder instances.
+    rtc::VideoSinkInterface<video_coding::EncodedFrame>* encoded_frame_sink =
+        nullptr;
+
     // Expected delay needed by the renderer, i.e. the frame will be delivered
     // this many milliseconds, if possible, earlier than the ideal render time.
     // Only valid if 'renderer' is set.
@@ -208,6 +226,23 @@ class VideoReceiveStream {
     // available.
     bool disable_prerenderer_smoothing = false;
 
+    // If set, frames are decoded as soon as they are decodable rather than
+    // when they are due for rendering, none are dropped for being late, and
+    // decoded frames are passed on to the renderer in decode order. For
+    // receivers that don't render, e.g. recording or transcoding. Implies
+    // |disable_prerenderer_smoothing| and ignores the playout delay and A/V
+    // sync.
+    bool decode_immediately = false;
+
+    // If set, the highest spatial layer of VP9 and temporal layer of VP8 and
+    // VP9 streams to receive, for receivers that show a lower resolution or
+    // frame rate than what is sent, e.g. the thumbnails of a gallery view.
+    // Packets of higher layers are dropped on arrival, before they are
+    // assembled into frames. They still count as received, so they are not
+    // NACKed.
+    absl::optional<int> max_spatial_layer;
+    absl::optional<int> max_temporal_layer;
+
     // Identifier for an A/V synchronization group. Empty string to disable.
     // TODO(pbos): Synchronize streams in a sync group, not just video streams
     // to one of the audio streams.
@@ -216,6 +251,13 @@ class VideoReceiveStream {
     // Target delay in milliseconds. A positive value indicates this stream is
     // used for streaming instead of a real-time call.
     int target_delay_ms = 0;
+
+    // If set, the jitter estimate starts from this state, as returned by
+    // GetJitterEstimatorState() of an earlier stream, instead of from the
+    // defaults. Applications can keep the last state per network type, e.g.
+    // per rtc::AdapterType, so that a new call on a cellular network doesn't
+    // start with the estimate of a wired one. Malformed states are ignored.
+    std::string jitter_estimator_state;
   };
 
   // Starts stream activity.
@@ -228,6 +270,10 @@ class VideoReceiveStream {
   // TODO(pbos): Add info on currently-received codec to Stats.
   virtual Stats GetStats() const = 0;
 
+  // Returns the current state of the jitter estimator, which can be passed in
+  // |Config::jitter_estimator_state| of a later stream on the same network.
+  virtual std::string GetJitterEstimatorState() const = 0;
+
   // Takes ownership of the file, is responsible for closing it later.
   // Calling this method will close and finalize any current log.
   // Giving rtc::kInvalidPlatformFileValue disables logging.
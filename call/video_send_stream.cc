@@ -73,7 +73,11 @@ std::string VideoSendStream::Config::ToString() const {
   char buf[2 * 1024];
   rtc::SimpleStringBuilder ss(buf);
   ss << "{encoder_settings: { experiment_cpu_load_estimator: "
-     << (encoder_settings.experiment_cpu_load_estimator ? "on" : "off") << "}}";
+     << (encoder_settings.experiment_cpu_load_estimator ? "on" : "off")
+     << ", encoder_speed_adaptation: "
+     << (encoder_settings.encoder_speed_adaptation ? "on" : "off")
+     << ", drop_frames_at_source: "
+     << (encoder_settings.drop_frames_at_source ? "on" : "off") << "}}";
   ss << ", rtp: " << rtp.ToString();
   ss << ", rtcp: " << rtcp.ToString();
   ss << ", pre_encode_callback: "
@@ -84,6 +88,8 @@ std::string VideoSendStream::Config::ToString() const {
   ss << ", target_delay_ms: " << target_delay_ms;
   ss << ", suspend_below_min_bitrate: "
      << (suspend_below_min_bitrate ? "on" : "off");
+  ss << ", shared_encoder: "
+     << (shared_encoder ? "(SharedVideoStreamEncoder)" : "nullptr");
   ss << '}';
   return ss.str();
 }
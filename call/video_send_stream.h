@@ -30,6 +30,8 @@
 
 namespace webrtc {
 
+class SharedVideoStreamEncoder;
+
 class VideoSendStream {
  public:
   struct StreamStats {
@@ -144,6 +146,12 @@ class VideoSendStream {
     // Track ID as specified during track creation.
     std::string track_id;
 
+    // If set, the stream sends the frames encoded by this encoder, which is
+    // shared with the other streams that have it set, instead of encoding its
+    // source itself. |encoder_settings| are only used by the first stream.
+    // Must outlive the stream.
+    SharedVideoStreamEncoder* shared_encoder = nullptr;
+
    private:
     // Access to the copy constructor is private to force use of the Copy()
     // method for those exceptional cases where we do use it.
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 
 #include "common_audio/third_party/fft4g/fft4g.h"
 #include "rtc_base/checks.h"
@@ -43,6 +44,10 @@ RealFourierOoura::RealFourierOoura(int fft_order)
       work_ip_(new size_t[ComputeWorkIpSize(length_)]()),
       work_w_(new float[complex_length_]()) {
   RTC_CHECK_GE(fft_order, 1);
+  // Transforms a silent frame, so that the work arrays are computed here
+  // rather than by the first transform on the audio processing thread.
+  std::unique_ptr<float[]> silence(new float[length_]());
+  WebRtc_rdft(length_, 1, silence.get(), work_ip_.get(), work_w_.get());
 }
 
 RealFourierOoura::~RealFourierOoura() = default;
@@ -91,8 +91,10 @@
 #include <string.h>
 
 #include <limits>
+#include <map>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/system/arch.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
@@ -116,25 +118,101 @@ double SincScaleFactor(double io_ratio) {
   return sinc_scale_factor;
 }
 
+// Aligned for the AVX2 Convolve(), which loads 8 floats at a time.
+constexpr size_t kKernelAlignment = 32;
+
+// Upper bound on the number of ratios for which the kernels are shared, so
+// that resamplers which keep changing their ratio do not grow the cache
+// without bound.
+constexpr size_t kMaxNumSharedKernels = 64;
+
+// Generates a set of windowed sinc() kernels for |io_ratio| into |kernel|.
+// We generate a range of sub-sample offsets from 0.0 to 1.0.
+void ComputeKernel(double io_ratio, float* kernel) {
+  // Blackman window parameters.
+  static const double kAlpha = 0.16;
+  static const double kA0 = 0.5 * (1.0 - kAlpha);
+  static const double kA1 = 0.5;
+  static const double kA2 = 0.5 * kAlpha;
+
+  const size_t kKernelSize = SincResampler::kKernelSize;
+  const size_t kKernelOffsetCount = SincResampler::kKernelOffsetCount;
+  const double sinc_scale_factor = SincScaleFactor(io_ratio);
+  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
+    const float subsample_offset =
+        static_cast<float>(offset_idx) / kKernelOffsetCount;
+
+    for (size_t i = 0; i < kKernelSize; ++i) {
+      const size_t idx = i + offset_idx * kKernelSize;
+      const float pre_sinc = static_cast<float>(
+          M_PI * (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
+                  subsample_offset));
+
+      // Compute Blackman window, matching the offset of the sinc().
+      const float x = (i - subsample_offset) / kKernelSize;
+      const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
+                                              kA2 * cos(4.0 * M_PI * x));
+
+      // Compute the sinc with offset, then window the sinc() function and store
+      // at the correct offset.
+      kernel[idx] = static_cast<float>(
+          window * ((pre_sinc == 0)
+                        ? sinc_scale_factor
+                        : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
+    }
+  }
+}
+
+// Kernels shared by all the resamplers in the process, keyed by ratio. Entries
+// are immutable once added and are never freed, so that the pointers handed
+// out remain valid without reference counting.
+rtc::GlobalLockPod g_shared_kernels_lock;
+std::map<double, const float*>* g_shared_kernels
+    RTC_GUARDED_BY(g_shared_kernels_lock) = nullptr;
+
+// Returns the shared kernels for |io_ratio|, or null if there are already too
+// many ratios in use.
+const float* GetSharedKernel(double io_ratio) {
+  rtc::GlobalLockScope lock(&g_shared_kernels_lock);
+  if (!g_shared_kernels) {
+    g_shared_kernels = new std::map<double, const float*>();
+  }
+  auto it = g_shared_kernels->find(io_ratio);
+  if (it != g_shared_kernels->end()) {
+    return it->second;
+  }
+  if (g_shared_kernels->size() >= kMaxNumSharedKernels) {
+    return nullptr;
+  }
+  float* kernel = static_cast<float*>(
+      AlignedMalloc(sizeof(float) * SincResampler::kKernelStorageSize,
+                    kKernelAlignment));
+  ComputeKernel(io_ratio, kernel);
+  g_shared_kernels->insert(std::make_pair(io_ratio, kernel));
+  return kernel;
+}
+
 }  // namespace
 
 const size_t SincResampler::kKernelSize;
 
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-#if defined(__SSE2__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
-// x86 CPU detection required.  Function will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// x86 CPU detection required for AVX2, and for SSE2 when it is not part of the
+// baseline.  Function will be set by InitializeCPUSpecificFeatures().
 #define CONVOLVE_FUNC convolve_proc_
 
 void SincResampler::InitializeCPUSpecificFeatures() {
+#if defined(__SSE2__)
+  convolve_proc_ = Convolve_SSE;
+#else
+  // TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
   convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
-}
 #endif
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    convolve_proc_ = Convolve_AVX2;
+  }
+}
 #elif defined(WEBRTC_HAS_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
@@ -151,21 +229,16 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
       read_cb_(read_cb),
       request_frames_(request_frames),
       input_buffer_size_(request_frames_ + kKernelSize),
+      kernel_(nullptr),
       // Create input buffers with a 16-byte alignment for SSE optimizations.
-      kernel_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
-      kernel_pre_sinc_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
-      kernel_window_storage_(static_cast<float*>(
-          AlignedMalloc(sizeof(float) * kKernelStorageSize, 16))),
       input_buffer_(static_cast<float*>(
           AlignedMalloc(sizeof(float) * input_buffer_size_, 16))),
-#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
       convolve_proc_(nullptr),
 #endif
       r1_(input_buffer_.get()),
       r2_(input_buffer_.get() + kKernelSize / 2) {
-#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__)
+#if defined(WEBRTC_ARCH_X86_FAMILY)
   InitializeCPUSpecificFeatures();
   RTC_DCHECK(convolve_proc_);
 #endif
@@ -173,14 +246,7 @@ SincResampler::SincResampler(double io_sample_rate_ratio,
   Flush();
   RTC_DCHECK_GT(block_size_, kKernelSize);
 
-  memset(kernel_storage_.get(), 0,
-         sizeof(*kernel_storage_.get()) * kKernelStorageSize);
-  memset(kernel_pre_sinc_storage_.get(), 0,
-         sizeof(*kernel_pre_sinc_storage_.get()) * kKernelStorageSize);
-  memset(kernel_window_storage_.get(), 0,
-         sizeof(*kernel_window_storage_.get()) * kKernelStorageSize);
-
-  InitializeKernel();
+  UpdateKernel();
 }
 
 SincResampler::~SincResampler() {}
@@ -201,41 +267,17 @@ void SincResampler::UpdateRegions(bool second_load) {
   RTC_DCHECK_LT(r2_, r3_);
 }
 
-void SincResampler::InitializeKernel() {
-  // Blackman window parameters.
-  static const double kAlpha = 0.16;
-  static const double kA0 = 0.5 * (1.0 - kAlpha);
-  static const double kA1 = 0.5;
-  static const double kA2 = 0.5 * kAlpha;
-
-  // Generates a set of windowed sinc() kernels.
-  // We generate a range of sub-sample offsets from 0.0 to 1.0.
-  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
-  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
-    const float subsample_offset =
-        static_cast<float>(offset_idx) / kKernelOffsetCount;
-
-    for (size_t i = 0; i < kKernelSize; ++i) {
-      const size_t idx = i + offset_idx * kKernelSize;
-      const float pre_sinc = static_cast<float>(
-          M_PI * (static_cast<int>(i) - static_cast<int>(kKernelSize / 2) -
-                  subsample_offset));
-      kernel_pre_sinc_storage_[idx] = pre_sinc;
-
-      // Compute Blackman window, matching the offset of the sinc().
-      const float x = (i - subsample_offset) / kKernelSize;
-      const float window = static_cast<float>(kA0 - kA1 * cos(2.0 * M_PI * x) +
-                                              kA2 * cos(4.0 * M_PI * x));
-      kernel_window_storage_[idx] = window;
-
-      // Compute the sinc with offset, then window the sinc() function and store
-      // at the correct offset.
-      kernel_storage_[idx] = static_cast<float>(
-          window * ((pre_sinc == 0)
-                        ? sinc_scale_factor
-                        : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
-    }
+void SincResampler::UpdateKernel() {
+  kernel_ = GetSharedKernel(io_sample_rate_ratio_);
+  if (kernel_) {
+    return;
+  }
+  if (!kernel_storage_) {
+    kernel_storage_.reset(static_cast<float*>(
+        AlignedMalloc(sizeof(float) * kKernelStorageSize, kKernelAlignment)));
   }
+  ComputeKernel(io_sample_rate_ratio_, kernel_storage_.get());
+  kernel_ = kernel_storage_.get();
 }
 
 void SincResampler::SetRatio(double io_sample_rate_ratio) {
@@ -245,22 +287,7 @@ void SincResampler::SetRatio(double io_sample_rate_ratio) {
   }
 
   io_sample_rate_ratio_ = io_sample_rate_ratio;
-
-  // Optimize reinitialization by reusing values which are independent of
-  // |sinc_scale_factor|.  Provides a 3x speedup.
-  const double sinc_scale_factor = SincScaleFactor(io_sample_rate_ratio_);
-  for (size_t offset_idx = 0; offset_idx <= kKernelOffsetCount; ++offset_idx) {
-    for (size_t i = 0; i < kKernelSize; ++i) {
-      const size_t idx = i + offset_idx * kKernelSize;
-      const float window = kernel_window_storage_[idx];
-      const float pre_sinc = kernel_pre_sinc_storage_[idx];
-
-      kernel_storage_[idx] = static_cast<float>(
-          window * ((pre_sinc == 0)
-                        ? sinc_scale_factor
-                        : (sin(sinc_scale_factor * pre_sinc) / pre_sinc)));
-    }
-  }
+  UpdateKernel();
 }
 
 void SincResampler::Resample(size_t frames, float* destination) {
@@ -275,7 +302,7 @@ void SincResampler::Resample(size_t frames, float* destination) {
   // Step (2) -- Resample!  const what we can outside of the loop for speed.  It
   // actually has an impact on ARM performance.  See inner loop comment below.
   const double current_io_ratio = io_sample_rate_ratio_;
-  const float* const kernel_ptr = kernel_storage_.get();
+  const float* const kernel_ptr = kernel_;
   while (remaining_frames) {
     // |i| may be negative if the last Resample() call ended on an iteration
     // that put |virtual_source_idx_| over the limit.
@@ -144,25 +144,57 @@ TEST(SincResamplerTest, Convolve) {
 
   // Use a kernel from SincResampler as input and kernel data, this has the
   // benefit of already being properly sized and aligned for Convolve_SSE().
-  double result = resampler.Convolve_C(
-      resampler.kernel_storage_.get(), resampler.kernel_storage_.get(),
-      resampler.kernel_storage_.get(), kKernelInterpolationFactor);
-  double result2 = resampler.CONVOLVE_FUNC(
-      resampler.kernel_storage_.get(), resampler.kernel_storage_.get(),
-      resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+  const float* const kernel = resampler.kernel_;
+  double result = resampler.Convolve_C(kernel, kernel, kernel,
+                                       kKernelInterpolationFactor);
+  double result2 = resampler.CONVOLVE_FUNC(kernel, kernel, kernel,
+                                           kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
 
   // Test Convolve() w/ unaligned input pointer.
-  result = resampler.Convolve_C(
-      resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
-      resampler.kernel_storage_.get(), kKernelInterpolationFactor);
-  result2 = resampler.CONVOLVE_FUNC(
-      resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
-      resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+  result = resampler.Convolve_C(kernel + 1, kernel, kernel,
+                                kKernelInterpolationFactor);
+  result2 = resampler.CONVOLVE_FUNC(kernel + 1, kernel, kernel,
+                                    kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    result = resampler.Convolve_C(kernel, kernel, kernel,
+                                  kKernelInterpolationFactor);
+    result2 = resampler.Convolve_AVX2(kernel, kernel, kernel,
+                                      kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon);
+
+    result = resampler.Convolve_C(kernel + 1, kernel, kernel,
+                                  kKernelInterpolationFactor);
+    result2 = resampler.Convolve_AVX2(kernel + 1, kernel, kernel,
+                                      kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon);
+  }
+#endif
 }
 #endif
 
+// Resamplers with the same ratio reuse the same kernels instead of computing
+// their own.
+TEST(SincResamplerTest, SharesKernelsBetweenResamplersWithTheSameRatio) {
+  MockSource mock_source;
+  SincResampler resampler1(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                           &mock_source);
+  SincResampler resampler2(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                           &mock_source);
+  EXPECT_EQ(resampler1.get_kernel_for_testing(),
+            resampler2.get_kernel_for_testing());
+
+  resampler2.SetRatio(M_PI);
+  EXPECT_NE(resampler1.get_kernel_for_testing(),
+            resampler2.get_kernel_for_testing());
+  resampler2.SetRatio(kSampleRateRatio);
+  EXPECT_EQ(resampler1.get_kernel_for_testing(),
+            resampler2.get_kernel_for_testing());
+}
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that RTC_DCHECKs are compiled out when benchmarking.
 // Original benchmarks were run with --convolve-iterations=50000000.
@@ -181,9 +213,8 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
   // Benchmark Convolve_C().
   int64_t start = rtc::TimeNanos();
   for (int i = 0; i < kConvolveIterations; ++i) {
-    resampler.Convolve_C(
-        resampler.kernel_storage_.get(), resampler.kernel_storage_.get(),
-        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    resampler.Convolve_C(resampler.kernel_, resampler.kernel_,
+                         resampler.kernel_, kKernelInterpolationFactor);
   }
   double total_time_c_us =
       (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
@@ -199,9 +230,8 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
   // Benchmark with unaligned input pointer.
   start = rtc::TimeNanos();
   for (int j = 0; j < kConvolveIterations; ++j) {
-    resampler.CONVOLVE_FUNC(
-        resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
-        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    resampler.CONVOLVE_FUNC(resampler.kernel_ + 1, resampler.kernel_,
+                            resampler.kernel_, kKernelInterpolationFactor);
   }
   double total_time_optimized_unaligned_us =
       (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
@@ -212,9 +242,8 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
   // Benchmark with aligned input pointer.
   start = rtc::TimeNanos();
   for (int j = 0; j < kConvolveIterations; ++j) {
-    resampler.CONVOLVE_FUNC(
-        resampler.kernel_storage_.get(), resampler.kernel_storage_.get(),
-        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    resampler.CONVOLVE_FUNC(resampler.kernel_, resampler.kernel_,
+                            resampler.kernel_, kKernelInterpolationFactor);
   }
   double total_time_optimized_aligned_us =
       (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
@@ -350,7 +379,7 @@ INSTANTIATE_TEST_CASE_P(
         std::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::make_tuple(48000, 44100, -15.01, -64.04),
         std::make_tuple(96000, 44100, -18.49, -25.51),
         std::make_tuple(192000, 44100, -20.50, -13.31),
@@ -11,9 +11,33 @@
 #include "common_audio/sparse_fir_filter.h"
 
 #include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+#define FILTER_FUNC Filter_SSE
+void SparseFIRFilter::InitializeCPUSpecificFeatures() {}
+#else
+// x86 CPU detection required. Function will be set by
+// InitializeCPUSpecificFeatures().
+#define FILTER_FUNC filter_proc_
+
+void SparseFIRFilter::InitializeCPUSpecificFeatures() {
+  filter_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Filter_SSE : Filter_C;
+}
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+#define FILTER_FUNC Filter_NEON
+void SparseFIRFilter::InitializeCPUSpecificFeatures() {}
+#else
+// Unknown architecture.
+#define FILTER_FUNC Filter_C
+void SparseFIRFilter::InitializeCPUSpecificFeatures() {}
+#endif
+
 SparseFIRFilter::SparseFIRFilter(const float* nonzero_coeffs,
                                  size_t num_nonzero_coeffs,
                                  size_t sparsity,
@@ -21,40 +45,49 @@ SparseFIRFilter::SparseFIRFilter(const float* nonzero_coeffs,
     : sparsity_(sparsity),
       offset_(offset),
       nonzero_coeffs_(nonzero_coeffs, nonzero_coeffs + num_nonzero_coeffs),
-      state_(sparsity_ * (num_nonzero_coeffs - 1) + offset_, 0.f) {
+      state_length_(sparsity_ * (num_nonzero_coeffs - 1) + offset_),
+      state_(state_length_, 0.f) {
   RTC_CHECK_GE(num_nonzero_coeffs, 1);
   RTC_CHECK_GE(sparsity, 1);
+#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__)
+  InitializeCPUSpecificFeatures();
+  RTC_DCHECK(filter_proc_);
+#endif
 }
 
 SparseFIRFilter::~SparseFIRFilter() = default;
 
 void SparseFIRFilter::Filter(const float* in, size_t length, float* out) {
-  // Convolves the input signal |in| with the filter kernel |nonzero_coeffs_|
-  // taking into account the previous state.
-  for (size_t i = 0; i < length; ++i) {
-    out[i] = 0.f;
-    size_t j;
-    for (j = 0; i >= j * sparsity_ + offset_ && j < nonzero_coeffs_.size();
-         ++j) {
-      out[i] += in[i - j * sparsity_ - offset_] * nonzero_coeffs_[j];
-    }
-    for (; j < nonzero_coeffs_.size(); ++j) {
-      out[i] += state_[i + (nonzero_coeffs_.size() - j - 1) * sparsity_] *
-                nonzero_coeffs_[j];
-    }
-  }
+  // Appends the input signal |in| to the previous state, so that the
+  // convolution with the filter kernel |nonzero_coeffs_| reads all its taps
+  // from one contiguous buffer. The buffer keeps its capacity between calls.
+  state_.resize(state_length_ + length);
+  std::memcpy(state_.data() + state_length_, in, length * sizeof(*in));
+
+  FILTER_FUNC(state_.data(), length, nonzero_coeffs_.data(),
+              nonzero_coeffs_.size(), sparsity_, out);
 
   // Update current state.
-  if (state_.size() > 0u) {
-    if (length >= state_.size()) {
-      std::memcpy(&state_[0], &in[length - state_.size()],
-                  state_.size() * sizeof(*in));
-    } else {
-      std::memmove(&state_[0], &state_[length],
-                   (state_.size() - length) * sizeof(state_[0]));
-      std::memcpy(&state_[state_.size() - length], in, length * sizeof(*in));
+  if (state_length_ > 0u) {
+    std::memmove(state_.data(), state_.data() + length,
+                 state_length_ * sizeof(state_[0]));
+  }
+}
+
+void SparseFIRFilter::Filter_C(const float* history,
+                               size_t length,
+                               const float* coeffs,
+                               size_t num_coeffs,
+                               size_t sparsity,
+                               float* out) {
+  for (size_t i = 0; i < length; ++i) {
+    out[i] = 0.f;
+    for (size_t j = 0; j < num_coeffs; ++j) {
+      out[i] += history[i + (num_coeffs - 1 - j) * sparsity] * coeffs[j];
     }
   }
 }
 
+#undef FILTER_FUNC
+
 }  // namespace webrtc
@@ -15,6 +15,8 @@
 #include <vector>
 
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/gtest_prod_util.h"
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
 
@@ -40,11 +42,57 @@ class SparseFIRFilter final {
   void Filter(const float* in, size_t length, float* out);
 
  private:
+  FRIEND_TEST_ALL_PREFIXES(SparseFIRFilterTest, OptimizedFiltersAreBitExact);
+
+  // Selects runtime specific CPU features like SSE.
+  void InitializeCPUSpecificFeatures();
+
+  // Computes |length| output samples as
+  // out[i] = sum_j coeffs[j] * history[i + (num_coeffs - 1 - j) * sparsity],
+  // where |history| holds the filter state followed by the input. The taps
+  // are accumulated in the same order by all the variants, which makes them
+  // bit-exact. On x86 and ARM the underlying implementation is chosen at run
+  // time.
+  static void Filter_C(const float* history,
+                       size_t length,
+                       const float* coeffs,
+                       size_t num_coeffs,
+                       size_t sparsity,
+                       float* out);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  static void Filter_SSE(const float* history,
+                         size_t length,
+                         const float* coeffs,
+                         size_t num_coeffs,
+                         size_t sparsity,
+                         float* out);
+#elif defined(WEBRTC_HAS_NEON)
+  static void Filter_NEON(const float* history,
+                          size_t length,
+                          const float* coeffs,
+                          size_t num_coeffs,
+                          size_t sparsity,
+                          float* out);
+#endif
+
   const size_t sparsity_;
   const size_t offset_;
   const std::vector<float> nonzero_coeffs_;
+  const size_t state_length_;
+  // The last |state_length_| input samples, followed by the input of the
+  // ongoing Filter() call.
   std::vector<float> state_;
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__)
+  typedef void (*FilterProc)(const float*,
+                             size_t,
+                             const float*,
+                             size_t,
+                             size_t,
+                             float*);
+  FilterProc filter_proc_;
+#endif
+
   RTC_DISALLOW_COPY_AND_ASSIGN(SparseFIRFilter);
 };
 
@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/sparse_fir_filter.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+void SparseFIRFilter::Filter_NEON(const float* history,
+                                  size_t length,
+                                  const float* coeffs,
+                                  size_t num_coeffs,
+                                  size_t sparsity,
+                                  float* out) {
+  // Computes four consecutive output samples at a time. The multiplications
+  // and additions are kept separate, which keeps the result bit-exact with
+  // Filter_C().
+  const size_t vector_length = length & ~static_cast<size_t>(3);
+  for (size_t i = 0; i < vector_length; i += 4) {
+    float32x4_t sums = vdupq_n_f32(0.f);
+    for (size_t j = 0; j < num_coeffs; ++j) {
+      const float32x4_t history_j =
+          vld1q_f32(&history[i + (num_coeffs - 1 - j) * sparsity]);
+      sums = vaddq_f32(sums, vmulq_n_f32(history_j, coeffs[j]));
+    }
+    vst1q_f32(&out[i], sums);
+  }
+
+  Filter_C(&history[vector_length], length - vector_length, coeffs, num_coeffs,
+           sparsity, &out[vector_length]);
+}
+
+}  // namespace webrtc
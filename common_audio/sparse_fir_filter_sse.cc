@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/sparse_fir_filter.h"
+
+#include <xmmintrin.h>
+
+namespace webrtc {
+
+void SparseFIRFilter::Filter_SSE(const float* history,
+                                 size_t length,
+                                 const float* coeffs,
+                                 size_t num_coeffs,
+                                 size_t sparsity,
+                                 float* out) {
+  // Computes four consecutive output samples at a time. The products are not
+  // fused, which keeps the result bit-exact with Filter_C().
+  const size_t vector_length = length & ~static_cast<size_t>(3);
+  for (size_t i = 0; i < vector_length; i += 4) {
+    __m128 m_sums = _mm_setzero_ps();
+    for (size_t j = 0; j < num_coeffs; ++j) {
+      const __m128 m_history =
+          _mm_loadu_ps(&history[i + (num_coeffs - 1 - j) * sparsity]);
+      m_sums =
+          _mm_add_ps(m_sums, _mm_mul_ps(m_history, _mm_set1_ps(coeffs[j])));
+    }
+    _mm_storeu_ps(&out[i], m_sums);
+  }
+
+  Filter_C(&history[vector_length], length - vector_length, coeffs, num_coeffs,
+           sparsity, &out[vector_length]);
+}
+
+}  // namespace webrtc
@@ -9,12 +9,16 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include "common_audio/sparse_fir_filter.h"
 
 #include "common_audio/fir_filter.h"
 #include "common_audio/fir_filter_factory.h"
 #include "rtc_base/arraysize.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -216,4 +220,46 @@ TEST(SparseFIRFilterTest, SameOutputAsFIRFilterWhenSparsityOneAndOffsetZero) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#define FILTER_FUNC Filter_SSE
+#elif defined(WEBRTC_HAS_NEON)
+#define FILTER_FUNC Filter_NEON
+#endif
+
+// Verifies that the optimized filter kernel produces exactly the same output
+// as the generic one, also for lengths which aren't a multiple of the vector
+// width.
+#if defined(FILTER_FUNC)
+TEST(SparseFIRFilterTest, OptimizedFiltersAreBitExact) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  ASSERT_TRUE(WebRtc_GetCPUInfo(kSSE2));
+#endif
+  Random random_generator(42U);
+  for (size_t num_coeffs : {1, 3, 4}) {
+    for (size_t sparsity : {1, 3, 4}) {
+      for (size_t length : {1, 4, 7, 160, 161}) {
+        std::vector<float> coeffs(num_coeffs);
+        for (float& c : coeffs) {
+          c = random_generator.Rand<float>() * 2.f - 1.f;
+        }
+        std::vector<float> history(length + (num_coeffs - 1) * sparsity);
+        for (float& h : history) {
+          h = random_generator.Rand<float>() * 65536.f - 32768.f;
+        }
+        std::vector<float> output(length);
+        std::vector<float> optimized_output(length);
+        SparseFIRFilter::Filter_C(history.data(), length, coeffs.data(),
+                                  num_coeffs, sparsity, output.data());
+        SparseFIRFilter::FILTER_FUNC(history.data(), length, coeffs.data(),
+                                     num_coeffs, sparsity,
+                                     optimized_output.data());
+        EXPECT_EQ(output, optimized_output);
+      }
+    }
+  }
+}
+#endif
+
+#undef FILTER_FUNC
+
 }  // namespace webrtc
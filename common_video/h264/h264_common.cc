@@ -10,23 +10,70 @@
 
 #include "common_video/h264/h264_common.h"
 
+#include <string.h>
+
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 namespace webrtc {
 namespace H264 {
 
 const uint8_t kNaluTypeMask = 0x1F;
 
+namespace {
+
+constexpr size_t kScanBlockSize = 16;
+
+// Returns true if any of the kScanBlockSize bytes at |data| is 0.
+bool BlockHasZeroByte(const uint8_t* data) {
+#if defined(WEBRTC_HAS_NEON)
+  const uint64x2_t zeros =
+      vreinterpretq_u64_u8(vceqq_u8(vld1q_u8(data), vdupq_n_u8(0)));
+  return (vgetq_lane_u64(zeros, 0) | vgetq_lane_u64(zeros, 1)) != 0;
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128i block =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_setzero_si128())) != 0;
+#else
+  // A byte of a word is 0 if subtracting 1 from it borrows from its high bit.
+  constexpr uint64_t kLowBits = 0x0101010101010101ull;
+  constexpr uint64_t kHighBits = 0x8080808080808080ull;
+  uint64_t words[2];
+  memcpy(words, data, sizeof(words));
+  return ((((words[0] - kLowBits) & ~words[0]) |
+           ((words[1] - kLowBits) & ~words[1])) &
+          kHighBits) != 0;
+#endif
+}
+
+}  // namespace
+
 std::vector<NaluIndex> FindNaluIndices(const uint8_t* buffer,
                                        size_t buffer_size) {
   // This is sorta like Boyer-Moore, but with only the first optimization step:
   // given a 3-byte sequence we're looking at, if the 3rd byte isn't 1 or 0,
   // skip ahead to the next 3-byte sequence. 0s and 1s are relatively rare, so
-  // this will skip the majority of reads/checks.
+  // this will skip the majority of reads/checks. Before that, blocks without
+  // any 0 byte, where no start sequence can begin, are skipped whole.
   std::vector<NaluIndex> sequences;
   if (buffer_size < kNaluShortStartSequenceSize)
     return sequences;
 
   const size_t end = buffer_size - kNaluShortStartSequenceSize;
+  size_t block_end = 0;
   for (size_t i = 0; i < end;) {
+    if (i >= block_end) {
+      if (i + kScanBlockSize <= buffer_size && !BlockHasZeroByte(buffer + i)) {
+        i += kScanBlockSize;
+        continue;
+      }
+      block_end = i + kScanBlockSize;
+    }
     if (buffer[i + 2] > 1) {
       i += 3;
     } else if (buffer[i + 2] == 1 && buffer[i + 1] == 0 && buffer[i] == 0) {
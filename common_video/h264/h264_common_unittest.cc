@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/h264/h264_common.h"
+
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace H264 {
+namespace {
+
+// Checks every position for a start sequence, one byte at a time.
+std::vector<NaluIndex> FindNaluIndicesSlowly(const uint8_t* buffer,
+                                             size_t buffer_size) {
+  std::vector<NaluIndex> sequences;
+  for (size_t i = 0; i + kNaluShortStartSequenceSize < buffer_size; ++i) {
+    if (buffer[i] != 0 || buffer[i + 1] != 0 || buffer[i + 2] != 1)
+      continue;
+    NaluIndex index = {i, i + 3, 0};
+    if (i > 0 && buffer[i - 1] == 0)
+      --index.start_offset;
+    if (!sequences.empty()) {
+      sequences.back().payload_size =
+          index.start_offset - sequences.back().payload_start_offset;
+    }
+    sequences.push_back(index);
+    i += 2;
+  }
+  if (!sequences.empty())
+    sequences.back().payload_size =
+        buffer_size - sequences.back().payload_start_offset;
+  return sequences;
+}
+
+void ExpectSameIndices(const std::vector<NaluIndex>& expected,
+                       const std::vector<NaluIndex>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].start_offset, actual[i].start_offset);
+    EXPECT_EQ(expected[i].payload_start_offset,
+              actual[i].payload_start_offset);
+    EXPECT_EQ(expected[i].payload_size, actual[i].payload_size);
+  }
+}
+
+}  // namespace
+
+TEST(H264CommonTest, FindsStartSequencesAtEveryOffset) {
+  // Start sequences crossing the blocks that are scanned at once.
+  for (size_t offset = 0; offset < 40; ++offset) {
+    for (bool long_sequence : {false, true}) {
+      std::vector<uint8_t> buffer(64, 0xAA);
+      size_t start = offset;
+      if (long_sequence)
+        buffer[start++] = 0;
+      buffer[start] = 0;
+      buffer[start + 1] = 0;
+      buffer[start + 2] = 1;
+      std::vector<NaluIndex> indices =
+          FindNaluIndices(buffer.data(), buffer.size());
+      ASSERT_EQ(1u, indices.size());
+      EXPECT_EQ(offset, indices[0].start_offset);
+      EXPECT_EQ(start + 3, indices[0].payload_start_offset);
+      EXPECT_EQ(buffer.size() - start - 3, indices[0].payload_size);
+    }
+  }
+}
+
+TEST(H264CommonTest, FindsSameStartSequencesAsBytewiseScan) {
+  Random random(0x1234);
+  for (int i = 0; i < 200; ++i) {
+    std::vector<uint8_t> buffer(random.Rand(0, 300));
+    for (uint8_t& byte : buffer) {
+      // Mostly 0s and 1s, so that there are many start sequences.
+      byte = random.Rand(0, 3) == 0 ? random.Rand<uint8_t>()
+                                    : random.Rand(0, 1);
+    }
+    ExpectSameIndices(FindNaluIndicesSlowly(buffer.data(), buffer.size()),
+                      FindNaluIndices(buffer.data(), buffer.size()));
+  }
+}
+
+}  // namespace H264
+}  // namespace webrtc
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_VIDEO_INCLUDE_SHARED_I420_BUFFER_POOL_H_
+#define COMMON_VIDEO_INCLUDE_SHARED_I420_BUFFER_POOL_H_
+
+#include <deque>
+#include <list>
+#include <map>
+
+#include "api/video/i420_buffer.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Buffer pool shared by all the streams of the process, to avoid allocations
+// of I420Buffer objects when streams change resolution, e.g. for simulcast or
+// adaptation. Unlike I420BufferPool, the free buffers are kept per size, and a
+// buffer is returned to the pool as soon as its last reference is released,
+// on any thread, instead of being searched for on the next CreateBuffer.
+// The pool keeps free buffers up to |max_free_bytes|, above which the least
+// recently released buffers are freed, whatever their size.
+// On NUMA machines, the free buffers are also kept per node of the thread that
+// created them, and only handed out to threads running on the same node, so
+// that recycled buffers don't turn into cross-socket memory traffic.
+class SharedI420BufferPool : public rtc::RefCountInterface {
+ public:
+  static constexpr size_t kDefaultMaxFreeBytes = 64 * 1024 * 1024;
+
+  // Returns the pool of the process, which is never destroyed.
+  static SharedI420BufferPool* GetInstance();
+  // Creates a separate pool, which is destroyed once it has been released
+  // along with all its buffers.
+  static rtc::scoped_refptr<SharedI420BufferPool> Create(size_t max_free_bytes);
+
+  // Returns a free buffer of the given size, or a new one if there is none.
+  // The buffers are not initialized.
+  rtc::scoped_refptr<I420Buffer> CreateBuffer(int width, int height);
+  rtc::scoped_refptr<I420Buffer> CreateBuffer(int width,
+                                              int height,
+                                              int stride_y,
+                                              int stride_u,
+                                              int stride_v);
+
+  // Frees the least recently released buffers until the free buffers fit in
+  // |max_free_bytes|.
+  void SetMaxFreeBytes(size_t max_free_bytes);
+  // Frees all the free buffers.
+  void Trim();
+
+  size_t free_bytes() const;
+  size_t num_free_buffers() const;
+
+ protected:
+  explicit SharedI420BufferPool(size_t max_free_bytes);
+  ~SharedI420BufferPool() override;
+
+ private:
+  class PooledBuffer;
+
+  struct BufferSize {
+    bool operator<(const BufferSize& other) const;
+    size_t bytes() const;
+
+    int width;
+    int height;
+    int stride_y;
+    int stride_u;
+    int stride_v;
+    // The NUMA node of the thread that created the buffer.
+    int numa_node;
+  };
+
+  using FreeList = std::list<PooledBuffer*>;
+
+  void ReturnBuffer(PooledBuffer* buffer);
+  void TrimTo(size_t max_free_bytes) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  rtc::CriticalSection crit_;
+  size_t max_free_bytes_ RTC_GUARDED_BY(crit_);
+  size_t free_bytes_ RTC_GUARDED_BY(crit_);
+  // All the free buffers, least recently released first.
+  FreeList free_buffers_ RTC_GUARDED_BY(crit_);
+  // The free buffers of each size, in |free_buffers_| order.
+  std::map<BufferSize, std::deque<FreeList::iterator>> buckets_
+      RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_VIDEO_INCLUDE_SHARED_I420_BUFFER_POOL_H_
@@ -21,6 +21,7 @@
 #include "api/video/video_rotation.h"
 #include "api/video/video_timing.h"
 #include "common_types.h"  // NOLINT(build/include)
+#include "rtc_base/copyonwritebuffer.h"
 
 namespace webrtc {
 
@@ -39,6 +40,19 @@ class EncodedImage {
 
   void SetEncodeTime(int64_t encode_start_ms, int64_t encode_finish_ms);
 
+  // Stores the encoded data in the refcounted |encoded_data|, which copies of
+  // the image share. |_buffer|, |_length| and |_size| are set to refer to it,
+  // so the copies stay valid without copying the data, e.g. after the encoder
+  // has moved on to the next frame.
+  void SetEncodedData(rtc::CopyOnWriteBuffer encoded_data);
+  // Returns the data set with SetEncodedData, leaving the image empty. The
+  // returned buffer is cheap to reuse for the next frame once the copies of
+  // the image are gone.
+  rtc::CopyOnWriteBuffer ReleaseEncodedData();
+  // Empty unless set with SetEncodedData. When empty, |_buffer| is owned by
+  // whoever created the image.
+  const rtc::CopyOnWriteBuffer& encoded_data() const { return encoded_data_; }
+
   absl::optional<int> SpatialIndex() const {
     if (spatial_index_ < 0)
       return absl::nullopt;
@@ -83,8 +97,8 @@ class EncodedImage {
   } timing_;
 
  private:
-  // -1 means not set. Use a plain int rather than optional, to keep this class
-  // copyable with memcpy.
+  rtc::CopyOnWriteBuffer encoded_data_;
+  // -1 means not set.
   int spatial_index_ = -1;
 };
 
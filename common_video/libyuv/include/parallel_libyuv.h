@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_VIDEO_LIBYUV_INCLUDE_PARALLEL_LIBYUV_H_
+#define COMMON_VIDEO_LIBYUV_INCLUDE_PARALLEL_LIBYUV_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api/video/i420_buffer.h"
+#include "common_types.h"  // NOLINT(build/include)  // VideoTypes.
+
+namespace webrtc {
+
+// Frames with at least this many pixels are converted and scaled in
+// horizontal slices, on a pool of worker threads shared by all the streams.
+// Smaller frames are processed on the calling thread only.
+constexpr int kDefaultMinPixelsForParallelLibyuv = 1920 * 1080;
+void SetMinPixelsForParallelLibyuv(int min_pixels);
+
+// Like libyuv::ConvertToI420 without cropping or rotation, converts the
+// |src_width|x|src_height| frame of |src_size| bytes in |src| to |dst|, which
+// has the same size. MJPEG and inverted frames are converted in one piece.
+// Returns 0 if OK, < 0 otherwise.
+int ParallelConvertToI420(VideoType src_type,
+                          const uint8_t* src,
+                          size_t src_size,
+                          int src_width,
+                          int src_height,
+                          I420Buffer* dst);
+
+// Like I420Buffer::CropAndScaleFrom and I420Buffer::ScaleFrom. The slices
+// start at rows scaled from whole source rows, and are scaled like the frame
+// in one piece, give or take rounding in libyuv for uncommon ratios. Upscaled
+// frames, and frames scaled by ratios for which there are no such rows, e.g.
+// 1080 to 1079 rows, are scaled in one piece.
+void ParallelCropAndScaleI420(const I420BufferInterface& src,
+                              int offset_x,
+                              int offset_y,
+                              int crop_width,
+                              int crop_height,
+                              I420Buffer* dst);
+void ParallelScaleI420(const I420BufferInterface& src, I420Buffer* dst);
+
+}  // namespace webrtc
+
+#endif  // COMMON_VIDEO_LIBYUV_INCLUDE_PARALLEL_LIBYUV_H_
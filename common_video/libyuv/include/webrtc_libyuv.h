@@ -133,6 +133,17 @@ class NV12ToI420Scaler {
 // Convert VideoType to libyuv FourCC type
 int ConvertVideoType(VideoType video_type);
 
+// Restricts the kernels that libyuv picks to the ones for the CPU features in
+// |cpu_flags|, a mask of the libyuv::kCpuHas* flags in libyuv/cpu_id.h, e.g.
+// to keep it off AVX-512 on hosts where those kernels are slower. -1
+// allows all the features of the CPU, and 0 forces the portable C kernels.
+// Applies to the whole process and isn't thread safe, so it should be called
+// before any frames are processed.
+void SetLibyuvCpuFlags(int cpu_flags);
+
+// Returns the libyuv::kCpuHas* flags of the kernels that libyuv may pick.
+int GetLibyuvCpuFlags();
+
 }  // namespace webrtc
 
 #endif  // COMMON_VIDEO_LIBYUV_INCLUDE_WEBRTC_LIBYUV_H_
@@ -330,4 +330,23 @@ TEST_F(TestLibYuv, NV12Scale4x4to2x2) {
               ::testing::ElementsAre(Average(0, 2, 4, 6), Average(1, 3, 5, 7)));
 }
 
+TEST_F(TestLibYuv, SetLibyuvCpuFlags) {
+  SetLibyuvCpuFlags(-1);
+  const int cpu_flags = GetLibyuvCpuFlags();
+
+  // Forcing the portable kernels still scales correctly.
+  SetLibyuvCpuFlags(0);
+  EXPECT_EQ(0, GetLibyuvCpuFlags());
+  const std::vector<uint8_t> src_y = {0, 1, 2, 3};
+  const std::vector<uint8_t> src_uv = {0, 1};
+  std::vector<uint8_t> dst_y(4);
+  std::vector<uint8_t> dst_uv(2);
+  NV12Scale(nullptr, src_y.data(), 2, src_uv.data(), 2, 2, 2, dst_y.data(), 2,
+            dst_uv.data(), 2, 2, 2);
+  EXPECT_THAT(dst_y, ::testing::ContainerEq(src_y));
+
+  SetLibyuvCpuFlags(-1);
+  EXPECT_EQ(cpu_flags, GetLibyuvCpuFlags());
+}
+
 }  // namespace webrtc
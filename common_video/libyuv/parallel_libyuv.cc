@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/libyuv/include/parallel_libyuv.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "rtc_base/atomicops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/function_view.h"
+#include "rtc_base/task_queue.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "third_party/libyuv/include/libyuv.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kMaxSlices = 4;
+// Slices are at least this high, so that each is worth a task.
+constexpr int kMinSliceHeight = 64;
+
+volatile int g_min_pixels = kDefaultMinPixelsForParallelLibyuv;
+
+// Task queues running all the slices but the first one, which runs on the
+// calling thread. The frames are sliced the same way whatever the number of
+// cores, so that the output doesn't depend on it.
+class SliceWorkers {
+ public:
+  static SliceWorkers* GetInstance() {
+    static SliceWorkers* const instance = new SliceWorkers();
+    return instance;
+  }
+
+  // Runs |slice_fn| for each of the |num_slices| slices, and returns once they
+  // are all done.
+  void Run(int num_slices, rtc::FunctionView<void(int)> slice_fn) {
+    if (queues_.empty()) {
+      for (int i = 0; i < num_slices; ++i)
+        slice_fn(i);
+      return;
+    }
+    volatile int remaining = num_slices - 1;
+    rtc::Event done(false, false);
+    for (int i = 1; i < num_slices; ++i) {
+      queues_[(i - 1) % queues_.size()]->PostTask(
+          [&slice_fn, &remaining, &done, i] {
+            slice_fn(i);
+            if (rtc::AtomicOps::Decrement(&remaining) == 0)
+              done.Set();
+          });
+    }
+    slice_fn(0);
+    if (num_slices > 1)
+      done.Wait(rtc::Event::kForever);
+  }
+
+ private:
+  SliceWorkers() {
+    const int num_cores = static_cast<int>(CpuInfo::DetectNumberOfCores());
+    const int num_queues = std::min(num_cores, kMaxSlices) - 1;
+    for (int i = 0; i < num_queues; ++i)
+      queues_.push_back(absl::make_unique<rtc::TaskQueue>("LibyuvSliceQueue"));
+  }
+
+  std::vector<std::unique_ptr<rtc::TaskQueue>> queues_;
+};
+
+// Returns the number of slices to process a |width|x|height| frame in.
+int NumSlices(int width, int height) {
+  if (width * height < rtc::AtomicOps::AcquireLoad(&g_min_pixels))
+    return 1;
+  return std::max(1, std::min(kMaxSlices, height / kMinSliceHeight));
+}
+
+// Returns the first row of |slice| when |height| rows are split in
+// |num_slices| slices starting at multiples of |row_step|, which is even so
+// that the chroma rows are split too.
+int SliceStart(int slice, int num_slices, int height, int row_step) {
+  if (slice == num_slices)
+    return height;
+  return height * slice / num_slices / row_step * row_step;
+}
+
+// Returns the smallest even number of destination rows that is scaled from an
+// even number of source rows, so that the slices are scaled like the frame.
+int ScaleRowStep(int src_height, int dst_height) {
+  int a = src_height;
+  int b = dst_height;
+  while (b != 0) {
+    const int r = a % b;
+    a = b;
+    b = r;
+  }
+  const int dst_step = dst_height / a;
+  const int src_step = src_height / a;
+  return dst_step % 2 == 0 && src_step % 2 == 0 ? dst_step : 2 * dst_step;
+}
+
+}  // namespace
+
+void SetMinPixelsForParallelLibyuv(int min_pixels) {
+  rtc::AtomicOps::ReleaseStore(&g_min_pixels, min_pixels);
+}
+
+int ParallelConvertToI420(VideoType src_type,
+                          const uint8_t* src,
+                          size_t src_size,
+                          int src_width,
+                          int src_height,
+                          I420Buffer* dst) {
+  RTC_DCHECK_EQ(src_width, dst->width());
+  RTC_DCHECK_EQ(std::abs(src_height), dst->height());
+  const uint32_t fourcc = ConvertVideoType(src_type);
+  const int num_slices = src_type == VideoType::kMJPEG || src_height < 0
+                             ? 1
+                             : NumSlices(src_width, src_height);
+  int results[kMaxSlices] = {0};
+  auto convert_slice = [&](int slice) {
+    const int start = SliceStart(slice, num_slices, dst->height(), 2);
+    const int end = SliceStart(slice + 1, num_slices, dst->height(), 2);
+    results[slice] = libyuv::ConvertToI420(
+        src, src_size, dst->MutableDataY() + dst->StrideY() * start,
+        dst->StrideY(), dst->MutableDataU() + dst->StrideU() * (start / 2),
+        dst->StrideU(), dst->MutableDataV() + dst->StrideV() * (start / 2),
+        dst->StrideV(), 0, start, src_width, src_height, src_width,
+        end - start, libyuv::kRotate0, fourcc);
+  };
+  if (num_slices == 1) {
+    convert_slice(0);
+    return results[0];
+  }
+  SliceWorkers::GetInstance()->Run(num_slices, convert_slice);
+  return *std::min_element(results, results + num_slices);
+}
+
+void ParallelCropAndScaleI420(const I420BufferInterface& src,
+                              int offset_x,
+                              int offset_y,
+                              int crop_width,
+                              int crop_height,
+                              I420Buffer* dst) {
+  const int row_step = ScaleRowStep(crop_height, dst->height());
+  // Slices can't be upscaled separately, since their edges would be
+  // interpolated from the rows of the next slice.
+  const int num_slices =
+      dst->height() > crop_height
+          ? 1
+          : std::min({NumSlices(crop_width, crop_height),
+                      NumSlices(dst->width(), dst->height()),
+                      dst->height() / row_step});
+  if (num_slices <= 1) {
+    dst->CropAndScaleFrom(src, offset_x, offset_y, crop_width, crop_height);
+    return;
+  }
+  RTC_CHECK_GE(offset_x, 0);
+  RTC_CHECK_GE(offset_y, 0);
+  RTC_CHECK_LE(crop_width + offset_x, src.width());
+  RTC_CHECK_LE(crop_height + offset_y, src.height());
+  // Make sure offset is even so that u/v plane becomes aligned.
+  offset_x &= ~1;
+  offset_y &= ~1;
+
+  SliceWorkers::GetInstance()->Run(num_slices, [&](int slice) {
+    const int dst_start =
+        SliceStart(slice, num_slices, dst->height(), row_step);
+    const int dst_end =
+        SliceStart(slice + 1, num_slices, dst->height(), row_step);
+    const int src_start = static_cast<int64_t>(dst_start) * crop_height /
+                          dst->height();
+    const int src_end = static_cast<int64_t>(dst_end) * crop_height /
+                        dst->height();
+    const int src_y = offset_y + src_start;
+    int res = libyuv::I420Scale(
+        src.DataY() + src.StrideY() * src_y + offset_x, src.StrideY(),
+        src.DataU() + src.StrideU() * (src_y / 2) + offset_x / 2,
+        src.StrideU(),
+        src.DataV() + src.StrideV() * (src_y / 2) + offset_x / 2,
+        src.StrideV(), crop_width, src_end - src_start,
+        dst->MutableDataY() + dst->StrideY() * dst_start, dst->StrideY(),
+        dst->MutableDataU() + dst->StrideU() * (dst_start / 2),
+        dst->StrideU(),
+        dst->MutableDataV() + dst->StrideV() * (dst_start / 2),
+        dst->StrideV(), dst->width(), dst_end - dst_start,
+        libyuv::kFilterBox);
+    RTC_DCHECK_EQ(res, 0);
+  });
+}
+
+void ParallelScaleI420(const I420BufferInterface& src, I420Buffer* dst) {
+  ParallelCropAndScaleI420(src, 0, 0, src.width(), src.height(), dst);
+}
+
+}  // namespace webrtc
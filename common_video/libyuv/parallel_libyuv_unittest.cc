@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/libyuv/include/parallel_libyuv.h"
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "rtc_base/timeutils.h"
+#include "test/frame_utils.h"
+#include "test/gtest.h"
+#include "third_party/libyuv/include/libyuv.h"
+
+namespace webrtc {
+namespace {
+
+rtc::scoped_refptr<I420Buffer> CreateGradient(int width, int height) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x)
+      buffer->MutableDataY()[y * buffer->StrideY() + x] = (x + 3 * y) & 0xff;
+  }
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    for (int x = 0; x < buffer->ChromaWidth(); ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] = (2 * x + y) & 0xff;
+      buffer->MutableDataV()[y * buffer->StrideV() + x] = (x + 2 * y) & 0xff;
+    }
+  }
+  return buffer;
+}
+
+std::vector<uint8_t> ToYuy2(const I420BufferInterface& buffer) {
+  std::vector<uint8_t> yuy2(
+      CalcBufferSize(VideoType::kYUY2, buffer.width(), buffer.height()));
+  libyuv::I420ToYUY2(buffer.DataY(), buffer.StrideY(), buffer.DataU(),
+                     buffer.StrideU(), buffer.DataV(), buffer.StrideV(),
+                     yuy2.data(), 2 * buffer.width(), buffer.width(),
+                     buffer.height());
+  return yuy2;
+}
+
+class ParallelLibyuvTest : public ::testing::Test {
+ protected:
+  // Slice all the frames, as long as there are enough cores.
+  ParallelLibyuvTest() { SetMinPixelsForParallelLibyuv(0); }
+  ~ParallelLibyuvTest() override {
+    SetMinPixelsForParallelLibyuv(kDefaultMinPixelsForParallelLibyuv);
+  }
+};
+
+}  // namespace
+
+TEST_F(ParallelLibyuvTest, ConvertsLikeLibyuv) {
+  const int kWidth = 640;
+  const int kHeight = 362;
+  const std::vector<uint8_t> yuy2 =
+      ToYuy2(*CreateGradient(kWidth, kHeight));
+
+  rtc::scoped_refptr<I420Buffer> expected = I420Buffer::Create(kWidth, kHeight);
+  ASSERT_EQ(0, libyuv::ConvertToI420(
+                   yuy2.data(), yuy2.size(), expected->MutableDataY(),
+                   expected->StrideY(), expected->MutableDataU(),
+                   expected->StrideU(), expected->MutableDataV(),
+                   expected->StrideV(), 0, 0, kWidth, kHeight, kWidth, kHeight,
+                   libyuv::kRotate0, libyuv::FOURCC_YUY2));
+  rtc::scoped_refptr<I420Buffer> converted =
+      I420Buffer::Create(kWidth, kHeight);
+  ASSERT_EQ(0, ParallelConvertToI420(VideoType::kYUY2, yuy2.data(),
+                                     yuy2.size(), kWidth, kHeight, converted));
+  EXPECT_TRUE(test::FrameBufsEqual(expected, converted));
+}
+
+TEST_F(ParallelLibyuvTest, ScalesByTwoLikeI420Buffer) {
+  rtc::scoped_refptr<I420Buffer> src = CreateGradient(1280, 720);
+  rtc::scoped_refptr<I420Buffer> expected = I420Buffer::Create(640, 360);
+  expected->ScaleFrom(*src);
+  rtc::scoped_refptr<I420Buffer> scaled = I420Buffer::Create(640, 360);
+  ParallelScaleI420(*src, scaled);
+  EXPECT_TRUE(test::FrameBufsEqual(expected, scaled));
+}
+
+TEST_F(ParallelLibyuvTest, CropsAndScalesLikeI420Buffer) {
+  rtc::scoped_refptr<I420Buffer> src = CreateGradient(1280, 720);
+  rtc::scoped_refptr<I420Buffer> expected = I420Buffer::Create(800, 480);
+  expected->CropAndScaleFrom(*src, 40, 0, 1200, 720);
+  rtc::scoped_refptr<I420Buffer> scaled = I420Buffer::Create(800, 480);
+  ParallelCropAndScaleI420(*src, 40, 0, 1200, 720, scaled);
+  EXPECT_TRUE(test::FrameBufsEqual(expected, scaled));
+}
+
+TEST_F(ParallelLibyuvTest, ScalesByOtherRatiosCloseToI420Buffer) {
+  rtc::scoped_refptr<I420Buffer> src = CreateGradient(1280, 720);
+  rtc::scoped_refptr<I420Buffer> expected = I420Buffer::Create(480, 270);
+  expected->CropAndScaleFrom(*src, 20, 10, 1200, 700);
+  rtc::scoped_refptr<I420Buffer> scaled = I420Buffer::Create(480, 270);
+  ParallelCropAndScaleI420(*src, 20, 10, 1200, 700, scaled);
+  EXPECT_GT(I420PSNR(*expected, *scaled), 40.0);
+}
+
+// Compares the time to convert and scale 4K frames in one piece and in
+// slices.
+TEST(ParallelLibyuvPerfTest, DISABLED_ConvertAndScale4k) {
+  const int kWidth = 3840;
+  const int kHeight = 2160;
+  const int kNumFrames = 50;
+  const std::vector<uint8_t> yuy2 =
+      ToYuy2(*CreateGradient(kWidth, kHeight));
+  rtc::scoped_refptr<I420Buffer> frame = I420Buffer::Create(kWidth, kHeight);
+  rtc::scoped_refptr<I420Buffer> scaled =
+      I420Buffer::Create(kWidth / 2, kHeight / 2);
+  for (int min_pixels : {kWidth * kHeight + 1, 0}) {
+    SetMinPixelsForParallelLibyuv(min_pixels);
+    int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumFrames; ++i) {
+      ParallelConvertToI420(VideoType::kYUY2, yuy2.data(), yuy2.size(), kWidth,
+                            kHeight, frame);
+    }
+    int64_t convert_us = rtc::TimeMicros() - start_us;
+    start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumFrames; ++i)
+      ParallelScaleI420(*frame, scaled);
+    int64_t scale_us = rtc::TimeMicros() - start_us;
+    printf("%s: convert %.2f ms, scale %.2f ms per frame\n",
+           min_pixels == 0 ? "Sliced" : "Single threaded",
+           convert_us / 1000.0 / kNumFrames, scale_us / 1000.0 / kNumFrames);
+  }
+  SetMinPixelsForParallelLibyuv(kDefaultMinPixelsForParallelLibyuv);
+}
+
+}  // namespace webrtc
@@ -45,6 +45,7 @@ size_t CalcBufferSize(VideoType type, int width, int height) {
     case VideoType::kRGB24:
       buffer_size = width * height * 3;
       break;
+    case VideoType::kABGR:
     case VideoType::kBGRA:
     case VideoType::kARGB:
       buffer_size = width * height * 4;
@@ -185,6 +186,16 @@ int ConvertVideoType(VideoType video_type) {
   return libyuv::FOURCC_ANY;
 }
 
+void SetLibyuvCpuFlags(int cpu_flags) {
+  // Without kCpuInitialized, an empty mask would make libyuv detect the CPU
+  // features again.
+  libyuv::MaskCpuFlags(cpu_flags | libyuv::kCpuInitialized);
+}
+
+int GetLibyuvCpuFlags() {
+  return libyuv::TestCpuFlag(-1) & ~libyuv::kCpuInitialized;
+}
+
 int ConvertFromI420(const VideoFrame& src_frame,
                     VideoType dst_video_type,
                     int dst_sample_size,
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/nv12_buffer_pool.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+NV12BufferPool::NV12BufferPool()
+    : NV12BufferPool(std::numeric_limits<size_t>::max()) {}
+NV12BufferPool::NV12BufferPool(size_t max_number_of_buffers)
+    : max_number_of_buffers_(max_number_of_buffers) {}
+NV12BufferPool::~NV12BufferPool() = default;
+
+void NV12BufferPool::Release() {
+  buffers_.clear();
+}
+
+rtc::scoped_refptr<NV12Buffer> NV12BufferPool::CreateBuffer(int width,
+                                                            int height) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  // Release buffers with wrong resolution.
+  for (auto it = buffers_.begin(); it != buffers_.end();) {
+    if ((*it)->width() != width || (*it)->height() != height)
+      it = buffers_.erase(it);
+    else
+      ++it;
+  }
+  // Look for a free buffer. The list holds the only reference to a buffer
+  // that isn't in use.
+  for (const rtc::scoped_refptr<PooledNV12Buffer>& buffer : buffers_) {
+    if (buffer->HasOneRef())
+      return buffer;
+  }
+
+  if (buffers_.size() >= max_number_of_buffers_)
+    return nullptr;
+  // Allocate new buffer.
+  rtc::scoped_refptr<PooledNV12Buffer> buffer =
+      new PooledNV12Buffer(width, height, width, 2 * ((width + 1) / 2));
+  buffers_.push_back(buffer);
+  return buffer;
+}
+
+}  // namespace webrtc
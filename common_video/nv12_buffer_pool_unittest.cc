@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/nv12_buffer_pool.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(TestNV12BufferPool, SimpleFrameReuse) {
+  NV12BufferPool pool;
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12, buffer->type());
+  EXPECT_EQ(16, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+  EXPECT_EQ(16, buffer->StrideUV());
+  const uint8_t* y_ptr = buffer->DataY();
+  const uint8_t* uv_ptr = buffer->DataUV();
+  // Release buffer so that it is returned to the pool.
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(uv_ptr, buffer->DataUV());
+}
+
+TEST(TestNV12BufferPool, FailToReuseWithDifferentSize) {
+  NV12BufferPool pool;
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(16, 16);
+  buffer = pool.CreateBuffer(32, 16);
+  EXPECT_EQ(32, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+}
+
+TEST(TestNV12BufferPool, MaxNumberOfBuffers) {
+  NV12BufferPool pool(1);
+  rtc::scoped_refptr<NV12Buffer> buffer1 = pool.CreateBuffer(16, 16);
+  EXPECT_NE(nullptr, buffer1.get());
+  EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/shared_i420_buffer_pool.h"
+
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/numa.h"
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/refcounter.h"
+
+namespace webrtc {
+
+// An I420Buffer that is returned to its pool instead of being deleted when
+// the last reference is released. It only holds a reference to the pool while
+// it is in use, so that the free buffers owned by the pool don't keep it
+// alive.
+class SharedI420BufferPool::PooledBuffer : public I420Buffer {
+ public:
+  explicit PooledBuffer(const BufferSize& size)
+      : I420Buffer(size.width,
+                   size.height,
+                   size.stride_y,
+                   size.stride_u,
+                   size.stride_v),
+        size_(size) {}
+  ~PooledBuffer() override = default;
+
+  void AddRef() const override { ref_count_.IncRef(); }
+
+  rtc::RefCountReleaseStatus Release() const override {
+    const auto status = ref_count_.DecRef();
+    if (status == rtc::RefCountReleaseStatus::kDroppedLastRef) {
+      // Keep the pool alive until the buffer has been returned to it.
+      rtc::scoped_refptr<SharedI420BufferPool> pool = std::move(pool_);
+      pool->ReturnBuffer(const_cast<PooledBuffer*>(this));
+    }
+    return status;
+  }
+
+  const BufferSize& size() const { return size_; }
+  void set_pool(SharedI420BufferPool* pool) { pool_ = pool; }
+
+ private:
+  const BufferSize size_;
+  mutable rtc::scoped_refptr<SharedI420BufferPool> pool_;
+  mutable webrtc_impl::RefCounter ref_count_{0};
+};
+
+constexpr size_t SharedI420BufferPool::kDefaultMaxFreeBytes;
+
+bool SharedI420BufferPool::BufferSize::operator<(
+    const BufferSize& other) const {
+  return std::tie(width, height, stride_y, stride_u, stride_v, numa_node) <
+         std::tie(other.width, other.height, other.stride_y, other.stride_u,
+                  other.stride_v, other.numa_node);
+}
+
+size_t SharedI420BufferPool::BufferSize::bytes() const {
+  return static_cast<size_t>(stride_y) * height +
+         static_cast<size_t>(stride_u + stride_v) * ((height + 1) / 2);
+}
+
+SharedI420BufferPool* SharedI420BufferPool::GetInstance() {
+  static SharedI420BufferPool* const instance = [] {
+    SharedI420BufferPool* pool =
+        new rtc::RefCountedObject<SharedI420BufferPool>(kDefaultMaxFreeBytes);
+    // Never released, the buffers may outlive everything else.
+    pool->AddRef();
+    return pool;
+  }();
+  return instance;
+}
+
+rtc::scoped_refptr<SharedI420BufferPool> SharedI420BufferPool::Create(
+    size_t max_free_bytes) {
+  return new rtc::RefCountedObject<SharedI420BufferPool>(max_free_bytes);
+}
+
+SharedI420BufferPool::SharedI420BufferPool(size_t max_free_bytes)
+    : max_free_bytes_(max_free_bytes), free_bytes_(0) {}
+
+SharedI420BufferPool::~SharedI420BufferPool() {
+  for (PooledBuffer* buffer : free_buffers_)
+    delete buffer;
+}
+
+rtc::scoped_refptr<I420Buffer> SharedI420BufferPool::CreateBuffer(int width,
+                                                                  int height) {
+  return CreateBuffer(width, height, width, (width + 1) / 2, (width + 1) / 2);
+}
+
+rtc::scoped_refptr<I420Buffer> SharedI420BufferPool::CreateBuffer(
+    int width,
+    int height,
+    int stride_y,
+    int stride_u,
+    int stride_v) {
+  const BufferSize size = {width,    height,   stride_y,
+                           stride_u, stride_v, rtc::CurrentNumaNode()};
+  PooledBuffer* buffer = nullptr;
+  {
+    rtc::CritScope lock(&crit_);
+    auto bucket = buckets_.find(size);
+    if (bucket != buckets_.end()) {
+      // Reuse the most recently released buffer, which is the most likely to
+      // still be cached.
+      FreeList::iterator it = bucket->second.back();
+      buffer = *it;
+      bucket->second.pop_back();
+      if (bucket->second.empty())
+        buckets_.erase(bucket);
+      free_buffers_.erase(it);
+      free_bytes_ -= size.bytes();
+    }
+  }
+  if (!buffer)
+    buffer = new PooledBuffer(size);
+  buffer->set_pool(this);
+  return buffer;
+}
+
+void SharedI420BufferPool::SetMaxFreeBytes(size_t max_free_bytes) {
+  rtc::CritScope lock(&crit_);
+  max_free_bytes_ = max_free_bytes;
+  TrimTo(max_free_bytes_);
+}
+
+void SharedI420BufferPool::Trim() {
+  rtc::CritScope lock(&crit_);
+  TrimTo(0);
+}
+
+size_t SharedI420BufferPool::free_bytes() const {
+  rtc::CritScope lock(&crit_);
+  return free_bytes_;
+}
+
+size_t SharedI420BufferPool::num_free_buffers() const {
+  rtc::CritScope lock(&crit_);
+  return free_buffers_.size();
+}
+
+void SharedI420BufferPool::ReturnBuffer(PooledBuffer* buffer) {
+  rtc::CritScope lock(&crit_);
+  free_buffers_.push_back(buffer);
+  buckets_[buffer->size()].push_back(std::prev(free_buffers_.end()));
+  free_bytes_ += buffer->size().bytes();
+  TrimTo(max_free_bytes_);
+}
+
+void SharedI420BufferPool::TrimTo(size_t max_free_bytes) {
+  while (free_bytes_ > max_free_bytes) {
+    PooledBuffer* buffer = free_buffers_.front();
+    // The least recently released buffer is also the first one of its size.
+    auto bucket = buckets_.find(buffer->size());
+    RTC_DCHECK(bucket != buckets_.end());
+    RTC_DCHECK(bucket->second.front() == free_buffers_.begin());
+    bucket->second.pop_front();
+    if (bucket->second.empty())
+      buckets_.erase(bucket);
+    free_buffers_.pop_front();
+    free_bytes_ -= buffer->size().bytes();
+    delete buffer;
+  }
+}
+
+}  // namespace webrtc
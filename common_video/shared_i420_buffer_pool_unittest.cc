@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/shared_i420_buffer_pool.h"
+
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// The size of a 16x16 buffer.
+constexpr size_t kBufferBytes = 16 * 16 + 2 * 8 * 8;
+constexpr size_t kMaxFreeBytes = 2 * kBufferBytes;
+
+}  // namespace
+
+TEST(SharedI420BufferPoolTest, ReusesReleasedBuffer) {
+  rtc::scoped_refptr<SharedI420BufferPool> pool =
+      SharedI420BufferPool::Create(kMaxFreeBytes);
+  rtc::scoped_refptr<I420Buffer> buffer = pool->CreateBuffer(16, 16);
+  EXPECT_EQ(16, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+  const uint8_t* y_ptr = buffer->DataY();
+  EXPECT_EQ(0u, pool->num_free_buffers());
+  buffer = nullptr;
+  EXPECT_EQ(1u, pool->num_free_buffers());
+  EXPECT_EQ(kBufferBytes, pool->free_bytes());
+
+  buffer = pool->CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(0u, pool->num_free_buffers());
+  EXPECT_EQ(0u, pool->free_bytes());
+}
+
+TEST(SharedI420BufferPoolTest, KeepsBuffersOfOtherSizes) {
+  rtc::scoped_refptr<SharedI420BufferPool> pool =
+      SharedI420BufferPool::Create(SharedI420BufferPool::kDefaultMaxFreeBytes);
+  rtc::scoped_refptr<I420Buffer> buffer = pool->CreateBuffer(16, 16);
+  const uint8_t* y_ptr = buffer->DataY();
+  buffer = nullptr;
+
+  // Changing resolution doesn't free the buffers of the previous one.
+  buffer = pool->CreateBuffer(32, 16);
+  EXPECT_NE(y_ptr, buffer->DataY());
+  EXPECT_EQ(1u, pool->num_free_buffers());
+  buffer = pool->CreateBuffer(16, 16, 32, 16, 16);
+  EXPECT_EQ(32, buffer->StrideY());
+  EXPECT_NE(y_ptr, buffer->DataY());
+  EXPECT_EQ(2u, pool->num_free_buffers());
+  buffer = nullptr;
+  buffer = pool->CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+}
+
+TEST(SharedI420BufferPoolTest, FreesLeastRecentlyReleasedBuffers) {
+  rtc::scoped_refptr<SharedI420BufferPool> pool =
+      SharedI420BufferPool::Create(kMaxFreeBytes);
+  rtc::scoped_refptr<I420Buffer> buffer1 = pool->CreateBuffer(16, 16);
+  rtc::scoped_refptr<I420Buffer> buffer2 = pool->CreateBuffer(16, 16);
+  rtc::scoped_refptr<I420Buffer> buffer3 = pool->CreateBuffer(16, 16);
+  const uint8_t* y_ptr2 = buffer2->DataY();
+  const uint8_t* y_ptr3 = buffer3->DataY();
+  buffer1 = nullptr;
+  buffer3 = nullptr;
+  buffer2 = nullptr;
+  EXPECT_EQ(2u, pool->num_free_buffers());
+  EXPECT_EQ(kMaxFreeBytes, pool->free_bytes());
+
+  // The most recently released buffer is reused first.
+  buffer2 = pool->CreateBuffer(16, 16);
+  buffer3 = pool->CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr2, buffer2->DataY());
+  EXPECT_EQ(y_ptr3, buffer3->DataY());
+  buffer2 = nullptr;
+  buffer3 = nullptr;
+
+  pool->SetMaxFreeBytes(kBufferBytes);
+  EXPECT_EQ(1u, pool->num_free_buffers());
+  pool->Trim();
+  EXPECT_EQ(0u, pool->num_free_buffers());
+  EXPECT_EQ(0u, pool->free_bytes());
+}
+
+TEST(SharedI420BufferPoolTest, BuffersOutliveReleasedPool) {
+  rtc::scoped_refptr<SharedI420BufferPool> pool =
+      SharedI420BufferPool::Create(kMaxFreeBytes);
+  rtc::scoped_refptr<I420Buffer> buffer = pool->CreateBuffer(16, 16);
+  pool = nullptr;
+  // The pool is destroyed with the last buffer.
+  buffer->MutableDataY()[0] = 1;
+  buffer = nullptr;
+}
+
+TEST(SharedI420BufferPoolTest, ReturnsBuffersReleasedOnOtherThreads) {
+  SharedI420BufferPool* pool = SharedI420BufferPool::GetInstance();
+  pool->Trim();
+  rtc::scoped_refptr<I420Buffer> buffer = pool->CreateBuffer(16, 16);
+  rtc::PlatformThread thread(
+      [](void* obj) {
+        *static_cast<rtc::scoped_refptr<I420Buffer>*>(obj) = nullptr;
+      },
+      &buffer, "ReleaseBuffer");
+  thread.Start();
+  thread.Stop();
+  EXPECT_FALSE(buffer);
+  EXPECT_EQ(1u, pool->num_free_buffers());
+  pool->Trim();
+}
+
+}  // namespace webrtc
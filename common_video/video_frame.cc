@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include <algorithm>  // swap
+#include <utility>
 
 #include "rtc_base/bind.h"
 #include "rtc_base/checks.h"
@@ -52,4 +53,19 @@ void EncodedImage::SetEncodeTime(int64_t encode_start_ms,
   timing_.encode_start_ms = encode_start_ms;
   timing_.encode_finish_ms = encode_finish_ms;
 }
+
+void EncodedImage::SetEncodedData(rtc::CopyOnWriteBuffer encoded_data) {
+  encoded_data_ = std::move(encoded_data);
+  // Not data(), which would copy the data shared with other images.
+  _buffer = const_cast<uint8_t*>(encoded_data_.cdata());
+  _length = encoded_data_.size();
+  _size = encoded_data_.capacity();
+}
+
+rtc::CopyOnWriteBuffer EncodedImage::ReleaseEncodedData() {
+  _buffer = nullptr;
+  _length = 0;
+  _size = 0;
+  return std::move(encoded_data_);
+}
 }  // namespace webrtc
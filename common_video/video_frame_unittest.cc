@@ -11,9 +11,13 @@
 #include <math.h>
 #include <string.h>
 
+#include <utility>
+
 #include "api/video/i010_buffer.h"
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video/video_frame.h"
+#include "common_video/include/video_frame.h"
 #include "rtc_base/bind.h"
 #include "rtc_base/timeutils.h"
 #include "test/fake_texture_frame.h"
@@ -432,4 +436,79 @@ INSTANTIATE_TEST_CASE_P(
                        ::testing::Values(VideoFrameBuffer::Type::kI420,
                                          VideoFrameBuffer::Type::kI010)));
 
+rtc::scoped_refptr<NV12Buffer> CreateNV12Gradient(int width, int height) {
+  return NV12Buffer::Copy(
+      *CreateGradient(VideoFrameBuffer::Type::kI420, width, height)
+           ->ToI420());
+}
+
+TEST(TestNV12Buffer, CopyConvertsBackToSameI420) {
+  rtc::scoped_refptr<I420BufferInterface> i420 =
+      CreateGradient(VideoFrameBuffer::Type::kI420, 200, 100)->ToI420();
+  rtc::scoped_refptr<NV12Buffer> nv12 = NV12Buffer::Copy(*i420);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12, nv12->type());
+  EXPECT_EQ(100, nv12->ChromaWidth());
+  EXPECT_EQ(50, nv12->ChromaHeight());
+  EXPECT_TRUE(test::FrameBufsEqual(i420, nv12->ToI420()));
+  EXPECT_TRUE(test::FrameBufsEqual(i420, NV12Buffer::Copy(*nv12)->ToI420()));
+}
+
+TEST(TestNV12Buffer, Scale) {
+  rtc::scoped_refptr<NV12Buffer> buf = CreateNV12Gradient(200, 100);
+
+  rtc::scoped_refptr<NV12Buffer> scaled_buffer = NV12Buffer::Create(150, 75);
+  scaled_buffer->ScaleFrom(*buf);
+  CheckCrop(*scaled_buffer->ToI420(), 0.0, 0.0, 1.0, 1.0);
+}
+
+TEST(TestNV12Buffer, CropXNotCenter) {
+  rtc::scoped_refptr<NV12Buffer> buf = CreateNV12Gradient(200, 100);
+
+  rtc::scoped_refptr<NV12Buffer> cropped_buffer = NV12Buffer::Create(100, 100);
+  cropped_buffer->CropAndScaleFrom(*buf, 25, 0, 100, 100);
+  CheckCrop(*cropped_buffer->ToI420(), 0.125, 0.0, 0.5, 1.0);
+}
+
+TEST(TestNV12Buffer, CropAndScale16x9) {
+  rtc::scoped_refptr<NV12Buffer> buf = CreateNV12Gradient(640, 480);
+
+  rtc::scoped_refptr<NV12Buffer> scaled_buffer = NV12Buffer::Create(320, 180);
+  scaled_buffer->CropAndScaleFrom(*buf, 0, 60, 640, 360);
+  CheckCrop(*scaled_buffer->ToI420(), 0.0, 0.125, 1.0, 0.75);
+}
+
+TEST(TestEncodedImage, CopiesShareEncodedData) {
+  const uint8_t kData[] = {1, 2, 3, 4};
+  EncodedImage image;
+  image.SetEncodedData(rtc::CopyOnWriteBuffer(kData, sizeof(kData), 16));
+  EXPECT_EQ(sizeof(kData), image._length);
+  EXPECT_EQ(16u, image._size);
+
+  EncodedImage copy = image;
+  EXPECT_EQ(image._buffer, copy._buffer);
+
+  // Reusing the data for the next frame doesn't overwrite the copy.
+  rtc::CopyOnWriteBuffer encoded_data = image.ReleaseEncodedData();
+  EXPECT_EQ(nullptr, image._buffer);
+  EXPECT_EQ(0u, image._length);
+  encoded_data.Clear();
+  encoded_data.AppendData(kData, 2);
+  image.SetEncodedData(std::move(encoded_data));
+  EXPECT_NE(copy._buffer, image._buffer);
+  EXPECT_EQ(0, memcmp(kData, copy._buffer, sizeof(kData)));
+}
+
+TEST(TestEncodedImage, ReusesEncodedDataWithoutCopies) {
+  EncodedImage image;
+  image.SetEncodedData(rtc::CopyOnWriteBuffer(4, 16));
+  const uint8_t* buffer = image._buffer;
+
+  rtc::CopyOnWriteBuffer encoded_data = image.ReleaseEncodedData();
+  encoded_data.Clear();
+  encoded_data.SetSize(8);
+  image.SetEncodedData(std::move(encoded_data));
+  EXPECT_EQ(buffer, image._buffer);
+  EXPECT_EQ(8u, image._length);
+}
+
 }  // namespace webrtc
@@ -11,14 +11,18 @@
 #include <iostream>  // NOLINT
 
 #include "p2p/base/basicpacketsocketfactory.h"
+#include "p2p/base/shardedturnserver.h"
 #include "p2p/base/turnserver.h"
 #include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/networkthreadpool.h"
 #include "rtc_base/optionsfile.h"
 #include "rtc_base/stringencode.h"
 #include "rtc_base/thread.h"
 
 static const char kSoftware[] = "libjingle TurnServer";
 
+// Only reads the file once loaded, so it can be shared by the shards of a
+// ShardedTurnServer.
 class TurnFileAuth : public cricket::TurnAuthInterface {
  public:
   explicit TurnFileAuth(const std::string& path) : file_(path) { file_.Load(); }
@@ -42,8 +46,9 @@ class TurnFileAuth : public cricket::TurnAuthInterface {
 };
 
 int main(int argc, char* argv[]) {
-  if (argc != 5) {
-    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file"
+  if (argc != 5 && argc != 6) {
+    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file "
+                 "[num-threads]"
               << std::endl;
     return 1;
   }
@@ -60,7 +65,38 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  int num_threads = 1;
+  if (argc == 6 && (!rtc::FromString(argv[5], &num_threads) ||
+                    num_threads < 1)) {
+    std::cerr << "Invalid number of threads: " << argv[5] << std::endl;
+    return 1;
+  }
+
   rtc::Thread* main = rtc::Thread::Current();
+  TurnFileAuth auth(argv[4]);
+  if (num_threads > 1) {
+    // Spread the allocations over the threads, which all listen on
+    // |int_addr|.
+    rtc::NetworkThreadPool pool(num_threads);
+    pool.Start();
+    cricket::ShardedTurnServer server(&pool);
+    server.set_realm(argv[3]);
+    server.set_software(kSoftware);
+    server.set_auth_hook(&auth);
+    if (server.AddInternalSocket(int_addr, cricket::PROTO_UDP).IsNil()) {
+      std::cerr << "Failed to create UDP sockets bound at "
+                << int_addr.ToString() << std::endl;
+      return 1;
+    }
+    server.SetExternalAddress(rtc::SocketAddress(ext_addr, 0));
+
+    std::cout << "Listening internally at " << int_addr.ToString() << " on "
+              << num_threads << " threads" << std::endl;
+
+    main->Run();
+    return 0;
+  }
+
   rtc::AsyncUDPSocket* int_socket =
       rtc::AsyncUDPSocket::Create(main->socketserver(), int_addr);
   if (!int_socket) {
@@ -70,7 +106,6 @@ int main(int argc, char* argv[]) {
   }
 
   cricket::TurnServer server(main);
-  TurnFileAuth auth(argv[4]);
   server.set_realm(argv[3]);
   server.set_software(kSoftware);
   server.set_auth_hook(&auth);
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/encoder/delta_encoding.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+uint64_t BitMask(int bit_width) {
+  RTC_DCHECK_GT(bit_width, 0);
+  RTC_DCHECK_LE(bit_width, 64);
+  return bit_width == 64 ? ~uint64_t{0} : (uint64_t{1} << bit_width) - 1;
+}
+
+// Maps the difference |value| - |previous|, taken modulo 2^|bit_width|, to
+// the shortest signed difference, and zigzag encodes that.
+uint64_t ZigzagDelta(uint64_t previous, uint64_t value, int bit_width) {
+  const uint64_t mask = BitMask(bit_width);
+  const uint64_t delta = (value - previous) & mask;
+  const uint64_t sign_bit = uint64_t{1} << (bit_width - 1);
+  // Sign extend the |bit_width| bits wide difference to 64 bits.
+  const int64_t signed_delta =
+      static_cast<int64_t>((delta ^ sign_bit) - sign_bit);
+  return (static_cast<uint64_t>(signed_delta) << 1) ^
+         static_cast<uint64_t>(signed_delta >> 63);
+}
+
+uint64_t ApplyZigzagDelta(uint64_t previous, uint64_t zigzag, int bit_width) {
+  const uint64_t delta = (zigzag >> 1) ^ (0 - (zigzag & 1));
+  return (previous + delta) & BitMask(bit_width);
+}
+
+}  // namespace
+
+void EncodeVarInt(uint64_t value, std::string* output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>(0x80 | (value & 0x7F)));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+bool DecodeVarInt(const std::string& input, size_t* offset, uint64_t* value) {
+  *value = 0;
+  for (size_t bytes_read = 0; bytes_read < 10; ++bytes_read) {
+    if (*offset >= input.size()) {
+      return false;
+    }
+    const uint8_t byte = static_cast<uint8_t>(input[(*offset)++]);
+    *value |= static_cast<uint64_t>(byte & 0x7F) << (7 * bytes_read);
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string EncodeDeltas(absl::optional<uint64_t> base,
+                         const std::vector<absl::optional<uint64_t>>& values,
+                         int bit_width) {
+  std::string output;
+  output.reserve(values.size());
+  uint64_t previous = base.value_or(0);
+  for (const auto& value : values) {
+    if (!value) {
+      output.push_back(0);
+      continue;
+    }
+    RTC_DCHECK_EQ(*value & BitMask(bit_width), *value);
+    EncodeVarInt(ZigzagDelta(previous, *value, bit_width) + 1, &output);
+    previous = *value;
+  }
+  return output;
+}
+
+bool DecodeDeltas(const std::string& input,
+                  absl::optional<uint64_t> base,
+                  int bit_width,
+                  std::vector<absl::optional<uint64_t>>* values) {
+  values->clear();
+  uint64_t previous = base.value_or(0);
+  size_t offset = 0;
+  while (offset < input.size()) {
+    uint64_t varint;
+    if (!DecodeVarInt(input, &offset, &varint)) {
+      return false;
+    }
+    if (varint == 0) {
+      values->push_back(absl::nullopt);
+      continue;
+    }
+    previous = ApplyZigzagDelta(previous, varint - 1, bit_width);
+    values->push_back(previous);
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef LOGGING_RTC_EVENT_LOG_ENCODER_DELTA_ENCODING_H_
+#define LOGGING_RTC_EVENT_LOG_ENCODER_DELTA_ENCODING_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+
+namespace webrtc {
+
+// Appends |value| to |output| as a protobuf-style varint.
+void EncodeVarInt(uint64_t value, std::string* output);
+
+// Reads a varint from |input|, starting at |*offset|, and advances |*offset|
+// past it. Returns false if |input| ends before the varint does.
+bool DecodeVarInt(const std::string& input, size_t* offset, uint64_t* value);
+
+// Encodes |values|, which are at most |bit_width| bits wide, as one varint
+// each. An absent value is written as 0. A present value is written as one
+// more than the zigzag-encoded difference to the previous present value, or
+// to |base| for the first one. The difference wraps around at |bit_width|
+// bits, so that e.g. a sequence number going from 0xffff to 0 costs as little
+// as one going from 0 to 1.
+std::string EncodeDeltas(absl::optional<uint64_t> base,
+                         const std::vector<absl::optional<uint64_t>>& values,
+                         int bit_width);
+
+// Decodes the output of EncodeDeltas() into |values|. Returns false if |input|
+// is malformed.
+bool DecodeDeltas(const std::string& input,
+                  absl::optional<uint64_t> base,
+                  int bit_width,
+                  std::vector<absl::optional<uint64_t>>* values);
+
+}  // namespace webrtc
+
+#endif  // LOGGING_RTC_EVENT_LOG_ENCODER_DELTA_ENCODING_H_
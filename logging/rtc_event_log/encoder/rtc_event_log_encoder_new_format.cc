@@ -0,0 +1,779 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "absl/types/optional.h"
+#include "logging/rtc_event_log/encoder/delta_encoding.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_network_adaptation.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_playout.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_delay_based.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_loss_based.h"
+#include "logging/rtc_event_log/events/rtc_event_probe_cluster_created.h"
+#include "logging/rtc_event_log/events/rtc_event_probe_result_failure.h"
+#include "logging/rtc_event_log/events/rtc_event_probe_result_success.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_outgoing.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
+#include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor_config.h"
+#include "modules/remote_bitrate_estimator/include/bwe_defines.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/app.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/extended_jitter_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/psfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/ignore_wundef.h"
+
+#ifdef ENABLE_RTC_EVENT_LOG
+
+// *.pb.h files are generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log2.pb.h"
+#else
+#include "logging/rtc_event_log/rtc_event_log2.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+namespace {
+rtclog2::DelayBasedBweUpdates::DetectorState ConvertDetectorState(
+    BandwidthUsage state) {
+  switch (state) {
+    case BandwidthUsage::kBwNormal:
+      return rtclog2::DelayBasedBweUpdates::BWE_NORMAL;
+    case BandwidthUsage::kBwUnderusing:
+      return rtclog2::DelayBasedBweUpdates::BWE_UNDERUSING;
+    case BandwidthUsage::kBwOverusing:
+      return rtclog2::DelayBasedBweUpdates::BWE_OVERUSING;
+    case BandwidthUsage::kLast:
+      RTC_NOTREACHED();
+  }
+  RTC_NOTREACHED();
+  return rtclog2::DelayBasedBweUpdates::BWE_NORMAL;
+}
+
+rtclog2::BweProbeResultFailure::FailureReason ConvertProbeFailureReason(
+    ProbeFailureReason failure_reason) {
+  switch (failure_reason) {
+    case ProbeFailureReason::kInvalidSendReceiveInterval:
+      return rtclog2::BweProbeResultFailure::INVALID_SEND_RECEIVE_INTERVAL;
+    case ProbeFailureReason::kInvalidSendReceiveRatio:
+      return rtclog2::BweProbeResultFailure::INVALID_SEND_RECEIVE_RATIO;
+    case ProbeFailureReason::kTimeout:
+      return rtclog2::BweProbeResultFailure::TIMEOUT;
+    case ProbeFailureReason::kLast:
+      RTC_NOTREACHED();
+  }
+  RTC_NOTREACHED();
+  return rtclog2::BweProbeResultFailure::UNKNOWN;
+}
+
+// Returns |packet| without the blocks that we don't log, sender descriptions,
+// application defined messages and blocks of unknown type, which may hold
+// user data.
+std::string RemoveNonWhitelistedRtcpBlocks(const rtc::Buffer& packet) {
+  rtcp::CommonHeader header;
+  const uint8_t* block_begin = packet.data();
+  const uint8_t* packet_end = packet.data() + packet.size();
+  std::string output;
+  while (block_begin < packet_end) {
+    if (!header.Parse(block_begin, packet_end - block_begin)) {
+      break;  // Incorrect message header.
+    }
+    const uint8_t* next_block = header.NextPacket();
+    const size_t block_size = next_block - block_begin;
+    switch (header.type()) {
+      case rtcp::Bye::kPacketType:
+      case rtcp::ExtendedJitterReport::kPacketType:
+      case rtcp::ExtendedReports::kPacketType:
+      case rtcp::Psfb::kPacketType:
+      case rtcp::ReceiverReport::kPacketType:
+      case rtcp::Rtpfb::kPacketType:
+      case rtcp::SenderReport::kPacketType:
+        output.append(reinterpret_cast<const char*>(block_begin), block_size);
+        break;
+      case rtcp::App::kPacketType:
+      case rtcp::Sdes::kPacketType:
+      default:
+        break;
+    }
+    block_begin = next_block;
+  }
+  return output;
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetTimestampMs(const EventType& event) {
+  return static_cast<uint64_t>(event.timestamp_us_ / 1000);
+}
+
+// Returns the values that |value_of| returns for the events of |batch| after
+// the first.
+template <typename EventType, typename Function>
+std::vector<absl::optional<uint64_t>> GetDeltaValues(
+    const std::vector<const EventType*>& batch,
+    Function value_of) {
+  std::vector<absl::optional<uint64_t>> values;
+  values.reserve(batch.size() - 1);
+  for (size_t i = 1; i < batch.size(); ++i) {
+    values.push_back(value_of(*batch[i]));
+  }
+  return values;
+}
+
+// Encodes the values that |value_of| returns for the events of |batch| after
+// the first, which is the base. Returns an empty string, for the field to be
+// left out, if the values of all the events are the same.
+template <typename EventType, typename Function>
+std::string EncodeBatchDeltas(const std::vector<const EventType*>& batch,
+                              Function value_of,
+                              int bit_width) {
+  RTC_DCHECK(!batch.empty());
+  const absl::optional<uint64_t> base = value_of(*batch[0]);
+  const std::vector<absl::optional<uint64_t>> values =
+      GetDeltaValues(batch, value_of);
+  if (std::all_of(values.begin(), values.end(),
+                  [&base](const absl::optional<uint64_t>& value) {
+                    return value == base;
+                  })) {
+    return std::string();
+  }
+  return EncodeDeltas(base, values, bit_width);
+}
+
+// Unlike those of the other fields, the timestamp deltas are always written,
+// so that they give the number of events in the batch.
+template <typename EventType>
+std::string EncodeTimestampDeltas(const std::vector<const EventType*>& batch) {
+  RTC_DCHECK(!batch.empty());
+  return EncodeDeltas(GetTimestampMs(*batch[0]),
+                      GetDeltaValues(batch, GetTimestampMs<EventType>), 64);
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetMarker(const EventType& event) {
+  return event.header_.Marker();
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetPayloadType(const EventType& event) {
+  return event.header_.PayloadType();
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetSequenceNumber(const EventType& event) {
+  return event.header_.SequenceNumber();
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetRtpTimestamp(const EventType& event) {
+  return event.header_.Timestamp();
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetSsrc(const EventType& event) {
+  return event.header_.Ssrc();
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetPacketSize(const EventType& event) {
+  return event.packet_length_;
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetHeaderSize(const EventType& event) {
+  return event.header_.headers_size();
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetPaddingSize(const EventType& event) {
+  return event.header_.padding_size();
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetTransmissionTimeOffset(const EventType& event) {
+  int32_t offset;
+  if (!event.header_.template GetExtension<TransmissionOffset>(&offset))
+    return absl::nullopt;
+  return static_cast<uint32_t>(offset);
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetAbsoluteSendTime(const EventType& event) {
+  uint32_t send_time;
+  if (!event.header_.template GetExtension<AbsoluteSendTime>(&send_time))
+    return absl::nullopt;
+  return send_time;
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetTransportSequenceNumber(const EventType& event) {
+  uint16_t sequence_number;
+  if (!event.header_.template GetExtension<TransportSequenceNumber>(
+          &sequence_number)) {
+    return absl::nullopt;
+  }
+  return sequence_number;
+}
+
+template <typename EventType>
+absl::optional<uint64_t> GetAudioLevel(const EventType& event) {
+  bool voice_activity;
+  uint8_t audio_level;
+  if (!event.header_.template GetExtension<AudioLevel>(&voice_activity,
+                                                       &audio_level)) {
+    return absl::nullopt;
+  }
+  return (voice_activity ? 0x80 : 0) | audio_level;
+}
+
+template <typename EventType>
+std::string EncodeCsrcDeltas(const std::vector<const EventType*>& batch) {
+  std::string output;
+  bool changed = false;
+  std::vector<uint32_t> previous = batch[0]->header_.Csrcs();
+  for (size_t i = 1; i < batch.size(); ++i) {
+    std::vector<uint32_t> csrcs = batch[i]->header_.Csrcs();
+    if (csrcs == previous) {
+      output.push_back(0);
+      continue;
+    }
+    changed = true;
+    EncodeVarInt(csrcs.size() + 1, &output);
+    for (uint32_t csrc : csrcs) {
+      for (int shift = 0; shift < 32; shift += 8) {
+        output.push_back(static_cast<char>(csrc >> shift));
+      }
+    }
+    previous = std::move(csrcs);
+  }
+  return changed ? output : std::string();
+}
+
+// Writes the packets of |batch|, which all have the same SSRC, to
+// |proto_batch|, which is an IncomingRtpPackets or an OutgoingRtpPackets.
+template <typename EventType, typename ProtoType>
+void EncodeRtpPacketBatch(const std::vector<const EventType*>& batch,
+                          ProtoType* proto_batch) {
+  RTC_DCHECK(!batch.empty());
+  const EventType& base_event = *batch[0];
+  const RtpPacket& base = base_event.header_;
+  proto_batch->set_timestamp_ms(base_event.timestamp_us_ / 1000);
+  proto_batch->set_marker(base.Marker());
+  proto_batch->set_payload_type(base.PayloadType());
+  proto_batch->set_sequence_number(base.SequenceNumber());
+  proto_batch->set_rtp_timestamp(base.Timestamp());
+  proto_batch->set_ssrc(base.Ssrc());
+  for (uint32_t csrc : base.Csrcs()) {
+    proto_batch->add_csrcs(csrc);
+  }
+  proto_batch->set_packet_size(base_event.packet_length_);
+  proto_batch->set_header_size(base.headers_size());
+  if (base.padding_size() > 0) {
+    proto_batch->set_padding_size(base.padding_size());
+  }
+  absl::optional<uint64_t> value = GetTransmissionTimeOffset(base_event);
+  if (value) {
+    proto_batch->set_transmission_time_offset(static_cast<int32_t>(*value));
+  }
+  value = GetAbsoluteSendTime(base_event);
+  if (value) {
+    proto_batch->set_absolute_send_time(*value);
+  }
+  value = GetTransportSequenceNumber(base_event);
+  if (value) {
+    proto_batch->set_transport_sequence_number(*value);
+  }
+  value = GetAudioLevel(base_event);
+  if (value) {
+    proto_batch->set_audio_level(*value);
+  }
+
+  if (batch.size() == 1) {
+    return;
+  }
+
+  proto_batch->set_timestamp_deltas_ms(EncodeTimestampDeltas(batch));
+  std::string deltas = EncodeBatchDeltas(batch, GetMarker<EventType>, 1);
+  if (!deltas.empty()) {
+    proto_batch->set_marker_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetPayloadType<EventType>, 7);
+  if (!deltas.empty()) {
+    proto_batch->set_payload_type_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetSequenceNumber<EventType>, 16);
+  if (!deltas.empty()) {
+    proto_batch->set_sequence_number_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetRtpTimestamp<EventType>, 32);
+  if (!deltas.empty()) {
+    proto_batch->set_rtp_timestamp_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetSsrc<EventType>, 32);
+  if (!deltas.empty()) {
+    proto_batch->set_ssrc_deltas(deltas);
+  }
+  deltas = EncodeCsrcDeltas(batch);
+  if (!deltas.empty()) {
+    proto_batch->set_csrcs_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetPacketSize<EventType>, 32);
+  if (!deltas.empty()) {
+    proto_batch->set_packet_size_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetHeaderSize<EventType>, 32);
+  if (!deltas.empty()) {
+    proto_batch->set_header_size_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetPaddingSize<EventType>, 8);
+  if (!deltas.empty()) {
+    proto_batch->set_padding_size_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetTransmissionTimeOffset<EventType>, 32);
+  if (!deltas.empty()) {
+    proto_batch->set_transmission_time_offset_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetAbsoluteSendTime<EventType>, 24);
+  if (!deltas.empty()) {
+    proto_batch->set_absolute_send_time_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetTransportSequenceNumber<EventType>, 16);
+  if (!deltas.empty()) {
+    proto_batch->set_transport_sequence_number_deltas(deltas);
+  }
+  deltas = EncodeBatchDeltas(batch, GetAudioLevel<EventType>, 8);
+  if (!deltas.empty()) {
+    proto_batch->set_audio_level_deltas(deltas);
+  }
+}
+
+// Writes the packets of |batch| to |proto_batch|, which is an
+// IncomingRtcpPackets or an OutgoingRtcpPackets.
+template <typename EventType, typename ProtoType>
+void EncodeRtcpPacketBatch(const std::vector<const EventType*>& batch,
+                           ProtoType* proto_batch) {
+  RTC_DCHECK(!batch.empty());
+  proto_batch->set_timestamp_ms(batch[0]->timestamp_us_ / 1000);
+  proto_batch->set_raw_packet(
+      RemoveNonWhitelistedRtcpBlocks(batch[0]->packet_));
+  if (batch.size() == 1) {
+    return;
+  }
+
+  proto_batch->set_timestamp_deltas_ms(EncodeTimestampDeltas(batch));
+  std::string packets;
+  for (size_t i = 1; i < batch.size(); ++i) {
+    std::string packet = RemoveNonWhitelistedRtcpBlocks(batch[i]->packet_);
+    EncodeVarInt(packet.size(), &packets);
+    packets += packet;
+  }
+  proto_batch->set_raw_packet_deltas(packets);
+}
+
+}  // namespace
+
+std::string RtcEventLogEncoderNewFormat::EncodeLogStart(int64_t timestamp_us) {
+  rtclog2::EventStream event_stream;
+  event_stream.set_version(2);
+  event_stream.add_begin_log_events()->set_timestamp_ms(timestamp_us / 1000);
+  return event_stream.SerializeAsString();
+}
+
+std::string RtcEventLogEncoderNewFormat::EncodeLogEnd(int64_t timestamp_us) {
+  rtclog2::EventStream event_stream;
+  event_stream.add_end_log_events()->set_timestamp_ms(timestamp_us / 1000);
+  return event_stream.SerializeAsString();
+}
+
+std::string RtcEventLogEncoderNewFormat::EncodeBatch(
+    std::deque<std::unique_ptr<RtcEvent>>::const_iterator begin,
+    std::deque<std::unique_ptr<RtcEvent>>::const_iterator end) {
+  std::string encoded_output;
+  std::vector<const RtcEventAudioNetworkAdaptation*>
+      audio_network_adaptation_events;
+  std::vector<const RtcEventAudioPlayout*> audio_playout_events;
+  std::vector<const RtcEventBweUpdateDelayBased*> bwe_delay_based_updates;
+  std::vector<const RtcEventBweUpdateLossBased*> bwe_loss_based_updates;
+  std::vector<const RtcEventProbeClusterCreated*> probe_cluster_created_events;
+  std::vector<const RtcEventProbeResultFailure*> probe_result_failure_events;
+  std::vector<const RtcEventProbeResultSuccess*> probe_result_success_events;
+  std::vector<const RtcEventRtcpPacketIncoming*> incoming_rtcp_packets;
+  std::vector<const RtcEventRtcpPacketOutgoing*> outgoing_rtcp_packets;
+  std::map<uint32_t, std::vector<const RtcEventRtpPacketIncoming*>>
+      incoming_rtp_packets;
+  std::map<uint32_t, std::vector<const RtcEventRtpPacketOutgoing*>>
+      outgoing_rtp_packets;
+
+  for (auto it = begin; it != end; ++it) {
+    RTC_CHECK(it->get() != nullptr);
+    const RtcEvent& event = **it;
+    switch (event.GetType()) {
+      case RtcEvent::Type::AlrStateEvent:
+      case RtcEvent::Type::AudioReceiveStreamConfig:
+      case RtcEvent::Type::AudioSendStreamConfig:
+      case RtcEvent::Type::IceCandidatePairConfig:
+      case RtcEvent::Type::IceCandidatePairEvent:
+      case RtcEvent::Type::VideoReceiveStreamConfig:
+      case RtcEvent::Type::VideoSendStreamConfig:
+        encoded_output += legacy_encoder_.EncodeBatch(it, std::next(it));
+        break;
+      case RtcEvent::Type::AudioNetworkAdaptation:
+        audio_network_adaptation_events.push_back(
+            static_cast<const RtcEventAudioNetworkAdaptation*>(&event));
+        break;
+      case RtcEvent::Type::AudioPlayout:
+        audio_playout_events.push_back(
+            static_cast<const RtcEventAudioPlayout*>(&event));
+        break;
+      case RtcEvent::Type::BweUpdateDelayBased:
+        bwe_delay_based_updates.push_back(
+            static_cast<const RtcEventBweUpdateDelayBased*>(&event));
+        break;
+      case RtcEvent::Type::BweUpdateLossBased:
+        bwe_loss_based_updates.push_back(
+            static_cast<const RtcEventBweUpdateLossBased*>(&event));
+        break;
+      case RtcEvent::Type::ProbeClusterCreated:
+        probe_cluster_created_events.push_back(
+            static_cast<const RtcEventProbeClusterCreated*>(&event));
+        break;
+      case RtcEvent::Type::ProbeResultFailure:
+        probe_result_failure_events.push_back(
+            static_cast<const RtcEventProbeResultFailure*>(&event));
+        break;
+      case RtcEvent::Type::ProbeResultSuccess:
+        probe_result_success_events.push_back(
+            static_cast<const RtcEventProbeResultSuccess*>(&event));
+        break;
+      case RtcEvent::Type::RtcpPacketIncoming:
+        incoming_rtcp_packets.push_back(
+            static_cast<const RtcEventRtcpPacketIncoming*>(&event));
+        break;
+      case RtcEvent::Type::RtcpPacketOutgoing:
+        outgoing_rtcp_packets.push_back(
+            static_cast<const RtcEventRtcpPacketOutgoing*>(&event));
+        break;
+      case RtcEvent::Type::RtpPacketIncoming: {
+        auto* rtp_event = static_cast<const RtcEventRtpPacketIncoming*>(&event);
+        incoming_rtp_packets[rtp_event->header_.Ssrc()].push_back(rtp_event);
+        break;
+      }
+      case RtcEvent::Type::RtpPacketOutgoing: {
+        auto* rtp_event = static_cast<const RtcEventRtpPacketOutgoing*>(&event);
+        outgoing_rtp_packets[rtp_event->header_.Ssrc()].push_back(rtp_event);
+        break;
+      }
+    }
+  }
+
+  rtclog2::EventStream event_stream;
+  EncodeAudioNetworkAdaptation(audio_network_adaptation_events, &event_stream);
+  EncodeAudioPlayout(audio_playout_events, &event_stream);
+  EncodeBweUpdateDelayBased(bwe_delay_based_updates, &event_stream);
+  EncodeBweUpdateLossBased(bwe_loss_based_updates, &event_stream);
+  EncodeProbeClusterCreated(probe_cluster_created_events, &event_stream);
+  EncodeProbeResultFailure(probe_result_failure_events, &event_stream);
+  EncodeProbeResultSuccess(probe_result_success_events, &event_stream);
+  EncodeRtcpPacketIncoming(incoming_rtcp_packets, &event_stream);
+  EncodeRtcpPacketOutgoing(outgoing_rtcp_packets, &event_stream);
+  EncodeRtpPacketIncoming(incoming_rtp_packets, &event_stream);
+  EncodeRtpPacketOutgoing(outgoing_rtp_packets, &event_stream);
+  encoded_output += event_stream.SerializeAsString();
+  return encoded_output;
+}
+
+void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
+    const std::vector<const RtcEventAudioNetworkAdaptation*>& batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+
+  // The fields are all optional, and a batch only has a base value for the
+  // fields that the first event has.
+  auto bitrate_bps = [](const RtcEventAudioNetworkAdaptation& event) {
+    absl::optional<uint64_t> value;
+    if (event.config_->bitrate_bps)
+      value = static_cast<uint32_t>(*event.config_->bitrate_bps);
+    return value;
+  };
+  auto frame_length_ms = [](const RtcEventAudioNetworkAdaptation& event) {
+    absl::optional<uint64_t> value;
+    if (event.config_->frame_length_ms)
+      value = static_cast<uint32_t>(*event.config_->frame_length_ms);
+    return value;
+  };
+  auto uplink_packet_loss_fraction =
+      [](const RtcEventAudioNetworkAdaptation& event) {
+        absl::optional<uint64_t> value;
+        if (event.config_->uplink_packet_loss_fraction) {
+          // Delta encoded as the bits of the float.
+          uint32_t bits;
+          const float fraction = *event.config_->uplink_packet_loss_fraction;
+          static_assert(sizeof(bits) == sizeof(fraction), "");
+          memcpy(&bits, &fraction, sizeof(bits));
+          value = bits;
+        }
+        return value;
+      };
+  auto enable_fec = [](const RtcEventAudioNetworkAdaptation& event) {
+    absl::optional<uint64_t> value;
+    if (event.config_->enable_fec)
+      value = *event.config_->enable_fec;
+    return value;
+  };
+  auto enable_dtx = [](const RtcEventAudioNetworkAdaptation& event) {
+    absl::optional<uint64_t> value;
+    if (event.config_->enable_dtx)
+      value = *event.config_->enable_dtx;
+    return value;
+  };
+  auto num_channels = [](const RtcEventAudioNetworkAdaptation& event) {
+    absl::optional<uint64_t> value;
+    if (event.config_->num_channels)
+      value = *event.config_->num_channels;
+    return value;
+  };
+
+  rtclog2::AudioNetworkAdaptations* proto_batch =
+      event_stream->add_audio_network_adaptations();
+  const AudioEncoderRuntimeConfig& base = *batch[0]->config_;
+  proto_batch->set_timestamp_ms(batch[0]->timestamp_us_ / 1000);
+  if (base.bitrate_bps)
+    proto_batch->set_bitrate_bps(*base.bitrate_bps);
+  if (base.frame_length_ms)
+    proto_batch->set_frame_length_ms(*base.frame_length_ms);
+  if (base.uplink_packet_loss_fraction) {
+    proto_batch->set_uplink_packet_loss_fraction(
+        *base.uplink_packet_loss_fraction);
+  }
+  if (base.enable_fec)
+    proto_batch->set_enable_fec(*base.enable_fec);
+  if (base.enable_dtx)
+    proto_batch->set_enable_dtx(*base.enable_dtx);
+  if (base.num_channels)
+    proto_batch->set_num_channels(*base.num_channels);
+
+  if (batch.size() == 1)
+    return;
+
+  proto_batch->set_timestamp_deltas_ms(EncodeTimestampDeltas(batch));
+  std::string deltas = EncodeBatchDeltas(batch, bitrate_bps, 32);
+  if (!deltas.empty())
+    proto_batch->set_bitrate_deltas_bps(deltas);
+  deltas = EncodeBatchDeltas(batch, frame_length_ms, 32);
+  if (!deltas.empty())
+    proto_batch->set_frame_length_deltas_ms(deltas);
+  deltas = EncodeBatchDeltas(batch, uplink_packet_loss_fraction, 32);
+  if (!deltas.empty())
+    proto_batch->set_uplink_packet_loss_fraction_deltas(deltas);
+  deltas = EncodeBatchDeltas(batch, enable_fec, 1);
+  if (!deltas.empty())
+    proto_batch->set_enable_fec_deltas(deltas);
+  deltas = EncodeBatchDeltas(batch, enable_dtx, 1);
+  if (!deltas.empty())
+    proto_batch->set_enable_dtx_deltas(deltas);
+  deltas = EncodeBatchDeltas(batch, num_channels, 32);
+  if (!deltas.empty())
+    proto_batch->set_num_channels_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeAudioPlayout(
+    const std::vector<const RtcEventAudioPlayout*>& batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+
+  rtclog2::AudioPlayoutEvents* proto_batch =
+      event_stream->add_audio_playout_events();
+  proto_batch->set_timestamp_ms(batch[0]->timestamp_us_ / 1000);
+  proto_batch->set_local_ssrc(batch[0]->ssrc_);
+  if (batch.size() == 1)
+    return;
+
+  proto_batch->set_timestamp_deltas_ms(EncodeTimestampDeltas(batch));
+  std::string deltas = EncodeBatchDeltas(
+      batch,
+      [](const RtcEventAudioPlayout& event) -> absl::optional<uint64_t> {
+        return event.ssrc_;
+      },
+      32);
+  if (!deltas.empty())
+    proto_batch->set_local_ssrc_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeBweUpdateDelayBased(
+    const std::vector<const RtcEventBweUpdateDelayBased*>& batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+
+  rtclog2::DelayBasedBweUpdates* proto_batch =
+      event_stream->add_delay_based_bwe_updates();
+  proto_batch->set_timestamp_ms(batch[0]->timestamp_us_ / 1000);
+  proto_batch->set_bitrate_bps(batch[0]->bitrate_bps_);
+  proto_batch->set_detector_state(
+      ConvertDetectorState(batch[0]->detector_state_));
+  if (batch.size() == 1)
+    return;
+
+  proto_batch->set_timestamp_deltas_ms(EncodeTimestampDeltas(batch));
+  std::string deltas = EncodeBatchDeltas(
+      batch,
+      [](const RtcEventBweUpdateDelayBased& event) -> absl::optional<uint64_t> {
+        return static_cast<uint32_t>(event.bitrate_bps_);
+      },
+      32);
+  if (!deltas.empty())
+    proto_batch->set_bitrate_deltas_bps(deltas);
+  deltas = EncodeBatchDeltas(
+      batch,
+      [](const RtcEventBweUpdateDelayBased& event) -> absl::optional<uint64_t> {
+        return ConvertDetectorState(event.detector_state_);
+      },
+      32);
+  if (!deltas.empty())
+    proto_batch->set_detector_state_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeBweUpdateLossBased(
+    const std::vector<const RtcEventBweUpdateLossBased*>& batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+
+  rtclog2::LossBasedBweUpdates* proto_batch =
+      event_stream->add_loss_based_bwe_updates();
+  proto_batch->set_timestamp_ms(batch[0]->timestamp_us_ / 1000);
+  proto_batch->set_bitrate_bps(batch[0]->bitrate_bps_);
+  proto_batch->set_fraction_loss(batch[0]->fraction_loss_);
+  proto_batch->set_total_packets(batch[0]->total_packets_);
+  if (batch.size() == 1)
+    return;
+
+  proto_batch->set_timestamp_deltas_ms(EncodeTimestampDeltas(batch));
+  std::string deltas = EncodeBatchDeltas(
+      batch,
+      [](const RtcEventBweUpdateLossBased& event) -> absl::optional<uint64_t> {
+        return static_cast<uint32_t>(event.bitrate_bps_);
+      },
+      32);
+  if (!deltas.empty())
+    proto_batch->set_bitrate_deltas_bps(deltas);
+  deltas = EncodeBatchDeltas(
+      batch,
+      [](const RtcEventBweUpdateLossBased& event) -> absl::optional<uint64_t> {
+        return event.fraction_loss_;
+      },
+      8);
+  if (!deltas.empty())
+    proto_batch->set_fraction_loss_deltas(deltas);
+  deltas = EncodeBatchDeltas(
+      batch,
+      [](const RtcEventBweUpdateLossBased& event) -> absl::optional<uint64_t> {
+        return static_cast<uint32_t>(event.total_packets_);
+      },
+      32);
+  if (!deltas.empty())
+    proto_batch->set_total_packets_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeProbeClusterCreated(
+    const std::vector<const RtcEventProbeClusterCreated*>& batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventProbeClusterCreated* event : batch) {
+    rtclog2::BweProbeCluster* proto_event = event_stream->add_probe_clusters();
+    proto_event->set_timestamp_ms(event->timestamp_us_ / 1000);
+    proto_event->set_id(event->id_);
+    proto_event->set_bitrate_bps(event->bitrate_bps_);
+    proto_event->set_min_packets(event->min_probes_);
+    proto_event->set_min_bytes(event->min_bytes_);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeProbeResultFailure(
+    const std::vector<const RtcEventProbeResultFailure*>& batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventProbeResultFailure* event : batch) {
+    rtclog2::BweProbeResultFailure* proto_event =
+        event_stream->add_probe_failure();
+    proto_event->set_timestamp_ms(event->timestamp_us_ / 1000);
+    proto_event->set_id(event->id_);
+    proto_event->set_failure(ConvertProbeFailureReason(event->failure_reason_));
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeProbeResultSuccess(
+    const std::vector<const RtcEventProbeResultSuccess*>& batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventProbeResultSuccess* event : batch) {
+    rtclog2::BweProbeResultSuccess* proto_event =
+        event_stream->add_probe_success();
+    proto_event->set_timestamp_ms(event->timestamp_us_ / 1000);
+    proto_event->set_id(event->id_);
+    proto_event->set_bitrate_bps(event->bitrate_bps_);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtcpPacketIncoming(
+    const std::vector<const RtcEventRtcpPacketIncoming*>& batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+  EncodeRtcpPacketBatch(batch, event_stream->add_incoming_rtcp_packets());
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtcpPacketOutgoing(
+    const std::vector<const RtcEventRtcpPacketOutgoing*>& batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+  EncodeRtcpPacketBatch(batch, event_stream->add_outgoing_rtcp_packets());
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtpPacketIncoming(
+    const std::map<uint32_t, std::vector<const RtcEventRtpPacketIncoming*>>&
+        batch,
+    rtclog2::EventStream* event_stream) {
+  for (const auto& kv : batch) {
+    EncodeRtpPacketBatch(kv.second, event_stream->add_incoming_rtp_packets());
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtpPacketOutgoing(
+    const std::map<uint32_t, std::vector<const RtcEventRtpPacketOutgoing*>>&
+        batch,
+    rtclog2::EventStream* event_stream) {
+  // TODO(terelius): The probe cluster ID isn't parsed, so it isn't written.
+  for (const auto& kv : batch) {
+    EncodeRtpPacketBatch(kv.second, event_stream->add_outgoing_rtp_packets());
+  }
+}
+
+}  // namespace webrtc
+
+#endif  // ENABLE_RTC_EVENT_LOG
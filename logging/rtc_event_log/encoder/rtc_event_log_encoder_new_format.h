@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef LOGGING_RTC_EVENT_LOG_ENCODER_RTC_EVENT_LOG_ENCODER_NEW_FORMAT_H_
+#define LOGGING_RTC_EVENT_LOG_ENCODER_RTC_EVENT_LOG_ENCODER_NEW_FORMAT_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+
+#if defined(ENABLE_RTC_EVENT_LOG)
+
+namespace webrtc {
+
+namespace rtclog2 {
+class EventStream;  // Auto-generated from protobuf.
+}  // namespace rtclog2
+
+class RtcEventAudioNetworkAdaptation;
+class RtcEventAudioPlayout;
+class RtcEventBweUpdateDelayBased;
+class RtcEventBweUpdateLossBased;
+class RtcEventProbeClusterCreated;
+class RtcEventProbeResultFailure;
+class RtcEventProbeResultSuccess;
+class RtcEventRtcpPacketIncoming;
+class RtcEventRtcpPacketOutgoing;
+class RtcEventRtpPacketIncoming;
+class RtcEventRtpPacketOutgoing;
+
+// Encodes events in the format of rtc_event_log2.proto. The events of each
+// type in a batch are written together, with the fields of all but the first
+// event delta encoded, and the RTP packets additionally grouped by SSRC, so
+// that e.g. consecutive sequence numbers and timestamps take about a byte
+// each.
+class RtcEventLogEncoderNewFormat final : public RtcEventLogEncoder {
+ public:
+  ~RtcEventLogEncoderNewFormat() override = default;
+
+  std::string EncodeLogStart(int64_t timestamp_us) override;
+  std::string EncodeLogEnd(int64_t timestamp_us) override;
+
+  std::string EncodeBatch(
+      std::deque<std::unique_ptr<RtcEvent>>::const_iterator begin,
+      std::deque<std::unique_ptr<RtcEvent>>::const_iterator end) override;
+
+ private:
+  // Encoding entry-point for the batches of the various RtcEvent subclasses.
+  void EncodeAudioNetworkAdaptation(
+      const std::vector<const RtcEventAudioNetworkAdaptation*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeAudioPlayout(const std::vector<const RtcEventAudioPlayout*>& batch,
+                          rtclog2::EventStream* event_stream);
+  void EncodeBweUpdateDelayBased(
+      const std::vector<const RtcEventBweUpdateDelayBased*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeBweUpdateLossBased(
+      const std::vector<const RtcEventBweUpdateLossBased*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeProbeClusterCreated(
+      const std::vector<const RtcEventProbeClusterCreated*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeProbeResultFailure(
+      const std::vector<const RtcEventProbeResultFailure*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeProbeResultSuccess(
+      const std::vector<const RtcEventProbeResultSuccess*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeRtcpPacketIncoming(
+      const std::vector<const RtcEventRtcpPacketIncoming*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeRtcpPacketOutgoing(
+      const std::vector<const RtcEventRtcpPacketOutgoing*>& batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeRtpPacketIncoming(
+      const std::map<uint32_t, std::vector<const RtcEventRtpPacketIncoming*>>&
+          batch,
+      rtclog2::EventStream* event_stream);
+  void EncodeRtpPacketOutgoing(
+      const std::map<uint32_t, std::vector<const RtcEventRtpPacketOutgoing*>>&
+          batch,
+      rtclog2::EventStream* event_stream);
+
+  // The stream configs and the ALR and ICE events, which rtc_event_log2.proto
+  // can't describe yet, are written as events of the legacy format, which the
+  // new format can hold.
+  RtcEventLogEncoderLegacy legacy_encoder_;
+};
+
+}  // namespace webrtc
+
+#endif  // ENABLE_RTC_EVENT_LOG
+
+#endif  // LOGGING_RTC_EVENT_LOG_ENCODER_RTC_EVENT_LOG_ENCODER_NEW_FORMAT_H_
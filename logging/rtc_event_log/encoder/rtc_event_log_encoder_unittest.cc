@@ -11,9 +11,11 @@
 #include <deque>
 #include <limits>
 #include <string>
+#include <tuple>
 
 #include "absl/memory/memory.h"
 #include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
 #include "logging/rtc_event_log/events/rtc_event_alr_state.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_network_adaptation.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_playout.h"
@@ -30,24 +32,45 @@
 #include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
 #include "logging/rtc_event_log/events/rtc_event_video_receive_stream_config.h"
 #include "logging/rtc_event_log/events/rtc_event_video_send_stream_config.h"
+#include "logging/rtc_event_log/rtc_event_log.h"
 #include "logging/rtc_event_log/rtc_event_log_parser_new.h"
 #include "logging/rtc_event_log/rtc_event_log_unittest_helper.h"
 #include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor_config.h"
 #include "modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "rtc_base/fakeclock.h"
 #include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
+namespace {
+
+std::unique_ptr<RtcEventLogEncoder> CreateEncoder(
+    RtcEventLog::EncodingType type) {
+  switch (type) {
+    case RtcEventLog::EncodingType::Legacy:
+      return absl::make_unique<RtcEventLogEncoderLegacy>();
+    case RtcEventLog::EncodingType::NewFormat:
+      return absl::make_unique<RtcEventLogEncoderNewFormat>();
+  }
+  RTC_NOTREACHED();
+  return nullptr;
+}
 
+}  // namespace
 
-class RtcEventLogEncoderTest : public testing::TestWithParam<int> {
+class RtcEventLogEncoderTest
+    : public testing::TestWithParam<
+          std::tuple<int /* seed */, RtcEventLog::EncodingType>> {
  protected:
   RtcEventLogEncoderTest()
-      : encoder_(new RtcEventLogEncoderLegacy),
-        seed_(GetParam()),
+      : encoder_(CreateEncoder(std::get<1>(GetParam()))),
+        seed_(std::get<0>(GetParam())),
         prng_(seed_),
-        gen_(seed_ * 880001UL) {}
+        gen_(seed_ * 880001UL) {
+    // The new format stores timestamps with millisecond precision.
+    fake_clock_.SetTimeMicros(prng_.Rand<uint32_t>() * int64_t{1000});
+  }
   ~RtcEventLogEncoderTest() override = default;
 
   // ANA events have some optional fields, so we want to make sure that we get
@@ -56,9 +79,8 @@ class RtcEventLogEncoderTest : public testing::TestWithParam<int> {
   void TestRtcEventAudioNetworkAdaptation(
       std::unique_ptr<AudioEncoderRuntimeConfig> runtime_config);
 
+  rtc::ScopedFakeClock fake_clock_;
   std::deque<std::unique_ptr<RtcEvent>> history_;
-  // TODO(eladalon): Once we have more than one possible encoder, parameterize
-  // encoder selection.
   std::unique_ptr<RtcEventLogEncoder> encoder_;
   ParsedRtcEventLogNew parsed_log_;
   const uint64_t seed_;
@@ -407,6 +429,79 @@ TEST_P(RtcEventLogEncoderTest, RtcEventRtpPacketOutgoing) {
       test::VerifyLoggedRtpPacketOutgoing(*event, stream.outgoing_packets[0]));
 }
 
+TEST_P(RtcEventLogEncoderTest, RtcEventRtpPacketIncomingBatch) {
+  const uint32_t ssrcs[] = {prng_.Rand<uint32_t>(), prng_.Rand<uint32_t>()};
+  RtpHeaderExtensionMap extension_map;
+  std::vector<std::unique_ptr<RtcEventRtpPacketIncoming>> events;
+  for (int i = 0; i < 20; ++i) {
+    fake_clock_.AdvanceTimeMicros(prng_.Rand(0, 30) * 1000);
+    events.push_back(gen_.NewRtpPacketIncoming(ssrcs[i % 2], extension_map));
+    history_.push_back(events.back()->Copy());
+  }
+
+  std::string encoded = encoder_->EncodeBatch(history_.begin(), history_.end());
+  ASSERT_TRUE(parsed_log_.ParseString(encoded));
+  const auto& incoming_rtp_packets_by_ssrc =
+      parsed_log_.incoming_rtp_packets_by_ssrc();
+
+  ASSERT_EQ(incoming_rtp_packets_by_ssrc.size(), 2u);
+  for (const auto& stream : incoming_rtp_packets_by_ssrc) {
+    const size_t index = stream.ssrc == ssrcs[0] ? 0 : 1;
+    ASSERT_EQ(stream.ssrc, ssrcs[index]);
+    ASSERT_EQ(stream.incoming_packets.size(), 10u);
+    for (size_t i = 0; i < stream.incoming_packets.size(); ++i) {
+      EXPECT_TRUE(test::VerifyLoggedRtpPacketIncoming(
+          *events[2 * i + index], stream.incoming_packets[i]));
+    }
+  }
+}
+
+TEST_P(RtcEventLogEncoderTest, RtcEventRtpPacketOutgoingBatch) {
+  const uint32_t ssrcs[] = {prng_.Rand<uint32_t>(), prng_.Rand<uint32_t>()};
+  RtpHeaderExtensionMap extension_map;
+  std::vector<std::unique_ptr<RtcEventRtpPacketOutgoing>> events;
+  for (int i = 0; i < 20; ++i) {
+    fake_clock_.AdvanceTimeMicros(prng_.Rand(0, 30) * 1000);
+    events.push_back(gen_.NewRtpPacketOutgoing(ssrcs[i % 2], extension_map));
+    history_.push_back(events.back()->Copy());
+  }
+
+  std::string encoded = encoder_->EncodeBatch(history_.begin(), history_.end());
+  ASSERT_TRUE(parsed_log_.ParseString(encoded));
+  const auto& outgoing_rtp_packets_by_ssrc =
+      parsed_log_.outgoing_rtp_packets_by_ssrc();
+
+  ASSERT_EQ(outgoing_rtp_packets_by_ssrc.size(), 2u);
+  for (const auto& stream : outgoing_rtp_packets_by_ssrc) {
+    const size_t index = stream.ssrc == ssrcs[0] ? 0 : 1;
+    ASSERT_EQ(stream.ssrc, ssrcs[index]);
+    ASSERT_EQ(stream.outgoing_packets.size(), 10u);
+    for (size_t i = 0; i < stream.outgoing_packets.size(); ++i) {
+      EXPECT_TRUE(test::VerifyLoggedRtpPacketOutgoing(
+          *events[2 * i + index], stream.outgoing_packets[i]));
+    }
+  }
+}
+
+TEST_P(RtcEventLogEncoderTest, RtcEventRtcpPacketIncomingBatch) {
+  std::vector<std::unique_ptr<RtcEventRtcpPacketIncoming>> events;
+  for (int i = 0; i < 10; ++i) {
+    fake_clock_.AdvanceTimeMicros(prng_.Rand(1, 30) * 1000);
+    events.push_back(gen_.NewRtcpPacketIncoming());
+    history_.push_back(events.back()->Copy());
+  }
+
+  std::string encoded = encoder_->EncodeBatch(history_.begin(), history_.end());
+  ASSERT_TRUE(parsed_log_.ParseString(encoded));
+  const auto& incoming_rtcp_packets = parsed_log_.incoming_rtcp_packets();
+
+  ASSERT_EQ(incoming_rtcp_packets.size(), events.size());
+  for (size_t i = 0; i < events.size(); ++i) {
+    EXPECT_TRUE(test::VerifyLoggedRtcpPacketIncoming(*events[i],
+                                                     incoming_rtcp_packets[i]));
+  }
+}
+
 TEST_P(RtcEventLogEncoderTest, RtcEventVideoReceiveStreamConfig) {
   uint32_t ssrc = prng_.Rand<uint32_t>();
   RtpHeaderExtensionMap extensions = gen_.NewRtpHeaderExtensionMap();
@@ -437,8 +532,33 @@ TEST_P(RtcEventLogEncoderTest, RtcEventVideoSendStreamConfig) {
   EXPECT_TRUE(test::VerifyLoggedVideoSendConfig(*event, video_send_configs[0]));
 }
 
-INSTANTIATE_TEST_CASE_P(RandomSeeds,
-                        RtcEventLogEncoderTest,
-                        ::testing::Values(1, 2, 3, 4, 5));
+INSTANTIATE_TEST_CASE_P(
+    RandomSeeds,
+    RtcEventLogEncoderTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3, 4, 5),
+        ::testing::Values(RtcEventLog::EncodingType::Legacy,
+                          RtcEventLog::EncodingType::NewFormat)));
+
+TEST(RtcEventLogEncoderNewFormatTest, RtpPacketBatchIsSmallerThanLegacy) {
+  rtc::ScopedFakeClock fake_clock;
+  fake_clock.SetTimeMicros(1000000);
+  test::EventGenerator gen(1);
+  const uint32_t ssrc = 0x12345678;
+  RtpHeaderExtensionMap extension_map;
+  std::deque<std::unique_ptr<RtcEvent>> history;
+  for (int i = 0; i < 100; ++i) {
+    fake_clock.AdvanceTimeMicros(20000);
+    history.push_back(gen.NewRtpPacketOutgoing(ssrc, extension_map));
+  }
+
+  RtcEventLogEncoderLegacy legacy_encoder;
+  RtcEventLogEncoderNewFormat new_format_encoder;
+  const std::string legacy =
+      legacy_encoder.EncodeBatch(history.begin(), history.end());
+  const std::string new_format =
+      new_format_encoder.EncodeBatch(history.begin(), history.end());
+  EXPECT_LT(new_format.size(), legacy.size());
+}
 
 }  // namespace webrtc
@@ -19,9 +19,11 @@
 
 #include "absl/memory/memory.h"
 #include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
 #include "logging/rtc_event_log/output/rtc_event_log_output_file.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
@@ -39,6 +41,10 @@ constexpr size_t kMaxEventsInHistory = 10000;
 // The config-history is supposed to be unbounded, but needs to have some bound
 // to prevent an attack via unreasonable memory use.
 constexpr size_t kMaxEventsInConfigHistory = 1000;
+// Bound on the events logged since the last time the |task_queue_| moved them
+// to the history. Beyond it, non-configuration events are dropped, so that a
+// stalled task queue can't make the log grow without bound.
+constexpr size_t kMaxPendingEvents = kMaxEventsInHistory;
 
 // TODO(eladalon): This class exists because C++11 doesn't allow transferring a
 // unique_ptr to a lambda (a copy constructor is required). We should get
@@ -65,6 +71,8 @@ std::unique_ptr<RtcEventLogEncoder> CreateEncoder(
   switch (type) {
     case RtcEventLog::EncodingType::Legacy:
       return absl::make_unique<RtcEventLogEncoderLegacy>();
+    case RtcEventLog::EncodingType::NewFormat:
+      return absl::make_unique<RtcEventLogEncoderNewFormat>();
     default:
       RTC_LOG(LS_ERROR) << "Unknown RtcEventLog encoder type (" << int(type)
                         << ")";
@@ -89,6 +97,9 @@ class RtcEventLogImpl final : public RtcEventLog {
   void Log(std::unique_ptr<RtcEvent> event) override;
 
  private:
+  // Moves the events that Log() has collected since the last call to the
+  // history, writing them to the output if there is one.
+  void LogPendingEventsToMemory() RTC_RUN_ON(task_queue_);
   void LogToMemory(std::unique_ptr<RtcEvent> event) RTC_RUN_ON(task_queue_);
   void LogEventsFromMemoryToOutput() RTC_RUN_ON(task_queue_);
 
@@ -107,6 +118,18 @@ class RtcEventLogImpl final : public RtcEventLog {
   // as started/stopped - from the same thread/task-queue.
   rtc::SequencedTaskChecker owner_sequence_checker_;
 
+  // Events are handed from Log() to the |task_queue_| in batches, so that
+  // logging an event only takes a short lock, and a task is posted once per
+  // batch rather than once per event.
+  rtc::CriticalSection pending_crit_;
+  std::vector<std::unique_ptr<RtcEvent>> pending_events_
+      RTC_GUARDED_BY(pending_crit_);
+  bool drain_scheduled_ RTC_GUARDED_BY(pending_crit_);
+  size_t num_dropped_events_ RTC_GUARDED_BY(pending_crit_);
+  // Swapped with |pending_events_|, so that both keep their capacity.
+  std::vector<std::unique_ptr<RtcEvent>> draining_events_
+      RTC_GUARDED_BY(*task_queue_);
+
   // History containing all past configuration events.
   std::deque<std::unique_ptr<RtcEvent>> config_history_
       RTC_GUARDED_BY(*task_queue_);
@@ -138,7 +161,9 @@ class RtcEventLogImpl final : public RtcEventLog {
 RtcEventLogImpl::RtcEventLogImpl(
     std::unique_ptr<RtcEventLogEncoder> event_encoder,
     std::unique_ptr<rtc::TaskQueue> task_queue)
-    : max_size_bytes_(std::numeric_limits<decltype(max_size_bytes_)>::max()),
+    : drain_scheduled_(false),
+      num_dropped_events_(0),
+      max_size_bytes_(std::numeric_limits<decltype(max_size_bytes_)>::max()),
       written_bytes_(0),
       event_encoder_(std::move(event_encoder)),
       num_config_events_written_(0),
@@ -179,6 +204,7 @@ bool RtcEventLogImpl::StartLogging(std::unique_ptr<RtcEventLogOutput> output,
   auto start = [this, timestamp_us](std::unique_ptr<RtcEventLogOutput> output) {
     RTC_DCHECK_RUN_ON(task_queue_.get());
     RTC_DCHECK(output->IsActive());
+    LogPendingEventsToMemory();
     event_output_ = std::move(output);
     num_config_events_written_ = 0;
     WriteToOutput(event_encoder_->EncodeLogStart(timestamp_us));
@@ -202,6 +228,7 @@ void RtcEventLogImpl::StopLogging() {
   // Binding to |this| is safe because |this| outlives the |task_queue_|.
   task_queue_->PostTask([this, &output_stopped]() {
     RTC_DCHECK_RUN_ON(task_queue_.get());
+    LogPendingEventsToMemory();
     if (event_output_) {
       RTC_DCHECK(event_output_->IsActive());
       LogEventsFromMemoryToOutput();
@@ -218,16 +245,54 @@ void RtcEventLogImpl::StopLogging() {
 void RtcEventLogImpl::Log(std::unique_ptr<RtcEvent> event) {
   RTC_CHECK(event);
 
+  {
+    rtc::CritScope lock(&pending_crit_);
+    // Configuration events are rare, and needed to parse the rest of the log,
+    // so they are never dropped.
+    if (pending_events_.size() >= kMaxPendingEvents &&
+        !event->IsConfigEvent()) {
+      ++num_dropped_events_;
+      return;
+    }
+    pending_events_.push_back(std::move(event));
+    if (drain_scheduled_)
+      return;
+    drain_scheduled_ = true;
+  }
+
   // Binding to |this| is safe because |this| outlives the |task_queue_|.
-  auto event_handler = [this](std::unique_ptr<RtcEvent> unencoded_event) {
+  task_queue_->PostTask([this]() {
     RTC_DCHECK_RUN_ON(task_queue_.get());
-    LogToMemory(std::move(unencoded_event));
+    LogPendingEventsToMemory();
     if (event_output_)
       ScheduleOutput();
-  };
+  });
+}
+
+void RtcEventLogImpl::LogPendingEventsToMemory() {
+  size_t num_dropped_events;
+  {
+    rtc::CritScope lock(&pending_crit_);
+    draining_events_.swap(pending_events_);
+    drain_scheduled_ = false;
+    num_dropped_events = num_dropped_events_;
+    num_dropped_events_ = 0;
+  }
+  if (num_dropped_events > 0) {
+    RTC_LOG(LS_WARNING) << "Dropped " << num_dropped_events
+                        << " RTC events that were logged faster than they "
+                           "could be processed.";
+  }
 
-  task_queue_->PostTask(absl::make_unique<ResourceOwningTask<RtcEvent>>(
-      std::move(event), event_handler));
+  for (std::unique_ptr<RtcEvent>& event : draining_events_) {
+    if (event_output_ && history_.size() >= kMaxEventsInHistory) {
+      // Same emergency drain as in ScheduleOutput(), since a batch may hold
+      // more events than fit in the history.
+      LogEventsFromMemoryToOutput();
+    }
+    LogToMemory(std::move(event));
+  }
+  draining_events_.clear();
 }
 
 void RtcEventLogImpl::ScheduleOutput() {
@@ -21,8 +21,10 @@
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "absl/types/optional.h"
 #include "api/rtp_headers.h"
 #include "api/rtpparameters.h"
+#include "logging/rtc_event_log/encoder/delta_encoding.h"
 #include "logging/rtc_event_log/rtc_event_log.h"
 #include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "modules/remote_bitrate_estimator/include/bwe_defines.h"
@@ -270,6 +272,272 @@ void GetHeaderExtensions(std::vector<RtpExtension>* header_extensions,
   }
 }
 
+BandwidthUsage GetRuntimeDetectorState(
+    rtclog2::DelayBasedBweUpdates::DetectorState detector_state) {
+  switch (detector_state) {
+    case rtclog2::DelayBasedBweUpdates::BWE_NORMAL:
+      return BandwidthUsage::kBwNormal;
+    case rtclog2::DelayBasedBweUpdates::BWE_UNDERUSING:
+      return BandwidthUsage::kBwUnderusing;
+    case rtclog2::DelayBasedBweUpdates::BWE_OVERUSING:
+      return BandwidthUsage::kBwOverusing;
+  }
+  RTC_NOTREACHED();
+  return BandwidthUsage::kBwNormal;
+}
+
+absl::optional<uint64_t> GetBaseValue(bool has_value, uint64_t value) {
+  return has_value ? absl::optional<uint64_t>(value) : absl::nullopt;
+}
+
+// Decodes the timestamps of a batch of events of the new format, which also
+// gives the number of events in the batch.
+bool DecodeBatchTimestamps(int64_t base_ms,
+                           const std::string& deltas,
+                           std::vector<int64_t>* timestamps_us) {
+  std::vector<absl::optional<uint64_t>> values;
+  if (!DecodeDeltas(deltas, static_cast<uint64_t>(base_ms), 64, &values)) {
+    RTC_LOG(LS_WARNING) << "Malformed timestamp deltas.";
+    return false;
+  }
+  timestamps_us->clear();
+  timestamps_us->push_back(base_ms * 1000);
+  for (const auto& value : values) {
+    if (!value) {
+      RTC_LOG(LS_WARNING) << "Missing timestamp in batch of events.";
+      return false;
+    }
+    timestamps_us->push_back(static_cast<int64_t>(*value) * 1000);
+  }
+  return true;
+}
+
+// Decodes the values of a field for the |num_events| events in a batch of the
+// new format, from the |base| value of the first event and the |deltas| of
+// the others.
+bool DecodeBatchField(absl::optional<uint64_t> base,
+                      const std::string& deltas,
+                      size_t num_events,
+                      int bit_width,
+                      std::vector<absl::optional<uint64_t>>* values) {
+  RTC_DCHECK_GT(num_events, 0);
+  if (deltas.empty()) {
+    values->assign(num_events, base);
+    return true;
+  }
+  if (!DecodeDeltas(deltas, base, bit_width, values) ||
+      values->size() != num_events - 1) {
+    RTC_LOG(LS_WARNING) << "Malformed deltas in batch of events.";
+    return false;
+  }
+  values->insert(values->begin(), base);
+  return true;
+}
+
+// Like DecodeBatchField(), for a field which each event must have.
+bool DecodeRequiredBatchField(absl::optional<uint64_t> base,
+                              const std::string& deltas,
+                              size_t num_events,
+                              int bit_width,
+                              std::vector<uint64_t>* values) {
+  std::vector<absl::optional<uint64_t>> optional_values;
+  if (!base ||
+      !DecodeBatchField(base, deltas, num_events, bit_width,
+                        &optional_values)) {
+    return false;
+  }
+  values->clear();
+  for (const auto& value : optional_values) {
+    if (!value) {
+      RTC_LOG(LS_WARNING) << "Missing required field in batch of events.";
+      return false;
+    }
+    values->push_back(*value);
+  }
+  return true;
+}
+
+template <typename ProtoType>
+bool DecodeCsrcs(const ProtoType& proto,
+                 size_t num_packets,
+                 std::vector<std::vector<uint32_t>>* csrcs) {
+  csrcs->assign(
+      1, std::vector<uint32_t>(proto.csrcs().begin(), proto.csrcs().end()));
+  const std::string& deltas = proto.csrcs_deltas();
+  if (deltas.empty()) {
+    csrcs->resize(num_packets, csrcs->front());
+    return true;
+  }
+  size_t offset = 0;
+  while (offset < deltas.size()) {
+    uint64_t varint;
+    if (!DecodeVarInt(deltas, &offset, &varint)) {
+      return false;
+    }
+    if (varint == 0) {
+      std::vector<uint32_t> previous = csrcs->back();
+      csrcs->push_back(std::move(previous));
+      continue;
+    }
+    const uint64_t num_csrcs = varint - 1;
+    if (num_csrcs > kRtpCsrcSize || deltas.size() - offset < 4 * num_csrcs) {
+      return false;
+    }
+    std::vector<uint32_t> packet_csrcs;
+    for (uint64_t i = 0; i < num_csrcs; ++i) {
+      uint32_t csrc = 0;
+      for (int shift = 0; shift < 32; shift += 8) {
+        csrc |= static_cast<uint32_t>(static_cast<uint8_t>(deltas[offset++]))
+                << shift;
+      }
+      packet_csrcs.push_back(csrc);
+    }
+    csrcs->push_back(std::move(packet_csrcs));
+  }
+  return csrcs->size() == num_packets;
+}
+
+// Decodes a batch of RTP packets of the new format. |ProtoType| is either
+// IncomingRtpPackets or OutgoingRtpPackets, and |LoggedType| the
+// corresponding LoggedRtpPacketIncoming or LoggedRtpPacketOutgoing.
+template <typename ProtoType, typename LoggedType>
+bool DecodeRtpPackets(const ProtoType& proto,
+                      std::vector<LoggedType>* packets) {
+  std::vector<int64_t> timestamps_us;
+  if (!proto.has_timestamp_ms() ||
+      !DecodeBatchTimestamps(proto.timestamp_ms(), proto.timestamp_deltas_ms(),
+                             &timestamps_us)) {
+    return false;
+  }
+  const size_t num_packets = timestamps_us.size();
+
+  std::vector<uint64_t> markers;
+  std::vector<uint64_t> payload_types;
+  std::vector<uint64_t> sequence_numbers;
+  std::vector<uint64_t> rtp_timestamps;
+  std::vector<uint64_t> ssrcs;
+  std::vector<uint64_t> packet_sizes;
+  std::vector<uint64_t> header_sizes;
+  std::vector<uint64_t> padding_sizes;
+  std::vector<std::vector<uint32_t>> csrcs;
+  std::vector<absl::optional<uint64_t>> transmission_time_offsets;
+  std::vector<absl::optional<uint64_t>> absolute_send_times;
+  std::vector<absl::optional<uint64_t>> transport_sequence_numbers;
+  std::vector<absl::optional<uint64_t>> audio_levels;
+  if (!DecodeRequiredBatchField(
+          GetBaseValue(proto.has_marker(), proto.marker()),
+          proto.marker_deltas(), num_packets, 1, &markers) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_payload_type(), proto.payload_type()),
+          proto.payload_type_deltas(), num_packets, 7, &payload_types) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_sequence_number(), proto.sequence_number()),
+          proto.sequence_number_deltas(), num_packets, 16,
+          &sequence_numbers) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_rtp_timestamp(), proto.rtp_timestamp()),
+          proto.rtp_timestamp_deltas(), num_packets, 32, &rtp_timestamps) ||
+      !DecodeRequiredBatchField(GetBaseValue(proto.has_ssrc(), proto.ssrc()),
+                                proto.ssrc_deltas(), num_packets, 32,
+                                &ssrcs) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_packet_size(), proto.packet_size()),
+          proto.packet_size_deltas(), num_packets, 32, &packet_sizes) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_header_size(), proto.header_size()),
+          proto.header_size_deltas(), num_packets, 32, &header_sizes) ||
+      !DecodeRequiredBatchField(proto.padding_size(),
+                                proto.padding_size_deltas(), num_packets, 8,
+                                &padding_sizes) ||
+      !DecodeCsrcs(proto, num_packets, &csrcs) ||
+      !DecodeBatchField(
+          GetBaseValue(proto.has_transmission_time_offset(),
+                       static_cast<uint32_t>(proto.transmission_time_offset())),
+          proto.transmission_time_offset_deltas(), num_packets, 32,
+          &transmission_time_offsets) ||
+      !DecodeBatchField(GetBaseValue(proto.has_absolute_send_time(),
+                                     proto.absolute_send_time()),
+                        proto.absolute_send_time_deltas(), num_packets, 24,
+                        &absolute_send_times) ||
+      !DecodeBatchField(GetBaseValue(proto.has_transport_sequence_number(),
+                                     proto.transport_sequence_number()),
+                        proto.transport_sequence_number_deltas(), num_packets,
+                        16, &transport_sequence_numbers) ||
+      !DecodeBatchField(
+          GetBaseValue(proto.has_audio_level(), proto.audio_level()),
+          proto.audio_level_deltas(), num_packets, 8, &audio_levels)) {
+    RTC_LOG(LS_WARNING) << "Failed to decode batch of RTP packets.";
+    return false;
+  }
+
+  for (size_t i = 0; i < num_packets; ++i) {
+    RTPHeader header;
+    header.markerBit = markers[i] != 0;
+    header.payloadType = static_cast<uint8_t>(payload_types[i]);
+    header.sequenceNumber = static_cast<uint16_t>(sequence_numbers[i]);
+    header.timestamp = static_cast<uint32_t>(rtp_timestamps[i]);
+    header.ssrc = static_cast<uint32_t>(ssrcs[i]);
+    header.numCSRCs = static_cast<uint8_t>(csrcs[i].size());
+    std::copy(csrcs[i].begin(), csrcs[i].end(), header.arrOfCSRCs);
+    header.paddingLength = padding_sizes[i];
+    header.headerLength = header_sizes[i];
+    if (transmission_time_offsets[i]) {
+      header.extension.hasTransmissionTimeOffset = true;
+      header.extension.transmissionTimeOffset =
+          static_cast<int32_t>(*transmission_time_offsets[i]);
+    }
+    if (absolute_send_times[i]) {
+      header.extension.hasAbsoluteSendTime = true;
+      header.extension.absoluteSendTime =
+          static_cast<uint32_t>(*absolute_send_times[i]);
+    }
+    if (transport_sequence_numbers[i]) {
+      header.extension.hasTransportSequenceNumber = true;
+      header.extension.transportSequenceNumber =
+          static_cast<uint16_t>(*transport_sequence_numbers[i]);
+    }
+    if (audio_levels[i]) {
+      header.extension.hasAudioLevel = true;
+      header.extension.voiceActivity = (*audio_levels[i] & 0x80) != 0;
+      header.extension.audioLevel = *audio_levels[i] & 0x7F;
+    }
+    packets->emplace_back(timestamps_us[i], header, header_sizes[i],
+                          packet_sizes[i]);
+  }
+  return true;
+}
+
+// Decodes a batch of RTCP packets of the new format. |ProtoType| is either
+// IncomingRtcpPackets or OutgoingRtcpPackets.
+template <typename ProtoType>
+bool DecodeRtcpPackets(const ProtoType& proto,
+                       std::vector<int64_t>* timestamps_us,
+                       std::vector<std::string>* packets) {
+  if (!proto.has_timestamp_ms() || !proto.has_raw_packet() ||
+      !DecodeBatchTimestamps(proto.timestamp_ms(), proto.timestamp_deltas_ms(),
+                             timestamps_us)) {
+    return false;
+  }
+  packets->assign(1, proto.raw_packet());
+  const std::string& deltas = proto.raw_packet_deltas();
+  size_t offset = 0;
+  while (offset < deltas.size()) {
+    uint64_t length;
+    if (!DecodeVarInt(deltas, &offset, &length) ||
+        length > deltas.size() - offset) {
+      return false;
+    }
+    packets->push_back(deltas.substr(offset, length));
+    offset += length;
+  }
+  for (const std::string& packet : *packets) {
+    if (packet.size() > IP_PACKET_SIZE) {
+      return false;
+    }
+  }
+  return packets->size() == timestamps_us->size();
+}
+
 }  // namespace
 
 ParsedRtcEventLogNew::ParsedRtcEventLogNew(
@@ -358,7 +626,7 @@ bool ParsedRtcEventLogNew::ParseString(const std::string& s) {
 bool ParsedRtcEventLogNew::ParseStream(
     std::istream& stream) {  // no-presubmit-check TODO(webrtc:8982)
   Clear();
-  bool success = ParseStreamInternal(stream);
+  bool success = ParseStreamInternal(stream, nullptr);
 
   // ParseStreamInternal stores the RTP packets in a map indexed by SSRC.
   // Since we dont need rapid lookup based on SSRC after parsing, we move the
@@ -396,8 +664,11 @@ bool ParsedRtcEventLogNew::ParseStream(
 }
 
 bool ParsedRtcEventLogNew::ParseStreamInternal(
-    std::istream& stream) {  // no-presubmit-check TODO(webrtc:8982)
+    std::istream& stream,  // no-presubmit-check TODO(webrtc:8982)
+    rtc::FunctionView<void()> message_parsed) {
   const size_t kMaxEventSize = (1u << 16) - 1;
+  // Messages of the new format hold a batch of events each.
+  const size_t kMaxBatchSize = (1u << 24) - 1;
   std::vector<char> tmp_buffer(kMaxEventSize);
   uint64_t tag;
   uint64_t message_length;
@@ -413,38 +684,73 @@ bool ParsedRtcEventLogNew::ParseStreamInternal(
     }
 
     // Read the next message tag. The tag number is defined as
-    // (fieldnumber << 3) | wire_type. In our case, the field number is
-    // supposed to be 1 and the wire type for an
-    // length-delimited field is 2.
+    // (fieldnumber << 3) | wire_type. In the legacy format, the field number
+    // is supposed to be 1 and the wire type for an length-delimited field is
+    // 2. The other fields are those of rtclog2::EventStream, which except for
+    // the version are length-delimited too.
     const uint64_t kExpectedTag = (1 << 3) | 2;
+    const uint64_t kVersionTag = (2 << 3) | 0;
     std::tie(tag, success) = ParseVarInt(stream);
     if (!success) {
       RTC_LOG(LS_WARNING)
           << "Missing field tag from beginning of protobuf event.";
       return false;
-    } else if (tag != kExpectedTag) {
+    } else if (tag == kVersionTag) {
+      uint64_t version;
+      std::tie(version, success) = ParseVarInt(stream);
+      if (!success || version != 2) {
+        RTC_LOG(LS_WARNING) << "Unsupported event log version.";
+        return false;
+      }
+      continue;
+    } else if ((tag & 7) != 2) {
       RTC_LOG(LS_WARNING)
           << "Unexpected field tag at beginning of protobuf event.";
       return false;
     }
+    const bool is_legacy_event = tag == kExpectedTag;
 
     // Read the length field.
     std::tie(message_length, success) = ParseVarInt(stream);
     if (!success) {
       RTC_LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
       return false;
-    } else if (message_length > kMaxEventSize) {
+    } else if (message_length >
+               (is_legacy_event ? kMaxEventSize : kMaxBatchSize)) {
       RTC_LOG(LS_WARNING) << "Protobuf message length is too large.";
       return false;
     }
 
     // Read the next protobuf event to a temporary char buffer.
+    if (message_length > tmp_buffer.size()) {
+      tmp_buffer.resize(message_length);
+    }
     stream.read(tmp_buffer.data(), message_length);
     if (stream.gcount() != static_cast<int>(message_length)) {
       RTC_LOG(LS_WARNING) << "Failed to read protobuf message from file.";
       return false;
     }
 
+    if (!is_legacy_event) {
+      // Parse the field as an EventStream of its own.
+      std::string serialized;
+      EncodeVarInt(tag, &serialized);
+      EncodeVarInt(message_length, &serialized);
+      serialized.append(tmp_buffer.data(), message_length);
+      rtclog2::EventStream event_stream;
+      if (!event_stream.ParseFromString(serialized)) {
+        RTC_LOG(LS_WARNING) << "Failed to parse protobuf message.";
+        return false;
+      }
+      if (!StoreParsedNewFormatEvent(event_stream)) {
+        return false;
+      }
+      if (message_parsed) {
+        message_parsed();
+      }
+      continue;
+    }
+
     // Parse the protobuf event from the buffer.
     rtclog::Event event;
     if (!event.ParseFromArray(tmp_buffer.data(), message_length)) {
@@ -453,7 +759,11 @@ bool ParsedRtcEventLogNew::ParseStreamInternal(
     }
 
     StoreParsedEvent(event);
-    events_.push_back(event);
+    if (message_parsed) {
+      message_parsed();
+    } else {
+      events_.push_back(event);
+    }
   }
   return true;
 }
@@ -557,85 +867,8 @@ void ParsedRtcEventLogNew::StoreParsedEvent(const rtclog::Event& event) {
       uint8_t packet[IP_PACKET_SIZE];
       size_t total_length;
       GetRtcpPacket(event, &direction, packet, &total_length);
-      uint64_t timestamp_us = GetTimestamp(event);
       RTC_CHECK_LE(total_length, IP_PACKET_SIZE);
-      if (direction == kIncomingPacket) {
-        // Currently incoming RTCP packets are logged twice, both for audio and
-        // video. Only act on one of them. Compare against the previous parsed
-        // incoming RTCP packet.
-        if (total_length == last_incoming_rtcp_packet_length_ &&
-            memcmp(last_incoming_rtcp_packet_, packet, total_length) == 0)
-          break;
-        incoming_rtcp_packets_.push_back(
-            LoggedRtcpPacketIncoming(timestamp_us, packet, total_length));
-        last_incoming_rtcp_packet_length_ = total_length;
-        memcpy(last_incoming_rtcp_packet_, packet, total_length);
-      } else {
-        outgoing_rtcp_packets_.push_back(
-            LoggedRtcpPacketOutgoing(timestamp_us, packet, total_length));
-      }
-      rtcp::CommonHeader header;
-      const uint8_t* packet_end = packet + total_length;
-      for (const uint8_t* block = packet; block < packet_end;
-           block = header.NextPacket()) {
-        RTC_CHECK(header.Parse(block, packet_end - block));
-        if (header.type() == rtcp::TransportFeedback::kPacketType &&
-            header.fmt() == rtcp::TransportFeedback::kFeedbackMessageType) {
-          if (direction == kIncomingPacket) {
-            incoming_transport_feedback_.emplace_back();
-            LoggedRtcpPacketTransportFeedback& parsed_block =
-                incoming_transport_feedback_.back();
-            parsed_block.timestamp_us = GetTimestamp(event);
-            if (!parsed_block.transport_feedback.Parse(header))
-              incoming_transport_feedback_.pop_back();
-          } else {
-            outgoing_transport_feedback_.emplace_back();
-            LoggedRtcpPacketTransportFeedback& parsed_block =
-                outgoing_transport_feedback_.back();
-            parsed_block.timestamp_us = GetTimestamp(event);
-            if (!parsed_block.transport_feedback.Parse(header))
-              outgoing_transport_feedback_.pop_back();
-          }
-        } else if (header.type() == rtcp::SenderReport::kPacketType) {
-          LoggedRtcpPacketSenderReport parsed_block;
-          parsed_block.timestamp_us = GetTimestamp(event);
-          if (parsed_block.sr.Parse(header)) {
-            if (direction == kIncomingPacket)
-              incoming_sr_.push_back(std::move(parsed_block));
-            else
-              outgoing_sr_.push_back(std::move(parsed_block));
-          }
-        } else if (header.type() == rtcp::ReceiverReport::kPacketType) {
-          LoggedRtcpPacketReceiverReport parsed_block;
-          parsed_block.timestamp_us = GetTimestamp(event);
-          if (parsed_block.rr.Parse(header)) {
-            if (direction == kIncomingPacket)
-              incoming_rr_.push_back(std::move(parsed_block));
-            else
-              outgoing_rr_.push_back(std::move(parsed_block));
-          }
-        } else if (header.type() == rtcp::Remb::kPacketType &&
-                   header.fmt() == rtcp::Remb::kFeedbackMessageType) {
-          LoggedRtcpPacketRemb parsed_block;
-          parsed_block.timestamp_us = GetTimestamp(event);
-          if (parsed_block.remb.Parse(header)) {
-            if (direction == kIncomingPacket)
-              incoming_remb_.push_back(std::move(parsed_block));
-            else
-              outgoing_remb_.push_back(std::move(parsed_block));
-          }
-        } else if (header.type() == rtcp::Nack::kPacketType &&
-                   header.fmt() == rtcp::Nack::kFeedbackMessageType) {
-          LoggedRtcpPacketNack parsed_block;
-          parsed_block.timestamp_us = GetTimestamp(event);
-          if (parsed_block.nack.Parse(header)) {
-            if (direction == kIncomingPacket)
-              incoming_nack_.push_back(std::move(parsed_block));
-            else
-              outgoing_nack_.push_back(std::move(parsed_block));
-          }
-        }
-      }
+      StoreRtcpPacket(GetTimestamp(event), direction, packet, total_length);
       break;
     }
     case ParsedRtcEventLogNew::EventType::LOG_START: {
@@ -696,6 +929,408 @@ void ParsedRtcEventLogNew::StoreParsedEvent(const rtclog::Event& event) {
   }
 }
 
+void ParsedRtcEventLogNew::StoreRtcpPacket(int64_t timestamp_us,
+                                           PacketDirection direction,
+                                           const uint8_t* packet,
+                                           size_t total_length) {
+  if (direction == kIncomingPacket) {
+    // Currently incoming RTCP packets are logged twice, both for audio and
+    // video. Only act on one of them. Compare against the previous parsed
+    // incoming RTCP packet.
+    if (total_length == last_incoming_rtcp_packet_length_ &&
+        memcmp(last_incoming_rtcp_packet_, packet, total_length) == 0)
+      return;
+    incoming_rtcp_packets_.push_back(
+        LoggedRtcpPacketIncoming(timestamp_us, packet, total_length));
+    last_incoming_rtcp_packet_length_ = total_length;
+    memcpy(last_incoming_rtcp_packet_, packet, total_length);
+  } else {
+    outgoing_rtcp_packets_.push_back(
+        LoggedRtcpPacketOutgoing(timestamp_us, packet, total_length));
+  }
+  rtcp::CommonHeader header;
+  const uint8_t* packet_end = packet + total_length;
+  for (const uint8_t* block = packet; block < packet_end;
+       block = header.NextPacket()) {
+    RTC_CHECK(header.Parse(block, packet_end - block));
+    if (header.type() == rtcp::TransportFeedback::kPacketType &&
+        header.fmt() == rtcp::TransportFeedback::kFeedbackMessageType) {
+      if (direction == kIncomingPacket) {
+        incoming_transport_feedback_.emplace_back();
+        LoggedRtcpPacketTransportFeedback& parsed_block =
+            incoming_transport_feedback_.back();
+        parsed_block.timestamp_us = timestamp_us;
+        if (!parsed_block.transport_feedback.Parse(header))
+          incoming_transport_feedback_.pop_back();
+      } else {
+        outgoing_transport_feedback_.emplace_back();
+        LoggedRtcpPacketTransportFeedback& parsed_block =
+            outgoing_transport_feedback_.back();
+        parsed_block.timestamp_us = timestamp_us;
+        if (!parsed_block.transport_feedback.Parse(header))
+          outgoing_transport_feedback_.pop_back();
+      }
+    } else if (header.type() == rtcp::SenderReport::kPacketType) {
+      LoggedRtcpPacketSenderReport parsed_block;
+      parsed_block.timestamp_us = timestamp_us;
+      if (parsed_block.sr.Parse(header)) {
+        if (direction == kIncomingPacket)
+          incoming_sr_.push_back(std::move(parsed_block));
+        else
+          outgoing_sr_.push_back(std::move(parsed_block));
+      }
+    } else if (header.type() == rtcp::ReceiverReport::kPacketType) {
+      LoggedRtcpPacketReceiverReport parsed_block;
+      parsed_block.timestamp_us = timestamp_us;
+      if (parsed_block.rr.Parse(header)) {
+        if (direction == kIncomingPacket)
+          incoming_rr_.push_back(std::move(parsed_block));
+        else
+          outgoing_rr_.push_back(std::move(parsed_block));
+      }
+    } else if (header.type() == rtcp::Remb::kPacketType &&
+               header.fmt() == rtcp::Remb::kFeedbackMessageType) {
+      LoggedRtcpPacketRemb parsed_block;
+      parsed_block.timestamp_us = timestamp_us;
+      if (parsed_block.remb.Parse(header)) {
+        if (direction == kIncomingPacket)
+          incoming_remb_.push_back(std::move(parsed_block));
+        else
+          outgoing_remb_.push_back(std::move(parsed_block));
+      }
+    } else if (header.type() == rtcp::Nack::kPacketType &&
+               header.fmt() == rtcp::Nack::kFeedbackMessageType) {
+      LoggedRtcpPacketNack parsed_block;
+      parsed_block.timestamp_us = timestamp_us;
+      if (parsed_block.nack.Parse(header)) {
+        if (direction == kIncomingPacket)
+          incoming_nack_.push_back(std::move(parsed_block));
+        else
+          outgoing_nack_.push_back(std::move(parsed_block));
+      }
+    }
+  }
+}
+
+void ParsedRtcEventLogNew::UpdateTimestampRange(int64_t timestamp_us) {
+  first_timestamp_ = std::min(first_timestamp_, timestamp_us);
+  last_timestamp_ = std::max(last_timestamp_, timestamp_us);
+}
+
+bool ParsedRtcEventLogNew::StoreParsedNewFormatEvent(
+    const rtclog2::EventStream& event_stream) {
+  for (const auto& proto : event_stream.incoming_rtp_packets()) {
+    std::vector<LoggedRtpPacketIncoming> packets;
+    if (!DecodeRtpPackets(proto, &packets))
+      return false;
+    for (auto& packet : packets) {
+      UpdateTimestampRange(packet.log_time_us());
+      incoming_rtp_packets_map_[packet.rtp.header.ssrc].push_back(
+          std::move(packet));
+    }
+  }
+  for (const auto& proto : event_stream.outgoing_rtp_packets()) {
+    std::vector<LoggedRtpPacketOutgoing> packets;
+    if (!DecodeRtpPackets(proto, &packets))
+      return false;
+    for (auto& packet : packets) {
+      UpdateTimestampRange(packet.log_time_us());
+      outgoing_rtp_packets_map_[packet.rtp.header.ssrc].push_back(
+          std::move(packet));
+    }
+  }
+  for (const auto& proto : event_stream.incoming_rtcp_packets()) {
+    std::vector<int64_t> timestamps_us;
+    std::vector<std::string> packets;
+    if (!DecodeRtcpPackets(proto, &timestamps_us, &packets)) {
+      RTC_LOG(LS_WARNING) << "Failed to decode batch of RTCP packets.";
+      return false;
+    }
+    for (size_t i = 0; i < packets.size(); ++i) {
+      UpdateTimestampRange(timestamps_us[i]);
+      StoreRtcpPacket(timestamps_us[i], kIncomingPacket,
+                      reinterpret_cast<const uint8_t*>(packets[i].data()),
+                      packets[i].size());
+    }
+  }
+  for (const auto& proto : event_stream.outgoing_rtcp_packets()) {
+    std::vector<int64_t> timestamps_us;
+    std::vector<std::string> packets;
+    if (!DecodeRtcpPackets(proto, &timestamps_us, &packets)) {
+      RTC_LOG(LS_WARNING) << "Failed to decode batch of RTCP packets.";
+      return false;
+    }
+    for (size_t i = 0; i < packets.size(); ++i) {
+      UpdateTimestampRange(timestamps_us[i]);
+      StoreRtcpPacket(timestamps_us[i], kOutgoingPacket,
+                      reinterpret_cast<const uint8_t*>(packets[i].data()),
+                      packets[i].size());
+    }
+  }
+  for (const auto& proto : event_stream.audio_playout_events()) {
+    if (!StoreAudioPlayoutEvents(proto))
+      return false;
+  }
+  for (const auto& proto : event_stream.begin_log_events()) {
+    start_log_events_.push_back(LoggedStartEvent(proto.timestamp_ms() * 1000));
+  }
+  for (const auto& proto : event_stream.end_log_events()) {
+    stop_log_events_.push_back(LoggedStopEvent(proto.timestamp_ms() * 1000));
+  }
+  for (const auto& proto : event_stream.loss_based_bwe_updates()) {
+    if (!StoreLossBasedBweUpdates(proto))
+      return false;
+  }
+  for (const auto& proto : event_stream.delay_based_bwe_updates()) {
+    if (!StoreDelayBasedBweUpdates(proto))
+      return false;
+  }
+  for (const auto& proto : event_stream.audio_network_adaptations()) {
+    if (!StoreAudioNetworkAdaptations(proto))
+      return false;
+  }
+  for (const auto& proto : event_stream.probe_clusters()) {
+    StoreBweProbeCluster(proto);
+  }
+  for (const auto& proto : event_stream.probe_success()) {
+    StoreBweProbeSuccess(proto);
+  }
+  for (const auto& proto : event_stream.probe_failure()) {
+    StoreBweProbeFailure(proto);
+  }
+  // TODO(terelius): Parse the stream configs of the new format, once the
+  // encoder writes them. Until then, they are written as legacy events.
+  return true;
+}
+
+bool ParsedRtcEventLogNew::StoreAudioNetworkAdaptations(
+    const rtclog2::AudioNetworkAdaptations& proto) {
+  std::vector<int64_t> timestamps_us;
+  if (!proto.has_timestamp_ms() ||
+      !DecodeBatchTimestamps(proto.timestamp_ms(), proto.timestamp_deltas_ms(),
+                             &timestamps_us)) {
+    return false;
+  }
+  const size_t num_events = timestamps_us.size();
+
+  uint32_t base_fraction_bits;
+  const float base_fraction = proto.uplink_packet_loss_fraction();
+  static_assert(sizeof(base_fraction_bits) == sizeof(base_fraction), "");
+  memcpy(&base_fraction_bits, &base_fraction, sizeof(base_fraction_bits));
+
+  std::vector<absl::optional<uint64_t>> bitrates_bps;
+  std::vector<absl::optional<uint64_t>> frame_lengths_ms;
+  std::vector<absl::optional<uint64_t>> uplink_packet_loss_fractions;
+  std::vector<absl::optional<uint64_t>> enable_fecs;
+  std::vector<absl::optional<uint64_t>> enable_dtxs;
+  std::vector<absl::optional<uint64_t>> num_channels;
+  if (!DecodeBatchField(
+          GetBaseValue(proto.has_bitrate_bps(),
+                       static_cast<uint32_t>(proto.bitrate_bps())),
+          proto.bitrate_deltas_bps(), num_events, 32, &bitrates_bps) ||
+      !DecodeBatchField(
+          GetBaseValue(proto.has_frame_length_ms(),
+                       static_cast<uint32_t>(proto.frame_length_ms())),
+          proto.frame_length_deltas_ms(), num_events, 32, &frame_lengths_ms) ||
+      !DecodeBatchField(
+          GetBaseValue(proto.has_uplink_packet_loss_fraction(),
+                       base_fraction_bits),
+          proto.uplink_packet_loss_fraction_deltas(), num_events, 32,
+          &uplink_packet_loss_fractions) ||
+      !DecodeBatchField(
+          GetBaseValue(proto.has_enable_fec(), proto.enable_fec()),
+          proto.enable_fec_deltas(), num_events, 1, &enable_fecs) ||
+      !DecodeBatchField(
+          GetBaseValue(proto.has_enable_dtx(), proto.enable_dtx()),
+          proto.enable_dtx_deltas(), num_events, 1, &enable_dtxs) ||
+      !DecodeBatchField(
+          GetBaseValue(proto.has_num_channels(), proto.num_channels()),
+          proto.num_channels_deltas(), num_events, 32, &num_channels)) {
+    RTC_LOG(LS_WARNING) << "Failed to decode batch of ANA events.";
+    return false;
+  }
+
+  for (size_t i = 0; i < num_events; ++i) {
+    LoggedAudioNetworkAdaptationEvent event;
+    event.timestamp_us = timestamps_us[i];
+    if (bitrates_bps[i])
+      event.config.bitrate_bps = static_cast<int32_t>(*bitrates_bps[i]);
+    if (frame_lengths_ms[i])
+      event.config.frame_length_ms = static_cast<int32_t>(*frame_lengths_ms[i]);
+    if (uplink_packet_loss_fractions[i]) {
+      const uint32_t bits =
+          static_cast<uint32_t>(*uplink_packet_loss_fractions[i]);
+      float fraction;
+      memcpy(&fraction, &bits, sizeof(fraction));
+      event.config.uplink_packet_loss_fraction = fraction;
+    }
+    if (enable_fecs[i])
+      event.config.enable_fec = *enable_fecs[i] != 0;
+    if (enable_dtxs[i])
+      event.config.enable_dtx = *enable_dtxs[i] != 0;
+    if (num_channels[i])
+      event.config.num_channels = static_cast<size_t>(*num_channels[i]);
+    UpdateTimestampRange(event.timestamp_us);
+    audio_network_adaptation_events_.push_back(event);
+  }
+  return true;
+}
+
+bool ParsedRtcEventLogNew::StoreAudioPlayoutEvents(
+    const rtclog2::AudioPlayoutEvents& proto) {
+  std::vector<int64_t> timestamps_us;
+  std::vector<uint64_t> local_ssrcs;
+  if (!proto.has_timestamp_ms() ||
+      !DecodeBatchTimestamps(proto.timestamp_ms(), proto.timestamp_deltas_ms(),
+                             &timestamps_us) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_local_ssrc(), proto.local_ssrc()),
+          proto.local_ssrc_deltas(), timestamps_us.size(), 32, &local_ssrcs)) {
+    RTC_LOG(LS_WARNING) << "Failed to decode batch of audio playout events.";
+    return false;
+  }
+
+  for (size_t i = 0; i < timestamps_us.size(); ++i) {
+    LoggedAudioPlayoutEvent event;
+    event.timestamp_us = timestamps_us[i];
+    event.ssrc = static_cast<uint32_t>(local_ssrcs[i]);
+    UpdateTimestampRange(event.timestamp_us);
+    audio_playout_events_[event.ssrc].push_back(event);
+  }
+  return true;
+}
+
+bool ParsedRtcEventLogNew::StoreDelayBasedBweUpdates(
+    const rtclog2::DelayBasedBweUpdates& proto) {
+  std::vector<int64_t> timestamps_us;
+  std::vector<uint64_t> bitrates_bps;
+  std::vector<uint64_t> detector_states;
+  if (!proto.has_timestamp_ms() ||
+      !DecodeBatchTimestamps(proto.timestamp_ms(), proto.timestamp_deltas_ms(),
+                             &timestamps_us) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_bitrate_bps(), proto.bitrate_bps()),
+          proto.bitrate_deltas_bps(), timestamps_us.size(), 32,
+          &bitrates_bps) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_detector_state(), proto.detector_state()),
+          proto.detector_state_deltas(), timestamps_us.size(), 32,
+          &detector_states)) {
+    RTC_LOG(LS_WARNING) << "Failed to decode batch of delay based BWE updates.";
+    return false;
+  }
+
+  for (size_t i = 0; i < timestamps_us.size(); ++i) {
+    if (!rtclog2::DelayBasedBweUpdates::DetectorState_IsValid(
+            static_cast<int>(detector_states[i]))) {
+      RTC_LOG(LS_WARNING) << "Unknown detector state in BWE update.";
+      return false;
+    }
+    LoggedBweDelayBasedUpdate update;
+    update.timestamp_us = timestamps_us[i];
+    update.bitrate_bps = static_cast<int32_t>(bitrates_bps[i]);
+    update.detector_state = GetRuntimeDetectorState(
+        static_cast<rtclog2::DelayBasedBweUpdates::DetectorState>(
+            detector_states[i]));
+    UpdateTimestampRange(update.timestamp_us);
+    bwe_delay_updates_.push_back(update);
+  }
+  return true;
+}
+
+bool ParsedRtcEventLogNew::StoreLossBasedBweUpdates(
+    const rtclog2::LossBasedBweUpdates& proto) {
+  std::vector<int64_t> timestamps_us;
+  std::vector<uint64_t> bitrates_bps;
+  std::vector<uint64_t> fraction_losses;
+  std::vector<uint64_t> total_packets;
+  if (!proto.has_timestamp_ms() ||
+      !DecodeBatchTimestamps(proto.timestamp_ms(), proto.timestamp_deltas_ms(),
+                             &timestamps_us) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_bitrate_bps(), proto.bitrate_bps()),
+          proto.bitrate_deltas_bps(), timestamps_us.size(), 32,
+          &bitrates_bps) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_fraction_loss(), proto.fraction_loss()),
+          proto.fraction_loss_deltas(), timestamps_us.size(), 8,
+          &fraction_losses) ||
+      !DecodeRequiredBatchField(
+          GetBaseValue(proto.has_total_packets(), proto.total_packets()),
+          proto.total_packets_deltas(), timestamps_us.size(), 32,
+          &total_packets)) {
+    RTC_LOG(LS_WARNING) << "Failed to decode batch of loss based BWE updates.";
+    return false;
+  }
+
+  for (size_t i = 0; i < timestamps_us.size(); ++i) {
+    LoggedBweLossBasedUpdate update;
+    update.timestamp_us = timestamps_us[i];
+    update.bitrate_bps = static_cast<int32_t>(bitrates_bps[i]);
+    update.fraction_lost = static_cast<uint8_t>(fraction_losses[i]);
+    update.expected_packets = static_cast<int32_t>(total_packets[i]);
+    UpdateTimestampRange(update.timestamp_us);
+    bwe_loss_updates_.push_back(update);
+  }
+  return true;
+}
+
+void ParsedRtcEventLogNew::StoreBweProbeCluster(
+    const rtclog2::BweProbeCluster& proto) {
+  LoggedBweProbeClusterCreatedEvent event;
+  RTC_CHECK(proto.has_timestamp_ms());
+  event.timestamp_us = proto.timestamp_ms() * 1000;
+  RTC_CHECK(proto.has_id());
+  event.id = proto.id();
+  RTC_CHECK(proto.has_bitrate_bps());
+  event.bitrate_bps = proto.bitrate_bps();
+  RTC_CHECK(proto.has_min_packets());
+  event.min_packets = proto.min_packets();
+  RTC_CHECK(proto.has_min_bytes());
+  event.min_bytes = proto.min_bytes();
+  UpdateTimestampRange(event.timestamp_us);
+  bwe_probe_cluster_created_events_.push_back(event);
+}
+
+void ParsedRtcEventLogNew::StoreBweProbeFailure(
+    const rtclog2::BweProbeResultFailure& proto) {
+  LoggedBweProbeFailureEvent event;
+  RTC_CHECK(proto.has_timestamp_ms());
+  event.timestamp_us = proto.timestamp_ms() * 1000;
+  RTC_CHECK(proto.has_id());
+  event.id = proto.id();
+  RTC_CHECK(proto.has_failure());
+  switch (proto.failure()) {
+    case rtclog2::BweProbeResultFailure::INVALID_SEND_RECEIVE_INTERVAL:
+      event.failure_reason = ProbeFailureReason::kInvalidSendReceiveInterval;
+      break;
+    case rtclog2::BweProbeResultFailure::INVALID_SEND_RECEIVE_RATIO:
+      event.failure_reason = ProbeFailureReason::kInvalidSendReceiveRatio;
+      break;
+    case rtclog2::BweProbeResultFailure::TIMEOUT:
+      event.failure_reason = ProbeFailureReason::kTimeout;
+      break;
+    case rtclog2::BweProbeResultFailure::UNKNOWN:
+      RTC_NOTREACHED();
+      return;
+  }
+  UpdateTimestampRange(event.timestamp_us);
+  bwe_probe_failure_events_.push_back(event);
+}
+
+void ParsedRtcEventLogNew::StoreBweProbeSuccess(
+    const rtclog2::BweProbeResultSuccess& proto) {
+  LoggedBweProbeSuccessEvent event;
+  RTC_CHECK(proto.has_timestamp_ms());
+  event.timestamp_us = proto.timestamp_ms() * 1000;
+  RTC_CHECK(proto.has_id());
+  event.id = proto.id();
+  RTC_CHECK(proto.has_bitrate_bps());
+  event.bitrate_bps = proto.bitrate_bps();
+  UpdateTimestampRange(event.timestamp_us);
+  bwe_probe_success_events_.push_back(event);
+}
+
 size_t ParsedRtcEventLogNew::GetNumberOfEvents() const {
   return events_.size();
 }
@@ -32,14 +32,17 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/function_view.h"
 #include "rtc_base/ignore_wundef.h"
 
 // Files generated at build-time by the protobuf compiler.
 RTC_PUSH_IGNORING_WUNDEF()
 #ifdef WEBRTC_ANDROID_PLATFORM_BUILD
 #include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log.pb.h"
+#include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log2.pb.h"
 #else
 #include "logging/rtc_event_log/rtc_event_log.pb.h"
+#include "logging/rtc_event_log/rtc_event_log2.pb.h"
 #endif
 RTC_POP_IGNORING_WUNDEF()
 
@@ -467,6 +470,7 @@ class PacketView {
 };
 
 class ParsedRtcEventLogNew {
+  friend class RtcEventLogStreamParser;
   friend class RtcEventLogTestHelper;
 
  public:
@@ -830,11 +834,33 @@ class ParsedRtcEventLogNew {
   int64_t last_timestamp() const { return last_timestamp_; }
 
  private:
+  // If |message_parsed| is set, it is called after the events of each message
+  // in |stream| have been stored, and the legacy events are not kept in
+  // |events_|.
   bool ParseStreamInternal(
-      std::istream& stream);  // no-presubmit-check TODO(webrtc:8982)
+      std::istream& stream,  // no-presubmit-check TODO(webrtc:8982)
+      rtc::FunctionView<void()> message_parsed);
 
   void StoreParsedEvent(const rtclog::Event& event);
 
+  // Stores the events of the new format in |event_stream|. Returns false if
+  // they are malformed.
+  bool StoreParsedNewFormatEvent(const rtclog2::EventStream& event_stream);
+  bool StoreAudioNetworkAdaptations(
+      const rtclog2::AudioNetworkAdaptations& proto);
+  bool StoreAudioPlayoutEvents(const rtclog2::AudioPlayoutEvents& proto);
+  bool StoreDelayBasedBweUpdates(const rtclog2::DelayBasedBweUpdates& proto);
+  bool StoreLossBasedBweUpdates(const rtclog2::LossBasedBweUpdates& proto);
+  void StoreBweProbeCluster(const rtclog2::BweProbeCluster& proto);
+  void StoreBweProbeFailure(const rtclog2::BweProbeResultFailure& proto);
+  void StoreBweProbeSuccess(const rtclog2::BweProbeResultSuccess& proto);
+
+  void StoreRtcpPacket(int64_t timestamp_us,
+                       PacketDirection direction,
+                       const uint8_t* packet,
+                       size_t total_length);
+  void UpdateTimestampRange(int64_t timestamp_us);
+
   rtclog::StreamConfig GetVideoReceiveConfig(const rtclog::Event& event) const;
   std::vector<rtclog::StreamConfig> GetVideoSendConfig(
       const rtclog::Event& event) const;
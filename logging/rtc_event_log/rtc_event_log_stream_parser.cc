@@ -0,0 +1,271 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/rtc_event_log_stream_parser.h"
+
+#include <fstream>  // no-presubmit-check TODO(webrtc:8982)
+#include <vector>
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+namespace {
+
+// Calls |deliver| for each of |events|, and then drops them.
+template <typename T, typename F>
+void DeliverAndClear(std::vector<T>* events, F deliver) {
+  for (const T& event : *events) {
+    deliver(event);
+  }
+  events->clear();
+}
+
+// Returns the SSRC of the sender of the first RTCP packet in |packet|, or 0 if
+// it is too short to have one.
+uint32_t GetRtcpSenderSsrc(const LoggedRtcpPacket& packet) {
+  if (packet.raw_data.size() < 8) {
+    return 0;
+  }
+  return ByteReader<uint32_t>::ReadBigEndian(packet.raw_data.data() + 4);
+}
+
+}  // namespace
+
+RtcEventLogStreamParser::Filter::Filter() = default;
+
+RtcEventLogStreamParser::Filter::Filter(const Filter&) = default;
+
+RtcEventLogStreamParser::Filter::~Filter() = default;
+
+RtcEventLogStreamParser::RtcEventLogStreamParser(
+    Handler* handler,
+    const Filter& filter,
+    ParsedRtcEventLogNew::UnconfiguredHeaderExtensions
+        parse_unconfigured_header_extensions)
+    : handler_(handler),
+      filter_(filter),
+      parsed_log_(parse_unconfigured_header_extensions) {
+  RTC_DCHECK(handler_);
+}
+
+RtcEventLogStreamParser::~RtcEventLogStreamParser() = default;
+
+bool RtcEventLogStreamParser::ParseFile(const std::string& file_name) {
+  std::ifstream file(  // no-presubmit-check TODO(webrtc:8982)
+      file_name, std::ios_base::in | std::ios_base::binary);
+  if (!file.good() || !file.is_open()) {
+    RTC_LOG(LS_WARNING) << "Could not open file for reading.";
+    return false;
+  }
+
+  return ParseStream(file);
+}
+
+bool RtcEventLogStreamParser::ParseStream(
+    std::istream& stream) {  // no-presubmit-check TODO(webrtc:8982)
+  parsed_log_.Clear();
+  return parsed_log_.ParseStreamInternal(stream,
+                                         [this] { DeliverParsedEvents(); });
+}
+
+bool RtcEventLogStreamParser::IsTypeSelected(EventType type) const {
+  return filter_.event_types.empty() || filter_.event_types.count(type) > 0;
+}
+
+bool RtcEventLogStreamParser::IsSsrcSelected(uint32_t ssrc) const {
+  return filter_.ssrcs.empty() || filter_.ssrcs.count(ssrc) > 0;
+}
+
+void RtcEventLogStreamParser::DeliverParsedEvents() {
+  ParsedRtcEventLogNew& log = parsed_log_;
+  const bool selected_start = IsTypeSelected(EventType::LOG_START);
+  DeliverAndClear(&log.start_log_events_, [&](const LoggedStartEvent& event) {
+    if (selected_start)
+      handler_->OnLogStart(event);
+  });
+  const bool selected_end = IsTypeSelected(EventType::LOG_END);
+  DeliverAndClear(&log.stop_log_events_, [&](const LoggedStopEvent& event) {
+    if (selected_end)
+      handler_->OnLogEnd(event);
+  });
+
+  const bool selected_audio_recv_config =
+      IsTypeSelected(EventType::AUDIO_RECEIVER_CONFIG_EVENT);
+  DeliverAndClear(&log.audio_recv_configs_,
+                  [&](const LoggedAudioRecvConfig& config) {
+                    if (selected_audio_recv_config)
+                      handler_->OnAudioRecvConfig(config);
+                  });
+  const bool selected_audio_send_config =
+      IsTypeSelected(EventType::AUDIO_SENDER_CONFIG_EVENT);
+  DeliverAndClear(&log.audio_send_configs_,
+                  [&](const LoggedAudioSendConfig& config) {
+                    if (selected_audio_send_config)
+                      handler_->OnAudioSendConfig(config);
+                  });
+  const bool selected_video_recv_config =
+      IsTypeSelected(EventType::VIDEO_RECEIVER_CONFIG_EVENT);
+  DeliverAndClear(&log.video_recv_configs_,
+                  [&](const LoggedVideoRecvConfig& config) {
+                    if (selected_video_recv_config)
+                      handler_->OnVideoRecvConfig(config);
+                  });
+  const bool selected_video_send_config =
+      IsTypeSelected(EventType::VIDEO_SENDER_CONFIG_EVENT);
+  DeliverAndClear(&log.video_send_configs_,
+                  [&](const LoggedVideoSendConfig& config) {
+                    if (selected_video_send_config)
+                      handler_->OnVideoSendConfig(config);
+                  });
+
+  // The RTP packets are grouped by SSRC until the parsing is done.
+  const bool selected_rtp = IsTypeSelected(EventType::RTP_EVENT);
+  for (auto& kv : log.incoming_rtp_packets_map_) {
+    if (selected_rtp && IsSsrcSelected(kv.first)) {
+      for (const LoggedRtpPacketIncoming& packet : kv.second)
+        handler_->OnRtpPacketIncoming(packet);
+    }
+  }
+  log.incoming_rtp_packets_map_.clear();
+  for (auto& kv : log.outgoing_rtp_packets_map_) {
+    if (selected_rtp && IsSsrcSelected(kv.first)) {
+      for (const LoggedRtpPacketOutgoing& packet : kv.second)
+        handler_->OnRtpPacketOutgoing(packet);
+    }
+  }
+  log.outgoing_rtp_packets_map_.clear();
+
+  const bool selected_rtcp = IsTypeSelected(EventType::RTCP_EVENT);
+  DeliverAndClear(&log.incoming_rtcp_packets_,
+                  [&](const LoggedRtcpPacketIncoming& packet) {
+                    if (selected_rtcp &&
+                        IsSsrcSelected(GetRtcpSenderSsrc(packet.rtcp)))
+                      handler_->OnRtcpPacketIncoming(packet);
+                  });
+  DeliverAndClear(&log.outgoing_rtcp_packets_,
+                  [&](const LoggedRtcpPacketOutgoing& packet) {
+                    if (selected_rtcp &&
+                        IsSsrcSelected(GetRtcpSenderSsrc(packet.rtcp)))
+                      handler_->OnRtcpPacketOutgoing(packet);
+                  });
+  for (PacketDirection direction : {kIncomingPacket, kOutgoingPacket}) {
+    const bool incoming = direction == kIncomingPacket;
+    DeliverAndClear(
+        incoming ? &log.incoming_rr_ : &log.outgoing_rr_,
+        [&](const LoggedRtcpPacketReceiverReport& report) {
+          if (selected_rtcp && IsSsrcSelected(report.rr.sender_ssrc()))
+            handler_->OnReceiverReport(direction, report);
+        });
+    DeliverAndClear(
+        incoming ? &log.incoming_sr_ : &log.outgoing_sr_,
+        [&](const LoggedRtcpPacketSenderReport& report) {
+          if (selected_rtcp && IsSsrcSelected(report.sr.sender_ssrc()))
+            handler_->OnSenderReport(direction, report);
+        });
+    DeliverAndClear(incoming ? &log.incoming_nack_ : &log.outgoing_nack_,
+                    [&](const LoggedRtcpPacketNack& nack) {
+                      if (selected_rtcp &&
+                          IsSsrcSelected(nack.nack.sender_ssrc()))
+                        handler_->OnNack(direction, nack);
+                    });
+    DeliverAndClear(incoming ? &log.incoming_remb_ : &log.outgoing_remb_,
+                    [&](const LoggedRtcpPacketRemb& remb) {
+                      if (selected_rtcp &&
+                          IsSsrcSelected(remb.remb.sender_ssrc()))
+                        handler_->OnRemb(direction, remb);
+                    });
+    DeliverAndClear(
+        incoming ? &log.incoming_transport_feedback_
+                 : &log.outgoing_transport_feedback_,
+        [&](const LoggedRtcpPacketTransportFeedback& feedback) {
+          if (selected_rtcp &&
+              IsSsrcSelected(feedback.transport_feedback.sender_ssrc()))
+            handler_->OnTransportFeedback(direction, feedback);
+        });
+  }
+
+  const bool selected_playout = IsTypeSelected(EventType::AUDIO_PLAYOUT_EVENT);
+  for (auto& kv : log.audio_playout_events_) {
+    if (selected_playout && IsSsrcSelected(kv.first)) {
+      for (const LoggedAudioPlayoutEvent& event : kv.second)
+        handler_->OnAudioPlayout(event);
+    }
+  }
+  log.audio_playout_events_.clear();
+  const bool selected_ana =
+      IsTypeSelected(EventType::AUDIO_NETWORK_ADAPTATION_EVENT);
+  DeliverAndClear(&log.audio_network_adaptation_events_,
+                  [&](const LoggedAudioNetworkAdaptationEvent& event) {
+                    if (selected_ana)
+                      handler_->OnAudioNetworkAdaptation(event);
+                  });
+
+  const bool selected_delay_bwe =
+      IsTypeSelected(EventType::DELAY_BASED_BWE_UPDATE);
+  DeliverAndClear(&log.bwe_delay_updates_,
+                  [&](const LoggedBweDelayBasedUpdate& update) {
+                    if (selected_delay_bwe)
+                      handler_->OnBweDelayBasedUpdate(update);
+                  });
+  const bool selected_loss_bwe =
+      IsTypeSelected(EventType::LOSS_BASED_BWE_UPDATE);
+  DeliverAndClear(&log.bwe_loss_updates_,
+                  [&](const LoggedBweLossBasedUpdate& update) {
+                    if (selected_loss_bwe)
+                      handler_->OnBweLossBasedUpdate(update);
+                  });
+  const bool selected_probe_cluster =
+      IsTypeSelected(EventType::BWE_PROBE_CLUSTER_CREATED_EVENT);
+  DeliverAndClear(&log.bwe_probe_cluster_created_events_,
+                  [&](const LoggedBweProbeClusterCreatedEvent& event) {
+                    if (selected_probe_cluster)
+                      handler_->OnBweProbeClusterCreated(event);
+                  });
+  const bool selected_probe_failure =
+      IsTypeSelected(EventType::BWE_PROBE_FAILURE_EVENT);
+  DeliverAndClear(&log.bwe_probe_failure_events_,
+                  [&](const LoggedBweProbeFailureEvent& event) {
+                    if (selected_probe_failure)
+                      handler_->OnBweProbeFailure(event);
+                  });
+  const bool selected_probe_success =
+      IsTypeSelected(EventType::BWE_PROBE_SUCCESS_EVENT);
+  DeliverAndClear(&log.bwe_probe_success_events_,
+                  [&](const LoggedBweProbeSuccessEvent& event) {
+                    if (selected_probe_success)
+                      handler_->OnBweProbeSuccess(event);
+                  });
+  const bool selected_alr = IsTypeSelected(EventType::ALR_STATE_EVENT);
+  DeliverAndClear(&log.alr_state_events_,
+                  [&](const LoggedAlrStateEvent& event) {
+                    if (selected_alr)
+                      handler_->OnAlrState(event);
+                  });
+
+  const bool selected_ice_config =
+      IsTypeSelected(EventType::ICE_CANDIDATE_PAIR_CONFIG);
+  DeliverAndClear(&log.ice_candidate_pair_configs_,
+                  [&](const LoggedIceCandidatePairConfig& config) {
+                    if (selected_ice_config)
+                      handler_->OnIceCandidatePairConfig(config);
+                  });
+  const bool selected_ice_event =
+      IsTypeSelected(EventType::ICE_CANDIDATE_PAIR_EVENT);
+  DeliverAndClear(&log.ice_candidate_pair_events_,
+                  [&](const LoggedIceCandidatePairEvent& event) {
+                    if (selected_ice_event)
+                      handler_->OnIceCandidatePairEvent(event);
+                  });
+}
+
+}  // namespace webrtc
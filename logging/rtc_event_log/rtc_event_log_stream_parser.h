@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_STREAM_PARSER_H_
+#define LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_STREAM_PARSER_H_
+
+#include <set>
+#include <string>
+
+#include "logging/rtc_event_log/rtc_event_log_parser_new.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Parses an RtcEventLog one message at a time and hands each event to a
+// Handler as soon as it has been read, instead of keeping it. Only the stream
+// configurations needed to parse the RTP header extensions are remembered, so
+// logs of any length are processed in bounded memory.
+//
+// The events of a legacy log are delivered in log order. A message of the new
+// format holds a batch of events, which are delivered grouped by type.
+class RtcEventLogStreamParser {
+ public:
+  using EventType = ParsedRtcEventLogNew::EventType;
+
+  // All methods are no-ops by default, so a Handler only needs to override
+  // the events it is interested in.
+  class Handler {
+   public:
+    virtual ~Handler() = default;
+
+    virtual void OnLogStart(const LoggedStartEvent& event) {}
+    virtual void OnLogEnd(const LoggedStopEvent& event) {}
+
+    virtual void OnAudioRecvConfig(const LoggedAudioRecvConfig& config) {}
+    virtual void OnAudioSendConfig(const LoggedAudioSendConfig& config) {}
+    virtual void OnVideoRecvConfig(const LoggedVideoRecvConfig& config) {}
+    virtual void OnVideoSendConfig(const LoggedVideoSendConfig& config) {}
+
+    virtual void OnRtpPacketIncoming(const LoggedRtpPacketIncoming& packet) {}
+    virtual void OnRtpPacketOutgoing(const LoggedRtpPacketOutgoing& packet) {}
+
+    virtual void OnRtcpPacketIncoming(const LoggedRtcpPacketIncoming& packet) {
+    }
+    virtual void OnRtcpPacketOutgoing(const LoggedRtcpPacketOutgoing& packet) {
+    }
+    virtual void OnReceiverReport(
+        PacketDirection direction,
+        const LoggedRtcpPacketReceiverReport& report) {}
+    virtual void OnSenderReport(PacketDirection direction,
+                                const LoggedRtcpPacketSenderReport& report) {}
+    virtual void OnNack(PacketDirection direction,
+                        const LoggedRtcpPacketNack& nack) {}
+    virtual void OnRemb(PacketDirection direction,
+                        const LoggedRtcpPacketRemb& remb) {}
+    virtual void OnTransportFeedback(
+        PacketDirection direction,
+        const LoggedRtcpPacketTransportFeedback& feedback) {}
+
+    virtual void OnAudioPlayout(const LoggedAudioPlayoutEvent& event) {}
+    virtual void OnAudioNetworkAdaptation(
+        const LoggedAudioNetworkAdaptationEvent& event) {}
+
+    virtual void OnBweDelayBasedUpdate(
+        const LoggedBweDelayBasedUpdate& update) {}
+    virtual void OnBweLossBasedUpdate(const LoggedBweLossBasedUpdate& update) {}
+    virtual void OnBweProbeClusterCreated(
+        const LoggedBweProbeClusterCreatedEvent& event) {}
+    virtual void OnBweProbeFailure(const LoggedBweProbeFailureEvent& event) {}
+    virtual void OnBweProbeSuccess(const LoggedBweProbeSuccessEvent& event) {}
+    virtual void OnAlrState(const LoggedAlrStateEvent& event) {}
+
+    virtual void OnIceCandidatePairConfig(
+        const LoggedIceCandidatePairConfig& config) {}
+    virtual void OnIceCandidatePairEvent(
+        const LoggedIceCandidatePairEvent& event) {}
+  };
+
+  // Selects the events which are handed to the Handler. An empty set lets
+  // everything through.
+  struct Filter {
+    Filter();
+    Filter(const Filter&);
+    ~Filter();
+
+    std::set<EventType> event_types;
+    // Applies to RTP packets, to RTCP packets by their sender SSRC and to
+    // audio playout events.
+    std::set<uint32_t> ssrcs;
+  };
+
+  // |handler| must outlive the parser.
+  RtcEventLogStreamParser(
+      Handler* handler,
+      const Filter& filter,
+      ParsedRtcEventLogNew::UnconfiguredHeaderExtensions
+          parse_unconfigured_header_extensions =
+              ParsedRtcEventLogNew::UnconfiguredHeaderExtensions::kDontParse);
+  ~RtcEventLogStreamParser();
+
+  // Parses an RtcEventLog file, and returns true if the whole file could be
+  // parsed. The events before a parsing error have already been handed to the
+  // Handler when false is returned.
+  bool ParseFile(const std::string& file_name);
+
+  // Like ParseFile(), for a log in an istream.
+  bool ParseStream(
+      std::istream& stream);  // no-presubmit-check TODO(webrtc:8982)
+
+  int64_t first_timestamp() const { return parsed_log_.first_timestamp(); }
+  int64_t last_timestamp() const { return parsed_log_.last_timestamp(); }
+
+ private:
+  bool IsTypeSelected(EventType type) const;
+  bool IsSsrcSelected(uint32_t ssrc) const;
+
+  // Hands the events stored in |parsed_log_| by the last message to the
+  // Handler, and drops them.
+  void DeliverParsedEvents();
+
+  Handler* const handler_;
+  const Filter filter_;
+  ParsedRtcEventLogNew parsed_log_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtcEventLogStreamParser);
+};
+
+}  // namespace webrtc
+
+#endif  // LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_STREAM_PARSER_H_
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/rtc_event_log_stream_parser.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_loss_based.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_incoming.h"
+#include "logging/rtc_event_log/rtc_event_log_unittest_helper.h"
+#include "rtc_base/fakeclock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint32_t kSsrcs[] = {0x1234, 0x5678};
+const size_t kNumRtpPackets = 10;
+
+class RecordingHandler : public RtcEventLogStreamParser::Handler {
+ public:
+  void OnLogStart(const LoggedStartEvent& event) override {
+    timestamps_us.push_back(event.timestamp_us);
+    ++num_log_starts;
+  }
+  void OnLogEnd(const LoggedStopEvent& event) override {
+    timestamps_us.push_back(event.timestamp_us);
+    ++num_log_ends;
+  }
+  void OnRtpPacketIncoming(const LoggedRtpPacketIncoming& packet) override {
+    timestamps_us.push_back(packet.log_time_us());
+    rtp_packets.push_back(packet);
+  }
+  void OnRtcpPacketIncoming(const LoggedRtcpPacketIncoming& packet) override {
+    timestamps_us.push_back(packet.log_time_us());
+    ++num_rtcp_packets;
+  }
+  void OnBweLossBasedUpdate(const LoggedBweLossBasedUpdate& update) override {
+    timestamps_us.push_back(update.log_time_us());
+    ++num_loss_based_updates;
+  }
+
+  std::vector<int64_t> timestamps_us;
+  std::vector<LoggedRtpPacketIncoming> rtp_packets;
+  int num_log_starts = 0;
+  int num_log_ends = 0;
+  int num_rtcp_packets = 0;
+  int num_loss_based_updates = 0;
+};
+
+class RtcEventLogStreamParserTest
+    : public testing::TestWithParam<RtcEventLog::EncodingType> {
+ protected:
+  RtcEventLogStreamParserTest() : gen_(1) {
+    // The new format stores timestamps with millisecond precision.
+    fake_clock_.SetTimeMicros(1000000);
+    if (GetParam() == RtcEventLog::EncodingType::Legacy) {
+      encoder_ = absl::make_unique<RtcEventLogEncoderLegacy>();
+    } else {
+      encoder_ = absl::make_unique<RtcEventLogEncoderNewFormat>();
+    }
+  }
+
+  // Writes a log with a start event, RTP packets alternating between the two
+  // SSRCs, an RTCP packet, a loss based BWE update and an end event.
+  std::string CreateLog() {
+    std::string log = encoder_->EncodeLogStart(rtc::TimeMicros());
+    std::deque<std::unique_ptr<RtcEvent>> history;
+    RtpHeaderExtensionMap extension_map;
+    for (size_t i = 0; i < kNumRtpPackets; ++i) {
+      fake_clock_.AdvanceTimeMicros(1000);
+      rtp_events_.push_back(
+          gen_.NewRtpPacketIncoming(kSsrcs[i % 2], extension_map));
+      history.push_back(rtp_events_.back()->Copy());
+    }
+    fake_clock_.AdvanceTimeMicros(1000);
+    history.push_back(gen_.NewRtcpPacketIncoming());
+    history.push_back(gen_.NewBweUpdateLossBased());
+    log += encoder_->EncodeBatch(history.begin(), history.end());
+    log += encoder_->EncodeLogEnd(rtc::TimeMicros());
+    return log;
+  }
+
+  bool Parse(const std::string& log,
+             const RtcEventLogStreamParser::Filter& filter,
+             RecordingHandler* handler) {
+    std::istringstream stream(  // no-presubmit-check TODO(webrtc:8982)
+        log, std::ios_base::in | std::ios_base::binary);
+    RtcEventLogStreamParser parser(handler, filter);
+    return parser.ParseStream(stream);
+  }
+
+  rtc::ScopedFakeClock fake_clock_;
+  test::EventGenerator gen_;
+  std::unique_ptr<RtcEventLogEncoder> encoder_;
+  std::vector<std::unique_ptr<RtcEventRtpPacketIncoming>> rtp_events_;
+};
+
+TEST_P(RtcEventLogStreamParserTest, DeliversAllEvents) {
+  const std::string log = CreateLog();
+  RecordingHandler handler;
+  ASSERT_TRUE(Parse(log, RtcEventLogStreamParser::Filter(), &handler));
+
+  EXPECT_EQ(handler.num_log_starts, 1);
+  EXPECT_EQ(handler.num_log_ends, 1);
+  EXPECT_EQ(handler.num_rtcp_packets, 1);
+  EXPECT_EQ(handler.num_loss_based_updates, 1);
+  ASSERT_EQ(handler.rtp_packets.size(), kNumRtpPackets);
+  for (const LoggedRtpPacketIncoming& packet : handler.rtp_packets) {
+    bool found = false;
+    for (const auto& event : rtp_events_) {
+      if (event->header_.SequenceNumber() ==
+              packet.rtp.header.sequenceNumber &&
+          event->header_.Ssrc() == packet.rtp.header.ssrc) {
+        EXPECT_TRUE(test::VerifyLoggedRtpPacketIncoming(*event, packet));
+        found = true;
+      }
+    }
+    EXPECT_TRUE(found);
+  }
+}
+
+TEST_P(RtcEventLogStreamParserTest, DeliversLegacyEventsInLogOrder) {
+  if (GetParam() != RtcEventLog::EncodingType::Legacy) {
+    // Batches of the new format are delivered grouped by type.
+    return;
+  }
+  const std::string log = CreateLog();
+  RecordingHandler handler;
+  ASSERT_TRUE(Parse(log, RtcEventLogStreamParser::Filter(), &handler));
+
+  ASSERT_EQ(handler.timestamps_us.size(), kNumRtpPackets + 4);
+  EXPECT_TRUE(std::is_sorted(handler.timestamps_us.begin(),
+                             handler.timestamps_us.end()));
+  for (size_t i = 0; i < kNumRtpPackets; ++i) {
+    EXPECT_TRUE(test::VerifyLoggedRtpPacketIncoming(*rtp_events_[i],
+                                                    handler.rtp_packets[i]));
+  }
+}
+
+TEST_P(RtcEventLogStreamParserTest, FiltersByEventTypeAndSsrc) {
+  const std::string log = CreateLog();
+  RtcEventLogStreamParser::Filter filter;
+  filter.event_types.insert(RtcEventLogStreamParser::EventType::RTP_EVENT);
+  filter.event_types.insert(RtcEventLogStreamParser::EventType::LOG_END);
+  filter.ssrcs.insert(kSsrcs[1]);
+  RecordingHandler handler;
+  ASSERT_TRUE(Parse(log, filter, &handler));
+
+  EXPECT_EQ(handler.num_log_starts, 0);
+  EXPECT_EQ(handler.num_log_ends, 1);
+  EXPECT_EQ(handler.num_loss_based_updates, 0);
+  ASSERT_EQ(handler.rtp_packets.size(), kNumRtpPackets / 2);
+  for (const LoggedRtpPacketIncoming& packet : handler.rtp_packets) {
+    EXPECT_EQ(packet.rtp.header.ssrc, kSsrcs[1]);
+  }
+}
+
+TEST_P(RtcEventLogStreamParserTest, KeepsEventsBeforeParsingError) {
+  std::string log = CreateLog();
+  // Cut the log in the middle of the end event.
+  log.resize(log.size() - 1);
+  RecordingHandler handler;
+  EXPECT_FALSE(Parse(log, RtcEventLogStreamParser::Filter(), &handler));
+
+  EXPECT_EQ(handler.num_log_starts, 1);
+  EXPECT_EQ(handler.rtp_packets.size(), kNumRtpPackets);
+  EXPECT_EQ(handler.num_log_ends, 0);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    EncodingTypes,
+    RtcEventLogStreamParserTest,
+    ::testing::Values(RtcEventLog::EncodingType::Legacy,
+                      RtcEventLog::EncodingType::NewFormat));
+
+}  // namespace
+
+}  // namespace webrtc
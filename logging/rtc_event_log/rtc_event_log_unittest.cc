@@ -40,8 +40,10 @@
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/fakeclock.h"
 #include "rtc_base/random.h"
+#include "rtc_base/task_queue.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
 
@@ -758,6 +760,43 @@ TEST(RtcEventLogTest, CircularBufferKeepsMostRecentEvents) {
   }
 }
 
+TEST(RtcEventLogTest, DropsNewestEventsWhileTaskQueueIsStalled) {
+  constexpr size_t kNumEvents = 20000;
+  constexpr int32_t kStartBitrate = 1000000;
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  std::string test_name =
+      std::string(test_info->test_case_name()) + "_" + test_info->name();
+  const std::string temp_filename = test::OutputPath() + test_name;
+
+  auto task_queue = absl::make_unique<rtc::TaskQueue>("rtc_event_log");
+  rtc::Event unstall(false, false);
+  task_queue->PostTask([&unstall] { unstall.Wait(rtc::Event::kForever); });
+  std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create(
+      RtcEventLog::EncodingType::Legacy, std::move(task_queue)));
+
+  // Nothing can be moved out of the pending events while the task queue is
+  // blocked, so only the first events fit.
+  for (size_t i = 0; i < kNumEvents; i++) {
+    log_dumper->Log(absl::make_unique<RtcEventProbeResultSuccess>(
+        i, kStartBitrate + i * 1000));
+  }
+  unstall.Set();
+  log_dumper->StartLogging(
+      absl::make_unique<RtcEventLogOutputFile>(temp_filename, 10000000),
+      RtcEventLog::kImmediateOutput);
+  log_dumper->StopLogging();
+
+  ParsedRtcEventLogNew parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+  const auto& probe_success_events = parsed_log.bwe_probe_success_events();
+  ASSERT_GT(probe_success_events.size(), 1u);
+  EXPECT_LT(probe_success_events.size(), kNumEvents);
+  for (size_t i = 0; i < probe_success_events.size(); i++) {
+    ASSERT_EQ(static_cast<int>(i), probe_success_events[i].id);
+  }
+}
+
 // TODO(terelius): Verify parser behavior if the timestamps are not
 // monotonically increasing in the log.
 
@@ -47,10 +47,11 @@ void AdaptedVideoTrackSource::OnFrame(const webrtc::VideoFrame& frame) {
      synchronization for us in this case, by not passing the frame on
      to sinks which don't want it. */
   if (apply_rotation() && frame.rotation() != webrtc::kVideoRotation_0 &&
-      buffer->type() == webrtc::VideoFrameBuffer::Type::kI420) {
-    /* Apply pending rotation. */
+      (buffer->type() == webrtc::VideoFrameBuffer::Type::kI420 ||
+       buffer->type() == webrtc::VideoFrameBuffer::Type::kNV12)) {
+    /* Apply pending rotation. NV12 frames are rotated in I420. */
     broadcaster_.OnFrame(webrtc::VideoFrame(
-        webrtc::I420Buffer::Rotate(*buffer->GetI420(), frame.rotation()),
+        webrtc::I420Buffer::Rotate(*buffer->ToI420(), frame.rotation()),
         webrtc::kVideoRotation_0, frame.timestamp_us()));
   } else {
     broadcaster_.OnFrame(frame);
@@ -103,6 +104,12 @@ bool AdaptedVideoTrackSource::AdaptFrame(int width,
     return false;
   }
 
+  if (broadcaster_.sinks_busy()) {
+    // Drop the frame before it is converted and scaled.
+    broadcaster_.OnDiscardedFrame();
+    return false;
+  }
+
   if (!video_adapter_.AdaptFrameResolution(
           width, height, time_us * rtc::kNumNanosecsPerMicrosec, crop_width,
           crop_height, out_width, out_height)) {
@@ -520,6 +520,7 @@ struct VideoReceiverInfo : public MediaReceiverInfo {
   // Timing frame info: all important timestamps for a full lifetime of a
   // single 'timing frame'.
   absl::optional<webrtc::TimingFrameInfo> timing_frame_info;
+  std::vector<webrtc::FrameLatencyStageStats> frame_latency_stages;
 };
 
 struct DataSenderInfo : public MediaSenderInfo {
@@ -59,6 +59,14 @@ struct MediaConfig {
     // TODO(bugs.webrtc.org/8504): If all goes well, the flag will be removed
     // together with the old method of estimation.
     bool experiment_cpu_load_estimator = false;
+
+    // Makes cpu adaptation first speed up the encoder, at the cost of some
+    // quality per bit, and only then reduce the resolution or framerate.
+    bool encoder_speed_adaptation = false;
+
+    // Makes sources drop the frames that arrive while the encoder is still
+    // behind, before they are converted and scaled.
+    bool drop_frames_at_source = false;
   } video;
 
   bool operator==(const MediaConfig& o) const {
@@ -71,7 +79,10 @@ struct MediaConfig {
            video.periodic_alr_bandwidth_probing ==
                o.video.periodic_alr_bandwidth_probing &&
            video.experiment_cpu_load_estimator ==
-               o.video.experiment_cpu_load_estimator;
+               o.video.experiment_cpu_load_estimator &&
+           video.encoder_speed_adaptation ==
+               o.video.encoder_speed_adaptation &&
+           video.drop_frames_at_source == o.video.drop_frames_at_source;
   }
 
   bool operator!=(const MediaConfig& o) const { return !(*this == o); }
@@ -17,6 +17,8 @@
 #include <utility>
 
 #include "absl/types/optional.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "media/base/mediaconstants.h"
 #include "media/base/videocommon.h"
 #include "rtc_base/arraysize.h"
@@ -273,4 +275,38 @@ void VideoAdapter::OnResolutionFramerateRequest(
   max_framerate_request_ = max_framerate_fps;
 }
 
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> CropAndScaleFrameBuffer(
+    const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+    int crop_x,
+    int crop_y,
+    int crop_width,
+    int crop_height,
+    int out_width,
+    int out_height) {
+  switch (buffer->type()) {
+    case webrtc::VideoFrameBuffer::Type::kNative: {
+      rtc::scoped_refptr<webrtc::VideoFrameBuffer> scaled_buffer =
+          buffer->CropAndScaleNative(crop_x, crop_y, crop_width, crop_height,
+                                     out_width, out_height);
+      if (scaled_buffer)
+        return scaled_buffer;
+      break;
+    }
+    case webrtc::VideoFrameBuffer::Type::kNV12: {
+      rtc::scoped_refptr<webrtc::NV12Buffer> nv12_buffer =
+          webrtc::NV12Buffer::Create(out_width, out_height);
+      nv12_buffer->CropAndScaleFrom(*buffer->GetNV12(), crop_x, crop_y,
+                                    crop_width, crop_height);
+      return nv12_buffer;
+    }
+    default:
+      break;
+  }
+  rtc::scoped_refptr<webrtc::I420Buffer> i420_buffer =
+      webrtc::I420Buffer::Create(out_width, out_height);
+  i420_buffer->CropAndScaleFrom(*buffer->ToI420(), crop_x, crop_y, crop_width,
+                                crop_height);
+  return i420_buffer;
+}
+
 }  // namespace cricket
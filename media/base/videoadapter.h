@@ -12,9 +12,11 @@
 #define MEDIA_BASE_VIDEOADAPTER_H_
 
 #include "absl/types/optional.h"
+#include "api/video/video_frame_buffer.h"
 #include "media/base/videocommon.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace cricket {
 
@@ -93,6 +95,20 @@ class VideoAdapter {
   RTC_DISALLOW_COPY_AND_ASSIGN(VideoAdapter);
 };
 
+// Crops the |crop_width| x |crop_height| rectangle at (|crop_x|, |crop_y|) of
+// |buffer| and scales it to |out_width| x |out_height|, as decided by
+// VideoAdapter::AdaptFrameResolution(). kNative buffers that support it are
+// cropped and scaled natively, e.g. on the GPU, and NV12 buffers stay NV12;
+// other buffers are converted to I420.
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> CropAndScaleFrameBuffer(
+    const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+    int crop_x,
+    int crop_y,
+    int crop_width,
+    int crop_height,
+    int out_width,
+    int out_height);
+
 }  // namespace cricket
 
 #endif  // MEDIA_BASE_VIDEOADAPTER_H_
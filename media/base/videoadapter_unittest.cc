@@ -16,18 +16,62 @@
 #include <vector>
 
 #include "absl/memory/memory.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "media/base/fakeframesource.h"
 #include "media/base/mediachannel.h"
 #include "media/base/testutils.h"
 #include "media/base/videoadapter.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/refcountedobject.h"
 
 namespace cricket {
 namespace {
 const int kWidth = 1280;
 const int kHeight = 720;
 const int kDefaultFps = 30;
+
+// A native buffer that records how it was cropped and scaled, or is converted
+// to I420 if it can't be.
+class FakeNativeBuffer : public webrtc::VideoFrameBuffer {
+ public:
+  FakeNativeBuffer(int width, int height, bool scalable)
+      : width_(width), height_(height), scalable_(scalable) {}
+
+  Type type() const override { return Type::kNative; }
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+  rtc::scoped_refptr<webrtc::I420BufferInterface> ToI420() override {
+    return webrtc::I420Buffer::Create(width_, height_);
+  }
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> CropAndScaleNative(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override {
+    if (!scalable_)
+      return nullptr;
+    crop_x_ = offset_x;
+    crop_y_ = offset_y;
+    crop_width_ = crop_width;
+    crop_height_ = crop_height;
+    return new rtc::RefCountedObject<FakeNativeBuffer>(scaled_width,
+                                                       scaled_height, true);
+  }
+
+  int crop_x_ = -1;
+  int crop_y_ = -1;
+  int crop_width_ = -1;
+  int crop_height_ = -1;
+
+ private:
+  const int width_;
+  const int height_;
+  const bool scalable_;
+};
 }  // namespace
 
 class VideoAdapterTest : public testing::Test {
@@ -1074,4 +1118,40 @@ TEST_F(VideoAdapterTest, TestAdaptToMax) {
   EXPECT_EQ(640, out_width_);
   EXPECT_EQ(360, out_height_);
 }
+
+TEST(CropAndScaleFrameBufferTest, CropsAndScalesNativeBuffersNatively) {
+  rtc::scoped_refptr<FakeNativeBuffer> buffer(
+      new rtc::RefCountedObject<FakeNativeBuffer>(kWidth, kHeight, true));
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> scaled_buffer =
+      CropAndScaleFrameBuffer(buffer, 160, 0, 960, 720, 640, 480);
+  EXPECT_EQ(webrtc::VideoFrameBuffer::Type::kNative, scaled_buffer->type());
+  EXPECT_EQ(640, scaled_buffer->width());
+  EXPECT_EQ(480, scaled_buffer->height());
+  EXPECT_EQ(160, buffer->crop_x_);
+  EXPECT_EQ(0, buffer->crop_y_);
+  EXPECT_EQ(960, buffer->crop_width_);
+  EXPECT_EQ(720, buffer->crop_height_);
+}
+
+TEST(CropAndScaleFrameBufferTest, ConvertsUnscalableNativeBuffersToI420) {
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer(
+      new rtc::RefCountedObject<FakeNativeBuffer>(kWidth, kHeight, false));
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> scaled_buffer =
+      CropAndScaleFrameBuffer(buffer, 160, 0, 960, 720, 640, 480);
+  EXPECT_EQ(webrtc::VideoFrameBuffer::Type::kI420, scaled_buffer->type());
+  EXPECT_EQ(640, scaled_buffer->width());
+  EXPECT_EQ(480, scaled_buffer->height());
+}
+
+TEST(CropAndScaleFrameBufferTest, KeepsNV12BuffersInNV12) {
+  rtc::scoped_refptr<webrtc::NV12Buffer> buffer =
+      webrtc::NV12Buffer::Create(kWidth, kHeight);
+  buffer->InitializeData();
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> scaled_buffer =
+      CropAndScaleFrameBuffer(buffer, 160, 0, 960, 720, 640, 480);
+  EXPECT_EQ(webrtc::VideoFrameBuffer::Type::kNV12, scaled_buffer->type());
+  EXPECT_EQ(640, scaled_buffer->width());
+  EXPECT_EQ(480, scaled_buffer->height());
+}
+
 }  // namespace cricket
@@ -10,15 +10,39 @@
 
 #include "media/base/videobroadcaster.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <limits>
 
+#include "absl/memory/memory.h"
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
+#include "rtc_base/atomicops.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/logging.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace rtc {
 
-VideoBroadcaster::VideoBroadcaster() {
+namespace {
+
+const char kParallelDeliveryFieldTrial[] =
+    "WebRTC-VideoBroadcaster-ParallelDelivery";
+const char kScaleForSinksFieldTrial[] = "WebRTC-VideoBroadcaster-ScaleForSinks";
+
+// Beyond this, sinks share the queues.
+const int kMaxDeliveryQueues = 4;
+
+}  // namespace
+
+VideoBroadcaster::VideoBroadcaster()
+    : deliver_in_parallel_(
+          webrtc::field_trial::IsEnabled(kParallelDeliveryFieldTrial)),
+      scale_for_sinks_(
+          webrtc::field_trial::IsEnabled(kScaleForSinksFieldTrial)) {
   thread_checker_.DetachFromThread();
 }
 VideoBroadcaster::~VideoBroadcaster() = default;
@@ -47,6 +71,15 @@ bool VideoBroadcaster::frame_wanted() const {
   return !sink_pairs().empty();
 }
 
+bool VideoBroadcaster::sinks_busy() const {
+  rtc::CritScope cs(&sinks_and_wants_lock_);
+  for (const auto& sink_pair : sink_pairs()) {
+    if (!sink_pair.wants.is_busy || !sink_pair.wants.is_busy())
+      return false;
+  }
+  return !sink_pairs().empty();
+}
+
 VideoSinkWants VideoBroadcaster::wants() const {
   rtc::CritScope cs(&sinks_and_wants_lock_);
   return current_wants_;
@@ -54,6 +87,10 @@ VideoSinkWants VideoBroadcaster::wants() const {
 
 void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
   rtc::CritScope cs(&sinks_and_wants_lock_);
+  std::vector<SinkFrame> sink_frames;
+  sink_frames.reserve(sink_pairs().size());
+  std::vector<webrtc::VideoFrame> scaled_frames;
+  rtc::scoped_refptr<webrtc::I420BufferInterface> i420_buffer;
   for (auto& sink_pair : sink_pairs()) {
     if (sink_pair.wants.rotation_applied &&
         frame.rotation() != webrtc::kVideoRotation_0) {
@@ -64,14 +101,20 @@ void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
       RTC_LOG(LS_VERBOSE) << "Discarding frame with unexpected rotation.";
       continue;
     }
+    webrtc::VideoFrame sink_frame =
+        scale_for_sinks_
+            ? ScaleFrameForSink(frame, sink_pair.wants.max_pixel_count,
+                                &scaled_frames, &i420_buffer)
+            : frame;
     if (sink_pair.wants.black_frames) {
-      sink_pair.sink->OnFrame(
-          webrtc::VideoFrame(GetBlackFrameBuffer(frame.width(), frame.height()),
-                             frame.rotation(), frame.timestamp_us()));
-    } else {
-      sink_pair.sink->OnFrame(frame);
+      sink_frame = webrtc::VideoFrame(
+          GetBlackFrameBuffer(frame.video_frame_buffer()->type(),
+                              sink_frame.width(), sink_frame.height()),
+          frame.rotation(), frame.timestamp_us());
     }
+    sink_frames.push_back(SinkFrame{sink_pair.sink, std::move(sink_frame)});
   }
+  DeliverFrames(sink_frames);
 }
 
 void VideoBroadcaster::OnDiscardedFrame() {
@@ -85,23 +128,38 @@ void VideoBroadcaster::UpdateWants() {
 
   VideoSinkWants wants;
   wants.rotation_applied = false;
+  if (scale_for_sinks_ && !sink_pairs().empty())
+    wants.max_pixel_count = 0;
   for (auto& sink : sink_pairs()) {
     // wants.rotation_applied == ANY(sink.wants.rotation_applied)
     if (sink.wants.rotation_applied) {
       wants.rotation_applied = true;
     }
-    // wants.max_pixel_count == MIN(sink.wants.max_pixel_count)
-    if (sink.wants.max_pixel_count < wants.max_pixel_count) {
-      wants.max_pixel_count = sink.wants.max_pixel_count;
-    }
-    // Select the minimum requested target_pixel_count, if any, of all sinks so
-    // that we don't over utilize the resources for any one.
-    // TODO(sprang): Consider using the median instead, since the limit can be
-    // expressed by max_pixel_count.
-    if (sink.wants.target_pixel_count &&
-        (!wants.target_pixel_count ||
-         (*sink.wants.target_pixel_count < *wants.target_pixel_count))) {
-      wants.target_pixel_count = sink.wants.target_pixel_count;
+    if (scale_for_sinks_) {
+      // The frames are scaled down for each sink, so the source is asked for
+      // the largest resolution that any sink wants.
+      wants.max_pixel_count =
+          std::max(wants.max_pixel_count, sink.wants.max_pixel_count);
+      const int target_pixel_count =
+          sink.wants.target_pixel_count.value_or(sink.wants.max_pixel_count);
+      if (!wants.target_pixel_count ||
+          target_pixel_count > *wants.target_pixel_count) {
+        wants.target_pixel_count = target_pixel_count;
+      }
+    } else {
+      // wants.max_pixel_count == MIN(sink.wants.max_pixel_count)
+      if (sink.wants.max_pixel_count < wants.max_pixel_count) {
+        wants.max_pixel_count = sink.wants.max_pixel_count;
+      }
+      // Select the minimum requested target_pixel_count, if any, of all sinks
+      // so that we don't over utilize the resources for any one.
+      // TODO(sprang): Consider using the median instead, since the limit can
+      // be expressed by max_pixel_count.
+      if (sink.wants.target_pixel_count &&
+          (!wants.target_pixel_count ||
+           (*sink.wants.target_pixel_count < *wants.target_pixel_count))) {
+        wants.target_pixel_count = sink.wants.target_pixel_count;
+      }
     }
     // Select the minimum for the requested max framerates.
     if (sink.wants.max_framerate_fps < wants.max_framerate_fps) {
@@ -116,14 +174,134 @@ void VideoBroadcaster::UpdateWants() {
   current_wants_ = wants;
 }
 
+webrtc::VideoFrame VideoBroadcaster::ScaleFrameForSink(
+    const webrtc::VideoFrame& frame,
+    int max_pixel_count,
+    std::vector<webrtc::VideoFrame>* scaled_frames,
+    rtc::scoped_refptr<webrtc::I420BufferInterface>* i420_buffer) {
+  // Scale down by alternately 3/4 and 2/3, like cricket::VideoAdapter, so
+  // that sinks with close limits end up sharing a resolution.
+  const int64_t pixels = static_cast<int64_t>(frame.width()) * frame.height();
+  int numerator = 1;
+  int denominator = 1;
+  while (pixels * numerator * numerator >
+             static_cast<int64_t>(max_pixel_count) * denominator *
+                 denominator &&
+         frame.width() * numerator / denominator > 1) {
+    if (numerator % 3 == 0 && denominator % 2 == 0) {
+      numerator /= 3;
+      denominator /= 2;
+    } else {
+      numerator *= 3;
+      denominator *= 4;
+    }
+  }
+  if (numerator == denominator)
+    return frame;
+
+  const int width = frame.width() * numerator / denominator;
+  const int height = std::max(1, frame.height() * numerator / denominator);
+  for (const webrtc::VideoFrame& scaled_frame : *scaled_frames) {
+    if (scaled_frame.width() == width && scaled_frame.height() == height)
+      return scaled_frame;
+  }
+
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer =
+      frame.video_frame_buffer();
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> scaled_buffer;
+  if (buffer->type() == webrtc::VideoFrameBuffer::Type::kNV12) {
+    rtc::scoped_refptr<webrtc::NV12Buffer> nv12_buffer =
+        webrtc::NV12Buffer::Create(width, height);
+    nv12_buffer->ScaleFrom(*buffer->GetNV12());
+    scaled_buffer = nv12_buffer;
+  } else if (buffer->type() == webrtc::VideoFrameBuffer::Type::kNative) {
+    // Scaled natively if the buffer supports it, e.g. on the GPU.
+    scaled_buffer = buffer->ScaleNative(width, height);
+  }
+  if (!scaled_buffer) {
+    if (!*i420_buffer)
+      *i420_buffer = buffer->ToI420();
+    rtc::scoped_refptr<webrtc::I420Buffer> scaled_i420_buffer =
+        webrtc::I420Buffer::Create(width, height);
+    scaled_i420_buffer->ScaleFrom(**i420_buffer);
+    scaled_buffer = scaled_i420_buffer;
+  }
+
+  webrtc::VideoFrame::Builder builder;
+  builder.set_video_frame_buffer(scaled_buffer)
+      .set_timestamp_us(frame.timestamp_us())
+      .set_timestamp_rtp(frame.timestamp())
+      .set_ntp_time_ms(frame.ntp_time_ms())
+      .set_rotation(frame.rotation());
+  if (frame.color_space())
+    builder.set_color_space(*frame.color_space());
+  // An unchanged frame is still unchanged once scaled.
+  if (frame.update_rect() && frame.update_rect()->IsEmpty())
+    builder.set_update_rect(webrtc::VideoFrame::UpdateRect{0, 0, 0, 0});
+  scaled_frames->push_back(builder.build());
+  return scaled_frames->back();
+}
+
+void VideoBroadcaster::DeliverFrames(
+    const std::vector<SinkFrame>& sink_frames) {
+  if (!deliver_in_parallel_ || sink_frames.size() < 2) {
+    for (const SinkFrame& sink_frame : sink_frames)
+      sink_frame.sink->OnFrame(sink_frame.frame);
+    return;
+  }
+
+  if (delivery_queues_.empty()) {
+    const int num_queues = std::min(
+        kMaxDeliveryQueues,
+        std::max(1, static_cast<int>(webrtc::CpuInfo::DetectNumberOfCores()) -
+                        1));
+    for (int i = 0; i < num_queues; ++i) {
+      delivery_queues_.push_back(
+          absl::make_unique<rtc::TaskQueue>("VideoBroadcasterQueue"));
+    }
+  }
+
+  // The first sink is called on the calling thread, the others on
+  // |delivery_queues_|.
+  rtc::Event done(false, false);
+  volatile int remaining = static_cast<int>(sink_frames.size()) - 1;
+  for (size_t i = 1; i < sink_frames.size(); ++i) {
+    const SinkFrame* sink_frame = &sink_frames[i];
+    delivery_queues_[(i - 1) % delivery_queues_.size()]->PostTask(
+        [sink_frame, &remaining, &done] {
+          sink_frame->sink->OnFrame(sink_frame->frame);
+          if (rtc::AtomicOps::Decrement(&remaining) == 0)
+            done.Set();
+        });
+  }
+  sink_frames[0].sink->OnFrame(sink_frames[0].frame);
+  done.Wait(rtc::Event::kForever);
+}
+
 const rtc::scoped_refptr<webrtc::VideoFrameBuffer>&
-VideoBroadcaster::GetBlackFrameBuffer(int width, int height) {
+VideoBroadcaster::GetBlackFrameBuffer(webrtc::VideoFrameBuffer::Type type,
+                                      int width,
+                                      int height) {
+  const webrtc::VideoFrameBuffer::Type black_type =
+      type == webrtc::VideoFrameBuffer::Type::kNV12
+          ? webrtc::VideoFrameBuffer::Type::kNV12
+          : webrtc::VideoFrameBuffer::Type::kI420;
   if (!black_frame_buffer_ || black_frame_buffer_->width() != width ||
-      black_frame_buffer_->height() != height) {
-    rtc::scoped_refptr<webrtc::I420Buffer> buffer =
-        webrtc::I420Buffer::Create(width, height);
-    webrtc::I420Buffer::SetBlack(buffer.get());
-    black_frame_buffer_ = buffer;
+      black_frame_buffer_->height() != height ||
+      black_frame_buffer_->type() != black_type) {
+    if (black_type == webrtc::VideoFrameBuffer::Type::kNV12) {
+      rtc::scoped_refptr<webrtc::NV12Buffer> buffer =
+          webrtc::NV12Buffer::Create(width, height);
+      memset(buffer->MutableDataY(), 0, buffer->StrideY() * height);
+      memset(buffer->MutableDataUV(), 128,
+             buffer->StrideUV() * buffer->ChromaHeight());
+      black_frame_buffer_ = buffer;
+    } else {
+      rtc::scoped_refptr<webrtc::I420Buffer> buffer =
+          webrtc::I420Buffer::Create(width, height);
+      webrtc::I420Buffer::SetBlack(buffer.get());
+      black_frame_buffer_ = buffer;
+    }
   }
 
   return black_frame_buffer_;
@@ -19,6 +19,7 @@
 #include "api/video/video_sink_interface.h"
 #include "media/base/videosourcebase.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/task_queue.h"
 #include "rtc_base/thread_checker.h"
 
 namespace rtc {
@@ -29,6 +30,16 @@ namespace rtc {
 // Sinks must be added and removed on one and only one thread.
 // Video frames can be broadcasted on any thread. I.e VideoBroadcaster::OnFrame
 // can be called on any thread.
+//
+// With the WebRTC-VideoBroadcaster-ParallelDelivery field trial, frames
+// are delivered to the sinks concurrently, on the calling thread and a pool of
+// task queues, and OnFrame returns once all the sinks are done. Sinks must
+// then not call back into the broadcaster from OnFrame.
+//
+// With the WebRTC-VideoBroadcaster-ScaleForSinks field trial, the source is
+// asked for the largest resolution wanted by any sink, and frames are scaled
+// down for sinks with a lower VideoSinkWants::max_pixel_count. Frames are
+// scaled once per resolution and shared between the sinks that want it.
 class VideoBroadcaster : public VideoSourceBase,
                          public VideoSinkInterface<webrtc::VideoFrame> {
  public:
@@ -41,6 +52,10 @@ class VideoBroadcaster : public VideoSourceBase,
   // Returns true if the next frame will be delivered to at least one sink.
   bool frame_wanted() const;
 
+  // Returns true if there are sinks and all of them are busy, see
+  // VideoSinkWants::is_busy. The next frame would be dropped by all of them.
+  bool sinks_busy() const;
+
   // Returns VideoSinkWants a source is requested to fulfill. They are
   // aggregated by all VideoSinkWants from all sinks.
   VideoSinkWants wants() const;
@@ -54,16 +69,39 @@ class VideoBroadcaster : public VideoSourceBase,
   void OnDiscardedFrame() override;
 
  protected:
+  struct SinkFrame {
+    VideoSinkInterface<webrtc::VideoFrame>* sink;
+    webrtc::VideoFrame frame;
+  };
+
   void UpdateWants() RTC_EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
+  // Returns |frame| scaled down to fit |max_pixel_count|. |scaled_frames|
+  // holds the frames already scaled from |frame|, and |i420_buffer| its
+  // buffer in I420, if it was converted.
+  webrtc::VideoFrame ScaleFrameForSink(
+      const webrtc::VideoFrame& frame,
+      int max_pixel_count,
+      std::vector<webrtc::VideoFrame>* scaled_frames,
+      rtc::scoped_refptr<webrtc::I420BufferInterface>* i420_buffer);
+  void DeliverFrames(const std::vector<SinkFrame>& sink_frames)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
+  // Returns a black buffer of |width| x |height|, in NV12 for NV12 frames and
+  // in I420 otherwise.
   const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& GetBlackFrameBuffer(
+      webrtc::VideoFrameBuffer::Type type,
       int width,
       int height) RTC_EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
 
   ThreadChecker thread_checker_;
   rtc::CriticalSection sinks_and_wants_lock_;
 
+  const bool deliver_in_parallel_;
+  const bool scale_for_sinks_;
   VideoSinkWants current_wants_ RTC_GUARDED_BY(sinks_and_wants_lock_);
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> black_frame_buffer_;
+  // Created the first time a frame is delivered to several sinks in parallel.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> delivery_queues_
+      RTC_GUARDED_BY(sinks_and_wants_lock_);
 };
 
 }  // namespace rtc
@@ -11,10 +11,12 @@
 #include <limits>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video/video_frame.h"
 #include "media/base/fakevideorenderer.h"
 #include "media/base/videobroadcaster.h"
 #include "rtc_base/gunit.h"
+#include "test/field_trial.h"
 
 using rtc::VideoBroadcaster;
 using rtc::VideoSinkWants;
@@ -32,6 +34,27 @@ TEST(VideoBroadcasterTest, frame_wanted) {
   EXPECT_FALSE(broadcaster.frame_wanted());
 }
 
+TEST(VideoBroadcasterTest, SinksBusyOnlyIfAllSinksAreBusy) {
+  VideoBroadcaster broadcaster;
+  EXPECT_FALSE(broadcaster.sinks_busy());
+
+  bool busy1 = true;
+  FakeVideoRenderer sink1;
+  VideoSinkWants wants1;
+  wants1.is_busy = [&busy1] { return busy1; };
+  broadcaster.AddOrUpdateSink(&sink1, wants1);
+  EXPECT_TRUE(broadcaster.sinks_busy());
+
+  FakeVideoRenderer sink2;
+  broadcaster.AddOrUpdateSink(&sink2, VideoSinkWants());
+  EXPECT_FALSE(broadcaster.sinks_busy());
+
+  broadcaster.RemoveSink(&sink2);
+  EXPECT_TRUE(broadcaster.sinks_busy());
+  busy1 = false;
+  EXPECT_FALSE(broadcaster.sinks_busy());
+}
+
 TEST(VideoBroadcasterTest, OnFrame) {
   VideoBroadcaster broadcaster;
 
@@ -192,3 +215,97 @@ TEST(VideoBroadcasterTest, SinkWantsBlackFrames) {
   EXPECT_TRUE(sink2.black_frame());
   EXPECT_EQ(30, sink2.timestamp_us());
 }
+
+TEST(VideoBroadcasterTest, SendsBlackFramesOfSameType) {
+  class BufferTypeSink : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+   public:
+    void OnFrame(const webrtc::VideoFrame& frame) override {
+      buffer = frame.video_frame_buffer();
+    }
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer;
+  };
+
+  VideoBroadcaster broadcaster;
+  BufferTypeSink sink;
+  VideoSinkWants wants;
+  wants.black_frames = true;
+  broadcaster.AddOrUpdateSink(&sink, wants);
+
+  rtc::scoped_refptr<webrtc::NV12Buffer> nv12_buffer(
+      webrtc::NV12Buffer::Create(100, 200));
+  nv12_buffer->InitializeData();
+  broadcaster.OnFrame(webrtc::VideoFrame(nv12_buffer, webrtc::kVideoRotation_0,
+                                         10 /* timestamp_us */));
+  ASSERT_TRUE(sink.buffer);
+  EXPECT_EQ(webrtc::VideoFrameBuffer::Type::kNV12, sink.buffer->type());
+  EXPECT_NE(nv12_buffer, sink.buffer);
+  rtc::scoped_refptr<webrtc::I420BufferInterface> black =
+      sink.buffer->ToI420();
+  EXPECT_EQ(0, black->DataY()[0]);
+  EXPECT_EQ(128, black->DataU()[0]);
+  EXPECT_EQ(128, black->DataV()[0]);
+
+  broadcaster.OnFrame(
+      webrtc::VideoFrame(webrtc::I420Buffer::Create(100, 200),
+                         webrtc::kVideoRotation_0, 20 /* timestamp_us */));
+  EXPECT_EQ(webrtc::VideoFrameBuffer::Type::kI420, sink.buffer->type());
+}
+
+TEST(VideoBroadcasterTest, DeliversToSinksInParallel) {
+  webrtc::test::ScopedFieldTrials field_trials(
+      "WebRTC-VideoBroadcaster-ParallelDelivery/Enabled/");
+  VideoBroadcaster broadcaster;
+  FakeVideoRenderer sinks[3];
+  for (FakeVideoRenderer& sink : sinks)
+    broadcaster.AddOrUpdateSink(&sink, rtc::VideoSinkWants());
+
+  webrtc::VideoFrame frame(webrtc::I420Buffer::Create(100, 200),
+                           webrtc::kVideoRotation_0, 10 /* timestamp_us */);
+  broadcaster.OnFrame(frame);
+  broadcaster.OnFrame(frame);
+  // All the sinks are done when OnFrame returns.
+  for (FakeVideoRenderer& sink : sinks)
+    EXPECT_EQ(2, sink.num_rendered_frames());
+}
+
+TEST(VideoBroadcasterTest, ScalesFramesOncePerSinkResolution) {
+  webrtc::test::ScopedFieldTrials field_trials(
+      "WebRTC-VideoBroadcaster-ScaleForSinks/Enabled/");
+  class BufferSink : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+   public:
+    void OnFrame(const webrtc::VideoFrame& frame) override {
+      buffer = frame.video_frame_buffer();
+    }
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer;
+  };
+
+  VideoBroadcaster broadcaster;
+  BufferSink full_sink;
+  broadcaster.AddOrUpdateSink(&full_sink, VideoSinkWants());
+  BufferSink small_sink1;
+  BufferSink small_sink2;
+  VideoSinkWants small_wants1;
+  small_wants1.max_pixel_count = 640 * 360;
+  broadcaster.AddOrUpdateSink(&small_sink1, small_wants1);
+  VideoSinkWants small_wants2;
+  small_wants2.max_pixel_count = 700 * 400;
+  broadcaster.AddOrUpdateSink(&small_sink2, small_wants2);
+  // The source is asked for the largest resolution.
+  EXPECT_EQ(std::numeric_limits<int>::max(),
+            broadcaster.wants().max_pixel_count);
+
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer(
+      webrtc::I420Buffer::Create(1280, 720));
+  buffer->InitializeData();
+  broadcaster.OnFrame(webrtc::VideoFrame(buffer, webrtc::kVideoRotation_0,
+                                         10 /* timestamp_us */));
+  EXPECT_EQ(buffer, full_sink.buffer);
+  ASSERT_TRUE(small_sink1.buffer);
+  EXPECT_EQ(640, small_sink1.buffer->width());
+  EXPECT_EQ(360, small_sink1.buffer->height());
+  // Sinks that fit the same resolution share the scaled frame.
+  EXPECT_EQ(small_sink1.buffer, small_sink2.buffer);
+
+  broadcaster.RemoveSink(&full_sink);
+  EXPECT_EQ(700 * 400, broadcaster.wants().max_pixel_count);
+}
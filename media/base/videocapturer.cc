@@ -182,6 +182,12 @@ bool VideoCapturer::AdaptFrame(int width,
     return false;
   }
 
+  if (broadcaster_.sinks_busy()) {
+    // Drop the frame before it is converted and scaled.
+    broadcaster_.OnDiscardedFrame();
+    return false;
+  }
+
   if (enable_video_adapter_) {
     if (!video_adapter_.AdaptFrameResolution(
             width, height, camera_time_us * rtc::kNumNanosecsPerMicrosec,
@@ -214,17 +220,18 @@ void VideoCapturer::OnFrame(const webrtc::VideoFrame& frame,
   if (apply_rotation_ && frame.rotation() != webrtc::kVideoRotation_0) {
     rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer(
         frame.video_frame_buffer());
-    if (buffer->type() != webrtc::VideoFrameBuffer::Type::kI420) {
+    if (buffer->type() != webrtc::VideoFrameBuffer::Type::kI420 &&
+        buffer->type() != webrtc::VideoFrameBuffer::Type::kNV12) {
       // Sources producing non-I420 frames must handle apply_rotation
       // themselves. But even if they do, we may occasionally end up
       // in this case, for frames in flight at the time
       // applied_rotation is set to true. In that case, we just drop
       // the frame.
-      RTC_LOG(LS_WARNING) << "Non-I420 frame requiring rotation. Discarding.";
+      RTC_LOG(LS_WARNING) << "Native frame requiring rotation. Discarding.";
       return;
     }
     broadcaster_.OnFrame(webrtc::VideoFrame(
-        webrtc::I420Buffer::Rotate(*buffer->GetI420(), frame.rotation()),
+        webrtc::I420Buffer::Rotate(*buffer->ToI420(), frame.rotation()),
         webrtc::kVideoRotation_0, frame.timestamp_us()));
   } else {
     broadcaster_.OnFrame(frame);
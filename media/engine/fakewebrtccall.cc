@@ -268,6 +268,7 @@ void FakeVideoSendStream::ReconfigureVideoEncoder(
 
 void FakeVideoSendStream::UpdateActiveSimulcastLayers(
     const std::vector<bool> active_layers) {
+  active_layers_ = active_layers;
   sending_ = false;
   for (const bool active_layer : active_layers) {
     if (active_layer) {
@@ -345,6 +346,10 @@ webrtc::VideoReceiveStream::Stats FakeVideoReceiveStream::GetStats() const {
   return stats_;
 }
 
+std::string FakeVideoReceiveStream::GetJitterEstimatorState() const {
+  return config_.jitter_estimator_state;
+}
+
 void FakeVideoReceiveStream::Start() {
   receiving_ = true;
 }
@@ -142,6 +142,7 @@ class FakeVideoSendStream final
   int num_encoder_reconfigurations() const {
     return num_encoder_reconfigurations_;
   }
+  const std::vector<bool>& active_layers() const { return active_layers_; }
 
   void EnableEncodedFrameRecording(const std::vector<rtc::PlatformFile>& files,
                                    size_t byte_limit) override;
@@ -190,6 +191,7 @@ class FakeVideoSendStream final
   absl::optional<webrtc::VideoFrame> last_frame_;
   webrtc::VideoSendStream::Stats stats_;
   int num_encoder_reconfigurations_ = 0;
+  std::vector<bool> active_layers_;
 };
 
 class FakeVideoReceiveStream final : public webrtc::VideoReceiveStream {
@@ -219,6 +221,7 @@ class FakeVideoReceiveStream final : public webrtc::VideoReceiveStream {
   void Stop() override;
 
   webrtc::VideoReceiveStream::Stats GetStats() const override;
+  std::string GetJitterEstimatorState() const override;
 
   webrtc::VideoReceiveStream::Config config_;
   bool receiving_;
@@ -38,7 +38,10 @@ class ScopedVideoEncoder : public webrtc::VideoEncoder {
   int32_t SetRateAllocation(const webrtc::VideoBitrateAllocation& allocation,
                             uint32_t framerate) override;
   ScalingSettings GetScalingSettings() const override;
+  bool SetSpeedSteps(int steps) override;
+  bool Reconfigure(const webrtc::VideoCodec& codec_settings) override;
   bool SupportsNativeHandle() const override;
+  bool SupportsNV12() const override;
   const char* ImplementationName() const override;
 
   ~ScopedVideoEncoder() override;
@@ -95,10 +98,22 @@ webrtc::VideoEncoder::ScalingSettings ScopedVideoEncoder::GetScalingSettings()
   return encoder_->GetScalingSettings();
 }
 
+bool ScopedVideoEncoder::SetSpeedSteps(int steps) {
+  return encoder_->SetSpeedSteps(steps);
+}
+
+bool ScopedVideoEncoder::Reconfigure(const webrtc::VideoCodec& codec_settings) {
+  return encoder_->Reconfigure(codec_settings);
+}
+
 bool ScopedVideoEncoder::SupportsNativeHandle() const {
   return encoder_->SupportsNativeHandle();
 }
 
+bool ScopedVideoEncoder::SupportsNV12() const {
+  return encoder_->SupportsNV12();
+}
+
 const char* ScopedVideoEncoder::ImplementationName() const {
   return encoder_->ImplementationName();
 }
@@ -12,14 +12,18 @@
 
 #include <algorithm>
 
+#include "absl/memory/memory.h"
 #include "api/video/i420_buffer.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "api/video_codecs/video_encoder_factory.h"
+#include "common_video/include/shared_i420_buffer_pool.h"
+#include "common_video/libyuv/include/parallel_libyuv.h"
 #include "media/engine/scopedvideoencoder.h"
 #include "modules/video_coding/utility/simulcast_rate_allocator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "system_wrappers/include/clock.h"
-#include "third_party/libyuv/include/libyuv/scale.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace {
 
@@ -28,6 +32,9 @@ const unsigned int kDefaultMaxQp = 56;
 // Max qp for lowest spatial resolution when doing simulcast.
 const unsigned int kLowestResMaxQp = 45;
 
+const char kParallelEncodeFieldTrial[] =
+    "WebRTC-SimulcastEncoderAdapter-ParallelEncode";
+
 uint32_t SumStreamMaxBitrate(int streams, const webrtc::VideoCodec& codec) {
   uint32_t bitrate_sum = 0;
   for (int i = 0; i < streams; ++i) {
@@ -113,7 +120,12 @@ SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory,
       factory_(factory),
       video_format_(format),
       encoded_complete_callback_(nullptr),
-      implementation_name_("SimulcastEncoderAdapter") {
+      implementation_name_("SimulcastEncoderAdapter"),
+      speed_steps_(0),
+      parallel_encode_enabled_(
+          webrtc::field_trial::IsEnabled(kParallelEncodeFieldTrial)),
+      parallel_encode_(false),
+      defer_encoded_images_(false) {
   RTC_DCHECK(factory_);
 
   // The adapter is typically created on the worker thread, but operated on
@@ -253,6 +265,16 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
 
   // To save memory, don't store encoders that we don't use.
   DestroyStoredEncoders();
+  speed_steps_ = 0;
+
+  parallel_encode_ =
+      parallel_encode_enabled_ && number_of_cores > 1 && number_of_streams > 1;
+  if (parallel_encode_) {
+    while (encode_queues_.size() < streaminfos_.size() - 1) {
+      encode_queues_.push_back(
+          absl::make_unique<rtc::TaskQueue>("SimulcastEncodeQueue"));
+    }
+  }
 
   rtc::AtomicOps::ReleaseStore(&inited_, 1);
 
@@ -291,66 +313,193 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
+  FrameType frame_type = send_key_frame ? kVideoFrameKey : kVideoFrameDelta;
+  if (send_key_frame) {
+    for (StreamInfo& streaminfo : streaminfos_) {
+      if (streaminfo.send_stream)
+        streaminfo.key_frame_request = false;
+    }
+  }
+
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> scaled_buffers =
+      ScaleInputForStreams(input_image);
+
+  if (parallel_encode_) {
+    return EncodeStreamsInParallel(input_image, scaled_buffers,
+                                   codec_specific_info, frame_type);
+  }
+
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream) {
       continue;
     }
-
-    std::vector<FrameType> stream_frame_types;
-    if (send_key_frame) {
-      stream_frame_types.push_back(kVideoFrameKey);
-      streaminfos_[stream_idx].key_frame_request = false;
-    } else {
-      stream_frame_types.push_back(kVideoFrameDelta);
+    int ret = EncodeStream(stream_idx, input_image, scaled_buffers[stream_idx],
+                           codec_specific_info, frame_type);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
     }
+  }
+
+  return WEBRTC_VIDEO_CODEC_OK;
+}
 
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources) or the source image has a native handle, pass the image on
-    // directly. Otherwise, we'll scale it to match what the encoder expects
-    // (below).
-    // For texture frames, the underlying encoder is expected to be able to
-    // correctly sample/scale the source texture.
-    // TODO(perkj): ensure that works going forward, and figure out how this
-    // affects webrtc:5683.
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.video_frame_buffer()->type() ==
-            VideoFrameBuffer::Type::kNative) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          input_image, codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
+std::vector<rtc::scoped_refptr<VideoFrameBuffer>>
+SimulcastEncoderAdapter::ScaleInputForStreams(const VideoFrame& input_image) {
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> scaled_buffers(
+      streaminfos_.size());
+  // The streams are ordered by increasing resolution. Each one is scaled from
+  // the smallest image already scaled for a higher stream, rather than from
+  // the input, so that the full resolution image is only read once.
+  if (input_image.video_frame_buffer()->type() ==
+      VideoFrameBuffer::Type::kNative) {
+    rtc::scoped_refptr<VideoFrameBuffer> src_buffer =
+        input_image.video_frame_buffer();
+    for (size_t i = streaminfos_.size(); i-- > 0;) {
+      const StreamInfo& streaminfo = streaminfos_[i];
+      if (!streaminfo.send_stream ||
+          (streaminfo.width == input_image.width() &&
+           streaminfo.height == input_image.height())) {
+        continue;
       }
-    } else {
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-      rtc::scoped_refptr<I420BufferInterface> src_buffer =
-          input_image.video_frame_buffer()->ToI420();
-      libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
-                        src_buffer->DataU(), src_buffer->StrideU(),
-                        src_buffer->DataV(), src_buffer->StrideV(), src_width,
-                        src_height, dst_buffer->MutableDataY(),
-                        dst_buffer->StrideY(), dst_buffer->MutableDataU(),
-                        dst_buffer->StrideU(), dst_buffer->MutableDataV(),
-                        dst_buffer->StrideV(), dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          VideoFrame(dst_buffer, input_image.timestamp(),
-                     input_image.render_time_ms(), webrtc::kVideoRotation_0),
-          codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
+      // For texture frames that can't be scaled natively, the underlying
+      // encoder is expected to be able to correctly sample/scale the source
+      // texture.
+      // TODO(perkj): ensure that works going forward, and figure out how this
+      // affects webrtc:5683.
+      rtc::scoped_refptr<VideoFrameBuffer> dst_buffer =
+          src_buffer->ScaleNative(streaminfo.width, streaminfo.height);
+      if (!dst_buffer)
+        return scaled_buffers;
+      scaled_buffers[i] = dst_buffer;
+      src_buffer = dst_buffer;
+    }
+    return scaled_buffers;
+  }
+
+  if (input_image.video_frame_buffer()->type() ==
+          VideoFrameBuffer::Type::kNV12 &&
+      SupportsNV12()) {
+    const NV12BufferInterface* src_buffer =
+        input_image.video_frame_buffer()->GetNV12();
+    for (size_t i = streaminfos_.size(); i-- > 0;) {
+      StreamInfo& streaminfo = streaminfos_[i];
+      if (!streaminfo.send_stream ||
+          (streaminfo.width == input_image.width() &&
+           streaminfo.height == input_image.height())) {
+        continue;
       }
+      rtc::scoped_refptr<NV12Buffer> dst_buffer =
+          streaminfo.nv12_buffer_pool->CreateBuffer(streaminfo.width,
+                                                    streaminfo.height);
+      dst_buffer->ScaleFrom(*src_buffer);
+      scaled_buffers[i] = dst_buffer;
+      src_buffer = dst_buffer.get();
     }
-  }
+    return scaled_buffers;
+  }
+
+  rtc::scoped_refptr<I420BufferInterface> src_buffer;
+  for (size_t i = streaminfos_.size(); i-- > 0;) {
+    StreamInfo& streaminfo = streaminfos_[i];
+    // Don't scale frames in resolutions that we don't intend to send. Frames
+    // of streams with the resolution of the input, or empty frames (e.g. a
+    // keyframe request for encoders with internal camera sources), are passed
+    // on directly.
+    if (!streaminfo.send_stream ||
+        (streaminfo.width == input_image.width() &&
+         streaminfo.height == input_image.height())) {
+      continue;
+    }
+    if (!src_buffer)
+      src_buffer = input_image.video_frame_buffer()->ToI420();
+    // The buffers are shared with the other streams of the process, so that
+    // they are kept when the resolutions change.
+    rtc::scoped_refptr<I420Buffer> dst_buffer =
+        SharedI420BufferPool::GetInstance()->CreateBuffer(streaminfo.width,
+                                                          streaminfo.height);
+    ParallelScaleI420(*src_buffer, dst_buffer);
+    scaled_buffers[i] = dst_buffer;
+    src_buffer = dst_buffer;
+  }
+  return scaled_buffers;
+}
 
+int SimulcastEncoderAdapter::EncodeStream(
+    size_t stream_idx,
+    const VideoFrame& input_image,
+    const rtc::scoped_refptr<VideoFrameBuffer>& scaled_buffer,
+    const CodecSpecificInfo* codec_specific_info,
+    FrameType frame_type) {
+  std::vector<FrameType> stream_frame_types(1, frame_type);
+  if (!scaled_buffer) {
+    return streaminfos_[stream_idx].encoder->Encode(
+        input_image, codec_specific_info, &stream_frame_types);
+  }
+  return streaminfos_[stream_idx].encoder->Encode(
+      VideoFrame(scaled_buffer, input_image.timestamp(),
+                 input_image.render_time_ms(), webrtc::kVideoRotation_0),
+      codec_specific_info, &stream_frame_types);
+}
+
+int SimulcastEncoderAdapter::EncodeStreamsInParallel(
+    const VideoFrame& input_image,
+    const std::vector<rtc::scoped_refptr<VideoFrameBuffer>>& scaled_buffers,
+    const CodecSpecificInfo* codec_specific_info,
+    FrameType frame_type) {
+  {
+    rtc::CritScope lock(&deferred_crit_);
+    defer_encoded_images_ = true;
+  }
+
+  // The first stream is encoded on the calling queue, the others on
+  // |encode_queues_|.
+  std::vector<int> results(streaminfos_.size(), WEBRTC_VIDEO_CODEC_OK);
+  rtc::Event done(false, false);
+  volatile int remaining = 0;
+  for (size_t stream_idx = 1; stream_idx < streaminfos_.size(); ++stream_idx) {
+    if (streaminfos_[stream_idx].send_stream)
+      ++remaining;
+  }
+  for (size_t stream_idx = 1; stream_idx < streaminfos_.size(); ++stream_idx) {
+    if (!streaminfos_[stream_idx].send_stream)
+      continue;
+    encode_queues_[stream_idx - 1]->PostTask([&, stream_idx] {
+      results[stream_idx] =
+          EncodeStream(stream_idx, input_image, scaled_buffers[stream_idx],
+                       codec_specific_info, frame_type);
+      if (rtc::AtomicOps::Decrement(&remaining) == 0)
+        done.Set();
+    });
+  }
+  if (streaminfos_[0].send_stream) {
+    results[0] = EncodeStream(0, input_image, scaled_buffers[0],
+                              codec_specific_info, frame_type);
+  }
+  if (rtc::AtomicOps::AcquireLoad(&remaining) > 0)
+    done.Wait(rtc::Event::kForever);
+
+  std::vector<DeferredEncodedImage> deferred_images;
+  {
+    rtc::CritScope lock(&deferred_crit_);
+    defer_encoded_images_ = false;
+    deferred_images.swap(deferred_images_);
+  }
+  std::stable_sort(
+      deferred_images.begin(), deferred_images.end(),
+      [](const DeferredEncodedImage& a, const DeferredEncodedImage& b) {
+        return a.stream_idx < b.stream_idx;
+      });
+  for (const DeferredEncodedImage& deferred : deferred_images) {
+    DeliverEncodedImage(deferred.stream_idx, deferred.encoded_image,
+                        &deferred.codec_specific_info,
+                        deferred.fragmentation.get());
+  }
+
+  for (int ret : results) {
+    if (ret != WEBRTC_VIDEO_CODEC_OK)
+      return ret;
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -434,6 +583,37 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
     const EncodedImage& encodedImage,
     const CodecSpecificInfo* codecSpecificInfo,
     const RTPFragmentationHeader* fragmentation) {
+  {
+    rtc::CritScope lock(&deferred_crit_);
+    if (defer_encoded_images_) {
+      deferred_images_.emplace_back();
+      DeferredEncodedImage& deferred = deferred_images_.back();
+      deferred.stream_idx = stream_idx;
+      deferred.encoded_image = encodedImage;
+      // Data stored with SetEncodedData is kept alive by the copy, other data
+      // is only valid during the callback.
+      if (encodedImage._buffer != encodedImage.encoded_data().cdata()) {
+        deferred.encoded_image.SetEncodedData(
+            rtc::CopyOnWriteBuffer(encodedImage._buffer, encodedImage._length));
+      }
+      deferred.codec_specific_info = *codecSpecificInfo;
+      if (fragmentation) {
+        deferred.fragmentation.reset(new RTPFragmentationHeader());
+        deferred.fragmentation->CopyFrom(*fragmentation);
+      }
+      return EncodedImageCallback::Result(EncodedImageCallback::Result::OK,
+                                          encodedImage._timeStamp);
+    }
+  }
+  return DeliverEncodedImage(stream_idx, encodedImage, codecSpecificInfo,
+                             fragmentation);
+}
+
+EncodedImageCallback::Result SimulcastEncoderAdapter::DeliverEncodedImage(
+    size_t stream_idx,
+    const EncodedImage& encodedImage,
+    const CodecSpecificInfo* codecSpecificInfo,
+    const RTPFragmentationHeader* fragmentation) {
   CodecSpecificInfo stream_codec_specific = *codecSpecificInfo;
   stream_codec_specific.codec_name = implementation_name_.c_str();
   if (stream_codec_specific.codecType == webrtc::kVideoCodecVP8) {
@@ -509,6 +689,16 @@ bool SimulcastEncoderAdapter::SupportsNativeHandle() const {
   return true;
 }
 
+bool SimulcastEncoderAdapter::SupportsNV12() const {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
+  // Frames are scaled in NV12 only if all the encoders take them that way.
+  for (const auto& streaminfo : streaminfos_) {
+    if (!streaminfo.encoder->SupportsNV12())
+      return false;
+  }
+  return !streaminfos_.empty();
+}
+
 VideoEncoder::ScalingSettings SimulcastEncoderAdapter::GetScalingSettings()
     const {
   // TODO(brandtr): Investigate why the sequence checker below fails on mac.
@@ -520,6 +710,20 @@ VideoEncoder::ScalingSettings SimulcastEncoderAdapter::GetScalingSettings()
   return streaminfos_[0].encoder->GetScalingSettings();
 }
 
+bool SimulcastEncoderAdapter::SetSpeedSteps(int steps) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
+  for (size_t i = 0; i < streaminfos_.size(); ++i) {
+    if (!streaminfos_[i].encoder->SetSpeedSteps(steps)) {
+      // Keep the same speed steps on all the streams.
+      for (size_t j = 0; j < i; ++j)
+        streaminfos_[j].encoder->SetSpeedSteps(speed_steps_);
+      return false;
+    }
+  }
+  speed_steps_ = steps;
+  return true;
+}
+
 const char* SimulcastEncoderAdapter::ImplementationName() const {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
   return implementation_name_.c_str();
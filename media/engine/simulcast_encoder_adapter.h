@@ -18,10 +18,14 @@
 #include <utility>
 #include <vector>
 
+#include "api/video/i420_buffer.h"
+#include "common_video/include/nv12_buffer_pool.h"
 #include "media/engine/webrtcvideoencoderfactory.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "rtc_base/atomicops.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/sequenced_task_checker.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -32,6 +36,12 @@ class VideoEncoderFactory;
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // The object is created and destroyed on the worker thread, but all public
 // interfaces should be called from the encoder task queue.
+//
+// With the WebRTC-SimulcastEncoderAdapter-ParallelEncode field trial and more
+// than one core, Encode() encodes the streams in parallel, each on its own
+// task queue, and returns once all of them are encoded. The encoded images are
+// then passed on in stream order, as when the streams are encoded one after
+// another.
 class SimulcastEncoderAdapter : public VideoEncoder {
  public:
   explicit SimulcastEncoderAdapter(VideoEncoderFactory* factory,
@@ -62,7 +72,10 @@ class SimulcastEncoderAdapter : public VideoEncoder {
 
   VideoEncoder::ScalingSettings GetScalingSettings() const override;
 
+  bool SetSpeedSteps(int steps) override;
+
   bool SupportsNativeHandle() const override;
+  bool SupportsNV12() const override;
   const char* ImplementationName() const override;
 
  private:
@@ -77,13 +90,25 @@ class SimulcastEncoderAdapter : public VideoEncoder {
           width(width),
           height(height),
           key_frame_request(false),
-          send_stream(send_stream) {}
+          send_stream(send_stream),
+          nv12_buffer_pool(new NV12BufferPool()) {}
     std::unique_ptr<VideoEncoder> encoder;
     std::unique_ptr<EncodedImageCallback> callback;
     uint16_t width;
     uint16_t height;
     bool key_frame_request;
     bool send_stream;
+    // Buffers the input is scaled into when it is kept in NV12.
+    std::unique_ptr<NV12BufferPool> nv12_buffer_pool;
+  };
+
+  // An encoded image held back during a parallel Encode(), with copies of the
+  // data that the encoder only keeps valid during the callback.
+  struct DeferredEncodedImage {
+    size_t stream_idx;
+    EncodedImage encoded_image;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
   };
 
   // Populate the codec settings for each simulcast stream.
@@ -97,6 +122,32 @@ class SimulcastEncoderAdapter : public VideoEncoder {
 
   void DestroyStoredEncoders();
 
+  // Returns the input image scaled to the resolution of each stream, or null
+  // for the streams that aren't sent or are encoded from the input as is.
+  // Native input images are scaled with VideoFrameBuffer::ScaleNative, and
+  // passed on as is if they can't be. NV12 input images are scaled in NV12 if
+  // all the encoders take NV12.
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> ScaleInputForStreams(
+      const VideoFrame& input_image);
+  // Encodes |scaled_buffer| with the encoder of the stream, or |input_image|
+  // if it is null.
+  int EncodeStream(size_t stream_idx,
+                   const VideoFrame& input_image,
+                   const rtc::scoped_refptr<VideoFrameBuffer>& scaled_buffer,
+                   const CodecSpecificInfo* codec_specific_info,
+                   FrameType frame_type);
+  int EncodeStreamsInParallel(
+      const VideoFrame& input_image,
+      const std::vector<rtc::scoped_refptr<VideoFrameBuffer>>& scaled_buffers,
+      const CodecSpecificInfo* codec_specific_info,
+      FrameType frame_type);
+
+  EncodedImageCallback::Result DeliverEncodedImage(
+      size_t stream_idx,
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const RTPFragmentationHeader* fragmentation);
+
   volatile int inited_;  // Accessed atomically.
   VideoEncoderFactory* const factory_;
   const SdpVideoFormat video_format_;
@@ -104,6 +155,19 @@ class SimulcastEncoderAdapter : public VideoEncoder {
   std::vector<StreamInfo> streaminfos_;
   EncodedImageCallback* encoded_complete_callback_;
   std::string implementation_name_;
+  // The speed steps set on all the stream encoders.
+  int speed_steps_;
+
+  const bool parallel_encode_enabled_;
+  bool parallel_encode_;
+  // Encode all streams but the first in parallel mode. Created as needed by
+  // InitEncode and kept until the destructor.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> encode_queues_;
+
+  rtc::CriticalSection deferred_crit_;
+  bool defer_encoded_images_ RTC_GUARDED_BY(deferred_crit_);
+  std::vector<DeferredEncodedImage> deferred_images_
+      RTC_GUARDED_BY(deferred_crit_);
 
   // Used for checking the single-threaded access of the encoder interface.
   rtc::SequencedTaskChecker encoder_queue_;
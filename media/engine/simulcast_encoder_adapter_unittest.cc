@@ -15,6 +15,7 @@
 #include "absl/memory/memory.h"
 #include "api/test/create_simulcast_test_fixture.h"
 #include "api/test/simulcast_test_fixture.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video_codecs/sdp_video_format.h"
 #include "api/video_codecs/video_encoder_factory.h"
 #include "common_video/include/video_frame_buffer.h"
@@ -23,12 +24,16 @@
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "modules/video_coding/utility/simulcast_test_fixture_impl.h"
+#include "rtc_base/platform_thread.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/field_trial.h"
 #include "test/function_video_decoder_factory.h"
 #include "test/function_video_encoder_factory.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
 using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
 
 namespace webrtc {
@@ -209,6 +214,15 @@ class MockVideoEncoder : public VideoEncoder {
     return supports_native_handle_;
   }
 
+  bool SupportsNV12() const /* override */ { return supports_nv12_; }
+
+  bool SetSpeedSteps(int steps) /* override */ {
+    if (steps > max_speed_steps_)
+      return false;
+    speed_steps_ = steps;
+    return true;
+  }
+
   virtual ~MockVideoEncoder() { factory_->DestroyVideoEncoder(this); }
 
   const VideoCodec& codec() const { return codec_; }
@@ -228,10 +242,18 @@ class MockVideoEncoder : public VideoEncoder {
     supports_native_handle_ = enabled;
   }
 
+  void set_supports_nv12(bool enabled) { supports_nv12_ = enabled; }
+
   void set_init_encode_return_value(int32_t value) {
     init_encode_return_value_ = value;
   }
 
+  void set_max_speed_steps(int max_speed_steps) {
+    max_speed_steps_ = max_speed_steps;
+  }
+
+  int speed_steps() const { return speed_steps_; }
+
   VideoBitrateAllocation last_set_bitrate() const { return last_set_bitrate_; }
 
   MOCK_CONST_METHOD0(ImplementationName, const char*());
@@ -239,7 +261,10 @@ class MockVideoEncoder : public VideoEncoder {
  private:
   MockVideoEncoderFactory* const factory_;
   bool supports_native_handle_ = false;
+  bool supports_nv12_ = false;
   int32_t init_encode_return_value_ = 0;
+  int max_speed_steps_ = 0;
+  int speed_steps_ = 0;
   VideoBitrateAllocation last_set_bitrate_;
 
   VideoCodec codec_;
@@ -721,6 +746,24 @@ TEST_F(TestSimulcastEncoderAdapterFake, SupportsNativeHandleForSingleStreams) {
   EXPECT_FALSE(adapter_->SupportsNativeHandle());
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake, SetsSameSpeedStepsOnAllStreams) {
+  SetupCodec();
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (MockVideoEncoder* encoder : encoders)
+    encoder->set_max_speed_steps(2);
+  encoders[2]->set_max_speed_steps(1);
+
+  EXPECT_TRUE(adapter_->SetSpeedSteps(1));
+  for (MockVideoEncoder* encoder : encoders)
+    EXPECT_EQ(1, encoder->speed_steps());
+
+  // The streams that could be sped up more are restored.
+  EXPECT_FALSE(adapter_->SetSpeedSteps(2));
+  for (MockVideoEncoder* encoder : encoders)
+    EXPECT_EQ(1, encoder->speed_steps());
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, SetRatesUnderMinBitrate) {
   SimulcastTestFixtureImpl::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
@@ -838,6 +881,99 @@ TEST_F(TestSimulcastEncoderAdapterFake,
   EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
 }
 
+class FakeScalableNativeBuffer : public FakeNativeBufferNoI420 {
+ public:
+  FakeScalableNativeBuffer(int width, int height)
+      : FakeNativeBufferNoI420(width, height) {}
+
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScaleNative(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override {
+    return new rtc::RefCountedObject<FakeScalableNativeBuffer>(scaled_width,
+                                                               scaled_height);
+  }
+};
+
+TEST_F(TestSimulcastEncoderAdapterFake, ScalesNativeBuffersForStreams) {
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec_.numberOfSimulcastStreams = 3;
+  // High start bitrate, so all streams are enabled.
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 1, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  for (MockVideoEncoder* encoder : encoders)
+    encoder->set_supports_native_handle(true);
+
+  rtc::scoped_refptr<VideoFrameBuffer> buffer(
+      new rtc::RefCountedObject<FakeScalableNativeBuffer>(1280, 720));
+  VideoFrame input_frame(buffer, 100, 1000, kVideoRotation_0);
+  // The top stream gets the input frame, the others native buffers scaled to
+  // their resolution.
+  EXPECT_CALL(*encoders[2], Encode(::testing::Ref(input_frame), _, _));
+  for (size_t i = 0; i < 2; ++i) {
+    const int width = codec_.simulcastStream[i].width;
+    const int height = codec_.simulcastStream[i].height;
+    EXPECT_CALL(*encoders[i], Encode(_, _, _))
+        .WillOnce(Invoke([width, height](const VideoFrame& frame,
+                                         const CodecSpecificInfo*,
+                                         const std::vector<FrameType>*) {
+          EXPECT_EQ(VideoFrameBuffer::Type::kNative,
+                    frame.video_frame_buffer()->type());
+          EXPECT_EQ(width, frame.width());
+          EXPECT_EQ(height, frame.height());
+          return 0;
+        }));
+  }
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+}
+
+TEST_F(TestSimulcastEncoderAdapterFake, ScalesNV12BuffersInNV12) {
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec_.numberOfSimulcastStreams = 3;
+  // High start bitrate, so all streams are enabled.
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 1, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  EXPECT_FALSE(adapter_->SupportsNV12());
+  for (MockVideoEncoder* encoder : encoders)
+    encoder->set_supports_nv12(true);
+  EXPECT_TRUE(adapter_->SupportsNV12());
+
+  rtc::scoped_refptr<NV12Buffer> buffer = NV12Buffer::Create(1280, 720);
+  buffer->InitializeData();
+  VideoFrame input_frame(buffer, 100, 1000, kVideoRotation_0);
+  EXPECT_CALL(*encoders[2], Encode(::testing::Ref(input_frame), _, _));
+  for (size_t i = 0; i < 2; ++i) {
+    const int width = codec_.simulcastStream[i].width;
+    const int height = codec_.simulcastStream[i].height;
+    EXPECT_CALL(*encoders[i], Encode(_, _, _))
+        .WillOnce(Invoke([width, height](const VideoFrame& frame,
+                                         const CodecSpecificInfo*,
+                                         const std::vector<FrameType>*) {
+          EXPECT_EQ(VideoFrameBuffer::Type::kNV12,
+                    frame.video_frame_buffer()->type());
+          EXPECT_EQ(width, frame.width());
+          EXPECT_EQ(height, frame.height());
+          return 0;
+        }));
+  }
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, TestFailureReturnCodesFromEncodeCalls) {
   SimulcastTestFixtureImpl::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
@@ -903,5 +1039,110 @@ TEST_F(TestSimulcastEncoderAdapterFake, DoesNotAlterMaxQpForScreenshare) {
   ref_codec.qpMax = kLowMaxQp;
   VerifyCodec(ref_codec, 0);
 }
+
+TEST_F(TestSimulcastEncoderAdapterFake, ReusesScaledBuffers) {
+  SetupCodec();
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  std::vector<std::vector<VideoFrameBuffer*>> buffers(3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_CALL(*encoders[i], Encode(_, _, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&, i](const VideoFrame& frame,
+                                      const CodecSpecificInfo*,
+                                      const std::vector<FrameType>*) {
+          EXPECT_EQ(codec_.simulcastStream[i].width, frame.width());
+          EXPECT_EQ(codec_.simulcastStream[i].height, frame.height());
+          buffers[i].push_back(frame.video_frame_buffer().get());
+          return WEBRTC_VIDEO_CODEC_OK;
+        }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(VideoFrame(buffer, 100, 1000, kVideoRotation_0),
+                                nullptr, &frame_types));
+  EXPECT_EQ(0, adapter_->Encode(VideoFrame(buffer, 200, 1000, kVideoRotation_0),
+                                nullptr, &frame_types));
+
+  // The full resolution stream gets the input buffer, the others get the
+  // same scaled buffers for both frames, since the encoders released them.
+  EXPECT_EQ(buffer.get(), buffers[2][0]);
+  EXPECT_EQ(buffer.get(), buffers[2][1]);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_NE(buffer.get(), buffers[i][0]);
+    EXPECT_EQ(buffers[i][0], buffers[i][1]);
+  }
+}
+
+class SimulcastIndexRecorder : public EncodedImageCallback {
+ public:
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    simulcast_indices.push_back(
+        codec_specific_info->codecSpecific.VP8.simulcastIdx);
+    widths.push_back(encoded_image._encodedWidth);
+    return Result(Result::OK, encoded_image._timeStamp);
+  }
+
+  std::vector<int> simulcast_indices;
+  std::vector<int> widths;
+};
+
+TEST(SimulcastEncoderAdapterParallelTest, EncodesStreamsInParallel) {
+  ScopedFieldTrials field_trials(
+      "WebRTC-SimulcastEncoderAdapter-ParallelEncode/Enabled/");
+  TestSimulcastEncoderAdapterFakeHelper helper;
+  std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+  VideoCodec codec;
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  EXPECT_EQ(0, adapter->InitEncode(&codec, 4, 1200));
+  SimulcastIndexRecorder recorder;
+  adapter->RegisterEncodeCompleteCallback(&recorder);
+  std::vector<MockVideoEncoder*> encoders = helper.factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+
+  // The highest stream finishes first, but the encoded images are still
+  // passed on in stream order.
+  std::vector<rtc::PlatformThreadRef> threads(3);
+  std::vector<int> scaled_widths(3);
+  for (int i = 0; i < 3; ++i) {
+    MockVideoEncoder* encoder = encoders[i];
+    EXPECT_CALL(*encoder, Encode(_, _, _))
+        .WillOnce(Invoke([&, encoder, i](const VideoFrame& frame,
+                                         const CodecSpecificInfo*,
+                                         const std::vector<FrameType>*) {
+          threads[i] = rtc::CurrentThreadRef();
+          scaled_widths[i] = frame.width();
+          if (i < 2)
+            SleepMs(20 * (2 - i));
+          encoder->SendEncodedImage(frame.width(), frame.height());
+          return WEBRTC_VIDEO_CODEC_OK;
+        }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  buffer->InitializeData();
+  VideoFrame input_frame(buffer, 100, 1000, kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter->Encode(input_frame, nullptr, &frame_types));
+
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), recorder.simulcast_indices);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(codec.simulcastStream[i].width, scaled_widths[i]);
+    EXPECT_EQ(scaled_widths[i], recorder.widths[i]);
+  }
+  EXPECT_TRUE(rtc::IsThreadRefEqual(threads[0], rtc::CurrentThreadRef()));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(threads[1], threads[0]));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(threads[2], threads[0]));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(threads[2], threads[1]));
+  adapter->Release();
+}
 }  // namespace test
 }  // namespace webrtc
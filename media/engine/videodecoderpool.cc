@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/engine/videodecoderpool.h"
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace cricket {
+
+VideoDecoderPool::VideoDecoderPool(webrtc::VideoDecoderFactory* factory,
+                                   size_t max_pooled_decoders)
+    : factory_(factory), max_pooled_decoders_(max_pooled_decoders) {
+  RTC_DCHECK(factory_);
+}
+
+VideoDecoderPool::~VideoDecoderPool() {
+  if (requested_decoders_ > 0) {
+    RTC_LOG(LS_INFO) << "VideoDecoderPool reused " << reused_decoders_
+                     << " of " << requested_decoders_ << " decoders.";
+  }
+}
+
+std::unique_ptr<webrtc::VideoDecoder> VideoDecoderPool::CreateVideoDecoder(
+    const webrtc::SdpVideoFormat& format) {
+  ++requested_decoders_;
+  auto it = pooled_decoders_.find(format);
+  if (it != pooled_decoders_.end()) {
+    RTC_DCHECK(!it->second.empty());
+    std::unique_ptr<webrtc::VideoDecoder> decoder =
+        std::move(it->second.back());
+    it->second.pop_back();
+    if (it->second.empty())
+      pooled_decoders_.erase(it);
+    --num_pooled_decoders_;
+    ++reused_decoders_;
+    return decoder;
+  }
+  return factory_->CreateVideoDecoder(format);
+}
+
+void VideoDecoderPool::ReleaseVideoDecoder(
+    const webrtc::SdpVideoFormat& format,
+    std::unique_ptr<webrtc::VideoDecoder> decoder) {
+  if (!decoder)
+    return;
+  // The VCM releases the decoders it stops using, but the decoder must be
+  // initialized again by the next stream either way.
+  decoder->Release();
+  if (num_pooled_decoders_ >= max_pooled_decoders_)
+    return;
+  pooled_decoders_[format].push_back(std::move(decoder));
+  ++num_pooled_decoders_;
+}
+
+VideoDecoderPool::Stats VideoDecoderPool::GetStats() const {
+  Stats stats;
+  stats.pooled_decoders = num_pooled_decoders_;
+  stats.requested_decoders = requested_decoders_;
+  stats.reused_decoders = reused_decoders_;
+  return stats;
+}
+
+}  // namespace cricket
@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MEDIA_ENGINE_VIDEODECODERPOOL_H_
+#define MEDIA_ENGINE_VIDEODECODERPOOL_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_decoder.h"
+#include "api/video_codecs/video_decoder_factory.h"
+#include "rtc_base/constructormagic.h"
+
+namespace cricket {
+
+// Creates decoders with a VideoDecoderFactory, and keeps the decoders that
+// receive streams release to hand them to the next stream that receives the
+// same format. Saves creating and setting up a new decoder, including its
+// buffer pools, when streams are recreated or participants come and go.
+// Not thread safe, used on the worker thread.
+class VideoDecoderPool {
+ public:
+  struct Stats {
+    // Number of decoders currently kept for reuse.
+    size_t pooled_decoders = 0;
+    // Number of CreateVideoDecoder calls, and how many of them were served
+    // with a pooled decoder.
+    int requested_decoders = 0;
+    int reused_decoders = 0;
+  };
+
+  // Keeps at most |max_pooled_decoders| released decoders, further released
+  // decoders are destroyed.
+  VideoDecoderPool(webrtc::VideoDecoderFactory* factory,
+                   size_t max_pooled_decoders);
+  ~VideoDecoderPool();
+
+  // Returns a released decoder for |format| if there is one, otherwise a new
+  // one from the factory.
+  std::unique_ptr<webrtc::VideoDecoder> CreateVideoDecoder(
+      const webrtc::SdpVideoFormat& format);
+
+  // Releases the resources of |decoder|, which must no longer be used by a
+  // receive stream, and keeps it for the next stream that receives |format|.
+  void ReleaseVideoDecoder(const webrtc::SdpVideoFormat& format,
+                           std::unique_ptr<webrtc::VideoDecoder> decoder);
+
+  Stats GetStats() const;
+
+ private:
+  struct SdpVideoFormatCompare {
+    bool operator()(const webrtc::SdpVideoFormat& lhs,
+                    const webrtc::SdpVideoFormat& rhs) const {
+      return std::tie(lhs.name, lhs.parameters) <
+             std::tie(rhs.name, rhs.parameters);
+    }
+  };
+
+  webrtc::VideoDecoderFactory* const factory_;
+  const size_t max_pooled_decoders_;
+  std::map<webrtc::SdpVideoFormat,
+           std::vector<std::unique_ptr<webrtc::VideoDecoder>>,
+           SdpVideoFormatCompare>
+      pooled_decoders_;
+  size_t num_pooled_decoders_ = 0;
+  int requested_decoders_ = 0;
+  int reused_decoders_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VideoDecoderPool);
+};
+
+}  // namespace cricket
+
+#endif  // MEDIA_ENGINE_VIDEODECODERPOOL_H_
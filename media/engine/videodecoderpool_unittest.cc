@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/engine/videodecoderpool.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "test/gtest.h"
+
+namespace cricket {
+namespace {
+
+class FakeDecoder : public webrtc::VideoDecoder {
+ public:
+  explicit FakeDecoder(int* num_releases) : num_releases_(num_releases) {}
+
+  int32_t InitDecode(const webrtc::VideoCodec* codec_settings,
+                     int32_t number_of_cores) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Decode(const webrtc::EncodedImage& input_image,
+                 bool missing_frames,
+                 const webrtc::CodecSpecificInfo* codec_specific_info,
+                 int64_t render_time_ms) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t RegisterDecodeCompleteCallback(
+      webrtc::DecodedImageCallback* callback) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Release() override {
+    ++*num_releases_;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+ private:
+  int* const num_releases_;
+};
+
+class FakeDecoderFactory : public webrtc::VideoDecoderFactory {
+ public:
+  std::vector<webrtc::SdpVideoFormat> GetSupportedFormats() const override {
+    return {};
+  }
+
+  std::unique_ptr<webrtc::VideoDecoder> CreateVideoDecoder(
+      const webrtc::SdpVideoFormat& format) override {
+    ++num_created_decoders;
+    return absl::make_unique<FakeDecoder>(&num_releases);
+  }
+
+  int num_created_decoders = 0;
+  int num_releases = 0;
+};
+
+}  // namespace
+
+TEST(VideoDecoderPoolTest, ReusesReleasedDecodersOfTheSameFormat) {
+  FakeDecoderFactory factory;
+  VideoDecoderPool pool(&factory, 4);
+  const webrtc::SdpVideoFormat vp8("VP8");
+  const webrtc::SdpVideoFormat vp9("VP9");
+
+  std::unique_ptr<webrtc::VideoDecoder> decoder =
+      pool.CreateVideoDecoder(vp8);
+  webrtc::VideoDecoder* vp8_decoder = decoder.get();
+  pool.ReleaseVideoDecoder(vp8, std::move(decoder));
+  EXPECT_EQ(1, factory.num_releases);
+  EXPECT_EQ(1u, pool.GetStats().pooled_decoders);
+
+  // A stream receiving another format gets a new decoder.
+  std::unique_ptr<webrtc::VideoDecoder> other_decoder =
+      pool.CreateVideoDecoder(vp9);
+  EXPECT_NE(vp8_decoder, other_decoder.get());
+  EXPECT_EQ(2, factory.num_created_decoders);
+
+  decoder = pool.CreateVideoDecoder(vp8);
+  EXPECT_EQ(vp8_decoder, decoder.get());
+  EXPECT_EQ(2, factory.num_created_decoders);
+
+  VideoDecoderPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(0u, stats.pooled_decoders);
+  EXPECT_EQ(3, stats.requested_decoders);
+  EXPECT_EQ(1, stats.reused_decoders);
+}
+
+TEST(VideoDecoderPoolTest, DestroysDecodersReleasedToAFullPool) {
+  FakeDecoderFactory factory;
+  VideoDecoderPool pool(&factory, 2);
+  const webrtc::SdpVideoFormat vp8("VP8");
+
+  std::vector<std::unique_ptr<webrtc::VideoDecoder>> decoders;
+  for (int i = 0; i < 3; ++i)
+    decoders.push_back(pool.CreateVideoDecoder(vp8));
+  for (auto& decoder : decoders)
+    pool.ReleaseVideoDecoder(vp8, std::move(decoder));
+  EXPECT_EQ(3, factory.num_releases);
+  EXPECT_EQ(2u, pool.GetStats().pooled_decoders);
+
+  for (int i = 0; i < 3; ++i)
+    decoders[i] = pool.CreateVideoDecoder(vp8);
+  EXPECT_EQ(4, factory.num_created_decoders);
+  EXPECT_EQ(2, pool.GetStats().reused_decoders);
+}
+
+}  // namespace cricket
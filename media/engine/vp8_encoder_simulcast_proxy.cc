@@ -73,10 +73,22 @@ VideoEncoder::ScalingSettings VP8EncoderSimulcastProxy::GetScalingSettings()
   return encoder_->GetScalingSettings();
 }
 
+bool VP8EncoderSimulcastProxy::SetSpeedSteps(int steps) {
+  return encoder_->SetSpeedSteps(steps);
+}
+
+bool VP8EncoderSimulcastProxy::Reconfigure(const VideoCodec& codec_settings) {
+  return encoder_->Reconfigure(codec_settings);
+}
+
 bool VP8EncoderSimulcastProxy::SupportsNativeHandle() const {
   return encoder_->SupportsNativeHandle();
 }
 
+bool VP8EncoderSimulcastProxy::SupportsNV12() const {
+  return encoder_->SupportsNV12();
+}
+
 const char* VP8EncoderSimulcastProxy::ImplementationName() const {
   return encoder_->ImplementationName();
 }
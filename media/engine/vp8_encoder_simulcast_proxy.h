@@ -48,7 +48,11 @@ class VP8EncoderSimulcastProxy : public VP8Encoder {
 
   VideoEncoder::ScalingSettings GetScalingSettings() const override;
 
+  bool SetSpeedSteps(int steps) override;
+  bool Reconfigure(const VideoCodec& codec_settings) override;
+
   bool SupportsNativeHandle() const override;
+  bool SupportsNV12() const override;
   const char* ImplementationName() const override;
 
  private:
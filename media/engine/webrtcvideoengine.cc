@@ -16,6 +16,7 @@
 #include <string>
 #include <utility>
 
+#include "absl/memory/memory.h"
 #include "api/video/i420_buffer.h"
 #include "api/video_codecs/sdp_video_format.h"
 #include "api/video_codecs/video_decoder.h"
@@ -29,6 +30,7 @@
 #include "media/engine/convert_legacy_video_factory.h"  // nogncheck
 #endif
 #include "media/engine/simulcast.h"
+#include "media/engine/videodecoderpool.h"
 #include "media/engine/webrtcmediaengine.h"
 #include "media/engine/webrtcvoiceengine.h"
 #include "modules/video_coding/include/video_error_codes.h"
@@ -41,6 +43,11 @@
 
 namespace cricket {
 
+namespace {
+// The number of released decoders kept for new receive streams.
+constexpr size_t kMaxPooledDecoders = 8;
+}  // namespace
+
 // Hack in order to pass in |receive_stream_id| to legacy clients.
 // TODO(magjed): Remove once WebRtcVideoDecoderFactory is deprecated and
 // webrtc:7925 is fixed.
@@ -59,7 +66,10 @@ class DecoderFactoryAdapter {
   explicit DecoderFactoryAdapter(
       std::unique_ptr<webrtc::VideoDecoderFactory> video_decoder_factory)
       : cricket_decoder_with_params_(nullptr),
-        decoder_factory_(std::move(video_decoder_factory)) {}
+        decoder_factory_(std::move(video_decoder_factory)),
+        decoder_pool_(
+            absl::make_unique<VideoDecoderPool>(decoder_factory_.get(),
+                                                kMaxPooledDecoders)) {}
 
   void SetReceiveStreamId(const std::string& receive_stream_id) {
     if (cricket_decoder_with_params_)
@@ -72,9 +82,18 @@ class DecoderFactoryAdapter {
 
   std::unique_ptr<webrtc::VideoDecoder> CreateVideoDecoder(
       const webrtc::SdpVideoFormat& format) {
+    if (decoder_pool_)
+      return decoder_pool_->CreateVideoDecoder(format);
     return decoder_factory_->CreateVideoDecoder(format);
   }
 
+  // Called with the decoders of destroyed receive streams.
+  void ReleaseVideoDecoder(const webrtc::SdpVideoFormat& format,
+                           std::unique_ptr<webrtc::VideoDecoder> decoder) {
+    if (decoder_pool_)
+      decoder_pool_->ReleaseVideoDecoder(format, std::move(decoder));
+  }
+
  private:
   // WebRtcVideoDecoderFactory implementation that allows to override
   // |receive_stream_id|.
@@ -122,6 +141,9 @@ class DecoderFactoryAdapter {
   // |decoder_factory_|.
   CricketDecoderWithParams* const cricket_decoder_with_params_;
   std::unique_ptr<webrtc::VideoDecoderFactory> decoder_factory_;
+  // Decoders are not pooled for legacy factories, since the decoders they
+  // create are specific to the |receive_stream_id| of a stream.
+  const std::unique_ptr<VideoDecoderPool> decoder_pool_;
 };
 
 namespace {
@@ -1124,6 +1146,10 @@ bool WebRtcVideoChannel::AddSendStream(const StreamParams& sp) {
       video_config_.periodic_alr_bandwidth_probing;
   config.encoder_settings.experiment_cpu_load_estimator =
       video_config_.experiment_cpu_load_estimator;
+  config.encoder_settings.encoder_speed_adaptation =
+      video_config_.encoder_speed_adaptation;
+  config.encoder_settings.drop_frames_at_source =
+      video_config_.drop_frames_at_source;
   config.encoder_settings.encoder_factory = encoder_factory_;
 
   WebRtcVideoSendStream* stream = new WebRtcVideoSendStream(
@@ -1825,9 +1851,8 @@ webrtc::RTCError WebRtcVideoChannel::WebRtcVideoSendStream::SetRtpParameters(
       new_bitrate || (new_parameters.encodings[0].bitrate_priority !=
                       rtp_parameters_.encodings[0].bitrate_priority);
 
-  // TODO(bugs.webrtc.org/8807): The active field as well should not require
-  // a full encoder reconfiguration, but it needs to update both the bitrate
-  // allocator and the video bitrate allocator.
+  // The active field doesn't require an encoder reconfiguration: the send
+  // stream pauses the encoding of inactive layers.
   bool new_send_state = false;
   for (size_t i = 0; i < rtp_parameters_.encodings.size(); ++i) {
     if (new_parameters.encodings[i].active !=
@@ -1838,7 +1863,7 @@ webrtc::RTCError WebRtcVideoChannel::WebRtcVideoSendStream::SetRtpParameters(
   rtp_parameters_ = new_parameters;
   // Codecs are currently handled at the WebRtcVideoChannel level.
   rtp_parameters_.codecs.clear();
-  if (reconfigure_encoder || new_send_state) {
+  if (reconfigure_encoder) {
     ReconfigureEncoder();
   }
   if (new_send_state) {
@@ -2242,7 +2267,7 @@ WebRtcVideoChannel::WebRtcVideoReceiveStream::~WebRtcVideoReceiveStream() {
     call_->DestroyFlexfecReceiveStream(flexfec_stream_);
   }
   call_->DestroyVideoReceiveStream(stream_);
-  allocated_decoders_.clear();
+  ReleaseDecoders(&allocated_decoders_);
 }
 
 const std::vector<uint32_t>&
@@ -2341,6 +2366,15 @@ void WebRtcVideoChannel::WebRtcVideoReceiveStream::ConfigureCodecs(
   }
 }
 
+void WebRtcVideoChannel::WebRtcVideoReceiveStream::ReleaseDecoders(
+    DecoderMap* decoders) {
+  if (decoder_factory_) {
+    for (auto& kv : *decoders)
+      decoder_factory_->ReleaseVideoDecoder(kv.first, std::move(kv.second));
+  }
+  decoders->clear();
+}
+
 void WebRtcVideoChannel::WebRtcVideoReceiveStream::ConfigureFlexfecCodec(
     int flexfec_payload_type) {
   flexfec_config_.payload_type = flexfec_payload_type;
@@ -2430,6 +2464,7 @@ void WebRtcVideoChannel::WebRtcVideoReceiveStream::SetRecvParameters(
         << "RecreateWebRtcVideoStream (recv) because of SetRecvParameters";
     RecreateWebRtcVideoStream();
   }
+  ReleaseDecoders(&old_decoders);
 }
 
 void WebRtcVideoChannel::WebRtcVideoReceiveStream::RecreateWebRtcVideoStream() {
@@ -2569,6 +2604,7 @@ WebRtcVideoChannel::WebRtcVideoReceiveStream::GetVideoReceiverInfo(
   info.nacks_sent = stats.rtcp_packet_type_counts.nack_packets;
 
   info.timing_frame_info = stats.timing_frame_info;
+  info.frame_latency_stages = stats.frame_latency_stages;
 
   if (log_stats)
     RTC_LOG(LS_INFO) << stats.ToString(rtc::TimeMillis());
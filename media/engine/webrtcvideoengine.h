@@ -397,6 +397,9 @@ class WebRtcVideoChannel : public VideoMediaChannel, public webrtc::Transport {
 
     void ConfigureCodecs(const std::vector<VideoCodecSettings>& recv_codecs,
                          DecoderMap* old_codecs);
+    // Hands |decoders|, no longer used by |stream_|, back to the
+    // |decoder_factory_|.
+    void ReleaseDecoders(DecoderMap* decoders);
     void ConfigureFlexfecCodec(int flexfec_payload_type);
 
     std::string GetCodecNameFromPayloadType(int payload_type);
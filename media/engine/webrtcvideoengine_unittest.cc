@@ -933,9 +933,13 @@ TEST_F(WebRtcVideoEngineTest, RegisterDecodersIfSupported) {
   EXPECT_TRUE(channel->SetRecvParameters(parameters));
   EXPECT_EQ(1, decoder_factory_->GetNumCreatedDecoders());
 
-  // Remove stream previously added to free the external decoder instance.
+  // Removing the stream keeps the decoder for the next stream.
   EXPECT_TRUE(channel->RemoveRecvStream(kSsrc));
-  EXPECT_EQ(0u, decoder_factory_->decoders().size());
+  EXPECT_EQ(1u, decoder_factory_->decoders().size());
+  EXPECT_TRUE(
+      channel->AddRecvStream(cricket::StreamParams::CreateLegacy(kSsrc + 1)));
+  EXPECT_EQ(1u, decoder_factory_->decoders().size());
+  EXPECT_EQ(1, decoder_factory_->GetNumCreatedDecoders());
 }
 
 // Verifies that we can set up decoders.
@@ -5897,8 +5901,8 @@ TEST_F(WebRtcVideoChannelTest, SetRtpSendParametersOneEncodingActive) {
 }
 
 // Tests that when active is updated for any simulcast layer then the send
-// stream's sending state will be updated and it will be reconfigured with the
-// new appropriate active simulcast streams.
+// stream's sending state and active layers will be updated, without
+// reconfiguring its encoder.
 TEST_F(WebRtcVideoChannelTest, SetRtpSendParametersMultipleEncodingsActive) {
   // Create the stream params with multiple ssrcs for simulcast.
   const size_t kNumSimulcastStreams = 3;
@@ -5908,8 +5912,7 @@ TEST_F(WebRtcVideoChannelTest, SetRtpSendParametersMultipleEncodingsActive) {
   uint32_t primary_ssrc = stream_params.first_ssrc();
 
   // Using the FakeVideoCapturerWithTaskQueue, we manually send a full size
-  // frame. This allows us to test that ReconfigureEncoder is called
-  // appropriately.
+  // frame. This allows us to test that ReconfigureEncoder isn't called.
   cricket::FakeVideoCapturerWithTaskQueue capturer;
   VideoOptions options;
   EXPECT_TRUE(channel_->SetVideoSend(primary_ssrc, &options, &capturer));
@@ -5928,6 +5931,8 @@ TEST_F(WebRtcVideoChannelTest, SetRtpSendParametersMultipleEncodingsActive) {
   EXPECT_TRUE(parameters.encodings[1].active);
   EXPECT_TRUE(parameters.encodings[2].active);
   EXPECT_TRUE(fake_video_send_stream->IsSending());
+  const int num_encoder_reconfigurations =
+      fake_video_send_stream->num_encoder_reconfigurations();
 
   // Only turn on only the middle stream.
   parameters.encodings[0].active = false;
@@ -5941,14 +5946,12 @@ TEST_F(WebRtcVideoChannelTest, SetRtpSendParametersMultipleEncodingsActive) {
   EXPECT_TRUE(parameters.encodings[1].active);
   EXPECT_FALSE(parameters.encodings[2].active);
   // Check that the VideoSendStream is updated appropriately. This means its
-  // send state was updated and it was reconfigured.
+  // active layers were updated, without reconfiguring its encoder.
   EXPECT_TRUE(fake_video_send_stream->IsSending());
-  std::vector<webrtc::VideoStream> simulcast_streams =
-      fake_video_send_stream->GetVideoStreams();
-  EXPECT_EQ(kNumSimulcastStreams, simulcast_streams.size());
-  EXPECT_FALSE(simulcast_streams[0].active);
-  EXPECT_TRUE(simulcast_streams[1].active);
-  EXPECT_FALSE(simulcast_streams[2].active);
+  EXPECT_EQ(std::vector<bool>({false, true, false}),
+            fake_video_send_stream->active_layers());
+  EXPECT_EQ(num_encoder_reconfigurations,
+            fake_video_send_stream->num_encoder_reconfigurations());
 
   // Turn off all streams.
   parameters.encodings[0].active = false;
@@ -5963,11 +5966,10 @@ TEST_F(WebRtcVideoChannelTest, SetRtpSendParametersMultipleEncodingsActive) {
   EXPECT_FALSE(parameters.encodings[2].active);
   // Check that the VideoSendStream is off.
   EXPECT_FALSE(fake_video_send_stream->IsSending());
-  simulcast_streams = fake_video_send_stream->GetVideoStreams();
-  EXPECT_EQ(kNumSimulcastStreams, simulcast_streams.size());
-  EXPECT_FALSE(simulcast_streams[0].active);
-  EXPECT_FALSE(simulcast_streams[1].active);
-  EXPECT_FALSE(simulcast_streams[2].active);
+  EXPECT_EQ(std::vector<bool>({false, false, false}),
+            fake_video_send_stream->active_layers());
+  EXPECT_EQ(num_encoder_reconfigurations,
+            fake_video_send_stream->num_encoder_reconfigurations());
 
   EXPECT_TRUE(channel_->SetVideoSend(primary_ssrc, nullptr, nullptr));
 }
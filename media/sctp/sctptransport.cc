@@ -259,12 +259,22 @@ class SctpTransport::UsrSctpWrapper {
 
     VerboseLogPacket(data, length, SCTP_DUMP_OUTBOUND);
     // Note: We have to copy the data; the caller will delete it.
-    rtc::CopyOnWriteBuffer buf(reinterpret_cast<uint8_t*>(data), length);
-    // TODO(deadbeef): Why do we need an AsyncInvoke here? We're already on the
-    // right thread and don't need to unwind the stack.
-    transport->invoker_.AsyncInvoke<void>(
-        RTC_FROM_HERE, transport->network_thread_,
-        rtc::Bind(&SctpTransport::OnPacketFromSctpToNetwork, transport, buf));
+    // This may be called on the usrsctp timer thread, as well as on the
+    // network thread while it unwinds out of usrsctp, so the packet is
+    // queued and sent from a post. A burst of packets, such as the ones of a
+    // large message, shares the post of its first packet.
+    bool post;
+    {
+      rtc::CritScope cs(&transport->outbound_crit_);
+      post = transport->outbound_packets_.empty();
+      transport->outbound_packets_.emplace_back(
+          reinterpret_cast<uint8_t*>(data), length);
+    }
+    if (post) {
+      transport->invoker_.AsyncInvoke<void>(
+          RTC_FROM_HERE, transport->network_thread_,
+          rtc::Bind(&SctpTransport::OnPacketsFromSctpToNetwork, transport));
+    }
     return 0;
   }
 
@@ -428,6 +438,16 @@ bool SctpTransport::Start(int local_sctp_port, int remote_sctp_port) {
   return true;
 }
 
+void SctpTransport::SetOptions(const SctpOptions& options) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (started_) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->SetOptions(...): "
+                        << "Ignoring the options set after Start().";
+    return;
+  }
+  options_ = options;
+}
+
 bool SctpTransport::OpenStream(int sid) {
   RTC_DCHECK_RUN_ON(network_thread_);
   if (sid > kMaxSctpSid) {
@@ -649,10 +669,13 @@ bool SctpTransport::OpenSctpSocket() {
   // still have to do something reasonable here.  Look up what the buffer's
   // real size is and set our threshold to something reasonable.
   static const int kSendThreshold = usrsctp_sysctl_get_sctp_sendspace() / 2;
+  const int send_threshold = options_.send_buffer_size > 0
+                                 ? options_.send_buffer_size / 2
+                                 : kSendThreshold;
 
   sock_ = usrsctp_socket(
       AF_CONN, SOCK_STREAM, IPPROTO_SCTP, &UsrSctpWrapper::OnSctpInboundPacket,
-      &UsrSctpWrapper::SendThresholdCallback, kSendThreshold, this);
+      &UsrSctpWrapper::SendThresholdCallback, send_threshold, this);
   if (!sock_) {
     RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->OpenSctpSocket(): "
                             << "Failed to create SCTP socket.";
@@ -726,6 +749,49 @@ bool SctpTransport::ConfigureSctpSocket() {
     return false;
   }
 
+  // Buffer sizes. The receive buffer has to be set before connecting, as it
+  // determines the window advertised in the INIT.
+  if (options_.send_buffer_size > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF,
+                         &options_.send_buffer_size,
+                         sizeof(options_.send_buffer_size))) {
+    RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                            << "Failed to set SO_SNDBUF.";
+    return false;
+  }
+  if (options_.receive_buffer_size > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_RCVBUF,
+                         &options_.receive_buffer_size,
+                         sizeof(options_.receive_buffer_size))) {
+    RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                            << "Failed to set SO_RCVBUF.";
+    return false;
+  }
+
+  // Congestion control.
+  if (options_.max_burst > 0) {
+    struct sctp_assoc_value max_burst;
+    max_burst.assoc_id = SCTP_ALL_ASSOC;
+    max_burst.assoc_value = options_.max_burst;
+    if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_MAX_BURST, &max_burst,
+                           sizeof(max_burst))) {
+      RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                              << "Failed to set SCTP_MAX_BURST.";
+      return false;
+    }
+  }
+  if (options_.use_htcp_congestion_control) {
+    struct sctp_assoc_value cc;
+    cc.assoc_id = SCTP_ALL_ASSOC;
+    cc.assoc_value = SCTP_CC_HTCP;
+    if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_PLUGGABLE_CC, &cc,
+                           sizeof(cc))) {
+      RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                              << "Failed to set SCTP_PLUGGABLE_CC.";
+      return false;
+    }
+  }
+
   // Subscribe to SCTP event notifications.
   int event_types[] = {SCTP_ASSOC_CHANGE, SCTP_PEER_ADDR_CHANGE,
                        SCTP_SEND_FAILED_EVENT, SCTP_SENDER_DRY_EVENT,
@@ -892,6 +958,18 @@ sockaddr_conn SctpTransport::GetSctpSockAddr(int port) {
   return sconn;
 }
 
+void SctpTransport::OnPacketsFromSctpToNetwork() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  std::vector<rtc::CopyOnWriteBuffer> packets;
+  {
+    rtc::CritScope cs(&outbound_crit_);
+    packets.swap(outbound_packets_);
+  }
+  for (const rtc::CopyOnWriteBuffer& packet : packets) {
+    OnPacketFromSctpToNetwork(packet);
+  }
+}
+
 void SctpTransport::OnPacketFromSctpToNetwork(
     const rtc::CopyOnWriteBuffer& buffer) {
   RTC_DCHECK_RUN_ON(network_thread_);
@@ -22,8 +22,10 @@
 #include "rtc_base/asyncinvoker.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
 // For SendDataParams/ReceiveDataParams.
 #include "media/base/mediachannel.h"
 #include "media/sctp/sctptransportinternal.h"
@@ -74,6 +76,7 @@ class SctpTransport : public SctpTransportInternal,
   // SctpTransportInternal overrides (see sctptransportinternal.h for comments).
   void SetDtlsTransport(rtc::PacketTransportInternal* transport) override;
   bool Start(int local_port, int remote_port) override;
+  void SetOptions(const SctpOptions& options) override;
   bool OpenStream(int sid) override;
   bool ResetStream(int sid) override;
   bool SendData(const SendDataParams& params,
@@ -120,7 +123,9 @@ class SctpTransport : public SctpTransportInternal,
   void OnSendThresholdCallback();
   sockaddr_conn GetSctpSockAddr(int port);
 
-  // Called using |invoker_| to send packet on the network.
+  // Called using |invoker_| to send the packets that usrsctp queued in
+  // |outbound_packets_| on the network.
+  void OnPacketsFromSctpToNetwork();
   void OnPacketFromSctpToNetwork(const rtc::CopyOnWriteBuffer& buffer);
   // Called using |invoker_| to decide what to do with the packet.
   // The |flags| parameter is used by SCTP to distinguish notification packets
@@ -143,6 +148,15 @@ class SctpTransport : public SctpTransportInternal,
   // Underlying DTLS channel.
   rtc::PacketTransportInternal* transport_ = nullptr;
 
+  // The packets that usrsctp produced, which may be on its timer thread, and
+  // that are waiting to be sent on the network thread. Only one post is
+  // pending at a time, so a burst of packets is sent with a single post.
+  rtc::CriticalSection outbound_crit_;
+  std::vector<rtc::CopyOnWriteBuffer> outbound_packets_
+      RTC_GUARDED_BY(outbound_crit_);
+
+  SctpOptions options_;
+
   // Track the data received from usrsctp between callbacks until the EOR bit
   // arrives.
   rtc::CopyOnWriteBuffer partial_message_;
@@ -132,6 +132,12 @@ class SctpTransportTest : public testing::Test, public sigslot::has_slots<> {
   }
 
   void SetupConnectedTransportsWithTwoStreams(int port1, int port2) {
+    SetupConnectedTransportsWithTwoStreams(port1, port2, SctpOptions());
+  }
+
+  void SetupConnectedTransportsWithTwoStreams(int port1,
+                                              int port2,
+                                              const SctpOptions& options) {
     fake_dtls1_.reset(new FakeDtlsTransport("fake dtls 1", 0));
     fake_dtls2_.reset(new FakeDtlsTransport("fake dtls 2", 0));
     recv1_.reset(new SctpFakeDataReceiver());
@@ -144,6 +150,8 @@ class SctpTransportTest : public testing::Test, public sigslot::has_slots<> {
     transport2_->set_debug_name_for_testing("transport2");
     transport2_->SignalReadyToSendData.connect(
         this, &SctpTransportTest::OnChan2ReadyToSend);
+    transport1_->SetOptions(options);
+    transport2_->SetOptions(options);
     // Setup two connected transports ready to send and receive.
     bool asymmetric = false;
     fake_dtls1_->SetDestination(fake_dtls2_.get(), asymmetric);
@@ -447,6 +455,41 @@ TEST_F(SctpTransportTest, SendDataBlocked) {
   EXPECT_EQ(SDR_BLOCK, result);
 }
 
+// A larger send buffer takes more data before SDR_BLOCK is returned, and the
+// receive buffer and congestion control options still let it through.
+TEST_F(SctpTransportTest, SendDataWithLargerBuffers) {
+  SctpOptions options;
+  options.send_buffer_size = 1024 * 1024;
+  options.receive_buffer_size = 1024 * 1024;
+  options.max_burst = 8;
+  options.use_htcp_congestion_control = true;
+  SetupConnectedTransportsWithTwoStreams(kTransport1Port, kTransport2Port,
+                                         options);
+  EXPECT_EQ_WAIT(1, transport1_ready_to_send_count(), kDefaultTimeout);
+
+  // With the default 256 kB send buffer, about 256 of these are taken.
+  fake_dtls1()->SetWritable(false);
+  static const int kMaxMessages = 4096;
+  SendDataParams params;
+  params.sid = 1;
+  rtc::CopyOnWriteBuffer buf(1024);
+  memset(buf.data<uint8_t>(), 0, 1024);
+  SendDataResult result;
+  int message_count;
+  for (message_count = 0; message_count < kMaxMessages; ++message_count) {
+    if (!transport1()->SendData(params, buf, &result) && result == SDR_BLOCK) {
+      break;
+    }
+  }
+  EXPECT_GT(message_count, 512);
+  ASSERT_NE(kMaxMessages, message_count);
+
+  fake_dtls1()->SetWritable(true);
+  EXPECT_EQ_WAIT(2, transport1_ready_to_send_count(), kDefaultTimeout);
+  ASSERT_TRUE(SendData(transport1(), 1, "done", &result));
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, "done"), kDefaultTimeout);
+}
+
 // Trying to send data for a nonexistent stream should fail.
 TEST_F(SctpTransportTest, SendDataWithNonexistentStreamFails) {
   SetupConnectedTransportsWithTwoStreams();
@@ -48,6 +48,23 @@ constexpr uint16_t kMinSctpSid = 0;
 // usrsctp.h)
 const int kSctpDefaultPort = 5000;
 
+// Options of the SCTP association, for bulk transfers on paths with a high
+// bandwidth-delay product. Values of 0 keep the usrsctp defaults.
+struct SctpOptions {
+  // The size of the send buffer in bytes, which bounds the data that the
+  // transport accepts before SendData() returns SDR_BLOCK.
+  int send_buffer_size = 0;
+  // The size of the receive buffer in bytes, which bounds the window that the
+  // peer is allowed to have in flight.
+  int receive_buffer_size = 0;
+  // The maximum number of packets sent at once when the congestion window
+  // opens.
+  int max_burst = 0;
+  // If true, the congestion window grows with H-TCP instead of the RFC 4960
+  // algorithm, which recovers from a loss much faster on long fat paths.
+  bool use_htcp_congestion_control = false;
+};
+
 // Abstract SctpTransport interface for use internally (by PeerConnection etc.).
 // Exists to allow mock/fake SctpTransports to be created.
 class SctpTransportInternal {
@@ -75,6 +92,9 @@ class SctpTransportInternal {
   // support though. See: https://github.com/w3c/webrtc-pc/issues/979
   virtual bool Start(int local_sctp_port, int remote_sctp_port) = 0;
 
+  // Sets the options of the association. Must be called before Start.
+  virtual void SetOptions(const SctpOptions& options) {}
+
   // NOTE: Initially there was a "Stop" method here, but it was never used, so
   // it was removed.
 
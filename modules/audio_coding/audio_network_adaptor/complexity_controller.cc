@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/audio_network_adaptor/complexity_controller.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+// Smooths the encode usage over about half a second of 10 ms blocks, so that
+// the effect of a change shows before the next change is allowed.
+constexpr float kEncodeUsageAlpha = 0.98f;
+constexpr int64_t kBlockDurationUs = 10000;
+constexpr int kComplexityDecreaseStep = 2;
+constexpr int kComplexityIncreaseStep = 1;
+}  // namespace
+
+ComplexityController::Config::Config(int min_complexity,
+                                     int max_complexity,
+                                     float high_encode_usage,
+                                     float low_encode_usage,
+                                     int high_cpu_usage_percent,
+                                     int low_cpu_usage_percent,
+                                     int min_time_between_decreases_ms,
+                                     int min_time_between_increases_ms)
+    : min_complexity(min_complexity),
+      max_complexity(max_complexity),
+      high_encode_usage(high_encode_usage),
+      low_encode_usage(low_encode_usage),
+      high_cpu_usage_percent(high_cpu_usage_percent),
+      low_cpu_usage_percent(low_cpu_usage_percent),
+      min_time_between_decreases_ms(min_time_between_decreases_ms),
+      min_time_between_increases_ms(min_time_between_increases_ms) {}
+
+ComplexityController::ComplexityController(const Config& config)
+    : config_(config),
+      complexity_(config_.max_complexity),
+      encode_usage_(kEncodeUsageAlpha) {
+  RTC_DCHECK_LE(config_.min_complexity, config_.max_complexity);
+  RTC_DCHECK_LT(config_.low_encode_usage, config_.high_encode_usage);
+  RTC_DCHECK_LT(config_.low_cpu_usage_percent, config_.high_cpu_usage_percent);
+}
+
+ComplexityController::~ComplexityController() = default;
+
+void ComplexityController::UpdateEncodeTime(int64_t encode_time_us,
+                                            int64_t audio_duration_us) {
+  RTC_DCHECK_GT(audio_duration_us, 0);
+  encode_usage_.Apply(
+      static_cast<float>(audio_duration_us) / kBlockDurationUs,
+      static_cast<float>(encode_time_us) / audio_duration_us);
+}
+
+void ComplexityController::UpdateCpuUsage(int cpu_usage_percent) {
+  cpu_usage_percent_ = cpu_usage_percent;
+}
+
+bool ComplexityController::MakeDecision(int64_t now_ms) {
+  if (!last_change_ms_) {
+    // Let the measurements settle before the first change.
+    last_change_ms_ = now_ms;
+    return false;
+  }
+  const int64_t time_since_change_ms = now_ms - *last_change_ms_;
+  const bool has_encode_usage =
+      encode_usage_.filtered() != rtc::ExpFilter::kValueUndefined;
+  const bool overused =
+      (has_encode_usage &&
+       encode_usage_.filtered() > config_.high_encode_usage) ||
+      (cpu_usage_percent_ &&
+       *cpu_usage_percent_ > config_.high_cpu_usage_percent);
+  const bool underused =
+      (!has_encode_usage ||
+       encode_usage_.filtered() < config_.low_encode_usage) &&
+      (!cpu_usage_percent_ ||
+       *cpu_usage_percent_ < config_.low_cpu_usage_percent);
+
+  int new_complexity = complexity_;
+  if (overused &&
+      time_since_change_ms >= config_.min_time_between_decreases_ms) {
+    new_complexity = std::max(complexity_ - kComplexityDecreaseStep,
+                              config_.min_complexity);
+  } else if (underused &&
+             time_since_change_ms >= config_.min_time_between_increases_ms) {
+    new_complexity = std::min(complexity_ + kComplexityIncreaseStep,
+                              config_.max_complexity);
+  }
+  if (new_complexity == complexity_)
+    return false;
+  complexity_ = new_complexity;
+  last_change_ms_ = now_ms;
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
+#define MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/numerics/exp_filter.h"
+
+namespace webrtc {
+
+// Limits the complexity of an encoder when the CPU is overused, either because
+// encoding takes up too much of the real time of the audio, or because the
+// system as a whole is loaded, and raises it again once the load has been low
+// for a while. Unlike the other controllers, it does not act on network
+// metrics, and the encoder queries it directly.
+class ComplexityController final {
+ public:
+  struct Config {
+    Config(int min_complexity,
+           int max_complexity,
+           float high_encode_usage,
+           float low_encode_usage,
+           int high_cpu_usage_percent,
+           int low_cpu_usage_percent,
+           int min_time_between_decreases_ms,
+           int min_time_between_increases_ms);
+    int min_complexity;
+    // Also the initial complexity.
+    int max_complexity;
+    // Fraction of the duration of the audio spent encoding it, above which
+    // the complexity is lowered.
+    float high_encode_usage;
+    // Fraction of the duration of the audio spent encoding it, below which
+    // the complexity may be raised.
+    float low_encode_usage;
+    // System CPU usage above which the complexity is lowered.
+    int high_cpu_usage_percent;
+    // System CPU usage below which the complexity may be raised.
+    int low_cpu_usage_percent;
+    // The complexity is lowered quickly, to avoid missing deadlines, and
+    // raised slowly, to avoid oscillating.
+    int min_time_between_decreases_ms;
+    int min_time_between_increases_ms;
+  };
+
+  explicit ComplexityController(const Config& config);
+
+  ~ComplexityController();
+
+  // Reports that |audio_duration_us| of audio took |encode_time_us| to encode.
+  void UpdateEncodeTime(int64_t encode_time_us, int64_t audio_duration_us);
+
+  // Reports the CPU usage of the system, e.g. as estimated by
+  // OveruseFrameDetector from the time spent encoding video.
+  void UpdateCpuUsage(int cpu_usage_percent);
+
+  // Returns true if the complexity has changed.
+  bool MakeDecision(int64_t now_ms);
+
+  int complexity() const { return complexity_; }
+
+ private:
+  const Config config_;
+  int complexity_;
+  rtc::ExpFilter encode_usage_;
+  absl::optional<int> cpu_usage_percent_;
+  absl::optional<int64_t> last_change_ms_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(ComplexityController);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
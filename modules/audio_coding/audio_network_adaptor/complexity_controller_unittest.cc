@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/audio_network_adaptor/complexity_controller.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kMinComplexity = 1;
+constexpr int kMaxComplexity = 9;
+constexpr float kHighEncodeUsage = 0.2f;
+constexpr float kLowEncodeUsage = 0.05f;
+constexpr int kHighCpuUsagePercent = 85;
+constexpr int kLowCpuUsagePercent = 42;
+constexpr int kMinTimeBetweenDecreasesMs = 1000;
+constexpr int kMinTimeBetweenIncreasesMs = 10000;
+constexpr int64_t kBlockDurationUs = 10000;
+
+ComplexityController::Config CreateConfig() {
+  return ComplexityController::Config(
+      kMinComplexity, kMaxComplexity, kHighEncodeUsage, kLowEncodeUsage,
+      kHighCpuUsagePercent, kLowCpuUsagePercent, kMinTimeBetweenDecreasesMs,
+      kMinTimeBetweenIncreasesMs);
+}
+
+// Encodes |duration_ms| of audio in 10 ms blocks, each taking |encode_usage|
+// of the block duration, and lets the controller decide after each block.
+// Returns the time after the last block.
+int64_t EncodeFor(ComplexityController* controller,
+                  int64_t now_ms,
+                  int duration_ms,
+                  float encode_usage) {
+  for (int t = 0; t < duration_ms; t += 10) {
+    controller->UpdateEncodeTime(
+        static_cast<int64_t>(encode_usage * kBlockDurationUs),
+        kBlockDurationUs);
+    now_ms += 10;
+    controller->MakeDecision(now_ms);
+  }
+  return now_ms;
+}
+
+}  // namespace
+
+TEST(ComplexityControllerTest, StartsAtMaxComplexity) {
+  ComplexityController controller(CreateConfig());
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+  EXPECT_FALSE(controller.MakeDecision(0));
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+}
+
+TEST(ComplexityControllerTest, DecreasesWhenEncodingTakesTooLong) {
+  ComplexityController controller(CreateConfig());
+  controller.MakeDecision(0);
+  int64_t now_ms = EncodeFor(&controller, 0, kMinTimeBetweenDecreasesMs - 10,
+                             2 * kHighEncodeUsage);
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+  now_ms = EncodeFor(&controller, now_ms, 10, 2 * kHighEncodeUsage);
+  EXPECT_EQ(kMaxComplexity - 2, controller.complexity());
+
+  // Keeps decreasing down to the minimum complexity while overused.
+  EncodeFor(&controller, now_ms, 10 * kMinTimeBetweenDecreasesMs,
+            2 * kHighEncodeUsage);
+  EXPECT_EQ(kMinComplexity, controller.complexity());
+}
+
+TEST(ComplexityControllerTest, DecreasesWhenSystemCpuIsOverused) {
+  ComplexityController controller(CreateConfig());
+  controller.MakeDecision(0);
+  controller.UpdateCpuUsage(kHighCpuUsagePercent + 1);
+  EncodeFor(&controller, 0, kMinTimeBetweenDecreasesMs, kLowEncodeUsage / 2);
+  EXPECT_EQ(kMaxComplexity - 2, controller.complexity());
+}
+
+TEST(ComplexityControllerTest, KeepsComplexityWithinHysteresis) {
+  ComplexityController controller(CreateConfig());
+  const float kMediumEncodeUsage = (kHighEncodeUsage + kLowEncodeUsage) / 2;
+  controller.MakeDecision(0);
+  int64_t now_ms = EncodeFor(&controller, 0, kMinTimeBetweenDecreasesMs,
+                             2 * kHighEncodeUsage);
+  const int decreased_complexity = controller.complexity();
+  EXPECT_LT(decreased_complexity, kMaxComplexity);
+  EncodeFor(&controller, now_ms, 2 * kMinTimeBetweenIncreasesMs,
+            kMediumEncodeUsage);
+  EXPECT_EQ(decreased_complexity, controller.complexity());
+}
+
+TEST(ComplexityControllerTest, IncreasesSlowlyWhenUnderused) {
+  ComplexityController controller(CreateConfig());
+  controller.MakeDecision(0);
+  int64_t now_ms = EncodeFor(&controller, 0, kMinTimeBetweenDecreasesMs,
+                             2 * kHighEncodeUsage);
+  EXPECT_EQ(kMaxComplexity - 2, controller.complexity());
+
+  // The encode usage of the past high complexity is forgotten within a few
+  // seconds.
+  now_ms = EncodeFor(&controller, now_ms, kMinTimeBetweenIncreasesMs - 10,
+                     kLowEncodeUsage / 2);
+  EXPECT_EQ(kMaxComplexity - 2, controller.complexity());
+  now_ms = EncodeFor(&controller, now_ms, 10, kLowEncodeUsage / 2);
+  EXPECT_EQ(kMaxComplexity - 1, controller.complexity());
+  EncodeFor(&controller, now_ms, 10 * kMinTimeBetweenIncreasesMs,
+            kLowEncodeUsage / 2);
+  EXPECT_EQ(kMaxComplexity, controller.complexity());
+}
+
+TEST(ComplexityControllerTest, DoesNotIncreaseWhileSystemCpuIsBusy) {
+  ComplexityController controller(CreateConfig());
+  controller.MakeDecision(0);
+  int64_t now_ms = EncodeFor(&controller, 0, kMinTimeBetweenDecreasesMs,
+                             2 * kHighEncodeUsage);
+  EXPECT_EQ(kMaxComplexity - 2, controller.complexity());
+  controller.UpdateCpuUsage((kHighCpuUsagePercent + kLowCpuUsagePercent) / 2);
+  EncodeFor(&controller, now_ms, 2 * kMinTimeBetweenIncreasesMs,
+            kLowEncodeUsage / 2);
+  EXPECT_EQ(kMaxComplexity - 2, controller.complexity());
+}
+
+}  // namespace webrtc
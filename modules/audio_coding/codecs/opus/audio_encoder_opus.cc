@@ -17,6 +17,7 @@
 #include "absl/memory/memory.h"
 #include "common_types.h"  // NOLINT(build/include)
 #include "modules/audio_coding/audio_network_adaptor/audio_network_adaptor_impl.h"
+#include "modules/audio_coding/audio_network_adaptor/complexity_controller.h"
 #include "modules/audio_coding/audio_network_adaptor/controller_manager.h"
 #include "modules/audio_coding/codecs/opus/opus_interface.h"
 #include "rtc_base/arraysize.h"
@@ -214,6 +215,19 @@ int GetBitrateBps(const AudioEncoderOpusConfig& config) {
   return *config.bitrate_bps;
 }
 
+std::unique_ptr<ComplexityController> CreateComplexityController(
+    const AudioEncoderOpusConfig& config) {
+  if (!webrtc::field_trial::IsEnabled(
+          "WebRTC-Audio-OpusCpuAdaptiveComplexity")) {
+    return nullptr;
+  }
+  // The CPU usage thresholds are the ones OveruseFrameDetector uses for
+  // video, adapting the complexity of which keeps that usage in between.
+  return absl::make_unique<ComplexityController>(ComplexityController::Config(
+      1, std::max(config.complexity, config.low_rate_complexity), 0.2f, 0.05f,
+      85, 42, 1000, 10000));
+}
+
 }  // namespace
 
 void AudioEncoderOpusImpl::AppendSupportedEncoders(
@@ -406,7 +420,8 @@ AudioEncoderOpusImpl::AudioEncoderOpusImpl(
       packet_loss_fraction_smoother_(new PacketLossFractionSmoother()),
       audio_network_adaptor_creator_(audio_network_adaptor_creator),
       bitrate_smoother_(std::move(bitrate_smoother)),
-      consecutive_dtx_frames_(0) {
+      consecutive_dtx_frames_(0),
+      complexity_controller_(CreateComplexityController(config)) {
   RTC_DCHECK(0 <= payload_type && payload_type <= 127);
 
   // Sanity check of the redundant payload type field that we want to get rid
@@ -583,6 +598,11 @@ void AudioEncoderOpusImpl::OnReceivedOverhead(
   }
 }
 
+void AudioEncoderOpusImpl::OnReceivedCpuUsage(int cpu_usage_percent) {
+  if (complexity_controller_)
+    complexity_controller_->UpdateCpuUsage(cpu_usage_percent);
+}
+
 void AudioEncoderOpusImpl::SetReceiverFrameLengthRange(
     int min_frame_length_ms,
     int max_frame_length_ms) {
@@ -612,6 +632,8 @@ AudioEncoder::EncodedInfo AudioEncoderOpusImpl::EncodeImpl(
                Num10msFramesPerPacket() * SamplesPer10msFrame());
 
   const size_t max_encoded_bytes = SufficientOutputBufferSize();
+  const int64_t encode_start_us =
+      complexity_controller_ ? rtc::TimeMicros() : 0;
   EncodedInfo info;
   info.encoded_bytes = encoded->AppendData(
       max_encoded_bytes, [&](rtc::ArrayView<uint8_t> encoded) {
@@ -626,6 +648,14 @@ AudioEncoder::EncodedInfo AudioEncoderOpusImpl::EncodeImpl(
       });
   input_buffer_.clear();
 
+  if (complexity_controller_) {
+    complexity_controller_->UpdateEncodeTime(
+        rtc::TimeMicros() - encode_start_us,
+        config_.frame_size_ms * rtc::kNumMicrosecsPerMillisec);
+    if (complexity_controller_->MakeDecision(rtc::TimeMillis()))
+      ApplyComplexity();
+  }
+
   bool dtx_frame = (info.encoded_bytes <= 2);
 
   // Will use new packet size for next encoding.
@@ -701,7 +731,7 @@ bool AudioEncoderOpusImpl::RecreateEncoderInstance(
   // Use the default complexity if the start bitrate is within the hysteresis
   // window.
   complexity_ = GetNewComplexity(config).value_or(config.complexity);
-  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, complexity_));
+  ApplyComplexity();
   bitrate_changed_ = true;
   if (config.dtx_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableDtx(inst_));
@@ -747,6 +777,17 @@ void AudioEncoderOpusImpl::SetProjectedPacketLossRate(float fraction) {
   }
 }
 
+int AudioEncoderOpusImpl::applied_complexity() const {
+  // Lower the complexity further while the CPU is overused.
+  return complexity_controller_
+             ? std::min(complexity_, complexity_controller_->complexity())
+             : complexity_;
+}
+
+void AudioEncoderOpusImpl::ApplyComplexity() {
+  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, applied_complexity()));
+}
+
 void AudioEncoderOpusImpl::SetTargetBitrate(int bits_per_second) {
   config_.bitrate_bps = rtc::SafeClamp<int>(
       bits_per_second, AudioEncoderOpusConfig::kMinBitrateBps,
@@ -756,7 +797,7 @@ void AudioEncoderOpusImpl::SetTargetBitrate(int bits_per_second) {
   const auto new_complexity = GetNewComplexity(config_);
   if (new_complexity && complexity_ != *new_complexity) {
     complexity_ = *new_complexity;
-    RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, complexity_));
+    ApplyComplexity();
   }
   bitrate_changed_ = true;
 }
@@ -28,6 +28,7 @@
 
 namespace webrtc {
 
+class ComplexityController;
 class RtcEventLog;
 
 struct CodecInst;
@@ -101,6 +102,7 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
       absl::optional<int64_t> bwe_period_ms) override;
   void OnReceivedRtt(int rtt_ms) override;
   void OnReceivedOverhead(size_t overhead_bytes_per_packet) override;
+  void OnReceivedCpuUsage(int cpu_usage_percent) override;
   void SetReceiverFrameLengthRange(int min_frame_length_ms,
                                    int max_frame_length_ms) override;
   ANAStats GetANAStats() const override;
@@ -116,6 +118,7 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   bool fec_enabled() const { return config_.fec_enabled; }
   size_t num_channels_to_encode() const { return num_channels_to_encode_; }
   int next_frame_length_ms() const { return next_frame_length_ms_; }
+  int applied_complexity() const;
 
  protected:
   EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
@@ -140,6 +143,9 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   void SetFrameLength(int frame_length_ms);
   void SetNumChannelsToEncode(size_t num_channels_to_encode);
   void SetProjectedPacketLossRate(float fraction);
+  // Sets |applied_complexity()| on the encoder, which is |complexity_| capped
+  // by |complexity_controller_|.
+  void ApplyComplexity();
 
   // TODO(minyue): remove "override" when we can deprecate
   // |AudioEncoder::SetTargetBitrate|.
@@ -171,6 +177,8 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   const std::unique_ptr<SmoothingFilter> bitrate_smoother_;
   absl::optional<int64_t> bitrate_smoother_last_update_time_;
   int consecutive_dtx_frames_;
+  // Set if the complexity adapts to the CPU usage.
+  const std::unique_ptr<ComplexityController> complexity_controller_;
 
   friend struct AudioEncoderOpus;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioEncoderOpusImpl);
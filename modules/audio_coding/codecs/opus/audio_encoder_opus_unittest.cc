@@ -11,6 +11,7 @@
 #include <array>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "api/audio_codecs/opus/audio_encoder_opus.h"
@@ -469,6 +470,22 @@ TEST(AudioEncoderOpusTest, ConfigComplexityAdaptation) {
   EXPECT_EQ(6, AudioEncoderOpusImpl::GetNewComplexity(config));
 }
 
+TEST(AudioEncoderOpusTest, ComplexityAdaptsToCpuUsage) {
+  test::ScopedFieldTrials override_field_trials(
+      "WebRTC-Audio-OpusCpuAdaptiveComplexity/Enabled/");
+  auto states = CreateCodec(1);
+  const int initial_complexity = states->encoder->applied_complexity();
+  std::vector<int16_t> audio(states->encoder->SampleRateHz() / 100);
+  rtc::Buffer encoded;
+
+  states->encoder->OnReceivedCpuUsage(100);
+  for (int k = 0; k < 200; ++k) {
+    states->encoder->Encode(k * audio.size(), audio, &encoded);
+    states->fake_clock->AdvanceTime(TimeDelta::ms(10));
+  }
+  EXPECT_LT(states->encoder->applied_complexity(), initial_complexity);
+}
+
 // Verifies that the bandwidth adaptation in the config works as intended.
 TEST(AudioEncoderOpusTest, ConfigBandwidthAdaptation) {
   AudioEncoderOpusConfig config;
@@ -92,6 +92,10 @@ class NetEq {
     int max_delay_ms = 2000;
     bool enable_fast_accelerate = false;
     bool enable_muted_state = false;
+    // Mutes the output instead of generating comfort noise while the sender
+    // is in DTX, until the next packet arrives. The muted frames are passed to
+    // the mixer as muted, so that silent streams cost next to nothing.
+    bool enable_muted_comfort_noise = false;
     absl::optional<AudioCodecPairId> codec_pair_id;
     bool for_test_no_time_stretching = false;  // Use only for testing.
   };
@@ -127,9 +131,11 @@ class NetEq {
   // |vad_activity_| are updated upon success. If an error is returned, some
   // fields may not have been updated, or may contain inconsistent values.
   // If muted state is enabled (through Config::enable_muted_state), |muted|
-  // may be set to true after a prolonged expand period. When this happens, the
-  // |data_| in |audio_frame| is not written, but should be interpreted as being
-  // all zeros.
+  // may be set to true after a prolonged expand period. If muted comfort noise
+  // is enabled (through Config::enable_muted_comfort_noise), |muted| is set to
+  // true while comfort noise would otherwise be generated without any new
+  // packet. When this happens, the |data_| in |audio_frame| is not written,
+  // but should be interpreted as being all zeros.
   // Returns kOK on success, or kFail in case of an error.
   virtual int GetAudio(AudioFrame* audio_frame, bool* muted) = 0;
 
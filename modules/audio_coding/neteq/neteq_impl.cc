@@ -104,6 +104,7 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       enable_fast_accelerate_(config.enable_fast_accelerate),
       nack_enabled_(false),
       enable_muted_state_(config.enable_muted_state),
+      enable_muted_comfort_noise_(config.enable_muted_comfort_noise),
       expand_uma_logger_("WebRTC.Audio.ExpandRatePercent",
                          10,  // Report once every 10 s.
                          tick_timer_.get()),
@@ -831,12 +832,25 @@ int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame, bool* muted) {
   speech_expand_uma_logger_.UpdateSampleCounter(
       lifetime_stats.voice_concealed_samples, fs_hz_);
 
-  // Check for muted state.
-  if (enable_muted_state_ && expand_->Muted() && packet_buffer_->Empty()) {
-    RTC_DCHECK_EQ(last_mode_, kModeExpand);
+  // Check for muted state. While comfort noise is played out, the muted state
+  // lasts until a new packet arrives.
+  const bool muted_expand =
+      enable_muted_state_ && expand_->Muted() && packet_buffer_->Empty();
+  const bool muted_comfort_noise =
+      enable_muted_comfort_noise_ &&
+      (last_mode_ == kModeRfc3389Cng || last_mode_ == kModeCodecInternalCng) &&
+      packet_buffer_->Empty() && dtmf_buffer_->Empty();
+  if (muted_expand || muted_comfort_noise) {
+    RTC_DCHECK(muted_comfort_noise || last_mode_ == kModeExpand);
     audio_frame->Reset();
     RTC_DCHECK(audio_frame->muted());  // Reset() should mute the frame.
-    playout_timestamp_ += static_cast<uint32_t>(output_size_samples_);
+    if (muted_expand) {
+      // Use dead reckoning to estimate the |playout_timestamp_|, like when
+      // expanding. During comfort noise, it stays at the end of the last
+      // decoded packet.
+      playout_timestamp_ += static_cast<uint32_t>(output_size_samples_);
+      stats_.ExpandedNoiseSamples(output_size_samples_, false);
+    }
     audio_frame->sample_rate_hz_ = fs_hz_;
     audio_frame->samples_per_channel_ = output_size_samples_;
     audio_frame->timestamp_ =
@@ -845,7 +859,6 @@ int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame, bool* muted) {
             : timestamp_scaler_->ToExternal(playout_timestamp_) -
                   static_cast<uint32_t>(audio_frame->samples_per_channel_);
     audio_frame->num_channels_ = sync_buffer_->Channels();
-    stats_.ExpandedNoiseSamples(output_size_samples_, false);
     *muted = true;
     return 0;
   }
@@ -416,6 +416,7 @@ class NetEqImpl : public webrtc::NetEq {
   std::unique_ptr<NackTracker> nack_ RTC_GUARDED_BY(crit_sect_);
   bool nack_enabled_ RTC_GUARDED_BY(crit_sect_);
   const bool enable_muted_state_ RTC_GUARDED_BY(crit_sect_);
+  const bool enable_muted_comfort_noise_ RTC_GUARDED_BY(crit_sect_);
   AudioFrame::VADActivity last_vad_activity_ RTC_GUARDED_BY(crit_sect_) =
       AudioFrame::kVadPassive;
   std::unique_ptr<TickTimer::Stopwatch> generated_noise_stopwatch_
@@ -1451,6 +1451,38 @@ TEST_F(NetEqDecodingTestWithMutedState, RecoverAfterExtendedCngWithoutPackets) {
   GetAudioUntilNormal();
 }
 
+class NetEqDecodingTestWithMutedComfortNoise
+    : public NetEqDecodingTestWithMutedState {
+ public:
+  NetEqDecodingTestWithMutedComfortNoise() {
+    config_.enable_muted_comfort_noise = true;
+  }
+};
+
+// Verifies that NetEq mutes the comfort noise until the next packet arrives.
+TEST_F(NetEqDecodingTestWithMutedComfortNoise, MuteCngWithoutPackets) {
+  // Insert one CNG packet. Pull out audio once and expect it not to be muted,
+  // since the CNG packet is decoded.
+  InsertCngPacket(0);
+  EXPECT_FALSE(GetAudioReturnMuted());
+  EXPECT_EQ(AudioFrame::kCNG, out_frame_.speech_type_);
+
+  // Pull 1 second of audio (10 ms audio generated per lap).
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(GetAudioReturnMuted());
+    EXPECT_TRUE(out_frame_.muted());
+    EXPECT_EQ(AudioFrame::kCNG, out_frame_.speech_type_);
+    EXPECT_EQ(kSamples, out_frame_.samples_per_channel_);
+    ++counter_;
+  }
+
+  // Insert new data. Timestamp is corrected for the time elapsed since the last
+  // packet. Verify that normal operation resumes.
+  InsertPacket(kSamples * counter_);
+  GetAudioUntilNormal();
+  EXPECT_FALSE(out_frame_.muted());
+}
+
 class NetEqDecodingTestTwoInstances : public NetEqDecodingTest {
  public:
   NetEqDecodingTestTwoInstances() : NetEqDecodingTest() {}
@@ -10,11 +10,14 @@
 
 // This is the implementation of the PacketBuffer class. It is mostly based on
 // an STL list. The list is kept sorted at all times so that the next packet to
-// decode is at the beginning of the list.
+// decode is at the beginning of the list. The list nodes of packets that leave
+// the buffer are kept in a list of free slots and reused for new packets, so
+// that inserting a packet does not allocate once the buffer has warmed up.
 
 #include "modules/audio_coding/neteq/packet_buffer.h"
 
 #include <algorithm>  // find_if()
+#include <iterator>
 
 #include "api/audio_codecs/audio_decoder.h"
 #include "modules/audio_coding/neteq/decoder_database.h"
@@ -68,7 +71,10 @@ PacketBuffer::~PacketBuffer() {
 
 // Flush the buffer. All packets in the buffer will be destroyed.
 void PacketBuffer::Flush() {
-  buffer_.clear();
+  for (Packet& packet : buffer_) {
+    packet = Packet();
+  }
+  free_slots_.splice(free_slots_.end(), buffer_);
 }
 
 bool PacketBuffer::Empty() const {
@@ -115,9 +121,15 @@ int PacketBuffer::InsertPacket(Packet&& packet, StatisticsCalculator* stats) {
   PacketList::iterator it = rit.base();
   if (it != buffer_.end() && packet.timestamp == it->timestamp) {
     LogPacketDiscarded(it->priority.codec_level, stats);
-    it = buffer_.erase(it);
+    it = ReleaseSlot(it);
+  }
+  // Insert the packet at that position, in a free slot if there is one.
+  if (free_slots_.empty()) {
+    buffer_.insert(it, std::move(packet));
+  } else {
+    free_slots_.front() = std::move(packet);
+    buffer_.splice(it, free_slots_, free_slots_.begin());
   }
-  buffer_.insert(it, std::move(packet));  // Insert the packet at that position.
 
   return return_val;
 }
@@ -211,7 +223,7 @@ absl::optional<Packet> PacketBuffer::GetNextPacket() {
   absl::optional<Packet> packet(std::move(buffer_.front()));
   // Assert that the packet sanity checks in InsertPacket method works.
   RTC_DCHECK(!packet->empty());
-  buffer_.pop_front();
+  ReleaseSlot(buffer_.begin());
 
   return packet;
 }
@@ -224,21 +236,20 @@ int PacketBuffer::DiscardNextPacket(StatisticsCalculator* stats) {
   const Packet& packet = buffer_.front();
   RTC_DCHECK(!packet.empty());
   LogPacketDiscarded(packet.priority.codec_level, stats);
-  buffer_.pop_front();
+  ReleaseSlot(buffer_.begin());
   return kOK;
 }
 
 void PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit,
                                      uint32_t horizon_samples,
                                      StatisticsCalculator* stats) {
-  buffer_.remove_if([timestamp_limit, horizon_samples, stats](const Packet& p) {
-    if (timestamp_limit == p.timestamp ||
-        !IsObsoleteTimestamp(p.timestamp, timestamp_limit, horizon_samples)) {
-      return false;
-    }
-    LogPacketDiscarded(p.priority.codec_level, stats);
-    return true;
-  });
+  DiscardPacketsIf(
+      [timestamp_limit, horizon_samples](const Packet& p) {
+        return timestamp_limit != p.timestamp &&
+               IsObsoleteTimestamp(p.timestamp, timestamp_limit,
+                                   horizon_samples);
+      },
+      stats);
 }
 
 void PacketBuffer::DiscardAllOldPackets(uint32_t timestamp_limit,
@@ -248,13 +259,11 @@ void PacketBuffer::DiscardAllOldPackets(uint32_t timestamp_limit,
 
 void PacketBuffer::DiscardPacketsWithPayloadType(uint8_t payload_type,
                                                  StatisticsCalculator* stats) {
-  buffer_.remove_if([payload_type, stats](const Packet& p) {
-    if (p.payload_type != payload_type) {
-      return false;
-    }
-    LogPacketDiscarded(p.priority.codec_level, stats);
-    return true;
-  });
+  DiscardPacketsIf(
+      [payload_type](const Packet& p) {
+        return p.payload_type == payload_type;
+      },
+      stats);
 }
 
 size_t PacketBuffer::NumPacketsInBuffer() const {
@@ -293,6 +302,27 @@ bool PacketBuffer::ContainsDtxOrCngPacket(
   return false;
 }
 
+PacketList::iterator PacketBuffer::ReleaseSlot(PacketList::iterator it) {
+  const PacketList::iterator next = std::next(it);
+  // Release the payload and the frame now rather than when the slot is reused.
+  *it = Packet();
+  free_slots_.splice(free_slots_.end(), buffer_, it);
+  return next;
+}
+
+void PacketBuffer::DiscardPacketsIf(
+    rtc::FunctionView<bool(const Packet&)> predicate,
+    StatisticsCalculator* stats) {
+  for (auto it = buffer_.begin(); it != buffer_.end();) {
+    if (predicate(*it)) {
+      LogPacketDiscarded(it->priority.codec_level, stats);
+      it = ReleaseSlot(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void PacketBuffer::BufferStat(int* num_packets, int* max_num_packets) const {
   *num_packets = static_cast<int>(buffer_.size());
   *max_num_packets = static_cast<int>(max_number_of_packets_);
@@ -16,6 +16,7 @@
 #include "modules/audio_coding/neteq/packet.h"
 #include "modules/include/module_common_types.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/function_view.h"
 
 namespace webrtc {
 
@@ -142,8 +143,19 @@ class PacketBuffer {
   }
 
  private:
+  // Moves the slot of the packet at |it| to |free_slots_|, and returns an
+  // iterator to the next packet.
+  PacketList::iterator ReleaseSlot(PacketList::iterator it);
+
+  // Discards all packets for which |predicate| returns true.
+  void DiscardPacketsIf(rtc::FunctionView<bool(const Packet&)> predicate,
+                        StatisticsCalculator* stats);
+
   size_t max_number_of_packets_;
   PacketList buffer_;
+  // Empty packets, whose list nodes are reused for new packets. Never holds
+  // more slots than the largest number of packets that has been buffered.
+  PacketList free_slots_;
   const TickTimer* tick_timer_;
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
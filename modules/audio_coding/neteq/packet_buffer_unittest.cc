@@ -128,6 +128,37 @@ TEST(PacketBuffer, FlushBuffer) {
   EXPECT_TRUE(buffer.Empty());
 }
 
+// Test that packets inserted in the slots of packets that left the buffer keep
+// their own contents and order.
+TEST(PacketBuffer, ReusesSlotsOfRemovedPackets) {
+  TickTimer tick_timer;
+  PacketBuffer buffer(10, &tick_timer);  // 10 packets.
+  PacketGenerator gen(0, 0, 0, 10);
+  MockStatisticsCalculator mock_stats;
+
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_EQ(PacketBuffer::kOK,
+                buffer.InsertPacket(gen.NextPacket(10 * (i + 1)), &mock_stats));
+    }
+    const uint16_t first_seq_no = static_cast<uint16_t>(gen.seq_no_ - 5);
+    for (int i = 0; i < 2; ++i) {
+      absl::optional<Packet> packet = buffer.GetNextPacket();
+      ASSERT_TRUE(packet);
+      EXPECT_EQ(first_seq_no + i, packet->sequence_number);
+      EXPECT_EQ(10u * (i + 1), packet->payload.size());
+    }
+    EXPECT_EQ(PacketBuffer::kOK, buffer.DiscardNextPacket(&mock_stats));
+    const Packet* next_packet = buffer.PeekNextPacket();
+    ASSERT_TRUE(next_packet);
+    EXPECT_EQ(first_seq_no + 3, next_packet->sequence_number);
+    EXPECT_EQ(40u, next_packet->payload.size());
+    EXPECT_EQ(2u, buffer.NumPacketsInBuffer());
+    buffer.Flush();
+    EXPECT_TRUE(buffer.Empty());
+  }
+}
+
 // Test to fill the buffer over the limits, and verify that it flushes.
 TEST(PacketBuffer, OverfillBuffer) {
   TickTimer tick_timer;
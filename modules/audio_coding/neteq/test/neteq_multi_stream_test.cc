@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <iostream>
+#include <string>
+
+#include "modules/audio_coding/neteq/tools/neteq_multi_stream_benchmark.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/flags.h"
+#include "test/testsupport/fileutils.h"
+#include "test/testsupport/perf_test.h"
+
+// Define command line flags.
+DEFINE_int(num_streams, 10, "Number of NetEq instances.");
+DEFINE_int(runtime_ms, 60000, "Simulated runtime in ms.");
+DEFINE_int(warmup_ms, 2000, "Simulated time not measured, in ms.");
+DEFINE_string(codec, "pcm16b", "Codec, pcm16b or opus.");
+DEFINE_float(max_drift_percent,
+             0.5f,
+             "Sender clocks drift by up to this much, in percent.");
+DEFINE_int(base_delay_ms, 50, "Network delay, in ms.");
+DEFINE_int(jitter_ms, 10, "Standard deviation of the delay variation, in ms.");
+DEFINE_float(spike_probability, 0.002f, "Chance of a delay spike per packet.");
+DEFINE_int(spike_ms, 300, "Length of a delay spike, in ms.");
+DEFINE_float(loss_percent, 1.0f, "Random packet loss, in percent.");
+DEFINE_int(seed, 1, "Seed of the network simulation.");
+DEFINE_string(isolated_script_test_perf_output,
+              "",
+              "Path where the perf results should be stored in the JSON "
+              "format of test/testsupport/perf_test.h.");
+DEFINE_bool(help, false, "Print this message.");
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Tool for measuring the throughput of many NetEq instances, each "
+      "receiving from a sender with a drifting clock over a jittery "
+      "network.\n"
+      "Usage: " +
+      program_name + " [options]\n";
+  webrtc::test::SetExecutablePath(argv[0]);
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) || FLAG_help ||
+      argc != 1) {
+    printf("%s", usage.c_str());
+    if (FLAG_help) {
+      rtc::FlagList::Print(nullptr, false);
+      return 0;
+    }
+    return 1;
+  }
+  RTC_CHECK_GT(FLAG_num_streams, 0);
+  RTC_CHECK_GT(FLAG_runtime_ms, FLAG_warmup_ms);
+  RTC_CHECK_GE(FLAG_warmup_ms, 0);
+
+  webrtc::test::NetEqMultiStreamBenchmark::Config config;
+  config.num_streams = FLAG_num_streams;
+  config.runtime_ms = FLAG_runtime_ms;
+  config.warmup_ms = FLAG_warmup_ms;
+  config.codec = FLAG_codec;
+  config.max_drift_percent = FLAG_max_drift_percent;
+  config.base_delay_ms = FLAG_base_delay_ms;
+  config.jitter_ms = FLAG_jitter_ms;
+  config.spike_probability = FLAG_spike_probability;
+  config.spike_ms = FLAG_spike_ms;
+  config.loss_percent = FLAG_loss_percent;
+  config.seed = FLAG_seed;
+
+  webrtc::test::NetEqMultiStreamBenchmark::Results results;
+  if (!webrtc::test::NetEqMultiStreamBenchmark::Run(config, &results)) {
+    std::cout << "There was an error" << std::endl;
+    return -1;
+  }
+  webrtc::test::NetEqMultiStreamBenchmark::PrintResults(config, results);
+
+  std::string chartjson_result_file = FLAG_isolated_script_test_perf_output;
+  if (!chartjson_result_file.empty()) {
+    webrtc::test::WritePerfResults(chartjson_result_file);
+  }
+  return 0;
+}
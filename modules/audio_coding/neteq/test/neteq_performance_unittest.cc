@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include "modules/audio_coding/neteq/tools/neteq_multi_stream_benchmark.h"
 #include "modules/audio_coding/neteq/tools/neteq_performance_test.h"
 #include "system_wrappers/include/field_trial.h"
 #include "test/gtest.h"
@@ -47,3 +48,23 @@ TEST(NetEqPerformanceTest, RunClean) {
   webrtc::test::PrintResult("neteq_performance", "", "0_pl_0_drift", runtime,
                             "ms", true);
 }
+
+// Runs many streams at once, with clock drift, jitter, delay spikes and
+// losses, and reports the decode time per stream.
+TEST(NetEqPerformanceTest, RunMultiStream) {
+  webrtc::test::NetEqMultiStreamBenchmark::Config config;
+  config.num_streams = 20;
+  config.runtime_ms =
+      webrtc::field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 10000 : 120000;
+  webrtc::test::NetEqMultiStreamBenchmark::Results results;
+  ASSERT_TRUE(webrtc::test::NetEqMultiStreamBenchmark::Run(config, &results));
+  EXPECT_EQ(
+      results.num_get_audio_calls,
+      results.normal_count + results.expand_count + results.accelerate_count +
+          results.preemptive_expand_count + results.merge_count +
+          results.other_count);
+  // The drifting clocks and the delay spikes make NetEq time-stretch.
+  EXPECT_GT(results.accelerate_count + results.preemptive_expand_count, 0);
+  EXPECT_GT(results.expand_count, 0);
+  webrtc::test::NetEqMultiStreamBenchmark::PrintResults(config, results);
+}
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/tools/neteq_batch_decoder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "api/audio/audio_frame.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "rtc_base/atomicops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+constexpr int kOutputFrameMs = 10;
+
+NetEq::Config CreateNetEqConfig(const NetEqBatchDecoder::Config& config,
+                                int sample_rate_hz) {
+  NetEq::Config neteq_config;
+  neteq_config.sample_rate_hz = sample_rate_hz;
+  neteq_config.for_test_no_time_stretching = true;
+  // Leave room for the lookahead even with the shortest packets.
+  neteq_config.max_packets_in_buffer = std::max(
+      neteq_config.max_packets_in_buffer,
+      static_cast<size_t>(2 * config.lookahead_ms / kOutputFrameMs));
+  neteq_config.max_delay_ms =
+      std::max(neteq_config.max_delay_ms, 2 * config.lookahead_ms);
+  return neteq_config;
+}
+
+struct ParallelRun {
+  const std::vector<NetEqBatchDecoder*>* decoders;
+  std::vector<int64_t>* durations_ms;
+  volatile int next_decoder = 0;
+};
+
+void RunDecoders(void* obj) {
+  ParallelRun* run = static_cast<ParallelRun*>(obj);
+  while (true) {
+    const size_t k = rtc::AtomicOps::Increment(&run->next_decoder) - 1;
+    if (k >= run->decoders->size()) {
+      return;
+    }
+    (*run->durations_ms)[k] = (*run->decoders)[k]->Run();
+  }
+}
+
+}  // namespace
+
+NetEqBatchDecoder::NetEqBatchDecoder(const Config& config,
+                                     int sample_rate_hz,
+                                     const NetEqTest::DecoderMap& codecs,
+                                     std::unique_ptr<NetEqInput> input,
+                                     std::unique_ptr<AudioSink> output)
+    : config_(config),
+      neteq_(NetEq::Create(CreateNetEqConfig(config, sample_rate_hz),
+                           CreateBuiltinAudioDecoderFactory())),
+      input_(std::move(input)),
+      output_(std::move(output)) {
+  RTC_DCHECK_GT(config_.lookahead_ms, 0);
+  RTC_DCHECK_GE(config_.output_block_ms, kOutputFrameMs);
+  for (const auto& c : codecs) {
+    RTC_CHECK_EQ(
+        neteq_->RegisterPayloadType(c.second.first, c.second.second, c.first),
+        NetEq::kOK)
+        << "Cannot register " << c.second.second << " to payload type "
+        << c.first;
+  }
+}
+
+NetEqBatchDecoder::~NetEqBatchDecoder() = default;
+
+int64_t NetEqBatchDecoder::Run() {
+  int64_t duration_ms = 0;
+  AudioFrame frame;
+  while (true) {
+    while (input_->NextPacketTime() &&
+           neteq_->CurrentDelayMs() < config_.lookahead_ms) {
+      InsertNextPacket();
+    }
+    // Stop when all the packets have been played out.
+    if (!input_->NextPacketTime() && neteq_->CurrentDelayMs() == 0) {
+      break;
+    }
+    bool muted;
+    if (neteq_->GetAudio(&frame, &muted) != NetEq::kOK) {
+      break;
+    }
+    const int16_t* data = frame.data();
+    block_.insert(block_.end(), data,
+                  data + frame.samples_per_channel_ * frame.num_channels_);
+    block_duration_ms_ += kOutputFrameMs;
+    duration_ms += kOutputFrameMs;
+    if (block_duration_ms_ >= config_.output_block_ms) {
+      WriteBlock();
+    }
+  }
+  WriteBlock();
+  return duration_ms;
+}
+
+std::vector<int64_t> NetEqBatchDecoder::RunInParallel(
+    const std::vector<NetEqBatchDecoder*>& decoders,
+    size_t num_threads) {
+  RTC_DCHECK_GT(num_threads, 0);
+  std::vector<int64_t> durations_ms(decoders.size());
+  ParallelRun run;
+  run.decoders = &decoders;
+  run.durations_ms = &durations_ms;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t k = 0; k < std::min(num_threads, decoders.size()); ++k) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&RunDecoders, &run, "NetEqBatchDecoder"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+  return durations_ms;
+}
+
+void NetEqBatchDecoder::InsertNextPacket() {
+  std::unique_ptr<NetEqInput::PacketData> packet_data = input_->PopPacket();
+  RTC_CHECK(packet_data);
+  // Packets that cannot be inserted, e.g. because of an unknown payload type,
+  // are concealed like lost ones.
+  neteq_->InsertPacket(
+      packet_data->header, packet_data->payload,
+      static_cast<uint32_t>(packet_data->time_ms *
+                            neteq_->last_output_sample_rate_hz() / 1000));
+}
+
+void NetEqBatchDecoder::WriteBlock() {
+  if (output_ && !block_.empty()) {
+    RTC_CHECK(output_->WriteArray(block_.data(), block_.size()));
+  }
+  block_.clear();
+  block_duration_ms_ = 0;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_BATCH_DECODER_H_
+#define MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_BATCH_DECODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "modules/audio_coding/neteq/include/neteq.h"
+#include "modules/audio_coding/neteq/tools/audio_sink.h"
+#include "modules/audio_coding/neteq/tools/neteq_input.h"
+#include "modules/audio_coding/neteq/tools/neteq_test.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+namespace test {
+
+// Decodes recorded packets as fast as possible, e.g. to transcode recordings,
+// instead of simulating the real-time playout that NetEqTest reproduces. The
+// arrival times of the packets are ignored: enough packets are inserted ahead
+// of the playout for reordered packets to be decoded in order, and NetEq does
+// not time-stretch the audio. Lost packets are still concealed. The output is
+// written in large blocks.
+class NetEqBatchDecoder {
+ public:
+  struct Config {
+    // Duration of the audio inserted ahead of the playout.
+    int lookahead_ms = 200;
+    // Duration of the audio written to the output at a time.
+    int output_block_ms = 1000;
+  };
+
+  NetEqBatchDecoder(const Config& config,
+                    int sample_rate_hz,
+                    const NetEqTest::DecoderMap& codecs,
+                    std::unique_ptr<NetEqInput> input,
+                    std::unique_ptr<AudioSink> output);
+  ~NetEqBatchDecoder();
+
+  // Decodes all the packets of the input. Returns the duration of the decoded
+  // audio in ms.
+  int64_t Run();
+
+  // Runs several decoders, e.g. one per recording, on up to |num_threads|
+  // threads. Returns the duration of the audio decoded by each.
+  static std::vector<int64_t> RunInParallel(
+      const std::vector<NetEqBatchDecoder*>& decoders,
+      size_t num_threads);
+
+ private:
+  void InsertNextPacket();
+  void WriteBlock();
+
+  const Config config_;
+  std::unique_ptr<NetEq> neteq_;
+  std::unique_ptr<NetEqInput> input_;
+  std::unique_ptr<AudioSink> output_;
+  std::vector<int16_t> block_;
+  int block_duration_ms_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetEqBatchDecoder);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_BATCH_DECODER_H_
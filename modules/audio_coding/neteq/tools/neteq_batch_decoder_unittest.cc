@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/tools/neteq_batch_decoder.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+constexpr int kSampleRateHz = 16000;
+constexpr int kPayloadType = 94;
+constexpr int kPacketDurationMs = 20;
+constexpr int kSamplesPerPacket = kSampleRateHz * kPacketDurationMs / 1000;
+constexpr int kNumPackets = 50;
+constexpr int64_t kInputDurationMs = kNumPackets * kPacketDurationMs;
+
+// Provides PCM16B packets of a ramp, with the packets at the given indices
+// swapped with the next ones.
+class RampPacketInput : public NetEqInput {
+ public:
+  explicit RampPacketInput(const std::vector<int>& swapped_packets) {
+    for (int k = 0; k < kNumPackets; ++k) {
+      std::unique_ptr<PacketData> packet = absl::make_unique<PacketData>();
+      packet->header.payloadType = kPayloadType;
+      packet->header.sequenceNumber = k;
+      packet->header.timestamp = k * kSamplesPerPacket;
+      packet->header.ssrc = 0x1234;
+      packet->time_ms = k * kPacketDurationMs;
+      for (int n = 0; n < kSamplesPerPacket; ++n) {
+        const uint16_t sample = k * kSamplesPerPacket + n;
+        packet->payload.AppendData(static_cast<uint8_t>(sample >> 8));
+        packet->payload.AppendData(static_cast<uint8_t>(sample & 0xFF));
+      }
+      packets_.push_back(std::move(packet));
+    }
+    for (int k : swapped_packets) {
+      std::swap(packets_[k], packets_[k + 1]);
+    }
+  }
+
+  absl::optional<int64_t> NextPacketTime() const override {
+    if (next_packet_ == packets_.size())
+      return absl::nullopt;
+    return static_cast<int64_t>(packets_[next_packet_]->time_ms);
+  }
+  absl::optional<int64_t> NextOutputEventTime() const override {
+    return absl::nullopt;
+  }
+  std::unique_ptr<PacketData> PopPacket() override {
+    return std::move(packets_[next_packet_++]);
+  }
+  void AdvanceOutputEvent() override {}
+  bool ended() const override { return next_packet_ == packets_.size(); }
+  absl::optional<RTPHeader> NextHeader() const override {
+    return packets_[next_packet_]->header;
+  }
+
+ private:
+  std::vector<std::unique_ptr<PacketData>> packets_;
+  size_t next_packet_ = 0;
+};
+
+class RecordingSink : public AudioSink {
+ public:
+  RecordingSink(std::vector<int16_t>* samples, int* num_writes)
+      : samples_(samples), num_writes_(num_writes) {}
+
+  bool WriteArray(const int16_t* audio, size_t num_samples) override {
+    samples_->insert(samples_->end(), audio, audio + num_samples);
+    ++*num_writes_;
+    return true;
+  }
+
+ private:
+  std::vector<int16_t>* const samples_;
+  int* const num_writes_;
+};
+
+std::unique_ptr<NetEqBatchDecoder> CreateDecoder(
+    const NetEqBatchDecoder::Config& config,
+    const std::vector<int>& swapped_packets,
+    std::vector<int16_t>* samples,
+    int* num_writes) {
+  NetEqTest::DecoderMap codecs = {
+      {kPayloadType,
+       std::make_pair(NetEqDecoder::kDecoderPCM16Bwb, "pcm16-wb")}};
+  return absl::make_unique<NetEqBatchDecoder>(
+      config, kSampleRateHz, codecs,
+      absl::make_unique<RampPacketInput>(swapped_packets),
+      absl::make_unique<RecordingSink>(samples, num_writes));
+}
+
+// The output is the input ramp, delayed by less than a millisecond by NetEq.
+void ExpectRamp(const std::vector<int16_t>& samples) {
+  ASSERT_EQ(static_cast<size_t>(kInputDurationMs * kSampleRateHz / 1000),
+            samples.size());
+  size_t delay = 0;
+  while (delay + 1 < samples.size() && samples[delay + 1] == 0) {
+    ++delay;
+  }
+  ASSERT_LT(delay, static_cast<size_t>(kSampleRateHz / 1000));
+  for (size_t k = delay; k < samples.size(); ++k) {
+    ASSERT_EQ(static_cast<int16_t>(k - delay), samples[k]) << "sample " << k;
+  }
+}
+
+}  // namespace
+
+TEST(NetEqBatchDecoderTest, DecodesAllAudioInBlocks) {
+  NetEqBatchDecoder::Config config;
+  config.output_block_ms = 300;
+  std::vector<int16_t> samples;
+  int num_writes = 0;
+  std::unique_ptr<NetEqBatchDecoder> decoder =
+      CreateDecoder(config, {}, &samples, &num_writes);
+
+  EXPECT_EQ(kInputDurationMs, decoder->Run());
+  // The audio is decoded as is, without time-stretching or concealment.
+  ExpectRamp(samples);
+  // Three full blocks and the remaining 100 ms.
+  EXPECT_EQ(4, num_writes);
+}
+
+TEST(NetEqBatchDecoderTest, DecodesReorderedPacketsInOrder) {
+  NetEqBatchDecoder::Config config;
+  std::vector<int16_t> samples;
+  int num_writes = 0;
+  std::unique_ptr<NetEqBatchDecoder> decoder =
+      CreateDecoder(config, {3, 20, 40}, &samples, &num_writes);
+
+  EXPECT_EQ(kInputDurationMs, decoder->Run());
+  ExpectRamp(samples);
+}
+
+TEST(NetEqBatchDecoderTest, RunsDecodersInParallel) {
+  constexpr size_t kNumDecoders = 5;
+  NetEqBatchDecoder::Config config;
+  std::vector<std::vector<int16_t>> samples(kNumDecoders);
+  std::vector<int> num_writes(kNumDecoders);
+  std::vector<std::unique_ptr<NetEqBatchDecoder>> decoders;
+  std::vector<NetEqBatchDecoder*> decoder_ptrs;
+  for (size_t k = 0; k < kNumDecoders; ++k) {
+    decoders.push_back(
+        CreateDecoder(config, {}, &samples[k], &num_writes[k]));
+    decoder_ptrs.push_back(decoders.back().get());
+  }
+
+  const std::vector<int64_t> durations_ms =
+      NetEqBatchDecoder::RunInParallel(decoder_ptrs, 2);
+  ASSERT_EQ(kNumDecoders, durations_ms.size());
+  for (size_t k = 0; k < kNumDecoders; ++k) {
+    EXPECT_EQ(kInputDurationMs, durations_ms[k]);
+    ExpectRamp(samples[k]);
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
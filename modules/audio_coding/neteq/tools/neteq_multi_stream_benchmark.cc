@@ -0,0 +1,365 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/tools/neteq_multi_stream_benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "api/audio/audio_frame.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/audio_codecs/builtin_audio_encoder_factory.h"
+#include "common_types.h"  // NOLINT(build/include)
+#include "modules/audio_coding/neteq/defines.h"
+#include "modules/audio_coding/neteq/neteq_impl.h"
+#include "modules/audio_coding/neteq/tools/audio_loop.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/memory_usage.h"
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/clock.h"
+#include "test/drifting_clock.h"
+#include "test/testsupport/fileutils.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const int kOutputBlockMs = 10;
+const int kPacketMs = 20;
+// Length of the encoded clip the streams loop over.
+const int kClipMs = 10000;
+
+struct EncodedClip {
+  int sample_rate_hz;
+  int payload_type;
+  SdpAudioFormat format = SdpAudioFormat("", 0, 0);
+  std::vector<rtc::Buffer> packets;
+};
+
+// Encodes the clip once, so that encoding doesn't count, and every stream
+// sends the same packets from a different starting point.
+bool EncodeClip(const std::string& codec, EncodedClip* clip) {
+  std::string file_name;
+  if (codec == "opus") {
+    file_name = ResourcePath("audio_coding/speech_mono_32_48kHz", "pcm");
+    clip->sample_rate_hz = 48000;
+    clip->payload_type = 111;
+    clip->format = SdpAudioFormat("opus", 48000, 2, {{"stereo", "0"}});
+  } else {
+    RTC_CHECK_EQ("pcm16b", codec);
+    file_name = ResourcePath("audio_coding/testfile32kHz", "pcm");
+    clip->sample_rate_hz = 32000;
+    clip->payload_type = 95;
+    clip->format = SdpAudioFormat("L16", 32000, 1, {{"ptime", "20"}});
+  }
+
+  const size_t block_samples = clip->sample_rate_hz * kOutputBlockMs / 1000;
+  AudioLoop audio_loop;
+  if (!audio_loop.Init(file_name, clip->sample_rate_hz * kClipMs / 1000,
+                       block_samples)) {
+    return false;
+  }
+  std::unique_ptr<AudioEncoder> encoder =
+      CreateBuiltinAudioEncoderFactory()->MakeAudioEncoder(
+          clip->payload_type, clip->format, absl::nullopt);
+  RTC_CHECK(encoder);
+  RTC_CHECK_EQ(kPacketMs / kOutputBlockMs,
+               encoder->Num10MsFramesInNextPacket());
+  uint32_t rtp_timestamp = 0;
+  for (int i = 0; i < kClipMs / kOutputBlockMs; ++i) {
+    rtc::Buffer encoded;
+    encoder->Encode(rtp_timestamp, audio_loop.GetNextBlock(), &encoded);
+    rtp_timestamp += block_samples;
+    if (encoded.size() > 0)
+      clip->packets.push_back(std::move(encoded));
+  }
+  return !clip->packets.empty();
+}
+
+// A sender with its own, drifting clock, the network between it and the
+// receiver, and the receiving NetEq.
+class Stream {
+ public:
+  Stream(const NetEqMultiStreamBenchmark::Config& config,
+         int index,
+         float clock_speed,
+         const EncodedClip* clip,
+         Clock* receiver_clock,
+         const rtc::scoped_refptr<AudioDecoderFactory>& decoder_factory)
+      : config_(config),
+        clip_(clip),
+        receiver_clock_(receiver_clock),
+        sender_clock_(receiver_clock, clock_speed),
+        random_(config.seed * 1000 + index + 1),
+        clip_index_((index * 37) % clip->packets.size()) {
+    NetEq::Config neteq_config;
+    neteq_config.sample_rate_hz = clip->sample_rate_hz;
+    neteq_ = absl::make_unique<NetEqImpl>(
+        neteq_config, NetEqImpl::Dependencies(neteq_config, decoder_factory));
+    RTC_CHECK(neteq_->RegisterPayloadType(clip->payload_type, clip->format));
+    header_.payloadType = clip->payload_type;
+    header_.ssrc = 1000 + index;
+    header_.sequenceNumber = random_.Rand<uint16_t>();
+    header_.timestamp = random_.Rand<uint32_t>();
+    next_send_time_us_ = sender_clock_.TimeInMicroseconds();
+  }
+
+  // Sends the packets due at the sender and inserts those that have arrived.
+  // Called every millisecond.
+  void Process() {
+    while (sender_clock_.TimeInMicroseconds() >= next_send_time_us_) {
+      SendPacket();
+      next_send_time_us_ += kPacketMs * 1000;
+    }
+    const int64_t now_us = receiver_clock_->TimeInMicroseconds();
+    while (!in_flight_.empty() &&
+           in_flight_.front().arrival_time_us <= now_us) {
+      const InFlightPacket& packet = in_flight_.front();
+      const uint32_t receive_timestamp = static_cast<uint32_t>(
+          now_us * clip_->sample_rate_hz / rtc::kNumMicrosecsPerSec);
+      const int64_t start_ns = rtc::TimeNanos();
+      RTC_CHECK_EQ(NetEq::kOK,
+                   neteq_->InsertPacket(packet.header,
+                                        clip_->packets[packet.clip_index],
+                                        receive_timestamp));
+      decode_time_ns_ += rtc::TimeNanos() - start_ns;
+      in_flight_.pop_front();
+    }
+  }
+
+  // Pulls 10 ms of audio. Returns the decode time since the last call, in ns.
+  int64_t GetAudio(Operations* operation) {
+    bool muted;
+    const int64_t start_ns = rtc::TimeNanos();
+    RTC_CHECK_EQ(NetEq::kOK, neteq_->GetAudio(&frame_, &muted));
+    const int64_t decode_time_ns =
+        decode_time_ns_ + rtc::TimeNanos() - start_ns;
+    decode_time_ns_ = 0;
+    *operation = neteq_->last_operation_for_test();
+    return decode_time_ns;
+  }
+
+  // The net rate at which NetEq has sped up the audio since the last call,
+  // negative if it has slowed it down. The rates are in Q14.
+  double TimeStretchPpm() {
+    NetEqNetworkStatistics stats;
+    neteq_->NetworkStatistics(&stats);
+    return (static_cast<double>(stats.accelerate_rate) -
+            stats.preemptive_rate) /
+           (1 << 14) * 1e6;
+  }
+
+ private:
+  struct InFlightPacket {
+    int64_t arrival_time_us;
+    RTPHeader header;
+    size_t clip_index;
+  };
+
+  void SendPacket() {
+    const size_t clip_index = clip_index_;
+    clip_index_ = (clip_index_ + 1) % clip_->packets.size();
+    RTPHeader header = header_;
+    ++header_.sequenceNumber;
+    header_.timestamp += clip_->sample_rate_hz * kPacketMs / 1000;
+
+    if (random_.Rand<float>() * 100 < config_.loss_percent)
+      return;
+
+    if (random_.Rand<float>() < config_.spike_probability)
+      spike_remaining_ms_ = config_.spike_ms;
+    const double jitter_ms =
+        std::fabs(random_.Gaussian(0, config_.jitter_ms));
+    const int64_t delay_us = static_cast<int64_t>(
+        1000 * (config_.base_delay_ms + jitter_ms + spike_remaining_ms_));
+    spike_remaining_ms_ = std::max(0, spike_remaining_ms_ - kPacketMs);
+
+    // The send time is when the sender clock says so, in receiver time.
+    const int64_t send_time_us = receiver_clock_->TimeInMicroseconds();
+    // A network path doesn't reorder packets.
+    const int64_t arrival_time_us =
+        std::max(send_time_us + delay_us, last_arrival_time_us_);
+    last_arrival_time_us_ = arrival_time_us;
+    in_flight_.push_back({arrival_time_us, header, clip_index});
+  }
+
+  const NetEqMultiStreamBenchmark::Config& config_;
+  const EncodedClip* const clip_;
+  Clock* const receiver_clock_;
+  DriftingClock sender_clock_;
+  Random random_;
+  std::unique_ptr<NetEqImpl> neteq_;
+  AudioFrame frame_;
+  RTPHeader header_;
+  size_t clip_index_;
+  int64_t next_send_time_us_;
+  int64_t last_arrival_time_us_ = 0;
+  int spike_remaining_ms_ = 0;
+  std::deque<InFlightPacket> in_flight_;
+  int64_t decode_time_ns_ = 0;
+};
+
+void CountOperation(Operations operation,
+                    NetEqMultiStreamBenchmark::Results* results) {
+  switch (operation) {
+    case kNormal:
+      ++results->normal_count;
+      break;
+    case kExpand:
+      ++results->expand_count;
+      break;
+    case kAccelerate:
+    case kFastAccelerate:
+      ++results->accelerate_count;
+      break;
+    case kPreemptiveExpand:
+      ++results->preemptive_expand_count;
+      break;
+    case kMerge:
+      ++results->merge_count;
+      break;
+    default:
+      ++results->other_count;
+      break;
+  }
+}
+
+double Percent(int64_t count, int64_t total) {
+  return total > 0 ? 100.0 * count / total : 0.0;
+}
+
+}  // namespace
+
+bool NetEqMultiStreamBenchmark::Run(const Config& config, Results* results) {
+  RTC_CHECK_GT(config.num_streams, 0);
+  RTC_CHECK_GT(config.runtime_ms, config.warmup_ms);
+  RTC_CHECK_GE(config.warmup_ms, 0);
+  RTC_CHECK(config.max_drift_percent >= 0 && config.max_drift_percent < 100);
+
+  EncodedClip clip;
+  if (!EncodeClip(config.codec, &clip))
+    return false;
+
+  const int64_t rss_before_bytes = rtc::GetProcessResidentSizeBytes();
+  SimulatedClock receiver_clock(0);
+  rtc::scoped_refptr<AudioDecoderFactory> decoder_factory =
+      CreateBuiltinAudioDecoderFactory();
+  std::vector<std::unique_ptr<Stream>> streams;
+  for (int i = 0; i < config.num_streams; ++i) {
+    // Spread the drift evenly, from the slowest to the fastest sender.
+    const float drift_percent =
+        config.num_streams == 1
+            ? config.max_drift_percent
+            : config.max_drift_percent *
+                  (2.0f * i / (config.num_streams - 1) - 1.0f);
+    streams.push_back(absl::make_unique<Stream>(
+        config, i, DriftingClock::PercentsFaster(drift_percent), &clip,
+        &receiver_clock, decoder_factory));
+  }
+
+  *results = Results();
+  std::vector<float> decode_times_us;
+  int64_t total_decode_time_ns = 0;
+  for (int time_ms = 0; time_ms < config.runtime_ms; ++time_ms) {
+    receiver_clock.AdvanceTimeMilliseconds(1);
+    for (auto& stream : streams)
+      stream->Process();
+    if ((time_ms + 1) % kOutputBlockMs != 0)
+      continue;
+
+    const bool measure = time_ms >= config.warmup_ms;
+    if (measure && decode_times_us.empty()) {
+      // NetEq has reached its steady state buffer sizes.
+      const int64_t rss_bytes = rtc::GetProcessResidentSizeBytes();
+      if (rss_before_bytes >= 0 && rss_bytes >= 0) {
+        results->memory_bytes_per_stream =
+            static_cast<double>(rss_bytes - rss_before_bytes) /
+            config.num_streams;
+      }
+      for (auto& stream : streams)
+        stream->TimeStretchPpm();
+      decode_times_us.reserve(static_cast<size_t>(config.num_streams) *
+                              (config.runtime_ms - config.warmup_ms) /
+                              kOutputBlockMs);
+    }
+    for (auto& stream : streams) {
+      Operations operation;
+      const int64_t decode_time_ns = stream->GetAudio(&operation);
+      if (!measure)
+        continue;
+      total_decode_time_ns += decode_time_ns;
+      decode_times_us.push_back(static_cast<float>(decode_time_ns) /
+                                rtc::kNumNanosecsPerMicrosec);
+      CountOperation(operation, results);
+    }
+  }
+
+  results->num_get_audio_calls = decode_times_us.size();
+  if (!decode_times_us.empty()) {
+    results->mean_decode_us =
+        static_cast<double>(total_decode_time_ns) /
+        rtc::kNumNanosecsPerMicrosec / decode_times_us.size();
+    const size_t p99_index = decode_times_us.size() * 99 / 100;
+    std::nth_element(decode_times_us.begin(),
+                     decode_times_us.begin() + p99_index,
+                     decode_times_us.end());
+    results->p99_decode_us = decode_times_us[p99_index];
+  }
+  if (results->mean_decode_us > 0) {
+    results->streams_per_core =
+        kOutputBlockMs * rtc::kNumMicrosecsPerMillisec /
+        results->mean_decode_us;
+  }
+  double sum_abs_time_stretch_ppm = 0.0;
+  for (auto& stream : streams)
+    sum_abs_time_stretch_ppm += std::abs(stream->TimeStretchPpm());
+  results->mean_abs_time_stretch_ppm =
+      sum_abs_time_stretch_ppm / streams.size();
+  return true;
+}
+
+void NetEqMultiStreamBenchmark::PrintResults(const Config& config,
+                                             const Results& results) {
+  const std::string trace = std::to_string(config.num_streams) + "_" +
+                            config.codec + "_streams";
+  PrintResult("neteq_decode_time", "", trace, results.mean_decode_us,
+              "us/10ms", true);
+  PrintResult("neteq_decode_time_p99", "", trace, results.p99_decode_us,
+              "us/10ms", false);
+  PrintResult("neteq_streams_per_core", "", trace, results.streams_per_core,
+              "streams", true);
+  PrintResult("neteq_memory_per_stream", "", trace,
+              results.memory_bytes_per_stream / 1024, "KiB", false);
+  const int64_t total = results.num_get_audio_calls;
+  PrintResult("neteq_normal", "", trace, Percent(results.normal_count, total),
+              "%", false);
+  PrintResult("neteq_expand", "", trace, Percent(results.expand_count, total),
+              "%", false);
+  PrintResult("neteq_accelerate", "", trace,
+              Percent(results.accelerate_count, total), "%", false);
+  PrintResult("neteq_preemptive_expand", "", trace,
+              Percent(results.preemptive_expand_count, total), "%", false);
+  PrintResult("neteq_merge", "", trace, Percent(results.merge_count, total),
+              "%", false);
+  PrintResult("neteq_other_operations", "", trace,
+              Percent(results.other_count, total), "%", false);
+  PrintResult("neteq_time_stretch", "", trace,
+              results.mean_abs_time_stretch_ppm, "ppm", false);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_MULTI_STREAM_BENCHMARK_H_
+#define MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_MULTI_STREAM_BENCHMARK_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace webrtc {
+namespace test {
+
+// Runs many NetEq instances side by side, like the receive side of an audio
+// mixer, and measures what it costs to pull 10 ms of audio from each of them
+// every 10 ms. Every stream has its own sender clock, a DriftingClock running
+// slightly faster or slower than the receiver, and its own network with
+// jitter, delay spikes and loss, so that NetEq has to expand, accelerate and
+// merge as it would in a real call.
+class NetEqMultiStreamBenchmark {
+ public:
+  struct Config {
+    int num_streams = 10;
+    // Simulated time, of which the first |warmup_ms| aren't measured.
+    int runtime_ms = 60000;
+    int warmup_ms = 2000;
+    // "pcm16b" (32 kHz) or "opus" (48 kHz, 20 ms packets).
+    std::string codec = "pcm16b";
+    // The sender clocks are spread evenly over +-|max_drift_percent| relative
+    // to the receiver clock.
+    float max_drift_percent = 0.5f;
+    int base_delay_ms = 50;
+    // Standard deviation of the per-packet delay variation.
+    int jitter_ms = 10;
+    // Chance per packet of a delay spike, e.g. a Wi-Fi stall, which is
+    // |spike_ms| long and drains at the packet rate; packets keep their order.
+    float spike_probability = 0.002f;
+    int spike_ms = 300;
+    float loss_percent = 1.0f;
+    uint64_t seed = 1;
+  };
+
+  struct Results {
+    // Decode time, i.e. InsertPacket() and GetAudio(), per stream and 10 ms.
+    double mean_decode_us = 0.0;
+    double p99_decode_us = 0.0;
+    // The number of streams one core could serve in real time.
+    double streams_per_core = 0.0;
+    // Growth of the resident set size per NetEq instance, after warm-up.
+    double memory_bytes_per_stream = 0.0;
+    // The operation each GetAudio() call after warm-up performed.
+    int64_t num_get_audio_calls = 0;
+    int64_t normal_count = 0;
+    int64_t expand_count = 0;
+    int64_t accelerate_count = 0;
+    int64_t preemptive_expand_count = 0;
+    int64_t merge_count = 0;
+    // Comfort noise and DTMF.
+    int64_t other_count = 0;
+    // Mean over the streams of the magnitude of the net rate at which NetEq
+    // time-stretched the audio after warm-up, which tracks the sender drift.
+    double mean_abs_time_stretch_ppm = 0.0;
+  };
+
+  // Returns false if the input audio can't be read.
+  static bool Run(const Config& config, Results* results);
+
+  // Prints the results with test::PrintResult().
+  static void PrintResults(const Config& config, const Results& results);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_MULTI_STREAM_BENCHMARK_H_
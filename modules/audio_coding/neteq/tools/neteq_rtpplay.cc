@@ -16,10 +16,12 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "modules/audio_coding/neteq/include/neteq.h"
 #include "modules/audio_coding/neteq/tools/fake_decode_from_file.h"
 #include "modules/audio_coding/neteq/tools/input_audio_file.h"
+#include "modules/audio_coding/neteq/tools/neteq_batch_decoder.h"
 #include "modules/audio_coding/neteq/tools/neteq_delay_analyzer.h"
 #include "modules/audio_coding/neteq/tools/neteq_event_log_input.h"
 #include "modules/audio_coding/neteq/tools/neteq_packet_source_input.h"
@@ -133,6 +135,13 @@ DEFINE_bool(pythonplot,
             "Generates a python script for plotting the delay profile");
 DEFINE_bool(help, false, "Prints this message");
 DEFINE_bool(concealment_events, false, "Prints concealment events");
+DEFINE_bool(batch,
+            false,
+            "Decodes as fast as possible, in order and without "
+            "time-stretching, e.g. to transcode recordings. Takes any number "
+            "of input and output file pairs, which are decoded in parallel. "
+            "Ignores the plotting, statistics and replacement audio flags.");
+DEFINE_int(batch_threads, 4, "Number of threads decoding in batch mode");
 DEFINE_string(
     force_fieldtrials,
     "",
@@ -268,77 +277,13 @@ class SsrcSwitchDetector : public NetEqPostInsertPacket {
   absl::optional<uint32_t> last_ssrc_;
 };
 
-int RunTest(int argc, char* argv[]) {
-  std::string program_name = argv[0];
-  std::string usage =
-      "Tool for decoding an RTP dump file using NetEq.\n"
-      "Run " +
-      program_name +
-      " --help for usage.\n"
-      "Example usage:\n" +
-      program_name + " input.rtp output.{pcm, wav}\n";
-  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true)) {
-    return 1;
-  }
-  if (FLAG_help) {
-    std::cout << usage;
-    rtc::FlagList::Print(nullptr, false);
-    return 0;
-  }
-
-  if (FLAG_codec_map) {
-    PrintCodecMapping();
-  }
-
-  if (argc != 3) {
-    if (FLAG_codec_map) {
-      // We have already printed the codec map. Just end the program.
-      return 0;
-    }
-    // Print usage information.
-    std::cout << usage;
-    return 0;
-  }
-
-  ValidateFieldTrialsStringOrDie(FLAG_force_fieldtrials);
-  ScopedFieldTrials field_trials(FLAG_force_fieldtrials);
-
-  RTC_CHECK(ValidatePayloadType(FLAG_pcmu));
-  RTC_CHECK(ValidatePayloadType(FLAG_pcma));
-  RTC_CHECK(ValidatePayloadType(FLAG_ilbc));
-  RTC_CHECK(ValidatePayloadType(FLAG_isac));
-  RTC_CHECK(ValidatePayloadType(FLAG_isac_swb));
-  RTC_CHECK(ValidatePayloadType(FLAG_opus));
-  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b));
-  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b_wb));
-  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b_swb32));
-  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b_swb48));
-  RTC_CHECK(ValidatePayloadType(FLAG_g722));
-  RTC_CHECK(ValidatePayloadType(FLAG_avt));
-  RTC_CHECK(ValidatePayloadType(FLAG_avt_16));
-  RTC_CHECK(ValidatePayloadType(FLAG_avt_32));
-  RTC_CHECK(ValidatePayloadType(FLAG_avt_48));
-  RTC_CHECK(ValidatePayloadType(FLAG_red));
-  RTC_CHECK(ValidatePayloadType(FLAG_cn_nb));
-  RTC_CHECK(ValidatePayloadType(FLAG_cn_wb));
-  RTC_CHECK(ValidatePayloadType(FLAG_cn_swb32));
-  RTC_CHECK(ValidatePayloadType(FLAG_cn_swb48));
-  RTC_CHECK(ValidateSsrcValue(FLAG_ssrc));
-  RTC_CHECK(ValidateExtensionId(FLAG_audio_level));
-  RTC_CHECK(ValidateExtensionId(FLAG_abs_send_time));
-  RTC_CHECK(ValidateExtensionId(FLAG_transport_seq_no));
-  RTC_CHECK(ValidateExtensionId(FLAG_video_content_type));
-  RTC_CHECK(ValidateExtensionId(FLAG_video_timing));
-
-  // Gather RTP header extensions in a map.
-  NetEqPacketSourceInput::RtpHeaderExtensionMap rtp_ext_map = {
-      {FLAG_audio_level, kRtpExtensionAudioLevel},
-      {FLAG_abs_send_time, kRtpExtensionAbsoluteSendTime},
-      {FLAG_transport_seq_no, kRtpExtensionTransportSequenceNumber},
-      {FLAG_video_content_type, kRtpExtensionVideoContentType},
-      {FLAG_video_timing, kRtpExtensionVideoTiming}};
-
-  const std::string input_file_name = argv[1];
+// Opens an RTP dump, pcap or event log file, and skips the packets with
+// unknown payload types at its start. Returns the sample rate of the codec of
+// the first packet in |codec_sample_rate_hz|.
+std::unique_ptr<NetEqInput> CreateInput(
+    const std::string& input_file_name,
+    const NetEqPacketSourceInput::RtpHeaderExtensionMap& rtp_ext_map,
+    int* codec_sample_rate_hz) {
   std::unique_ptr<NetEqInput> input;
   if (RtpFileSource::ValidRtpDump(input_file_name) ||
       RtpFileSource::ValidPcap(input_file_name)) {
@@ -391,22 +336,28 @@ int RunTest(int argc, char* argv[]) {
               << std::endl;
     RTC_NOTREACHED();
   }
+  *codec_sample_rate_hz = *sample_rate_hz;
+  return input;
+}
 
-  // Open the output file now that we know the sample rate. (Rate is only needed
-  // for wav files.)
-  const std::string output_file_name = argv[2];
+// Opens a wav or pcm output file. The sample rate is only needed for wav files.
+std::unique_ptr<AudioSink> CreateOutput(const std::string& output_file_name,
+                                        int sample_rate_hz) {
   std::unique_ptr<AudioSink> output;
   if (output_file_name.size() >= 4 &&
       output_file_name.substr(output_file_name.size() - 4) == ".wav") {
     // Open a wav file.
-    output.reset(new OutputWavFile(output_file_name, *sample_rate_hz));
+    output.reset(new OutputWavFile(output_file_name, sample_rate_hz));
   } else {
     // Open a pcm file.
     output.reset(new OutputAudioFile(output_file_name));
   }
 
   std::cout << "Output file: " << output_file_name << std::endl;
+  return output;
+}
 
+NetEqTest::DecoderMap CreateCodecMap() {
   NetEqTest::DecoderMap codecs = {
     {FLAG_pcmu, std::make_pair(NetEqDecoder::kDecoderPCMu, "pcmu")},
     {FLAG_pcma, std::make_pair(NetEqDecoder::kDecoderPCMa, "pcma")},
@@ -440,6 +391,123 @@ int RunTest(int argc, char* argv[]) {
     {FLAG_cn_swb48,
      std::make_pair(NetEqDecoder::kDecoderCNGswb48kHz, "cng-swb48")}
   };
+  return codecs;
+}
+
+// Decodes the pairs of input and output files in |file_names| with one
+// NetEqBatchDecoder each, in parallel.
+int RunBatch(
+    int num_file_names,
+    char* file_names[],
+    const NetEqPacketSourceInput::RtpHeaderExtensionMap& rtp_ext_map) {
+  RTC_CHECK_GT(FLAG_batch_threads, 0);
+  const NetEqTest::DecoderMap codecs = CreateCodecMap();
+  std::vector<std::unique_ptr<NetEqBatchDecoder>> decoders;
+  std::vector<NetEqBatchDecoder*> decoder_ptrs;
+  for (int k = 0; k + 1 < num_file_names; k += 2) {
+    int sample_rate_hz;
+    std::unique_ptr<NetEqInput> input =
+        CreateInput(file_names[k], rtp_ext_map, &sample_rate_hz);
+    decoders.emplace_back(new NetEqBatchDecoder(
+        NetEqBatchDecoder::Config(), sample_rate_hz, codecs, std::move(input),
+        CreateOutput(file_names[k + 1], sample_rate_hz)));
+    decoder_ptrs.push_back(decoders.back().get());
+  }
+
+  const std::vector<int64_t> durations_ms = NetEqBatchDecoder::RunInParallel(
+      decoder_ptrs, static_cast<size_t>(FLAG_batch_threads));
+  for (size_t k = 0; k < durations_ms.size(); ++k) {
+    printf("%s: %" PRId64 " ms decoded\n", file_names[2 * k + 1],
+           durations_ms[k]);
+  }
+  return 0;
+}
+
+int RunTest(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Tool for decoding an RTP dump file using NetEq.\n"
+      "Run " +
+      program_name +
+      " --help for usage.\n"
+      "Example usage:\n" +
+      program_name + " input.rtp output.{pcm, wav}\n" + program_name +
+      " --batch input1.rtp output1.{pcm, wav} input2.rtp ...\n";
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true)) {
+    return 1;
+  }
+  if (FLAG_help) {
+    std::cout << usage;
+    rtc::FlagList::Print(nullptr, false);
+    return 0;
+  }
+
+  if (FLAG_codec_map) {
+    PrintCodecMapping();
+  }
+
+  if (FLAG_batch ? (argc < 3 || argc % 2 == 0) : argc != 3) {
+    if (FLAG_codec_map) {
+      // We have already printed the codec map. Just end the program.
+      return 0;
+    }
+    // Print usage information.
+    std::cout << usage;
+    return 0;
+  }
+
+  ValidateFieldTrialsStringOrDie(FLAG_force_fieldtrials);
+  ScopedFieldTrials field_trials(FLAG_force_fieldtrials);
+
+  RTC_CHECK(ValidatePayloadType(FLAG_pcmu));
+  RTC_CHECK(ValidatePayloadType(FLAG_pcma));
+  RTC_CHECK(ValidatePayloadType(FLAG_ilbc));
+  RTC_CHECK(ValidatePayloadType(FLAG_isac));
+  RTC_CHECK(ValidatePayloadType(FLAG_isac_swb));
+  RTC_CHECK(ValidatePayloadType(FLAG_opus));
+  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b));
+  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b_wb));
+  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b_swb32));
+  RTC_CHECK(ValidatePayloadType(FLAG_pcm16b_swb48));
+  RTC_CHECK(ValidatePayloadType(FLAG_g722));
+  RTC_CHECK(ValidatePayloadType(FLAG_avt));
+  RTC_CHECK(ValidatePayloadType(FLAG_avt_16));
+  RTC_CHECK(ValidatePayloadType(FLAG_avt_32));
+  RTC_CHECK(ValidatePayloadType(FLAG_avt_48));
+  RTC_CHECK(ValidatePayloadType(FLAG_red));
+  RTC_CHECK(ValidatePayloadType(FLAG_cn_nb));
+  RTC_CHECK(ValidatePayloadType(FLAG_cn_wb));
+  RTC_CHECK(ValidatePayloadType(FLAG_cn_swb32));
+  RTC_CHECK(ValidatePayloadType(FLAG_cn_swb48));
+  RTC_CHECK(ValidateSsrcValue(FLAG_ssrc));
+  RTC_CHECK(ValidateExtensionId(FLAG_audio_level));
+  RTC_CHECK(ValidateExtensionId(FLAG_abs_send_time));
+  RTC_CHECK(ValidateExtensionId(FLAG_transport_seq_no));
+  RTC_CHECK(ValidateExtensionId(FLAG_video_content_type));
+  RTC_CHECK(ValidateExtensionId(FLAG_video_timing));
+
+  // Gather RTP header extensions in a map.
+  NetEqPacketSourceInput::RtpHeaderExtensionMap rtp_ext_map = {
+      {FLAG_audio_level, kRtpExtensionAudioLevel},
+      {FLAG_abs_send_time, kRtpExtensionAbsoluteSendTime},
+      {FLAG_transport_seq_no, kRtpExtensionTransportSequenceNumber},
+      {FLAG_video_content_type, kRtpExtensionVideoContentType},
+      {FLAG_video_timing, kRtpExtensionVideoTiming}};
+
+  if (FLAG_batch) {
+    return RunBatch(argc - 1, argv + 1, rtp_ext_map);
+  }
+
+  const std::string input_file_name = argv[1];
+  int sample_rate_hz;
+  std::unique_ptr<NetEqInput> input =
+      CreateInput(input_file_name, rtp_ext_map, &sample_rate_hz);
+
+  const std::string output_file_name = argv[2];
+  std::unique_ptr<AudioSink> output =
+      CreateOutput(output_file_name, sample_rate_hz);
+
+  NetEqTest::DecoderMap codecs = CreateCodecMap();
 
   // Check if a replacement audio file was provided.
   std::unique_ptr<AudioDecoder> replacement_decoder;
@@ -489,7 +557,7 @@ int RunTest(int argc, char* argv[]) {
   NetEqStatsGetter stats_getter(std::move(delay_analyzer));
   callbacks.get_audio_callback = &stats_getter;
   NetEq::Config config;
-  config.sample_rate_hz = *sample_rate_hz;
+  config.sample_rate_hz = sample_rate_hz;
   NetEqTest test(config, codecs, ext_codecs, std::move(input),
                  std::move(output), callbacks);
 
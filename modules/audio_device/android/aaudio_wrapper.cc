@@ -14,6 +14,7 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/strings/string_builder.h"
 #include "rtc_base/timeutils.h"
+#include "system_wrappers/include/field_trial.h"
 
 #define LOG_ON_ERROR(op)                                                      \
   do {                                                                        \
@@ -47,6 +48,12 @@ const char* DirectionToString(aaudio_direction_t direction) {
   }
 }
 
+aaudio_sharing_mode_t RequestedSharingMode() {
+  return webrtc::field_trial::IsEnabled("WebRTC-Audio-AAudioExclusive")
+             ? AAUDIO_SHARING_MODE_EXCLUSIVE
+             : AAUDIO_SHARING_MODE_SHARED;
+}
+
 const char* SharingModeToString(aaudio_sharing_mode_t mode) {
   switch (mode) {
     case AAUDIO_SHARING_MODE_EXCLUSIVE:
@@ -370,10 +377,12 @@ void AAudioWrapper::SetStreamConfiguration(AAudioStreamBuilder* builder) {
   AAudioStreamBuilder_setChannelCount(builder, audio_parameters().channels());
   // Always use 16-bit PCM audio sample format.
   AAudioStreamBuilder_setFormat(builder, AAUDIO_FORMAT_PCM_I16);
-  // TODO(henrika): investigate effect of using AAUDIO_SHARING_MODE_EXCLUSIVE.
-  // Ask for exclusive mode since this will give us the lowest possible latency.
+  // Exclusive mode gives the lowest possible latency, since the stream then
+  // shares an MMAP buffer with the audio hardware where supported, but
+  // it keeps other applications from using the device. Hence it is only
+  // requested when the WebRTC-Audio-AAudioExclusive field trial is enabled.
   // If exclusive mode isn't available, shared mode will be used instead.
-  AAudioStreamBuilder_setSharingMode(builder, AAUDIO_SHARING_MODE_SHARED);
+  AAudioStreamBuilder_setSharingMode(builder, RequestedSharingMode());
   // Use the direction that was given at construction.
   AAudioStreamBuilder_setDirection(builder, direction_);
   // TODO(henrika): investigate performance using different performance modes.
@@ -444,9 +453,9 @@ bool AAudioWrapper::VerifyStreamConfiguration() {
     RTC_LOG(LS_ERROR) << "Stream unable to use requested format";
     return false;
   }
-  if (AAudioStream_getSharingMode(stream_) != AAUDIO_SHARING_MODE_SHARED) {
-    RTC_LOG(LS_ERROR) << "Stream unable to use requested sharing mode";
-    return false;
+  // Falling back from exclusive to shared mode is expected on many devices.
+  if (AAudioStream_getSharingMode(stream_) != RequestedSharingMode()) {
+    RTC_LOG(LS_WARNING) << "Stream unable to use requested sharing mode";
   }
   if (AAudioStream_getPerformanceMode(stream_) !=
       AAUDIO_PERFORMANCE_MODE_LOW_LATENCY) {
@@ -0,0 +1,263 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "modules/audio_device/include/headless_audio_device.h"
+
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+#include <errno.h>
+#include <time.h>
+#endif
+
+#include <algorithm>
+
+#include "modules/audio_device/include/audio_device_default.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kChunkDurationMs = 10;
+
+// Once the clock is this many ticks behind, it drops the missed ticks instead
+// of processing them back to back.
+constexpr int64_t kMaxNumLateTicks = 5;
+
+// Blocks until rtc::TimeMicros() reaches |deadline_us|, or |stop_event| is
+// set. Returns true if |stop_event| was set.
+bool WaitUntil(int64_t deadline_us, rtc::Event* stop_event) {
+  const int64_t wait_us = deadline_us - rtc::TimeMicros();
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  // rtc::Event waits with millisecond resolution, and mostly oversleeps by up
+  // to a millisecond. Sleep with microsecond resolution instead, till an
+  // absolute time so that being preempted before the call doesn't add up;
+  // ticks are short enough to check |stop_event| only on wake up.
+  if (wait_us > 0) {
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    const int64_t deadline_ns =
+        deadline.tv_nsec + wait_us * rtc::kNumNanosecsPerMicrosec;
+    deadline.tv_sec += deadline_ns / rtc::kNumNanosecsPerSec;
+    deadline.tv_nsec = deadline_ns % rtc::kNumNanosecsPerSec;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline,
+                           nullptr) == EINTR) {
+    }
+  }
+  return stop_event->Wait(0);
+#else
+  const int wait_ms =
+      wait_us > 0 ? rtc::dchecked_cast<int>(
+                        (wait_us + rtc::kNumMicrosecsPerMillisec - 1) /
+                        rtc::kNumMicrosecsPerMillisec)
+                  : 0;
+  return stop_event->Wait(wait_ms);
+#endif
+}
+
+class HeadlessAudioDeviceModuleImpl
+    : public webrtc_impl::AudioDeviceModuleDefault<HeadlessAudioDeviceModule>,
+      public HeadlessAudioClock::Client {
+ public:
+  HeadlessAudioDeviceModuleImpl(HeadlessAudioClock* clock,
+                                const Config& config)
+      : clock_(clock),
+        renderer_(config.renderer),
+        sample_rate_hz_(config.sample_rate_hz),
+        num_channels_(config.num_channels),
+        samples_per_chunk_(rtc::CheckedDivExact(sample_rate_hz_, 100) *
+                           num_channels_),
+        playout_buffer_(samples_per_chunk_ * clock->block_duration_ms() /
+                        kChunkDurationMs) {
+    RTC_DCHECK(clock_);
+    RTC_DCHECK(num_channels_ == 1 || num_channels_ == 2);
+  }
+
+  ~HeadlessAudioDeviceModuleImpl() override { StopPlayout(); }
+
+  int32_t RegisterAudioCallback(AudioTransport* callback) override {
+    rtc::CritScope cs(&lock_);
+    audio_callback_ = callback;
+    return 0;
+  }
+
+  int32_t PlayoutIsAvailable(bool* available) override {
+    *available = true;
+    return 0;
+  }
+
+  int32_t RecordingIsAvailable(bool* available) override {
+    *available = false;
+    return 0;
+  }
+
+  int32_t StereoPlayoutIsAvailable(bool* available) const override {
+    *available = num_channels_ == 2;
+    return 0;
+  }
+
+  int32_t StereoPlayout(bool* enabled) const override {
+    *enabled = num_channels_ == 2;
+    return 0;
+  }
+
+  // The clock calls OnTick() with its lock held, so the clock is called
+  // without holding |lock_|, which OnTick() takes.
+  int32_t StartPlayout() override {
+    {
+      rtc::CritScope cs(&lock_);
+      if (playing_)
+        return 0;
+      playing_ = true;
+    }
+    clock_->AddClient(this);
+    return 0;
+  }
+
+  int32_t StopPlayout() override {
+    {
+      rtc::CritScope cs(&lock_);
+      if (!playing_)
+        return 0;
+      playing_ = false;
+    }
+    clock_->RemoveClient(this);
+    return 0;
+  }
+
+  bool Playing() const override {
+    rtc::CritScope cs(&lock_);
+    return playing_;
+  }
+
+  void OnTick(int block_duration_ms) override {
+    rtc::CritScope cs(&lock_);
+    if (!audio_callback_)
+      return;
+    int16_t* chunk = playout_buffer_.data();
+    for (int ms = 0; ms < block_duration_ms; ms += kChunkDurationMs) {
+      size_t samples_out = 0;
+      int64_t elapsed_time_ms = -1;
+      int64_t ntp_time_ms = -1;
+      audio_callback_->NeedMorePlayData(
+          samples_per_chunk_ / num_channels_, sizeof(int16_t) * num_channels_,
+          num_channels_, sample_rate_hz_, chunk, samples_out, &elapsed_time_ms,
+          &ntp_time_ms);
+      chunk += samples_per_chunk_;
+    }
+    if (renderer_) {
+      renderer_->Render(playout_buffer_, sample_rate_hz_, num_channels_);
+    }
+  }
+
+ private:
+  HeadlessAudioClock* const clock_;
+  Renderer* const renderer_;
+  const int sample_rate_hz_;
+  const size_t num_channels_;
+  // Interleaved samples in 10 ms of audio.
+  const size_t samples_per_chunk_;
+
+  rtc::CriticalSection lock_;
+  AudioTransport* audio_callback_ RTC_GUARDED_BY(lock_) = nullptr;
+  bool playing_ RTC_GUARDED_BY(lock_) = false;
+  std::vector<int16_t> playout_buffer_ RTC_GUARDED_BY(lock_);
+};
+
+}  // namespace
+
+HeadlessAudioClock::HeadlessAudioClock(const Config& config)
+    : block_duration_ms_(config.block_duration_ms),
+      start_time_us_(rtc::TimeMicros()),
+      stop_event_(false, false),
+      thread_(&HeadlessAudioClock::Run,
+              this,
+              "HeadlessAudioClock",
+              config.priority) {
+  RTC_CHECK(block_duration_ms_ == 10 || block_duration_ms_ == 20);
+  thread_.Start();
+}
+
+HeadlessAudioClock::~HeadlessAudioClock() {
+  stop_event_.Set();
+  thread_.Stop();
+}
+
+void HeadlessAudioClock::AddClient(Client* client) {
+  RTC_DCHECK(client);
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(std::find(clients_.begin(), clients_.end(), client) ==
+             clients_.end());
+  clients_.push_back(client);
+}
+
+void HeadlessAudioClock::RemoveClient(Client* client) {
+  rtc::CritScope lock(&crit_);
+  auto it = std::find(clients_.begin(), clients_.end(), client);
+  RTC_DCHECK(it != clients_.end());
+  if (it != clients_.end())
+    clients_.erase(it);
+}
+
+HeadlessAudioClock::Stats HeadlessAudioClock::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  Stats stats = stats_;
+  if (stats.num_ticks > 0)
+    stats.mean_jitter_us = total_jitter_us_ / stats.num_ticks;
+  return stats;
+}
+
+void HeadlessAudioClock::Run(void* obj) {
+  static_cast<HeadlessAudioClock*>(obj)->Run();
+}
+
+void HeadlessAudioClock::Run() {
+  const int64_t tick_duration_us =
+      block_duration_ms_ * rtc::kNumMicrosecsPerMillisec;
+  for (int64_t tick = 1;; ++tick) {
+    const int64_t deadline_us = start_time_us_ + tick * tick_duration_us;
+    if (WaitUntil(deadline_us, &stop_event_)) {
+      return;
+    }
+
+    const int64_t now_us = rtc::TimeMicros();
+    const int64_t jitter_us = std::max<int64_t>(0, now_us - deadline_us);
+    int64_t num_skipped_ticks = 0;
+    if (jitter_us > kMaxNumLateTicks * tick_duration_us) {
+      num_skipped_ticks = jitter_us / tick_duration_us;
+      tick += num_skipped_ticks;
+    }
+
+    rtc::CritScope lock(&crit_);
+    for (Client* client : clients_) {
+      client->OnTick(block_duration_ms_);
+    }
+
+    const int64_t end_us = rtc::TimeMicros();
+    ++stats_.num_ticks;
+    stats_.num_skipped_ticks += num_skipped_ticks;
+    stats_.max_jitter_us = std::max(stats_.max_jitter_us, jitter_us);
+    total_jitter_us_ += jitter_us;
+    stats_.max_tick_duration_us =
+        std::max(stats_.max_tick_duration_us, end_us - now_us);
+    if (end_us > start_time_us_ + (tick + 1) * tick_duration_us) {
+      ++stats_.num_overruns;
+    }
+  }
+}
+
+rtc::scoped_refptr<HeadlessAudioDeviceModule> HeadlessAudioDeviceModule::Create(
+    HeadlessAudioClock* clock,
+    const Config& config) {
+  return new rtc::RefCountedObject<HeadlessAudioDeviceModuleImpl>(clock,
+                                                                  config);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef MODULES_AUDIO_DEVICE_INCLUDE_HEADLESS_AUDIO_DEVICE_H_
+#define MODULES_AUDIO_DEVICE_INCLUDE_HEADLESS_AUDIO_DEVICE_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_device/include/audio_device.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// The clock of headless audio devices, for servers that mix the audio of many
+// calls and have no sound card. One thread, woken by a monotonic timer with
+// absolute deadlines, so that timing errors don't accumulate, processes one
+// block of audio for every started device on each tick. A server with one
+// AudioState per call thereby pulls the playout audio of all its calls in one
+// batch per tick.
+class HeadlessAudioClock {
+ public:
+  // Is called on the clock thread on every tick.
+  class Client {
+   public:
+    virtual void OnTick(int block_duration_ms) = 0;
+
+   protected:
+    virtual ~Client() {}
+  };
+
+  struct Config {
+    // The duration of the audio processed on every tick, 10 or 20 ms.
+    int block_duration_ms = 10;
+    rtc::ThreadPriority priority = rtc::kRealtimePriority;
+  };
+
+  struct Stats {
+    int64_t num_ticks = 0;
+    // Ticks that were not done processing when the next tick was due.
+    int64_t num_overruns = 0;
+    // Ticks that were dropped to catch up after falling far behind.
+    int64_t num_skipped_ticks = 0;
+    // How much later than its deadline the clock thread woke up for a tick.
+    int64_t max_jitter_us = 0;
+    int64_t mean_jitter_us = 0;
+    // The longest time that the clients have spent processing one tick.
+    int64_t max_tick_duration_us = 0;
+  };
+
+  explicit HeadlessAudioClock(const Config& config);
+  ~HeadlessAudioClock();
+
+  int block_duration_ms() const { return block_duration_ms_; }
+
+  // From the next tick on, |client| is called on every tick. A client may only
+  // be added once.
+  void AddClient(Client* client);
+  // Once this returns, |client| is no longer called.
+  void RemoveClient(Client* client);
+
+  Stats GetStats() const;
+
+ private:
+  static void Run(void* obj);
+  void Run();
+
+  const int block_duration_ms_;
+  const int64_t start_time_us_;
+  rtc::CriticalSection crit_;
+  std::vector<Client*> clients_ RTC_GUARDED_BY(crit_);
+  Stats stats_ RTC_GUARDED_BY(crit_);
+  int64_t total_jitter_us_ RTC_GUARDED_BY(crit_) = 0;
+  rtc::Event stop_event_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(HeadlessAudioClock);
+};
+
+// An AudioDeviceModule without a sound card. While playing, it pulls a block
+// of playout audio from its AudioTransport on every tick of a
+// HeadlessAudioClock, in 10 ms chunks, and hands it to a renderer, if any. It
+// has no microphone: recording succeeds, but no audio is recorded.
+class HeadlessAudioDeviceModule : public AudioDeviceModule {
+ public:
+  // Receives the audio of every block, on the clock thread.
+  class Renderer {
+   public:
+    virtual void Render(rtc::ArrayView<const int16_t> data,
+                        int sample_rate_hz,
+                        size_t num_channels) = 0;
+
+   protected:
+    virtual ~Renderer() {}
+  };
+
+  struct Config {
+    int sample_rate_hz = 48000;
+    size_t num_channels = 1;
+    // Must outlive the module, if set.
+    Renderer* renderer = nullptr;
+  };
+
+  // |clock| must outlive the module.
+  static rtc::scoped_refptr<HeadlessAudioDeviceModule> Create(
+      HeadlessAudioClock* clock,
+      const Config& config);
+
+  ~HeadlessAudioDeviceModule() override {}
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_DEVICE_INCLUDE_HEADLESS_AUDIO_DEVICE_H_
@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "modules/audio_device/include/headless_audio_device.h"
+#include "modules/audio_device/include/mock_audio_transport.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+constexpr int kWaitMs = 5000;
+
+// Fills every 10 ms chunk with the number of chunks pulled so far.
+class CountingAudioTransport : public test::MockAudioTransport {
+ public:
+  CountingAudioTransport() {
+    ON_CALL(*this, NeedMorePlayData(_, _, _, _, _, _, _, _))
+        .WillByDefault(::testing::Invoke(this, &CountingAudioTransport::Fill));
+  }
+
+ private:
+  int32_t Fill(size_t num_samples,
+               size_t bytes_per_sample,
+               size_t num_channels,
+               uint32_t sample_rate,
+               void* audio_samples,
+               size_t& num_samples_out,
+               int64_t* elapsed_time_ms,
+               int64_t* ntp_time_ms) {
+    int16_t* samples = static_cast<int16_t*>(audio_samples);
+    std::fill(samples, samples + num_samples * num_channels, ++num_chunks_);
+    num_samples_out = num_samples;
+    return 0;
+  }
+
+  int16_t num_chunks_ = 0;
+};
+
+class BlockRenderer : public HeadlessAudioDeviceModule::Renderer {
+ public:
+  explicit BlockRenderer(size_t num_blocks)
+      : num_blocks_(num_blocks), done_(false, false) {}
+
+  void Render(rtc::ArrayView<const int16_t> data,
+              int sample_rate_hz,
+              size_t num_channels) override {
+    rtc::CritScope lock(&crit_);
+    if (blocks_.size() == num_blocks_)
+      return;
+    blocks_.emplace_back(data.begin(), data.end());
+    sample_rate_hz_ = sample_rate_hz;
+    num_channels_ = num_channels;
+    if (blocks_.size() == num_blocks_)
+      done_.Set();
+  }
+
+  bool Wait() { return done_.Wait(kWaitMs); }
+
+  std::vector<std::vector<int16_t>> blocks() const {
+    rtc::CritScope lock(&crit_);
+    return blocks_;
+  }
+  int sample_rate_hz() const {
+    rtc::CritScope lock(&crit_);
+    return sample_rate_hz_;
+  }
+  size_t num_channels() const {
+    rtc::CritScope lock(&crit_);
+    return num_channels_;
+  }
+
+ private:
+  const size_t num_blocks_;
+  rtc::CriticalSection crit_;
+  std::vector<std::vector<int16_t>> blocks_;
+  int sample_rate_hz_ = 0;
+  size_t num_channels_ = 0;
+  rtc::Event done_;
+};
+
+HeadlessAudioClock::Config ClockConfig(int block_duration_ms) {
+  HeadlessAudioClock::Config config;
+  config.block_duration_ms = block_duration_ms;
+  config.priority = rtc::kNormalPriority;
+  return config;
+}
+
+}  // namespace
+
+TEST(HeadlessAudioDeviceTest, PullsBlocksInTenMsChunks) {
+  HeadlessAudioClock clock(ClockConfig(20));
+  BlockRenderer renderer(3);
+  HeadlessAudioDeviceModule::Config config;
+  config.sample_rate_hz = 16000;
+  config.num_channels = 2;
+  config.renderer = &renderer;
+  rtc::scoped_refptr<HeadlessAudioDeviceModule> adm =
+      HeadlessAudioDeviceModule::Create(&clock, config);
+
+  ::testing::NiceMock<CountingAudioTransport> transport;
+  EXPECT_CALL(transport, NeedMorePlayData(160, 4, 2, 16000, _, _, _, _))
+      .Times(AnyNumber());
+  adm->RegisterAudioCallback(&transport);
+  EXPECT_EQ(0, adm->StartPlayout());
+  EXPECT_TRUE(adm->Playing());
+  ASSERT_TRUE(renderer.Wait());
+  EXPECT_EQ(0, adm->StopPlayout());
+  EXPECT_FALSE(adm->Playing());
+
+  EXPECT_EQ(16000, renderer.sample_rate_hz());
+  EXPECT_EQ(2u, renderer.num_channels());
+  const std::vector<std::vector<int16_t>> blocks = renderer.blocks();
+  ASSERT_EQ(3u, blocks.size());
+  int16_t chunk = 0;
+  for (const std::vector<int16_t>& block : blocks) {
+    // Two chunks of 160 stereo samples.
+    ASSERT_EQ(640u, block.size());
+    EXPECT_EQ(++chunk, block[0]);
+    EXPECT_EQ(chunk, block[319]);
+    EXPECT_EQ(++chunk, block[320]);
+    EXPECT_EQ(chunk, block[639]);
+  }
+}
+
+TEST(HeadlessAudioDeviceTest, DrivesSeveralDevicesFromOneClock) {
+  HeadlessAudioClock clock(ClockConfig(10));
+  BlockRenderer renderer1(5);
+  BlockRenderer renderer2(5);
+  HeadlessAudioDeviceModule::Config config;
+  config.renderer = &renderer1;
+  rtc::scoped_refptr<HeadlessAudioDeviceModule> adm1 =
+      HeadlessAudioDeviceModule::Create(&clock, config);
+  config.renderer = &renderer2;
+  rtc::scoped_refptr<HeadlessAudioDeviceModule> adm2 =
+      HeadlessAudioDeviceModule::Create(&clock, config);
+
+  ::testing::NiceMock<CountingAudioTransport> transport1;
+  ::testing::NiceMock<CountingAudioTransport> transport2;
+  adm1->RegisterAudioCallback(&transport1);
+  adm2->RegisterAudioCallback(&transport2);
+  adm1->StartPlayout();
+  adm2->StartPlayout();
+  ASSERT_TRUE(renderer1.Wait());
+  ASSERT_TRUE(renderer2.Wait());
+  adm1->StopPlayout();
+  adm2->StopPlayout();
+
+  EXPECT_EQ(480u, renderer1.blocks()[0].size());
+  EXPECT_EQ(480u, renderer2.blocks()[0].size());
+  const HeadlessAudioClock::Stats stats = clock.GetStats();
+  EXPECT_GE(stats.num_ticks, 5);
+  EXPECT_GE(stats.max_jitter_us, stats.mean_jitter_us);
+  EXPECT_GE(stats.mean_jitter_us, 0);
+}
+
+TEST(HeadlessAudioDeviceTest, DoesNotPullWhenStopped) {
+  HeadlessAudioClock clock(ClockConfig(10));
+  BlockRenderer renderer(1);
+  HeadlessAudioDeviceModule::Config config;
+  config.renderer = &renderer;
+  rtc::scoped_refptr<HeadlessAudioDeviceModule> adm =
+      HeadlessAudioDeviceModule::Create(&clock, config);
+
+  test::MockAudioTransport transport;
+  EXPECT_CALL(transport, NeedMorePlayData(_, _, _, _, _, _, _, _)).Times(0);
+  adm->RegisterAudioCallback(&transport);
+  rtc::Event(false, false).Wait(50);
+  EXPECT_TRUE(renderer.blocks().empty());
+  EXPECT_GT(clock.GetStats().num_ticks, 0);
+}
+
+}  // namespace webrtc
@@ -9,12 +9,14 @@
  */
 
 #include <assert.h>
+#include <stdio.h>
 
 #include "modules/audio_device/audio_device_config.h"
 #include "modules/audio_device/linux/audio_device_pulse_linux.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/event_wrapper.h"
+#include "system_wrappers/include/field_trial.h"
 
 webrtc::adm_linux_pulse::PulseAudioSymbolTable PaSymbolTable;
 
@@ -27,6 +29,39 @@ webrtc::adm_linux_pulse::PulseAudioSymbolTable PaSymbolTable;
 
 namespace webrtc {
 
+namespace {
+
+const char kPulseLowLatencyFieldTrial[] = "WebRTC-Audio-PulseLowLatency";
+
+// Reads the playback and capture latency targets from the field trial, if it
+// is enabled and well formed.
+bool GetLowLatencyTargets(uint32_t* play_latency_ms, uint32_t* rec_latency_ms) {
+  const std::string group =
+      webrtc::field_trial::FindFullName(kPulseLowLatencyFieldTrial);
+  if (group.empty())
+    return false;
+
+  unsigned int play_ms = 0;
+  unsigned int rec_ms = 0;
+  if (sscanf(group.c_str(), "Enabled-%u,%u", &play_ms, &rec_ms) != 2)
+    return false;
+
+  if (play_ms < WEBRTC_PA_LOW_LATENCY_PLAYBACK_MINIMUM_MSECS ||
+      play_ms > WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS ||
+      rec_ms < WEBRTC_PA_LOW_LATENCY_CAPTURE_MINIMUM_MSECS ||
+      rec_ms > WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS) {
+    RTC_LOG(LS_WARNING) << "Invalid " << kPulseLowLatencyFieldTrial << ": "
+                        << group;
+    return false;
+  }
+
+  *play_latency_ms = play_ms;
+  *rec_latency_ms = rec_ms;
+  return true;
+}
+
+}  // namespace
+
 AudioDeviceLinuxPulse::AudioDeviceLinuxPulse()
     : _ptrAudioBuffer(NULL),
       _timeEventRec(*EventWrapper::Create()),
@@ -71,6 +106,9 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse()
       _tempSampleDataSize(0),
       _configuredLatencyPlay(0),
       _configuredLatencyRec(0),
+      _playLatencyMinimumMs(WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS),
+      _playLatencyIncrementMs(WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS),
+      _recLatencyMs(WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS),
       _paDeviceIndex(-1),
       _paStateChanged(false),
       _paMainloop(NULL),
@@ -86,6 +124,12 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse()
   memset(&_playBufferAttr, 0, sizeof(_playBufferAttr));
   memset(&_recBufferAttr, 0, sizeof(_recBufferAttr));
   memset(_oldKeyState, 0, sizeof(_oldKeyState));
+
+  if (GetLowLatencyTargets(&_playLatencyMinimumMs, &_recLatencyMs)) {
+    _playLatencyIncrementMs = _playLatencyMinimumMs / 2;
+    RTC_LOG(LS_INFO) << "Low latency mode, playback " << _playLatencyMinimumMs
+                     << " ms, capture " << _recLatencyMs << " ms";
+  }
 }
 
 AudioDeviceLinuxPulse::~AudioDeviceLinuxPulse() {
@@ -918,8 +962,8 @@ int32_t AudioDeviceLinuxPulse::InitPlayout() {
     }
 
     size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-    uint32_t latency = bytesPerSec * WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS /
-                       WEBRTC_PA_MSECS_PER_SEC;
+    uint32_t latency =
+        bytesPerSec * _playLatencyMinimumMs / WEBRTC_PA_MSECS_PER_SEC;
 
     // Set the play buffer attributes
     _playBufferAttr.maxlength = latency;  // num bytes stored in the buffer
@@ -1017,8 +1061,7 @@ int32_t AudioDeviceLinuxPulse::InitRecording() {
     }
 
     size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-    uint32_t latency = bytesPerSec * WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS /
-                       WEBRTC_PA_MSECS_PER_SEC;
+    uint32_t latency = bytesPerSec * _recLatencyMs / WEBRTC_PA_MSECS_PER_SEC;
 
     // Set the rec buffer attributes
     // Note: fragsize specifies a maximum transfer size, not a minimum, so
@@ -1783,9 +1826,8 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler() {
 
   size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
   uint32_t newLatency =
-      _configuredLatencyPlay + bytesPerSec *
-                                   WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS /
-                                   WEBRTC_PA_MSECS_PER_SEC;
+      _configuredLatencyPlay +
+      bytesPerSec * _playLatencyIncrementMs / WEBRTC_PA_MSECS_PER_SEC;
 
   // Set the play buffer attributes
   _playBufferAttr.maxlength = newLatency;
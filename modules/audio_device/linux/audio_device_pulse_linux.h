@@ -85,6 +85,15 @@ const uint32_t WEBRTC_PA_CAPTURE_BUFFER_EXTRA_MSECS = 750;
 
 const uint32_t WEBRTC_PA_MSECS_PER_SEC = 1000;
 
+// Interactive applications may lower the playback and capture latency targets
+// above with the "WebRTC-Audio-PulseLowLatency" field trial, using the group
+// "Enabled-<playback msecs>,<capture msecs>". Playback then starts at the given
+// latency, down to this lowest value, and every underflow raises it by half of
+// that instead of WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS, so that it
+// settles close to the lowest latency the system can sustain.
+const uint32_t WEBRTC_PA_LOW_LATENCY_PLAYBACK_MINIMUM_MSECS = 5;
+const uint32_t WEBRTC_PA_LOW_LATENCY_CAPTURE_MINIMUM_MSECS = 1;
+
 // Init _configuredLatencyRec/Play to this value to disable latency requirements
 const int32_t WEBRTC_PA_NO_LATENCY_REQUIREMENTS = -1;
 
@@ -314,6 +323,10 @@ class AudioDeviceLinuxPulse : public AudioDeviceGeneric {
   size_t _tempSampleDataSize;
   int32_t _configuredLatencyPlay;
   int32_t _configuredLatencyRec;
+  // Latency targets in milliseconds, see WebRTC-Audio-PulseLowLatency.
+  uint32_t _playLatencyMinimumMs;
+  uint32_t _playLatencyIncrementMs;
+  uint32_t _recLatencyMs;
 
   // PulseAudio
   uint16_t _paDeviceIndex;
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/audio_decode_pool.h"
+
+#include <algorithm>
+
+#include "rtc_base/atomicops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+
+class AudioDecodePool::Worker {
+ public:
+  explicit Worker(AudioDecodePool* pool)
+      : pool_(pool),
+        start_event_(false, false),
+        done_event_(false, false),
+        thread_(&Worker::Run, this, "AudioDecodeWorker",
+                rtc::kRealtimePriority) {
+    thread_.Start();
+  }
+
+  ~Worker() {
+    rtc::AtomicOps::ReleaseStore(&stop_, 1);
+    start_event_.Set();
+    thread_.Stop();
+  }
+
+  void Start() { start_event_.Set(); }
+  void WaitUntilDone() { done_event_.Wait(rtc::Event::kForever); }
+
+ private:
+  static void Run(void* obj) { static_cast<Worker*>(obj)->Run(); }
+
+  void Run() {
+    while (true) {
+      start_event_.Wait(rtc::Event::kForever);
+      if (rtc::AtomicOps::AcquireLoad(&stop_)) {
+        return;
+      }
+      pool_->RunTasks();
+      done_event_.Set();
+    }
+  }
+
+  AudioDecodePool* const pool_;
+  volatile int stop_ = 0;
+  rtc::Event start_event_;
+  rtc::Event done_event_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+AudioDecodePool::AudioDecodePool(size_t num_threads) {
+  for (size_t k = 0; k < num_threads; ++k) {
+    workers_.emplace_back(new Worker(this));
+  }
+}
+
+AudioDecodePool::~AudioDecodePool() = default;
+
+void AudioDecodePool::Run(size_t num_tasks,
+                          rtc::FunctionView<void(size_t)> task) {
+  if (num_tasks == 0) {
+    return;
+  }
+  task_ = task;
+  num_tasks_ = rtc::dchecked_cast<int>(num_tasks);
+  rtc::AtomicOps::ReleaseStore(&next_task_, 0);
+
+  // Waking up the workers costs more than running a single task here.
+  const size_t num_workers = std::min(workers_.size(), num_tasks - 1);
+  for (size_t k = 0; k < num_workers; ++k) {
+    workers_[k]->Start();
+  }
+  RunTasks();
+  for (size_t k = 0; k < num_workers; ++k) {
+    workers_[k]->WaitUntilDone();
+  }
+}
+
+void AudioDecodePool::RunTasks() {
+  while (true) {
+    const int k = rtc::AtomicOps::Increment(&next_task_) - 1;
+    if (k >= num_tasks_) {
+      return;
+    }
+    task_(k);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_AUDIO_DECODE_POOL_H_
+#define MODULES_AUDIO_MIXER_AUDIO_DECODE_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/function_view.h"
+
+namespace webrtc {
+
+// A pool of threads on which the mixer asks its sources for audio, so that
+// the decoding of many receive streams is spread over several cores instead
+// of running serially within one 10 ms deadline.
+class AudioDecodePool {
+ public:
+  explicit AudioDecodePool(size_t num_threads);
+  ~AudioDecodePool();
+
+  // Calls |task(k)| for every k in [0, |num_tasks|), on the threads of the
+  // pool and on the calling thread. Returns once all the calls have returned.
+  // Must not be called concurrently.
+  void Run(size_t num_tasks, rtc::FunctionView<void(size_t)> task);
+
+ private:
+  class Worker;
+
+  // Runs tasks until there are none left. Called on all the threads taking
+  // part in Run().
+  void RunTasks();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Only written by Run() before the workers are started, so that reading
+  // them on the worker threads needs no lock.
+  rtc::FunctionView<void(size_t)> task_;
+  int num_tasks_ = 0;
+  volatile int next_task_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AudioDecodePool);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_AUDIO_DECODE_POOL_H_
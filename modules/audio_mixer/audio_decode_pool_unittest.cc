@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/audio_decode_pool.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(AudioDecodePool, RunsEveryTaskOnce) {
+  AudioDecodePool pool(3);
+  for (const size_t num_tasks : {0, 1, 2, 100}) {
+    std::vector<int> num_calls(num_tasks, 0);
+    pool.Run(num_tasks, [&num_calls](size_t k) { ++num_calls[k]; });
+    EXPECT_EQ(std::vector<int>(num_tasks, 1), num_calls);
+  }
+}
+
+TEST(AudioDecodePool, RunsTasksOnSeveralThreads) {
+  constexpr size_t kNumTasks = 8;
+  AudioDecodePool pool(kNumTasks - 1);
+  rtc::CriticalSection crit;
+  std::set<rtc::PlatformThreadId> thread_ids;
+  size_t num_running = 0;
+  size_t max_num_running = 0;
+  pool.Run(kNumTasks, [&](size_t k) {
+    {
+      rtc::CritScope lock(&crit);
+      thread_ids.insert(rtc::CurrentThreadId());
+      max_num_running = std::max(max_num_running, ++num_running);
+    }
+    // Keep the task busy so that the other threads pick up tasks too.
+    rtc::Event wait(false, false);
+    wait.Wait(20);
+    rtc::CritScope lock(&crit);
+    --num_running;
+  });
+  EXPECT_LT(1u, thread_ids.size());
+  EXPECT_LT(1u, max_num_running);
+}
+
+TEST(AudioDecodePool, WorksWithoutThreads) {
+  AudioDecodePool pool(0);
+  const rtc::PlatformThreadId thread_id = rtc::CurrentThreadId();
+  size_t num_calls = 0;
+  pool.Run(3, [&](size_t k) {
+    EXPECT_EQ(thread_id, rtc::CurrentThreadId());
+    ++num_calls;
+  });
+  EXPECT_EQ(3u, num_calls);
+}
+
+}  // namespace webrtc
@@ -23,6 +23,11 @@
 namespace webrtc {
 namespace {
 
+// Lowers the level at which a mixed source is replaced when selecting sources
+// by their received audio levels, so that sources with similar levels do not
+// keep replacing each other.
+constexpr int kAudioLevelHysteresisDb = 6;
+
 struct SourceFrame {
   SourceFrame(AudioMixerImpl::SourceStatus* source_status,
               AudioFrame* audio_frame,
@@ -79,6 +84,52 @@ void RampAndUpdateGain(
   }
 }
 
+struct SourceAudioLevel {
+  AudioMixerImpl::SourceStatus* source_status;
+  bool voice_activity;
+  int level_dbov;
+};
+
+// Returns the sources to ask for audio: the |max_num_sources| ones with the
+// highest received audio levels, as well as all the sources for which the
+// level is unknown.
+std::vector<AudioMixerImpl::SourceStatus*> SelectSourcesByAudioLevel(
+    const AudioMixerImpl::SourceStatusList& audio_source_list,
+    size_t max_num_sources) {
+  std::vector<AudioMixerImpl::SourceStatus*> selected_sources;
+  std::vector<SourceAudioLevel> levels;
+  for (const auto& source_status : audio_source_list) {
+    const absl::optional<AudioMixer::Source::AudioLevel> audio_level =
+        source_status->audio_source->ReceivedAudioLevel();
+    if (!audio_level) {
+      selected_sources.push_back(source_status.get());
+      continue;
+    }
+    const int hysteresis_db =
+        source_status->is_mixed ? kAudioLevelHysteresisDb : 0;
+    levels.push_back({source_status.get(), audio_level->voice_activity,
+                      audio_level->level_dbov - hysteresis_db});
+  }
+
+  const size_t num_sources = std::min(max_num_sources, levels.size());
+  std::partial_sort(
+      levels.begin(), levels.begin() + num_sources, levels.end(),
+      [](const SourceAudioLevel& a, const SourceAudioLevel& b) {
+        if (a.voice_activity != b.voice_activity) {
+          return a.voice_activity;
+        }
+        return a.level_dbov < b.level_dbov;
+      });
+  for (size_t k = 0; k < levels.size(); ++k) {
+    if (k < num_sources) {
+      selected_sources.push_back(levels[k].source_status);
+    } else {
+      levels[k].source_status->is_mixed = false;
+    }
+  }
+  return selected_sources;
+}
+
 AudioMixerImpl::SourceStatusList::const_iterator FindSourceInList(
     AudioMixerImpl::Source const* audio_source,
     AudioMixerImpl::SourceStatusList const* audio_source_list) {
@@ -92,11 +143,17 @@ AudioMixerImpl::SourceStatusList::const_iterator FindSourceInList(
 
 AudioMixerImpl::AudioMixerImpl(
     std::unique_ptr<OutputRateCalculator> output_rate_calculator,
-    bool use_limiter)
+    bool use_limiter,
+    bool select_sources_by_audio_level,
+    size_t num_decode_threads)
     : output_rate_calculator_(std::move(output_rate_calculator)),
+      select_sources_by_audio_level_(select_sources_by_audio_level),
       output_frequency_(0),
       sample_size_(0),
       audio_source_list_(),
+      decode_pool_(num_decode_threads > 0
+                       ? new AudioDecodePool(num_decode_threads)
+                       : nullptr),
       frame_combiner_(use_limiter) {}
 
 AudioMixerImpl::~AudioMixerImpl() {}
@@ -110,9 +167,26 @@ rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create() {
 rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
     std::unique_ptr<OutputRateCalculator> output_rate_calculator,
     bool use_limiter) {
+  return Create(std::move(output_rate_calculator), use_limiter, false);
+}
+
+rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    bool use_limiter,
+    bool select_sources_by_audio_level) {
+  return Create(std::move(output_rate_calculator), use_limiter,
+                select_sources_by_audio_level, 0);
+}
+
+rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    bool use_limiter,
+    bool select_sources_by_audio_level,
+    size_t num_decode_threads) {
   return rtc::scoped_refptr<AudioMixerImpl>(
       new rtc::RefCountedObject<AudioMixerImpl>(
-          std::move(output_rate_calculator), use_limiter));
+          std::move(output_rate_calculator), use_limiter,
+          select_sources_by_audio_level, num_decode_threads));
 }
 
 void AudioMixerImpl::Mix(size_t number_of_channels,
@@ -178,18 +252,43 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   std::vector<SourceFrame> audio_source_mixing_data_list;
   std::vector<SourceFrame> ramp_list;
 
-  // Get audio from the audio sources and put it in the SourceFrame vector.
-  for (auto& source_and_status : audio_source_list_) {
-    const auto audio_frame_info =
+  std::vector<SourceStatus*> sources_to_pull;
+  if (select_sources_by_audio_level_) {
+    sources_to_pull = SelectSourcesByAudioLevel(
+        audio_source_list_, kMaximumAmountOfMixedAudioSources);
+  } else {
+    for (auto& source_and_status : audio_source_list_) {
+      sources_to_pull.push_back(source_and_status.get());
+    }
+  }
+
+  // Get audio from the audio sources, on the decode threads if there are any.
+  const int output_frequency = OutputFrequency();
+  std::vector<Source::AudioFrameInfo> audio_frame_infos(sources_to_pull.size());
+  auto get_audio = [&](size_t k) {
+    SourceStatus* const source_and_status = sources_to_pull[k];
+    audio_frame_infos[k] =
         source_and_status->audio_source->GetAudioFrameWithInfo(
-            OutputFrequency(), &source_and_status->audio_frame);
+            output_frequency, &source_and_status->audio_frame);
+  };
+  if (decode_pool_) {
+    decode_pool_->Run(sources_to_pull.size(), get_audio);
+  } else {
+    for (size_t k = 0; k < sources_to_pull.size(); ++k) {
+      get_audio(k);
+    }
+  }
 
+  // Put the audio in the SourceFrame vector.
+  for (size_t k = 0; k < sources_to_pull.size(); ++k) {
+    SourceStatus* const source_and_status = sources_to_pull[k];
+    const Source::AudioFrameInfo audio_frame_info = audio_frame_infos[k];
     if (audio_frame_info == Source::AudioFrameInfo::kError) {
       RTC_LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
       continue;
     }
     audio_source_mixing_data_list.emplace_back(
-        source_and_status.get(), &source_and_status->audio_frame,
+        source_and_status, &source_and_status->audio_frame,
         audio_frame_info == Source::AudioFrameInfo::kMuted);
   }
 
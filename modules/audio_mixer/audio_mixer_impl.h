@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "api/audio/audio_mixer.h"
+#include "modules/audio_mixer/audio_decode_pool.h"
 #include "modules/audio_mixer/frame_combiner.h"
 #include "modules/audio_mixer/output_rate_calculator.h"
 #include "rtc_base/race_checker.h"
@@ -50,6 +51,26 @@ class AudioMixerImpl : public AudioMixer {
       std::unique_ptr<OutputRateCalculator> output_rate_calculator,
       bool use_limiter);
 
+  // With |select_sources_by_audio_level|, only the sources with the highest
+  // received audio levels (see Source::ReceivedAudioLevel()) and the ones
+  // with an unknown level are asked for audio, which saves decoding the
+  // sources that would not be mixed anyway during large calls. The sources
+  // that are not asked for audio must tolerate the gaps.
+  static rtc::scoped_refptr<AudioMixerImpl> Create(
+      std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+      bool use_limiter,
+      bool select_sources_by_audio_level);
+
+  // With |num_decode_threads| > 0, the sources are asked for audio in parallel
+  // on a pool of that many threads and on the mixing thread, before the audio
+  // is mixed. The sources must then allow GetAudioFrameWithInfo() to be called
+  // on any of these threads, concurrently with the other sources.
+  static rtc::scoped_refptr<AudioMixerImpl> Create(
+      std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+      bool use_limiter,
+      bool select_sources_by_audio_level,
+      size_t num_decode_threads);
+
   ~AudioMixerImpl() override;
 
   // AudioMixer functions
@@ -67,7 +88,9 @@ class AudioMixerImpl : public AudioMixer {
 
  protected:
   AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
-                 bool use_limiter);
+                 bool use_limiter,
+                 bool select_sources_by_audio_level,
+                 size_t num_decode_threads);
 
  private:
   // Set mixing frequency through OutputFrequencyCalculator.
@@ -94,6 +117,7 @@ class AudioMixerImpl : public AudioMixer {
   rtc::RaceChecker race_checker_;
 
   std::unique_ptr<OutputRateCalculator> output_rate_calculator_;
+  const bool select_sources_by_audio_level_;
   // The current sample frequency and sample size when mixing.
   int output_frequency_ RTC_GUARDED_BY(race_checker_);
   size_t sample_size_ RTC_GUARDED_BY(race_checker_);
@@ -101,6 +125,10 @@ class AudioMixerImpl : public AudioMixer {
   // List of all audio sources. Note all lists are disjunct
   SourceStatusList audio_source_list_ RTC_GUARDED_BY(crit_);  // May be mixed.
 
+  // Asks the sources for audio in parallel. Null if there are no decode
+  // threads.
+  const std::unique_ptr<AudioDecodePool> decode_pool_;
+
   // Component that handles actual adding of audio frames.
   FrameCombiner frame_combiner_ RTC_GUARDED_BY(race_checker_);
 
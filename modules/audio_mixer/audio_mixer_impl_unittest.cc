@@ -77,6 +77,7 @@ class MockMixerAudioSource : public testing::NiceMock<AudioMixer::Source> {
 
   MOCK_CONST_METHOD0(PreferredSampleRate, int());
   MOCK_CONST_METHOD0(Ssrc, int());
+  MOCK_CONST_METHOD0(ReceivedAudioLevel, absl::optional<AudioLevel>());
 
   AudioFrame* fake_frame() { return &fake_frame_; }
   AudioFrameInfo fake_info() { return fake_audio_frame_info_; }
@@ -142,6 +143,19 @@ void MixAndCompare(
   }
 }
 
+rtc::scoped_refptr<AudioMixerImpl> CreateMixerSelectingByAudioLevel() {
+  return AudioMixerImpl::Create(
+      std::unique_ptr<OutputRateCalculator>(new DefaultOutputRateCalculator()),
+      true, true);
+}
+
+void SetReceivedAudioLevel(MockMixerAudioSource* source, int level_dbov) {
+  AudioMixer::Source::AudioLevel audio_level;
+  audio_level.level_dbov = level_dbov;
+  audio_level.voice_activity = true;
+  ON_CALL(*source, ReceivedAudioLevel()).WillByDefault(Return(audio_level));
+}
+
 void MixMonoAtGivenNativeRate(int native_sample_rate,
                               AudioFrame* mix_frame,
                               rtc::scoped_refptr<AudioMixer> mixer,
@@ -530,4 +544,108 @@ TEST(AudioMixer, AnyRateIsPossibleWithNoLimiter) {
     }
   }
 }
+
+TEST(AudioMixer, OnlyLoudestSourcesArePulledWhenSelectingByAudioLevel) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources + 3;
+  const auto mixer = CreateMixerSelectingByAudioLevel();
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->mutable_data()[0] = 100;
+    // The lower the level in -dBov, the louder the source.
+    SetReceivedAudioLevel(&participants[i], 10 * (kAudioSources - i));
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    const bool loudest =
+        i >= kAudioSources - AudioMixerImpl::kMaximumAmountOfMixedAudioSources;
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(_, _))
+        .Times(Exactly(loudest ? 1 : 0));
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    const bool loudest =
+        i >= kAudioSources - AudioMixerImpl::kMaximumAmountOfMixedAudioSources;
+    EXPECT_EQ(loudest, mixer->GetAudioSourceMixabilityStatusForTest(
+                           &participants[i]))
+        << "Mixed status of AudioSource #" << i << " wrong.";
+  }
+}
+
+TEST(AudioMixer, SourcesWithUnknownAudioLevelArePulled) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources + 1;
+  const auto mixer = CreateMixerSelectingByAudioLevel();
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(_, _))
+        .Times(Exactly(1));
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+}
+
+TEST(AudioMixer, AudioLevelSelectionFavorsMixedSources) {
+  constexpr int kAudioSources =
+      AudioMixerImpl::kMaximumAmountOfMixedAudioSources + 1;
+  constexpr int kQuietest = kAudioSources - 1;
+  const auto mixer = CreateMixerSelectingByAudioLevel();
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->mutable_data()[0] = 100;
+    SetReceivedAudioLevel(&participants[i], 20 + 10 * i);
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+  mixer->Mix(1, &frame_for_mixing);
+  EXPECT_FALSE(
+      mixer->GetAudioSourceMixabilityStatusForTest(&participants[kQuietest]));
+
+  // Slightly louder than the quietest mixed source is not enough.
+  SetReceivedAudioLevel(&participants[kQuietest], 10 * kAudioSources - 2);
+  mixer->Mix(1, &frame_for_mixing);
+  EXPECT_FALSE(
+      mixer->GetAudioSourceMixabilityStatusForTest(&participants[kQuietest]));
+  EXPECT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(
+      &participants[kQuietest - 1]));
+
+  // Clearly louder than the quietest mixed source replaces it.
+  SetReceivedAudioLevel(&participants[kQuietest], 10);
+  mixer->Mix(1, &frame_for_mixing);
+  EXPECT_TRUE(
+      mixer->GetAudioSourceMixabilityStatusForTest(&participants[kQuietest]));
+  EXPECT_FALSE(mixer->GetAudioSourceMixabilityStatusForTest(
+      &participants[kQuietest - 1]));
+}
+
+TEST(AudioMixer, SourcesArePulledOnDecodeThreads) {
+  constexpr int kAudioSources = 10;
+  const auto mixer = AudioMixerImpl::Create(
+      std::unique_ptr<OutputRateCalculator>(new DefaultOutputRateCalculator()),
+      true, false, 3);
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->mutable_data()[0] = 100 * (i + 1);
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(kDefaultSampleRateHz, _))
+        .Times(Exactly(2));
+  }
+
+  for (int k = 0; k < 2; ++k) {
+    mixer->Mix(1, &frame_for_mixing);
+  }
+
+  // The loudest sources are mixed, like when pulling on the mixing thread.
+  for (int i = 0; i < kAudioSources; ++i) {
+    const bool loudest =
+        i >= kAudioSources - AudioMixerImpl::kMaximumAmountOfMixedAudioSources;
+    EXPECT_EQ(loudest,
+              mixer->GetAudioSourceMixabilityStatusForTest(&participants[i]))
+        << "Mixed status of AudioSource #" << i << " wrong.";
+  }
+}
 }  // namespace webrtc
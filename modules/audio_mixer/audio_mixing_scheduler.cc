@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/audio_mixing_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/types/optional.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int64_t kTickDurationUs =
+    AudioMixingScheduler::kTickDurationMs * rtc::kNumMicrosecsPerMillisec;
+
+// Once a worker is this many ticks behind, it drops the missed ticks instead
+// of mixing them back to back.
+constexpr int64_t kMaxNumLateTicks = 5;
+
+}  // namespace
+
+class AudioMixingScheduler::Worker {
+ public:
+  Worker(int64_t start_time_us,
+         absl::optional<int> cpu,
+         rtc::ThreadPriority priority)
+      : start_time_us_(start_time_us),
+        cpu_(cpu),
+        stop_event_(false, false),
+        thread_(&Worker::Run, this, "AudioMixingWorker", priority) {
+    thread_.Start();
+  }
+
+  ~Worker() {
+    stop_event_.Set();
+    thread_.Stop();
+  }
+
+  void AddMixer(rtc::scoped_refptr<AudioMixer> mixer,
+                size_t num_channels,
+                Sink* sink) {
+    rtc::CritScope lock(&crit_);
+    mixers_.push_back({std::move(mixer), num_channels, sink});
+  }
+
+  bool RemoveMixer(AudioMixer* mixer) {
+    rtc::CritScope lock(&crit_);
+    auto it = std::find_if(mixers_.begin(), mixers_.end(),
+                           [mixer](const MixerEntry& entry) {
+                             return entry.mixer.get() == mixer;
+                           });
+    if (it == mixers_.end()) {
+      return false;
+    }
+    mixers_.erase(it);
+    return true;
+  }
+
+  size_t num_mixers() const {
+    rtc::CritScope lock(&crit_);
+    return mixers_.size();
+  }
+
+  Stats stats() const {
+    rtc::CritScope lock(&crit_);
+    return stats_;
+  }
+
+ private:
+  struct MixerEntry {
+    rtc::scoped_refptr<AudioMixer> mixer;
+    size_t num_channels;
+    Sink* sink;
+  };
+
+  static void Run(void* obj) { static_cast<Worker*>(obj)->Run(); }
+
+  void Run() {
+    if (cpu_ && !rtc::SetCurrentThreadCpuAffinity({*cpu_})) {
+      RTC_LOG(LS_WARNING) << "Failed to pin the audio mixing thread to CPU "
+                          << *cpu_;
+    }
+
+    for (int64_t tick = 1;; ++tick) {
+      const int64_t deadline_us = start_time_us_ + tick * kTickDurationUs;
+      int64_t now_us = rtc::TimeMicros();
+      const int wait_ms =
+          deadline_us > now_us
+              ? rtc::dchecked_cast<int>(
+                    (deadline_us - now_us + rtc::kNumMicrosecsPerMillisec - 1) /
+                    rtc::kNumMicrosecsPerMillisec)
+              : 0;
+      if (stop_event_.Wait(wait_ms)) {
+        return;
+      }
+
+      int64_t num_skipped_ticks = 0;
+      now_us = rtc::TimeMicros();
+      if (now_us - deadline_us > kMaxNumLateTicks * kTickDurationUs) {
+        num_skipped_ticks = (now_us - deadline_us) / kTickDurationUs;
+        tick += num_skipped_ticks;
+      }
+
+      rtc::CritScope lock(&crit_);
+      for (const MixerEntry& entry : mixers_) {
+        entry.mixer->Mix(entry.num_channels, &mixed_audio_);
+        entry.sink->OnMixedAudio(mixed_audio_);
+      }
+
+      const int64_t end_us = rtc::TimeMicros();
+      ++stats_.num_ticks;
+      stats_.num_skipped_ticks += num_skipped_ticks;
+      stats_.max_tick_duration_us =
+          std::max(stats_.max_tick_duration_us, end_us - now_us);
+      const int64_t next_deadline_us =
+          start_time_us_ + (tick + 1) * kTickDurationUs;
+      if (end_us > next_deadline_us) {
+        ++stats_.num_overruns;
+      }
+    }
+  }
+
+  const int64_t start_time_us_;
+  const absl::optional<int> cpu_;
+  rtc::CriticalSection crit_;
+  std::vector<MixerEntry> mixers_ RTC_GUARDED_BY(crit_);
+  Stats stats_ RTC_GUARDED_BY(crit_);
+  // Only used on the worker thread.
+  AudioFrame mixed_audio_;
+  rtc::Event stop_event_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+AudioMixingScheduler::Config::Config() = default;
+AudioMixingScheduler::Config::Config(const Config&) = default;
+AudioMixingScheduler::Config::~Config() = default;
+
+constexpr int AudioMixingScheduler::kTickDurationMs;
+
+AudioMixingScheduler::AudioMixingScheduler(const Config& config) {
+  RTC_DCHECK_LT(0, config.num_worker_threads);
+  const int64_t start_time_us = rtc::TimeMicros();
+  for (size_t k = 0; k < config.num_worker_threads; ++k) {
+    absl::optional<int> cpu;
+    if (!config.cpu_affinity.empty()) {
+      cpu = config.cpu_affinity[k % config.cpu_affinity.size()];
+    }
+    workers_.emplace_back(new Worker(start_time_us, cpu, config.priority));
+  }
+}
+
+AudioMixingScheduler::~AudioMixingScheduler() = default;
+
+void AudioMixingScheduler::AddMixer(rtc::scoped_refptr<AudioMixer> mixer,
+                                    size_t num_channels,
+                                    Sink* sink) {
+  RTC_DCHECK(mixer);
+  RTC_DCHECK(sink);
+  RTC_DCHECK(num_channels == 1 || num_channels == 2);
+  auto least_loaded_worker = std::min_element(
+      workers_.begin(), workers_.end(),
+      [](const std::unique_ptr<Worker>& a, const std::unique_ptr<Worker>& b) {
+        return a->num_mixers() < b->num_mixers();
+      });
+  (*least_loaded_worker)->AddMixer(std::move(mixer), num_channels, sink);
+}
+
+void AudioMixingScheduler::RemoveMixer(AudioMixer* mixer) {
+  for (auto& worker : workers_) {
+    if (worker->RemoveMixer(mixer)) {
+      return;
+    }
+  }
+  RTC_NOTREACHED() << "Mixer not present in the scheduler";
+}
+
+AudioMixingScheduler::Stats AudioMixingScheduler::GetStats() const {
+  Stats stats;
+  for (const auto& worker : workers_) {
+    const Stats worker_stats = worker->stats();
+    stats.num_ticks += worker_stats.num_ticks;
+    stats.num_overruns += worker_stats.num_overruns;
+    stats.num_skipped_ticks += worker_stats.num_skipped_ticks;
+    stats.max_tick_duration_us =
+        std::max(stats.max_tick_duration_us, worker_stats.max_tick_duration_us);
+  }
+  return stats;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_AUDIO_MIXING_SCHEDULER_H_
+#define MODULES_AUDIO_MIXER_AUDIO_MIXING_SCHEDULER_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "api/audio/audio_mixer.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+namespace webrtc {
+
+// Drives many independent audio mixers from one clock, instead of one timer
+// thread per mixer. The mixers are spread over a pool of worker threads. On
+// every 10 ms tick, each worker mixes all of its mixers and passes the mixed
+// audio to their sinks. The ticks of all the workers are aligned to the time
+// at which the scheduler was created.
+class AudioMixingScheduler {
+ public:
+  // Receives the mixed audio of a mixer, on the thread of its worker.
+  class Sink {
+   public:
+    virtual void OnMixedAudio(const AudioFrame& mixed_audio) = 0;
+
+   protected:
+    virtual ~Sink() {}
+  };
+
+  struct Config {
+    Config();
+    Config(const Config&);
+    ~Config();
+
+    size_t num_worker_threads = 1;
+    // If not empty, worker thread k is pinned to the CPU
+    // |cpu_affinity[k % cpu_affinity.size()]|. Only supported on Linux and
+    // Android.
+    std::vector<int> cpu_affinity;
+    rtc::ThreadPriority priority = rtc::kRealtimePriority;
+  };
+
+  // Counters summed over all the workers.
+  struct Stats {
+    int64_t num_ticks = 0;
+    // Ticks that were not done mixing when the next tick was due.
+    int64_t num_overruns = 0;
+    // Ticks that were dropped to catch up after falling far behind.
+    int64_t num_skipped_ticks = 0;
+    // The longest time that a worker has spent mixing one tick.
+    int64_t max_tick_duration_us = 0;
+  };
+
+  static constexpr int kTickDurationMs = 10;
+
+  explicit AudioMixingScheduler(const Config& config);
+  ~AudioMixingScheduler();
+
+  // Adds |mixer| to the worker with the fewest mixers. From the next tick on,
+  // |mixer| is mixed into |num_channels| channels and |sink| receives the
+  // result. A mixer may only be added once.
+  void AddMixer(rtc::scoped_refptr<AudioMixer> mixer,
+                size_t num_channels,
+                Sink* sink);
+
+  // Removes |mixer|. Once this returns, its sink is no longer called.
+  void RemoveMixer(AudioMixer* mixer);
+
+  Stats GetStats() const;
+
+ private:
+  class Worker;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixingScheduler);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_AUDIO_MIXING_SCHEDULER_H_
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/audio_mixing_scheduler.h"
+
+#include <vector>
+
+#include "modules/audio_mixer/audio_mixer_impl.h"
+#include "rtc_base/atomicops.h"
+#include "rtc_base/event.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumTicksToWaitFor = 5;
+constexpr int kTimeoutMs = 5000;
+
+class CountingSink : public AudioMixingScheduler::Sink {
+ public:
+  CountingSink() : done_(false, false) {}
+
+  void OnMixedAudio(const AudioFrame& mixed_audio) override {
+    num_channels_ = mixed_audio.num_channels_;
+    if (rtc::AtomicOps::Increment(&num_calls_) == kNumTicksToWaitFor) {
+      done_.Set();
+    }
+  }
+
+  bool WaitForTicks() { return done_.Wait(kTimeoutMs); }
+  int num_calls() const { return rtc::AtomicOps::AcquireLoad(&num_calls_); }
+  size_t num_channels() const { return num_channels_; }
+
+ private:
+  volatile int num_calls_ = 0;
+  size_t num_channels_ = 0;
+  rtc::Event done_;
+};
+
+}  // namespace
+
+TEST(AudioMixingScheduler, MixesAllMixersOverTheWorkers) {
+  AudioMixingScheduler::Config config;
+  config.num_worker_threads = 2;
+  config.priority = rtc::kNormalPriority;
+  AudioMixingScheduler scheduler(config);
+
+  constexpr size_t kNumMixers = 5;
+  std::vector<rtc::scoped_refptr<AudioMixerImpl>> mixers;
+  std::vector<CountingSink> sinks(kNumMixers);
+  for (size_t k = 0; k < kNumMixers; ++k) {
+    mixers.push_back(AudioMixerImpl::Create());
+    scheduler.AddMixer(mixers[k], 1 + k % 2, &sinks[k]);
+  }
+
+  for (size_t k = 0; k < kNumMixers; ++k) {
+    EXPECT_TRUE(sinks[k].WaitForTicks());
+    EXPECT_EQ(1 + k % 2, sinks[k].num_channels());
+  }
+  for (size_t k = 0; k < kNumMixers; ++k) {
+    scheduler.RemoveMixer(mixers[k].get());
+  }
+
+  EXPECT_LE(kNumTicksToWaitFor, scheduler.GetStats().num_ticks);
+}
+
+TEST(AudioMixingScheduler, RemovedMixerIsNotMixed) {
+  AudioMixingScheduler::Config config;
+  config.priority = rtc::kNormalPriority;
+  AudioMixingScheduler scheduler(config);
+
+  rtc::scoped_refptr<AudioMixerImpl> mixer = AudioMixerImpl::Create();
+  CountingSink sink;
+  scheduler.AddMixer(mixer, 1, &sink);
+  EXPECT_TRUE(sink.WaitForTicks());
+  scheduler.RemoveMixer(mixer.get());
+
+  const int num_calls = sink.num_calls();
+  rtc::Event wait(false, false);
+  wait.Wait(3 * AudioMixingScheduler::kTickDurationMs);
+  EXPECT_EQ(num_calls, sink.num_calls());
+}
+
+}  // namespace webrtc
@@ -10,6 +10,15 @@
 
 #include "modules/audio_mixer/frame_combiner.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <algorithm>
 #include <array>
 #include <functional>
@@ -34,6 +43,8 @@ constexpr int kMaximumAmountOfChannels = 2;
 constexpr int kMaximumChannelSize = 48 * AudioMixerImpl::kFrameDurationInMs;
 
 using OneChannelBuffer = std::array<float, kMaximumChannelSize>;
+using InterleavedBuffer =
+    std::array<float, kMaximumAmountOfChannels * kMaximumChannelSize>;
 
 void SetAudioFrameFields(const std::vector<AudioFrame*>& mix_list,
                          size_t number_of_channels,
@@ -72,23 +83,92 @@ void MixFewFramesWithNoLimiter(const std::vector<AudioFrame*>& mix_list,
             audio_frame_for_mixing->mutable_data());
 }
 
-std::array<OneChannelBuffer, kMaximumAmountOfChannels> MixToFloatFrame(
-    const std::vector<AudioFrame*>& mix_list,
-    size_t samples_per_channel,
-    size_t number_of_channels) {
-  // Convert to FloatS16 and mix.
-  using OneChannelBuffer = std::array<float, kMaximumChannelSize>;
-  std::array<OneChannelBuffer, kMaximumAmountOfChannels> mixing_buffer{};
-
-  for (size_t i = 0; i < mix_list.size(); ++i) {
-    const AudioFrame* const frame = mix_list[i];
-    for (size_t j = 0; j < number_of_channels; ++j) {
-      for (size_t k = 0; k < samples_per_channel; ++k) {
-        mixing_buffer[j][k] += frame->data()[number_of_channels * k + j];
-      }
-    }
+// Adds the int16 samples in |src| to the FloatS16 samples in |dst|. Sums of
+// int16 samples are exactly representable in float, so the vectorized and the
+// scalar paths give identical results.
+void AccumulateS16(const int16_t* src, size_t size, float* dst) {
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  for (; k + 8 <= size; k += 8) {
+    const __m128i s =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[k]));
+    const __m128i sign = _mm_srai_epi16(s, 15);
+    const __m128 s_low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(s, sign));
+    const __m128 s_high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(s, sign));
+    _mm_storeu_ps(&dst[k], _mm_add_ps(_mm_loadu_ps(&dst[k]), s_low));
+    _mm_storeu_ps(&dst[k + 4], _mm_add_ps(_mm_loadu_ps(&dst[k + 4]), s_high));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; k + 8 <= size; k += 8) {
+    const int16x8_t s = vld1q_s16(&src[k]);
+    const float32x4_t s_low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+    const float32x4_t s_high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+    vst1q_f32(&dst[k], vaddq_f32(vld1q_f32(&dst[k]), s_low));
+    vst1q_f32(&dst[k + 4], vaddq_f32(vld1q_f32(&dst[k + 4]), s_high));
+  }
+#endif
+  for (; k < size; ++k) {
+    dst[k] += src[k];
+  }
+}
+
+// Rounds and saturates FloatS16 samples to int16. Bit-exact with
+// FloatS16ToS16(): the samples are clamped to the int16 range, offset by 0.5
+// away from zero and truncated.
+void FloatS16ToS16Saturated(const float* src, size_t size, int16_t* dst) {
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 max = _mm_set1_ps(limits_int16::max());
+  const __m128 min = _mm_set1_ps(limits_int16::min());
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 minus_half = _mm_set1_ps(-0.5f);
+  auto round = [&](__m128 v) {
+    v = _mm_max_ps(_mm_min_ps(v, max), min);
+    const __m128 positive = _mm_cmpgt_ps(v, zero);
+    const __m128 offset = _mm_or_ps(_mm_and_ps(positive, half),
+                                    _mm_andnot_ps(positive, minus_half));
+    return _mm_cvttps_epi32(_mm_add_ps(v, offset));
+  };
+  for (; k + 8 <= size; k += 8) {
+    const __m128i low = round(_mm_loadu_ps(&src[k]));
+    const __m128i high = round(_mm_loadu_ps(&src[k + 4]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&dst[k]),
+                     _mm_packs_epi32(low, high));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  const float32x4_t max = vdupq_n_f32(limits_int16::max());
+  const float32x4_t min = vdupq_n_f32(limits_int16::min());
+  const float32x4_t zero = vdupq_n_f32(0.f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t minus_half = vdupq_n_f32(-0.5f);
+  auto round = [&](float32x4_t v) {
+    v = vmaxq_f32(vminq_f32(v, max), min);
+    const float32x4_t offset = vbslq_f32(vcgtq_f32(v, zero), half, minus_half);
+    return vqmovn_s32(vcvtq_s32_f32(vaddq_f32(v, offset)));
+  };
+  for (; k + 8 <= size; k += 8) {
+    vst1q_s16(&dst[k], vcombine_s16(round(vld1q_f32(&src[k])),
+                                    round(vld1q_f32(&src[k + 4]))));
+  }
+#endif
+  for (; k < size; ++k) {
+    dst[k] = FloatS16ToS16(src[k]);
+  }
+}
+
+// Mixes the frames in |mix_list| into |interleaved_buffer|, which keeps the
+// channel layout of the frames.
+void MixToFloatFrame(const std::vector<AudioFrame*>& mix_list,
+                     size_t samples_per_channel,
+                     size_t number_of_channels,
+                     InterleavedBuffer* interleaved_buffer) {
+  const size_t size = samples_per_channel * number_of_channels;
+  std::fill(interleaved_buffer->begin(), interleaved_buffer->begin() + size,
+            0.f);
+  for (const AudioFrame* const frame : mix_list) {
+    AccumulateS16(frame->data(), size, interleaved_buffer->data());
   }
-  return mixing_buffer;
 }
 
 void RunLimiter(AudioFrameView<float> mixing_buffer_view,
@@ -99,18 +179,14 @@ void RunLimiter(AudioFrameView<float> mixing_buffer_view,
   limiter->Process(mixing_buffer_view);
 }
 
-// Both interleaves and rounds.
-void InterleaveToAudioFrame(AudioFrameView<const float> mixing_buffer_view,
-                            AudioFrame* audio_frame_for_mixing) {
-  const size_t number_of_channels = mixing_buffer_view.num_channels();
-  const size_t samples_per_channel = mixing_buffer_view.samples_per_channel();
-  // Put data in the result frame.
-  for (size_t i = 0; i < number_of_channels; ++i) {
-    for (size_t j = 0; j < samples_per_channel; ++j) {
-      audio_frame_for_mixing->mutable_data()[number_of_channels * j + i] =
-          FloatS16ToS16(mixing_buffer_view.channel(i)[j]);
-    }
-  }
+// Rounds the mixed audio and puts it in the result frame.
+void ToAudioFrame(const InterleavedBuffer& interleaved_buffer,
+                  size_t samples_per_channel,
+                  size_t number_of_channels,
+                  AudioFrame* audio_frame_for_mixing) {
+  FloatS16ToS16Saturated(interleaved_buffer.data(),
+                         samples_per_channel * number_of_channels,
+                         audio_frame_for_mixing->mutable_data());
 }
 }  // namespace
 
@@ -154,22 +230,45 @@ void FrameCombiner::Combine(const std::vector<AudioFrame*>& mix_list,
     return;
   }
 
-  std::array<OneChannelBuffer, kMaximumAmountOfChannels> mixing_buffer =
-      MixToFloatFrame(mix_list, samples_per_channel, number_of_channels);
-
-  // Put float data in an AudioFrameView.
-  std::array<float*, kMaximumAmountOfChannels> channel_pointers{};
-  for (size_t i = 0; i < number_of_channels; ++i) {
-    channel_pointers[i] = &mixing_buffer[i][0];
-  }
-  AudioFrameView<float> mixing_buffer_view(
-      &channel_pointers[0], number_of_channels, samples_per_channel);
+  // The frames are mixed in their interleaved layout, so that whole frames
+  // can be accumulated with vector instructions. Mono frames are already
+  // planar and are passed to the limiter as they are.
+  InterleavedBuffer interleaved_buffer;
+  MixToFloatFrame(mix_list, samples_per_channel, number_of_channels,
+                  &interleaved_buffer);
 
   if (use_limiter_) {
+    std::array<OneChannelBuffer, kMaximumAmountOfChannels> mixing_buffer;
+    std::array<float*, kMaximumAmountOfChannels> channel_pointers{};
+    if (number_of_channels == 1) {
+      channel_pointers[0] = interleaved_buffer.data();
+    } else {
+      for (size_t i = 0; i < number_of_channels; ++i) {
+        channel_pointers[i] = &mixing_buffer[i][0];
+        for (size_t j = 0; j < samples_per_channel; ++j) {
+          mixing_buffer[i][j] =
+              interleaved_buffer[number_of_channels * j + i];
+        }
+      }
+    }
+
+    // Put float data in an AudioFrameView.
+    AudioFrameView<float> mixing_buffer_view(
+        &channel_pointers[0], number_of_channels, samples_per_channel);
     RunLimiter(mixing_buffer_view, &limiter_);
+
+    if (number_of_channels > 1) {
+      for (size_t i = 0; i < number_of_channels; ++i) {
+        for (size_t j = 0; j < samples_per_channel; ++j) {
+          interleaved_buffer[number_of_channels * j + i] =
+              mixing_buffer[i][j];
+        }
+      }
+    }
   }
 
-  InterleaveToAudioFrame(mixing_buffer_view, audio_frame_for_mixing);
+  ToAudioFrame(interleaved_buffer, samples_per_channel, number_of_channels,
+               audio_frame_for_mixing);
 }
 
 void FrameCombiner::LogMixingStats(const std::vector<AudioFrame*>& mix_list,
@@ -18,6 +18,7 @@
 #include "modules/audio_mixer/gain_change_calculator.h"
 #include "modules/audio_mixer/sine_wave_generator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/numerics/safe_conversions.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -152,6 +153,36 @@ TEST(FrameCombiner, CombiningOneFrameShouldNotChangeFrame) {
   }
 }
 
+TEST(FrameCombiner, CombiningTwoFramesWithoutLimiterSaturatesTheSum) {
+  FrameCombiner combiner(false);
+  for (const int rate : {8000, 10000, 11000, 32000, 44100}) {
+    for (const int number_of_channels : {1, 2}) {
+      SCOPED_TRACE(ProduceDebugText(rate, number_of_channels, 2));
+
+      SetUpFrames(rate, number_of_channels);
+      const size_t size = number_of_channels * rate / 100;
+      int16_t* frame1_data = frame1.mutable_data();
+      int16_t* frame2_data = frame2.mutable_data();
+      std::vector<int16_t> expected(size);
+      for (size_t i = 0; i < size; ++i) {
+        frame1_data[i] = static_cast<int16_t>(i * 397 - 20000);
+        frame2_data[i] = static_cast<int16_t>(15000 - i * 211);
+        expected[i] = rtc::saturated_cast<int16_t>(
+            static_cast<int>(frame1_data[i]) + frame2_data[i]);
+      }
+      const std::vector<AudioFrame*> frames_to_combine = {&frame1, &frame2};
+      combiner.Combine(frames_to_combine, number_of_channels, rate,
+                       frames_to_combine.size(), &audio_frame_for_mixing);
+
+      const int16_t* audio_frame_for_mixing_data =
+          audio_frame_for_mixing.data();
+      const std::vector<int16_t> mixed_data(
+          audio_frame_for_mixing_data, audio_frame_for_mixing_data + size);
+      EXPECT_EQ(mixed_data, expected);
+    }
+  }
+}
+
 // Send a sine wave through the FrameCombiner, and check that the
 // difference between input and output varies smoothly. Also check
 // that it is inside reasonable bounds. This is to catch issues like
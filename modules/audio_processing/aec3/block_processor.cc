@@ -9,6 +9,8 @@
  */
 #include "modules/audio_processing/aec3/block_processor.h"
 
+#include <utility>
+
 #include "absl/types/optional.h"
 #include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/block_processor_metrics.h"
@@ -29,7 +31,7 @@ class BlockProcessorImpl final : public BlockProcessor {
                      int sample_rate_hz,
                      std::unique_ptr<RenderDelayBuffer> render_buffer,
                      std::unique_ptr<RenderDelayController> delay_controller,
-                     std::unique_ptr<EchoRemover> echo_remover);
+                     std::vector<std::unique_ptr<EchoRemover>> echo_removers);
 
   ~BlockProcessorImpl() override;
 
@@ -37,6 +39,11 @@ class BlockProcessorImpl final : public BlockProcessor {
                       bool capture_signal_saturation,
                       std::vector<std::vector<float>>* capture_block) override;
 
+  void ProcessMultiChannelCapture(
+      bool echo_path_gain_change,
+      bool capture_signal_saturation,
+      std::vector<std::vector<std::vector<float>>>* capture_blocks) override;
+
   void BufferRender(const std::vector<std::vector<float>>& block) override;
 
   void UpdateEchoLeakageStatus(bool leakage_detected) override;
@@ -54,7 +61,10 @@ class BlockProcessorImpl final : public BlockProcessor {
   const size_t sample_rate_hz_;
   std::unique_ptr<RenderDelayBuffer> render_buffer_;
   std::unique_ptr<RenderDelayController> delay_controller_;
-  std::unique_ptr<EchoRemover> echo_remover_;
+  // One echo remover per capture channel.
+  std::vector<std::unique_ptr<EchoRemover>> echo_removers_;
+  // Holds the block passed to the single-channel ProcessCapture().
+  std::vector<std::vector<std::vector<float>>> mono_capture_blocks_;
   BlockProcessorMetrics metrics_;
   RenderDelayBuffer::BufferingEvent render_event_;
   size_t capture_call_counter_ = 0;
@@ -70,16 +80,18 @@ BlockProcessorImpl::BlockProcessorImpl(
     int sample_rate_hz,
     std::unique_ptr<RenderDelayBuffer> render_buffer,
     std::unique_ptr<RenderDelayController> delay_controller,
-    std::unique_ptr<EchoRemover> echo_remover)
+    std::vector<std::unique_ptr<EchoRemover>> echo_removers)
     : data_dumper_(
           new ApmDataDumper(rtc::AtomicOps::Increment(&instance_count_))),
       config_(config),
       sample_rate_hz_(sample_rate_hz),
       render_buffer_(std::move(render_buffer)),
       delay_controller_(std::move(delay_controller)),
-      echo_remover_(std::move(echo_remover)),
+      echo_removers_(std::move(echo_removers)),
+      mono_capture_blocks_(1),
       render_event_(RenderDelayBuffer::BufferingEvent::kNone) {
   RTC_DCHECK(ValidFullBandRate(sample_rate_hz_));
+  RTC_DCHECK(!echo_removers_.empty());
 }
 
 BlockProcessorImpl::~BlockProcessorImpl() = default;
@@ -89,8 +101,26 @@ void BlockProcessorImpl::ProcessCapture(
     bool capture_signal_saturation,
     std::vector<std::vector<float>>* capture_block) {
   RTC_DCHECK(capture_block);
-  RTC_DCHECK_EQ(NumBandsForRate(sample_rate_hz_), capture_block->size());
-  RTC_DCHECK_EQ(kBlockSize, (*capture_block)[0].size());
+  RTC_DCHECK_EQ(1u, echo_removers_.size());
+  // The block is swapped in and out, which avoids copying the samples.
+  mono_capture_blocks_[0].swap(*capture_block);
+  ProcessMultiChannelCapture(echo_path_gain_change, capture_signal_saturation,
+                             &mono_capture_blocks_);
+  mono_capture_blocks_[0].swap(*capture_block);
+}
+
+void BlockProcessorImpl::ProcessMultiChannelCapture(
+    bool echo_path_gain_change,
+    bool capture_signal_saturation,
+    std::vector<std::vector<std::vector<float>>>* capture_blocks) {
+  RTC_DCHECK(capture_blocks);
+  RTC_DCHECK_EQ(echo_removers_.size(), capture_blocks->size());
+  for (const auto& capture_block : *capture_blocks) {
+    RTC_DCHECK_EQ(NumBandsForRate(sample_rate_hz_), capture_block.size());
+    RTC_DCHECK_EQ(kBlockSize, capture_block[0].size());
+  }
+  // The render delay is estimated on the first channel.
+  std::vector<std::vector<float>>* capture_block = &(*capture_blocks)[0];
 
   capture_call_counter_++;
 
@@ -190,14 +220,17 @@ void BlockProcessorImpl::ProcessCapture(
     }
   }
 
-  // Remove the echo from the capture signal.
-  echo_remover_->ProcessCapture(
-      echo_path_variability, capture_signal_saturation, estimated_delay_,
-      render_buffer_->GetRenderBuffer(), capture_block);
+  // Remove the echo from the capture signal of each channel. The render
+  // buffer, and thereby the render spectra, are shared by all the channels.
+  for (size_t ch = 0; ch < echo_removers_.size(); ++ch) {
+    echo_removers_[ch]->ProcessCapture(
+        echo_path_variability, capture_signal_saturation, estimated_delay_,
+        render_buffer_->GetRenderBuffer(), &(*capture_blocks)[ch]);
+  }
 
   // Check to see if a refined delay estimate has been obtained from the echo
   // remover.
-  echo_remover_delay_ = echo_remover_->Delay();
+  echo_remover_delay_ = echo_removers_[0]->Delay();
 
   // Update the metrics.
   metrics_.UpdateCapture(false);
@@ -226,11 +259,13 @@ void BlockProcessorImpl::BufferRender(
 }
 
 void BlockProcessorImpl::UpdateEchoLeakageStatus(bool leakage_detected) {
-  echo_remover_->UpdateEchoLeakageStatus(leakage_detected);
+  for (auto& echo_remover : echo_removers_) {
+    echo_remover->UpdateEchoLeakageStatus(leakage_detected);
+  }
 }
 
 void BlockProcessorImpl::GetMetrics(EchoControl::Metrics* metrics) const {
-  echo_remover_->GetMetrics(metrics);
+  echo_removers_[0]->GetMetrics(metrics);
   const int block_size_ms = sample_rate_hz_ == 8000 ? 8 : 4;
   absl::optional<size_t> delay = render_buffer_->Delay();
   metrics->delay_ms = delay ? static_cast<int>(*delay) * block_size_ms : 0;
@@ -244,16 +279,26 @@ void BlockProcessorImpl::SetAudioBufferDelay(size_t delay_ms) {
 
 BlockProcessor* BlockProcessor::Create(const EchoCanceller3Config& config,
                                        int sample_rate_hz) {
+  return Create(config, sample_rate_hz, 1);
+}
+
+BlockProcessor* BlockProcessor::Create(const EchoCanceller3Config& config,
+                                       int sample_rate_hz,
+                                       size_t num_capture_channels) {
+  RTC_DCHECK_LT(0, num_capture_channels);
   std::unique_ptr<RenderDelayBuffer> render_buffer(
       RenderDelayBuffer::Create(config, NumBandsForRate(sample_rate_hz)));
   std::unique_ptr<RenderDelayController> delay_controller(
       RenderDelayController::Create(
           config, RenderDelayBuffer::DelayEstimatorOffset(config),
           sample_rate_hz));
-  std::unique_ptr<EchoRemover> echo_remover(
-      EchoRemover::Create(config, sample_rate_hz));
-  return Create(config, sample_rate_hz, std::move(render_buffer),
-                std::move(delay_controller), std::move(echo_remover));
+  std::vector<std::unique_ptr<EchoRemover>> echo_removers;
+  for (size_t ch = 0; ch < num_capture_channels; ++ch) {
+    echo_removers.emplace_back(EchoRemover::Create(config, sample_rate_hz));
+  }
+  return new BlockProcessorImpl(
+      config, sample_rate_hz, std::move(render_buffer),
+      std::move(delay_controller), std::move(echo_removers));
 }
 
 BlockProcessor* BlockProcessor::Create(
@@ -276,9 +321,11 @@ BlockProcessor* BlockProcessor::Create(
     std::unique_ptr<RenderDelayBuffer> render_buffer,
     std::unique_ptr<RenderDelayController> delay_controller,
     std::unique_ptr<EchoRemover> echo_remover) {
+  std::vector<std::unique_ptr<EchoRemover>> echo_removers;
+  echo_removers.push_back(std::move(echo_remover));
   return new BlockProcessorImpl(
       config, sample_rate_hz, std::move(render_buffer),
-      std::move(delay_controller), std::move(echo_remover));
+      std::move(delay_controller), std::move(echo_removers));
 }
 
 }  // namespace webrtc
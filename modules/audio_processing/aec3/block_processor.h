@@ -25,6 +25,11 @@ class BlockProcessor {
  public:
   static BlockProcessor* Create(const EchoCanceller3Config& config,
                                 int sample_rate_hz);
+  // Creates a processor for |num_capture_channels| capture channels, which
+  // share the render buffering and the delay estimation.
+  static BlockProcessor* Create(const EchoCanceller3Config& config,
+                                int sample_rate_hz,
+                                size_t num_capture_channels);
   // Only used for testing purposes.
   static BlockProcessor* Create(
       const EchoCanceller3Config& config,
@@ -51,6 +56,14 @@ class BlockProcessor {
       bool capture_signal_saturation,
       std::vector<std::vector<float>>* capture_block) = 0;
 
+  // Processes a block of capture data for each of the capture channels. The
+  // render delay is estimated on the first channel, and the echo is removed
+  // from all the channels using the same delayed render signal.
+  virtual void ProcessMultiChannelCapture(
+      bool echo_path_gain_change,
+      bool capture_signal_saturation,
+      std::vector<std::vector<std::vector<float>>>* capture_blocks) = 0;
+
   // Buffers a block of render data supplied by a FrameBlocker object.
   virtual void BufferRender(
       const std::vector<std::vector<float>>& render_block) = 0;
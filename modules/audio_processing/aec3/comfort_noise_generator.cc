@@ -208,6 +208,7 @@ void ComfortNoiseGenerator::Compute(
   switch (optimization_) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
     case Aec3Optimization::kSse2:
+    case Aec3Optimization::kAvx2:
       aec3::EstimateComfortNoise_SSE2(N2, &seed_, lower_band_noise,
                                       upper_band_noise);
       break;
@@ -131,13 +131,14 @@ EchoCanceller3Config AdjustConfig(const EchoCanceller3Config& config) {
 
 void FillSubFrameView(AudioBuffer* frame,
                       size_t sub_frame_index,
+                      size_t channel,
                       std::vector<rtc::ArrayView<float>>* sub_frame_view) {
   RTC_DCHECK_GE(1, sub_frame_index);
   RTC_DCHECK_LE(0, sub_frame_index);
   RTC_DCHECK_EQ(frame->num_bands(), sub_frame_view->size());
   for (size_t k = 0; k < sub_frame_view->size(); ++k) {
     (*sub_frame_view)[k] = rtc::ArrayView<float>(
-        &frame->split_bands_f(0)[k][sub_frame_index * kSubFrameLength],
+        &frame->split_bands_f(channel)[k][sub_frame_index * kSubFrameLength],
         kSubFrameLength);
   }
 }
@@ -153,38 +154,67 @@ void FillSubFrameView(std::vector<std::vector<float>>* frame,
   }
 }
 
+// Passes one block per capture channel to the block processor. The
+// single-channel interface is used in the mono case.
+void ProcessCaptureBlocks(
+    bool level_change,
+    bool saturated_microphone_signal,
+    BlockProcessor* block_processor,
+    std::vector<std::vector<std::vector<float>>>* blocks) {
+  if (blocks->size() == 1) {
+    block_processor->ProcessCapture(level_change, saturated_microphone_signal,
+                                    &(*blocks)[0]);
+  } else {
+    block_processor->ProcessMultiChannelCapture(
+        level_change, saturated_microphone_signal, blocks);
+  }
+}
+
 void ProcessCaptureFrameContent(
     AudioBuffer* capture,
     bool level_change,
     bool saturated_microphone_signal,
     size_t sub_frame_index,
-    FrameBlocker* capture_blocker,
-    BlockFramer* output_framer,
+    std::vector<std::unique_ptr<FrameBlocker>>* capture_blockers,
+    std::vector<std::unique_ptr<BlockFramer>>* output_framers,
     BlockProcessor* block_processor,
-    std::vector<std::vector<float>>* block,
+    std::vector<std::vector<std::vector<float>>>* blocks,
     std::vector<rtc::ArrayView<float>>* sub_frame_view) {
-  FillSubFrameView(capture, sub_frame_index, sub_frame_view);
-  capture_blocker->InsertSubFrameAndExtractBlock(*sub_frame_view, block);
-  block_processor->ProcessCapture(level_change, saturated_microphone_signal,
-                                  block);
-  output_framer->InsertBlockAndExtractSubFrame(*block, sub_frame_view);
+  for (size_t ch = 0; ch < blocks->size(); ++ch) {
+    FillSubFrameView(capture, sub_frame_index, ch, sub_frame_view);
+    (*capture_blockers)[ch]->InsertSubFrameAndExtractBlock(*sub_frame_view,
+                                                           &(*blocks)[ch]);
+  }
+  ProcessCaptureBlocks(level_change, saturated_microphone_signal,
+                       block_processor, blocks);
+  for (size_t ch = 0; ch < blocks->size(); ++ch) {
+    FillSubFrameView(capture, sub_frame_index, ch, sub_frame_view);
+    (*output_framers)[ch]->InsertBlockAndExtractSubFrame((*blocks)[ch],
+                                                         sub_frame_view);
+  }
 }
 
 void ProcessRemainingCaptureFrameContent(
     bool level_change,
     bool saturated_microphone_signal,
-    FrameBlocker* capture_blocker,
-    BlockFramer* output_framer,
+    std::vector<std::unique_ptr<FrameBlocker>>* capture_blockers,
+    std::vector<std::unique_ptr<BlockFramer>>* output_framers,
     BlockProcessor* block_processor,
-    std::vector<std::vector<float>>* block) {
-  if (!capture_blocker->IsBlockAvailable()) {
+    std::vector<std::vector<std::vector<float>>>* blocks) {
+  // All the channels are blocked in lockstep, so it suffices to check the
+  // first one.
+  if (!(*capture_blockers)[0]->IsBlockAvailable()) {
     return;
   }
 
-  capture_blocker->ExtractBlock(block);
-  block_processor->ProcessCapture(level_change, saturated_microphone_signal,
-                                  block);
-  output_framer->InsertBlock(*block);
+  for (size_t ch = 0; ch < blocks->size(); ++ch) {
+    (*capture_blockers)[ch]->ExtractBlock(&(*blocks)[ch]);
+  }
+  ProcessCaptureBlocks(level_change, saturated_microphone_signal,
+                       block_processor, blocks);
+  for (size_t ch = 0; ch < blocks->size(); ++ch) {
+    (*output_framers)[ch]->InsertBlock((*blocks)[ch]);
+  }
 }
 
 void BufferRenderFrameContent(
@@ -239,8 +269,9 @@ const int kNumberOfHighPassBiQuads_16kHz = 1;
 class EchoCanceller3::RenderWriter {
  public:
   RenderWriter(ApmDataDumper* data_dumper,
-               SwapQueue<std::vector<std::vector<float>>,
-                         Aec3RenderQueueItemVerifier>* render_transfer_queue,
+               SpscSwapQueue<std::vector<std::vector<float>>,
+                             Aec3RenderQueueItemVerifier>*
+                   render_transfer_queue,
                std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter,
                int sample_rate_hz,
                int frame_length,
@@ -255,14 +286,14 @@ class EchoCanceller3::RenderWriter {
   const int num_bands_;
   std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter_;
   std::vector<std::vector<float>> render_queue_input_frame_;
-  SwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>*
+  SpscSwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>*
       render_transfer_queue_;
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RenderWriter);
 };
 
 EchoCanceller3::RenderWriter::RenderWriter(
     ApmDataDumper* data_dumper,
-    SwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>*
+    SpscSwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>*
         render_transfer_queue,
     std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter,
     int sample_rate_hz,
@@ -309,23 +340,39 @@ int EchoCanceller3::instance_count_ = 0;
 EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                int sample_rate_hz,
                                bool use_highpass_filter)
-    : EchoCanceller3(
-          AdjustConfig(config),
-          sample_rate_hz,
-          use_highpass_filter,
-          std::unique_ptr<BlockProcessor>(
-              BlockProcessor::Create(AdjustConfig(config), sample_rate_hz))) {}
+    : EchoCanceller3(config, sample_rate_hz, use_highpass_filter, 1) {}
+EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
+                               int sample_rate_hz,
+                               bool use_highpass_filter,
+                               size_t num_capture_channels)
+    : EchoCanceller3(AdjustConfig(config),
+                     sample_rate_hz,
+                     use_highpass_filter,
+                     num_capture_channels,
+                     std::unique_ptr<BlockProcessor>(
+                         BlockProcessor::Create(AdjustConfig(config),
+                                                sample_rate_hz,
+                                                num_capture_channels))) {}
 EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                int sample_rate_hz,
                                bool use_highpass_filter,
                                std::unique_ptr<BlockProcessor> block_processor)
+    : EchoCanceller3(config,
+                     sample_rate_hz,
+                     use_highpass_filter,
+                     1,
+                     std::move(block_processor)) {}
+EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
+                               int sample_rate_hz,
+                               bool use_highpass_filter,
+                               size_t num_capture_channels,
+                               std::unique_ptr<BlockProcessor> block_processor)
     : data_dumper_(
           new ApmDataDumper(rtc::AtomicOps::Increment(&instance_count_))),
       sample_rate_hz_(sample_rate_hz),
       num_bands_(NumBandsForRate(sample_rate_hz_)),
       frame_length_(rtc::CheckedDivExact(LowestBandRate(sample_rate_hz_), 100)),
-      output_framer_(num_bands_),
-      capture_blocker_(num_bands_),
+      num_capture_channels_(num_capture_channels),
       render_blocker_(num_bands_),
       render_transfer_queue_(
           kRenderTransferQueueSizeFrames,
@@ -337,8 +384,18 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
       render_queue_output_frame_(num_bands_,
                                  std::vector<float>(frame_length_, 0.f)),
       block_(num_bands_, std::vector<float>(kBlockSize, 0.f)),
+      capture_blocks_(
+          num_capture_channels_,
+          std::vector<std::vector<float>>(num_bands_,
+                                          std::vector<float>(kBlockSize, 0.f))),
       sub_frame_view_(num_bands_) {
   RTC_DCHECK(ValidFullBandRate(sample_rate_hz_));
+  RTC_DCHECK_LT(0, num_capture_channels_);
+
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    output_framers_.emplace_back(new BlockFramer(num_bands_));
+    capture_blockers_.emplace_back(new FrameBlocker(num_bands_));
+  }
 
   std::unique_ptr<CascadedBiQuadFilter> render_highpass_filter;
   if (use_highpass_filter) {
@@ -347,11 +404,13 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                 : kHighPassFilterCoefficients_16kHz,
         sample_rate_hz_ == 8000 ? kNumberOfHighPassBiQuads_8kHz
                                 : kNumberOfHighPassBiQuads_16kHz));
-    capture_highpass_filter_.reset(new CascadedBiQuadFilter(
-        sample_rate_hz_ == 8000 ? kHighPassFilterCoefficients_8kHz
-                                : kHighPassFilterCoefficients_16kHz,
-        sample_rate_hz_ == 8000 ? kNumberOfHighPassBiQuads_8kHz
-                                : kNumberOfHighPassBiQuads_16kHz));
+    for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+      capture_highpass_filters_.emplace_back(new CascadedBiQuadFilter(
+          sample_rate_hz_ == 8000 ? kHighPassFilterCoefficients_8kHz
+                                  : kHighPassFilterCoefficients_16kHz,
+          sample_rate_hz_ == 8000 ? kNumberOfHighPassBiQuads_8kHz
+                                  : kNumberOfHighPassBiQuads_16kHz));
+    }
   }
 
   render_writer_.reset(
@@ -394,7 +453,7 @@ void EchoCanceller3::AnalyzeCapture(AudioBuffer* capture) {
 void EchoCanceller3::ProcessCapture(AudioBuffer* capture, bool level_change) {
   RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
   RTC_DCHECK(capture);
-  RTC_DCHECK_EQ(1u, capture->num_channels());
+  RTC_DCHECK_EQ(num_capture_channels_, capture->num_channels());
   RTC_DCHECK_EQ(num_bands_, capture->num_bands());
   RTC_DCHECK_EQ(frame_length_, capture->num_frames_per_band());
   data_dumper_->DumpRaw("aec3_call_order",
@@ -408,24 +467,29 @@ void EchoCanceller3::ProcessCapture(AudioBuffer* capture, bool level_change) {
 
   EmptyRenderQueue();
 
-  if (capture_highpass_filter_) {
-    capture_highpass_filter_->Process(capture_lower_band);
+  for (size_t ch = 0; ch < capture_highpass_filters_.size(); ++ch) {
+    capture_highpass_filters_[ch]->Process(
+        rtc::ArrayView<float>(&capture->split_bands_f(ch)[0][0],
+                              frame_length_));
   }
 
-  ProcessCaptureFrameContent(
-      capture, level_change, saturated_microphone_signal_, 0, &capture_blocker_,
-      &output_framer_, block_processor_.get(), &block_, &sub_frame_view_);
+  ProcessCaptureFrameContent(capture, level_change,
+                             saturated_microphone_signal_, 0,
+                             &capture_blockers_, &output_framers_,
+                             block_processor_.get(), &capture_blocks_,
+                             &sub_frame_view_);
 
   if (sample_rate_hz_ != 8000) {
-    ProcessCaptureFrameContent(
-        capture, level_change, saturated_microphone_signal_, 1,
-        &capture_blocker_, &output_framer_, block_processor_.get(), &block_,
-        &sub_frame_view_);
+    ProcessCaptureFrameContent(capture, level_change,
+                               saturated_microphone_signal_, 1,
+                               &capture_blockers_, &output_framers_,
+                               block_processor_.get(), &capture_blocks_,
+                               &sub_frame_view_);
   }
 
   ProcessRemainingCaptureFrameContent(
-      level_change, saturated_microphone_signal_, &capture_blocker_,
-      &output_framer_, block_processor_.get(), &block_);
+      level_change, saturated_microphone_signal_, &capture_blockers_,
+      &output_framers_, block_processor_.get(), &capture_blocks_);
 
   data_dumper_->DumpWav("aec3_capture_output", frame_length_,
                         &capture->split_bands_f(0)[0][0],
@@ -11,6 +11,9 @@
 #ifndef MODULES_AUDIO_PROCESSING_AEC3_ECHO_CANCELLER3_H_
 #define MODULES_AUDIO_PROCESSING_AEC3_ECHO_CANCELLER3_H_
 
+#include <memory>
+#include <vector>
+
 #include "api/audio/echo_canceller3_config.h"
 #include "modules/audio_processing/aec3/block_framer.h"
 #include "modules/audio_processing/aec3/block_processor.h"
@@ -66,11 +69,22 @@ class EchoCanceller3 : public EchoControl {
   EchoCanceller3(const EchoCanceller3Config& config,
                  int sample_rate_hz,
                  bool use_highpass_filter);
-  // Testing c-tor that is used only for testing purposes.
+  // C-tor for processing |num_capture_channels| capture channels. The render
+  // buffering and the delay estimation are shared by all the channels.
+  EchoCanceller3(const EchoCanceller3Config& config,
+                 int sample_rate_hz,
+                 bool use_highpass_filter,
+                 size_t num_capture_channels);
+  // Testing c-tors that are used only for testing purposes.
   EchoCanceller3(const EchoCanceller3Config& config,
                  int sample_rate_hz,
                  bool use_highpass_filter,
                  std::unique_ptr<BlockProcessor> block_processor);
+  EchoCanceller3(const EchoCanceller3Config& config,
+                 int sample_rate_hz,
+                 bool use_highpass_filter,
+                 size_t num_capture_channels,
+                 std::unique_ptr<BlockProcessor> block_processor);
   ~EchoCanceller3() override;
   // Analyzes and stores an internal copy of the split-band domain render
   // signal.
@@ -113,20 +127,27 @@ class EchoCanceller3 : public EchoControl {
   const int sample_rate_hz_;
   const int num_bands_;
   const size_t frame_length_;
-  BlockFramer output_framer_ RTC_GUARDED_BY(capture_race_checker_);
-  FrameBlocker capture_blocker_ RTC_GUARDED_BY(capture_race_checker_);
+  const size_t num_capture_channels_;
+  std::vector<std::unique_ptr<BlockFramer>> output_framers_
+      RTC_GUARDED_BY(capture_race_checker_);
+  std::vector<std::unique_ptr<FrameBlocker>> capture_blockers_
+      RTC_GUARDED_BY(capture_race_checker_);
   FrameBlocker render_blocker_ RTC_GUARDED_BY(capture_race_checker_);
-  SwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>
+  // Written by the render thread and read by the capture thread, without
+  // locking.
+  SpscSwapQueue<std::vector<std::vector<float>>, Aec3RenderQueueItemVerifier>
       render_transfer_queue_;
   std::unique_ptr<BlockProcessor> block_processor_
       RTC_GUARDED_BY(capture_race_checker_);
   std::vector<std::vector<float>> render_queue_output_frame_
       RTC_GUARDED_BY(capture_race_checker_);
-  std::unique_ptr<CascadedBiQuadFilter> capture_highpass_filter_
+  std::vector<std::unique_ptr<CascadedBiQuadFilter>> capture_highpass_filters_
       RTC_GUARDED_BY(capture_race_checker_);
   bool saturated_microphone_signal_ RTC_GUARDED_BY(capture_race_checker_) =
       false;
   std::vector<std::vector<float>> block_ RTC_GUARDED_BY(capture_race_checker_);
+  std::vector<std::vector<std::vector<float>>> capture_blocks_
+      RTC_GUARDED_BY(capture_race_checker_);
   std::vector<rtc::ArrayView<float>> sub_frame_view_
       RTC_GUARDED_BY(capture_race_checker_);
 
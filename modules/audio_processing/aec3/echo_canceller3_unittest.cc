@@ -10,6 +10,7 @@
 
 #include "modules/audio_processing/aec3/echo_canceller3.h"
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <sstream>
@@ -22,6 +23,7 @@
 #include "modules/audio_processing/aec3/frame_blocker.h"
 #include "modules/audio_processing/aec3/mock/mock_block_processor.h"
 #include "modules/audio_processing/audio_buffer.h"
+#include "rtc_base/random.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -98,6 +100,11 @@ class CaptureTransportVerificationProcessor : public BlockProcessor {
                       std::vector<std::vector<float>>* capture_block) override {
   }
 
+  void ProcessMultiChannelCapture(
+      bool level_change,
+      bool saturated_microphone_signal,
+      std::vector<std::vector<std::vector<float>>>* capture_blocks) override {}
+
   void BufferRender(const std::vector<std::vector<float>>& block) override {}
 
   void UpdateEchoLeakageStatus(bool leakage_detected) override {}
@@ -126,6 +133,16 @@ class RenderTransportVerificationProcessor : public BlockProcessor {
     capture_block->swap(render_block);
   }
 
+  void ProcessMultiChannelCapture(
+      bool level_change,
+      bool saturated_microphone_signal,
+      std::vector<std::vector<std::vector<float>>>* capture_blocks) override {
+    for (auto& capture_block : *capture_blocks) {
+      capture_block = received_render_blocks_.front();
+    }
+    received_render_blocks_.pop_front();
+  }
+
   void BufferRender(const std::vector<std::vector<float>>& block) override {
     received_render_blocks_.push_back(block);
   }
@@ -185,6 +202,45 @@ class EchoCanceller3Tester {
     }
   }
 
+  // Verifies that the data of each capture channel is properly passed through
+  // the block processor to the corresponding EchoCanceller3 output channel.
+  void RunMultiChannelCaptureTransportTest() {
+    constexpr size_t kNumCaptureChannels = 3;
+    AudioBuffer capture_buffer(fullband_frame_length_, kNumCaptureChannels,
+                               fullband_frame_length_, kNumCaptureChannels,
+                               fullband_frame_length_);
+    EchoCanceller3 aec3(
+        EchoCanceller3Config(), sample_rate_hz_, false, kNumCaptureChannels,
+        std::unique_ptr<BlockProcessor>(
+            new CaptureTransportVerificationProcessor(num_bands_)));
+
+    for (size_t frame_index = 0; frame_index < kNumFramesToProcess;
+         ++frame_index) {
+      aec3.AnalyzeCapture(&capture_buffer);
+      if (sample_rate_hz_ > 16000) {
+        capture_buffer.SplitIntoFrequencyBands();
+        render_buffer_.SplitIntoFrequencyBands();
+      }
+      // The channels are distinguished by channel-specific offsets.
+      for (size_t ch = 0; ch < kNumCaptureChannels; ++ch) {
+        PopulateInputFrame(frame_length_, num_bands_, frame_index,
+                           &capture_buffer.split_bands_f(ch)[0],
+                           -100 * static_cast<int>(ch));
+      }
+      PopulateInputFrame(frame_length_, frame_index,
+                         &render_buffer_.channels_f()[0][0], 0);
+
+      aec3.AnalyzeRender(&render_buffer_);
+      aec3.ProcessCapture(&capture_buffer, false);
+      for (size_t ch = 0; ch < kNumCaptureChannels; ++ch) {
+        EXPECT_TRUE(VerifyOutputFrameBitexactness(
+            frame_length_, num_bands_, frame_index,
+            &capture_buffer.split_bands_f(ch)[0],
+            -100 * static_cast<int>(ch) - 64));
+      }
+    }
+  }
+
   // Test method for testing that the render data is properly received by the
   // block processor.
   void RunRenderTransportVerificationTest() {
@@ -624,6 +680,60 @@ TEST(EchoCanceller3Buffering, CaptureBitexactness) {
   }
 }
 
+TEST(EchoCanceller3Buffering, MultiChannelCaptureBitexactness) {
+  for (auto rate : {8000, 16000, 32000, 48000}) {
+    SCOPED_TRACE(ProduceDebugText(rate));
+    EchoCanceller3Tester(rate).RunMultiChannelCaptureTransportTest();
+  }
+}
+
+// Verifies that capture channels with identical content are each processed
+// exactly as the single channel of a mono echo canceller.
+TEST(EchoCanceller3MultiChannel, IdenticalChannelsMatchMonoProcessing) {
+  for (auto rate : {16000, 48000}) {
+    SCOPED_TRACE(ProduceDebugText(rate));
+    const size_t frame_length = rtc::CheckedDivExact(rate, 100);
+    const size_t num_bands = NumBandsForRate(rate);
+    const size_t band_length = rtc::CheckedDivExact(frame_length, num_bands);
+    EchoCanceller3 mono_aec3(EchoCanceller3Config(), rate, true);
+    EchoCanceller3 stereo_aec3(EchoCanceller3Config(), rate, true, 2);
+    AudioBuffer render(frame_length, 1, frame_length, 1, frame_length);
+    AudioBuffer mono_capture(frame_length, 1, frame_length, 1, frame_length);
+    AudioBuffer stereo_capture(frame_length, 2, frame_length, 2, frame_length);
+    Random random_generator(42U);
+
+    for (size_t frame_index = 0; frame_index < 200; ++frame_index) {
+      for (size_t i = 0; i < frame_length; ++i) {
+        const float x = random_generator.Rand<float>() * 2000.f - 1000.f;
+        const float y = 0.5f * x + random_generator.Rand<float>() * 10.f;
+        render.channels_f()[0][i] = x;
+        mono_capture.channels_f()[0][i] = y;
+        stereo_capture.channels_f()[0][i] = y;
+        stereo_capture.channels_f()[1][i] = y;
+      }
+      mono_aec3.AnalyzeCapture(&mono_capture);
+      stereo_aec3.AnalyzeCapture(&stereo_capture);
+      if (rate > 16000) {
+        render.SplitIntoFrequencyBands();
+        mono_capture.SplitIntoFrequencyBands();
+        stereo_capture.SplitIntoFrequencyBands();
+      }
+      mono_aec3.AnalyzeRender(&render);
+      stereo_aec3.AnalyzeRender(&render);
+      mono_aec3.ProcessCapture(&mono_capture, false);
+      stereo_aec3.ProcessCapture(&stereo_capture, false);
+
+      for (size_t ch = 0; ch < 2; ++ch) {
+        for (size_t k = 0; k < num_bands; ++k) {
+          const float* mono_band = mono_capture.split_bands_f(0)[k];
+          EXPECT_TRUE(std::equal(mono_band, mono_band + band_length,
+                                 stereo_capture.split_bands_f(ch)[k]));
+        }
+      }
+    }
+  }
+}
+
 TEST(EchoCanceller3Buffering, RenderBitexactness) {
   for (auto rate : {8000, 16000, 32000, 48000}) {
     SCOPED_TRACE(ProduceDebugText(rate));
@@ -46,7 +46,8 @@ struct FftData {
     RTC_DCHECK_EQ(kFftLengthBy2Plus1, power_spectrum.size());
     switch (optimization) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-      case Aec3Optimization::kSse2: {
+      case Aec3Optimization::kSse2:
+      case Aec3Optimization::kAvx2: {
         constexpr int kNumFourBinBands = kFftLengthBy2 / 4;
         constexpr int kLimit = kNumFourBinBands * 4;
         for (size_t k = 0; k < kLimit; k += 4) {
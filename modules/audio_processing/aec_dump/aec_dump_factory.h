@@ -40,6 +40,14 @@ class AecDumpFactory {
   static std::unique_ptr<AecDump> Create(FILE* handle,
                                          int64_t max_log_size_bytes,
                                          rtc::TaskQueue* worker_queue);
+  // Creates an AecDump that writes to |file_name| and keeps the size of the
+  // log bounded by rotating it into at most |num_files| files of at most
+  // |max_file_size_bytes| each. The older parts are named |file_name|.1,
+  // |file_name|.2 and so on, and each part is readable on its own.
+  static std::unique_ptr<AecDump> Create(std::string file_name,
+                                         size_t max_file_size_bytes,
+                                         size_t num_files,
+                                         rtc::TaskQueue* worker_queue);
 };
 
 }  // namespace webrtc
@@ -57,11 +57,9 @@ void CopyFromConfigToEvent(const webrtc::InternalAPMConfig& config,
 
 }  // namespace
 
-AecDumpImpl::AecDumpImpl(std::unique_ptr<FileWrapper> debug_file,
-                         int64_t max_log_size_bytes,
+AecDumpImpl::AecDumpImpl(std::unique_ptr<DebugFileWriter> debug_file_writer,
                          rtc::TaskQueue* worker_queue)
-    : debug_file_(std::move(debug_file)),
-      num_bytes_left_for_log_(max_log_size_bytes),
+    : debug_file_writer_(std::move(debug_file_writer)),
       worker_queue_(worker_queue),
       capture_stream_info_(CreateWriteToFileTask()) {}
 
@@ -170,8 +168,7 @@ void AecDumpImpl::WriteConfig(const InternalAPMConfig& config) {
 }
 
 std::unique_ptr<WriteToFileTask> AecDumpImpl::CreateWriteToFileTask() {
-  return absl::make_unique<WriteToFileTask>(debug_file_.get(),
-                                            &num_bytes_left_for_log_);
+  return absl::make_unique<WriteToFileTask>(debug_file_writer_.get());
 }
 
 std::unique_ptr<AecDump> AecDumpFactory::Create(rtc::PlatformFile file,
@@ -186,8 +183,10 @@ std::unique_ptr<AecDump> AecDumpFactory::Create(rtc::PlatformFile file,
   if (!debug_file->OpenFromFileHandle(handle)) {
     return nullptr;
   }
-  return absl::make_unique<AecDumpImpl>(std::move(debug_file),
-                                        max_log_size_bytes, worker_queue);
+  return absl::make_unique<AecDumpImpl>(
+      absl::make_unique<DebugFileWriter>(std::move(debug_file),
+                                         max_log_size_bytes),
+      worker_queue);
 }
 
 std::unique_ptr<AecDump> AecDumpFactory::Create(std::string file_name,
@@ -198,8 +197,10 @@ std::unique_ptr<AecDump> AecDumpFactory::Create(std::string file_name,
   if (!debug_file->OpenFile(file_name.c_str(), false)) {
     return nullptr;
   }
-  return absl::make_unique<AecDumpImpl>(std::move(debug_file),
-                                        max_log_size_bytes, worker_queue);
+  return absl::make_unique<AecDumpImpl>(
+      absl::make_unique<DebugFileWriter>(std::move(debug_file),
+                                         max_log_size_bytes),
+      worker_queue);
 }
 
 std::unique_ptr<AecDump> AecDumpFactory::Create(FILE* handle,
@@ -211,7 +212,23 @@ std::unique_ptr<AecDump> AecDumpFactory::Create(FILE* handle,
   if (!debug_file->OpenFromFileHandle(handle)) {
     return nullptr;
   }
-  return absl::make_unique<AecDumpImpl>(std::move(debug_file),
-                                        max_log_size_bytes, worker_queue);
+  return absl::make_unique<AecDumpImpl>(
+      absl::make_unique<DebugFileWriter>(std::move(debug_file),
+                                         max_log_size_bytes),
+      worker_queue);
+}
+
+std::unique_ptr<AecDump> AecDumpFactory::Create(std::string file_name,
+                                                size_t max_file_size_bytes,
+                                                size_t num_files,
+                                                rtc::TaskQueue* worker_queue) {
+  RTC_DCHECK(worker_queue);
+  auto debug_file_writer = absl::make_unique<DebugFileWriter>(
+      file_name, max_file_size_bytes, num_files);
+  if (!debug_file_writer->is_open()) {
+    return nullptr;
+  }
+  return absl::make_unique<AecDumpImpl>(std::move(debug_file_writer),
+                                        worker_queue);
 }
 }  // namespace webrtc
@@ -17,6 +17,7 @@
 
 #include "api/audio/audio_frame.h"
 #include "modules/audio_processing/aec_dump/capture_stream_info.h"
+#include "modules/audio_processing/aec_dump/debug_file_writer.h"
 #include "modules/audio_processing/aec_dump/write_to_file_task.h"
 #include "modules/audio_processing/include/aec_dump.h"
 #include "rtc_base/ignore_wundef.h"
@@ -46,8 +47,7 @@ namespace webrtc {
 class AecDumpImpl : public AecDump {
  public:
   // Does member variables initialization shared across all c-tors.
-  AecDumpImpl(std::unique_ptr<FileWrapper> debug_file,
-              int64_t max_log_size_bytes,
+  AecDumpImpl(std::unique_ptr<DebugFileWriter> debug_file_writer,
               rtc::TaskQueue* worker_queue);
 
   ~AecDumpImpl() override;
@@ -70,8 +70,8 @@ class AecDumpImpl : public AecDump {
  private:
   std::unique_ptr<WriteToFileTask> CreateWriteToFileTask();
 
-  std::unique_ptr<FileWrapper> debug_file_;
-  int64_t num_bytes_left_for_log_ = 0;
+  // Only accessed on the worker queue, apart from its destruction.
+  std::unique_ptr<DebugFileWriter> debug_file_writer_;
   rtc::RaceChecker race_checker_;
   rtc::TaskQueue* worker_queue_;
   CaptureStreamInfo capture_stream_info_;
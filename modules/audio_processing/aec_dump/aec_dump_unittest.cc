@@ -9,13 +9,24 @@
  */
 
 #include <utility>
+#include <vector>
 
 #include "modules/audio_processing/aec_dump/aec_dump_factory.h"
 
+#include "rtc_base/ignore_wundef.h"
+#include "rtc_base/stringencode.h"
 #include "rtc_base/task_queue.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
 
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/modules/audio_processing/debug.pb.h"
+#else
+#include "modules/audio_processing/debug.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
 TEST(AecDumper, APICallsDoNotCrash) {
   // Note order of initialization: Task queue has to be initialized
   // before AecDump.
@@ -69,3 +80,53 @@ TEST(AecDumper, WriteToFile) {
   ASSERT_EQ(0, fclose(fid));
   ASSERT_EQ(0, remove(filename.c_str()));
 }
+
+TEST(AecDumper, RotatesFiles) {
+  rtc::TaskQueue file_writer_queue("file_writer_queue");
+
+  const std::string filename =
+      webrtc::test::TempFilename(webrtc::test::OutputPath(), "aec_dump");
+  auto file_name = [&filename](int index) {
+    return index == 0 ? filename : filename + "." + rtc::ToString(index);
+  };
+
+  {
+    constexpr size_t kMaxFileSizeBytes = 4000;
+    constexpr size_t kNumFiles = 3;
+    std::unique_ptr<webrtc::AecDump> aec_dump = webrtc::AecDumpFactory::Create(
+        filename, kMaxFileSizeBytes, kNumFiles, &file_writer_queue);
+    ASSERT_TRUE(aec_dump);
+
+    webrtc::ProcessingConfig api_format;
+    constexpr int64_t kTimeNowMs = 123456789ll;
+    aec_dump->WriteInitMessage(api_format, kTimeNowMs);
+
+    webrtc::AudioFrame frame;
+    frame.samples_per_channel_ = 160;
+    frame.num_channels_ = 1;
+    for (int i = 0; i < 100; ++i) {
+      aec_dump->WriteRenderStreamMessage(frame);
+    }
+  }
+
+  // Every file that is kept starts with the INIT event.
+  for (int i = 0; i < 3; ++i) {
+    FILE* fid = fopen(file_name(i).c_str(), "rb");
+    ASSERT_TRUE(fid != NULL);
+    int32_t size = 0;
+    ASSERT_EQ(1u, fread(&size, sizeof(size), 1, fid));
+    ASSERT_LT(0, size);
+    std::vector<char> bytes(size);
+    ASSERT_EQ(bytes.size(), fread(bytes.data(), 1, bytes.size(), fid));
+    webrtc::audioproc::Event event;
+    ASSERT_TRUE(event.ParseFromArray(bytes.data(), size));
+    EXPECT_EQ(webrtc::audioproc::Event::INIT, event.type());
+    ASSERT_EQ(0, fclose(fid));
+  }
+  EXPECT_TRUE(fopen(file_name(3).c_str(), "rb") == NULL);
+
+  // Clean them up.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(0, remove(file_name(i).c_str()));
+  }
+}
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec_dump/debug_file_writer.h"
+
+#include <stdio.h>
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/protobuf_utils.h"
+#include "rtc_base/stringencode.h"
+
+namespace webrtc {
+namespace {
+
+// Appends |event_string| preceded by its size, in the format that is read by
+// the debug dump readers.
+void AppendEventRecord(const ProtoString& event_string, std::string* chunk) {
+  const int32_t event_byte_size = static_cast<int32_t>(event_string.size());
+  chunk->append(reinterpret_cast<const char*>(&event_byte_size),
+                sizeof(event_byte_size));
+  chunk->append(event_string.data(), event_string.size());
+}
+
+}  // namespace
+
+constexpr size_t DebugFileWriter::kChunkSizeBytes;
+
+DebugFileWriter::DebugFileWriter(std::unique_ptr<FileWrapper> debug_file,
+                                 int64_t max_log_size_bytes)
+    : debug_file_(std::move(debug_file)),
+      num_bytes_left_for_log_(max_log_size_bytes) {
+  RTC_DCHECK(debug_file_);
+  chunk_.reserve(kChunkSizeBytes);
+}
+
+DebugFileWriter::DebugFileWriter(const std::string& file_name,
+                                 size_t max_file_size_bytes,
+                                 size_t num_files)
+    : debug_file_(FileWrapper::Create()),
+      file_name_(file_name),
+      max_file_size_bytes_(max_file_size_bytes),
+      num_files_(num_files) {
+  RTC_DCHECK(!file_name_.empty());
+  RTC_DCHECK_LT(0, max_file_size_bytes_);
+  RTC_DCHECK_LT(0, num_files_);
+  debug_file_->OpenFile(file_name_.c_str(), false);
+  chunk_.reserve(kChunkSizeBytes);
+}
+
+DebugFileWriter::~DebugFileWriter() {
+  Flush();
+}
+
+void DebugFileWriter::WriteEvent(const audioproc::Event& event) {
+  if (!debug_file_->is_open()) {
+    return;
+  }
+
+  ProtoString event_string;
+  event.SerializeToString(&event_string);
+  const size_t event_record_size = sizeof(int32_t) + event_string.size();
+
+  if (file_name_.empty()) {
+    if (!IsRoomForNextEvent(event_record_size)) {
+      Flush();
+      debug_file_->CloseFile();
+      return;
+    }
+    if (num_bytes_left_for_log_ >= 0) {
+      num_bytes_left_for_log_ -= event_record_size;
+    }
+  } else {
+    // Rotates on event boundaries only, and not before the file holds more
+    // than the events it was started with.
+    if (file_size_bytes_ + event_record_size > max_file_size_bytes_ &&
+        file_size_bytes_ > seed_size_bytes_) {
+      RotateFiles();
+      if (!debug_file_->is_open()) {
+        return;
+      }
+    }
+    file_size_bytes_ += event_record_size;
+  }
+
+  AppendEventRecord(event_string, &chunk_);
+
+  if (!file_name_.empty()) {
+    if (event.type() == audioproc::Event::INIT) {
+      init_event_record_.clear();
+      AppendEventRecord(event_string, &init_event_record_);
+    } else if (event.type() == audioproc::Event::CONFIG) {
+      config_event_record_.clear();
+      AppendEventRecord(event_string, &config_event_record_);
+    }
+  }
+
+  if (chunk_.size() >= kChunkSizeBytes) {
+    Flush();
+  }
+}
+
+void DebugFileWriter::Flush() {
+  if (chunk_.empty() || !debug_file_->is_open()) {
+    return;
+  }
+  if (!debug_file_->Write(chunk_.data(), chunk_.size())) {
+    RTC_NOTREACHED();
+  }
+  chunk_.clear();
+}
+
+bool DebugFileWriter::IsRoomForNextEvent(size_t event_record_size) const {
+  return (num_bytes_left_for_log_ < 0) ||
+         (num_bytes_left_for_log_ >= static_cast<int64_t>(event_record_size));
+}
+
+void DebugFileWriter::RotateFiles() {
+  Flush();
+  debug_file_->CloseFile();
+
+  // Shifts |file_name_|.i to |file_name_|.(i + 1), dropping the oldest file.
+  remove(FileName(num_files_ - 1).c_str());
+  for (size_t i = num_files_ - 1; i > 0; --i) {
+    rename(FileName(i - 1).c_str(), FileName(i).c_str());
+  }
+
+  if (!debug_file_->OpenFile(file_name_.c_str(), false)) {
+    return;
+  }
+  chunk_.append(init_event_record_);
+  chunk_.append(config_event_record_);
+  file_size_bytes_ = chunk_.size();
+  seed_size_bytes_ = chunk_.size();
+}
+
+std::string DebugFileWriter::FileName(size_t index) const {
+  return index == 0 ? file_name_ : file_name_ + "." + rtc::ToString(index);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC_DUMP_DEBUG_FILE_WRITER_H_
+#define MODULES_AUDIO_PROCESSING_AEC_DUMP_DEBUG_FILE_WRITER_H_
+
+#include <memory>
+#include <string>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/ignore_wundef.h"
+#include "rtc_base/system/file_wrapper.h"
+
+// Files generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/modules/audio_processing/debug.pb.h"
+#else
+#include "modules/audio_processing/debug.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+// Writes debug events, each preceded by its size, to a file. The events are
+// collected into chunks, which are written to the file at once. The class is
+// not thread safe and is meant to be used on the AecDump worker queue.
+class DebugFileWriter {
+ public:
+  // Size of the chunks in which the events are written to the file.
+  static constexpr size_t kChunkSizeBytes = 64 * 1024;
+
+  // Writes to |debug_file| until |max_log_size_bytes| have been written, after
+  // which the file is closed. |max_log_size_bytes == -1| means that the log
+  // size is unlimited.
+  DebugFileWriter(std::unique_ptr<FileWrapper> debug_file,
+                  int64_t max_log_size_bytes);
+
+  // Writes to |file_name|. Before the file exceeds |max_file_size_bytes|, it
+  // is renamed to |file_name|.1 and a new file is started. The older files
+  // are shifted likewise, and at most |num_files| files are kept. Each new
+  // file starts with the latest INIT and CONFIG events, so that every file
+  // can be unpacked on its own.
+  DebugFileWriter(const std::string& file_name,
+                  size_t max_file_size_bytes,
+                  size_t num_files);
+
+  ~DebugFileWriter();
+
+  bool is_open() const { return debug_file_->is_open(); }
+
+  // Adds |event| to the current chunk, which is written to the file once it
+  // is full.
+  void WriteEvent(const audioproc::Event& event);
+
+  // Writes the current chunk to the file.
+  void Flush();
+
+ private:
+  bool IsRoomForNextEvent(size_t event_record_size) const;
+  void RotateFiles();
+  std::string FileName(size_t index) const;
+
+  const std::unique_ptr<FileWrapper> debug_file_;
+  int64_t num_bytes_left_for_log_ = -1;
+
+  // Used for rotating the files only.
+  const std::string file_name_;
+  const size_t max_file_size_bytes_ = 0;
+  const size_t num_files_ = 0;
+  size_t file_size_bytes_ = 0;
+  size_t seed_size_bytes_ = 0;
+  std::string init_event_record_;
+  std::string config_event_record_;
+
+  std::string chunk_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DebugFileWriter);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC_DUMP_DEBUG_FILE_WRITER_H_
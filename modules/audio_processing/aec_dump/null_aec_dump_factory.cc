@@ -30,4 +30,11 @@ std::unique_ptr<AecDump> AecDumpFactory::Create(FILE* handle,
                                                 rtc::TaskQueue* worker_queue) {
   return nullptr;
 }
+
+std::unique_ptr<AecDump> AecDumpFactory::Create(std::string file_name,
+                                                size_t max_file_size_bytes,
+                                                size_t num_files,
+                                                rtc::TaskQueue* worker_queue) {
+  return nullptr;
+}
 }  // namespace webrtc
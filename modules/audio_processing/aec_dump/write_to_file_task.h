@@ -15,11 +15,11 @@
 #include <string>
 #include <utility>
 
+#include "modules/audio_processing/aec_dump/debug_file_writer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
 #include "rtc_base/ignore_wundef.h"
 #include "rtc_base/platform_file.h"
-#include "rtc_base/system/file_wrapper.h"
 #include "rtc_base/task_queue.h"
 
 // Files generated at build-time by the protobuf compiler.
@@ -35,22 +35,16 @@ namespace webrtc {
 
 class WriteToFileTask : public rtc::QueuedTask {
  public:
-  WriteToFileTask(webrtc::FileWrapper* debug_file,
-                  int64_t* num_bytes_left_for_log);
+  explicit WriteToFileTask(DebugFileWriter* debug_file_writer);
   ~WriteToFileTask() override;
 
   audioproc::Event* GetEvent();
 
  private:
-  bool IsRoomForNextEvent(size_t event_byte_size) const;
-
-  void UpdateBytesLeft(size_t event_byte_size);
-
   bool Run() override;
 
-  webrtc::FileWrapper* debug_file_;
+  DebugFileWriter* debug_file_writer_;
   audioproc::Event event_;
-  int64_t* num_bytes_left_for_log_;
 };
 
 }  // namespace webrtc
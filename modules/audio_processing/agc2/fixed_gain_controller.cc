@@ -10,6 +10,15 @@
 
 #include "modules/audio_processing/agc2/fixed_gain_controller.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <algorithm>
 #include <cmath>
 
@@ -31,6 +40,44 @@ bool CloseToOne(float gain_factor) {
   return 1.f - 1.f / kMaxFloatS16Value <= gain_factor &&
          gain_factor <= 1.f + 1.f / kMaxFloatS16Value;
 }
+
+void MultiplyByGain(float gain, rtc::ArrayView<float> x) {
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 g = _mm_set1_ps(gain);
+  for (; k + 4 <= x.size(); k += 4) {
+    _mm_storeu_ps(&x[k], _mm_mul_ps(_mm_loadu_ps(&x[k]), g));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  const float32x4_t g = vdupq_n_f32(gain);
+  for (; k + 4 <= x.size(); k += 4) {
+    vst1q_f32(&x[k], vmulq_f32(vld1q_f32(&x[k]), g));
+  }
+#endif
+  for (; k < x.size(); ++k) {
+    x[k] *= gain;
+  }
+}
+
+void ClampToFloatS16(rtc::ArrayView<float> x) {
+  size_t k = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 min = _mm_set1_ps(kMinFloatS16Value);
+  const __m128 max = _mm_set1_ps(kMaxFloatS16Value);
+  for (; k + 4 <= x.size(); k += 4) {
+    _mm_storeu_ps(&x[k], _mm_max_ps(_mm_min_ps(_mm_loadu_ps(&x[k]), max), min));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  const float32x4_t min = vdupq_n_f32(kMinFloatS16Value);
+  const float32x4_t max = vdupq_n_f32(kMaxFloatS16Value);
+  for (; k + 4 <= x.size(); k += 4) {
+    vst1q_f32(&x[k], vmaxq_f32(vminq_f32(vld1q_f32(&x[k]), max), min));
+  }
+#endif
+  for (; k < x.size(); ++k) {
+    x[k] = rtc::SafeClamp(x[k], kMinFloatS16Value, kMaxFloatS16Value);
+  }
+}
 }  // namespace
 
 FixedGainController::FixedGainController(ApmDataDumper* apm_data_dumper)
@@ -61,10 +108,7 @@ void FixedGainController::Process(AudioFrameView<float> signal) {
   // it up considerably. Hence the check.
   if (!CloseToOne(gain_to_apply_)) {
     for (size_t k = 0; k < signal.num_channels(); ++k) {
-      rtc::ArrayView<float> channel_view = signal.channel(k);
-      for (auto& sample : channel_view) {
-        sample *= gain_to_apply_;
-      }
+      MultiplyByGain(gain_to_apply_, signal.channel(k));
     }
   }
 
@@ -77,10 +121,7 @@ void FixedGainController::Process(AudioFrameView<float> signal) {
                             channel_view.size(), channel_view.data());
   // Hard-clipping.
   for (size_t k = 0; k < signal.num_channels(); ++k) {
-    rtc::ArrayView<float> channel_view = signal.channel(k);
-    for (auto& sample : channel_view) {
-      sample = rtc::SafeClamp(sample, kMinFloatS16Value, kMaxFloatS16Value);
-    }
+    ClampToFloatS16(signal.channel(k));
   }
 }
 }  // namespace webrtc
@@ -10,6 +10,15 @@
 
 #include "modules/audio_processing/agc2/gain_curve_applier.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -75,7 +84,19 @@ void ScaleSamples(rtc::ArrayView<const float> per_sample_scaling_factors,
   RTC_DCHECK_EQ(samples_per_channel, per_sample_scaling_factors.size());
   for (size_t i = 0; i < signal.num_channels(); ++i) {
     auto channel = signal.channel(i);
-    for (size_t j = 0; j < samples_per_channel; ++j) {
+    size_t j = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    for (; j + 4 <= samples_per_channel; j += 4) {
+      const __m128 g = _mm_loadu_ps(&per_sample_scaling_factors[j]);
+      _mm_storeu_ps(&channel[j], _mm_mul_ps(_mm_loadu_ps(&channel[j]), g));
+    }
+#elif defined(WEBRTC_HAS_NEON)
+    for (; j + 4 <= samples_per_channel; j += 4) {
+      const float32x4_t g = vld1q_f32(&per_sample_scaling_factors[j]);
+      vst1q_f32(&channel[j], vmulq_f32(vld1q_f32(&channel[j]), g));
+    }
+#endif
+    for (; j < samples_per_channel; ++j) {
       channel[j] *= per_sample_scaling_factors[j];
     }
   }
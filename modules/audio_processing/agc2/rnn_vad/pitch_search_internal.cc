@@ -16,6 +16,7 @@
 #include <utility>
 
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
+#include "modules/audio_processing/agc2/rnn_vad/vector_math.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -28,15 +29,16 @@ size_t GetInvertedLag(size_t lag) {
   return kMaxPitch24kHz - lag;
 }
 
-float ComputeAutoCorrelationCoeff(rtc::ArrayView<const float> pitch_buf,
+float ComputeAutoCorrelationCoeff(const VectorMath& vector_math,
+                                  rtc::ArrayView<const float> pitch_buf,
                                   size_t inv_lag,
                                   size_t max_pitch_period) {
   RTC_DCHECK_LT(inv_lag, pitch_buf.size());
   RTC_DCHECK_LT(max_pitch_period, pitch_buf.size());
   RTC_DCHECK_LE(inv_lag, max_pitch_period);
-  // TODO(bugs.webrtc.org/9076): Maybe optimize using vectorization.
-  return std::inner_product(pitch_buf.begin() + max_pitch_period,
-                            pitch_buf.end(), pitch_buf.begin() + inv_lag, 0.f);
+  const size_t size = pitch_buf.size() - max_pitch_period;
+  return vector_math.DotProduct({&pitch_buf[max_pitch_period], size},
+                                {&pitch_buf[inv_lag], size});
 }
 
 // Computes a pseudo-interpolation offset for an estimated pitch period |lag| by
@@ -67,6 +69,7 @@ int GetPitchPseudoInterpolationOffset(size_t lag,
 // Refines a pitch period |lag| encoded as lag with pseudo-interpolation. The
 // output sample rate is twice as that of |lag|.
 size_t PitchPseudoInterpolationLagPitchBuf(
+    const VectorMath& vector_math,
     size_t lag,
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf) {
   int offset = 0;
@@ -74,12 +77,12 @@ size_t PitchPseudoInterpolationLagPitchBuf(
   if (lag > 0 && lag < kMaxPitch24kHz) {
     offset = GetPitchPseudoInterpolationOffset(
         lag,
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag - 1),
-                                    kMaxPitch24kHz),
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag),
-                                    kMaxPitch24kHz),
-        ComputeAutoCorrelationCoeff(pitch_buf, GetInvertedLag(lag + 1),
-                                    kMaxPitch24kHz));
+        ComputeAutoCorrelationCoeff(vector_math, pitch_buf,
+                                    GetInvertedLag(lag - 1), kMaxPitch24kHz),
+        ComputeAutoCorrelationCoeff(vector_math, pitch_buf,
+                                    GetInvertedLag(lag), kMaxPitch24kHz),
+        ComputeAutoCorrelationCoeff(vector_math, pitch_buf,
+                                    GetInvertedLag(lag + 1), kMaxPitch24kHz));
   }
   return 2 * lag + offset;
 }
@@ -191,8 +194,9 @@ float ComputePitchGainThreshold(size_t candidate_pitch_period,
 void ComputeSlidingFrameSquareEnergies(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     rtc::ArrayView<float, kMaxPitch24kHz + 1> yy_values) {
-  float yy =
-      ComputeAutoCorrelationCoeff(pitch_buf, kMaxPitch24kHz, kMaxPitch24kHz);
+  float yy = ComputeAutoCorrelationCoeff(VectorMath(Optimization::kNone),
+                                         pitch_buf, kMaxPitch24kHz,
+                                         kMaxPitch24kHz);
   yy_values[0] = yy;
   for (size_t i = 1; i < yy_values.size(); ++i) {
     RTC_DCHECK_LE(i, kMaxPitch24kHz + kFrameSize20ms24kHz);
@@ -323,7 +327,9 @@ std::array<size_t, 2> FindBestPitchPeriods(
 
 size_t RefinePitchPeriod48kHz(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<const size_t, 2> inv_lags) {
+    rtc::ArrayView<const size_t, 2> inv_lags,
+    Optimization optimization) {
+  const VectorMath vector_math(optimization);
   // Compute the auto-correlation terms only for neighbors of the given pitch
   // candidates (similar to what is done in ComputePitchAutoCorrelation(), but
   // for a few lag values).
@@ -334,8 +340,8 @@ size_t RefinePitchPeriod48kHz(
   };
   for (size_t inv_lag = 0; inv_lag < auto_corr.size(); ++inv_lag) {
     if (is_neighbor(inv_lag, inv_lags[0]) || is_neighbor(inv_lag, inv_lags[1]))
-      auto_corr[inv_lag] =
-          ComputeAutoCorrelationCoeff(pitch_buf, inv_lag, kMaxPitch24kHz);
+      auto_corr[inv_lag] = ComputeAutoCorrelationCoeff(vector_math, pitch_buf,
+                                                       inv_lag, kMaxPitch24kHz);
   }
   // Find best pitch at 24 kHz.
   const auto pitch_candidates_inv_lags = FindBestPitchPeriods(
@@ -349,7 +355,8 @@ size_t RefinePitchPeriod48kHz(
 PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     size_t initial_pitch_period_48kHz,
-    PitchInfo prev_pitch_48kHz) {
+    PitchInfo prev_pitch_48kHz,
+    Optimization optimization) {
   RTC_DCHECK_LE(kMinPitch48kHz, initial_pitch_period_48kHz);
   RTC_DCHECK_LE(initial_pitch_period_48kHz, kMaxPitch48kHz);
   // Stores information for a refined pitch candidate.
@@ -367,6 +374,7 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
   };
 
   // Initialize.
+  const VectorMath vector_math(optimization);
   std::array<float, kMaxPitch24kHz + 1> yy_values;
   ComputeSlidingFrameSquareEnergies(pitch_buf,
                                     {yy_values.data(), yy_values.size()});
@@ -381,7 +389,8 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
   best_pitch.period_24kHz =
       std::min(initial_pitch_period_48kHz / 2, kMaxPitch24kHz - 1);
   best_pitch.xy = ComputeAutoCorrelationCoeff(
-      pitch_buf, GetInvertedLag(best_pitch.period_24kHz), kMaxPitch24kHz);
+      vector_math, pitch_buf, GetInvertedLag(best_pitch.period_24kHz),
+      kMaxPitch24kHz);
   best_pitch.yy = yy_values[best_pitch.period_24kHz];
   best_pitch.gain = pitch_gain(best_pitch.xy, best_pitch.yy, xx);
 
@@ -415,10 +424,11 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     // |candidate_pitch_period| by also looking at its possible sub-harmonic
     // |candidate_pitch_secondary_period|.
     float xy_primary_period = ComputeAutoCorrelationCoeff(
-        pitch_buf, GetInvertedLag(candidate_pitch_period), kMaxPitch24kHz);
-    float xy_secondary_period = ComputeAutoCorrelationCoeff(
-        pitch_buf, GetInvertedLag(candidate_pitch_secondary_period),
+        vector_math, pitch_buf, GetInvertedLag(candidate_pitch_period),
         kMaxPitch24kHz);
+    float xy_secondary_period = ComputeAutoCorrelationCoeff(
+        vector_math, pitch_buf,
+        GetInvertedLag(candidate_pitch_secondary_period), kMaxPitch24kHz);
     float xy = 0.5f * (xy_primary_period + xy_secondary_period);
     float yy = 0.5f * (yy_values[candidate_pitch_period] +
                        yy_values[candidate_pitch_secondary_period]);
@@ -442,7 +452,8 @@ PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
   final_pitch_gain = std::min(best_pitch.gain, final_pitch_gain);
   size_t final_pitch_period_48kHz = std::max(
       kMinPitch48kHz,
-      PitchPseudoInterpolationLagPitchBuf(best_pitch.period_24kHz, pitch_buf));
+      PitchPseudoInterpolationLagPitchBuf(vector_math, best_pitch.period_24kHz,
+                                          pitch_buf));
 
   return {final_pitch_period_48kHz, final_pitch_gain};
 }
@@ -89,17 +89,21 @@ std::array<size_t, 2> FindBestPitchPeriods(
 
 // Refines the pitch period estimation given the pitch buffer |pitch_buf| and
 // the initial pitch period estimation |inv_lags|. Returns an inverted lag at
-// 48 kHz.
+// 48 kHz. The auto-correlation coefficients are computed using the
+// optimization |optimization|.
 size_t RefinePitchPeriod48kHz(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
-    rtc::ArrayView<const size_t, 2> inv_lags);
+    rtc::ArrayView<const size_t, 2> inv_lags,
+    Optimization optimization);
 
 // Refines the pitch period estimation and compute the pitch gain. Returns the
-// refined pitch estimation data at 48 kHz.
+// refined pitch estimation data at 48 kHz. The auto-correlation coefficients
+// are computed using the optimization |optimization|.
 PitchInfo CheckLowerPitchPeriodsAndComputePitchGain(
     rtc::ArrayView<const float, kBufSize24kHz> pitch_buf,
     size_t initial_pitch_period_48kHz,
-    PitchInfo prev_pitch_48kHz);
+    PitchInfo prev_pitch_48kHz,
+    Optimization optimization);
 
 }  // namespace rnn_vad
 }  // namespace webrtc
@@ -183,15 +183,18 @@ TEST(RnnVadTest, RefinePitchPeriod48kHzBitExactness) {
   TestData test_data;
   std::array<float, kBufSize12kHz> pitch_buf_decimated;
   Decimate2x(test_data.GetPitchBufView(), pitch_buf_decimated);
-  size_t pitch_inv_lag;
-  {
-    // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
-    // FloatingPointExceptionObserver fpe_observer;
-    const std::array<size_t, 2> pitch_candidates_inv_lags = {280, 284};
-    pitch_inv_lag = RefinePitchPeriod48kHz(test_data.GetPitchBufView(),
-                                           pitch_candidates_inv_lags);
+  for (Optimization optimization : GetSupportedOptimizations()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    size_t pitch_inv_lag;
+    {
+      // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
+      // FloatingPointExceptionObserver fpe_observer;
+      const std::array<size_t, 2> pitch_candidates_inv_lags = {280, 284};
+      pitch_inv_lag = RefinePitchPeriod48kHz(
+          test_data.GetPitchBufView(), pitch_candidates_inv_lags, optimization);
+    }
+    EXPECT_EQ(560u, pitch_inv_lag);
   }
-  EXPECT_EQ(560u, pitch_inv_lag);
 }
 
 class CheckLowerPitchPeriodsAndComputePitchGainTest
@@ -207,12 +210,13 @@ TEST_P(CheckLowerPitchPeriodsAndComputePitchGainTest, BitExactness) {
   const size_t expected_pitch_period = std::get<3>(params);
   const float expected_pitch_gain = std::get<4>(params);
   TestData test_data;
-  {
+  for (Optimization optimization : GetSupportedOptimizations()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
     // TODO(bugs.webrtc.org/8948): Add when the issue is fixed.
     // FloatingPointExceptionObserver fpe_observer;
     const auto computed_output = CheckLowerPitchPeriodsAndComputePitchGain(
         test_data.GetPitchBufView(), initial_pitch_period,
-        {prev_pitch_period, prev_pitch_gain});
+        {prev_pitch_period, prev_pitch_gain}, optimization);
     EXPECT_EQ(expected_pitch_period, computed_output.period);
     EXPECT_NEAR(expected_pitch_gain, computed_output.gain, 1e-6f);
   }
@@ -48,23 +48,55 @@ using rnnoise::RectifiedLinearUnit;
 using rnnoise::SigmoidApproximated;
 using rnnoise::TansigApproximated;
 
+namespace {
+
+// Casts and scales |params|.
+std::vector<float> ScaleParams(rtc::ArrayView<const int8_t> params) {
+  std::vector<float> scaled_params(params.size());
+  for (size_t i = 0; i < params.size(); ++i) {
+    scaled_params[i] = kWeightsScale * static_cast<float>(params[i]);
+  }
+  return scaled_params;
+}
+
+// Casts, scales and transposes |weights|, which is a row-major matrix with
+// |input_size| rows and |num_units| columns, so that the weights feeding each
+// unit are contiguous.
+std::vector<float> PreprocessWeights(rtc::ArrayView<const int8_t> weights,
+                                     size_t input_size,
+                                     size_t num_units) {
+  RTC_DCHECK_LE(input_size * num_units, weights.size());
+  std::vector<float> preprocessed_weights(input_size * num_units);
+  for (size_t o = 0; o < num_units; ++o) {
+    for (size_t i = 0; i < input_size; ++i) {
+      preprocessed_weights[o * input_size + i] =
+          kWeightsScale * static_cast<float>(weights[i * num_units + o]);
+    }
+  }
+  return preprocessed_weights;
+}
+
+}  // namespace
+
 FullyConnectedLayer::FullyConnectedLayer(
     const size_t input_size,
     const size_t output_size,
     const rtc::ArrayView<const int8_t> bias,
     const rtc::ArrayView<const int8_t> weights,
-    float (*const activation_function)(float))
+    float (*const activation_function)(float),
+    Optimization optimization)
     : input_size_(input_size),
       output_size_(output_size),
-      bias_(bias),
-      weights_(weights),
-      activation_function_(activation_function) {
+      bias_(ScaleParams(bias)),
+      weights_(PreprocessWeights(weights, input_size, output_size)),
+      activation_function_(activation_function),
+      vector_math_(optimization) {
   RTC_DCHECK_LE(output_size_, kFullyConnectedLayersMaxUnits)
       << "Static over-allocation of fully-connected layers output vectors is "
          "not sufficient.";
-  RTC_DCHECK_EQ(output_size_, bias_.size())
+  RTC_DCHECK_EQ(output_size_, bias.size())
       << "Mismatching output size and bias terms array size.";
-  RTC_DCHECK_EQ(input_size_ * output_size_, weights_.size())
+  RTC_DCHECK_EQ(input_size_ * output_size_, weights.size())
       << "Mismatching input-output size and weight coefficients array size.";
 }
 
@@ -75,16 +107,12 @@ rtc::ArrayView<const float> FullyConnectedLayer::GetOutput() const {
 }
 
 void FullyConnectedLayer::ComputeOutput(rtc::ArrayView<const float> input) {
-  // TODO(bugs.chromium.org/9076): Optimize using SSE/AVX fused multiply-add
-  // operations.
+  RTC_DCHECK_EQ(input_size_, input.size());
   for (size_t o = 0; o < output_size_; ++o) {
-    output_[o] = bias_[o];
-    // TODO(bugs.chromium.org/9076): Benchmark how different layouts for
-    // |weights_| change the performance across different platforms.
-    for (size_t i = 0; i < input_size_; ++i) {
-      output_[o] += input[i] * weights_[i * output_size_ + o];
-    }
-    output_[o] = (*activation_function_)(kWeightsScale * output_[o]);
+    const rtc::ArrayView<const float> weights(&weights_[o * input_size_],
+                                              input_size_);
+    output_[o] = (*activation_function_)(
+        bias_[o] + vector_math_.DotProduct(input, weights));
   }
 }
 
@@ -94,21 +122,24 @@ GatedRecurrentLayer::GatedRecurrentLayer(
     const rtc::ArrayView<const int8_t> bias,
     const rtc::ArrayView<const int8_t> weights,
     const rtc::ArrayView<const int8_t> recurrent_weights,
-    float (*const activation_function)(float))
+    float (*const activation_function)(float),
+    Optimization optimization)
     : input_size_(input_size),
       output_size_(output_size),
-      bias_(bias),
-      weights_(weights),
-      recurrent_weights_(recurrent_weights),
-      activation_function_(activation_function) {
+      bias_(ScaleParams(bias)),
+      weights_(PreprocessWeights(weights, input_size, 3 * output_size)),
+      recurrent_weights_(
+          PreprocessWeights(recurrent_weights, output_size, 3 * output_size)),
+      activation_function_(activation_function),
+      vector_math_(optimization) {
   RTC_DCHECK_LE(output_size_, kRecurrentLayersMaxUnits)
       << "Static over-allocation of recurrent layers state vectors is not "
       << "sufficient.";
-  RTC_DCHECK_EQ(3 * output_size_, bias_.size())
+  RTC_DCHECK_EQ(3 * output_size_, bias.size())
       << "Mismatching output size and bias terms array size.";
-  RTC_DCHECK_EQ(3 * input_size_ * output_size_, weights_.size())
+  RTC_DCHECK_EQ(3 * input_size_ * output_size_, weights.size())
       << "Mismatching input-output size and weight coefficients array size.";
-  RTC_DCHECK_EQ(3 * input_size_ * output_size_, recurrent_weights_.size())
+  RTC_DCHECK_EQ(3 * input_size_ * output_size_, recurrent_weights.size())
       << "Mismatching input-output size and recurrent weight coefficients array"
       << " size.";
   Reset();
@@ -125,56 +156,41 @@ void GatedRecurrentLayer::Reset() {
 }
 
 void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input) {
-  // TODO(bugs.chromium.org/9076): Optimize using SSE/AVX fused multiply-add
-  // operations.
-  // Stride and offset used to read parameter arrays.
-  const size_t stride = 3 * output_size_;
-  size_t offset = 0;
+  RTC_DCHECK_EQ(input_size_, input.size());
+  const rtc::ArrayView<const float> state(state_.data(), output_size_);
+  // Returns the weighted sum of |input| and |recurrent_input| feeding the unit
+  // at row |row| of the parameter arrays, bias included.
+  const auto weighted_sum =
+      [&](size_t row, rtc::ArrayView<const float> recurrent_input) -> float {
+    const rtc::ArrayView<const float> weights(&weights_[row * input_size_],
+                                              input_size_);
+    const rtc::ArrayView<const float> recurrent_weights(
+        &recurrent_weights_[row * output_size_], output_size_);
+    return bias_[row] + vector_math_.DotProduct(input, weights) +
+           vector_math_.DotProduct(recurrent_input, recurrent_weights);
+  };
 
   // Compute update gates.
+  size_t offset = 0;
   std::array<float, kRecurrentLayersMaxUnits> update;
   for (size_t o = 0; o < output_size_; ++o) {
-    update[o] = bias_[o];
-    // TODO(bugs.chromium.org/9076): Benchmark how different layouts for
-    // |weights_| and |recurrent_weights_| change the performance across
-    // different platforms.
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      update[o] += input[i] * weights_[i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_; ++s) {
-      update[o] += state_[s] * recurrent_weights_[s * stride + o];
-    }  // Add state.
-    update[o] = SigmoidApproximated(kWeightsScale * update[o]);
+    update[o] = SigmoidApproximated(weighted_sum(offset + o, state));
   }
 
-  // Compute reset gates.
+  // Compute reset gates and apply them to the state.
   offset += output_size_;
-  std::array<float, kRecurrentLayersMaxUnits> reset;
+  std::array<float, kRecurrentLayersMaxUnits> reset_state;
   for (size_t o = 0; o < output_size_; ++o) {
-    reset[o] = bias_[offset + o];
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      reset[o] += input[i] * weights_[offset + i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_; ++s) {  // Add state.
-      reset[o] += state_[s] * recurrent_weights_[offset + s * stride + o];
-    }
-    reset[o] = SigmoidApproximated(kWeightsScale * reset[o]);
+    reset_state[o] =
+        state_[o] * SigmoidApproximated(weighted_sum(offset + o, state));
   }
 
   // Compute output.
   offset += output_size_;
   std::array<float, kRecurrentLayersMaxUnits> output;
   for (size_t o = 0; o < output_size_; ++o) {
-    output[o] = bias_[offset + o];
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      output[o] += input[i] * weights_[offset + i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_;
-         ++s) {  // Add state through reset gates.
-      output[o] +=
-          state_[s] * recurrent_weights_[offset + s * stride + o] * reset[s];
-    }
-    output[o] = (*activation_function_)(kWeightsScale * output[o]);
+    output[o] = (*activation_function_)(
+        weighted_sum(offset + o, {reset_state.data(), output_size_}));
     // Update output through the update gates.
     output[o] = update[o] * state_[o] + (1.f - update[o]) * output[o];
   }
@@ -184,23 +200,28 @@ void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input) {
   std::copy(output.begin(), output.end(), state_.begin());
 }
 
-RnnBasedVad::RnnBasedVad()
+RnnBasedVad::RnnBasedVad() : RnnBasedVad(DetectOptimization()) {}
+
+RnnBasedVad::RnnBasedVad(Optimization optimization)
     : input_layer_(kInputLayerInputSize,
                    kInputLayerOutputSize,
                    kInputDenseBias,
                    kInputDenseWeights,
-                   TansigApproximated),
+                   TansigApproximated,
+                   optimization),
       hidden_layer_(kInputLayerOutputSize,
                     kHiddenLayerOutputSize,
                     kHiddenGruBias,
                     kHiddenGruWeights,
                     kHiddenGruRecurrentWeights,
-                    RectifiedLinearUnit),
+                    RectifiedLinearUnit,
+                    optimization),
       output_layer_(kHiddenLayerOutputSize,
                     kOutputLayerOutputSize,
                     kOutputDenseBias,
                     kOutputDenseWeights,
-                    SigmoidApproximated) {
+                    SigmoidApproximated,
+                    optimization) {
   // Input-output chaining size checks.
   RTC_DCHECK_EQ(input_layer_.output_size(), hidden_layer_.input_size())
       << "The input and the hidden layers sizes do not match.";
@@ -12,6 +12,8 @@
 
 #include "absl/memory/memory.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
 
@@ -46,6 +48,22 @@ void ExpectNearAbsolute(rtc::ArrayView<const float> expected,
   }
 }
 
+std::vector<Optimization> GetSupportedOptimizations() {
+  std::vector<Optimization> optimizations = {Optimization::kNone};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    optimizations.push_back(Optimization::kSse2);
+  }
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    optimizations.push_back(Optimization::kAvx2);
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  optimizations.push_back(Optimization::kNeon);
+#endif
+  return optimizations;
+}
+
 std::unique_ptr<BinaryFileReader<float>> CreatePitchSearchTestDataReader() {
   constexpr size_t cols = 1396;
   return absl::make_unique<BinaryFileReader<float>>(
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "api/array_view.h"
+#include "modules/audio_processing/agc2/rnn_vad/common.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -39,6 +40,10 @@ void ExpectNearAbsolute(rtc::ArrayView<const float> expected,
                         rtc::ArrayView<const float> computed,
                         float tolerance);
 
+// Returns the optimizations supported by the CPU, including
+// Optimization::kNone.
+std::vector<Optimization> GetSupportedOptimizations();
+
 // Reader for binary files consisting of an arbitrary long sequence of elements
 // having type T. It is possible to read and cast to another type D at once.
 template <typename T, typename D = T>
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_VECTOR_MATH_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_VECTOR_MATH_H_
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#include <numeric>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/agc2/rnn_vad/common.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace rnn_vad {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Computes the dot product of |x| and |y| (AVX2 variant). Only call it after
+// checking that the CPU supports AVX2 and FMA.
+float DotProduct_AVX2(rtc::ArrayView<const float> x,
+                      rtc::ArrayView<const float> y);
+#endif
+
+// Provides optimizations for mathematical operations based on vectors.
+class VectorMath {
+ public:
+  explicit VectorMath(Optimization optimization)
+      : optimization_(optimization) {}
+
+  // Computes the dot product of two equally sized vectors.
+  float DotProduct(rtc::ArrayView<const float> x,
+                   rtc::ArrayView<const float> y) const {
+    RTC_DCHECK_EQ(x.size(), y.size());
+    const size_t size = x.size();
+    switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Optimization::kAvx2:
+        return DotProduct_AVX2(x, y);
+      case Optimization::kSse2: {
+        const size_t vector_limit = size & ~static_cast<size_t>(3);
+        __m128 sum_128 = _mm_setzero_ps();
+        for (size_t i = 0; i < vector_limit; i += 4) {
+          const __m128 x_i = _mm_loadu_ps(&x[i]);
+          const __m128 y_i = _mm_loadu_ps(&y[i]);
+          sum_128 = _mm_add_ps(sum_128, _mm_mul_ps(x_i, y_i));
+        }
+        float* v = reinterpret_cast<float*>(&sum_128);
+        float sum = v[0] + v[1] + v[2] + v[3];
+        for (size_t i = vector_limit; i < size; ++i) {
+          sum += x[i] * y[i];
+        }
+        return sum;
+      }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+      case Optimization::kNeon: {
+        const size_t vector_limit = size & ~static_cast<size_t>(3);
+        float32x4_t sum_128 = vdupq_n_f32(0.f);
+        for (size_t i = 0; i < vector_limit; i += 4) {
+          const float32x4_t x_i = vld1q_f32(&x[i]);
+          const float32x4_t y_i = vld1q_f32(&y[i]);
+          sum_128 = vmlaq_f32(sum_128, x_i, y_i);
+        }
+        float32x2_t sum_64 =
+            vadd_f32(vget_low_f32(sum_128), vget_high_f32(sum_128));
+        sum_64 = vpadd_f32(sum_64, sum_64);
+        float sum = vget_lane_f32(sum_64, 0);
+        for (size_t i = vector_limit; i < size; ++i) {
+          sum += x[i] * y[i];
+        }
+        return sum;
+      }
+#endif
+      default:
+        return std::inner_product(x.begin(), x.end(), y.begin(), 0.f);
+    }
+  }
+
+ private:
+  const Optimization optimization_;
+};
+
+}  // namespace rnn_vad
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_VECTOR_MATH_H_
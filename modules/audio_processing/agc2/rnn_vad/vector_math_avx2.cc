@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/rnn_vad/vector_math.h"
+
+#include <immintrin.h>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace rnn_vad {
+
+float DotProduct_AVX2(rtc::ArrayView<const float> x,
+                      rtc::ArrayView<const float> y) {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  const size_t size = x.size();
+  const size_t vector_limit = size & ~static_cast<size_t>(7);
+  __m256 sum_256 = _mm256_setzero_ps();
+  for (size_t i = 0; i < vector_limit; i += 8) {
+    const __m256 x_i = _mm256_loadu_ps(&x[i]);
+    const __m256 y_i = _mm256_loadu_ps(&y[i]);
+    sum_256 = _mm256_fmadd_ps(x_i, y_i, sum_256);
+  }
+
+  // Combine the accumulated vector and scalar values.
+  __m128 sum_128 = _mm_add_ps(_mm256_extractf128_ps(sum_256, 0),
+                              _mm256_extractf128_ps(sum_256, 1));
+  float* v = reinterpret_cast<float*>(&sum_128);
+  float sum = v[0] + v[1] + v[2] + v[3];
+  for (size_t i = vector_limit; i < size; ++i) {
+    sum += x[i] * y[i];
+  }
+  return sum;
+}
+
+}  // namespace rnn_vad
+}  // namespace webrtc
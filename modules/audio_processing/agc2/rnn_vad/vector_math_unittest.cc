@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/rnn_vad/vector_math.h"
+
+#include <cmath>
+#include <vector>
+
+#include "modules/audio_processing/agc2/rnn_vad/test_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace rnn_vad {
+namespace test {
+
+// Verifies that every optimization computes the dot product for vector sizes
+// that are and are not multiples of the SIMD widths.
+TEST(RnnVadTest, VectorMathDotProduct) {
+  for (Optimization optimization : GetSupportedOptimizations()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    const VectorMath vector_math(optimization);
+    for (size_t size = 0; size < 70; ++size) {
+      SCOPED_TRACE(size);
+      std::vector<float> x(size);
+      std::vector<float> y(size);
+      double expected = 0.0;
+      for (size_t i = 0; i < size; ++i) {
+        x[i] = std::sin(0.1f * i);
+        y[i] = 0.5f - 0.01f * i;
+        expected += static_cast<double>(x[i]) * y[i];
+      }
+      EXPECT_NEAR(expected, vector_math.DotProduct(x, y), 1e-5f);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace rnn_vad
+}  // namespace webrtc
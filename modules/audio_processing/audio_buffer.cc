@@ -91,11 +91,12 @@ AudioBuffer::AudioBuffer(size_t input_num_frames,
     }
   }
 
+  // The splitting filter is created by the first call to
+  // SplitIntoFrequencyBands(), since it is not used when none of the enabled
+  // submodules operates on the split bands.
   if (num_bands_ > 1) {
     split_data_.reset(
         new IFChannelBuffer(proc_num_frames_, num_proc_channels_, num_bands_));
-    splitting_filter_.reset(
-        new SplittingFilter(num_proc_channels_, num_bands_, proc_num_frames_));
   }
 }
 
@@ -450,10 +451,17 @@ void AudioBuffer::CopyLowPassToReference() {
 }
 
 void AudioBuffer::SplitIntoFrequencyBands() {
+  RTC_DCHECK(split_data_);
+  if (!splitting_filter_) {
+    splitting_filter_.reset(
+        new SplittingFilter(num_proc_channels_, num_bands_, proc_num_frames_));
+  }
   splitting_filter_->Analysis(data_.get(), split_data_.get());
 }
 
 void AudioBuffer::MergeFrequencyBands() {
+  RTC_DCHECK(splitting_filter_)
+      << "The bands must be split before they are merged.";
   splitting_filter_->Synthesis(split_data_.get(), data_.get());
 }
 
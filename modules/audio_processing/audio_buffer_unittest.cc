@@ -38,6 +38,22 @@ TEST(AudioBufferTest, SetNumChannelsSetsChannelBuffersNumChannels) {
   ExpectNumChannels(ab, kStereo);
 }
 
+TEST(AudioBufferTest, SplitsIntoFrequencyBandsOnDemand) {
+  AudioBuffer ab(kNumFrames, kMono, kNumFrames, kMono, kNumFrames);
+  ASSERT_EQ(3u, ab.num_bands());
+  for (size_t i = 0; i < kNumFrames; ++i) {
+    ab.channels_f()[0][i] = (i % 16 < 8) ? 1000.f : -1000.f;
+  }
+  ab.SplitIntoFrequencyBands();
+  float low_band_energy = 0.f;
+  for (size_t i = 0; i < ab.num_frames_per_band(); ++i) {
+    const float sample = ab.split_bands_const_f(0)[kBand0To8kHz][i];
+    low_band_energy += sample * sample;
+  }
+  EXPECT_LT(0.f, low_band_energy);
+  ab.MergeFrequencyBands();
+}
+
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 TEST(AudioBufferTest, SetNumChannelsDeathTest) {
   AudioBuffer ab(kNumFrames, kMono, kNumFrames, kMono, kNumFrames);
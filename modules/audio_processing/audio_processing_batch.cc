@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/audio_processing_batch.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "rtc_base/atomicops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/task_queue.h"
+
+namespace webrtc {
+
+AudioProcessingBatch::AudioProcessingBatch(size_t num_workers) {
+  for (size_t i = 0; i < num_workers; ++i) {
+    queues_.push_back(
+        absl::make_unique<rtc::TaskQueue>("AudioProcessingBatch"));
+  }
+}
+
+AudioProcessingBatch::~AudioProcessingBatch() {}
+
+int AudioProcessingBatch::ProcessStreams(
+    rtc::ArrayView<AudioProcessing* const> processors,
+    rtc::ArrayView<AudioFrame* const> frames) {
+  RTC_DCHECK_EQ(processors.size(), frames.size());
+  return Run(processors.size(), [&](size_t k) {
+    return processors[k]->ProcessStream(frames[k]);
+  });
+}
+
+int AudioProcessingBatch::ProcessReverseStreams(
+    rtc::ArrayView<AudioProcessing* const> processors,
+    rtc::ArrayView<AudioFrame* const> frames) {
+  RTC_DCHECK_EQ(processors.size(), frames.size());
+  return Run(processors.size(), [&](size_t k) {
+    return processors[k]->ProcessReverseStream(frames[k]);
+  });
+}
+
+int AudioProcessingBatch::Run(size_t num_streams,
+                              rtc::FunctionView<int(size_t)> process) {
+  std::vector<int> errors(num_streams, AudioProcessing::kNoError);
+  const size_t num_groups = std::min(num_streams, queues_.size() + 1);
+  auto process_group = [&](size_t group) {
+    const size_t begin = group * num_streams / num_groups;
+    const size_t end = (group + 1) * num_streams / num_groups;
+    for (size_t k = begin; k < end; ++k)
+      errors[k] = process(k);
+  };
+
+  volatile int remaining = static_cast<int>(num_groups) - 1;
+  rtc::Event done(false, false);
+  for (size_t group = 1; group < num_groups; ++group) {
+    queues_[group - 1]->PostTask([&process_group, &remaining, &done, group] {
+      process_group(group);
+      if (rtc::AtomicOps::Decrement(&remaining) == 0)
+        done.Set();
+    });
+  }
+  if (num_groups > 0)
+    process_group(0);
+  if (num_groups > 1)
+    done.Wait(rtc::Event::kForever);
+
+  for (int error : errors) {
+    if (error != AudioProcessing::kNoError)
+      return error;
+  }
+  return AudioProcessing::kNoError;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AUDIO_PROCESSING_BATCH_H_
+#define MODULES_AUDIO_PROCESSING_AUDIO_PROCESSING_BATCH_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/function_view.h"
+
+namespace rtc {
+class TaskQueue;
+}  // namespace rtc
+
+namespace webrtc {
+
+class AudioFrame;
+class AudioProcessing;
+
+// Processes one 10 ms frame for each of many independent AudioProcessing
+// instances, e.g. one per stream of a server-side mixer, on a pool of task
+// queues that can be shared by all the streams of a process. The streams of a
+// call are divided into contiguous groups, one per thread, so that a given
+// instance is only used by one thread at a time and its locks are never
+// contended.
+class AudioProcessingBatch {
+ public:
+  // Runs the groups on |num_workers| task queues besides the calling thread.
+  // With no workers, all the streams are processed on the calling thread.
+  explicit AudioProcessingBatch(size_t num_workers);
+  ~AudioProcessingBatch();
+
+  // Calls |processors[k]->ProcessStream(frames[k])| for every k, and returns
+  // once they are all done. Returns kNoError, or the error of the first stream
+  // that failed. Can be called from several threads at once, as long as an
+  // AudioProcessing instance is not passed to two calls at the same time.
+  int ProcessStreams(rtc::ArrayView<AudioProcessing* const> processors,
+                     rtc::ArrayView<AudioFrame* const> frames);
+
+  // Same as ProcessStreams(), for ProcessReverseStream().
+  int ProcessReverseStreams(rtc::ArrayView<AudioProcessing* const> processors,
+                            rtc::ArrayView<AudioFrame* const> frames);
+
+  size_t num_workers() const { return queues_.size(); }
+
+ private:
+  // Runs |process| for the |num_streams| streams and returns the first error.
+  int Run(size_t num_streams, rtc::FunctionView<int(size_t)> process);
+
+  std::vector<std::unique_ptr<rtc::TaskQueue>> queues_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(AudioProcessingBatch);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AUDIO_PROCESSING_BATCH_H_
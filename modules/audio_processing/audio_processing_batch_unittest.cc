@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/audio_processing_batch.h"
+
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "modules/audio_processing/include/mock_audio_processing.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/refcountedobject.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::Invoke;
+using ::testing::Return;
+
+constexpr size_t kNumStreams = 7;
+
+class AudioProcessingBatchTest : public ::testing::TestWithParam<size_t> {
+ protected:
+  AudioProcessingBatchTest() : frames_(kNumStreams) {
+    for (size_t k = 0; k < kNumStreams; ++k) {
+      processors_.push_back(
+          new rtc::RefCountedObject<test::MockAudioProcessing>());
+      processor_ptrs_.push_back(processors_.back().get());
+      frame_ptrs_.push_back(&frames_[k]);
+    }
+  }
+
+  std::vector<rtc::scoped_refptr<test::MockAudioProcessing>> processors_;
+  std::vector<AudioProcessing*> processor_ptrs_;
+  std::vector<AudioFrame> frames_;
+  std::vector<AudioFrame*> frame_ptrs_;
+};
+
+}  // namespace
+
+TEST_P(AudioProcessingBatchTest, ProcessesEachStreamOnce) {
+  AudioProcessingBatch batch(GetParam());
+  for (size_t k = 0; k < kNumStreams; ++k) {
+    EXPECT_CALL(*processors_[k], ProcessStream(&frames_[k]))
+        .WillOnce(Return(AudioProcessing::kNoError));
+  }
+  EXPECT_EQ(AudioProcessing::kNoError,
+            batch.ProcessStreams(processor_ptrs_, frame_ptrs_));
+}
+
+TEST_P(AudioProcessingBatchTest, ProcessesEachReverseStreamOnce) {
+  AudioProcessingBatch batch(GetParam());
+  for (size_t k = 0; k < kNumStreams; ++k) {
+    EXPECT_CALL(*processors_[k], ProcessReverseStream(&frames_[k]))
+        .WillOnce(Return(AudioProcessing::kNoError));
+  }
+  EXPECT_EQ(AudioProcessing::kNoError,
+            batch.ProcessReverseStreams(processor_ptrs_, frame_ptrs_));
+}
+
+TEST_P(AudioProcessingBatchTest, ReturnsErrorOfFirstFailingStream) {
+  AudioProcessingBatch batch(GetParam());
+  for (size_t k = 0; k < kNumStreams; ++k) {
+    int error = AudioProcessing::kNoError;
+    if (k == 3)
+      error = AudioProcessing::kBadSampleRateError;
+    else if (k == 5)
+      error = AudioProcessing::kBadNumberChannelsError;
+    EXPECT_CALL(*processors_[k], ProcessStream(&frames_[k]))
+        .WillOnce(Return(error));
+  }
+  EXPECT_EQ(AudioProcessing::kBadSampleRateError,
+            batch.ProcessStreams(processor_ptrs_, frame_ptrs_));
+}
+
+TEST_P(AudioProcessingBatchTest, RunsStreamsOnWorkers) {
+  AudioProcessingBatch batch(GetParam());
+  const rtc::PlatformThreadRef caller = rtc::CurrentThreadRef();
+  std::vector<int> on_caller(kNumStreams, 0);
+  for (size_t k = 0; k < kNumStreams; ++k) {
+    EXPECT_CALL(*processors_[k], ProcessStream(&frames_[k]))
+        .WillOnce(Invoke([&on_caller, caller, k](AudioFrame*) {
+          on_caller[k] =
+              rtc::IsThreadRefEqual(rtc::CurrentThreadRef(), caller) ? 1 : 0;
+          return AudioProcessing::kNoError;
+        }));
+  }
+  EXPECT_EQ(AudioProcessing::kNoError,
+            batch.ProcessStreams(processor_ptrs_, frame_ptrs_));
+
+  // The first group of streams is processed on the calling thread, and the
+  // others only when there are no workers.
+  EXPECT_EQ(1, on_caller[0]);
+  EXPECT_EQ(GetParam() == 0 ? 1 : 0, on_caller[kNumStreams - 1]);
+}
+
+TEST(AudioProcessingBatch, HandlesNoStreams) {
+  AudioProcessingBatch batch(2);
+  EXPECT_EQ(AudioProcessing::kNoError, batch.ProcessStreams({}, {}));
+}
+
+INSTANTIATE_TEST_CASE_P(NumWorkers,
+                        AudioProcessingBatchTest,
+                        ::testing::Values(0, 1, 3, 10));
+
+}  // namespace webrtc
@@ -71,6 +71,11 @@ constexpr int kRuntimeSettingQueueSize = 100;
 
 namespace {
 
+// One capture frame per second is timed, and the submodule processing times
+// are averaged over ten timed frames.
+constexpr int kProcessingTimeSamplingIntervalFrames = 100;
+constexpr int kProcessingTimeNumFramesPerWindow = 10;
+
 static bool LayoutHasKeyboard(AudioProcessing::ChannelLayout layout) {
   switch (layout) {
     case AudioProcessing::kMono:
@@ -217,11 +222,15 @@ bool AudioProcessingImpl::ApmSubmoduleStates::Update(
 
 bool AudioProcessingImpl::ApmSubmoduleStates::CaptureMultiBandSubModulesActive()
     const {
+  // The transient suppressor analyzes the lowest band, but bands are only
+  // merged back by the submodules that modify them.
 #if WEBRTC_INTELLIGIBILITY_ENHANCER
   return CaptureMultiBandProcessingActive() ||
-         intelligibility_enhancer_enabled_ || voice_activity_detector_enabled_;
+         intelligibility_enhancer_enabled_ ||
+         voice_activity_detector_enabled_ || transient_suppressor_enabled_;
 #else
-  return CaptureMultiBandProcessingActive() || voice_activity_detector_enabled_;
+  return CaptureMultiBandProcessingActive() ||
+         voice_activity_detector_enabled_ || transient_suppressor_enabled_;
 #endif
 }
 
@@ -381,7 +390,9 @@ AudioProcessingImpl::AudioProcessingImpl(
 #else
       capture_(config.Get<ExperimentalNs>().enabled),
 #endif
-      capture_nonlocked_(config.Get<Intelligibility>().enabled) {
+      capture_nonlocked_(config.Get<Intelligibility>().enabled),
+      capture_processing_time_stats_(kProcessingTimeSamplingIntervalFrames,
+                                     kProcessingTimeNumFramesPerWindow) {
   {
     rtc::CritScope cs_render(&crit_render_);
     rtc::CritScope cs_capture(&crit_capture_);
@@ -1002,7 +1013,7 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         aec_render_queue_element_max_size_);
 
     aec_render_signal_queue_.reset(
-        new SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
+        new SpscSwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<float>(
                 aec_render_queue_element_max_size_)));
@@ -1022,7 +1033,8 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         aecm_render_queue_element_max_size_);
 
     aecm_render_signal_queue_.reset(
-        new SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>(
+        new SpscSwapQueue<std::vector<int16_t>,
+                          RenderQueueItemVerifier<int16_t>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<int16_t>(
                 aecm_render_queue_element_max_size_)));
@@ -1041,7 +1053,8 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         agc_render_queue_element_max_size_);
 
     agc_render_signal_queue_.reset(
-        new SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>(
+        new SpscSwapQueue<std::vector<int16_t>,
+                          RenderQueueItemVerifier<int16_t>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<int16_t>(
                 agc_render_queue_element_max_size_)));
@@ -1060,7 +1073,7 @@ void AudioProcessingImpl::AllocateRenderQueue() {
         red_render_queue_element_max_size_);
 
     red_render_signal_queue_.reset(
-        new SwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
+        new SpscSwapQueue<std::vector<float>, RenderQueueItemVerifier<float>>(
             kMaxNumFramesToBuffer, template_queue_element,
             RenderQueueItemVerifier<float>(
                 red_render_queue_element_max_size_)));
@@ -1177,6 +1190,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
                public_submodules_->echo_control_mobile->is_enabled()));
 
   MaybeUpdateHistograms();
+  capture_processing_time_stats_.StartFrame();
+  using Submodule = ProcessingTimeStats::Submodule;
 
   AudioBuffer* capture_buffer = capture_.capture_audio.get();  // For brevity.
 
@@ -1207,11 +1222,15 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
         capture_.prev_analog_mic_level != -1;
     capture_.prev_analog_mic_level = analog_mic_level;
 
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kEchoCanceller);
     private_submodules_->echo_controller->AnalyzeCapture(capture_buffer);
   }
 
   if (constants_.use_experimental_agc &&
       public_submodules_->gain_control->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kGainControl);
     private_submodules_->agc_manager->AnalyzePreProcess(
         capture_buffer->channels()[0], capture_buffer->num_channels(),
         capture_nonlocked_.capture_processing_format.num_frames());
@@ -1234,11 +1253,21 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   // TODO(peah): Move the AEC3 low-cut filter to this place.
   if (private_submodules_->low_cut_filter &&
       !private_submodules_->echo_controller) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kHighPassFilter);
     private_submodules_->low_cut_filter->Process(capture_buffer);
   }
-  RETURN_ON_ERR(
-      public_submodules_->gain_control->AnalyzeCaptureAudio(capture_buffer));
-  public_submodules_->noise_suppression->AnalyzeCaptureAudio(capture_buffer);
+  if (public_submodules_->gain_control->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kGainControl);
+    RETURN_ON_ERR(
+        public_submodules_->gain_control->AnalyzeCaptureAudio(capture_buffer));
+  }
+  if (public_submodules_->noise_suppression->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kNoiseSuppressor);
+    public_submodules_->noise_suppression->AnalyzeCaptureAudio(capture_buffer);
+  }
 
   // Ensure that the stream delay was set before the call to the
   // AEC ProcessCaptureAudio function.
@@ -1255,9 +1284,13 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
           stream_delay_ms());
     }
 
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kEchoCanceller);
     private_submodules_->echo_controller->ProcessCapture(
         capture_buffer, capture_.echo_path_gain_change);
-  } else {
+  } else if (public_submodules_->echo_cancellation->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kEchoCanceller);
     RETURN_ON_ERR(public_submodules_->echo_cancellation->ProcessCaptureAudio(
         capture_buffer, stream_delay_ms()));
   }
@@ -1266,7 +1299,11 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
       public_submodules_->noise_suppression->is_enabled()) {
     capture_buffer->CopyLowPassToReference();
   }
-  public_submodules_->noise_suppression->ProcessCaptureAudio(capture_buffer);
+  if (public_submodules_->noise_suppression->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kNoiseSuppressor);
+    public_submodules_->noise_suppression->ProcessCaptureAudio(capture_buffer);
+  }
 #if WEBRTC_INTELLIGIBILITY_ENHANCER
   if (capture_nonlocked_.intelligibility_enabled) {
     RTC_DCHECK(public_submodules_->noise_suppression->is_enabled());
@@ -1288,21 +1325,31 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   if (!(private_submodules_->echo_controller ||
-        public_submodules_->echo_cancellation->is_enabled())) {
+        public_submodules_->echo_cancellation->is_enabled()) &&
+      public_submodules_->echo_control_mobile->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kEchoCanceller);
     RETURN_ON_ERR(public_submodules_->echo_control_mobile->ProcessCaptureAudio(
         capture_buffer, stream_delay_ms()));
   }
 
-  public_submodules_->voice_detection->ProcessCaptureAudio(capture_buffer);
+  if (public_submodules_->voice_detection->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kVoiceDetection);
+    public_submodules_->voice_detection->ProcessCaptureAudio(capture_buffer);
+  }
 
-  if (constants_.use_experimental_agc &&
-      public_submodules_->gain_control->is_enabled()) {
-    private_submodules_->agc_manager->Process(
-        capture_buffer->split_bands_const(0)[kBand0To8kHz],
-        capture_buffer->num_frames_per_band(), capture_nonlocked_.split_rate);
+  if (public_submodules_->gain_control->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kGainControl);
+    if (constants_.use_experimental_agc) {
+      private_submodules_->agc_manager->Process(
+          capture_buffer->split_bands_const(0)[kBand0To8kHz],
+          capture_buffer->num_frames_per_band(), capture_nonlocked_.split_rate);
+    }
+    RETURN_ON_ERR(public_submodules_->gain_control->ProcessCaptureAudio(
+        capture_buffer, echo_cancellation()->stream_has_echo()));
   }
-  RETURN_ON_ERR(public_submodules_->gain_control->ProcessCaptureAudio(
-      capture_buffer, echo_cancellation()->stream_has_echo()));
 
   if (submodule_states_.CaptureMultiBandProcessingActive() &&
       SampleRateSupportsMultiBand(
@@ -1335,6 +1382,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   if (config_.gain_controller2.enabled) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kGainController2);
     private_submodules_->gain_controller2->NotifyAnalogLevel(
         gain_control()->stream_analog_level());
     private_submodules_->gain_controller2->Process(capture_buffer);
@@ -1345,7 +1394,11 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   }
 
   // The level estimator operates on the recombined data.
-  public_submodules_->level_estimator->ProcessStream(capture_buffer);
+  if (public_submodules_->level_estimator->is_enabled()) {
+    ProcessingTimeStats::ScopedTimer timer(&capture_processing_time_stats_,
+                                           Submodule::kLevelEstimator);
+    public_submodules_->level_estimator->ProcessStream(capture_buffer);
+  }
 
   capture_output_rms_.Analyze(rtc::ArrayView<const int16_t>(
       capture_buffer->channels_const()[0],
@@ -1358,6 +1411,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
                                 levels.peak, 1, RmsLevel::kMinLevelDb, 64);
   }
 
+  capture_processing_time_stats_.EndFrame();
   capture_.was_stream_delay_set = false;
   return kNoError;
 }
@@ -1665,6 +1719,24 @@ AudioProcessing::AudioProcessingStatistics AudioProcessingImpl::GetStatistics()
 AudioProcessingStats AudioProcessingImpl::GetStatistics(
     bool has_remote_tracks) const {
   AudioProcessingStats stats;
+  {
+    rtc::CritScope cs_capture(&crit_capture_);
+    using Submodule = ProcessingTimeStats::Submodule;
+    const ProcessingTimeStats& times = capture_processing_time_stats_;
+    stats.high_pass_filter_time_us =
+        times.AverageTimeUs(Submodule::kHighPassFilter);
+    stats.echo_canceller_time_us =
+        times.AverageTimeUs(Submodule::kEchoCanceller);
+    stats.noise_suppressor_time_us =
+        times.AverageTimeUs(Submodule::kNoiseSuppressor);
+    stats.gain_control_time_us = times.AverageTimeUs(Submodule::kGainControl);
+    stats.gain_controller2_time_us =
+        times.AverageTimeUs(Submodule::kGainController2);
+    stats.level_estimator_time_us =
+        times.AverageTimeUs(Submodule::kLevelEstimator);
+    stats.voice_detection_time_us =
+        times.AverageTimeUs(Submodule::kVoiceDetection);
+  }
   if (has_remote_tracks) {
     EchoCancellation::Metrics metrics;
     if (private_submodules_->echo_controller) {
@@ -52,7 +52,8 @@ enum class SettingsType {
   kDefaultApmDesktopAndIntelligibilityEnhancer,
   kAllSubmodulesTurnedOff,
   kDefaultApmDesktopWithoutDelayAgnostic,
-  kDefaultApmDesktopWithoutExtendedFilter
+  kDefaultApmDesktopWithoutExtendedFilter,
+  kFullBandSubmodulesOnly
 };
 
 // Variables related to the audio data and formats.
@@ -90,7 +91,8 @@ struct SimulationConfig {
     const SettingsType desktop_settings[] = {
         SettingsType::kDefaultApmDesktop, SettingsType::kAllSubmodulesTurnedOff,
         SettingsType::kDefaultApmDesktopWithoutDelayAgnostic,
-        SettingsType::kDefaultApmDesktopWithoutExtendedFilter};
+        SettingsType::kDefaultApmDesktopWithoutExtendedFilter,
+        SettingsType::kFullBandSubmodulesOnly};
 
     const int desktop_sample_rates[] = {8000, 16000, 32000, 48000};
 
@@ -149,6 +151,9 @@ struct SimulationConfig {
       case SettingsType::kDefaultApmDesktopWithoutExtendedFilter:
         description = "DefaultApmDesktopWithoutExtendedFilter";
         break;
+      case SettingsType::kFullBandSubmodulesOnly:
+        description = "FullBandSubmodulesOnly";
+        break;
     }
     return description;
   }
@@ -574,6 +579,19 @@ class CallSimulator : public ::testing::TestWithParam<SimulationConfig> {
         apm_->SetExtraOptions(config);
         break;
       }
+      case SettingsType::kFullBandSubmodulesOnly: {
+        // None of these submodules operates on the split bands, so the band
+        // splitting is skipped.
+        apm_.reset(AudioProcessingBuilder().Create());
+        ASSERT_TRUE(!!apm_);
+        turn_off_default_apm_runtime_settings(apm_.get());
+        ASSERT_EQ(apm_->kNoError, apm_->level_estimator()->Enable(true));
+        AudioProcessing::Config apm_config;
+        apm_config.gain_controller2.enabled = true;
+        apm_config.residual_echo_detector.enabled = false;
+        apm_->ApplyConfig(apm_config);
+        break;
+      }
     }
 
     render_thread_state_.reset(new TimedThreadApiProcessor(
@@ -49,6 +49,17 @@ struct AudioProcessingStats {
   // milliseconds and the value is the instantaneous value at the time of the
   // call to |GetStatistics()|.
   absl::optional<int32_t> delay_ms;
+
+  // The average time in microseconds that each capture submodule spends on a
+  // 10 ms frame. The times are measured on one frame per second and updated
+  // every ten seconds. Only set for the submodules that are active.
+  absl::optional<double> high_pass_filter_time_us;
+  absl::optional<double> echo_canceller_time_us;
+  absl::optional<double> noise_suppressor_time_us;
+  absl::optional<double> gain_control_time_us;
+  absl::optional<double> gain_controller2_time_us;
+  absl::optional<double> level_estimator_time_us;
+  absl::optional<double> voice_detection_time_us;
 };
 
 }  // namespace webrtc
@@ -10,6 +10,8 @@
 
 #include "modules/audio_processing/low_cut_filter.h"
 
+#include <algorithm>
+
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "modules/audio_processing/audio_buffer.h"
 
@@ -17,6 +19,44 @@ namespace webrtc {
 namespace {
 const int16_t kFilterCoefficients8kHz[5] = {3798, -7596, 3798, 7807, -3733};
 const int16_t kFilterCoefficients[5] = {4012, -8024, 4012, 8002, -3913};
+
+// Filters one sample of each of |num_channels| channels, with the arithmetic
+// of LowCutFilter::BiquadFilter::Process(). The state arrays have an entry per
+// channel and never overlap, which lets the compiler vectorize the loop.
+void FilterSampleOfEachChannel(const int16_t* ba,
+                               size_t num_channels,
+                               int16_t* __restrict data,
+                               int16_t* __restrict x0,
+                               int16_t* __restrict x1,
+                               int16_t* __restrict y0,
+                               int16_t* __restrict y1,
+                               int16_t* __restrict y2,
+                               int16_t* __restrict y3) {
+  const int32_t b0 = ba[0];
+  const int32_t b1 = ba[1];
+  const int32_t b2 = ba[2];
+  const int32_t a1 = ba[3];
+  const int32_t a2 = ba[4];
+  for (size_t c = 0; c < num_channels; ++c) {
+    int32_t tmp_int32 = (y1[c] * a1 + y3[c] * a2) >> 15;
+    tmp_int32 += y0[c] * a1 + y2[c] * a2;
+    tmp_int32 *= 2;
+    tmp_int32 += data[c] * b0 + x0[c] * b1 + x1[c] * b2;
+
+    x1[c] = x0[c];
+    x0[c] = data[c];
+
+    y2[c] = y0[c];
+    y3[c] = y1[c];
+    y0[c] = static_cast<int16_t>(tmp_int32 >> 13);
+    y1[c] = static_cast<int16_t>((tmp_int32 & 0x00001FFF) * 4);
+
+    tmp_int32 += 2048;
+    tmp_int32 = std::min<int32_t>(134217727,
+                                  std::max<int32_t>(-134217728, tmp_int32));
+    data[c] = static_cast<int16_t>(tmp_int32 >> 12);
+  }
+}
 }  // namespace
 
 class LowCutFilter::BiquadFilter {
@@ -98,4 +138,58 @@ void LowCutFilter::Process(AudioBuffer* audio) {
   }
 }
 
+LowCutFilterBatch::LowCutFilterBatch(size_t num_channels, int sample_rate_hz)
+    : ba_(sample_rate_hz == AudioProcessing::kSampleRate8kHz
+              ? kFilterCoefficients8kHz
+              : kFilterCoefficients),
+      x0_(num_channels, 0),
+      x1_(num_channels, 0),
+      y0_(num_channels, 0),
+      y1_(num_channels, 0),
+      y2_(num_channels, 0),
+      y3_(num_channels, 0) {}
+
+LowCutFilterBatch::~LowCutFilterBatch() {}
+
+void LowCutFilterBatch::Process(rtc::ArrayView<AudioBuffer* const> audio) {
+  if (audio.empty())
+    return;
+  const size_t num_channels = x0_.size();
+  const size_t num_frames = audio[0]->num_frames_per_band();
+  RTC_DCHECK_GE(160, num_frames);
+  interleaved_.resize(num_frames * num_channels);
+
+  size_t channel = 0;
+  for (AudioBuffer* buffer : audio) {
+    RTC_DCHECK_EQ(num_frames, buffer->num_frames_per_band());
+    for (size_t i = 0; i < buffer->num_channels(); ++i, ++channel) {
+      RTC_DCHECK_LT(channel, num_channels);
+      const int16_t* band = buffer->split_bands(i)[kBand0To8kHz];
+      for (size_t j = 0; j < num_frames; ++j)
+        interleaved_[j * num_channels + channel] = band[j];
+    }
+  }
+  RTC_DCHECK_EQ(num_channels, channel);
+
+  ProcessInterleaved(interleaved_.data(), num_frames);
+
+  channel = 0;
+  for (AudioBuffer* buffer : audio) {
+    for (size_t i = 0; i < buffer->num_channels(); ++i, ++channel) {
+      int16_t* band = buffer->split_bands(i)[kBand0To8kHz];
+      for (size_t j = 0; j < num_frames; ++j)
+        band[j] = interleaved_[j * num_channels + channel];
+    }
+  }
+}
+
+void LowCutFilterBatch::ProcessInterleaved(int16_t* data, size_t num_frames) {
+  const size_t num_channels = x0_.size();
+  for (size_t i = 0; i < num_frames; ++i) {
+    FilterSampleOfEachChannel(ba_, num_channels, &data[i * num_channels],
+                              x0_.data(), x1_.data(), y0_.data(), y1_.data(),
+                              y2_.data(), y3_.data());
+  }
+}
+
 }  // namespace webrtc
@@ -14,6 +14,7 @@
 #include <memory>
 #include <vector>
 
+#include "api/array_view.h"
 #include "rtc_base/constructormagic.h"
 
 namespace webrtc {
@@ -31,6 +32,40 @@ class LowCutFilter {
   std::vector<std::unique_ptr<BiquadFilter>> filters_;
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(LowCutFilter);
 };
+
+// Applies the LowCutFilter to many independent streams in one call, e.g. all
+// the streams handled by a server. The filter states are stored as one array
+// per state variable with an entry per channel, and all the channels are
+// filtered side by side for each sample, so that the compiler can vectorize
+// the filter across the channels. The output is bitexact to LowCutFilter.
+class LowCutFilterBatch {
+ public:
+  // |num_channels| is the number of channels summed over all the streams.
+  LowCutFilterBatch(size_t num_channels, int sample_rate_hz);
+  ~LowCutFilterBatch();
+
+  // Filters the lowest band of every channel of |audio|. The channels of the
+  // buffers are assigned to the filters in order, and the buffers must all
+  // have the same band length.
+  void Process(rtc::ArrayView<AudioBuffer* const> audio);
+
+  // Filters |num_frames| samples of each channel in |data|, laid out so that
+  // |data[i * num_channels + c]| is sample i of channel c.
+  void ProcessInterleaved(int16_t* data, size_t num_frames);
+
+ private:
+  const int16_t* const ba_;
+  // Filter input states x[i-1] and x[i-2].
+  std::vector<int16_t> x0_;
+  std::vector<int16_t> x1_;
+  // Filter output states, as the high and low parts of y[i-1] and y[i-2].
+  std::vector<int16_t> y0_;
+  std::vector<int16_t> y1_;
+  std::vector<int16_t> y2_;
+  std::vector<int16_t> y3_;
+  std::vector<int16_t> interleaved_;
+  RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(LowCutFilterBatch);
+};
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_LOW_CUT_FILTER_H_
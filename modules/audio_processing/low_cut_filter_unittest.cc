@@ -7,6 +7,7 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include <memory>
 #include <vector>
 
 #include "api/array_view.h"
@@ -14,6 +15,7 @@
 #include "modules/audio_processing/low_cut_filter.h"
 #include "modules/audio_processing/test/audio_buffer_tools.h"
 #include "modules/audio_processing/test/bitexactness_tools.h"
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -677,4 +679,55 @@ TEST(LowCutFilterBitExactnessTest, Stereo16kHzConverged) {
       16000, 2, CreateVector(rtc::ArrayView<const float>(kReferenceInput)),
       CreateVector(rtc::ArrayView<const float>(kReference)));
 }
+
+// Verifies that filtering many streams at once gives the same output as
+// filtering each of them with its own LowCutFilter.
+TEST(LowCutFilterBatchTest, BitexactToLowCutFilter) {
+  for (int sample_rate : {8000, 16000, 48000}) {
+    const std::vector<size_t> kStreamChannels = {1, 2, 1, 1, 2};
+    Random random_generator(42U);
+    std::vector<std::unique_ptr<LowCutFilter>> filters;
+    std::vector<std::unique_ptr<AudioBuffer>> buffers;
+    std::vector<std::unique_ptr<AudioBuffer>> batch_buffers;
+    size_t total_channels = 0;
+    for (size_t num_channels : kStreamChannels) {
+      const StreamConfig config(sample_rate, num_channels, false);
+      filters.push_back(
+          std::unique_ptr<LowCutFilter>(new LowCutFilter(num_channels,
+                                                         sample_rate)));
+      for (auto* buffers_list : {&buffers, &batch_buffers}) {
+        buffers_list->push_back(std::unique_ptr<AudioBuffer>(new AudioBuffer(
+            config.num_frames(), num_channels, config.num_frames(),
+            num_channels, config.num_frames())));
+      }
+      total_channels += num_channels;
+    }
+    LowCutFilterBatch batch_filter(total_channels, sample_rate);
+
+    for (int frame = 0; frame < 20; ++frame) {
+      std::vector<AudioBuffer*> batch;
+      for (size_t k = 0; k < kStreamChannels.size(); ++k) {
+        const StreamConfig config(sample_rate, kStreamChannels[k], false);
+        std::vector<float> input(config.num_frames() * config.num_channels());
+        for (float& sample : input)
+          sample = 2.f * random_generator.Rand<float>() - 1.f;
+        test::CopyVectorToAudioBuffer(config, input, buffers[k].get());
+        test::CopyVectorToAudioBuffer(config, input, batch_buffers[k].get());
+        filters[k]->Process(buffers[k].get());
+        batch.push_back(batch_buffers[k].get());
+      }
+      batch_filter.Process(batch);
+
+      for (size_t k = 0; k < kStreamChannels.size(); ++k) {
+        for (size_t c = 0; c < kStreamChannels[k]; ++c) {
+          const int16_t* expected = buffers[k]->split_bands(c)[kBand0To8kHz];
+          const int16_t* actual =
+              batch_buffers[k]->split_bands(c)[kBand0To8kHz];
+          for (size_t i = 0; i < buffers[k]->num_frames_per_band(); ++i)
+            ASSERT_EQ(expected[i], actual[i]);
+        }
+      }
+    }
+  }
+}
 }  // namespace webrtc
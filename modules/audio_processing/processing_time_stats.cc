@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/processing_time_stats.h"
+
+#include "rtc_base/checks.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+
+constexpr size_t ProcessingTimeStats::kNumSubmodules;
+
+ProcessingTimeStats::ScopedTimer::ScopedTimer(ProcessingTimeStats* stats,
+                                              Submodule submodule)
+    : stats_(stats->timing_frame_ ? stats : nullptr), submodule_(submodule) {
+  if (stats_) {
+    start_time_ns_ = rtc::TimeNanos();
+  }
+}
+
+ProcessingTimeStats::ScopedTimer::~ScopedTimer() {
+  if (stats_) {
+    const size_t index = static_cast<size_t>(submodule_);
+    stats_->frame_times_ns_[index] += rtc::TimeNanos() - start_time_ns_;
+    stats_->timed_in_frame_[index] = true;
+  }
+}
+
+ProcessingTimeStats::ProcessingTimeStats(int sampling_interval_frames,
+                                         int num_frames_per_window)
+    : sampling_interval_frames_(sampling_interval_frames),
+      num_frames_per_window_(num_frames_per_window) {
+  RTC_DCHECK_LT(0, sampling_interval_frames_);
+  RTC_DCHECK_LT(0, num_frames_per_window_);
+  frame_times_ns_.fill(0);
+  timed_in_frame_.fill(false);
+  time_sums_ns_.fill(0);
+  num_frames_.fill(0);
+}
+
+ProcessingTimeStats::~ProcessingTimeStats() = default;
+
+void ProcessingTimeStats::StartFrame() {
+  timing_frame_ = frame_counter_ == 0;
+  if (++frame_counter_ == sampling_interval_frames_) {
+    frame_counter_ = 0;
+  }
+  if (timing_frame_) {
+    frame_times_ns_.fill(0);
+    timed_in_frame_.fill(false);
+  }
+}
+
+void ProcessingTimeStats::EndFrame() {
+  if (!timing_frame_) {
+    return;
+  }
+  timing_frame_ = false;
+  for (size_t k = 0; k < kNumSubmodules; ++k) {
+    if (timed_in_frame_[k]) {
+      time_sums_ns_[k] += frame_times_ns_[k];
+      ++num_frames_[k];
+    }
+  }
+
+  if (++num_timed_frames_ < num_frames_per_window_) {
+    return;
+  }
+  for (size_t k = 0; k < kNumSubmodules; ++k) {
+    if (num_frames_[k] > 0) {
+      average_times_us_[k] = static_cast<double>(time_sums_ns_[k]) /
+                             (num_frames_[k] * rtc::kNumNanosecsPerMicrosec);
+    } else {
+      average_times_us_[k] = absl::nullopt;
+    }
+  }
+  num_timed_frames_ = 0;
+  time_sums_ns_.fill(0);
+  num_frames_.fill(0);
+}
+
+absl::optional<double> ProcessingTimeStats::AverageTimeUs(
+    Submodule submodule) const {
+  return average_times_us_[static_cast<size_t>(submodule)];
+}
+
+}  // namespace webrtc
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_PROCESSING_TIME_STATS_H_
+#define MODULES_AUDIO_PROCESSING_PROCESSING_TIME_STATS_H_
+
+#include <array>
+
+#include "absl/types/optional.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Measures the time spent in the capture submodules of the audio processing.
+// To keep the overhead negligible, only one frame out of
+// |sampling_interval_frames| is timed. The averages over the timed frames are
+// published once |num_frames_per_window| frames have been timed.
+class ProcessingTimeStats {
+ public:
+  enum class Submodule {
+    kHighPassFilter = 0,
+    kEchoCanceller,
+    kNoiseSuppressor,
+    kGainControl,
+    kGainController2,
+    kLevelEstimator,
+    kVoiceDetection,
+  };
+  static constexpr size_t kNumSubmodules = 7;
+
+  // Times the duration of its scope for |submodule| if the current frame is
+  // timed, and does nothing otherwise.
+  class ScopedTimer {
+   public:
+    ScopedTimer(ProcessingTimeStats* stats, Submodule submodule);
+    ~ScopedTimer();
+
+   private:
+    ProcessingTimeStats* const stats_;
+    const Submodule submodule_;
+    int64_t start_time_ns_ = 0;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(ScopedTimer);
+  };
+
+  ProcessingTimeStats(int sampling_interval_frames, int num_frames_per_window);
+  ~ProcessingTimeStats();
+
+  // Must be called at the start and the end of each capture frame. A frame
+  // that is not ended, e.g., due to an error, is not counted.
+  void StartFrame();
+  void EndFrame();
+
+  // Returns the average time in microseconds that |submodule| took to process
+  // a frame, over the latest complete window. Not set before the first window
+  // has completed or when the submodule did not run during that window.
+  absl::optional<double> AverageTimeUs(Submodule submodule) const;
+
+ private:
+  const int sampling_interval_frames_;
+  const int num_frames_per_window_;
+  int frame_counter_ = 0;
+  bool timing_frame_ = false;
+  int num_timed_frames_ = 0;
+  std::array<int64_t, kNumSubmodules> frame_times_ns_;
+  std::array<bool, kNumSubmodules> timed_in_frame_;
+  std::array<int64_t, kNumSubmodules> time_sums_ns_;
+  std::array<int, kNumSubmodules> num_frames_;
+  std::array<absl::optional<double>, kNumSubmodules> average_times_us_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ProcessingTimeStats);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_PROCESSING_TIME_STATS_H_
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/processing_time_stats.h"
+
+#include "rtc_base/fakeclock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using Submodule = ProcessingTimeStats::Submodule;
+
+constexpr int kSamplingIntervalFrames = 3;
+constexpr int kNumFramesPerWindow = 2;
+
+// Processes one frame in which the noise suppressor takes |ns_time_us| and
+// the echo canceller is called twice, taking |aec_time_us| each time.
+void ProcessFrame(ProcessingTimeStats* stats,
+                  rtc::ScopedFakeClock* clock,
+                  int ns_time_us,
+                  int aec_time_us) {
+  stats->StartFrame();
+  {
+    ProcessingTimeStats::ScopedTimer timer(stats, Submodule::kNoiseSuppressor);
+    clock->AdvanceTimeMicros(ns_time_us);
+  }
+  for (int k = 0; k < 2; ++k) {
+    ProcessingTimeStats::ScopedTimer timer(stats, Submodule::kEchoCanceller);
+    clock->AdvanceTimeMicros(aec_time_us);
+  }
+  stats->EndFrame();
+}
+
+}  // namespace
+
+TEST(ProcessingTimeStats, NotSetBeforeFirstWindow) {
+  rtc::ScopedFakeClock clock;
+  ProcessingTimeStats stats(kSamplingIntervalFrames, kNumFramesPerWindow);
+  for (int k = 0; k < kSamplingIntervalFrames * (kNumFramesPerWindow - 1);
+       ++k) {
+    ProcessFrame(&stats, &clock, 10, 20);
+  }
+  EXPECT_FALSE(stats.AverageTimeUs(Submodule::kNoiseSuppressor));
+  EXPECT_FALSE(stats.AverageTimeUs(Submodule::kEchoCanceller));
+
+  ProcessFrame(&stats, &clock, 10, 20);
+  EXPECT_TRUE(stats.AverageTimeUs(Submodule::kNoiseSuppressor));
+  EXPECT_TRUE(stats.AverageTimeUs(Submodule::kEchoCanceller));
+}
+
+TEST(ProcessingTimeStats, AveragesTimedFramesOnly) {
+  rtc::ScopedFakeClock clock;
+  ProcessingTimeStats stats(kSamplingIntervalFrames, kNumFramesPerWindow);
+  // Only the first frame of each sampling interval is timed.
+  for (int k = 0; k < kNumFramesPerWindow; ++k) {
+    ProcessFrame(&stats, &clock, 10 * (k + 1), 20);
+    for (int j = 1; j < kSamplingIntervalFrames; ++j) {
+      ProcessFrame(&stats, &clock, 1000, 1000);
+    }
+  }
+  ASSERT_TRUE(stats.AverageTimeUs(Submodule::kNoiseSuppressor));
+  EXPECT_DOUBLE_EQ(15.0, *stats.AverageTimeUs(Submodule::kNoiseSuppressor));
+  // The time of all the calls within a frame is added.
+  ASSERT_TRUE(stats.AverageTimeUs(Submodule::kEchoCanceller));
+  EXPECT_DOUBLE_EQ(40.0, *stats.AverageTimeUs(Submodule::kEchoCanceller));
+  EXPECT_FALSE(stats.AverageTimeUs(Submodule::kGainControl));
+}
+
+TEST(ProcessingTimeStats, IgnoresFramesThatAreNotEnded) {
+  rtc::ScopedFakeClock clock;
+  ProcessingTimeStats stats(1, kNumFramesPerWindow);
+  stats.StartFrame();
+  {
+    ProcessingTimeStats::ScopedTimer timer(&stats, Submodule::kGainControl);
+    clock.AdvanceTimeMicros(1000);
+  }
+  for (int k = 0; k < kNumFramesPerWindow; ++k) {
+    ProcessFrame(&stats, &clock, 10, 20);
+  }
+  EXPECT_FALSE(stats.AverageTimeUs(Submodule::kGainControl));
+  ASSERT_TRUE(stats.AverageTimeUs(Submodule::kNoiseSuppressor));
+  EXPECT_DOUBLE_EQ(10.0, *stats.AverageTimeUs(Submodule::kNoiseSuppressor));
+}
+
+}  // namespace webrtc
@@ -10,6 +10,7 @@
 
 #include "modules/audio_processing/transient/moving_moments.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "rtc_base/checks.h"
@@ -17,11 +18,12 @@
 namespace webrtc {
 
 MovingMoments::MovingMoments(size_t length)
-    : length_(length), queue_(), sum_(0.0), sum_of_squares_(0.0) {
+    : length_(length),
+      queue_(new float[length]()),
+      queue_index_(0),
+      sum_(0.0),
+      sum_of_squares_(0.0) {
   RTC_DCHECK_GT(length, 0);
-  for (size_t i = 0; i < length; ++i) {
-    queue_.push(0.0);
-  }
 }
 
 MovingMoments::~MovingMoments() {}
@@ -36,9 +38,10 @@ void MovingMoments::CalculateMoments(const float* in,
   RTC_DCHECK(second);
 
   for (size_t i = 0; i < in_length; ++i) {
-    const float old_value = queue_.front();
-    queue_.pop();
-    queue_.push(in[i]);
+    const float old_value = queue_[queue_index_];
+    queue_[queue_index_] = in[i];
+    if (++queue_index_ == length_)
+      queue_index_ = 0;
 
     sum_ += in[i] - old_value;
     sum_of_squares_ += in[i] * in[i] - old_value * old_value;
@@ -13,7 +13,9 @@
 
 #include <stddef.h>
 
-#include <queue>
+#include <stddef.h>
+
+#include <memory>
 
 namespace webrtc {
 
@@ -40,8 +42,10 @@ class MovingMoments {
 
  private:
   size_t length_;
-  // A queue holding the |length_| latest input values.
-  std::queue<float> queue_;
+  // A ring buffer holding the |length_| latest input values, the oldest of
+  // them at |queue_index_|.
+  std::unique_ptr<float[]> queue_;
+  size_t queue_index_;
   // Sum of the values of the queue.
   float sum_;
   // Sum of the squares of the values of the queue.
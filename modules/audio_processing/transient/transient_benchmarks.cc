@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "modules/audio_processing/transient/daubechies_8_wavelet_coeffs.h"
+#include "modules/audio_processing/transient/transient_suppressor.h"
+#include "modules/audio_processing/transient/wpd_tree.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+namespace {
+
+const int kChunksPerSecond = 100;
+const int kNumChunks = 50;
+// The number of levels of the TransientDetector tree.
+const int kLevels = 3;
+
+// Returns |num_chunks| chunks of noise with a click every 10 chunks.
+std::vector<std::vector<float>> CreateChunks(int sample_rate_hz,
+                                             int num_chunks) {
+  Random random(0x1234);
+  std::vector<std::vector<float>> chunks(num_chunks);
+  for (int i = 0; i < num_chunks; ++i) {
+    const int amplitude = i % 10 == 0 ? 20000 : 1000;
+    chunks[i].resize(sample_rate_hz / kChunksPerSecond);
+    for (float& sample : chunks[i])
+      sample = random.Rand(-amplitude, amplitude);
+  }
+  return chunks;
+}
+
+// Updates the wavelet packet decomposition tree of the TransientDetector on
+// every chunk of range(0) Hz audio.
+void BM_WPDTreeUpdate(benchmark::State& state) {
+  const int sample_rate_hz = state.range(0);
+  const std::vector<std::vector<float>> chunks =
+      CreateChunks(sample_rate_hz, kNumChunks);
+  const size_t chunk_length = chunks[0].size();
+  WPDTree tree(chunk_length, kDaubechies8HighPassCoefficients,
+               kDaubechies8LowPassCoefficients, kDaubechies8CoefficientsLength,
+               kLevels);
+  size_t chunk = 0;
+  for (auto _ : state) {
+    tree.Update(chunks[chunk].data(), chunk_length);
+    chunk = (chunk + 1) % chunks.size();
+  }
+}
+BENCHMARK(BM_WPDTreeUpdate)->Arg(16000)->Arg(48000);
+
+// Suppresses the clicks in chunks of range(0) Hz mono audio while keys are
+// being pressed, so that both the detection and the suppression run.
+void BM_TransientSuppressorSuppress(benchmark::State& state) {
+  const int sample_rate_hz = state.range(0);
+  const std::vector<std::vector<float>> chunks =
+      CreateChunks(sample_rate_hz, kNumChunks);
+  const size_t chunk_length = chunks[0].size();
+  TransientSuppressor suppressor;
+  suppressor.Initialize(sample_rate_hz, sample_rate_hz, 1);
+  std::vector<float> data(chunk_length);
+  size_t chunk = 0;
+  for (auto _ : state) {
+    data = chunks[chunk];
+    suppressor.Suppress(data.data(), chunk_length, 1, nullptr, chunk_length,
+                        nullptr, 0, 0.f, chunk % 5 == 0);
+    chunk = (chunk + 1) % chunks.size();
+  }
+}
+BENCHMARK(BM_TransientSuppressorSuppress)->Arg(16000)->Arg(48000);
+
+}  // namespace
+}  // namespace webrtc
@@ -10,6 +10,15 @@
 
 #include "modules/audio_processing/transient/transient_suppressor.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <math.h>
 #include <string.h>
 #include <cmath>
@@ -41,6 +50,112 @@ float ComplexMagnitude(float a, float b) {
   return std::abs(a) + std::abs(b);
 }
 
+// The loops below are vectorized with the same operations, in the same order,
+// as the scalar code that handles the remaining samples, to keep the results
+// identical.
+
+// Computes |out| = |in| * |window|.
+void ApplyWindow(const float* in,
+                 const float* window,
+                 size_t length,
+                 float* out) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  for (; i + 4 <= length; i += 4) {
+    _mm_storeu_ps(&out[i],
+                  _mm_mul_ps(_mm_loadu_ps(&in[i]), _mm_loadu_ps(&window[i])));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; i + 4 <= length; i += 4)
+    vst1q_f32(&out[i], vmulq_f32(vld1q_f32(&in[i]), vld1q_f32(&window[i])));
+#endif
+  for (; i < length; ++i)
+    out[i] = in[i] * window[i];
+}
+
+// Adds |in| * |window| * |scaling| to |out|.
+void AddWindowed(const float* in,
+                 const float* window,
+                 float scaling,
+                 size_t length,
+                 float* out) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 scaling_128 = _mm_set1_ps(scaling);
+  for (; i + 4 <= length; i += 4) {
+    const __m128 windowed =
+        _mm_mul_ps(_mm_loadu_ps(&in[i]), _mm_loadu_ps(&window[i]));
+    _mm_storeu_ps(&out[i], _mm_add_ps(_mm_loadu_ps(&out[i]),
+                                      _mm_mul_ps(windowed, scaling_128)));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; i + 4 <= length; i += 4) {
+    const float32x4_t windowed =
+        vmulq_f32(vld1q_f32(&in[i]), vld1q_f32(&window[i]));
+    vst1q_f32(&out[i],
+              vaddq_f32(vld1q_f32(&out[i]), vmulq_n_f32(windowed, scaling)));
+  }
+#endif
+  for (; i < length; ++i)
+    out[i] += in[i] * window[i] * scaling;
+}
+
+// Computes the ComplexMagnitude() of the |num_bins| interleaved complex
+// values of |spectrum|.
+void ComputeMagnitudes(const float* spectrum,
+                       size_t num_bins,
+                       float* magnitudes) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  for (; i + 4 <= num_bins; i += 4) {
+    const __m128 a = _mm_and_ps(_mm_loadu_ps(&spectrum[i * 2]), abs_mask);
+    const __m128 b = _mm_and_ps(_mm_loadu_ps(&spectrum[i * 2 + 4]), abs_mask);
+    const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm_storeu_ps(&magnitudes[i], _mm_add_ps(re, im));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; i + 4 <= num_bins; i += 4) {
+    const float32x4x2_t bins = vld2q_f32(&spectrum[i * 2]);
+    vst1q_f32(&magnitudes[i],
+              vaddq_f32(vabsq_f32(bins.val[0]), vabsq_f32(bins.val[1])));
+  }
+#endif
+  for (; i < num_bins; ++i)
+    magnitudes[i] = ComplexMagnitude(spectrum[i * 2], spectrum[i * 2 + 1]);
+}
+
+// Moves |spectral_mean| towards |magnitudes| by |kMeanIIRCoefficient|.
+void UpdateSpectralMean(const float* magnitudes,
+                        size_t num_bins,
+                        float* spectral_mean) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  const __m128 mean_factor = _mm_set1_ps(1 - kMeanIIRCoefficient);
+  const __m128 magnitude_factor = _mm_set1_ps(kMeanIIRCoefficient);
+  for (; i + 4 <= num_bins; i += 4) {
+    const __m128 mean =
+        _mm_mul_ps(mean_factor, _mm_loadu_ps(&spectral_mean[i]));
+    const __m128 magnitude =
+        _mm_mul_ps(magnitude_factor, _mm_loadu_ps(&magnitudes[i]));
+    _mm_storeu_ps(&spectral_mean[i], _mm_add_ps(mean, magnitude));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; i + 4 <= num_bins; i += 4) {
+    const float32x4_t mean =
+        vmulq_n_f32(vld1q_f32(&spectral_mean[i]), 1 - kMeanIIRCoefficient);
+    const float32x4_t magnitude =
+        vmulq_n_f32(vld1q_f32(&magnitudes[i]), kMeanIIRCoefficient);
+    vst1q_f32(&spectral_mean[i], vaddq_f32(mean, magnitude));
+  }
+#endif
+  for (; i < num_bins; ++i) {
+    spectral_mean[i] = (1 - kMeanIIRCoefficient) * spectral_mean[i] +
+                       kMeanIIRCoefficient * magnitudes[i];
+  }
+}
+
 }  // namespace
 
 TransientSuppressor::TransientSuppressor()
@@ -226,10 +341,8 @@ void TransientSuppressor::Suppress(float* in_ptr,
                                    float* spectral_mean,
                                    float* out_ptr) {
   // Go to frequency domain.
-  for (size_t i = 0; i < analysis_length_; ++i) {
-    // TODO(aluebs): Rename windows
-    fft_buffer_[i] = in_ptr[i] * window_[i];
-  }
+  // TODO(aluebs): Rename windows
+  ApplyWindow(in_ptr, window_, analysis_length_, fft_buffer_.get());
 
   WebRtc_rdft(analysis_length_, 1, fft_buffer_.get(), ip_.get(), wfft_.get());
 
@@ -239,10 +352,8 @@ void TransientSuppressor::Suppress(float* in_ptr,
   fft_buffer_[analysis_length_ + 1] = 0.f;
   fft_buffer_[1] = 0.f;
 
-  for (size_t i = 0; i < complex_analysis_length_; ++i) {
-    magnitudes_[i] =
-        ComplexMagnitude(fft_buffer_[i * 2], fft_buffer_[i * 2 + 1]);
-  }
+  ComputeMagnitudes(fft_buffer_.get(), complex_analysis_length_,
+                    magnitudes_.get());
   // Restore audio if necessary.
   if (suppression_enabled_) {
     if (use_hard_restoration_) {
@@ -253,10 +364,8 @@ void TransientSuppressor::Suppress(float* in_ptr,
   }
 
   // Update the spectral mean.
-  for (size_t i = 0; i < complex_analysis_length_; ++i) {
-    spectral_mean[i] = (1 - kMeanIIRCoefficient) * spectral_mean[i] +
-                       kMeanIIRCoefficient * magnitudes_[i];
-  }
+  UpdateSpectralMean(magnitudes_.get(), complex_analysis_length_,
+                     spectral_mean);
 
   // Back to time domain.
   // Put R[n/2] back in fft_buffer_[1].
@@ -265,9 +374,8 @@ void TransientSuppressor::Suppress(float* in_ptr,
   WebRtc_rdft(analysis_length_, -1, fft_buffer_.get(), ip_.get(), wfft_.get());
   const float fft_scaling = 2.f / analysis_length_;
 
-  for (size_t i = 0; i < analysis_length_; ++i) {
-    out_ptr[i] += fft_buffer_[i] * window_[i] * fft_scaling;
-  }
+  AddWindowed(fft_buffer_.get(), window_, fft_scaling, analysis_length_,
+              out_ptr);
 }
 
 void TransientSuppressor::UpdateKeypress(bool key_pressed) {
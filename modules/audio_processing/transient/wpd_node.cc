@@ -10,29 +10,75 @@
 
 #include "modules/audio_processing/transient/wpd_node.h"
 
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 #include <math.h>
 #include <string.h>
 
-#include "common_audio/fir_filter.h"
-#include "common_audio/fir_filter_factory.h"
-#include "modules/audio_processing/transient/dyadic_decimator.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
+namespace {
+
+// Returns the dot product of |coefficients_length| samples from |in| and the
+// |coefficients|, a multiple of four of them. The four partial sums are added
+// the same way as in the SSE2 and NEON FIRFilters.
+float FilterSample(const float* in,
+                   const float* coefficients,
+                   size_t coefficients_length) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  __m128 sum = _mm_setzero_ps();
+  for (size_t j = 0; j < coefficients_length; j += 4) {
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(in + j),
+                                     _mm_loadu_ps(coefficients + j)));
+  }
+  sum = _mm_add_ps(_mm_movehl_ps(sum, sum), sum);
+  return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+#elif defined(WEBRTC_HAS_NEON)
+  float32x4_t sum = vmovq_n_f32(0);
+  for (size_t j = 0; j < coefficients_length; j += 4)
+    sum = vmlaq_f32(sum, vld1q_f32(in + j), vld1q_f32(coefficients + j));
+  float32x2_t half = vadd_f32(vget_high_f32(sum), vget_low_f32(sum));
+  return vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+  float sum = 0.f;
+  for (size_t j = 0; j < coefficients_length; ++j)
+    sum += in[j] * coefficients[j];
+  return sum;
+#endif
+}
+
+}  // namespace
 
 WPDNode::WPDNode(size_t length,
                  const float* coefficients,
                  size_t coefficients_length)
-    :  // The data buffer has parent data length to be able to contain and
-       // filter it.
-      data_(new float[2 * length + 1]),
+    : data_(new float[length]),
       length_(length),
-      filter_(
-          CreateFirFilter(coefficients, coefficients_length, 2 * length + 1)) {
+      // Closest higher multiple of four.
+      coefficients_length_((coefficients_length + 3) & ~0x03),
+      state_length_(coefficients_length_ - 1),
+      coefficients_(new float[coefficients_length_]),
+      // Room for the parent data, which has up to 2 * |length| + 1 samples.
+      state_(new float[state_length_ + 2 * length + 1]) {
   RTC_DCHECK_GT(length, 0);
   RTC_DCHECK(coefficients);
   RTC_DCHECK_GT(coefficients_length, 0);
-  memset(data_.get(), 0.f, (2 * length + 1) * sizeof(data_[0]));
+  memset(data_.get(), 0.f, length * sizeof(data_[0]));
+  // Add zeros at the start of the reversed coefficients.
+  const size_t padding = coefficients_length_ - coefficients_length;
+  memset(coefficients_.get(), 0, padding * sizeof(coefficients_[0]));
+  for (size_t i = 0; i < coefficients_length; ++i)
+    coefficients_[i + padding] = coefficients[coefficients_length - i - 1];
+  memset(state_.get(), 0,
+         (state_length_ + 2 * length + 1) * sizeof(state_[0]));
 }
 
 WPDNode::~WPDNode() {}
@@ -42,22 +88,19 @@ int WPDNode::Update(const float* parent_data, size_t parent_data_length) {
     return -1;
   }
 
-  // Filter data.
-  filter_->Filter(parent_data, parent_data_length, data_.get());
-
-  // Decimate data.
-  const bool kOddSequence = true;
-  size_t output_samples = DyadicDecimate(data_.get(), parent_data_length,
-                                         kOddSequence, data_.get(), length_);
-  if (output_samples != length_) {
-    return -1;
-  }
-
-  // Get abs to all values.
+  // Filter the odd samples of the data, which are the ones the dyadic
+  // decimation keeps, and get their abs.
+  memcpy(&state_[state_length_], parent_data,
+         parent_data_length * sizeof(parent_data[0]));
   for (size_t i = 0; i < length_; ++i) {
-    data_[i] = fabs(data_[i]);
+    data_[i] = fabs(FilterSample(&state_[2 * i + 1], coefficients_.get(),
+                                 coefficients_length_));
   }
 
+  // Keep the last samples for the next update.
+  memmove(state_.get(), &state_[parent_data_length],
+          state_length_ * sizeof(state_[0]));
+
   return 0;
 }
 
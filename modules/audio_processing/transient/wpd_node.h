@@ -15,8 +15,6 @@
 
 namespace webrtc {
 
-class FIRFilter;
-
 // A single node of a Wavelet Packet Decomposition (WPD) tree.
 class WPDNode {
  public:
@@ -37,7 +35,14 @@ class WPDNode {
  private:
   std::unique_ptr<float[]> data_;
   size_t length_;
-  std::unique_ptr<FIRFilter> filter_;
+  // The filter works like FIRFilter, but only computes the samples that are
+  // kept by the decimation. The coefficients are padded to a multiple of four
+  // and reversed, and |state_| holds the last inputs followed by the parent
+  // data.
+  const size_t coefficients_length_;
+  const size_t state_length_;
+  std::unique_ptr<float[]> coefficients_;
+  std::unique_ptr<float[]> state_;
 };
 
 }  // namespace webrtc
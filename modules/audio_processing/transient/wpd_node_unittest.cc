@@ -10,8 +10,17 @@
 
 #include "modules/audio_processing/transient/wpd_node.h"
 
+#include <math.h>
 #include <string.h>
 
+#include <memory>
+#include <vector>
+
+#include "common_audio/fir_filter.h"
+#include "common_audio/fir_filter_factory.h"
+#include "modules/audio_processing/transient/daubechies_8_wavelet_coeffs.h"
+#include "modules/audio_processing/transient/dyadic_decimator.h"
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -53,6 +62,34 @@ TEST(WPDNodeTest, UpdateWithArbitraryDataAndArbitraryFilter) {
   EXPECT_NEAR(0.94f, node.data()[4], kTolerance);
 }
 
+// The node only filters the samples that the decimation keeps, which has to
+// give the same data as filtering all of them and decimating, update after
+// update.
+TEST(WPDNodeTest, UpdateMatchesFilteringAndDecimating) {
+  const size_t kLength = 60;
+  Random random(0x9abc);
+  for (size_t parent_length : {2 * kLength, 2 * kLength + 1}) {
+    WPDNode node(kLength, kDaubechies8HighPassCoefficients,
+                 kDaubechies8CoefficientsLength);
+    std::unique_ptr<FIRFilter> filter(
+        CreateFirFilter(kDaubechies8HighPassCoefficients,
+                        kDaubechies8CoefficientsLength, parent_length));
+    std::vector<float> parent_data(parent_length);
+    std::vector<float> filtered(parent_length);
+    std::vector<float> expected(kLength);
+    for (int update = 0; update < 5; ++update) {
+      for (float& sample : parent_data)
+        sample = random.Rand(-32768, 32767);
+      ASSERT_EQ(0, node.Update(parent_data.data(), parent_length));
+      filter->Filter(parent_data.data(), parent_length, filtered.data());
+      ASSERT_EQ(kLength, DyadicDecimate(filtered.data(), parent_length, true,
+                                        expected.data(), kLength));
+      for (size_t i = 0; i < kLength; ++i)
+        EXPECT_FLOAT_EQ(fabs(expected[i]), node.data()[i]);
+    }
+  }
+}
+
 TEST(WPDNodeTest, ExpectedErrorReturnValue) {
   WPDNode node(kDataLength, kCoefficients, kCoefficientsLength);
   EXPECT_EQ(-1, node.Update(kParentData, kParentDataLength - 1));
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+
+#include "logging/rtc_event_log/mock/mock_rtc_event_log.h"
+#include "modules/congestion_controller/bbr/bbr_factory.h"
+#include "modules/congestion_controller/goog_cc/include/goog_cc_factory.h"
+#include "modules/congestion_controller/test/network_controller_benchmark.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace bbr {
+namespace test {
+namespace {
+using webrtc::test::NetworkControllerBenchmark;
+
+NetworkControllerBenchmark::Result RunAndPrint(
+    NetworkControllerFactoryInterface* factory,
+    const NetworkControllerBenchmark::Config& config,
+    const std::string& controller,
+    const std::string& scenario) {
+  NetworkControllerBenchmark::Result result =
+      NetworkControllerBenchmark(config).Run(factory);
+  webrtc::test::PrintResult("throughput", controller, scenario,
+                            result.throughput.kbps(), "kbps", false);
+  webrtc::test::PrintResult("mean_queue_delay", controller, scenario,
+                            result.mean_queue_delay.ms(), "ms", false);
+  webrtc::test::PrintResult("p95_queue_delay", controller, scenario,
+                            result.p95_queue_delay.ms(), "ms", false);
+  webrtc::test::PrintResult("loss", controller, scenario,
+                            result.loss_ratio * 100, "%", false);
+  if (result.convergence_time) {
+    webrtc::test::PrintResult("convergence_time", controller, scenario,
+                              result.convergence_time->ms(), "ms", false);
+  }
+  return result;
+}
+
+void CompareWithGoogCc(const NetworkControllerBenchmark::Config& config,
+                       const std::string& scenario,
+                       NetworkControllerBenchmark::Result* bbr_result,
+                       NetworkControllerBenchmark::Result* goog_cc_result) {
+  ::testing::NiceMock<MockRtcEventLog> event_log;
+  BbrNetworkControllerFactory bbr_factory;
+  GoogCcNetworkControllerFactory goog_cc_factory(&event_log);
+  *bbr_result = RunAndPrint(&bbr_factory, config, "_bbr", scenario);
+  *goog_cc_result = RunAndPrint(&goog_cc_factory, config, "_goog_cc", scenario);
+}
+}  // namespace
+
+TEST(BbrBenchmarkTest, ComparesWithGoogCcOnIdleLink) {
+  NetworkControllerBenchmark::Config config;
+  config.link_capacity = DataRate::kbps(2000);
+  config.propagation_delay = TimeDelta::ms(50);
+  config.duration = TimeDelta::seconds(30);
+  NetworkControllerBenchmark::Result bbr;
+  NetworkControllerBenchmark::Result goog_cc;
+  CompareWithGoogCc(config, "idle_link", &bbr, &goog_cc);
+
+  // BBR fills the link quickly but keeps a standing queue, goog_cc ramps up
+  // slowly and keeps the queue short.
+  EXPECT_GE(bbr.throughput, config.link_capacity * 0.8);
+  EXPECT_LE(bbr.mean_queue_delay, TimeDelta::ms(200));
+  EXPECT_LE(bbr.loss_ratio, 0.01);
+  EXPECT_GE(goog_cc.throughput, config.link_capacity * 0.4);
+  EXPECT_LE(goog_cc.mean_queue_delay, TimeDelta::ms(50));
+  EXPECT_LE(goog_cc.loss_ratio, 0.01);
+}
+
+TEST(BbrBenchmarkTest, ComparesWithGoogCcUnderCrossTraffic) {
+  NetworkControllerBenchmark::Config config;
+  config.link_capacity = DataRate::kbps(2000);
+  config.propagation_delay = TimeDelta::ms(50);
+  config.queue_length_packets = 100;
+  config.cross_traffic_rate = DataRate::kbps(1000);
+  config.cross_traffic_start = TimeDelta::seconds(15);
+  config.duration = TimeDelta::seconds(45);
+  NetworkControllerBenchmark::Result bbr;
+  NetworkControllerBenchmark::Result goog_cc;
+  CompareWithGoogCc(config, "cross_traffic", &bbr, &goog_cc);
+
+  // Both back off to leave room for the cross traffic.
+  EXPECT_LE(bbr.throughput, config.link_capacity);
+  EXPECT_GE(bbr.throughput, DataRate::kbps(800));
+  EXPECT_LE(bbr.loss_ratio, 0.1);
+  EXPECT_GE(goog_cc.throughput, DataRate::kbps(500));
+  EXPECT_LE(goog_cc.loss_ratio, 0.1);
+}
+
+}  // namespace test
+}  // namespace bbr
+}  // namespace webrtc
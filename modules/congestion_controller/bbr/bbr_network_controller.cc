@@ -57,9 +57,9 @@ const size_t kGainCycleLength = 8;
 // The size of the bandwidth filter window, in round-trips.
 const BbrRoundTripCount kBandwidthWindowSize = kGainCycleLength + 2;
 
-// The time after which the current min_rtt value expires.
+// The default time after which the current min_rtt value expires.
 constexpr int64_t kMinRttExpirySeconds = 10;
-// The minimum time the connection can spend in PROBE_RTT mode.
+// The default minimum time the connection can spend in PROBE_RTT mode.
 constexpr int64_t kProbeRttTimeMs = 200;
 // If the bandwidth does not increase by the factor of |kStartupGrowthTarget|
 // within |kRoundTripsWithoutGrowthBeforeExitingStartup| rounds, the connection
@@ -119,7 +119,10 @@ BbrNetworkController::BbrControllerConfig::BbrControllerConfig(
       probe_rtt_skipped_if_similar_rtt("probe_rtt_skipped_if_similar_rtt",
                                        false),
       probe_rtt_disabled_if_app_limited("probe_rtt_disabled_if_app_limited",
-                                        false) {
+                                        false),
+      min_rtt_expiry("min_rtt_expiry",
+                     TimeDelta::seconds(kMinRttExpirySeconds)),
+      probe_rtt_duration("probe_rtt_duration", TimeDelta::ms(kProbeRttTimeMs)) {
   ParseFieldTrial(
       {
           &exit_startup_on_loss,
@@ -133,12 +136,14 @@ BbrNetworkController::BbrControllerConfig::BbrControllerConfig(
           &max_aggregation_bytes_multiplier,
           &max_congestion_window,
           &min_congestion_window,
+          &min_rtt_expiry,
           &num_startup_rtts,
           &pacing_rate_as_target,
           &probe_bw_pacing_gain_offset,
           &probe_rtt_based_on_bdp,
           &probe_rtt_congestion_window_gain,
           &probe_rtt_disabled_if_app_limited,
+          &probe_rtt_duration,
           &probe_rtt_skipped_if_similar_rtt,
           &rate_based_recovery,
           &rate_based_startup,
@@ -590,10 +595,9 @@ bool BbrNetworkController::UpdateBandwidthAndMinRtt(
   min_rtt_since_last_probe_rtt_ =
       std::min(min_rtt_since_last_probe_rtt_, sample_rtt);
 
-  const TimeDelta kMinRttExpiry = TimeDelta::seconds(kMinRttExpirySeconds);
   // Do not expire min_rtt if none was ever available.
-  bool min_rtt_expired =
-      !min_rtt_.IsZero() && (now > (min_rtt_timestamp_ + kMinRttExpiry));
+  bool min_rtt_expired = !min_rtt_.IsZero() &&
+                         (now > (min_rtt_timestamp_ + config_.min_rtt_expiry));
 
   if (min_rtt_expired || sample_rtt < min_rtt_ || min_rtt_.IsZero()) {
     if (ShouldExtendMinRttExpiry()) {
@@ -726,7 +730,7 @@ void BbrNetworkController::MaybeEnterOrExitProbeRtt(
       // we allow an extra packet since QUIC checks CWND before sending a
       // packet.
       if (msg.data_in_flight < ProbeRttCongestionWindow() + kMaxPacketSize) {
-        exit_probe_rtt_at_ = msg.feedback_time + TimeDelta::ms(kProbeRttTimeMs);
+        exit_probe_rtt_at_ = msg.feedback_time + config_.probe_rtt_duration;
         probe_rtt_round_passed_ = false;
       }
     } else {
@@ -113,6 +113,12 @@ class BbrNetworkController : public NetworkControllerInterface {
     // If true, disable PROBE_RTT entirely as long as the connection was
     // recently app limited.
     FieldTrialParameter<bool> probe_rtt_disabled_if_app_limited;
+    // How long min_rtt is trusted before PROBE_RTT is entered to measure it
+    // again, and how long PROBE_RTT lasts at least. Media senders can use a
+    // shorter and less frequent PROBE_RTT, since the encoder rate is lowered
+    // for its duration.
+    FieldTrialParameter<TimeDelta> min_rtt_expiry;
+    FieldTrialParameter<TimeDelta> probe_rtt_duration;
 
     explicit BbrControllerConfig(std::string field_trial);
     ~BbrControllerConfig();
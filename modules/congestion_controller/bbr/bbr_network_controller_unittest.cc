@@ -95,6 +95,17 @@ TEST_F(BbrNetworkControllerTest, SendsConfigurationOnFirstProcess) {
   EXPECT_THAT(*update.congestion_window, Property(&DataSize::IsFinite, true));
 }
 
+TEST_F(BbrNetworkControllerTest, ParsesProbeRttTiming) {
+  BbrNetworkController::BbrControllerConfig default_config("");
+  EXPECT_EQ(TimeDelta::seconds(10), default_config.min_rtt_expiry.Get());
+  EXPECT_EQ(TimeDelta::ms(200), default_config.probe_rtt_duration.Get());
+
+  BbrNetworkController::BbrControllerConfig config(
+      "min_rtt_expiry:20s,probe_rtt_duration:100ms");
+  EXPECT_EQ(TimeDelta::seconds(20), config.min_rtt_expiry.Get());
+  EXPECT_EQ(TimeDelta::ms(100), config.probe_rtt_duration.Get());
+}
+
 TEST_F(BbrNetworkControllerTest, SendsConfigurationOnNetworkRouteChanged) {
   std::unique_ptr<NetworkControllerInterface> controller_;
   controller_.reset(new BbrNetworkController(InitialConfig()));
@@ -15,6 +15,7 @@
 
 #include "modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "modules/remote_bitrate_estimator/test/bwe_test_logging.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
 namespace webrtc {
@@ -28,19 +29,17 @@ MedianSlopeEstimator::MedianSlopeEstimator(size_t window_size,
       num_of_deltas_(0),
       accumulated_delay_(0),
       delay_hist_(),
-      median_filter_(0.5),
-      trendline_(0) {}
-
-MedianSlopeEstimator::~MedianSlopeEstimator() {}
-
-MedianSlopeEstimator::DelayInfo::DelayInfo(int64_t time,
-                                           double delay,
-                                           size_t slope_count)
-    : time(time), delay(delay) {
-  slopes.reserve(slope_count);
+      slopes_(window_size * (window_size - 1)),
+      next_row_(0),
+      trendline_(0) {
+  RTC_DCHECK_GE(window_size, 2);
+  sorted_slopes_.reserve(window_size * (window_size - 1) / 2);
+  merged_slopes_.reserve(window_size * (window_size - 1) / 2);
+  removed_slopes_.reserve(window_size - 1);
+  added_slopes_.reserve(window_size - 1);
 }
 
-MedianSlopeEstimator::DelayInfo::~DelayInfo() = default;
+MedianSlopeEstimator::~MedianSlopeEstimator() {}
 
 void MedianSlopeEstimator::Update(double recv_delta_ms,
                                   double send_delta_ms,
@@ -56,14 +55,15 @@ void MedianSlopeEstimator::Update(double recv_delta_ms,
 
   // If the window is full, remove the |window_size_| - 1 slopes that belong to
   // the oldest point.
+  removed_slopes_.clear();
   if (delay_hist_.size() == window_size_) {
-    for (double slope : delay_hist_.front().slopes) {
-      const bool success = median_filter_.Erase(slope);
-      RTC_CHECK(success);
-    }
+    const DelayInfo& oldest = delay_hist_.front();
+    const double* row = SlopeRow(oldest.row);
+    removed_slopes_.assign(row, row + oldest.slope_count);
     delay_hist_.pop_front();
   }
   // Add |window_size_| - 1 new slopes.
+  added_slopes_.clear();
   for (auto& old_delay : delay_hist_) {
     if (arrival_time_ms - old_delay.time != 0) {
       // The C99 standard explicitly states that casts and assignments must
@@ -75,19 +75,45 @@ void MedianSlopeEstimator::Update(double recv_delta_ms,
       // this assumption even if they wanted to.
       double slope = (accumulated_delay_ - old_delay.delay) /
                      static_cast<double>(arrival_time_ms - old_delay.time);
-      median_filter_.Insert(slope);
+      added_slopes_.push_back(slope);
       // We want to avoid issues with different rounding mode / precision
       // which we might get if we recomputed the slope when we remove it.
-      old_delay.slopes.push_back(slope);
+      SlopeRow(old_delay.row)[old_delay.slope_count++] = slope;
     }
   }
-  delay_hist_.emplace_back(arrival_time_ms, accumulated_delay_,
-                           window_size_ - 1);
+  delay_hist_.push_back({arrival_time_ms, accumulated_delay_, 0, next_row_});
+  next_row_ = (next_row_ + 1) % window_size_;
+  UpdateSortedSlopes(&removed_slopes_, &added_slopes_);
+
   // Recompute the median slope.
-  if (delay_hist_.size() == window_size_)
-    trendline_ = median_filter_.GetPercentileValue();
+  if (delay_hist_.size() == window_size_) {
+    trendline_ = sorted_slopes_.empty()
+                     ? 0
+                     : sorted_slopes_[(sorted_slopes_.size() - 1) / 2];
+  }
 
   BWE_TEST_LOGGING_PLOT(1, "trendline_slope", arrival_time_ms, trendline_);
 }
 
+void MedianSlopeEstimator::UpdateSortedSlopes(std::vector<double>* removed,
+                                              std::vector<double>* added) {
+  std::sort(removed->begin(), removed->end());
+  std::sort(added->begin(), added->end());
+  merged_slopes_.clear();
+  auto removed_it = removed->begin();
+  auto added_it = added->begin();
+  for (double slope : sorted_slopes_) {
+    if (removed_it != removed->end() && *removed_it == slope) {
+      ++removed_it;
+      continue;
+    }
+    while (added_it != added->end() && *added_it < slope)
+      merged_slopes_.push_back(*added_it++);
+    merged_slopes_.push_back(slope);
+  }
+  RTC_CHECK(removed_it == removed->end());
+  merged_slopes_.insert(merged_slopes_.end(), added_it, added->end());
+  sorted_slopes_.swap(merged_slopes_);
+}
+
 }  // namespace webrtc
@@ -17,7 +17,6 @@
 #include <vector>
 
 #include "rtc_base/constructormagic.h"
-#include "rtc_base/numerics/percentile_filter.h"
 
 namespace webrtc {
 
@@ -48,12 +47,19 @@ class MedianSlopeEstimator {
 
  private:
   struct DelayInfo {
-    DelayInfo(int64_t time, double delay, size_t slope_count);
-    ~DelayInfo();
     int64_t time;
     double delay;
-    std::vector<double> slopes;
+    // Number of slopes to later points, stored in row |row| of |slopes_|.
+    size_t slope_count;
+    size_t row;
   };
+
+  double* SlopeRow(size_t row) { return &slopes_[row * (window_size_ - 1)]; }
+  // Removes |removed| from and inserts |added| into |sorted_slopes_|, in one
+  // pass. Both are sorted in the process.
+  void UpdateSortedSlopes(std::vector<double>* removed,
+                          std::vector<double>* added);
+
   // Parameters.
   const size_t window_size_;
   const double threshold_gain_;
@@ -62,7 +68,17 @@ class MedianSlopeEstimator {
   // Theil-Sen robust line fitting
   double accumulated_delay_;
   std::deque<DelayInfo> delay_hist_;
-  PercentileFilter<double> median_filter_;
+  // The slopes from each point of the window to the later points, one row of
+  // |window_size_| - 1 per point, so that they can be removed exactly as they
+  // were added.
+  std::vector<double> slopes_;
+  // Points leave in the order they came, so rows are used round robin.
+  size_t next_row_;
+  // All slopes of the window in order, the median is looked up by index.
+  std::vector<double> sorted_slopes_;
+  std::vector<double> merged_slopes_;
+  std::vector<double> removed_slopes_;
+  std::vector<double> added_slopes_;
   double trendline_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(MedianSlopeEstimator);
@@ -9,6 +9,12 @@
  */
 
 #include "modules/congestion_controller/goog_cc/median_slope_estimator.h"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
 #include "rtc_base/random.h"
 #include "test/gtest.h"
 
@@ -69,4 +75,39 @@ TEST(MedianSlopeEstimator, JitteryLineSlopeZero) {
   TestEstimator(0, kAvgTimeBetweenPackets / 3.0, 0.02);
 }
 
+TEST(MedianSlopeEstimator, MatchesMedianOfAllSlopesInWindow) {
+  MedianSlopeEstimator estimator(kWindowSize, kGain);
+  Random random(0x1234567);
+  std::deque<std::pair<int64_t, double>> window;
+  int64_t arrival_time_ms = random.Rand(1000000);
+  double accumulated_delay = 0;
+  for (int i = 0; i < 2000; ++i) {
+    // Repeated arrival times give pairs without a slope.
+    int64_t send_delta = kAvgTimeBetweenPackets;
+    int64_t recv_delta = random.Rand(0, 20);
+    arrival_time_ms += recv_delta;
+    accumulated_delay += recv_delta - send_delta;
+    estimator.Update(recv_delta, send_delta, arrival_time_ms);
+
+    window.emplace_back(arrival_time_ms, accumulated_delay);
+    if (window.size() > kWindowSize)
+      window.pop_front();
+    if (window.size() < kWindowSize)
+      continue;
+    std::vector<double> slopes;
+    for (size_t j = 0; j < window.size(); ++j) {
+      for (size_t k = j + 1; k < window.size(); ++k) {
+        if (window[k].first == window[j].first)
+          continue;
+        slopes.push_back((window[k].second - window[j].second) /
+                         static_cast<double>(window[k].first -
+                                             window[j].first));
+      }
+    }
+    std::sort(slopes.begin(), slopes.end());
+    double expected = slopes.empty() ? 0 : slopes[(slopes.size() - 1) / 2];
+    ASSERT_EQ(expected, estimator.trendline_slope());
+  }
+}
+
 }  // namespace webrtc
@@ -22,30 +22,6 @@
 namespace webrtc {
 
 namespace {
-absl::optional<double> LinearFitSlope(
-    const std::deque<std::pair<double, double>>& points) {
-  RTC_DCHECK(points.size() >= 2);
-  // Compute the "center of mass".
-  double sum_x = 0;
-  double sum_y = 0;
-  for (const auto& point : points) {
-    sum_x += point.first;
-    sum_y += point.second;
-  }
-  double x_avg = sum_x / points.size();
-  double y_avg = sum_y / points.size();
-  // Compute the slope k = \sum (x_i-x_avg)(y_i-y_avg) / \sum (x_i-x_avg)^2
-  double numerator = 0;
-  double denominator = 0;
-  for (const auto& point : points) {
-    numerator += (point.first - x_avg) * (point.second - y_avg);
-    denominator += (point.first - x_avg) * (point.first - x_avg);
-  }
-  if (denominator == 0)
-    return absl::nullopt;
-  return numerator / denominator;
-}
-
 constexpr double kMaxAdaptOffsetMs = 15.0;
 constexpr double kOverUsingTimeThreshold = 10;
 constexpr int kMinNumDeltas = 60;
@@ -65,6 +41,12 @@ TrendlineEstimator::TrendlineEstimator(size_t window_size,
       accumulated_delay_(0),
       smoothed_delay_(0),
       delay_hist_(),
+      origin_(0, 0),
+      sum_x_(0),
+      sum_y_(0),
+      sum_xx_(0),
+      sum_xy_(0),
+      updates_since_recompute_(0),
       trendline_(0),
       k_up_(0.0087),
       k_down_(0.039),
@@ -101,11 +83,16 @@ void TrendlineEstimator::Update(double recv_delta_ms,
   delay_hist_.push_back(std::make_pair(
       static_cast<double>(arrival_time_ms - first_arrival_time_ms_),
       smoothed_delay_));
-  if (delay_hist_.size() > window_size_)
+  AddToSums(delay_hist_.back(), 1);
+  if (delay_hist_.size() > window_size_) {
+    AddToSums(delay_hist_.front(), -1);
     delay_hist_.pop_front();
+  }
+  if (++updates_since_recompute_ >= window_size_)
+    RecomputeSums();
   if (delay_hist_.size() == window_size_) {
     // Only update trendline_ if it is possible to fit a line to the data.
-    trendline_ = LinearFitSlope(delay_hist_).value_or(trendline_);
+    trendline_ = LinearFitSlope().value_or(trendline_);
   }
 
   BWE_TEST_LOGGING_PLOT(1, "trendline_slope", arrival_time_ms, trendline_);
@@ -160,6 +147,36 @@ void TrendlineEstimator::Detect(double offset,
   UpdateThreshold(T, now_ms);
 }
 
+void TrendlineEstimator::AddToSums(const std::pair<double, double>& point,
+                                   double sign) {
+  const double x = point.first - origin_.first;
+  const double y = point.second - origin_.second;
+  sum_x_ += sign * x;
+  sum_y_ += sign * y;
+  sum_xx_ += sign * x * x;
+  sum_xy_ += sign * x * y;
+}
+
+void TrendlineEstimator::RecomputeSums() {
+  updates_since_recompute_ = 0;
+  origin_ = delay_hist_.front();
+  sum_x_ = sum_y_ = sum_xx_ = sum_xy_ = 0;
+  for (const auto& point : delay_hist_)
+    AddToSums(point, 1);
+}
+
+absl::optional<double> TrendlineEstimator::LinearFitSlope() const {
+  RTC_DCHECK(delay_hist_.size() >= 2);
+  // The slope k = \sum (x_i-x_avg)(y_i-y_avg) / \sum (x_i-x_avg)^2, where
+  // the sums of products of deviations are computed from the raw sums.
+  const double n = static_cast<double>(delay_hist_.size());
+  const double numerator = sum_xy_ - sum_x_ * sum_y_ / n;
+  const double denominator = sum_xx_ - sum_x_ * sum_x_ / n;
+  if (denominator == 0)
+    return absl::nullopt;
+  return numerator / denominator;
+}
+
 void TrendlineEstimator::UpdateThreshold(double modified_offset,
                                          int64_t now_ms) {
   if (last_update_ms_ == -1)
@@ -16,6 +16,7 @@
 #include <deque>
 #include <utility>
 
+#include "absl/types/optional.h"
 #include "modules/congestion_controller/goog_cc/delay_increase_detector_interface.h"
 #include "rtc_base/constructormagic.h"
 
@@ -60,6 +61,10 @@ class TrendlineEstimator : public DelayIncreaseDetectorInterface {
 
   void UpdateThreshold(double modified_offset, int64_t now_ms);
 
+  void AddToSums(const std::pair<double, double>& point, double sign);
+  void RecomputeSums();
+  absl::optional<double> LinearFitSlope() const;
+
   // Parameters.
   const size_t window_size_;
   const double smoothing_coef_;
@@ -73,6 +78,15 @@ class TrendlineEstimator : public DelayIncreaseDetectorInterface {
   double smoothed_delay_;
   // Linear least squares regression.
   std::deque<std::pair<double, double>> delay_hist_;
+  // Sums over |delay_hist_|, updated as points enter and leave the window. The
+  // coordinates are relative to a point of the window when the sums were last
+  // recomputed, which is done once per window to bound rounding errors.
+  std::pair<double, double> origin_;
+  double sum_x_;
+  double sum_y_;
+  double sum_xx_;
+  double sum_xy_;
+  size_t updates_since_recompute_;
   double trendline_;
 
   const double k_up_;
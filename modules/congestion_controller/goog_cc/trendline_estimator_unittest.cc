@@ -9,6 +9,10 @@
  */
 
 #include "modules/congestion_controller/goog_cc/trendline_estimator.h"
+
+#include <deque>
+#include <utility>
+
 #include "rtc_base/random.h"
 #include "test/gtest.h"
 
@@ -70,4 +74,43 @@ TEST(TrendlineEstimator, JitteryLineSlopeZero) {
   TestEstimator(0, kAvgTimeBetweenPackets / 3.0, 0.02);
 }
 
+TEST(TrendlineEstimator, MatchesLeastSquaresFitOfWindowOverLongRun) {
+  TrendlineEstimator estimator(kWindowSize, kSmoothing, kGain);
+  Random random(0x1234567);
+  std::deque<std::pair<double, double>> window;
+  const int64_t first_arrival_time_ms = random.Rand(1000000);
+  int64_t arrival_time_ms = first_arrival_time_ms;
+  double accumulated_delay = 0;
+  // Long enough for the arrival times and the accumulated delay to get much
+  // larger than their variation within the window.
+  for (int i = 0; i < 100000; ++i) {
+    int64_t send_delta = kAvgTimeBetweenPackets;
+    int64_t recv_delta = send_delta + random.Rand(0, 2);
+    if (i > 0)
+      arrival_time_ms += recv_delta;
+    accumulated_delay += recv_delta - send_delta;
+    estimator.Update(recv_delta, send_delta, arrival_time_ms);
+
+    window.emplace_back(arrival_time_ms - first_arrival_time_ms,
+                        accumulated_delay);
+    if (window.size() > kWindowSize)
+      window.pop_front();
+    if (window.size() < kWindowSize)
+      continue;
+    double x_avg = 0;
+    double y_avg = 0;
+    for (const auto& point : window) {
+      x_avg += point.first / window.size();
+      y_avg += point.second / window.size();
+    }
+    double numerator = 0;
+    double denominator = 0;
+    for (const auto& point : window) {
+      numerator += (point.first - x_avg) * (point.second - y_avg);
+      denominator += (point.first - x_avg) * (point.first - x_avg);
+    }
+    ASSERT_NEAR(numerator / denominator, estimator.trendline_slope(), 1e-9);
+  }
+}
+
 }  // namespace webrtc
@@ -27,6 +27,7 @@
 #include "modules/include/module_common_types.h"
 #include "modules/pacing/paced_sender.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/networkroute.h"
@@ -168,6 +169,18 @@ class SendSideCongestionController
   void OnReceivedRtcpReceiverReportBlocks(const ReportBlockList& report_blocks,
                                           int64_t now_ms)
       RTC_RUN_ON(task_queue_);
+  // Applies the sent packets and transport feedback queued since the last
+  // call, passing all feedback to the controller as a single message.
+  void ProcessPendingFeedback() RTC_RUN_ON(task_queue_);
+
+  struct PendingSentPacket {
+    uint16_t sequence_number;
+    int64_t send_time_ms;
+  };
+  struct PendingFeedback {
+    rtcp::TransportFeedback feedback;
+    int64_t receive_time_ms;
+  };
 
   const Clock* const clock_;
   // PacedSender is thread safe and doesn't need protection here.
@@ -212,6 +225,18 @@ class SendSideCongestionController
   send_side_cc_internal::PeriodicTask* controller_task_
       RTC_GUARDED_BY(task_queue_);
 
+  // If set, OnSentPacket() and OnTransportFeedback() only queue their input
+  // for the task queue, which applies everything queued until it gets to it
+  // at once. The network threads then never wait for the feedback adapter or
+  // the controller, and under load the controller sees fewer, larger feedback
+  // messages.
+  const bool batch_feedback_;
+  rtc::CriticalSection pending_crit_;
+  std::vector<PendingSentPacket> pending_sent_packets_
+      RTC_GUARDED_BY(pending_crit_);
+  std::vector<PendingFeedback> pending_feedback_ RTC_GUARDED_BY(pending_crit_);
+  bool pending_task_posted_ RTC_GUARDED_BY(pending_crit_);
+
   // Protects access to last_packet_feedback_vector_ in feedback adapter.
   // TODO(srte): Remove this checker when feedback adapter runs on task queue.
   rtc::RaceChecker worker_race_;
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 #include "absl/memory/memory.h"
 #include "api/transport/network_types.h"
@@ -43,12 +44,18 @@ const char kCwndExperiment[] = "WebRTC-CwndExperiment";
 
 // When CongestionWindowPushback is enabled, the pacer is oblivious to
 // the congestion window. The relation between outstanding data and
-// the congestion window affects encoder allocations directly.
+// the congestion window affects encoder allocations directly. Together with
+// CwndExperiment this applies to the window of goog_cc, on its own to the
+// window of controllers that always report one, such as BBR.
 const char kCongestionPushbackExperiment[] = "WebRTC-CongestionWindowPushback";
 
 // When PacerPushbackExperiment is enabled, build-up in the pacer due to
 // the congestion window and/or data spikes reduces encoder allocations.
 const char kPacerPushbackExperiment[] = "WebRTC-PacerPushbackExperiment";
+
+// When BatchedFeedback is enabled, sent packets and transport feedback are
+// applied on the task queue instead of on the calling network thread.
+const char kBatchedFeedbackExperiment[] = "WebRTC-Bwe-BatchedFeedback";
 const int64_t PacerQueueUpdateIntervalMs = 25;
 
 bool IsPacerPushbackExperimentEnabled() {
@@ -63,6 +70,10 @@ bool IsCongestionWindowPushbackExperimentEnabled() {
          webrtc::field_trial::IsEnabled(kCwndExperiment);
 }
 
+bool IsCongestionWindowPushbackEnabledForControllerWindow() {
+  return webrtc::field_trial::IsEnabled(kCongestionPushbackExperiment);
+}
+
 std::unique_ptr<CongestionWindowPushbackController>
 MaybeInitalizeCongestionWindowPushbackController() {
   return IsCongestionWindowPushbackExperimentEnabled()
@@ -203,7 +214,8 @@ class ControlHandler {
   uint32_t min_pushback_target_bitrate_bps_;
   int64_t pacer_expected_queue_ms_ = 0;
   double encoding_rate_ratio_ = 1.0;
-  const std::unique_ptr<CongestionWindowPushbackController>
+  const bool pushback_on_controller_window_;
+  std::unique_ptr<CongestionWindowPushbackController>
       congestion_window_pushback_controller_;
 
   rtc::SequencedTaskChecker sequenced_checker_;
@@ -216,6 +228,8 @@ ControlHandler::ControlHandler(NetworkChangedObserver* observer,
     : observer_(observer),
       pacer_controller_(pacer_controller),
       pacer_pushback_experiment_(IsPacerPushbackExperimentEnabled()),
+      pushback_on_controller_window_(
+          IsCongestionWindowPushbackEnabledForControllerWindow()),
       congestion_window_pushback_controller_(
           MaybeInitalizeCongestionWindowPushbackController()) {
   sequenced_checker_.Detach();
@@ -224,6 +238,14 @@ ControlHandler::ControlHandler(NetworkChangedObserver* observer,
 void ControlHandler::PostUpdates(NetworkControlUpdate update) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   if (update.congestion_window) {
+    // Controllers such as BBR report a window without CwndExperiment, start
+    // pushing back on the first finite one.
+    if (!congestion_window_pushback_controller_ &&
+        pushback_on_controller_window_ &&
+        update.congestion_window->IsFinite()) {
+      congestion_window_pushback_controller_ =
+          absl::make_unique<CongestionWindowPushbackController>();
+    }
     if (congestion_window_pushback_controller_) {
       congestion_window_pushback_controller_->SetDataWindow(
           update.congestion_window.value());
@@ -365,6 +387,9 @@ SendSideCongestionController::SendSideCongestionController(
       packet_feedback_available_(false),
       pacer_queue_update_task_(nullptr),
       controller_task_(nullptr),
+      batch_feedback_(
+          webrtc::field_trial::IsEnabled(kBatchedFeedbackExperiment)),
+      pending_task_posted_(false),
       task_queue_(task_queue) {
   initial_config_.constraints =
       ConvertConstraints(min_bitrate_bps, max_bitrate_bps, clock_);
@@ -581,6 +606,24 @@ void SendSideCongestionController::OnSentPacket(
   // etc, sent on the same transport.
   if (sent_packet.packet_id == -1)
     return;
+  if (batch_feedback_) {
+    bool post_task;
+    {
+      rtc::CritScope cs(&pending_crit_);
+      pending_sent_packets_.push_back(
+          {rtc::dchecked_cast<uint16_t>(sent_packet.packet_id),
+           sent_packet.send_time_ms});
+      post_task = !pending_task_posted_;
+      pending_task_posted_ = true;
+    }
+    if (post_task) {
+      task_queue_->PostTask([this]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        ProcessPendingFeedback();
+      });
+    }
+    return;
+  }
   transport_feedback_adapter_.OnSentPacket(sent_packet.packet_id,
                                            sent_packet.send_time_ms);
   MaybeUpdateOutstandingData();
@@ -652,6 +695,9 @@ void SendSideCongestionController::StartProcessPeriodicTasks() {
 }
 
 void SendSideCongestionController::UpdateControllerWithTimeInterval() {
+  // Let the controller see all feedback received up to now.
+  if (batch_feedback_)
+    ProcessPendingFeedback();
   if (controller_) {
     ProcessInterval msg;
     msg.at_time = Timestamp::ms(clock_->TimeInMilliseconds());
@@ -683,6 +729,25 @@ void SendSideCongestionController::OnTransportFeedback(
     const rtcp::TransportFeedback& feedback) {
   RTC_DCHECK_RUNS_SERIALIZED(&worker_race_);
   int64_t feedback_time_ms = clock_->TimeInMilliseconds();
+  if (batch_feedback_) {
+    // Copied before taking the lock, so that the lock is only held for as long
+    // as it takes to move the feedback in.
+    PendingFeedback pending{feedback, feedback_time_ms};
+    bool post_task;
+    {
+      rtc::CritScope cs(&pending_crit_);
+      pending_feedback_.push_back(std::move(pending));
+      post_task = !pending_task_posted_;
+      pending_task_posted_ = true;
+    }
+    if (post_task) {
+      task_queue_->PostTask([this]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        ProcessPendingFeedback();
+      });
+    }
+    return;
+  }
 
   DataSize prior_in_flight =
       DataSize::bytes(transport_feedback_adapter_.GetOutstandingBytes());
@@ -709,6 +774,70 @@ void SendSideCongestionController::OnTransportFeedback(
   }
 }
 
+void SendSideCongestionController::ProcessPendingFeedback() {
+  std::vector<PendingSentPacket> sent_packets;
+  std::vector<PendingFeedback> feedbacks;
+  {
+    rtc::CritScope cs(&pending_crit_);
+    sent_packets.swap(pending_sent_packets_);
+    feedbacks.swap(pending_feedback_);
+    pending_task_posted_ = false;
+  }
+  if (sent_packets.empty() && feedbacks.empty())
+    return;
+
+  // Packets are queued as they are sent, before any feedback about them can
+  // arrive, so applying all of them first keeps the feedback matchable.
+  for (const PendingSentPacket& sent_packet : sent_packets) {
+    transport_feedback_adapter_.OnSentPacket(sent_packet.sequence_number,
+                                             sent_packet.send_time_ms);
+    if (!controller_)
+      continue;
+    auto packet =
+        transport_feedback_adapter_.GetPacket(sent_packet.sequence_number);
+    if (!packet.has_value())
+      continue;
+    SentPacket msg;
+    msg.size = DataSize::bytes(packet->payload_size);
+    msg.send_time = Timestamp::ms(packet->send_time_ms);
+    msg.sequence_number = packet->long_sequence_number;
+    msg.data_in_flight =
+        DataSize::bytes(transport_feedback_adapter_.GetOutstandingBytes());
+    control_handler_->PostUpdates(controller_->OnSentPacket(msg));
+  }
+
+  if (!feedbacks.empty()) {
+    DataSize prior_in_flight =
+        DataSize::bytes(transport_feedback_adapter_.GetOutstandingBytes());
+    std::vector<PacketFeedback> feedback_vector;
+    for (const PendingFeedback& pending : feedbacks) {
+      transport_feedback_adapter_.OnTransportFeedback(pending.feedback);
+      std::vector<PacketFeedback> packets =
+          transport_feedback_adapter_.GetTransportFeedbackVector();
+      feedback_vector.insert(feedback_vector.end(), packets.begin(),
+                             packets.end());
+    }
+    SortPacketFeedbackVector(&feedback_vector);
+    if (!feedback_vector.empty() && controller_) {
+      TransportPacketsFeedback msg;
+      msg.packet_feedbacks =
+          PacketResultsFromRtpFeedbackVector(feedback_vector);
+      msg.feedback_time = Timestamp::ms(feedbacks.back().receive_time_ms);
+      msg.prior_in_flight = prior_in_flight;
+      msg.data_in_flight =
+          DataSize::bytes(transport_feedback_adapter_.GetOutstandingBytes());
+      control_handler_->PostUpdates(
+          controller_->OnTransportPacketsFeedback(msg));
+    }
+  }
+
+  DataSize in_flight_data =
+      DataSize::bytes(transport_feedback_adapter_.GetOutstandingBytes());
+  pacer_controller_->OnOutstandingData(in_flight_data);
+  if (control_handler_)
+    control_handler_->OnOutstandingData(in_flight_data);
+}
+
 void SendSideCongestionController::MaybeUpdateOutstandingData() {
   DataSize in_flight_data =
       DataSize::bytes(transport_feedback_adapter_.GetOutstandingBytes());
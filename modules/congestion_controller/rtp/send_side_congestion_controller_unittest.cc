@@ -17,6 +17,7 @@
 #include "modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/event.h"
 #include "rtc_base/socket.h"
 #include "system_wrappers/include/clock.h"
 #include "test/field_trial.h"
@@ -55,6 +56,79 @@ class SendSideCongestionControllerForTest
     SendSideCongestionController::WaitOnTasksForTest();
   }
 };
+
+// Records the number of packets in every transport feedback message. Reports
+// a fixed target rate and congestion window if |congestion_window| is set, as
+// controllers like BBR do.
+class FeedbackCountingController : public NetworkControllerInterface {
+ public:
+  FeedbackCountingController(std::vector<size_t>* feedback_sizes,
+                             absl::optional<DataSize> congestion_window)
+      : feedback_sizes_(feedback_sizes),
+        congestion_window_(congestion_window) {}
+
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnProcessInterval(ProcessInterval msg) override {
+    NetworkControlUpdate update;
+    if (congestion_window_) {
+      update.congestion_window = congestion_window_;
+      TargetTransferRate target_rate;
+      target_rate.at_time = msg.at_time;
+      target_rate.target_rate = DataRate::bps(kInitialBitrateBps);
+      target_rate.network_estimate.round_trip_time = TimeDelta::ms(100);
+      target_rate.network_estimate.bwe_period = TimeDelta::seconds(3);
+      update.target_rate = target_rate;
+    }
+    return update;
+  }
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnSentPacket(SentPacket) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback msg) override {
+    feedback_sizes_->push_back(msg.packet_feedbacks.size());
+    return NetworkControlUpdate();
+  }
+
+ private:
+  std::vector<size_t>* const feedback_sizes_;
+  const absl::optional<DataSize> congestion_window_;
+};
+
+class FeedbackCountingControllerFactory
+    : public NetworkControllerFactoryInterface {
+ public:
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override {
+    return absl::make_unique<FeedbackCountingController>(&feedback_sizes,
+                                                         congestion_window);
+  }
+  TimeDelta GetProcessInterval() const override { return TimeDelta::ms(25); }
+
+  std::vector<size_t> feedback_sizes;
+  absl::optional<DataSize> congestion_window;
+};
 }  // namespace
 
 class SendSideCongestionControllerTest : public ::testing::Test {
@@ -103,6 +177,19 @@ class SendSideCongestionControllerTest : public ::testing::Test {
     controller_->SignalNetworkState(NetworkState::kNetworkUp);
   }
 
+  void OnFeedback(const PacketFeedback& packet) {
+    rtcp::TransportFeedback feedback;
+    feedback.SetBase(packet.sequence_number, packet.arrival_time_ms * 1000);
+    EXPECT_TRUE(feedback.AddReceivedPacket(packet.sequence_number,
+                                           packet.arrival_time_ms * 1000));
+    rtc::Buffer raw_packet = feedback.Build();
+    std::unique_ptr<rtcp::TransportFeedback> parsed =
+        rtcp::TransportFeedback::ParseFrom(raw_packet.data(),
+                                           raw_packet.size());
+    ASSERT_TRUE(parsed);
+    controller_->OnTransportFeedback(*parsed);
+  }
+
   void OnSentPacket(const PacketFeedback& packet_feedback) {
     constexpr uint32_t ssrc = 0;
     controller_->AddPacket(ssrc, packet_feedback.sequence_number,
@@ -165,6 +252,7 @@ class SendSideCongestionControllerTest : public ::testing::Test {
   NiceMock<MockRtcEventLog> event_log_;
   RtcpBandwidthObserver* bandwidth_observer_;
   PacketRouter packet_router_;
+  FeedbackCountingControllerFactory counting_controller_factory_;
   std::unique_ptr<NiceMock<MockPacedSender>> pacer_;
   std::unique_ptr<SendSideCongestionControllerForTest> controller_;
   absl::optional<uint32_t> target_bitrate_bps_;
@@ -515,6 +603,93 @@ TEST_F(SendSideCongestionControllerTest, PacerQueueEncodeRatePushback) {
   controller_->Process();
 }
 
+TEST_F(SendSideCongestionControllerTest, BatchesQueuedFeedback) {
+  ::webrtc::test::ScopedFieldTrials batched_feedback_field_trial(
+      "WebRTC-Bwe-BatchedFeedback/Enabled/");
+  task_queue_ = absl::make_unique<rtc::TaskQueue>("SSCC Test");
+  controller_.reset(new SendSideCongestionControllerForTest(
+      &clock_, task_queue_.get(), &event_log_, pacer_.get(),
+      kInitialBitrateBps, 0, 5 * kInitialBitrateBps,
+      &counting_controller_factory_));
+  controller_->DisablePeriodicTasks();
+  controller_->RegisterNetworkObserver(&target_bitrate_observer_);
+  controller_->SignalNetworkState(NetworkState::kNetworkUp);
+  controller_->WaitOnTasks();
+
+  // Keep the task queue busy, so that everything below is queued up.
+  rtc::Event queue_blocked(false, false);
+  rtc::Event release_queue(false, false);
+  task_queue_->PostTask([&queue_blocked, &release_queue]() {
+    queue_blocked.Set();
+    release_queue.Wait(rtc::Event::kForever);
+  });
+  queue_blocked.Wait(rtc::Event::kForever);
+
+  const int64_t now_ms = clock_.TimeInMilliseconds();
+  for (uint16_t seq = 0; seq < 3; ++seq) {
+    PacketFeedback packet(now_ms + 10 * seq + 50, now_ms + 10 * seq, seq, 1000,
+                          kPacingInfo0);
+    OnSentPacket(packet);
+    OnFeedback(packet);
+  }
+  release_queue.Set();
+  controller_->WaitOnTasks();
+
+  ASSERT_EQ(1u, counting_controller_factory_.feedback_sizes.size());
+  EXPECT_EQ(3u, counting_controller_factory_.feedback_sizes[0]);
+}
+
+TEST_F(SendSideCongestionControllerTest,
+       UpdatesDelayBasedEstimateWithBatchedFeedback) {
+  ::webrtc::test::ScopedFieldTrials batched_feedback_field_trial(
+      "WebRTC-Bwe-BatchedFeedback/Enabled/");
+  TargetBitrateTrackingSetup();
+
+  const int64_t kRunTimeMs = 6000;
+  uint16_t seq_num = 0;
+  PacketTransmissionAndFeedbackBlock(&seq_num, kRunTimeMs, 0);
+  ASSERT_TRUE(target_bitrate_bps_);
+
+  uint32_t bitrate_before_delay = *target_bitrate_bps_;
+  PacketTransmissionAndFeedbackBlock(&seq_num, kRunTimeMs, 50);
+  EXPECT_LT(*target_bitrate_bps_, bitrate_before_delay);
+}
+
+TEST_F(SendSideCongestionControllerTest,
+       PushesBackOnCongestionWindowOfController) {
+  ::webrtc::test::ScopedFieldTrials pushback_field_trial(
+      "WebRTC-CongestionWindowPushback/Enabled/");
+  constexpr size_t kPayloadSize = 1000;
+  counting_controller_factory_.congestion_window =
+      DataSize::bytes(4 * kPayloadSize);
+  task_queue_ = absl::make_unique<rtc::TaskQueue>("SSCC Test");
+  controller_.reset(new SendSideCongestionControllerForTest(
+      &clock_, task_queue_.get(), &event_log_, pacer_.get(),
+      kInitialBitrateBps, 0, 5 * kInitialBitrateBps,
+      &counting_controller_factory_));
+  controller_->DisablePeriodicTasks();
+  controller_->RegisterNetworkObserver(&target_bitrate_observer_);
+  controller_->SignalNetworkState(NetworkState::kNetworkUp);
+
+  controller_->Process();
+  controller_->WaitOnTasks();
+  ASSERT_TRUE(target_bitrate_bps_);
+  EXPECT_EQ(kInitialBitrateBps, static_cast<int>(*target_bitrate_bps_));
+
+  // Twice the window is outstanding, so the encoder rate is pushed back.
+  const int64_t now_ms = clock_.TimeInMilliseconds();
+  for (uint16_t seq = 0; seq < 8; ++seq) {
+    OnSentPacket(PacketFeedback(now_ms, now_ms, seq, kPayloadSize,
+                                kPacingInfo0));
+  }
+  for (int i = 0; i < 10; ++i) {
+    clock_.AdvanceTimeMilliseconds(25);
+    controller_->Process();
+  }
+  controller_->WaitOnTasks();
+  EXPECT_LT(*target_bitrate_bps_, static_cast<uint32_t>(kInitialBitrateBps));
+}
+
 }  // namespace test
 }  // namespace webrtc_cc
 }  // namespace webrtc
@@ -15,46 +15,74 @@
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_conversions.h"
 #include "system_wrappers/include/clock.h"
 
 namespace webrtc {
+namespace {
+constexpr size_t kMinRingSize = 64;
+}  // namespace
+
+constexpr int32_t SendTimeHistory::kNotSent;
+constexpr size_t SendTimeHistory::kMaxSideTableSize;
 
 SendTimeHistory::SendTimeHistory(const Clock* clock,
                                  int64_t packet_age_limit_ms)
-    : clock_(clock), packet_age_limit_ms_(packet_age_limit_ms) {}
+    : clock_(clock),
+      packet_age_limit_ms_(packet_age_limit_ms),
+      pacing_infos_(1, PacedPacketInfo()) {
+  static_assert(sizeof(PackedPacket) == 16, "PackedPacket should stay small");
+}
 
 SendTimeHistory::~SendTimeHistory() {}
 
 void SendTimeHistory::AddAndRemoveOld(const PacketFeedback& packet) {
-  int64_t now_ms = clock_->TimeInMilliseconds();
-  // Remove old.
-  while (!history_.empty() &&
-         now_ms - history_.begin()->second.creation_time_ms >
-             packet_age_limit_ms_) {
-    // TODO(sprang): Warn if erasing (too many) old items?
-    RemovePacketBytes(history_.begin()->second);
-    history_.erase(history_.begin());
-  }
+  RemoveOld(clock_->TimeInMilliseconds());
 
   // Add new.
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(packet.sequence_number);
-  PacketFeedback packet_copy = packet;
-  packet_copy.long_sequence_number = unwrapped_seq_num;
-  history_.insert(std::make_pair(unwrapped_seq_num, packet_copy));
-  if (packet.send_time_ms >= 0)
-    AddPacketBytes(packet_copy);
+  // Look up everything that may move the packets around first.
+  int32_t creation_time_ms =
+      RelativeTime(packet.creation_time_ms, &creation_time_base_ms_,
+                   &PackedPacket::creation_time_ms);
+  int32_t send_time_ms = kNotSent;
+  if (packet.send_time_ms >= 0) {
+    send_time_ms = RelativeTime(packet.send_time_ms, &send_time_base_ms_,
+                                &PackedPacket::send_time_ms);
+  }
+  uint8_t route =
+      Intern(std::make_pair(packet.local_net_id, packet.remote_net_id),
+             &routes_, &PackedPacket::route);
+  uint8_t pacing_info =
+      Intern(packet.pacing_info, &pacing_infos_, &PackedPacket::pacing_info);
+  if (in_flight_bytes_.size() < routes_.size())
+    in_flight_bytes_.resize(routes_.size(), 0);
+
+  PackedPacket* entry = Insert(unwrapped_seq_num);
+  if (entry->valid)
+    RemovePacketBytes(*entry, unwrapped_seq_num);
+  entry->creation_time_ms = creation_time_ms;
+  entry->send_time_ms = send_time_ms;
+  entry->payload_size = rtc::dchecked_cast<uint32_t>(packet.payload_size);
+  entry->route = route;
+  entry->pacing_info = pacing_info;
+  entry->valid = true;
+  AddPacketBytes(*entry, unwrapped_seq_num);
 }
 
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  if (!Find(unwrapped_seq_num))
     return false;
-  bool packet_retransmit = it->second.send_time_ms >= 0;
-  it->second.send_time_ms = send_time_ms;
+  int32_t relative_send_time_ms = RelativeTime(
+      send_time_ms, &send_time_base_ms_, &PackedPacket::send_time_ms);
+  PackedPacket* entry = Find(unwrapped_seq_num);
+  bool packet_retransmit = entry->send_time_ms != kNotSent;
+  entry->send_time_ms = relative_send_time_ms;
   if (!packet_retransmit)
-    AddPacketBytes(it->second);
+    AddPacketBytes(*entry, unwrapped_seq_num);
   return true;
 }
 
@@ -63,9 +91,9 @@ absl::optional<PacketFeedback> SendTimeHistory::GetPacket(
   int64_t unwrapped_seq_num =
       seq_num_unwrapper_.UnwrapWithoutUpdate(sequence_number);
   absl::optional<PacketFeedback> optional_feedback;
-  auto it = history_.find(unwrapped_seq_num);
-  if (it != history_.end())
-    optional_feedback.emplace(it->second);
+  const PackedPacket* entry = Find(unwrapped_seq_num);
+  if (entry)
+    optional_feedback.emplace(Unpack(*entry, unwrapped_seq_num));
   return optional_feedback;
 }
 
@@ -76,66 +104,187 @@ bool SendTimeHistory::GetFeedback(PacketFeedback* packet_feedback,
       seq_num_unwrapper_.Unwrap(packet_feedback->sequence_number);
   UpdateAckedSeqNum(unwrapped_seq_num);
   RTC_DCHECK_GE(*last_ack_seq_num_, 0);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PackedPacket* entry = Find(unwrapped_seq_num);
+  if (!entry)
     return false;
 
   // Save arrival_time not to overwrite it.
   int64_t arrival_time_ms = packet_feedback->arrival_time_ms;
-  *packet_feedback = it->second;
+  *packet_feedback = Unpack(*entry, unwrapped_seq_num);
   packet_feedback->arrival_time_ms = arrival_time_ms;
 
   if (remove)
-    history_.erase(it);
+    entry->valid = false;
   return true;
 }
 
 size_t SendTimeHistory::GetOutstandingBytes(uint16_t local_net_id,
                                             uint16_t remote_net_id) const {
-  auto it = in_flight_bytes_.find({local_net_id, remote_net_id});
-  if (it != in_flight_bytes_.end()) {
-    return it->second;
-  } else {
+  for (size_t i = 0; i < routes_.size(); ++i) {
+    if (routes_[i] == std::make_pair(local_net_id, remote_net_id))
+      return in_flight_bytes_[i];
+  }
+  return 0;
+}
+
+SendTimeHistory::PackedPacket* SendTimeHistory::Find(
+    int64_t unwrapped_seq_num) {
+  return const_cast<PackedPacket*>(
+      static_cast<const SendTimeHistory*>(this)->Find(unwrapped_seq_num));
+}
+
+const SendTimeHistory::PackedPacket* SendTimeHistory::Find(
+    int64_t unwrapped_seq_num) const {
+  if (unwrapped_seq_num < begin_seq_num_ || unwrapped_seq_num >= end_seq_num_)
+    return nullptr;
+  const PackedPacket& entry = ring_[unwrapped_seq_num & (ring_.size() - 1)];
+  return entry.valid ? &entry : nullptr;
+}
+
+SendTimeHistory::PackedPacket* SendTimeHistory::Insert(
+    int64_t unwrapped_seq_num) {
+  if (begin_seq_num_ == end_seq_num_) {
+    begin_seq_num_ = unwrapped_seq_num;
+    end_seq_num_ = unwrapped_seq_num;
+  }
+  int64_t begin_seq_num = std::min(begin_seq_num_, unwrapped_seq_num);
+  int64_t end_seq_num = std::max(end_seq_num_, unwrapped_seq_num + 1);
+  size_t span = static_cast<size_t>(end_seq_num - begin_seq_num);
+  if (span > ring_.size())
+    Grow(span);
+  // Entries outside of the old range are invalid already.
+  begin_seq_num_ = begin_seq_num;
+  end_seq_num_ = end_seq_num;
+  return &ring_[unwrapped_seq_num & (ring_.size() - 1)];
+}
+
+void SendTimeHistory::Grow(size_t min_capacity) {
+  size_t capacity = std::max(kMinRingSize, ring_.size());
+  while (capacity < min_capacity)
+    capacity *= 2;
+  std::vector<PackedPacket> ring(capacity, PackedPacket());
+  for (int64_t seq_num = begin_seq_num_; seq_num < end_seq_num_; ++seq_num) {
+    const PackedPacket& entry = ring_[seq_num & (ring_.size() - 1)];
+    if (entry.valid)
+      ring[seq_num & (capacity - 1)] = entry;
+  }
+  ring_.swap(ring);
+}
+
+void SendTimeHistory::RemoveOld(int64_t now_ms) {
+  while (begin_seq_num_ < end_seq_num_) {
+    PackedPacket& entry = ring_[begin_seq_num_ & (ring_.size() - 1)];
+    if (entry.valid) {
+      int64_t creation_time_ms =
+          creation_time_base_ms_ + entry.creation_time_ms;
+      if (now_ms - creation_time_ms <= packet_age_limit_ms_)
+        break;
+      // TODO(sprang): Warn if erasing (too many) old items?
+      RemovePacketBytes(entry, begin_seq_num_);
+      entry.valid = false;
+    }
+    ++begin_seq_num_;
+  }
+}
+
+PacketFeedback SendTimeHistory::Unpack(const PackedPacket& packed,
+                                       int64_t unwrapped_seq_num) const {
+  const RemoteAndLocalNetworkId& route = routes_[packed.route];
+  PacketFeedback packet(
+      creation_time_base_ms_ + packed.creation_time_ms,
+      PacketFeedback::kNotReceived,
+      packed.send_time_ms == kNotSent
+          ? PacketFeedback::kNoSendTime
+          : send_time_base_ms_ + packed.send_time_ms,
+      static_cast<uint16_t>(unwrapped_seq_num), packed.payload_size,
+      route.first, route.second, pacing_infos_[packed.pacing_info]);
+  packet.long_sequence_number = unwrapped_seq_num;
+  return packet;
+}
+
+int32_t SendTimeHistory::RelativeTime(int64_t time_ms,
+                                      int64_t* base_ms,
+                                      int32_t PackedPacket::*field) {
+  int64_t relative_ms = time_ms - *base_ms;
+  if (relative_ms > kNotSent && relative_ms <= INT32_MAX)
+    return static_cast<int32_t>(relative_ms);
+  // Only happens for the first packet, or after 24 days, so the live packets
+  // are nowhere near the other end of the range.
+  for (int64_t seq_num = begin_seq_num_; seq_num < end_seq_num_; ++seq_num) {
+    PackedPacket& entry = ring_[seq_num & (ring_.size() - 1)];
+    if (!entry.valid || entry.*field == kNotSent)
+      continue;
+    entry.*field = rtc::saturated_cast<int32_t>(
+        std::max<int64_t>(entry.*field - relative_ms, kNotSent + 1));
+  }
+  *base_ms = time_ms;
+  return 0;
+}
+
+template <typename T>
+uint8_t SendTimeHistory::Intern(const T& value,
+                                std::vector<T>* table,
+                                uint8_t PackedPacket::*field) {
+  // Most packets share the first value, the default pacing info, or the most
+  // recently added one.
+  if (!table->empty() && table->front() == value)
     return 0;
+  for (size_t i = table->size(); i > 0; --i) {
+    if ((*table)[i - 1] == value)
+      return static_cast<uint8_t>(i - 1);
+  }
+  if (table->size() < kMaxSideTableSize) {
+    table->push_back(value);
+    return static_cast<uint8_t>(table->size() - 1);
+  }
+  // The table is full, replace a value that no live packet refers to. With
+  // one value per network route or probe cluster, this is rare.
+  std::vector<bool> used(kMaxSideTableSize, false);
+  for (int64_t seq_num = begin_seq_num_; seq_num < end_seq_num_; ++seq_num) {
+    const PackedPacket& entry = ring_[seq_num & (ring_.size() - 1)];
+    if (entry.valid)
+      used[entry.*field] = true;
   }
+  for (size_t i = 0; i < kMaxSideTableSize; ++i) {
+    if (!used[i]) {
+      (*table)[i] = value;
+      return static_cast<uint8_t>(i);
+    }
+  }
+  RTC_LOG(LS_WARNING) << "Too many distinct values in send time history.";
+  (*table)[kMaxSideTableSize - 1] = value;
+  return static_cast<uint8_t>(kMaxSideTableSize - 1);
 }
 
-void SendTimeHistory::AddPacketBytes(const PacketFeedback& packet) {
-  if (packet.send_time_ms < 0 || packet.payload_size == 0 ||
-      (last_ack_seq_num_ && *last_ack_seq_num_ >= packet.long_sequence_number))
+void SendTimeHistory::AddPacketBytes(const PackedPacket& packet,
+                                     int64_t unwrapped_seq_num) {
+  if (packet.send_time_ms == kNotSent || packet.payload_size == 0 ||
+      (last_ack_seq_num_ && *last_ack_seq_num_ >= unwrapped_seq_num))
     return;
-  auto it = in_flight_bytes_.find({packet.local_net_id, packet.remote_net_id});
-  if (it != in_flight_bytes_.end()) {
-    it->second += packet.payload_size;
-  } else {
-    in_flight_bytes_[{packet.local_net_id, packet.remote_net_id}] =
-        packet.payload_size;
-  }
+  in_flight_bytes_[packet.route] += packet.payload_size;
 }
 
-void SendTimeHistory::RemovePacketBytes(const PacketFeedback& packet) {
-  if (packet.send_time_ms < 0 || packet.payload_size == 0 ||
-      (last_ack_seq_num_ && *last_ack_seq_num_ >= packet.long_sequence_number))
+void SendTimeHistory::RemovePacketBytes(const PackedPacket& packet,
+                                        int64_t unwrapped_seq_num) {
+  if (packet.send_time_ms == kNotSent || packet.payload_size == 0 ||
+      (last_ack_seq_num_ && *last_ack_seq_num_ >= unwrapped_seq_num))
     return;
-  auto it = in_flight_bytes_.find({packet.local_net_id, packet.remote_net_id});
-  if (it != in_flight_bytes_.end()) {
-    it->second -= packet.payload_size;
-    if (it->second == 0)
-      in_flight_bytes_.erase(it);
-  }
+  RTC_DCHECK_GE(in_flight_bytes_[packet.route], packet.payload_size);
+  in_flight_bytes_[packet.route] -= packet.payload_size;
 }
 
 void SendTimeHistory::UpdateAckedSeqNum(int64_t acked_seq_num) {
   if (last_ack_seq_num_ && *last_ack_seq_num_ >= acked_seq_num)
     return;
 
-  auto unacked_it = history_.begin();
+  int64_t seq_num = begin_seq_num_;
   if (last_ack_seq_num_)
-    unacked_it = history_.lower_bound(*last_ack_seq_num_);
-
-  auto newly_acked_end = history_.upper_bound(acked_seq_num);
-  for (; unacked_it != newly_acked_end; ++unacked_it) {
-    RemovePacketBytes(unacked_it->second);
+    seq_num = std::max(seq_num, *last_ack_seq_num_);
+  int64_t newly_acked_end = std::min(end_seq_num_, acked_seq_num + 1);
+  for (; seq_num < newly_acked_end; ++seq_num) {
+    const PackedPacket& entry = ring_[seq_num & (ring_.size() - 1)];
+    if (entry.valid)
+      RemovePacketBytes(entry, seq_num);
   }
   last_ack_seq_num_.emplace(acked_seq_num);
 }
@@ -11,8 +11,10 @@
 #ifndef MODULES_CONGESTION_CONTROLLER_RTP_SEND_TIME_HISTORY_H_
 #define MODULES_CONGESTION_CONTROLLER_RTP_SEND_TIME_HISTORY_H_
 
-#include <map>
+#include <stdint.h>
+
 #include <utility>
+#include <vector>
 
 #include "modules/include/module_common_types.h"
 #include "rtc_base/constructormagic.h"
@@ -21,6 +23,12 @@ namespace webrtc {
 class Clock;
 struct PacketFeedback;
 
+// Keeps the packets sent during the last |packet_age_limit_ms| until their
+// transport feedback arrives. Packets are stored in a ring indexed by their
+// unwrapped transport-wide sequence number, in 16 byte entries: times are kept
+// relative to a base, and network routes and pacing infos, which few packets
+// differ in, are stored once in side tables and referred to by index. Expired
+// packets are dropped from the front of the ring without any deallocation.
 class SendTimeHistory {
  public:
   SendTimeHistory(const Clock* clock, int64_t packet_age_limit_ms);
@@ -47,15 +55,60 @@ class SendTimeHistory {
  private:
   using RemoteAndLocalNetworkId = std::pair<uint16_t, uint16_t>;
 
-  void AddPacketBytes(const PacketFeedback& packet);
-  void RemovePacketBytes(const PacketFeedback& packet);
+  struct PackedPacket {
+    // Relative to |creation_time_base_ms_|.
+    int32_t creation_time_ms;
+    // Relative to |send_time_base_ms_|, or kNotSent.
+    int32_t send_time_ms;
+    uint32_t payload_size;
+    // Indices into |routes_| and |pacing_infos_|.
+    uint8_t route;
+    uint8_t pacing_info;
+    bool valid;
+  };
+  static constexpr int32_t kNotSent = INT32_MIN;
+  // Side tables are indexed by uint8_t.
+  static constexpr size_t kMaxSideTableSize = 256;
+
+  PackedPacket* Find(int64_t unwrapped_seq_num);
+  const PackedPacket* Find(int64_t unwrapped_seq_num) const;
+  // Makes room for |unwrapped_seq_num| in the ring and returns its entry.
+  PackedPacket* Insert(int64_t unwrapped_seq_num);
+  void Grow(size_t min_capacity);
+  void RemoveOld(int64_t now_ms);
+  PacketFeedback Unpack(const PackedPacket& packed,
+                        int64_t unwrapped_seq_num) const;
+
+  // Returns |time_ms| relative to |*base_ms|, moving the base and the times of
+  // all packets in |field| if it would not fit.
+  int32_t RelativeTime(int64_t time_ms,
+                       int64_t* base_ms,
+                       int32_t PackedPacket::*field);
+  // Returns the index of |value| in |table|, adding it if needed.
+  template <typename T>
+  uint8_t Intern(const T& value,
+                 std::vector<T>* table,
+                 uint8_t PackedPacket::*field);
+
+  void AddPacketBytes(const PackedPacket& packet, int64_t unwrapped_seq_num);
+  void RemovePacketBytes(const PackedPacket& packet, int64_t unwrapped_seq_num);
   void UpdateAckedSeqNum(int64_t acked_seq_num);
   const Clock* const clock_;
   const int64_t packet_age_limit_ms_;
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketFeedback> history_;
+  // Packets with unwrapped sequence numbers in [begin_seq_num_, end_seq_num_)
+  // live at index |seq_num & (ring_.size() - 1)|. All other entries are
+  // invalid.
+  std::vector<PackedPacket> ring_;
+  int64_t begin_seq_num_ = 0;
+  int64_t end_seq_num_ = 0;
+  int64_t creation_time_base_ms_ = 0;
+  int64_t send_time_base_ms_ = 0;
+  std::vector<RemoteAndLocalNetworkId> routes_;
+  std::vector<PacedPacketInfo> pacing_infos_;
   absl::optional<int64_t> last_ack_seq_num_;
-  std::map<RemoteAndLocalNetworkId, size_t> in_flight_bytes_;
+  // Indexed like |routes_|.
+  std::vector<size_t> in_flight_bytes_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(SendTimeHistory);
 };
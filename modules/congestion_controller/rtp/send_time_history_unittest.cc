@@ -252,5 +252,82 @@ TEST_F(SendTimeHistoryTest, InterlievedGetAndRemove) {
   EXPECT_TRUE(history_.GetFeedback(&packet3, true));
   EXPECT_EQ(packets[2], packet3);
 }
+
+TEST_F(SendTimeHistoryTest, KeepsManyPacketsInFlight) {
+  const size_t kNumPackets = 5000;
+  const size_t kPacketSize = 1200;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    AddPacketWithSendTime(static_cast<uint16_t>(i), kPacketSize, i,
+                          PacedPacketInfo());
+  }
+  EXPECT_EQ(kNumPackets * kPacketSize, history_.GetOutstandingBytes(0, 0));
+  for (size_t i = 0; i < kNumPackets; i += 2) {
+    PacketFeedback packet(0, static_cast<uint16_t>(i));
+    EXPECT_TRUE(history_.GetFeedback(&packet, true));
+    EXPECT_EQ(static_cast<int64_t>(i), packet.send_time_ms);
+    EXPECT_EQ(static_cast<int64_t>(i), packet.long_sequence_number);
+  }
+  // Everything up to the highest acked sequence number is out of flight.
+  EXPECT_EQ(kPacketSize, history_.GetOutstandingBytes(0, 0));
+  for (size_t i = 1; i < kNumPackets; i += 2) {
+    PacketFeedback packet(0, static_cast<uint16_t>(i));
+    EXPECT_TRUE(history_.GetFeedback(&packet, false));
+    EXPECT_EQ(kPacketSize, packet.payload_size);
+  }
+}
+
+TEST_F(SendTimeHistoryTest, KeepsOutstandingBytesPerRoute) {
+  const int64_t now_ms = clock_.TimeInMilliseconds();
+  history_.AddAndRemoveOld(
+      PacketFeedback(now_ms, 0, 100, 1, 2, PacedPacketInfo()));
+  history_.OnSentPacket(0, now_ms);
+  history_.AddAndRemoveOld(
+      PacketFeedback(now_ms, 1, 200, 3, 4, PacedPacketInfo()));
+  history_.OnSentPacket(1, now_ms);
+  EXPECT_EQ(100u, history_.GetOutstandingBytes(1, 2));
+  EXPECT_EQ(200u, history_.GetOutstandingBytes(3, 4));
+  EXPECT_EQ(0u, history_.GetOutstandingBytes(2, 1));
+
+  clock_.AdvanceTimeMilliseconds(kDefaultHistoryLengthMs + 1);
+  AddPacketWithSendTime(2, 300, clock_.TimeInMilliseconds(), PacedPacketInfo());
+  EXPECT_EQ(0u, history_.GetOutstandingBytes(1, 2));
+  EXPECT_EQ(0u, history_.GetOutstandingBytes(3, 4));
+  EXPECT_EQ(300u, history_.GetOutstandingBytes(0, 0));
+}
+
+TEST_F(SendTimeHistoryTest, RestoresTimesFarFromEachOther) {
+  // Creation times come from |clock_|, send times may be on another clock.
+  const int64_t kSendTimeMs = int64_t{1} << 40;
+  clock_.AdvanceTimeMilliseconds(int64_t{1} << 35);
+  AddPacketWithSendTime(0, 100, kSendTimeMs, PacedPacketInfo());
+  clock_.AdvanceTimeMilliseconds(10);
+  AddPacketWithSendTime(1, 100, kSendTimeMs + 10, PacedPacketInfo());
+
+  PacketFeedback packet(0, 0);
+  EXPECT_TRUE(history_.GetFeedback(&packet, false));
+  EXPECT_EQ(kSendTimeMs, packet.send_time_ms);
+  EXPECT_EQ(clock_.TimeInMilliseconds() - 10, packet.creation_time_ms);
+  PacketFeedback packet2(0, 1);
+  EXPECT_TRUE(history_.GetFeedback(&packet2, false));
+  EXPECT_EQ(kSendTimeMs + 10, packet2.send_time_ms);
+  EXPECT_EQ(clock_.TimeInMilliseconds(), packet2.creation_time_ms);
+}
+
+TEST_F(SendTimeHistoryTest, KeepsPacingInfoOfManyProbeClusters) {
+  // More probe clusters than fit in the pacing info table at once, but no
+  // more than that at a time, since old packets expire.
+  const int kClusters = 1000;
+  for (int cluster = 0; cluster < kClusters; ++cluster) {
+    clock_.AdvanceTimeMilliseconds(10);
+    const PacedPacketInfo pacing_info(cluster, 5, 1000);
+    AddPacketWithSendTime(static_cast<uint16_t>(cluster), 100,
+                          clock_.TimeInMilliseconds(), pacing_info);
+    if (cluster >= 50) {
+      PacketFeedback packet(0, static_cast<uint16_t>(cluster - 50));
+      EXPECT_TRUE(history_.GetFeedback(&packet, false));
+      EXPECT_EQ(cluster - 50, packet.pacing_info.probe_cluster_id);
+    }
+  }
+}
 }  // namespace test
 }  // namespace webrtc
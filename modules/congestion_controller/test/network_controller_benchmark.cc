@@ -0,0 +1,345 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "modules/congestion_controller/test/network_controller_benchmark.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "call/simulated_network.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+constexpr int64_t kPacketSizeBytes = 1200;
+// Allows the pacer to catch up after sending a little too late.
+constexpr int64_t kMaxPacerBurstBytes = 4 * kPacketSizeBytes;
+// Like an encoder dropping frames, never queue more than this in the pacer.
+constexpr int64_t kMaxEncoderQueueMs = 1000;
+constexpr uint64_t kCrossTrafficId = uint64_t{1} << 63;
+
+const TimeDelta kStep = TimeDelta::ms(1);
+
+void Accumulate(NetworkControlUpdate* state,
+                const NetworkControlUpdate& update) {
+  if (update.congestion_window)
+    state->congestion_window = update.congestion_window;
+  if (update.pacer_config)
+    state->pacer_config = update.pacer_config;
+  if (update.target_rate)
+    state->target_rate = update.target_rate;
+  for (const auto& probe : update.probe_cluster_configs)
+    state->probe_cluster_configs.push_back(probe);
+}
+
+// One run of the benchmark: the controlled sender, the link, the cross
+// traffic and the receiver, stepped a millisecond at a time.
+class BenchmarkRun {
+ public:
+  BenchmarkRun(const NetworkControllerBenchmark::Config& config,
+               NetworkControllerFactoryInterface* factory)
+      : config_(config),
+        start_time_(Timestamp::seconds(100000)),
+        now_(start_time_),
+        network_(NetworkConfig(config)),
+        process_interval_(factory->GetProcessInterval()),
+        next_process_time_(start_time_) {
+    NetworkControllerConfig controller_config;
+    controller_config.constraints.at_time = start_time_;
+    controller_config.constraints.min_data_rate = DataRate::Zero();
+    controller_config.constraints.max_data_rate = config.max_rate;
+    controller_config.starting_bandwidth = config.start_rate;
+    controller_ = factory->Create(controller_config);
+  }
+
+  NetworkControllerBenchmark::Result Run() {
+    const Timestamp end_time = start_time_ + config_.duration;
+    const Timestamp convergence_start =
+        start_time_ + std::min(config_.cross_traffic_start, config_.duration);
+    absl::optional<Timestamp> left_band_at;
+    bool in_band = false;
+    while (now_ < end_time) {
+      if (now_ >= next_process_time_) {
+        ProcessInterval msg;
+        msg.at_time = now_;
+        Accumulate(&state_, controller_->OnProcessInterval(msg));
+        // Controllers without periodic processing still need the first call.
+        next_process_time_ = process_interval_.IsFinite()
+                                 ? now_ + process_interval_
+                                 : Timestamp::Infinity();
+      }
+      StartProbes();
+      SendCrossTraffic();
+      SendPackets();
+      ReceivePackets();
+      SendAndReceiveFeedback();
+
+      if (now_ >= convergence_start && state_.target_rate) {
+        in_band = IsInConvergenceBand(state_.target_rate->target_rate);
+        if (!in_band)
+          left_band_at = now_;
+      }
+      now_ += kStep;
+    }
+
+    NetworkControllerBenchmark::Result result;
+    result.throughput = DataSize::bytes(delivered_bytes_) / config_.duration;
+    if (!queue_delays_us_.empty()) {
+      int64_t sum_us = 0;
+      for (int64_t delay_us : queue_delays_us_)
+        sum_us += delay_us;
+      result.mean_queue_delay =
+          TimeDelta::us(sum_us / static_cast<int64_t>(queue_delays_us_.size()));
+      size_t p95_index = queue_delays_us_.size() * 95 / 100;
+      std::nth_element(queue_delays_us_.begin(),
+                       queue_delays_us_.begin() + p95_index,
+                       queue_delays_us_.end());
+      result.p95_queue_delay = TimeDelta::us(queue_delays_us_[p95_index]);
+    }
+    if (sent_packets_ > 0)
+      result.loss_ratio = static_cast<double>(lost_packets_) / sent_packets_;
+    if (in_band) {
+      result.convergence_time =
+          left_band_at ? *left_band_at + kStep - convergence_start
+                       : TimeDelta::Zero();
+    }
+    return result;
+  }
+
+ private:
+  struct Probe {
+    int cluster_id;
+    int min_probes;
+    int min_bytes;
+    DataRate rate;
+    int64_t remaining_bytes;
+    Timestamp next_send_time;
+  };
+
+  static SimulatedNetwork::Config NetworkConfig(
+      const NetworkControllerBenchmark::Config& config) {
+    SimulatedNetwork::Config network_config;
+    network_config.link_capacity_kbps = config.link_capacity.kbps();
+    network_config.queue_delay_ms = config.propagation_delay.ms();
+    network_config.queue_length_packets = config.queue_length_packets;
+    return network_config;
+  }
+
+  DataRate AvailableCapacity() const {
+    if (now_ - start_time_ < config_.cross_traffic_start)
+      return config_.link_capacity;
+    if (config_.cross_traffic_rate >= config_.link_capacity)
+      return DataRate::Zero();
+    return DataRate::bps(config_.link_capacity.bps() -
+                         config_.cross_traffic_rate.bps());
+  }
+
+  bool IsInConvergenceBand(DataRate target_rate) const {
+    DataRate available = std::min(AvailableCapacity(), config_.max_rate);
+    return target_rate >= available * (1 - config_.convergence_margin) &&
+           target_rate <= available * (1 + config_.convergence_margin);
+  }
+
+  void StartProbes() {
+    for (const ProbeClusterConfig& config : state_.probe_cluster_configs) {
+      DataSize size = config.target_data_rate * config.target_duration;
+      int bytes = static_cast<int>(size.bytes());
+      probes_.push_back({next_probe_cluster_id_++, config.target_probe_count,
+                         bytes, config.target_data_rate,
+                         std::max<int64_t>(bytes, kPacketSizeBytes), now_});
+    }
+    state_.probe_cluster_configs.clear();
+  }
+
+  void SendCrossTraffic() {
+    if (config_.cross_traffic_rate.IsZero() ||
+        now_ - start_time_ < config_.cross_traffic_start) {
+      return;
+    }
+    cross_traffic_budget_bytes_ += (config_.cross_traffic_rate * kStep).bytes();
+    while (cross_traffic_budget_bytes_ >= kPacketSizeBytes) {
+      network_.EnqueuePacket(PacketInFlightInfo(
+          kPacketSizeBytes, now_.us(), kCrossTrafficId | cross_traffic_id_++));
+      cross_traffic_budget_bytes_ -= kPacketSizeBytes;
+    }
+  }
+
+  void SendPackets() {
+    // Probes are sent regardless of the window, like PacedSender does.
+    while (!probes_.empty() && probes_.front().next_send_time <= now_) {
+      Probe& probe = probes_.front();
+      SendPacket(PacedPacketInfo(probe.cluster_id, probe.min_probes,
+                                 probe.min_bytes));
+      probe.remaining_bytes -= kPacketSizeBytes;
+      probe.next_send_time += DataSize::bytes(kPacketSizeBytes) / probe.rate;
+      if (probe.remaining_bytes <= 0)
+        probes_.pop_front();
+    }
+
+    if (!state_.target_rate || !state_.pacer_config)
+      return;
+    const DataRate target_rate = state_.target_rate->target_rate;
+    const TimeDelta max_queue = TimeDelta::ms(kMaxEncoderQueueMs);
+    encoder_queue_bytes_ =
+        std::min(encoder_queue_bytes_ + (target_rate * kStep).bytes(),
+                 (target_rate * max_queue).bytes());
+    media_budget_bytes_ =
+        std::min(media_budget_bytes_ +
+                     (state_.pacer_config->data_rate() * kStep).bytes(),
+                 kMaxPacerBurstBytes);
+    padding_budget_bytes_ =
+        std::min(padding_budget_bytes_ +
+                     (state_.pacer_config->pad_rate() * kStep).bytes(),
+                 kMaxPacerBurstBytes);
+    while (media_budget_bytes_ >= kPacketSizeBytes && !IsWindowFull()) {
+      bool padding = encoder_queue_bytes_ < kPacketSizeBytes;
+      if (padding && padding_budget_bytes_ < kPacketSizeBytes)
+        break;
+      SendPacket(PacedPacketInfo());
+      media_budget_bytes_ -= kPacketSizeBytes;
+      if (padding) {
+        padding_budget_bytes_ -= kPacketSizeBytes;
+      } else {
+        encoder_queue_bytes_ -= kPacketSizeBytes;
+      }
+    }
+  }
+
+  bool IsWindowFull() const {
+    return state_.congestion_window && state_.congestion_window->IsFinite() &&
+           in_flight_bytes_ >= state_.congestion_window->bytes();
+  }
+
+  void SendPacket(const PacedPacketInfo& pacing_info) {
+    SentPacket packet;
+    packet.send_time = now_;
+    packet.size = DataSize::bytes(kPacketSizeBytes);
+    packet.pacing_info = pacing_info;
+    packet.sequence_number = next_sequence_number_++;
+    in_flight_bytes_ += kPacketSizeBytes;
+    packet.data_in_flight = DataSize::bytes(in_flight_bytes_);
+    Accumulate(&state_, controller_->OnSentPacket(packet));
+    in_flight_.emplace(packet.sequence_number, packet);
+    ++sent_packets_;
+    if (!network_.EnqueuePacket(PacketInFlightInfo(
+            kPacketSizeBytes, now_.us(), packet.sequence_number))) {
+      OnPacketReceived(packet.sequence_number, Timestamp::Infinity());
+    }
+  }
+
+  void ReceivePackets() {
+    for (const PacketDeliveryInfo& delivery :
+         network_.DequeueDeliverablePackets(now_.us())) {
+      if (delivery.packet_id & kCrossTrafficId)
+        continue;
+      Timestamp receive_time =
+          delivery.receive_time_us == PacketDeliveryInfo::kNotReceived
+              ? Timestamp::Infinity()
+              : Timestamp::us(delivery.receive_time_us);
+      OnPacketReceived(delivery.packet_id, receive_time);
+    }
+  }
+
+  void OnPacketReceived(int64_t sequence_number, Timestamp receive_time) {
+    auto it = in_flight_.find(sequence_number);
+    RTC_DCHECK(it != in_flight_.end());
+    PacketResult result;
+    result.sent_packet = it->second;
+    result.receive_time = receive_time;
+    if (receive_time.IsInfinite()) {
+      ++lost_packets_;
+    } else {
+      delivered_bytes_ += kPacketSizeBytes;
+      TimeDelta queue_delay =
+          receive_time - it->second.send_time - config_.propagation_delay;
+      queue_delays_us_.push_back(std::max<int64_t>(queue_delay.us(), 0));
+    }
+    unreported_.push_back(result);
+  }
+
+  void SendAndReceiveFeedback() {
+    if (now_ >= next_feedback_time_) {
+      if (!unreported_.empty()) {
+        feedback_in_flight_.emplace_back(now_ + config_.propagation_delay,
+                                         std::move(unreported_));
+        unreported_.clear();
+      }
+      next_feedback_time_ = now_ + config_.feedback_interval;
+    }
+    while (!feedback_in_flight_.empty() &&
+           feedback_in_flight_.front().first <= now_) {
+      TransportPacketsFeedback feedback;
+      feedback.feedback_time = now_;
+      feedback.prior_in_flight = DataSize::bytes(in_flight_bytes_);
+      feedback.packet_feedbacks = std::move(feedback_in_flight_.front().second);
+      feedback_in_flight_.pop_front();
+      std::sort(feedback.packet_feedbacks.begin(),
+                feedback.packet_feedbacks.end(),
+                [](const PacketResult& a, const PacketResult& b) {
+                  return a.sent_packet->sequence_number <
+                         b.sent_packet->sequence_number;
+                });
+      for (const PacketResult& result : feedback.packet_feedbacks) {
+        in_flight_.erase(result.sent_packet->sequence_number);
+        in_flight_bytes_ -= kPacketSizeBytes;
+      }
+      feedback.data_in_flight = DataSize::bytes(in_flight_bytes_);
+      Accumulate(&state_, controller_->OnTransportPacketsFeedback(feedback));
+    }
+  }
+
+  const NetworkControllerBenchmark::Config config_;
+  const Timestamp start_time_;
+  Timestamp now_;
+  SimulatedNetwork network_;
+  std::unique_ptr<NetworkControllerInterface> controller_;
+  const TimeDelta process_interval_;
+  Timestamp next_process_time_;
+  NetworkControlUpdate state_;
+
+  std::deque<Probe> probes_;
+  int next_probe_cluster_id_ = 1;
+  int64_t encoder_queue_bytes_ = 0;
+  int64_t media_budget_bytes_ = 0;
+  int64_t padding_budget_bytes_ = 0;
+  int64_t cross_traffic_budget_bytes_ = 0;
+  uint64_t cross_traffic_id_ = 0;
+
+  int64_t next_sequence_number_ = 1;
+  std::map<int64_t, SentPacket> in_flight_;
+  int64_t in_flight_bytes_ = 0;
+  std::vector<PacketResult> unreported_;
+  Timestamp next_feedback_time_ = Timestamp::ms(0);
+  std::deque<std::pair<Timestamp, std::vector<PacketResult>>>
+      feedback_in_flight_;
+
+  int64_t sent_packets_ = 0;
+  int64_t lost_packets_ = 0;
+  int64_t delivered_bytes_ = 0;
+  std::vector<int64_t> queue_delays_us_;
+};
+}  // namespace
+
+NetworkControllerBenchmark::NetworkControllerBenchmark(Config config)
+    : config_(config) {}
+
+NetworkControllerBenchmark::~NetworkControllerBenchmark() = default;
+
+NetworkControllerBenchmark::Result NetworkControllerBenchmark::Run(
+    NetworkControllerFactoryInterface* factory) const {
+  return BenchmarkRun(config_, factory).Run();
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef MODULES_CONGESTION_CONTROLLER_TEST_NETWORK_CONTROLLER_BENCHMARK_H_
+#define MODULES_CONGESTION_CONTROLLER_TEST_NETWORK_CONTROLLER_BENCHMARK_H_
+
+#include <stddef.h>
+
+#include "absl/types/optional.h"
+#include "api/transport/network_control.h"
+
+namespace webrtc {
+namespace test {
+
+// Runs a network controller against a bottleneck link simulated with
+// SimulatedNetwork, which it may share with constant rate cross traffic, and
+// measures how well the controller uses the link. The sender is idealized:
+// the encoder produces exactly the target rate, the pacer sends at the pacing
+// rate within the congestion window and sends the requested probes, and the
+// receiver reports every packet in transport feedback at a fixed interval.
+class NetworkControllerBenchmark {
+ public:
+  struct Config {
+    DataRate link_capacity = DataRate::kbps(2000);
+    // One way, the same in both directions.
+    TimeDelta propagation_delay = TimeDelta::ms(50);
+    // Packets that fit in the bottleneck queue, 0 for no limit.
+    size_t queue_length_packets = 0;
+    DataRate cross_traffic_rate = DataRate::Zero();
+    // Cross traffic runs from |cross_traffic_start| until the end.
+    TimeDelta cross_traffic_start = TimeDelta::Zero();
+    TimeDelta duration = TimeDelta::seconds(30);
+    DataRate start_rate = DataRate::kbps(300);
+    DataRate max_rate = DataRate::kbps(5000);
+    TimeDelta feedback_interval = TimeDelta::ms(50);
+    // The target rate has converged once it stays within this fraction of the
+    // capacity not used by cross traffic.
+    double convergence_margin = 0.2;
+  };
+
+  struct Result {
+    // Data of the controlled sender delivered per second of the run.
+    DataRate throughput = DataRate::Zero();
+    // Time spent in the bottleneck queue by delivered packets.
+    TimeDelta mean_queue_delay = TimeDelta::Zero();
+    TimeDelta p95_queue_delay = TimeDelta::Zero();
+    double loss_ratio = 0;
+    // Time from the start of the cross traffic, or of the run without cross
+    // traffic, until the target rate converged. Not set if it did not.
+    absl::optional<TimeDelta> convergence_time;
+  };
+
+  explicit NetworkControllerBenchmark(Config config);
+  ~NetworkControllerBenchmark();
+
+  Result Run(NetworkControllerFactoryInterface* factory) const;
+
+ private:
+  const Config config_;
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_TEST_NETWORK_CONTROLLER_BENCHMARK_H_
@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/alpha_blend_neon.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+extern int AlphaBlendRow_NEON(uint8_t* dest, const uint8_t* src, int width) {
+  const uint16x8_t one = vdupq_n_u16(1);
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    // De-interleave the channels of 8 pixels, channel 3 being the alpha.
+    const uint8x8x4_t s = vld4_u8(src + x * 4);
+    const uint8x8_t transparent = vceq_u8(s.val[3], vdup_n_u8(0));
+    // Most of a cursor image is transparent, leave |dest| untouched there.
+    if (vget_lane_u64(vreinterpret_u64_u8(transparent), 0) == ~0ull)
+      continue;
+    const uint8x8_t opaque = vceq_u8(s.val[3], vdup_n_u8(255));
+    const uint8x8_t base_alpha = vmvn_u8(s.val[3]);
+    uint8x8x4_t d = vld4_u8(dest + x * 4);
+    for (int c = 0; c < 3; ++c) {
+      // dest * base_alpha / 255 computed exactly as (t + 1 + (t >> 8)) >> 8,
+      // the sum wraps around like the C version.
+      uint16x8_t t = vmull_u8(d.val[c], base_alpha);
+      t = vshrq_n_u16(vaddq_u16(vaddq_u16(t, vshrq_n_u16(t, 8)), one), 8);
+      uint8x8_t blended = vadd_u8(vmovn_u16(t), s.val[c]);
+      blended = vbsl_u8(opaque, s.val[c], blended);
+      d.val[c] = vbsl_u8(transparent, d.val[c], blended);
+    }
+    // Blending keeps the alpha of |dest|, opaque pixels are copied.
+    d.val[3] = vbsl_u8(opaque, s.val[3], d.val[3]);
+    vst4_u8(dest + x * 4, d);
+  }
+  return x;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,28 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This header file is used only by desktop_and_cursor_composer.cc. It defines
+// the NEON routine for blending the mouse cursor into a frame.
+
+#ifndef MODULES_DESKTOP_CAPTURE_ALPHA_BLEND_NEON_H_
+#define MODULES_DESKTOP_CAPTURE_ALPHA_BLEND_NEON_H_
+
+#include <stdint.h>
+
+namespace webrtc {
+
+// Blends the pre-multiplied |src| row into the |dest| row, 8 pixels at a time,
+// with the same result as the C version. Returns the number of pixels blended,
+// which is |width| rounded down to a multiple of 8.
+extern int AlphaBlendRow_NEON(uint8_t* dest, const uint8_t* src, int width);
+
+}  // namespace webrtc
+
+#endif  // MODULES_DESKTOP_CAPTURE_ALPHA_BLEND_NEON_H_
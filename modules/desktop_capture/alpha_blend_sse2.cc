@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/alpha_blend_sse2.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+
+namespace {
+
+// Blends the two pixels in the low 64 bits of |src| and |dest| as 16 bit
+// lanes. dest * (255 - alpha) / 255 is computed exactly as
+// (t + 1 + (t >> 8)) >> 8, and the sums wrap around like the C version.
+inline __m128i BlendTwoPixels(__m128i dest, __m128i src) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i d = _mm_unpacklo_epi8(dest, zero);
+  const __m128i s = _mm_unpacklo_epi8(src, zero);
+  // Spread the alpha of each pixel over its 4 lanes.
+  __m128i alpha = _mm_shufflelo_epi16(s, 0xFF);
+  alpha = _mm_shufflehi_epi16(alpha, 0xFF);
+  const __m128i base_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  __m128i t = _mm_mullo_epi16(d, base_alpha);
+  t = _mm_add_epi16(t, _mm_srli_epi16(t, 8));
+  t = _mm_srli_epi16(_mm_add_epi16(t, _mm_set1_epi16(1)), 8);
+  return _mm_and_si128(_mm_add_epi16(t, s), _mm_set1_epi16(0xFF));
+}
+
+inline __m128i Select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+}  // namespace
+
+extern int AlphaBlendRow_SSE2(uint8_t* dest, const uint8_t* src, int width) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i opaque = _mm_set1_epi32(255);
+  const __m128i alpha_mask = _mm_set1_epi32(0xFF000000);
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    __m128i* d_ptr = reinterpret_cast<__m128i*>(dest + x * 4);
+    const __m128i s = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(src + x * 4));
+    const __m128i alpha = _mm_srli_epi32(s, 24);
+    const __m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+    // Most of a cursor image is transparent, leave |dest| untouched there.
+    if (_mm_movemask_epi8(transparent) == 0xFFFF)
+      continue;
+    const __m128i d = _mm_loadu_si128(d_ptr);
+    __m128i blended =
+        _mm_packus_epi16(BlendTwoPixels(d, s),
+                         BlendTwoPixels(_mm_srli_si128(d, 8),
+                                        _mm_srli_si128(s, 8)));
+    // Blending keeps the alpha of |dest|, opaque pixels are copied and
+    // transparent ones are skipped.
+    blended = Select(alpha_mask, d, blended);
+    blended = Select(_mm_cmpeq_epi32(alpha, opaque), s, blended);
+    blended = Select(transparent, d, blended);
+    _mm_storeu_si128(d_ptr, blended);
+  }
+  return x;
+}
+
+}  // namespace webrtc
@@ -21,11 +21,55 @@
 #include "modules/desktop_capture/mouse_cursor_monitor.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/desktop_capture/alpha_blend_sse2.h"
+#elif defined(WEBRTC_HAS_NEON)
+#include "modules/desktop_capture/alpha_blend_neon.h"
+#endif
 
 namespace webrtc {
 
 namespace {
 
+// Blends one pixel of the pre-multiplied |src| into |dest|.
+inline void AlphaBlendPixel(uint8_t* dest, const uint8_t* src) {
+  uint32_t base_alpha = 255 - src[3];
+  if (base_alpha == 255) {
+    return;
+  } else if (base_alpha == 0) {
+    memcpy(dest, src, DesktopFrame::kBytesPerPixel);
+  } else {
+    dest[0] = dest[0] * base_alpha / 255 + src[0];
+    dest[1] = dest[1] * base_alpha / 255 + src[1];
+    dest[2] = dest[2] * base_alpha / 255 + src[2];
+  }
+}
+
+int AlphaBlendRow_C(uint8_t* dest, const uint8_t* src, int width) {
+  for (int x = 0; x < width; ++x) {
+    AlphaBlendPixel(dest + x * DesktopFrame::kBytesPerPixel,
+                    src + x * DesktopFrame::kBytesPerPixel);
+  }
+  return width;
+}
+
+using AlphaBlendRowFunction = int (*)(uint8_t*, const uint8_t*, int);
+
+AlphaBlendRowFunction SelectAlphaBlendRow() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    return &AlphaBlendRow_SSE2;
+  return &AlphaBlendRow_C;
+#elif defined(WEBRTC_HAS_NEON)
+  return &AlphaBlendRow_NEON;
+#else
+  return &AlphaBlendRow_C;
+#endif
+}
+
 // Helper function that blends one image into another. Source image must be
 // pre-multiplied with the alpha channel. Destination is assumed to be opaque.
 void AlphaBlend(uint8_t* dest,
@@ -33,26 +77,12 @@ void AlphaBlend(uint8_t* dest,
                 const uint8_t* src,
                 int src_stride,
                 const DesktopSize& size) {
+  static const AlphaBlendRowFunction blend_row = SelectAlphaBlendRow();
   for (int y = 0; y < size.height(); ++y) {
-    for (int x = 0; x < size.width(); ++x) {
-      uint32_t base_alpha = 255 - src[x * DesktopFrame::kBytesPerPixel + 3];
-      if (base_alpha == 255) {
-        continue;
-      } else if (base_alpha == 0) {
-        memcpy(dest + x * DesktopFrame::kBytesPerPixel,
-               src + x * DesktopFrame::kBytesPerPixel,
-               DesktopFrame::kBytesPerPixel);
-      } else {
-        dest[x * DesktopFrame::kBytesPerPixel] =
-            dest[x * DesktopFrame::kBytesPerPixel] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel];
-        dest[x * DesktopFrame::kBytesPerPixel + 1] =
-            dest[x * DesktopFrame::kBytesPerPixel + 1] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 1];
-        dest[x * DesktopFrame::kBytesPerPixel + 2] =
-            dest[x * DesktopFrame::kBytesPerPixel + 2] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 2];
-      }
+    // The SIMD versions leave the pixels past their vector width to the C one.
+    for (int x = blend_row(dest, src, size.width()); x < size.width(); ++x) {
+      AlphaBlendPixel(dest + x * DesktopFrame::kBytesPerPixel,
+                      src + x * DesktopFrame::kBytesPerPixel);
     }
     src += src_stride;
     dest += dest_stride;
@@ -150,6 +180,10 @@ void DesktopAndCursorComposer::Start(DesktopCapturer::Callback* callback) {
   desktop_capturer_->Start(this);
 }
 
+void DesktopAndCursorComposer::SetCursorCallback(CursorCallback* callback) {
+  cursor_callback_ = callback;
+}
+
 void DesktopAndCursorComposer::SetSharedMemoryFactory(
     std::unique_ptr<SharedMemoryFactory> shared_memory_factory) {
   desktop_capturer_->SetSharedMemoryFactory(std::move(shared_memory_factory));
@@ -168,14 +202,15 @@ void DesktopAndCursorComposer::SetExcludedWindow(WindowId window) {
 void DesktopAndCursorComposer::OnCaptureResult(
     DesktopCapturer::Result result,
     std::unique_ptr<DesktopFrame> frame) {
-  if (frame && cursor_) {
-    if (frame->rect().Contains(cursor_position_) &&
-        !desktop_capturer_->IsOccluded(cursor_position_)) {
-      const float scale = frame->scale_factor();
-      DesktopVector relative_position =
-          cursor_position_.subtract(frame->top_left());
-      relative_position.set(relative_position.x() * scale,
-                            relative_position.y() * scale);
+  if (frame && cursor_callback_) {
+    const MouseCursor* cursor = nullptr;
+    DesktopVector relative_position;
+    if (cursor_ && GetRelativeCursorPosition(*frame, &relative_position))
+      cursor = cursor_.get();
+    cursor_callback_->OnFrameCursor(cursor, relative_position);
+  } else if (frame && cursor_) {
+    DesktopVector relative_position;
+    if (GetRelativeCursorPosition(*frame, &relative_position)) {
       frame = absl::make_unique<DesktopFrameWithCursor>(
           std::move(frame), *cursor_, relative_position);
     }
@@ -184,6 +219,19 @@ void DesktopAndCursorComposer::OnCaptureResult(
   callback_->OnCaptureResult(result, std::move(frame));
 }
 
+bool DesktopAndCursorComposer::GetRelativeCursorPosition(
+    const DesktopFrame& frame,
+    DesktopVector* position) const {
+  if (!frame.rect().Contains(cursor_position_) ||
+      desktop_capturer_->IsOccluded(cursor_position_)) {
+    return false;
+  }
+  const float scale = frame.scale_factor();
+  *position = cursor_position_.subtract(frame.top_left());
+  position->set(position->x() * scale, position->y() * scale);
+  return true;
+}
+
 void DesktopAndCursorComposer::OnMouseCursor(MouseCursor* cursor) {
   cursor_.reset(cursor);
 }
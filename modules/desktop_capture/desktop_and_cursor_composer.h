@@ -26,6 +26,20 @@ class DesktopAndCursorComposer : public DesktopCapturer,
                                  public DesktopCapturer::Callback,
                                  public MouseCursorMonitor::Callback {
  public:
+  // Receives the mouse cursor of each frame when it isn't drawn into the
+  // frames, see SetCursorCallback().
+  class CursorCallback {
+   public:
+    // Called right before |frame| of OnCaptureResult() is passed on. |cursor|
+    // is null if the cursor isn't over the frame or is occluded, otherwise
+    // |position| is where its hotspot is in the frame, in frame pixels.
+    virtual void OnFrameCursor(const MouseCursor* cursor,
+                               const DesktopVector& position) = 0;
+
+   protected:
+    virtual ~CursorCallback() {}
+  };
+
   // Creates a new blender that captures mouse cursor using
   // MouseCursorMonitor::Create(options) and renders it into the frames
   // generated by |desktop_capturer|.
@@ -34,6 +48,12 @@ class DesktopAndCursorComposer : public DesktopCapturer,
 
   ~DesktopAndCursorComposer() override;
 
+  // Stops drawing the cursor into the frames, and reports it to |callback|
+  // instead, so that a consumer can render it on its own while the frames
+  // keep only the screen content, and unchanged regions stay unchanged when
+  // the cursor moves. Null draws the cursor again.
+  void SetCursorCallback(CursorCallback* callback);
+
   // DesktopCapturer interface.
   void Start(DesktopCapturer::Callback* callback) override;
   void SetSharedMemoryFactory(
@@ -60,10 +80,16 @@ class DesktopAndCursorComposer : public DesktopCapturer,
                              const DesktopVector& position) override;
   void OnMouseCursorPosition(const DesktopVector& position) override;
 
+  // Returns false if the cursor isn't over |frame| or is occluded, otherwise
+  // sets |position| to the cursor position in |frame| pixels.
+  bool GetRelativeCursorPosition(const DesktopFrame& frame,
+                                 DesktopVector* position) const;
+
   const std::unique_ptr<DesktopCapturer> desktop_capturer_;
   const std::unique_ptr<MouseCursorMonitor> mouse_monitor_;
 
   DesktopCapturer::Callback* callback_;
+  CursorCallback* cursor_callback_ = nullptr;
 
   std::unique_ptr<MouseCursor> cursor_;
   DesktopVector cursor_position_;
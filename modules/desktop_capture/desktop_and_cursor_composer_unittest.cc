@@ -17,6 +17,7 @@
 #include "modules/desktop_capture/mouse_cursor.h"
 #include "modules/desktop_capture/shared_desktop_frame.h"
 #include "rtc_base/arraysize.h"
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -117,10 +118,19 @@ class FakeMouseMonitor : public MouseCursorMonitor {
     hotspot_ = hotspot;
   }
 
+  // Uses |image| as the cursor image instead of the test cursor.
+  void SetImage(std::unique_ptr<DesktopFrame> image) {
+    image_ = std::move(image);
+    changed_ = true;
+  }
+
   void Init(Callback* callback, Mode mode) override { callback_ = callback; }
 
   void Capture() override {
-    if (changed_) {
+    if (changed_ && image_) {
+      callback_->OnMouseCursor(new MouseCursor(
+          BasicDesktopFrame::CopyOf(*image_), hotspot_));
+    } else if (changed_) {
       std::unique_ptr<DesktopFrame> image(
           new BasicDesktopFrame(DesktopSize(kCursorWidth, kCursorHeight)));
       uint32_t* data = reinterpret_cast<uint32_t*>(image->data());
@@ -146,6 +156,7 @@ class FakeMouseMonitor : public MouseCursorMonitor {
   DesktopVector position_;
   DesktopVector hotspot_;
   bool changed_;
+  std::unique_ptr<DesktopFrame> image_;
 };
 
 void VerifyFrame(const DesktopFrame& frame,
@@ -170,6 +181,43 @@ void VerifyFrame(const DesktopFrame& frame,
   }
 }
 
+// Returns a cursor image of random pre-multiplied pixels, with fully
+// transparent and opaque ones among them.
+std::unique_ptr<DesktopFrame> CreateRandomCursorImage(Random* random) {
+  std::unique_ptr<DesktopFrame> image(
+      new BasicDesktopFrame(DesktopSize(kCursorWidth, kCursorHeight)));
+  for (int y = 0; y < kCursorHeight; ++y) {
+    uint32_t* row = reinterpret_cast<uint32_t*>(
+        image->GetFrameDataAtPos(DesktopVector(0, y)));
+    for (int x = 0; x < kCursorWidth; ++x) {
+      uint32_t alpha = random->Rand(0, 2) == 0 ? random->Rand(0, 1) * 255
+                                               : random->Rand(0, 255);
+      row[x] = (alpha << 24) + (random->Rand(0u, alpha) << 16) +
+               (random->Rand(0u, alpha) << 8) + random->Rand(0u, alpha);
+    }
+  }
+  return image;
+}
+
+class FakeCursorCallback : public DesktopAndCursorComposer::CursorCallback {
+ public:
+  void OnFrameCursor(const MouseCursor* cursor,
+                     const DesktopVector& position) override {
+    ++num_calls_;
+    cursor_ = cursor;
+    position_ = position;
+  }
+
+  int num_calls() const { return num_calls_; }
+  const MouseCursor* cursor() const { return cursor_; }
+  const DesktopVector& position() const { return position_; }
+
+ private:
+  int num_calls_ = 0;
+  const MouseCursor* cursor_ = nullptr;
+  DesktopVector position_;
+};
+
 }  // namespace
 
 class DesktopAndCursorComposerTest : public testing::Test,
@@ -315,4 +363,73 @@ TEST_F(DesktopAndCursorComposerTest, CursorIncluded) {
   }
 }
 
+TEST_F(DesktopAndCursorComposerTest, TranslucentCursorIsBlended) {
+  Random random(0x5678);
+  std::unique_ptr<DesktopFrame> image = CreateRandomCursorImage(&random);
+  const uint32_t* image_data = reinterpret_cast<uint32_t*>(image->data());
+  fake_cursor_->SetImage(std::move(image));
+  std::unique_ptr<SharedDesktopFrame> frame(
+      SharedDesktopFrame::Wrap(CreateTestFrame()));
+
+  // Cursors clipped to every width, so that vectorized blending is done on
+  // both full and partial vectors.
+  for (int width = 1; width <= kCursorWidth; ++width) {
+    SCOPED_TRACE(width);
+
+    const DesktopVector pos(kScreenWidth - width, kScreenHeight / 2);
+    fake_screen_->SetNextFrame(frame->Share());
+    fake_cursor_->SetState(MouseCursorMonitor::OUTSIDE, pos);
+    blender_.CaptureFrame();
+
+    DesktopRect image_rect = DesktopRect::MakeWH(kCursorWidth, kCursorHeight);
+    image_rect.Translate(pos);
+    for (int y = 0; y < kScreenHeight; ++y) {
+      for (int x = 0; x < kScreenWidth; ++x) {
+        DesktopVector p(x, y);
+        uint32_t expected = GetFakeFramePixelValue(p);
+        if (image_rect.Contains(p)) {
+          expected = BlendPixels(
+              expected, image_data[(y - pos.y()) * kCursorWidth + x - pos.x()]);
+        }
+        ASSERT_EQ(expected, GetFramePixel(*frame_, p));
+      }
+    }
+
+    frame_.reset();
+    VerifyFrame(*frame, MouseCursorMonitor::OUTSIDE, DesktopVector());
+  }
+}
+
+TEST_F(DesktopAndCursorComposerTest, CursorCallbackGetsCursorInsteadOfFrame) {
+  FakeCursorCallback cursor_callback;
+  blender_.SetCursorCallback(&cursor_callback);
+  std::unique_ptr<SharedDesktopFrame> frame(
+      SharedDesktopFrame::Wrap(CreateTestFrame()));
+  frame->set_top_left(DesktopVector(100, 200));
+  // The frame covers (100, 200) - (200, 300).
+
+  fake_screen_->SetNextFrame(frame->Share());
+  fake_cursor_->SetState(MouseCursorMonitor::OUTSIDE, DesktopVector(150, 250));
+  blender_.CaptureFrame();
+  VerifyFrame(*frame_, MouseCursorMonitor::OUTSIDE, DesktopVector());
+  EXPECT_EQ(1, cursor_callback.num_calls());
+  ASSERT_TRUE(cursor_callback.cursor());
+  EXPECT_TRUE(cursor_callback.position().equals(DesktopVector(50, 50)));
+
+  fake_screen_->SetNextFrame(frame->Share());
+  fake_screen_->set_is_occluded(true);
+  blender_.CaptureFrame();
+  VerifyFrame(*frame_, MouseCursorMonitor::OUTSIDE, DesktopVector());
+  EXPECT_EQ(2, cursor_callback.num_calls());
+  EXPECT_FALSE(cursor_callback.cursor());
+
+  // Without a callback the cursor is drawn again.
+  blender_.SetCursorCallback(nullptr);
+  fake_screen_->set_is_occluded(false);
+  fake_screen_->SetNextFrame(frame->Share());
+  blender_.CaptureFrame();
+  VerifyFrame(*frame_, MouseCursorMonitor::INSIDE, DesktopVector(50, 50));
+  EXPECT_EQ(2, cursor_callback.num_calls());
+}
+
 }  // namespace webrtc
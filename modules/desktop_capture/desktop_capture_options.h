@@ -99,6 +99,14 @@ class DesktopCaptureOptions {
     detect_updated_region_ = detect_updated_region;
   }
 
+  // Flag that makes the updated region detection compare every fourth line of
+  // the frames first, so that changed areas are found sooner. Only used if
+  // detect_updated_region() is true.
+  bool hierarchical_diff() const { return hierarchical_diff_; }
+  void set_hierarchical_diff(bool hierarchical_diff) {
+    hierarchical_diff_ = hierarchical_diff;
+  }
+
 #if defined(WEBRTC_WIN)
   bool allow_use_magnification_api() const {
     return allow_use_magnification_api_;
@@ -137,6 +145,7 @@ class DesktopCaptureOptions {
 #endif
   bool disable_effects_ = true;
   bool detect_updated_region_ = false;
+  bool hierarchical_diff_ = false;
 };
 
 }  // namespace webrtc
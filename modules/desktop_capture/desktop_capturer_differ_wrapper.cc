@@ -44,6 +44,19 @@ bool PartialBlockDifference(const uint8_t* old_buffer,
   return false;
 }
 
+// Returns true if the (kBlockSize, |height|) blocks in |old_buffer| and
+// |new_buffer| differ, comparing them with HierarchicalBlockDifference() if
+// |hierarchical_diff| is true.
+bool FullBlockDifference(const uint8_t* old_buffer,
+                         const uint8_t* new_buffer,
+                         int height,
+                         int stride,
+                         bool hierarchical_diff) {
+  if (hierarchical_diff)
+    return HierarchicalBlockDifference(old_buffer, new_buffer, height, stride);
+  return BlockDifference(old_buffer, new_buffer, height, stride);
+}
+
 // Compares columns in the range of [|left|, |right|), in a row in the
 // range of [|top|, |top| + |height|), starts from |old_buffer| and
 // |new_buffer|, and outputs updated regions into |output|. |stride| is the
@@ -55,6 +68,7 @@ void CompareRow(const uint8_t* old_buffer,
                 const int top,
                 const int bottom,
                 const int stride,
+                const bool hierarchical_diff,
                 DesktopRegion* const output) {
   const int block_x_offset = kBlockSize * DesktopFrame::kBytesPerPixel;
   const int width = right - left;
@@ -70,7 +84,8 @@ void CompareRow(const uint8_t* old_buffer,
   // We always need to add dirty area into |output| in the last block, so handle
   // it separatedly.
   for (int x = 0; x < block_count; x++) {
-    if (BlockDifference(old_buffer, new_buffer, height, stride)) {
+    if (FullBlockDifference(old_buffer, new_buffer, height, stride,
+                            hierarchical_diff)) {
       if (first_dirty_x_block == -1) {
         // This is the first dirty block in a continuous dirty area.
         first_dirty_x_block = x;
@@ -93,7 +108,8 @@ void CompareRow(const uint8_t* old_buffer,
     last_block_diff = PartialBlockDifference(old_buffer, new_buffer,
                                              last_block_width, height, stride);
   } else {
-    last_block_diff = BlockDifference(old_buffer, new_buffer, height, stride);
+    last_block_diff = FullBlockDifference(old_buffer, new_buffer, height,
+                                          stride, hierarchical_diff);
   }
   if (last_block_diff) {
     if (first_dirty_x_block == -1) {
@@ -113,6 +129,7 @@ void CompareRow(const uint8_t* old_buffer,
 void CompareFrames(const DesktopFrame& old_frame,
                    const DesktopFrame& new_frame,
                    DesktopRect rect,
+                   bool hierarchical_diff,
                    DesktopRegion* const output) {
   RTC_DCHECK(old_frame.size().equals(new_frame.size()));
   RTC_DCHECK_EQ(old_frame.stride(), new_frame.stride());
@@ -131,21 +148,28 @@ void CompareFrames(const DesktopFrame& old_frame,
   // The last row may have a different height, so we handle it separately.
   for (int y = 0; y < y_block_count; y++) {
     CompareRow(prev_block_row_start, curr_block_row_start, rect.left(),
-               rect.right(), top, top + kBlockSize, old_frame.stride(), output);
+               rect.right(), top, top + kBlockSize, old_frame.stride(),
+               hierarchical_diff, output);
     top += kBlockSize;
     prev_block_row_start += block_y_stride;
     curr_block_row_start += block_y_stride;
   }
   CompareRow(prev_block_row_start, curr_block_row_start, rect.left(),
              rect.right(), top, top + last_y_block_height, old_frame.stride(),
-             output);
+             hierarchical_diff, output);
 }
 
 }  // namespace
 
 DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
     std::unique_ptr<DesktopCapturer> base_capturer)
-    : base_capturer_(std::move(base_capturer)) {
+    : DesktopCapturerDifferWrapper(std::move(base_capturer), false) {}
+
+DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
+    std::unique_ptr<DesktopCapturer> base_capturer,
+    bool hierarchical_diff)
+    : base_capturer_(std::move(base_capturer)),
+      hierarchical_diff_(hierarchical_diff) {
   RTC_DCHECK(base_capturer_);
 }
 
@@ -207,7 +231,7 @@ void DesktopCapturerDifferWrapper::OnCaptureResult(
     DesktopRegion hints;
     hints.Swap(frame->mutable_updated_region());
     for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
-      CompareFrames(*last_frame_, *frame, it.rect(),
+      CompareFrames(*last_frame_, *frame, it.rect(), hierarchical_diff_,
                     frame->mutable_updated_region());
     }
   } else {
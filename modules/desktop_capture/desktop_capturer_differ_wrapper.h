@@ -33,6 +33,10 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
   // implementation, and takes its ownership.
   explicit DesktopCapturerDifferWrapper(
       std::unique_ptr<DesktopCapturer> base_capturer);
+  // Same as above, but compares the blocks of the frames with
+  // HierarchicalBlockDifference() if |hierarchical_diff| is true.
+  DesktopCapturerDifferWrapper(std::unique_ptr<DesktopCapturer> base_capturer,
+                               bool hierarchical_diff);
 
   ~DesktopCapturerDifferWrapper() override;
 
@@ -53,6 +57,7 @@ class DesktopCapturerDifferWrapper : public DesktopCapturer,
                        std::unique_ptr<DesktopFrame> frame) override;
 
   const std::unique_ptr<DesktopCapturer> base_capturer_;
+  const bool hierarchical_diff_;
   DesktopCapturer::Callback* callback_;
   std::unique_ptr<SharedDesktopFrame> last_frame_;
 };
@@ -12,10 +12,16 @@
 
 #include <string.h>
 
-#include "modules/desktop_capture/differ_vector_sse2.h"
 #include "rtc_base/system/arch.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/desktop_capture/differ_vector_avx2.h"
+#include "modules/desktop_capture/differ_vector_sse2.h"
+#elif defined(WEBRTC_HAS_NEON)
+#include "modules/desktop_capture/differ_vector_neon.h"
+#endif
+
 namespace webrtc {
 
 namespace {
@@ -24,29 +30,31 @@ bool VectorDifference_C(const uint8_t* image1, const uint8_t* image2) {
   return memcmp(image1, image2, kBlockSize * kBytesPerPixel) != 0;
 }
 
-}  // namespace
+using VectorDifferenceFunction = bool (*)(const uint8_t*, const uint8_t*);
 
-bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
-  static bool (*diff_proc)(const uint8_t*, const uint8_t*) = nullptr;
-
-  if (!diff_proc) {
-#if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
-    // For ARM and MIPS processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
-    diff_proc = &VectorDifference_C;
+VectorDifferenceFunction SelectVectorDifference() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // For x86 processors, use the widest vectors that are supported.
+  if (WebRtc_GetCPUInfo(kAVX2) != 0)
+    return kBlockSize == 32 ? &VectorDifference_AVX2_W32
+                            : &VectorDifference_AVX2_W16;
+  if (WebRtc_GetCPUInfo(kSSE2) != 0)
+    return kBlockSize == 32 ? &VectorDifference_SSE2_W32
+                            : &VectorDifference_SSE2_W16;
+  return &VectorDifference_C;
+#elif defined(WEBRTC_HAS_NEON)
+  return kBlockSize == 32 ? &VectorDifference_NEON_W32
+                          : &VectorDifference_NEON_W16;
 #else
-    bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
-    // For x86 processors, check if SSE2 is supported.
-    if (have_sse2 && kBlockSize == 32) {
-      diff_proc = &VectorDifference_SSE2_W32;
-    } else if (have_sse2 && kBlockSize == 16) {
-      diff_proc = &VectorDifference_SSE2_W16;
-    } else {
-      diff_proc = &VectorDifference_C;
-    }
+  // For MIPS processors and ARM processors without NEON, use C version.
+  return &VectorDifference_C;
 #endif
-  }
+}
+
+}  // namespace
 
+bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
+  static const VectorDifferenceFunction diff_proc = SelectVectorDifference();
   return diff_proc(image1, image2);
 }
 
@@ -68,4 +76,22 @@ bool BlockDifference(const uint8_t* image1, const uint8_t* image2, int stride) {
   return BlockDifference(image1, image2, kBlockSize, stride);
 }
 
+bool HierarchicalBlockDifference(const uint8_t* image1,
+                                 const uint8_t* image2,
+                                 int height,
+                                 int stride) {
+  // Compare the downsampled lines first.
+  for (int i = 0; i < height; i += kHierarchicalDiffLineStep) {
+    if (VectorDifference(image1 + i * stride, image2 + i * stride))
+      return true;
+  }
+  for (int i = 0; i < height; i++) {
+    if (i % kHierarchicalDiffLineStep != 0 &&
+        VectorDifference(image1 + i * stride, image2 + i * stride)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace webrtc
@@ -37,6 +37,19 @@ bool BlockDifference(const uint8_t* image1,
 // (kBlockSize, kBlockSize).  Returns whether the blocks differ.
 bool BlockDifference(const uint8_t* image1, const uint8_t* image2, int stride);
 
+// Distance between the lines HierarchicalBlockDifference() compares first.
+const int kHierarchicalDiffLineStep = 4;
+
+// Same as BlockDifference(), but compares every kHierarchicalDiffLineStep-th
+// line of the blocks before the others. Changed content usually spans several
+// lines, so most changed blocks are found after reading a fraction of them.
+// Blocks are only reported as unchanged after all their lines are compared,
+// since skipping the other lines would miss e.g. a blinking text cursor.
+bool HierarchicalBlockDifference(const uint8_t* image1,
+                                 const uint8_t* image2,
+                                 int height,
+                                 int stride);
+
 }  // namespace webrtc
 
 #endif  // MODULES_DESKTOP_CAPTURE_DIFFER_BLOCK_H_
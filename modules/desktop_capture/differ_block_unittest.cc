@@ -83,4 +83,25 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+TEST(HierarchicalBlockDifferenceTest, FindsChangeInAnyLine) {
+  uint8_t* block1;
+  uint8_t* block2;
+  PrepareBuffers(block1, block2);
+  const int stride = kBlockSize * kBytesPerPixel;
+  EXPECT_FALSE(HierarchicalBlockDifference(block1, block2, kBlockSize, stride));
+
+  // Both the lines compared first and the others are checked.
+  for (int y = 0; y < kBlockSize; ++y) {
+    block2[y * stride + 5] += 1;
+    EXPECT_TRUE(
+        HierarchicalBlockDifference(block1, block2, kBlockSize, stride));
+    block2[y * stride + 5] -= 1;
+  }
+
+  // Partial blocks at the bottom of the frame.
+  block2[2 * stride] += 1;
+  EXPECT_TRUE(HierarchicalBlockDifference(block1, block2, 3, stride));
+  EXPECT_FALSE(HierarchicalBlockDifference(block1, block2, 2, stride));
+}
+
 }  // namespace webrtc
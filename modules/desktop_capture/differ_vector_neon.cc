@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/differ_vector_neon.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+namespace {
+
+// Returns whether the |num_vectors| 16 byte vectors starting at |image1| and
+// |image2| differ.
+inline bool VectorDifference_NEON(const uint8_t* image1,
+                                  const uint8_t* image2,
+                                  int num_vectors) {
+  uint8x16_t acc = veorq_u8(vld1q_u8(image1), vld1q_u8(image2));
+  for (int i = 1; i < num_vectors; ++i) {
+    acc = vorrq_u8(acc, veorq_u8(vld1q_u8(image1 + 16 * i),
+                                 vld1q_u8(image2 + 16 * i)));
+  }
+  const uint64x2_t acc64 = vreinterpretq_u64_u8(acc);
+  return (vgetq_lane_u64(acc64, 0) | vgetq_lane_u64(acc64, 1)) != 0;
+}
+
+}  // namespace
+
+extern bool VectorDifference_NEON_W16(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  return VectorDifference_NEON(image1, image2, 4);
+}
+
+extern bool VectorDifference_NEON_W32(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  return VectorDifference_NEON(image1, image2, 8);
+}
+
+}  // namespace webrtc
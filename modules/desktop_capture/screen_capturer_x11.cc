@@ -312,7 +312,6 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
 
   DesktopRegion* updated_region = frame->mutable_updated_region();
 
-  x_server_pixel_buffer_.Synchronize();
   if (use_damage_ && queue_.previous_frame()) {
     // Atomically fetch and clear the damage region.
     XDamageSubtract(display(), damage_handle_, None, damage_region_);
@@ -336,6 +335,16 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
     updated_region->IntersectWith(
         DesktopRect::MakeSize(x_server_pixel_buffer_.window_size()));
 
+    // Only fetch the lines spanned by the damage from the X server, and
+    // nothing at all if the screen hasn't changed.
+    DesktopRect damage_bounds;
+    for (DesktopRegion::Iterator it(*updated_region); !it.IsAtEnd();
+         it.Advance()) {
+      damage_bounds.UnionWith(it.rect());
+    }
+    if (!damage_bounds.is_empty())
+      x_server_pixel_buffer_.Synchronize(damage_bounds);
+
     for (DesktopRegion::Iterator it(*updated_region); !it.IsAtEnd();
          it.Advance()) {
       if (!x_server_pixel_buffer_.CaptureRect(it.rect(), frame.get()))
@@ -344,6 +353,7 @@ std::unique_ptr<DesktopFrame> ScreenCapturerLinux::CaptureScreen() {
   } else {
     // Doing full-screen polling, or this is the first capture after a
     // screen-resolution change.  In either case, need a full-screen capture.
+    x_server_pixel_buffer_.Synchronize();
     DesktopRect screen_rect = DesktopRect::MakeSize(frame->size());
     if (!x_server_pixel_buffer_.CaptureRect(screen_rect, frame.get()))
       return nullptr;
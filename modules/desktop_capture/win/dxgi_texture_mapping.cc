@@ -28,7 +28,8 @@ DxgiTextureMapping::~DxgiTextureMapping() = default;
 
 bool DxgiTextureMapping::CopyFromTexture(
     const DXGI_OUTDUPL_FRAME_INFO& frame_info,
-    ID3D11Texture2D* texture) {
+    ID3D11Texture2D* texture,
+    const DesktopRegion& updated_region) {
   RTC_DCHECK_GT(frame_info.AccumulatedFrames, 0);
   RTC_DCHECK(texture);
   *rect() = {0};
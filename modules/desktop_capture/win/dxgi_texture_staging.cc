@@ -60,6 +60,7 @@ bool DxgiTextureStaging::InitializeStage(ID3D11Texture2D* texture) {
   } else {
     RTC_DCHECK(!surface_);
   }
+  full_copy_needed_ = true;
 
   _com_error error = device_.d3d_device()->CreateTexture2D(
       &desc, nullptr, stage_.GetAddressOf());
@@ -93,7 +94,8 @@ void DxgiTextureStaging::AssertStageAndSurfaceAreSameObject() {
 
 bool DxgiTextureStaging::CopyFromTexture(
     const DXGI_OUTDUPL_FRAME_INFO& frame_info,
-    ID3D11Texture2D* texture) {
+    ID3D11Texture2D* texture,
+    const DesktopRegion& updated_region) {
   RTC_DCHECK_GT(frame_info.AccumulatedFrames, 0);
   RTC_DCHECK(texture);
 
@@ -103,18 +105,40 @@ bool DxgiTextureStaging::CopyFromTexture(
     return false;
   }
 
-  device_.context()->CopyResource(static_cast<ID3D11Resource*>(stage_.Get()),
-                                  static_cast<ID3D11Resource*>(texture));
+  if (full_copy_needed_) {
+    device_.context()->CopyResource(static_cast<ID3D11Resource*>(stage_.Get()),
+                                    static_cast<ID3D11Resource*>(texture));
+  } else {
+    // Reading back only the changed rectangles saves most of the transfer
+    // from GPU memory for high resolution screens, which seldom change whole.
+    for (DesktopRegion::Iterator it(updated_region); !it.IsAtEnd();
+         it.Advance()) {
+      const DesktopRect& dirty_rect = it.rect();
+      const D3D11_BOX box = {static_cast<UINT>(dirty_rect.left()),
+                             static_cast<UINT>(dirty_rect.top()),
+                             0,
+                             static_cast<UINT>(dirty_rect.right()),
+                             static_cast<UINT>(dirty_rect.bottom()),
+                             1};
+      device_.context()->CopySubresourceRegion(
+          static_cast<ID3D11Resource*>(stage_.Get()), 0, dirty_rect.left(),
+          dirty_rect.top(), 0, static_cast<ID3D11Resource*>(texture), 0,
+          &box);
+    }
+  }
 
   *rect() = {0};
   _com_error error = surface_->Map(rect(), DXGI_MAP_READ);
   if (error.Error() != S_OK) {
     *rect() = {0};
+    // The content of the stage can't be relied on anymore.
+    full_copy_needed_ = true;
     RTC_LOG(LS_ERROR) << "Failed to map the IDXGISurface to a bitmap, error "
                       << error.ErrorMessage() << ", code " << error.Error();
     return false;
   }
 
+  full_copy_needed_ = false;
   return true;
 }
 
@@ -39,9 +39,11 @@ class DxgiTextureStaging : public DxgiTexture {
 
  protected:
   // Copies selected regions of a frame represented by frame_info and texture.
-  // Returns false if anything wrong.
+  // Only |updated_region| is copied to the stage, which keeps the rest of the
+  // screen from earlier frames. Returns false if anything wrong.
   bool CopyFromTexture(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
-                       ID3D11Texture2D* texture) override;
+                       ID3D11Texture2D* texture,
+                       const DesktopRegion& updated_region) override;
 
   bool DoRelease() override;
 
@@ -61,6 +63,9 @@ class DxgiTextureStaging : public DxgiTexture {
   const D3dDevice device_;
   Microsoft::WRL::ComPtr<ID3D11Texture2D> stage_;
   Microsoft::WRL::ComPtr<IDXGISurface> surface_;
+  // Whether |stage_| is new, or may have missed updates, so that the next copy
+  // needs to cover the whole texture.
+  bool full_copy_needed_ = true;
 };
 
 }  // namespace webrtc
@@ -306,6 +306,26 @@ void XServerPixelBuffer::Synchronize() {
   }
 }
 
+void XServerPixelBuffer::Synchronize(const DesktopRect& rect) {
+  RTC_DCHECK_LE(rect.bottom(), window_rect_.height());
+  if (shm_segment_info_ && !shm_pixmap_) {
+    // XShmGetImage writes the lines of the image at the offset of its data in
+    // the segment, so narrow |x_shm_image_| to the lines of |rect| for the
+    // call. The lines keep the width and stride of the whole window.
+    char* const data = x_shm_image_->data;
+    const int height = x_shm_image_->height;
+    x_shm_image_->data = data + rect.top() * x_shm_image_->bytes_per_line;
+    x_shm_image_->height = rect.height();
+    {
+      XErrorTrap error_trap(display_);
+      xshm_get_image_succeeded_ = XShmGetImage(
+          display_, window_, x_shm_image_, 0, rect.top(), AllPlanes);
+    }
+    x_shm_image_->data = data;
+    x_shm_image_->height = height;
+  }
+}
+
 bool XServerPixelBuffer::CaptureRect(const DesktopRect& rect,
                                      DesktopFrame* frame) {
   RTC_DCHECK_LE(rect.right(), window_rect_.width());
@@ -54,6 +54,11 @@ class XServerPixelBuffer {
   // beginning.
   void Synchronize();
 
+  // Same as Synchronize(), but only fetches the lines spanned by |rect|, so
+  // that CaptureRect() can only be called for rectangles within these lines
+  // until the next synchronization.
+  void Synchronize(const DesktopRect& rect);
+
   // Capture the specified rectangle and stores it in the |frame|. In the case
   // where the full-screen data is captured by Synchronize(), this simply
   // returns the pointer without doing any more work. The caller must ensure
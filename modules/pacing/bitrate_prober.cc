@@ -11,6 +11,7 @@
 #include "modules/pacing/bitrate_prober.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "absl/memory/memory.h"
 #include "logging/rtc_event_log/events/rtc_event_probe_cluster_created.h"
@@ -43,6 +44,10 @@ constexpr size_t kMinProbePacketSize = 200;
 
 constexpr int64_t kProbeClusterTimeoutMs = 5000;
 
+// A new cluster is merged into a queued cluster that has not started yet if
+// their bitrates differ by at most this fraction.
+constexpr double kMaxCoalescedBitrateDifference = 0.1;
+
 }  // namespace
 
 BitrateProber::BitrateProber() : BitrateProber(nullptr) {}
@@ -90,7 +95,21 @@ void BitrateProber::CreateProbeCluster(int bitrate_bps, int64_t now_ms) {
   RTC_DCHECK_GT(bitrate_bps, 0);
   while (!clusters_.empty() &&
          now_ms - clusters_.front().time_created_ms > kProbeClusterTimeoutMs) {
-    clusters_.pop();
+    clusters_.pop_front();
+  }
+
+  // Controllers sharing the pacer, or one controller reacting to several
+  // allocation changes in a row, may ask for the same probe more than once
+  // before it is sent. Sending it once is enough.
+  for (const ProbeCluster& queued : clusters_) {
+    if (queued.time_started_ms == -1 &&
+        std::abs(queued.pace_info.send_bitrate_bps - bitrate_bps) <=
+            kMaxCoalescedBitrateDifference * bitrate_bps) {
+      RTC_LOG(LS_INFO) << "Probe cluster at " << bitrate_bps
+                       << " bps coalesced with queued cluster "
+                       << queued.pace_info.probe_cluster_id;
+      return;
+    }
   }
 
   ProbeCluster cluster;
@@ -100,7 +119,7 @@ void BitrateProber::CreateProbeCluster(int bitrate_bps, int64_t now_ms) {
       bitrate_bps * kMinProbeDurationMs / 8000;
   cluster.pace_info.send_bitrate_bps = bitrate_bps;
   cluster.pace_info.probe_cluster_id = next_cluster_id_++;
-  clusters_.push(cluster);
+  clusters_.push_back(cluster);
   if (event_log_)
     event_log_->Log(absl::make_unique<RtcEventProbeClusterCreated>(
         cluster.pace_info.probe_cluster_id, cluster.pace_info.send_bitrate_bps,
@@ -166,7 +185,7 @@ void BitrateProber::ProbeSent(int64_t now_ms, size_t bytes) {
     next_probe_time_ms_ = GetNextProbeTime(*cluster);
     if (cluster->sent_bytes >= cluster->pace_info.probe_cluster_min_bytes &&
         cluster->sent_probes >= cluster->pace_info.probe_cluster_min_probes) {
-      clusters_.pop();
+      clusters_.pop_front();
     }
     if (clusters_.empty())
       probing_state_ = ProbingState::kSuspended;
@@ -11,7 +11,7 @@
 #ifndef MODULES_PACING_BITRATE_PROBER_H_
 #define MODULES_PACING_BITRATE_PROBER_H_
 
-#include <queue>
+#include <deque>
 
 #include "modules/include/module_common_types.h"
 
@@ -92,7 +92,7 @@ class BitrateProber {
   // Probe bitrate per packet. These are used to compute the delta relative to
   // the previous probe packet based on the size and time when that packet was
   // sent.
-  std::queue<ProbeCluster> clusters_;
+  std::deque<ProbeCluster> clusters_;
 
   // Time the next probe should be sent when in kActive state.
   int64_t next_probe_time_ms_;
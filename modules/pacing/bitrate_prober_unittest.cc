@@ -72,6 +72,35 @@ TEST(BitrateProberTest, VerifyStatesAndTimeBetweenProbes) {
   EXPECT_FALSE(prober.IsProbing());
 }
 
+TEST(BitrateProberTest, CoalescesQueuedClustersWithSimilarBitrate) {
+  BitrateProber prober;
+  int64_t now_ms = 0;
+  const int kProbeSize = 1000;
+
+  prober.CreateProbeCluster(900000, now_ms);
+  prober.CreateProbeCluster(950000, now_ms);
+  prober.CreateProbeCluster(1800000, now_ms);
+  prober.OnIncomingPacket(kProbeSize);
+  EXPECT_EQ(0, prober.CurrentCluster().probe_cluster_id);
+  EXPECT_EQ(900000, prober.CurrentCluster().send_bitrate_bps);
+
+  // Once a cluster has started, a new one is queued even if it is similar.
+  prober.ProbeSent(now_ms, kProbeSize);
+  prober.CreateProbeCluster(900000, now_ms);
+  for (int i = 1; i < 5; ++i) {
+    now_ms += prober.TimeUntilNextProbe(now_ms);
+    prober.ProbeSent(now_ms, kProbeSize);
+  }
+  EXPECT_EQ(1, prober.CurrentCluster().probe_cluster_id);
+  EXPECT_EQ(1800000, prober.CurrentCluster().send_bitrate_bps);
+  for (int i = 0; i < 5; ++i) {
+    now_ms += prober.TimeUntilNextProbe(now_ms);
+    prober.ProbeSent(now_ms, kProbeSize);
+  }
+  EXPECT_EQ(2, prober.CurrentCluster().probe_cluster_id);
+  EXPECT_EQ(900000, prober.CurrentCluster().send_bitrate_bps);
+}
+
 TEST(BitrateProberTest, DoesntProbeWithoutRecentPackets) {
   BitrateProber prober;
   EXPECT_FALSE(prober.IsProbing());
@@ -164,7 +193,8 @@ TEST(BitrateProberTest, ProbeClusterTimeout) {
   prober.OnIncomingPacket(kSmallPacketSize);
   EXPECT_FALSE(prober.IsProbing());
   now_ms += 1;
-  prober.CreateProbeCluster(kBitrateBps / 10, now_ms);
+  // Different enough from the previous cluster not to be coalesced with it.
+  prober.CreateProbeCluster(kBitrateBps * 3 / 20, now_ms);
   prober.OnIncomingPacket(kSmallPacketSize);
   EXPECT_TRUE(prober.IsProbing());
   int bytes_sent = 0;
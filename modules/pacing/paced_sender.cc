@@ -25,13 +25,16 @@
 #include "modules/pacing/round_robin_packet_queue.h"
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/experiments/field_trial_parser.h"
+#include "rtc_base/experiments/field_trial_units.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/trace_event.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/runtime_enabled_features.h"
 
 namespace {
-// Time limit in milliseconds between packet bursts.
+// Default time limit in milliseconds between packet bursts.
 const int64_t kMinPacketLimitMs = 5;
 const int64_t kCongestedPacketIntervalMs = 500;
 const int64_t kPausedProcessIntervalMs = kCongestedPacketIntervalMs;
@@ -48,6 +51,18 @@ namespace webrtc {
 const int64_t PacedSender::kMaxQueueLengthMs = 2000;
 const float PacedSender::kDefaultPaceMultiplier = 2.5f;
 
+PacedSender::BurstConfig::BurstConfig()
+    : process_interval_ms(kMinPacketLimitMs), max_packets(0) {
+  FieldTrialParameter<TimeDelta> interval("interval",
+                                          TimeDelta::ms(kMinPacketLimitMs));
+  FieldTrialParameter<int> packets("packets", 0);
+  ParseFieldTrial({&interval, &packets},
+                  field_trial::FindFullName("WebRTC-Pacer-Burst"));
+  process_interval_ms =
+      std::min(std::max<int64_t>(interval.Get().ms(), 1), kMaxIntervalTimeMs);
+  max_packets = std::max(packets.Get(), 0);
+}
+
 PacedSender::PacedSender(const Clock* clock,
                          PacketSender* packet_sender,
                          RtcEventLog* event_log)
@@ -67,6 +82,9 @@ PacedSender::PacedSender(const Clock* clock,
       send_padding_if_silent_(
           field_trial::IsEnabled("WebRTC-Pacer-PadInSilence")),
       video_blocks_audio_(!field_trial::IsDisabled("WebRTC-Pacer-BlockAudio")),
+      suppress_padding_in_alr_(
+          field_trial::IsEnabled("WebRTC-Pacer-SuppressPaddingInAlr")),
+      burst_config_(),
       paused_(false),
       media_budget_(absl::make_unique<IntervalBudget>(0)),
       padding_budget_(absl::make_unique<IntervalBudget>(0)),
@@ -81,13 +99,17 @@ PacedSender::PacedSender(const Clock* clock,
       first_sent_packet_ms_(-1),
       packets_(std::move(packets)),
       packet_counter_(0),
+      ingress_(field_trial::IsEnabled("WebRTC-Pacer-LockFreeIngress")
+                   ? absl::make_unique<PacerIngressQueue>()
+                   : nullptr),
       pacing_factor_(kDefaultPaceMultiplier),
       queue_time_limit(kMaxQueueLengthMs),
-      account_for_audio_(false) {
+      account_for_audio_(false),
+      num_fast_lane_ssrcs_(0) {
   if (!drain_large_queues_)
     RTC_LOG(LS_WARNING) << "Pacer queues will not be drained,"
                            "pushback experiment must be enabled.";
-  UpdateBudgetWithElapsedTime(kMinPacketLimitMs);
+  UpdateBudgetWithElapsedTime(burst_config_.process_interval_ms);
 }
 
 PacedSender::~PacedSender() {}
@@ -103,6 +125,7 @@ void PacedSender::Pause() {
     if (!paused_)
       RTC_LOG(LS_INFO) << "PacedSender paused.";
     paused_ = true;
+    DrainIngress();
     packets_->SetPauseState(true, clock_->TimeInMilliseconds());
   }
   rtc::CritScope cs(&process_thread_lock_);
@@ -118,6 +141,7 @@ void PacedSender::Resume() {
     if (paused_)
       RTC_LOG(LS_INFO) << "PacedSender resumed.";
     paused_ = false;
+    DrainIngress();
     packets_->SetPauseState(false, clock_->TimeInMilliseconds());
   }
   rtc::CritScope cs(&process_thread_lock_);
@@ -188,9 +212,28 @@ void PacedSender::InsertPacket(RtpPacketSender::Priority priority,
                                int64_t capture_time_ms,
                                size_t bytes,
                                bool retransmission) {
+  if (priority == kHighPriority && num_fast_lane_ssrcs_.load() > 0) {
+    rtc::CritScope cs(&critsect_);
+    if (fast_lane_queued_packets_.count(ssrc) > 0) {
+      InsertFastLanePacket(priority, ssrc, sequence_number, capture_time_ms,
+                           bytes, retransmission);
+      return;
+    }
+  }
+  if (ingress_) {
+    if (capture_time_ms < 0)
+      capture_time_ms = clock_->TimeInMilliseconds();
+    if (ingress_->Push({priority, ssrc, sequence_number, capture_time_ms, bytes,
+                        retransmission})) {
+      return;
+    }
+    // The ring of this stream is full. Queue the packet directly, after the
+    // staged ones so that the order within the stream is kept.
+  }
   rtc::CritScope cs(&critsect_);
   RTC_DCHECK(pacing_bitrate_kbps_ > 0)
       << "SetPacingRate must be called before InsertPacket.";
+  DrainIngress();
 
   int64_t now_ms = clock_->TimeInMilliseconds();
   prober_->OnIncomingPacket(bytes);
@@ -203,13 +246,65 @@ void PacedSender::InsertPacket(RtpPacketSender::Priority priority,
       retransmission, packet_counter_++));
 }
 
+void PacedSender::InsertFastLanePacket(RtpPacketSender::Priority priority,
+                                       uint32_t ssrc,
+                                       uint16_t sequence_number,
+                                       int64_t capture_time_ms,
+                                       size_t bytes,
+                                       bool retransmission) {
+  RTC_DCHECK(pacing_bitrate_kbps_ > 0)
+      << "SetPacingRate must be called before InsertPacket.";
+  // Staged packets may include earlier ones of |ssrc|.
+  DrainIngress();
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  if (capture_time_ms < 0)
+    capture_time_ms = now_ms;
+
+  if (fast_lane_queued_packets_[ssrc] == 0 && !paused_ &&
+      !IsPaced(true, PacedPacketInfo())) {
+    TRACE_EVENT1("webrtc", "PacedSender::InsertFastLanePacket", "ssrc", ssrc);
+    critsect_.Leave();
+    const bool success = packet_sender_->TimeToSendPacket(
+        ssrc, sequence_number, capture_time_ms, retransmission,
+        PacedPacketInfo());
+    critsect_.Enter();
+    if (success) {
+      ++packet_counter_;
+      OnPacketSent(true, bytes);
+      alr_detector_->OnBytesSent(bytes, clock_->TimeInMilliseconds());
+      return;
+    }
+  }
+
+  // The lane may have been torn down while the lock was released.
+  auto it = fast_lane_queued_packets_.find(ssrc);
+  if (it != fast_lane_queued_packets_.end())
+    ++it->second;
+  prober_->OnIncomingPacket(bytes);
+  packets_->Push(PacketQueueInterface::Packet(
+      priority, ssrc, sequence_number, capture_time_ms, now_ms, bytes,
+      retransmission, packet_counter_++));
+}
+
 void PacedSender::SetAccountForAudioPackets(bool account_for_audio) {
   rtc::CritScope cs(&critsect_);
   account_for_audio_ = account_for_audio;
 }
 
+void PacedSender::SetAudioFastLane(uint32_t ssrc, bool enabled) {
+  rtc::CritScope cs(&critsect_);
+  if (enabled) {
+    fast_lane_queued_packets_.emplace(ssrc, 0);
+  } else {
+    fast_lane_queued_packets_.erase(ssrc);
+  }
+  num_fast_lane_ssrcs_.store(
+      static_cast<int>(fast_lane_queued_packets_.size()));
+}
+
 int64_t PacedSender::ExpectedQueueTimeMs() const {
   rtc::CritScope cs(&critsect_);
+  DrainIngress();
   RTC_DCHECK_GT(pacing_bitrate_kbps_, 0);
   return static_cast<int64_t>(packets_->SizeInBytes() * 8 /
                               pacing_bitrate_kbps_);
@@ -223,6 +318,7 @@ absl::optional<int64_t> PacedSender::GetApplicationLimitedRegionStartTime()
 
 size_t PacedSender::QueueSizePackets() const {
   rtc::CritScope cs(&critsect_);
+  DrainIngress();
   return packets_->SizeInPackets();
 }
 
@@ -233,6 +329,7 @@ int64_t PacedSender::FirstSentPacketTimeMs() const {
 
 int64_t PacedSender::QueueInMs() const {
   rtc::CritScope cs(&critsect_);
+  DrainIngress();
 
   int64_t oldest_packet = packets_->OldestEnqueueTimeMs();
   if (oldest_packet == 0)
@@ -256,10 +353,12 @@ int64_t PacedSender::TimeUntilNextProcess() {
     if (ret > 0 || (ret == 0 && !probing_send_failure_))
       return ret;
   }
-  return std::max<int64_t>(kMinPacketLimitMs - elapsed_time_ms, 0);
+  return std::max<int64_t>(
+      burst_config_.process_interval_ms - elapsed_time_ms, 0);
 }
 
 void PacedSender::Process() {
+  TRACE_EVENT0("webrtc", "PacedSender::Process");
   int64_t now_us = clock_->TimeInMicroseconds();
   rtc::CritScope cs(&critsect_);
   int64_t elapsed_time_ms = (now_us - time_last_process_us_ + 500) / 1000;
@@ -287,6 +386,7 @@ void PacedSender::Process() {
   if (paused_)
     return;
 
+  DrainIngress();
   if (elapsed_time_ms > 0) {
     int target_bitrate_kbps = pacing_bitrate_kbps_;
     size_t queue_size_bytes = packets_->SizeInBytes();
@@ -312,6 +412,7 @@ void PacedSender::Process() {
   bool is_probing = prober_->IsProbing();
   PacedPacketInfo pacing_info;
   size_t bytes_sent = 0;
+  size_t packets_sent = 0;
   size_t recommended_probe_size = 0;
   if (is_probing) {
     pacing_info = prober_->CurrentCluster();
@@ -329,8 +430,13 @@ void PacedSender::Process() {
       bytes_sent += packet.bytes;
       // Send succeeded, remove it from the queue.
       packets_->FinalizePop(packet);
+      ++packets_sent;
       if (is_probing && bytes_sent > recommended_probe_size)
         break;
+      // The rest of the budget carries over to the next call. Probes are sent
+      // in full since the prober needs them back to back.
+      if (!is_probing && packets_sent == burst_config_.max_packets)
+        break;
     } else {
       // Send failed, put it back into the queue.
       packets_->CancelPop(packet);
@@ -338,7 +444,13 @@ void PacedSender::Process() {
     }
   }
 
-  if (packets_->Empty() && !Congested()) {
+  // Packets inserted while the lock was released for sending take precedence
+  // over padding.
+  DrainIngress();
+  bool padding_suppressed =
+      !is_probing && suppress_padding_in_alr_ &&
+      alr_detector_->GetApplicationLimitedRegionStartTime().has_value();
+  if (packets_->Empty() && !Congested() && !padding_suppressed) {
     // We can not send padding unless a normal packet has first been sent. If we
     // do, timestamps get messed up.
     if (packet_counter_ > 0) {
@@ -366,15 +478,11 @@ void PacedSender::ProcessThreadAttached(ProcessThread* process_thread) {
 
 bool PacedSender::SendPacket(const PacketQueueInterface::Packet& packet,
                              const PacedPacketInfo& pacing_info) {
+  TRACE_EVENT1("webrtc", "PacedSender::SendPacket", "ssrc", packet.ssrc);
   RTC_DCHECK(!paused_);
   bool audio_packet = packet.priority == kHighPriority;
-  bool apply_pacing =
-      !audio_packet || account_for_audio_ || video_blocks_audio_;
-  if (apply_pacing && (Congested() || (media_budget_->bytes_remaining() == 0 &&
-                                       pacing_info.probe_cluster_id ==
-                                           PacedPacketInfo::kNotAProbe))) {
+  if (IsPaced(audio_packet, pacing_info))
     return false;
-  }
 
   critsect_.Leave();
   const bool success = packet_sender_->TimeToSendPacket(
@@ -383,24 +491,44 @@ bool PacedSender::SendPacket(const PacketQueueInterface::Packet& packet,
   critsect_.Enter();
 
   if (success) {
-    if (first_sent_packet_ms_ == -1)
-      first_sent_packet_ms_ = clock_->TimeInMilliseconds();
-    if (!audio_packet || account_for_audio_) {
-      // Update media bytes sent.
-      // TODO(eladalon): TimeToSendPacket() can also return |true| in some
-      // situations where nothing actually ended up being sent to the network,
-      // and we probably don't want to update the budget in such cases.
-      // https://bugs.chromium.org/p/webrtc/issues/detail?id=8052
-      UpdateBudgetWithBytesSent(packet.bytes);
-      last_send_time_us_ = clock_->TimeInMicroseconds();
+    OnPacketSent(audio_packet, packet.bytes);
+    if (audio_packet && !fast_lane_queued_packets_.empty()) {
+      auto it = fast_lane_queued_packets_.find(packet.ssrc);
+      if (it != fast_lane_queued_packets_.end() && it->second > 0)
+        --it->second;
     }
   }
 
   return success;
 }
 
+bool PacedSender::IsPaced(bool audio_packet,
+                          const PacedPacketInfo& pacing_info) const {
+  bool apply_pacing =
+      !audio_packet || account_for_audio_ || video_blocks_audio_;
+  return apply_pacing &&
+         (Congested() ||
+          (media_budget_->bytes_remaining() == 0 &&
+           pacing_info.probe_cluster_id == PacedPacketInfo::kNotAProbe));
+}
+
+void PacedSender::OnPacketSent(bool audio_packet, size_t bytes) {
+  if (first_sent_packet_ms_ == -1)
+    first_sent_packet_ms_ = clock_->TimeInMilliseconds();
+  if (!audio_packet || account_for_audio_) {
+    // Update media bytes sent.
+    // TODO(eladalon): TimeToSendPacket() can also return |true| in some
+    // situations where nothing actually ended up being sent to the network,
+    // and we probably don't want to update the budget in such cases.
+    // https://bugs.chromium.org/p/webrtc/issues/detail?id=8052
+    UpdateBudgetWithBytesSent(bytes);
+    last_send_time_us_ = clock_->TimeInMicroseconds();
+  }
+}
+
 size_t PacedSender::SendPadding(size_t padding_needed,
                                 const PacedPacketInfo& pacing_info) {
+  TRACE_EVENT1("webrtc", "PacedSender::SendPadding", "bytes", padding_needed);
   RTC_DCHECK_GT(packet_counter_, 0);
   critsect_.Leave();
   size_t bytes_sent =
@@ -414,6 +542,25 @@ size_t PacedSender::SendPadding(size_t padding_needed,
   return bytes_sent;
 }
 
+void PacedSender::DrainIngress() const {
+  if (!ingress_)
+    return;
+  ingress_entries_.clear();
+  ingress_->PopAll(&ingress_entries_);
+  if (ingress_entries_.empty())
+    return;
+  // Staged packets count as enqueued from now, |packets_| requires enqueue
+  // times to be increasing.
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  for (const PacerIngressQueue::Entry& entry : ingress_entries_) {
+    prober_->OnIncomingPacket(entry.bytes);
+    packets_->Push(PacketQueueInterface::Packet(
+        entry.priority, entry.ssrc, entry.sequence_number,
+        entry.capture_time_ms, now_ms, entry.bytes, entry.retransmission,
+        packet_counter_++));
+  }
+}
+
 void PacedSender::UpdateBudgetWithElapsedTime(int64_t delta_time_ms) {
   delta_time_ms = std::min(kMaxIntervalTimeMs, delta_time_ms);
   media_budget_->IncreaseBudget(delta_time_ms);
@@ -439,4 +586,9 @@ void PacedSender::SetQueueTimeLimit(int limit_ms) {
   queue_time_limit = limit_ms;
 }
 
+void PacedSender::SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) {
+  rtc::CritScope cs(&critsect_);
+  packets_->SetStreamAllocation(ssrc, bitrate_bps);
+}
+
 }  // namespace webrtc
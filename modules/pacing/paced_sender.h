@@ -11,10 +11,14 @@
 #ifndef MODULES_PACING_PACED_SENDER_H_
 #define MODULES_PACING_PACED_SENDER_H_
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "modules/pacing/pacer.h"
+#include "modules/pacing/pacer_ingress_queue.h"
 #include "modules/pacing/packet_queue_interface.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/thread_annotations.h"
@@ -100,6 +104,9 @@ class PacedSender : public Pacer {
 
   // Returns true if we send the packet now, else it will add the packet
   // information to the queue and call TimeToSendPacket when it's time to send.
+  // With the WebRTC-Pacer-LockFreeIngress field trial, the packet is staged
+  // without taking the pacer lock and is queued on the next Process() call (or
+  // any other call that needs the queue to be up to date).
   void InsertPacket(RtpPacketSender::Priority priority,
                     uint32_t ssrc,
                     uint16_t sequence_number,
@@ -113,6 +120,12 @@ class PacedSender : public Pacer {
   // at high priority.
   void SetAccountForAudioPackets(bool account_for_audio) override;
 
+  // Packets of |ssrc| on the fast lane are sent from InsertPacket(), on the
+  // calling thread, if nothing would hold them in the queue: no earlier packet
+  // of |ssrc| is queued, the pacer isn't paused and, if audio is paced, there
+  // is budget left. Otherwise they are queued as usual.
+  void SetAudioFastLane(uint32_t ssrc, bool enabled) override;
+
   // Returns the time since the oldest queued packet was enqueued.
   virtual int64_t QueueInMs() const;
 
@@ -142,6 +155,10 @@ class PacedSender : public Pacer {
   void SetPacingFactor(float pacing_factor);
   void SetQueueTimeLimit(int limit_ms);
 
+  // Sets the bitrate allocated to the stream with |ssrc|. Streams of the same
+  // priority are paced out in proportion to their allocations.
+  void SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps);
+
  private:
   // Updates the number of bytes that can be sent for the next time interval.
   void UpdateBudgetWithElapsedTime(int64_t delta_time_in_ms)
@@ -152,12 +169,41 @@ class PacedSender : public Pacer {
   bool SendPacket(const PacketQueueInterface::Packet& packet,
                   const PacedPacketInfo& cluster_info)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  // Tries to send a packet of a fast lane stream right away, and queues it if
+  // that fails.
+  void InsertFastLanePacket(RtpPacketSender::Priority priority,
+                            uint32_t ssrc,
+                            uint16_t sequence_number,
+                            int64_t capture_time_ms,
+                            size_t bytes,
+                            bool retransmission)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  // Whether a packet is held back by congestion or the media budget.
+  bool IsPaced(bool audio_packet, const PacedPacketInfo& pacing_info) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void OnPacketSent(bool audio_packet, size_t bytes)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   size_t SendPadding(size_t padding_needed, const PacedPacketInfo& cluster_info)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
+  // Moves the packets staged by InsertPacket() into |packets_|. This is const
+  // since the queue length getters need to drain first.
+  void DrainIngress() const RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+
   void OnBytesSent(size_t bytes_sent) RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   bool Congested() const RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
+  // Configured with the WebRTC-Pacer-Burst field trial, for example
+  // "WebRTC-Pacer-Burst/interval:1ms,packets:4/". A shorter interval paces
+  // more smoothly at the cost of more wakeups.
+  struct BurstConfig {
+    BurstConfig();
+    // Time between calls to Process(), between 1 ms and 30 ms.
+    int64_t process_interval_ms;
+    // Packets sent per call to Process(), not counting probes. 0 for no limit.
+    size_t max_packets;
+  };
+
   const Clock* const clock_;
   PacketSender* const packet_sender_;
   const std::unique_ptr<AlrDetector> alr_detector_ RTC_PT_GUARDED_BY(critsect_);
@@ -165,6 +211,10 @@ class PacedSender : public Pacer {
   const bool drain_large_queues_;
   const bool send_padding_if_silent_;
   const bool video_blocks_audio_;
+  // No padding is sent in the application limited region, the estimate is
+  // kept up by probes instead.
+  const bool suppress_padding_in_alr_;
+  const BurstConfig burst_config_;
   rtc::CriticalSection critsect_;
   bool paused_ RTC_GUARDED_BY(critsect_);
   // This is the media budget, keeping track of how many bits of media
@@ -192,7 +242,13 @@ class PacedSender : public Pacer {
 
   const std::unique_ptr<PacketQueueInterface> packets_
       RTC_PT_GUARDED_BY(critsect_);
-  uint64_t packet_counter_ RTC_GUARDED_BY(critsect_);
+  mutable uint64_t packet_counter_ RTC_GUARDED_BY(critsect_);
+
+  // Null unless the WebRTC-Pacer-LockFreeIngress field trial is enabled.
+  // Pushed to from any thread, drained with |critsect_| held.
+  const std::unique_ptr<PacerIngressQueue> ingress_;
+  mutable std::vector<PacerIngressQueue::Entry> ingress_entries_
+      RTC_GUARDED_BY(critsect_);
 
   int64_t congestion_window_bytes_ RTC_GUARDED_BY(critsect_) =
       kNoCongestionWindow;
@@ -208,6 +264,14 @@ class PacedSender : public Pacer {
 
   int64_t queue_time_limit RTC_GUARDED_BY(critsect_);
   bool account_for_audio_ RTC_GUARDED_BY(critsect_);
+
+  // Map from the SSRCs on the fast lane to their number of queued packets,
+  // which the packets that follow must not overtake. The size is mirrored in
+  // |num_fast_lane_ssrcs_|, so that InsertPacket() only takes the lock for the
+  // lane when one is set up.
+  std::map<uint32_t, size_t> fast_lane_queued_packets_
+      RTC_GUARDED_BY(critsect_);
+  std::atomic<int> num_fast_lane_ssrcs_;
 };
 }  // namespace webrtc
 #endif  // MODULES_PACING_PACED_SENDER_H_
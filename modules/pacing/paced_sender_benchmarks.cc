@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "benchmark/benchmark.h"
+#include "modules/pacing/paced_sender.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+
+const uint32_t kSsrc = 12345;
+const size_t kPacketSize = 1200;
+// High enough for all packets of a burst to be sent within a few intervals.
+const uint32_t kPacingRateBps = 500000000;
+
+class CountingPacketSender : public PacedSender::PacketSender {
+ public:
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission,
+                        const PacedPacketInfo& pacing_info) override {
+    ++packets_sent_;
+    return true;
+  }
+  size_t TimeToSendPadding(size_t bytes,
+                           const PacedPacketInfo& pacing_info) override {
+    return 0;
+  }
+
+  int64_t packets_sent() const { return packets_sent_; }
+
+ private:
+  int64_t packets_sent_ = 0;
+};
+
+// Inserts a burst of range(0) packets, like a video frame, and runs
+// Process() until the queue is drained.
+void BM_PacedSenderProcess(benchmark::State& state) {
+  SimulatedClock clock(123456);
+  CountingPacketSender packet_sender;
+  PacedSender pacer(&clock, &packet_sender, nullptr);
+  pacer.SetPacingRates(kPacingRateBps, 0);
+  uint16_t sequence_number = 0;
+
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      pacer.InsertPacket(PacedSender::kNormalPriority, kSsrc,
+                         sequence_number++, clock.TimeInMilliseconds(),
+                         kPacketSize, false);
+    }
+    while (pacer.QueueSizePackets() > 0) {
+      clock.AdvanceTimeMilliseconds(pacer.TimeUntilNextProcess());
+      pacer.Process();
+    }
+  }
+  state.SetItemsProcessed(packet_sender.packets_sent());
+}
+BENCHMARK(BM_PacedSenderProcess)->Arg(1)->Arg(10)->Arg(100);
+
+}  // namespace
+}  // namespace webrtc
@@ -162,6 +162,27 @@ class PacedSenderFieldTrialTest : public testing::Test {
     clock_.AdvanceTimeMilliseconds(5);
     pacer->Process();
   }
+  // Sends one video packet and then runs the pacer for a second without media,
+  // returns the number of padding requests made in the application limited
+  // region.
+  int PaddingRequestsInAlr(PacedSender* pacer) {
+    pacer->SetEstimatedBitrate(kTargetBitrateBps);
+    pacer->SetSendBitrateLimits(0, kTargetBitrateBps / 10);
+    InsertPacket(pacer, &video);
+    EXPECT_CALL(callback_, TimeToSendPacket).WillOnce(Return(true));
+    int requests_in_alr = 0;
+    EXPECT_CALL(callback_, TimeToSendPadding)
+        .WillRepeatedly(testing::Invoke(
+            [&](size_t bytes, const PacedPacketInfo&) {
+              if (pacer->GetApplicationLimitedRegionStartTime())
+                ++requests_in_alr;
+              return bytes;
+            }));
+    for (int i = 0; i < kProcessIntervalsPerSecond; ++i)
+      ProcessNext(pacer);
+    EXPECT_TRUE(pacer->GetApplicationLimitedRegionStartTime());
+    return requests_in_alr;
+  }
   MediaStream audio{/*priority*/ PacedSender::kHighPriority,
                     /*ssrc*/ 3333, /*packet_size*/ 100, /*seq_num*/ 1000};
   MediaStream video{/*priority*/ PacedSender::kNormalPriority,
@@ -199,6 +220,17 @@ TEST_F(PacedSenderFieldTrialTest, PaddingInSilenceWithTrial) {
   pacer.Process();
 }
 
+TEST_F(PacedSenderFieldTrialTest, DefaultPaddingInAlr) {
+  PacedSender pacer(&clock_, &callback_, nullptr);
+  EXPECT_GT(PaddingRequestsInAlr(&pacer), 0);
+}
+
+TEST_F(PacedSenderFieldTrialTest, NoPaddingInAlrWithTrial) {
+  ScopedFieldTrials trial("WebRTC-Pacer-SuppressPaddingInAlr/Enabled/");
+  PacedSender pacer(&clock_, &callback_, nullptr);
+  EXPECT_EQ(0, PaddingRequestsInAlr(&pacer));
+}
+
 TEST_F(PacedSenderFieldTrialTest, DefaultCongestionWindowAffectsAudio) {
   EXPECT_CALL(callback_, TimeToSendPadding).Times(0);
   PacedSender pacer(&clock_, &callback_, nullptr);
@@ -274,6 +306,52 @@ TEST_F(PacedSenderFieldTrialTest, BudgetDoesNotAffectAudioInTrial) {
   ProcessNext(&pacer);
 }
 
+TEST_F(PacedSenderFieldTrialTest, LockFreeIngressKeepsStreamOrder) {
+  ScopedFieldTrials trial("WebRTC-Pacer-LockFreeIngress/Enabled/");
+  EXPECT_CALL(callback_, TimeToSendPadding).Times(0);
+  PacedSender pacer(&clock_, &callback_, nullptr);
+  pacer.SetPacingRates(10000000, 0);
+  // More packets than fit in the ingress ring of a stream, so that the last
+  // ones are queued through the locked path.
+  const size_t kNumPackets = PacerIngressQueue::kStreamCapacity + 10;
+  const uint16_t first_seq_num = video.seq_num;
+  for (size_t i = 0; i < kNumPackets; ++i)
+    InsertPacket(&pacer, &video);
+  InsertPacket(&pacer, &audio);
+  EXPECT_EQ(kNumPackets + 1, pacer.QueueSizePackets());
+
+  // Audio has higher priority, video follows in insertion order.
+  testing::InSequence in_sequence;
+  EXPECT_CALL(callback_, TimeToSendPacket(audio.ssrc, _, _, false, _))
+      .WillOnce(Return(true));
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_CALL(callback_,
+                TimeToSendPacket(video.ssrc, first_seq_num + i, _, false, _))
+        .WillOnce(Return(true));
+  }
+  while (pacer.QueueSizePackets() > 0)
+    ProcessNext(&pacer);
+}
+
+TEST_F(PacedSenderFieldTrialTest, BurstTrialSetsIntervalAndPacketsPerProcess) {
+  ScopedFieldTrials trial("WebRTC-Pacer-Burst/interval:1ms,packets:2/");
+  EXPECT_CALL(callback_, TimeToSendPadding).Times(0);
+  PacedSender pacer(&clock_, &callback_, nullptr);
+  // Budget for all packets on every process call.
+  pacer.SetPacingRates(100000000, 0);
+  for (int i = 0; i < 5; ++i)
+    InsertPacket(&pacer, &video);
+  EXPECT_EQ(1, pacer.TimeUntilNextProcess());
+
+  EXPECT_CALL(callback_, TimeToSendPacket)
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  clock_.AdvanceTimeMilliseconds(1);
+  pacer.Process();
+  EXPECT_EQ(3u, pacer.QueueSizePackets());
+  EXPECT_EQ(1, pacer.TimeUntilNextProcess());
+}
+
 TEST_F(PacedSenderTest, FirstSentPacketTimeIsSet) {
   uint16_t sequence_number = 1234;
   const uint32_t kSsrc = 12345;
@@ -645,6 +723,68 @@ TEST_F(PacedSenderTest, RetransmissionPriority) {
   EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
 }
 
+TEST_F(PacedSenderTest, RetransmissionGoesBeforeKeyFrameOfOtherStream) {
+  const uint32_t kKeyFrameSsrc = 12345;
+  const uint32_t kRetransmissionSsrc = 12346;
+  uint16_t sequence_number = 1234;
+  int64_t capture_time_ms = clock_.TimeInMilliseconds();
+  send_bucket_->Process();
+
+  for (int i = 0; i < 10; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, kKeyFrameSsrc,
+                               sequence_number++, capture_time_ms, 1000, false);
+  }
+  send_bucket_->InsertPacket(PacedSender::kNormalPriority, kRetransmissionSsrc,
+                             sequence_number, capture_time_ms, 250, true);
+
+  ::testing::InSequence in_sequence;
+  EXPECT_CALL(callback_, TimeToSendPacket(kRetransmissionSsrc, sequence_number,
+                                          _, true, _))
+      .WillOnce(Return(true));
+  EXPECT_CALL(callback_, TimeToSendPacket(kKeyFrameSsrc, _, _, false, _))
+      .WillRepeatedly(Return(true));
+  clock_.AdvanceTimeMilliseconds(5);
+  send_bucket_->Process();
+}
+
+TEST_F(PacedSenderTest, SharesLinkInProportionToStreamAllocations) {
+  const uint32_t kFirstSsrc = 12345;
+  const uint32_t kSecondSsrc = 12346;
+  const size_t kPacketSize = 1000;
+  const int kPacketsToSend = 40;
+  uint16_t sequence_number = 1234;
+  int64_t capture_time_ms = clock_.TimeInMilliseconds();
+  send_bucket_->Process();
+
+  send_bucket_->SetStreamAllocation(kFirstSsrc, 300000);
+  send_bucket_->SetStreamAllocation(kSecondSsrc, 100000);
+  for (int i = 0; i < kPacketsToSend; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, kFirstSsrc,
+                               sequence_number++, capture_time_ms, kPacketSize,
+                               false);
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, kSecondSsrc,
+                               sequence_number++, capture_time_ms, kPacketSize,
+                               false);
+  }
+
+  int first_sent = 0;
+  int second_sent = 0;
+  EXPECT_CALL(callback_, TimeToSendPacket(_, _, _, _, _))
+      .WillRepeatedly(::testing::Invoke(
+          [&](uint32_t ssrc, uint16_t, int64_t, bool, const PacedPacketInfo&) {
+            ++(ssrc == kFirstSsrc ? first_sent : second_sent);
+            return true;
+          }));
+  while (first_sent + second_sent < kPacketsToSend) {
+    clock_.AdvanceTimeMilliseconds(5);
+    send_bucket_->Process();
+  }
+
+  // The first stream is allocated three times the bitrate of the second.
+  EXPECT_NEAR(3 * kPacketsToSend / 4, first_sent, 2);
+  EXPECT_NEAR(kPacketsToSend / 4, second_sent, 2);
+}
+
 TEST_F(PacedSenderTest, HighPrioDoesntAffectBudget) {
   uint32_t ssrc = 12346;
   uint16_t sequence_number = 1234;
@@ -683,6 +823,62 @@ TEST_F(PacedSenderTest, HighPrioDoesntAffectBudget) {
   EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
 }
 
+TEST_F(PacedSenderTest, FastLaneSendsAudioFromInsertPacket) {
+  const uint32_t kAudioSsrc = 12345;
+  const uint32_t kVideoSsrc = 23456;
+  send_bucket_->SetAudioFastLane(kAudioSsrc, true);
+  // Leaves budget for the next interval.
+  send_bucket_->Process();
+  // The video waits in the queue for the next Process().
+  for (uint16_t i = 0; i < 10; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, kVideoSsrc, i,
+                               clock_.TimeInMilliseconds(), 1000, false);
+  }
+  EXPECT_CALL(callback_, TimeToSendPacket(kVideoSsrc, _, _, _, _)).Times(0);
+  EXPECT_CALL(callback_, TimeToSendPacket(kAudioSsrc, 100, _, false, _))
+      .WillOnce(Return(true));
+  send_bucket_->InsertPacket(PacedSender::kHighPriority, kAudioSsrc, 100,
+                             clock_.TimeInMilliseconds(), 100, false);
+  testing::Mock::VerifyAndClearExpectations(&callback_);
+  EXPECT_EQ(10u, send_bucket_->QueueSizePackets());
+
+  // Other streams are queued as usual.
+  send_bucket_->SetAudioFastLane(kAudioSsrc, false);
+  send_bucket_->InsertPacket(PacedSender::kHighPriority, kAudioSsrc, 101,
+                             clock_.TimeInMilliseconds(), 100, false);
+  EXPECT_EQ(11u, send_bucket_->QueueSizePackets());
+}
+
+TEST_F(PacedSenderTest, FastLaneKeepsOrderOfQueuedAudio) {
+  const uint32_t kAudioSsrc = 12345;
+  send_bucket_->SetAccountForAudioPackets(true);
+  send_bucket_->SetAudioFastLane(kAudioSsrc, true);
+  // Without budget, paced audio is queued, and so is the packet after it.
+  EXPECT_CALL(callback_, TimeToSendPacket(_, _, _, _, _)).Times(0);
+  send_bucket_->InsertPacket(PacedSender::kHighPriority, kAudioSsrc, 1,
+                             clock_.TimeInMilliseconds(), 250, false);
+  send_bucket_->InsertPacket(PacedSender::kHighPriority, kAudioSsrc, 2,
+                             clock_.TimeInMilliseconds(), 250, false);
+  testing::Mock::VerifyAndClearExpectations(&callback_);
+  EXPECT_EQ(2u, send_bucket_->QueueSizePackets());
+
+  {
+    testing::InSequence in_sequence;
+    for (uint16_t sequence_number = 1; sequence_number <= 3;
+         ++sequence_number) {
+      EXPECT_CALL(callback_,
+                  TimeToSendPacket(kAudioSsrc, sequence_number, _, _, _))
+          .WillOnce(Return(true));
+    }
+  }
+  send_bucket_->Process();
+  EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
+  // With the queue empty and budget left, the lane sends right away again.
+  send_bucket_->InsertPacket(PacedSender::kHighPriority, kAudioSsrc, 3,
+                             clock_.TimeInMilliseconds(), 250, false);
+  EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
+}
+
 TEST_F(PacedSenderTest, SendsOnlyPaddingWhenCongested) {
   uint32_t ssrc = 202020;
   uint16_t sequence_number = 1000;
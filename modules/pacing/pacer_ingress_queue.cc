@@ -0,0 +1,125 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/pacer_ingress_queue.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+static_assert((PacerIngressQueue::kMaxStreams &
+               (PacerIngressQueue::kMaxStreams - 1)) == 0,
+              "kMaxStreams must be a power of two");
+static_assert((PacerIngressQueue::kStreamCapacity &
+               (PacerIngressQueue::kStreamCapacity - 1)) == 0,
+              "kStreamCapacity must be a power of two");
+
+size_t StreamIndex(uint32_t ssrc) {
+  // Fibonacci hashing, SSRCs of one sender are often close to each other.
+  return (ssrc * 2654435769u) >> 28;
+}
+static_assert(PacerIngressQueue::kMaxStreams == 16,
+              "StreamIndex() needs to be updated");
+}  // namespace
+
+constexpr size_t PacerIngressQueue::kMaxStreams;
+constexpr size_t PacerIngressQueue::kStreamCapacity;
+
+PacerIngressQueue::PacerIngressQueue() : streams_(new Stream[kMaxStreams]) {
+  for (size_t i = 0; i < kMaxStreams; ++i) {
+    Stream& stream = streams_[i];
+    stream.key.store(0, std::memory_order_relaxed);
+    stream.push_pos.store(0, std::memory_order_relaxed);
+    stream.pop_pos = 0;
+    for (size_t j = 0; j < kStreamCapacity; ++j)
+      stream.cells[j].sequence.store(j, std::memory_order_relaxed);
+  }
+}
+
+PacerIngressQueue::~PacerIngressQueue() = default;
+
+bool PacerIngressQueue::Push(const Entry& entry) {
+  Stream* stream = FindOrAddStream(entry.ssrc);
+  if (!stream)
+    return false;
+
+  size_t pos = stream->push_pos.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &stream->cells[pos & (kStreamCapacity - 1)];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (stream->push_pos.compare_exchange_weak(pos, pos + 1,
+                                                 std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The consumer has not freed this cell yet, the ring is full.
+      return false;
+    } else {
+      pos = stream->push_pos.load(std::memory_order_relaxed);
+    }
+  }
+  cell->entry = entry;
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+void PacerIngressQueue::PopAll(std::vector<Entry>* entries) {
+  for (size_t i = 0; i < kMaxStreams; ++i) {
+    Stream& stream = streams_[i];
+    if (stream.key.load(std::memory_order_acquire) == 0)
+      continue;
+    while (true) {
+      Cell* cell = &stream.cells[stream.pop_pos & (kStreamCapacity - 1)];
+      if (cell->sequence.load(std::memory_order_acquire) !=
+          stream.pop_pos + 1) {
+        break;
+      }
+      entries->push_back(cell->entry);
+      cell->sequence.store(stream.pop_pos + kStreamCapacity,
+                           std::memory_order_release);
+      ++stream.pop_pos;
+    }
+  }
+}
+
+bool PacerIngressQueue::Empty() const {
+  for (size_t i = 0; i < kMaxStreams; ++i) {
+    const Stream& stream = streams_[i];
+    if (stream.key.load(std::memory_order_acquire) == 0)
+      continue;
+    if (stream.push_pos.load(std::memory_order_acquire) != stream.pop_pos)
+      return false;
+  }
+  return true;
+}
+
+PacerIngressQueue::Stream* PacerIngressQueue::FindOrAddStream(uint32_t ssrc) {
+  const uint64_t key = static_cast<uint64_t>(ssrc) + 1;
+  size_t index = StreamIndex(ssrc);
+  for (size_t probe = 0; probe < kMaxStreams; ++probe) {
+    Stream& stream = streams_[(index + probe) & (kMaxStreams - 1)];
+    uint64_t current = stream.key.load(std::memory_order_acquire);
+    if (current == 0 &&
+        stream.key.compare_exchange_strong(current, key,
+                                           std::memory_order_acq_rel)) {
+      return &stream;
+    }
+    // Either the slot was taken already, or another thread just claimed it,
+    // possibly for the same SSRC.
+    if (current == key)
+      return &stream;
+  }
+  return nullptr;
+}
+
+}  // namespace webrtc
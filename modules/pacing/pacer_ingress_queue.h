@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_PACING_PACER_INGRESS_QUEUE_H_
+#define MODULES_PACING_PACER_INGRESS_QUEUE_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Staging area for packets inserted into the PacedSender, so that encoder and
+// network threads never wait for the pacer lock. Every SSRC gets a bounded
+// ring that any number of threads can push to without locking. The pacer
+// thread is the only consumer and moves the staged packets into its packet
+// queue, where they are prioritized and paced as usual.
+class PacerIngressQueue {
+ public:
+  struct Entry {
+    RtpPacketSender::Priority priority;
+    uint32_t ssrc;
+    uint16_t sequence_number;
+    int64_t capture_time_ms;
+    size_t bytes;
+    bool retransmission;
+  };
+
+  static constexpr size_t kMaxStreams = 16;
+  static constexpr size_t kStreamCapacity = 128;
+
+  PacerIngressQueue();
+  ~PacerIngressQueue();
+
+  // Stages |entry| in the ring of its SSRC. Returns false if the ring is full,
+  // or if there are already kMaxStreams other SSRCs. The caller must then
+  // insert the packet some other way, after draining this queue.
+  bool Push(const Entry& entry);
+
+  // Appends all staged entries to |entries|, stream by stream and in push
+  // order within each stream. Only one thread may call this at a time.
+  void PopAll(std::vector<Entry>* entries);
+
+  // Returns true if no entries are staged. Entries pushed concurrently may or
+  // may not be seen. Must be called on the consumer thread.
+  bool Empty() const;
+
+ private:
+  // Bounded multi-producer, single-consumer ring. Every cell has a sequence
+  // number telling whether it is free for the producer claiming position
+  // |pos| (sequence == pos) or holds the entry for position |pos|
+  // (sequence == pos + 1).
+  struct Cell {
+    std::atomic<size_t> sequence;
+    Entry entry;
+  };
+
+  struct Stream {
+    // The SSRC plus one, or zero if the stream is unused. Streams are claimed
+    // once and never released.
+    std::atomic<uint64_t> key;
+    std::atomic<size_t> push_pos;
+    // Only accessed by the consumer.
+    size_t pop_pos;
+    Cell cells[kStreamCapacity];
+  };
+
+  Stream* FindOrAddStream(uint32_t ssrc);
+
+  const std::unique_ptr<Stream[]> streams_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PacerIngressQueue);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_PACING_PACER_INGRESS_QUEUE_H_
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/pacer_ingress_queue.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/platform_thread.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+PacerIngressQueue::Entry MakeEntry(uint32_t ssrc, uint16_t sequence_number) {
+  return {RtpPacketSender::kNormalPriority, ssrc, sequence_number, 0, 1000,
+          false};
+}
+
+constexpr int kThreads = 4;
+constexpr uint16_t kPacketsPerThread = 1000;
+
+struct ProducerContext {
+  PacerIngressQueue* queue;
+  uint32_t ssrc;
+};
+
+void Produce(void* context) {
+  ProducerContext* ctx = static_cast<ProducerContext*>(context);
+  for (uint16_t seq = 0; seq < kPacketsPerThread;) {
+    if (ctx->queue->Push(MakeEntry(ctx->ssrc, seq)))
+      ++seq;
+    else
+      SleepMs(1);
+  }
+}
+}  // namespace
+
+TEST(PacerIngressQueueTest, StartsEmpty) {
+  PacerIngressQueue queue;
+  EXPECT_TRUE(queue.Empty());
+  std::vector<PacerIngressQueue::Entry> entries;
+  queue.PopAll(&entries);
+  EXPECT_TRUE(entries.empty());
+}
+
+TEST(PacerIngressQueueTest, KeepsOrderWithinStream) {
+  PacerIngressQueue queue;
+  for (uint16_t seq = 0; seq < 10; ++seq) {
+    EXPECT_TRUE(queue.Push(MakeEntry(1111, seq)));
+    EXPECT_TRUE(queue.Push(MakeEntry(2222, seq + 100)));
+  }
+  EXPECT_FALSE(queue.Empty());
+
+  std::vector<PacerIngressQueue::Entry> entries;
+  queue.PopAll(&entries);
+  ASSERT_EQ(20u, entries.size());
+  EXPECT_TRUE(queue.Empty());
+  std::map<uint32_t, std::vector<uint16_t>> by_ssrc;
+  for (const auto& entry : entries)
+    by_ssrc[entry.ssrc].push_back(entry.sequence_number);
+  ASSERT_EQ(10u, by_ssrc[1111].size());
+  ASSERT_EQ(10u, by_ssrc[2222].size());
+  for (uint16_t seq = 0; seq < 10; ++seq) {
+    EXPECT_EQ(seq, by_ssrc[1111][seq]);
+    EXPECT_EQ(seq + 100, by_ssrc[2222][seq]);
+  }
+}
+
+TEST(PacerIngressQueueTest, RejectsWhenStreamIsFull) {
+  PacerIngressQueue queue;
+  for (size_t i = 0; i < PacerIngressQueue::kStreamCapacity; ++i)
+    EXPECT_TRUE(queue.Push(MakeEntry(1111, i)));
+  EXPECT_FALSE(queue.Push(MakeEntry(1111, 0)));
+  // Other streams are not affected.
+  EXPECT_TRUE(queue.Push(MakeEntry(2222, 0)));
+
+  std::vector<PacerIngressQueue::Entry> entries;
+  queue.PopAll(&entries);
+  EXPECT_EQ(PacerIngressQueue::kStreamCapacity + 1, entries.size());
+  EXPECT_TRUE(queue.Push(MakeEntry(1111, 0)));
+}
+
+TEST(PacerIngressQueueTest, RejectsTooManyStreams) {
+  PacerIngressQueue queue;
+  for (uint32_t ssrc = 1; ssrc <= PacerIngressQueue::kMaxStreams; ++ssrc)
+    EXPECT_TRUE(queue.Push(MakeEntry(ssrc, 0)));
+  EXPECT_FALSE(queue.Push(MakeEntry(PacerIngressQueue::kMaxStreams + 1, 0)));
+  // Known streams can still be pushed to.
+  EXPECT_TRUE(queue.Push(MakeEntry(1, 1)));
+}
+
+TEST(PacerIngressQueueTest, ConcurrentProducers) {
+  PacerIngressQueue queue;
+  // Two threads per SSRC, so that producers also race within a stream.
+  ProducerContext contexts[kThreads];
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    contexts[i] = {&queue, static_cast<uint32_t>(1000 + i / 2)};
+    threads.emplace_back(
+        new rtc::PlatformThread(&Produce, &contexts[i], "Producer"));
+    threads.back()->Start();
+  }
+
+  std::map<uint32_t, std::vector<int>> counts;
+  std::vector<PacerIngressQueue::Entry> entries;
+  size_t received = 0;
+  while (received < kThreads * kPacketsPerThread) {
+    entries.clear();
+    queue.PopAll(&entries);
+    for (const auto& entry : entries) {
+      std::vector<int>& seen = counts[entry.ssrc];
+      seen.resize(kPacketsPerThread);
+      ++seen[entry.sequence_number];
+    }
+    received += entries.size();
+    if (entries.empty())
+      SleepMs(1);
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+
+  EXPECT_TRUE(queue.Empty());
+  ASSERT_EQ(2u, counts.size());
+  for (const auto& stream : counts) {
+    for (int count : stream.second)
+      EXPECT_EQ(2, count);
+  }
+}
+
+}  // namespace webrtc
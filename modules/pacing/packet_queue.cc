@@ -125,4 +125,8 @@ int64_t PacketQueue::AverageQueueTimeMs() const {
   return queue_time_sum_ / packet_list_.size();
 }
 
+void PacketQueue::SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) {
+  // Packets are sent in priority order regardless of their stream.
+}
+
 }  // namespace webrtc
@@ -39,6 +39,7 @@ class PacketQueue : public PacketQueueInterface {
   void UpdateQueueTime(int64_t timestamp_ms) override;
   void SetPauseState(bool paused, int64_t timestamp_ms) override;
   int64_t AverageQueueTimeMs() const override;
+  void SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) override;
 
  private:
   // Try to add a packet to the set of ssrc/seqno identifiers currently in the
@@ -63,6 +63,9 @@ class PacketQueueInterface {
   virtual void UpdateQueueTime(int64_t timestamp_ms) = 0;
   virtual void SetPauseState(bool paused, int64_t timestamp_ms) = 0;
   virtual int64_t AverageQueueTimeMs() const = 0;
+  // Sets the bitrate allocated to the stream with |ssrc|, 0 if it has none.
+  // Queues that share the link between streams may use it as their weight.
+  virtual void SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) = 0;
 };
 }  // namespace webrtc
 
@@ -17,7 +17,7 @@
 
 namespace webrtc {
 
-RoundRobinPacketQueue::Stream::Stream() : bytes(0) {}
+RoundRobinPacketQueue::Stream::Stream() : bytes(0), allocation_bps(0) {}
 RoundRobinPacketQueue::Stream::Stream(const Stream& stream) = default;
 RoundRobinPacketQueue::Stream::~Stream() {}
 
@@ -29,29 +29,21 @@ RoundRobinPacketQueue::~RoundRobinPacketQueue() {}
 void RoundRobinPacketQueue::Push(const Packet& packet_to_insert) {
   Packet packet(packet_to_insert);
 
-  auto stream_info_it = streams_.find(packet.ssrc);
-  if (stream_info_it == streams_.end()) {
-    stream_info_it = streams_.emplace(packet.ssrc, Stream()).first;
-    stream_info_it->second.priority_it = stream_priorities_.end();
-    stream_info_it->second.ssrc = packet.ssrc;
-  }
+  Stream* stream = GetOrCreateStream(packet.ssrc);
+  StreamPrioKey key(packet.priority, packet.retransmission, stream->bytes);
 
-  Stream* streams_ = &stream_info_it->second;
-
-  if (streams_->priority_it == stream_priorities_.end()) {
+  if (stream->priority_it == stream_priorities_.end()) {
     // If the SSRC is not currently scheduled, add it to |stream_priorities_|.
-    RTC_CHECK(!IsSsrcScheduled(streams_->ssrc));
-    streams_->priority_it = stream_priorities_.emplace(
-        StreamPrioKey(packet.priority, streams_->bytes), packet.ssrc);
-  } else if (packet.priority < streams_->priority_it->first.priority) {
+    RTC_CHECK(!IsSsrcScheduled(stream->ssrc));
+    stream->priority_it = stream_priorities_.emplace(key, packet.ssrc);
+  } else if (key < stream->priority_it->first) {
     // If the priority of this SSRC increased, remove the outdated StreamPrioKey
     // and insert a new one with the new priority. Note that
     // RtpPacketSender::Priority uses lower ordinal for higher priority.
-    stream_priorities_.erase(streams_->priority_it);
-    streams_->priority_it = stream_priorities_.emplace(
-        StreamPrioKey(packet.priority, streams_->bytes), packet.ssrc);
+    stream_priorities_.erase(stream->priority_it);
+    stream->priority_it = stream_priorities_.emplace(key, packet.ssrc);
   }
-  RTC_CHECK(streams_->priority_it != stream_priorities_.end());
+  RTC_CHECK(stream->priority_it != stream_priorities_.end());
 
   packet.enqueue_time_it = enqueue_times_.insert(packet.enqueue_time_ms);
 
@@ -63,7 +55,7 @@ void RoundRobinPacketQueue::Push(const Packet& packet_to_insert) {
   // in a paused state.
   UpdateQueueTime(packet.enqueue_time_ms);
   packet.enqueue_time_ms -= pause_time_sum_ms_;
-  streams_->packet_queue.push(packet);
+  stream->packet_queue.push(packet);
 
   size_packets_ += 1;
   size_bytes_ += packet.bytes;
@@ -112,8 +104,11 @@ void RoundRobinPacketQueue::FinalizePop(const Packet& packet) {
     // case a "budget" will be built up for the stream sending at the lower
     // rate. To avoid building a too large budget we limit |bytes| to be within
     // kMaxLeading bytes of the stream that has sent the most amount of bytes.
+    // The bytes are scaled by the weight of the stream, so that streams with a
+    // larger allocation get a larger share.
     stream->bytes =
-        std::max(stream->bytes + packet.bytes, max_bytes_ - kMaxLeadingBytes);
+        std::max(stream->bytes + WeightedBytes(*stream, packet.bytes),
+                 max_bytes_ - kMaxLeadingBytes);
     max_bytes_ = std::max(max_bytes_, stream->bytes);
 
     size_bytes_ -= packet.bytes;
@@ -125,9 +120,10 @@ void RoundRobinPacketQueue::FinalizePop(const Packet& packet) {
     if (stream->packet_queue.empty()) {
       stream->priority_it = stream_priorities_.end();
     } else {
-      RtpPacketSender::Priority priority = stream->packet_queue.top().priority;
+      const Packet& next = stream->packet_queue.top();
       stream->priority_it = stream_priorities_.emplace(
-          StreamPrioKey(priority, stream->bytes), stream->ssrc);
+          StreamPrioKey(next.priority, next.retransmission, stream->bytes),
+          stream->ssrc);
     }
 
     pop_packet_.reset();
@@ -179,12 +175,33 @@ void RoundRobinPacketQueue::SetPauseState(bool paused, int64_t timestamp_ms) {
   paused_ = paused;
 }
 
+void RoundRobinPacketQueue::SetStreamAllocation(uint32_t ssrc,
+                                                uint32_t bitrate_bps) {
+  GetOrCreateStream(ssrc)->allocation_bps = bitrate_bps;
+  max_allocation_bps_ = 0;
+  for (const auto& stream : streams_) {
+    max_allocation_bps_ =
+        std::max(max_allocation_bps_, stream.second.allocation_bps);
+  }
+}
+
 int64_t RoundRobinPacketQueue::AverageQueueTimeMs() const {
   if (Empty())
     return 0;
   return queue_time_sum_ms_ / size_packets_;
 }
 
+RoundRobinPacketQueue::Stream* RoundRobinPacketQueue::GetOrCreateStream(
+    uint32_t ssrc) {
+  auto stream_info_it = streams_.find(ssrc);
+  if (stream_info_it == streams_.end()) {
+    stream_info_it = streams_.emplace(ssrc, Stream()).first;
+    stream_info_it->second.priority_it = stream_priorities_.end();
+    stream_info_it->second.ssrc = ssrc;
+  }
+  return &stream_info_it->second;
+}
+
 RoundRobinPacketQueue::Stream*
 RoundRobinPacketQueue::GetHighestPriorityStream() {
   RTC_CHECK(!stream_priorities_.empty());
@@ -197,6 +214,16 @@ RoundRobinPacketQueue::GetHighestPriorityStream() {
   return &stream_info_it->second;
 }
 
+size_t RoundRobinPacketQueue::WeightedBytes(const Stream& stream,
+                                            size_t bytes) const {
+  if (max_allocation_bps_ == 0 || stream.allocation_bps == 0)
+    return bytes;
+  uint32_t weight_bps = std::max(stream.allocation_bps,
+                                 max_allocation_bps_ / kMaxWeightRatio);
+  return static_cast<size_t>(static_cast<uint64_t>(bytes) *
+                             max_allocation_bps_ / weight_bps);
+}
+
 bool RoundRobinPacketQueue::IsSsrcScheduled(uint32_t ssrc) const {
   for (const auto& scheduled_stream : stream_priorities_) {
     if (scheduled_stream.second == ssrc)
@@ -40,20 +40,33 @@ class RoundRobinPacketQueue : public PacketQueueInterface {
   int64_t AverageQueueTimeMs() const override;
   void UpdateQueueTime(int64_t timestamp_ms) override;
   void SetPauseState(bool paused, int64_t timestamp_ms) override;
+  // Streams of the same priority share the link in proportion to their
+  // allocations, as in weighted deficit round robin. Streams without an
+  // allocation get the weight of the largest one, and no stream gets less than
+  // 1/kMaxWeightRatio of it.
+  void SetStreamAllocation(uint32_t ssrc, uint32_t bitrate_bps) override;
 
  private:
   struct StreamPrioKey {
     StreamPrioKey() = default;
-    StreamPrioKey(RtpPacketSender::Priority priority, int64_t bytes)
-        : priority(priority), bytes(bytes) {}
+    StreamPrioKey(RtpPacketSender::Priority priority,
+                  bool retransmission,
+                  int64_t bytes)
+        : priority(priority), retransmission(retransmission), bytes(bytes) {}
 
     bool operator<(const StreamPrioKey& other) const {
       if (priority != other.priority)
         return priority < other.priority;
+      if (retransmission != other.retransmission)
+        return retransmission;
       return bytes < other.bytes;
     }
 
     const RtpPacketSender::Priority priority;
+    // Streams with a retransmission at the head of their queue go before
+    // streams of the same priority that only have new packets, so that a NACKed
+    // packet does not wait behind another stream's key frame.
+    const bool retransmission;
     const size_t bytes;
   };
 
@@ -63,8 +76,10 @@ class RoundRobinPacketQueue : public PacketQueueInterface {
 
     virtual ~Stream();
 
+    // Bytes sent, scaled by the weight of the stream.
     size_t bytes;
     uint32_t ssrc;
+    uint32_t allocation_bps;
     std::priority_queue<Packet> packet_queue;
 
     // Whenever a packet is inserted for this stream we check if |priority_it|
@@ -76,8 +91,12 @@ class RoundRobinPacketQueue : public PacketQueueInterface {
   };
 
   static constexpr size_t kMaxLeadingBytes = 1400;
+  static constexpr uint32_t kMaxWeightRatio = 16;
 
+  Stream* GetOrCreateStream(uint32_t ssrc);
   Stream* GetHighestPriorityStream();
+  // Returns |bytes| scaled by the inverse of the weight of |stream|.
+  size_t WeightedBytes(const Stream& stream, size_t bytes) const;
 
   // Just used to verify correctness.
   bool IsSsrcScheduled(uint32_t ssrc) const;
@@ -91,6 +110,7 @@ class RoundRobinPacketQueue : public PacketQueueInterface {
   size_t size_packets_ = 0;
   size_t size_bytes_ = 0;
   size_t max_bytes_ = kMaxLeadingBytes;
+  uint32_t max_allocation_bps_ = 0;
   int64_t queue_time_sum_ms_ = 0;
   int64_t pause_time_sum_ms_ = 0;
 
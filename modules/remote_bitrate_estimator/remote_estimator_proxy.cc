@@ -26,6 +26,12 @@ const int RemoteEstimatorProxy::kBackWindowMs = 500;
 const int RemoteEstimatorProxy::kMinSendIntervalMs = 50;
 const int RemoteEstimatorProxy::kMaxSendIntervalMs = 250;
 const int RemoteEstimatorProxy::kDefaultSendIntervalMs = 100;
+// Room for the packets received in the back window at more than 100000
+// packets per second, and for the largest step in sequence numbers accepted.
+const size_t RemoteEstimatorProxy::kMaxArrivalTimes = 1 << 16;
+
+// Enough for the back window at 2000 packets per second without growing.
+static constexpr size_t kInitialArrivalTimes = 1 << 10;
 
 // The maximum allowed value for a timestamp in milliseconds. This is lower
 // than the numerical limit since we often convert to microseconds.
@@ -41,6 +47,9 @@ RemoteEstimatorProxy::RemoteEstimatorProxy(
       media_ssrc_(0),
       feedback_sequence_(0),
       window_start_seq_(-1),
+      arrival_times_(kInitialArrivalTimes, -1),
+      begin_seq_(0),
+      end_seq_(0),
       send_interval_ms_(kDefaultSendIntervalMs) {}
 
 RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
@@ -130,18 +139,22 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
     return;
   }
 
-  if (packet_arrival_times_.lower_bound(window_start_seq_) ==
-      packet_arrival_times_.end()) {
+  if (end_seq_ <= window_start_seq_) {
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
+    while (begin_seq_ < end_seq_ && begin_seq_ < seq &&
+           arrival_time - ArrivalTime(begin_seq_) >= kBackWindowMs) {
+      ++begin_seq_;
+      SkipNotReceived();
     }
   }
 
+  if ((seq < begin_seq_ || seq >= end_seq_) && !ExtendRange(seq)) {
+    RTC_LOG(LS_WARNING) << "Skipping this sequence number (" << sequence_number
+                        << ") since it is older than the packets kept for "
+                           "feedback.";
+    return;
+  }
+
   if (window_start_seq_ == -1) {
     window_start_seq_ = sequence_number;
   } else if (seq < window_start_seq_) {
@@ -149,10 +162,12 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
   }
 
   // We are only interested in the first time a packet is received.
-  if (packet_arrival_times_.find(seq) != packet_arrival_times_.end())
+  int64_t& packet_arrival_time = ArrivalTime(seq);
+  if (packet_arrival_time >= 0)
     return;
 
-  packet_arrival_times_[seq] = arrival_time;
+  packet_arrival_time = arrival_time;
+  SkipNotReceived();
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
@@ -161,41 +176,96 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
   // feedback packet. Some older may still be in the map, in case a reordering
   // happens and we need to retransmit them.
   rtc::CritScope cs(&lock_);
-  auto it = packet_arrival_times_.lower_bound(window_start_seq_);
-  if (it == packet_arrival_times_.end()) {
+  int64_t seq = std::max(window_start_seq_, begin_seq_);
+  while (seq < end_seq_ && ArrivalTime(seq) < 0)
+    ++seq;
+  if (seq >= end_seq_) {
     // Feedback for all packets already sent.
     return false;
   }
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
-  const int64_t first_sequence = it->first;
+  const int64_t first_sequence = seq;
   feedback_packet->SetMediaSsrc(media_ssrc_);
   // Base sequence is the expected next (window_start_seq_). This is known, but
   // we might not have actually received it, so the base time shall be the time
   // of the first received packet in the feedback.
   feedback_packet->SetBase(static_cast<uint16_t>(window_start_seq_ & 0xFFFF),
-                           it->second * 1000);
+                           ArrivalTime(seq) * 1000);
   feedback_packet->SetFeedbackSequenceNumber(feedback_sequence_++);
-  for (; it != packet_arrival_times_.end(); ++it) {
-    if (!feedback_packet->AddReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
+  for (; seq < end_seq_; ++seq) {
+    const int64_t arrival_time = ArrivalTime(seq);
+    if (arrival_time < 0)
+      continue;
+    if (!feedback_packet->AddReceivedPacket(static_cast<uint16_t>(seq & 0xFFFF),
+                                            arrival_time * 1000)) {
       // If we can't even add the first seq to the feedback packet, we won't be
       // able to build it at all.
-      RTC_CHECK_NE(first_sequence, it->first);
+      RTC_CHECK_NE(first_sequence, seq);
 
       // Could not add timestamp, feedback packet might be full. Return and
       // try again with a fresh packet.
       break;
     }
 
-    // Note: Don't erase items from packet_arrival_times_ after sending, in case
-    // they need to be re-sent after a reordering. Removal will be handled
-    // by OnPacketArrival once packets are too old.
-    window_start_seq_ = it->first + 1;
+    // Note: Don't forget arrival times after sending, in case they need to be
+    // re-sent after a reordering. Removal will be handled by OnPacketArrival
+    // once packets are too old.
+    window_start_seq_ = seq + 1;
   }
 
   return true;
 }
 
+int64_t& RemoteEstimatorProxy::ArrivalTime(int64_t seq) {
+  RTC_DCHECK_GE(seq, begin_seq_);
+  RTC_DCHECK_LT(seq, end_seq_);
+  return arrival_times_[static_cast<uint64_t>(seq) &
+                        (arrival_times_.size() - 1)];
+}
+
+bool RemoteEstimatorProxy::ExtendRange(int64_t seq) {
+  if (begin_seq_ == end_seq_) {
+    begin_seq_ = seq;
+    end_seq_ = seq + 1;
+    ArrivalTime(seq) = -1;
+    return true;
+  }
+  int64_t new_begin = std::min(begin_seq_, seq);
+  const int64_t new_end = std::max(end_seq_, seq + 1);
+  if (new_end - new_begin > static_cast<int64_t>(kMaxArrivalTimes)) {
+    if (seq < begin_seq_)
+      return false;
+    // Forget the oldest packets rather than growing further.
+    new_begin = new_end - kMaxArrivalTimes;
+  }
+  const int64_t kept_begin = std::max(begin_seq_, new_begin);
+
+  size_t size = arrival_times_.size();
+  while (size < static_cast<size_t>(new_end - new_begin))
+    size *= 2;
+  if (size != arrival_times_.size()) {
+    std::vector<int64_t> arrival_times(size, -1);
+    for (int64_t i = kept_begin; i < end_seq_; ++i)
+      arrival_times[static_cast<uint64_t>(i) & (size - 1)] = ArrivalTime(i);
+    arrival_times_.swap(arrival_times);
+  }
+
+  const int64_t old_begin = begin_seq_;
+  const int64_t old_end = end_seq_;
+  begin_seq_ = new_begin;
+  end_seq_ = new_end;
+  for (int64_t i = new_begin; i < old_begin; ++i)
+    ArrivalTime(i) = -1;
+  for (int64_t i = old_end; i < new_end; ++i)
+    ArrivalTime(i) = -1;
+  return true;
+}
+
+void RemoteEstimatorProxy::SkipNotReceived() {
+  while (begin_seq_ < end_seq_ && ArrivalTime(begin_seq_) < 0)
+    ++begin_seq_;
+}
+
 }  // namespace webrtc
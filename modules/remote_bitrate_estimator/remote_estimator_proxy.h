@@ -11,7 +11,6 @@
 #ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
 #include <vector>
 
 #include "modules/include/module_common_types.h"
@@ -52,12 +51,23 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   static const int kMaxSendIntervalMs;
   static const int kDefaultSendIntervalMs;
   static const int kBackWindowMs;
+  static const size_t kMaxArrivalTimes;
 
  private:
   void OnPacketArrival(uint16_t sequence_number, int64_t arrival_time)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
   bool BuildFeedbackPacket(rtcp::TransportFeedback* feedback_packet);
 
+  // Arrival time of the packet with unwrapped sequence number |seq|, which
+  // must be in [begin_seq_, end_seq_). Negative if it has not been received.
+  int64_t& ArrivalTime(int64_t seq) RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+  // Makes room for |seq| in |arrival_times_| and marks the sequence numbers
+  // between it and the current range as not received. Returns false if the
+  // range would grow past kMaxArrivalTimes because |seq| is too old.
+  bool ExtendRange(int64_t seq) RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+  // Moves |begin_seq_| to the first received packet at or after it.
+  void SkipNotReceived() RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+
   const Clock* const clock_;
   TransportFeedbackSenderInterface* const feedback_sender_;
   int64_t last_process_time_ms_;
@@ -68,8 +78,13 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_sequence_ RTC_GUARDED_BY(&lock_);
   SequenceNumberUnwrapper unwrapper_ RTC_GUARDED_BY(&lock_);
   int64_t window_start_seq_ RTC_GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ RTC_GUARDED_BY(&lock_);
+  // Ring of arrival times indexed by unwrapped sequence number, holding the
+  // range [begin_seq_, end_seq_). The range is empty or starts and ends with a
+  // received packet. Its size is a power of two so that no packet arrival
+  // needs more than a mask to find its slot.
+  std::vector<int64_t> arrival_times_ RTC_GUARDED_BY(&lock_);
+  int64_t begin_seq_ RTC_GUARDED_BY(&lock_);
+  int64_t end_seq_ RTC_GUARDED_BY(&lock_);
   int64_t send_interval_ms_ RTC_GUARDED_BY(&lock_);
 };
 
@@ -293,6 +293,32 @@ TEST_F(RemoteEstimatorProxyTest, RemovesTimestampsOutOfScope) {
   Process();
 }
 
+TEST_F(RemoteEstimatorProxyTest, SendsFeedbackForLongRunWithLosses) {
+  // Spans more sequence numbers than the initially allocated arrival times.
+  const int kNumPackets = 3000;
+  std::vector<uint16_t> expected_sequence_numbers;
+  for (int i = 0; i < kNumPackets; ++i) {
+    // Every third packet is lost.
+    if (i % 3 == 2)
+      continue;
+    uint16_t seq = kBaseSeq + i;
+    IncomingPacket(seq, kBaseTimeMs + i);
+    expected_sequence_numbers.push_back(seq);
+  }
+
+  std::vector<uint16_t> sequence_numbers;
+  EXPECT_CALL(router_, SendTransportFeedback(_))
+      .WillRepeatedly(
+          Invoke([&sequence_numbers](rtcp::TransportFeedback* feedback_packet) {
+            for (uint16_t seq : SequenceNumbers(*feedback_packet))
+              sequence_numbers.push_back(seq);
+            return true;
+          }));
+
+  Process();
+  EXPECT_EQ(expected_sequence_numbers, sequence_numbers);
+}
+
 TEST_F(RemoteEstimatorProxyTest, TimeUntilNextProcessIsZeroBeforeFirstProcess) {
   EXPECT_EQ(0, proxy_.TimeUntilNextProcess());
 }
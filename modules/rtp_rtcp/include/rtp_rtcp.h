@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "common_types.h"  // NOLINT(build/include)
 #include "modules/include/module.h"
@@ -241,6 +242,20 @@ class RtpRtcp : public Module, public RtcpFeedbackSenderInterface {
                                 const RTPVideoHeader* rtp_video_header,
                                 uint32_t* transport_frame_id_out) = 0;
 
+  // Sends the payload of one RTP packet that was packetized elsewhere, e.g.
+  // forwarded from a received stream, with the given sequence number, so that
+  // the caller can keep the order of reordered packets. The module sets the
+  // SSRC and its header extensions, and sends the packet like one of its own,
+  // through the pacer and kept for retransmission. Padding on the media SSRC
+  // would reuse sequence numbers, so RTX should be configured.
+  // Returns true on success.
+  virtual bool SendRtpPayload(int8_t payload_type,
+                              bool marker,
+                              uint16_t sequence_number,
+                              uint32_t timestamp,
+                              int64_t capture_time_ms,
+                              rtc::ArrayView<const uint8_t> payload) = 0;
+
   virtual bool TimeToSendPacket(uint32_t ssrc,
                                 uint16_t sequence_number,
                                 int64_t capture_time_ms,
@@ -453,6 +453,11 @@ class RtpPacketSender {
   // TODO(alexnarest): Make it pure virtual after rtp_sender_unittest will be
   // updated to support it
   virtual void SetAccountForAudioPackets(bool account_for_audio) {}
+
+  // If enabled, high priority packets of |ssrc| are sent from InsertPacket()
+  // when the pacer would send them right away anyway, instead of waiting in
+  // the queue for the next time it is processed.
+  virtual void SetAudioFastLane(uint32_t ssrc, bool enabled) {}
 };
 
 class TransportSequenceNumberAllocator {
@@ -98,6 +98,13 @@ class MockRtpRtcp : public RtpRtcp {
                     const RTPFragmentationHeader* fragmentation,
                     const RTPVideoHeader* rtp_video_header,
                     uint32_t* frame_id_out));
+  MOCK_METHOD6(SendRtpPayload,
+               bool(int8_t payload_type,
+                    bool marker,
+                    uint16_t sequence_number,
+                    uint32_t timestamp,
+                    int64_t capture_time_ms,
+                    rtc::ArrayView<const uint8_t> payload));
   MOCK_METHOD5(TimeToSendPacket,
                bool(uint32_t ssrc,
                     uint16_t sequence_number,
@@ -18,7 +18,6 @@ namespace webrtc {
 
 namespace {
 
-using Packet = ForwardErrorCorrection::Packet;
 using ReceivedPacket = ForwardErrorCorrection::ReceivedPacket;
 
 // Minimum header size (in bytes) of a well-formed non-singular FlexFEC packet.
@@ -97,7 +96,7 @@ std::unique_ptr<ReceivedPacket> FlexfecReceiver::AddReceivedPacket(
     // Insert packet payload into erasure code.
     // TODO(brandtr): Remove this memcpy when the FEC packet classes
     // are using COW buffers internally.
-    received_packet->pkt = rtc::scoped_refptr<Packet>(new Packet());
+    received_packet->pkt = erasure_code_->AllocatePacket();
     auto payload = packet.payload();
     memcpy(received_packet->pkt->data, payload.data(), payload.size());
     received_packet->pkt->length = payload.size();
@@ -109,11 +108,9 @@ std::unique_ptr<ReceivedPacket> FlexfecReceiver::AddReceivedPacket(
     }
     received_packet->is_fec = false;
 
-    // Insert entire packet into erasure code.
-    // TODO(brandtr): Remove this memcpy too.
-    received_packet->pkt = rtc::scoped_refptr<Packet>(new Packet());
-    memcpy(received_packet->pkt->data, packet.data(), packet.size());
-    received_packet->pkt->length = packet.size();
+    // Insert entire packet into erasure code. It is only referenced, and not
+    // copied unless it is needed for recovering a lost packet.
+    received_packet->buffer = packet.Buffer();
   }
 
   ++packet_counter_.num_packets;
@@ -20,6 +20,7 @@
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
+#include "modules/rtp_rtcp/source/forward_error_correction_xor.h"
 #include "modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -30,6 +31,22 @@ namespace webrtc {
 namespace {
 // Transport header size in bytes. Assume UDP/IPv4 as a reasonable minimum.
 constexpr size_t kTransportOverhead = 28;
+
+// Returns the data of the media packet |protected_packet|, which is either
+// held in packet storage or referenced, or nullptr if it is missing.
+const uint8_t* ProtectedPacketData(
+    const ForwardErrorCorrection::ProtectedPacket& protected_packet,
+    size_t* length) {
+  if (protected_packet.pkt) {
+    *length = protected_packet.pkt->length;
+    return protected_packet.pkt->data;
+  }
+  if (protected_packet.buffer.size() > 0) {
+    *length = protected_packet.buffer.size();
+    return protected_packet.buffer.cdata();
+  }
+  return nullptr;
+}
 }  // namespace
 
 ForwardErrorCorrection::Packet::Packet() : length(0), data(), ref_count_(0) {}
@@ -47,6 +64,10 @@ int32_t ForwardErrorCorrection::Packet::Release() {
   return ref_count;
 }
 
+bool ForwardErrorCorrection::Packet::HasOneRef() const {
+  return ref_count_ == 1;
+}
+
 // This comparator is used to compare std::unique_ptr's pointing to
 // subclasses of SortablePackets. It needs to be parametric since
 // the std::unique_ptr's are not covariant w.r.t. the types that
@@ -81,6 +102,7 @@ ForwardErrorCorrection::ForwardErrorCorrection(
       fec_header_reader_(std::move(fec_header_reader)),
       fec_header_writer_(std::move(fec_header_writer)),
       generated_fec_packets_(fec_header_writer_->MaxFecPackets()),
+      next_pooled_packet_(0),
       packet_mask_size_(0) {}
 
 ForwardErrorCorrection::~ForwardErrorCorrection() = default;
@@ -200,60 +222,55 @@ void ForwardErrorCorrection::GenerateFecPayloads(
     const PacketList& media_packets,
     size_t num_fec_packets) {
   RTC_DCHECK(!media_packets.empty());
+  RTC_DCHECK_LE(num_fec_packets, kUlpfecMaxMediaPackets);
+  size_t fec_header_sizes[kUlpfecMaxMediaPackets];
   for (size_t i = 0; i < num_fec_packets; ++i) {
-    Packet* const fec_packet = &generated_fec_packets_[i];
-    size_t pkt_mask_idx = i * packet_mask_size_;
     const size_t min_packet_mask_size = fec_header_writer_->MinPacketMaskSize(
-        &packet_masks_[pkt_mask_idx], packet_mask_size_);
-    const size_t fec_header_size =
+        &packet_masks_[i * packet_mask_size_], packet_mask_size_);
+    fec_header_sizes[i] =
         fec_header_writer_->FecHeaderSize(min_packet_mask_size);
+  }
 
-    size_t media_pkt_idx = 0;
-    auto media_packets_it = media_packets.cbegin();
-    uint16_t prev_seq_num = ParseSequenceNumber((*media_packets_it)->data);
-    while (media_packets_it != media_packets.end()) {
-      Packet* const media_packet = media_packets_it->get();
-      // Should |media_packet| be protected by |fec_packet|?
-      if (packet_masks_[pkt_mask_idx] & (1 << (7 - media_pkt_idx))) {
-        size_t media_payload_length = media_packet->length - kRtpHeaderSize;
-
-        bool first_protected_packet = (fec_packet->length == 0);
-        size_t fec_packet_length = fec_header_size + media_payload_length;
-        if (fec_packet_length > fec_packet->length) {
-          // Recall that XORing with zero (which the FEC packets are prefilled
-          // with) is the identity operator, thus all prior XORs are
-          // still correct even though we expand the packet length here.
-          fec_packet->length = fec_packet_length;
-        }
-        if (first_protected_packet) {
-          // Write P, X, CC, M, and PT recovery fields.
-          // Note that bits 0, 1, and 16 are overwritten in FinalizeFecHeaders.
-          memcpy(&fec_packet->data[0], &media_packet->data[0], 2);
-          // Write length recovery field. (This is a temporary location for
-          // ULPFEC.)
-          ByteWriter<uint16_t>::WriteBigEndian(&fec_packet->data[2],
-                                               media_payload_length);
-          // Write timestamp recovery field.
-          memcpy(&fec_packet->data[4], &media_packet->data[4], 4);
-          // Write payload.
-          memcpy(&fec_packet->data[fec_header_size],
-                 &media_packet->data[kRtpHeaderSize], media_payload_length);
-        } else {
-          XorHeaders(*media_packet, fec_packet);
-          XorPayloads(*media_packet, media_payload_length, fec_header_size,
-                      fec_packet);
-        }
-      }
-      media_packets_it++;
-      if (media_packets_it != media_packets.end()) {
-        uint16_t seq_num = ParseSequenceNumber((*media_packets_it)->data);
-        media_pkt_idx += static_cast<uint16_t>(seq_num - prev_seq_num);
-        prev_seq_num = seq_num;
+  // Iterate over the media packets rather than over the FEC packets, so that
+  // every media payload is read once and XORed into all FEC packets that
+  // protect it. The FEC packets are prefilled with zeros, and XORing with zero
+  // is the identity operator, so the first protected packet needs no special
+  // treatment.
+  uint8_t* fec_payloads[kUlpfecMaxMediaPackets];
+  size_t media_pkt_idx = 0;
+  uint16_t prev_seq_num = ParseSequenceNumber(media_packets.front()->data);
+  for (const auto& media_packet : media_packets) {
+    const uint16_t seq_num = ParseSequenceNumber(media_packet->data);
+    media_pkt_idx += static_cast<uint16_t>(seq_num - prev_seq_num);
+    prev_seq_num = seq_num;
+    const size_t mask_byte_idx = media_pkt_idx / 8;
+    const uint8_t mask_bit = 1 << (7 - media_pkt_idx % 8);
+    const size_t media_payload_length = media_packet->length - kRtpHeaderSize;
+
+    size_t num_fec_payloads = 0;
+    for (size_t i = 0; i < num_fec_packets; ++i) {
+      // Should |media_packet| be protected by this FEC packet?
+      if (!(packet_masks_[i * packet_mask_size_ + mask_byte_idx] & mask_bit))
+        continue;
+      Packet* const fec_packet = &generated_fec_packets_[i];
+      const size_t fec_packet_length =
+          fec_header_sizes[i] + media_payload_length;
+      RTC_DCHECK_LE(fec_packet_length, sizeof(fec_packet->data));
+      if (fec_packet_length > fec_packet->length) {
+        fec_packet->length = fec_packet_length;
       }
-      pkt_mask_idx += media_pkt_idx / 8;
-      media_pkt_idx %= 8;
+      // Write P, X, CC, M, and PT recovery fields, the length recovery field
+      // and the timestamp recovery field. Note that bits 0, 1, and 16 are
+      // overwritten in FinalizeFecHeaders, and that the length recovery field
+      // is a temporary location for ULPFEC.
+      XorHeaders(media_packet->data, media_packet->length, fec_packet);
+      fec_payloads[num_fec_payloads++] = &fec_packet->data[fec_header_sizes[i]];
     }
-    RTC_DCHECK_GT(fec_packet->length, 0)
+    internal::XorInto(&media_packet->data[kRtpHeaderSize],
+                      media_payload_length, fec_payloads, num_fec_payloads);
+  }
+  for (size_t i = 0; i < num_fec_packets; ++i) {
+    RTC_DCHECK_GT(generated_fec_packets_[i].length, 0)
         << "Packet mask is wrong or poorly designed.";
   }
 }
@@ -350,6 +367,7 @@ void ForwardErrorCorrection::InsertMediaPacket(
     RecoveredPacketList* recovered_packets,
     const ReceivedPacket& received_packet) {
   RTC_DCHECK_EQ(received_packet.ssrc, protected_media_ssrc_);
+  RTC_DCHECK(received_packet.pkt || received_packet.buffer.size() > 0);
 
   // Search for duplicate packets.
   for (const auto& recovered_packet : *recovered_packets) {
@@ -368,7 +386,7 @@ void ForwardErrorCorrection::InsertMediaPacket(
   recovered_packet->ssrc = received_packet.ssrc;
   recovered_packet->seq_num = received_packet.seq_num;
   recovered_packet->pkt = received_packet.pkt;
-  recovered_packet->pkt->length = received_packet.pkt->length;
+  recovered_packet->buffer = received_packet.buffer;
   // TODO(holmer): Consider replacing this with a binary search for the right
   // position, and then just insert the new packet. Would get rid of the sort.
   RecoveredPacket* recovered_packet_ptr = recovered_packet.get();
@@ -388,6 +406,7 @@ void ForwardErrorCorrection::UpdateCoveringFecPackets(
         (*protected_it)->seq_num == packet.seq_num) {
       // Found an FEC packet which is protecting |packet|.
       (*protected_it)->pkt = packet.pkt;
+      (*protected_it)->buffer = packet.buffer;
     }
   }
 }
@@ -396,6 +415,8 @@ void ForwardErrorCorrection::InsertFecPacket(
     const RecoveredPacketList& recovered_packets,
     const ReceivedPacket& received_packet) {
   RTC_DCHECK_EQ(received_packet.ssrc, ssrc_);
+  // The FEC header reader modifies the packet, so it cannot be a reference.
+  RTC_DCHECK(received_packet.pkt);
 
   // Check for duplicate.
   for (const auto& existing_fec_packet : received_fec_packets_) {
@@ -480,6 +501,7 @@ void ForwardErrorCorrection::AssignRecoveredPackets(
     } else {  // *it_p == *it_r.
       // This protected packet has already been recovered.
       (*it_p)->pkt = (*it_r)->pkt;
+      (*it_p)->buffer = (*it_r)->buffer;
       ++it_p;
       ++it_r;
     }
@@ -536,8 +558,7 @@ bool ForwardErrorCorrection::StartPacketRecovery(
     return false;
   }
   // Initialize recovered packet data.
-  recovered_packet->pkt = new Packet();
-  memset(recovered_packet->pkt->data, 0, IP_PACKET_SIZE);
+  recovered_packet->pkt = AllocatePacket();
   recovered_packet->returned = false;
   recovered_packet->was_recovered = true;
   // Copy bytes corresponding to minimum RTP header size.
@@ -583,37 +604,37 @@ bool ForwardErrorCorrection::FinishPacketRecovery(
   return true;
 }
 
-void ForwardErrorCorrection::XorHeaders(const Packet& src, Packet* dst) {
+void ForwardErrorCorrection::XorHeaders(const uint8_t* src,
+                                        size_t src_length,
+                                        Packet* dst) {
   // XOR the first 2 bytes of the header: V, P, X, CC, M, PT fields.
-  dst->data[0] ^= src.data[0];
-  dst->data[1] ^= src.data[1];
+  dst->data[0] ^= src[0];
+  dst->data[1] ^= src[1];
 
   // XOR the length recovery field.
   uint8_t src_payload_length_network_order[2];
   ByteWriter<uint16_t>::WriteBigEndian(src_payload_length_network_order,
-                                       src.length - kRtpHeaderSize);
+                                       src_length - kRtpHeaderSize);
   dst->data[2] ^= src_payload_length_network_order[0];
   dst->data[3] ^= src_payload_length_network_order[1];
 
   // XOR the 5th to 8th bytes of the header: the timestamp field.
-  dst->data[4] ^= src.data[4];
-  dst->data[5] ^= src.data[5];
-  dst->data[6] ^= src.data[6];
-  dst->data[7] ^= src.data[7];
+  dst->data[4] ^= src[4];
+  dst->data[5] ^= src[5];
+  dst->data[6] ^= src[6];
+  dst->data[7] ^= src[7];
 
   // Skip the 9th to 12th bytes of the header.
 }
 
-void ForwardErrorCorrection::XorPayloads(const Packet& src,
+void ForwardErrorCorrection::XorPayloads(const uint8_t* src,
                                          size_t payload_length,
                                          size_t dst_offset,
                                          Packet* dst) {
   // XOR the payload.
-  RTC_DCHECK_LE(kRtpHeaderSize + payload_length, sizeof(src.data));
   RTC_DCHECK_LE(dst_offset + payload_length, sizeof(dst->data));
-  for (size_t i = 0; i < payload_length; ++i) {
-    dst->data[dst_offset + i] ^= src.data[kRtpHeaderSize + i];
-  }
+  uint8_t* const dst_payload = &dst->data[dst_offset];
+  internal::XorInto(&src[kRtpHeaderSize], payload_length, &dst_payload, 1);
 }
 
 bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
@@ -622,13 +643,18 @@ bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
     return false;
   }
   for (const auto& protected_packet : fec_packet.protected_packets) {
-    if (protected_packet->pkt == nullptr) {
+    size_t length = 0;
+    const uint8_t* data = ProtectedPacketData(*protected_packet, &length);
+    if (data == nullptr) {
       // This is the packet we're recovering.
       recovered_packet->seq_num = protected_packet->seq_num;
     } else {
-      XorHeaders(*protected_packet->pkt, recovered_packet->pkt);
-      XorPayloads(*protected_packet->pkt, protected_packet->pkt->length,
-                  kRtpHeaderSize, recovered_packet->pkt);
+      // Only the payload was XORed into the FEC packet, not the bytes after
+      // it, which need not be zero in packet storage and are not even part of
+      // referenced packets.
+      XorHeaders(data, length, recovered_packet->pkt);
+      XorPayloads(data, length - kRtpHeaderSize, kRtpHeaderSize,
+                  recovered_packet->pkt);
     }
   }
   if (!FinishPacketRecovery(fec_packet, recovered_packet)) {
@@ -685,7 +711,8 @@ int ForwardErrorCorrection::NumCoveredPacketsMissing(
     const ReceivedFecPacket& fec_packet) {
   int packets_missing = 0;
   for (const auto& protected_packet : fec_packet.protected_packets) {
-    if (protected_packet->pkt == nullptr) {
+    size_t length;
+    if (ProtectedPacketData(*protected_packet, &length) == nullptr) {
       ++packets_missing;
       if (packets_missing > 1) {
         break;  // We can't recover more than one packet.
@@ -739,6 +766,27 @@ void ForwardErrorCorrection::DecodeFec(const ReceivedPacket& received_packet,
   AttemptRecovery(recovered_packets);
 }
 
+rtc::scoped_refptr<ForwardErrorCorrection::Packet>
+ForwardErrorCorrection::AllocatePacket() {
+  for (size_t i = 0; i < packet_pool_.size(); ++i) {
+    const size_t index = (next_pooled_packet_ + i) % packet_pool_.size();
+    Packet* const packet = packet_pool_[index].get();
+    if (packet->HasOneRef()) {
+      next_pooled_packet_ = index + 1;
+      packet->length = 0;
+      memset(packet->data, 0, sizeof(packet->data));
+      return packet;
+    }
+  }
+  // Enough for all packets that the decoder keeps, plus the ones in flight.
+  const size_t max_pooled_packets = fec_header_reader_->MaxMediaPackets() +
+                                    fec_header_reader_->MaxFecPackets() + 2;
+  rtc::scoped_refptr<Packet> packet(new Packet());
+  if (packet_pool_.size() < max_pooled_packets)
+    packet_pool_.push_back(packet);
+  return packet;
+}
+
 size_t ForwardErrorCorrection::MaxPacketOverhead() const {
   return fec_header_writer_->MaxPacketOverhead();
 }
@@ -20,6 +20,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/scoped_ref_ptr.h"
 
@@ -52,6 +53,9 @@ class ForwardErrorCorrection {
     // reaches zero.
     virtual int32_t Release();
 
+    // Returns true if the caller holds the only reference.
+    bool HasOneRef() const;
+
     size_t length;                 // Length of packet in bytes.
     uint8_t data[IP_PACKET_SIZE];  // Packet data.
 
@@ -86,6 +90,10 @@ class ForwardErrorCorrection {
     bool is_fec;  // Set to true if this is an FEC packet and false
                   // otherwise.
     rtc::scoped_refptr<Packet> pkt;  // Pointer to the packet storage.
+    // Media packets may instead be passed as the complete RTP packet in
+    // |buffer|, leaving |pkt| null. The decoder then only keeps a reference to
+    // the buffer, and reads from it if the packet is needed for recovery.
+    rtc::CopyOnWriteBuffer buffer;
   };
 
   // The recovered list parameter of DecodeFec() references structs of
@@ -102,6 +110,9 @@ class ForwardErrorCorrection {
     bool returned;  // True when the packet already has been returned to the
                     // caller through the callback.
     rtc::scoped_refptr<Packet> pkt;  // Pointer to the packet storage.
+    // Set instead of |pkt| for media packets received by reference, see
+    // ReceivedPacket::buffer.
+    rtc::CopyOnWriteBuffer buffer;
   };
 
   // Used to link media packets to their protecting FEC packets.
@@ -113,6 +124,9 @@ class ForwardErrorCorrection {
     ~ProtectedPacket();
 
     rtc::scoped_refptr<ForwardErrorCorrection::Packet> pkt;
+    // Set instead of |pkt| for media packets received by reference, see
+    // ReceivedPacket::buffer.
+    rtc::CopyOnWriteBuffer buffer;
   };
 
   using ProtectedPacketList = std::list<std::unique_ptr<ProtectedPacket>>;
@@ -203,8 +217,11 @@ class ForwardErrorCorrection {
   // |recovered_packets| will be progressively assembled with each call.
   // When the function returns, |received_packets| will be empty.
   //
-  // The caller will allocate packets submitted through |received_packets|.
-  // The function will handle allocation of recovered packets.
+  // The caller will allocate packets submitted through |received_packets|,
+  // preferably using AllocatePacket(). Media packets can also be submitted by
+  // reference, see ReceivedPacket::buffer, in which case nothing is copied
+  // unless the packet is used to recover another one. The function will
+  // handle allocation of recovered packets.
   //
   // Input:  received_packets   List of new received packets, of type
   //                            ReceivedPacket, belonging to a single
@@ -220,6 +237,11 @@ class ForwardErrorCorrection {
   void DecodeFec(const ReceivedPacket& received_packet,
                  RecoveredPacketList* recovered_packets);
 
+  // Returns zeroed packet storage for input to DecodeFec(). The storage of
+  // packets that the decoder and the caller no longer reference is reused, so
+  // that the receive path does not allocate memory for every packet.
+  rtc::scoped_refptr<Packet> AllocatePacket();
+
   // Get the number of generated FEC packets, given the number of media packets
   // and the protection factor.
   static int NumFecPackets(int num_media_packets, int protection_factor);
@@ -294,18 +316,18 @@ class ForwardErrorCorrection {
 
   // Initializes headers and payload before the XOR operation
   // that recovers a packet.
-  static bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
-                                  RecoveredPacket* recovered_packet);
+  bool StartPacketRecovery(const ReceivedFecPacket& fec_packet,
+                           RecoveredPacket* recovered_packet);
 
-  // Performs XOR between the first 8 bytes of |src| and |dst| and stores
-  // the result in |dst|. The 3rd and 4th bytes are used for storing
-  // the length recovery field.
-  static void XorHeaders(const Packet& src, Packet* dst);
+  // Performs XOR between the first 8 bytes of the |src_length| byte packet
+  // |src| and |dst| and stores the result in |dst|. The 3rd and 4th bytes are
+  // used for storing the length recovery field.
+  static void XorHeaders(const uint8_t* src, size_t src_length, Packet* dst);
 
   // Performs XOR between the payloads of |src| and |dst| and stores the result
   // in |dst|. The parameter |dst_offset| determines at  what byte the
   // XOR operation starts in |dst|. In total, |payload_length| bytes are XORed.
-  static void XorPayloads(const Packet& src,
+  static void XorPayloads(const uint8_t* src,
                           size_t payload_length,
                           size_t dst_offset,
                           Packet* dst);
@@ -316,8 +338,8 @@ class ForwardErrorCorrection {
                                    RecoveredPacket* recovered_packet);
 
   // Recover a missing packet.
-  static bool RecoverPacket(const ReceivedFecPacket& fec_packet,
-                            RecoveredPacket* recovered_packet);
+  bool RecoverPacket(const ReceivedFecPacket& fec_packet,
+                     RecoveredPacket* recovered_packet);
 
   // Get the number of missing media packets which are covered by |fec_packet|.
   // An FEC packet can recover at most one packet, and if zero packets are
@@ -339,6 +361,11 @@ class ForwardErrorCorrection {
   std::vector<Packet> generated_fec_packets_;
   ReceivedFecPacketList received_fec_packets_;
 
+  // Packet storage handed out by AllocatePacket(), and where to start looking
+  // for an unreferenced packet.
+  std::vector<rtc::scoped_refptr<Packet>> packet_pool_;
+  size_t next_pooled_packet_;
+
   // Arrays used to avoid dynamically allocating memory when generating
   // the packet masks.
   // (There are never more than |kUlpfecMaxMediaPackets| FEC packets generated.)
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/forward_error_correction_xor.h"
+
+#include <string.h>
+
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+
+using XorIntoFunction = void (*)(const uint8_t*,
+                                 size_t,
+                                 uint8_t* const*,
+                                 size_t);
+
+XorIntoFunction SelectXorInto() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2))
+    return XorIntoAvx2;
+#if defined(__SSE2__)
+  return XorIntoSse2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? XorIntoSse2 : XorIntoC;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return XorIntoNeon;
+#else
+  return XorIntoC;
+#endif
+}
+
+}  // namespace
+
+void XorInto(const uint8_t* src,
+             size_t length,
+             uint8_t* const* dsts,
+             size_t num_dsts) {
+  static const XorIntoFunction xor_into = SelectXorInto();
+  xor_into(src, length, dsts, num_dsts);
+}
+
+void XorIntoC(const uint8_t* src,
+              size_t length,
+              uint8_t* const* dsts,
+              size_t num_dsts) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t s;
+    memcpy(&s, src + i, sizeof(s));
+    for (size_t d = 0; d < num_dsts; ++d) {
+      uint64_t v;
+      memcpy(&v, dsts[d] + i, sizeof(v));
+      v ^= s;
+      memcpy(dsts[d] + i, &v, sizeof(v));
+    }
+  }
+  for (; i < length; ++i) {
+    for (size_t d = 0; d < num_dsts; ++d)
+      dsts[d][i] ^= src[i];
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
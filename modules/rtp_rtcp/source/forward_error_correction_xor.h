@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_FORWARD_ERROR_CORRECTION_XOR_H_
+#define MODULES_RTP_RTCP_SOURCE_FORWARD_ERROR_CORRECTION_XOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+namespace internal {
+
+// XORs |length| bytes of |src| into each of the |num_dsts| buffers in |dsts|,
+// reading |src| only once. The buffers must not overlap |src|. Uses the
+// widest vector instructions that the CPU supports.
+void XorInto(const uint8_t* src,
+             size_t length,
+             uint8_t* const* dsts,
+             size_t num_dsts);
+
+// Implementations of XorInto(), exposed for testing.
+void XorIntoC(const uint8_t* src,
+              size_t length,
+              uint8_t* const* dsts,
+              size_t num_dsts);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void XorIntoSse2(const uint8_t* src,
+                 size_t length,
+                 uint8_t* const* dsts,
+                 size_t num_dsts);
+void XorIntoAvx2(const uint8_t* src,
+                 size_t length,
+                 uint8_t* const* dsts,
+                 size_t num_dsts);
+#endif
+#if defined(WEBRTC_HAS_NEON)
+void XorIntoNeon(const uint8_t* src,
+                 size_t length,
+                 uint8_t* const* dsts,
+                 size_t num_dsts);
+#endif
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_FORWARD_ERROR_CORRECTION_XOR_H_
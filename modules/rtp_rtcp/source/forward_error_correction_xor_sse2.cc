@@ -0,0 +1,38 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/forward_error_correction_xor.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+namespace internal {
+
+void XorIntoSse2(const uint8_t* src,
+                 size_t length,
+                 uint8_t* const* dsts,
+                 size_t num_dsts) {
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i s =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    for (size_t d = 0; d < num_dsts; ++d) {
+      __m128i* dst = reinterpret_cast<__m128i*>(dsts[d] + i);
+      _mm_storeu_si128(dst, _mm_xor_si128(_mm_loadu_si128(dst), s));
+    }
+  }
+  for (; i < length; ++i) {
+    for (size_t d = 0; d < num_dsts; ++d)
+      dsts[d][i] ^= src[i];
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/forward_error_correction_xor.h"
+
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+
+using XorIntoFunction = void (*)(const uint8_t*,
+                                 size_t,
+                                 uint8_t* const*,
+                                 size_t);
+
+// Compares |xor_into| with a byte by byte XOR, for unaligned buffers of all
+// lengths around the vector sizes.
+void VerifyXorInto(XorIntoFunction xor_into) {
+  constexpr size_t kMaxLength = 100;
+  constexpr size_t kNumDsts = 5;
+  Random random(0x1234);
+  std::vector<uint8_t> src(kMaxLength + 1);
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (size_t num_dsts = 0; num_dsts <= kNumDsts; ++num_dsts) {
+      for (uint8_t& byte : src)
+        byte = random.Rand<uint8_t>();
+      std::vector<std::vector<uint8_t>> dsts(num_dsts);
+      std::vector<std::vector<uint8_t>> expected(num_dsts);
+      uint8_t* dst_ptrs[kNumDsts];
+      for (size_t d = 0; d < num_dsts; ++d) {
+        // One guard byte after |length|.
+        dsts[d].resize(length + 2);
+        for (uint8_t& byte : dsts[d])
+          byte = random.Rand<uint8_t>();
+        expected[d] = dsts[d];
+        for (size_t i = 0; i < length; ++i)
+          expected[d][1 + i] ^= src[1 + i];
+        dst_ptrs[d] = &dsts[d][1];
+      }
+      xor_into(&src[1], length, dst_ptrs, num_dsts);
+      for (size_t d = 0; d < num_dsts; ++d)
+        ASSERT_EQ(expected[d], dsts[d]) << length << " bytes, dst " << d;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ForwardErrorCorrectionXorTest, C) {
+  VerifyXorInto(XorIntoC);
+}
+
+TEST(ForwardErrorCorrectionXorTest, Dispatch) {
+  VerifyXorInto(XorInto);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(ForwardErrorCorrectionXorTest, Sse2) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  VerifyXorInto(XorIntoSse2);
+}
+
+TEST(ForwardErrorCorrectionXorTest, Avx2) {
+  if (!WebRtc_GetCPUInfo(kAVX2))
+    return;
+  VerifyXorInto(XorIntoAvx2);
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+TEST(ForwardErrorCorrectionXorTest, Neon) {
+  VerifyXorInto(XorIntoNeon);
+}
+#endif
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/receive_statistics_aggregator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+ReceiveStatisticsAggregator::ReceiveStatisticsAggregator() = default;
+
+ReceiveStatisticsAggregator::~ReceiveStatisticsAggregator() = default;
+
+void ReceiveStatisticsAggregator::AddProvider(
+    ReceiveStatisticsProvider* provider) {
+  RTC_DCHECK(provider);
+  rtc::CritScope lock(&lock_);
+  RTC_DCHECK(std::find(providers_.begin(), providers_.end(), provider) ==
+             providers_.end());
+  providers_.push_back(provider);
+}
+
+void ReceiveStatisticsAggregator::RemoveProvider(
+    ReceiveStatisticsProvider* provider) {
+  rtc::CritScope lock(&lock_);
+  auto it = std::find(providers_.begin(), providers_.end(), provider);
+  if (it == providers_.end())
+    return;
+  size_t index = it - providers_.begin();
+  providers_.erase(it);
+  if (index < next_provider_)
+    --next_provider_;
+  if (next_provider_ >= providers_.size())
+    next_provider_ = 0;
+}
+
+std::vector<rtcp::ReportBlock> ReceiveStatisticsAggregator::RtcpReportBlocks(
+    size_t max_blocks) {
+  rtc::CritScope lock(&lock_);
+  std::vector<rtcp::ReportBlock> result;
+  const size_t num_providers = providers_.size();
+  for (size_t i = 0; i < num_providers && result.size() < max_blocks; ++i) {
+    ReceiveStatisticsProvider* provider =
+        providers_[(next_provider_ + i) % num_providers];
+    std::vector<rtcp::ReportBlock> blocks =
+        provider->RtcpReportBlocks(max_blocks - result.size());
+    RTC_DCHECK_LE(blocks.size(), max_blocks - result.size());
+    if (result.empty()) {
+      result = std::move(blocks);
+    } else {
+      result.insert(result.end(), blocks.begin(), blocks.end());
+    }
+  }
+  if (num_providers > 0)
+    next_provider_ = (next_provider_ + 1) % num_providers;
+  return result;
+}
+
+}  // namespace webrtc
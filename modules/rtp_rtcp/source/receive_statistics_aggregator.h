@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_AGGREGATOR_H_
+#define MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_AGGREGATOR_H_
+
+#include <vector>
+
+#include "modules/rtp_rtcp/include/receive_statistics.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Collects report blocks from the receive statistics of all streams sharing
+// one rtp transport, so that a single RtcpTransceiver can report all of them
+// in few compound packets instead of every stream sending own receiver
+// reports. When there are more report blocks than fit into one request,
+// providers take turns to be asked first.
+class ReceiveStatisticsAggregator : public ReceiveStatisticsProvider {
+ public:
+  ReceiveStatisticsAggregator();
+  ~ReceiveStatisticsAggregator() override;
+
+  // |provider| should outlive this class or be removed before it is deleted.
+  void AddProvider(ReceiveStatisticsProvider* provider);
+  void RemoveProvider(ReceiveStatisticsProvider* provider);
+
+  // Implements ReceiveStatisticsProvider.
+  std::vector<rtcp::ReportBlock> RtcpReportBlocks(size_t max_blocks) override;
+
+ private:
+  rtc::CriticalSection lock_;
+  std::vector<ReceiveStatisticsProvider*> providers_ RTC_GUARDED_BY(lock_);
+  // Index into |providers_| of the provider to ask first next time.
+  size_t next_provider_ RTC_GUARDED_BY(lock_) = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ReceiveStatisticsAggregator);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_AGGREGATOR_H_
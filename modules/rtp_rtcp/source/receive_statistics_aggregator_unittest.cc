@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/receive_statistics_aggregator.h"
+
+#include <utility>
+#include <vector>
+
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// Reports the same blocks every time, as many as requested.
+class FakeReceiveStatistics : public ReceiveStatisticsProvider {
+ public:
+  explicit FakeReceiveStatistics(std::vector<uint32_t> ssrcs)
+      : ssrcs_(std::move(ssrcs)) {}
+
+  std::vector<rtcp::ReportBlock> RtcpReportBlocks(size_t max_blocks) override {
+    std::vector<rtcp::ReportBlock> result;
+    for (size_t i = 0; i < ssrcs_.size() && i < max_blocks; ++i) {
+      result.emplace_back();
+      result.back().SetMediaSsrc(ssrcs_[i]);
+    }
+    return result;
+  }
+
+ private:
+  const std::vector<uint32_t> ssrcs_;
+};
+
+std::vector<uint32_t> Ssrcs(const std::vector<rtcp::ReportBlock>& blocks) {
+  std::vector<uint32_t> ssrcs;
+  for (const rtcp::ReportBlock& block : blocks)
+    ssrcs.push_back(block.source_ssrc());
+  return ssrcs;
+}
+
+TEST(ReceiveStatisticsAggregatorTest, ReportsNothingWithoutProviders) {
+  ReceiveStatisticsAggregator aggregator;
+  EXPECT_THAT(aggregator.RtcpReportBlocks(31), IsEmpty());
+}
+
+TEST(ReceiveStatisticsAggregatorTest, CombinesReportBlocksOfAllProviders) {
+  FakeReceiveStatistics stream1({1, 2});
+  FakeReceiveStatistics stream2({3});
+  ReceiveStatisticsAggregator aggregator;
+  aggregator.AddProvider(&stream1);
+  aggregator.AddProvider(&stream2);
+
+  EXPECT_THAT(Ssrcs(aggregator.RtcpReportBlocks(31)), ElementsAre(1, 2, 3));
+}
+
+TEST(ReceiveStatisticsAggregatorTest, ProvidersTakeTurnsWhenLimited) {
+  FakeReceiveStatistics stream1({1, 2});
+  FakeReceiveStatistics stream2({3, 4});
+  FakeReceiveStatistics stream3({5, 6});
+  ReceiveStatisticsAggregator aggregator;
+  aggregator.AddProvider(&stream1);
+  aggregator.AddProvider(&stream2);
+  aggregator.AddProvider(&stream3);
+
+  EXPECT_THAT(Ssrcs(aggregator.RtcpReportBlocks(3)), ElementsAre(1, 2, 3));
+  EXPECT_THAT(Ssrcs(aggregator.RtcpReportBlocks(3)), ElementsAre(3, 4, 5));
+  EXPECT_THAT(Ssrcs(aggregator.RtcpReportBlocks(3)), ElementsAre(5, 6, 1));
+  EXPECT_THAT(Ssrcs(aggregator.RtcpReportBlocks(3)), ElementsAre(1, 2, 3));
+}
+
+TEST(ReceiveStatisticsAggregatorTest, StopsAskingRemovedProvider) {
+  FakeReceiveStatistics stream1({1});
+  FakeReceiveStatistics stream2({2});
+  FakeReceiveStatistics stream3({3});
+  ReceiveStatisticsAggregator aggregator;
+  aggregator.AddProvider(&stream1);
+  aggregator.AddProvider(&stream2);
+  aggregator.AddProvider(&stream3);
+  // Move turn to the |stream2|.
+  aggregator.RtcpReportBlocks(1);
+
+  aggregator.RemoveProvider(&stream1);
+
+  EXPECT_THAT(Ssrcs(aggregator.RtcpReportBlocks(1)), ElementsAre(2));
+  EXPECT_THAT(Ssrcs(aggregator.RtcpReportBlocks(31)), ElementsAre(3, 2));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <vector>
 
+#include "absl/memory/memory.h"
 #include "modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "modules/rtp_rtcp/source/time_util.h"
@@ -35,16 +36,11 @@ StreamStatisticianImpl::StreamStatisticianImpl(
     StreamDataCountersCallback* rtp_callback)
     : ssrc_(ssrc),
       clock_(clock),
+      max_reordering_threshold_(kDefaultMaxReorderingThreshold),
       incoming_bitrate_(kStatisticsProcessIntervalMs,
                         RateStatistics::kBpsScale),
-      max_reordering_threshold_(kDefaultMaxReorderingThreshold),
-      jitter_q4_(0),
-      last_receive_time_ms_(0),
-      last_received_timestamp_(0),
-      received_seq_first_(0),
-      received_seq_max_(0),
-      received_seq_wraps_(0),
       received_packet_overhead_(12),
+      last_fraction_lost_(0),
       rtcp_callback_(rtcp_callback),
       rtp_callback_(rtp_callback) {}
 
@@ -53,35 +49,33 @@ StreamStatisticianImpl::~StreamStatisticianImpl() = default;
 void StreamStatisticianImpl::IncomingPacket(const RTPHeader& header,
                                             size_t packet_length,
                                             bool retransmitted) {
-  StreamDataCounters counters;
-  RtcpStatistics rtcp_stats;
-  {
-    rtc::CritScope cs(&stream_lock_);
-    counters = UpdateCounters(header, packet_length, retransmitted);
-    // We only want to recalculate |fraction_lost| when sending an RTCP SR or
-    // RR.
-    rtcp_stats = CalculateRtcpStatistics(/*update_fraction_lost=*/false);
-  }
-
-  rtp_callback_->DataCountersUpdated(counters, ssrc_);
-  rtcp_callback_->StatisticsUpdated(rtcp_stats, ssrc_);
+  RTC_DCHECK_RUNS_SERIALIZED(&packet_race_checker_);
+  UpdateCounters(header, packet_length, retransmitted);
+  published_state_.Write(state_);
+
+  rtp_callback_->DataCountersUpdated(state_.counters, ssrc_);
+  // We only want to recalculate |fraction_lost| when sending an RTCP SR or
+  // RR.
+  rtcp_callback_->StatisticsUpdated(CalculateRtcpStatistics(state_), ssrc_);
 }
 
-StreamDataCounters StreamStatisticianImpl::UpdateCounters(
-    const RTPHeader& header,
-    size_t packet_length,
-    bool retransmitted) {
-  bool in_order = InOrderPacketInternal(header.sequenceNumber);
+void StreamStatisticianImpl::UpdateCounters(const RTPHeader& header,
+                                            size_t packet_length,
+                                            bool retransmitted) {
+  StreamDataCounters& counters = state_.counters;
+  bool in_order = InOrderPacket(state_, header.sequenceNumber);
   RTC_DCHECK_EQ(ssrc_, header.ssrc);
-  incoming_bitrate_.Update(packet_length, clock_->TimeInMilliseconds());
-  receive_counters_.transmitted.AddPacket(packet_length, header);
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  incoming_bitrate_.Update(packet_length, now_ms);
+  state_.bitrate_bps = incoming_bitrate_.Rate(now_ms).value_or(0);
+  counters.transmitted.AddPacket(packet_length, header);
   if (!in_order && retransmitted) {
-    receive_counters_.retransmitted.AddPacket(packet_length, header);
+    counters.retransmitted.AddPacket(packet_length, header);
   }
 
-  if (receive_counters_.transmitted.packets == 1) {
-    received_seq_first_ = header.sequenceNumber;
-    receive_counters_.first_packet_time_ms = clock_->TimeInMilliseconds();
+  if (counters.transmitted.packets == 1) {
+    state_.received_seq_first = header.sequenceNumber;
+    counters.first_packet_time_ms = now_ms;
   }
 
   // Count only the new packets received. That is, if packets 1, 2, 3, 5, 4, 6
@@ -91,24 +85,24 @@ StreamDataCounters StreamStatisticianImpl::UpdateCounters(
     NtpTime receive_time = clock_->CurrentNtpTime();
 
     // Wrong if we use RetransmitOfOldPacket.
-    if (receive_counters_.transmitted.packets > 1 &&
-        received_seq_max_ > header.sequenceNumber) {
+    if (counters.transmitted.packets > 1 &&
+        state_.received_seq_max > header.sequenceNumber) {
       // Wrap around detected.
-      received_seq_wraps_++;
+      state_.received_seq_wraps++;
     }
     // New max.
-    received_seq_max_ = header.sequenceNumber;
+    state_.received_seq_max = header.sequenceNumber;
 
     // If new time stamp and more than one in-order packet received, calculate
     // new jitter statistics.
-    if (header.timestamp != last_received_timestamp_ &&
-        (receive_counters_.transmitted.packets -
-         receive_counters_.retransmitted.packets) > 1) {
+    if (header.timestamp != state_.last_received_timestamp &&
+        (counters.transmitted.packets - counters.retransmitted.packets) > 1) {
       UpdateJitter(header, receive_time);
     }
-    last_received_timestamp_ = header.timestamp;
+    state_.last_received_timestamp = header.timestamp;
     last_receive_time_ntp_ = receive_time;
-    last_receive_time_ms_ = clock_->TimeInMilliseconds();
+    state_.last_receive_time_ntp_ms = receive_time.ToMs();
+    state_.last_receive_time_ms = now_ms;
   }
 
   size_t packet_oh = header.headerLength + header.paddingLength;
@@ -116,7 +110,6 @@ StreamDataCounters StreamStatisticianImpl::UpdateCounters(
   // Our measured overhead. Filter from RFC 5104 4.2.1.2:
   // avg_OH (new) = 15/16*avg_OH (old) + 1/16*pckt_OH,
   received_packet_overhead_ = (15 * received_packet_overhead_ + packet_oh) >> 4;
-  return receive_counters_;
 }
 
 void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
@@ -125,8 +118,9 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
       NtpToRtp(receive_time, header.payload_type_frequency);
   uint32_t last_receive_time_rtp =
       NtpToRtp(last_receive_time_ntp_, header.payload_type_frequency);
-  int32_t time_diff_samples = (receive_time_rtp - last_receive_time_rtp) -
-                              (header.timestamp - last_received_timestamp_);
+  int32_t time_diff_samples =
+      (receive_time_rtp - last_receive_time_rtp) -
+      (header.timestamp - state_.last_received_timestamp);
 
   time_diff_samples = std::abs(time_diff_samples);
 
@@ -135,63 +129,62 @@ void StreamStatisticianImpl::UpdateJitter(const RTPHeader& header,
   // as the threshold.
   if (time_diff_samples < 450000) {
     // Note we calculate in Q4 to avoid using float.
-    int32_t jitter_diff_q4 = (time_diff_samples << 4) - jitter_q4_;
-    jitter_q4_ += ((jitter_diff_q4 + 8) >> 4);
+    int32_t jitter_diff_q4 = (time_diff_samples << 4) - state_.jitter_q4;
+    state_.jitter_q4 += ((jitter_diff_q4 + 8) >> 4);
   }
 }
 
 void StreamStatisticianImpl::FecPacketReceived(const RTPHeader& header,
                                                size_t packet_length) {
-  StreamDataCounters counters;
-  {
-    rtc::CritScope cs(&stream_lock_);
-    receive_counters_.fec.AddPacket(packet_length, header);
-    counters = receive_counters_;
-  }
-  rtp_callback_->DataCountersUpdated(counters, ssrc_);
+  RTC_DCHECK_RUNS_SERIALIZED(&packet_race_checker_);
+  state_.counters.fec.AddPacket(packet_length, header);
+  published_state_.Write(state_);
+  rtp_callback_->DataCountersUpdated(state_.counters, ssrc_);
 }
 
 void StreamStatisticianImpl::SetMaxReorderingThreshold(
     int max_reordering_threshold) {
-  rtc::CritScope cs(&stream_lock_);
-  max_reordering_threshold_ = max_reordering_threshold;
+  max_reordering_threshold_.store(max_reordering_threshold,
+                                  std::memory_order_relaxed);
 }
 
 bool StreamStatisticianImpl::GetStatistics(RtcpStatistics* statistics,
                                            bool update_fraction_lost) {
-  {
-    rtc::CritScope cs(&stream_lock_);
-    if (received_seq_first_ == 0 &&
-        receive_counters_.transmitted.payload_bytes == 0) {
-      // We have not received anything.
-      return false;
-    }
-
-    *statistics = CalculateRtcpStatistics(update_fraction_lost);
+  const ReceiveState state = published_state_.Read();
+  if (state.received_seq_first == 0 &&
+      state.counters.transmitted.payload_bytes == 0) {
+    // We have not received anything.
+    return false;
   }
 
-  if (update_fraction_lost) {
-    rtcp_callback_->StatisticsUpdated(*statistics, ssrc_);
+  if (!update_fraction_lost) {
+    *statistics = CalculateRtcpStatistics(state);
+    return true;
+  }
+  {
+    rtc::CritScope cs(&report_lock_);
+    *statistics = CalculateRtcpStatistics(state, /*update_fraction_lost=*/true);
   }
+  rtcp_callback_->StatisticsUpdated(*statistics, ssrc_);
   return true;
 }
 
 bool StreamStatisticianImpl::GetActiveStatisticsAndReset(
     RtcpStatistics* statistics) {
+  const ReceiveState state = published_state_.Read();
+  if (clock_->CurrentNtpInMilliseconds() - state.last_receive_time_ntp_ms >=
+      kStatisticsTimeoutMs) {
+    // Not active.
+    return false;
+  }
+  if (state.received_seq_first == 0 &&
+      state.counters.transmitted.payload_bytes == 0) {
+    // We have not received anything.
+    return false;
+  }
   {
-    rtc::CritScope cs(&stream_lock_);
-    if (clock_->CurrentNtpInMilliseconds() - last_receive_time_ntp_.ToMs() >=
-        kStatisticsTimeoutMs) {
-      // Not active.
-      return false;
-    }
-    if (received_seq_first_ == 0 &&
-        receive_counters_.transmitted.payload_bytes == 0) {
-      // We have not received anything.
-      return false;
-    }
-
-    *statistics = CalculateRtcpStatistics(/*update_fraction_lost=*/true);
+    rtc::CritScope cs(&report_lock_);
+    *statistics = CalculateRtcpStatistics(state, /*update_fraction_lost=*/true);
   }
 
   rtcp_callback_->StatisticsUpdated(*statistics, ssrc_);
@@ -199,15 +192,14 @@ bool StreamStatisticianImpl::GetActiveStatisticsAndReset(
 }
 
 RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics(
+    const ReceiveState& state,
     bool update_fraction_lost) {
-  RtcpStatistics statistics;
-
-  uint32_t extended_seq_max = (received_seq_wraps_ << 16) + received_seq_max_;
-
   if (update_fraction_lost) {
+    uint32_t extended_seq_max =
+        (state.received_seq_wraps << 16) + state.received_seq_max;
     if (last_report_received_packets_ == 0) {
       // First time we're calculating fraction lost.
-      last_report_extended_seq_max_ = received_seq_first_ - 1;
+      last_report_extended_seq_max_ = state.received_seq_first - 1;
     }
 
     uint32_t exp_since_last =
@@ -216,7 +208,7 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics(
     // Number of received RTP packets since last report; counts all packets
     // including retransmissions.
     uint32_t rec_since_last =
-        receive_counters_.transmitted.packets - last_report_received_packets_;
+        state.counters.transmitted.packets - last_report_received_packets_;
 
     // Calculate fraction lost according to RFC3550 Appendix A.3. Snap to 0 if
     // negative (which is possible with duplicate packets).
@@ -227,16 +219,27 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics(
           255 * (exp_since_last - rec_since_last) / exp_since_last);
     }
 
-    last_fraction_lost_ = local_fraction_lost;
-    last_report_received_packets_ = receive_counters_.transmitted.packets;
+    last_fraction_lost_.store(local_fraction_lost, std::memory_order_relaxed);
+    last_report_received_packets_ = state.counters.transmitted.packets;
     last_report_extended_seq_max_ = extended_seq_max;
   }
+  return CalculateRtcpStatistics(state);
+}
+
+RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics(
+    const ReceiveState& state) const {
+  RtcpStatistics statistics;
+
+  uint32_t extended_seq_max =
+      (state.received_seq_wraps << 16) + state.received_seq_max;
 
-  statistics.fraction_lost = last_fraction_lost_;
+  statistics.fraction_lost =
+      last_fraction_lost_.load(std::memory_order_relaxed);
   // Calculate cumulative loss, according to RFC3550 Appendix A.3.
-  uint32_t total_expected_packets = extended_seq_max - received_seq_first_ + 1;
+  uint32_t total_expected_packets =
+      extended_seq_max - state.received_seq_first + 1;
   statistics.packets_lost =
-      total_expected_packets - receive_counters_.transmitted.packets;
+      total_expected_packets - state.counters.transmitted.packets;
   // Since cumulative loss is carried in a signed 24-bit field in RTCP, we may
   // need to clamp it.
   statistics.packets_lost = std::min(statistics.packets_lost, 0x7fffff);
@@ -246,61 +249,67 @@ RtcpStatistics StreamStatisticianImpl::CalculateRtcpStatistics(
   statistics.packets_lost = std::max(statistics.packets_lost, 0);
   statistics.extended_highest_sequence_number = extended_seq_max;
   // Note: internal jitter value is in Q4 and needs to be scaled by 1/16.
-  statistics.jitter = jitter_q4_ >> 4;
+  statistics.jitter = state.jitter_q4 >> 4;
 
   BWE_TEST_LOGGING_PLOT_WITH_SSRC(1, "cumulative_loss_pkts",
                                   clock_->TimeInMilliseconds(),
                                   statistics.packets_lost, ssrc_);
   BWE_TEST_LOGGING_PLOT_WITH_SSRC(
       1, "received_seq_max_pkts", clock_->TimeInMilliseconds(),
-      (received_seq_max_ - received_seq_first_), ssrc_);
+      (state.received_seq_max - state.received_seq_first), ssrc_);
 
   return statistics;
 }
 
 void StreamStatisticianImpl::GetDataCounters(size_t* bytes_received,
                                              uint32_t* packets_received) const {
-  rtc::CritScope cs(&stream_lock_);
+  const StreamDataCounters counters = published_state_.Read().counters;
   if (bytes_received) {
-    *bytes_received = receive_counters_.transmitted.payload_bytes +
-                      receive_counters_.transmitted.header_bytes +
-                      receive_counters_.transmitted.padding_bytes;
+    *bytes_received = counters.transmitted.payload_bytes +
+                      counters.transmitted.header_bytes +
+                      counters.transmitted.padding_bytes;
   }
   if (packets_received) {
-    *packets_received = receive_counters_.transmitted.packets;
+    *packets_received = counters.transmitted.packets;
   }
 }
 
 void StreamStatisticianImpl::GetReceiveStreamDataCounters(
     StreamDataCounters* data_counters) const {
-  rtc::CritScope cs(&stream_lock_);
-  *data_counters = receive_counters_;
+  *data_counters = published_state_.Read().counters;
 }
 
 uint32_t StreamStatisticianImpl::BitrateReceived() const {
-  rtc::CritScope cs(&stream_lock_);
-  return incoming_bitrate_.Rate(clock_->TimeInMilliseconds()).value_or(0);
+  const ReceiveState state = published_state_.Read();
+  // Rate is only updated when packets arrive, so it is stale once they stop
+  // for longer than the rate window.
+  if (clock_->TimeInMilliseconds() - state.last_receive_time_ms >=
+      kStatisticsProcessIntervalMs) {
+    return 0;
+  }
+  return state.bitrate_bps;
 }
 
 bool StreamStatisticianImpl::IsRetransmitOfOldPacket(
     const RTPHeader& header) const {
-  rtc::CritScope cs(&stream_lock_);
-  if (InOrderPacketInternal(header.sequenceNumber)) {
+  const ReceiveState state = published_state_.Read();
+  if (InOrderPacket(state, header.sequenceNumber)) {
     return false;
   }
   uint32_t frequency_khz = header.payload_type_frequency / 1000;
   assert(frequency_khz > 0);
 
-  int64_t time_diff_ms = clock_->TimeInMilliseconds() - last_receive_time_ms_;
+  int64_t time_diff_ms =
+      clock_->TimeInMilliseconds() - state.last_receive_time_ms;
 
   // Diff in time stamp since last received in order.
-  uint32_t timestamp_diff = header.timestamp - last_received_timestamp_;
+  uint32_t timestamp_diff = header.timestamp - state.last_received_timestamp;
   uint32_t rtp_time_stamp_diff_ms = timestamp_diff / frequency_khz;
 
   int64_t max_delay_ms = 0;
 
   // Jitter standard deviation in samples.
-  float jitter_std = sqrt(static_cast<float>(jitter_q4_ >> 4));
+  float jitter_std = sqrt(static_cast<float>(state.jitter_q4 >> 4));
 
   // 2 times the standard deviation => 95% confidence.
   // And transform to milliseconds by dividing by the frequency in kHz.
@@ -313,18 +322,20 @@ bool StreamStatisticianImpl::IsRetransmitOfOldPacket(
   return time_diff_ms > rtp_time_stamp_diff_ms + max_delay_ms;
 }
 
-bool StreamStatisticianImpl::InOrderPacketInternal(
-    uint16_t sequence_number) const {
+bool StreamStatisticianImpl::InOrderPacket(const ReceiveState& state,
+                                           uint16_t sequence_number) const {
   // First packet is always in order.
-  if (receive_counters_.transmitted.packets == 0)
+  if (state.counters.transmitted.packets == 0)
     return true;
 
-  if (IsNewerSequenceNumber(sequence_number, received_seq_max_)) {
+  if (IsNewerSequenceNumber(sequence_number, state.received_seq_max)) {
     return true;
   } else {
     // If we have a restart of the remote side this packet is still in order.
     return !IsNewerSequenceNumber(
-        sequence_number, received_seq_max_ - max_reordering_threshold_);
+        sequence_number,
+        state.received_seq_max -
+            max_reordering_threshold_.load(std::memory_order_relaxed));
   }
 }
 
@@ -332,11 +343,51 @@ ReceiveStatistics* ReceiveStatistics::Create(Clock* clock) {
   return new ReceiveStatisticsImpl(clock);
 }
 
+ReceiveStatisticsImpl::StatisticianTable::StatisticianTable(size_t capacity)
+    : capacity_(capacity),
+      slots_(new std::atomic<StreamStatisticianImpl*>[capacity]) {
+  RTC_DCHECK_EQ(capacity & (capacity - 1), 0u);
+  for (size_t i = 0; i < capacity_; ++i)
+    slots_[i].store(nullptr, std::memory_order_relaxed);
+}
+
+ReceiveStatisticsImpl::StatisticianTable::~StatisticianTable() = default;
+
+size_t ReceiveStatisticsImpl::StatisticianTable::Index(uint32_t ssrc) const {
+  // Fibonacci hashing, ssrcs of one sender are often close to each other.
+  return ((ssrc * 2654435769u) >> 16) & (capacity_ - 1);
+}
+
+StreamStatisticianImpl* ReceiveStatisticsImpl::StatisticianTable::Find(
+    uint32_t ssrc) const {
+  for (size_t i = Index(ssrc);; i = (i + 1) & (capacity_ - 1)) {
+    StreamStatisticianImpl* statistician =
+        slots_[i].load(std::memory_order_acquire);
+    if (statistician == nullptr || statistician->ssrc() == ssrc)
+      return statistician;
+  }
+}
+
+void ReceiveStatisticsImpl::StatisticianTable::Insert(
+    StreamStatisticianImpl* statistician) {
+  RTC_DCHECK(!IsFull());
+  size_t i = Index(statistician->ssrc());
+  while (slots_[i].load(std::memory_order_relaxed) != nullptr)
+    i = (i + 1) & (capacity_ - 1);
+  slots_[i].store(statistician, std::memory_order_release);
+  ++size_;
+}
+
 ReceiveStatisticsImpl::ReceiveStatisticsImpl(Clock* clock)
     : clock_(clock),
       last_returned_ssrc_(0),
-      rtcp_stats_callback_(NULL),
-      rtp_stats_callback_(NULL) {}
+      statistician_table_(nullptr),
+      rtcp_stats_callback_(nullptr),
+      rtp_stats_callback_(nullptr) {
+  rtc::CritScope cs(&receive_statistics_lock_);
+  statistician_tables_.push_back(absl::make_unique<StatisticianTable>(16));
+  statistician_table_.store(statistician_tables_.back().get());
+}
 
 ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
   while (!statisticians_.empty()) {
@@ -345,48 +396,54 @@ ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
   }
 }
 
+StreamStatisticianImpl* ReceiveStatisticsImpl::GetOrCreateStatistician(
+    uint32_t ssrc) {
+  rtc::CritScope cs(&receive_statistics_lock_);
+  StreamStatisticianImpl*& impl = statisticians_[ssrc];
+  if (impl != nullptr)
+    return impl;
+  impl = new StreamStatisticianImpl(ssrc, clock_, this, this);
+  StatisticianTable* table =
+      statistician_table_.load(std::memory_order_relaxed);
+  if (table->IsFull()) {
+    statistician_tables_.push_back(
+        absl::make_unique<StatisticianTable>(2 * table->capacity()));
+    table = statistician_tables_.back().get();
+    for (const auto& it : statisticians_) {
+      if (it.second != impl)
+        table->Insert(it.second);
+    }
+  }
+  table->Insert(impl);
+  statistician_table_.store(table, std::memory_order_release);
+  return impl;
+}
+
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            size_t packet_length,
                                            bool retransmitted) {
-  StreamStatisticianImpl* impl;
-  {
-    rtc::CritScope cs(&receive_statistics_lock_);
-    auto it = statisticians_.find(header.ssrc);
-    if (it != statisticians_.end()) {
-      impl = it->second;
-    } else {
-      impl = new StreamStatisticianImpl(header.ssrc, clock_, this, this);
-      statisticians_[header.ssrc] = impl;
-    }
-  }
+  StreamStatisticianImpl* impl =
+      statistician_table_.load(std::memory_order_acquire)->Find(header.ssrc);
+  if (impl == nullptr)
+    impl = GetOrCreateStatistician(header.ssrc);
   // StreamStatisticianImpl instance is created once and only destroyed when
-  // this whole ReceiveStatisticsImpl is destroyed. StreamStatisticianImpl has
-  // it's own locking so don't hold receive_statistics_lock_ (potential
-  // deadlock).
+  // this whole ReceiveStatisticsImpl is destroyed.
   impl->IncomingPacket(header, packet_length, retransmitted);
 }
 
 void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
                                               size_t packet_length) {
-  StreamStatisticianImpl* impl;
-  {
-    rtc::CritScope cs(&receive_statistics_lock_);
-    auto it = statisticians_.find(header.ssrc);
-    // Ignore FEC if it is the first packet.
-    if (it == statisticians_.end())
-      return;
-    impl = it->second;
-  }
+  StreamStatisticianImpl* impl =
+      statistician_table_.load(std::memory_order_acquire)->Find(header.ssrc);
+  // Ignore FEC if it is the first packet.
+  if (impl == nullptr)
+    return;
   impl->FecPacketReceived(header, packet_length);
 }
 
 StreamStatistician* ReceiveStatisticsImpl::GetStatistician(
     uint32_t ssrc) const {
-  rtc::CritScope cs(&receive_statistics_lock_);
-  auto it = statisticians_.find(ssrc);
-  if (it == statisticians_.end())
-    return NULL;
-  return it->second;
+  return statistician_table_.load(std::memory_order_acquire)->Find(ssrc);
 }
 
 void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
@@ -399,38 +456,36 @@ void ReceiveStatisticsImpl::SetMaxReorderingThreshold(
 
 void ReceiveStatisticsImpl::RegisterRtcpStatisticsCallback(
     RtcpStatisticsCallback* callback) {
-  rtc::CritScope cs(&receive_statistics_lock_);
   if (callback != NULL)
-    assert(rtcp_stats_callback_ == NULL);
-  rtcp_stats_callback_ = callback;
+    assert(rtcp_stats_callback_.load() == NULL);
+  rtcp_stats_callback_.store(callback);
 }
 
 void ReceiveStatisticsImpl::StatisticsUpdated(const RtcpStatistics& statistics,
                                               uint32_t ssrc) {
-  rtc::CritScope cs(&receive_statistics_lock_);
-  if (rtcp_stats_callback_)
-    rtcp_stats_callback_->StatisticsUpdated(statistics, ssrc);
+  RtcpStatisticsCallback* callback = rtcp_stats_callback_.load();
+  if (callback)
+    callback->StatisticsUpdated(statistics, ssrc);
 }
 
 void ReceiveStatisticsImpl::CNameChanged(const char* cname, uint32_t ssrc) {
-  rtc::CritScope cs(&receive_statistics_lock_);
-  if (rtcp_stats_callback_)
-    rtcp_stats_callback_->CNameChanged(cname, ssrc);
+  RtcpStatisticsCallback* callback = rtcp_stats_callback_.load();
+  if (callback)
+    callback->CNameChanged(cname, ssrc);
 }
 
 void ReceiveStatisticsImpl::RegisterRtpStatisticsCallback(
     StreamDataCountersCallback* callback) {
-  rtc::CritScope cs(&receive_statistics_lock_);
   if (callback != NULL)
-    assert(rtp_stats_callback_ == NULL);
-  rtp_stats_callback_ = callback;
+    assert(rtp_stats_callback_.load() == NULL);
+  rtp_stats_callback_.store(callback);
 }
 
 void ReceiveStatisticsImpl::DataCountersUpdated(const StreamDataCounters& stats,
                                                 uint32_t ssrc) {
-  rtc::CritScope cs(&receive_statistics_lock_);
-  if (rtp_stats_callback_) {
-    rtp_stats_callback_->DataCountersUpdated(stats, ssrc);
+  StreamDataCountersCallback* callback = rtp_stats_callback_.load();
+  if (callback) {
+    callback->DataCountersUpdated(stats, ssrc);
   }
 }
 
@@ -16,15 +16,23 @@
 #include <math.h>
 
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/race_checker.h"
 #include "rtc_base/rate_statistics.h"
+#include "rtc_base/synchronization/sequence_lock.h"
 #include "system_wrappers/include/ntp_time.h"
 
 namespace webrtc {
 
+// Statistics of one received rtp stream. IncomingPacket() and
+// FecPacketReceived() must be called on one thread at a time, and take no
+// locks: they update the state privately and then publish a copy of it, which
+// all the getters read without blocking the packet path.
 class StreamStatisticianImpl : public StreamStatistician {
  public:
   StreamStatisticianImpl(uint32_t ssrc,
@@ -33,6 +41,8 @@ class StreamStatisticianImpl : public StreamStatistician {
                          StreamDataCountersCallback* rtp_callback);
   ~StreamStatisticianImpl() override;
 
+  uint32_t ssrc() const { return ssrc_; }
+
   bool GetStatistics(RtcpStatistics* statistics,
                      bool update_fraction_lost) override;
   bool GetActiveStatisticsAndReset(RtcpStatistics* statistics);
@@ -50,42 +60,55 @@ class StreamStatisticianImpl : public StreamStatistician {
   void SetMaxReorderingThreshold(int max_reordering_threshold);
 
  private:
-  bool InOrderPacketInternal(uint16_t sequence_number) const
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(stream_lock_);
-  RtcpStatistics CalculateRtcpStatistics(bool update_fraction_lost)
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(stream_lock_);
+  // Everything the getters need to know about received packets.
+  struct ReceiveState {
+    StreamDataCounters counters;
+    uint32_t jitter_q4 = 0;
+    uint16_t received_seq_first = 0;
+    uint16_t received_seq_max = 0;
+    uint16_t received_seq_wraps = 0;
+    uint32_t last_received_timestamp = 0;
+    int64_t last_receive_time_ms = 0;
+    int64_t last_receive_time_ntp_ms = 0;
+    // Bitrate as of the last received packet.
+    uint32_t bitrate_bps = 0;
+  };
+
+  bool InOrderPacket(const ReceiveState& state,
+                     uint16_t sequence_number) const;
+  RtcpStatistics CalculateRtcpStatistics(const ReceiveState& state,
+                                         bool update_fraction_lost)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(report_lock_);
+  // Computes statistics for the per packet callback, leaving fraction lost
+  // as of the last report.
+  RtcpStatistics CalculateRtcpStatistics(const ReceiveState& state) const;
   void UpdateJitter(const RTPHeader& header, NtpTime receive_time);
-  StreamDataCounters UpdateCounters(const RTPHeader& rtp_header,
-                                    size_t packet_length,
-                                    bool retransmitted)
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(stream_lock_);
+  void UpdateCounters(const RTPHeader& rtp_header,
+                      size_t packet_length,
+                      bool retransmitted);
 
   const uint32_t ssrc_;
   Clock* const clock_;
-  rtc::CriticalSection stream_lock_;
-  RateStatistics incoming_bitrate_;
-  int max_reordering_threshold_;  // In number of packets or sequence numbers.
-
-  // Stats on received RTP packets.
-  uint32_t jitter_q4_;
+  std::atomic<int> max_reordering_threshold_;  // In number of packets or
+                                               // sequence numbers.
 
-  int64_t last_receive_time_ms_;
-  NtpTime last_receive_time_ntp_;
-  uint32_t last_received_timestamp_;
-  uint16_t received_seq_first_;
-  uint16_t received_seq_max_;
-  uint16_t received_seq_wraps_;
+  // Only accessed by the thread receiving packets.
+  rtc::RaceChecker packet_race_checker_;
+  RateStatistics incoming_bitrate_ RTC_GUARDED_BY(packet_race_checker_);
+  ReceiveState state_ RTC_GUARDED_BY(packet_race_checker_);
+  NtpTime last_receive_time_ntp_ RTC_GUARDED_BY(packet_race_checker_);
+  size_t received_packet_overhead_ RTC_GUARDED_BY(packet_race_checker_);
 
-  // Current counter values.
-  size_t received_packet_overhead_;
-  StreamDataCounters receive_counters_ RTC_GUARDED_BY(stream_lock_);
+  // Copy of |state_| for the getters.
+  rtc::SequenceLocked<ReceiveState> published_state_;
 
   // Used to calculate fraction_lost between reports.
-  uint32_t last_report_received_packets_ = 0;
-  uint32_t last_report_extended_seq_max_ = 0;
-  uint8_t last_fraction_lost_ = 0;
+  rtc::CriticalSection report_lock_;
+  uint32_t last_report_received_packets_ RTC_GUARDED_BY(report_lock_) = 0;
+  uint32_t last_report_extended_seq_max_ RTC_GUARDED_BY(report_lock_) = 0;
+  std::atomic<uint8_t> last_fraction_lost_;
 
-  // stream_lock_ shouldn't be held when calling callbacks.
+  // report_lock_ shouldn't be held when calling callbacks.
   RtcpStatisticsCallback* const rtcp_callback_;
   StreamDataCountersCallback* const rtp_callback_;
 };
@@ -110,6 +133,8 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
   StreamStatistician* GetStatistician(uint32_t ssrc) const override;
   void SetMaxReorderingThreshold(int max_reordering_threshold) override;
 
+  // Callbacks are expected to be registered before packets are received and
+  // unregistered after, they are invoked without locking.
   void RegisterRtcpStatisticsCallback(
       RtcpStatisticsCallback* callback) override;
 
@@ -117,19 +142,49 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
       StreamDataCountersCallback* callback) override;
 
  private:
+  // Open addressing table of statisticians keyed by their ssrc, that can be
+  // searched without locking. Statisticians are never removed, and when the
+  // table gets full it is replaced by a larger copy.
+  class StatisticianTable {
+   public:
+    explicit StatisticianTable(size_t capacity);
+    ~StatisticianTable();
+
+    StreamStatisticianImpl* Find(uint32_t ssrc) const;
+    // Must be called with |receive_statistics_lock_| held.
+    void Insert(StreamStatisticianImpl* statistician);
+    bool IsFull() const { return 2 * (size_ + 1) > capacity_; }
+    size_t capacity() const { return capacity_; }
+
+   private:
+    size_t Index(uint32_t ssrc) const;
+
+    const size_t capacity_;
+    size_t size_ = 0;
+    const std::unique_ptr<std::atomic<StreamStatisticianImpl*>[]> slots_;
+  };
+
   void StatisticsUpdated(const RtcpStatistics& statistics,
                          uint32_t ssrc) override;
   void CNameChanged(const char* cname, uint32_t ssrc) override;
   void DataCountersUpdated(const StreamDataCounters& counters,
                            uint32_t ssrc) override;
 
+  // Returns the statistician for |ssrc|, creating one if needed.
+  StreamStatisticianImpl* GetOrCreateStatistician(uint32_t ssrc);
+
   Clock* const clock_;
   rtc::CriticalSection receive_statistics_lock_;
   uint32_t last_returned_ssrc_;
-  std::map<uint32_t, StreamStatisticianImpl*> statisticians_;
-
-  RtcpStatisticsCallback* rtcp_stats_callback_;
-  StreamDataCountersCallback* rtp_stats_callback_;
+  std::map<uint32_t, StreamStatisticianImpl*> statisticians_
+      RTC_GUARDED_BY(receive_statistics_lock_);
+  std::atomic<StatisticianTable*> statistician_table_;
+  // All tables ever published, since readers may still search the old ones.
+  std::vector<std::unique_ptr<StatisticianTable>> statistician_tables_
+      RTC_GUARDED_BY(receive_statistics_lock_);
+
+  std::atomic<RtcpStatisticsCallback*> rtcp_stats_callback_;
+  std::atomic<StreamDataCountersCallback*> rtp_stats_callback_;
 };
 }  // namespace webrtc
 #endif  // MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_IMPL_H_
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "modules/rtp_rtcp/include/receive_statistics.h"
+#include "rtc_base/platform_thread.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -190,6 +191,54 @@ TEST_F(ReceiveStatisticsTest, GetReceiveStreamDataCounters) {
   EXPECT_EQ(2u, counters.transmitted.packets);
 }
 
+TEST_F(ReceiveStatisticsTest, TracksManyStreams) {
+  const int kNumStreams = 100;
+  for (int i = 0; i < kNumStreams; ++i) {
+    receive_statistics_->IncomingPacket(CreateRtpHeader(1000 + 7 * i),
+                                        kPacketSize1, false);
+  }
+  for (int i = 0; i < kNumStreams; ++i) {
+    StreamStatistician* statistician =
+        receive_statistics_->GetStatistician(1000 + 7 * i);
+    ASSERT_TRUE(statistician != NULL);
+    StreamDataCounters counters;
+    statistician->GetReceiveStreamDataCounters(&counters);
+    EXPECT_EQ(1u, counters.transmitted.packets);
+  }
+  EXPECT_TRUE(receive_statistics_->GetStatistician(1001) == NULL);
+}
+
+void ReceivePackets(void* obj) {
+  ReceiveStatistics* receive_statistics = static_cast<ReceiveStatistics*>(obj);
+  RTPHeader header = CreateRtpHeader(kSsrc1);
+  for (int i = 0; i < 10000; ++i) {
+    receive_statistics->IncomingPacket(header, kPacketSize1, false);
+    ++header.sequenceNumber;
+  }
+}
+
+TEST_F(ReceiveStatisticsTest, ReadsConsistentCountersWhilePacketsArrive) {
+  // Create the statistician before starting the thread to check it.
+  receive_statistics_->IncomingPacket(header1_, kPacketSize1, false);
+  StreamStatistician* statistician =
+      receive_statistics_->GetStatistician(kSsrc1);
+  ASSERT_TRUE(statistician != NULL);
+  rtc::PlatformThread thread(&ReceivePackets, receive_statistics_.get(),
+                             "ReceivePackets");
+  thread.Start();
+
+  uint32_t packets_received = 0;
+  while (packets_received < 10001) {
+    size_t bytes_received = 0;
+    uint32_t packets = 0;
+    statistician->GetDataCounters(&bytes_received, &packets);
+    ASSERT_EQ(packets * kPacketSize1, bytes_received);
+    ASSERT_GE(packets, packets_received);
+    packets_received = packets;
+  }
+  thread.Stop();
+}
+
 class MockRtcpCallback : public RtcpStatisticsCallback {
  public:
   MOCK_METHOD2(StatisticsUpdated,
@@ -70,6 +70,50 @@ constexpr int64_t kTimeWrapPeriodUs = (1ll << 24) * kBaseScaleFactor;
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 //    |           recv delta          |  recv delta   | zero padding  |
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+int PopCount(uint32_t bits) {
+  bits = bits - ((bits >> 1) & 0x5555);
+  bits = (bits & 0x3333) + ((bits >> 2) & 0x3333);
+  bits = (bits + (bits >> 4)) & 0x0f0f;
+  return (bits + (bits >> 8)) & 0x1f;
+}
+
+// Returns in |*count| how many packet statuses, at most |max_count|, |chunk|
+// holds, and adds the number of received packets among them and the size of
+// their receive deltas to |*num_received| and |*delta_bytes|. Status vectors
+// are measured as a whole, with bit operations on the symbol list. Returns
+// false if one of the statuses is invalid.
+bool MeasureChunk(uint16_t chunk,
+                  size_t max_count,
+                  size_t* count,
+                  size_t* num_received,
+                  size_t* delta_bytes) {
+  if ((chunk & 0x8000) == 0) {
+    // Run length chunk.
+    *count = std::min<size_t>(chunk & 0x1fff, max_count);
+    const size_t delta_size = (chunk >> 13) & 0x03;
+    if (*count > 0 && delta_size == 3)
+      return false;
+    if (delta_size > 0)
+      *num_received += *count;
+    *delta_bytes += *count * delta_size;
+  } else if ((chunk & 0x4000) == 0) {
+    // One bit status vector chunk, the set bits are the received packets.
+    *count = std::min<size_t>(14, max_count);
+    const int received = PopCount((chunk & 0x3fff) >> (14 - *count));
+    *num_received += received;
+    *delta_bytes += received;
+  } else {
+    // Two bit status vector chunk, the symbols are the delta sizes.
+    *count = std::min<size_t>(7, max_count);
+    const uint32_t symbols = (chunk & 0x3fff) >> (2 * (7 - *count));
+    if ((symbols & (symbols >> 1) & 0x1555) != 0)
+      return false;
+    *num_received += PopCount((symbols | (symbols >> 1)) & 0x1555);
+    *delta_bytes += PopCount(symbols & 0x1555) + 2 * PopCount(symbols & 0x2aaa);
+  }
+  return true;
+}
 }  // namespace
 constexpr uint8_t TransportFeedback::kFeedbackMessageType;
 constexpr size_t TransportFeedback::kMaxReportedPackets;
@@ -378,62 +422,100 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     return false;
   }
 
-  std::vector<uint8_t> delta_sizes;
-  delta_sizes.reserve(status_count);
-  while (delta_sizes.size() < status_count) {
+  // Walk the chunks once to find where the receive deltas start and check
+  // that all of them are in the packet, so that they can then be decoded
+  // without further checks.
+  const size_t chunks_index = index;
+  size_t num_statuses = 0;
+  size_t num_received = 0;
+  size_t delta_bytes = 0;
+  uint16_t chunk = 0;
+  size_t last_chunk_max_count = 0;
+  while (num_statuses < status_count) {
     if (index + kChunkSizeBytes > end_index) {
       RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
       Clear();
       return false;
     }
 
-    uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
+    chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
     index += kChunkSizeBytes;
-    encoded_chunks_.push_back(chunk);
-    last_chunk_.Decode(chunk, status_count - delta_sizes.size());
-    last_chunk_.AppendTo(&delta_sizes);
+    last_chunk_max_count = status_count - num_statuses;
+    size_t count = 0;
+    if (!MeasureChunk(chunk, last_chunk_max_count, &count, &num_received,
+                      &delta_bytes)) {
+      RTC_LOG(LS_WARNING) << "Invalid delta_size in chunk " << chunk;
+      Clear();
+      return false;
+    }
+    num_statuses += count;
   }
-  // Last chunk is stored in the |last_chunk_|.
-  encoded_chunks_.pop_back();
-  RTC_DCHECK_EQ(delta_sizes.size(), status_count);
+  const size_t deltas_index = index;
+  if (deltas_index + delta_bytes > end_index) {
+    RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
+    Clear();
+    return false;
+  }
+  RTC_DCHECK_EQ(num_statuses, status_count);
   num_seq_no_ = status_count;
 
+  // Last chunk is stored in the |last_chunk_|.
+  encoded_chunks_.resize((deltas_index - chunks_index) / kChunkSizeBytes - 1);
+  for (size_t i = 0; i < encoded_chunks_.size(); ++i) {
+    encoded_chunks_[i] = ByteReader<uint16_t>::ReadBigEndian(
+        &payload[chunks_index + i * kChunkSizeBytes]);
+  }
+  last_chunk_.Decode(chunk, last_chunk_max_count);
+
+  // Decode the deltas straight from the chunks, skipping runs of packets that
+  // were not received as a whole.
+  packets_.reserve(num_received);
+  const uint8_t* delta_ptr = &payload[deltas_index];
+  auto add_received_packet = [this, &delta_ptr](uint16_t seq_no,
+                                                DeltaSize delta_size) {
+    int16_t delta = delta_size == 1
+                        ? *delta_ptr
+                        : ByteReader<int16_t>::ReadBigEndian(delta_ptr);
+    packets_.emplace_back(seq_no, delta);
+    last_timestamp_us_ += delta * kDeltaScaleFactor;
+    delta_ptr += delta_size;
+  };
   uint16_t seq_no = base_seq_no_;
-  for (size_t delta_size : delta_sizes) {
-    if (index + delta_size > end_index) {
-      RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
-      Clear();
-      return false;
-    }
-    switch (delta_size) {
-      case 0:
-        break;
-      case 1: {
-        int16_t delta = payload[index];
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
+  size_t remaining = status_count;
+  for (index = chunks_index; index < deltas_index; index += kChunkSizeBytes) {
+    chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
+    if ((chunk & 0x8000) == 0) {
+      const size_t count = std::min<size_t>(chunk & 0x1fff, remaining);
+      const DeltaSize delta_size = (chunk >> 13) & 0x03;
+      if (delta_size == 0) {
+        seq_no += count;
+      } else {
+        for (size_t i = 0; i < count; ++i)
+          add_received_packet(seq_no++, delta_size);
       }
-      case 2: {
-        int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
+      remaining -= count;
+    } else if ((chunk & 0x4000) == 0) {
+      const size_t count = std::min<size_t>(14, remaining);
+      for (size_t i = 0; i < count; ++i, ++seq_no) {
+        if ((chunk >> (13 - i)) & 0x01)
+          add_received_packet(seq_no, 1);
       }
-      case 3:
-        Clear();
-        RTC_LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
-        return false;
-      default:
-        RTC_NOTREACHED();
-        break;
+      remaining -= count;
+    } else {
+      const size_t count = std::min<size_t>(7, remaining);
+      for (size_t i = 0; i < count; ++i, ++seq_no) {
+        const DeltaSize delta_size = (chunk >> 2 * (6 - i)) & 0x03;
+        if (delta_size != 0)
+          add_received_packet(seq_no, delta_size);
+      }
+      remaining -= count;
     }
-    ++seq_no;
   }
-  size_bytes_ = RtcpPacket::kHeaderLength + index;
-  RTC_DCHECK_LE(index, end_index);
+  RTC_DCHECK_EQ(remaining, 0);
+  RTC_DCHECK_EQ(packets_.size(), num_received);
+  RTC_DCHECK_EQ(delta_ptr, &payload[deltas_index + delta_bytes]);
+  size_bytes_ = RtcpPacket::kHeaderLength + deltas_index + delta_bytes;
+  RTC_DCHECK_LE(deltas_index + delta_bytes, end_index);
   return true;
 }
 
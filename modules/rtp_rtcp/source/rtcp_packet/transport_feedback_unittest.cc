@@ -15,6 +15,7 @@
 #include <utility>
 
 #include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -464,6 +465,78 @@ TEST(RtcpPacketTest, TransportFeedback_CorrectlySplitsVectorChunks) {
   }
 }
 
+TEST(RtcpPacketTest, TransportFeedback_ParseIntoReusedPacket) {
+  const int64_t kLargeTimeDelta =
+      TransportFeedback::kDeltaScaleFactor * (1 << 8);
+  TransportFeedback large;
+  large.SetBase(100, 0);
+  for (int i = 0; i < 200; i += 3)
+    large.AddReceivedPacket(100 + i, i * kLargeTimeDelta);
+  TransportFeedback small;
+  small.SetBase(7, 0);
+  small.AddReceivedPacket(7, 1000);
+  small.AddReceivedPacket(9, 2000);
+  rtc::Buffer large_packet = large.Build();
+  rtc::Buffer small_packet = small.Build();
+
+  TransportFeedback reused;
+  rtcp::CommonHeader header;
+  ASSERT_TRUE(header.Parse(large_packet.data(), large_packet.size()));
+  ASSERT_TRUE(reused.Parse(header));
+  EXPECT_EQ(large.GetReceivedPackets().size(),
+            reused.GetReceivedPackets().size());
+  ASSERT_TRUE(header.Parse(small_packet.data(), small_packet.size()));
+  ASSERT_TRUE(reused.Parse(header));
+  EXPECT_TRUE(reused.IsConsistent());
+  EXPECT_EQ(7, reused.GetBaseSequence());
+  ASSERT_EQ(2u, reused.GetReceivedPackets().size());
+  EXPECT_EQ(9, reused.GetReceivedPackets()[1].sequence_number());
+  EXPECT_EQ(small_packet, reused.Build());
+}
+
+TEST(RtcpPacketTest, TransportFeedback_RejectsInvalidDeltaSize) {
+  const int64_t kLargeTimeDelta =
+      TransportFeedback::kDeltaScaleFactor * (1 << 8);
+  TransportFeedback feedback;
+  feedback.SetBase(0, 0);
+  feedback.AddReceivedPacket(0, 1000);
+  feedback.AddReceivedPacket(1, 1000 + kLargeTimeDelta);
+  rtc::Buffer packet = feedback.Build();
+  ASSERT_TRUE(TransportFeedback::ParseFrom(packet.data(), packet.size()));
+
+  // Two bit status vector chunk, with the reserved symbol for the 2nd packet.
+  ByteWriter<uint16_t>::WriteBigEndian(&packet.data()[kHeaderSize],
+                                       0xc000 | (1 << 12) | (3 << 10));
+  EXPECT_FALSE(TransportFeedback::ParseFrom(packet.data(), packet.size()));
+  // It is fine beyond the packet status count.
+  ByteWriter<uint16_t>::WriteBigEndian(&packet.data()[kHeaderSize],
+                                       0xc000 | (1 << 12) | (2 << 10) | 3);
+  EXPECT_TRUE(TransportFeedback::ParseFrom(packet.data(), packet.size()));
+}
+
+TEST(RtcpPacketTest, TransportFeedback_RejectsTruncatedDeltas) {
+  TransportFeedback feedback;
+  feedback.SetBase(0, 0);
+  feedback.AddReceivedPacket(0, 1000);
+  rtc::Buffer packet = feedback.Build();
+  ASSERT_TRUE(TransportFeedback::ParseFrom(packet.data(), packet.size()));
+
+  // Claim a run of 8 small deltas, which don't fit in the padded packet.
+  const size_t kStatusCountOffset = 14;
+  ByteWriter<uint16_t>::WriteBigEndian(&packet.data()[kStatusCountOffset], 8);
+  ByteWriter<uint16_t>::WriteBigEndian(&packet.data()[kHeaderSize],
+                                       (1 << 13) | 8);
+  EXPECT_FALSE(TransportFeedback::ParseFrom(packet.data(), packet.size()));
+  // Missing packets need no deltas.
+  ByteWriter<uint16_t>::WriteBigEndian(&packet.data()[kHeaderSize],
+                                       0x8000 | (1 << 13));
+  std::unique_ptr<TransportFeedback> parsed =
+      TransportFeedback::ParseFrom(packet.data(), packet.size());
+  ASSERT_TRUE(parsed);
+  EXPECT_EQ(8u, parsed->GetPacketStatusCount());
+  EXPECT_EQ(1u, parsed->GetReceivedPackets().size());
+}
+
 TEST(RtcpPacketTest, TransportFeedback_MoveConstructor) {
   const int kSamples = 100;
   const int64_t kDelta = TransportFeedback::kDeltaScaleFactor;
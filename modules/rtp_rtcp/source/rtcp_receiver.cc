@@ -166,6 +166,12 @@ void RTCPReceiver::IncomingPacket(const uint8_t* packet, size_t packet_size) {
   if (!ParseCompoundPacket(packet, packet + packet_size, &packet_information))
     return;
   TriggerCallbacksFromRtcpPacket(packet_information);
+
+  if (packet_information.transport_feedback) {
+    rtc::CritScope lock(&rtcp_receiver_lock_);
+    reusable_transport_feedback_ =
+        std::move(packet_information.transport_feedback);
+  }
 }
 
 int64_t RTCPReceiver::LastReceivedReportBlockMs() const {
@@ -907,14 +913,24 @@ void RTCPReceiver::HandleFir(const CommonHeader& rtcp_block,
 void RTCPReceiver::HandleTransportFeedback(
     const CommonHeader& rtcp_block,
     PacketInformation* packet_information) {
-  std::unique_ptr<rtcp::TransportFeedback> transport_feedback(
-      new rtcp::TransportFeedback());
+  // Parse into the storage of a previous feedback when possible, that saves
+  // reallocating its packet vectors for every feedback.
+  std::unique_ptr<rtcp::TransportFeedback> transport_feedback =
+      std::move(reusable_transport_feedback_);
+  if (!transport_feedback)
+    transport_feedback.reset(new rtcp::TransportFeedback());
   if (!transport_feedback->Parse(rtcp_block)) {
+    reusable_transport_feedback_ = std::move(transport_feedback);
     ++num_skipped_packets_;
     return;
   }
 
   packet_information->packet_type_flags |= kRtcpTransportFeedback;
+  // A compound packet with several transport feedbacks only delivers the last.
+  if (packet_information->transport_feedback) {
+    reusable_transport_feedback_ =
+        std::move(packet_information->transport_feedback);
+  }
   packet_information->transport_feedback = std::move(transport_feedback);
 }
 
@@ -13,6 +13,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -32,6 +33,7 @@ class ReportBlock;
 class Rrtr;
 class TargetBitrate;
 class TmmbItem;
+class TransportFeedback;
 }  // namespace rtcp
 
 class RTCPReceiver {
@@ -248,6 +250,10 @@ class RTCPReceiver {
       RTC_GUARDED_BY(rtcp_receiver_lock_);
   std::map<uint32_t, std::string> received_cnames_
       RTC_GUARDED_BY(rtcp_receiver_lock_);
+  // Transport feedback that has been delivered, kept to parse the next one
+  // into without allocating.
+  std::unique_ptr<rtcp::TransportFeedback> reusable_transport_feedback_
+      RTC_GUARDED_BY(rtcp_receiver_lock_);
 
   // The last time we received an RTCP Report block for this module.
   int64_t last_received_rb_ms_ RTC_GUARDED_BY(rtcp_receiver_lock_);
@@ -47,6 +47,7 @@ using ::testing::_;
 using ::testing::AllOf;
 using ::testing::ElementsAreArray;
 using ::testing::Field;
+using ::testing::Invoke;
 using ::testing::IsEmpty;
 using ::testing::NiceMock;
 using ::testing::Property;
@@ -1206,6 +1207,38 @@ TEST_F(RtcpReceiverTest, ReceivesTransportFeedback) {
   InjectRtcpPacket(packet);
 }
 
+TEST_F(RtcpReceiverTest, ReceivesConsecutiveTransportFeedbacks) {
+  rtcp::TransportFeedback first;
+  first.SetMediaSsrc(kReceiverMainSsrc);
+  first.SetSenderSsrc(kSenderSsrc);
+  first.SetBase(1, 1000);
+  for (uint16_t seq = 1; seq < 50; ++seq)
+    first.AddReceivedPacket(seq, 1000 + seq * 1000);
+  rtcp::TransportFeedback second;
+  second.SetMediaSsrc(kReceiverMainSsrc);
+  second.SetSenderSsrc(kSenderSsrc);
+  second.SetBase(50, 60000);
+  second.AddReceivedPacket(52, 61000);
+
+  EXPECT_CALL(transport_feedback_observer_,
+              OnTransportFeedback(Property(
+                  &rtcp::TransportFeedback::GetBaseSequence, 1)));
+  InjectRtcpPacket(first);
+
+  // The second feedback may be parsed into the storage of the first one, it
+  // must not carry anything over from it.
+  std::vector<rtcp::TransportFeedback::ReceivedPacket> received;
+  EXPECT_CALL(transport_feedback_observer_, OnTransportFeedback(_))
+      .WillOnce(Invoke([&](const rtcp::TransportFeedback& feedback) {
+        EXPECT_EQ(50, feedback.GetBaseSequence());
+        EXPECT_EQ(3u, feedback.GetPacketStatusCount());
+        received = feedback.GetReceivedPackets();
+      }));
+  InjectRtcpPacket(second);
+  ASSERT_EQ(1u, received.size());
+  EXPECT_EQ(52, received[0].sequence_number());
+}
+
 TEST_F(RtcpReceiverTest, ReceivesRemb) {
   const uint32_t kBitrateBps = 500000;
   rtcp::Remb remb;
@@ -58,11 +58,20 @@ bool RtcpTransceiverConfig::Validate() const {
                       << "ms between reports should be positive.";
     return false;
   }
+  if (rtcp_bitrate_bps < 0) {
+    RTC_LOG(LS_ERROR) << debug_id << "rtcp bitrate " << rtcp_bitrate_bps
+                      << "bps shouldn't be negative.";
+    return false;
+  }
   if (schedule_periodic_compound_packets && !task_queue) {
     RTC_LOG(LS_ERROR) << debug_id
                       << "missing task queue for periodic compound packets";
     return false;
   }
+  if (batch_feedback && !task_queue) {
+    RTC_LOG(LS_ERROR) << debug_id << "missing task queue for batched feedback";
+    return false;
+  }
   if (rtcp_mode != RtcpMode::kCompound && rtcp_mode != RtcpMode::kReducedSize) {
     RTC_LOG(LS_ERROR) << debug_id << "unsupported rtcp mode";
     return false;
@@ -90,10 +90,22 @@ struct RtcpTransceiverConfig {
   // Period between periodic compound packets.
   int report_period_ms = 1000;
 
+  // Bandwidth available for rtcp, e.g. receivers share of the 5% of the
+  // session bandwidth, see https://tools.ietf.org/html/rfc3550#section-6.2
+  // When positive, periodic compound packets are sent less often than every
+  // |report_period_ms| when they are too large for it. Zero means no limit.
+  int rtcp_bitrate_bps = 0;
+
   //
   // Flags for features and experiments.
   //
   bool schedule_periodic_compound_packets = true;
+  // Instead of sending every NACK, PLI and FIR in own rtcp packet, collect
+  // them until the currently running task on the |task_queue| ends and send
+  // them together, e.g. when several receive streams request feedback in
+  // response to the same incoming packets. In compound mode all of them share
+  // single set of receiver reports, sdes and remb.
+  bool batch_feedback = false;
   // Estimate RTT as non-sender as described in
   // https://tools.ietf.org/html/rfc3611#section-4.4 and #section-4.5
   bool non_sender_rtt_measurement = false;
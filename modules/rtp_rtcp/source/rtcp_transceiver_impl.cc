@@ -10,6 +10,7 @@
 
 #include "modules/rtp_rtcp/source/rtcp_transceiver_impl.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "absl/memory/memory.h"
@@ -37,6 +38,26 @@
 namespace webrtc {
 namespace {
 
+// Size of the receiver report without report blocks: rtcp common header and
+// sender ssrc.
+constexpr size_t kReceiverReportBaseSize = 8;
+
+// Returns number of report blocks that fit into |bytes| together with the
+// receiver reports needed to carry them.
+size_t MaxReportBlocks(size_t bytes) {
+  constexpr size_t kFullReceiverReportSize =
+      kReceiverReportBaseSize +
+      rtcp::ReceiverReport::kMaxNumberOfReportBlocks *
+          rtcp::ReportBlock::kLength;
+  size_t num_blocks = (bytes / kFullReceiverReportSize) *
+                      rtcp::ReceiverReport::kMaxNumberOfReportBlocks;
+  size_t remaining_bytes = bytes % kFullReceiverReportSize;
+  if (remaining_bytes > kReceiverReportBaseSize)
+    num_blocks += (remaining_bytes - kReceiverReportBaseSize) /
+                  rtcp::ReportBlock::kLength;
+  return num_blocks;
+}
+
 struct SenderReportTimes {
   int64_t local_received_time_us;
   NtpTime remote_sent_time;
@@ -56,9 +77,8 @@ struct RtcpTransceiverImpl::RemoteSenderState {
 // compound RTCP packets need to be generated, ensure each packet is compound.
 class RtcpTransceiverImpl::PacketSender {
  public:
-  PacketSender(rtcp::RtcpPacket::PacketReadyCallback callback,
-               size_t max_packet_size)
-      : callback_(callback), max_packet_size_(max_packet_size) {
+  PacketSender(Transport* transport, size_t max_packet_size)
+      : transport_(transport), max_packet_size_(max_packet_size) {
     RTC_CHECK_LE(max_packet_size, IP_PACKET_SIZE);
   }
   ~PacketSender() { RTC_DCHECK_EQ(index_, 0) << "Unsent rtcp packet."; }
@@ -66,21 +86,27 @@ class RtcpTransceiverImpl::PacketSender {
   // Appends a packet to pending compound packet.
   // Sends rtcp compound packet if buffer was already full and resets buffer.
   void AppendPacket(const rtcp::RtcpPacket& packet) {
-    packet.Create(buffer_, &index_, max_packet_size_, callback_);
+    auto send_packet = [this](rtc::ArrayView<const uint8_t> packet) {
+      transport_->SendRtcp(packet.data(), packet.size());
+    };
+    packet.Create(buffer_, &index_, max_packet_size_, send_packet);
   }
 
   // Sends pending rtcp compound packet.
   void Send() {
     if (index_ > 0) {
-      callback_(rtc::ArrayView<const uint8_t>(buffer_, index_));
+      transport_->SendRtcp(buffer_, index_);
       index_ = 0;
     }
   }
 
+  // Drops pending rtcp compound packet.
+  void Clear() { index_ = 0; }
+
   bool IsEmpty() const { return index_ == 0; }
 
  private:
-  const rtcp::RtcpPacket::PacketReadyCallback callback_;
+  Transport* const transport_;
   const size_t max_packet_size_;
   size_t index_ = 0;
   uint8_t buffer_[IP_PACKET_SIZE];
@@ -89,13 +115,22 @@ class RtcpTransceiverImpl::PacketSender {
 RtcpTransceiverImpl::RtcpTransceiverImpl(const RtcpTransceiverConfig& config)
     : config_(config),
       ready_to_send_(config.initial_ready_to_send),
-      ptr_factory_(this) {
+      ptr_factory_(this),
+      feedback_ptr_factory_(this) {
   RTC_CHECK(config_.Validate());
+  if (config_.batch_feedback)
+    pending_feedback_ = absl::make_unique<PacketSender>(
+        config_.outgoing_transport, config_.max_packet_size);
   if (ready_to_send_ && config_.schedule_periodic_compound_packets)
     SchedulePeriodicCompoundPackets(config_.initial_report_delay_ms);
 }
 
-RtcpTransceiverImpl::~RtcpTransceiverImpl() = default;
+RtcpTransceiverImpl::~RtcpTransceiverImpl() {
+  // Feedback that wasn't sent yet is dropped together with the scheduled
+  // SendPendingFeedback task.
+  if (pending_feedback_)
+    pending_feedback_->Clear();
+}
 
 void RtcpTransceiverImpl::AddMediaReceiverRtcpObserver(
     uint32_t remote_ssrc,
@@ -320,7 +355,7 @@ void RtcpTransceiverImpl::ReschedulePeriodicCompoundPackets() {
     return;
   // Stop existent send task.
   ptr_factory_.InvalidateWeakPtrs();
-  SchedulePeriodicCompoundPackets(config_.report_period_ms);
+  SchedulePeriodicCompoundPackets(ReportPeriodMs());
 }
 
 void RtcpTransceiverImpl::SchedulePeriodicCompoundPackets(int64_t delay_ms) {
@@ -335,7 +370,7 @@ void RtcpTransceiverImpl::SchedulePeriodicCompoundPackets(int64_t delay_ms) {
         return true;
       ptr_->SendPeriodicCompoundPacket();
       task_queue_->PostDelayedTask(absl::WrapUnique(this),
-                                   ptr_->config_.report_period_ms);
+                                   ptr_->ReportPeriodMs());
       return false;
     }
 
@@ -354,60 +389,95 @@ void RtcpTransceiverImpl::SchedulePeriodicCompoundPackets(int64_t delay_ms) {
     config_.task_queue->PostTask(std::move(task));
 }
 
-void RtcpTransceiverImpl::CreateCompoundPacket(PacketSender* sender) {
+void RtcpTransceiverImpl::CreateCompoundPacket(PacketSender* sender,
+                                               size_t reserved_bytes) {
   RTC_DCHECK(sender->IsEmpty());
   const uint32_t sender_ssrc = config_.feedback_ssrc;
   int64_t now_us = rtc::TimeMicros();
-  rtcp::ReceiverReport receiver_report;
-  receiver_report.SetSenderSsrc(sender_ssrc);
-  receiver_report.SetReportBlocks(CreateReportBlocks(now_us));
-  sender->AppendPacket(receiver_report);
 
+  absl::optional<rtcp::Sdes> sdes;
   if (!config_.cname.empty()) {
-    rtcp::Sdes sdes;
-    bool added = sdes.AddCName(config_.feedback_ssrc, config_.cname);
+    sdes.emplace();
+    bool added = sdes->AddCName(config_.feedback_ssrc, config_.cname);
     RTC_DCHECK(added) << "Failed to add cname " << config_.cname
                       << " to rtcp sdes packet.";
-    sender->AppendPacket(sdes);
+    reserved_bytes += sdes->BlockLength();
   }
   if (remb_) {
     remb_->SetSenderSsrc(sender_ssrc);
-    sender->AppendPacket(*remb_);
+    reserved_bytes += remb_->BlockLength();
   }
   // TODO(bugs.webrtc.org/8239): Do not send rrtr if this packet starts with
   // SenderReport instead of ReceiverReport
   // when RtcpTransceiver supports rtp senders.
+  absl::optional<rtcp::ExtendedReports> xr;
   if (config_.non_sender_rtt_measurement) {
-    rtcp::ExtendedReports xr;
-
+    xr.emplace();
     rtcp::Rrtr rrtr;
     rrtr.SetNtp(TimeMicrosToNtp(now_us));
-    xr.SetRrtr(rrtr);
-
-    xr.SetSenderSsrc(sender_ssrc);
-    sender->AppendPacket(xr);
+    xr->SetRrtr(rrtr);
+    xr->SetSenderSsrc(sender_ssrc);
+    reserved_bytes += xr->BlockLength();
   }
+
+  // Report blocks take the rest of the packet, using as many receiver reports
+  // as needed to carry them.
+  size_t report_bytes = config_.max_packet_size > reserved_bytes
+                            ? config_.max_packet_size - reserved_bytes
+                            : 0;
+  std::vector<rtcp::ReportBlock> report_blocks =
+      CreateReportBlocks(now_us, MaxReportBlocks(report_bytes));
+  size_t compound_packet_bytes = reserved_bytes;
+  auto report_block = report_blocks.begin();
+  // Compound packet starts with a receiver report even if there is nothing to
+  // report.
+  do {
+    rtcp::ReceiverReport receiver_report;
+    receiver_report.SetSenderSsrc(sender_ssrc);
+    while (report_block != report_blocks.end() &&
+           receiver_report.AddReportBlock(*report_block)) {
+      ++report_block;
+    }
+    compound_packet_bytes += receiver_report.BlockLength();
+    sender->AppendPacket(receiver_report);
+  } while (report_block != report_blocks.end());
+
+  if (sdes)
+    sender->AppendPacket(*sdes);
+  if (remb_)
+    sender->AppendPacket(*remb_);
+  if (xr)
+    sender->AppendPacket(*xr);
+  last_compound_packet_bytes_ = compound_packet_bytes;
+}
+
+int64_t RtcpTransceiverImpl::ReportPeriodMs() const {
+  if (config_.rtcp_bitrate_bps <= 0)
+    return config_.report_period_ms;
+  // Average bitrate of the periodic packets shouldn't exceed the configured
+  // rtcp bandwidth, see https://tools.ietf.org/html/rfc3550#section-6.2
+  int64_t min_period_ms =
+      last_compound_packet_bytes_ * 8 * 1000 / config_.rtcp_bitrate_bps;
+  return std::max<int64_t>(config_.report_period_ms, min_period_ms);
 }
 
 void RtcpTransceiverImpl::SendPeriodicCompoundPacket() {
-  auto send_packet = [this](rtc::ArrayView<const uint8_t> packet) {
-    config_.outgoing_transport->SendRtcp(packet.data(), packet.size());
-  };
-  PacketSender sender(send_packet, config_.max_packet_size);
-  CreateCompoundPacket(&sender);
+  PacketSender sender(config_.outgoing_transport, config_.max_packet_size);
+  CreateCompoundPacket(&sender, /*reserved_bytes=*/0);
   sender.Send();
 }
 
 void RtcpTransceiverImpl::SendImmediateFeedback(
     const rtcp::RtcpPacket& rtcp_packet) {
-  auto send_packet = [this](rtc::ArrayView<const uint8_t> packet) {
-    config_.outgoing_transport->SendRtcp(packet.data(), packet.size());
-  };
-  PacketSender sender(send_packet, config_.max_packet_size);
+  if (config_.batch_feedback) {
+    AppendPendingFeedback(rtcp_packet);
+    return;
+  }
+  PacketSender sender(config_.outgoing_transport, config_.max_packet_size);
   // Compound mode requires every sent rtcp packet to be compound, i.e. start
   // with a sender or receiver report.
   if (config_.rtcp_mode == RtcpMode::kCompound)
-    CreateCompoundPacket(&sender);
+    CreateCompoundPacket(&sender, rtcp_packet.BlockLength());
 
   sender.AppendPacket(rtcp_packet);
   sender.Send();
@@ -417,15 +487,43 @@ void RtcpTransceiverImpl::SendImmediateFeedback(
     ReschedulePeriodicCompoundPackets();
 }
 
+void RtcpTransceiverImpl::AppendPendingFeedback(
+    const rtcp::RtcpPacket& rtcp_packet) {
+  // First feedback message starts the packet with the compound header, all
+  // following ones until the packet is sent share it.
+  if (pending_feedback_->IsEmpty() && config_.rtcp_mode == RtcpMode::kCompound)
+    CreateCompoundPacket(pending_feedback_.get(), rtcp_packet.BlockLength());
+  pending_feedback_->AppendPacket(rtcp_packet);
+
+  if (feedback_send_scheduled_)
+    return;
+  feedback_send_scheduled_ = true;
+  rtc::WeakPtr<RtcpTransceiverImpl> ptr = feedback_ptr_factory_.GetWeakPtr();
+  config_.task_queue->PostTask([ptr] {
+    if (ptr)
+      ptr->SendPendingFeedback();
+  });
+}
+
+void RtcpTransceiverImpl::SendPendingFeedback() {
+  RTC_DCHECK(feedback_send_scheduled_);
+  feedback_send_scheduled_ = false;
+  if (!ready_to_send_) {
+    pending_feedback_->Clear();
+    return;
+  }
+  pending_feedback_->Send();
+  if (config_.rtcp_mode == RtcpMode::kCompound)
+    ReschedulePeriodicCompoundPackets();
+}
+
 std::vector<rtcp::ReportBlock> RtcpTransceiverImpl::CreateReportBlocks(
-    int64_t now_us) {
-  if (!config_.receive_statistics)
+    int64_t now_us,
+    size_t max_blocks) {
+  if (!config_.receive_statistics || max_blocks == 0)
     return {};
-  // TODO(danilchap): Support sending more than
-  // |ReceiverReport::kMaxNumberOfReportBlocks| per compound rtcp packet.
   std::vector<rtcp::ReportBlock> report_blocks =
-      config_.receive_statistics->RtcpReportBlocks(
-          rtcp::ReceiverReport::kMaxNumberOfReportBlocks);
+      config_.receive_statistics->RtcpReportBlocks(max_blocks);
   uint32_t last_sr = 0;
   uint32_t last_delay = 0;
   for (rtcp::ReportBlock& report_block : report_blocks) {
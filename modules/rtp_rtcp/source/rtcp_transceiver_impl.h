@@ -81,21 +81,38 @@ class RtcpTransceiverImpl {
   void SchedulePeriodicCompoundPackets(int64_t delay_ms);
   // Creates compound RTCP packet, as defined in
   // https://tools.ietf.org/html/rfc5506#section-2
-  void CreateCompoundPacket(PacketSender* sender);
+  // Report blocks fill the packet up to the max packet size, leaving
+  // |reserved_bytes| for the packets that are appended after it.
+  void CreateCompoundPacket(PacketSender* sender, size_t reserved_bytes);
+  // Delay between periodic compound packets.
+  int64_t ReportPeriodMs() const;
   // Sends RTCP packets.
   void SendPeriodicCompoundPacket();
   void SendImmediateFeedback(const rtcp::RtcpPacket& rtcp_packet);
+  // Helpers for |config_.batch_feedback|: queue feedback into
+  // |pending_feedback_| and send it from a task posted to the task queue.
+  void AppendPendingFeedback(const rtcp::RtcpPacket& rtcp_packet);
+  void SendPendingFeedback();
   // Generate Report Blocks to be send in Sender or Receiver Report.
-  std::vector<rtcp::ReportBlock> CreateReportBlocks(int64_t now_us);
+  std::vector<rtcp::ReportBlock> CreateReportBlocks(int64_t now_us,
+                                                    size_t max_blocks);
 
   const RtcpTransceiverConfig config_;
 
   bool ready_to_send_;
   absl::optional<rtcp::Remb> remb_;
+  // Size of the last created compound packet, used to limit rtcp bitrate.
+  size_t last_compound_packet_bytes_ = 0;
   // TODO(danilchap): Remove entries from remote_senders_ that are no longer
   // needed.
   std::map<uint32_t, RemoteSenderState> remote_senders_;
+  // Set when |config_.batch_feedback| is enabled.
+  std::unique_ptr<PacketSender> pending_feedback_;
+  bool feedback_send_scheduled_ = false;
   rtc::WeakPtrFactory<RtcpTransceiverImpl> ptr_factory_;
+  // Separate from |ptr_factory_| so that rescheduling periodic packets doesn't
+  // cancel sending of the pending feedback.
+  rtc::WeakPtrFactory<RtcpTransceiverImpl> feedback_ptr_factory_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RtcpTransceiverImpl);
 };
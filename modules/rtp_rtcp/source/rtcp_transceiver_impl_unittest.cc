@@ -454,6 +454,91 @@ TEST(RtcpTransceiverImplTest, ReceiverReportUsesReceiveStatistics) {
             kMediaSsrc);
 }
 
+TEST(RtcpTransceiverImplTest, FillsPacketWithReportBlocksOfManyStreams) {
+  MockReceiveStatisticsProvider receive_statistics;
+  auto create_report_blocks = [](size_t max_blocks) {
+    std::vector<ReportBlock> report_blocks(max_blocks);
+    for (size_t i = 0; i < max_blocks; ++i)
+      report_blocks[i].SetMediaSsrc(1000 + i);
+    return report_blocks;
+  };
+  // Two receiver reports: one with 31 report blocks, and one with 18 report
+  // blocks filling the rest of the 1200 bytes.
+  EXPECT_CALL(receive_statistics, RtcpReportBlocks(49))
+      .WillOnce(Invoke(create_report_blocks));
+
+  RtcpTransceiverConfig config;
+  config.max_packet_size = 1200;
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  config.receive_statistics = &receive_statistics;
+  config.schedule_periodic_compound_packets = false;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+
+  rtcp_transceiver.SendCompoundPacket();
+
+  EXPECT_EQ(transport.num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 2);
+  ASSERT_THAT(rtcp_parser.receiver_report()->report_blocks(), SizeIs(18));
+  EXPECT_EQ(rtcp_parser.receiver_report()->report_blocks()[17].source_ssrc(),
+            1000u + 48);
+}
+
+TEST(RtcpTransceiverImplTest, LeavesRoomInPacketForFeedback) {
+  MockReceiveStatisticsProvider receive_statistics;
+  EXPECT_CALL(receive_statistics, RtcpReportBlocks(_))
+      .WillOnce(Invoke([](size_t max_blocks) {
+        return std::vector<ReportBlock>(max_blocks);
+      }));
+
+  RtcpTransceiverConfig config;
+  config.max_packet_size = 1200;
+  config.rtcp_mode = webrtc::RtcpMode::kCompound;
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  config.receive_statistics = &receive_statistics;
+  config.schedule_periodic_compound_packets = false;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+
+  rtcp_transceiver.SendPictureLossIndication(4321);
+
+  EXPECT_EQ(transport.num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.pli()->num_packets(), 1);
+}
+
+TEST(RtcpTransceiverImplTest, RtcpBitrateLimitsPeriodOfLargeCompoundPackets) {
+  rtc::TaskQueue queue("rtcp");
+  FakeRtcpTransport transport;
+  RtcpTransceiverConfig config;
+  config.outgoing_transport = &transport;
+  config.initial_report_delay_ms = 0;
+  config.report_period_ms = kReportPeriodMs;
+  // Compound packet with single empty receiver report takes 8 bytes, i.e.
+  // 64 bits, thus should be sent every 5 periods.
+  config.rtcp_bitrate_bps = 64 * 1000 / (5 * kReportPeriodMs);
+  config.task_queue = &queue;
+  absl::optional<RtcpTransceiverImpl> rtcp_transceiver;
+  queue.PostTask([&] { rtcp_transceiver.emplace(config); });
+
+  EXPECT_TRUE(transport.WaitPacket());
+  int64_t time_of_1st_packet_ms = rtc::TimeMillis();
+  EXPECT_TRUE(transport.WaitPacket());
+  int64_t time_of_2nd_packet_ms = rtc::TimeMillis();
+
+  EXPECT_GE(time_of_2nd_packet_ms - time_of_1st_packet_ms,
+            5 * kReportPeriodMs - 1);
+
+  // Cleanup.
+  rtc::Event done(false, false);
+  queue.PostTask([&] {
+    rtcp_transceiver.reset();
+    done.Set();
+  });
+  ASSERT_TRUE(done.Wait(kAlmostForeverMs));
+}
+
 TEST(RtcpTransceiverImplTest, MultipleObserversOnSameSsrc) {
   const uint32_t kRemoteSsrc = 12345;
   StrictMock<MockMediaReceiverRtcpObserver> observer1;
@@ -890,6 +975,97 @@ TEST(RtcpTransceiverImplTest, KeyFrameRequestCreatesReducedSizePacket) {
   EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 0);
 }
 
+TEST(RtcpTransceiverImplTest, BatchesFeedbackIntoSingleCompoundPacket) {
+  const uint32_t kRemoteSsrcs[] = {4321, 5321};
+  rtc::TaskQueue queue("rtcp");
+  RtcpTransceiverConfig config;
+  config.schedule_periodic_compound_packets = false;
+  config.batch_feedback = true;
+  config.task_queue = &queue;
+  config.rtcp_mode = webrtc::RtcpMode::kCompound;
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  absl::optional<RtcpTransceiverImpl> rtcp_transceiver;
+
+  rtc::Event done(false, false);
+  queue.PostTask([&] {
+    rtcp_transceiver.emplace(config);
+    rtcp_transceiver->SendNack(kRemoteSsrcs[0], {34, 37});
+    rtcp_transceiver->SendPictureLossIndication(kRemoteSsrcs[1]);
+    rtcp_transceiver->SendNack(kRemoteSsrcs[1], {12});
+    // Nothing is sent until the current task is done.
+    EXPECT_EQ(transport.num_packets(), 0);
+  });
+  queue.PostTask([&] {
+    rtcp_transceiver.reset();
+    done.Set();
+  });
+  ASSERT_TRUE(done.Wait(kAlmostForeverMs));
+
+  EXPECT_EQ(transport.num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.nack()->num_packets(), 2);
+  EXPECT_EQ(rtcp_parser.nack()->media_ssrc(), kRemoteSsrcs[1]);
+  EXPECT_EQ(rtcp_parser.pli()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.pli()->media_ssrc(), kRemoteSsrcs[1]);
+}
+
+TEST(RtcpTransceiverImplTest, BatchesFeedbackIntoSingleReducedSizePacket) {
+  const uint32_t kRemoteSsrcs[] = {4321, 5321};
+  rtc::TaskQueue queue("rtcp");
+  RtcpTransceiverConfig config;
+  config.schedule_periodic_compound_packets = false;
+  config.batch_feedback = true;
+  config.task_queue = &queue;
+  config.rtcp_mode = webrtc::RtcpMode::kReducedSize;
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  absl::optional<RtcpTransceiverImpl> rtcp_transceiver;
+
+  rtc::Event done(false, false);
+  queue.PostTask([&] {
+    rtcp_transceiver.emplace(config);
+    rtcp_transceiver->SendPictureLossIndication(kRemoteSsrcs[0]);
+    rtcp_transceiver->SendFullIntraRequest(kRemoteSsrcs);
+  });
+  queue.PostTask([&] {
+    rtcp_transceiver.reset();
+    done.Set();
+  });
+  ASSERT_TRUE(done.Wait(kAlmostForeverMs));
+
+  EXPECT_EQ(transport.num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 0);
+  EXPECT_EQ(rtcp_parser.pli()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.fir()->num_packets(), 1);
+}
+
+TEST(RtcpTransceiverImplTest, DropsBatchedFeedbackWhenNetworkStateIsDown) {
+  rtc::TaskQueue queue("rtcp");
+  MockTransport mock_transport;
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  config.batch_feedback = true;
+  config.task_queue = &queue;
+  config.outgoing_transport = &mock_transport;
+  absl::optional<RtcpTransceiverImpl> rtcp_transceiver;
+
+  EXPECT_CALL(mock_transport, SendRtcp(_, _)).Times(0);
+
+  rtc::Event done(false, false);
+  queue.PostTask([&] {
+    rtcp_transceiver.emplace(config);
+    rtcp_transceiver->SendPictureLossIndication(4321);
+    rtcp_transceiver->SetReadyToSend(false);
+  });
+  queue.PostTask([&] {
+    rtcp_transceiver.reset();
+    done.Set();
+  });
+  ASSERT_TRUE(done.Wait(kAlmostForeverMs));
+}
+
 TEST(RtcpTransceiverImplTest, SendsXrRrtrWhenEnabled) {
   const uint32_t kSenderSsrc = 4321;
   rtc::ScopedFakeClock clock;
@@ -159,11 +159,16 @@ bool RtpFecTest<ForwardErrorCorrectionType>::IsRecoveryComplete() {
       [](const std::unique_ptr<ForwardErrorCorrection::Packet>& media_packet,
          const std::unique_ptr<ForwardErrorCorrection::RecoveredPacket>&
              recovered_packet) {
-        if (media_packet->length != recovered_packet->pkt->length) {
+        // Media packets received by reference are kept that way.
+        const bool by_reference = !recovered_packet->pkt;
+        const uint8_t* data = by_reference ? recovered_packet->buffer.cdata()
+                                           : recovered_packet->pkt->data;
+        const size_t length = by_reference ? recovered_packet->buffer.size()
+                                           : recovered_packet->pkt->length;
+        if (media_packet->length != length) {
           return false;
         }
-        if (memcmp(media_packet->data, recovered_packet->pkt->data,
-                   media_packet->length) != 0) {
+        if (memcmp(media_packet->data, data, media_packet->length) != 0) {
           return false;
         }
         return true;
@@ -293,6 +298,72 @@ TYPED_TEST(RtpFecTest, FecRecoveryNoLoss) {
   EXPECT_TRUE(this->IsRecoveryComplete());
 }
 
+TYPED_TEST(RtpFecTest, FecRecoveryWithLossOfMediaReceivedByReference) {
+  constexpr int kNumImportantPackets = 0;
+  constexpr bool kUseUnequalProtection = false;
+  constexpr int kNumMediaPackets = 4;
+  constexpr uint8_t kProtectionFactor = 60;
+
+  this->media_packets_ =
+      this->media_packet_generator_.ConstructMediaPackets(kNumMediaPackets);
+
+  EXPECT_EQ(
+      0, this->fec_.EncodeFec(this->media_packets_, kProtectionFactor,
+                              kNumImportantPackets, kUseUnequalProtection,
+                              kFecMaskBursty, &this->generated_fec_packets_));
+
+  // Expect 1 FEC packet.
+  EXPECT_EQ(1u, this->generated_fec_packets_.size());
+
+  // 1 media packet lost.
+  memset(this->media_loss_mask_, 0, sizeof(this->media_loss_mask_));
+  memset(this->fec_loss_mask_, 0, sizeof(this->fec_loss_mask_));
+  this->media_loss_mask_[1] = 1;
+  this->NetworkReceivedPackets(this->media_loss_mask_, this->fec_loss_mask_);
+
+  // Pass the received media packets by reference instead of in packet
+  // storage.
+  for (const auto& received_packet : this->received_packets_) {
+    if (received_packet->is_fec)
+      continue;
+    received_packet->buffer.SetData(received_packet->pkt->data,
+                                    received_packet->pkt->length);
+    received_packet->pkt = nullptr;
+  }
+
+  for (const auto& received_packet : this->received_packets_) {
+    this->fec_.DecodeFec(*received_packet, &this->recovered_packets_);
+  }
+
+  // One packet lost, one FEC packet, expect complete recovery.
+  EXPECT_TRUE(this->IsRecoveryComplete());
+  ASSERT_EQ(4u, this->recovered_packets_.size());
+  auto it = this->recovered_packets_.begin();
+  EXPECT_FALSE((*it)->pkt);
+  ++it;
+  EXPECT_TRUE((*it)->was_recovered);
+  EXPECT_TRUE((*it)->pkt);
+}
+
+TYPED_TEST(RtpFecTest, AllocatePacketReusesUnreferencedPackets) {
+  rtc::scoped_refptr<ForwardErrorCorrection::Packet> packet =
+      this->fec_.AllocatePacket();
+  ForwardErrorCorrection::Packet* const first = packet.get();
+  packet->length = 10;
+  packet->data[0] = 0xff;
+
+  // Still referenced, so new storage is needed.
+  rtc::scoped_refptr<ForwardErrorCorrection::Packet> second =
+      this->fec_.AllocatePacket();
+  EXPECT_NE(first, second.get());
+
+  packet = nullptr;
+  packet = this->fec_.AllocatePacket();
+  EXPECT_EQ(first, packet.get());
+  EXPECT_EQ(0u, packet->length);
+  EXPECT_EQ(0, packet->data[0]);
+}
+
 TYPED_TEST(RtpFecTest, FecRecoveryWithLoss) {
   constexpr int kNumImportantPackets = 0;
   constexpr bool kUseUnequalProtection = false;
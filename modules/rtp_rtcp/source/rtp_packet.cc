@@ -72,18 +72,24 @@ RtpPacket::RtpPacket(const ExtensionManager* extensions, size_t capacity)
   } else {
     for (size_t i = 0; i < kMaxExtensionHeaders; ++i)
       extension_entries_[i].type = ExtensionManager::kInvalidType;
+    memset(extension_ids_, 0, sizeof(extension_ids_));
   }
 }
 
 RtpPacket::~RtpPacket() {}
 
 void RtpPacket::IdentifyExtensions(const ExtensionManager& extensions) {
-  for (int i = 0; i < kMaxExtensionHeaders; ++i)
-    extension_entries_[i].type = extensions.GetType(i + 1);
+  memset(extension_ids_, 0, sizeof(extension_ids_));
+  for (int i = 0; i < kMaxExtensionHeaders; ++i) {
+    ExtensionType type = extensions.GetType(i + 1);
+    extension_entries_[i].type = type;
+    if (type != ExtensionManager::kInvalidType)
+      extension_ids_[type] = i + 1;
+  }
 }
 
 bool RtpPacket::Parse(const uint8_t* buffer, size_t buffer_size) {
-  if (!ParseBuffer(buffer, buffer_size)) {
+  if (!ParseBuffer(buffer, buffer_size, /*lazy_extensions=*/false)) {
     Clear();
     return false;
   }
@@ -97,7 +103,18 @@ bool RtpPacket::Parse(rtc::ArrayView<const uint8_t> packet) {
 }
 
 bool RtpPacket::Parse(rtc::CopyOnWriteBuffer buffer) {
-  if (!ParseBuffer(buffer.cdata(), buffer.size())) {
+  if (!ParseBuffer(buffer.cdata(), buffer.size(), /*lazy_extensions=*/false)) {
+    Clear();
+    return false;
+  }
+  size_t buffer_size = buffer.size();
+  buffer_ = std::move(buffer);
+  RTC_DCHECK_EQ(size(), buffer_size);
+  return true;
+}
+
+bool RtpPacket::ParseWithLazyExtensions(rtc::CopyOnWriteBuffer buffer) {
+  if (!ParseBuffer(buffer.cdata(), buffer.size(), /*lazy_extensions=*/true)) {
     Clear();
     return false;
   }
@@ -195,10 +212,14 @@ void RtpPacket::CopyHeaderFrom(const RtpPacket& packet) {
   timestamp_ = packet.timestamp_;
   ssrc_ = packet.ssrc_;
   payload_offset_ = packet.payload_offset_;
+  if (!packet.extensions_parsed_)
+    packet.ParseExtensions(packet.data());
   for (size_t i = 0; i < kMaxExtensionHeaders; ++i) {
     extension_entries_[i] = packet.extension_entries_[i];
   }
+  memcpy(extension_ids_, packet.extension_ids_, sizeof(extension_ids_));
   extensions_size_ = packet.extensions_size_;
+  extensions_parsed_ = true;
   buffer_.SetData(packet.data(), packet.headers_size());
   // Reset payload and padding.
   payload_size_ = 0;
@@ -257,6 +278,8 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
   RTC_DCHECK_GE(length, 1);
   RTC_DCHECK_LE(length, 16);
 
+  if (!extensions_parsed_)
+    ParseExtensions(data());
   ExtensionInfo* extension_entry = &extension_entries_[id - 1];
   if (extension_entry->offset != 0) {
     // Extension already reserved. Check if same length is used.
@@ -308,6 +331,80 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
   extension_entry->length = rtc::dchecked_cast<uint8_t>(length);
   extensions_size_ = new_extensions_size;
 
+  UpdateExtensionsLength(extensions_offset);
+  return rtc::MakeArrayView(WriteAt(extension_entry->offset), length);
+}
+
+bool RtpPacket::ReserveRawExtensions(const ExtensionType* types,
+                                     const uint8_t* lengths,
+                                     size_t num_extensions) {
+  if (!extensions_parsed_)
+    ParseExtensions(data());
+  size_t num_csrc = data()[0] & 0x0F;
+  size_t extensions_offset = kFixedHeaderSize + (num_csrc * 4) + 4;
+  size_t new_extensions_size = extensions_size_;
+  bool all_new = payload_size_ == 0 && padding_size_ == 0;
+  for (size_t i = 0; i < num_extensions; ++i) {
+    RTC_DCHECK_GE(lengths[i], 1);
+    RTC_DCHECK_LE(lengths[i], 16);
+    int id = extension_ids_[types[i]];
+    if (id == ExtensionManager::kInvalidId)
+      continue;
+    if (extension_entries_[id - 1].offset != 0)
+      all_new = false;
+    new_extensions_size += kOneByteHeaderSize + lengths[i];
+  }
+  if (!all_new || extensions_offset + new_extensions_size > capacity()) {
+    // Reserve one at a time, which handles and logs all the special cases.
+    bool success = true;
+    for (size_t i = 0; i < num_extensions; ++i) {
+      auto buffer = AllocateExtension(types[i], lengths[i]);
+      if (buffer.empty()) {
+        success = false;
+        continue;
+      }
+      memset(buffer.data(), 0, lengths[i]);
+    }
+    return success;
+  }
+
+  if (new_extensions_size == extensions_size_) {
+    // None of the extensions is registered.
+    return num_extensions == 0;
+  }
+  if (extensions_size_ == 0) {
+    RTC_DCHECK_EQ(payload_offset_, kFixedHeaderSize + (num_csrc * 4));
+    WriteAt(0, data()[0] | 0x10);  // Set extension bit.
+    // Profile specific ID always set to OneByteExtensionHeader.
+    ByteWriter<uint16_t>::WriteBigEndian(WriteAt(extensions_offset - 4),
+                                         kOneByteExtensionId);
+  }
+  // Write all headers and zeroed values back to back, and the length field
+  // and padding once at the end.
+  bool success = true;
+  uint8_t* extensions = WriteAt(extensions_offset);
+  for (size_t i = 0; i < num_extensions; ++i) {
+    int id = extension_ids_[types[i]];
+    if (id == ExtensionManager::kInvalidId) {
+      success = false;
+      continue;
+    }
+    uint8_t one_byte_header = rtc::dchecked_cast<uint8_t>(id) << 4;
+    one_byte_header |= rtc::dchecked_cast<uint8_t>(lengths[i] - 1);
+    extensions[extensions_size_] = one_byte_header;
+    memset(&extensions[extensions_size_ + kOneByteHeaderSize], 0, lengths[i]);
+    ExtensionInfo* extension_entry = &extension_entries_[id - 1];
+    extension_entry->offset = rtc::dchecked_cast<uint16_t>(
+        extensions_offset + extensions_size_ + kOneByteHeaderSize);
+    extension_entry->length = lengths[i];
+    extensions_size_ += kOneByteHeaderSize + lengths[i];
+  }
+  RTC_DCHECK_EQ(extensions_size_, new_extensions_size);
+  UpdateExtensionsLength(extensions_offset);
+  return success;
+}
+
+void RtpPacket::UpdateExtensionsLength(size_t extensions_offset) {
   // Update header length field.
   uint16_t extensions_words = rtc::dchecked_cast<uint16_t>(
       (extensions_size_ + 3) / 4);  // Wrap up to 32bit.
@@ -319,7 +416,6 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
          extension_padding_size);
   payload_offset_ = extensions_offset + 4 * extensions_words;
   buffer_.SetSize(payload_offset_);
-  return rtc::MakeArrayView(WriteAt(extension_entry->offset), length);
 }
 
 uint8_t* RtpPacket::AllocatePayload(size_t size_bytes) {
@@ -374,6 +470,7 @@ void RtpPacket::Clear() {
   payload_size_ = 0;
   padding_size_ = 0;
   extensions_size_ = 0;
+  extensions_parsed_ = true;
   for (ExtensionInfo& location : extension_entries_) {
     location.offset = 0;
     location.length = 0;
@@ -384,7 +481,9 @@ void RtpPacket::Clear() {
   WriteAt(0, kRtpVersion << 6);
 }
 
-bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
+bool RtpPacket::ParseBuffer(const uint8_t* buffer,
+                            size_t size,
+                            bool lazy_extensions) {
   if (size < kFixedHeaderSize) {
     return false;
   }
@@ -416,11 +515,6 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
     padding_size_ = 0;
   }
 
-  extensions_size_ = 0;
-  for (ExtensionInfo& location : extension_entries_) {
-    location.offset = 0;
-    location.length = 0;
-  }
   if (has_extension) {
     /* RTP header extension, RFC 3550.
      0                   1                   2                   3
@@ -435,52 +529,12 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
     if (extension_offset > size) {
       return false;
     }
-    uint16_t profile =
-        ByteReader<uint16_t>::ReadBigEndian(&buffer[payload_offset_]);
     size_t extensions_capacity =
         ByteReader<uint16_t>::ReadBigEndian(&buffer[payload_offset_ + 2]);
     extensions_capacity *= 4;
     if (extension_offset + extensions_capacity > size) {
       return false;
     }
-    if (profile != kOneByteExtensionId) {
-      RTC_LOG(LS_WARNING) << "Unsupported rtp extension " << profile;
-    } else {
-      constexpr uint8_t kPaddingId = 0;
-      constexpr uint8_t kReservedId = 15;
-      while (extensions_size_ + kOneByteHeaderSize < extensions_capacity) {
-        int id = buffer[extension_offset + extensions_size_] >> 4;
-        if (id == kReservedId) {
-          break;
-        } else if (id == kPaddingId) {
-          extensions_size_++;
-          continue;
-        }
-        uint8_t length =
-            1 + (buffer[extension_offset + extensions_size_] & 0xf);
-        if (extensions_size_ + kOneByteHeaderSize + length >
-            extensions_capacity) {
-          RTC_LOG(LS_WARNING) << "Oversized rtp header extension.";
-          break;
-        }
-
-        size_t idx = id - 1;
-        if (extension_entries_[idx].length != 0) {
-          RTC_LOG(LS_VERBOSE)
-              << "Duplicate rtp header extension id " << id << ". Overwriting.";
-        }
-
-        size_t offset =
-            extension_offset + extensions_size_ + kOneByteHeaderSize;
-        if (!rtc::IsValueInRangeForNumericType<uint16_t>(offset)) {
-          RTC_DLOG(LS_WARNING) << "Oversized rtp header extension.";
-          break;
-        }
-        extension_entries_[idx].offset = static_cast<uint16_t>(offset);
-        extension_entries_[idx].length = length;
-        extensions_size_ += kOneByteHeaderSize + length;
-      }
-    }
     payload_offset_ = extension_offset + extensions_capacity;
   }
 
@@ -488,33 +542,99 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
     return false;
   }
   payload_size_ = size - payload_offset_ - padding_size_;
+
+  if (lazy_extensions) {
+    extensions_parsed_ = false;
+  } else {
+    ParseExtensions(buffer);
+  }
   return true;
 }
 
+void RtpPacket::ParseExtensions(const uint8_t* buffer) const {
+  extensions_parsed_ = true;
+  extensions_size_ = 0;
+  for (ExtensionInfo& location : extension_entries_) {
+    location.offset = 0;
+    location.length = 0;
+  }
+  if ((buffer[0] & 0x10) == 0)
+    return;
+
+  const size_t number_of_crcs = buffer[0] & 0x0f;
+  const size_t profile_offset = kFixedHeaderSize + number_of_crcs * 4;
+  const size_t extension_offset = profile_offset + 4;
+  // Bounds were checked by ParseBuffer.
+  RTC_DCHECK_GE(payload_offset_, extension_offset);
+  const size_t extensions_capacity = payload_offset_ - extension_offset;
+  uint16_t profile =
+      ByteReader<uint16_t>::ReadBigEndian(&buffer[profile_offset]);
+  if (profile != kOneByteExtensionId) {
+    RTC_LOG(LS_WARNING) << "Unsupported rtp extension " << profile;
+    return;
+  }
+  constexpr uint8_t kPaddingId = 0;
+  constexpr uint8_t kReservedId = 15;
+  while (extensions_size_ + kOneByteHeaderSize < extensions_capacity) {
+    int id = buffer[extension_offset + extensions_size_] >> 4;
+    if (id == kReservedId) {
+      break;
+    } else if (id == kPaddingId) {
+      extensions_size_++;
+      continue;
+    }
+    uint8_t length = 1 + (buffer[extension_offset + extensions_size_] & 0xf);
+    if (extensions_size_ + kOneByteHeaderSize + length > extensions_capacity) {
+      RTC_LOG(LS_WARNING) << "Oversized rtp header extension.";
+      break;
+    }
+
+    size_t idx = id - 1;
+    if (extension_entries_[idx].length != 0) {
+      RTC_LOG(LS_VERBOSE) << "Duplicate rtp header extension id " << id
+                          << ". Overwriting.";
+    }
+
+    size_t offset = extension_offset + extensions_size_ + kOneByteHeaderSize;
+    if (!rtc::IsValueInRangeForNumericType<uint16_t>(offset)) {
+      RTC_DLOG(LS_WARNING) << "Oversized rtp header extension.";
+      break;
+    }
+    extension_entries_[idx].offset = static_cast<uint16_t>(offset);
+    extension_entries_[idx].length = length;
+    extensions_size_ += kOneByteHeaderSize + length;
+  }
+}
+
 rtc::ArrayView<const uint8_t> RtpPacket::FindExtension(
     ExtensionType type) const {
-  for (const ExtensionInfo& extension : extension_entries_) {
-    if (extension.type == type) {
-      if (extension.length == 0) {
-        // Extension is registered but not set.
-        return nullptr;
-      }
-      return rtc::MakeArrayView(data() + extension.offset, extension.length);
-    }
+  RTC_DCHECK_GT(type, kRtpExtensionNone);
+  RTC_DCHECK_LT(type, kRtpExtensionNumberOfExtensions);
+  int id = extension_ids_[type];
+  if (id == ExtensionManager::kInvalidId) {
+    // Extension not registered.
+    return nullptr;
+  }
+  if (!extensions_parsed_)
+    ParseExtensions(data());
+  const ExtensionInfo& extension = extension_entries_[id - 1];
+  if (extension.length == 0) {
+    // Extension is registered but not set.
+    return nullptr;
   }
-  return nullptr;
+  return rtc::MakeArrayView(data() + extension.offset, extension.length);
 }
 
 rtc::ArrayView<uint8_t> RtpPacket::AllocateExtension(ExtensionType type,
                                                      size_t length) {
-  for (int i = 0; i < kMaxExtensionHeaders; ++i) {
-    if (extension_entries_[i].type == type) {
-      int extension_id = i + 1;
-      return AllocateRawExtension(extension_id, length);
-    }
+  RTC_DCHECK_GT(type, kRtpExtensionNone);
+  RTC_DCHECK_LT(type, kRtpExtensionNumberOfExtensions);
+  int id = extension_ids_[type];
+  if (id == ExtensionManager::kInvalidId) {
+    // Extension not registered.
+    return nullptr;
   }
-  // Extension not registered.
-  return nullptr;
+  return AllocateRawExtension(id, length);
 }
 
 uint8_t* RtpPacket::WriteAt(size_t offset) {
@@ -47,6 +47,13 @@ class RtpPacket {
   // Parse and move given buffer into Packet.
   bool Parse(rtc::CopyOnWriteBuffer packet);
 
+  // Same as above, but only validates the bounds of the header extension
+  // block. Individual extensions are located on first access, so packets that
+  // are dropped, or only asked for a couple of extensions, never pay for the
+  // full walk. Until then the packet must not be used from several threads at
+  // once, not even through const methods.
+  bool ParseWithLazyExtensions(rtc::CopyOnWriteBuffer packet);
+
   // Maps extensions id to their types.
   void IdentifyExtensions(const ExtensionManager& extensions);
 
@@ -102,6 +109,13 @@ class RtpPacket {
   template <typename Extension>
   bool ReserveExtension();
 
+  // Same as ReserveExtension() for each of |Extensions|, but writes the
+  // extension headers in a single pass. Meant for the fixed size extensions
+  // that every packet of a stream carries. Returns false if any of them is
+  // not registered or could not be reserved.
+  template <typename... Extensions>
+  bool ReserveExtensions();
+
   // Reserve size_bytes for payload. Returns nullptr on failure.
   uint8_t* SetPayloadSize(size_t size_bytes);
   // Same as SetPayloadSize but doesn't guarantee to keep current payload.
@@ -117,7 +131,11 @@ class RtpPacket {
 
   // Helper function for Parse. Fill header fields using data in given buffer,
   // but does not touch packet own buffer, leaving packet in invalid state.
-  bool ParseBuffer(const uint8_t* buffer, size_t size);
+  bool ParseBuffer(const uint8_t* buffer, size_t size, bool lazy_extensions);
+
+  // Locates the one-byte header extensions in |buffer|, which must hold the
+  // packet header as already validated by ParseBuffer.
+  void ParseExtensions(const uint8_t* buffer) const;
 
   // Find an extension |type|.
   // Returns view of the raw extension or empty view on failure.
@@ -131,6 +149,14 @@ class RtpPacket {
   // to write raw extension to or an empty view on failure.
   rtc::ArrayView<uint8_t> AllocateExtension(ExtensionType type, size_t length);
 
+  // Reserves zeroed space for extensions |types| of size |lengths|.
+  bool ReserveRawExtensions(const ExtensionType* types,
+                            const uint8_t* lengths,
+                            size_t num_extensions);
+
+  // Writes the length field and padding after |extensions_size_| changed.
+  void UpdateExtensionsLength(size_t extensions_offset);
+
   uint8_t* WriteAt(size_t offset);
   void WriteAt(size_t offset, uint8_t byte);
 
@@ -144,8 +170,14 @@ class RtpPacket {
   size_t payload_offset_;  // Match header size with csrcs and extensions.
   size_t payload_size_;
 
-  ExtensionInfo extension_entries_[kMaxExtensionHeaders];
-  size_t extensions_size_ = 0;  // Unaligned.
+  // Offsets and lengths are filled in by ParseExtensions(), which may run on
+  // first access when the packet was parsed with lazy extensions.
+  mutable ExtensionInfo extension_entries_[kMaxExtensionHeaders];
+  mutable size_t extensions_size_ = 0;  // Unaligned.
+  mutable bool extensions_parsed_ = true;
+  // Reverse of the entries' types, maps extension type to id, or 0 if the type
+  // is not registered.
+  uint8_t extension_ids_[kRtpExtensionNumberOfExtensions];
   rtc::CopyOnWriteBuffer buffer_;
 };
 
@@ -182,6 +214,13 @@ bool RtpPacket::ReserveExtension() {
   return true;
 }
 
+template <typename... Extensions>
+bool RtpPacket::ReserveExtensions() {
+  const ExtensionType types[] = {Extensions::kId...};
+  const uint8_t lengths[] = {Extensions::kValueSizeBytes...};
+  return ReserveRawExtensions(types, lengths, sizeof...(Extensions));
+}
+
 }  // namespace webrtc
 
 #endif  // MODULES_RTP_RTCP_SOURCE_RTP_PACKET_H_
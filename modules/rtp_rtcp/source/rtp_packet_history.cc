@@ -16,6 +16,7 @@
 
 #include "absl/memory/memory.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
@@ -34,6 +35,15 @@ size_t SizeDiff(const std::unique_ptr<RtpPacketToSend>& packet, size_t size) {
   }
   return size - packet_size;
 }
+
+// The ring is twice the requested size, which leaves room for packets that are
+// not sent yet and for gaps in the sequence numbers.
+size_t RingCapacity(size_t number_to_store) {
+  size_t capacity = 32;
+  while (capacity < 2 * number_to_store)
+    capacity *= 2;
+  return capacity;
+}
 }  // namespace
 
 constexpr size_t RtpPacketHistory::kMaxCapacity;
@@ -51,11 +61,36 @@ RtpPacketHistory::StoredPacket& RtpPacketHistory::StoredPacket::operator=(
     RtpPacketHistory::StoredPacket&&) = default;
 RtpPacketHistory::StoredPacket::~StoredPacket() = default;
 
+RtpPacketHistory::PacketSlot::PacketSlot()
+    : version(0),
+      sequence_number(-1),
+      send_time_ms(-1),
+      capture_time_ms(0),
+      ssrc(0),
+      payload_size(0),
+      times_retransmitted(0) {}
+RtpPacketHistory::PacketSlot::~PacketSlot() = default;
+
+RtpPacketHistory::Ring::Ring(size_t capacity)
+    : mask(capacity - 1), slots(new PacketSlot[capacity]) {
+  RTC_DCHECK_EQ(0, capacity & mask);
+}
+RtpPacketHistory::Ring::~Ring() = default;
+
 RtpPacketHistory::RtpPacketHistory(Clock* clock)
+    : RtpPacketHistory(clock, nullptr) {}
+
+RtpPacketHistory::RtpPacketHistory(Clock* clock,
+                                   RtpPacketToSendPool* packet_pool)
     : clock_(clock),
+      packet_pool_(packet_pool),
       number_to_store_(0),
       mode_(StorageMode::kDisabled),
-      rtt_ms_(-1) {}
+      enabled_(false),
+      rtt_ms_(-1),
+      ring_(nullptr),
+      num_packets_(0),
+      max_packets_(0) {}
 
 RtpPacketHistory::~RtpPacketHistory() {}
 
@@ -69,6 +104,20 @@ void RtpPacketHistory::SetStorePacketsStatus(StorageMode mode,
   Reset();
   mode_ = mode;
   number_to_store_ = std::min(kMaxCapacity, number_to_store);
+  if (mode_ == StorageMode::kDisabled) {
+    enabled_.store(false, std::memory_order_release);
+    return;
+  }
+
+  const size_t capacity = RingCapacity(number_to_store_);
+  Ring* ring = ring_.load(std::memory_order_relaxed);
+  if (!ring || ring->capacity() < capacity) {
+    rings_.push_back(absl::make_unique<Ring>(capacity));
+    ring = rings_.back().get();
+    ring_.store(ring, std::memory_order_release);
+  }
+  max_packets_ = std::min(kMaxCapacity, ring->capacity());
+  enabled_.store(true, std::memory_order_release);
 }
 
 RtpPacketHistory::StorageMode RtpPacketHistory::GetStorageMode() const {
@@ -77,9 +126,8 @@ RtpPacketHistory::StorageMode RtpPacketHistory::GetStorageMode() const {
 }
 
 void RtpPacketHistory::SetRtt(int64_t rtt_ms) {
-  rtc::CritScope cs(&lock_);
   RTC_DCHECK_GE(rtt_ms, 0);
-  rtt_ms_ = rtt_ms;
+  rtt_ms_.store(rtt_ms, std::memory_order_relaxed);
 }
 
 void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
@@ -94,10 +142,15 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
 
   CullOldPackets(now_ms);
 
-  // Store packet.
+  // Store packet. If the slot still holds a packet one or more ring
+  // capacities older, that packet is dropped.
   const uint16_t rtp_seq_no = packet->SequenceNumber();
-  StoredPacket& stored_packet = packet_history_[rtp_seq_no];
-  RTC_DCHECK(stored_packet.packet == nullptr);
+  PacketSlot* slot = &ring_.load(std::memory_order_relaxed)->at(rtp_seq_no);
+  if (slot->stored.packet) {
+    RTC_DCHECK_NE(rtp_seq_no, slot->stored.packet->SequenceNumber());
+    DropPacket(slot);
+  }
+  StoredPacket& stored_packet = slot->stored;
   stored_packet.packet = std::move(packet);
 
   if (stored_packet.packet->capture_time_ms() <= 0) {
@@ -106,6 +159,8 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
   stored_packet.send_time_ms = send_time_ms;
   stored_packet.storage_type = type;
   stored_packet.times_retransmitted = 0;
+  PublishSlot(slot);
+  ++num_packets_;
 
   if (!start_seqno_) {
     start_seqno_ = rtp_seq_no;
@@ -121,13 +176,14 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
   }
 
   int64_t now_ms = clock_->TimeInMilliseconds();
-  StoredPacketIterator rtp_it = packet_history_.find(sequence_number);
-  if (rtp_it == packet_history_.end()) {
+  PacketSlot* slot = FindPacket(sequence_number);
+  if (!slot) {
     return nullptr;
   }
 
-  StoredPacket& packet = rtp_it->second;
-  if (verify_rtt && !VerifyRtt(rtp_it->second, now_ms)) {
+  StoredPacket& packet = slot->stored;
+  if (verify_rtt &&
+      !VerifyRtt(packet.send_time_ms, packet.times_retransmitted, now_ms)) {
     return nullptr;
   }
 
@@ -141,37 +197,64 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
   if (packet.storage_type == StorageType::kDontRetransmit) {
     // Non retransmittable packet, so call must come from paced sender.
     // Remove from history and return actual packet instance.
-    return RemovePacket(rtp_it);
+    return RemovePacket(slot);
   }
+  PublishSlot(slot);
   return absl::make_unique<RtpPacketToSend>(*packet.packet);
 }
 
 absl::optional<RtpPacketHistory::PacketState> RtpPacketHistory::GetPacketState(
     uint16_t sequence_number,
     bool verify_rtt) const {
-  rtc::CritScope cs(&lock_);
-  if (mode_ == StorageMode::kDisabled) {
+  if (!enabled_.load(std::memory_order_acquire)) {
     return absl::nullopt;
   }
+  const PacketSlot& slot =
+      ring_.load(std::memory_order_acquire)->at(sequence_number);
+
+  // Read the mirrored state, retrying if it changed while being read.
+  PacketState state;
+  while (true) {
+    uint32_t version = slot.version.load(std::memory_order_acquire);
+    if (version & 1)
+      continue;
+    int32_t stored_seq_no =
+        slot.sequence_number.load(std::memory_order_relaxed);
+    int64_t send_time_ms = slot.send_time_ms.load(std::memory_order_relaxed);
+    state.capture_time_ms =
+        slot.capture_time_ms.load(std::memory_order_relaxed);
+    state.ssrc = slot.ssrc.load(std::memory_order_relaxed);
+    state.payload_size = slot.payload_size.load(std::memory_order_relaxed);
+    state.times_retransmitted =
+        slot.times_retransmitted.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.version.load(std::memory_order_relaxed) != version)
+      continue;
 
-  auto rtp_it = packet_history_.find(sequence_number);
-  if (rtp_it == packet_history_.end()) {
-    return absl::nullopt;
+    if (stored_seq_no != sequence_number) {
+      return absl::nullopt;
+    }
+    state.rtp_sequence_number = sequence_number;
+    if (send_time_ms >= 0)
+      state.send_time_ms = send_time_ms;
+    break;
   }
 
-  if (verify_rtt && !VerifyRtt(rtp_it->second, clock_->TimeInMilliseconds())) {
+  if (verify_rtt && !VerifyRtt(state.send_time_ms, state.times_retransmitted,
+                               clock_->TimeInMilliseconds())) {
     return absl::nullopt;
   }
 
-  return StoredPacketToPacketState(rtp_it->second);
+  return state;
 }
 
-bool RtpPacketHistory::VerifyRtt(const RtpPacketHistory::StoredPacket& packet,
+bool RtpPacketHistory::VerifyRtt(absl::optional<int64_t> send_time_ms,
+                                 size_t times_retransmitted,
                                  int64_t now_ms) const {
-  if (packet.send_time_ms) {
+  if (send_time_ms) {
     // Send-time already set, this check must be for a retransmission.
-    if (packet.times_retransmitted > 0 &&
-        now_ms < *packet.send_time_ms + rtt_ms_) {
+    if (times_retransmitted > 0 &&
+        now_ms < *send_time_ms + rtt_ms_.load(std::memory_order_relaxed)) {
       // This packet has already been retransmitted once, and the time since
       // that even is lower than on RTT. Ignore request as this packet is
       // likely already in the network pipe.
@@ -186,17 +269,25 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetBestFittingPacket(
     size_t packet_length) const {
   // TODO(sprang): Make this smarter, taking retransmit count etc into account.
   rtc::CritScope cs(&lock_);
-  if (packet_length < kMinPacketRequestBytes || packet_history_.empty()) {
+  if (packet_length < kMinPacketRequestBytes || num_packets_ == 0) {
     return nullptr;
   }
 
+  // Visit the stored packets from the oldest one.
+  Ring* ring = ring_.load(std::memory_order_relaxed);
   size_t min_diff = std::numeric_limits<size_t>::max();
   RtpPacketToSend* best_packet = nullptr;
-  for (auto& it : packet_history_) {
-    size_t diff = SizeDiff(it.second.packet, packet_length);
+  size_t visited = 0;
+  for (size_t i = 0; i < ring->capacity() && visited < num_packets_; ++i) {
+    const StoredPacket& stored =
+        ring->at(static_cast<uint16_t>(*start_seqno_ + i)).stored;
+    if (!stored.packet)
+      continue;
+    ++visited;
+    size_t diff = SizeDiff(stored.packet, packet_length);
     if (!min_diff || diff < min_diff) {
       min_diff = diff;
-      best_packet = it.second.packet.get();
+      best_packet = stored.packet.get();
       if (diff == 0) {
         break;
       }
@@ -207,25 +298,36 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetBestFittingPacket(
 }
 
 void RtpPacketHistory::Reset() {
-  packet_history_.clear();
+  Ring* ring = ring_.load(std::memory_order_relaxed);
+  if (ring && num_packets_ > 0) {
+    for (size_t i = 0; i < ring->capacity(); ++i) {
+      PacketSlot* slot = &ring->slots[i];
+      if (slot->stored.packet) {
+        slot->stored = StoredPacket();
+        PublishSlot(slot);
+      }
+    }
+  }
+  num_packets_ = 0;
   start_seqno_.reset();
 }
 
 void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
   int64_t packet_duration_ms =
-      std::max(kMinPacketDurationRtt * rtt_ms_, kMinPacketDurationMs);
-  while (!packet_history_.empty()) {
-    auto stored_packet_it = packet_history_.find(*start_seqno_);
-    RTC_DCHECK(stored_packet_it != packet_history_.end());
+      std::max(kMinPacketDurationRtt * rtt_ms_.load(std::memory_order_relaxed),
+               kMinPacketDurationMs);
+  while (num_packets_ > 0) {
+    PacketSlot* slot = FindPacket(*start_seqno_);
+    RTC_DCHECK(slot);
 
-    if (packet_history_.size() >= kMaxCapacity) {
+    if (num_packets_ >= max_packets_) {
       // We have reached the absolute max capacity, remove one packet
       // unconditionally.
-      RemovePacket(stored_packet_it);
+      DropPacket(slot);
       continue;
     }
 
-    const StoredPacket& stored_packet = stored_packet_it->second;
+    const StoredPacket& stored_packet = slot->stored;
     if (!stored_packet.send_time_ms) {
       // Don't remove packets that have not been sent.
       return;
@@ -236,14 +338,14 @@ void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
       return;
     }
 
-    if (packet_history_.size() >= number_to_store_ ||
+    if (num_packets_ >= number_to_store_ ||
         (mode_ == StorageMode::kStoreAndCull &&
          *stored_packet.send_time_ms +
                  (packet_duration_ms * kPacketCullingDelayFactor) <=
              now_ms)) {
       // Too many packets in history, or this packet has timed out. Remove it
       // and continue.
-      RemovePacket(stored_packet_it);
+      DropPacket(slot);
     } else {
       // No more packets can be removed right now.
       return;
@@ -251,30 +353,72 @@ void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
   }
 }
 
+RtpPacketHistory::PacketSlot* RtpPacketHistory::FindPacket(
+    uint16_t sequence_number) {
+  PacketSlot* slot = &ring_.load(std::memory_order_relaxed)->at(sequence_number);
+  if (!slot->stored.packet ||
+      slot->stored.packet->SequenceNumber() != sequence_number) {
+    return nullptr;
+  }
+  return slot;
+}
+
 std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
-    StoredPacketIterator packet_it) {
+    PacketSlot* slot) {
   // Move the packet out from the StoredPacket container.
-  std::unique_ptr<RtpPacketToSend> rtp_packet =
-      std::move(packet_it->second.packet);
-  // Erase the packet from the map, and capture iterator to the next one.
-  StoredPacketIterator next_it = packet_history_.erase(packet_it);
-
-  // |next_it| now points to the next element, or to the end. If the end,
-  // check if we can wrap around.
-  if (next_it == packet_history_.end()) {
-    next_it = packet_history_.begin();
-  }
+  std::unique_ptr<RtpPacketToSend> rtp_packet = std::move(slot->stored.packet);
+  slot->stored = StoredPacket();
+  PublishSlot(slot);
+  --num_packets_;
 
-  // Update |start_seq_no| to the new oldest item.
-  if (next_it != packet_history_.end()) {
-    start_seqno_ = next_it->first;
-  } else {
+  if (num_packets_ == 0) {
     start_seqno_.reset();
+  } else if (rtp_packet->SequenceNumber() == *start_seqno_) {
+    // Update |start_seq_no| to the next stored packet, which is the new
+    // oldest item.
+    Ring* ring = ring_.load(std::memory_order_relaxed);
+    for (size_t i = 1; i < ring->capacity(); ++i) {
+      const StoredPacket& next =
+          ring->at(static_cast<uint16_t>(*start_seqno_ + i)).stored;
+      if (next.packet) {
+        start_seqno_ = next.packet->SequenceNumber();
+        break;
+      }
+    }
   }
 
   return rtp_packet;
 }
 
+void RtpPacketHistory::DropPacket(PacketSlot* slot) {
+  std::unique_ptr<RtpPacketToSend> rtp_packet = RemovePacket(slot);
+  if (packet_pool_)
+    packet_pool_->Recycle(std::move(rtp_packet));
+}
+
+// static
+void RtpPacketHistory::PublishSlot(PacketSlot* slot) {
+  const StoredPacket& stored = slot->stored;
+  uint32_t version = slot->version.load(std::memory_order_relaxed);
+  slot->version.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  if (stored.packet) {
+    slot->sequence_number.store(stored.packet->SequenceNumber(),
+                                std::memory_order_relaxed);
+    slot->send_time_ms.store(stored.send_time_ms.value_or(-1),
+                             std::memory_order_relaxed);
+    slot->capture_time_ms.store(stored.packet->capture_time_ms(),
+                                std::memory_order_relaxed);
+    slot->ssrc.store(stored.packet->Ssrc(), std::memory_order_relaxed);
+    slot->payload_size.store(stored.packet->size(), std::memory_order_relaxed);
+    slot->times_retransmitted.store(stored.times_retransmitted,
+                                    std::memory_order_relaxed);
+  } else {
+    slot->sequence_number.store(-1, std::memory_order_relaxed);
+  }
+  slot->version.store(version + 2, std::memory_order_release);
+}
+
 RtpPacketHistory::PacketState RtpPacketHistory::StoredPacketToPacketState(
     const RtpPacketHistory::StoredPacket& stored_packet) {
   RtpPacketHistory::PacketState state;
@@ -11,7 +11,7 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 #define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 
-#include <map>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -24,6 +24,7 @@ namespace webrtc {
 
 class Clock;
 class RtpPacketToSend;
+class RtpPacketToSendPool;
 
 class RtpPacketHistory {
  public:
@@ -58,6 +59,9 @@ class RtpPacketHistory {
   static constexpr int kPacketCullingDelayFactor = 3;
 
   explicit RtpPacketHistory(Clock* clock);
+  // Packets removed from the history are added to |packet_pool|, if not null,
+  // which must outlive the history.
+  RtpPacketHistory(Clock* clock, RtpPacketToSendPool* packet_pool);
   ~RtpPacketHistory();
 
   // Set/get storage mode. Note that setting the state will clear the history,
@@ -83,7 +87,9 @@ class RtpPacketHistory {
       bool verify_rtt);
 
   // Similar to GetPacketAndSetSendTime(), but only returns a snapshot of the
-  // current state for packet, and never updates internal state.
+  // current state for packet, and never updates internal state. This does not
+  // take the history lock, so NACK handling does not contend with the send
+  // path.
   absl::optional<PacketState> GetPacketState(uint16_t sequence_number,
                                              bool verify_rtt) const;
 
@@ -113,29 +119,81 @@ class RtpPacketHistory {
     std::unique_ptr<RtpPacketToSend> packet;
   };
 
-  using StoredPacketIterator = std::map<uint16_t, StoredPacket>::iterator;
+  // A slot in the ring of stored packets. |stored| is guarded by |lock_|.
+  // The state returned by GetPacketState() is mirrored in atomics behind a
+  // sequence lock, so that it can be read without taking |lock_|.
+  struct PacketSlot {
+    PacketSlot();
+    ~PacketSlot();
+
+    // Odd while the mirrored state is being updated.
+    std::atomic<uint32_t> version;
+    // The sequence number of the stored packet, or -1 if the slot is empty.
+    std::atomic<int32_t> sequence_number;
+    // -1 if the packet has not been sent.
+    std::atomic<int64_t> send_time_ms;
+    std::atomic<int64_t> capture_time_ms;
+    std::atomic<uint32_t> ssrc;
+    std::atomic<size_t> payload_size;
+    std::atomic<size_t> times_retransmitted;
+
+    StoredPacket stored;
+  };
+
+  // Fixed-capacity ring of packets, indexed by sequence number modulo the
+  // capacity.
+  struct Ring {
+    explicit Ring(size_t capacity);
+    ~Ring();
+
+    size_t capacity() const { return mask + 1; }
+    PacketSlot& at(uint16_t sequence_number) {
+      return slots[sequence_number & mask];
+    }
+
+    const size_t mask;
+    const std::unique_ptr<PacketSlot[]> slots;
+  };
 
   // Helper method used by GetPacketAndSetSendTime() and GetPacketState() to
   // check if packet has too recently been sent.
-  bool VerifyRtt(const StoredPacket& packet, int64_t now_ms) const
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  bool VerifyRtt(absl::optional<int64_t> send_time_ms,
+                 size_t times_retransmitted,
+                 int64_t now_ms) const;
   void Reset() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void CullOldPackets(int64_t now_ms) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the slot holding |sequence_number|, or null if it is not stored.
+  PacketSlot* FindPacket(uint16_t sequence_number)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   // Removes the packet from the history, and context/mapping that has been
   // stored. Returns the RTP packet instance contained within the StoredPacket.
-  std::unique_ptr<RtpPacketToSend> RemovePacket(StoredPacketIterator packet)
+  std::unique_ptr<RtpPacketToSend> RemovePacket(PacketSlot* slot)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Removes the packet and adds it to |packet_pool_|.
+  void DropPacket(PacketSlot* slot) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Copies the state of |slot->stored| to its atomic mirror.
+  static void PublishSlot(PacketSlot* slot);
   static PacketState StoredPacketToPacketState(
       const StoredPacket& stored_packet);
 
   Clock* const clock_;
+  RtpPacketToSendPool* const packet_pool_;
   rtc::CriticalSection lock_;
   size_t number_to_store_ RTC_GUARDED_BY(lock_);
   StorageMode mode_ RTC_GUARDED_BY(lock_);
-  int64_t rtt_ms_ RTC_GUARDED_BY(lock_);
-
-  // Map from rtp sequence numbers to stored packet.
-  std::map<uint16_t, StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
+  // Mirrors of |mode_| != kDisabled and the RTT, for GetPacketState().
+  std::atomic<bool> enabled_;
+  std::atomic<int64_t> rtt_ms_;
+
+  // The ring currently in use, or null before storage is first enabled. A
+  // ring is replaced only if SetStorePacketsStatus() needs a larger one. The
+  // old ones are kept in |rings_| until destruction, since GetPacketState()
+  // may still be reading them.
+  std::atomic<Ring*> ring_;
+  std::vector<std::unique_ptr<Ring>> rings_ RTC_GUARDED_BY(lock_);
+  // The number of packets stored in |ring_|, never more than |max_packets_|.
+  size_t num_packets_ RTC_GUARDED_BY(lock_);
+  size_t max_packets_ RTC_GUARDED_BY(lock_);
 
   // The earliest packet in the history. This might not be the lowest sequence
   // number, in case there is a wraparound.
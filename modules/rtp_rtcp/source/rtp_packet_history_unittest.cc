@@ -15,6 +15,8 @@
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
+#include "rtc_base/platform_thread.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gtest.h"
 
@@ -363,6 +365,26 @@ TEST_F(RtpPacketHistoryTest, DontRemoveUnsentPackets) {
   EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 2), false));
 }
 
+TEST_F(RtpPacketHistoryTest, AddsRemovedPacketsToPool) {
+  const size_t kMaxNumPackets = 10;
+  RtpPacketToSendPool pool;
+  RtpPacketHistory hist(&fake_clock_, &pool);
+  hist.SetStorePacketsStatus(StorageMode::kStore, kMaxNumPackets);
+
+  for (size_t i = 0; i < kMaxNumPackets; ++i) {
+    hist.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + i)),
+                      kAllowRetransmission, fake_clock_.TimeInMilliseconds());
+  }
+  EXPECT_EQ(0u, pool.size());
+
+  // The oldest packet is removed to make room for the new one.
+  fake_clock_.AdvanceTimeMilliseconds(RtpPacketHistory::kMinPacketDurationMs);
+  hist.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + kMaxNumPackets)),
+                    kAllowRetransmission, fake_clock_.TimeInMilliseconds());
+  EXPECT_FALSE(hist.GetPacketState(kStartSeqNum, false));
+  EXPECT_EQ(1u, pool.size());
+}
+
 TEST_F(RtpPacketHistoryTest, DontRemoveTooRecentlyTransmittedPackets) {
   // Set size to remove old packets as soon as possible.
   hist_.SetStorePacketsStatus(StorageMode::kStore, 1);
@@ -488,4 +510,59 @@ TEST_F(RtpPacketHistoryTest, GetBestFittingPacket) {
   EXPECT_EQ(target_packet_size,
             hist_.GetBestFittingPacket(target_packet_size)->size());
 }
+
+TEST_F(RtpPacketHistoryTest, StoresNonContiguousSequenceNumbers) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+  const uint16_t kOtherSeqNum = To16u(kStartSeqNum + 1000);
+  hist_.PutRtpPacket(CreateRtpPacket(kStartSeqNum), kAllowRetransmission,
+                     absl::nullopt);
+  hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + 1)),
+                     kAllowRetransmission, absl::nullopt);
+  hist_.PutRtpPacket(CreateRtpPacket(kOtherSeqNum), kAllowRetransmission,
+                     absl::nullopt);
+  EXPECT_TRUE(hist_.GetPacketState(kOtherSeqNum, false));
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kOtherSeqNum + 1), false));
+  EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 1), false));
+  EXPECT_TRUE(hist_.GetPacketAndSetSendTime(kOtherSeqNum, false));
+}
+
+TEST_F(RtpPacketHistoryTest, GetPacketStateConcurrentWithPut) {
+  const size_t kMaxNumPackets = 10;
+  const uint16_t kNumPackets = 5000;
+  hist_.SetStorePacketsStatus(StorageMode::kStore, kMaxNumPackets);
+
+  struct Reader {
+    static void Run(void* context) {
+      Reader* reader = static_cast<Reader*>(context);
+      while (!reader->done.load()) {
+        for (uint16_t i = 0; i < kMaxNumPackets; ++i) {
+          uint16_t seq_num = To16u(reader->last_put.load() - i);
+          auto state = reader->hist->GetPacketState(seq_num, false);
+          if (state && state->rtp_sequence_number != seq_num)
+            reader->mismatches++;
+        }
+      }
+    }
+    RtpPacketHistory* hist;
+    std::atomic<uint16_t> last_put{kStartSeqNum};
+    std::atomic<bool> done{false};
+    std::atomic<int> mismatches{0};
+  } reader;
+  reader.hist = &hist_;
+  rtc::PlatformThread thread(&Reader::Run, &reader, "Reader");
+  thread.Start();
+
+  for (uint16_t i = 0; i < kNumPackets; ++i) {
+    uint16_t seq_num = To16u(kStartSeqNum + i);
+    hist_.PutRtpPacket(CreateRtpPacket(seq_num), kAllowRetransmission,
+                       fake_clock_.TimeInMilliseconds());
+    reader.last_put.store(seq_num);
+    fake_clock_.AdvanceTimeMilliseconds(1);
+  }
+  reader.done.store(true);
+  thread.Stop();
+  EXPECT_EQ(0, reader.mismatches.load());
+  EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + kNumPackets - 1),
+                                   false));
+}
 }  // namespace webrtc
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+
+namespace webrtc {
+
+constexpr size_t RtpPacketToSendPool::kMaxPackets;
+
+RtpPacketToSendPool::RtpPacketToSendPool() = default;
+
+RtpPacketToSendPool::~RtpPacketToSendPool() = default;
+
+std::unique_ptr<RtpPacketToSend> RtpPacketToSendPool::CopyHeader(
+    const RtpPacketToSend& header) {
+  std::unique_ptr<RtpPacketToSend> packet;
+  {
+    rtc::CritScope lock(&crit_);
+    if (!packets_.empty()) {
+      packet = std::move(packets_.back());
+      packets_.pop_back();
+    }
+  }
+  // A packet that is too small, e.g. after the max packet size is increased,
+  // is dropped.
+  if (!packet || packet->capacity() < header.capacity())
+    return absl::make_unique<RtpPacketToSend>(header);
+
+  // Writes the header to the buffer of the packet, unless copies of the packet
+  // still share it, e.g. in the packet history.
+  packet->CopyHeaderFrom(header);
+  packet->set_capture_time_ms(header.capture_time_ms());
+  packet->set_application_data(header.application_data());
+  return packet;
+}
+
+void RtpPacketToSendPool::Recycle(std::unique_ptr<RtpPacketToSend> packet) {
+  if (!packet)
+    return;
+  rtc::CritScope lock(&crit_);
+  if (packets_.size() < kMaxPackets)
+    packets_.push_back(std::move(packet));
+}
+
+size_t RtpPacketToSendPool::size() const {
+  rtc::CritScope lock(&crit_);
+  return packets_.size();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_POOL_H_
+#define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class RtpPacketToSend;
+
+// Keeps the packets of an RTPSender that are no longer used, once sent and
+// removed from the packet history, so that packetizing a frame reuses them and
+// their buffers instead of allocating new ones. Thread safe.
+class RtpPacketToSendPool {
+ public:
+  // Enough for the packets of a few large frames.
+  static constexpr size_t kMaxPackets = 512;
+
+  RtpPacketToSendPool();
+  ~RtpPacketToSendPool();
+
+  // Returns a packet with the header, capture time and application data of
+  // |header|, and at least its capacity. The header is copied to the buffer of
+  // a pooled packet if there is one, otherwise the packet is a copy of
+  // |header|.
+  std::unique_ptr<RtpPacketToSend> CopyHeader(const RtpPacketToSend& header);
+
+  // Adds |packet| to the pool, or deletes it if the pool is full.
+  void Recycle(std::unique_ptr<RtpPacketToSend> packet);
+
+  size_t size() const;
+
+ private:
+  rtc::CriticalSection crit_;
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpPacketToSendPool);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_POOL_H_
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kCapacity = 1200;
+constexpr uint32_t kSsrc = 0x12345678;
+constexpr uint8_t kTransmissionOffsetId = 1;
+
+std::unique_ptr<RtpPacketToSend> CreateHeader(
+    const RtpHeaderExtensionMap* extensions) {
+  auto header = absl::make_unique<RtpPacketToSend>(extensions, kCapacity);
+  header->SetPayloadType(96);
+  header->SetSequenceNumber(17);
+  header->SetTimestamp(0x1234);
+  header->SetSsrc(kSsrc);
+  header->ReserveExtension<TransmissionOffset>();
+  header->set_capture_time_ms(1000);
+  return header;
+}
+
+}  // namespace
+
+TEST(RtpPacketToSendPoolTest, CopiesHeaderWhenEmpty) {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetId);
+  std::unique_ptr<RtpPacketToSend> header = CreateHeader(&extensions);
+  RtpPacketToSendPool pool;
+
+  std::unique_ptr<RtpPacketToSend> packet = pool.CopyHeader(*header);
+  ASSERT_TRUE(packet);
+  EXPECT_EQ(header->Ssrc(), packet->Ssrc());
+  EXPECT_EQ(header->headers_size(), packet->headers_size());
+  EXPECT_EQ(1000, packet->capture_time_ms());
+  EXPECT_TRUE(packet->HasExtension<TransmissionOffset>());
+}
+
+TEST(RtpPacketToSendPoolTest, ReusesBufferOfRecycledPacket) {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetId);
+  std::unique_ptr<RtpPacketToSend> header = CreateHeader(&extensions);
+  RtpPacketToSendPool pool;
+
+  std::unique_ptr<RtpPacketToSend> sent = pool.CopyHeader(*header);
+  sent->SetPayloadSize(500);
+  sent->SetMarker(true);
+  const uint8_t* buffer = sent->data();
+  pool.Recycle(std::move(sent));
+  EXPECT_EQ(1u, pool.size());
+
+  std::unique_ptr<RtpPacketToSend> packet = pool.CopyHeader(*header);
+  EXPECT_EQ(0u, pool.size());
+  EXPECT_EQ(buffer, packet->data());
+  EXPECT_FALSE(packet->Marker());
+  EXPECT_EQ(0u, packet->payload_size());
+  EXPECT_EQ(header->headers_size(), packet->size());
+  EXPECT_TRUE(packet->HasExtension<TransmissionOffset>());
+}
+
+TEST(RtpPacketToSendPoolTest, DoesNotReuseSmallerPacket) {
+  RtpPacketToSendPool pool;
+  pool.Recycle(absl::make_unique<RtpPacketToSend>(nullptr, kCapacity / 2));
+
+  std::unique_ptr<RtpPacketToSend> packet =
+      pool.CopyHeader(RtpPacketToSend(nullptr, kCapacity));
+  EXPECT_GE(packet->capacity(), kCapacity);
+  EXPECT_EQ(0u, pool.size());
+}
+
+TEST(RtpPacketToSendPoolTest, HoldsAtMostMaxPackets) {
+  RtpPacketToSendPool pool;
+  for (size_t i = 0; i < RtpPacketToSendPool::kMaxPackets + 1; ++i)
+    pool.Recycle(absl::make_unique<RtpPacketToSend>(nullptr));
+  EXPECT_EQ(RtpPacketToSendPool::kMaxPackets, pool.size());
+}
+
+}  // namespace webrtc
@@ -235,6 +235,44 @@ TEST(RtpPacketTest, SetReservedExtensionsAfterPayload) {
   EXPECT_TRUE(packet.SetExtension<TransmissionOffset>(kTimeOffset));
 }
 
+TEST(RtpPacketTest, ReserveExtensionsAtOnce) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  extensions.Register(kRtpExtensionAudioLevel, kAudioLevelExtensionId);
+  RtpPacketToSend one_by_one(&extensions);
+  EXPECT_TRUE(one_by_one.ReserveExtension<TransmissionOffset>());
+  EXPECT_TRUE(one_by_one.ReserveExtension<AudioLevel>());
+  RtpPacketToSend at_once(&extensions);
+  EXPECT_TRUE((at_once.ReserveExtensions<TransmissionOffset, AudioLevel>()));
+
+  EXPECT_THAT(make_tuple(at_once.data(), at_once.size()),
+              ElementsAreArray(one_by_one.data(), one_by_one.size()));
+  EXPECT_TRUE(at_once.SetExtension<TransmissionOffset>(kTimeOffset));
+  EXPECT_TRUE(at_once.SetExtension<AudioLevel>(kVoiceActive, kAudioLevel));
+  at_once.SetPayloadType(kPayloadType);
+  at_once.SetSequenceNumber(kSeqNum);
+  at_once.SetTimestamp(kTimestamp);
+  at_once.SetSsrc(kSsrc);
+  EXPECT_THAT(kPacketWithTOAndAL,
+              ElementsAreArray(at_once.data(), at_once.size()));
+}
+
+TEST(RtpPacketTest, ReserveExtensionsSkipsUnregisteredOnes) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  RtpPacketToSend packet(&extensions);
+
+  EXPECT_FALSE((packet.ReserveExtensions<AudioLevel, TransmissionOffset>()));
+  EXPECT_TRUE(packet.HasExtension<TransmissionOffset>());
+  EXPECT_FALSE(packet.HasExtension<AudioLevel>());
+  // Reserving again keeps the extensions in place.
+  size_t size = packet.size();
+  EXPECT_TRUE(packet.ReserveExtensions<TransmissionOffset>());
+  EXPECT_EQ(size, packet.size());
+}
+
 TEST(RtpPacketTest, CreatePurePadding) {
   const size_t kPaddingSize = kMaxPaddingSize - 1;
   RtpPacketToSend packet(nullptr, 12 + kPaddingSize);
@@ -403,6 +441,70 @@ TEST(RtpPacketTest, ParseWithExtensionDelayed) {
   EXPECT_EQ(0u, packet.padding_size());
 }
 
+TEST(RtpPacketTest, ParseWithLazyExtensions) {
+  RtpPacketReceived packet;
+  EXPECT_TRUE(packet.ParseWithLazyExtensions(
+      rtc::CopyOnWriteBuffer(kPacketWithTOAndAL)));
+  EXPECT_EQ(kSeqNum, packet.SequenceNumber());
+  EXPECT_EQ(kSsrc, packet.Ssrc());
+  EXPECT_EQ(0u, packet.payload_size());
+
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  extensions.Register(kRtpExtensionAudioLevel, kAudioLevelExtensionId);
+  packet.IdentifyExtensions(extensions);
+
+  int32_t time_offset;
+  EXPECT_TRUE(packet.GetExtension<TransmissionOffset>(&time_offset));
+  EXPECT_EQ(kTimeOffset, time_offset);
+  bool voice_active;
+  uint8_t audio_level;
+  EXPECT_TRUE(packet.GetExtension<AudioLevel>(&voice_active, &audio_level));
+  EXPECT_EQ(kVoiceActive, voice_active);
+  EXPECT_EQ(kAudioLevel, audio_level);
+  EXPECT_FALSE(packet.HasExtension<AbsoluteSendTime>());
+}
+
+TEST(RtpPacketTest, ParseWithLazyExtensionsIgnoresInvalidExtension) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  RtpPacketReceived packet(&extensions);
+  EXPECT_TRUE(packet.ParseWithLazyExtensions(
+      rtc::CopyOnWriteBuffer(kPacketWithInvalidExtension)));
+
+  EXPECT_THAT(packet.payload(), ElementsAreArray(kPayload));
+  int32_t time_offset;
+  EXPECT_FALSE(packet.GetExtension<TransmissionOffset>(&time_offset));
+}
+
+TEST(RtpPacketTest, ParseWithLazyExtensionsFailsOnTruncatedExtension) {
+  RtpPacketReceived packet;
+  EXPECT_FALSE(packet.ParseWithLazyExtensions(
+      rtc::CopyOnWriteBuffer(kPacketWithTO, sizeof(kPacketWithTO) - 1)));
+}
+
+TEST(RtpPacketTest, CopyHeaderFromLazilyParsedPacket) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  extensions.Register(kRtpExtensionAudioLevel, kAudioLevelExtensionId);
+  RtpPacketReceived received(&extensions);
+  EXPECT_TRUE(received.ParseWithLazyExtensions(
+      rtc::CopyOnWriteBuffer(kPacketWithTO)));
+
+  RtpPacketToSend packet(&extensions);
+  packet.CopyHeaderFrom(received);
+  int32_t time_offset;
+  EXPECT_TRUE(packet.GetExtension<TransmissionOffset>(&time_offset));
+  EXPECT_EQ(kTimeOffset, time_offset);
+  // Extensions can still be added after the copied ones.
+  EXPECT_TRUE(packet.SetExtension<AudioLevel>(kVoiceActive, kAudioLevel));
+  EXPECT_THAT(kPacketWithTOAndAL,
+              ElementsAreArray(packet.data(), packet.size()));
+}
+
 TEST(RtpPacketTest, ParseDynamicSizeExtension) {
   // clang-format off
   const uint8_t kPacket1[] = {
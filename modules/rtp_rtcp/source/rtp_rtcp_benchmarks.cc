@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "modules/include/module_common_types.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/fec_test_helper.h"
+#include "modules/rtp_rtcp/source/forward_error_correction.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "modules/rtp_rtcp/source/rtp_format_h264.h"
+#include "modules/rtp_rtcp/source/rtp_format_vp8.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+namespace {
+
+const uint32_t kSsrc = 0x12345678;
+const size_t kMaxPayloadSize = 1200;
+
+// A frame of |frame_size| bytes which is a single H.264 IDR NAL unit.
+std::vector<uint8_t> MakeFrame(size_t frame_size) {
+  std::vector<uint8_t> frame(frame_size);
+  for (size_t i = 0; i < frame_size; ++i)
+    frame[i] = static_cast<uint8_t>(i);
+  frame[0] = 0x65;  // NRI=3, Type=5.
+  return frame;
+}
+
+void BM_RtpPacketParse(benchmark::State& state) {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransmissionOffset>(1);
+  extensions.Register<AbsoluteSendTime>(2);
+  extensions.Register<TransportSequenceNumber>(3);
+  extensions.Register<VideoOrientation>(4);
+
+  RtpPacketToSend packet(&extensions);
+  packet.SetPayloadType(96);
+  packet.SetSequenceNumber(1);
+  packet.SetTimestamp(90000);
+  packet.SetSsrc(kSsrc);
+  packet.SetExtension<TransmissionOffset>(100);
+  packet.SetExtension<AbsoluteSendTime>(0x123456);
+  packet.SetExtension<TransportSequenceNumber>(42);
+  packet.SetExtension<VideoOrientation>(kVideoRotation_90);
+  packet.AllocatePayload(state.range(0));
+  const rtc::Buffer buffer(packet.data(), packet.size());
+
+  RtpPacketReceived received(&extensions);
+  for (auto _ : state) {
+    bool parsed = received.Parse(buffer.data(), buffer.size());
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_RtpPacketParse)->Arg(160)->Arg(kMaxPayloadSize);
+
+void BM_RtpPacketizerVp8(benchmark::State& state) {
+  RTPVideoHeaderVP8 header;
+  header.InitRTPVideoHeaderVP8();
+  header.pictureId = 1000;
+  header.tl0PicIdx = 10;
+  const std::vector<uint8_t> frame = MakeFrame(state.range(0));
+  RtpPacketToSend packet(nullptr);
+
+  for (auto _ : state) {
+    RtpPacketizerVp8 packetizer(header, kMaxPayloadSize, 0);
+    size_t num_packets =
+        packetizer.SetPayloadData(frame.data(), frame.size(), nullptr);
+    for (size_t i = 0; i < num_packets; ++i)
+      packetizer.NextPacket(&packet);
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+BENCHMARK(BM_RtpPacketizerVp8)->Arg(1000)->Arg(50000);
+
+void BM_RtpPacketizerH264(benchmark::State& state) {
+  const std::vector<uint8_t> frame = MakeFrame(state.range(0));
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(1);
+  fragmentation.fragmentationOffset[0] = 0;
+  fragmentation.fragmentationLength[0] = frame.size();
+  RtpPacketToSend packet(nullptr);
+
+  for (auto _ : state) {
+    RtpPacketizerH264 packetizer(kMaxPayloadSize, 0,
+                                 H264PacketizationMode::NonInterleaved);
+    size_t num_packets =
+        packetizer.SetPayloadData(frame.data(), frame.size(), &fragmentation);
+    for (size_t i = 0; i < num_packets; ++i)
+      packetizer.NextPacket(&packet);
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+BENCHMARK(BM_RtpPacketizerH264)->Arg(1000)->Arg(50000);
+
+// Protects a frame of range(0) media packets with range(1) / 255 overhead.
+void BM_ForwardErrorCorrectionEncode(benchmark::State& state) {
+  Random random(0x1234);
+  test::fec::MediaPacketGenerator generator(kMaxPayloadSize / 2,
+                                            kMaxPayloadSize, kSsrc, &random);
+  const ForwardErrorCorrection::PacketList media_packets =
+      generator.ConstructMediaPackets(state.range(0));
+  std::unique_ptr<ForwardErrorCorrection> fec =
+      ForwardErrorCorrection::CreateUlpfec(kSsrc);
+  std::list<ForwardErrorCorrection::Packet*> fec_packets;
+
+  for (auto _ : state) {
+    fec_packets.clear();
+    fec->EncodeFec(media_packets, state.range(1), 0, false, kFecMaskRandom,
+                   &fec_packets);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ForwardErrorCorrectionEncode)
+    ->Args({4, 85})
+    ->Args({12, 85})
+    ->Args({12, 255});
+
+void BM_TransportFeedbackParse(benchmark::State& state) {
+  rtcp::TransportFeedback feedback;
+  feedback.SetSenderSsrc(kSsrc);
+  feedback.SetMediaSsrc(kSsrc + 1);
+  feedback.SetBase(1, 1000000);
+  feedback.SetFeedbackSequenceNumber(1);
+  int64_t receive_time_us = 1000000;
+  for (int i = 0; i < state.range(0); ++i) {
+    // Every 10th packet is lost.
+    if (i % 10 != 9)
+      RTC_CHECK(feedback.AddReceivedPacket(1 + i, receive_time_us));
+    receive_time_us += 250 * (1 + i % 7);
+  }
+  const rtc::Buffer buffer = feedback.Build();
+
+  for (auto _ : state) {
+    std::unique_ptr<rtcp::TransportFeedback> parsed =
+        rtcp::TransportFeedback::ParseFrom(buffer.data(), buffer.size());
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransportFeedbackParse)->Arg(20)->Arg(200);
+
+}  // namespace
+}  // namespace webrtc
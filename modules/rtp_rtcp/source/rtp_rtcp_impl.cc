@@ -447,6 +447,19 @@ bool ModuleRtpRtcpImpl::SendOutgoingData(
       expected_retransmission_time_ms);
 }
 
+bool ModuleRtpRtcpImpl::SendRtpPayload(int8_t payload_type,
+                                       bool marker,
+                                       uint16_t sequence_number,
+                                       uint32_t timestamp,
+                                       int64_t capture_time_ms,
+                                       rtc::ArrayView<const uint8_t> payload) {
+  if (!rtp_sender_)
+    return false;
+  rtcp_sender_.SetLastRtpTime(timestamp, capture_time_ms);
+  return rtp_sender_->SendRtpPayload(payload_type, marker, sequence_number,
+                                     timestamp, capture_time_ms, payload);
+}
+
 bool ModuleRtpRtcpImpl::TimeToSendPacket(uint32_t ssrc,
                                          uint16_t sequence_number,
                                          int64_t capture_time_ms,
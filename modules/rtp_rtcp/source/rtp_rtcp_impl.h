@@ -126,6 +126,13 @@ class ModuleRtpRtcpImpl : public RtpRtcp, public RTCPReceiver::ModuleRtpRtcp {
                         const RTPVideoHeader* rtp_video_header,
                         uint32_t* transport_frame_id_out) override;
 
+  bool SendRtpPayload(int8_t payload_type,
+                      bool marker,
+                      uint16_t sequence_number,
+                      uint32_t timestamp,
+                      int64_t capture_time_ms,
+                      rtc::ArrayView<const uint8_t> payload) override;
+
   bool TimeToSendPacket(uint32_t ssrc,
                         uint16_t sequence_number,
                         int64_t capture_time_ms,
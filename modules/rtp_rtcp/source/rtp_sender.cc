@@ -17,6 +17,7 @@
 #include "absl/memory/memory.h"
 #include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
 #include "logging/rtc_event_log/rtc_event_log.h"
+#include "modules/include/module_common_types_public.h"
 #include "modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "modules/rtp_rtcp/include/rtp_cvo.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
@@ -133,8 +134,8 @@ RTPSender::RTPSender(
       last_payload_type_(-1),
       payload_type_map_(),
       rtp_header_extension_map_(),
-      packet_history_(clock),
-      flexfec_packet_history_(clock),
+      packet_history_(clock, &packet_pool_),
+      flexfec_packet_history_(clock, &packet_pool_),
       // Statistics
       rtp_stats_callback_(nullptr),
       total_bitrate_sent_(kBitrateStatisticsWindowMs,
@@ -819,15 +820,20 @@ bool RTPSender::PrepareAndSendPacket(std::unique_ptr<RtpPacketToSend> packet,
                        packet->Ssrc());
   }
 
-  if (!SendPacketToNetwork(*packet_to_send, options, pacing_info))
-    return false;
-
-  {
-    rtc::CritScope lock(&send_critsect_);
-    media_has_been_sent_ = true;
+  bool sent = SendPacketToNetwork(*packet_to_send, options, pacing_info);
+  if (sent) {
+    {
+      rtc::CritScope lock(&send_critsect_);
+      media_has_been_sent_ = true;
+    }
+    UpdateRtpStats(*packet_to_send, send_over_rtx, is_retransmit);
   }
-  UpdateRtpStats(*packet_to_send, send_over_rtx, is_retransmit);
-  return true;
+
+  // The packet is either a copy of the one in the packet history or has been
+  // removed from it, so it can be reused to packetize the next frames.
+  packet_pool_.Recycle(std::move(packet));
+  packet_pool_.Recycle(std::move(packet_rtx));
+  return sent;
 }
 
 void RTPSender::UpdateRtpStats(const RtpPacketToSend& packet,
@@ -965,6 +971,8 @@ bool RTPSender::SendToNetwork(std::unique_ptr<RtpPacketToSend> packet,
   if (storage == kAllowRetransmission) {
     RTC_DCHECK_EQ(ssrc, SSRC());
     packet_history_.PutRtpPacket(std::move(packet), storage, now_ms);
+  } else {
+    packet_pool_.Recycle(std::move(packet));
   }
 
   return sent;
@@ -1054,6 +1062,42 @@ void RTPSender::GetDataCounters(StreamDataCounters* rtp_stats,
   *rtx_stats = rtx_rtp_stats_;
 }
 
+bool RTPSender::SendRtpPayload(int8_t payload_type,
+                               bool marker,
+                               uint16_t sequence_number,
+                               uint32_t timestamp,
+                               int64_t capture_time_ms,
+                               rtc::ArrayView<const uint8_t> payload) {
+  std::unique_ptr<RtpPacketToSend> packet = AllocatePacket();
+  if (payload.size() > packet->FreeCapacity())
+    return false;
+  packet->SetPayloadType(payload_type);
+  packet->SetMarker(marker);
+  packet->SetSequenceNumber(sequence_number);
+  packet->SetTimestamp(timestamp);
+  packet->set_capture_time_ms(capture_time_ms);
+  memcpy(packet->AllocatePayload(payload.size()), payload.data(),
+         payload.size());
+  {
+    rtc::CritScope lock(&send_critsect_);
+    if (!sending_media_)
+      return false;
+    // Keeps the state that padding is based on at the newest packet, as
+    // AssignSequenceNumber() does.
+    if (sequence_number == sequence_number_ ||
+        IsNewerSequenceNumber(sequence_number, sequence_number_)) {
+      sequence_number_ = sequence_number + 1;
+      last_packet_marker_bit_ = marker;
+      last_payload_type_ = payload_type;
+      last_rtp_timestamp_ = timestamp;
+      last_timestamp_time_ms_ = clock_->TimeInMilliseconds();
+      capture_time_ms_ = capture_time_ms;
+    }
+  }
+  return SendToNetwork(std::move(packet), kAllowRetransmission,
+                       RtpPacketSender::kNormalPriority);
+}
+
 std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   rtc::CritScope lock(&send_critsect_);
   std::unique_ptr<RtpPacketToSend> packet(
@@ -1062,9 +1106,8 @@ std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   packet->SetSsrc(*ssrc_);
   packet->SetCsrcs(csrcs_);
   // Reserve extensions, if registered, RtpSender set in SendToNetwork.
-  packet->ReserveExtension<AbsoluteSendTime>();
-  packet->ReserveExtension<TransmissionOffset>();
-  packet->ReserveExtension<TransportSequenceNumber>();
+  packet->ReserveExtensions<AbsoluteSendTime, TransmissionOffset,
+                            TransportSequenceNumber>();
   if (playout_delay_oracle_.send_playout_delay()) {
     packet->SetExtension<PlayoutDelayLimits>(
         playout_delay_oracle_.playout_delay());
@@ -1076,6 +1119,11 @@ std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   return packet;
 }
 
+std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacketWithHeader(
+    const RtpPacketToSend& header) {
+  return packet_pool_.CopyHeader(header);
+}
+
 bool RTPSender::AssignSequenceNumber(RtpPacketToSend* packet) {
   rtc::CritScope lock(&send_critsect_);
   if (!sending_media_)
@@ -1215,10 +1263,17 @@ std::unique_ptr<RtpPacketToSend> RTPSender::BuildRtxPacket(
     const RtpPacketToSend& packet) {
   // TODO(danilchap): Create rtx packet with extra capacity for SRTP
   // when transport interface would be updated to take buffer class.
-  std::unique_ptr<RtpPacketToSend> rtx_packet(new RtpPacketToSend(
-      &rtp_header_extension_map_, packet.size() + kRtxHeaderSize));
-  // Add original RTP header.
-  rtx_packet->CopyHeaderFrom(packet);
+  // The original RTP header is written to the buffer of a pooled packet, so
+  // that retransmissions and redundant payloads don't allocate. Full size
+  // packets don't fit with the OSN in the buffers of media packets, so they
+  // get a larger packet, which is then pooled too.
+  std::unique_ptr<RtpPacketToSend> rtx_packet = packet_pool_.CopyHeader(packet);
+  if (rtx_packet->capacity() < packet.size() + kRtxHeaderSize) {
+    packet_pool_.Recycle(std::move(rtx_packet));
+    rtx_packet.reset(new RtpPacketToSend(&rtp_header_extension_map_,
+                                         packet.size() + kRtxHeaderSize));
+    rtx_packet->CopyHeaderFrom(packet);
+  }
   {
     rtc::CritScope lock(&send_critsect_);
     if (!sending_media_)
@@ -26,6 +26,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/playout_delay_oracle.h"
 #include "modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
 #include "modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "modules/rtp_rtcp/source/rtp_utility.h"
 #include "rtc_base/constructormagic.h"
@@ -159,6 +160,10 @@ class RTPSender {
   // Create empty packet, fills ssrc, csrcs and reserve place for header
   // extensions RtpSender updates before sending.
   std::unique_ptr<RtpPacketToSend> AllocatePacket() const;
+  // Returns a packet with the header of |header|, reusing the buffer of a
+  // packet that has been sent and is no longer in the packet history, if any.
+  std::unique_ptr<RtpPacketToSend> AllocatePacketWithHeader(
+      const RtpPacketToSend& header);
   // Allocate sequence number for provided packet.
   // Save packet's fields to generate padding that doesn't break media stream.
   // Return false if sending was turned off.
@@ -178,6 +183,15 @@ class RTPSender {
                      StorageType storage,
                      RtpPacketSender::Priority priority);
 
+  // Packs |payload| into a packet of this sender and sends it, as
+  // RtpRtcp::SendRtpPayload().
+  bool SendRtpPayload(int8_t payload_type,
+                      bool marker,
+                      uint16_t sequence_number,
+                      uint32_t timestamp,
+                      int64_t capture_time_ms,
+                      rtc::ArrayView<const uint8_t> payload);
+
   // Audio.
 
   // Send a DTMF tone using RFC 2833 (4733).
@@ -288,6 +302,8 @@ class RTPSender {
   // delay extension on header.
   PlayoutDelayOracle playout_delay_oracle_;
 
+  // Must outlive the packet histories, which add dropped packets to it.
+  RtpPacketToSendPool packet_pool_;
   RtpPacketHistory packet_history_;
   // TODO(brandtr): Remove |flexfec_packet_history_| when the FlexfecSender
   // is hooked up to the PacedSender.
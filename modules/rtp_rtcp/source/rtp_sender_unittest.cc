@@ -19,6 +19,7 @@
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "modules/rtp_rtcp/include/rtp_header_parser.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "modules/rtp_rtcp/source/rtp_format_video_generic.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
@@ -996,6 +997,25 @@ TEST_P(RtpSenderTestWithoutPacer, SendGenericVideo) {
   EXPECT_THAT(sent_payload.subview(1), ElementsAreArray(payload));
 }
 
+TEST_P(RtpSenderTestWithoutPacer, SendsRtpPayloadWithGivenSequenceNumber) {
+  const uint8_t payload[] = {47, 11, 32};
+  ASSERT_TRUE(rtp_sender_->SendRtpPayload(kPayload, true, kSeqNum + 5, 1234,
+                                          4321, payload));
+  const RtpPacketReceived& sent = transport_.last_sent_packet();
+  EXPECT_EQ(kSeqNum + 5, sent.SequenceNumber());
+  EXPECT_EQ(1234u, sent.Timestamp());
+  EXPECT_EQ(kSsrc, sent.Ssrc());
+  EXPECT_TRUE(sent.Marker());
+  EXPECT_THAT(sent.payload(), ElementsAreArray(payload));
+  EXPECT_EQ(kSeqNum + 6, rtp_sender_->SequenceNumber());
+
+  // A reordered packet doesn't move the sequence number back.
+  ASSERT_TRUE(rtp_sender_->SendRtpPayload(kPayload, false, kSeqNum + 3, 1234,
+                                          4321, payload));
+  EXPECT_EQ(kSeqNum + 3, transport_.last_sent_packet().SequenceNumber());
+  EXPECT_EQ(kSeqNum + 6, rtp_sender_->SequenceNumber());
+}
+
 TEST_P(RtpSenderTest, SendFlexfecPackets) {
   constexpr int kMediaPayloadType = 127;
   constexpr int kFlexfecPayloadType = 118;
@@ -1652,6 +1672,55 @@ TEST_P(RtpSenderTestWithoutPacer, BytesReportedCorrectly) {
       rtp_stats.transmitted.TotalBytes() + rtx_stats.transmitted.TotalBytes());
 }
 
+TEST_P(RtpSenderTestWithoutPacer, RtxPacketsCarryPayloadOfOriginalPacket) {
+  const uint32_t kRtxSsrc = 1234;
+  rtp_sender_->SetStorePacketsStatus(true, 10);
+  rtp_sender_->SetRtxSsrc(kRtxSsrc);
+  rtp_sender_->SetRtxPayloadType(kRtxPayload, kPayload);
+  rtp_sender_->SetRtxStatus(kRtxRetransmitted);
+
+  // Packets of decreasing size, so that RTX packets built in the pooled
+  // buffers of earlier ones must not carry over any of their bytes.
+  const size_t kPayloadSizes[] = {900, 300, 20};
+  const size_t kNumPackets = arraysize(kPayloadSizes);
+  std::vector<uint16_t> sequence_numbers;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    auto packet = BuildRtpPacket(kPayload, kMarkerBit, kTimestamp,
+                                 fake_clock_.TimeInMilliseconds());
+    uint8_t* payload = packet->AllocatePayload(kPayloadSizes[i]);
+    for (size_t j = 0; j < kPayloadSizes[i]; ++j)
+      payload[j] = static_cast<uint8_t>(i + j);
+    sequence_numbers.push_back(packet->SequenceNumber());
+    EXPECT_TRUE(rtp_sender_->SendToNetwork(std::move(packet),
+                                           kAllowRetransmission,
+                                           RtpPacketSender::kNormalPriority));
+  }
+
+  for (int round = 0; round < 2; ++round) {
+    fake_clock_.AdvanceTimeMilliseconds(100);
+    for (uint16_t sequence_number : sequence_numbers)
+      EXPECT_GT(rtp_sender_->ReSendPacket(sequence_number), 0);
+  }
+
+  ASSERT_EQ(static_cast<int>(3 * kNumPackets), transport_.packets_sent());
+  for (size_t i = kNumPackets; i < 3 * kNumPackets; ++i) {
+    const RtpPacketReceived& original =
+        transport_.sent_packets_[i % kNumPackets];
+    const RtpPacketReceived& rtx = transport_.sent_packets_[i];
+    EXPECT_EQ(kRtxSsrc, rtx.Ssrc());
+    EXPECT_EQ(kRtxPayload, rtx.PayloadType());
+    EXPECT_EQ(original.Timestamp(), rtx.Timestamp());
+    EXPECT_EQ(transport_.sent_packets_[kNumPackets].SequenceNumber() +
+                  i - kNumPackets,
+              rtx.SequenceNumber());
+    ASSERT_EQ(original.payload_size() + kRtxHeaderSize, rtx.payload_size());
+    EXPECT_EQ(original.SequenceNumber(),
+              ByteReader<uint16_t>::ReadBigEndian(rtx.payload().data()));
+    EXPECT_THAT(rtx.payload().subview(kRtxHeaderSize),
+                ElementsAreArray(original.payload()));
+  }
+}
+
 TEST_P(RtpSenderTestWithoutPacer, RespectsNackBitrateLimit) {
   const int32_t kPacketSize = 1400;
   const int32_t kNumPackets = 30;
@@ -10,6 +10,9 @@
 
 #include "modules/utility/source/process_thread_impl.h"
 
+#include <iterator>
+#include <utility>
+
 #include "modules/include/module.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/task_queue.h"
@@ -97,10 +100,9 @@ void ProcessThreadImpl::WakeUp(Module* module) {
   // Allowed to be called on any thread.
   {
     rtc::CritScope lock(&lock_);
-    for (ModuleCallback& m : modules_) {
-      if (m.module == module)
-        m.next_callback = kCallProcessImmediately;
-    }
+    auto it = module_index_.find(module);
+    if (it != module_index_.end())
+      Schedule(&*it->second, kCallProcessImmediately);
   }
   wake_up_->Set();
 }
@@ -140,6 +142,9 @@ void ProcessThreadImpl::RegisterModule(Module* module,
   {
     rtc::CritScope lock(&lock_);
     modules_.push_back(ModuleCallback(module, from));
+    module_index_[module] = std::prev(modules_.end());
+    // Queries the module on the next wake up.
+    Schedule(&modules_.back(), 0);
   }
 
   // Wake the thread calling ProcessThreadImpl::Process() to update the
@@ -154,14 +159,31 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
 
   {
     rtc::CritScope lock(&lock_);
-    modules_.remove_if(
-        [&module](const ModuleCallback& m) { return m.module == module; });
+    auto it = module_index_.find(module);
+    if (it != module_index_.end()) {
+      modules_.erase(it->second);
+      module_index_.erase(it);
+    }
   }
 
   // Notify the module that it's been detached.
   module->ProcessThreadAttached(nullptr);
 }
 
+void ProcessThreadImpl::Schedule(ModuleCallback* m, int64_t next_callback) {
+  m->next_callback = next_callback;
+  m->schedule_id = ++next_schedule_id_;
+  schedule_.push({next_callback, m->module, m->schedule_id});
+}
+
+ProcessThreadImpl::ModuleCallback* ProcessThreadImpl::FindCurrent(
+    const ScheduledCallback& entry) {
+  auto it = module_index_.find(entry.module);
+  if (it == module_index_.end() || it->second->schedule_id != entry.id)
+    return nullptr;
+  return &*it->second;
+}
+
 // static
 bool ProcessThreadImpl::Run(void* obj) {
   return static_cast<ProcessThreadImpl*>(obj)->Process();
@@ -176,33 +198,58 @@ bool ProcessThreadImpl::Process() {
     rtc::CritScope lock(&lock_);
     if (stop_)
       return false;
-    for (ModuleCallback& m : modules_) {
-      // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
-      // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
-      // operation should not require taking a lock, so querying all modules
-      // should run in a matter of nanoseconds.
-      if (m.next_callback == 0)
-        m.next_callback = GetNextCallbackTime(m.module, now);
-
-      if (m.next_callback <= now ||
-          m.next_callback == kCallProcessImmediately) {
-        {
-          TRACE_EVENT2("webrtc", "ModuleProcess", "function",
-                       m.location.function_name(), "file",
-                       m.location.file_and_line());
-          m.module->Process();
-        }
-        // Use a new 'now' reference to calculate when the next callback
-        // should occur.  We'll continue to use 'now' above for the baseline
-        // of calculating how long we should wait, to reduce variance.
-        int64_t new_now = rtc::TimeMillis();
-        m.next_callback = GetNextCallbackTime(m.module, new_now);
+    // Takes the modules that are due off the schedule before calling any of
+    // them, so that a module that is due again right away is called on the
+    // next wake up, and can't starve the tasks.
+    std::vector<ModuleCallback*> due;
+    while (!schedule_.empty()) {
+      ModuleCallback* m = FindCurrent(schedule_.top());
+      if (!m) {
+        schedule_.pop();
+        continue;
       }
+      if (m->next_callback == 0) {
+        // Just registered.
+        schedule_.pop();
+        Schedule(m, GetNextCallbackTime(m->module, now));
+        continue;
+      }
+      if (m->next_callback > now)
+        break;
+      schedule_.pop();
+      due.push_back(m);
+    }
+
+    for (ModuleCallback* m : due) {
+      {
+        TRACE_EVENT2("webrtc", "ModuleProcess", "function",
+                     m->location.function_name(), "file",
+                     m->location.file_and_line());
+        m->module->Process();
+      }
+      // Use a new 'now' reference to calculate when the next callback
+      // should occur.  We'll continue to use 'now' above for the baseline
+      // of calculating how long we should wait, to reduce variance.
+      int64_t new_now = rtc::TimeMillis();
+      Schedule(m, GetNextCallbackTime(m->module, new_now));
+    }
 
-      if (m.next_callback < next_checkpoint)
-        next_checkpoint = m.next_callback;
+    // Rebuilds the heap when out of date entries pile up, e.g. from frequent
+    // wake ups of modules that wait long between callbacks.
+    if (schedule_.size() > 2 * modules_.size() + 16) {
+      std::vector<ScheduledCallback> current;
+      current.reserve(modules_.size());
+      for (const ModuleCallback& m : modules_)
+        current.push_back({m.next_callback, m.module, m.schedule_id});
+      schedule_ = decltype(schedule_)(std::greater<ScheduledCallback>(),
+                                      std::move(current));
     }
 
+    // Out of date entries don't matter here, they can only wake the thread
+    // up early.
+    if (!schedule_.empty() && schedule_.top().next_callback < next_checkpoint)
+      next_checkpoint = schedule_.top().next_callback;
+
     while (!queue_.empty()) {
       rtc::QueuedTask* task = queue_.front();
       queue_.pop();
@@ -11,14 +11,18 @@
 #ifndef MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 #define MODULES_UTILITY_SOURCE_PROCESS_THREAD_IMPL_H_
 
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/location.h"
 #include "rtc_base/platform_thread.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
 #include "system_wrappers/include/event_wrapper.h"
 
@@ -55,6 +59,8 @@ class ProcessThreadImpl : public ProcessThread {
 
     Module* const module;
     int64_t next_callback = 0;  // Absolute timestamp.
+    // Identifies the entry of |schedule_| that is current for the module.
+    uint64_t schedule_id = 0;
     const rtc::Location location;
 
    private:
@@ -63,6 +69,27 @@ class ProcessThreadImpl : public ProcessThread {
 
   typedef std::list<ModuleCallback> ModuleList;
 
+  // An entry of the min-heap of next callback times. When a module is
+  // rescheduled or removed, its old entry is left in the heap, and dropped
+  // once it reaches the top, so that rescheduling costs O(log n).
+  struct ScheduledCallback {
+    bool operator>(const ScheduledCallback& other) const {
+      return next_callback > other.next_callback ||
+             (next_callback == other.next_callback && id > other.id);
+    }
+
+    int64_t next_callback;
+    Module* module;
+    uint64_t id;
+  };
+
+  // Sets when |m| is to be called next, and adds it to |schedule_|.
+  void Schedule(ModuleCallback* m, int64_t next_callback)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the module of |entry|, or null if |entry| is out of date.
+  ModuleCallback* FindCurrent(const ScheduledCallback& entry)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Warning: For some reason, if |lock_| comes immediately before |modules_|
   // with the current class layout, we will  start to have mysterious crashes
   // on Mac 10.9 debug.  I (Tommi) suspect we're hitting some obscure alignemnt
@@ -77,6 +104,15 @@ class ProcessThreadImpl : public ProcessThread {
   std::unique_ptr<rtc::PlatformThread> thread_;
 
   ModuleList modules_;
+  std::map<Module*, ModuleList::iterator> module_index_;
+  // Every module has one current entry, for when it is to be called next. On
+  // every wake up, only the modules that are due are taken from the top, so
+  // the cost of a wake up doesn't grow with the number of idle modules.
+  std::priority_queue<ScheduledCallback,
+                      std::vector<ScheduledCallback>,
+                      std::greater<ScheduledCallback>>
+      schedule_;
+  uint64_t next_schedule_id_ = 0;
   std::queue<rtc::QueuedTask*> queue_;
   bool stop_;
   const char* thread_name_;
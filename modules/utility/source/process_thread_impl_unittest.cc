@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "modules/include/module.h"
 #include "modules/utility/source/process_thread_impl.h"
@@ -300,6 +301,55 @@ TEST(ProcessThreadImpl, WakeUp) {
   EXPECT_LE(diff, 100u);
 }
 
+// Tests that modules which aren't due are neither processed nor queried again
+// while another module is processed over and over, and that waking up one of
+// them only processes that module.
+TEST(ProcessThreadImpl, OnlyDueModulesAreCalled) {
+  ProcessThreadImpl thread("ProcessThread");
+  std::unique_ptr<EventWrapper> busy_done(EventWrapper::Create());
+  std::unique_ptr<EventWrapper> idle_called(EventWrapper::Create());
+
+  const size_t kWokenModule = 42;
+  std::vector<std::unique_ptr<MockModule>> idle_modules;
+  for (size_t i = 0; i < 100; ++i) {
+    idle_modules.emplace_back(new MockModule());
+    MockModule* module = idle_modules.back().get();
+    if (i == kWokenModule) {
+      EXPECT_CALL(*module, TimeUntilNextProcess())
+          .Times(2)
+          .WillRepeatedly(Return(100000));
+      EXPECT_CALL(*module, Process())
+          .WillOnce(DoAll(SetEvent(idle_called.get()), Return()));
+    } else {
+      EXPECT_CALL(*module, TimeUntilNextProcess()).WillOnce(Return(100000));
+      EXPECT_CALL(*module, Process()).Times(0);
+    }
+    EXPECT_CALL(*module, ProcessThreadAttached(_)).Times(2);
+    thread.RegisterModule(module, RTC_FROM_HERE);
+  }
+
+  int process_count = 0;
+  MockModule busy_module;
+  EXPECT_CALL(busy_module, TimeUntilNextProcess()).WillRepeatedly(Return(1));
+  EXPECT_CALL(busy_module, Process())
+      .WillRepeatedly(Invoke([&process_count, &busy_done] {
+        if (++process_count == 10)
+          busy_done->Set();
+      }));
+  EXPECT_CALL(busy_module, ProcessThreadAttached(_)).Times(2);
+  thread.RegisterModule(&busy_module, RTC_FROM_HERE);
+
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, busy_done->Wait(kEventWaitTimeout));
+  thread.WakeUp(idle_modules[kWokenModule].get());
+  EXPECT_EQ(kEventSignaled, idle_called->Wait(kEventWaitTimeout));
+
+  thread.DeRegisterModule(&busy_module);
+  for (const std::unique_ptr<MockModule>& module : idle_modules)
+    thread.DeRegisterModule(module.get());
+  thread.Stop();
+}
+
 // Tests that we can post a task that gets run straight away on the worker
 // thread.
 TEST(ProcessThreadImpl, PostTask) {
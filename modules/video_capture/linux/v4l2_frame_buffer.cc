@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_capture/linux/v4l2_frame_buffer.h"
+
+#include <utility>
+
+#include "api/video/i420_buffer.h"
+#include "common_video/libyuv/include/parallel_libyuv.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace videocapturemodule {
+
+V4L2FrameBuffer::V4L2FrameBuffer(int width,
+                                 int height,
+                                 VideoType video_type,
+                                 const uint8_t* data,
+                                 size_t size,
+                                 int dmabuf_fd,
+                                 std::function<void()> on_released)
+    : width_(width),
+      height_(height),
+      video_type_(video_type),
+      data_(data),
+      size_(size),
+      dmabuf_fd_(dmabuf_fd),
+      on_released_(std::move(on_released)) {}
+
+V4L2FrameBuffer::~V4L2FrameBuffer() {
+  on_released_();
+}
+
+VideoFrameBuffer::Type V4L2FrameBuffer::type() const {
+  return Type::kNative;
+}
+
+int V4L2FrameBuffer::width() const {
+  return width_;
+}
+
+int V4L2FrameBuffer::height() const {
+  return height_;
+}
+
+rtc::scoped_refptr<I420BufferInterface> V4L2FrameBuffer::ToI420() {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width_, height_);
+  const int result = ParallelConvertToI420(video_type_, data_, size_, width_,
+                                          height_, buffer);
+  if (result < 0) {
+    RTC_LOG(LS_ERROR) << "Failed to convert capture frame from type "
+                      << static_cast<int>(video_type_) << " to I420.";
+    buffer->InitializeData();
+  }
+  return buffer;
+}
+
+}  // namespace videocapturemodule
+}  // namespace webrtc
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CAPTURE_LINUX_V4L2_FRAME_BUFFER_H_
+#define MODULES_VIDEO_CAPTURE_LINUX_V4L2_FRAME_BUFFER_H_
+
+#include <functional>
+
+#include "api/video/video_frame_buffer.h"
+#include "common_video/libyuv/include/webrtc_libyuv.h"
+
+namespace webrtc {
+namespace videocapturemodule {
+
+// Native frame buffer wrapping a buffer dequeued from a V4L2 capture device,
+// which is only converted to I420 when a sink calls ToI420. Sinks that can
+// use the captured format, e.g. hardware encoders importing |dmabuf_fd|,
+// avoid the conversion and the copy entirely. The device buffer is queued
+// again once the last reference to the frame buffer is released, so sinks
+// shouldn't keep the frames for long.
+class V4L2FrameBuffer : public VideoFrameBuffer {
+ public:
+  Type type() const override;
+  int width() const override;
+  int height() const override;
+  rtc::scoped_refptr<I420BufferInterface> ToI420() override;
+
+  VideoType video_type() const { return video_type_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  // DMABUF file descriptor of the device buffer, or -1 if the driver can't
+  // export it. Owned by the capture module.
+  int dmabuf_fd() const { return dmabuf_fd_; }
+
+ protected:
+  // |on_released| is called, on any thread, when the buffer is destroyed.
+  V4L2FrameBuffer(int width,
+                  int height,
+                  VideoType video_type,
+                  const uint8_t* data,
+                  size_t size,
+                  int dmabuf_fd,
+                  std::function<void()> on_released);
+  ~V4L2FrameBuffer() override;
+
+ private:
+  const int width_;
+  const int height_;
+  const VideoType video_type_;
+  const uint8_t* const data_;
+  const size_t size_;
+  const int dmabuf_fd_;
+  const std::function<void()> on_released_;
+};
+
+}  // namespace videocapturemodule
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CAPTURE_LINUX_V4L2_FRAME_BUFFER_H_
@@ -21,15 +21,82 @@
 #include <unistd.h>
 
 #include <new>
+#include <vector>
 
+#include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "media/base/videocommon.h"
+#include "modules/video_capture/linux/v4l2_frame_buffer.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/refcountedobject.h"
 #include "rtc_base/scoped_ref_ptr.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 namespace videocapturemodule {
+
+class VideoCaptureModuleV4L2::MappedBuffers : public rtc::RefCountInterface {
+ public:
+  struct Buffer {
+    void* start;
+    size_t length;
+    int dmabuf_fd;
+  };
+
+  explicit MappedBuffers(int device_fd)
+      : device_fd_(device_fd), streaming_(true), num_queued_(0) {}
+
+  // Called before the buffers are queued.
+  void Add(const Buffer& buffer) { buffers_.push_back(buffer); }
+  const Buffer& buffer(int index) const { return buffers_[index]; }
+
+  // Queues buffer |index| to the device again, unless the capture has
+  // stopped. Can be called on any thread.
+  void Queue(int index) {
+    rtc::CritScope cs(&crit_);
+    if (!streaming_)
+      return;
+    struct v4l2_buffer buf;
+    memset(&buf, 0, sizeof(struct v4l2_buffer));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    if (ioctl(device_fd_, VIDIOC_QBUF, &buf) == -1) {
+      RTC_LOG(LS_INFO) << "Failed to enqueue capture buffer";
+      return;
+    }
+    ++num_queued_;
+  }
+
+  // Returns the number of buffers still queued to the device.
+  int OnDequeued() {
+    rtc::CritScope cs(&crit_);
+    return --num_queued_;
+  }
+
+  // Must be called before the device is closed.
+  void Stop() {
+    rtc::CritScope cs(&crit_);
+    streaming_ = false;
+  }
+
+ protected:
+  ~MappedBuffers() override {
+    for (const Buffer& buffer : buffers_) {
+      if (buffer.dmabuf_fd != -1)
+        close(buffer.dmabuf_fd);
+      munmap(buffer.start, buffer.length);
+    }
+  }
+
+ private:
+  const int device_fd_;
+  std::vector<Buffer> buffers_;
+  rtc::CriticalSection crit_;
+  bool streaming_ RTC_GUARDED_BY(crit_);
+  int num_queued_ RTC_GUARDED_BY(crit_);
+};
+
 rtc::scoped_refptr<VideoCaptureModule> VideoCaptureImpl::Create(
     const char* deviceUniqueId) {
   rtc::scoped_refptr<VideoCaptureModuleV4L2> implementation(
@@ -45,13 +112,12 @@ VideoCaptureModuleV4L2::VideoCaptureModuleV4L2()
     : VideoCaptureImpl(),
       _deviceId(-1),
       _deviceFd(-1),
-      _buffersAllocatedByDevice(-1),
       _currentWidth(-1),
       _currentHeight(-1),
       _currentFrameRate(-1),
       _captureStarted(false),
       _captureVideoType(VideoType::kI420),
-      _pool(NULL) {}
+      _zeroCopy(field_trial::IsEnabled("WebRTC-V4L2ZeroCopy")) {}
 
 int32_t VideoCaptureModuleV4L2::Init(const char* deviceUniqueIdUTF8) {
   int len = strlen((const char*)deviceUniqueIdUTF8);
@@ -295,10 +361,9 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers() {
   if (rbuffer.count > kNoOfV4L2Bufffers)
     rbuffer.count = kNoOfV4L2Bufffers;
 
-  _buffersAllocatedByDevice = rbuffer.count;
-
   // Map the buffers
-  _pool = new Buffer[rbuffer.count];
+  rtc::scoped_refptr<MappedBuffers> buffers(
+      new rtc::RefCountedObject<MappedBuffers>(_deviceFd));
 
   for (unsigned int i = 0; i < rbuffer.count; i++) {
     struct v4l2_buffer buffer;
@@ -311,30 +376,40 @@ bool VideoCaptureModuleV4L2::AllocateVideoBuffers() {
       return false;
     }
 
-    _pool[i].start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE,
-                          MAP_SHARED, _deviceFd, buffer.m.offset);
-
-    if (MAP_FAILED == _pool[i].start) {
-      for (unsigned int j = 0; j < i; j++)
-        munmap(_pool[j].start, _pool[j].length);
+    MappedBuffers::Buffer mapped;
+    mapped.start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, _deviceFd, buffer.m.offset);
+    if (MAP_FAILED == mapped.start) {
       return false;
     }
-
-    _pool[i].length = buffer.length;
-
-    if (ioctl(_deviceFd, VIDIOC_QBUF, &buffer) < 0) {
-      return false;
+    mapped.length = buffer.length;
+
+    // Export the buffer for sinks that can import it, e.g. hardware encoders.
+    mapped.dmabuf_fd = -1;
+    if (_zeroCopy) {
+      struct v4l2_exportbuffer expbuf;
+      memset(&expbuf, 0, sizeof(v4l2_exportbuffer));
+      expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+      expbuf.index = i;
+      expbuf.flags = O_RDONLY | O_CLOEXEC;
+      if (ioctl(_deviceFd, VIDIOC_EXPBUF, &expbuf) == 0)
+        mapped.dmabuf_fd = expbuf.fd;
     }
+    buffers->Add(mapped);
   }
+
+  for (unsigned int i = 0; i < rbuffer.count; i++)
+    buffers->Queue(i);
+  _buffers = buffers;
   return true;
 }
 
 bool VideoCaptureModuleV4L2::DeAllocateVideoBuffers() {
-  // unmap buffers
-  for (int i = 0; i < _buffersAllocatedByDevice; i++)
-    munmap(_pool[i].start, _pool[i].length);
-
-  delete[] _pool;
+  // The buffers are unmapped once the frames wrapping them are released.
+  if (_buffers) {
+    _buffers->Stop();
+    _buffers = nullptr;
+  }
 
   // turn off stream
   enum v4l2_buf_type type;
@@ -391,17 +466,36 @@ bool VideoCaptureModuleV4L2::CaptureProcess() {
         return true;
       }
     }
+    const int num_queued = _buffers->OnDequeued();
+    uint8_t* data = static_cast<uint8_t*>(_buffers->buffer(buf.index).start);
+
     VideoCaptureCapability frameInfo;
     frameInfo.width = _currentWidth;
     frameInfo.height = _currentHeight;
     frameInfo.videoType = _captureVideoType;
 
-    // convert to to I420 if needed
-    IncomingFrame((unsigned char*)_pool[buf.index].start, buf.bytesused,
-                  frameInfo);
-    // enqueue the buffer again
-    if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1) {
-      RTC_LOG(LS_INFO) << "Failed to enqueue capture buffer";
+    // Wrap the buffer instead of converting it, as long as enough buffers
+    // remain queued for the device to keep capturing.
+    if (_zeroCopy && num_queued >= kMinQueuedV4L2Buffers &&
+        _captureVideoType != VideoType::kMJPEG &&
+        buf.bytesused == CalcBufferSize(_captureVideoType, _currentWidth,
+                                        _currentHeight)) {
+      rtc::scoped_refptr<MappedBuffers> buffers = _buffers;
+      const int index = buf.index;
+      rtc::scoped_refptr<VideoFrameBuffer> frame_buffer(
+          new rtc::RefCountedObject<V4L2FrameBuffer>(
+              _currentWidth, _currentHeight, _captureVideoType, data,
+              buf.bytesused, buffers->buffer(index).dmabuf_fd,
+              [buffers, index] { buffers->Queue(index); }));
+      // Frames that have to be rotated are converted. Either way, the buffer
+      // is queued again once the frame buffer is released.
+      if (IncomingFrameBuffer(frame_buffer) != 0)
+        IncomingFrame(data, buf.bytesused, frameInfo);
+    } else {
+      // convert to to I420 if needed
+      IncomingFrame(data, buf.bytesused, frameInfo);
+      // enqueue the buffer again
+      _buffers->Queue(buf.index);
     }
   }
   usleep(0);
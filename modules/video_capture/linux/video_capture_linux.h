@@ -17,6 +17,7 @@
 #include "modules/video_capture/video_capture_impl.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/platform_thread.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 namespace videocapturemodule {
@@ -32,6 +33,12 @@ class VideoCaptureModuleV4L2 : public VideoCaptureImpl {
 
  private:
   enum { kNoOfV4L2Bufffers = 4 };
+  // Buffers kept queued to the device when frames wrap the other ones.
+  enum { kMinQueuedV4L2Buffers = 2 };
+
+  // The buffers mapped from the device, which outlive the capture while
+  // frames wrapping them are in use.
+  class MappedBuffers;
 
   static bool CaptureThread(void*);
   bool CaptureProcess();
@@ -45,17 +52,15 @@ class VideoCaptureModuleV4L2 : public VideoCaptureImpl {
   int32_t _deviceId;
   int32_t _deviceFd;
 
-  int32_t _buffersAllocatedByDevice;
   int32_t _currentWidth;
   int32_t _currentHeight;
   int32_t _currentFrameRate;
   bool _captureStarted;
   VideoType _captureVideoType;
-  struct Buffer {
-    void* start;
-    size_t length;
-  };
-  Buffer* _pool;
+  // If set, captured frames are delivered as V4L2FrameBuffers wrapping the
+  // device buffers instead of being converted to I420.
+  const bool _zeroCopy;
+  rtc::scoped_refptr<MappedBuffers> _buffers;
 };
 }  // namespace videocapturemodule
 }  // namespace webrtc
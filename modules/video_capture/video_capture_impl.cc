@@ -11,6 +11,7 @@
 #include <stdlib.h>
 
 #include "api/video/i420_buffer.h"
+#include "common_video/libyuv/include/parallel_libyuv.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/include/module_common_types.h"
 #include "modules/video_capture/video_capture_config.h"
@@ -183,13 +184,17 @@ int32_t VideoCaptureImpl::IncomingFrame(uint8_t* videoFrame,
     }
   }
 
-  const int conversionResult = libyuv::ConvertToI420(
-      videoFrame, videoFrameLength, buffer.get()->MutableDataY(),
-      buffer.get()->StrideY(), buffer.get()->MutableDataU(),
-      buffer.get()->StrideU(), buffer.get()->MutableDataV(),
-      buffer.get()->StrideV(), 0, 0,  // No Cropping
-      width, height, target_width, target_height, rotation_mode,
-      ConvertVideoType(frameInfo.videoType));
+  const int conversionResult =
+      rotation_mode == libyuv::kRotate0
+          ? ParallelConvertToI420(frameInfo.videoType, videoFrame,
+                                  videoFrameLength, width, height, buffer)
+          : libyuv::ConvertToI420(
+                videoFrame, videoFrameLength, buffer.get()->MutableDataY(),
+                buffer.get()->StrideY(), buffer.get()->MutableDataU(),
+                buffer.get()->StrideU(), buffer.get()->MutableDataV(),
+                buffer.get()->StrideV(), 0, 0,  // No Cropping
+                width, height, target_width, target_height, rotation_mode,
+                ConvertVideoType(frameInfo.videoType));
   if (conversionResult < 0) {
     RTC_LOG(LS_ERROR) << "Failed to convert capture frame from type "
                       << static_cast<int>(frameInfo.videoType) << "to I420.";
@@ -205,6 +210,25 @@ int32_t VideoCaptureImpl::IncomingFrame(uint8_t* videoFrame,
   return 0;
 }
 
+int32_t VideoCaptureImpl::IncomingFrameBuffer(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+    int64_t captureTime /*=0*/) {
+  rtc::CritScope cs(&_apiCs);
+
+  TRACE_EVENT1("webrtc", "VC::IncomingFrameBuffer", "capture_time",
+               captureTime);
+
+  if (apply_rotation_ && _rotateFrame != kVideoRotation_0)
+    return -1;
+
+  VideoFrame captureFrame(buffer, 0, rtc::TimeMillis(), _rotateFrame);
+  captureFrame.set_ntp_time_ms(captureTime);
+
+  DeliverCapturedFrame(captureFrame);
+
+  return 0;
+}
+
 int32_t VideoCaptureImpl::SetCaptureRotation(VideoRotation rotation) {
   rtc::CritScope cs(&_apiCs);
   _rotateFrame = rotation;
@@ -88,6 +88,12 @@ class VideoCaptureImpl : public VideoCaptureModule,
   VideoCaptureImpl();
   virtual ~VideoCaptureImpl();
   int32_t DeliverCapturedFrame(VideoFrame& captureFrame);
+  // Delivers |buffer| as is, e.g. a native buffer wrapping the capture memory.
+  // Returns -1 without delivering it if the frame has to be rotated, which
+  // only IncomingFrame does.
+  int32_t IncomingFrameBuffer(
+      const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+      int64_t captureTime = 0);
 
   char* _deviceUniqueId;  // current Device unique name;
   rtc::CriticalSection _apiCs;
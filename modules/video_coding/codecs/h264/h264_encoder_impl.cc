@@ -13,6 +13,7 @@
 
 #include <limits>
 #include <string>
+#include <utility>
 
 #include "third_party/openh264/src/codec/api/svc/codec_api.h"
 #include "third_party/openh264/src/codec/api/svc/codec_app_def.h"
@@ -83,8 +84,9 @@ FrameType ConvertToVideoFrameType(EVideoFrameType type) {
 
 // Helper method used by H264EncoderImpl::Encode.
 // Copies the encoded bytes from |info| to |encoded_image| and updates the
-// fragmentation information of |frag_header|. The |encoded_image->_buffer| may
-// be deleted and reallocated if a bigger buffer is required.
+// fragmentation information of |frag_header|. The storage of the previous
+// frame is reused if it is big enough and no copy of its image refers to it,
+// otherwise new storage is allocated.
 //
 // After OpenH264 encoding, the encoded bytes are stored in |info| spread out
 // over a number of layers and "NAL units". Each NAL unit is a fragment starting
@@ -93,7 +95,6 @@ FrameType ConvertToVideoFrameType(EVideoFrameType type) {
 // is updated to point to each fragment, with offsets and lengths set as to
 // exclude the start codes.
 static void RtpFragmentize(EncodedImage* encoded_image,
-                           std::unique_ptr<uint8_t[]>* encoded_image_buffer,
                            const VideoFrameBuffer& frame_buffer,
                            SFrameBSInfo* info,
                            RTPFragmentationHeader* frag_header) {
@@ -110,31 +111,31 @@ static void RtpFragmentize(EncodedImage* encoded_image,
       required_size += layerInfo.pNalLengthInByte[nal];
     }
   }
-  if (encoded_image->_size < required_size) {
+  rtc::CopyOnWriteBuffer encoded_data = encoded_image->ReleaseEncodedData();
+  encoded_data.Clear();
+  if (encoded_data.capacity() < required_size) {
     // Increase buffer size. Allocate enough to hold an unencoded image, this
     // should be more than enough to hold any encoded data of future frames of
     // the same size (avoiding possible future reallocation due to variations in
     // required size).
-    encoded_image->_size = CalcBufferSize(
-        VideoType::kI420, frame_buffer.width(), frame_buffer.height());
-    if (encoded_image->_size < required_size) {
+    size_t capacity = CalcBufferSize(VideoType::kI420, frame_buffer.width(),
+                                     frame_buffer.height());
+    if (capacity < required_size) {
       // Encoded data > unencoded data. Allocate required bytes.
       RTC_LOG(LS_WARNING)
           << "Encoding produced more bytes than the original image "
-          << "data! Original bytes: " << encoded_image->_size
+          << "data! Original bytes: " << capacity
           << ", encoded bytes: " << required_size << ".";
-      encoded_image->_size = required_size;
+      capacity = required_size;
     }
-    encoded_image->_buffer = new uint8_t[encoded_image->_size];
-    encoded_image_buffer->reset(encoded_image->_buffer);
+    encoded_data.EnsureCapacity(capacity);
   }
 
   // Iterate layers and NAL units, note each NAL unit as a fragment and copy
-  // the data to |encoded_image->_buffer|.
+  // the data to |encoded_data|.
   const uint8_t start_code[4] = {0, 0, 0, 1};
   frag_header->VerifyAndAllocateFragmentationHeader(fragments_count);
   size_t frag = 0;
-  encoded_image->_length = 0;
   for (int layer = 0; layer < info->iLayerNum; ++layer) {
     const SLayerBSInfo& layerInfo = info->sLayerInfo[layer];
     // Iterate NAL units making up this layer, noting fragments.
@@ -148,16 +149,15 @@ static void RtpFragmentize(EncodedImage* encoded_image,
       RTC_DCHECK_EQ(layerInfo.pBsBuf[layer_len + 2], start_code[2]);
       RTC_DCHECK_EQ(layerInfo.pBsBuf[layer_len + 3], start_code[3]);
       frag_header->fragmentationOffset[frag] =
-          encoded_image->_length + layer_len + sizeof(start_code);
+          encoded_data.size() + layer_len + sizeof(start_code);
       frag_header->fragmentationLength[frag] =
           layerInfo.pNalLengthInByte[nal] - sizeof(start_code);
       layer_len += layerInfo.pNalLengthInByte[nal];
     }
     // Copy the entire layer's data (including start codes).
-    memcpy(encoded_image->_buffer + encoded_image->_length, layerInfo.pBsBuf,
-           layer_len);
-    encoded_image->_length += layer_len;
+    encoded_data.AppendData(layerInfo.pBsBuf, layer_len);
   }
+  encoded_image->SetEncodedData(std::move(encoded_data));
 }
 
 H264EncoderImpl::H264EncoderImpl(const cricket::VideoCodec& codec)
@@ -176,7 +176,6 @@ H264EncoderImpl::H264EncoderImpl(const cricket::VideoCodec& codec)
   }
   downscaled_buffers_.reserve(kMaxSimulcastStreams - 1);
   encoded_images_.reserve(kMaxSimulcastStreams);
-  encoded_image_buffers_.reserve(kMaxSimulcastStreams);
   encoders_.reserve(kMaxSimulcastStreams);
   configurations_.reserve(kMaxSimulcastStreams);
 }
@@ -219,7 +218,6 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* inst,
   }
   downscaled_buffers_.resize(number_of_streams - 1);
   encoded_images_.resize(number_of_streams);
-  encoded_image_buffers_.resize(number_of_streams);
   encoders_.resize(number_of_streams);
   pictures_.resize(number_of_streams);
   configurations_.resize(number_of_streams);
@@ -285,6 +283,7 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* inst,
 
     // Create encoder parameters based on the layer configuration.
     SEncParamExt encoder_params = CreateEncoderParams(i);
+    configurations_[i].complexity_mode = encoder_params.iComplexityMode;
 
     // Initialize.
     if (openh264_encoder->InitializeExt(&encoder_params) != 0) {
@@ -298,15 +297,12 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* inst,
     openh264_encoder->SetOption(ENCODER_OPTION_DATAFORMAT, &video_format);
 
     // Initialize encoded image. Default buffer size: size of unencoded data.
-    encoded_images_[i]._size =
-        CalcBufferSize(VideoType::kI420, codec_.simulcastStream[idx].width,
-                       codec_.simulcastStream[idx].height);
-    encoded_images_[i]._buffer = new uint8_t[encoded_images_[i]._size];
-    encoded_image_buffers_[i].reset(encoded_images_[i]._buffer);
+    encoded_images_[i].SetEncodedData(rtc::CopyOnWriteBuffer(
+        0, CalcBufferSize(VideoType::kI420, codec_.simulcastStream[idx].width,
+                          codec_.simulcastStream[idx].height)));
     encoded_images_[i]._completeFrame = true;
     encoded_images_[i]._encodedWidth = codec_.simulcastStream[idx].width;
     encoded_images_[i]._encodedHeight = codec_.simulcastStream[idx].height;
-    encoded_images_[i]._length = 0;
   }
 
   SimulcastRateAllocator init_allocator(codec_);
@@ -327,7 +323,6 @@ int32_t H264EncoderImpl::Release() {
   downscaled_buffers_.clear();
   configurations_.clear();
   encoded_images_.clear();
-  encoded_image_buffers_.clear();
   pictures_.clear();
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -510,8 +505,7 @@ int32_t H264EncoderImpl::Encode(const VideoFrame& input_frame,
     // Split encoded image up into fragments. This also updates
     // |encoded_image_|.
     RTPFragmentationHeader frag_header;
-    RtpFragmentize(&encoded_images_[i], &encoded_image_buffers_[i],
-                   *frame_buffer, &info, &frag_header);
+    RtpFragmentize(&encoded_images_[i], *frame_buffer, &info, &frag_header);
 
     // Encoder can skip frames to save bandwidth in which case
     // |encoded_images_[i]._length| == 0.
@@ -630,6 +624,50 @@ int32_t H264EncoderImpl::SetChannelParameters(uint32_t packet_loss,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+bool H264EncoderImpl::SetSpeedSteps(int steps) {
+  if (encoders_.empty() || steps < 0)
+    return steps == 0;
+  for (const LayerConfig& configuration : configurations_) {
+    if (configuration.complexity_mode - steps < LOW_COMPLEXITY)
+      return false;
+  }
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    int complexity_mode = configurations_[i].complexity_mode - steps;
+    encoders_[i]->SetOption(ENCODER_OPTION_COMPLEXITY, &complexity_mode);
+  }
+  return true;
+}
+
+bool H264EncoderImpl::Reconfigure(const VideoCodec& codec_settings) {
+  // OpenH264 takes new parameters of a single stream, including its
+  // resolution, without the encoder being recreated. The stream continues
+  // with a key frame.
+  if (encoders_.size() != 1 ||
+      SimulcastUtility::NumberOfSimulcastStreams(codec_settings) != 1 ||
+      codec_settings.width < 1 || codec_settings.height < 1) {
+    return false;
+  }
+  codec_ = codec_settings;
+  if (codec_.numberOfSimulcastStreams == 0) {
+    codec_.simulcastStream[0].width = codec_.width;
+    codec_.simulcastStream[0].height = codec_.height;
+  }
+  configurations_[0].width = codec_.width;
+  configurations_[0].height = codec_.height;
+  configurations_[0].max_bps = codec_.maxBitrate * 1000;
+  SEncParamExt encoder_params = CreateEncoderParams(0);
+  if (encoders_[0]->SetOption(ENCODER_OPTION_SVC_ENCODE_PARAM_EXT,
+                              &encoder_params) != 0) {
+    RTC_LOG(LS_WARNING) << "Failed to reconfigure OpenH264 encoder.";
+    return false;
+  }
+  configurations_[0].complexity_mode = encoder_params.iComplexityMode;
+  configurations_[0].key_frame_request = true;
+  encoded_images_[0]._encodedWidth = codec_.width;
+  encoded_images_[0]._encodedHeight = codec_.height;
+  return true;
+}
+
 VideoEncoder::ScalingSettings H264EncoderImpl::GetScalingSettings() const {
   return VideoEncoder::ScalingSettings(kLowH264QpThreshold,
                                        kHighH264QpThreshold);
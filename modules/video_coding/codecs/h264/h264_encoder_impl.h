@@ -39,6 +39,8 @@ class H264EncoderImpl : public H264Encoder {
     uint32_t max_bps = 0;
     bool frame_dropping_on = false;
     int key_frame_interval = 0;
+    // The complexity selected in InitEncode, lower modes are faster.
+    ECOMPLEXITY_MODE complexity_mode = LOW_COMPLEXITY;
 
     void SetStreamState(bool send_stream);
   };
@@ -77,6 +79,10 @@ class H264EncoderImpl : public H264Encoder {
   // Unsupported / Do nothing.
   int32_t SetChannelParameters(uint32_t packet_loss, int64_t rtt) override;
 
+  bool SetSpeedSteps(int steps) override;
+
+  bool Reconfigure(const VideoCodec& codec_settings) override;
+
   // Exposed for testing.
   H264PacketizationMode PacketizationModeForTesting() const {
     return packetization_mode_;
@@ -95,7 +101,6 @@ class H264EncoderImpl : public H264Encoder {
   std::vector<rtc::scoped_refptr<I420Buffer>> downscaled_buffers_;
   std::vector<LayerConfig> configurations_;
   std::vector<EncodedImage> encoded_images_;
-  std::vector<std::unique_ptr<uint8_t[]>> encoded_image_buffers_;
 
   VideoCodec codec_;
   H264PacketizationMode packetization_mode_;
@@ -15,6 +15,7 @@
 
 #include "common_types.h"  // NOLINT(build/include)
 #include "common_video/include/video_frame.h"
+#include "rtc_base/buffer.h"
 
 namespace webrtc {
 
@@ -97,6 +98,18 @@ class MultiplexEncodedImagePacker {
   // Note: It is caller responsibility to release the buffer of the result.
   static EncodedImage PackAndRelease(const MultiplexImage& image);
 
+  // Packing in place, where each bitstream is copied once, as soon as it is
+  // encoded: |buffer| starts with BitstreamsOffset() bytes for the headers,
+  // AppendBitstream() adds the bitstreams of the components as they come in
+  // and PackHeaders() fills in the headers once the image is complete.
+  static size_t BitstreamsOffset(uint8_t component_count);
+  static void AppendBitstream(const MultiplexImageComponent& image_component,
+                              rtc::Buffer* buffer);
+  // |image| must list the components in the order they were appended. The
+  // result points into |buffer|.
+  static EncodedImage PackHeaders(const MultiplexImage& image,
+                                  rtc::Buffer* buffer);
+
   // Note: The image components just share the memory with |combined_image|.
   static MultiplexImage Unpack(const EncodedImage& combined_image);
 };
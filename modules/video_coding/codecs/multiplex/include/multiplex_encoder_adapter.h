@@ -20,7 +20,9 @@
 #include "api/video_codecs/video_encoder_factory.h"
 #include "modules/video_coding/codecs/multiplex/include/multiplex_encoded_image_packer.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -61,22 +63,37 @@ class MultiplexEncoderAdapter : public VideoEncoder {
   // Wrapper class that redirects OnEncodedImage() calls.
   class AdapterEncodedImageCallback;
 
+  // The components of an image that are encoded so far, with their
+  // bitstreams already where they go in the combined image in |buffer|.
+  struct StashedImage {
+    StashedImage(uint16_t picture_index, uint8_t component_count);
+    ~StashedImage();
+
+    MultiplexImage image;
+    rtc::Buffer buffer;
+  };
+
   VideoEncoderFactory* const factory_;
   const SdpVideoFormat associated_format_;
   std::vector<std::unique_ptr<VideoEncoder>> encoders_;
   std::vector<std::unique_ptr<AdapterEncodedImageCallback>> adapter_callbacks_;
   EncodedImageCallback* encoded_complete_callback_;
 
-  std::map<uint32_t /* timestamp */, MultiplexImage> stashed_images_
+  std::map<uint32_t /* timestamp */, StashedImage> stashed_images_
       RTC_GUARDED_BY(crit_);
+  // The buffer of the last sent image, reused for the next stashed image.
+  rtc::Buffer spare_buffer_ RTC_GUARDED_BY(crit_);
 
   uint16_t picture_index_ = 0;
   std::vector<uint8_t> multiplex_dummy_planes_;
 
   int key_frame_interval_;
-  EncodedImage combined_image_;
 
   rtc::CriticalSection crit_;
+
+  // Encodes the alpha plane while the YUV planes are encoded on the thread
+  // calling Encode(). Only created when there is more than one core.
+  std::unique_ptr<rtc::TaskQueue> alpha_encoder_queue_;
 };
 
 }  // namespace webrtc
@@ -15,6 +15,7 @@
 #include "common_video/include/video_frame.h"
 #include "common_video/include/video_frame_buffer.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "rtc_base/event.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "rtc_base/logging.h"
 
@@ -105,6 +106,10 @@ int32_t MultiplexDecoderAdapter::InitDecode(const VideoCodec* codec_settings,
     decoder->RegisterDecodeCompleteCallback(adapter_callbacks_.back().get());
     decoders_.emplace_back(std::move(decoder));
   }
+  if (number_of_cores > 1 && !component_decoder_queue_) {
+    component_decoder_queue_.reset(
+        new rtc::TaskQueue("MultiplexComponentDecoder"));
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -117,21 +122,41 @@ int32_t MultiplexDecoderAdapter::Decode(
       MultiplexEncodedImagePacker::Unpack(input_image);
 
   if (image.component_count == 1) {
+    rtc::CritScope cs(&crit_);
     RTC_DCHECK(decoded_data_.find(input_image._timeStamp) ==
                decoded_data_.end());
     decoded_data_.emplace(std::piecewise_construct,
                           std::forward_as_tuple(input_image._timeStamp),
                           std::forward_as_tuple(kAXXStream));
   }
-  int32_t rv = 0;
-  for (size_t i = 0; i < image.image_components.size(); i++) {
-    rv = decoders_[image.image_components[i].component_index]->Decode(
-        image.image_components[i].encoded_image, missing_frames, nullptr,
-        render_time_ms);
-    if (rv != WEBRTC_VIDEO_CODEC_OK)
-      return rv;
+  const std::vector<MultiplexImageComponent>& components =
+      image.image_components;
+  RTC_DCHECK_LE(components.size(), kAlphaCodecStreams);
+  if (!component_decoder_queue_ || components.size() < 2) {
+    int32_t rv = 0;
+    for (size_t i = 0; i < components.size(); i++) {
+      rv = decoders_[components[i].component_index]->Decode(
+          components[i].encoded_image, missing_frames, nullptr,
+          render_time_ms);
+      if (rv != WEBRTC_VIDEO_CODEC_OK)
+        return rv;
+    }
+    return rv;
   }
-  return rv;
+
+  // Decode both components at the same time. Both are done before returning,
+  // since the components point into |input_image|.
+  int32_t second_rv = WEBRTC_VIDEO_CODEC_OK;
+  rtc::Event second_decoded(false, false);
+  component_decoder_queue_->PostTask([&] {
+    second_rv = decoders_[components[1].component_index]->Decode(
+        components[1].encoded_image, missing_frames, nullptr, render_time_ms);
+    second_decoded.Set();
+  });
+  const int32_t rv = decoders_[components[0].component_index]->Decode(
+      components[0].encoded_image, missing_frames, nullptr, render_time_ms);
+  second_decoded.Wait(rtc::Event::kForever);
+  return rv != WEBRTC_VIDEO_CODEC_OK ? rv : second_rv;
 }
 
 int32_t MultiplexDecoderAdapter::RegisterDecodeCompleteCallback(
@@ -155,6 +180,8 @@ void MultiplexDecoderAdapter::Decoded(AlphaCodecStream stream_idx,
                                       VideoFrame* decoded_image,
                                       absl::optional<int32_t> decode_time_ms,
                                       absl::optional<uint8_t> qp) {
+  // The components may be decoded on different threads.
+  rtc::CritScope cs(&crit_);
   const auto& other_decoded_data_it =
       decoded_data_.find(decoded_image->timestamp());
   if (other_decoded_data_it != decoded_data_.end()) {
@@ -116,21 +116,21 @@ void PackBitstream(uint8_t* buffer, MultiplexImageComponent image) {
 MultiplexImage::MultiplexImage(uint16_t picture_index, uint8_t frame_count)
     : image_index(picture_index), component_count(frame_count) {}
 
-EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
-    const MultiplexImage& multiplex_image) {
-  MultiplexImageHeader header;
-  std::vector<MultiplexImageComponentHeader> frame_headers;
-
-  header.component_count = multiplex_image.component_count;
-  header.image_index = multiplex_image.image_index;
+// Computes the headers of |multiplex_image|, for the bitstreams laid out back
+// to back after the headers, and returns the size of the combined image.
+size_t ComputeHeaders(
+    const MultiplexImage& multiplex_image,
+    MultiplexImageHeader* header,
+    std::vector<MultiplexImageComponentHeader>* frame_headers) {
+  header->component_count = multiplex_image.component_count;
+  header->image_index = multiplex_image.image_index;
   int header_offset = kMultiplexImageHeaderSize;
-  header.first_component_header_offset = header_offset;
+  header->first_component_header_offset = header_offset;
   int bitstream_offset = header_offset + kMultiplexImageComponentHeaderSize *
-                                             header.component_count;
+                                             header->component_count;
 
   const std::vector<MultiplexImageComponent>& images =
       multiplex_image.image_components;
-  EncodedImage combined_image = images[0].encoded_image;
   for (size_t i = 0; i < images.size(); i++) {
     MultiplexImageComponentHeader frame_header;
     header_offset += kMultiplexImageComponentHeaderSize;
@@ -148,6 +148,23 @@ EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
     frame_header.codec_type = images[i].codec_type;
     frame_header.frame_type = images[i].encoded_image._frameType;
 
+    frame_headers->push_back(frame_header);
+  }
+  return bitstream_offset;
+}
+
+// Writes the headers, and returns the combined image of |multiplex_image|
+// in |buffer|.
+EncodedImage WriteHeaders(
+    const MultiplexImage& multiplex_image,
+    const MultiplexImageHeader& header,
+    const std::vector<MultiplexImageComponentHeader>& frame_headers,
+    uint8_t* buffer,
+    size_t size) {
+  const std::vector<MultiplexImageComponent>& images =
+      multiplex_image.image_components;
+  EncodedImage combined_image = images[0].encoded_image;
+  for (const MultiplexImageComponentHeader& frame_header : frame_headers) {
     // As long as one component is delta frame, we have to mark the combined
     // frame as delta frame, because it is necessary for all components to be
     // key frame so as to decode the whole image without previous frame data.
@@ -156,33 +173,43 @@ EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
     if (frame_header.frame_type == FrameType::kVideoFrameDelta) {
       combined_image._frameType = FrameType::kVideoFrameDelta;
     }
-
-    frame_headers.push_back(frame_header);
   }
-
-  combined_image._length = combined_image._size = bitstream_offset;
-  combined_image._buffer = new uint8_t[combined_image._length];
+  combined_image._length = combined_image._size = size;
+  combined_image._buffer = buffer;
 
   // header
-  header_offset = PackHeader(combined_image._buffer, header);
+  int header_offset = PackHeader(buffer, header);
   RTC_DCHECK_EQ(header.first_component_header_offset,
                 kMultiplexImageHeaderSize);
 
   // Frame Header
-  for (size_t i = 0; i < images.size(); i++) {
-    int relative_offset = PackFrameHeader(
-        combined_image._buffer + header_offset, frame_headers[i]);
+  for (size_t i = 0; i < frame_headers.size(); i++) {
+    int relative_offset =
+        PackFrameHeader(buffer + header_offset, frame_headers[i]);
     RTC_DCHECK_EQ(relative_offset, kMultiplexImageComponentHeaderSize);
 
     header_offset = frame_headers[i].next_component_header_offset;
     RTC_DCHECK_EQ(header_offset,
-                  (i == images.size() - 1)
+                  (i == frame_headers.size() - 1)
                       ? 0
                       : (kMultiplexImageHeaderSize +
                          kMultiplexImageComponentHeaderSize * (i + 1)));
   }
+  return combined_image;
+}
+
+EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
+    const MultiplexImage& multiplex_image) {
+  MultiplexImageHeader header;
+  std::vector<MultiplexImageComponentHeader> frame_headers;
+  const size_t size =
+      ComputeHeaders(multiplex_image, &header, &frame_headers);
+  EncodedImage combined_image = WriteHeaders(
+      multiplex_image, header, frame_headers, new uint8_t[size], size);
 
   // Bitstreams
+  const std::vector<MultiplexImageComponent>& images =
+      multiplex_image.image_components;
   for (size_t i = 0; i < images.size(); i++) {
     PackBitstream(combined_image._buffer + frame_headers[i].bitstream_offset,
                   images[i]);
@@ -192,6 +219,35 @@ EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
   return combined_image;
 }
 
+size_t MultiplexEncodedImagePacker::BitstreamsOffset(uint8_t component_count) {
+  return kMultiplexImageHeaderSize +
+         kMultiplexImageComponentHeaderSize * component_count;
+}
+
+void MultiplexEncodedImagePacker::AppendBitstream(
+    const MultiplexImageComponent& image_component,
+    rtc::Buffer* buffer) {
+  const EncodedImage& encoded_image = image_component.encoded_image;
+  const size_t padding =
+      EncodedImage::GetBufferPaddingBytes(image_component.codec_type);
+  buffer->AppendData(encoded_image._buffer, encoded_image._length);
+  const size_t padding_offset = buffer->size();
+  buffer->SetSize(padding_offset + padding);
+  memset(buffer->data() + padding_offset, 0, padding);
+}
+
+EncodedImage MultiplexEncodedImagePacker::PackHeaders(
+    const MultiplexImage& multiplex_image,
+    rtc::Buffer* buffer) {
+  MultiplexImageHeader header;
+  std::vector<MultiplexImageComponentHeader> frame_headers;
+  const size_t size =
+      ComputeHeaders(multiplex_image, &header, &frame_headers);
+  RTC_DCHECK_EQ(size, buffer->size());
+  return WriteHeaders(multiplex_image, header, frame_headers, buffer->data(),
+                      size);
+}
+
 MultiplexImage MultiplexEncodedImagePacker::Unpack(
     const EncodedImage& combined_image) {
   const MultiplexImageHeader& header = UnpackHeader(combined_image._buffer);
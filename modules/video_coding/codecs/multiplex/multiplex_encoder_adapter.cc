@@ -10,12 +10,11 @@
 
 #include "modules/video_coding/codecs/multiplex/include/multiplex_encoder_adapter.h"
 
-#include <cstring>
-
 #include "common_video/include/video_frame.h"
 #include "common_video/include/video_frame_buffer.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/include/module_common_types.h"
+#include "rtc_base/event.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "rtc_base/logging.h"
 
@@ -45,6 +44,12 @@ class MultiplexEncoderAdapter::AdapterEncodedImageCallback
   const AlphaCodecStream stream_idx_;
 };
 
+MultiplexEncoderAdapter::StashedImage::StashedImage(uint16_t picture_index,
+                                                   uint8_t component_count)
+    : image(picture_index, component_count) {}
+
+MultiplexEncoderAdapter::StashedImage::~StashedImage() = default;
+
 MultiplexEncoderAdapter::MultiplexEncoderAdapter(
     VideoEncoderFactory* factory,
     const SdpVideoFormat& associated_format)
@@ -103,6 +108,9 @@ int MultiplexEncoderAdapter::InitEncode(const VideoCodec* inst,
     encoder->RegisterEncodeCompleteCallback(adapter_callbacks_.back().get());
     encoders_.emplace_back(std::move(encoder));
   }
+  if (number_of_cores > 1 && !alpha_encoder_queue_) {
+    alpha_encoder_queue_.reset(new rtc::TaskQueue("MultiplexAlphaEncoder"));
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -124,23 +132,28 @@ int MultiplexEncoderAdapter::Encode(
                          VideoFrameBuffer::Type::kI420A;
   {
     rtc::CritScope cs(&crit_);
-    stashed_images_.emplace(
+    const uint8_t component_count = has_alpha ? kAlphaCodecStreams : 1;
+    auto stashed_image = stashed_images_.emplace(
         std::piecewise_construct,
         std::forward_as_tuple(input_image.timestamp()),
-        std::forward_as_tuple(picture_index_,
-                              has_alpha ? kAlphaCodecStreams : 1));
+        std::forward_as_tuple(picture_index_, component_count));
+    if (stashed_image.second) {
+      rtc::Buffer& buffer = stashed_image.first->second.buffer;
+      buffer = std::move(spare_buffer_);
+      buffer.SetSize(
+          MultiplexEncodedImagePacker::BitstreamsOffset(component_count));
+    }
   }
 
   ++picture_index_;
 
-  // Encode YUV
-  int rv = encoders_[kYUVStream]->Encode(input_image, codec_specific_info,
-                                         &adjusted_frame_types);
   // If we do not receive an alpha frame, we send a single frame for this
   // |picture_index_|. The receiver will receive |frame_count| as 1 which
   // soecifies this case.
-  if (rv || !has_alpha)
-    return rv;
+  if (!has_alpha) {
+    return encoders_[kYUVStream]->Encode(input_image, codec_specific_info,
+                                         &adjusted_frame_types);
+  }
 
   // Encode AXX
   const I420ABufferInterface* yuva_buffer =
@@ -153,9 +166,34 @@ int MultiplexEncoderAdapter::Encode(
                      rtc::KeepRefUntilDone(input_image.video_frame_buffer()));
   VideoFrame alpha_image(alpha_buffer, input_image.timestamp(),
                          input_image.render_time_ms(), input_image.rotation());
-  rv = encoders_[kAXXStream]->Encode(alpha_image, codec_specific_info,
-                                     &adjusted_frame_types);
-  return rv;
+  if (!alpha_encoder_queue_) {
+    const int rv = encoders_[kYUVStream]->Encode(
+        input_image, codec_specific_info, &adjusted_frame_types);
+    if (rv)
+      return rv;
+    return encoders_[kAXXStream]->Encode(alpha_image, codec_specific_info,
+                                         &adjusted_frame_types);
+  }
+
+  // Encode YUV and AXX at the same time. Both are done before returning, so
+  // that the input frame and the encoders are not used after Encode().
+  int alpha_rv = WEBRTC_VIDEO_CODEC_OK;
+  rtc::Event alpha_encoded(false, false);
+  alpha_encoder_queue_->PostTask([&] {
+    alpha_rv = encoders_[kAXXStream]->Encode(alpha_image, codec_specific_info,
+                                             &adjusted_frame_types);
+    alpha_encoded.Set();
+  });
+  const int rv = encoders_[kYUVStream]->Encode(input_image, codec_specific_info,
+                                               &adjusted_frame_types);
+  alpha_encoded.Wait(rtc::Event::kForever);
+  if (rv) {
+    // Like when encoding one after the other, there is no image without YUV.
+    rtc::CritScope cs(&crit_);
+    stashed_images_.erase(input_image.timestamp());
+    return rv;
+  }
+  return alpha_rv;
 }
 
 int MultiplexEncoderAdapter::RegisterEncodeCompleteCallback(
@@ -198,16 +236,8 @@ int MultiplexEncoderAdapter::Release() {
   encoders_.clear();
   adapter_callbacks_.clear();
   rtc::CritScope cs(&crit_);
-  for (auto& stashed_image : stashed_images_) {
-    for (auto& image_component : stashed_image.second.image_components) {
-      delete[] image_component.encoded_image._buffer;
-    }
-  }
   stashed_images_.clear();
-  if (combined_image_._buffer) {
-    delete[] combined_image_._buffer;
-    combined_image_._buffer = nullptr;
-  }
+  spare_buffer_ = rtc::Buffer();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -226,17 +256,18 @@ EncodedImageCallback::Result MultiplexEncoderAdapter::OnEncodedImage(
   image_component.codec_type =
       PayloadStringToCodecType(associated_format_.name);
   image_component.encoded_image = encodedImage;
-  image_component.encoded_image._buffer = new uint8_t[encodedImage._length];
-  std::memcpy(image_component.encoded_image._buffer, encodedImage._buffer,
-              encodedImage._length);
 
   rtc::CritScope cs(&crit_);
   const auto& stashed_image_itr = stashed_images_.find(encodedImage._timeStamp);
   const auto& stashed_image_next_itr = std::next(stashed_image_itr, 1);
   RTC_DCHECK(stashed_image_itr != stashed_images_.end());
-  MultiplexImage& stashed_image = stashed_image_itr->second;
+  MultiplexImage& stashed_image = stashed_image_itr->second.image;
   const uint8_t frame_count = stashed_image.component_count;
 
+  // The only copy of the bitstream, right into the combined image.
+  MultiplexEncodedImagePacker::AppendBitstream(
+      image_component, &stashed_image_itr->second.buffer);
+  image_component.encoded_image._buffer = nullptr;
   stashed_image.image_components.push_back(image_component);
 
   if (stashed_image.image_components.size() == frame_count) {
@@ -245,23 +276,23 @@ EncodedImageCallback::Result MultiplexEncoderAdapter::OnEncodedImage(
          iter != stashed_images_.end() && iter != stashed_image_next_itr;
          iter++) {
       // No image at all, skip.
-      if (iter->second.image_components.size() == 0)
+      if (iter->second.image.image_components.size() == 0)
         continue;
 
       // We have to send out those stashed frames, otherwise the delta frame
       // dependency chain is broken.
-      if (combined_image_._buffer)
-        delete[] combined_image_._buffer;
-      combined_image_ =
-          MultiplexEncodedImagePacker::PackAndRelease(iter->second);
+      const EncodedImage combined_image =
+          MultiplexEncodedImagePacker::PackHeaders(iter->second.image,
+                                                   &iter->second.buffer);
 
       CodecSpecificInfo codec_info = *codecSpecificInfo;
       codec_info.codecType = kVideoCodecMultiplex;
       codec_info.codecSpecific.generic.simulcast_idx = 0;
-      encoded_complete_callback_->OnEncodedImage(combined_image_, &codec_info,
+      encoded_complete_callback_->OnEncodedImage(combined_image, &codec_info,
                                                  fragmentation);
     }
 
+    spare_buffer_ = std::move(stashed_image_itr->second.buffer);
     stashed_images_.erase(stashed_images_.begin(), stashed_image_next_itr);
   }
   return EncodedImageCallback::Result(EncodedImageCallback::Result::OK);
@@ -222,4 +222,44 @@ TEST_F(TestMultiplexAdapter, ImageIndexIncreases) {
   }
 }
 
+TEST(MultiplexEncodedImagePackerTest, PacksInPlaceLikePackAndRelease) {
+  const uint8_t kBitstreams[kAlphaCodecStreams][5] = {{1, 2, 3, 4, 5},
+                                                      {6, 7, 8}};
+  const size_t kLengths[kAlphaCodecStreams] = {5, 3};
+  MultiplexImage image(7 /* picture_index */, kAlphaCodecStreams);
+  rtc::Buffer buffer(
+      MultiplexEncodedImagePacker::BitstreamsOffset(kAlphaCodecStreams));
+  for (uint8_t i = 0; i < kAlphaCodecStreams; ++i) {
+    MultiplexImageComponent component;
+    component.component_index = i;
+    component.codec_type = kVideoCodecVP9;
+    component.encoded_image._buffer = const_cast<uint8_t*>(kBitstreams[i]);
+    component.encoded_image._length = kLengths[i];
+    component.encoded_image._frameType = i ? kVideoFrameDelta : kVideoFrameKey;
+    MultiplexEncodedImagePacker::AppendBitstream(component, &buffer);
+    // PackAndRelease() takes ownership of copies of the bitstreams.
+    component.encoded_image._buffer = new uint8_t[kLengths[i]];
+    memcpy(component.encoded_image._buffer, kBitstreams[i], kLengths[i]);
+    image.image_components.push_back(component);
+  }
+
+  EncodedImage packed =
+      MultiplexEncodedImagePacker::PackHeaders(image, &buffer);
+  EncodedImage expected = MultiplexEncodedImagePacker::PackAndRelease(image);
+  EXPECT_EQ(buffer.data(), packed._buffer);
+  EXPECT_EQ(kVideoFrameDelta, packed._frameType);
+  ASSERT_EQ(expected._length, packed._length);
+  EXPECT_EQ(0, memcmp(expected._buffer, packed._buffer, packed._length));
+  delete[] expected._buffer;
+
+  const MultiplexImage unpacked = MultiplexEncodedImagePacker::Unpack(packed);
+  EXPECT_EQ(7, unpacked.image_index);
+  ASSERT_EQ(2u, unpacked.image_components.size());
+  for (size_t i = 0; i < kAlphaCodecStreams; ++i) {
+    const EncodedImage& component = unpacked.image_components[i].encoded_image;
+    ASSERT_EQ(kLengths[i], component._length);
+    EXPECT_EQ(0, memcmp(kBitstreams[i], component._buffer, kLengths[i]));
+  }
+}
+
 }  // namespace webrtc
@@ -0,0 +1,289 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+#include "third_party/libyuv/include/libyuv.h"
+
+// Measures the throughput of the libyuv conversion, scaling, rotation and
+// cropping kernels, in MB of source pixel data per second, for each level of
+// CPU features that the CPU supports. Use SetLibyuvCpuFlags() to apply the
+// best level of a host.
+
+namespace webrtc {
+namespace {
+
+struct CpuFeatureLevel {
+  const char* name;
+  // The newest feature of the level, which the CPU must have.
+  int required_cpu_flag;
+  // The features of the level and the levels below it.
+  int cpu_flags;
+};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+constexpr int kSse2 = libyuv::kCpuHasX86 | libyuv::kCpuHasSSE2;
+constexpr int kSsse3 = kSse2 | libyuv::kCpuHasSSSE3;
+constexpr int kSse4 = kSsse3 | libyuv::kCpuHasSSE41 | libyuv::kCpuHasSSE42;
+constexpr int kAvx2 = kSse4 | libyuv::kCpuHasAVX | libyuv::kCpuHasAVX2 |
+                      libyuv::kCpuHasERMS | libyuv::kCpuHasFMA3 |
+                      libyuv::kCpuHasF16C;
+constexpr int kAvx512 =
+    kAvx2 | libyuv::kCpuHasAVX512BW | libyuv::kCpuHasAVX512VL;
+const CpuFeatureLevel kCpuFeatureLevels[] = {
+    {"c", 0, 0},
+    {"sse2", libyuv::kCpuHasSSE2, kSse2},
+    {"ssse3", libyuv::kCpuHasSSSE3, kSsse3},
+    {"sse4", libyuv::kCpuHasSSE41, kSse4},
+    {"avx2", libyuv::kCpuHasAVX2, kAvx2},
+    {"avx512", libyuv::kCpuHasAVX512BW, kAvx512},
+};
+#elif defined(WEBRTC_ARCH_ARM_FAMILY)
+const CpuFeatureLevel kCpuFeatureLevels[] = {
+    {"c", 0, 0},
+    {"neon", libyuv::kCpuHasNEON, libyuv::kCpuHasARM | libyuv::kCpuHasNEON},
+};
+#else
+const CpuFeatureLevel kCpuFeatureLevels[] = {{"c", 0, 0}};
+#endif
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+const Resolution kResolutions[] = {
+    {"360p", 640, 360}, {"720p", 1280, 720}, {"1080p", 1920, 1080}};
+
+// MJPEG is left out, since it needs compressed input.
+const VideoType kVideoTypes[] = {
+    VideoType::kI420,   VideoType::kIYUV,     VideoType::kRGB24,
+    VideoType::kABGR,   VideoType::kARGB,     VideoType::kARGB4444,
+    VideoType::kRGB565, VideoType::kARGB1555, VideoType::kYUY2,
+    VideoType::kYV12,   VideoType::kUYVY,     VideoType::kNV21,
+    VideoType::kNV12,   VideoType::kBGRA};
+
+const char* VideoTypeName(VideoType type) {
+  switch (type) {
+    case VideoType::kUnknown:
+      return "unknown";
+    case VideoType::kI420:
+      return "i420";
+    case VideoType::kIYUV:
+      return "iyuv";
+    case VideoType::kRGB24:
+      return "rgb24";
+    case VideoType::kABGR:
+      return "abgr";
+    case VideoType::kARGB:
+      return "argb";
+    case VideoType::kARGB4444:
+      return "argb4444";
+    case VideoType::kRGB565:
+      return "rgb565";
+    case VideoType::kARGB1555:
+      return "argb1555";
+    case VideoType::kYUY2:
+      return "yuy2";
+    case VideoType::kYV12:
+      return "yv12";
+    case VideoType::kUYVY:
+      return "uyvy";
+    case VideoType::kMJPEG:
+      return "mjpeg";
+    case VideoType::kNV21:
+      return "nv21";
+    case VideoType::kNV12:
+      return "nv12";
+    case VideoType::kBGRA:
+      return "bgra";
+  }
+  return "unknown";
+}
+
+rtc::scoped_refptr<I420Buffer> CreateTestBuffer(int width, int height) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x)
+      buffer->MutableDataY()[y * buffer->StrideY() + x] = (x + y) & 0xff;
+  }
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    for (int x = 0; x < buffer->ChromaWidth(); ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] = x & 0xff;
+      buffer->MutableDataV()[y * buffer->StrideV() + x] = y & 0xff;
+    }
+  }
+  return buffer;
+}
+
+class LibyuvPerformanceTest : public ::testing::Test {
+ protected:
+  LibyuvPerformanceTest()
+      : quick_(field_trial::IsEnabled("WebRTC-QuickPerfTest")) {
+    SetLibyuvCpuFlags(-1);
+    cpu_flags_ = GetLibyuvCpuFlags();
+  }
+  ~LibyuvPerformanceTest() override { SetLibyuvCpuFlags(-1); }
+
+  std::vector<Resolution> resolutions() const {
+    if (quick_)
+      return {kResolutions[0]};
+    return std::vector<Resolution>(std::begin(kResolutions),
+                                   std::end(kResolutions));
+  }
+
+  // Runs |operation|, which processes |bytes| of source data and returns 0 on
+  // success, with the kernels of each supported CPU feature level, and
+  // reports the throughput. Operations that libyuv doesn't support are
+  // skipped.
+  void Measure(const std::string& operation,
+               const Resolution& resolution,
+               size_t bytes,
+               std::function<int()> run) {
+    const int iterations = quick_ ? 2 : 20;
+    for (const CpuFeatureLevel& level : kCpuFeatureLevels) {
+      if (level.required_cpu_flag &&
+          !(cpu_flags_ & level.required_cpu_flag)) {
+        continue;
+      }
+      SetLibyuvCpuFlags(level.cpu_flags & cpu_flags_);
+      // Warms up the caches.
+      if (run() != 0)
+        break;
+      const int64_t start_ns = rtc::TimeNanos();
+      for (int i = 0; i < iterations; ++i)
+        run();
+      const int64_t elapsed_ns =
+          std::max<int64_t>(1, rtc::TimeNanos() - start_ns);
+      const double megabytes_per_second =
+          static_cast<double>(bytes) * iterations * 1000.0 / elapsed_ns;
+      test::PrintResult("libyuv_" + operation,
+                        "_" + std::string(resolution.name), level.name,
+                        megabytes_per_second, "MBps", false);
+    }
+    SetLibyuvCpuFlags(-1);
+  }
+
+  const bool quick_;
+  int cpu_flags_;
+};
+
+}  // namespace
+
+TEST_F(LibyuvPerformanceTest, ConvertToI420) {
+  for (const Resolution& resolution : resolutions()) {
+    rtc::scoped_refptr<I420Buffer> dst =
+        I420Buffer::Create(resolution.width, resolution.height);
+    for (VideoType type : kVideoTypes) {
+      const size_t size =
+          CalcBufferSize(type, resolution.width, resolution.height);
+      std::vector<uint8_t> src(size);
+      for (size_t i = 0; i < size; ++i)
+        src[i] = (i * 7) & 0xff;
+      Measure(std::string(VideoTypeName(type)) + "_to_i420", resolution, size,
+              [&] {
+                return libyuv::ConvertToI420(
+                    src.data(), size, dst->MutableDataY(), dst->StrideY(),
+                    dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(),
+                    dst->StrideV(), 0, 0, resolution.width, resolution.height,
+                    resolution.width, resolution.height, libyuv::kRotate0,
+                    ConvertVideoType(type));
+              });
+    }
+  }
+}
+
+TEST_F(LibyuvPerformanceTest, ConvertFromI420) {
+  for (const Resolution& resolution : resolutions()) {
+    const VideoFrame frame(
+        CreateTestBuffer(resolution.width, resolution.height),
+        kVideoRotation_0, 0);
+    const size_t src_size =
+        CalcBufferSize(VideoType::kI420, resolution.width, resolution.height);
+    for (VideoType type : kVideoTypes) {
+      std::vector<uint8_t> dst(
+          CalcBufferSize(type, resolution.width, resolution.height));
+      Measure(std::string("i420_to_") + VideoTypeName(type), resolution,
+              src_size,
+              [&] { return ConvertFromI420(frame, type, 0, dst.data()); });
+    }
+  }
+}
+
+TEST_F(LibyuvPerformanceTest, Scale) {
+  for (const Resolution& resolution : resolutions()) {
+    rtc::scoped_refptr<I420Buffer> src =
+        CreateTestBuffer(resolution.width, resolution.height);
+    const size_t src_size =
+        CalcBufferSize(VideoType::kI420, resolution.width, resolution.height);
+    rtc::scoped_refptr<I420Buffer> dst_3_4 = I420Buffer::Create(
+        resolution.width * 3 / 4, resolution.height * 3 / 4);
+    Measure("scale_3_4", resolution, src_size, [&] {
+      dst_3_4->ScaleFrom(*src);
+      return 0;
+    });
+    rtc::scoped_refptr<I420Buffer> dst_1_2 =
+        I420Buffer::Create(resolution.width / 2, resolution.height / 2);
+    Measure("scale_1_2", resolution, src_size, [&] {
+      dst_1_2->ScaleFrom(*src);
+      return 0;
+    });
+  }
+}
+
+TEST_F(LibyuvPerformanceTest, Rotate) {
+  for (const Resolution& resolution : resolutions()) {
+    rtc::scoped_refptr<I420Buffer> src =
+        CreateTestBuffer(resolution.width, resolution.height);
+    const size_t src_size =
+        CalcBufferSize(VideoType::kI420, resolution.width, resolution.height);
+    rtc::scoped_refptr<I420Buffer> dst =
+        I420Buffer::Create(resolution.height, resolution.width);
+    Measure("rotate_90", resolution, src_size, [&] {
+      return libyuv::I420Rotate(
+          src->DataY(), src->StrideY(), src->DataU(), src->StrideU(),
+          src->DataV(), src->StrideV(), dst->MutableDataY(), dst->StrideY(),
+          dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(),
+          dst->StrideV(), resolution.width, resolution.height,
+          libyuv::kRotate90);
+    });
+  }
+}
+
+TEST_F(LibyuvPerformanceTest, Crop) {
+  for (const Resolution& resolution : resolutions()) {
+    rtc::scoped_refptr<I420Buffer> src =
+        CreateTestBuffer(resolution.width, resolution.height);
+    // Crops to 4:3, like VideoAdapter does for 4:3 output formats.
+    const int crop_width = resolution.height * 4 / 3;
+    rtc::scoped_refptr<I420Buffer> dst =
+        I420Buffer::Create(crop_width, resolution.height);
+    Measure("crop", resolution,
+            CalcBufferSize(VideoType::kI420, crop_width, resolution.height),
+            [&] {
+              dst->CropAndScaleFrom(*src, (resolution.width - crop_width) / 2,
+                                    0, crop_width, resolution.height);
+              return 0;
+            });
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/test/videocodec_test_batch.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "modules/video_coding/codecs/test/videocodec_test_fixture_impl.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/platform_thread.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace test {
+
+VideoCodecTestBatch::Job::Job() = default;
+VideoCodecTestBatch::Job::Job(const Job&) = default;
+VideoCodecTestBatch::Job::~Job() = default;
+
+VideoCodecTestBatch::VideoCodecTestBatch(size_t max_parallel_jobs)
+    : VideoCodecTestBatch(max_parallel_jobs, 0, 1) {}
+
+VideoCodecTestBatch::VideoCodecTestBatch(size_t max_parallel_jobs,
+                                         size_t shard_index,
+                                         size_t num_shards)
+    : max_parallel_jobs_(max_parallel_jobs > 0
+                             ? max_parallel_jobs
+                             : CpuInfo::DetectNumberOfCores()),
+      shard_index_(shard_index),
+      num_shards_(num_shards),
+      next_job_(0) {
+  RTC_CHECK_GT(num_shards_, 0);
+  RTC_CHECK_LT(shard_index_, num_shards_);
+}
+
+VideoCodecTestBatch::~VideoCodecTestBatch() = default;
+
+void VideoCodecTestBatch::AddJob(const Job& job) {
+  RTC_CHECK(!job.rate_profiles.empty());
+  RTC_CHECK_GT(job.config.num_frames, 0);
+  RTC_CHECK(job.rc_thresholds.empty() ||
+            job.rc_thresholds.size() == job.rate_profiles.size());
+  RTC_CHECK(job.quality_thresholds.empty() ||
+            job.quality_thresholds.size() == job.rate_profiles.size());
+  RTC_CHECK_EQ(!job.create_encoder_factory, !job.create_decoder_factory)
+      << "Set both codec factories or none.";
+  jobs_.push_back(job);
+}
+
+std::vector<VideoCodecTestBatch::Result> VideoCodecTestBatch::Run() {
+  shard_jobs_.clear();
+  for (size_t i = shard_index_; i < jobs_.size(); i += num_shards_)
+    shard_jobs_.push_back(&jobs_[i]);
+  {
+    rtc::CritScope lock(&crit_);
+    next_job_ = 0;
+    results_.assign(shard_jobs_.size(), Result());
+  }
+
+  const size_t num_threads = std::min(max_parallel_jobs_, shard_jobs_.size());
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.push_back(absl::make_unique<rtc::PlatformThread>(
+        &VideoCodecTestBatch::WorkerThread, this, "VidCodecBatch"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+
+  rtc::CritScope lock(&crit_);
+  return results_;
+}
+
+void VideoCodecTestBatch::PrintResults(const std::vector<Result>& results) {
+  printf("==> Batch results\n");
+  printf("%-32s %8s %8s %8s %8s %8s %8s %8s %8s\n", "name", "width",
+         "height", "kbps", "fps", "avg_psnr", "min_psnr", "avg_ssim",
+         "enc_fps");
+  for (const Result& result : results) {
+    const VideoCodecTestStats::VideoStatistics& stats = result.send_stats;
+    printf("%-32s %8zu %8zu %8zu %8.2f %8.2f %8.2f %8.4f %8.2f\n",
+           result.name.c_str(), stats.width, stats.height, stats.bitrate_kbps,
+           stats.framerate_fps, stats.avg_psnr, stats.min_psnr,
+           stats.avg_ssim, stats.enc_speed_fps);
+  }
+  printf("\n");
+
+  // Codec throughput, for tracking CPU regressions. Jobs run in parallel,
+  // so these are comparable between runs of the same batch only.
+  for (const Result& result : results) {
+    PrintResult("codec_enc_speed", "", result.name,
+                result.send_stats.enc_speed_fps, "fps", false);
+    PrintResult("codec_dec_speed", "", result.name,
+                result.send_stats.dec_speed_fps, "fps", false);
+  }
+}
+
+bool VideoCodecTestBatch::WorkerThread(void* obj) {
+  static_cast<VideoCodecTestBatch*>(obj)->RunJobs();
+  return false;
+}
+
+void VideoCodecTestBatch::RunJobs() {
+  while (true) {
+    size_t job_index;
+    {
+      rtc::CritScope lock(&crit_);
+      if (next_job_ == shard_jobs_.size())
+        return;
+      job_index = next_job_++;
+    }
+    Result result = RunJob(*shard_jobs_[job_index]);
+    rtc::CritScope lock(&crit_);
+    results_[job_index] = result;
+  }
+}
+
+VideoCodecTestBatch::Result VideoCodecTestBatch::RunJob(const Job& job) {
+  std::unique_ptr<VideoCodecTestFixtureImpl> fixture;
+  if (job.create_encoder_factory) {
+    fixture = absl::make_unique<VideoCodecTestFixtureImpl>(
+        job.config, job.create_decoder_factory(), job.create_encoder_factory());
+  } else {
+    fixture = absl::make_unique<VideoCodecTestFixtureImpl>(job.config);
+  }
+  fixture->RunTest(
+      job.rate_profiles,
+      job.rc_thresholds.empty() ? nullptr : &job.rc_thresholds,
+      job.quality_thresholds.empty() ? nullptr : &job.quality_thresholds,
+      nullptr);
+
+  Result result;
+  result.name = job.name;
+  const size_t last_frame_num = job.config.num_frames - 1;
+  result.send_stats = fixture->GetStats().SliceAndCalcAggregatedVideoStatistic(
+      0, last_frame_num);
+  result.layer_stats =
+      fixture->GetStats().SliceAndCalcLayerVideoStatistic(0, last_frame_num);
+  return result;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_TEST_BATCH_H_
+#define MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_TEST_BATCH_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/test/videocodec_test_fixture.h"
+#include "api/test/videocodec_test_stats.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+
+namespace webrtc {
+namespace test {
+
+// Runs independent VideoCodecTestFixture configurations, e.g. the clips,
+// resolutions, bitrates and codecs of a codec evaluation, in parallel, and
+// collects their statistics.
+//
+// Jobs run on worker threads, each with its own codecs and task queue, and
+// print their usual output as they finish. Jobs encoding with several cores
+// compete for them, so when running many jobs at once, it is usually best to
+// set |use_single_core| in their configs. With |measure_cpu|, the CPU usage
+// of a job includes all concurrent jobs.
+//
+// A large batch can also be split across processes or machines with
+// |shard_index| and |num_shards|. The shard runs every job whose index
+// modulo |num_shards| equals |shard_index|.
+class VideoCodecTestBatch {
+ public:
+  struct Job {
+    Job();
+    Job(const Job&);
+    ~Job();
+
+    // Identifies the job in the results.
+    std::string name;
+    VideoCodecTestFixture::Config config;
+    std::vector<RateProfile> rate_profiles;
+    // Thresholds to verify, one per rate profile. Empty if unverified.
+    std::vector<RateControlThresholds> rc_thresholds;
+    std::vector<QualityThresholds> quality_thresholds;
+    // Codec factories, created on the thread running the job. The built-in
+    // codecs are used if unset.
+    std::function<std::unique_ptr<VideoEncoderFactory>()>
+        create_encoder_factory;
+    std::function<std::unique_ptr<VideoDecoderFactory>()>
+        create_decoder_factory;
+  };
+
+  struct Result {
+    std::string name;
+    // Statistics over the whole clip.
+    VideoCodecTestStats::VideoStatistics send_stats;
+    std::vector<VideoCodecTestStats::VideoStatistics> layer_stats;
+  };
+
+  // Runs at most |max_parallel_jobs| jobs at a time, or as many as there are
+  // cores if 0.
+  explicit VideoCodecTestBatch(size_t max_parallel_jobs);
+  VideoCodecTestBatch(size_t max_parallel_jobs,
+                      size_t shard_index,
+                      size_t num_shards);
+  ~VideoCodecTestBatch();
+
+  void AddJob(const Job& job);
+
+  // Runs the jobs of this shard and returns their results, in the order the
+  // jobs were added. Blocks until all have finished.
+  std::vector<Result> Run();
+
+  // Prints one line per result, with the main statistics of each job.
+  static void PrintResults(const std::vector<Result>& results);
+
+ private:
+  static bool WorkerThread(void* obj);
+  void RunJobs();
+  Result RunJob(const Job& job);
+
+  const size_t max_parallel_jobs_;
+  const size_t shard_index_;
+  const size_t num_shards_;
+  std::vector<Job> jobs_;
+
+  rtc::CriticalSection crit_;
+  // Index into |shard_jobs_| of the next job to run.
+  size_t next_job_ RTC_GUARDED_BY(crit_);
+  // The jobs of this shard, and their results at the same indices.
+  std::vector<const Job*> shard_jobs_;
+  std::vector<Result> results_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VideoCodecTestBatch);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_TEST_BATCH_H_
@@ -251,6 +251,7 @@ std::string VideoCodecTestFixtureImpl::Config::ToString() const {
   ss << "\ndecode: " << decode;
   ss << "\nuse_single_core: " << use_single_core;
   ss << "\nmeasure_cpu: " << measure_cpu;
+  ss << "\nquality_calc_threads: " << quality_calc_threads;
   ss << "\nnum_cores: " << NumberOfCores();
   ss << "\nkeyframe_interval: " << keyframe_interval;
   ss << "\ncodec_type: " << codec_type;
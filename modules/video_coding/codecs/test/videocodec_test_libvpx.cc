@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string>
 #include <vector>
 
 #include "absl/memory/memory.h"
@@ -17,8 +18,10 @@
 #include "media/engine/internaldecoderfactory.h"
 #include "media/engine/internalencoderfactory.h"
 #include "media/engine/simulcast_encoder_adapter.h"
+#include "modules/video_coding/codecs/test/videocodec_test_batch.h"
 #include "modules/video_coding/utility/vp8_header_parser.h"
 #include "modules/video_coding/utility/vp9_uncompressed_header_parser.h"
+#include "rtc_base/arraysize.h"
 #include "test/function_video_encoder_factory.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
@@ -485,5 +488,65 @@ TEST(VideoCodecTestLibvpx, DISABLED_SvcVP9RdPerf) {
   PrintRdPerf(rd_stats);
 }
 
+TEST(VideoCodecTestLibvpx, BatchOfVP8Bitrates) {
+  const size_t kBitratesKbps[] = {200, 500, 1000};
+  VideoCodecTestBatch batch(0);
+  for (size_t bitrate_kbps : kBitratesKbps) {
+    VideoCodecTestBatch::Job job;
+    job.name = "vp8_" + std::to_string(bitrate_kbps) + "kbps";
+    job.config = CreateConfig();
+    job.config.num_frames = kNumFramesShort;
+    job.config.quality_calc_threads = 1;
+    job.config.SetCodecSettings(cricket::kVp8CodecName, 1, 1, 1, true, true,
+                                false, kCifWidth, kCifHeight);
+    job.rate_profiles = {{bitrate_kbps, 30, kNumFramesShort}};
+    batch.AddJob(job);
+  }
+
+  const std::vector<VideoCodecTestBatch::Result> results = batch.Run();
+  VideoCodecTestBatch::PrintResults(results);
+
+  ASSERT_EQ(arraysize(kBitratesKbps), results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ("vp8_" + std::to_string(kBitratesKbps[i]) + "kbps",
+              results[i].name);
+    EXPECT_EQ(static_cast<size_t>(kNumFramesShort),
+              results[i].send_stats.num_input_frames);
+    EXPECT_GT(results[i].send_stats.avg_psnr, 30);
+  }
+  EXPECT_LT(results.front().send_stats.avg_psnr,
+            results.back().send_stats.avg_psnr);
+}
+
+// Compares the encoding speed on a single core with the speed on all cores of
+// the machine, for one to three spatial layers.
+TEST(VideoCodecTestLibvpx, DISABLED_SvcVP9ThreadingPerf) {
+  printf("--> Summary\n");
+  printf("%14s %9s %13s %13s\n", "spatial_layers", "num_cores",
+         "enc_speed_fps", "dec_speed_fps");
+  for (size_t num_spatial_layers = 1; num_spatial_layers <= 3;
+       ++num_spatial_layers) {
+    for (bool use_single_core : {true, false}) {
+      auto config = CreateConfig();
+      config.filename = "FourPeople_1280x720_30";
+      config.filepath = ResourcePath(config.filename, "yuv");
+      config.num_frames = kNumFramesShort;
+      config.use_single_core = use_single_core;
+      config.SetCodecSettings(cricket::kVp9CodecName, 1, num_spatial_layers,
+                              3, true, true, false, 1280, 720);
+      auto fixture = CreateVideoCodecTestFixture(config);
+
+      std::vector<RateProfile> rate_profiles = {{1500, 30, config.num_frames}};
+      fixture->RunTest(rate_profiles, nullptr, nullptr, nullptr);
+
+      const VideoStatistics stats =
+          fixture->GetStats().SliceAndCalcAggregatedVideoStatistic(
+              0, config.num_frames - 1);
+      printf("%14zu %9zu %13.2f %13.2f\n", num_spatial_layers,
+             config.NumberOfCores(), stats.enc_speed_fps, stats.dec_speed_fps);
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace webrtc
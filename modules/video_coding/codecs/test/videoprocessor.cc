@@ -24,6 +24,7 @@
 #include "modules/video_coding/utility/default_video_bitrate_allocator.h"
 #include "modules/video_coding/utility/simulcast_rate_allocator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/timeutils.h"
 #include "test/gtest.h"
 #include "third_party/libyuv/include/libyuv/compare.h"
@@ -193,7 +194,8 @@ VideoProcessor::VideoProcessor(webrtc::VideoEncoder* encoder,
       first_decoded_frame_(num_simulcast_or_spatial_layers_, true),
       last_decoded_frame_num_(num_simulcast_or_spatial_layers_),
       decoded_frame_buffer_(num_simulcast_or_spatial_layers_),
-      post_encode_time_ns_(0) {
+      post_encode_time_ns_(0),
+      next_quality_task_queue_(0) {
   // Sanity checks.
   RTC_CHECK(rtc::TaskQueue::Current())
       << "VideoProcessor must be run on a task queue.";
@@ -228,11 +230,35 @@ VideoProcessor::VideoProcessor(webrtc::VideoEncoder* encoder,
                      decode_callback_.at(i).get()),
                  WEBRTC_VIDEO_CODEC_OK);
   }
+
+  for (size_t i = 0; i < config_.quality_calc_threads; ++i) {
+    quality_task_queues_.push_back(
+        absl::make_unique<rtc::TaskQueue>("VideoProcessorQuality"));
+  }
 }
 
 VideoProcessor::~VideoProcessor() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequence_checker_);
 
+  // Wait for the outstanding quality calculations, and store their results.
+  for (auto& quality_task_queue : quality_task_queues_) {
+    rtc::Event done(false, false);
+    quality_task_queue->PostTask([&done] { done.Set(); });
+    done.Wait(rtc::Event::kForever);
+  }
+  {
+    rtc::CritScope lock(&quality_lock_);
+    for (const FrameStatistics& quality : quality_results_) {
+      FrameStatistics* frame_stat =
+          stats_->GetFrame(quality.frame_number, quality.spatial_idx);
+      frame_stat->psnr_y = quality.psnr_y;
+      frame_stat->psnr_u = quality.psnr_u;
+      frame_stat->psnr_v = quality.psnr_v;
+      frame_stat->psnr = quality.psnr;
+      frame_stat->ssim = quality.ssim;
+    }
+  }
+
   // Explicitly reset codecs, in case they don't do that themselves when they
   // go out of scope.
   RTC_CHECK_EQ(encoder_->Release(), WEBRTC_VIDEO_CODEC_OK);
@@ -493,9 +519,31 @@ void VideoProcessor::FrameDecoded(const VideoFrame& decoded_frame,
     RTC_CHECK(reference_frame != input_frames_.cend())
         << "The codecs are either buffering too much, dropping too much, or "
            "being too slow relative the input frame rate.";
-    CalculateFrameQuality(
-        *reference_frame->second.video_frame_buffer()->ToI420(),
-        *decoded_frame.video_frame_buffer()->ToI420(), frame_stat);
+    if (quality_task_queues_.empty()) {
+      CalculateFrameQuality(
+          *reference_frame->second.video_frame_buffer()->ToI420(),
+          *decoded_frame.video_frame_buffer()->ToI420(), frame_stat);
+    } else {
+      // The frames are reference counted, so the copies are cheap. The
+      // results are stored on destruction, since |stats_| may reallocate
+      // while frames are added.
+      const VideoFrame reference = reference_frame->second;
+      const VideoFrame decoded = decoded_frame;
+      rtc::TaskQueue* quality_task_queue =
+          quality_task_queues_[next_quality_task_queue_].get();
+      next_quality_task_queue_ =
+          (next_quality_task_queue_ + 1) % quality_task_queues_.size();
+      quality_task_queue->PostTask(
+          [this, reference, decoded, frame_number, spatial_idx] {
+            FrameStatistics quality(frame_number, 0);
+            quality.spatial_idx = spatial_idx;
+            CalculateFrameQuality(*reference.video_frame_buffer()->ToI420(),
+                                  *decoded.video_frame_buffer()->ToI420(),
+                                  &quality);
+            rtc::CritScope lock(&quality_lock_);
+            quality_results_.push_back(quality);
+          });
+    }
 
     // Erase all buffered input frames that we have moved past for all
     // simulcast/spatial layers. Never buffer more than
@@ -24,6 +24,7 @@
 #include "modules/video_coding/utility/ivf_file_writer.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/sequenced_task_checker.h"
 #include "rtc_base/task_queue.h"
 #include "test/testsupport/frame_reader.h"
@@ -236,6 +237,16 @@ class VideoProcessor {
   // is substracted from measured encode time. Thus we get pure encode time.
   int64_t post_encode_time_ns_ RTC_GUARDED_BY(sequence_checker_);
 
+  // With |config_.quality_calc_threads|, frame quality is calculated on these
+  // task queues, in turn, so that it doesn't hold up encoding and decoding.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> quality_task_queues_;
+  size_t next_quality_task_queue_ RTC_GUARDED_BY(sequence_checker_);
+  rtc::CriticalSection quality_lock_;
+  // Quality metrics of the frames, identified by |frame_number| and
+  // |spatial_idx|. Written to |stats_| on destruction.
+  std::vector<VideoCodecTestStats::FrameStatistics> quality_results_
+      RTC_GUARDED_BY(quality_lock_);
+
   // This class must be operated on a TaskQueue.
   rtc::SequencedTaskChecker sequence_checker_;
 
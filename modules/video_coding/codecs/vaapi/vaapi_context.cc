@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/vaapi/vaapi_context.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "va/va_drm.h"
+#include "va/va_vpp.h"
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/refcountedobject.h"
+#include "third_party/libyuv/include/libyuv/convert.h"
+
+namespace webrtc {
+
+rtc::scoped_refptr<VaapiContext> VaapiContext::Create(
+    const std::string& device_path) {
+  const int fd = open(device_path.c_str(), O_RDWR);
+  if (fd < 0) {
+    RTC_LOG(LS_WARNING) << "Failed to open " << device_path;
+    return nullptr;
+  }
+  VADisplay display = vaGetDisplayDRM(fd);
+  int major_version;
+  int minor_version;
+  if (!display ||
+      vaInitialize(display, &major_version, &minor_version) !=
+          VA_STATUS_SUCCESS) {
+    RTC_LOG(LS_WARNING) << "Failed to initialize VA-API on " << device_path;
+    if (display)
+      vaTerminate(display);
+    close(fd);
+    return nullptr;
+  }
+  RTC_LOG(LS_INFO) << "Initialized VA-API " << major_version << "."
+                   << minor_version << " on " << device_path << ": "
+                   << vaQueryVendorString(display);
+  return new rtc::RefCountedObject<VaapiContext>(fd, display);
+}
+
+VaapiContext::VaapiContext(int fd, VADisplay display)
+    : fd_(fd),
+      display_(display),
+      vpp_config_(VA_INVALID_ID),
+      vpp_context_(VA_INVALID_ID) {}
+
+VaapiContext::~VaapiContext() {
+  if (vpp_context_ != VA_INVALID_ID)
+    vaDestroyContext(display_, vpp_context_);
+  if (vpp_config_ != VA_INVALID_ID)
+    vaDestroyConfig(display_, vpp_config_);
+  vaTerminate(display_);
+  close(fd_);
+}
+
+VASurfaceID VaapiContext::CreateSurface(int width, int height) {
+  VASurfaceAttrib attrib;
+  memset(&attrib, 0, sizeof(attrib));
+  attrib.type = VASurfaceAttribPixelFormat;
+  attrib.flags = VA_SURFACE_ATTRIB_SETTABLE;
+  attrib.value.type = VAGenericValueTypeInteger;
+  attrib.value.value.i = VA_FOURCC_NV12;
+  VASurfaceID surface;
+  if (vaCreateSurfaces(display_, VA_RT_FORMAT_YUV420, width, height, &surface,
+                       1, &attrib, 1) != VA_STATUS_SUCCESS) {
+    RTC_LOG(LS_ERROR) << "Failed to create " << width << "x" << height
+                      << " surface.";
+    return VA_INVALID_SURFACE;
+  }
+  return surface;
+}
+
+void VaapiContext::DestroySurface(VASurfaceID surface) {
+  vaDestroySurfaces(display_, &surface, 1);
+}
+
+bool VaapiContext::ScaleSurface(VASurfaceID src_surface,
+                                const VARectangle& src_rect,
+                                VASurfaceID dst_surface,
+                                int dst_width,
+                                int dst_height) {
+  rtc::CritScope lock(&crit_);
+  if (!InitVpp(dst_width, dst_height))
+    return false;
+
+  VAProcPipelineParameterBuffer params;
+  memset(&params, 0, sizeof(params));
+  params.surface = src_surface;
+  params.surface_region = &src_rect;
+  // A null region stands for the whole surface.
+  params.output_region = nullptr;
+  params.output_background_color = 0xff000000;
+  params.filter_flags = VA_FILTER_SCALING_DEFAULT;
+
+  VABufferID params_buffer;
+  if (vaCreateBuffer(display_, vpp_context_, VAProcPipelineParameterBufferType,
+                     sizeof(params), 1, &params,
+                     &params_buffer) != VA_STATUS_SUCCESS) {
+    return false;
+  }
+  const bool success =
+      vaBeginPicture(display_, vpp_context_, dst_surface) ==
+          VA_STATUS_SUCCESS &&
+      vaRenderPicture(display_, vpp_context_, &params_buffer, 1) ==
+          VA_STATUS_SUCCESS &&
+      vaEndPicture(display_, vpp_context_) == VA_STATUS_SUCCESS;
+  vaDestroyBuffer(display_, params_buffer);
+  if (!success)
+    RTC_LOG(LS_ERROR) << "Failed to scale surface.";
+  return success;
+}
+
+rtc::scoped_refptr<I420Buffer> VaapiContext::ReadSurface(VASurfaceID surface,
+                                                         int width,
+                                                         int height) {
+  if (vaSyncSurface(display_, surface) != VA_STATUS_SUCCESS)
+    return nullptr;
+
+  // Mapping the surface directly avoids a copy, but isn't supported by all
+  // drivers; fall back to copying it to an image.
+  VAImage image;
+  if (vaDeriveImage(display_, surface, &image) != VA_STATUS_SUCCESS) {
+    VAImageFormat format;
+    memset(&format, 0, sizeof(format));
+    format.fourcc = VA_FOURCC_NV12;
+    format.byte_order = VA_LSB_FIRST;
+    format.bits_per_pixel = 12;
+    if (vaCreateImage(display_, &format, width, height, &image) !=
+        VA_STATUS_SUCCESS) {
+      return nullptr;
+    }
+    if (vaGetImage(display_, surface, 0, 0, width, height, image.image_id) !=
+        VA_STATUS_SUCCESS) {
+      vaDestroyImage(display_, image.image_id);
+      return nullptr;
+    }
+  }
+
+  rtc::scoped_refptr<I420Buffer> buffer;
+  uint8_t* data;
+  if (image.format.fourcc == VA_FOURCC_NV12 &&
+      vaMapBuffer(display_, image.buf, reinterpret_cast<void**>(&data)) ==
+          VA_STATUS_SUCCESS) {
+    buffer = I420Buffer::Create(width, height);
+    libyuv::NV12ToI420(data + image.offsets[0], image.pitches[0],
+                       data + image.offsets[1], image.pitches[1],
+                       buffer->MutableDataY(), buffer->StrideY(),
+                       buffer->MutableDataU(), buffer->StrideU(),
+                       buffer->MutableDataV(), buffer->StrideV(), width,
+                       height);
+    vaUnmapBuffer(display_, image.buf);
+  }
+  vaDestroyImage(display_, image.image_id);
+  return buffer;
+}
+
+bool VaapiContext::InitVpp(int width, int height) {
+  if (vpp_context_ != VA_INVALID_ID)
+    return true;
+  if (vpp_config_ == VA_INVALID_ID &&
+      vaCreateConfig(display_, VAProfileNone, VAEntrypointVideoProc, nullptr, 0,
+                     &vpp_config_) != VA_STATUS_SUCCESS) {
+    RTC_LOG(LS_ERROR) << "Video processing isn't supported.";
+    vpp_config_ = VA_INVALID_ID;
+    return false;
+  }
+  // The render targets are passed to vaBeginPicture instead.
+  if (vaCreateContext(display_, vpp_config_, width, height, VA_PROGRESSIVE,
+                      nullptr, 0, &vpp_context_) != VA_STATUS_SUCCESS) {
+    RTC_LOG(LS_ERROR) << "Failed to create video processing context.";
+    vpp_context_ = VA_INVALID_ID;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_CODECS_VAAPI_VAAPI_CONTEXT_H_
+#define MODULES_VIDEO_CODING_CODECS_VAAPI_VAAPI_CONTEXT_H_
+
+#include <string>
+
+#include "va/va.h"
+
+#include "api/video/i420_buffer.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Owns a VA-API display opened on a DRM render node, e.g.
+// "/dev/dri/renderD128", and the video processing context used to scale
+// surfaces on the GPU. The surfaces of a display can be shared by the frame
+// buffers and codecs that use the same VaapiContext. Thread safe.
+class VaapiContext : public rtc::RefCountInterface {
+ public:
+  // Returns null if the device can't be opened or doesn't support VA-API.
+  static rtc::scoped_refptr<VaapiContext> Create(
+      const std::string& device_path);
+
+  VADisplay display() const { return display_; }
+
+  // Creates an NV12 surface. Returns VA_INVALID_SURFACE on failure.
+  VASurfaceID CreateSurface(int width, int height);
+  void DestroySurface(VASurfaceID surface);
+
+  // Scales |src_rect| of |src_surface| into the whole of |dst_surface| on the
+  // GPU.
+  bool ScaleSurface(VASurfaceID src_surface,
+                    const VARectangle& src_rect,
+                    VASurfaceID dst_surface,
+                    int dst_width,
+                    int dst_height);
+
+  // Waits for the pending operations on |surface| and copies its pixels to
+  // an I420 buffer. Returns null on failure.
+  rtc::scoped_refptr<I420Buffer> ReadSurface(VASurfaceID surface,
+                                             int width,
+                                             int height);
+
+ protected:
+  VaapiContext(int fd, VADisplay display);
+  ~VaapiContext() override;
+
+ private:
+  // Creates the video processing context the first time it is needed.
+  bool InitVpp(int width, int height) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const int fd_;
+  const VADisplay display_;
+
+  rtc::CriticalSection crit_;
+  VAConfigID vpp_config_ RTC_GUARDED_BY(crit_);
+  VAContextID vpp_context_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_CODECS_VAAPI_VAAPI_CONTEXT_H_
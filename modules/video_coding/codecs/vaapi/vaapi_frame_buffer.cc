@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/vaapi/vaapi_frame_buffer.h"
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace webrtc {
+
+rtc::scoped_refptr<VaapiFrameBuffer> VaapiFrameBuffer::Create(
+    rtc::scoped_refptr<VaapiContext> context,
+    VASurfaceID surface,
+    int width,
+    int height) {
+  return new rtc::RefCountedObject<VaapiFrameBuffer>(std::move(context),
+                                                     surface, width, height);
+}
+
+VaapiFrameBuffer::VaapiFrameBuffer(rtc::scoped_refptr<VaapiContext> context,
+                                   VASurfaceID surface,
+                                   int width,
+                                   int height)
+    : context_(std::move(context)),
+      surface_(surface),
+      width_(width),
+      height_(height) {
+  RTC_DCHECK(context_);
+  RTC_DCHECK_NE(surface_, VA_INVALID_SURFACE);
+}
+
+VaapiFrameBuffer::~VaapiFrameBuffer() {
+  context_->DestroySurface(surface_);
+}
+
+VideoFrameBuffer::Type VaapiFrameBuffer::type() const {
+  return Type::kNative;
+}
+
+int VaapiFrameBuffer::width() const {
+  return width_;
+}
+
+int VaapiFrameBuffer::height() const {
+  return height_;
+}
+
+rtc::scoped_refptr<I420BufferInterface> VaapiFrameBuffer::ToI420() {
+  rtc::CritScope lock(&crit_);
+  if (!i420_buffer_)
+    i420_buffer_ = context_->ReadSurface(surface_, width_, height_);
+  return i420_buffer_;
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> VaapiFrameBuffer::CropAndScaleNative(
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) {
+  VASurfaceID scaled_surface =
+      context_->CreateSurface(scaled_width, scaled_height);
+  if (scaled_surface == VA_INVALID_SURFACE)
+    return nullptr;
+  VARectangle crop_rect;
+  crop_rect.x = offset_x;
+  crop_rect.y = offset_y;
+  crop_rect.width = crop_width;
+  crop_rect.height = crop_height;
+  if (!context_->ScaleSurface(surface_, crop_rect, scaled_surface,
+                              scaled_width, scaled_height)) {
+    context_->DestroySurface(scaled_surface);
+    return nullptr;
+  }
+  return Create(context_, scaled_surface, scaled_width, scaled_height);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_CODECS_VAAPI_VAAPI_FRAME_BUFFER_H_
+#define MODULES_VIDEO_CODING_CODECS_VAAPI_VAAPI_FRAME_BUFFER_H_
+
+#include "va/va.h"
+
+#include "api/video/video_frame_buffer.h"
+#include "modules/video_coding/codecs/vaapi/vaapi_context.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// A kNative frame buffer that keeps a frame in a VA-API surface, e.g. a frame
+// decoded or captured on the GPU, so that it can be passed on to a VA-API
+// encoder without leaving the GPU. The pixels are only copied to memory the
+// first time ToI420() is called, and CropAndScaleNative() scales them on the
+// GPU.
+class VaapiFrameBuffer : public VideoFrameBuffer {
+ public:
+  // Takes ownership of |surface|, a surface of |context| which is destroyed
+  // with the buffer.
+  static rtc::scoped_refptr<VaapiFrameBuffer> Create(
+      rtc::scoped_refptr<VaapiContext> context,
+      VASurfaceID surface,
+      int width,
+      int height);
+
+  Type type() const override;
+  int width() const override;
+  int height() const override;
+  rtc::scoped_refptr<I420BufferInterface> ToI420() override;
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScaleNative(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override;
+
+  const rtc::scoped_refptr<VaapiContext>& context() const { return context_; }
+  VASurfaceID surface() const { return surface_; }
+
+ protected:
+  VaapiFrameBuffer(rtc::scoped_refptr<VaapiContext> context,
+                   VASurfaceID surface,
+                   int width,
+                   int height);
+  ~VaapiFrameBuffer() override;
+
+ private:
+  const rtc::scoped_refptr<VaapiContext> context_;
+  const VASurfaceID surface_;
+  const int width_;
+  const int height_;
+
+  rtc::CriticalSection crit_;
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_CODECS_VAAPI_VAAPI_FRAME_BUFFER_H_
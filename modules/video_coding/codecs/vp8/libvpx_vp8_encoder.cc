@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"
@@ -33,6 +34,10 @@ const char kVp8GfBoostFieldTrial[] = "WebRTC-VP8-GfBoost";
 constexpr int kLowVp8QpThreshold = 29;
 constexpr int kHighVp8QpThreshold = 95;
 
+// Fastest cpu_speed that SetSpeedSteps may select, the one used for large
+// resolutions on mobile platforms.
+constexpr int kFastestCpuSpeed = -12;
+
 constexpr int kTokenPartitions = VP8_ONE_TOKENPARTITION;
 constexpr uint32_t kVp832ByteAlign = 32u;
 
@@ -158,6 +163,8 @@ LibvpxVp8Encoder::LibvpxVp8Encoder()
       qp_max_(56),  // Setting for max quantizer.
       cpu_speed_default_(-6),
       number_of_cores_(0),
+      init_width_(0),
+      init_height_(0),
       rc_max_intra_target_(0),
       key_frame_request_(kMaxSimulcastStreams, false) {
   temporal_layers_.reserve(kMaxSimulcastStreams);
@@ -178,11 +185,7 @@ LibvpxVp8Encoder::~LibvpxVp8Encoder() {
 int LibvpxVp8Encoder::Release() {
   int ret_val = WEBRTC_VIDEO_CODEC_OK;
 
-  while (!encoded_images_.empty()) {
-    EncodedImage& image = encoded_images_.back();
-    delete[] image._buffer;
-    encoded_images_.pop_back();
-  }
+  encoded_images_.clear();
   while (!encoders_.empty()) {
     vpx_codec_ctx_t& encoder = encoders_.back();
     if (inited_) {
@@ -376,12 +379,8 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   }
   for (int i = 0; i < number_of_streams; ++i) {
     // allocate memory for encoded image
-    if (encoded_images_[i]._buffer != NULL) {
-      delete[] encoded_images_[i]._buffer;
-    }
-    encoded_images_[i]._size =
-        CalcBufferSize(VideoType::kI420, codec_.width, codec_.height);
-    encoded_images_[i]._buffer = new uint8_t[encoded_images_[i]._size];
+    encoded_images_[i].SetEncodedData(rtc::CopyOnWriteBuffer(
+        0, CalcBufferSize(VideoType::kI420, codec_.width, codec_.height)));
     encoded_images_[i]._completeFrame = true;
   }
   // populate encoder configuration with default values
@@ -450,6 +449,8 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   }
   configurations_[0].g_w = inst->width;
   configurations_[0].g_h = inst->height;
+  init_width_ = inst->width;
+  init_height_ = inst->height;
 
   // Determine number of threads based on the image size and #cores.
   // TODO(fbarchard): Consider number of Simulcast layers.
@@ -830,7 +831,12 @@ int LibvpxVp8Encoder::GetEncodedPartitions(
        ++encoder_idx, --stream_idx) {
     vpx_codec_iter_t iter = NULL;
     int part_idx = 0;
-    encoded_images_[encoder_idx]._length = 0;
+    // The storage of the previous frame is reused, unless copies of its image
+    // are still alive, in which case new storage is allocated instead of
+    // overwriting theirs.
+    rtc::CopyOnWriteBuffer encoded_data =
+        encoded_images_[encoder_idx].ReleaseEncodedData();
+    encoded_data.Clear();
     encoded_images_[encoder_idx]._frameType = kVideoFrameDelta;
     RTPFragmentationHeader frag_info;
     // kTokenPartitions is number of bits used.
@@ -841,23 +847,13 @@ int LibvpxVp8Encoder::GetEncodedPartitions(
            NULL) {
       switch (pkt->kind) {
         case VPX_CODEC_CX_FRAME_PKT: {
-          size_t length = encoded_images_[encoder_idx]._length;
-          if (pkt->data.frame.sz + length >
-              encoded_images_[encoder_idx]._size) {
-            uint8_t* buffer = new uint8_t[pkt->data.frame.sz + length];
-            memcpy(buffer, encoded_images_[encoder_idx]._buffer, length);
-            delete[] encoded_images_[encoder_idx]._buffer;
-            encoded_images_[encoder_idx]._buffer = buffer;
-            encoded_images_[encoder_idx]._size = pkt->data.frame.sz + length;
-          }
-          memcpy(&encoded_images_[encoder_idx]._buffer[length],
-                 pkt->data.frame.buf, pkt->data.frame.sz);
-          frag_info.fragmentationOffset[part_idx] = length;
+          frag_info.fragmentationOffset[part_idx] = encoded_data.size();
           frag_info.fragmentationLength[part_idx] = pkt->data.frame.sz;
           frag_info.fragmentationPlType[part_idx] = 0;  // not known here
           frag_info.fragmentationTimeDiff[part_idx] = 0;
-          encoded_images_[encoder_idx]._length += pkt->data.frame.sz;
-          assert(length <= encoded_images_[encoder_idx]._size);
+          encoded_data.AppendData(
+              static_cast<const uint8_t*>(pkt->data.frame.buf),
+              pkt->data.frame.sz);
           ++part_idx;
           break;
         }
@@ -875,6 +871,7 @@ int LibvpxVp8Encoder::GetEncodedPartitions(
         break;
       }
     }
+    encoded_images_[encoder_idx].SetEncodedData(std::move(encoded_data));
     encoded_images_[encoder_idx]._timeStamp = input_image.timestamp();
     encoded_images_[encoder_idx].capture_time_ms_ =
         input_image.render_time_ms();
@@ -920,6 +917,50 @@ VideoEncoder::ScalingSettings LibvpxVp8Encoder::GetScalingSettings() const {
                         : VideoEncoder::ScalingSettings::kOff;
 }
 
+bool LibvpxVp8Encoder::SetSpeedSteps(int steps) {
+  if (!inited_ || steps < 0)
+    return steps == 0;
+  // |cpu_speed_| holds the speeds selected in InitEncode, more negative values
+  // are faster.
+  for (int cpu_speed : cpu_speed_) {
+    if (cpu_speed - steps < kFastestCpuSpeed)
+      return false;
+  }
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    vpx_codec_control(&(encoders_[i]), VP8E_SET_CPUUSED,
+                      cpu_speed_[i] - steps);
+  }
+  return true;
+}
+
+bool LibvpxVp8Encoder::Reconfigure(const VideoCodec& codec_settings) {
+  // vpx_codec_enc_config_set() can scale a single stream down, or back up to
+  // the resolution it was initialized with, keeping the thread count. The
+  // stream continues with a key frame, which carries the new resolution.
+  if (!inited_ || encoders_.size() != 1 ||
+      SimulcastUtility::NumberOfSimulcastStreams(codec_settings) != 1 ||
+      codec_settings.width <= 1 || codec_settings.height <= 1 ||
+      codec_settings.width > init_width_ ||
+      codec_settings.height > init_height_) {
+    return false;
+  }
+  codec_ = codec_settings;
+  if (codec_.numberOfSimulcastStreams == 0) {
+    codec_.simulcastStream[0].width = codec_.width;
+    codec_.simulcastStream[0].height = codec_.height;
+  }
+  configurations_[0].g_w = codec_.width;
+  configurations_[0].g_h = codec_.height;
+  if (vpx_codec_enc_config_set(&encoders_[0], &configurations_[0]))
+    return false;
+  vpx_img_wrap(&raw_images_[0], VPX_IMG_FMT_I420, codec_.width, codec_.height,
+               1, NULL);
+  cpu_speed_[0] = SetCpuSpeed(codec_.width, codec_.height);
+  vpx_codec_control(&encoders_[0], VP8E_SET_CPUUSED, cpu_speed_[0]);
+  key_frame_request_[0] = true;
+  return true;
+}
+
 int LibvpxVp8Encoder::SetChannelParameters(uint32_t packetLoss, int64_t rtt) {
   return WEBRTC_VIDEO_CODEC_OK;
 }
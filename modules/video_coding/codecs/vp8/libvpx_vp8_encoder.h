@@ -51,6 +51,10 @@ class LibvpxVp8Encoder : public VP8Encoder {
 
   ScalingSettings GetScalingSettings() const override;
 
+  bool SetSpeedSteps(int steps) override;
+
+  bool Reconfigure(const VideoCodec& codec_settings) override;
+
   const char* ImplementationName() const override;
 
   static vpx_enc_frame_flags_t EncodeFlags(
@@ -93,6 +97,10 @@ class LibvpxVp8Encoder : public VP8Encoder {
   int qp_max_;
   int cpu_speed_default_;
   int number_of_cores_;
+  // The resolution of InitEncode, which libvpx can't exceed without being
+  // reinitialized.
+  int init_width_;
+  int init_height_;
   uint32_t rc_max_intra_target_;
   std::vector<std::unique_ptr<TemporalLayers>> temporal_layers_;
   std::vector<std::unique_ptr<TemporalLayersChecker>> temporal_layers_checkers_;
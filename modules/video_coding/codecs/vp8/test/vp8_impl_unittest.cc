@@ -9,8 +9,10 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include <memory>
+#include <vector>
 
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/video_coding/codecs/test/video_codec_unittest.h"
@@ -112,6 +114,24 @@ TEST_F(TestVp8Impl, EncodeFrameAndRelease) {
             encoder_->Encode(*NextInputFrame(), nullptr, nullptr));
 }
 
+TEST_F(TestVp8Impl, EncodedDataOutlivesNextEncode) {
+  EncodedImage encoded_frame;
+  CodecSpecificInfo codec_specific_info;
+  EncodeAndWaitForFrame(*NextInputFrame(), &encoded_frame,
+                        &codec_specific_info);
+  const std::vector<uint8_t> data(
+      encoded_frame._buffer, encoded_frame._buffer + encoded_frame._length);
+
+  // The copy of the first image keeps its data, the next frame is encoded to
+  // new storage.
+  EncodedImage next_encoded_frame;
+  EncodeAndWaitForFrame(*NextInputFrame(), &next_encoded_frame,
+                        &codec_specific_info);
+  EXPECT_NE(encoded_frame._buffer, next_encoded_frame._buffer);
+  ASSERT_EQ(data.size(), encoded_frame._length);
+  EXPECT_EQ(0, memcmp(data.data(), encoded_frame._buffer, data.size()));
+}
+
 TEST_F(TestVp8Impl, InitDecode) {
   EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder_->Release());
   EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
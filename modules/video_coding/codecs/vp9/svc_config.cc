@@ -16,6 +16,7 @@
 
 #include "modules/video_coding/codecs/vp9/svc_rate_allocator.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "rtc_base/checks.h"
 
 namespace webrtc {
 
@@ -24,6 +25,30 @@ const size_t kMinVp9SvcBitrateKbps = 30;
 
 const size_t kMaxNumLayersForScreenSharing = 2;
 const size_t kMaxScreenSharingLayerBitrateKbps[] = {200, 500};
+
+// Minimum width of a tile column, and maximum number of them, in libvpx.
+const int kMinVp9TileColumnWidth = 256;
+const int kMaxVp9TileColumnsLog2 = 6;
+
+int NumberOfThreads(int width, int height, int number_of_cores) {
+  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
+    return 8;
+  } else if (width * height >= 1280 * 720 && number_of_cores > 4) {
+    return 4;
+  } else if (width * height >= 640 * 360 && number_of_cores > 2) {
+    return 2;
+  } else {
+// Use 2 threads for low res on ARM.
+#if defined(WEBRTC_ARCH_ARM) || defined(WEBRTC_ARCH_ARM64) || \
+    defined(WEBRTC_ANDROID)
+    if (width * height >= 320 * 180 && number_of_cores > 2) {
+      return 2;
+    }
+#endif
+    // 1 thread less than VGA.
+    return 1;
+  }
+}
 }  // namespace
 
 std::vector<SpatialLayer> ConfigureSvcScreenSharing(size_t input_width,
@@ -119,4 +144,38 @@ std::vector<SpatialLayer> GetSvcConfig(size_t input_width,
   }
 }
 
+SvcThreadingConfig GetSvcThreadingConfig(
+    const std::vector<SpatialLayer>& spatial_layers,
+    int number_of_cores,
+    int max_threads) {
+  RTC_DCHECK(!spatial_layers.empty());
+  RTC_DCHECK_GT(max_threads, 0);
+
+  int width = 0;
+  int height = 0;
+  for (const SpatialLayer& layer : spatial_layers) {
+    if (layer.width * layer.height > width * height) {
+      width = layer.width;
+      height = layer.height;
+    }
+  }
+
+  SvcThreadingConfig config;
+  config.num_threads =
+      std::min(NumberOfThreads(width, height, number_of_cores), max_threads);
+
+  // Use as many tile columns as threads, as far as the largest layer is wide
+  // enough for them. libvpx caps the tile columns of each layer to its width.
+  config.tile_columns_log2 = 0;
+  while (config.tile_columns_log2 < kMaxVp9TileColumnsLog2 &&
+         (2 << config.tile_columns_log2) <= config.num_threads &&
+         (kMinVp9TileColumnWidth << (config.tile_columns_log2 + 1)) <=
+             width) {
+    ++config.tile_columns_log2;
+  }
+
+  config.row_mt = config.num_threads > 1;
+  return config;
+}
+
 }  // namespace webrtc
@@ -22,6 +22,25 @@ std::vector<SpatialLayer> GetSvcConfig(size_t input_width,
                                        size_t num_temporal_layers,
                                        bool is_screen_sharing);
 
+// Multithreading settings of the VP9 encoder for a set of spatial layers.
+struct SvcThreadingConfig {
+  int num_threads;
+  // Number of column tiles in log2 units, e.g. 2 for 4 tile columns.
+  int tile_columns_log2;
+  // Splits each tile across the threads by rows of blocks.
+  bool row_mt;
+};
+
+// Sizes the encoder thread pool after the largest of |spatial_layers| and
+// |number_of_cores|, using at most |max_threads| threads. Tile columns are at
+// least 256 pixels wide, so lower spatial layers can have fewer tile columns
+// than there are threads; row-based multithreading keeps the threads busy on
+// those layers.
+SvcThreadingConfig GetSvcThreadingConfig(
+    const std::vector<SpatialLayer>& spatial_layers,
+    int number_of_cores,
+    int max_threads);
+
 }  // namespace webrtc
 
 #endif  // MODULES_VIDEO_CODING_CODECS_VP9_SVC_CONFIG_H_
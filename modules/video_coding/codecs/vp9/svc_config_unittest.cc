@@ -60,4 +60,38 @@ TEST(SvcConfig, ScreenSharing) {
     EXPECT_LE(layer.targetBitrate, layer.maxBitrate);
   }
 }
+
+TEST(SvcConfig, ThreadingFollowsLargestLayer) {
+  std::vector<SpatialLayer> spatial_layers =
+      GetSvcConfig(1280, 720, 3, 3, false);
+
+  SvcThreadingConfig config = GetSvcThreadingConfig(spatial_layers, 8, 8);
+  EXPECT_EQ(config.num_threads, 4);
+  EXPECT_EQ(config.tile_columns_log2, 2);
+  EXPECT_TRUE(config.row_mt);
+
+  config = GetSvcThreadingConfig(spatial_layers, 4, 8);
+  EXPECT_EQ(config.num_threads, 2);
+  EXPECT_EQ(config.tile_columns_log2, 1);
+
+  config = GetSvcThreadingConfig(spatial_layers, 1, 8);
+  EXPECT_EQ(config.num_threads, 1);
+  EXPECT_EQ(config.tile_columns_log2, 0);
+  EXPECT_FALSE(config.row_mt);
+}
+
+TEST(SvcConfig, ThreadingLimitsTileColumnsToLayerWidth) {
+  std::vector<SpatialLayer> spatial_layers =
+      GetSvcConfig(1920, 1080, 3, 1, false);
+
+  SvcThreadingConfig config = GetSvcThreadingConfig(spatial_layers, 16, 8);
+  EXPECT_EQ(config.num_threads, 8);
+  // 1920 pixels fit 4 tile columns of at least 256 pixels.
+  EXPECT_EQ(config.tile_columns_log2, 2);
+  EXPECT_TRUE(config.row_mt);
+
+  config = GetSvcThreadingConfig(spatial_layers, 16, 2);
+  EXPECT_EQ(config.num_threads, 2);
+  EXPECT_EQ(config.tile_columns_log2, 1);
+}
 }  // namespace webrtc
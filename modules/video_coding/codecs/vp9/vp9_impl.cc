@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <string>
 #include <vector>
 
 #include "vpx/vp8cx.h"
@@ -32,6 +33,7 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
@@ -40,6 +42,30 @@ const float kMaxScreenSharingFramerateFps = 5.0f;
 
 // Only positive speeds, range for real-time coding currently is: 5 - 8.
 // Lower means slower/better quality, higher means fastest/lower quality.
+constexpr int kMaxCpuSpeed = 8;
+
+// Caps the number of encoder threads and turns row-based multithreading on or
+// off, e.g. "Enabled-2,0" for at most 2 threads without row-mt.
+const char kVp9ThreadingFieldTrial[] = "WebRTC-VP9-Threading";
+constexpr int kMaxNumThreads = 8;
+
+void GetThreadingSettingsFromFieldTrialGroup(int* max_threads,
+                                             bool* row_mt_allowed) {
+  *max_threads = kMaxNumThreads;
+  *row_mt_allowed = true;
+  const std::string group =
+      webrtc::field_trial::FindFullName(kVp9ThreadingFieldTrial);
+  int parsed_max_threads;
+  int parsed_row_mt;
+  if (sscanf(group.c_str(), "Enabled-%d,%d", &parsed_max_threads,
+             &parsed_row_mt) != 2) {
+    return;
+  }
+  if (parsed_max_threads > 0 && parsed_max_threads <= kMaxNumThreads)
+    *max_threads = parsed_max_threads;
+  *row_mt_allowed = parsed_row_mt != 0;
+}
+
 int GetCpuSpeed(int width, int height) {
 #if defined(WEBRTC_ARCH_ARM) || defined(WEBRTC_ARCH_ARM64) || defined(ANDROID)
   return 8;
@@ -161,6 +187,7 @@ VP9EncoderImpl::VP9EncoderImpl(const cricket::VideoCodec& codec)
       last_encoded_frame_rtp_timestamp_(0),
       is_flexible_mode_(false) {
   memset(&codec_, 0, sizeof(codec_));
+  memset(&threading_config_, 0, sizeof(threading_config_));
   memset(&svc_params_, 0, sizeof(vpx_svc_extra_cfg_t));
 }
 
@@ -440,9 +467,25 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
     config_->kf_mode = VPX_KF_DISABLED;
   }
   config_->rc_resize_allowed = inst->VP9().automaticResizeOn ? 1 : 0;
-  // Determine number of threads based on the image size and #cores.
-  config_->g_threads =
-      NumberOfThreads(config_->g_w, config_->g_h, number_of_cores);
+  // Determine number of threads based on the largest spatial layer and
+  // #cores.
+  std::vector<SpatialLayer> spatial_layers;
+  if (ExplicitlyConfiguredSpatialLayers()) {
+    spatial_layers.assign(codec_.spatialLayers,
+                          codec_.spatialLayers + num_spatial_layers_);
+  } else {
+    SpatialLayer layer = {0};
+    layer.width = codec_.width;
+    layer.height = codec_.height;
+    spatial_layers.push_back(layer);
+  }
+  int max_threads;
+  bool row_mt_allowed;
+  GetThreadingSettingsFromFieldTrialGroup(&max_threads, &row_mt_allowed);
+  threading_config_ =
+      GetSvcThreadingConfig(spatial_layers, number_of_cores, max_threads);
+  threading_config_.row_mt &= row_mt_allowed;
+  config_->g_threads = threading_config_.num_threads;
 
   cpu_speed_ = GetCpuSpeed(config_->g_w, config_->g_h);
 
@@ -492,28 +535,6 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   return InitAndSetControlSettings(inst);
 }
 
-int VP9EncoderImpl::NumberOfThreads(int width,
-                                    int height,
-                                    int number_of_cores) {
-  // Keep the number of encoder threads equal to the possible number of column
-  // tiles, which is (1, 2, 4, 8). See comments below for VP9E_SET_TILE_COLUMNS.
-  if (width * height >= 1280 * 720 && number_of_cores > 4) {
-    return 4;
-  } else if (width * height >= 640 * 360 && number_of_cores > 2) {
-    return 2;
-  } else {
-// Use 2 threads for low res on ARM.
-#if defined(WEBRTC_ARCH_ARM) || defined(WEBRTC_ARCH_ARM64) || \
-    defined(WEBRTC_ANDROID)
-    if (width * height >= 320 * 180 && number_of_cores > 2) {
-      return 2;
-    }
-#endif
-    // 1 thread less than VGA.
-    return 1;
-  }
-}
-
 int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // Set QP-min/max per spatial and temporal layer.
   int tot_num_layers = num_spatial_layers_ * num_temporal_layers_;
@@ -623,10 +644,13 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // log2 unit: e.g., 0 = 1 tile column, 1 = 2 tile columns, 2 = 4 tile columns.
   // The number tile columns will be capped by the encoder based on image size
   // (minimum width of tile column is 256 pixels, maximum is 4096).
-  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, (config_->g_threads >> 1));
+  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS,
+                    threading_config_.tile_columns_log2);
 
-  // Turn on row-based multithreading.
-  vpx_codec_control(encoder_, VP9E_SET_ROW_MT, 1);
+  // Row-based multithreading splits the tiles across the threads, which keeps
+  // them busy on the spatial layers too narrow for all the tile columns.
+  vpx_codec_control(encoder_, VP9E_SET_ROW_MT,
+                    threading_config_.row_mt ? 1 : 0);
 
 #if !defined(WEBRTC_ARCH_ARM) && !defined(WEBRTC_ARCH_ARM64) && \
     !defined(ANDROID)
@@ -1082,6 +1106,13 @@ bool VP9EncoderImpl::DropFrame(uint32_t rtp_timestamp) {
   return false;
 }
 
+bool VP9EncoderImpl::SetSpeedSteps(int steps) {
+  if (!inited_ || steps < 0 || cpu_speed_ + steps > kMaxCpuSpeed)
+    return steps == 0;
+  vpx_codec_control(encoder_, VP8E_SET_CPUUSED, cpu_speed_ + steps);
+  return true;
+}
+
 int VP9EncoderImpl::SetChannelParameters(uint32_t packet_loss, int64_t rtt) {
   return WEBRTC_VIDEO_CODEC_OK;
 }
@@ -19,6 +19,7 @@
 #include "modules/video_coding/codecs/vp9/include/vp9.h"
 
 #include "media/base/vp9_profile.h"
+#include "modules/video_coding/codecs/vp9/svc_config.h"
 #include "modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
 #include "rtc_base/rate_statistics.h"
 
@@ -51,12 +52,11 @@ class VP9EncoderImpl : public VP9Encoder {
   int SetRateAllocation(const VideoBitrateAllocation& bitrate_allocation,
                         uint32_t frame_rate) override;
 
+  bool SetSpeedSteps(int steps) override;
+
   const char* ImplementationName() const override;
 
  private:
-  // Determine number of encoder threads to use.
-  int NumberOfThreads(int width, int height, int number_of_cores);
-
   // Call encoder initialize function and set control settings.
   int InitAndSetControlSettings(const VideoCodec* inst);
 
@@ -100,6 +100,7 @@ class VP9EncoderImpl : public VP9Encoder {
   bool inited_;
   int64_t timestamp_;
   int cpu_speed_;
+  SvcThreadingConfig threading_config_;
   uint32_t rc_max_intra_target_;
   vpx_codec_ctx_t* encoder_;
   vpx_codec_enc_cfg_t* config_;
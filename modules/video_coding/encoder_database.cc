@@ -12,11 +12,20 @@
 
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/metrics.h"
 
 namespace webrtc {
 
 namespace {
 const size_t kDefaultPayloadSize = 1440;
+
+// How a change of the send codec was applied to the encoder, for UMA.
+enum EncoderReconfiguration {
+  kReconfiguredInPlace = 0,
+  kReinitialized = 1,
+  kReconfigurationMax
+};
 }
 
 VCMEncoderDataBase::VCMEncoderDataBase(
@@ -74,8 +83,11 @@ bool VCMEncoderDataBase::SetSendCodec(const VideoCodec* send_codec,
   if (new_send_codec.startBitrate > new_send_codec.maxBitrate)
     new_send_codec.startBitrate = new_send_codec.maxBitrate;
 
+  bool reconfigure_in_place = false;
   if (!reset_required) {
     reset_required = RequiresEncoderReset(new_send_codec);
+    reconfigure_in_place =
+        reset_required && CanReconfigureInPlace(new_send_codec);
   }
 
   memcpy(&send_codec_, &new_send_codec, sizeof(send_codec_));
@@ -84,7 +96,15 @@ bool VCMEncoderDataBase::SetSendCodec(const VideoCodec* send_codec,
     return true;
   }
 
+  if (reconfigure_in_place && ptr_encoder_->Reconfigure(&send_codec_)) {
+    RTC_HISTOGRAM_ENUMERATION("WebRTC.Video.EncoderReconfiguration",
+                              kReconfiguredInPlace, kReconfigurationMax);
+    return true;
+  }
+
   // If encoder exists, will destroy it and create new one.
+  const bool reinit = ptr_encoder_ != nullptr;
+  const int64_t start_time_us = rtc::TimeMicros();
   DeleteEncoder();
   ptr_encoder_.reset(new VCMGenericEncoder(
       external_encoder_, encoded_frame_callback_, internal_source_));
@@ -97,6 +117,13 @@ bool VCMEncoderDataBase::SetSendCodec(const VideoCodec* send_codec,
   }
 
   pending_encoder_reset_ = false;
+  if (reinit) {
+    RTC_HISTOGRAM_ENUMERATION("WebRTC.Video.EncoderReconfiguration",
+                              kReinitialized, kReconfigurationMax);
+    RTC_HISTOGRAM_COUNTS_1000(
+        "WebRTC.Video.EncoderReinitTimeMs",
+        (rtc::TimeMicros() - start_time_us) / rtc::kNumMicrosecsPerMillisec);
+  }
 
   return true;
 }
@@ -119,7 +146,7 @@ void VCMEncoderDataBase::RegisterExternalEncoder(VideoEncoder* external_encoder,
 }
 
 bool VCMEncoderDataBase::RequiresEncoderReset(
-    const VideoCodec& new_send_codec) {
+    const VideoCodec& new_send_codec) const {
   if (!ptr_encoder_)
     return true;
 
@@ -138,19 +165,19 @@ bool VCMEncoderDataBase::RequiresEncoderReset(
 
   switch (new_send_codec.codecType) {
     case kVideoCodecVP8:
-      if (new_send_codec.VP8() != *send_codec_.VP8()) {
+      if (new_send_codec.VP8() != send_codec_.VP8()) {
         return true;
       }
       break;
 
     case kVideoCodecVP9:
-      if (new_send_codec.VP9() != *send_codec_.VP9()) {
+      if (new_send_codec.VP9() != send_codec_.VP9()) {
         return true;
       }
       break;
 
     case kVideoCodecH264:
-      if (new_send_codec.H264() != *send_codec_.H264()) {
+      if (new_send_codec.H264() != send_codec_.H264()) {
         return true;
       }
       break;
@@ -173,6 +200,28 @@ bool VCMEncoderDataBase::RequiresEncoderReset(
   return false;
 }
 
+bool VCMEncoderDataBase::CanReconfigureInPlace(
+    const VideoCodec& new_send_codec) const {
+  if (new_send_codec.numberOfSimulcastStreams > 1)
+    return false;
+  // Check the other settings with the resolution and bitrate limits of the
+  // current ones.
+  VideoCodec codec = new_send_codec;
+  codec.width = send_codec_.width;
+  codec.height = send_codec_.height;
+  codec.maxBitrate = send_codec_.maxBitrate;
+  codec.minBitrate = send_codec_.minBitrate;
+  if (codec.numberOfSimulcastStreams == 1) {
+    SimulcastStream& stream = codec.simulcastStream[0];
+    stream.width = send_codec_.simulcastStream[0].width;
+    stream.height = send_codec_.simulcastStream[0].height;
+    stream.maxBitrate = send_codec_.simulcastStream[0].maxBitrate;
+    stream.targetBitrate = send_codec_.simulcastStream[0].targetBitrate;
+    stream.minBitrate = send_codec_.simulcastStream[0].minBitrate;
+  }
+  return !RequiresEncoderReset(codec);
+}
+
 VCMGenericEncoder* VCMEncoderDataBase::GetEncoder() {
   return ptr_encoder_.get();
 }
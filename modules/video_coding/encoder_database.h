@@ -46,7 +46,12 @@ class VCMEncoderDataBase {
  private:
   // Determines whether a new codec has to be created or not.
   // Checks every setting apart from maxFramerate and startBitrate.
-  bool RequiresEncoderReset(const VideoCodec& send_codec);
+  bool RequiresEncoderReset(const VideoCodec& send_codec) const;
+
+  // Determines whether |send_codec| differs only in what the encoder may be
+  // able to apply with VideoEncoder::Reconfigure(): the resolution and bitrate
+  // limits of a single stream.
+  bool CanReconfigureInPlace(const VideoCodec& send_codec) const;
 
   void DeleteEncoder();
 
@@ -57,6 +57,7 @@ FrameBuffer::FrameBuffer(Clock* clock,
       num_frames_buffered_(0),
       stopped_(false),
       protection_mode_(kProtectionNack),
+      decode_immediately_(false),
       stats_callback_(stats_callback),
       last_log_non_decoded_ms_(-kLogNonDecodedIntervalMs) {}
 
@@ -80,56 +81,7 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
       if (stopped_)
         return kStopped;
 
-      wait_ms = max_wait_time_ms;
-
-      // Need to hold |crit_| in order to use |frames_|, therefore we
-      // set it here in the loop instead of outside the loop in order to not
-      // acquire the lock unnecesserily.
-      next_frame_it_ = frames_.end();
-
-      // |frame_it| points to the first frame after the
-      // |last_decoded_frame_it_|.
-      auto frame_it = frames_.end();
-      if (last_decoded_frame_it_ == frames_.end()) {
-        frame_it = frames_.begin();
-      } else {
-        frame_it = last_decoded_frame_it_;
-        ++frame_it;
-      }
-
-      // |continuous_end_it| points to the first frame after the
-      // |last_continuous_frame_it_|.
-      auto continuous_end_it = last_continuous_frame_it_;
-      if (continuous_end_it != frames_.end())
-        ++continuous_end_it;
-
-      for (; frame_it != continuous_end_it && frame_it != frames_.end();
-           ++frame_it) {
-        if (!frame_it->second.continuous ||
-            frame_it->second.num_missing_decodable > 0) {
-          continue;
-        }
-
-        EncodedFrame* frame = frame_it->second.frame.get();
-
-        if (keyframe_required && !frame->is_keyframe())
-          continue;
-
-        next_frame_it_ = frame_it;
-        if (frame->RenderTime() == -1)
-          frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-        wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
-
-        // This will cause the frame buffer to prefer high framerate rather
-        // than high resolution in the case of the decoder not decoding fast
-        // enough and the stream has multiple spatial and temporal layers.
-        // For multiple temporal layers it may cause non-base layer frames to be
-        // skipped if they are late.
-        if (wait_ms < -kMaxAllowedFrameDelayMs)
-          continue;
-
-        break;
-      }
+      wait_ms = FindNextFrame(max_wait_time_ms, now_ms, keyframe_required);
     }  // rtc::Critscope lock(&crit_);
 
     wait_ms = std::min<int64_t>(wait_ms, latest_return_time_ms - now_ms);
@@ -140,66 +92,7 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
     rtc::CritScope lock(&crit_);
     now_ms = clock_->TimeInMilliseconds();
     if (next_frame_it_ != frames_.end()) {
-      std::unique_ptr<EncodedFrame> frame =
-          std::move(next_frame_it_->second.frame);
-
-      if (!frame->delayed_by_retransmission()) {
-        int64_t frame_delay;
-
-        if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
-                                              frame->ReceivedTime())) {
-          jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
-        }
-
-        float rtt_mult = protection_mode_ == kProtectionNackFEC ? 0.0 : 1.0;
-        timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
-        timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
-      } else {
-        if (webrtc::field_trial::IsEnabled("WebRTC-AddRttToPlayoutDelay"))
-          jitter_estimator_->FrameNacked();
-      }
-
-      // Gracefully handle bad RTP timestamps and render time issues.
-      if (HasBadRenderTiming(*frame, now_ms)) {
-        jitter_estimator_->Reset();
-        timing_->Reset();
-        frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-      }
-
-      UpdateJitterDelay();
-      UpdateTimingFrameInfo();
-      PropagateDecodability(next_frame_it_->second);
-
-      // Sanity check for RTP timestamp monotonicity.
-      if (last_decoded_frame_it_ != frames_.end()) {
-        const VideoLayerFrameId& last_decoded_frame_key =
-            last_decoded_frame_it_->first;
-        const VideoLayerFrameId& frame_key = next_frame_it_->first;
-
-        const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
-            last_decoded_frame_timestamp_ == frame->timestamp &&
-            last_decoded_frame_key.picture_id == frame_key.picture_id &&
-            last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
-
-        if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
-            !frame_is_higher_spatial_layer_of_last_decoded_frame) {
-          // TODO(brandtr): Consider clearing the entire buffer when we hit
-          // these conditions.
-          RTC_LOG(LS_WARNING)
-              << "Frame with (timestamp:picture_id:spatial_id) ("
-              << frame->timestamp << ":" << frame->id.picture_id << ":"
-              << static_cast<int>(frame->id.spatial_layer) << ")"
-              << " sent to decoder after frame with"
-              << " (timestamp:picture_id:spatial_id) ("
-              << last_decoded_frame_timestamp_ << ":"
-              << last_decoded_frame_key.picture_id << ":"
-              << static_cast<int>(last_decoded_frame_key.spatial_layer) << ").";
-        }
-      }
-
-      AdvanceLastDecodedFrame(next_frame_it_);
-      last_decoded_frame_timestamp_ = frame->timestamp;
-      *frame_out = std::move(frame);
+      *frame_out = GetNextFrame(now_ms);
       return kFrameFound;
     }
   }
@@ -215,6 +108,139 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
   return kTimeout;
 }
 
+FrameBuffer::ReturnReason FrameBuffer::PollNextFrame(
+    int64_t max_wait_time_ms,
+    std::unique_ptr<EncodedFrame>* frame_out,
+    int64_t* wait_ms_out,
+    bool keyframe_required) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::PollNextFrame");
+  rtc::CritScope lock(&crit_);
+  if (stopped_)
+    return kStopped;
+
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  int64_t wait_ms = std::min<int64_t>(
+      FindNextFrame(max_wait_time_ms, now_ms, keyframe_required),
+      max_wait_time_ms);
+  // Return what NextFrame would return after waiting for |wait_ms|.
+  if (wait_ms <= 0 && next_frame_it_ != frames_.end()) {
+    *frame_out = GetNextFrame(now_ms);
+    return kFrameFound;
+  }
+  *wait_ms_out = std::max<int64_t>(wait_ms, 0);
+  return kTimeout;
+}
+
+int64_t FrameBuffer::FindNextFrame(int64_t max_wait_time_ms,
+                                   int64_t now_ms,
+                                   bool keyframe_required) {
+  int64_t wait_ms = max_wait_time_ms;
+
+  next_frame_it_ = frames_.end();
+
+  // Every frame in |decodable_frames_| comes after |last_decoded_frame_it_|
+  // and at or before |last_continuous_frame_it_|, so there is no need to look
+  // at the frames that are still missing references.
+  for (FrameMap::iterator frame_it : decodable_frames_) {
+    RTC_DCHECK(frame_it->second.continuous);
+    RTC_DCHECK_EQ(frame_it->second.num_missing_decodable, 0U);
+
+    EncodedFrame* frame = frame_it->second.frame.get();
+
+    if (keyframe_required && !frame->is_keyframe())
+      continue;
+
+    next_frame_it_ = frame_it;
+    if (decode_immediately_) {
+      // Without rendering there is nothing to wait for, render time is now.
+      if (frame->RenderTime() == -1)
+        frame->SetRenderTime(now_ms);
+      wait_ms = 0;
+      break;
+    }
+
+    if (frame->RenderTime() == -1)
+      frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+    wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
+
+    // This will cause the frame buffer to prefer high framerate rather
+    // than high resolution in the case of the decoder not decoding fast
+    // enough and the stream has multiple spatial and temporal layers.
+    // For multiple temporal layers it may cause non-base layer frames to be
+    // skipped if they are late.
+    if (wait_ms < -kMaxAllowedFrameDelayMs)
+      continue;
+
+    break;
+  }
+  return wait_ms;
+}
+
+std::unique_ptr<EncodedFrame> FrameBuffer::GetNextFrame(int64_t now_ms) {
+  RTC_DCHECK(next_frame_it_ != frames_.end());
+  std::unique_ptr<EncodedFrame> frame =
+      std::move(next_frame_it_->second.frame);
+
+  if (!frame->delayed_by_retransmission()) {
+    int64_t frame_delay;
+
+    if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
+                                          frame->ReceivedTime())) {
+      jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
+    }
+
+    float rtt_mult = protection_mode_ == kProtectionNackFEC ? 0.0 : 1.0;
+    timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
+    timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
+  } else {
+    if (webrtc::field_trial::IsEnabled("WebRTC-AddRttToPlayoutDelay"))
+      jitter_estimator_->FrameNacked();
+  }
+
+  // Gracefully handle bad RTP timestamps and render time issues.
+  if (HasBadRenderTiming(*frame, now_ms)) {
+    jitter_estimator_->Reset();
+    timing_->Reset();
+    frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+  }
+
+  UpdateJitterDelay();
+  UpdateTimingFrameInfo();
+  decodable_frames_.erase(next_frame_it_);
+  PropagateDecodability(next_frame_it_->second);
+
+  // Sanity check for RTP timestamp monotonicity.
+  if (last_decoded_frame_it_ != frames_.end()) {
+    const VideoLayerFrameId& last_decoded_frame_key =
+        last_decoded_frame_it_->first;
+    const VideoLayerFrameId& frame_key = next_frame_it_->first;
+
+    const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
+        last_decoded_frame_timestamp_ == frame->timestamp &&
+        last_decoded_frame_key.picture_id == frame_key.picture_id &&
+        last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
+
+    if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
+        !frame_is_higher_spatial_layer_of_last_decoded_frame) {
+      // TODO(brandtr): Consider clearing the entire buffer when we hit
+      // these conditions.
+      RTC_LOG(LS_WARNING)
+          << "Frame with (timestamp:picture_id:spatial_id) ("
+          << frame->timestamp << ":" << frame->id.picture_id << ":"
+          << static_cast<int>(frame->id.spatial_layer) << ")"
+          << " sent to decoder after frame with"
+          << " (timestamp:picture_id:spatial_id) ("
+          << last_decoded_frame_timestamp_ << ":"
+          << last_decoded_frame_key.picture_id << ":"
+          << static_cast<int>(last_decoded_frame_key.spatial_layer) << ").";
+    }
+  }
+
+  AdvanceLastDecodedFrame(next_frame_it_);
+  last_decoded_frame_timestamp_ = frame->timestamp;
+  return frame;
+}
+
 bool FrameBuffer::HasBadRenderTiming(const EncodedFrame& frame,
                                      int64_t now_ms) {
   // Assume that render timing errors are due to changes in the video stream.
@@ -249,6 +275,12 @@ void FrameBuffer::SetProtectionMode(VCMVideoProtection mode) {
   protection_mode_ = mode;
 }
 
+void FrameBuffer::SetDecodeImmediately(bool decode_immediately) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::SetDecodeImmediately");
+  rtc::CritScope lock(&crit_);
+  decode_immediately_ = decode_immediately;
+}
+
 void FrameBuffer::Start() {
   TRACE_EVENT0("webrtc", "FrameBuffer::Start");
   rtc::CritScope lock(&crit_);
@@ -267,6 +299,18 @@ void FrameBuffer::UpdateRtt(int64_t rtt_ms) {
   jitter_estimator_->UpdateRtt(rtt_ms);
 }
 
+VCMJitterEstimator::State FrameBuffer::GetJitterEstimatorState() {
+  rtc::CritScope lock(&crit_);
+  return jitter_estimator_->GetState();
+}
+
+void FrameBuffer::SetJitterEstimatorState(
+    const VCMJitterEstimator::State& state) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::SetJitterEstimatorState");
+  rtc::CritScope lock(&crit_);
+  jitter_estimator_->SetState(state);
+}
+
 bool FrameBuffer::ValidReferences(const EncodedFrame& frame) const {
   if (frame.id.picture_id < 0)
     return false;
@@ -425,6 +469,7 @@ void FrameBuffer::PropagateContinuity(FrameMap::iterator start) {
 
     if (last_continuous_frame_it_->first < frame->first)
       last_continuous_frame_it_ = frame;
+    MaybeAddDecodableFrame(frame);
 
     // Loop through all dependent frames, and if that frame no longer has
     // any unfulfilled dependencies then that frame is continuous as well.
@@ -454,10 +499,18 @@ void FrameBuffer::PropagateDecodability(const FrameInfo& info) {
     if (ref_info != frames_.end()) {
       RTC_DCHECK_GT(ref_info->second.num_missing_decodable, 0U);
       --ref_info->second.num_missing_decodable;
+      MaybeAddDecodableFrame(ref_info);
     }
   }
 }
 
+void FrameBuffer::MaybeAddDecodableFrame(FrameMap::iterator frame) {
+  if (frame->second.frame && frame->second.continuous &&
+      frame->second.num_missing_decodable == 0) {
+    decodable_frames_.insert(frame);
+  }
+}
+
 void FrameBuffer::AdvanceLastDecodedFrame(FrameMap::iterator decoded) {
   TRACE_EVENT0("webrtc", "FrameBuffer::AdvanceLastDecodedFrame");
   if (last_decoded_frame_it_ == frames_.end()) {
@@ -473,11 +526,13 @@ void FrameBuffer::AdvanceLastDecodedFrame(FrameMap::iterator decoded) {
   while (last_decoded_frame_it_ != decoded) {
     if (last_decoded_frame_it_->second.frame)
       --num_frames_buffered_;
+    decodable_frames_.erase(last_decoded_frame_it_);
     last_decoded_frame_it_ = frames_.erase(last_decoded_frame_it_);
   }
 
   // Then remove old history if we have too much history saved.
   if (num_frames_history_ > kMaxFramesHistory) {
+    decodable_frames_.erase(frames_.begin());
     frames_.erase(frames_.begin());
     --num_frames_history_;
   }
@@ -607,6 +662,7 @@ void FrameBuffer::UpdateTimingFrameInfo() {
 void FrameBuffer::ClearFramesAndHistory() {
   TRACE_EVENT0("webrtc", "FrameBuffer::ClearFramesAndHistory");
   frames_.clear();
+  decodable_frames_.clear();
   last_decoded_frame_it_ = frames_.end();
   last_continuous_frame_it_ = frames_.end();
   next_frame_it_ = frames_.end();
@@ -14,11 +14,13 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <set>
 #include <utility>
 
 #include "api/video/encoded_frame.h"
 #include "modules/video_coding/include/video_coding_defines.h"
 #include "modules/video_coding/inter_frame_delay.h"
+#include "modules/video_coding/jitter_estimator.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
@@ -29,7 +31,6 @@ namespace webrtc {
 
 class Clock;
 class VCMReceiveStatisticsCallback;
-class VCMJitterEstimator;
 class VCMTiming;
 
 namespace video_coding {
@@ -61,12 +62,30 @@ class FrameBuffer {
                          std::unique_ptr<EncodedFrame>* frame_out,
                          bool keyframe_required = false);
 
+  // Non-blocking version of NextFrame, for callers that schedule the decoding
+  // of many streams themselves. Returns what NextFrame would return after
+  // waiting for |max_wait_time_ms| or until the next frame is due, whichever
+  // comes first.
+  //  - If that is a frame it returns kFrameFound and sets |frame_out|.
+  //  - Otherwise it returns kTimeout and sets |wait_ms_out| to the time left
+  //    to wait, which is zero once |max_wait_time_ms| has passed.
+  //  - If the FrameBuffer is stopped then it will return kStopped.
+  ReturnReason PollNextFrame(int64_t max_wait_time_ms,
+                             std::unique_ptr<EncodedFrame>* frame_out,
+                             int64_t* wait_ms_out,
+                             bool keyframe_required = false);
+
   // Tells the FrameBuffer which protection mode that is in use. Affects
   // the frame timing.
   // TODO(philipel): Remove this when new timing calculations has been
   //                 implemented.
   void SetProtectionMode(VCMVideoProtection mode);
 
+  // If set, frames are returned as soon as they are decodable, in decoding
+  // order, instead of when they are due according to the VCMTiming. Late
+  // frames are not skipped.
+  void SetDecodeImmediately(bool decode_immediately);
+
   // Start the frame buffer, has no effect if the frame buffer is started.
   // The frame buffer is started upon construction.
   void Start();
@@ -78,6 +97,11 @@ class FrameBuffer {
   // Updates the RTT for jitter buffer estimation.
   void UpdateRtt(int64_t rtt_ms);
 
+  // Gets and sets the state of the jitter estimator, which is updated as
+  // frames are returned.
+  VCMJitterEstimator::State GetJitterEstimatorState();
+  void SetJitterEstimatorState(const VCMJitterEstimator::State& state);
+
  private:
   struct FrameInfo {
     FrameInfo();
@@ -114,6 +138,30 @@ class FrameBuffer {
 
   using FrameMap = std::map<VideoLayerFrameId, FrameInfo>;
 
+  struct FrameMapIteratorCompare {
+    bool operator()(const FrameMap::iterator& a,
+                    const FrameMap::iterator& b) const {
+      return a->first < b->first;
+    }
+  };
+
+  // Frames that are continuous, decodable and not yet handed off for
+  // decoding, in decoding order.
+  using DecodableFrames = std::set<FrameMap::iterator, FrameMapIteratorCompare>;
+
+  // Sets |next_frame_it_| to the next frame to decode, if any, and returns
+  // how long to wait before decoding it, or |max_wait_time_ms| if there is no
+  // frame to decode.
+  int64_t FindNextFrame(int64_t max_wait_time_ms,
+                        int64_t now_ms,
+                        bool keyframe_required)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Removes the frame at |next_frame_it_| from the buffer and updates the
+  // timing and decodability state as it is sent to the decoder.
+  std::unique_ptr<EncodedFrame> GetNextFrame(int64_t now_ms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Check that the references of |frame| are valid.
   bool ValidReferences(const EncodedFrame& frame) const;
 
@@ -131,6 +179,11 @@ class FrameBuffer {
   void PropagateDecodability(const FrameInfo& info)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Adds |frame| to |decodable_frames_| if it has been inserted and is both
+  // continuous and decodable.
+  void MaybeAddDecodableFrame(FrameMap::iterator frame)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Advances |last_decoded_frame_it_| to |decoded| and removes old
   // frame info.
   void AdvanceLastDecodedFrame(FrameMap::iterator decoded)
@@ -153,6 +206,9 @@ class FrameBuffer {
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   FrameMap frames_ RTC_GUARDED_BY(crit_);
+  // Lets FindNextFrame only look at the frames it may return, instead of all
+  // frames after |last_decoded_frame_it_|.
+  DecodableFrames decodable_frames_ RTC_GUARDED_BY(crit_);
 
   rtc::CriticalSection crit_;
   Clock* const clock_;
@@ -168,6 +224,7 @@ class FrameBuffer {
   int num_frames_buffered_ RTC_GUARDED_BY(crit_);
   bool stopped_ RTC_GUARDED_BY(crit_);
   VCMVideoProtection protection_mode_ RTC_GUARDED_BY(crit_);
+  bool decode_immediately_ RTC_GUARDED_BY(crit_);
   VCMReceiveStatisticsCallback* const stats_callback_;
   int64_t last_log_non_decoded_ms_ RTC_GUARDED_BY(crit_);
 
@@ -293,6 +293,49 @@ TEST_F(TestFrameBuffer2, ZeroPlayoutDelay) {
   EXPECT_EQ(0, frames_[0]->RenderTimeMs());
 }
 
+TEST_F(TestFrameBuffer2, PollNextFrame) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+  std::unique_ptr<EncodedFrame> frame;
+  int64_t wait_ms = -1;
+
+  EXPECT_EQ(FrameBuffer::ReturnReason::kTimeout,
+            buffer_->PollNextFrame(100, &frame, &wait_ms));
+  EXPECT_EQ(100, wait_ms);
+
+  // The frame is due when it has to be sent to the decoder to be rendered in
+  // time, 25 ms from now with the fake timing.
+  InsertFrame(pid, 0, ts, false);
+  EXPECT_EQ(FrameBuffer::ReturnReason::kTimeout,
+            buffer_->PollNextFrame(100, &frame, &wait_ms));
+  EXPECT_EQ(25, wait_ms);
+  EXPECT_FALSE(frame);
+  clock_.AdvanceTimeMilliseconds(25);
+  EXPECT_EQ(FrameBuffer::ReturnReason::kFrameFound,
+            buffer_->PollNextFrame(100, &frame, &wait_ms));
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(pid, frame->id.picture_id);
+
+  // Like NextFrame, a frame that isn't due yet is returned once the max wait
+  // time has passed.
+  frame.reset();
+  uint16_t next_pid = pid + 1;
+  InsertFrame(next_pid, 0, ts + 90 * 100, false, pid);
+  EXPECT_EQ(FrameBuffer::ReturnReason::kFrameFound,
+            buffer_->PollNextFrame(0, &frame, &wait_ms));
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(next_pid, frame->id.picture_id);
+
+  frame.reset();
+  EXPECT_EQ(FrameBuffer::ReturnReason::kTimeout,
+            buffer_->PollNextFrame(0, &frame, &wait_ms));
+  EXPECT_EQ(0, wait_ms);
+
+  buffer_->Stop();
+  EXPECT_EQ(FrameBuffer::ReturnReason::kStopped,
+            buffer_->PollNextFrame(100, &frame, &wait_ms));
+}
+
 // Flaky test, see bugs.webrtc.org/7068.
 TEST_F(TestFrameBuffer2, DISABLED_OneUnorderedSuperFrame) {
   uint16_t pid = Rand();
@@ -348,6 +391,30 @@ TEST_F(TestFrameBuffer2, MissingFrame) {
   CheckNoFrame(2);
 }
 
+TEST_F(TestFrameBuffer2, DecodesFramesAsTheirReferencesAreDecoded) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+
+  InsertFrame(pid, 0, ts, false);
+  InsertFrame(pid + 1, 0, ts + kFps10, false, pid);
+  InsertFrame(pid + 2, 0, ts + 2 * kFps10, false, pid + 1);
+  InsertFrame(pid + 4, 0, ts + 4 * kFps10, false, pid + 3);
+  InsertFrame(pid + 5, 0, ts + 5 * kFps10, false);
+  for (int i = 0; i < 5; ++i)
+    ExtractFrame();
+
+  CheckFrame(0, pid, 0);
+  CheckFrame(1, pid + 1, 0);
+  CheckFrame(2, pid + 2, 0);
+  CheckFrame(3, pid + 5, 0);
+  CheckNoFrame(4);
+
+  // |pid + 3| and |pid + 4| were skipped over when |pid + 5| was decoded.
+  InsertFrame(pid + 3, 0, ts + 3 * kFps10, false, pid + 2);
+  ExtractFrame();
+  CheckNoFrame(5);
+}
+
 TEST_F(TestFrameBuffer2, OneLayerStream) {
   uint16_t pid = Rand();
   uint32_t ts = Rand();
@@ -392,6 +459,30 @@ TEST_F(TestFrameBuffer2, DropTemporalLayerSlowDecoder) {
   CheckNoFrame(9);
 }
 
+TEST_F(TestFrameBuffer2, DecodeImmediatelyReturnsAllFramesInOrder) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+
+  buffer_->SetDecodeImmediately(true);
+  InsertFrame(pid, 0, ts, false);
+  InsertFrame(pid + 1, 0, ts + kFps20, false, pid);
+  for (int i = 2; i < 10; i += 2) {
+    uint32_t ts_tl0 = ts + i / 2 * kFps10;
+    InsertFrame(pid + i, 0, ts_tl0, false, pid + i - 2);
+    InsertFrame(pid + i + 1, 0, ts_tl0 + kFps20, false, pid + i, pid + i - 1);
+  }
+
+  // Frames are neither held until they are due nor dropped for being late.
+  ExtractFrame();
+  CheckFrame(0, pid, 0);
+  EXPECT_EQ(clock_.TimeInMilliseconds(), frames_[0]->RenderTimeMs());
+  for (int i = 1; i < 10; ++i) {
+    clock_.AdvanceTimeMilliseconds(70);
+    ExtractFrame();
+    CheckFrame(i, pid + i, 0);
+  }
+}
+
 TEST_F(TestFrameBuffer2, DropSpatialLayerSlowDecoder) {
   uint16_t pid = Rand();
   uint32_t ts = Rand();
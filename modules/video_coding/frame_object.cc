@@ -10,6 +10,7 @@
 
 #include "modules/video_coding/frame_object.h"
 
+#include "api/video/video_memory_accountant.h"
 #include "common_video/h264/h264_common.h"
 #include "modules/video_coding/packet_buffer.h"
 #include "rtc_base/checks.h"
@@ -55,13 +56,15 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
   // NOTE! EncodedImage::_size is the size of the buffer (think capacity of
   //       an std::vector) and EncodedImage::_length is the actual size of
   //       the bitstream (think size of an std::vector).
+  size_t buffer_size = frame_size;
   if (codec_type_ == kVideoCodecH264)
-    _size = frame_size + EncodedImage::kBufferPaddingBytesH264;
-  else
-    _size = frame_size;
+    buffer_size += EncodedImage::kBufferPaddingBytesH264;
 
-  _buffer = new uint8_t[_size];
+  // The buffer may be a reused one larger than |buffer_size|, in which case
+  // |_size| is its actual size.
+  _buffer = packet_buffer_->GetBitstreamBuffer(buffer_size, &_size);
   _length = frame_size;
+  VideoMemoryAccountant::OnAllocated(_size);
 
   bool bitstream_copied = GetBitstream(_buffer);
   RTC_DCHECK(bitstream_copied);
@@ -114,6 +117,13 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
 
 RtpFrameObject::~RtpFrameObject() {
   packet_buffer_->ReturnFrame(this);
+  VideoMemoryAccountant::OnReleased(_size);
+  // Hand the bitstream buffer back for reuse rather than have
+  // VCMEncodedFrame delete it.
+  packet_buffer_->ReturnBitstreamBuffer(_buffer, _size);
+  _buffer = nullptr;
+  _size = 0;
+  _length = 0;
 }
 
 uint16_t RtpFrameObject::first_seq_num() const {
@@ -82,6 +82,17 @@ int32_t VCMGenericEncoder::InitEncode(const VideoCodec* settings,
   return 0;
 }
 
+bool VCMGenericEncoder::Reconfigure(const VideoCodec* settings) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  TRACE_EVENT0("webrtc", "VCMGenericEncoder::Reconfigure");
+  if (!encoder_->Reconfigure(*settings))
+    return false;
+  vcm_encoded_frame_callback_->SetTimingFramesThresholds(
+      settings->timing_frame_thresholds);
+  vcm_encoded_frame_callback_->OnFrameRateChanged(settings->maxFramerate);
+  return true;
+}
+
 int32_t VCMGenericEncoder::Encode(const VideoFrame& frame,
                                   const CodecSpecificInfo* codec_specific,
                                   const std::vector<FrameType>& frame_types) {
@@ -169,6 +180,11 @@ bool VCMGenericEncoder::SupportsNativeHandle() const {
   return encoder_->SupportsNativeHandle();
 }
 
+bool VCMGenericEncoder::SupportsNV12() const {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  return encoder_->SupportsNV12();
+}
+
 VCMEncodedFrameCallback::VCMEncodedFrameCallback(
     EncodedImageCallback* post_encode_callback,
     media_optimization::MediaOptimization* media_opt)
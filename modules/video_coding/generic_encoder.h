@@ -137,6 +137,8 @@ class VCMGenericEncoder {
   int32_t InitEncode(const VideoCodec* settings,
                      int32_t number_of_cores,
                      size_t max_payload_size);
+  // Returns false if |settings| require InitEncode().
+  bool Reconfigure(const VideoCodec* settings);
   int32_t Encode(const VideoFrame& frame,
                  const CodecSpecificInfo* codec_specific,
                  const std::vector<FrameType>& frame_types);
@@ -147,6 +149,7 @@ class VCMGenericEncoder {
   int32_t RequestFrame(const std::vector<FrameType>& frame_types);
   bool InternalSource() const;
   bool SupportsNativeHandle() const;
+  bool SupportsNV12() const;
 
  private:
   rtc::RaceChecker race_checker_;
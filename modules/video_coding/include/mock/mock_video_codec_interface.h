@@ -47,6 +47,7 @@ class MockVideoEncoder : public VideoEncoder {
   MOCK_METHOD2(SetRateAllocation,
                int32_t(const VideoBitrateAllocation& newBitRate,
                        uint32_t frameRate));
+  MOCK_METHOD1(Reconfigure, bool(const VideoCodec& codecSettings));
 };
 
 class MockDecodedImageCallback : public DecodedImageCallback {
@@ -12,8 +12,10 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <cmath>
 #include <string>
 
 #include "modules/video_coding/internal_defines.h"
@@ -113,6 +115,74 @@ void VCMJitterEstimator::ResetNackCount() {
   _nackCount = 0;
 }
 
+std::string VCMJitterEstimator::State::ToString() const {
+  char buf[512];
+  snprintf(buf, sizeof(buf),
+           "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g",
+           theta[0], theta[1], theta_cov[0][0], theta_cov[0][1],
+           theta_cov[1][0], theta_cov[1][1], var_noise, avg_noise,
+           avg_frame_size, var_frame_size, max_frame_size);
+  return buf;
+}
+
+absl::optional<VCMJitterEstimator::State> VCMJitterEstimator::State::Parse(
+    const std::string& str) {
+  State state;
+  char trailing;
+  if (sscanf(str.c_str(), "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf%c",
+             &state.theta[0], &state.theta[1], &state.theta_cov[0][0],
+             &state.theta_cov[0][1], &state.theta_cov[1][0],
+             &state.theta_cov[1][1], &state.var_noise, &state.avg_noise,
+             &state.avg_frame_size, &state.var_frame_size,
+             &state.max_frame_size, &trailing) != 11) {
+    return absl::nullopt;
+  }
+  const double values[] = {state.theta[0],        state.theta[1],
+                           state.theta_cov[0][0], state.theta_cov[0][1],
+                           state.theta_cov[1][0], state.theta_cov[1][1],
+                           state.var_noise,       state.avg_noise,
+                           state.avg_frame_size,  state.var_frame_size,
+                           state.max_frame_size};
+  for (double value : values) {
+    if (!std::isfinite(value))
+      return absl::nullopt;
+  }
+  if (state.var_noise <= 0 || state.var_frame_size <= 0 ||
+      state.avg_frame_size <= 0 || state.max_frame_size <= 0) {
+    return absl::nullopt;
+  }
+  return state;
+}
+
+VCMJitterEstimator::State VCMJitterEstimator::GetState() const {
+  State state;
+  memcpy(state.theta, _theta, sizeof(state.theta));
+  memcpy(state.theta_cov, _thetaCov, sizeof(state.theta_cov));
+  state.var_noise = _varNoise;
+  state.avg_noise = _avgNoise;
+  state.avg_frame_size = _avgFrameSize;
+  state.var_frame_size = _varFrameSize;
+  state.max_frame_size = _maxFrameSize;
+  return state;
+}
+
+void VCMJitterEstimator::SetState(const State& state) {
+  Reset();
+  memcpy(_theta, state.theta, sizeof(_theta));
+  memcpy(_thetaCov, state.theta_cov, sizeof(_thetaCov));
+  _varNoise = state.var_noise;
+  _avgNoise = state.avg_noise;
+  _avgFrameSize = state.avg_frame_size;
+  _varFrameSize = state.var_frame_size;
+  _maxFrameSize = state.max_frame_size;
+  // Skip the startup phase, the frame size average and the noise estimate
+  // would otherwise be replaced by the first few samples.
+  _fsCount = kFsAccuStartupSamples + 1;
+  _alphaCount = kStartupDelaySamples;
+  _startupCount = kStartupDelaySamples;
+  PostProcessEstimate();
+}
+
 // Updates the estimates with the new measurements
 void VCMJitterEstimator::UpdateEstimate(int64_t frameDelayMS,
                                         uint32_t frameSizeBytes,
@@ -11,6 +11,9 @@
 #ifndef MODULES_VIDEO_CODING_JITTER_ESTIMATOR_H_
 #define MODULES_VIDEO_CODING_JITTER_ESTIMATOR_H_
 
+#include <string>
+
+#include "absl/types/optional.h"
 #include "modules/video_coding/rtt_filter.h"
 #include "rtc_base/rollingaccumulator.h"
 
@@ -20,6 +23,24 @@ class Clock;
 
 class VCMJitterEstimator {
  public:
+  // The adaptive part of the estimate. Can be saved at the end of a stream so
+  // that later streams, e.g. on the same type of network, start from it
+  // instead of from the initial state.
+  struct State {
+    double theta[2];
+    double theta_cov[2][2];
+    double var_noise;
+    double avg_noise;
+    double avg_frame_size;
+    double var_frame_size;
+    double max_frame_size;
+
+    // Serializes the state to a string, to be persisted by the application,
+    // and parses it back. Returns nullopt for malformed strings.
+    std::string ToString() const;
+    static absl::optional<State> Parse(const std::string& str);
+  };
+
   VCMJitterEstimator(const Clock* clock,
                      int32_t vcmId = 0,
                      int32_t receiverId = 0);
@@ -30,6 +51,11 @@ class VCMJitterEstimator {
   void Reset();
   void ResetNackCount();
 
+  State GetState() const;
+  // Resets the estimate and continues from |state|, which is weighted as if
+  // the estimator had already been through its startup phase.
+  void SetState(const State& state);
+
   // Updates the jitter estimate with the new data.
   //
   // Input:
@@ -9,6 +9,8 @@
 
 #include "modules/video_coding/jitter_estimator.h"
 
+#include <stdlib.h>
+
 #include "system_wrappers/include/clock.h"
 #include "test/gtest.h"
 
@@ -158,4 +160,56 @@ TEST_F(TestVCMJitterEstimator, TestConvergence) {
   EXPECT_NE(low_rate_iterations, 0);
   EXPECT_LE(low_rate_iterations, regular_iterations);
 }
+
+TEST_F(TestVCMJitterEstimator, StateSurvivesSerialization) {
+  ValueGenerator gen(50);
+  for (int i = 0; i < 100; ++i) {
+    regular_estimator_.UpdateEstimate(gen.Delay(), gen.FrameSize());
+    regular_estimator_.AdvanceClock(1000000 / 30);
+    gen.Advance();
+  }
+
+  VCMJitterEstimator::State state = regular_estimator_.GetState();
+  absl::optional<VCMJitterEstimator::State> parsed =
+      VCMJitterEstimator::State::Parse(state.ToString());
+  ASSERT_TRUE(parsed);
+  EXPECT_EQ(state.ToString(), parsed->ToString());
+
+  low_rate_estimator_.SetState(*parsed);
+  EXPECT_EQ(state.ToString(), low_rate_estimator_.GetState().ToString());
+}
+
+// A warm started estimator begins with the jitter of the network,
+// instead of converging to it from the initial state.
+TEST_F(TestVCMJitterEstimator, WarmStartUsesSavedEstimate) {
+  ValueGenerator gen(50);
+  uint64_t time_delta = 1000000 / 30;
+  for (int i = 0; i < 300; ++i) {
+    regular_estimator_.UpdateEstimate(gen.Delay(), gen.FrameSize());
+    regular_estimator_.AdvanceClock(time_delta);
+    gen.Advance();
+  }
+  int converged_estimate = regular_estimator_.GetJitterEstimate(0);
+
+  TestEstimator cold_estimator(false);
+  TestEstimator warm_estimator(false);
+  warm_estimator.SetState(regular_estimator_.GetState());
+  ValueGenerator new_gen(50);
+  cold_estimator.UpdateEstimate(new_gen.Delay(), new_gen.FrameSize());
+  warm_estimator.UpdateEstimate(new_gen.Delay(), new_gen.FrameSize());
+  int cold_error =
+      std::abs(cold_estimator.GetJitterEstimate(0) - converged_estimate);
+  int warm_error =
+      std::abs(warm_estimator.GetJitterEstimate(0) - converged_estimate);
+  EXPECT_LT(warm_error, cold_error);
+}
+
+TEST(VCMJitterEstimatorStateTest, RejectsMalformedStates) {
+  EXPECT_FALSE(VCMJitterEstimator::State::Parse(""));
+  EXPECT_FALSE(VCMJitterEstimator::State::Parse("1,2,3"));
+  EXPECT_FALSE(VCMJitterEstimator::State::Parse("1,1,1,0,0,1,4,0,500,1,900x"));
+  EXPECT_FALSE(VCMJitterEstimator::State::Parse("1,1,1,0,0,1,0,0,500,1,900"));
+  EXPECT_FALSE(VCMJitterEstimator::State::Parse("1,1,1,0,0,1,nan,0,500,1,900"));
+  EXPECT_TRUE(VCMJitterEstimator::State::Parse("1,1,1,0,0,1,4,0,500,1,900"));
+}
 }  // namespace webrtc
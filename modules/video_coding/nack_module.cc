@@ -28,8 +28,112 @@ const int kProcessFrequency = 50;
 const int kProcessIntervalMs = 1000 / kProcessFrequency;
 const int kMaxReorderedPackets = 128;
 const int kNumReorderingBuckets = 10;
+// Streams without missing packets have nothing to do in Process, they are
+// woken up by OnReceivedPacket when a packet goes missing.
+const int kIdleProcessIntervalMs = 1000;
 }  // namespace
 
+NackModule::SeqNumBitset::SeqNumBitset() : oldest_(0), newest_(0), size_(0) {
+  words_.fill(0);
+}
+
+bool NackModule::SeqNumBitset::Contains(uint16_t seq_num) const {
+  if (size_ == 0 || AheadOf(oldest_, seq_num) || AheadOf(seq_num, newest_))
+    return false;
+  int index = seq_num % kSeqNumRingSize;
+  return (words_[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+}
+
+void NackModule::SeqNumBitset::Insert(uint16_t seq_num) {
+  if (size_ == 0) {
+    oldest_ = seq_num;
+    newest_ = seq_num;
+  } else if (Contains(seq_num)) {
+    return;
+  } else if (AheadOf(oldest_, seq_num)) {
+    oldest_ = seq_num;
+  } else if (AheadOf(seq_num, newest_)) {
+    newest_ = seq_num;
+  }
+  RTC_DCHECK_LT(ForwardDiff(oldest_, newest_), kSeqNumRingSize);
+  int index = seq_num % kSeqNumRingSize;
+  words_[index / kBitsPerWord] |= uint64_t{1} << (index % kBitsPerWord);
+  ++size_;
+}
+
+bool NackModule::SeqNumBitset::Erase(uint16_t seq_num) {
+  if (!Contains(seq_num))
+    return false;
+  int index = seq_num % kSeqNumRingSize;
+  words_[index / kBitsPerWord] &= ~(uint64_t{1} << (index % kBitsPerWord));
+  --size_;
+  if (size_ > 0 && seq_num == oldest_)
+    oldest_ = *Next(seq_num);
+  return true;
+}
+
+void NackModule::SeqNumBitset::EraseOlderThan(uint16_t seq_num) {
+  if (size_ > 0 && AheadOf(seq_num, newest_)) {
+    Clear();
+    return;
+  }
+  while (size_ > 0 && AheadOf(seq_num, oldest_))
+    Erase(oldest_);
+}
+
+void NackModule::SeqNumBitset::Clear() {
+  words_.fill(0);
+  size_ = 0;
+}
+
+uint16_t NackModule::SeqNumBitset::Oldest() const {
+  RTC_DCHECK_GT(size_, 0);
+  return oldest_;
+}
+
+absl::optional<uint16_t> NackModule::SeqNumBitset::LowerBound(
+    uint16_t seq_num) const {
+  if (size_ == 0 || AheadOf(seq_num, newest_))
+    return absl::nullopt;
+  if (!AheadOf(seq_num, oldest_))
+    return oldest_;
+  if (Contains(seq_num))
+    return seq_num;
+  return Next(seq_num);
+}
+
+absl::optional<uint16_t> NackModule::SeqNumBitset::Next(
+    uint16_t seq_num) const {
+  if (size_ == 0 || !AheadOf(newest_, seq_num))
+    return absl::nullopt;
+  if (AheadOf(oldest_, seq_num))
+    return oldest_;
+
+  // Scan the candidates (|seq_num|, |newest_|] a word at a time.
+  uint16_t candidate = seq_num + 1;
+  int remaining = ForwardDiff(seq_num, newest_);
+  while (remaining > 0) {
+    int index = candidate % kSeqNumRingSize;
+    int bit = index % kBitsPerWord;
+    uint64_t bits = words_[index / kBitsPerWord] >> bit;
+    if (bits == 0) {
+      int skipped = kBitsPerWord - bit;
+      candidate += skipped;
+      remaining -= skipped;
+      continue;
+    }
+    int offset = 0;
+    while ((bits & 1) == 0) {
+      bits >>= 1;
+      ++offset;
+    }
+    if (offset >= remaining)
+      return absl::nullopt;
+    return static_cast<uint16_t>(candidate + offset);
+  }
+  return absl::nullopt;
+}
+
 NackModule::NackInfo::NackInfo()
     : seq_num(0), send_at_seq_num(0), sent_at_time(-1), retries(0) {}
 
@@ -49,14 +153,35 @@ NackModule::NackModule(Clock* clock,
       initialized_(false),
       rtt_ms_(kDefaultRttMs),
       newest_seq_num_(0),
+      process_thread_(nullptr),
       next_process_time_ms_(-1) {
+  static_assert(kMaxPacketAge < kSeqNumRingSize,
+                "The NACK list must cover the max packet age.");
+  static_assert(0x10000 % kSeqNumRingSize == 0,
+                "Wrapping sequence numbers must map to the same index.");
   RTC_DCHECK(clock_);
   RTC_DCHECK(nack_sender_);
   RTC_DCHECK(keyframe_request_sender_);
 }
 
 int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
-  rtc::CritScope lock(&crit_);
+  ProcessThread* process_thread_to_wake_up = nullptr;
+  int nacks_sent_for_packet;
+  {
+    rtc::CritScope lock(&crit_);
+    bool had_missing_packets = !nack_list_.empty();
+    nacks_sent_for_packet = HandleReceivedPacket(seq_num, is_keyframe);
+    if (!had_missing_packets && !nack_list_.empty())
+      process_thread_to_wake_up = process_thread_;
+  }
+  // The process thread holds its own lock while calling TimeUntilNextProcess,
+  // so it must not be woken up while holding |crit_|.
+  if (process_thread_to_wake_up)
+    process_thread_to_wake_up->WakeUp(this);
+  return nacks_sent_for_packet;
+}
+
+int NackModule::HandleReceivedPacket(uint16_t seq_num, bool is_keyframe) {
   // TODO(philipel): When the packet includes information whether it is
   //                 retransmitted or not, use that value instead. For
   //                 now set it to true, which will cause the reordering
@@ -66,7 +191,7 @@ int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
   if (!initialized_) {
     newest_seq_num_ = seq_num;
     if (is_keyframe)
-      keyframe_list_.insert(seq_num);
+      keyframe_list_.Insert(seq_num);
     initialized_ = true;
     return 0;
   }
@@ -78,11 +203,10 @@ int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
 
   if (AheadOf(newest_seq_num_, seq_num)) {
     // An out of order packet has been received.
-    auto nack_list_it = nack_list_.find(seq_num);
     int nacks_sent_for_packet = 0;
-    if (nack_list_it != nack_list_.end()) {
-      nacks_sent_for_packet = nack_list_it->second.retries;
-      nack_list_.erase(nack_list_it);
+    if (nack_list_.Contains(seq_num)) {
+      nacks_sent_for_packet = nack_info(seq_num).retries;
+      nack_list_.Erase(seq_num);
     }
     if (!is_retransmitted)
       UpdateReorderingStatistics(seq_num);
@@ -91,14 +215,12 @@ int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
   AddPacketsToNack(newest_seq_num_ + 1, seq_num);
   newest_seq_num_ = seq_num;
 
-  // Keep track of new keyframes.
-  if (is_keyframe)
-    keyframe_list_.insert(seq_num);
+  // Remove old keyframes so we don't accumulate them.
+  keyframe_list_.EraseOlderThan(seq_num - kMaxPacketAge);
 
-  // And remove old ones so we don't accumulate keyframes.
-  auto it = keyframe_list_.lower_bound(seq_num - kMaxPacketAge);
-  if (it != keyframe_list_.begin())
-    keyframe_list_.erase(keyframe_list_.begin(), it);
+  // And keep track of new ones.
+  if (is_keyframe)
+    keyframe_list_.Insert(seq_num);
 
   // Are there any nacks that are waiting for this seq_num.
   std::vector<uint16_t> nack_batch = GetNackBatch(kSeqNumOnly);
@@ -116,9 +238,8 @@ int NackModule::OnReceivedPacket(const VCMPacket& packet) {
 
 void NackModule::ClearUpTo(uint16_t seq_num) {
   rtc::CritScope lock(&crit_);
-  nack_list_.erase(nack_list_.begin(), nack_list_.lower_bound(seq_num));
-  keyframe_list_.erase(keyframe_list_.begin(),
-                       keyframe_list_.lower_bound(seq_num));
+  nack_list_.EraseOlderThan(seq_num);
+  keyframe_list_.EraseOlderThan(seq_num);
 }
 
 void NackModule::UpdateRtt(int64_t rtt_ms) {
@@ -128,11 +249,17 @@ void NackModule::UpdateRtt(int64_t rtt_ms) {
 
 void NackModule::Clear() {
   rtc::CritScope lock(&crit_);
-  nack_list_.clear();
-  keyframe_list_.clear();
+  nack_list_.Clear();
+  keyframe_list_.Clear();
 }
 
 int64_t NackModule::TimeUntilNextProcess() {
+  {
+    rtc::CritScope lock(&crit_);
+    // Without a process thread to wake up, keep polling.
+    if (process_thread_ && nack_list_.empty())
+      return kIdleProcessIntervalMs;
+  }
   return std::max<int64_t>(next_process_time_ms_ - clock_->TimeInMilliseconds(),
                            0);
 }
@@ -163,21 +290,26 @@ void NackModule::Process() {
   }
 }
 
+void NackModule::ProcessThreadAttached(ProcessThread* process_thread) {
+  rtc::CritScope lock(&crit_);
+  process_thread_ = process_thread;
+}
+
 bool NackModule::RemovePacketsUntilKeyFrame() {
   while (!keyframe_list_.empty()) {
-    auto it = nack_list_.lower_bound(*keyframe_list_.begin());
+    uint16_t keyframe = keyframe_list_.Oldest();
 
-    if (it != nack_list_.begin()) {
+    if (!nack_list_.empty() && AheadOf(keyframe, nack_list_.Oldest())) {
       // We have found a keyframe that actually is newer than at least one
       // packet in the nack list.
-      RTC_DCHECK(it != nack_list_.end());
-      nack_list_.erase(nack_list_.begin(), it);
+      RTC_DCHECK(nack_list_.LowerBound(keyframe));
+      nack_list_.EraseOlderThan(keyframe);
       return true;
     }
 
     // If this keyframe is so old it does not remove any packets from the list,
     // remove it from the list of keyframes and try the next keyframe.
-    keyframe_list_.erase(keyframe_list_.begin());
+    keyframe_list_.Erase(keyframe);
   }
   return false;
 }
@@ -185,8 +317,7 @@ bool NackModule::RemovePacketsUntilKeyFrame() {
 void NackModule::AddPacketsToNack(uint16_t seq_num_start,
                                   uint16_t seq_num_end) {
   // Remove old packets.
-  auto it = nack_list_.lower_bound(seq_num_end - kMaxPacketAge);
-  nack_list_.erase(nack_list_.begin(), it);
+  nack_list_.EraseOlderThan(seq_num_end - kMaxPacketAge);
 
   // If the nack list is too large, remove packets from the nack list until
   // the latest first packet of a keyframe. If the list is still too large,
@@ -198,7 +329,7 @@ void NackModule::AddPacketsToNack(uint16_t seq_num_start,
     }
 
     if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
-      nack_list_.clear();
+      nack_list_.Clear();
       RTC_LOG(LS_WARNING) << "NACK list full, clearing NACK"
                              " list and requesting keyframe.";
       keyframe_request_sender_->RequestKeyFrame();
@@ -206,49 +337,44 @@ void NackModule::AddPacketsToNack(uint16_t seq_num_start,
     }
   }
 
+  if (nack_infos_.empty())
+    nack_infos_.resize(kSeqNumRingSize);
   for (uint16_t seq_num = seq_num_start; seq_num != seq_num_end; ++seq_num) {
-    NackInfo nack_info(seq_num, seq_num + WaitNumberOfPackets(0.5));
-    RTC_DCHECK(nack_list_.find(seq_num) == nack_list_.end());
-    nack_list_[seq_num] = nack_info;
+    RTC_DCHECK(!nack_list_.Contains(seq_num));
+    nack_list_.Insert(seq_num);
+    nack_info(seq_num) = NackInfo(seq_num, seq_num + WaitNumberOfPackets(0.5));
   }
 }
 
+NackModule::NackInfo& NackModule::nack_info(uint16_t seq_num) {
+  RTC_DCHECK(nack_list_.Contains(seq_num));
+  return nack_infos_[seq_num % kSeqNumRingSize];
+}
+
 std::vector<uint16_t> NackModule::GetNackBatch(NackFilterOptions options) {
   bool consider_seq_num = options != kTimeOnly;
   bool consider_timestamp = options != kSeqNumOnly;
   int64_t now_ms = clock_->TimeInMilliseconds();
   std::vector<uint16_t> nack_batch;
-  auto it = nack_list_.begin();
-  while (it != nack_list_.end()) {
-    if (consider_seq_num && it->second.sent_at_time == -1 &&
-        AheadOrAt(newest_seq_num_, it->second.send_at_seq_num)) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now_ms;
-      if (it->second.retries >= kMaxNackRetries) {
-        RTC_LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                            << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
-      }
-      continue;
-    }
-
-    if (consider_timestamp && it->second.sent_at_time + rtt_ms_ <= now_ms) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now_ms;
-      if (it->second.retries >= kMaxNackRetries) {
-        RTC_LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
+  absl::optional<uint16_t> seq_num;
+  if (!nack_list_.empty())
+    seq_num = nack_list_.Oldest();
+  while (seq_num) {
+    NackInfo& info = nack_info(*seq_num);
+    absl::optional<uint16_t> next_seq_num = nack_list_.Next(*seq_num);
+    if ((consider_seq_num && info.sent_at_time == -1 &&
+         AheadOrAt(newest_seq_num_, info.send_at_seq_num)) ||
+        (consider_timestamp && info.sent_at_time + rtt_ms_ <= now_ms)) {
+      nack_batch.emplace_back(info.seq_num);
+      ++info.retries;
+      info.sent_at_time = now_ms;
+      if (info.retries >= kMaxNackRetries) {
+        RTC_LOG(LS_WARNING) << "Sequence number " << info.seq_num
                             << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
+        nack_list_.Erase(*seq_num);
       }
-      continue;
     }
-    ++it;
+    seq_num = next_seq_num;
   }
   return nack_batch;
 }
@@ -11,10 +11,10 @@
 #ifndef MODULES_VIDEO_CODING_NACK_MODULE_H_
 #define MODULES_VIDEO_CODING_NACK_MODULE_H_
 
-#include <map>
-#include <set>
+#include <array>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "modules/include/module.h"
 #include "modules/include/module_common_types.h"
 #include "modules/video_coding/histogram.h"
@@ -41,8 +41,47 @@ class NackModule : public Module {
   // Module implementation
   int64_t TimeUntilNextProcess() override;
   void Process() override;
+  void ProcessThreadAttached(ProcessThread* process_thread) override;
 
  private:
+  // Number of sequence numbers covered by the NACK and keyframe lists. All
+  // entries are kept within this distance of each other.
+  static constexpr int kSeqNumRingSize = 1 << 14;
+
+  // Set of sequence numbers stored as a bitset indexed by
+  // |seq_num % kSeqNumRingSize|, ordered from the oldest to the newest entry.
+  class SeqNumBitset {
+   public:
+    SeqNumBitset();
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    bool Contains(uint16_t seq_num) const;
+    void Insert(uint16_t seq_num);
+    // Returns false if |seq_num| was not in the set.
+    bool Erase(uint16_t seq_num);
+    // Removes all entries older than |seq_num|.
+    void EraseOlderThan(uint16_t seq_num);
+    void Clear();
+
+    // Must not be called on an empty set.
+    uint16_t Oldest() const;
+    // Returns the oldest entry that is not older than |seq_num|.
+    absl::optional<uint16_t> LowerBound(uint16_t seq_num) const;
+    // Returns the oldest entry that is newer than |seq_num|.
+    absl::optional<uint16_t> Next(uint16_t seq_num) const;
+
+   private:
+    static constexpr int kBitsPerWord = 64;
+
+    std::array<uint64_t, kSeqNumRingSize / kBitsPerWord> words_;
+    uint16_t oldest_;
+    // Newest entry ever inserted since the set was last empty, the entry
+    // itself may have been erased since.
+    uint16_t newest_;
+    size_t size_;
+  };
+
   // Which fields to consider when deciding which packet to nack in
   // GetNackBatch.
   enum NackFilterOptions { kSeqNumOnly, kTimeOnly, kSeqNumAndTime };
@@ -65,6 +104,9 @@ class NackModule : public Module {
   // Removes packets from the nack list until the next keyframe. Returns true
   // if packets were removed.
   bool RemovePacketsUntilKeyFrame() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  int HandleReceivedPacket(uint16_t seq_num, bool is_keyframe)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  NackInfo& nack_info(uint16_t seq_num) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
   std::vector<uint16_t> GetNackBatch(NackFilterOptions options)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
@@ -85,14 +127,18 @@ class NackModule : public Module {
   // TODO(philipel): Some of the variables below are consistently used on a
   // known thread (e.g. see |initialized_|). Those probably do not need
   // synchronized access.
-  std::map<uint16_t, NackInfo, DescendingSeqNumComp<uint16_t>> nack_list_
-      RTC_GUARDED_BY(crit_);
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> keyframe_list_
-      RTC_GUARDED_BY(crit_);
+  SeqNumBitset nack_list_ RTC_GUARDED_BY(crit_);
+  // The NackInfo of the packets in |nack_list_|, indexed by
+  // |seq_num % kSeqNumRingSize|. Allocated when the first packet goes missing
+  // so streams without losses don't pay for it.
+  std::vector<NackInfo> nack_infos_ RTC_GUARDED_BY(crit_);
+  SeqNumBitset keyframe_list_ RTC_GUARDED_BY(crit_);
   video_coding::Histogram reordering_histogram_ RTC_GUARDED_BY(crit_);
   bool initialized_ RTC_GUARDED_BY(crit_);
   int64_t rtt_ms_ RTC_GUARDED_BY(crit_);
   uint16_t newest_seq_num_ RTC_GUARDED_BY(crit_);
+  // Woken up when the NACK list stops being empty, see TimeUntilNextProcess.
+  ProcessThread* process_thread_ RTC_GUARDED_BY(crit_);
 
   // Only touched on the process thread.
   int64_t next_process_time_ms_;
@@ -12,8 +12,10 @@
 #include <memory>
 
 #include "modules/video_coding/include/video_coding_defines.h"
+#include "modules/utility/include/mock/mock_process_thread.h"
 #include "modules/video_coding/nack_module.h"
 #include "system_wrappers/include/clock.h"
+#include "test/gmock.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -162,6 +164,36 @@ TEST_F(TestNackModule, DontBurstOnTimeSkip) {
   EXPECT_EQ(19, nack_module_.TimeUntilNextProcess());
 }
 
+TEST_F(TestNackModule, OnlyWakesUpProcessThreadForMissingPackets) {
+  MockProcessThread process_thread;
+  nack_module_.ProcessThreadAttached(&process_thread);
+  EXPECT_GT(nack_module_.TimeUntilNextProcess(), 20);
+
+  VCMPacket packet;
+  packet.seqNum = 0;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 1;
+  nack_module_.OnReceivedPacket(packet);
+  EXPECT_GT(nack_module_.TimeUntilNextProcess(), 20);
+
+  // Only the first missing packet wakes up the process thread.
+  EXPECT_CALL(process_thread, WakeUp(&nack_module_)).Times(1);
+  packet.seqNum = 3;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 5;
+  nack_module_.OnReceivedPacket(packet);
+  EXPECT_EQ(0, nack_module_.TimeUntilNextProcess());
+  nack_module_.Process();
+  EXPECT_EQ(20, nack_module_.TimeUntilNextProcess());
+
+  packet.seqNum = 2;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 4;
+  nack_module_.OnReceivedPacket(packet);
+  EXPECT_GT(nack_module_.TimeUntilNextProcess(), 20);
+  nack_module_.ProcessThreadAttached(nullptr);
+}
+
 TEST_F(TestNackModule, ResendNack) {
   VCMPacket packet;
   packet.seqNum = 1;
@@ -290,6 +322,36 @@ TEST_F(TestNackModule, ClearUpToWrap) {
   EXPECT_EQ(0, sent_nacks_[0]);
 }
 
+TEST_F(TestNackModule, StopsNackingPacketsOlderThanMaxPacketAge) {
+  VCMPacket packet;
+  packet.seqNum = 0xff00;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 0xff02;
+  nack_module_.OnReceivedPacket(packet);
+  ASSERT_EQ(1u, sent_nacks_.size());
+  EXPECT_EQ(0xff01, sent_nacks_[0]);
+
+  // The lost packet is nacked until it is older than the max packet age.
+  const uint16_t kLastNackedSeqNum = 0xff01 + 10000;
+  for (uint16_t seq_num = 0xff03; seq_num != kLastNackedSeqNum + 1;
+       ++seq_num) {
+    packet.seqNum = seq_num;
+    nack_module_.OnReceivedPacket(packet);
+  }
+  sent_nacks_.clear();
+  clock_->AdvanceTimeMilliseconds(100);
+  nack_module_.Process();
+  ASSERT_EQ(1u, sent_nacks_.size());
+  EXPECT_EQ(0xff01, sent_nacks_[0]);
+
+  sent_nacks_.clear();
+  packet.seqNum = kLastNackedSeqNum + 1;
+  nack_module_.OnReceivedPacket(packet);
+  clock_->AdvanceTimeMilliseconds(100);
+  nack_module_.Process();
+  EXPECT_EQ(0u, sent_nacks_.size());
+}
+
 TEST_F(TestNackModule, PacketNackCount) {
   VCMPacket packet;
   packet.seqNum = 0;
@@ -24,6 +24,11 @@
 
 namespace webrtc {
 namespace video_coding {
+namespace {
+// Enough to cover the frames waiting to be decoded, so that the buffer of a
+// decoded frame can be reused by the next one received.
+const size_t kMaxFreeBitstreamBuffers = 8;
+}  // namespace
 
 rtc::scoped_refptr<PacketBuffer> PacketBuffer::Create(
     Clock* clock,
@@ -410,6 +415,44 @@ void PacketBuffer::ReturnFrame(RtpFrameObject* frame) {
   }
 }
 
+uint8_t* PacketBuffer::GetBitstreamBuffer(size_t size, size_t* capacity) {
+  rtc::CritScope lock(&crit_);
+  // Use the smallest free buffer that is large enough.
+  auto best = free_bitstream_buffers_.end();
+  for (auto it = free_bitstream_buffers_.begin();
+       it != free_bitstream_buffers_.end(); ++it) {
+    if (it->capacity >= size &&
+        (best == free_bitstream_buffers_.end() ||
+         it->capacity < best->capacity)) {
+      best = it;
+    }
+  }
+  if (best == free_bitstream_buffers_.end()) {
+    *capacity = size;
+    return new uint8_t[size];
+  }
+  *capacity = best->capacity;
+  uint8_t* buffer = best->data.release();
+  free_bitstream_buffers_.erase(best);
+  return buffer;
+}
+
+void PacketBuffer::ReturnBitstreamBuffer(uint8_t* buffer, size_t capacity) {
+  if (!buffer)
+    return;
+  rtc::CritScope lock(&crit_);
+  free_bitstream_buffers_.push_back(
+      BitstreamBuffer{std::unique_ptr<uint8_t[]>(buffer), capacity});
+  if (free_bitstream_buffers_.size() > kMaxFreeBitstreamBuffers) {
+    // Keep the larger buffers, they can hold any frame the smaller can.
+    free_bitstream_buffers_.erase(std::min_element(
+        free_bitstream_buffers_.begin(), free_bitstream_buffers_.end(),
+        [](const BitstreamBuffer& a, const BitstreamBuffer& b) {
+          return a.capacity < b.capacity;
+        }));
+  }
+}
+
 bool PacketBuffer::GetBitstream(const RtpFrameObject& frame,
                                 uint8_t* destination) {
   rtc::CritScope lock(&crit_);
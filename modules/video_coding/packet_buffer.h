@@ -126,6 +126,13 @@ class PacketBuffer {
   // Virtual for testing.
   virtual void ReturnFrame(RtpFrameObject* frame);
 
+  // Returns a buffer for the bitstream of a frame of |size| bytes and sets
+  // |capacity| to its size, which may be larger. Buffers handed back with
+  // ReturnBitstreamBuffer are reused, so that frames do not need an
+  // allocation each in steady state.
+  uint8_t* GetBitstreamBuffer(size_t size, size_t* capacity);
+  void ReturnBitstreamBuffer(uint8_t* buffer, size_t capacity);
+
   void UpdateMissingPackets(uint16_t seq_num)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
@@ -155,6 +162,13 @@ class PacketBuffer {
   // and information needed to determine the continuity between packets.
   std::vector<ContinuityInfo> sequence_buffer_ RTC_GUARDED_BY(crit_);
 
+  struct BitstreamBuffer {
+    std::unique_ptr<uint8_t[]> data;
+    size_t capacity;
+  };
+  // Bitstream buffers of destroyed frames, kept for reuse.
+  std::vector<BitstreamBuffer> free_bitstream_buffers_ RTC_GUARDED_BY(crit_);
+
   // Called when a received frame is found.
   OnReceivedFrameCallback* const received_frame_callback_;
 
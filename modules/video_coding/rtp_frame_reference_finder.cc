@@ -129,6 +129,25 @@ void RtpFrameReferenceFinder::ClearTo(uint16_t seq_num) {
   }
 }
 
+void RtpFrameReferenceFinder::FrameDroppedVp8(uint16_t picture_id) {
+  rtc::CritScope lock(&crit_);
+  picture_id %= kPicIdLength;
+  if (last_picture_id_ == -1)
+    last_picture_id_ = picture_id;
+
+  // Like a received frame, except that the frame itself is not added to
+  // |not_yet_received_frames_| if it is ahead of the last picture id.
+  if (AheadOf<uint16_t, kPicIdLength>(picture_id, last_picture_id_)) {
+    last_picture_id_ = Add<kPicIdLength>(last_picture_id_, 1);
+    while (last_picture_id_ != picture_id) {
+      not_yet_received_frames_.Set(last_picture_id_, true);
+      last_picture_id_ = Add<kPicIdLength>(last_picture_id_, 1);
+    }
+  }
+  not_yet_received_frames_.Erase(picture_id);
+  RetryStashedFrames();
+}
+
 void RtpFrameReferenceFinder::UpdateLastPictureIdWithPadding(uint16_t seq_num) {
   auto gop_seq_num_it = last_seq_num_gop_.upper_bound(seq_num);
 
@@ -270,7 +289,7 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   if (AheadOf<uint16_t, kPicIdLength>(frame->id.picture_id, last_picture_id_)) {
     do {
       last_picture_id_ = Add<kPicIdLength>(last_picture_id_, 1);
-      not_yet_received_frames_.insert(last_picture_id_);
+      not_yet_received_frames_.Set(last_picture_id_, true);
     } while (last_picture_id_ != frame->id.picture_id);
   }
 
@@ -278,38 +297,38 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
 
   // Clean up info for base layers that are too old.
   int64_t old_tl0_pic_idx = unwrapped_tl0 - kMaxLayerInfo;
-  auto clean_layer_info_to = layer_info_.lower_bound(old_tl0_pic_idx);
-  layer_info_.erase(layer_info_.begin(), clean_layer_info_to);
+  layer_info_.EraseOlderThan(old_tl0_pic_idx);
 
   // Clean up info about not yet received frames that are too old.
   uint16_t old_picture_id =
       Subtract<kPicIdLength>(frame->id.picture_id, kMaxNotYetReceivedFrames);
-  auto clean_frames_to = not_yet_received_frames_.lower_bound(old_picture_id);
-  not_yet_received_frames_.erase(not_yet_received_frames_.begin(),
-                                 clean_frames_to);
+  not_yet_received_frames_.EraseOlderThan(old_picture_id);
 
   if (frame->frame_type() == kVideoFrameKey) {
     frame->num_references = 0;
-    layer_info_[unwrapped_tl0].fill(-1);
+    std::array<int16_t, kMaxTemporalLayers> no_frames;
+    no_frames.fill(-1);
+    layer_info_.Set(unwrapped_tl0, no_frames);
     UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
     return kHandOff;
   }
 
-  auto layer_info_it = layer_info_.find(
+  std::array<int16_t, kMaxTemporalLayers>* layer_info = layer_info_.Find(
       codec_header.temporalIdx == 0 ? unwrapped_tl0 - 1 : unwrapped_tl0);
 
   // If we don't have the base layer frame yet, stash this frame.
-  if (layer_info_it == layer_info_.end())
+  if (!layer_info)
     return kStash;
 
   // A non keyframe base layer frame has been received, copy the layer info
   // from the previous base layer frame and set a reference to the previous
   // base layer frame.
   if (codec_header.temporalIdx == 0) {
-    layer_info_it =
-        layer_info_.emplace(unwrapped_tl0, layer_info_it->second).first;
+    layer_info = layer_info_.Emplace(unwrapped_tl0, *layer_info);
+    if (!layer_info)
+      return kDrop;
     frame->num_references = 1;
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = (*layer_info)[0];
     UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
     return kHandOff;
   }
@@ -317,7 +336,7 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   // Layer sync frame, this frame only references its base layer frame.
   if (codec_header.layerSync) {
     frame->num_references = 1;
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = (*layer_info)[0];
 
     UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
     return kHandOff;
@@ -328,29 +347,29 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   for (uint8_t layer = 0; layer <= codec_header.temporalIdx; ++layer) {
     // If we have not yet received a previous frame on this temporal layer,
     // stash this frame.
-    if (layer_info_it->second[layer] == -1)
+    if ((*layer_info)[layer] == -1)
       return kStash;
 
     // If the last frame on this layer is ahead of this frame it means that
     // a layer sync frame has been received after this frame for the same
     // base layer frame, drop this frame.
-    if (AheadOf<uint16_t, kPicIdLength>(layer_info_it->second[layer],
-                                        frame->id.picture_id)) {
+    const uint16_t last_on_layer = (*layer_info)[layer];
+    if (AheadOf<uint16_t, kPicIdLength>(last_on_layer, frame->id.picture_id))
       return kDrop;
-    }
 
     // If we have not yet received a frame between this frame and the referenced
     // frame then we have to wait for that frame to be completed first.
-    auto not_received_frame_it =
-        not_yet_received_frames_.upper_bound(layer_info_it->second[layer]);
-    if (not_received_frame_it != not_yet_received_frames_.end() &&
-        AheadOf<uint16_t, kPicIdLength>(frame->id.picture_id,
-                                        *not_received_frame_it)) {
+    const uint16_t picture_id = frame->id.picture_id;
+    if (not_yet_received_frames_.Any([&](uint16_t not_received, bool) {
+          return AheadOf<uint16_t, kPicIdLength>(not_received,
+                                                 last_on_layer) &&
+                 AheadOf<uint16_t, kPicIdLength>(picture_id, not_received);
+        })) {
       return kStash;
     }
 
     if (!(AheadOf<uint16_t, kPicIdLength>(frame->id.picture_id,
-                                          layer_info_it->second[layer]))) {
+                                          last_on_layer))) {
       RTC_LOG(LS_WARNING) << "Frame with picture id " << frame->id.picture_id
                           << " and packet range [" << frame->first_seq_num()
                           << ", " << frame->last_seq_num()
@@ -360,7 +379,7 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
     }
 
     ++frame->num_references;
-    frame->references[layer] = layer_info_it->second[layer];
+    frame->references[layer] = last_on_layer;
   }
 
   UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
@@ -370,23 +389,24 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
 void RtpFrameReferenceFinder::UpdateLayerInfoVp8(RtpFrameObject* frame,
                                                  int64_t unwrapped_tl0,
                                                  uint8_t temporal_idx) {
-  auto layer_info_it = layer_info_.find(unwrapped_tl0);
+  std::array<int16_t, kMaxTemporalLayers>* layer_info =
+      layer_info_.Find(unwrapped_tl0);
 
   // Update this layer info and newer.
-  while (layer_info_it != layer_info_.end()) {
-    if (layer_info_it->second[temporal_idx] != -1 &&
-        AheadOf<uint16_t, kPicIdLength>(layer_info_it->second[temporal_idx],
+  while (layer_info) {
+    if ((*layer_info)[temporal_idx] != -1 &&
+        AheadOf<uint16_t, kPicIdLength>((*layer_info)[temporal_idx],
                                         frame->id.picture_id)) {
       // The frame was not newer, then no subsequent layer info have to be
       // update.
       break;
     }
 
-    layer_info_it->second[temporal_idx] = frame->id.picture_id;
+    (*layer_info)[temporal_idx] = frame->id.picture_id;
     ++unwrapped_tl0;
-    layer_info_it = layer_info_.find(unwrapped_tl0);
+    layer_info = layer_info_.Find(unwrapped_tl0);
   }
-  not_yet_received_frames_.erase(frame->id.picture_id);
+  not_yet_received_frames_.Erase(frame->id.picture_id);
 
   UnwrapPictureIds(frame);
 }
@@ -445,17 +465,15 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
 
       scalability_structures_[current_ss_idx_] = codec_header.gof;
       scalability_structures_[current_ss_idx_].pid_start = frame->id.picture_id;
-      gof_info_.emplace(unwrapped_tl0,
+      gof_info_.Emplace(unwrapped_tl0,
                         GofInfo(&scalability_structures_[current_ss_idx_],
                                 frame->id.picture_id));
     }
 
-    const auto gof_info_it = gof_info_.find(unwrapped_tl0);
-    if (gof_info_it == gof_info_.end())
+    info = gof_info_.Find(unwrapped_tl0);
+    if (!info)
       return kStash;
 
-    info = &gof_info_it->second;
-
     if (frame->frame_type() == kVideoFrameKey) {
       frame->num_references = 0;
       FrameReceivedVp9(frame->id.picture_id, info);
@@ -468,27 +486,24 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
       return kDrop;
     }
 
-    auto gof_info_it = gof_info_.find(
+    info = gof_info_.Find(
         (codec_header.temporal_idx == 0) ? unwrapped_tl0 - 1 : unwrapped_tl0);
 
     // Gof info for this frame is not available yet, stash this frame.
-    if (gof_info_it == gof_info_.end())
+    if (!info)
       return kStash;
 
     if (codec_header.temporal_idx == 0) {
-      gof_info_it = gof_info_
-                        .emplace(unwrapped_tl0, GofInfo(gof_info_it->second.gof,
-                                                        frame->id.picture_id))
-                        .first;
+      info = gof_info_.Emplace(unwrapped_tl0,
+                               GofInfo(info->gof, frame->id.picture_id));
+      if (!info)
+        return kDrop;
     }
-
-    info = &gof_info_it->second;
   }
 
   // Clean up info for base layers that are too old.
   int64_t old_tl0_pic_idx = unwrapped_tl0 - kMaxGofSaved;
-  auto clean_gof_info_to = gof_info_.lower_bound(old_tl0_pic_idx);
-  gof_info_.erase(gof_info_.begin(), clean_gof_info_to);
+  gof_info_.EraseOlderThan(old_tl0_pic_idx);
 
   FrameReceivedVp9(frame->id.picture_id, info);
 
@@ -498,12 +513,11 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
     return kStash;
 
   if (codec_header.temporal_up_switch)
-    up_switch_.emplace(frame->id.picture_id, codec_header.temporal_idx);
+    up_switch_.Emplace(frame->id.picture_id, codec_header.temporal_idx);
 
   // Clean out old info about up switch frames.
   uint16_t old_picture_id = Subtract<kPicIdLength>(frame->id.picture_id, 50);
-  auto up_switch_erase_to = up_switch_.lower_bound(old_picture_id);
-  up_switch_.erase(up_switch_.begin(), up_switch_erase_to);
+  up_switch_.EraseOlderThan(old_picture_id);
 
   size_t diff = ForwardDiff<uint16_t, kPicIdLength>(info->gof->pid_start,
                                                     frame->id.picture_id);
@@ -608,15 +622,11 @@ void RtpFrameReferenceFinder::FrameReceivedVp9(uint16_t picture_id,
 bool RtpFrameReferenceFinder::UpSwitchInIntervalVp9(uint16_t picture_id,
                                                     uint8_t temporal_idx,
                                                     uint16_t pid_ref) {
-  for (auto up_switch_it = up_switch_.upper_bound(pid_ref);
-       up_switch_it != up_switch_.end() &&
-       AheadOf<uint16_t, kPicIdLength>(picture_id, up_switch_it->first);
-       ++up_switch_it) {
-    if (up_switch_it->second < temporal_idx)
-      return true;
-  }
-
-  return false;
+  return up_switch_.Any([&](uint16_t up_switch_id, uint8_t up_switch_idx) {
+    return up_switch_idx < temporal_idx &&
+           AheadOf<uint16_t, kPicIdLength>(up_switch_id, pid_ref) &&
+           AheadOf<uint16_t, kPicIdLength>(picture_id, up_switch_id);
+  });
 }
 
 void RtpFrameReferenceFinder::UnwrapPictureIds(RtpFrameObject* frame) {
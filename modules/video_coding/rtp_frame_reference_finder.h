@@ -13,11 +13,14 @@
 
 #include <array>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
 #include <utility>
 
+#include "absl/types/optional.h"
+
 #include "modules/include/module_common_types.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/numerics/sequence_number_util.h"
@@ -56,6 +59,11 @@ class RtpFrameReferenceFinder {
   // Clear all stashed frames that include packets older than |seq_num|.
   void ClearTo(uint16_t seq_num);
 
+  // Notifies that the VP8 frame |picture_id| was dropped on purpose before it
+  // was assembled, e.g. because its temporal layer isn't decoded. Frames of
+  // lower layers are then not held back waiting for it.
+  void FrameDroppedVp8(uint16_t picture_id);
+
  private:
   static const uint16_t kPicIdLength = 1 << 15;
   static const uint8_t kMaxTemporalLayers = 5;
@@ -67,6 +75,81 @@ class RtpFrameReferenceFinder {
 
   enum FrameDecision { kStash, kHandOff, kDrop };
 
+  // Fixed size replacement of an std::map ordered by |Older|, for state that
+  // is only kept for a bounded window of keys. A key is stored at its value
+  // modulo |kSize|, which must be larger than the window, and when two keys
+  // would share a slot only the newer one is kept.
+  template <typename Key, typename T, size_t kSize, typename Older>
+  class RingMap {
+   public:
+    T* Find(Key key) {
+      Entry& entry = entries_[Slot(key)];
+      return entry.value && entry.key == key ? &*entry.value : nullptr;
+    }
+
+    // Like std::map::emplace, keeps the value of an existing |key|. Returns
+    // nullptr if a newer key holds the slot.
+    T* Emplace(Key key, const T& value) {
+      Entry& entry = entries_[Slot(key)];
+      if (entry.value && entry.key == key)
+        return &*entry.value;
+      return Set(key, value);
+    }
+
+    // Like std::map::operator[] followed by an assignment.
+    T* Set(Key key, const T& value) {
+      Entry& entry = entries_[Slot(key)];
+      if (entry.value && Older()(key, entry.key))
+        return nullptr;
+      entry.key = key;
+      entry.value = value;
+      return &*entry.value;
+    }
+
+    void Erase(Key key) {
+      Entry& entry = entries_[Slot(key)];
+      if (entry.value && entry.key == key)
+        entry.value.reset();
+    }
+
+    void EraseOlderThan(Key key) {
+      for (Entry& entry : entries_) {
+        if (entry.value && Older()(entry.key, key))
+          entry.value.reset();
+      }
+    }
+
+    // Returns true if |pred| is true for any key and value.
+    template <typename Predicate>
+    bool Any(Predicate pred) const {
+      for (const Entry& entry : entries_) {
+        if (entry.value && pred(entry.key, *entry.value))
+          return true;
+      }
+      return false;
+    }
+
+   private:
+    struct Entry {
+      Key key = 0;
+      absl::optional<T> value;
+    };
+
+    static size_t Slot(Key key) { return static_cast<uint64_t>(key) % kSize; }
+
+    std::array<Entry, kSize> entries_;
+  };
+
+  using PictureIdOlder = DescendingSeqNumComp<uint16_t, kPicIdLength>;
+  // The picture id rings must divide |kPicIdLength| to stay consecutive when
+  // picture ids wrap.
+  static const size_t kPictureIdRingSize = 128;
+  static const size_t kTl0RingSize = 64;
+  static_assert(kPicIdLength % kPictureIdRingSize == 0, "");
+  static_assert(kPictureIdRingSize > kMaxNotYetReceivedFrames, "");
+  static_assert(kTl0RingSize > kMaxLayerInfo && kTl0RingSize > kMaxGofSaved,
+                "");
+
   struct GofInfo {
     GofInfo(GofInfoVP9* gof, uint16_t last_picture_id)
         : gof(gof), last_picture_id(last_picture_id) {}
@@ -154,7 +237,7 @@ class RtpFrameReferenceFinder {
 
   // Frames earlier than the last received frame that have not yet been
   // fully received.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
+  RingMap<uint16_t, bool, kPictureIdRingSize, PictureIdOlder>
       not_yet_received_frames_ RTC_GUARDED_BY(crit_);
 
   // Frames that have been fully received but didn't have all the information
@@ -164,8 +247,11 @@ class RtpFrameReferenceFinder {
 
   // Holds the information about the last completed frame for a given temporal
   // layer given an unwrapped Tl0 picture index.
-  std::map<int64_t, std::array<int16_t, kMaxTemporalLayers>> layer_info_
-      RTC_GUARDED_BY(crit_);
+  RingMap<int64_t,
+          std::array<int16_t, kMaxTemporalLayers>,
+          kTl0RingSize,
+          std::less<int64_t>>
+      layer_info_ RTC_GUARDED_BY(crit_);
 
   // Where the current scalability structure is in the
   // |scalability_structures_| array.
@@ -176,12 +262,13 @@ class RtpFrameReferenceFinder {
       RTC_GUARDED_BY(crit_);
 
   // Holds the the Gof information for a given unwrapped TL0 picture index.
-  std::map<int64_t, GofInfo> gof_info_ RTC_GUARDED_BY(crit_);
+  RingMap<int64_t, GofInfo, kTl0RingSize, std::less<int64_t>> gof_info_
+      RTC_GUARDED_BY(crit_);
 
   // Keep track of which picture id and which temporal layer that had the
   // up switch flag set.
-  std::map<uint16_t, uint8_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
-      up_switch_ RTC_GUARDED_BY(crit_);
+  RingMap<uint16_t, uint8_t, kPictureIdRingSize, PictureIdOlder> up_switch_
+      RTC_GUARDED_BY(crit_);
 
   // For every temporal layer, keep a set of which frames that are missing.
   std::array<std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>,
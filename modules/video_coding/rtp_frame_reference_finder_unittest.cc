@@ -601,6 +601,31 @@ TEST_F(TestRtpFrameReferenceFinder, Vp8TemporalLayersReordering_0212) {
   CheckReferencesVp8(11, 8, 9, 10);
 }
 
+// Test with 3 temporal layers in a 0212 pattern, of which layer 2 is dropped.
+TEST_F(TestRtpFrameReferenceFinder, Vp8DroppedTemporalLayer_0212) {
+  uint16_t pid = Rand();
+  uint16_t sn = Rand();
+
+  InsertVp8(sn, sn, true, pid, 0, 55);
+  reference_finder_->FrameDroppedVp8(pid + 1);
+  InsertVp8(sn + 2, sn + 2, false, pid + 2, 1, 55, true);
+  reference_finder_->FrameDroppedVp8(pid + 3);
+  InsertVp8(sn + 4, sn + 4, false, pid + 4, 0, 56);
+  // Stashed until the frame before it is known to be dropped.
+  InsertVp8(sn + 6, sn + 6, false, pid + 6, 1, 56);
+  ASSERT_EQ(3UL, frames_from_callback_.size());
+  reference_finder_->FrameDroppedVp8(pid + 5);
+  reference_finder_->FrameDroppedVp8(pid + 7);
+  InsertVp8(sn + 8, sn + 8, false, pid + 8, 0, 57);
+
+  ASSERT_EQ(5UL, frames_from_callback_.size());
+  CheckReferencesVp8(0);
+  CheckReferencesVp8(2, 0);
+  CheckReferencesVp8(4, 0);
+  CheckReferencesVp8(6, 2, 4);
+  CheckReferencesVp8(8, 4);
+}
+
 TEST_F(TestRtpFrameReferenceFinder, Vp8InsertManyFrames_0212) {
   uint16_t pid = Rand();
   uint16_t sn = Rand();
@@ -645,6 +670,25 @@ TEST_F(TestRtpFrameReferenceFinder, Vp8InsertManyFrames_0212) {
   }
 }
 
+TEST_F(TestRtpFrameReferenceFinder, Vp8ReorderedFramesOverLongHistory) {
+  uint16_t pid = Rand();
+  uint16_t sn = Rand();
+  uint8_t tl0 = Rand();
+
+  // Enough frames for the picture id and TL0 history to wrap several times.
+  const int kFrames = 1000;
+  InsertVp8(sn, sn, true, pid, 0, tl0);
+  for (int i = 1; i + 1 < kFrames; i += 2) {
+    InsertVp8(sn + i + 1, sn + i + 1, false, pid + i + 1, 0, tl0 + i + 1);
+    InsertVp8(sn + i, sn + i, false, pid + i, 0, tl0 + i);
+  }
+
+  ASSERT_EQ(static_cast<size_t>(kFrames - 1), frames_from_callback_.size());
+  CheckReferencesVp8(0);
+  for (int i = 1; i < kFrames - 1; ++i)
+    CheckReferencesVp8(i, i - 1);
+}
+
 TEST_F(TestRtpFrameReferenceFinder, Vp8LayerSync) {
   uint16_t pid = Rand();
   uint16_t sn = Rand();
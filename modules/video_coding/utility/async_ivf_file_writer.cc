@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/async_ivf_file_writer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+constexpr size_t AsyncIvfFileWriter::kDefaultMaxQueuedBytes;
+
+// Writes a copy of a frame, since the buffer of the original one is reused
+// after WriteFrame() returns.
+class AsyncIvfFileWriter::WriteFrameTask : public rtc::QueuedTask {
+ public:
+  WriteFrameTask(AsyncIvfFileWriter* writer,
+                 const EncodedImage& encoded_image,
+                 VideoCodecType codec_type)
+      : writer_(writer),
+        encoded_image_(encoded_image),
+        codec_type_(codec_type),
+        buffer_(encoded_image._buffer, encoded_image._length) {
+    encoded_image_._buffer = buffer_.data();
+    encoded_image_._size = buffer_.size();
+  }
+
+ private:
+  bool Run() override {
+    RTC_DCHECK(writer_->queue_.IsCurrent());
+    bool ok = writer_->writer_ &&
+              writer_->writer_->WriteFrame(encoded_image_, codec_type_);
+    if (!ok)
+      writer_->writer_.reset();
+    writer_->OnFrameWritten(buffer_.size(), ok);
+    return true;
+  }
+
+  AsyncIvfFileWriter* const writer_;
+  EncodedImage encoded_image_;
+  const VideoCodecType codec_type_;
+  rtc::Buffer buffer_;
+};
+
+AsyncIvfFileWriter::AsyncIvfFileWriter(rtc::File file,
+                                       size_t byte_limit,
+                                       size_t max_queued_bytes)
+    : max_queued_bytes_(max_queued_bytes),
+      writer_(IvfFileWriter::Wrap(std::move(file), byte_limit)),
+      queue_("AsyncIvfFileWriter", rtc::TaskQueue::Priority::LOW) {}
+
+AsyncIvfFileWriter::~AsyncIvfFileWriter() {
+  // Tasks run in order, so the frames queued before are written first.
+  rtc::Event done(false, false);
+  queue_.PostTask([this, &done] {
+    writer_.reset();
+    done.Set();
+  });
+  done.Wait(rtc::Event::kForever);
+}
+
+std::unique_ptr<AsyncIvfFileWriter> AsyncIvfFileWriter::Wrap(
+    rtc::File file,
+    size_t byte_limit,
+    size_t max_queued_bytes) {
+  return std::unique_ptr<AsyncIvfFileWriter>(
+      new AsyncIvfFileWriter(std::move(file), byte_limit, max_queued_bytes));
+}
+
+bool AsyncIvfFileWriter::WriteFrame(const EncodedImage& encoded_image,
+                                    VideoCodecType codec_type) {
+  {
+    rtc::CritScope lock(&crit_);
+    if (closed_)
+      return false;
+    if (waiting_for_key_frame_ && encoded_image._frameType == kVideoFrameKey)
+      waiting_for_key_frame_ = false;
+    if (waiting_for_key_frame_ ||
+        stats_.queued_bytes + encoded_image._length > max_queued_bytes_) {
+      if (!waiting_for_key_frame_) {
+        RTC_LOG(LS_WARNING) << "IVF file writes are behind by "
+                            << stats_.queued_bytes
+                            << " bytes, dropping frames till a key frame.";
+      }
+      waiting_for_key_frame_ = true;
+      ++stats_.frames_dropped;
+      return true;
+    }
+    stats_.queued_bytes += encoded_image._length;
+    stats_.max_queued_bytes =
+        std::max(stats_.max_queued_bytes, stats_.queued_bytes);
+  }
+  queue_.PostTask(std::unique_ptr<rtc::QueuedTask>(
+      new WriteFrameTask(this, encoded_image, codec_type)));
+  return true;
+}
+
+AsyncIvfFileWriter::Stats AsyncIvfFileWriter::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  return stats_;
+}
+
+void AsyncIvfFileWriter::OnFrameWritten(size_t bytes, bool ok) {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK_GE(stats_.queued_bytes, bytes);
+  stats_.queued_bytes -= bytes;
+  if (ok) {
+    ++stats_.frames_written;
+  } else {
+    closed_ = true;
+  }
+}
+
+}  // namespace webrtc
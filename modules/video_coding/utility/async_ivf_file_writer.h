@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_ASYNC_IVF_FILE_WRITER_H_
+#define MODULES_VIDEO_CODING_UTILITY_ASYNC_IVF_FILE_WRITER_H_
+
+#include <memory>
+
+#include "common_video/include/video_frame.h"
+#include "modules/include/module_common_types.h"
+#include "modules/video_coding/utility/ivf_file_writer.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/file.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Records encoded frames like IvfFileWriter, but writes the file on a task
+// queue of its own, so that recording doesn't add file I/O to the thread that
+// encodes or decodes. Frames are copied when queued. While more than
+// |max_queued_bytes| wait to be written, frames are dropped, and so are the
+// ones after them up to the next key frame, to keep the file decodable.
+class AsyncIvfFileWriter {
+ public:
+  static constexpr size_t kDefaultMaxQueuedBytes = 8 * 1024 * 1024;
+
+  struct Stats {
+    size_t frames_written = 0;
+    size_t frames_dropped = 0;
+    // The bytes of frames waiting to be written, now and at most.
+    size_t queued_bytes = 0;
+    size_t max_queued_bytes = 0;
+  };
+
+  // See IvfFileWriter::Wrap() for |byte_limit|.
+  static std::unique_ptr<AsyncIvfFileWriter> Wrap(rtc::File file,
+                                                  size_t byte_limit,
+                                                  size_t max_queued_bytes);
+  // Blocks until the queued frames are written, and closes the file.
+  ~AsyncIvfFileWriter();
+
+  // Returns false once the file is closed, e.g. since a frame didn't fit
+  // within the byte limit. Dropped frames aren't an error.
+  bool WriteFrame(const EncodedImage& encoded_image, VideoCodecType codec_type);
+
+  Stats GetStats() const;
+
+ private:
+  class WriteFrameTask;
+
+  AsyncIvfFileWriter(rtc::File file,
+                     size_t byte_limit,
+                     size_t max_queued_bytes);
+
+  void OnFrameWritten(size_t bytes, bool ok);
+
+  const size_t max_queued_bytes_;
+
+  rtc::CriticalSection crit_;
+  Stats stats_ RTC_GUARDED_BY(crit_);
+  bool closed_ RTC_GUARDED_BY(crit_) = false;
+  bool waiting_for_key_frame_ RTC_GUARDED_BY(crit_) = false;
+
+  // Only used on |queue_|.
+  std::unique_ptr<IvfFileWriter> writer_;
+
+  rtc::TaskQueue queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AsyncIvfFileWriter);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_ASYNC_IVF_FILE_WRITER_H_
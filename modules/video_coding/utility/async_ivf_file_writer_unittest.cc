@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/async_ivf_file_writer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "rtc_base/gunit.h"
+#include "test/gtest.h"
+#include "test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+const size_t kHeaderSize = 32;
+const size_t kFrameHeaderSize = 12;
+const int kNumFrames = 20;
+uint8_t payload[100] = {0};
+}  // namespace
+
+class AsyncIvfFileWriterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    file_name_ =
+        webrtc::test::TempFilename(webrtc::test::OutputPath(), "test_file");
+  }
+  void TearDown() override { rtc::RemoveFile(file_name_); }
+
+  // Writes frames of 100 bytes, with a key frame every 5 frames.
+  void WriteFrames(AsyncIvfFileWriter* writer) {
+    EncodedImage frame;
+    frame._buffer = payload;
+    frame._length = sizeof(payload);
+    frame._encodedWidth = 320;
+    frame._encodedHeight = 240;
+    for (int i = 0; i < kNumFrames; ++i) {
+      frame._frameType = i % 5 == 0 ? kVideoFrameKey : kVideoFrameDelta;
+      frame._timeStamp = 3000 * (i + 1);
+      payload[0] = static_cast<uint8_t>(i);
+      EXPECT_TRUE(writer->WriteFrame(frame, kVideoCodecVP8));
+    }
+  }
+
+  // Returns the first payload byte of every frame in the file.
+  std::vector<uint8_t> ReadFrames() {
+    rtc::File file = rtc::File::Open(file_name_);
+    uint8_t header[kHeaderSize];
+    EXPECT_EQ(kHeaderSize, file.Read(header, kHeaderSize));
+    const uint32_t num_frames =
+        ByteReader<uint32_t>::ReadLittleEndian(&header[24]);
+    std::vector<uint8_t> frames;
+    for (uint32_t i = 0; i < num_frames; ++i) {
+      uint8_t frame_header[kFrameHeaderSize];
+      EXPECT_EQ(kFrameHeaderSize, file.Read(frame_header, kFrameHeaderSize));
+      EXPECT_EQ(sizeof(payload),
+                ByteReader<uint32_t>::ReadLittleEndian(&frame_header[0]));
+      uint8_t data[sizeof(payload)];
+      EXPECT_EQ(sizeof(payload), file.Read(data, sizeof(payload)));
+      frames.push_back(data[0]);
+    }
+    file.Close();
+    return frames;
+  }
+
+  std::string file_name_;
+};
+
+TEST_F(AsyncIvfFileWriterTest, WritesQueuedFramesBeforeClosing) {
+  std::unique_ptr<AsyncIvfFileWriter> writer = AsyncIvfFileWriter::Wrap(
+      rtc::File::Open(file_name_), 0,
+      AsyncIvfFileWriter::kDefaultMaxQueuedBytes);
+  WriteFrames(writer.get());
+  EXPECT_EQ(0u, writer->GetStats().frames_dropped);
+  EXPECT_GE(writer->GetStats().max_queued_bytes, sizeof(payload));
+  writer.reset();
+
+  std::vector<uint8_t> frames = ReadFrames();
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), frames.size());
+  for (int i = 0; i < kNumFrames; ++i)
+    EXPECT_EQ(i, frames[i]);
+}
+
+TEST_F(AsyncIvfFileWriterTest, DropsFramesThatDontFitInQueue) {
+  std::unique_ptr<AsyncIvfFileWriter> writer =
+      AsyncIvfFileWriter::Wrap(rtc::File::Open(file_name_), 0, 0);
+  WriteFrames(writer.get());
+  AsyncIvfFileWriter::Stats stats = writer->GetStats();
+  EXPECT_EQ(static_cast<size_t>(kNumFrames), stats.frames_dropped);
+  EXPECT_EQ(0u, stats.max_queued_bytes);
+  writer.reset();
+  // Not even the header is written without frames.
+  EXPECT_EQ(0u, webrtc::test::GetFileSize(file_name_));
+}
+
+TEST_F(AsyncIvfFileWriterTest, FailsOnceByteLimitIsReached) {
+  std::unique_ptr<AsyncIvfFileWriter> writer = AsyncIvfFileWriter::Wrap(
+      rtc::File::Open(file_name_), kHeaderSize + kFrameHeaderSize + 10,
+      AsyncIvfFileWriter::kDefaultMaxQueuedBytes);
+  EncodedImage frame;
+  frame._buffer = payload;
+  frame._length = sizeof(payload);
+  frame._encodedWidth = 320;
+  frame._encodedHeight = 240;
+  frame._frameType = kVideoFrameKey;
+  EXPECT_TRUE(writer->WriteFrame(frame, kVideoCodecVP8));
+  // Once the write has failed on the queue, frames are rejected.
+  EXPECT_TRUE_WAIT(!writer->WriteFrame(frame, kVideoCodecVP8), 5000);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "modules/video_coding/frame_buffer2.h"
+#include "modules/video_coding/frame_object.h"
+#include "modules/video_coding/jitter_estimator.h"
+#include "modules/video_coding/packet_buffer.h"
+#include "modules/video_coding/timing.h"
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace video_coding {
+namespace {
+
+const size_t kPacketSize = 1200;
+
+class CountingFrameCallback : public OnReceivedFrameCallback {
+ public:
+  void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {
+    ++frames_received_;
+  }
+
+  int64_t frames_received() const { return frames_received_; }
+
+ private:
+  int64_t frames_received_ = 0;
+};
+
+class FakeFrame : public EncodedFrame {
+ public:
+  bool GetBitstream(uint8_t* destination) const override { return true; }
+  uint32_t Timestamp() const override { return timestamp; }
+  int64_t ReceivedTime() const override { return 0; }
+  int64_t RenderTime() const override { return _renderTimeMs; }
+};
+
+// Inserts frames of range(0) packets in order, and clears the buffer up to
+// each assembled frame like RtpVideoStreamReceiver does once the frame is
+// decodable.
+void BM_PacketBufferInsertPacket(benchmark::State& state) {
+  SimulatedClock clock(0);
+  CountingFrameCallback callback;
+  rtc::scoped_refptr<PacketBuffer> packet_buffer =
+      PacketBuffer::Create(&clock, 512, 2048, &callback);
+  const int packets_per_frame = state.range(0);
+  uint16_t seq_num = 0;
+  uint32_t timestamp = 0;
+  int64_t packets_inserted = 0;
+
+  for (auto _ : state) {
+    for (int i = 0; i < packets_per_frame; ++i) {
+      VCMPacket packet;
+      packet.codec = kVideoCodecGeneric;
+      packet.timestamp = timestamp;
+      packet.seqNum = seq_num + i;
+      packet.frameType = kVideoFrameKey;
+      packet.is_first_packet_in_frame = i == 0;
+      packet.markerBit = i == packets_per_frame - 1;
+      packet.sizeBytes = kPacketSize;
+      // The packet buffer takes ownership of the payload.
+      packet.dataPtr = new uint8_t[kPacketSize]();
+      RTC_CHECK(packet_buffer->InsertPacket(&packet));
+      ++packets_inserted;
+    }
+    seq_num += packets_per_frame;
+    packet_buffer->ClearTo(seq_num - 1);
+    timestamp += 3000;
+  }
+  RTC_CHECK_EQ(state.iterations(), callback.frames_received());
+  state.SetItemsProcessed(packets_inserted);
+}
+BENCHMARK(BM_PacketBufferInsertPacket)->Arg(1)->Arg(10);
+
+// Inserts a key frame followed by range(0) - 1 delta frames, each
+// referencing the previous one, into a new frame buffer.
+void BM_FrameBufferInsertFrame(benchmark::State& state) {
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  VCMJitterEstimator jitter_estimator(&clock);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<FrameBuffer> frame_buffer(
+        new FrameBuffer(&clock, &jitter_estimator, &timing, nullptr));
+    state.ResumeTiming();
+    for (int i = 0; i < state.range(0); ++i) {
+      std::unique_ptr<FakeFrame> frame(new FakeFrame());
+      frame->id.picture_id = i;
+      frame->timestamp = i * 3000;
+      if (i > 0) {
+        frame->num_references = 1;
+        frame->references[0] = i - 1;
+      }
+      int64_t picture_id = frame_buffer->InsertFrame(std::move(frame));
+      benchmark::DoNotOptimize(picture_id);
+    }
+    state.PauseTiming();
+    frame_buffer.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrameBufferInsertFrame)->Arg(30)->Arg(300);
+
+}  // namespace
+}  // namespace video_coding
+}  // namespace webrtc
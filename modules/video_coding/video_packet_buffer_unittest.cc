@@ -617,6 +617,29 @@ TEST_P(TestPacketBufferH264Parameterized, GetBitstreamBufferPadding) {
   EXPECT_EQ(memcmp(result.get(), data, sizeof(data_data)), 0);
 }
 
+TEST_F(TestPacketBuffer, ReusesBitstreamBufferOfDestroyedFrame) {
+  const uint16_t seq_num = Rand();
+  EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kLast, 10, new uint8_t[10]));
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+  const uint8_t* buffer = frames_from_callback_[seq_num]->Buffer();
+  frames_from_callback_.clear();
+
+  // A smaller frame gets the buffer of the destroyed one.
+  EXPECT_TRUE(
+      Insert(seq_num + 1, kDeltaFrame, kFirst, kLast, 5, new uint8_t[5]));
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+  EXPECT_EQ(buffer, frames_from_callback_[seq_num + 1]->Buffer());
+  EXPECT_EQ(10u, frames_from_callback_[seq_num + 1]->EncodedImage()._size);
+  EXPECT_EQ(5u, frames_from_callback_[seq_num + 1]->size());
+
+  // A larger one needs a new buffer while the other is in use.
+  EXPECT_TRUE(
+      Insert(seq_num + 2, kDeltaFrame, kFirst, kLast, 20, new uint8_t[20]));
+  ASSERT_EQ(2UL, frames_from_callback_.size());
+  EXPECT_NE(buffer, frames_from_callback_[seq_num + 2]->Buffer());
+  EXPECT_EQ(20u, frames_from_callback_[seq_num + 2]->EncodedImage()._size);
+}
+
 TEST_F(TestPacketBuffer, FreeSlotsOnFrameDestruction) {
   const uint16_t seq_num = Rand();
 
@@ -280,7 +280,9 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
   const bool is_buffer_type_supported =
       buffer_type == VideoFrameBuffer::Type::kI420 ||
       (buffer_type == VideoFrameBuffer::Type::kNative &&
-       _encoder->SupportsNativeHandle());
+       _encoder->SupportsNativeHandle()) ||
+      (buffer_type == VideoFrameBuffer::Type::kNV12 &&
+       _encoder->SupportsNV12());
   if (!is_buffer_type_supported) {
     // This module only supports software encoding.
     // TODO(pbos): Offload conversion from the encoder thread.
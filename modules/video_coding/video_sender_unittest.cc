@@ -31,6 +31,7 @@ using ::testing::AllOf;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::Field;
+using ::testing::Mock;
 using ::testing::NiceMock;
 using ::testing::Pointee;
 using ::testing::Return;
@@ -392,6 +393,38 @@ TEST_F(TestVideoSenderWithMockEncoder,
   AddFrame();
 }
 
+TEST_F(TestVideoSenderWithMockEncoder, ReconfiguresResolutionInPlace) {
+  settings_.numberOfSimulcastStreams = 1;
+  ConfigureStream(kDefaultWidth, kDefaultHeight, 1200,
+                  &settings_.simulcastStream[0]);
+  EXPECT_EQ(0, sender_->RegisterSendCodec(&settings_, 1, 1200));
+
+  // A lower resolution is applied without reinitializing the encoder.
+  VideoCodec codec = settings_;
+  ConfigureStream(kDefaultWidth / 2, kDefaultHeight / 2, 600,
+                  &codec.simulcastStream[0]);
+  codec.width = kDefaultWidth / 2;
+  codec.height = kDefaultHeight / 2;
+  EXPECT_CALL(encoder_,
+              Reconfigure(Field(&VideoCodec::width, kDefaultWidth / 2)))
+      .WillOnce(Return(true));
+  EXPECT_CALL(encoder_, InitEncode(_, _, _)).Times(0);
+  EXPECT_EQ(0, sender_->RegisterSendCodec(&codec, 1, 1200));
+  Mock::VerifyAndClearExpectations(&encoder_);
+
+  // Without support of the encoder, it is reinitialized.
+  EXPECT_CALL(encoder_, Reconfigure(_)).WillOnce(Return(false));
+  EXPECT_CALL(encoder_, InitEncode(_, _, _)).WillOnce(Return(0));
+  EXPECT_EQ(0, sender_->RegisterSendCodec(&settings_, 1, 1200));
+  Mock::VerifyAndClearExpectations(&encoder_);
+
+  // Other changes always reinitialize it.
+  codec.qpMax = settings_.qpMax + 1;
+  EXPECT_CALL(encoder_, Reconfigure(_)).Times(0);
+  EXPECT_CALL(encoder_, InitEncode(_, _, _)).WillOnce(Return(0));
+  EXPECT_EQ(0, sender_->RegisterSendCodec(&codec, 1, 1200));
+}
+
 class TestVideoSenderWithVp8 : public TestVideoSender {
  public:
   TestVideoSenderWithVp8()
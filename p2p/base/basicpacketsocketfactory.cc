@@ -11,6 +11,7 @@
 #include "p2p/base/basicpacketsocketfactory.h"
 
 #include <string>
+#include <utility>
 
 #include "p2p/base/asyncstuntcpsocket.h"
 #include "p2p/base/stun.h"
@@ -19,6 +20,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/nethelpers.h"
+#include "rtc_base/networkthreadpool.h"
 #include "rtc_base/physicalsocketserver.h"
 #include "rtc_base/socketadapters.h"
 #include "rtc_base/ssladapter.h"
@@ -27,14 +29,17 @@
 namespace rtc {
 
 BasicPacketSocketFactory::BasicPacketSocketFactory()
-    : thread_(Thread::Current()), socket_factory_(NULL) {}
+    : thread_(Thread::Current()), socket_factory_(NULL), pool_(NULL) {}
 
 BasicPacketSocketFactory::BasicPacketSocketFactory(Thread* thread)
-    : thread_(thread), socket_factory_(NULL) {}
+    : thread_(thread), socket_factory_(NULL), pool_(NULL) {}
 
 BasicPacketSocketFactory::BasicPacketSocketFactory(
     SocketFactory* socket_factory)
-    : thread_(NULL), socket_factory_(socket_factory) {}
+    : thread_(NULL), socket_factory_(socket_factory), pool_(NULL) {}
+
+BasicPacketSocketFactory::BasicPacketSocketFactory(NetworkThreadPool* pool)
+    : thread_(NULL), socket_factory_(NULL), pool_(pool) {}
 
 BasicPacketSocketFactory::~BasicPacketSocketFactory() {}
 
@@ -44,7 +49,7 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateUdpSocket(
     uint16_t max_port) {
   // UDP sockets are simple.
   AsyncSocket* socket =
-      socket_factory()->CreateAsyncSocket(address.family(), SOCK_DGRAM);
+      socket_factory(address)->CreateAsyncSocket(address.family(), SOCK_DGRAM);
   if (!socket) {
     return NULL;
   }
@@ -67,8 +72,9 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateServerTcpSocket(
     return NULL;
   }
 
-  AsyncSocket* socket =
-      socket_factory()->CreateAsyncSocket(local_address.family(), SOCK_STREAM);
+  AsyncSocket* socket = socket_factory(local_address)
+                            ->CreateAsyncSocket(local_address.family(),
+                                                SOCK_STREAM);
   if (!socket) {
     return NULL;
   }
@@ -79,6 +85,12 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateServerTcpSocket(
     return NULL;
   }
 
+  return WrapServerTcpSocket(socket, opts);
+}
+
+AsyncPacketSocket* BasicPacketSocketFactory::WrapServerTcpSocket(
+    AsyncSocket* socket,
+    int opts) {
   // If using fake TLS, wrap the TCP socket in a pseudo-SSL socket.
   if (opts & PacketSocketFactory::OPT_TLS_FAKE) {
     RTC_DCHECK(!(opts & PacketSocketFactory::OPT_TLS));
@@ -113,8 +125,9 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateClientTcpSocket(
     const ProxyInfo& proxy_info,
     const std::string& user_agent,
     const PacketSocketTcpOptions& tcp_options) {
-  AsyncSocket* socket =
-      socket_factory()->CreateAsyncSocket(local_address.family(), SOCK_STREAM);
+  AsyncSocket* socket = socket_factory(local_address)
+                            ->CreateAsyncSocket(local_address.family(),
+                                                SOCK_STREAM);
   if (!socket) {
     return NULL;
   }
@@ -202,6 +215,60 @@ AsyncResolverInterface* BasicPacketSocketFactory::CreateAsyncResolver() {
   return new AsyncResolver();
 }
 
+std::vector<std::unique_ptr<AsyncPacketSocket>>
+BasicPacketSocketFactory::CreateReusePortUdpSockets(
+    const SocketAddress& local_address) {
+  std::vector<std::unique_ptr<AsyncPacketSocket>> packet_sockets;
+  for (auto& socket : CreateReusePortSockets(local_address, SOCK_DGRAM))
+    packet_sockets.emplace_back(new AsyncUDPSocket(socket.release()));
+  return packet_sockets;
+}
+
+std::vector<std::unique_ptr<AsyncPacketSocket>>
+BasicPacketSocketFactory::CreateReusePortServerTcpSockets(
+    const SocketAddress& local_address,
+    int opts) {
+  std::vector<std::unique_ptr<AsyncPacketSocket>> packet_sockets;
+  if (opts & PacketSocketFactory::OPT_TLS) {
+    RTC_LOG(LS_ERROR) << "TLS support currently is not available.";
+    return packet_sockets;
+  }
+  for (auto& socket : CreateReusePortSockets(local_address, SOCK_STREAM)) {
+    packet_sockets.emplace_back(
+        WrapServerTcpSocket(socket.release(), opts));
+  }
+  return packet_sockets;
+}
+
+std::vector<std::unique_ptr<AsyncSocket>>
+BasicPacketSocketFactory::CreateReusePortSockets(
+    const SocketAddress& local_address,
+    int type) {
+  RTC_DCHECK(pool_);
+  std::vector<std::unique_ptr<AsyncSocket>> sockets;
+  if (!pool_)
+    return sockets;
+  SocketAddress bind_address = local_address;
+  for (size_t i = 0; i < pool_->size(); ++i) {
+    std::unique_ptr<AsyncSocket> socket(
+        pool_->shard(i)->socketserver()->CreateAsyncSocket(
+            bind_address.family(), type));
+    if (!socket)
+      return std::vector<std::unique_ptr<AsyncSocket>>();
+    if (socket->SetOption(Socket::OPT_REUSEPORT, 1) < 0 ||
+        socket->Bind(bind_address) < 0) {
+      RTC_LOG(LS_ERROR) << "SO_REUSEPORT bind to "
+                        << bind_address.ToSensitiveString()
+                        << " failed with error " << socket->GetError();
+      return std::vector<std::unique_ptr<AsyncSocket>>();
+    }
+    // The remaining shards share whichever port the first socket got.
+    bind_address = socket->GetLocalAddress();
+    sockets.push_back(std::move(socket));
+  }
+  return sockets;
+}
+
 int BasicPacketSocketFactory::BindSocket(AsyncSocket* socket,
                                          const SocketAddress& local_address,
                                          uint16_t min_port,
@@ -219,7 +286,10 @@ int BasicPacketSocketFactory::BindSocket(AsyncSocket* socket,
   return ret;
 }
 
-SocketFactory* BasicPacketSocketFactory::socket_factory() {
+SocketFactory* BasicPacketSocketFactory::socket_factory(
+    const SocketAddress& local_address) {
+  if (pool_)
+    return pool_->SelectShard(local_address)->socketserver();
   if (thread_) {
     RTC_DCHECK(thread_ == Thread::Current());
     return thread_->socketserver();
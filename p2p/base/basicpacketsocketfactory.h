@@ -11,13 +11,16 @@
 #ifndef P2P_BASE_BASICPACKETSOCKETFACTORY_H_
 #define P2P_BASE_BASICPACKETSOCKETFACTORY_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "p2p/base/packetsocketfactory.h"
 
 namespace rtc {
 
 class AsyncSocket;
+class NetworkThreadPool;
 class SocketFactory;
 class Thread;
 
@@ -26,6 +29,9 @@ class BasicPacketSocketFactory : public PacketSocketFactory {
   BasicPacketSocketFactory();
   explicit BasicPacketSocketFactory(Thread* thread);
   explicit BasicPacketSocketFactory(SocketFactory* socket_factory);
+  // Places each new socket on a shard of |pool| picked by the pool's
+  // ShardSelector. The returned sockets signal on their shard's thread.
+  explicit BasicPacketSocketFactory(NetworkThreadPool* pool);
   ~BasicPacketSocketFactory() override;
 
   AsyncPacketSocket* CreateUdpSocket(const SocketAddress& local_address,
@@ -49,16 +55,35 @@ class BasicPacketSocketFactory : public PacketSocketFactory {
 
   AsyncResolverInterface* CreateAsyncResolver() override;
 
+  // Only for factories created with a NetworkThreadPool. Creates one socket
+  // per shard, all bound to the same port with SO_REUSEPORT so that the kernel
+  // spreads incoming flows over the shards; element i lives on
+  // pool->shard(i). If |local_address| has no port, the OS picks one for the
+  // first socket. Returns an empty vector on failure.
+  std::vector<std::unique_ptr<AsyncPacketSocket>> CreateReusePortUdpSockets(
+      const SocketAddress& local_address);
+  std::vector<std::unique_ptr<AsyncPacketSocket>>
+  CreateReusePortServerTcpSockets(const SocketAddress& local_address,
+                                  int opts);
+  // Same as above, but returns the bound sockets of |type| (SOCK_DGRAM or
+  // SOCK_STREAM) as they are, for users which wrap them on their own.
+  std::vector<std::unique_ptr<AsyncSocket>> CreateReusePortSockets(
+      const SocketAddress& local_address,
+      int type);
+
  private:
   int BindSocket(AsyncSocket* socket,
                  const SocketAddress& local_address,
                  uint16_t min_port,
                  uint16_t max_port);
+  // Wraps a bound TCP socket in the packet socket selected by |opts|.
+  AsyncPacketSocket* WrapServerTcpSocket(AsyncSocket* socket, int opts);
 
-  SocketFactory* socket_factory();
+  SocketFactory* socket_factory(const SocketAddress& local_address);
 
   Thread* thread_;
   SocketFactory* socket_factory_;
+  NetworkThreadPool* pool_;
 };
 
 }  // namespace rtc
@@ -141,7 +141,9 @@ DtlsTransport::DtlsTransport(
   ConnectToIceTransport();
 }
 
-DtlsTransport::~DtlsTransport() = default;
+DtlsTransport::~DtlsTransport() {
+  ice_transport_->SetReadPacketCallback(ReadPacketCallback());
+}
 
 const rtc::CryptoOptions& DtlsTransport::crypto_options() const {
   return crypto_options_;
@@ -350,6 +352,8 @@ bool DtlsTransport::SetupDtls() {
   dtls_->SetMode(rtc::SSL_MODE_DTLS);
   dtls_->SetMaxProtocolVersion(ssl_max_version_);
   dtls_->SetServerRole(*dtls_role_);
+  dtls_->set_session_resumption_enabled(
+      crypto_options_.enable_dtls_session_resumption);
   dtls_->SignalEvent.connect(this, &DtlsTransport::OnDtlsEvent);
   dtls_->SignalSSLHandshakeError.connect(this,
                                          &DtlsTransport::OnDtlsHandshakeError);
@@ -466,7 +470,9 @@ void DtlsTransport::ConnectToIceTransport() {
   RTC_DCHECK(ice_transport_);
   ice_transport_->SignalWritableState.connect(this,
                                               &DtlsTransport::OnWritableState);
-  ice_transport_->SignalReadPacket.connect(this, &DtlsTransport::OnReadPacket);
+  ice_transport_->SetReadPacketCallback(
+      ReadPacketCallback::Create<DtlsTransport, &DtlsTransport::OnReadPacket>(
+          this));
   ice_transport_->SignalSentPacket.connect(this, &DtlsTransport::OnSentPacket);
   ice_transport_->SignalReadyToSend.connect(this,
                                             &DtlsTransport::OnReadyToSend);
@@ -542,7 +548,7 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
 
   if (!dtls_active_) {
     // Not doing DTLS.
-    SignalReadPacket(this, data, size, packet_time, 0);
+    NotifyPacketReceived(data, size, packet_time, 0);
     return;
   }
 
@@ -605,7 +611,7 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
         RTC_DCHECK(!srtp_ciphers_.empty());
 
         // Signal this upwards as a bypass packet.
-        SignalReadPacket(this, data, size, packet_time, PF_SRTP_BYPASS);
+        NotifyPacketReceived(data, size, packet_time, PF_SRTP_BYPASS);
       }
       break;
     case DTLS_TRANSPORT_FAILED:
@@ -651,7 +657,7 @@ void DtlsTransport::OnDtlsEvent(rtc::StreamInterface* dtls, int sig, int err) {
     do {
       ret = dtls_->Read(buf, sizeof(buf), &read, &read_error);
       if (ret == rtc::SR_SUCCESS) {
-        SignalReadPacket(this, buf, read, rtc::CreatePacketTime(0), 0);
+        NotifyPacketReceived(buf, read, rtc::CreatePacketTime(0), 0);
       } else if (ret == rtc::SR_EOS) {
         // Remote peer shut down the association with no error.
         RTC_LOG(LS_INFO) << ToString() << ": DTLS transport closed";
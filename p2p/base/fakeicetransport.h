@@ -252,6 +252,12 @@ class FakeIceTransport : public IceTransportInternal {
   void SendPacketInternal(const rtc::CopyOnWriteBuffer& packet) {
     if (dest_) {
       last_sent_packet_ = packet;
+      // A transport reading from |dest_| through the ReadPacketCallback gets
+      // the packet as well as the tests connected to SignalReadPacket.
+      if (dest_->read_packet_callback()) {
+        dest_->read_packet_callback()(dest_, packet.data<char>(), packet.size(),
+                                      rtc::CreatePacketTime(0), 0);
+      }
       dest_->SignalReadPacket(dest_, packet.data<char>(), packet.size(),
                               rtc::CreatePacketTime(0), 0);
     }
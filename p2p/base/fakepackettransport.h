@@ -118,6 +118,12 @@ class FakePacketTransport : public PacketTransportInternal {
   void SendPacketInternal(const CopyOnWriteBuffer& packet) {
     last_sent_packet_ = packet;
     if (dest_) {
+      // A transport reading from |dest_| through the ReadPacketCallback gets
+      // the packet as well as the tests connected to SignalReadPacket.
+      if (dest_->read_packet_callback()) {
+        dest_->read_packet_callback()(dest_, packet.data<char>(), packet.size(),
+                                      CreatePacketTime(0), 0);
+      }
       dest_->SignalReadPacket(dest_, packet.data<char>(), packet.size(),
                               CreatePacketTime(0), 0);
     }
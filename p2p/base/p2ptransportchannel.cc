@@ -186,6 +186,7 @@ void P2PTransportChannel::AddAllocatorSession(
 
 void P2PTransportChannel::AddConnection(Connection* connection) {
   connections_.push_back(connection);
+  connection_ranks_[connection] = next_connection_rank_++;
   unpinged_connections_.insert(connection);
   connection->set_remote_ice_mode(remote_ice_mode_);
   connection->set_receiving_timeout(config_.receiving_timeout);
@@ -1538,16 +1539,21 @@ void P2PTransportChannel::SortConnectionsAndUpdateState(
   // that amongst equal preference, writable connections, this will choose the
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
-  // TODO(honghaiz): Don't sort;  Just use std::max_element in the right places.
-  std::stable_sort(connections_.begin(), connections_.end(),
-                   [this](const Connection* a, const Connection* b) {
-                     int cmp = CompareConnections(a, b, absl::nullopt, nullptr);
-                     if (cmp != 0) {
-                       return cmp > 0;
-                     }
-                     // Otherwise, sort based on latency estimate.
-                     return a->rtt() < b->rtt();
-                   });
+  // Most events change the order of few connections, if any, so the sort is
+  // skipped when the connections are still in order, which only takes one
+  // comparison per connection.
+  auto better = [this](const Connection* a, const Connection* b) {
+    int cmp = CompareConnections(a, b, absl::nullopt, nullptr);
+    if (cmp != 0) {
+      return cmp > 0;
+    }
+    // Otherwise, sort based on latency estimate.
+    return a->rtt() < b->rtt();
+  };
+  if (!std::is_sorted(connections_.begin(), connections_.end(), better)) {
+    std::stable_sort(connections_.begin(), connections_.end(), better);
+    UpdateConnectionRanks();
+  }
 
   RTC_LOG(LS_VERBOSE) << "Sorting " << connections_.size()
                       << " available connections";
@@ -1631,6 +1637,13 @@ P2PTransportChannel::GetBestWritableConnectionPerNetwork() const {
   return connections;
 }
 
+void P2PTransportChannel::UpdateConnectionRanks() {
+  next_connection_rank_ = 0;
+  for (const Connection* conn : connections_) {
+    connection_ranks_[conn] = next_connection_rank_++;
+  }
+}
+
 void P2PTransportChannel::PruneConnections() {
   // We can prune any connection for which there is a connected, writable
   // connection on the same network with better or equal priority.  We leave
@@ -1994,20 +2007,21 @@ Connection* P2PTransportChannel::FindNextPingableConnection() {
   // Otherwise, treat everything as unpinged.
   // TODO(honghaiz): Instead of adding two separate vectors, we can add a state
   // "pinged" to filter out unpinged connections.
-  if (std::find_if(unpinged_connections_.begin(), unpinged_connections_.end(),
-                   [this, now](Connection* conn) {
-                     return this->IsPingable(conn, now);
-                   }) == unpinged_connections_.end()) {
+  std::vector<Connection*> pingable_connections;
+  std::copy_if(unpinged_connections_.begin(), unpinged_connections_.end(),
+               std::back_inserter(pingable_connections),
+               [this, now](Connection* conn) { return IsPingable(conn, now); });
+  if (pingable_connections.empty() && !pinged_connections_.empty()) {
     unpinged_connections_.insert(pinged_connections_.begin(),
                                  pinged_connections_.end());
     pinged_connections_.clear();
+    std::copy_if(
+        unpinged_connections_.begin(), unpinged_connections_.end(),
+        std::back_inserter(pingable_connections),
+        [this, now](Connection* conn) { return IsPingable(conn, now); });
   }
 
   // Among un-pinged pingable connections, "more pingable" takes precedence.
-  std::vector<Connection*> pingable_connections;
-  std::copy_if(unpinged_connections_.begin(), unpinged_connections_.end(),
-               std::back_inserter(pingable_connections),
-               [this, now](Connection* conn) { return IsPingable(conn, now); });
   auto iter =
       std::max_element(pingable_connections.begin(), pingable_connections.end(),
                        [this](Connection* conn1, Connection* conn2) {
@@ -2131,6 +2145,7 @@ void P2PTransportChannel::OnConnectionDestroyed(Connection* connection) {
   RTC_DCHECK(iter != connections_.end());
   pinged_connections_.erase(*iter);
   unpinged_connections_.erase(*iter);
+  connection_ranks_.erase(*iter);
   connections_.erase(iter);
 
   RTC_LOG(LS_INFO) << ToString() << ": Removed connection " << connection
@@ -2226,7 +2241,7 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
     return;
 
   // Let the client know of an incoming packet
-  SignalReadPacket(this, data, len, packet_time, 0);
+  NotifyPacketReceived(data, len, packet_time, 0);
 
   // May need to switch the sending connection based on the receiving media path
   // if this is the controlled side.
@@ -2255,16 +2270,15 @@ Connection* P2PTransportChannel::FindOldestConnectionNeedingTriggeredCheck(
     int64_t now) {
   Connection* oldest_needing_triggered_check = nullptr;
   for (auto* conn : connections_) {
-    if (!IsPingable(conn, now)) {
-      continue;
-    }
+    // IsPingable() costs more than these checks, so it is done last.
     bool needs_triggered_check =
         (!conn->writable() &&
          conn->last_ping_received() > conn->last_ping_sent());
     if (needs_triggered_check &&
         (!oldest_needing_triggered_check ||
          (conn->last_ping_received() <
-          oldest_needing_triggered_check->last_ping_received()))) {
+          oldest_needing_triggered_check->last_ping_received())) &&
+        IsPingable(conn, now)) {
       oldest_needing_triggered_check = conn;
     }
   }
@@ -2324,10 +2338,8 @@ Connection* P2PTransportChannel::MorePingable(Connection* conn1,
 
   // During the initial state when nothing has been pinged yet, return the first
   // one in the ordered |connections_|.
-  return *(std::find_if(connections_.begin(), connections_.end(),
-                        [conn1, conn2](Connection* conn) {
-                          return conn == conn1 || conn == conn2;
-                        }));
+  RTC_DCHECK(connection_ranks_.count(conn1) && connection_ranks_.count(conn2));
+  return connection_ranks_[conn1] < connection_ranks_[conn2] ? conn1 : conn2;
 }
 
 void P2PTransportChannel::set_writable(bool writable) {
@@ -25,6 +25,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "api/asyncresolverfactory.h"
@@ -323,6 +324,8 @@ class P2PTransportChannel : public IceTransportInternal {
   std::vector<Connection*> GetBestWritableConnectionPerNetwork() const;
   void PruneConnections();
   bool IsBackupConnection(const Connection* conn) const;
+  // Renumbers |connection_ranks_| after |connections_| is reordered.
+  void UpdateConnectionRanks();
 
   Connection* FindOldestConnectionNeedingTriggeredCheck(int64_t now);
   // Between |conn1| and |conn2|, this function returns the one which should
@@ -388,6 +391,12 @@ class P2PTransportChannel : public IceTransportInternal {
   std::vector<Connection*> connections_;
   std::set<Connection*> pinged_connections_;
   std::set<Connection*> unpinged_connections_;
+  // The position of each connection in |connections_|, without rescanning it,
+  // which breaks the ties between connections when choosing one to ping. Only
+  // the order of the ranks matters, so a removed connection leaves a gap and
+  // an added one ranks last until the next sort.
+  std::unordered_map<const Connection*, uint64_t> connection_ranks_;
+  uint64_t next_connection_rank_ = 0;
 
   Connection* selected_connection_ = nullptr;
 
@@ -10,6 +10,8 @@
 
 #include "p2p/base/packettransportinternal.h"
 
+#include "rtc_base/checks.h"
+
 namespace rtc {
 
 PacketTransportInternal::PacketTransportInternal() = default;
@@ -28,4 +30,24 @@ absl::optional<NetworkRoute> PacketTransportInternal::network_route() const {
   return absl::optional<NetworkRoute>();
 }
 
+void PacketTransportInternal::SetReadPacketCallback(
+    ReadPacketCallback callback) {
+  RTC_DCHECK(!callback || !read_packet_callback_ ||
+             callback == read_packet_callback_)
+      << "A transport has a single ReadPacketCallback.";
+  read_packet_callback_ = callback;
+}
+
+void PacketTransportInternal::NotifyPacketReceived(
+    const char* data,
+    size_t len,
+    const rtc::PacketTime& packet_time,
+    int flags) {
+  if (read_packet_callback_) {
+    read_packet_callback_(this, data, len, packet_time, flags);
+    return;
+  }
+  SignalReadPacket(this, data, len, packet_time, flags);
+}
+
 }  // namespace rtc
@@ -19,6 +19,7 @@
 #include "api/ortc/packettransportinterface.h"
 #include "p2p/base/port.h"
 #include "rtc_base/asyncpacketsocket.h"
+#include "rtc_base/methodcallback.h"
 #include "rtc_base/networkroute.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
@@ -31,6 +32,12 @@ struct SentPacket;
 class PacketTransportInternal : public virtual webrtc::PacketTransportInterface,
                                 public sigslot::has_slots<> {
  public:
+  using ReadPacketCallback = MethodCallback<void(PacketTransportInternal*,
+                                                 const char*,
+                                                 size_t,
+                                                 const rtc::PacketTime&,
+                                                 int)>;
+
   virtual const std::string& transport_name() const = 0;
 
   // The transport has been established.
@@ -81,7 +88,16 @@ class PacketTransportInternal : public virtual webrtc::PacketTransportInterface,
   // Emitted when receiving state changes to true.
   sigslot::signal1<PacketTransportInternal*> SignalReceivingState;
 
-  // Signalled each time a packet is received on this channel.
+  // Makes |callback| the receiver of the packets received on this channel,
+  // which are then passed to it instead of being emitted through
+  // SignalReadPacket. For the transport stacked on top of this one on the
+  // media path, where the cost of the signal shows; an empty callback
+  // restores SignalReadPacket. The receiver must reset the callback before it
+  // is destroyed.
+  void SetReadPacketCallback(ReadPacketCallback callback);
+
+  // Signalled each time a packet is received on this channel, unless a
+  // ReadPacketCallback is set.
   sigslot::signal5<PacketTransportInternal*,
                    const char*,
                    size_t,
@@ -101,6 +117,20 @@ class PacketTransportInternal : public virtual webrtc::PacketTransportInterface,
   ~PacketTransportInternal() override;
 
   PacketTransportInternal* GetInternal() override;
+
+  // Passes a received packet to the ReadPacketCallback, or emits
+  // SignalReadPacket if there is none.
+  void NotifyPacketReceived(const char* data,
+                            size_t len,
+                            const rtc::PacketTime& packet_time,
+                            int flags);
+
+  const ReadPacketCallback& read_packet_callback() const {
+    return read_packet_callback_;
+  }
+
+ private:
+  ReadPacketCallback read_packet_callback_;
 };
 
 }  // namespace rtc
@@ -266,6 +266,7 @@ Port::Port(rtc::Thread* thread,
       generation_(0),
       ice_username_fragment_(username_fragment),
       password_(password),
+      ping_timeouts_(thread),
       timeout_delay_(kPortTimeoutDelay),
       enable_port_packets_(false),
       ice_role_(ICEROLE_UNKNOWN),
@@ -293,6 +294,7 @@ Port::Port(rtc::Thread* thread,
       generation_(0),
       ice_username_fragment_(username_fragment),
       password_(password),
+      ping_timeouts_(thread),
       timeout_delay_(kPortTimeoutDelay),
       enable_port_packets_(false),
       ice_role_(ICEROLE_UNKNOWN),
@@ -567,7 +569,8 @@ bool Port::GetStunMessage(const char* data,
     }
 
     // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401 Unauthorized
-    if (!stun_msg->ValidateMessageIntegrity(data, size, password_)) {
+    password_key_.SetKey(password_);
+    if (!StunMessage::ValidateMessageIntegrity(data, size, &password_key_)) {
       RTC_LOG(LS_ERROR) << ToString()
                         << ": Received STUN request with bad M-I from "
                         << addr.ToSensitiveString()
@@ -1069,6 +1072,7 @@ Connection::Connection(Port* port,
   // TODO(mallinath) - Start connections from STATE_FROZEN.
   // Wire up to send stun packets
   requests_.SignalSendPacket.connect(this, &Connection::OnSendStunPacket);
+  requests_.set_timeouts(&port->ping_timeouts_);
   RTC_LOG(LS_INFO) << ToString() << ": Connection created";
 }
 
@@ -1247,8 +1251,9 @@ void Connection::OnReadPacket(const char* data,
       // id's match.
       case STUN_BINDING_RESPONSE:
       case STUN_BINDING_ERROR_RESPONSE:
-        if (msg->ValidateMessageIntegrity(data, size,
-                                          remote_candidate().password())) {
+        remote_password_key_.SetKey(remote_candidate().password());
+        if (StunMessage::ValidateMessageIntegrity(data, size,
+                                                  &remote_password_key_)) {
           requests_.CheckResponse(msg.get());
         }
         // Otherwise silently discard the response message.
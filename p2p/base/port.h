@@ -405,6 +405,10 @@ class Port : public PortInterface,
                   const std::string& url,
                   bool final);
 
+  // Forgets the candidates, so that they can be added again with the current
+  // ICE parameters, component and generation.
+  void ClearCandidates() { candidates_.clear(); }
+
   // Adds the given connection to the map keyed by the remote candidate address.
   // If an existing connection has the same address, the existing one will be
   // replaced and destroyed.
@@ -470,8 +474,13 @@ class Port : public PortInterface,
   // username_fragment().
   std::string ice_username_fragment_;
   std::string password_;
+  // The key schedule for |password_|, which validates the binding requests of
+  // all the connections.
+  StunMessageIntegrityKey password_key_;
   std::vector<Candidate> candidates_;
   AddressMap connections_;
+  // Times out the pings of all the connections with one timer.
+  StunRequestTimeouts ping_timeouts_;
   int timeout_delay_;
   bool enable_port_packets_;
   IceRole ice_role_;
@@ -750,6 +759,9 @@ class Connection : public CandidatePairInterface,
   Port* port_;
   size_t local_candidate_index_;
   Candidate remote_candidate_;
+  // The key schedule for the password of |remote_candidate_|, which validates
+  // the binding responses.
+  StunMessageIntegrityKey remote_password_key_;
 
   ConnectionInfo stats_;
   rtc::RateTracker recv_rate_tracker_;
@@ -77,6 +77,15 @@ enum {
   // Exclude link-local network interfaces
   // from considertaion after adapter enumeration.
   PORTALLOCATOR_DISABLE_LINK_LOCAL_NETWORKS = 0x8000,
+
+  // Start the UDP, relay and TCP phases of the allocation on each network at
+  // once, instead of a step delay apart. The hostnames of the STUN and TURN
+  // servers are resolved once per session while the networks are enumerated,
+  // rather than by each port, and the allocation waits for them for up to
+  // kMaxServerResolveDelay. Used with a candidate pool (see
+  // PortAllocator::SetConfiguration), this makes the TURN allocations before
+  // the offer/answer.
+  PORTALLOCATOR_ENABLE_PARALLEL_GATHERING = 0x10000,
 };
 
 // Defines various reasons that have caused ICE regathering.
@@ -94,6 +103,11 @@ const uint32_t kDefaultStepDelay = 1000;  // 1 sec step delay.
 // internal. Less than 20ms is not acceptable. We choose 50ms as our default.
 const uint32_t kMinimumStepDelay = 50;
 
+// The longest that PORTALLOCATOR_ENABLE_PARALLEL_GATHERING delays the
+// allocation to resolve the server hostnames. The ports resolve the hostnames
+// that are not resolved by then themselves.
+const int kMaxServerResolveDelay = 500;
+
 // Turning on IPv6 could make many IPv6 interfaces available for connectivity
 // check and delay the call setup time. kDefaultMaxIPv6Networks is the default
 // upper limit of IPv6 networks but could be changed by
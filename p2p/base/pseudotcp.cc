@@ -14,8 +14,11 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "rtc_base/arraysize.h"
 #include "rtc_base/bytebuffer.h"
@@ -115,6 +118,9 @@ const uint32_t DEF_ACK_DELAY = 100;  // 100 milliseconds
 
 const uint8_t FLAG_CTL = 0x02;
 const uint8_t FLAG_RST = 0x04;
+// The payload of the segment is a list of SACK blocks rather than data. Only
+// sent on ACKs to peers that specified TCP_OPT_SACK_PERMITTED.
+const uint8_t FLAG_SACK = 0x08;
 
 const uint8_t CTL_CONNECT = 0;
 
@@ -123,6 +129,15 @@ const uint8_t TCP_OPT_EOL = 0;        // End of list.
 const uint8_t TCP_OPT_NOOP = 1;       // No-op.
 const uint8_t TCP_OPT_MSS = 2;        // Maximum segment size.
 const uint8_t TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8_t TCP_OPT_SACK_PERMITTED = 4;  // Selective ACKs supported.
+
+// Each SACK block is the left and right edge of a range of received data.
+const uint32_t SACK_BLOCK_SIZE = 8;
+const uint32_t MAX_SACK_BLOCKS = 8;
+
+// CUBIC parameters (RFC 8312, Sec. 5).
+const double CUBIC_C = 0.4;
+const double CUBIC_BETA = 0.7;
 
 const long DEFAULT_TIMEOUT =
     4000;  // If there are no pending clocks, wake up every 4 seconds
@@ -247,6 +262,13 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
   m_dup_acks = 0;
   m_recover = 0;
 
+  m_sack_enabled = false;
+  m_sack_high = m_sack_rexmit_nxt = 0;
+
+  m_use_cubic = false;
+  m_cubic_wmax = m_cubic_origin = m_cubic_epoch = 0;
+  m_cubic_k = 0;
+
   m_ts_recent = m_ts_lastack = 0;
 
   m_rx_rto = DEF_RTO;
@@ -255,6 +277,7 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
   m_use_nagling = true;
   m_ack_delay = DEF_ACK_DELAY;
   m_support_wnd_scale = true;
+  m_support_sack = true;
 }
 
 PseudoTcp::~PseudoTcp() {}
@@ -304,11 +327,18 @@ void PseudoTcp::NotifyClock(uint32_t now) {
       }
 
       uint32_t nInFlight = m_snd_nxt - m_snd_una;
-      m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+      m_ssthresh = onCongestionEvent(nInFlight);
       // RTC_LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " <<
       // nInFlight << "  m_mss: " << m_mss;
       m_cwnd = m_mss;
 
+      // The receiver may have discarded the data that it SACKed (RFC 2018,
+      // Sec. 8), so it is retransmitted too.
+      for (SSegment& sseg : m_slist) {
+        sseg.sacked = false;
+      }
+      m_sack_high = m_sack_rexmit_nxt = m_snd_una;
+
       // Back off retransmit timer.  Note: the limit is lower when connecting.
       uint32_t rto_limit = (m_state < TCP_ESTABLISHED) ? DEF_RTO : MAX_RTO;
       m_rx_rto = std::min(rto_limit, m_rx_rto * 2);
@@ -374,6 +404,8 @@ void PseudoTcp::GetOption(Option opt, int* value) {
     *value = m_sbuf_len;
   } else if (opt == OPT_RCVBUF) {
     *value = m_rbuf_len;
+  } else if (opt == OPT_CUBIC) {
+    *value = m_use_cubic ? 1 : 0;
   } else {
     RTC_NOTREACHED();
   }
@@ -389,6 +421,8 @@ void PseudoTcp::SetOption(Option opt, int value) {
   } else if (opt == OPT_RCVBUF) {
     RTC_DCHECK(m_state == TCP_LISTEN);
     resizeReceiveBuffer(value);
+  } else if (opt == OPT_CUBIC) {
+    m_use_cubic = value != 0;
   } else {
     RTC_NOTREACHED();
   }
@@ -517,7 +551,27 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 
   uint32_t now = Now();
 
-  std::unique_ptr<uint8_t[]> buffer(new uint8_t[MAX_PACKET]);
+  // Report the data received out of order on ACKs, merging adjacent ranges.
+  std::vector<std::pair<uint32_t, uint32_t>> sack_blocks;
+  if (m_sack_enabled && (len == 0) && (flags == 0)) {
+    for (const RSegment& rseg : m_rlist) {
+      if (!sack_blocks.empty() && (rseg.seq <= sack_blocks.back().second)) {
+        sack_blocks.back().second =
+            std::max(sack_blocks.back().second, rseg.seq + rseg.len);
+      } else if (sack_blocks.size() < MAX_SACK_BLOCKS) {
+        sack_blocks.emplace_back(rseg.seq, rseg.seq + rseg.len);
+      } else {
+        break;
+      }
+    }
+    if (!sack_blocks.empty()) {
+      flags |= FLAG_SACK;
+    }
+  }
+  uint32_t sack_len =
+      static_cast<uint32_t>(sack_blocks.size()) * SACK_BLOCK_SIZE;
+
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[HEADER_SIZE + len + sack_len]);
   long_to_bytes(m_conv, buffer.get());
   long_to_bytes(seq, buffer.get() + 4);
   long_to_bytes(m_rcv_nxt, buffer.get() + 8);
@@ -538,6 +592,11 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
     RTC_DCHECK(result == rtc::SR_SUCCESS);
     RTC_DCHECK(static_cast<uint32_t>(bytes_read) == len);
   }
+  for (size_t i = 0; i < sack_blocks.size(); ++i) {
+    uint8_t* block = buffer.get() + HEADER_SIZE + i * SACK_BLOCK_SIZE;
+    long_to_bytes(sack_blocks[i].first, block);
+    long_to_bytes(sack_blocks[i].second, block + 4);
+  }
 
 #if _DEBUGMSG >= _DBG_VERBOSE
   RTC_LOG(LS_INFO) << "<-- <CONV=" << m_conv
@@ -550,7 +609,8 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 #endif  // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char*>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char*>(buffer.get()),
+      len + sack_len + HEADER_SIZE);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value
   // for those, and thus we won't retry.  So go ahead and treat the packet as a
   // success (basically simulate as if it were dropped), which will prevent our
@@ -585,6 +645,14 @@ bool PseudoTcp::parse(const uint8_t* buffer, uint32_t size) {
   seg.data = reinterpret_cast<const char*>(buffer) + HEADER_SIZE;
   seg.len = size - HEADER_SIZE;
 
+  seg.sack = NULL;
+  seg.num_sack = 0;
+  if (seg.flags & FLAG_SACK) {
+    seg.sack = seg.data;
+    seg.num_sack = seg.len / SACK_BLOCK_SIZE;
+    seg.len = 0;
+  }
+
 #if _DEBUGMSG >= _DBG_VERBOSE
   RTC_LOG(LS_INFO) << "--> <CONV=" << seg.conv
                    << "><FLG=" << static_cast<unsigned>(seg.flags)
@@ -705,6 +773,8 @@ bool PseudoTcp::process(Segment& seg) {
     m_ts_recent = seg.tsval;
   }
 
+  applySackBlocks(seg);
+
   // Check if this is a valuable ack
   if ((seg.ack > m_snd_una) && (seg.ack <= m_snd_nxt)) {
     // Calculate round-trip time
@@ -768,10 +838,18 @@ bool PseudoTcp::process(Segment& seg) {
 #if _DEBUGMSG >= _DBG_NORMAL
         RTC_LOG(LS_INFO) << "recovery retransmit";
 #endif  // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
+        // With SACK, the next segment may have been retransmitted already,
+        // on a duplicate ack.
+        bool bRetransmitted =
+            m_sack_enabled && (m_slist.front().seq < m_sack_rexmit_nxt);
+        if (bRetransmitted ? !retransmitSackHole(now)
+                           : !transmit(m_slist.begin(), now)) {
           closedown(ECONNABORTED);
           return false;
         }
+        if (!bRetransmitted) {
+          m_sack_rexmit_nxt = m_slist.front().seq + m_slist.front().len;
+        }
         m_cwnd += m_mss - std::min(nAcked, m_cwnd);
       }
     } else {
@@ -780,7 +858,7 @@ bool PseudoTcp::process(Segment& seg) {
       if (m_cwnd < m_ssthresh) {
         m_cwnd += m_mss;
       } else {
-        m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / m_cwnd);
+        growCongestionWindow(now);
       }
     }
   } else if (seg.ack == m_snd_una) {
@@ -792,7 +870,11 @@ bool PseudoTcp::process(Segment& seg) {
     if (seg.len > 0) {
       // it's a dup ack, but with a data payload, so don't modify m_dup_acks
     } else if (m_snd_una != m_snd_nxt) {
-      m_dup_acks += 1;
+      // Saturate, so that a large window doesn't wrap around into another
+      // fast retransmit.
+      if (m_dup_acks < 0xFF) {
+        m_dup_acks += 1;
+      }
       if (m_dup_acks == 3) {  // (Fast Retransmit)
 #if _DEBUGMSG >= _DBG_NORMAL
         RTC_LOG(LS_INFO) << "enter recovery";
@@ -803,13 +885,20 @@ bool PseudoTcp::process(Segment& seg) {
           return false;
         }
         m_recover = m_snd_nxt;
+        m_sack_rexmit_nxt = m_slist.front().seq + m_slist.front().len;
         uint32_t nInFlight = m_snd_nxt - m_snd_una;
-        m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+        m_ssthresh = onCongestionEvent(nInFlight);
         // RTC_LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: "
         // << nInFlight << "  m_mss: " << m_mss;
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
         m_cwnd += m_mss;
+        // Repair the other losses of the window without waiting for their
+        // partial acks.
+        if (m_sack_enabled && !retransmitSackHole(now)) {
+          closedown(ECONNABORTED);
+          return false;
+        }
       }
     } else {
       m_dup_acks = 0;
@@ -1059,11 +1148,100 @@ bool PseudoTcp::transmit(const SList::iterator& seg, uint32_t now) {
   return true;
 }
 
+void PseudoTcp::applySackBlocks(const Segment& seg) {
+  for (uint32_t i = 0; i < seg.num_sack; ++i) {
+    const char* block = seg.sack + i * SACK_BLOCK_SIZE;
+    uint32_t left = bytes_to_long(block);
+    uint32_t right = bytes_to_long(block + 4);
+    if ((left >= right) || (left < m_snd_una) || (right > m_snd_nxt)) {
+      continue;
+    }
+    m_sack_high = std::max(m_sack_high, right);
+    for (SSegment& sseg : m_slist) {
+      if (sseg.seq >= right) {
+        break;
+      }
+      if ((sseg.seq >= left) && (sseg.seq + sseg.len <= right)) {
+        sseg.sacked = true;
+      }
+    }
+  }
+}
+
+bool PseudoTcp::retransmitSackHole(uint32_t now) {
+  for (SList::iterator it = m_slist.begin(); it != m_slist.end(); ++it) {
+    if ((it->xmit == 0) || (it->seq + it->len > m_sack_high)) {
+      break;
+    }
+    if (!it->sacked && (it->seq >= m_sack_rexmit_nxt)) {
+#if _DEBUGMSG >= _DBG_NORMAL
+      RTC_LOG(LS_INFO) << "sack retransmit";
+#endif  // _DEBUGMSG
+      if (!transmit(it, now)) {
+        return false;
+      }
+      m_sack_rexmit_nxt = it->seq + it->len;
+      return true;
+    }
+  }
+  return true;
+}
+
+uint32_t PseudoTcp::onCongestionEvent(uint32_t nInFlight) {
+  if (!m_use_cubic) {
+    return std::max(nInFlight / 2, 2 * m_mss);
+  }
+  // Fast convergence: release bandwidth to new flows when the window didn't
+  // grow back to its previous maximum.
+  if (nInFlight < m_cubic_wmax) {
+    m_cubic_wmax = static_cast<uint32_t>(nInFlight * (1 + CUBIC_BETA) / 2);
+  } else {
+    m_cubic_wmax = nInFlight;
+  }
+  m_cubic_epoch = 0;
+  return std::max(static_cast<uint32_t>(nInFlight * CUBIC_BETA), 2 * m_mss);
+}
+
+void PseudoTcp::growCongestionWindow(uint32_t now) {
+  if (!m_use_cubic) {
+    m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / m_cwnd);
+    return;
+  }
+  if (m_cubic_epoch == 0) {
+    m_cubic_epoch = now;
+    if (m_cwnd < m_cubic_wmax) {
+      m_cubic_k = std::cbrt(static_cast<double>(m_cubic_wmax - m_cwnd) /
+                            m_mss / CUBIC_C);
+      m_cubic_origin = m_cubic_wmax;
+    } else {
+      m_cubic_k = 0;
+      m_cubic_origin = m_cwnd;
+    }
+  }
+  // The window that CUBIC targets one RTT from now, or that NewReno would
+  // have reached if it is larger (RFC 8312, Sec. 4.2).
+  uint32_t rtt = std::max<uint32_t>(m_rx_srtt, 1);
+  double t = rtc::TimeDiff32(now, m_cubic_epoch) / 1000.0;
+  double offset = t + rtt / 1000.0 - m_cubic_k;
+  double target = m_cubic_origin + CUBIC_C * offset * offset * offset * m_mss;
+  double reno = m_cubic_wmax * CUBIC_BETA +
+                3 * (1 - CUBIC_BETA) / (1 + CUBIC_BETA) * t * 1000.0 / rtt *
+                    m_mss;
+  target = std::max(target, reno);
+  if (target > m_cwnd) {
+    m_cwnd += std::max<uint32_t>(
+        1, static_cast<uint32_t>((target - m_cwnd) * m_mss / m_cwnd));
+  } else {
+    m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / (100 * m_cwnd));
+  }
+}
+
 void PseudoTcp::attemptSend(SendFlags sflags) {
   uint32_t now = Now();
 
   if (rtc::TimeDiff32(now, m_lastsend) > static_cast<long>(m_rx_rto)) {
     m_cwnd = m_mss;
+    m_cubic_epoch = 0;
   }
 
 #if _DEBUGMSG
@@ -1190,6 +1368,14 @@ void PseudoTcp::disableWindowScale() {
   m_support_wnd_scale = false;
 }
 
+void PseudoTcp::disableSack() {
+  m_support_sack = false;
+}
+
+bool PseudoTcp::isSackEnabled() const {
+  return m_sack_enabled;
+}
+
 void PseudoTcp::queueConnectMessage() {
   rtc::ByteBufferWriter buf(rtc::ByteBuffer::ORDER_NETWORK);
 
@@ -1199,6 +1385,10 @@ void PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_support_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32_t>(buf.Length());
   queue(buf.Data(), static_cast<uint32_t>(buf.Length()), true);
 }
@@ -1237,6 +1427,10 @@ void PseudoTcp::parseOptions(const char* data, uint32_t len) {
     options_specified.insert(kind);
   }
 
+  m_sack_enabled = m_support_sack && (options_specified.find(
+                                          TCP_OPT_SACK_PERMITTED) !=
+                                      options_specified.end());
+
   if (options_specified.find(TCP_OPT_WND_SCALE) == options_specified.end()) {
     RTC_LOG(LS_WARNING) << "Peer doesn't support window scaling";
 
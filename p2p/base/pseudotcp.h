@@ -93,6 +93,8 @@ class PseudoTcp {
     OPT_ACKDELAY,  // The Delayed ACK timeout (0 == off).
     OPT_RCVBUF,    // Set the receive buffer size, in bytes.
     OPT_SNDBUF,    // Set the send buffer size, in bytes.
+    OPT_CUBIC,     // Whether to use CUBIC congestion control instead of
+                   // NewReno (0 == off).
   };
   void GetOption(Option opt, int* value);
   void SetOption(Option opt, int value);
@@ -121,15 +123,20 @@ class PseudoTcp {
     const char* data;
     uint32_t len;
     uint32_t tsval, tsecr;
+    // SACK blocks of an ACK, as pairs of 32-bit sequence numbers.
+    const char* sack;
+    uint32_t num_sack;
   };
 
   struct SSegment {
     SSegment(uint32_t s, uint32_t l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {}
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), sacked(false) {}
     uint32_t seq, len;
     // uint32_t tstamp;
     uint8_t xmit;
     bool bCtrl;
+    // Whether the receiver has reported the segment in a SACK block.
+    bool sacked;
   };
   typedef std::list<SSegment> SList;
 
@@ -162,6 +169,20 @@ class PseudoTcp {
   bool process(Segment& seg);
   bool transmit(const SList::iterator& seg, uint32_t now);
 
+  // Marks the segments covered by the SACK blocks of |seg| as received.
+  void applySackBlocks(const Segment& seg);
+
+  // Retransmits the first segment below the highest SACKed sequence number
+  // that hasn't been received or retransmitted since the recovery started.
+  bool retransmitSackHole(uint32_t now);
+
+  // Updates the congestion control state on a loss with |nInFlight| bytes in
+  // flight, and returns the new slow start threshold.
+  uint32_t onCongestionEvent(uint32_t nInFlight);
+
+  // Increases the congestion window for an ACK in congestion avoidance.
+  void growCongestionWindow(uint32_t now);
+
   void adjustMTU();
 
  protected:
@@ -172,6 +193,13 @@ class PseudoTcp {
   // support for testing backward compatibility.
   void disableWindowScale();
 
+  // This method is only used in tests, to disable SACK support for testing
+  // backward compatibility.
+  void disableSack();
+
+  // This method is used in test only to query whether both sides use SACK.
+  bool isSackEnabled() const;
+
  private:
   // Queue the connect message with TCP options.
   void queueConnectMessage();
@@ -232,6 +260,20 @@ class PseudoTcp {
   uint32_t m_recover;
   uint32_t m_t_ack;
 
+  // Selective acknowledgments (RFC 2018). |m_sack_high| is the highest
+  // sequence number that the receiver has SACKed, and |m_sack_rexmit_nxt|
+  // the end of the last segment retransmitted in the current recovery.
+  bool m_sack_enabled;
+  uint32_t m_sack_high, m_sack_rexmit_nxt;
+
+  // CUBIC congestion control (RFC 8312). |m_cubic_epoch| is the time at
+  // which the current congestion avoidance period started, or 0, and
+  // |m_cubic_k| the time in seconds that the window takes to grow back to
+  // |m_cubic_origin|.
+  bool m_use_cubic;
+  uint32_t m_cubic_wmax, m_cubic_origin, m_cubic_epoch;
+  double m_cubic_k;
+
   // Configuration options
   bool m_use_nagling;
   uint32_t m_ack_delay;
@@ -239,6 +281,10 @@ class PseudoTcp {
   // This is used by unit tests to test backward compatibility of
   // PseudoTcp implementations that don't support window scaling.
   bool m_support_wnd_scale;
+
+  // This is used by unit tests to test backward compatibility of
+  // PseudoTcp implementations that don't support SACK.
+  bool m_support_sack;
 };
 
 }  // namespace cricket
@@ -10,9 +10,11 @@
 
 #include <algorithm>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "p2p/base/pseudotcp.h"
+#include "rtc_base/fakeclock.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/helpers.h"
 #include "rtc_base/messagehandler.h"
@@ -24,6 +26,7 @@ using cricket::PseudoTcp;
 
 static const int kConnectTimeoutMs = 10000;  // ~3 * default RTO of 3000ms
 static const int kTransferTimeoutMs = 15000;
+static const int kSimulatedTransferTimeoutMs = 120000;
 static const int kBlockSize = 4096;
 
 class PseudoTcpForTest : public cricket::PseudoTcp {
@@ -34,6 +37,10 @@ class PseudoTcpForTest : public cricket::PseudoTcp {
   bool isReceiveBufferFull() const { return PseudoTcp::isReceiveBufferFull(); }
 
   void disableWindowScale() { PseudoTcp::disableWindowScale(); }
+
+  void disableSack() { PseudoTcp::disableSack(); }
+
+  bool isSackEnabled() const { return PseudoTcp::isSackEnabled(); }
 };
 
 class PseudoTcpTestBase : public testing::Test,
@@ -94,6 +101,11 @@ class PseudoTcpTestBase : public testing::Test,
   }
   void DisableRemoteWindowScale() { remote_.disableWindowScale(); }
   void DisableLocalWindowScale() { local_.disableWindowScale(); }
+  void DisableRemoteSack() { remote_.disableSack(); }
+  void SetOptCubic(bool enable_cubic) {
+    local_.SetOption(PseudoTcp::OPT_CUBIC, enable_cubic);
+    remote_.SetOption(PseudoTcp::OPT_CUBIC, enable_cubic);
+  }
 
  protected:
   int Connect() {
@@ -227,7 +239,9 @@ class PseudoTcpTestBase : public testing::Test,
 
 class PseudoTcpTest : public PseudoTcpTestBase {
  public:
-  void TestTransfer(int size) {
+  // Returns the throughput in Kbps. If |fake_clock| is set, the transfer runs
+  // on simulated time.
+  int TestTransfer(int size, rtc::ScopedFakeClock* fake_clock = nullptr) {
     uint32_t start;
     int32_t elapsed;
     size_t received;
@@ -243,11 +257,18 @@ class PseudoTcpTest : public PseudoTcpTestBase {
     // Connect and wait until connected.
     start = rtc::Time32();
     EXPECT_EQ(0, Connect());
-    EXPECT_TRUE_WAIT(have_connected_, kConnectTimeoutMs);
-    // Sending will start from OnTcpWriteable and complete when all data has
-    // been received.
-    EXPECT_TRUE_WAIT(have_disconnected_, kTransferTimeoutMs);
-    elapsed = rtc::Time32() - start;
+    if (fake_clock) {
+      EXPECT_TRUE_SIMULATED_WAIT(have_connected_, kConnectTimeoutMs,
+                                 *fake_clock);
+      EXPECT_TRUE_SIMULATED_WAIT(have_disconnected_,
+                                 kSimulatedTransferTimeoutMs, *fake_clock);
+    } else {
+      EXPECT_TRUE_WAIT(have_connected_, kConnectTimeoutMs);
+      // Sending will start from OnTcpWriteable and complete when all data has
+      // been received.
+      EXPECT_TRUE_WAIT(have_disconnected_, kTransferTimeoutMs);
+    }
+    elapsed = std::max<int32_t>(rtc::Time32() - start, 1);
     recv_stream_.GetSize(&received);
     // Ensure we closed down OK and we got the right data.
     // TODO(?): Ensure the errors are cleared properly.
@@ -258,6 +279,7 @@ class PseudoTcpTest : public PseudoTcpTestBase {
               memcmp(send_stream_.GetBuffer(), recv_stream_.GetBuffer(), size));
     RTC_LOG(LS_INFO) << "Transferred " << received << " bytes in " << elapsed
                      << " ms (" << size * 8 / elapsed << " Kbps)";
+    return size * 8 / elapsed;
   }
 
  private:
@@ -598,6 +620,48 @@ class PseudoTcpTestReceiveWindow : public PseudoTcpTestBase {
   std::vector<size_t> recv_position_;
 };
 
+// Sets up a fake clock before the PseudoTcps of the test are created.
+class PseudoTcpFakeClockHolder {
+ protected:
+  PseudoTcpFakeClockHolder() {
+    // The PseudoTcp uses 0 as "timer not set", so the clock starts later.
+    fake_clock_.AdvanceTime(webrtc::TimeDelta::seconds(1));
+  }
+
+  rtc::ScopedFakeClock fake_clock_;
+};
+
+// Measures the throughput of a bulk transfer with large buffers, for a
+// one-way delay in ms, a loss percentage and whether SACK and CUBIC are used.
+// The transfers run on simulated time, so that long RTTs don't slow the test
+// down.
+class PseudoTcpThroughputTest
+    : public PseudoTcpFakeClockHolder,
+      public PseudoTcpTest,
+      public testing::WithParamInterface<std::tuple<int, int, bool>> {
+ public:
+  int TestThroughput(int size) {
+    SetLocalMtu(1500);
+    SetRemoteMtu(1500);
+    SetDelay(std::get<0>(GetParam()));
+    SetLoss(std::get<1>(GetParam()));
+    if (!std::get<2>(GetParam())) {
+      DisableRemoteSack();
+    }
+    SetOptCubic(std::get<2>(GetParam()));
+    SetRemoteOptRcvBuf(1024 * 1024);
+    SetLocalOptRcvBuf(1024 * 1024);
+    SetOptSndBuf(2 * 1024 * 1024);
+    int kbps = TestTransfer(size, &fake_clock_);
+    EXPECT_EQ(std::get<2>(GetParam()), remote_.isSackEnabled());
+    RTC_LOG(LS_INFO) << "RTT " << 2 * std::get<0>(GetParam()) << " ms, "
+                     << std::get<1>(GetParam()) << "% loss, "
+                     << (std::get<2>(GetParam()) ? "SACK and CUBIC" : "NewReno")
+                     << ": " << kbps << " Kbps";
+    return kbps;
+  }
+};
+
 // Basic end-to-end data transfer tests
 
 // Test the normal case of sending data from one side to the other.
@@ -758,6 +822,56 @@ TEST_F(PseudoTcpTest, TestSendVerySmallReceiveBuffer) {
   TestTransfer(100000);
 }
 
+// Test sending data with packet loss using CUBIC.
+TEST_F(PseudoTcpTest, TestSendWithLossAndOptCubic) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  SetOptCubic(true);
+  TestTransfer(100000);
+}
+
+// Test sending data with a 50 ms RTT and 10% packet loss using CUBIC.
+TEST_F(PseudoTcpTest, TestSendWithDelayAndLossAndOptCubic) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(50);
+  SetLoss(10);
+  SetOptCubic(true);
+  TestTransfer(100000);
+}
+
+// Test that SACK is used when both sides support it.
+TEST_F(PseudoTcpTest, TestSendBothUseSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  TestTransfer(100000);
+  EXPECT_TRUE(local_.isSackEnabled());
+  EXPECT_TRUE(remote_.isSackEnabled());
+}
+
+// Test packet loss with a receiver that doesn't support SACK.
+TEST_F(PseudoTcpTest, TestSendWithLossRemoteNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableRemoteSack();
+  TestTransfer(100000);
+  EXPECT_FALSE(local_.isSackEnabled());
+  EXPECT_FALSE(remote_.isSackEnabled());
+}
+
+TEST_P(PseudoTcpThroughputTest, TestThroughput) {
+  TestThroughput(4 * 1024 * 1024);
+}
+
+INSTANTIATE_TEST_CASE_P(PseudoTcpThroughputTest,
+                        PseudoTcpThroughputTest,
+                        testing::Combine(testing::Values(10, 50, 100),
+                                         testing::Values(0, 1, 2),
+                                         testing::Bool()));
+
 // Ping-pong (request/response) tests
 
 // Test sending <= 1x MTU of data in each ping/pong.  Should take <10ms.
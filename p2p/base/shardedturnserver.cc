@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/shardedturnserver.h"
+
+#include "absl/memory/memory.h"
+#include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/logging.h"
+
+namespace cricket {
+
+namespace {
+
+const size_t kNonceKeySize = 16;
+const int kListenBacklog = 128;
+
+}  // namespace
+
+ShardedTurnServer::ShardedTurnServer(rtc::NetworkThreadPool* pool)
+    : pool_(pool), socket_factory_(pool) {
+  const std::string nonce_key = rtc::CreateRandomString(kNonceKeySize);
+  for (size_t i = 0; i < pool_->size(); ++i) {
+    rtc::Thread* shard = pool_->shard(i);
+    // A TurnServer must be created on the thread it runs on.
+    servers_.push_back(shard->Invoke<std::unique_ptr<TurnServer>>(
+        RTC_FROM_HERE,
+        [shard, &nonce_key] {
+          return absl::make_unique<TurnServer>(shard, nonce_key);
+        }));
+  }
+}
+
+ShardedTurnServer::~ShardedTurnServer() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    pool_->shard(i)->Invoke<void>(RTC_FROM_HERE,
+                                  [this, i] { servers_[i].reset(); });
+  }
+}
+
+void ShardedTurnServer::set_realm(const std::string& realm) {
+  InvokeOnShards([&realm](TurnServer* server) { server->set_realm(realm); });
+}
+
+void ShardedTurnServer::set_software(const std::string& software) {
+  InvokeOnShards(
+      [&software](TurnServer* server) { server->set_software(software); });
+}
+
+void ShardedTurnServer::set_auth_hook(TurnAuthInterface* auth_hook) {
+  InvokeOnShards(
+      [auth_hook](TurnServer* server) { server->set_auth_hook(auth_hook); });
+}
+
+void ShardedTurnServer::set_redirect_hook(
+    TurnRedirectInterface* redirect_hook) {
+  InvokeOnShards([redirect_hook](TurnServer* server) {
+    server->set_redirect_hook(redirect_hook);
+  });
+}
+
+void ShardedTurnServer::set_enable_otu_nonce(bool enable) {
+  InvokeOnShards(
+      [enable](TurnServer* server) { server->set_enable_otu_nonce(enable); });
+}
+
+void ShardedTurnServer::set_reject_private_addresses(bool filter) {
+  InvokeOnShards([filter](TurnServer* server) {
+    server->set_reject_private_addresses(filter);
+  });
+}
+
+void ShardedTurnServer::set_enable_permission_checks(bool enable) {
+  InvokeOnShards([enable](TurnServer* server) {
+    server->set_enable_permission_checks(enable);
+  });
+}
+
+rtc::SocketAddress ShardedTurnServer::AddInternalSocket(
+    const rtc::SocketAddress& address,
+    ProtocolType proto) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  RTC_DCHECK(proto == PROTO_UDP || proto == PROTO_TCP);
+  std::vector<std::unique_ptr<rtc::AsyncSocket>> sockets =
+      socket_factory_.CreateReusePortSockets(
+          address, proto == PROTO_UDP ? SOCK_DGRAM : SOCK_STREAM);
+  if (sockets.empty()) {
+    return rtc::SocketAddress();
+  }
+  if (proto == PROTO_TCP) {
+    for (auto& socket : sockets) {
+      if (socket->Listen(kListenBacklog) < 0) {
+        RTC_LOG(LS_ERROR) << "Listen on " << address.ToSensitiveString()
+                          << " failed with error " << socket->GetError();
+        return rtc::SocketAddress();
+      }
+    }
+  }
+
+  const rtc::SocketAddress bound_address = sockets[0]->GetLocalAddress();
+  for (size_t i = 0; i < sockets.size(); ++i) {
+    rtc::AsyncSocket* socket = sockets[i].release();
+    pool_->shard(i)->Invoke<void>(RTC_FROM_HERE, [this, i, socket, proto] {
+      if (proto == PROTO_UDP) {
+        servers_[i]->AddInternalSocket(new rtc::AsyncUDPSocket(socket), proto);
+      } else {
+        servers_[i]->AddInternalServerSocket(socket, proto);
+      }
+    });
+  }
+  return bound_address;
+}
+
+void ShardedTurnServer::SetExternalAddress(const rtc::SocketAddress& address) {
+  InvokeOnShards([&address](TurnServer* server) {
+    // The relayed sockets must signal on the thread of their shard.
+    server->SetExternalSocketFactory(
+        new rtc::BasicPacketSocketFactory(rtc::Thread::Current()), address);
+  });
+}
+
+size_t ShardedTurnServer::NumAllocations() {
+  size_t num_allocations = 0;
+  InvokeOnShards([&num_allocations](TurnServer* server) {
+    num_allocations += server->allocations().size();
+  });
+  return num_allocations;
+}
+
+void ShardedTurnServer::InvokeOnShards(
+    rtc::FunctionView<void(TurnServer*)> function) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  for (size_t i = 0; i < servers_.size(); ++i) {
+    TurnServer* server = servers_[i].get();
+    pool_->shard(i)->Invoke<void>(RTC_FROM_HERE,
+                                  [function, server] { function(server); });
+  }
+}
+
+}  // namespace cricket
@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_SHARDEDTURNSERVER_H_
+#define P2P_BASE_SHARDEDTURNSERVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "p2p/base/basicpacketsocketfactory.h"
+#include "p2p/base/turnserver.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/function_view.h"
+#include "rtc_base/networkthreadpool.h"
+#include "rtc_base/socketaddress.h"
+#include "rtc_base/thread_checker.h"
+
+namespace cricket {
+
+// Runs one TurnServer on each shard of a rtc::NetworkThreadPool, so that a
+// TURN node relays on as many cores as the pool has threads. Each shard
+// listens on the same internal addresses with SO_REUSEPORT, which makes the
+// kernel pick the shard of a client flow by the hash of its 5-tuple. An
+// allocation, from its internal connection to its relayed socket, therefore
+// lives entirely on the thread of one shard, and the shards share no state
+// on the relay path.
+//
+// The shards share their nonce key, so that a nonce issued by one shard is
+// accepted by the others, and their auth and redirect hooks, which are called
+// concurrently from all the shard threads and must therefore be thread safe.
+//
+// Must be created, used and destroyed on one thread, which is not a shard.
+class ShardedTurnServer {
+ public:
+  // |pool| must be started, and must outlive the server.
+  explicit ShardedTurnServer(rtc::NetworkThreadPool* pool);
+  ~ShardedTurnServer();
+
+  // These apply the settings of TurnServer to all the shards.
+  void set_realm(const std::string& realm);
+  void set_software(const std::string& software);
+  // Does not take ownership.
+  void set_auth_hook(TurnAuthInterface* auth_hook);
+  void set_redirect_hook(TurnRedirectInterface* redirect_hook);
+  void set_enable_otu_nonce(bool enable);
+  void set_reject_private_addresses(bool filter);
+  void set_enable_permission_checks(bool enable);
+
+  // Starts listening for internal clients over |proto|, which is PROTO_UDP or
+  // PROTO_TCP, with one socket per shard bound to |address|. If |address| has
+  // no port, the OS picks one. Returns the bound address, which is nil on
+  // failure.
+  rtc::SocketAddress AddInternalSocket(const rtc::SocketAddress& address,
+                                       ProtocolType proto);
+  // The relayed sockets of all the shards are bound to |address|, with ports
+  // picked by the OS.
+  void SetExternalAddress(const rtc::SocketAddress& address);
+
+  size_t num_shards() const { return servers_.size(); }
+  // The number of allocations over all the shards.
+  size_t NumAllocations();
+
+ private:
+  // Calls |function| with the server of each shard, on the shard's thread.
+  void InvokeOnShards(rtc::FunctionView<void(TurnServer*)> function);
+
+  rtc::ThreadChecker thread_checker_;
+  rtc::NetworkThreadPool* const pool_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  // |servers_[i]| lives on |pool_->shard(i)|.
+  std::vector<std::unique_ptr<TurnServer>> servers_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ShardedTurnServer);
+};
+
+}  // namespace cricket
+
+#endif  // P2P_BASE_SHARDEDTURNSERVER_H_
@@ -0,0 +1,185 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/shardedturnserver.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "p2p/base/stun.h"
+#include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/atomicops.h"
+#include "rtc_base/bytebuffer.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/physicalsocketserver.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+namespace {
+
+const int kTimeoutMs = 5000;
+const size_t kNumShards = 2;
+const size_t kNumClients = 8;
+const char kRealm[] = "example.org";
+const char kUsername[] = "test";
+const char kPassword[] = "test";
+
+class ConcurrentTurnAuth : public TurnAuthInterface {
+ public:
+  bool GetKey(const std::string& username,
+              const std::string& realm,
+              std::string* key) override {
+    rtc::AtomicOps::Increment(&num_calls_);
+    return ComputeStunCredentialHash(username, realm, kPassword, key);
+  }
+
+  int num_calls() const { return rtc::AtomicOps::AcquireLoad(&num_calls_); }
+
+ private:
+  volatile int num_calls_ = 0;
+};
+
+// Sends TURN allocate requests over UDP and collects the responses.
+class TurnClient : public sigslot::has_slots<> {
+ public:
+  TurnClient(rtc::SocketServer* ss, const rtc::SocketAddress& server_address)
+      : socket_(rtc::AsyncUDPSocket::Create(
+            ss,
+            rtc::SocketAddress(server_address.ipaddr(), 0))),
+        server_address_(server_address) {
+    socket_->SignalReadPacket.connect(this, &TurnClient::OnReadPacket);
+  }
+
+  // Without |nonce|, sends an unauthenticated request.
+  void SendAllocateRequest(const std::string& nonce) {
+    TurnMessage request;
+    request.SetType(STUN_ALLOCATE_REQUEST);
+    request.SetTransactionID(
+        rtc::CreateRandomString(kStunTransactionIdLength));
+    auto transport_attr =
+        StunAttribute::CreateUInt32(STUN_ATTR_REQUESTED_TRANSPORT);
+    transport_attr->SetValue(IPPROTO_UDP << 24);
+    request.AddAttribute(std::move(transport_attr));
+    if (!nonce.empty()) {
+      std::string key;
+      ASSERT_TRUE(
+          ComputeStunCredentialHash(kUsername, kRealm, kPassword, &key));
+      request.AddAttribute(absl::make_unique<StunByteStringAttribute>(
+          STUN_ATTR_USERNAME, kUsername));
+      request.AddAttribute(absl::make_unique<StunByteStringAttribute>(
+          STUN_ATTR_REALM, kRealm));
+      request.AddAttribute(absl::make_unique<StunByteStringAttribute>(
+          STUN_ATTR_NONCE, nonce));
+      ASSERT_TRUE(request.AddMessageIntegrity(key));
+    }
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    socket_->SendTo(buf.Data(), buf.Length(), server_address_,
+                    rtc::PacketOptions());
+  }
+
+  const std::vector<std::unique_ptr<TurnMessage>>& responses() const {
+    return responses_;
+  }
+
+ private:
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_address,
+                    const rtc::PacketTime& packet_time) {
+    auto response = absl::make_unique<TurnMessage>();
+    rtc::ByteBufferReader buf(data, size);
+    if (response->Read(&buf)) {
+      responses_.push_back(std::move(response));
+    }
+  }
+
+  std::unique_ptr<rtc::AsyncUDPSocket> socket_;
+  const rtc::SocketAddress server_address_;
+  std::vector<std::unique_ptr<TurnMessage>> responses_;
+};
+
+}  // namespace
+
+class ShardedTurnServerTest : public testing::Test {
+ public:
+  ShardedTurnServerTest() : thread_(&ss_), pool_(kNumShards) {
+    pool_.Start();
+    server_ = absl::make_unique<ShardedTurnServer>(&pool_);
+    server_->set_realm(kRealm);
+    server_->set_auth_hook(&auth_);
+    server_->SetExternalAddress(rtc::SocketAddress("127.0.0.1", 0));
+  }
+
+  ~ShardedTurnServerTest() override {
+    server_.reset();
+    pool_.Stop();
+  }
+
+ protected:
+  rtc::PhysicalSocketServer ss_;
+  rtc::AutoSocketServerThread thread_;
+  ConcurrentTurnAuth auth_;
+  rtc::NetworkThreadPool pool_;
+  std::unique_ptr<ShardedTurnServer> server_;
+};
+
+TEST_F(ShardedTurnServerTest, ListensOnOnePortPerAddress) {
+  ASSERT_EQ(kNumShards, server_->num_shards());
+  const rtc::SocketAddress udp_address = server_->AddInternalSocket(
+      rtc::SocketAddress("127.0.0.1", 0), PROTO_UDP);
+  ASSERT_FALSE(udp_address.IsNil());
+  EXPECT_NE(0, udp_address.port());
+  // TCP can listen on the same port.
+  EXPECT_EQ(udp_address,
+            server_->AddInternalSocket(udp_address, PROTO_TCP));
+}
+
+// The clients get the nonce of their first request from one shard, and use
+// it for the requests that the other shards handle.
+TEST_F(ShardedTurnServerTest, AllocatesWithTheNonceOfAnyShard) {
+  const rtc::SocketAddress server_address = server_->AddInternalSocket(
+      rtc::SocketAddress("127.0.0.1", 0), PROTO_UDP);
+  ASSERT_FALSE(server_address.IsNil());
+
+  std::vector<std::unique_ptr<TurnClient>> clients;
+  for (size_t i = 0; i < kNumClients; ++i) {
+    clients.push_back(absl::make_unique<TurnClient>(&ss_, server_address));
+  }
+  clients[0]->SendAllocateRequest("");
+  ASSERT_TRUE_WAIT(!clients[0]->responses().empty(), kTimeoutMs);
+  const TurnMessage* challenge = clients[0]->responses()[0].get();
+  ASSERT_TRUE(IsStunErrorResponseType(challenge->type()));
+  ASSERT_TRUE(challenge->GetErrorCode());
+  EXPECT_EQ(STUN_ERROR_UNAUTHORIZED, challenge->GetErrorCode()->code());
+  ASSERT_TRUE(challenge->GetByteString(STUN_ATTR_NONCE));
+  const std::string nonce =
+      challenge->GetByteString(STUN_ATTR_NONCE)->GetString();
+
+  for (auto& client : clients) {
+    client->SendAllocateRequest(nonce);
+  }
+  for (size_t i = 0; i < kNumClients; ++i) {
+    // The first client also has the response to its first request.
+    const size_t num_responses = i == 0 ? 2 : 1;
+    ASSERT_EQ_WAIT(num_responses, clients[i]->responses().size(), kTimeoutMs);
+    EXPECT_TRUE(
+        IsStunSuccessResponseType(clients[i]->responses().back()->type()));
+  }
+  EXPECT_EQ(kNumClients, server_->NumAllocations());
+  EXPECT_GE(auth_.num_calls(), static_cast<int>(kNumClients));
+}
+
+}  // namespace cricket
@@ -22,6 +22,7 @@
 #include "rtc_base/crc32.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/messagedigest.h"
+#include "rtc_base/openssldigest.h"
 #include "rtc_base/stringencode.h"
 
 using rtc::ByteBufferReader;
@@ -159,11 +160,50 @@ const StunUInt16ListAttribute* StunMessage::GetUnknownAttributes() const {
       GetAttribute(STUN_ATTR_UNKNOWN_ATTRIBUTES));
 }
 
+StunMessageIntegrityKey::StunMessageIntegrityKey() = default;
+
+StunMessageIntegrityKey::StunMessageIntegrityKey(const std::string& key)
+    : key_(key) {}
+
+StunMessageIntegrityKey::~StunMessageIntegrityKey() = default;
+
+void StunMessageIntegrityKey::SetKey(const std::string& key) {
+  if (key == key_) {
+    return;
+  }
+  key_ = key;
+  hmac_.reset();
+}
+
+bool StunMessageIntegrityKey::ComputeHmac(
+    const char* prefix,
+    size_t prefix_size,
+    const char* data,
+    size_t size,
+    char hmac[kStunMessageIntegritySize]) {
+  if (!hmac_) {
+    hmac_.reset(
+        new rtc::OpenSSLHmac(rtc::DIGEST_SHA_1, key_.data(), key_.size()));
+  }
+  hmac_->Update(prefix, prefix_size);
+  hmac_->Update(data, size);
+  size_t ret = hmac_->Finish(hmac, kStunMessageIntegritySize);
+  RTC_DCHECK(ret == kStunMessageIntegritySize);
+  return ret == kStunMessageIntegritySize;
+}
+
+bool StunMessage::ValidateMessageIntegrity(const char* data,
+                                           size_t size,
+                                           const std::string& password) {
+  StunMessageIntegrityKey key(password);
+  return ValidateMessageIntegrity(data, size, &key);
+}
+
 // Verifies a STUN message has a valid MESSAGE-INTEGRITY attribute, using the
 // procedure outlined in RFC 5389, section 15.4.
 bool StunMessage::ValidateMessageIntegrity(const char* data,
                                            size_t size,
-                                           const std::string& password) {
+                                           StunMessageIntegrityKey* key) {
   // Verifying the size of the message.
   if ((size % 4) != 0 || size < kStunHeaderSize) {
     return false;
@@ -206,10 +246,11 @@ bool StunMessage::ValidateMessageIntegrity(const char* data,
     return false;
   }
 
-  // Getting length of the message to calculate Message Integrity.
+  // Getting length of the message to calculate Message Integrity. Only the
+  // header may need to be changed for it, so only the header is copied.
   size_t mi_pos = current_pos;
-  std::unique_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
+  char header[kStunHeaderSize];
+  memcpy(header, data, kStunHeaderSize);
   if (size > mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize) {
     // Stun message has other attributes after message integrity.
     // Adjust the length parameter in stun message to calculate HMAC.
@@ -223,16 +264,14 @@ bool StunMessage::ValidateMessageIntegrity(const char* data,
     //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     //     |0 0|     STUN Message Type     |         Message Length        |
     //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2, static_cast<uint16_t>(new_adjusted_len));
+    rtc::SetBE16(header + 2, static_cast<uint16_t>(new_adjusted_len));
   }
 
   char hmac[kStunMessageIntegritySize];
-  size_t ret =
-      rtc::ComputeHmac(rtc::DIGEST_SHA_1, password.c_str(), password.size(),
-                       temp_data.get(), mi_pos, hmac, sizeof(hmac));
-  RTC_DCHECK(ret == sizeof(hmac));
-  if (ret != sizeof(hmac))
+  if (!key->ComputeHmac(header, sizeof(header), data + kStunHeaderSize,
+                        mi_pos - kStunHeaderSize, hmac)) {
     return false;
+  }
 
   // Comparing the calculated HMAC with the one present in the message.
   return memcmp(data + current_pos + kStunAttributeHeaderSize, hmac,
@@ -476,6 +515,122 @@ bool StunMessage::IsValidTransactionId(const std::string& transaction_id) {
          transaction_id.size() == kStunLegacyTransactionIdLength;
 }
 
+// StunMessageView
+
+StunMessageView::StunMessageView() : data_(nullptr), size_(0), type_(0) {}
+
+bool StunMessageView::Parse(const char* data, size_t size) {
+  data_ = nullptr;
+  size_ = 0;
+  type_ = 0;
+  if (size < kStunHeaderSize) {
+    return false;
+  }
+  uint16_t type = rtc::GetBE16(data);
+  // As in StunMessage::Read, RTP and RTCP set the MSB of the first byte.
+  if ((type & 0x8000) != 0 ||
+      rtc::GetBE16(data + 2) != size - kStunHeaderSize) {
+    return false;
+  }
+
+  size_t pos = kStunHeaderSize;
+  while (pos < size) {
+    if (pos + kStunAttributeHeaderSize > size) {
+      return false;
+    }
+    size_t attr_length = rtc::GetBE16(data + pos + 2);
+    pos += kStunAttributeHeaderSize;
+    if (pos + attr_length > size) {
+      return false;
+    }
+    // Like StunMessage::Read, accepts a last attribute without its padding.
+    pos += attr_length;
+    if ((attr_length % 4) != 0) {
+      pos += 4 - (attr_length % 4);
+    }
+  }
+
+  data_ = data;
+  size_ = size;
+  type_ = type;
+  return true;
+}
+
+rtc::ArrayView<const char> StunMessageView::transaction_id() const {
+  RTC_DCHECK(data_);
+  // The magic cookie is part of the transaction ID of RFC 3489 STUN.
+  const char* magic_cookie =
+      data_ + kStunTransactionIdOffset - kStunMagicCookieLength;
+  if (rtc::GetBE32(magic_cookie) != kStunMagicCookie) {
+    return rtc::ArrayView<const char>(magic_cookie,
+                                      kStunLegacyTransactionIdLength);
+  }
+  return rtc::ArrayView<const char>(data_ + kStunTransactionIdOffset,
+                                    kStunTransactionIdLength);
+}
+
+bool StunMessageView::GetByteString(int type,
+                                    rtc::ArrayView<const char>* value) const {
+  RTC_DCHECK(data_);
+  // Parse() has checked that the attributes fit in the message.
+  size_t pos = kStunHeaderSize;
+  while (pos < size_) {
+    uint16_t attr_type = rtc::GetBE16(data_ + pos);
+    uint16_t attr_length = rtc::GetBE16(data_ + pos + 2);
+    pos += kStunAttributeHeaderSize;
+    if (attr_type == type) {
+      *value = rtc::ArrayView<const char>(data_ + pos, attr_length);
+      return true;
+    }
+    pos += attr_length;
+    if ((attr_length % 4) != 0) {
+      pos += 4 - (attr_length % 4);
+    }
+  }
+  return false;
+}
+
+bool StunMessageView::GetXorAddress(int type,
+                                    rtc::SocketAddress* address) const {
+  // Decoded as in StunXorAddressAttribute::Read.
+  rtc::ArrayView<const char> value;
+  if (!GetByteString(type, &value) || value.size() < 4) {
+    return false;
+  }
+  uint8_t family = static_cast<uint8_t>(value[1]);
+  uint16_t port = rtc::GetBE16(&value[2]) ^ (kStunMagicCookie >> 16);
+  if (family == STUN_ADDRESS_IPV4 &&
+      value.size() == StunAddressAttribute::SIZE_IP4) {
+    in_addr v4addr;
+    memcpy(&v4addr, &value[4], sizeof(v4addr));
+    v4addr.s_addr ^= rtc::HostToNetwork32(kStunMagicCookie);
+    *address = rtc::SocketAddress(rtc::IPAddress(v4addr), port);
+    return true;
+  }
+  if (family == STUN_ADDRESS_IPV6 &&
+      value.size() == StunAddressAttribute::SIZE_IP6 &&
+      transaction_id().size() == kStunTransactionIdLength) {
+    // The address is XORed with the magic cookie followed by the transaction
+    // ID, which is how they are laid out in the header.
+    in6_addr v6addr;
+    memcpy(&v6addr, &value[4], sizeof(v6addr));
+    const char* mask =
+        data_ + kStunTransactionIdOffset - kStunMagicCookieLength;
+    for (size_t i = 0; i < sizeof(v6addr.s6_addr); ++i) {
+      v6addr.s6_addr[i] ^= static_cast<uint8_t>(mask[i]);
+    }
+    *address = rtc::SocketAddress(rtc::IPAddress(v6addr), port);
+    return true;
+  }
+  return false;
+}
+
+bool StunMessageView::ValidateMessageIntegrity(
+    StunMessageIntegrityKey* key) const {
+  RTC_DCHECK(data_);
+  return StunMessage::ValidateMessageIntegrity(data_, size_, key);
+}
+
 // StunAttribute
 
 StunAttribute::StunAttribute(uint16_t type, uint16_t length)
@@ -18,7 +18,9 @@
 #include <string>
 #include <vector>
 
+#include "api/array_view.h"
 #include "rtc_base/bytebuffer.h"
+#include "rtc_base/constructormagic.h"
 #include "rtc_base/socketaddress.h"
 
 namespace cricket {
@@ -125,6 +127,44 @@ class StunByteStringAttribute;
 class StunErrorCodeAttribute;
 class StunUInt16ListAttribute;
 
+}  // namespace cricket
+
+namespace rtc {
+class OpenSSLHmac;
+}  // namespace rtc
+
+namespace cricket {
+
+// A MESSAGE-INTEGRITY key, i.e. an ICE password or a TURN long-term credential
+// hash, with its HMAC-SHA1 key schedule. The schedule is only computed when
+// the key changes, so that validating many messages with one key, e.g. the
+// connectivity checks of all the connections of a port, neither recomputes it
+// nor allocates. Not thread safe.
+class StunMessageIntegrityKey {
+ public:
+  StunMessageIntegrityKey();
+  explicit StunMessageIntegrityKey(const std::string& key);
+  ~StunMessageIntegrityKey();
+
+  // Does nothing if |key| is the current key.
+  void SetKey(const std::string& key);
+  const std::string& key() const { return key_; }
+
+  // Writes the HMAC-SHA1 of |size| bytes of |data|, preceded by the
+  // |prefix_size| bytes of |prefix|, to |hmac|. Returns false on failure.
+  bool ComputeHmac(const char* prefix,
+                   size_t prefix_size,
+                   const char* data,
+                   size_t size,
+                   char hmac[kStunMessageIntegritySize]);
+
+ private:
+  std::string key_;
+  std::unique_ptr<rtc::OpenSSLHmac> hmac_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(StunMessageIntegrityKey);
+};
+
 // Records a complete STUN/TURN message.  Each message consists of a type and
 // any number of attributes.  Each attribute is parsed into an instance of an
 // appropriate class (see above).  The Get* methods will return instances of
@@ -173,6 +213,10 @@ class StunMessage {
   static bool ValidateMessageIntegrity(const char* data,
                                        size_t size,
                                        const std::string& password);
+  // Same as above, with the key schedule computed for |key|.
+  static bool ValidateMessageIntegrity(const char* data,
+                                       size_t size,
+                                       StunMessageIntegrityKey* key);
   // Adds a MESSAGE-INTEGRITY attribute that is valid for the current message.
   bool AddMessageIntegrity(const std::string& password);
   bool AddMessageIntegrity(const char* key, size_t keylen);
@@ -214,6 +258,38 @@ class StunMessage {
   uint32_t stun_magic_cookie_;
 };
 
+// A read-only view of a STUN message in a buffer. It checks the framing of the
+// message and finds its attributes in place, without copying or allocating,
+// for the hot paths which only look at a few attributes of each message, such
+// as TURN data indications. Unlike StunMessage::Read, it does not parse the
+// attributes it is not asked for, nor check them against their types.
+class StunMessageView {
+ public:
+  StunMessageView();
+
+  // Returns false if the |size| bytes of |data| are not a STUN message with
+  // well-formed attributes. |data| must outlive the use of the view.
+  bool Parse(const char* data, size_t size);
+
+  int type() const { return type_; }
+  // The transaction ID, including the magic cookie of RFC 3489 STUN.
+  rtc::ArrayView<const char> transaction_id() const;
+
+  // Finds the value of the first attribute of |type|. Returns false if there
+  // is none.
+  bool GetByteString(int type, rtc::ArrayView<const char>* value) const;
+  // Decodes the first XOR address attribute of |type|. Returns false if there
+  // is none or it is malformed.
+  bool GetXorAddress(int type, rtc::SocketAddress* address) const;
+
+  bool ValidateMessageIntegrity(StunMessageIntegrityKey* key) const;
+
+ private:
+  const char* data_;
+  size_t size_;
+  int type_;
+};
+
 // Base class for all STUN/TURN attributes.
 class StunAttribute {
  public:
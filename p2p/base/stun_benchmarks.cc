@@ -0,0 +1,53 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "absl/memory/memory.h"
+#include "benchmark/benchmark.h"
+#include "p2p/base/stun.h"
+#include "rtc_base/bytebuffer.h"
+#include "rtc_base/checks.h"
+
+namespace cricket {
+namespace {
+
+const char kPassword[] = "rflwyDKhSKo7lHY0ddbBzoFb";
+
+// A binding request like the ones sent for ICE connectivity checks.
+void BM_StunMessageRead(benchmark::State& state) {
+  IceMessage message;
+  message.SetType(STUN_BINDING_REQUEST);
+  RTC_CHECK(message.SetTransactionID("0123456789ab"));
+  message.AddAttribute(absl::make_unique<StunByteStringAttribute>(
+      STUN_ATTR_USERNAME, "abcd:efgh"));
+  message.AddAttribute(
+      absl::make_unique<StunUInt32Attribute>(STUN_ATTR_PRIORITY, 0x6e0001ff));
+  message.AddAttribute(absl::make_unique<StunUInt64Attribute>(
+      STUN_ATTR_ICE_CONTROLLING, 0x0123456789abcdefull));
+  message.AddAttribute(
+      absl::make_unique<StunByteStringAttribute>(STUN_ATTR_USE_CANDIDATE));
+  RTC_CHECK(message.AddMessageIntegrity(kPassword));
+  RTC_CHECK(message.AddFingerprint());
+  rtc::ByteBufferWriter writer;
+  RTC_CHECK(message.Write(&writer));
+
+  for (auto _ : state) {
+    rtc::ByteBufferReader reader(writer.Data(), writer.Length());
+    IceMessage parsed;
+    bool read = parsed.Read(&reader);
+    benchmark::DoNotOptimize(read);
+  }
+  state.SetBytesProcessed(state.iterations() * writer.Length());
+}
+BENCHMARK(BM_StunMessageRead);
+
+}  // namespace
+}  // namespace cricket
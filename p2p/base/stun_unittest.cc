@@ -15,6 +15,7 @@
 #include "p2p/base/stun.h"
 #include "rtc_base/arraysize.h"
 #include "rtc_base/bytebuffer.h"
+#include "rtc_base/byteorder.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/messagedigest.h"
@@ -708,6 +709,58 @@ TEST_F(StunTest, ReadRfc5769RequestMessageLongTermAuth) {
   ASSERT_TRUE(msg.GetUInt32(STUN_ATTR_FINGERPRINT) == NULL);
 }
 
+// Find the attributes of the RFC5769 sample messages in place.
+TEST_F(StunTest, ViewRfc5769Messages) {
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(reinterpret_cast<const char*>(kRfc5769SampleRequest),
+                         sizeof(kRfc5769SampleRequest)));
+  EXPECT_EQ(STUN_BINDING_REQUEST, view.type());
+  EXPECT_EQ(std::string(
+                reinterpret_cast<const char*>(kRfc5769SampleMsgTransactionId),
+                kStunTransactionIdLength),
+            std::string(view.transaction_id().data(),
+                        view.transaction_id().size()));
+  rtc::ArrayView<const char> username;
+  ASSERT_TRUE(view.GetByteString(STUN_ATTR_USERNAME, &username));
+  EXPECT_EQ(kRfc5769SampleMsgUsername,
+            std::string(username.data(), username.size()));
+  rtc::ArrayView<const char> origin;
+  EXPECT_FALSE(view.GetByteString(STUN_ATTR_ORIGIN, &origin));
+
+  rtc::SocketAddress address;
+  ASSERT_TRUE(
+      view.Parse(reinterpret_cast<const char*>(kRfc5769SampleResponse),
+                 sizeof(kRfc5769SampleResponse)));
+  ASSERT_TRUE(view.GetXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, &address));
+  EXPECT_EQ(kRfc5769SampleMsgMappedAddress, address);
+
+  ASSERT_TRUE(
+      view.Parse(reinterpret_cast<const char*>(kRfc5769SampleResponseIPv6),
+                 sizeof(kRfc5769SampleResponseIPv6)));
+  ASSERT_TRUE(view.GetXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, &address));
+  EXPECT_EQ(kRfc5769SampleMsgIPv6MappedAddress, address);
+  EXPECT_FALSE(view.GetXorAddress(STUN_ATTR_XOR_PEER_ADDRESS, &address));
+}
+
+TEST_F(StunTest, ViewRejectsMalformedMessages) {
+  StunMessageView view;
+  // Too short for a header.
+  EXPECT_FALSE(view.Parse(reinterpret_cast<const char*>(kRfc5769SampleRequest),
+                          kStunHeaderSize - 1));
+  // The length in the header doesn't match.
+  EXPECT_FALSE(
+      view.Parse(reinterpret_cast<const char*>(kRfc5769SampleRequest),
+                 sizeof(kRfc5769SampleRequest) - 4));
+  // An attribute runs past the end of the message.
+  char data[sizeof(kRfc5769SampleRequest)];
+  memcpy(data, kRfc5769SampleRequest, sizeof(data));
+  rtc::SetBE16(data + kStunHeaderSize + 2, sizeof(data));
+  EXPECT_FALSE(view.Parse(data, sizeof(data)));
+  // RTCP.
+  EXPECT_FALSE(view.Parse(reinterpret_cast<const char*>(kRtcpPacket),
+                          sizeof(kRtcpPacket)));
+}
+
 // The RFC3489 packet in this test is the same as
 // kStunMessageWithIPv4MappedAddress, but with a different value where the
 // magic cookie was.
@@ -1231,6 +1284,31 @@ TEST_F(StunTest, ValidateMessageIntegrity) {
 // Validate that we generate correct MESSAGE-INTEGRITY attributes.
 // Note the use of IceMessage instead of StunMessage; this is necessary because
 // the RFC5769 test messages used include attributes not found in basic STUN.
+// The key schedule of a StunMessageIntegrityKey is reused across messages, and
+// recomputed when the key changes.
+TEST_F(StunTest, ValidateMessageIntegrityWithKey) {
+  StunMessageIntegrityKey key(kRfc5769SampleMsgPassword);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(
+        reinterpret_cast<const char*>(kRfc5769SampleRequest),
+        sizeof(kRfc5769SampleRequest), &key));
+    EXPECT_TRUE(StunMessage::ValidateMessageIntegrity(
+        reinterpret_cast<const char*>(kRfc5769SampleResponse),
+        sizeof(kRfc5769SampleResponse), &key));
+  }
+
+  StunMessageView view;
+  ASSERT_TRUE(
+      view.Parse(reinterpret_cast<const char*>(kRfc5769SampleResponseIPv6),
+                 sizeof(kRfc5769SampleResponseIPv6)));
+  EXPECT_TRUE(view.ValidateMessageIntegrity(&key));
+
+  key.SetKey("InvalidPassword");
+  EXPECT_FALSE(view.ValidateMessageIntegrity(&key));
+  key.SetKey(kRfc5769SampleMsgPassword);
+  EXPECT_TRUE(view.ValidateMessageIntegrity(&key));
+}
+
 TEST_F(StunTest, AddMessageIntegrity) {
   IceMessage msg;
   rtc::ByteBufferReader buf(
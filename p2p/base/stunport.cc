@@ -208,7 +208,9 @@ bool UDPPort::Init() {
       RTC_LOG(LS_WARNING) << ToString() << ": UDP socket creation failed";
       return false;
     }
-    socket_->SignalReadPacket.connect(this, &UDPPort::OnReadPacket);
+    socket_->SetReadPacketCallback(
+        rtc::AsyncPacketSocket::ReadPacketCallback::Create<
+            UDPPort, &UDPPort::OnReadPacket>(this));
   }
   socket_->SignalSentPacket.connect(this, &UDPPort::OnSentPacket);
   socket_->SignalReadyToSend.connect(this, &UDPPort::OnReadyToSend);
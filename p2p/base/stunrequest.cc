@@ -41,6 +41,58 @@ const int STUN_MAX_RETRANSMISSIONS = 8;  // Total sends: 9
 // work well.
 const int STUN_MAX_RTO = 8000;  // milliseconds, or 5 doublings
 
+StunRequestTimeouts::StunRequestTimeouts(rtc::Thread* thread)
+    : thread_(thread) {}
+
+StunRequestTimeouts::~StunRequestTimeouts() {
+  for (const auto& kv : timeouts_) {
+    kv.second->timeouts_ = nullptr;
+  }
+  thread_->Clear(this);
+}
+
+void StunRequestTimeouts::Add(StunRequest* request, int64_t timeout_ms) {
+  RTC_DCHECK(!request->timeouts_);
+  request->timeouts_ = this;
+  request->timeout_it_ = timeouts_.emplace(timeout_ms, request);
+  ScheduleTimer(rtc::TimeMillis());
+}
+
+void StunRequestTimeouts::Remove(StunRequest* request) {
+  RTC_DCHECK(request->timeouts_ == this);
+  timeouts_.erase(request->timeout_it_);
+  request->timeouts_ = nullptr;
+}
+
+void StunRequestTimeouts::OnMessage(rtc::Message* pmsg) {
+  timer_ms_ = -1;
+  int64_t now = rtc::TimeMillis();
+  while (!timeouts_.empty() && timeouts_.begin()->first <= now) {
+    // The request removes itself when it is deleted.
+    StunRequest* request = timeouts_.begin()->second;
+    request->OnTimeout();
+    delete request;
+  }
+  ScheduleTimer(now);
+}
+
+void StunRequestTimeouts::ScheduleTimer(int64_t now) {
+  if (timeouts_.empty()) {
+    return;
+  }
+  int64_t next_ms = timeouts_.begin()->first;
+  if (timer_ms_ != -1) {
+    if (timer_ms_ <= next_ms) {
+      return;
+    }
+    thread_->Clear(this);
+  }
+  timer_ms_ = next_ms;
+  thread_->PostDelayed(RTC_FROM_HERE,
+                       static_cast<int>(std::max<int64_t>(next_ms - now, 0)),
+                       this);
+}
+
 StunRequestManager::StunRequestManager(rtc::Thread* thread) : thread_(thread) {}
 
 StunRequestManager::~StunRequestManager() {
@@ -94,7 +146,11 @@ void StunRequestManager::Remove(StunRequest* request) {
   if (iter != requests_.end()) {
     RTC_DCHECK(iter->second == request);
     requests_.erase(iter);
-    thread_->Clear(request);
+    if (request->timeouts_) {
+      request->timeouts_->Remove(request);
+    } else {
+      thread_->Clear(request);
+    }
   }
 }
 
@@ -180,9 +236,17 @@ StunRequest::StunRequest(StunMessage* request)
 
 StunRequest::~StunRequest() {
   RTC_DCHECK(manager_ != NULL);
+  // Clearing the messages of the request scans the whole message queue, which
+  // isn't needed while it waits in |timeouts_|.
+  bool has_messages = !timeouts_;
   if (manager_) {
     manager_->Remove(this);
-    manager_->thread_->Clear(this);
+    if (has_messages) {
+      manager_->thread_->Clear(this);
+    }
+  }
+  if (timeouts_) {
+    timeouts_->Remove(this);
   }
   delete msg_;
 }
@@ -237,6 +301,10 @@ void StunRequest::OnMessage(rtc::Message* pmsg) {
   manager_->SignalSendPacket(buf.Data(), buf.Length(), this);
 
   OnSent();
+  if (timeout_ && manager_->timeouts_) {
+    manager_->timeouts_->Add(this, tstamp_ + resend_delay());
+    return;
+  }
   manager_->thread_->PostDelayed(RTC_FROM_HERE, resend_delay(), this,
                                  MSG_STUN_SEND, NULL);
 }
@@ -28,6 +28,36 @@ const int kAllRequests = 0;
 // high RTT (such as 40s on 2G networks), this doesn't work well.
 const int STUN_TOTAL_TIMEOUT = 39750;  // milliseconds
 
+// Times out the requests of many StunRequestManagers with a single timer,
+// instead of a delayed message per request, so that the message queue of the
+// thread doesn't grow with the number of outstanding requests. Requests are
+// added once they have been sent for the last time; a Port keeps one for the
+// pings of all its connections.
+class StunRequestTimeouts : public rtc::MessageHandler {
+ public:
+  typedef std::multimap<int64_t, StunRequest*> TimeoutMap;
+
+  explicit StunRequestTimeouts(rtc::Thread* thread);
+  ~StunRequestTimeouts() override;
+
+  // Times out |request| at |timeout_ms|, unless it is removed before.
+  void Add(StunRequest* request, int64_t timeout_ms);
+  void Remove(StunRequest* request);
+
+  // The number of requests waiting for their timeout.
+  size_t size() const { return timeouts_.size(); }
+
+ private:
+  void OnMessage(rtc::Message* pmsg) override;
+  // Posts the timer for the earliest timeout, if it isn't pending yet.
+  void ScheduleTimer(int64_t now);
+
+  rtc::Thread* thread_;
+  TimeoutMap timeouts_;
+  // The time at which the pending timer fires, or -1 if there is none.
+  int64_t timer_ms_ = -1;
+};
+
 // Manages a set of STUN requests, sending and resending until we receive a
 // response or determine that the request has timed out.
 class StunRequestManager {
@@ -65,6 +95,10 @@ class StunRequestManager {
   // Set the Origin header for outgoing stun messages.
   void set_origin(const std::string& origin) { origin_ = origin; }
 
+  // Times out the requests in |timeouts| after their last send, rather than
+  // with a message each. |timeouts| must outlive the requests.
+  void set_timeouts(StunRequestTimeouts* timeouts) { timeouts_ = timeouts; }
+
   // Raised when there are bytes to be sent.
   sigslot::signal3<const void*, size_t, StunRequest*> SignalSendPacket;
 
@@ -74,6 +108,7 @@ class StunRequestManager {
   rtc::Thread* thread_;
   RequestMap requests_;
   std::string origin_;
+  StunRequestTimeouts* timeouts_ = nullptr;
 
   friend class StunRequest;
 };
@@ -138,8 +173,13 @@ class StunRequest : public rtc::MessageHandler {
   StunRequestManager* manager_;
   StunMessage* msg_;
   int64_t tstamp_;
+  // Set while the request waits for its timeout in |timeouts_|, in which case
+  // it has no pending message.
+  StunRequestTimeouts* timeouts_ = nullptr;
+  StunRequestTimeouts::TimeoutMap::iterator timeout_it_;
 
   friend class StunRequestManager;
+  friend class StunRequestTimeouts;
 };
 
 }  // namespace cricket
@@ -91,6 +91,21 @@ class StunRequestThunker : public StunRequest {
   StunRequestTest* test_;
 };
 
+// A request that is sent once and times out after a second, like the
+// connectivity checks of a Connection.
+class SendOnceStunRequest : public StunRequestThunker {
+ public:
+  SendOnceStunRequest(StunMessage* msg, StunRequestTest* test)
+      : StunRequestThunker(msg, test) {}
+
+ private:
+  void OnSent() override {
+    StunRequest::OnSent();
+    timeout_ = true;
+  }
+  int resend_delay() override { return 1000; }
+};
+
 // Test handling of a normal binding response.
 TEST_F(StunRequestTest, TestSuccess) {
   StunMessage* req = CreateStunMessage(STUN_BINDING_REQUEST, NULL);
@@ -178,6 +193,58 @@ TEST_F(StunRequestTest, TestTimeout) {
   delete res;
 }
 
+// Test that a request retransmitted with backoff times out at the same time
+// when its last timeout is tracked by a StunRequestTimeouts.
+TEST_F(StunRequestTest, TestTimeoutWithTimeouts) {
+  rtc::ScopedFakeClock fake_clock;
+  StunRequestTimeouts timeouts(rtc::Thread::Current());
+  manager_.set_timeouts(&timeouts);
+  StunMessage* req = CreateStunMessage(STUN_BINDING_REQUEST, NULL);
+
+  int64_t start = rtc::TimeMillis();
+  manager_.Send(new StunRequestThunker(req, this));
+  EXPECT_TRUE_SIMULATED_WAIT(request_count_ == 9, STUN_TOTAL_TIMEOUT,
+                             fake_clock);
+  EXPECT_EQ(1u, timeouts.size());
+  EXPECT_TRUE_SIMULATED_WAIT(timeout_, STUN_TOTAL_TIMEOUT, fake_clock);
+  EXPECT_EQ(STUN_TOTAL_TIMEOUT, rtc::TimeMillis() - start);
+  EXPECT_EQ(0u, timeouts.size());
+  EXPECT_TRUE(manager_.empty());
+}
+
+// Test that requests of several managers time out in order with one
+// StunRequestTimeouts, and that a response removes its request.
+TEST_F(StunRequestTest, TestTimeoutsOfSeveralManagers) {
+  rtc::ScopedFakeClock fake_clock;
+  StunRequestTimeouts timeouts(rtc::Thread::Current());
+  StunRequestManager other_manager(rtc::Thread::Current());
+  manager_.set_timeouts(&timeouts);
+  other_manager.set_timeouts(&timeouts);
+
+  StunMessage* req1 = CreateStunMessage(STUN_BINDING_REQUEST, NULL);
+  StunMessage* req2 = CreateStunMessage(STUN_BINDING_REQUEST, NULL);
+  StunMessage* req3 = CreateStunMessage(STUN_BINDING_REQUEST, NULL);
+  manager_.Send(new SendOnceStunRequest(req1, this));
+  fake_clock.AdvanceTime(webrtc::TimeDelta::ms(100));
+  other_manager.Send(new SendOnceStunRequest(req2, this));
+  manager_.Send(new SendOnceStunRequest(req3, this));
+  EXPECT_EQ(3u, timeouts.size());
+
+  StunMessage* res = CreateStunMessage(STUN_BINDING_RESPONSE, req1);
+  EXPECT_TRUE(manager_.CheckResponse(res));
+  EXPECT_TRUE(success_);
+  EXPECT_EQ(2u, timeouts.size());
+
+  fake_clock.AdvanceTime(webrtc::TimeDelta::ms(999));
+  EXPECT_FALSE(timeout_);
+  fake_clock.AdvanceTime(webrtc::TimeDelta::ms(1));
+  EXPECT_TRUE(timeout_);
+  EXPECT_EQ(0u, timeouts.size());
+  EXPECT_TRUE(manager_.empty());
+  EXPECT_TRUE(other_manager.empty());
+  delete res;
+}
+
 // Regression test for specific crash where we receive a response with the
 // same id as a request that doesn't have an underlying StunMessage yet.
 TEST_F(StunRequestTest, TestNoEmptyRequest) {
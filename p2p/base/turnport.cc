@@ -305,6 +305,15 @@ std::vector<std::string> TurnPort::GetTlsEllipticCurves() const {
 }
 
 void TurnPort::PrepareAddress() {
+  if (ready() && Candidates().size() == 1) {
+    // The allocation was made before this port was handed to its session, by
+    // TurnAllocationPool, and only its candidate has to be added again.
+    const Candidate candidate = Candidates()[0];
+    ClearCandidates();
+    OnAllocateSuccess(candidate.address(), candidate.related_address());
+    return;
+  }
+
   if (credentials_.username.empty() || credentials_.password.empty()) {
     RTC_LOG(LS_ERROR) << "Allocation can't be started without setting the"
                          " TURN server credentials for the user.";
@@ -672,8 +681,9 @@ bool TurnPort::HandleIncomingPacket(rtc::AsyncPacketSocket* socket,
 
   // This must be a response for one of our requests.
   // Check success responses, but not errors, for MESSAGE-INTEGRITY.
+  hash_key_.SetKey(hash());
   if (IsStunSuccessResponseType(msg_type) &&
-      !StunMessage::ValidateMessageIntegrity(data, size, hash())) {
+      !StunMessage::ValidateMessageIntegrity(data, size, &hash_key_)) {
     RTC_LOG(LS_WARNING) << ToString()
                         << ": Received TURN message with invalid "
                            "message integrity, msg_type: "
@@ -924,26 +934,25 @@ void TurnPort::HandleDataIndication(const char* data,
                                     size_t size,
                                     const rtc::PacketTime& packet_time) {
   // Read in the message, and process according to RFC5766, Section 10.4.
-  rtc::ByteBufferReader buf(data, size);
-  TurnMessage msg;
-  if (!msg.Read(&buf)) {
+  // Only two attributes are used, which are found in place.
+  StunMessageView msg;
+  if (!msg.Parse(data, size)) {
     RTC_LOG(LS_WARNING) << ToString()
                         << ": Received invalid TURN data indication";
     return;
   }
 
   // Check mandatory attributes.
-  const StunAddressAttribute* addr_attr =
-      msg.GetAddress(STUN_ATTR_XOR_PEER_ADDRESS);
-  if (!addr_attr) {
+  rtc::SocketAddress ext_addr;
+  if (!msg.GetXorAddress(STUN_ATTR_XOR_PEER_ADDRESS, &ext_addr)) {
     RTC_LOG(LS_WARNING) << ToString()
                         << ": Missing STUN_ATTR_XOR_PEER_ADDRESS attribute "
                            "in data indication.";
     return;
   }
 
-  const StunByteStringAttribute* data_attr = msg.GetByteString(STUN_ATTR_DATA);
-  if (!data_attr) {
+  rtc::ArrayView<const char> data_attr;
+  if (!msg.GetByteString(STUN_ATTR_DATA, &data_attr)) {
     RTC_LOG(LS_WARNING) << ToString()
                         << ": Missing STUN_ATTR_DATA attribute in "
                            "data indication.";
@@ -952,7 +961,6 @@ void TurnPort::HandleDataIndication(const char* data,
 
   // Log a warning if the data didn't come from an address that we think we have
   // a permission for.
-  rtc::SocketAddress ext_addr(addr_attr->GetAddress());
   if (!HasPermission(ext_addr.ipaddr())) {
     RTC_LOG(LS_WARNING) << ToString()
                         << ": Received TURN data indication with unknown "
@@ -960,7 +968,7 @@ void TurnPort::HandleDataIndication(const char* data,
                         << ext_addr.ToSensitiveString();
   }
 
-  DispatchPacket(data_attr->bytes(), data_attr->length(), ext_addr, PROTO_UDP,
+  DispatchPacket(data_attr.data(), data_attr.size(), ext_addr, PROTO_UDP,
                  packet_time);
 }
 
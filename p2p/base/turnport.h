@@ -320,6 +320,7 @@ class TurnPort : public Port {
   std::string realm_;       // From 401/438 response message.
   std::string nonce_;       // From 401/438 response message.
   std::string hash_;        // Digest of username:realm:password
+  StunMessageIntegrityKey hash_key_;  // Key schedule for |hash_|.
 
   int next_channel_number_;
   EntryList entries_;
@@ -10,6 +10,8 @@
 
 #include "p2p/base/turnserver.h"
 
+#include <string.h>
+
 #include <tuple>  // for std::tie
 #include <utility>
 
@@ -19,6 +21,7 @@
 #include "p2p/base/stun.h"
 #include "rtc_base/bind.h"
 #include "rtc_base/bytebuffer.h"
+#include "rtc_base/byteorder.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/helpers.h"
 #include "rtc_base/logging.h"
@@ -121,8 +124,11 @@ static bool InitErrorResponse(const StunMessage* req, int code,
 
 
 TurnServer::TurnServer(rtc::Thread* thread)
+    : TurnServer(thread, rtc::CreateRandomString(kNonceKeySize)) {}
+
+TurnServer::TurnServer(rtc::Thread* thread, const std::string& nonce_key)
     : thread_(thread),
-      nonce_key_(rtc::CreateRandomString(kNonceKeySize)),
+      nonce_key_(nonce_key),
       auth_hook_(NULL),
       redirect_hook_(NULL),
       enable_otu_nonce_(false) {
@@ -529,9 +535,15 @@ void TurnServer::SendStun(TurnServerConnection* conn, StunMessage* msg) {
 
 void TurnServer::Send(TurnServerConnection* conn,
                       const rtc::ByteBufferWriter& buf) {
+  Send(conn, buf.Data(), buf.Length());
+}
+
+void TurnServer::Send(TurnServerConnection* conn,
+                      const void* data,
+                      size_t size) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   rtc::PacketOptions options;
-  conn->socket()->SendTo(buf.Data(), buf.Length(), conn->src(), options);
+  conn->socket()->SendTo(data, size, conn->src(), options);
 }
 
 void TurnServer::OnAllocationDestroyed(TurnServerAllocation* allocation) {
@@ -593,6 +605,11 @@ bool TurnServerConnection::operator<(const TurnServerConnection& c) const {
   return std::tie(src_, dst_, proto_) < std::tie(c.src_, c.dst_, c.proto_);
 }
 
+size_t TurnServerConnection::Hash::operator()(
+    const TurnServerConnection& t) const {
+  return t.src_.Hash() ^ (t.dst_.Hash() << 1) ^ t.proto_;
+}
+
 std::string TurnServerConnection::ToString() const {
   const char* const kProtos[] = {
       "unknown", "udp", "tcp", "ssltcp"
@@ -617,13 +634,11 @@ TurnServerAllocation::TurnServerAllocation(TurnServer* server,
 }
 
 TurnServerAllocation::~TurnServerAllocation() {
-  for (ChannelList::iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    delete *it;
+  for (const auto& channel : channels_by_id_) {
+    delete channel.second;
   }
-  for (PermissionList::iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    delete *it;
+  for (const auto& perm : perms_) {
+    delete perm.second;
   }
   thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
   RTC_LOG(LS_INFO) << ToString() << ": Allocation destroyed";
@@ -806,7 +821,8 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
     channel1 = new Channel(thread_, channel_id, peer_attr->GetAddress());
     channel1->SignalDestroyed.connect(this,
         &TurnServerAllocation::OnChannelDestroyed);
-    channels_.push_back(channel1);
+    channels_by_id_[channel_id] = channel1;
+    channels_by_peer_[channel1->peer()] = channel1;
   } else {
     channel1->Refresh();
   }
@@ -825,13 +841,20 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
 }
 
 void TurnServerAllocation::HandleChannelData(const char* data, size_t size) {
-  // Extract the channel number from the data.
+  // Extract the channel number and the length of the data, which may be
+  // followed by padding.
   uint16_t channel_id = rtc::GetBE16(data);
+  size_t length = rtc::GetBE16(data + 2);
+  if (length > size - TURN_CHANNEL_HEADER_SIZE) {
+    RTC_LOG(LS_WARNING) << ToString()
+                        << ": Received truncated channel data, id="
+                        << channel_id;
+    return;
+  }
   Channel* channel = FindChannel(channel_id);
   if (channel) {
     // Send the data to the peer address.
-    SendExternal(data + TURN_CHANNEL_HEADER_SIZE,
-                 size - TURN_CHANNEL_HEADER_SIZE, channel->peer());
+    SendExternal(data + TURN_CHANNEL_HEADER_SIZE, length, channel->peer());
   } else {
     RTC_LOG(LS_WARNING) << ToString()
                         << ": Received channel data for invalid channel, id="
@@ -848,11 +871,11 @@ void TurnServerAllocation::OnExternalPacket(
   Channel* channel = FindChannel(addr);
   if (channel) {
     // There is a channel bound to this address. Send as a channel message.
-    rtc::ByteBufferWriter buf;
-    buf.WriteUInt16(channel->id());
-    buf.WriteUInt16(static_cast<uint16_t>(size));
-    buf.WriteBytes(data, size);
-    server_->Send(&conn_, buf);
+    channel_data_.SetSize(TURN_CHANNEL_HEADER_SIZE + size);
+    rtc::SetBE16(channel_data_.data(), static_cast<uint16_t>(channel->id()));
+    rtc::SetBE16(channel_data_.data() + 2, static_cast<uint16_t>(size));
+    memcpy(channel_data_.data() + TURN_CHANNEL_HEADER_SIZE, data, size);
+    server_->Send(&conn_, channel_data_.data(), channel_data_.size());
   } else if (!server_->enable_permission_checks_ ||
              HasPermission(addr.ipaddr())) {
     // No channel, but a permission exists. Send as a data indication.
@@ -893,7 +916,7 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
     perm = new Permission(thread_, addr);
     perm->SignalDestroyed.connect(
         this, &TurnServerAllocation::OnPermissionDestroyed);
-    perms_.push_back(perm);
+    perms_[addr] = perm;
   } else {
     perm->Refresh();
   }
@@ -901,32 +924,20 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
 
 TurnServerAllocation::Permission* TurnServerAllocation::FindPermission(
     const rtc::IPAddress& addr) const {
-  for (PermissionList::const_iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  PermissionMap::const_iterator it = perms_.find(addr);
+  return it != perms_.end() ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     int channel_id) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->id() == channel_id)
-      return *it;
-  }
-  return NULL;
+  ChannelIdMap::const_iterator it = channels_by_id_.find(channel_id);
+  return it != channels_by_id_.end() ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     const rtc::SocketAddress& addr) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  ChannelPeerMap::const_iterator it = channels_by_peer_.find(addr);
+  return it != channels_by_peer_.end() ? it->second : NULL;
 }
 
 void TurnServerAllocation::SendResponse(TurnMessage* msg) {
@@ -957,16 +968,15 @@ void TurnServerAllocation::OnMessage(rtc::Message* msg) {
 }
 
 void TurnServerAllocation::OnPermissionDestroyed(Permission* perm) {
-  PermissionList::iterator it = std::find(perms_.begin(), perms_.end(), perm);
-  RTC_DCHECK(it != perms_.end());
-  perms_.erase(it);
+  size_t num_erased = perms_.erase(perm->peer());
+  RTC_DCHECK_EQ(1, num_erased);
 }
 
 void TurnServerAllocation::OnChannelDestroyed(Channel* channel) {
-  ChannelList::iterator it =
-      std::find(channels_.begin(), channels_.end(), channel);
-  RTC_DCHECK(it != channels_.end());
-  channels_.erase(it);
+  size_t num_erased = channels_by_id_.erase(channel->id());
+  RTC_DCHECK_EQ(1, num_erased);
+  num_erased = channels_by_peer_.erase(channel->peer());
+  RTC_DCHECK_EQ(1, num_erased);
 }
 
 TurnServerAllocation::Permission::Permission(rtc::Thread* thread,
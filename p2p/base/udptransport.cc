@@ -121,7 +121,7 @@ void UdpTransport::OnSocketReadPacket(rtc::AsyncPacketSocket* socket,
                                       const rtc::SocketAddress& remote_addr,
                                       const rtc::PacketTime& packet_time) {
   // No thread_checker in high frequency network function.
-  SignalReadPacket(this, data, len, packet_time, 0);
+  NotifyPacketReceived(data, len, packet_time, 0);
 }
 
 void UdpTransport::OnSocketSentPacket(rtc::AsyncPacketSocket* socket,
@@ -41,6 +41,7 @@ enum {
   MSG_SEQUENCEOBJECTS_CREATED,
   MSG_CONFIG_STOP,
   MSG_SIGNAL_ANY_ADDRESS_PORTS,
+  MSG_SERVER_HOSTNAMES_RESOLVED,
 };
 
 const int PHASE_UDP = 0;
@@ -294,6 +295,10 @@ BasicPortAllocatorSession::~BasicPortAllocatorSession() {
   for (it = ports_.begin(); it != ports_.end(); it++)
     delete it->port();
 
+  for (auto& hostname_and_resolver : server_resolvers_) {
+    hostname_and_resolver.second->Destroy(false);
+  }
+
   for (uint32_t i = 0; i < configs_.size(); ++i)
     delete configs_[i];
 
@@ -574,6 +579,10 @@ void BasicPortAllocatorSession::OnMessage(rtc::Message* message) {
       RTC_DCHECK(rtc::Thread::Current() == network_thread_);
       SignalAnyAddressPortsAndCandidatesReadyIfNotRedundant();
       break;
+    case MSG_SERVER_HOSTNAMES_RESOLVED:
+      RTC_DCHECK(rtc::Thread::Current() == network_thread_);
+      OnServerHostnamesResolved();
+      break;
     default:
       RTC_NOTREACHED();
   }
@@ -593,9 +602,92 @@ void BasicPortAllocatorSession::GetPortConfigurations() {
   for (const RelayServerConfig& turn_server : allocator_->turn_servers()) {
     config->AddRelay(turn_server);
   }
+  if ((flags() & PORTALLOCATOR_ENABLE_PARALLEL_GATHERING) &&
+      ResolveServerHostnames(config)) {
+    pending_config_.reset(config);
+    network_thread_->PostDelayed(RTC_FROM_HERE, kMaxServerResolveDelay, this,
+                                 MSG_SERVER_HOSTNAMES_RESOLVED);
+    return;
+  }
   ConfigReady(config);
 }
 
+bool BasicPortAllocatorSession::ResolveServerHostnames(
+    PortConfiguration* config) {
+  const ServerAddresses stun_servers = config->StunServers();
+  std::vector<rtc::SocketAddress> addresses(stun_servers.begin(),
+                                            stun_servers.end());
+  for (const RelayServerConfig& relay : config->relays) {
+    for (const ProtocolAddress& relay_port : relay.ports) {
+      addresses.push_back(relay_port.address);
+    }
+  }
+
+  for (const rtc::SocketAddress& address : addresses) {
+    if (!address.IsUnresolvedIP() ||
+        server_resolvers_.find(address.hostname()) != server_resolvers_.end()) {
+      continue;
+    }
+    RTC_LOG(LS_INFO) << "Starting server host lookup for "
+                     << address.ToSensitiveString();
+    rtc::AsyncResolverInterface* resolver =
+        socket_factory_->CreateAsyncResolver();
+    resolver->SignalDone.connect(
+        this, &BasicPortAllocatorSession::OnServerHostnameResolved);
+    server_resolvers_[address.hostname()] = resolver;
+    ++num_pending_server_resolutions_;
+    resolver->Start(address);
+  }
+  return num_pending_server_resolutions_ > 0;
+}
+
+void BasicPortAllocatorSession::OnServerHostnameResolved(
+    rtc::AsyncResolverInterface* resolver) {
+  RTC_DCHECK_GT(num_pending_server_resolutions_, 0);
+  if (resolver->GetError() != 0) {
+    RTC_LOG(LS_WARNING) << "Server host lookup failed with error "
+                        << resolver->GetError();
+  }
+  if (--num_pending_server_resolutions_ == 0) {
+    network_thread_->Clear(this, MSG_SERVER_HOSTNAMES_RESOLVED);
+    OnServerHostnamesResolved();
+  }
+}
+
+void BasicPortAllocatorSession::OnServerHostnamesResolved() {
+  if (pending_config_) {
+    ConfigReady(pending_config_.release());
+  }
+}
+
+rtc::SocketAddress BasicPortAllocatorSession::GetResolvedServerAddress(
+    const rtc::SocketAddress& address,
+    int family) const {
+  if (!address.IsUnresolvedIP()) {
+    return address;
+  }
+  auto it = server_resolvers_.find(address.hostname());
+  rtc::SocketAddress resolved_address;
+  if (it == server_resolvers_.end() ||
+      !it->second->GetResolvedAddress(family, &resolved_address)) {
+    return address;
+  }
+  // Keep the hostname, which TLS needs.
+  rtc::SocketAddress server_address = address;
+  server_address.SetResolvedIP(resolved_address.ipaddr());
+  return server_address;
+}
+
+ServerAddresses BasicPortAllocatorSession::GetResolvedServerAddresses(
+    const ServerAddresses& addresses,
+    int family) const {
+  ServerAddresses resolved_addresses;
+  for (const rtc::SocketAddress& address : addresses) {
+    resolved_addresses.insert(GetResolvedServerAddress(address, family));
+  }
+  return resolved_addresses;
+}
+
 void BasicPortAllocatorSession::ConfigReady(PortConfiguration* config) {
   network_thread_->Post(RTC_FROM_HERE, this, MSG_CONFIG_READY, config);
 }
@@ -1340,8 +1432,9 @@ void AllocationSequence::Init() {
         rtc::SocketAddress(network_->GetBestIP(), 0),
         session_->allocator()->min_port(), session_->allocator()->max_port()));
     if (udp_socket_) {
-      udp_socket_->SignalReadPacket.connect(this,
-                                            &AllocationSequence::OnReadPacket);
+      udp_socket_->SetReadPacketCallback(
+          rtc::AsyncPacketSocket::ReadPacketCallback::Create<
+              AllocationSequence, &AllocationSequence::OnReadPacket>(this));
     }
     // Continuing if |udp_socket_| is null, as local TCP and RelayPort using
     // TCP are next available options to setup a communication channel.
@@ -1442,31 +1535,38 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
 
   const char* const PHASE_NAMES[kNumPhases] = {"Udp", "Relay", "Tcp"};
 
-  // Perform all of the phases in the current step.
-  RTC_LOG(LS_INFO) << network_->ToString()
-                   << ": Allocation Phase=" << PHASE_NAMES[phase_];
+  // With parallel gathering, all the phases are performed in the first step.
+  const bool parallel = IsFlagSet(PORTALLOCATOR_ENABLE_PARALLEL_GATHERING);
+  do {
+    // Perform all of the phases in the current step.
+    RTC_LOG(LS_INFO) << network_->ToString()
+                     << ": Allocation Phase=" << PHASE_NAMES[phase_];
+
+    switch (phase_) {
+      case PHASE_UDP:
+        CreateUDPPorts();
+        CreateStunPorts();
+        break;
 
-  switch (phase_) {
-    case PHASE_UDP:
-      CreateUDPPorts();
-      CreateStunPorts();
-      break;
+      case PHASE_RELAY:
+        CreateRelayPorts();
+        break;
 
-    case PHASE_RELAY:
-      CreateRelayPorts();
-      break;
+      case PHASE_TCP:
+        CreateTCPPorts();
+        state_ = kCompleted;
+        break;
 
-    case PHASE_TCP:
-      CreateTCPPorts();
-      state_ = kCompleted;
-      break;
+      default:
+        RTC_NOTREACHED();
+    }
 
-    default:
-      RTC_NOTREACHED();
-  }
+    if (state() == kRunning) {
+      ++phase_;
+    }
+  } while (parallel && state() == kRunning);
 
   if (state() == kRunning) {
-    ++phase_;
     session_->network_thread()->PostDelayed(RTC_FROM_HERE,
                                             session_->allocator()->step_delay(),
                                             this, MSG_ALLOCATION_PHASE);
@@ -1517,7 +1617,8 @@ void AllocationSequence::CreateUDPPorts() {
           RTC_LOG(LS_INFO)
               << "AllocationSequence: UDPPort will be handling the "
                  "STUN candidate generation.";
-          port->set_server_addresses(config_->StunServers());
+          port->set_server_addresses(session_->GetResolvedServerAddresses(
+              config_->StunServers(), network_->GetBestIP().family()));
         }
       }
     }
@@ -1563,7 +1664,9 @@ void AllocationSequence::CreateStunPorts() {
   StunPort* port = StunPort::Create(
       session_->network_thread(), session_->socket_factory(), network_,
       session_->allocator()->min_port(), session_->allocator()->max_port(),
-      session_->username(), session_->password(), config_->StunServers(),
+      session_->username(), session_->password(),
+      session_->GetResolvedServerAddresses(config_->StunServers(),
+                                           network_->GetBestIP().family()),
       session_->allocator()->origin(),
       session_->allocator()->stun_candidate_keepalive_interval());
   if (port) {
@@ -1651,6 +1754,10 @@ void AllocationSequence::CreateTurnPort(const RelayServerConfig& config) {
           << " Local address: " << network_->GetBestIP().ToString();
       continue;
     }
+    const ProtocolAddress server_address(
+        session_->GetResolvedServerAddress(relay_port->address,
+                                           local_ip_family),
+        relay_port->proto);
 
     CreateRelayPortArgs args;
     args.network_thread = session_->network_thread();
@@ -1658,7 +1765,7 @@ void AllocationSequence::CreateTurnPort(const RelayServerConfig& config) {
     args.network = network_;
     args.username = session_->username();
     args.password = session_->password();
-    args.server_address = &(*relay_port);
+    args.server_address = &server_address;
     args.config = &config;
     args.origin = session_->allocator()->origin();
     args.turn_customizer = session_->allocator()->turn_customizer();
@@ -11,6 +11,7 @@
 #ifndef P2P_CLIENT_BASICPORTALLOCATOR_H_
 #define P2P_CLIENT_BASICPORTALLOCATOR_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,6 +20,7 @@
 #include "p2p/base/portallocator.h"
 #include "p2p/client/relayportfactoryinterface.h"
 #include "p2p/client/turnportfactory.h"
+#include "rtc_base/asyncresolverinterface.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/messagequeue.h"
 #include "rtc_base/network.h"
@@ -214,6 +216,19 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
 
   void OnConfigReady(PortConfiguration* config);
   void OnConfigStop();
+  // Starts resolving the hostnames of the servers in |config|. Returns false
+  // if there are none to resolve.
+  bool ResolveServerHostnames(PortConfiguration* config);
+  void OnServerHostnameResolved(rtc::AsyncResolverInterface* resolver);
+  // Makes |pending_config_| ready, whether or not all the hostnames are
+  // resolved.
+  void OnServerHostnamesResolved();
+  // Returns |address| with the IP that its hostname was resolved to for
+  // |family| by ResolveServerHostnames(), or |address| itself otherwise.
+  rtc::SocketAddress GetResolvedServerAddress(const rtc::SocketAddress& address,
+                                              int family) const;
+  ServerAddresses GetResolvedServerAddresses(const ServerAddresses& addresses,
+                                             int family) const;
   void AllocatePorts();
   void OnAllocate();
   void DoAllocate(bool disable_equivalent_phases);
@@ -276,6 +291,11 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   bool network_manager_started_;
   bool allocation_sequences_created_;
   std::vector<PortConfiguration*> configs_;
+  // The configuration waiting for its server hostnames to resolve.
+  std::unique_ptr<PortConfiguration> pending_config_;
+  // Keyed by hostname.
+  std::map<std::string, rtc::AsyncResolverInterface*> server_resolvers_;
+  int num_pending_server_resolutions_ = 0;
   std::vector<AllocationSequence*> sequences_;
   std::vector<PortData> ports_;
   uint32_t candidate_filter_ = CF_ALL;
@@ -18,6 +18,7 @@
 #include "p2p/base/testrelayserver.h"
 #include "p2p/base/teststunserver.h"
 #include "p2p/base/testturnserver.h"
+#include "p2p/base/turnport.h"
 #include "p2p/client/basicportallocator.h"
 #include "rtc_base/fakeclock.h"
 #include "rtc_base/fakenetwork.h"
@@ -1172,6 +1173,23 @@ TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithOneSecondStepDelay) {
   session_->StopGettingPorts();
 }
 
+// Verify that with parallel gathering all the candidates are gathered without
+// waiting for the step delay.
+TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithParallelGathering) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_PARALLEL_GATHERING);
+  ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  // Host, STUN, relay and TCP candidates from kClientAddr.
+  ASSERT_EQ_SIMULATED_WAIT(7U, candidates_.size(), 1000, fake_clock);
+  EXPECT_EQ(4U, ports_.size());
+  EXPECT_TRUE(HasCandidate(candidates_, "relay", "udp", kRelayUdpIntAddr));
+  EXPECT_TRUE(HasCandidate(candidates_, "local", "tcp", kClientAddr));
+  EXPECT_TRUE_SIMULATED_WAIT(candidate_allocation_done_, 1000, fake_clock);
+}
+
 TEST_F(BasicPortAllocatorTest, TestSetupVideoRtpPortsWithNormalSendBuffers) {
   AddInterface(kClientAddr);
   ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP, CN_VIDEO));
@@ -1812,6 +1830,43 @@ TEST_F(BasicPortAllocatorTestWithRealClock,
   EXPECT_EQ_WAIT(2U, ports_.size(), kDefaultAllocationTimeout);
 }
 
+// Test that with parallel gathering, the session resolves the TURN server
+// hostname before creating the TurnPort.
+TEST_F(BasicPortAllocatorTestWithRealClock,
+       TestParallelGatheringWithServerAddressResolve) {
+  // This test relies on a real query for "localhost", so it won't work on an
+  // IPv6-only machine.
+  MAYBE_SKIP_IPV4;
+  turn_server_.AddInternalSocket(rtc::SocketAddress("127.0.0.1", 3478),
+                                 PROTO_UDP);
+  AddInterface(kClientAddr);
+  allocator_.reset(new BasicPortAllocator(&network_manager_));
+  allocator_->Initialize();
+  RelayServerConfig turn_server(RELAY_TURN);
+  RelayCredentials credentials(kTurnUsername, kTurnPassword);
+  turn_server.credentials = credentials;
+  turn_server.ports.push_back(
+      ProtocolAddress(rtc::SocketAddress("localhost", 3478), PROTO_UDP));
+  allocator_->AddTurnServer(turn_server);
+
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_SHARED_SOCKET |
+                        PORTALLOCATOR_DISABLE_TCP |
+                        PORTALLOCATOR_ENABLE_PARALLEL_GATHERING);
+
+  ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+
+  EXPECT_EQ_WAIT(2U, ports_.size(), kDefaultAllocationTimeout);
+  for (PortInterface* port : ports_) {
+    if (port->Type() == RELAY_PORT_TYPE) {
+      TurnPort* turn_port = static_cast<TurnPort*>(port);
+      EXPECT_FALSE(turn_port->server_address().address.IsUnresolvedIP());
+      EXPECT_EQ("localhost", turn_port->server_address().address.hostname());
+    }
+  }
+}
+
 // Test that when PORTALLOCATOR_ENABLE_SHARED_SOCKET is enabled only one port
 // is allocated for udp/stun/turn. In this test we should expect all local,
 // stun and turn candidates.
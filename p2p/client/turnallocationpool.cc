@@ -0,0 +1,203 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/client/turnallocationpool.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "p2p/base/p2pconstants.h"
+#include "p2p/base/turnport.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/logging.h"
+
+namespace cricket {
+
+namespace {
+
+// Whether |a| and |b| are the same server, where either may be resolved to an
+// IP already.
+bool IsSameServer(const ProtocolAddress& a, const ProtocolAddress& b) {
+  if (a.proto != b.proto || a.address.port() != b.address.port()) {
+    return false;
+  }
+  if (!a.address.hostname().empty() || !b.address.hostname().empty()) {
+    return a.address.hostname() == b.address.hostname();
+  }
+  return a.address.ipaddr() == b.address.ipaddr();
+}
+
+}  // namespace
+
+TurnAllocationPool::Pool::Pool(rtc::Network* network,
+                               const RelayServerConfig& config,
+                               const ProtocolAddress& server_address)
+    : network(network), config(config), server_address(server_address) {}
+
+TurnAllocationPool::Pool::~Pool() {
+  for (TurnPort* port : ports) {
+    delete port;
+  }
+}
+
+TurnAllocationPool::TurnAllocationPool(rtc::Thread* network_thread,
+                                       rtc::PacketSocketFactory* socket_factory)
+    : network_thread_(network_thread), socket_factory_(socket_factory) {
+  RTC_DCHECK(network_thread_);
+  RTC_DCHECK(socket_factory_);
+}
+
+TurnAllocationPool::~TurnAllocationPool() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+}
+
+void TurnAllocationPool::SetPoolSize(rtc::Network* network,
+                                     const RelayServerConfig& config,
+                                     size_t size) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  RTC_DCHECK_EQ(RELAY_TURN, config.type);
+  for (const ProtocolAddress& server_address : config.ports) {
+    auto it = std::find_if(
+        pools_.begin(), pools_.end(),
+        [network, &config, &server_address](const std::unique_ptr<Pool>& p) {
+          return p->network == network && p->config == config &&
+                 p->server_address == server_address;
+        });
+    if (it == pools_.end()) {
+      if (size == 0) {
+        continue;
+      }
+      pools_.push_back(
+          absl::make_unique<Pool>(network, config, server_address));
+      it = pools_.end() - 1;
+    }
+    Pool* pool = it->get();
+    pool->size = size;
+    // Release the allocations over the new size, newest first.
+    while (pool->ports.size() > pool->size) {
+      delete pool->ports.back();
+      pool->ports.pop_back();
+    }
+    if (pool->size == 0) {
+      pools_.erase(it);
+      continue;
+    }
+    Fill(pool);
+  }
+}
+
+std::unique_ptr<Port> TurnAllocationPool::Claim(const CreateRelayPortArgs& args,
+                                                int min_port,
+                                                int max_port) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (min_port != 0 || max_port != 0 || !args.origin.empty() ||
+      args.turn_customizer) {
+    return nullptr;
+  }
+  for (auto& pool : pools_) {
+    if (!CanClaim(*pool, args)) {
+      continue;
+    }
+    auto it = std::find_if(pool->ports.begin(), pool->ports.end(),
+                           [](TurnPort* port) { return port->ready(); });
+    if (it == pool->ports.end()) {
+      Fill(pool.get());
+      continue;
+    }
+    TurnPort* port = *it;
+    pool->ports.erase(it);
+    port->SignalPortError.disconnect(this);
+    port->SignalTurnPortClosed.disconnect(this);
+    port->SetIceParameters(port->component(), args.username, args.password);
+    RTC_LOG(LS_INFO) << port->ToString() << ": Claimed from the pool";
+    Fill(pool.get());
+    return std::unique_ptr<Port>(port);
+  }
+  return nullptr;
+}
+
+size_t TurnAllocationPool::num_ready() const {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  size_t num_ready = 0;
+  for (const auto& pool : pools_) {
+    num_ready += std::count_if(pool->ports.begin(), pool->ports.end(),
+                               [](TurnPort* port) { return port->ready(); });
+  }
+  return num_ready;
+}
+
+void TurnAllocationPool::Fill(Pool* pool) {
+  // An allocation that has a candidate but is no longer ready failed to
+  // refresh.
+  auto lost = std::partition(
+      pool->ports.begin(), pool->ports.end(), [](TurnPort* port) {
+        return port->ready() || port->Candidates().empty();
+      });
+  for (auto it = lost; it != pool->ports.end(); ++it) {
+    RTC_LOG(LS_WARNING) << (*it)->ToString() << ": Pooled allocation lost";
+    delete *it;
+  }
+  pool->ports.erase(lost, pool->ports.end());
+
+  while (pool->ports.size() < pool->size) {
+    // The ICE parameters are replaced when the port is claimed.
+    TurnPort* port = TurnPort::Create(
+        network_thread_, socket_factory_, pool->network, 0, 0,
+        rtc::CreateRandomString(ICE_UFRAG_LENGTH),
+        rtc::CreateRandomString(ICE_PWD_LENGTH), pool->server_address,
+        pool->config.credentials, pool->config.priority, std::string(),
+        pool->config.tls_alpn_protocols, pool->config.tls_elliptic_curves,
+        nullptr, pool->config.tls_cert_verifier);
+    if (!port) {
+      return;
+    }
+    port->SetTlsCertPolicy(pool->config.tls_cert_policy);
+    // Without connections, a port destroys itself unless it is kept alive.
+    port->KeepAliveUntilPruned();
+    port->SignalPortError.connect(this, &TurnAllocationPool::OnPortError);
+    port->SignalTurnPortClosed.connect(this,
+                                       &TurnAllocationPool::OnTurnPortClosed);
+    pool->ports.push_back(port);
+    port->PrepareAddress();
+  }
+}
+
+bool TurnAllocationPool::CanClaim(const Pool& pool,
+                                  const CreateRelayPortArgs& args) const {
+  return args.network_thread == network_thread_ &&
+         args.socket_factory == socket_factory_ &&
+         args.network == pool.network && *args.config == pool.config &&
+         IsSameServer(*args.server_address, pool.server_address);
+}
+
+void TurnAllocationPool::OnPortError(Port* port) {
+  RTC_LOG(LS_WARNING) << port->ToString() << ": Pooled allocation failed";
+  RemovePort(static_cast<TurnPort*>(port));
+}
+
+void TurnAllocationPool::OnTurnPortClosed(TurnPort* port) {
+  RemovePort(port);
+}
+
+void TurnAllocationPool::RemovePort(TurnPort* port) {
+  invoker_.AsyncInvoke<void>(RTC_FROM_HERE, network_thread_, [this, port] {
+    for (auto& pool : pools_) {
+      auto it = std::find(pool->ports.begin(), pool->ports.end(), port);
+      if (it != pool->ports.end()) {
+        pool->ports.erase(it);
+        delete port;
+        return;
+      }
+    }
+  });
+}
+
+}  // namespace cricket
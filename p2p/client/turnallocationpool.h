@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_CLIENT_TURNALLOCATIONPOOL_H_
+#define P2P_CLIENT_TURNALLOCATIONPOOL_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "p2p/base/port.h"
+#include "p2p/base/portallocator.h"
+#include "p2p/client/relayportfactoryinterface.h"
+#include "rtc_base/asyncinvoker.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/network.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_checker.h"
+
+namespace cricket {
+
+class TurnPort;
+
+// Keeps TURN allocations ready before they are needed, so that a new session
+// gets its relay candidates without the ALLOCATE round trips. The allocations
+// are kept alive with refreshes while they wait, and handed over with
+// Claim(), after which the pool starts another allocation to replace them.
+// Permissions and channels are created on demand by the TurnPort, as usual.
+//
+// The pool is meant to be shared by the port allocators of a process, through
+// TurnPortFactory. It only hands over ports created on the same network
+// thread, with the same socket factory and network, as the claimed ones.
+// Must be used on |network_thread|.
+class TurnAllocationPool : public sigslot::has_slots<> {
+ public:
+  TurnAllocationPool(rtc::Thread* network_thread,
+                     rtc::PacketSocketFactory* socket_factory);
+  ~TurnAllocationPool() override;
+
+  // Keeps |size| allocations ready on |network| with each server address of
+  // |config|, which must be a RELAY_TURN config. Setting a size of 0 releases
+  // the allocations.
+  void SetPoolSize(rtc::Network* network,
+                   const RelayServerConfig& config,
+                   size_t size);
+
+  // Returns a ready port that can be used for |args|, with the ICE
+  // parameters of |args|, or null if there is none. The pool no longer owns
+  // the port, which gathers its candidate again on PrepareAddress(). The
+  // pooled ports have no origin or TURN customizer, and are bound to any
+  // local port, so they are not used for |args| with these or a port range.
+  std::unique_ptr<Port> Claim(const CreateRelayPortArgs& args,
+                              int min_port,
+                              int max_port);
+
+  // The number of ports ready to be claimed.
+  size_t num_ready() const;
+
+ private:
+  struct Pool {
+    Pool(rtc::Network* network,
+         const RelayServerConfig& config,
+         const ProtocolAddress& server_address);
+    ~Pool();
+
+    rtc::Network* network;
+    RelayServerConfig config;
+    ProtocolAddress server_address;
+    size_t size = 0;
+    std::vector<TurnPort*> ports;
+  };
+
+  // Drops the allocations of |pool| that failed to refresh, and starts
+  // allocations until it has |pool->size| ports.
+  void Fill(Pool* pool);
+  bool CanClaim(const Pool& pool, const CreateRelayPortArgs& args) const;
+  void OnPortError(Port* port);
+  void OnTurnPortClosed(TurnPort* port);
+  // Removes |port| from its pool and destroys it, once it is done
+  // signaling. The pool is filled again on the next Claim(), so that a
+  // failing server is not retried in a loop.
+  void RemovePort(TurnPort* port);
+
+  rtc::ThreadChecker thread_checker_;
+  rtc::Thread* const network_thread_;
+  rtc::PacketSocketFactory* const socket_factory_;
+  std::vector<std::unique_ptr<Pool>> pools_;
+  rtc::AsyncInvoker invoker_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(TurnAllocationPool);
+};
+
+}  // namespace cricket
+
+#endif  // P2P_CLIENT_TURNALLOCATIONPOOL_H_
@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/client/turnallocationpool.h"
+
+#include <memory>
+#include <vector>
+
+#include "p2p/base/basicpacketsocketfactory.h"
+#include "p2p/base/testturnserver.h"
+#include "p2p/client/turnportfactory.h"
+#include "rtc_base/fakeclock.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/virtualsocketserver.h"
+
+namespace cricket {
+
+namespace {
+
+const rtc::SocketAddress kLocalAddr1("11.11.11.11", 0);
+const rtc::SocketAddress kLocalAddr2("22.22.22.22", 0);
+const rtc::SocketAddress kTurnUdpIntAddr("99.99.99.3", TURN_SERVER_PORT);
+const rtc::SocketAddress kTurnUdpExtAddr("99.99.99.5", 0);
+const char kIceUfrag[] = "TESTICEUFRAG0001";
+const char kIcePwd[] = "TESTICEPWD00000000000001";
+const char kTurnUsername[] = "test";
+const char kTurnPassword[] = "test";
+const int kTimeoutMs = 10000;
+
+}  // namespace
+
+class TurnAllocationPoolTest : public testing::Test,
+                               public sigslot::has_slots<> {
+ public:
+  TurnAllocationPoolTest()
+      : ss_(new rtc::VirtualSocketServer()),
+        main_(ss_.get()),
+        socket_factory_(rtc::Thread::Current()),
+        turn_server_(&main_, kTurnUdpIntAddr, kTurnUdpExtAddr),
+        network1_("unittest1", "unittest1", kLocalAddr1.ipaddr(), 32),
+        network2_("unittest2", "unittest2", kLocalAddr2.ipaddr(), 32),
+        server_address_(kTurnUdpIntAddr, PROTO_UDP),
+        config_(RELAY_TURN),
+        pool_(rtc::Thread::Current(), &socket_factory_) {
+    // Some code uses "last received time == 0" to represent "nothing received
+    // so far", so we need to start the fake clock at a nonzero time.
+    fake_clock_.AdvanceTime(webrtc::TimeDelta::seconds(1));
+    network1_.AddIP(kLocalAddr1.ipaddr());
+    network2_.AddIP(kLocalAddr2.ipaddr());
+    config_.credentials = RelayCredentials(kTurnUsername, kTurnPassword);
+    config_.ports.push_back(server_address_);
+  }
+
+  CreateRelayPortArgs MakeArgs(rtc::Network* network) {
+    CreateRelayPortArgs args;
+    args.network_thread = rtc::Thread::Current();
+    args.socket_factory = &socket_factory_;
+    args.network = network;
+    args.server_address = &server_address_;
+    args.config = &config_;
+    args.username = kIceUfrag;
+    args.password = kIcePwd;
+    args.turn_customizer = nullptr;
+    return args;
+  }
+
+  void ListenForCandidates(Port* port) {
+    port->SignalCandidateReady.connect(
+        this, &TurnAllocationPoolTest::OnCandidateReady);
+  }
+
+  void OnCandidateReady(Port* port, const Candidate& candidate) {
+    candidates_.push_back(candidate);
+  }
+
+ protected:
+  rtc::ScopedFakeClock fake_clock_;
+  std::unique_ptr<rtc::VirtualSocketServer> ss_;
+  rtc::AutoSocketServerThread main_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  TestTurnServer turn_server_;
+  rtc::Network network1_;
+  rtc::Network network2_;
+  const ProtocolAddress server_address_;
+  RelayServerConfig config_;
+  TurnAllocationPool pool_;
+  std::vector<Candidate> candidates_;
+};
+
+// A claimed port signals its candidate with the ICE parameters of its session
+// without another allocation, and the pool allocates a replacement.
+TEST_F(TurnAllocationPoolTest, ClaimedPortIsReadyAndReplaced) {
+  pool_.SetPoolSize(&network1_, config_, 1);
+  EXPECT_EQ_SIMULATED_WAIT(1u, pool_.num_ready(), kTimeoutMs, fake_clock_);
+
+  TurnPortFactory factory(&pool_);
+  const CreateRelayPortArgs args = MakeArgs(&network1_);
+  std::unique_ptr<Port> port = factory.Create(args, 0, 0);
+  ASSERT_TRUE(port);
+  EXPECT_EQ(kIceUfrag, port->username_fragment());
+  port->set_component(ICE_CANDIDATE_COMPONENT_RTCP);
+  ListenForCandidates(port.get());
+  port->PrepareAddress();
+  ASSERT_EQ(1u, candidates_.size());
+  EXPECT_EQ(RELAY_PORT_TYPE, candidates_[0].type());
+  EXPECT_EQ(kIceUfrag, candidates_[0].username());
+  EXPECT_EQ(ICE_CANDIDATE_COMPONENT_RTCP, candidates_[0].component());
+  ASSERT_EQ(1u, port->Candidates().size());
+
+  EXPECT_EQ_SIMULATED_WAIT(1u, pool_.num_ready(), kTimeoutMs, fake_clock_);
+  EXPECT_EQ(2u, turn_server_.server()->allocations().size());
+}
+
+TEST_F(TurnAllocationPoolTest, DoesNotClaimForOtherNetworkOrPortRange) {
+  pool_.SetPoolSize(&network1_, config_, 1);
+  EXPECT_EQ_SIMULATED_WAIT(1u, pool_.num_ready(), kTimeoutMs, fake_clock_);
+
+  EXPECT_FALSE(pool_.Claim(MakeArgs(&network2_), 0, 0));
+  EXPECT_FALSE(pool_.Claim(MakeArgs(&network1_), 10000, 20000));
+  RelayServerConfig other_config = config_;
+  other_config.credentials.password = "other";
+  CreateRelayPortArgs args = MakeArgs(&network1_);
+  args.config = &other_config;
+  EXPECT_FALSE(pool_.Claim(args, 0, 0));
+  EXPECT_EQ(1u, pool_.num_ready());
+
+  // Without a pooled port, the factory allocates a new one.
+  TurnPortFactory factory(&pool_);
+  std::unique_ptr<Port> port = factory.Create(MakeArgs(&network2_), 0, 0);
+  ASSERT_TRUE(port);
+  EXPECT_TRUE(port->Candidates().empty());
+}
+
+TEST_F(TurnAllocationPoolTest, SizeZeroReleasesTheAllocations) {
+  pool_.SetPoolSize(&network1_, config_, 2);
+  EXPECT_EQ_SIMULATED_WAIT(2u, pool_.num_ready(), kTimeoutMs, fake_clock_);
+  pool_.SetPoolSize(&network1_, config_, 0);
+  EXPECT_EQ(0u, pool_.num_ready());
+  EXPECT_FALSE(pool_.Claim(MakeArgs(&network1_), 0, 0));
+}
+
+}  // namespace cricket
@@ -13,9 +13,14 @@
 #include <memory>
 
 #include "p2p/base/turnport.h"
+#include "p2p/client/turnallocationpool.h"
 
 namespace cricket {
 
+TurnPortFactory::TurnPortFactory() : pool_(nullptr) {}
+
+TurnPortFactory::TurnPortFactory(TurnAllocationPool* pool) : pool_(pool) {}
+
 TurnPortFactory::~TurnPortFactory() {}
 
 std::unique_ptr<Port> TurnPortFactory::Create(
@@ -33,6 +38,12 @@ std::unique_ptr<Port> TurnPortFactory::Create(
 std::unique_ptr<Port> TurnPortFactory::Create(const CreateRelayPortArgs& args,
                                               int min_port,
                                               int max_port) {
+  if (pool_) {
+    std::unique_ptr<Port> port = pool_->Claim(args, min_port, max_port);
+    if (port) {
+      return port;
+    }
+  }
   TurnPort* port = TurnPort::Create(
       args.network_thread, args.socket_factory, args.network, min_port,
       max_port, args.username, args.password, *args.server_address,
@@ -17,9 +17,15 @@
 
 namespace cricket {
 
+class TurnAllocationPool;
+
 // This is a RelayPortFactory that produces TurnPorts.
 class TurnPortFactory : public RelayPortFactoryInterface {
  public:
+  TurnPortFactory();
+  // Claims the ports from |pool| when it has ready ones, which saves the
+  // round trips of the allocation. Does not take ownership of |pool|.
+  explicit TurnPortFactory(TurnAllocationPool* pool);
   ~TurnPortFactory() override;
 
   std::unique_ptr<Port> Create(const CreateRelayPortArgs& args,
@@ -28,6 +34,9 @@ class TurnPortFactory : public RelayPortFactoryInterface {
   std::unique_ptr<Port> Create(const CreateRelayPortArgs& args,
                                int min_port,
                                int max_port) override;
+
+ private:
+  TurnAllocationPool* const pool_;
 };
 
 }  // namespace cricket
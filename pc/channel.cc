@@ -265,18 +265,76 @@ bool BaseChannel::SetLocalContent(const MediaContentDescription* content,
                                   SdpType type,
                                   std::string* error_desc) {
   TRACE_EVENT0("webrtc", "BaseChannel::SetLocalContent");
-  return InvokeOnWorker<bool>(
+  has_local_content_ = InvokeOnWorker<bool>(
       RTC_FROM_HERE,
       Bind(&BaseChannel::SetLocalContent_w, this, content, type, error_desc));
+  return has_local_content_;
 }
 
 bool BaseChannel::SetRemoteContent(const MediaContentDescription* content,
                                    SdpType type,
                                    std::string* error_desc) {
   TRACE_EVENT0("webrtc", "BaseChannel::SetRemoteContent");
-  return InvokeOnWorker<bool>(
+  has_remote_content_ = InvokeOnWorker<bool>(
       RTC_FROM_HERE,
       Bind(&BaseChannel::SetRemoteContent_w, this, content, type, error_desc));
+  return has_remote_content_;
+}
+
+// static
+bool BaseChannel::SetContents(
+    const std::vector<
+        std::pair<BaseChannel*, const MediaContentDescription*>>& contents,
+    SdpType type,
+    ContentSource source,
+    std::string* error_desc) {
+  if (contents.empty()) {
+    return true;
+  }
+  TRACE_EVENT0("webrtc", "BaseChannel::SetContents");
+  rtc::Thread* worker_thread = contents[0].first->worker_thread();
+  rtc::Thread* network_thread = contents[0].first->network_thread();
+  return worker_thread->Invoke<bool>(RTC_FROM_HERE, [&] {
+    // Runs on the worker thread, so each SetLocalContent or SetRemoteContent
+    // below runs without another thread hop.
+    size_t num_applied = 0;
+    bool success = true;
+    while (success && num_applied < contents.size()) {
+      BaseChannel* channel = contents[num_applied].first;
+      const MediaContentDescription* content = contents[num_applied].second;
+      RTC_DCHECK_EQ(worker_thread, channel->worker_thread());
+      RTC_DCHECK_EQ(network_thread, channel->network_thread());
+      channel->defer_network_work_ = true;
+      success = (source == CS_LOCAL)
+                    ? channel->SetLocalContent(content, type, error_desc)
+                    : channel->SetRemoteContent(content, type, error_desc);
+      channel->defer_network_work_ = false;
+      ++num_applied;
+    }
+    BaseChannel* failed_channel = network_thread->Invoke<BaseChannel*>(
+        RTC_FROM_HERE, [&contents, num_applied] {
+          BaseChannel* failed_channel = nullptr;
+          for (size_t i = 0; i < num_applied; ++i) {
+            if (!contents[i].first->RunDeferredNetworkWork_n() &&
+                !failed_channel) {
+              failed_channel = contents[i].first;
+            }
+          }
+          return failed_channel;
+        });
+    if (success && failed_channel) {
+      if (source == CS_LOCAL) {
+        failed_channel->has_local_content_ = false;
+      } else {
+        failed_channel->has_remote_content_ = false;
+      }
+      SafeSetError(
+          "Failed to set up RTP demuxing for " + failed_channel->content_name(),
+          error_desc);
+      success = false;
+    }
+    return success;
+  });
 }
 
 bool BaseChannel::IsReadyToReceiveMedia_w() const {
@@ -458,6 +516,10 @@ void BaseChannel::UpdateRtpHeaderExtensionMap(
   // NOTE: This doesn't take the BUNDLE case in account meaning the RTP header
   // extension maps are not merged when BUNDLE is enabled. This is fine because
   // the ID for MID should be consistent among all the RTP transports.
+  if (worker_thread_->IsCurrent() && defer_network_work_) {
+    deferred_header_extensions_ = header_extensions;
+    return;
+  }
   network_thread_->Invoke<void>(RTC_FROM_HERE, [this, &header_extensions] {
     rtp_transport_->UpdateRtpHeaderExtensionMap(header_extensions);
   });
@@ -465,11 +527,28 @@ void BaseChannel::UpdateRtpHeaderExtensionMap(
 
 bool BaseChannel::RegisterRtpDemuxerSink() {
   RTC_DCHECK(rtp_transport_);
+  if (worker_thread_->IsCurrent() && defer_network_work_) {
+    deferred_demuxer_sink_ = true;
+    return true;
+  }
   return network_thread_->Invoke<bool>(RTC_FROM_HERE, [this] {
     return rtp_transport_->RegisterRtpDemuxerSink(demuxer_criteria_, this);
   });
 }
 
+bool BaseChannel::RunDeferredNetworkWork_n() {
+  RTC_DCHECK(network_thread_->IsCurrent());
+  if (deferred_header_extensions_) {
+    rtp_transport_->UpdateRtpHeaderExtensionMap(*deferred_header_extensions_);
+    deferred_header_extensions_.reset();
+  }
+  if (!deferred_demuxer_sink_) {
+    return true;
+  }
+  deferred_demuxer_sink_ = false;
+  return rtp_transport_->RegisterRtpDemuxerSink(demuxer_criteria_, this);
+}
+
 void BaseChannel::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer* packet,
                                        const rtc::PacketTime& packet_time) {
   OnPacketReceived(/*rtcp=*/true, *packet, packet_time);
@@ -117,6 +117,21 @@ class BaseChannel : public rtc::MessageHandler,
   bool SetRemoteContent(const MediaContentDescription* content,
                         webrtc::SdpType type,
                         std::string* error_desc);
+  // Whether the last local or remote content was applied successfully.
+  bool has_local_content() const { return has_local_content_; }
+  bool has_remote_content() const { return has_remote_content_; }
+
+  // Applies the local or remote |contents| to their channels, which must share
+  // their worker and network threads. Rather than blocking on the worker and
+  // network threads for each channel, blocks on the worker thread once, which
+  // in turn does the network thread work of all the channels at once. Stops
+  // at the first channel that fails.
+  static bool SetContents(
+      const std::vector<
+          std::pair<BaseChannel*, const MediaContentDescription*>>& contents,
+      webrtc::SdpType type,
+      ContentSource source,
+      std::string* error_desc);
 
   bool Enable(bool enable);
 
@@ -292,6 +307,8 @@ class BaseChannel : public rtc::MessageHandler,
  private:
   bool ConnectToRtpTransport();
   void DisconnectFromRtpTransport();
+  // Does the network thread work that SetContents() deferred.
+  bool RunDeferredNetworkWork_n();
   void SignalSentPacket_n(const rtc::SentPacket& sent_packet);
   void SignalSentPacket_w(const rtc::SentPacket& sent_packet);
   bool IsReadyToSendMedia_n() const;
@@ -314,6 +331,15 @@ class BaseChannel : public rtc::MessageHandler,
   bool has_received_packet_ = false;
   const bool srtp_required_ = true;
   rtc::CryptoOptions crypto_options_;
+  // Written by SetLocalContent and SetRemoteContent, which the signaling
+  // thread calls or waits for.
+  bool has_local_content_ = false;
+  bool has_remote_content_ = false;
+  // While SetContents() runs on the worker thread, the network thread work of
+  // the channel is recorded here instead of being invoked.
+  bool defer_network_work_ = false;
+  absl::optional<RtpHeaderExtensions> deferred_header_extensions_;
+  bool deferred_demuxer_sink_ = false;
 
   // MediaChannel related members that should be accessed from the worker
   // thread.
@@ -577,6 +577,33 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
         CodecMatches(content.codecs()[0], media_channel1_->codecs()[0]));
   }
 
+  // Test that BaseChannel::SetContents applies the contents of several
+  // channels at once.
+  void TestSetContentsOfChannels() {
+    CreateChannels(0, 0);
+    typename T::Content content;
+    CreateContent(0, kPcmuCodec, kH264Codec, &content);
+    std::vector<std::pair<cricket::BaseChannel*,
+                          const cricket::MediaContentDescription*>>
+        contents = {{channel1_.get(), &content}, {channel2_.get(), &content}};
+    EXPECT_TRUE(cricket::BaseChannel::SetContents(contents, SdpType::kOffer,
+                                                  cricket::CS_LOCAL, NULL));
+    EXPECT_TRUE(channel1_->has_local_content());
+    EXPECT_TRUE(channel2_->has_local_content());
+    EXPECT_FALSE(channel1_->has_remote_content());
+    EXPECT_EQ(0U, media_channel1_->codecs().size());
+    EXPECT_TRUE(cricket::BaseChannel::SetContents(contents, SdpType::kAnswer,
+                                                  cricket::CS_REMOTE, NULL));
+    EXPECT_TRUE(channel1_->has_remote_content());
+    EXPECT_TRUE(channel2_->has_remote_content());
+    ASSERT_EQ(1U, media_channel1_->codecs().size());
+    EXPECT_TRUE(
+        CodecMatches(content.codecs()[0], media_channel1_->codecs()[0]));
+    ASSERT_EQ(1U, media_channel2_->codecs().size());
+    EXPECT_TRUE(
+        CodecMatches(content.codecs()[0], media_channel2_->codecs()[0]));
+  }
+
   // Test that SetLocalContent and SetRemoteContent properly deals
   // with an empty offer.
   void TestSetContentsNullOffer() {
@@ -1615,6 +1642,10 @@ TEST_F(VoiceChannelSingleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VoiceChannelSingleThreadTest, TestSetContentsOfChannels) {
+  Base::TestSetContentsOfChannels();
+}
+
 TEST_F(VoiceChannelSingleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -1750,6 +1781,10 @@ TEST_F(VoiceChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VoiceChannelDoubleThreadTest, TestSetContentsOfChannels) {
+  Base::TestSetContentsOfChannels();
+}
+
 TEST_F(VoiceChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -1883,6 +1918,10 @@ TEST_F(VideoChannelSingleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VideoChannelSingleThreadTest, TestSetContentsOfChannels) {
+  Base::TestSetContentsOfChannels();
+}
+
 TEST_F(VideoChannelSingleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -2016,6 +2055,10 @@ TEST_F(VideoChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VideoChannelDoubleThreadTest, TestSetContentsOfChannels) {
+  Base::TestSetContentsOfChannels();
+}
+
 TEST_F(VideoChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -2213,6 +2256,10 @@ TEST_F(RtpDataChannelSingleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(RtpDataChannelSingleThreadTest, TestSetContentsOfChannels) {
+  Base::TestSetContentsOfChannels();
+}
+
 TEST_F(RtpDataChannelSingleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -2297,6 +2344,10 @@ TEST_F(RtpDataChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(RtpDataChannelDoubleThreadTest, TestSetContentsOfChannels) {
+  Base::TestSetContentsOfChannels();
+}
+
 TEST_F(RtpDataChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -66,6 +66,7 @@ void ChannelManager::GetSupportedAudioSendCodecs(
   if (!media_engine_) {
     return;
   }
+  EnsureMediaEngineInitialized();
   *codecs = media_engine_->audio_send_codecs();
 }
 
@@ -74,6 +75,7 @@ void ChannelManager::GetSupportedAudioReceiveCodecs(
   if (!media_engine_) {
     return;
   }
+  EnsureMediaEngineInitialized();
   *codecs = media_engine_->audio_recv_codecs();
 }
 
@@ -82,6 +84,7 @@ void ChannelManager::GetSupportedAudioRtpHeaderExtensions(
   if (!media_engine_) {
     return;
   }
+  EnsureMediaEngineInitialized();
   *ext = media_engine_->GetAudioCapabilities().header_extensions;
 }
 
@@ -90,6 +93,7 @@ void ChannelManager::GetSupportedVideoCodecs(
   if (!media_engine_) {
     return;
   }
+  EnsureMediaEngineInitialized();
   codecs->clear();
 
   std::vector<VideoCodec> video_codecs = media_engine_->video_codecs();
@@ -107,6 +111,7 @@ void ChannelManager::GetSupportedVideoRtpHeaderExtensions(
   if (!media_engine_) {
     return;
   }
+  EnsureMediaEngineInitialized();
   *ext = media_engine_->GetVideoCapabilities().header_extensions;
 }
 
@@ -128,16 +133,26 @@ bool ChannelManager::Init() {
         RTC_FROM_HERE, [&] { network_thread_->SetAllowBlockingCalls(false); });
   }
 
-  if (media_engine_) {
-    initialized_ = worker_thread_->Invoke<bool>(
-        RTC_FROM_HERE, [&] { return media_engine_->Init(); });
-    RTC_DCHECK(initialized_);
-  } else {
-    initialized_ = true;
-  }
+  initialized_ = true;
   return initialized_;
 }
 
+void ChannelManager::EnsureMediaEngineInitialized() const {
+  if (!initialized_ || !media_engine_ ||
+      media_engine_initialized_.load(std::memory_order_acquire)) {
+    return;
+  }
+  worker_thread_->Invoke<void>(RTC_FROM_HERE, [this] {
+    // Another thread may have initialized it in the meantime.
+    if (media_engine_initialized_.load(std::memory_order_relaxed))
+      return;
+    TRACE_EVENT0("webrtc", "ChannelManager::InitMediaEngine");
+    bool result = media_engine_->Init();
+    RTC_DCHECK(result);
+    media_engine_initialized_.store(true, std::memory_order_release);
+  });
+}
+
 void ChannelManager::Terminate() {
   RTC_DCHECK(initialized_);
   if (!initialized_) {
@@ -175,6 +190,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
   if (!media_engine_) {
     return nullptr;
   }
+  EnsureMediaEngineInitialized();
 
   VoiceMediaChannel* media_channel =
       media_engine_->CreateChannel(call, media_config, options);
@@ -242,6 +258,7 @@ VideoChannel* ChannelManager::CreateVideoChannel(
   if (!media_engine_) {
     return nullptr;
   }
+  EnsureMediaEngineInitialized();
 
   VideoMediaChannel* media_channel =
       media_engine_->CreateVideoChannel(call, media_config, options);
@@ -345,6 +362,7 @@ void ChannelManager::DestroyRtpDataChannel(RtpDataChannel* data_channel) {
 
 bool ChannelManager::StartAecDump(rtc::PlatformFile file,
                                   int64_t max_size_bytes) {
+  EnsureMediaEngineInitialized();
   return worker_thread_->Invoke<bool>(RTC_FROM_HERE, [&] {
     return media_engine_->StartAecDump(file, max_size_bytes);
   });
@@ -11,6 +11,7 @@
 #ifndef PC_CHANNELMANAGER_H_
 #define PC_CHANNELMANAGER_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -57,7 +58,11 @@ class ChannelManager final {
     return true;
   }
 
-  MediaEngineInterface* media_engine() { return media_engine_.get(); }
+  // Initializes the media engine first if needed, see Init().
+  MediaEngineInterface* media_engine() {
+    EnsureMediaEngineInitialized();
+    return media_engine_.get();
+  }
 
   // Retrieves the list of supported audio & video codec types.
   // Can be called before starting the media engine.
@@ -70,7 +75,11 @@ class ChannelManager final {
 
   // Indicates whether the media engine is started.
   bool initialized() const { return initialized_; }
-  // Starts up the media engine.
+  // Starts up the media engine. The media engine itself, and with it the
+  // audio device, the audio processing and the codec lists, is initialized
+  // on the worker thread when it is first needed, i.e. when its codecs are
+  // queried, a channel is created or media_engine() is called, so that
+  // creating a factory which ends up not sending media is cheap.
   bool Init();
   // Shuts down the media engine.
   void Terminate();
@@ -139,9 +148,14 @@ class ChannelManager final {
   void StopAecDump();
 
  private:
+  // Must not be called on the network thread, which may not block.
+  void EnsureMediaEngineInitialized() const;
+
   std::unique_ptr<MediaEngineInterface> media_engine_;  // Nullable.
   std::unique_ptr<DataEngineInterface> data_engine_;    // Non-null.
   bool initialized_ = false;
+  // Set on the worker thread, read on any thread.
+  mutable std::atomic<bool> media_engine_initialized_{false};
   rtc::Thread* main_thread_;
   rtc::Thread* worker_thread_;
   rtc::Thread* network_thread_;
@@ -197,12 +197,18 @@ bool DataChannel::Init(const InternalDataChannelInit& config) {
 DataChannel::~DataChannel() {}
 
 void DataChannel::RegisterObserver(DataChannelObserver* observer) {
+  if (observer_on_network_thread_) {
+    observer_on_network_thread_ = false;
+    provider_->SetNetworkThreadObserver(config_.id, nullptr);
+  }
   observer_ = observer;
   DeliverQueuedReceivedData();
+  UpdateNetworkThreadObserver();
 }
 
 void DataChannel::UnregisterObserver() {
   observer_ = NULL;
+  UpdateNetworkThreadObserver();
 }
 
 bool DataChannel::reliable() const {
@@ -522,6 +528,7 @@ void DataChannel::SetState(DataState state) {
   }
 
   state_ = state;
+  UpdateNetworkThreadObserver();
   if (observer_) {
     observer_->OnStateChange();
   }
@@ -538,6 +545,23 @@ void DataChannel::DisconnectFromProvider() {
 
   provider_->DisconnectDataChannel(this);
   connected_to_provider_ = false;
+  UpdateNetworkThreadObserver();
+}
+
+void DataChannel::UpdateNetworkThreadObserver() {
+  // Only unordered messages may overtake the ones that are already queued or
+  // on their way to the signaling thread.
+  bool on_network_thread = data_channel_type_ == cricket::DCT_SCTP &&
+                           !config_.ordered && config_.id >= 0 &&
+                           state_ == kOpen && connected_to_provider_ &&
+                           observer_ &&
+                           observer_->IsOkToCallOnTheNetworkThread();
+  if (on_network_thread == observer_on_network_thread_) {
+    return;
+  }
+  observer_on_network_thread_ = on_network_thread;
+  provider_->SetNetworkThreadObserver(
+      config_.id, on_network_thread ? observer_ : nullptr);
 }
 
 void DataChannel::DeliverQueuedReceivedData() {
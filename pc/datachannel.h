@@ -47,6 +47,11 @@ class DataChannelProviderInterface {
   virtual void RemoveSctpDataStream(int sid) = 0;
   // Returns true if the transport channel is ready to send data.
   virtual bool ReadyToSendData() const = 0;
+  // Sets the observer that is given the DATA messages of SCTP stream |sid| on
+  // the network thread, or stops doing so if |observer| is null. Once this
+  // returns, the previous observer is no longer called.
+  virtual void SetNetworkThreadObserver(int sid,
+                                        DataChannelObserver* observer) = 0;
 
  protected:
   virtual ~DataChannelProviderInterface() {}
@@ -256,6 +261,9 @@ class DataChannel : public DataChannelInterface,
   void UpdateState();
   void SetState(DataState state);
   void DisconnectFromProvider();
+  // Sets or clears the network thread observer with the provider, depending on
+  // whether the channel and its observer allow it.
+  void UpdateNetworkThreadObserver();
 
   void DeliverQueuedReceivedData();
 
@@ -284,6 +292,8 @@ class DataChannel : public DataChannelInterface,
   bool writable_;
   // Did we already start the graceful SCTP closing procedure?
   bool started_closing_procedure_ = false;
+  // Is |observer_| set as the network thread observer with the provider?
+  bool observer_on_network_thread_ = false;
   uint32_t send_ssrc_;
   uint32_t receive_ssrc_;
   // Control messages that always have to get sent out before any queued
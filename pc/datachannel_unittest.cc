@@ -37,6 +37,10 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
 
   void OnMessage(const webrtc::DataBuffer& buffer) { ++messages_received_; }
 
+  bool IsOkToCallOnTheNetworkThread() override { return network_thread_ok_; }
+
+  void set_network_thread_ok(bool ok) { network_thread_ok_ = ok; }
+
   size_t messages_received() const { return messages_received_; }
 
   void ResetOnStateChangeCount() { on_state_change_count_ = 0; }
@@ -55,6 +59,7 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
   size_t messages_received_;
   size_t on_state_change_count_;
   size_t on_buffered_amount_change_count_;
+  bool network_thread_ok_ = false;
 };
 
 // TODO(deadbeef): The fact that these tests use a fake provider makes them not
@@ -349,6 +354,43 @@ TEST_F(SctpDataChannelTest, SendUnorderedAfterReceiveData) {
   EXPECT_FALSE(provider_->last_send_data_params().ordered);
 }
 
+// Tests that an open unordered channel sets an observer that is ok to call on
+// the network thread with the provider, and clears it when it closes.
+TEST_F(SctpDataChannelTest, NetworkThreadObserverForUnorderedChannel) {
+  SetChannelReady();
+  webrtc::InternalDataChannelInit init;
+  init.id = 1;
+  init.ordered = false;
+  init.maxRetransmits = 0;
+  rtc::scoped_refptr<DataChannel> dc =
+      DataChannel::Create(provider_.get(), cricket::DCT_SCTP, "test1", init);
+  EXPECT_EQ_WAIT(webrtc::DataChannelInterface::kOpen, dc->state(), 1000);
+
+  FakeDataChannelObserver observer;
+  dc->RegisterObserver(&observer);
+  EXPECT_EQ(nullptr, provider_->network_thread_observer(init.id));
+  dc->UnregisterObserver();
+
+  observer.set_network_thread_ok(true);
+  dc->RegisterObserver(&observer);
+  EXPECT_EQ(&observer, provider_->network_thread_observer(init.id));
+
+  dc->Close();
+  EXPECT_EQ(nullptr, provider_->network_thread_observer(init.id));
+}
+
+// Tests that an ordered channel keeps delivering on the signaling thread.
+TEST_F(SctpDataChannelTest, NoNetworkThreadObserverForOrderedChannel) {
+  SetChannelReady();
+  EXPECT_EQ_WAIT(webrtc::DataChannelInterface::kOpen,
+                 webrtc_data_channel_->state(), 1000);
+  AddObserver();
+  observer_->set_network_thread_ok(true);
+  webrtc_data_channel_->RegisterObserver(observer_.get());
+  EXPECT_EQ(nullptr,
+            provider_->network_thread_observer(webrtc_data_channel_->id()));
+}
+
 // Tests that the channel can't open until it's successfully sent the OPEN
 // message.
 TEST_F(SctpDataChannelTest, OpenWaitsForOpenMesssage) {
@@ -588,6 +588,22 @@ bool CheckForRemoteIceRestart(const SessionDescriptionInterface* old_desc,
   return false;
 }
 
+// Returns true if |content| is in |old_desc| too, not rejected and unchanged,
+// so that a channel that was given the old media section needn't be given the
+// new one.
+bool IsMediaSectionUnchanged(const ContentInfo& content,
+                             const SessionDescriptionInterface* old_desc) {
+  if (!old_desc) {
+    return false;
+  }
+  const ContentInfo* old_content =
+      old_desc->description()->GetContentByName(content.name);
+  return old_content && !old_content->rejected &&
+         old_content->media_description() &&
+         old_content->media_description()->Equals(
+             *content.media_description());
+}
+
 // Generates a string error message for SetLocalDescription/SetRemoteDescription
 // from an RTCError.
 std::string GetSetDescriptionErrorMessage(cricket::ContentSource source,
@@ -619,6 +635,16 @@ absl::optional<int> RTCConfigurationToIceConfigOptionalInt(
   return rtc_configuration_parameter;
 }
 
+// Returns |crypto_options| with the changes that |configuration| asks for.
+rtc::CryptoOptions CryptoOptionsForConfiguration(
+    rtc::CryptoOptions crypto_options,
+    const PeerConnectionInterface::RTCConfiguration& configuration) {
+  if (configuration.enable_gcm_crypto_suites) {
+    crypto_options.enable_gcm_crypto_suites = true;
+  }
+  return crypto_options;
+}
+
 }  // namespace
 
 // Upon completion, posts a task to execute the callback of the
@@ -693,6 +719,11 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
     SdpSemantics sdp_semantics;
     absl::optional<rtc::AdapterType> network_preference;
     bool active_reset_srtp_params;
+    bool enable_gcm_crypto_suites;
+    absl::optional<int> sctp_send_buffer_size;
+    absl::optional<int> sctp_receive_buffer_size;
+    absl::optional<int> sctp_max_burst;
+    bool sctp_use_htcp_congestion_control;
   };
   static_assert(sizeof(stuff_being_tested_for_equality) == sizeof(*this),
                 "Did you add something to RTCConfiguration and forget to "
@@ -740,7 +771,13 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
          turn_customizer == o.turn_customizer &&
          sdp_semantics == o.sdp_semantics &&
          network_preference == o.network_preference &&
-         active_reset_srtp_params == o.active_reset_srtp_params;
+         active_reset_srtp_params == o.active_reset_srtp_params &&
+         enable_gcm_crypto_suites == o.enable_gcm_crypto_suites &&
+         sctp_send_buffer_size == o.sctp_send_buffer_size &&
+         sctp_receive_buffer_size == o.sctp_receive_buffer_size &&
+         sctp_max_burst == o.sctp_max_burst &&
+         sctp_use_htcp_congestion_control ==
+             o.sctp_use_htcp_congestion_control;
 }
 
 bool PeerConnectionInterface::RTCConfiguration::operator!=(
@@ -962,7 +999,8 @@ bool PeerConnection::Initialize(
   config.disable_encryption = options.disable_encryption;
   config.bundle_policy = configuration.bundle_policy;
   config.rtcp_mux_policy = configuration.rtcp_mux_policy;
-  config.crypto_options = options.crypto_options;
+  config.crypto_options =
+      CryptoOptionsForConfiguration(options.crypto_options, configuration);
   config.transport_observer = this;
   config.event_log = event_log_.get();
 #if defined(ENABLE_EXTERNAL_AUTH)
@@ -2108,7 +2146,8 @@ RTCError PeerConnection::ApplyLocalDescription(
   }
 
   error = UpdateSessionState(type, cricket::CS_LOCAL,
-                             local_description()->description());
+                             local_description()->description(),
+                             old_local_description);
   if (!error.ok()) {
     return error;
   }
@@ -2343,7 +2382,8 @@ RTCError PeerConnection::ApplyRemoteDescription(
   // NOTE: Candidates allocation will be initiated only when
   // SetLocalDescription is called.
   error = UpdateSessionState(type, cricket::CS_REMOTE,
-                             remote_description()->description());
+                             remote_description()->description(),
+                             old_remote_description);
   if (!error.ok()) {
     return error;
   }
@@ -3689,7 +3729,7 @@ void PeerConnection::GetOptionsForOffer(
   }
 
   session_options->rtcp_cname = rtcp_cname_;
-  session_options->crypto_options = factory_->options().crypto_options;
+  session_options->crypto_options = GetCryptoOptions();
   session_options->is_unified_plan = IsUnifiedPlan();
 }
 
@@ -3947,7 +3987,7 @@ void PeerConnection::GetOptionsForAnswer(
   }
 
   session_options->rtcp_cname = rtcp_cname_;
-  session_options->crypto_options = factory_->options().crypto_options;
+  session_options->crypto_options = GetCryptoOptions();
   session_options->is_unified_plan = IsUnifiedPlan();
 }
 
@@ -4709,6 +4749,8 @@ bool PeerConnection::InitializePortAllocator_n(
     const cricket::ServerAddresses& stun_servers,
     const std::vector<cricket::RelayServerConfig>& turn_servers,
     const RTCConfiguration& configuration) {
+  port_allocator_->SetNetworkIgnoreMask(
+      factory_->options().network_ignore_mask);
   port_allocator_->Initialize();
   // To handle both internal and externally created port allocator, we will
   // enable BUNDLE here.
@@ -4879,7 +4921,8 @@ void PeerConnection::SetSessionError(SessionError error,
 RTCError PeerConnection::UpdateSessionState(
     SdpType type,
     cricket::ContentSource source,
-    const cricket::SessionDescription* description) {
+    const cricket::SessionDescription* description,
+    const SessionDescriptionInterface* old_description) {
   RTC_DCHECK_RUN_ON(signaling_thread());
 
   // If there's already a pending error then no state transition should happen.
@@ -4908,7 +4951,7 @@ RTCError PeerConnection::UpdateSessionState(
 
   // Update internal objects according to the session description's media
   // descriptions.
-  RTCError error = PushdownMediaDescription(type, source);
+  RTCError error = PushdownMediaDescription(type, source, old_description);
   if (!error.ok()) {
     return error;
   }
@@ -4918,13 +4961,17 @@ RTCError PeerConnection::UpdateSessionState(
 
 RTCError PeerConnection::PushdownMediaDescription(
     SdpType type,
-    cricket::ContentSource source) {
+    cricket::ContentSource source,
+    const SessionDescriptionInterface* old_description) {
   const SessionDescriptionInterface* sdesc =
       (source == cricket::CS_LOCAL ? local_description()
                                    : remote_description());
   RTC_DCHECK(sdesc);
 
-  // Push down the new SDP media section for each audio/video transceiver.
+  // Collect the new SDP media section for each audio/video transceiver, to
+  // push them down to the channels with a single hop to the worker thread.
+  std::vector<std::pair<cricket::BaseChannel*, const MediaContentDescription*>>
+      channel_contents;
   for (auto transceiver : transceivers_) {
     const ContentInfo* content_info =
         FindMediaSectionForTransceiver(transceiver, sdesc);
@@ -4937,13 +4984,16 @@ RTCError PeerConnection::PushdownMediaDescription(
     if (!content_desc) {
       continue;
     }
-    std::string error;
-    bool success = (source == cricket::CS_LOCAL)
-                       ? channel->SetLocalContent(content_desc, type, &error)
-                       : channel->SetRemoteContent(content_desc, type, &error);
-    if (!success) {
-      LOG_AND_RETURN_ERROR(RTCErrorType::INVALID_PARAMETER, std::move(error));
+    // On renegotiation most sections are usually unchanged; skip the worker
+    // thread round trip for those.
+    bool has_content = (source == cricket::CS_LOCAL)
+                           ? channel->has_local_content()
+                           : channel->has_remote_content();
+    if (has_content &&
+        IsMediaSectionUnchanged(*content_info, old_description)) {
+      continue;
     }
+    channel_contents.emplace_back(channel, content_desc);
   }
 
   // If using the RtpDataChannel, push down the new SDP section for it too.
@@ -4953,20 +5003,23 @@ RTCError PeerConnection::PushdownMediaDescription(
     if (data_content && !data_content->rejected) {
       const MediaContentDescription* data_desc =
           data_content->media_description();
-      if (data_desc) {
-        std::string error;
-        bool success =
-            (source == cricket::CS_LOCAL)
-                ? rtp_data_channel_->SetLocalContent(data_desc, type, &error)
-                : rtp_data_channel_->SetRemoteContent(data_desc, type, &error);
-        if (!success) {
-          LOG_AND_RETURN_ERROR(RTCErrorType::INVALID_PARAMETER,
-                               std::move(error));
-        }
+      bool has_content = (source == cricket::CS_LOCAL)
+                             ? rtp_data_channel_->has_local_content()
+                             : rtp_data_channel_->has_remote_content();
+      if (data_desc &&
+          !(has_content &&
+            IsMediaSectionUnchanged(*data_content, old_description))) {
+        channel_contents.emplace_back(rtp_data_channel_, data_desc);
       }
     }
   }
 
+  std::string error;
+  if (!cricket::BaseChannel::SetContents(channel_contents, type, source,
+                                         &error)) {
+    LOG_AND_RETURN_ERROR(RTCErrorType::INVALID_PARAMETER, std::move(error));
+  }
+
   // Need complete offer/answer with an SCTP m= section before starting SCTP,
   // according to https://tools.ietf.org/html/draft-ietf-mmusic-sctp-sdp-19
   if (sctp_transport_ && local_description() && remote_description() &&
@@ -5095,10 +5148,10 @@ bool PeerConnection::SendData(const cricket::SendDataParams& params,
   }
   return rtp_data_channel_
              ? rtp_data_channel_->SendData(params, payload, result)
-             : network_thread()->Invoke<bool>(
-                   RTC_FROM_HERE,
-                   Bind(&cricket::SctpTransportInternal::SendData,
-                        sctp_transport_.get(), params, payload, result));
+             : network_thread()->Invoke<bool>(RTC_FROM_HERE, [&] {
+                 // The payload is shared with the caller rather than copied.
+                 return sctp_transport_->SendData(params, payload, result);
+               });
 }
 
 bool PeerConnection::ConnectDataChannel(DataChannel* webrtc_data_channel) {
@@ -5144,6 +5197,17 @@ void PeerConnection::DisconnectDataChannel(DataChannel* webrtc_data_channel) {
   }
 }
 
+void PeerConnection::SetNetworkThreadObserver(int sid,
+                                              DataChannelObserver* observer) {
+  network_thread()->Invoke<void>(RTC_FROM_HERE, [this, sid, observer] {
+    if (observer) {
+      network_thread_data_observers_[sid] = observer;
+    } else {
+      network_thread_data_observers_.erase(sid);
+    }
+  });
+}
+
 void PeerConnection::AddSctpDataStream(int sid) {
   if (!sctp_transport_) {
     RTC_LOG(LS_ERROR)
@@ -5371,16 +5435,28 @@ void PeerConnection::OnTransportControllerDtlsHandshakeError(
 }
 
 void PeerConnection::EnableSending() {
+  std::vector<cricket::BaseChannel*> channels;
   for (auto transceiver : transceivers_) {
     cricket::BaseChannel* channel = transceiver->internal()->channel();
     if (channel && !channel->enabled()) {
-      channel->Enable(true);
+      channels.push_back(channel);
     }
   }
 
   if (rtp_data_channel_ && !rtp_data_channel_->enabled()) {
-    rtp_data_channel_->Enable(true);
+    channels.push_back(rtp_data_channel_);
   }
+
+  if (channels.empty()) {
+    return;
+  }
+  // Enable the channels with a single hop to the worker thread, rather than
+  // one per channel.
+  worker_thread()->Invoke<void>(RTC_FROM_HERE, [&channels] {
+    for (cricket::BaseChannel* channel : channels) {
+      channel->Enable(true);
+    }
+  });
 }
 
 // Returns the media index for a local ice candidate given the content name.
@@ -5550,7 +5626,7 @@ cricket::VoiceChannel* PeerConnection::CreateVoiceChannel(
   cricket::VoiceChannel* voice_channel = channel_manager()->CreateVoiceChannel(
       call_.get(), configuration_.media_config, rtp_transport,
       signaling_thread(), mid, SrtpRequired(),
-      factory_->options().crypto_options, audio_options_);
+      GetCryptoOptions(), audio_options_);
   if (!voice_channel) {
     return nullptr;
   }
@@ -5572,7 +5648,7 @@ cricket::VideoChannel* PeerConnection::CreateVideoChannel(
   cricket::VideoChannel* video_channel = channel_manager()->CreateVideoChannel(
       call_.get(), configuration_.media_config, rtp_transport,
       signaling_thread(), mid, SrtpRequired(),
-      factory_->options().crypto_options, video_options_);
+      GetCryptoOptions(), video_options_);
   if (!video_channel) {
     return nullptr;
   }
@@ -5596,7 +5672,8 @@ bool PeerConnection::CreateDataChannel(const std::string& mid) {
     }
     if (!network_thread()->Invoke<bool>(
             RTC_FROM_HERE,
-            rtc::Bind(&PeerConnection::CreateSctpTransport_n, this, mid))) {
+            rtc::Bind(&PeerConnection::CreateSctpTransport_n, this, mid,
+                      GetSctpOptions()))) {
       return false;
     }
     for (const auto& channel : sctp_data_channels_) {
@@ -5608,7 +5685,7 @@ bool PeerConnection::CreateDataChannel(const std::string& mid) {
     RTC_DCHECK(rtp_transport);
     rtp_data_channel_ = channel_manager()->CreateRtpDataChannel(
         configuration_.media_config, rtp_transport, signaling_thread(), mid,
-        SrtpRequired(), factory_->options().crypto_options);
+        SrtpRequired(), GetCryptoOptions());
     if (!rtp_data_channel_) {
       return false;
     }
@@ -5634,7 +5711,9 @@ Call::Stats PeerConnection::GetCallStats() {
   }
 }
 
-bool PeerConnection::CreateSctpTransport_n(const std::string& mid) {
+bool PeerConnection::CreateSctpTransport_n(
+    const std::string& mid,
+    const cricket::SctpOptions& options) {
   RTC_DCHECK(network_thread()->IsCurrent());
   RTC_DCHECK(sctp_factory_);
   cricket::DtlsTransportInternal* dtls_transport =
@@ -5642,6 +5721,7 @@ bool PeerConnection::CreateSctpTransport_n(const std::string& mid) {
   RTC_DCHECK(dtls_transport);
   sctp_transport_ = sctp_factory_->CreateSctpTransport(dtls_transport);
   RTC_DCHECK(sctp_transport_);
+  sctp_transport_->SetOptions(options);
   sctp_invoker_.reset(new rtc::AsyncInvoker());
   sctp_transport_->SignalReadyToSendData.connect(
       this, &PeerConnection::OnSctpTransportReadyToSendData_n);
@@ -5665,6 +5745,7 @@ void PeerConnection::DestroySctpTransport_n() {
   sctp_transport_.reset(nullptr);
   sctp_mid_.reset();
   sctp_invoker_.reset(nullptr);
+  network_thread_data_observers_.clear();
   sctp_ready_to_send_data_ = false;
 }
 
@@ -5692,6 +5773,14 @@ void PeerConnection::OnSctpTransportDataReceived_n(
     const rtc::CopyOnWriteBuffer& payload) {
   RTC_DCHECK(data_channel_type_ == cricket::DCT_SCTP);
   RTC_DCHECK(network_thread()->IsCurrent());
+  if (params.type != cricket::DMT_CONTROL) {
+    auto it = network_thread_data_observers_.find(params.sid);
+    if (it != network_thread_data_observers_.end()) {
+      it->second->OnMessage(
+          DataBuffer(payload, params.type == cricket::DMT_BINARY));
+      return;
+    }
+  }
   // Note: Cannot use rtc::Bind here because it will grab a reference to
   // PeerConnection and potentially cause PeerConnection to live longer than
   // expected. It is safe not to grab a reference since the sctp_invoker_ will
@@ -6051,6 +6140,22 @@ bool PeerConnection::SrtpRequired() const {
          webrtc_session_desc_factory_->SdesPolicy() == cricket::SEC_REQUIRED;
 }
 
+cricket::SctpOptions PeerConnection::GetSctpOptions() const {
+  cricket::SctpOptions options;
+  options.send_buffer_size = configuration_.sctp_send_buffer_size.value_or(0);
+  options.receive_buffer_size =
+      configuration_.sctp_receive_buffer_size.value_or(0);
+  options.max_burst = configuration_.sctp_max_burst.value_or(0);
+  options.use_htcp_congestion_control =
+      configuration_.sctp_use_htcp_congestion_control;
+  return options;
+}
+
+rtc::CryptoOptions PeerConnection::GetCryptoOptions() const {
+  return CryptoOptionsForConfiguration(factory_->options().crypto_options,
+                                       configuration_);
+}
+
 void PeerConnection::OnTransportControllerGatheringState(
     cricket::IceGatheringState state) {
   RTC_DCHECK(signaling_thread()->IsCurrent());
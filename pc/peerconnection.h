@@ -19,6 +19,7 @@
 
 #include "api/peerconnectioninterface.h"
 #include "api/turncustomizer.h"
+#include "media/sctp/sctptransportinternal.h"
 #include "pc/iceserverparsing.h"
 #include "pc/jseptransportcontroller.h"
 #include "pc/peerconnectionfactory.h"
@@ -727,6 +728,8 @@ class PeerConnection : public PeerConnectionInternal,
   void AddSctpDataStream(int sid) override;
   void RemoveSctpDataStream(int sid) override;
   bool ReadyToSendData() const override;
+  void SetNetworkThreadObserver(int sid,
+                                DataChannelObserver* observer) override;
 
   cricket::DataChannelType data_channel_type() const;
 
@@ -750,13 +753,20 @@ class PeerConnection : public PeerConnectionInternal,
   // Updates the error state, signaling if necessary.
   void SetSessionError(SessionError error, const std::string& error_desc);
 
-  RTCError UpdateSessionState(SdpType type,
-                              cricket::ContentSource source,
-                              const cricket::SessionDescription* description);
+  // |old_description| is the local or remote description that |description|
+  // replaces, if any.
+  RTCError UpdateSessionState(
+      SdpType type,
+      cricket::ContentSource source,
+      const cricket::SessionDescription* description,
+      const SessionDescriptionInterface* old_description);
   // Push the media parts of the local or remote session description
-  // down to all of the channels.
-  RTCError PushdownMediaDescription(SdpType type,
-                                    cricket::ContentSource source);
+  // down to all of the channels, except for the media sections that are
+  // unchanged from |old_description|.
+  RTCError PushdownMediaDescription(
+      SdpType type,
+      cricket::ContentSource source,
+      const SessionDescriptionInterface* old_description);
   bool PushdownSctpParameters_n(cricket::ContentSource source);
 
   RTCError PushdownTransportDescription(cricket::ContentSource source,
@@ -809,7 +819,8 @@ class PeerConnection : public PeerConnectionInternal,
   cricket::VideoChannel* CreateVideoChannel(const std::string& mid);
   bool CreateDataChannel(const std::string& mid);
 
-  bool CreateSctpTransport_n(const std::string& mid);
+  bool CreateSctpTransport_n(const std::string& mid,
+                             const cricket::SctpOptions& options);
   // For bundling.
   void DestroySctpTransport_n();
   // SctpTransport signal handlers. Needed to marshal signals from the network
@@ -855,6 +866,11 @@ class PeerConnection : public PeerConnectionInternal,
   // this session.
   bool SrtpRequired() const;
 
+  // The SCTP options of |configuration_|.
+  cricket::SctpOptions GetSctpOptions() const;
+  // The crypto options of the factory, with the changes of |configuration_|.
+  rtc::CryptoOptions GetCryptoOptions() const;
+
   // JsepTransportController signal handlers.
   void OnTransportControllerConnectionState(cricket::IceConnectionState state);
   void OnTransportControllerGatheringState(cricket::IceGatheringState state);
@@ -1014,6 +1030,9 @@ class PeerConnection : public PeerConnectionInternal,
       SignalSctpDataReceived;
   sigslot::signal1<int> SignalSctpClosingProcedureStartedRemotely;
   sigslot::signal1<int> SignalSctpClosingProcedureComplete;
+  // The observers that are given the DATA messages of their SCTP stream
+  // directly on the network thread, by sid. Only used on the network thread.
+  std::map<int, DataChannelObserver*> network_thread_data_observers_;
 
   std::unique_ptr<SessionDescriptionInterface> current_local_description_;
   std::unique_ptr<SessionDescriptionInterface> pending_local_description_;
@@ -315,6 +315,21 @@ TEST_P(PeerConnectionCryptoTest, CorrectCryptoInAnswerWithSdesAndGcm) {
   EXPECT_TRUE(SdpContentsAll(HaveSdesGcmCryptos(1), answer->description()));
 }
 
+// The GCM cipher suites can be enabled with the RTCConfiguration, without the
+// crypto options of the factory.
+TEST_P(PeerConnectionCryptoTest, CorrectCryptoInOfferWithSdesAndGcmConfig) {
+  RTCConfiguration config;
+  config.enable_dtls_srtp.emplace(false);
+  config.enable_gcm_crypto_suites = true;
+  auto caller = CreatePeerConnectionWithAudioVideo(config);
+
+  auto offer = caller->CreateOffer();
+  ASSERT_TRUE(offer);
+
+  ASSERT_FALSE(offer->description()->contents().empty());
+  EXPECT_TRUE(SdpContentsAll(HaveSdesGcmCryptos(3), offer->description()));
+}
+
 TEST_P(PeerConnectionCryptoTest, CanSetSdesGcmRemoteOfferAndLocalAnswer) {
   PeerConnectionFactoryInterface::Options options;
   options.crypto_options.enable_gcm_crypto_suites = true;
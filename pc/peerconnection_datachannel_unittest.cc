@@ -323,6 +323,34 @@ TEST_P(PeerConnectionDataChannelTest, SctpPortPropagatedFromSdpToTransport) {
   EXPECT_EQ(kNewRecvPort, callee_transport->local_port());
 }
 
+TEST_P(PeerConnectionDataChannelTest, SctpOptionsPropagatedToTransport) {
+  RTCConfiguration config;
+  config.sctp_send_buffer_size = 1024 * 1024;
+  config.sctp_receive_buffer_size = 2 * 1024 * 1024;
+  config.sctp_max_burst = 8;
+  config.sctp_use_htcp_congestion_control = true;
+  auto caller = CreatePeerConnectionWithDataChannel(config);
+  auto callee = CreatePeerConnectionWithDataChannel();
+
+  ASSERT_TRUE(caller->ExchangeOfferAnswerWith(callee.get()));
+
+  auto* caller_transport =
+      caller->sctp_transport_factory()->last_fake_sctp_transport();
+  ASSERT_TRUE(caller_transport);
+  EXPECT_EQ(1024 * 1024, caller_transport->options().send_buffer_size);
+  EXPECT_EQ(2 * 1024 * 1024, caller_transport->options().receive_buffer_size);
+  EXPECT_EQ(8, caller_transport->options().max_burst);
+  EXPECT_TRUE(caller_transport->options().use_htcp_congestion_control);
+
+  // Without the options, the usrsctp defaults are kept.
+  auto* callee_transport =
+      callee->sctp_transport_factory()->last_fake_sctp_transport();
+  ASSERT_TRUE(callee_transport);
+  EXPECT_EQ(0, callee_transport->options().send_buffer_size);
+  EXPECT_EQ(0, callee_transport->options().receive_buffer_size);
+  EXPECT_FALSE(callee_transport->options().use_htcp_congestion_control);
+}
+
 INSTANTIATE_TEST_CASE_P(PeerConnectionDataChannelTest,
                         PeerConnectionDataChannelTest,
                         Values(SdpSemantics::kPlanB,
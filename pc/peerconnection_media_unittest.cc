@@ -358,6 +358,57 @@ TEST_P(PeerConnectionMediaTest, NewStreamInRemoteOfferAddsRecvStreams) {
   }
 }
 
+// Test that a renegotiation doesn't push the media sections that didn't change
+// down to their channels again. The recv codecs of the callee's voice channel
+// are cleared to tell whether its section was applied again.
+TEST_P(PeerConnectionMediaTest, UnchangedMediaSectionNotAppliedAgain) {
+  auto caller = CreatePeerConnection();
+  caller->AddAudioTrack("a");
+  auto callee = CreatePeerConnection();
+
+  ASSERT_TRUE(caller->ExchangeOfferAnswerWith(callee.get()));
+
+  auto callee_voice = callee->media_engine()->GetVoiceChannel(0);
+  ASSERT_TRUE(callee_voice);
+  ASSERT_FALSE(callee_voice->recv_codecs().empty());
+  ASSERT_TRUE(callee_voice->SetRecvParameters(cricket::AudioRecvParameters()));
+
+  caller->AddVideoTrack("v");
+
+  ASSERT_TRUE(caller->ExchangeOfferAnswerWith(callee.get()));
+
+  EXPECT_EQ(callee_voice, callee->media_engine()->GetVoiceChannel(0));
+  EXPECT_TRUE(callee_voice->recv_codecs().empty());
+  auto callee_video = callee->media_engine()->GetVideoChannel(0);
+  ASSERT_TRUE(callee_video);
+  EXPECT_FALSE(callee_video->recv_codecs().empty());
+}
+
+// Test that a renegotiation which changes a media section pushes it down to the
+// channel again.
+TEST_P(PeerConnectionMediaTest, ChangedMediaSectionAppliedAgain) {
+  auto caller = CreatePeerConnection();
+  caller->AddAudioTrack("a");
+  auto callee = CreatePeerConnection();
+
+  ASSERT_TRUE(caller->ExchangeOfferAnswerWith(callee.get()));
+
+  auto callee_voice = callee->media_engine()->GetVoiceChannel(0);
+  ASSERT_TRUE(callee_voice);
+  ASSERT_TRUE(callee_voice->SetRecvParameters(cricket::AudioRecvParameters()));
+
+  // Changes the direction of the audio section in both the offer and the
+  // answer.
+  RTCOfferAnswerOptions options;
+  options.offer_to_receive_audio = 0;
+  auto offer = caller->CreateOfferAndSetAsLocal(options);
+  ASSERT_TRUE(offer);
+  ASSERT_TRUE(callee->SetRemoteDescription(std::move(offer)));
+  ASSERT_TRUE(callee->CreateAnswerAndSetAsLocal());
+
+  EXPECT_FALSE(callee_voice->recv_codecs().empty());
+}
+
 // Test that a new stream in a subsequent answer causes a new send stream to be
 // created on the callee when added locally.
 TEST_P(PeerConnectionMediaTest, NewStreamInLocalAnswerAddsSendStreams) {
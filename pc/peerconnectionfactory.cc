@@ -26,7 +26,6 @@
 #include "media/base/rtpdataengine.h"
 #include "media/sctp/sctptransport.h"
 #include "pc/rtpparametersconversion.h"
-#include "rtc_base/bind.h"
 #include "rtc_base/checks.h"
 // Adding 'nogncheck' to disable the gn include headers check to support modular
 // WebRTC build targets.
@@ -231,6 +230,13 @@ bool PeerConnectionFactory::Initialize() {
 
 void PeerConnectionFactory::SetOptions(const Options& options) {
   options_ = options;
+  if (!certificate_pool_ && options_.certificate_pool.size > 0) {
+    certificate_pool_ =
+        absl::make_unique<rtc::RTCCertificatePool>(network_thread_);
+  }
+  if (certificate_pool_) {
+    certificate_pool_->SetConfig(options_.certificate_pool);
+  }
 }
 
 RtpCapabilities PeerConnectionFactory::GetRtpSenderCapabilities(
@@ -369,8 +375,8 @@ PeerConnectionFactory::CreatePeerConnection(
   // Set internal defaults if optional dependencies are not set.
   if (!dependencies.cert_generator) {
     dependencies.cert_generator =
-        absl::make_unique<rtc::RTCCertificateGenerator>(signaling_thread_,
-                                                        network_thread_);
+        absl::make_unique<rtc::RTCCertificateGenerator>(
+            signaling_thread_, network_thread_, certificate_pool_.get());
   }
   if (!dependencies.allocator) {
     dependencies.allocator.reset(new cricket::BasicPortAllocator(
@@ -382,19 +388,15 @@ PeerConnectionFactory::CreatePeerConnection(
   // |dependencies.async_resolver_factory| to a new
   // |rtc::BasicAsyncResolverFactory| if no factory is provided.
 
-  network_thread_->Invoke<void>(
-      RTC_FROM_HERE,
-      rtc::Bind(&cricket::PortAllocator::SetNetworkIgnoreMask,
-                dependencies.allocator.get(), options_.network_ignore_mask));
-
-  std::unique_ptr<RtcEventLog> event_log =
-      worker_thread_->Invoke<std::unique_ptr<RtcEventLog>>(
-          RTC_FROM_HERE,
-          rtc::Bind(&PeerConnectionFactory::CreateRtcEventLog_w, this));
-
-  std::unique_ptr<Call> call = worker_thread_->Invoke<std::unique_ptr<Call>>(
-      RTC_FROM_HERE,
-      rtc::Bind(&PeerConnectionFactory::CreateCall_w, this, event_log.get()));
+  // Create the event log and the call with one hop to the worker thread. The
+  // network ignore mask is applied when the PeerConnection initializes the
+  // port allocator on the network thread.
+  std::unique_ptr<RtcEventLog> event_log;
+  std::unique_ptr<Call> call;
+  worker_thread_->Invoke<void>(RTC_FROM_HERE, [this, &event_log, &call] {
+    event_log = CreateRtcEventLog_w();
+    call = CreateCall_w(event_log.get());
+  });
 
   rtc::scoped_refptr<PeerConnection> pc(
       new rtc::RefCountedObject<PeerConnection>(this, std::move(event_log),
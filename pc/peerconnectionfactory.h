@@ -20,6 +20,7 @@
 #include "media/sctp/sctptransportinternal.h"
 #include "pc/channelmanager.h"
 #include "rtc_base/rtccertificategenerator.h"
+#include "rtc_base/rtccertificatepool.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/thread.h"
 
@@ -145,6 +146,8 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   std::unique_ptr<rtc::Thread> owned_network_thread_;
   std::unique_ptr<rtc::Thread> owned_worker_thread_;
   Options options_;
+  // Created on the first SetOptions() that enables it.
+  std::unique_ptr<rtc::RTCCertificatePool> certificate_pool_;
   std::unique_ptr<cricket::ChannelManager> channel_manager_;
   std::unique_ptr<rtc::BasicNetworkManager> default_network_manager_;
   std::unique_ptr<rtc::BasicPacketSocketFactory> default_socket_factory_;
@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/audio_codecs/builtin_audio_encoder_factory.h"
+#include "api/peerconnectioninterface.h"
+#include "api/video_codecs/builtin_video_decoder_factory.h"
+#include "api/video_codecs/builtin_video_encoder_factory.h"
+#include "p2p/client/basicportallocator.h"
+#include "pc/test/fakeaudiocapturemodule.h"
+#include "pc/test/fakertccertificategenerator.h"
+#include "pc/test/mockpeerconnectionobservers.h"
+#include "rtc_base/fakenetwork.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+// Measures how many PeerConnections a gateway can create per second on its
+// signaling thread, with separate network and worker threads.
+
+namespace webrtc {
+namespace {
+
+const int kNumPeerConnections = 200;
+
+class PeerConnectionFactoryPerformanceTest : public testing::Test {
+ public:
+  PeerConnectionFactoryPerformanceTest()
+      : network_thread_(rtc::Thread::CreateWithSocketServer()),
+        worker_thread_(rtc::Thread::Create()) {
+    RTC_CHECK(network_thread_->Start());
+    RTC_CHECK(worker_thread_->Start());
+    pc_factory_ = CreatePeerConnectionFactory(
+        network_thread_.get(), worker_thread_.get(), rtc::Thread::Current(),
+        rtc::scoped_refptr<AudioDeviceModule>(FakeAudioCaptureModule::Create()),
+        CreateBuiltinAudioEncoderFactory(), CreateBuiltinAudioDecoderFactory(),
+        CreateBuiltinVideoEncoderFactory(), CreateBuiltinVideoDecoderFactory(),
+        nullptr /* audio_mixer */, nullptr /* audio_processing */);
+    network_manager_.AddInterface(rtc::SocketAddress("1.1.1.1", 0));
+  }
+
+ protected:
+  rtc::scoped_refptr<PeerConnectionInterface> CreatePeerConnection() {
+    PeerConnectionDependencies dependencies(&observer_);
+    dependencies.allocator =
+        absl::make_unique<cricket::BasicPortAllocator>(&network_manager_);
+    dependencies.cert_generator =
+        absl::make_unique<FakeRTCCertificateGenerator>();
+    PeerConnectionInterface::RTCConfiguration config;
+    config.sdp_semantics = SdpSemantics::kUnifiedPlan;
+    return pc_factory_->CreatePeerConnection(config, std::move(dependencies));
+  }
+
+  std::unique_ptr<rtc::Thread> network_thread_;
+  std::unique_ptr<rtc::Thread> worker_thread_;
+  rtc::FakeNetworkManager network_manager_;
+  MockPeerConnectionObserver observer_;
+  rtc::scoped_refptr<PeerConnectionFactoryInterface> pc_factory_;
+};
+
+TEST_F(PeerConnectionFactoryPerformanceTest, CreatePeerConnections) {
+  std::vector<rtc::scoped_refptr<PeerConnectionInterface>> pcs;
+  pcs.reserve(kNumPeerConnections);
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPeerConnections; ++i) {
+    pcs.push_back(CreatePeerConnection());
+    ASSERT_TRUE(pcs.back());
+  }
+  int64_t elapsed_us = rtc::TimeMicros() - start_us;
+
+  test::PrintResult("peerconnection_creation", "", "creations",
+                    kNumPeerConnections * 1e6 / elapsed_us, "count/s", false);
+  test::PrintResult("peerconnection_creation_time", "", "creations",
+                    elapsed_us / 1000.0 / kNumPeerConnections, "ms", false);
+
+  for (auto& pc : pcs) {
+    pc->Close();
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
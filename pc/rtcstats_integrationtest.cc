@@ -621,6 +621,10 @@ class RTCStatsReportVerifier {
         peer_connection.data_channels_opened);
     verifier.TestMemberIsNonNegative<uint32_t>(
         peer_connection.data_channels_closed);
+    verifier.TestMemberIsNonNegative<uint64_t>(
+        peer_connection.video_memory_bytes);
+    verifier.TestMemberIsNonNegative<uint64_t>(
+        peer_connection.video_memory_peak_bytes);
     return verifier.ExpectAllMembersSuccessfullyTested();
   }
 
@@ -686,6 +690,11 @@ class RTCStatsReportVerifier {
     } else {
       verifier.TestMemberIsUndefined(inbound_stream.frames_decoded);
     }
+    // Only defined once timing frames have been received.
+    verifier.MarkMemberTested(inbound_stream.frame_latency_stages, true);
+    verifier.MarkMemberTested(inbound_stream.frame_latency_p50, true);
+    verifier.MarkMemberTested(inbound_stream.frame_latency_p95, true);
+    verifier.MarkMemberTested(inbound_stream.frame_latency_p99, true);
     return verifier.ExpectAllMembersSuccessfullyTested();
   }
 
@@ -724,6 +733,7 @@ class RTCStatsReportVerifier {
                                      RTCCertificateStats::kType);
     verifier.TestMemberIsIDReference(transport.remote_certificate_id,
                                      RTCCertificateStats::kType);
+    verifier.TestMemberIsDefined(transport.srtp_cipher);
     return verifier.ExpectAllMembersSuccessfullyTested();
   }
 
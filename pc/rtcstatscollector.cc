@@ -19,12 +19,14 @@
 #include "api/candidate.h"
 #include "api/mediastreaminterface.h"
 #include "api/peerconnectioninterface.h"
+#include "api/video/video_memory_accountant.h"
 #include "media/base/mediachannel.h"
 #include "p2p/base/p2pconstants.h"
 #include "p2p/base/port.h"
 #include "pc/peerconnection.h"
 #include "pc/rtcstatstraversal.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/sslstreamadapter.h"
 #include "rtc_base/strings/string_builder.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
@@ -264,6 +266,23 @@ void SetInboundRTPStreamStatsFromVideoReceiverInfo(
   inbound_video->frames_decoded = video_receiver_info.frames_decoded;
   if (video_receiver_info.qp_sum)
     inbound_video->qp_sum = *video_receiver_info.qp_sum;
+  if (!video_receiver_info.frame_latency_stages.empty()) {
+    std::vector<std::string> stages;
+    std::vector<double> p50;
+    std::vector<double> p95;
+    std::vector<double> p99;
+    for (const FrameLatencyStageStats& stage :
+         video_receiver_info.frame_latency_stages) {
+      stages.push_back(stage.stage);
+      p50.push_back(static_cast<double>(stage.p50_ms));
+      p95.push_back(static_cast<double>(stage.p95_ms));
+      p99.push_back(static_cast<double>(stage.p99_ms));
+    }
+    inbound_video->frame_latency_stages = std::move(stages);
+    inbound_video->frame_latency_p50 = std::move(p50);
+    inbound_video->frame_latency_p95 = std::move(p95);
+    inbound_video->frame_latency_p99 = std::move(p99);
+  }
 }
 
 // Provides the media independent counters (both audio and video).
@@ -1157,6 +1176,10 @@ void RTCStatsCollector::ProducePeerConnectionStats_s(
     new RTCPeerConnectionStats("RTCPeerConnection", timestamp_us));
   stats->data_channels_opened = internal_record_.data_channels_opened;
   stats->data_channels_closed = internal_record_.data_channels_closed;
+  stats->video_memory_bytes =
+      static_cast<uint64_t>(VideoMemoryAccountant::allocated_bytes());
+  stats->video_memory_peak_bytes =
+      static_cast<uint64_t>(VideoMemoryAccountant::peak_allocated_bytes());
   report->AddStats(std::move(stats));
 }
 
@@ -1359,6 +1382,12 @@ void RTCStatsCollector::ProduceTransportStats_n(
         transport_stats->local_certificate_id = local_certificate_id;
       if (!remote_certificate_id.empty())
         transport_stats->remote_certificate_id = remote_certificate_id;
+      if (channel_stats.srtp_crypto_suite != rtc::SRTP_INVALID_CRYPTO_SUITE) {
+        std::string srtp_cipher =
+            rtc::SrtpCryptoSuiteToName(channel_stats.srtp_crypto_suite);
+        if (!srtp_cipher.empty())
+          transport_stats->srtp_cipher = srtp_cipher;
+      }
       report->AddStats(std::move(transport_stats));
     }
   }
@@ -20,6 +20,7 @@
 #include "api/stats/rtcstats_objects.h"
 #include "api/stats/rtcstatsreport.h"
 #include "api/units/time_delta.h"
+#include "api/video/video_memory_accountant.h"
 #include "p2p/base/p2pconstants.h"
 #include "p2p/base/port.h"
 #include "pc/mediastream.h"
@@ -1239,6 +1240,10 @@ TEST_F(RTCStatsCollectorTest, CollectRTCPeerConnectionStats) {
                                     report->timestamp_us());
     expected.data_channels_opened = 0;
     expected.data_channels_closed = 0;
+    expected.video_memory_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::allocated_bytes());
+    expected.video_memory_peak_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::peak_allocated_bytes());
     ASSERT_TRUE(report->Get("RTCPeerConnection"));
     EXPECT_EQ(
         expected,
@@ -1263,6 +1268,10 @@ TEST_F(RTCStatsCollectorTest, CollectRTCPeerConnectionStats) {
                                     report->timestamp_us());
     expected.data_channels_opened = 1;
     expected.data_channels_closed = 0;
+    expected.video_memory_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::allocated_bytes());
+    expected.video_memory_peak_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::peak_allocated_bytes());
     ASSERT_TRUE(report->Get("RTCPeerConnection"));
     EXPECT_EQ(
         expected,
@@ -1279,6 +1288,10 @@ TEST_F(RTCStatsCollectorTest, CollectRTCPeerConnectionStats) {
                                     report->timestamp_us());
     expected.data_channels_opened = 2;
     expected.data_channels_closed = 1;
+    expected.video_memory_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::allocated_bytes());
+    expected.video_memory_peak_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::peak_allocated_bytes());
     ASSERT_TRUE(report->Get("RTCPeerConnection"));
     EXPECT_EQ(
         expected,
@@ -1296,6 +1309,10 @@ TEST_F(RTCStatsCollectorTest, CollectRTCPeerConnectionStats) {
                                     report->timestamp_us());
     expected.data_channels_opened = 3;
     expected.data_channels_closed = 1;
+    expected.video_memory_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::allocated_bytes());
+    expected.video_memory_peak_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::peak_allocated_bytes());
     ASSERT_TRUE(report->Get("RTCPeerConnection"));
     EXPECT_EQ(
         expected,
@@ -1312,6 +1329,10 @@ TEST_F(RTCStatsCollectorTest, CollectRTCPeerConnectionStats) {
                                     report->timestamp_us());
     expected.data_channels_opened = 3;
     expected.data_channels_closed = 3;
+    expected.video_memory_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::allocated_bytes());
+    expected.video_memory_peak_bytes =
+        static_cast<uint64_t>(VideoMemoryAccountant::peak_allocated_bytes());
     ASSERT_TRUE(report->Get("RTCPeerConnection"));
     EXPECT_EQ(
         expected,
@@ -1681,6 +1702,16 @@ TEST_F(RTCStatsCollectorTest, CollectRTCInboundRTPStreamStats_Video) {
   // Set previously undefined values and "GetStats" again.
   video_media_info.receivers[0].qp_sum = 9;
   expected_video.qp_sum = 9;
+  FrameLatencyStageStats decode_stage;
+  decode_stage.stage = "decode";
+  decode_stage.p50_ms = 10;
+  decode_stage.p95_ms = 20;
+  decode_stage.p99_ms = 30;
+  video_media_info.receivers[0].frame_latency_stages.push_back(decode_stage);
+  expected_video.frame_latency_stages = std::vector<std::string>{"decode"};
+  expected_video.frame_latency_p50 = std::vector<double>{10.0};
+  expected_video.frame_latency_p95 = std::vector<double>{20.0};
+  expected_video.frame_latency_p99 = std::vector<double>{30.0};
   video_media_channel->SetStats(video_media_info);
 
   report = stats_->GetFreshStatsReport();
@@ -1953,6 +1984,34 @@ TEST_F(RTCStatsCollectorTest, CollectRTCTransportStats) {
       report->Get(expected_rtcp_transport.id())->cast_to<RTCTransportStats>());
 }
 
+TEST_F(RTCStatsCollectorTest, CollectRTCTransportStatsWithSrtpCipher) {
+  const char kTransportName[] = "transport";
+
+  pc_->AddVoiceChannel("audio", kTransportName);
+
+  cricket::TransportChannelStats rtp_transport_channel_stats;
+  rtp_transport_channel_stats.component = cricket::ICE_CANDIDATE_COMPONENT_RTP;
+  rtp_transport_channel_stats.dtls_state = cricket::DTLS_TRANSPORT_CONNECTED;
+  rtp_transport_channel_stats.srtp_crypto_suite = rtc::SRTP_AEAD_AES_128_GCM;
+  pc_->SetTransportStats(kTransportName, {rtp_transport_channel_stats});
+
+  rtc::scoped_refptr<const RTCStatsReport> report = stats_->GetStatsReport();
+
+  RTCTransportStats expected_rtp_transport(
+      "RTCTransport_transport_" +
+          rtc::ToString<>(cricket::ICE_CANDIDATE_COMPONENT_RTP),
+      report->timestamp_us());
+  expected_rtp_transport.bytes_sent = 0;
+  expected_rtp_transport.bytes_received = 0;
+  expected_rtp_transport.dtls_state = RTCDtlsTransportState::kConnected;
+  expected_rtp_transport.srtp_cipher = rtc::CS_AEAD_AES_128_GCM;
+
+  ASSERT_TRUE(report->Get(expected_rtp_transport.id()));
+  EXPECT_EQ(
+      expected_rtp_transport,
+      report->Get(expected_rtp_transport.id())->cast_to<RTCTransportStats>());
+}
+
 TEST_F(RTCStatsCollectorTest, CollectNoStreamRTCOutboundRTPStreamStats_Audio) {
   cricket::VoiceMediaInfo voice_media_info;
 
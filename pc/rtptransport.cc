@@ -19,6 +19,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/trace_event.h"
+#include "rtc_base/zerocopyreceivescope.h"
 
 namespace webrtc {
 
@@ -262,7 +263,11 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
     return;
   }
 
-  rtc::CopyOnWriteBuffer packet(data, len);
+  // Adopt the socket's receive buffer if it is handed to us unmodified, so
+  // that SRTP can decrypt it in place and the RTP parser can reference it.
+  rtc::CopyOnWriteBuffer packet;
+  if (!rtc::ZeroCopyReceiveScope::TakeBuffer(data, len, &packet))
+    packet.SetData(data, len);
   // Protect ourselves against crazy data.
   if (!cricket::IsValidRtpRtcpPacketSize(rtcp, packet.size())) {
     RTC_LOG(LS_ERROR) << "Dropping incoming "
@@ -10,6 +10,7 @@
 
 #include "pc/sessiondescription.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace cricket {
@@ -26,8 +27,30 @@ ContentInfo* FindContentInfoByName(ContentInfos* contents,
   return nullptr;
 }
 
+bool CryptosEqual(const CryptoParamsVec& a, const CryptoParamsVec& b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const CryptoParams& x, const CryptoParams& y) {
+                      return x.Matches(y) && x.key_params == y.key_params &&
+                             x.session_params == y.session_params;
+                    });
+}
+
 }  // namespace
 
+bool MediaContentDescription::Equals(
+    const MediaContentDescription& other) const {
+  return type() == other.type() && protocol_ == other.protocol_ &&
+         direction_ == other.direction_ && rtcp_mux_ == other.rtcp_mux_ &&
+         rtcp_reduced_size_ == other.rtcp_reduced_size_ &&
+         bandwidth_ == other.bandwidth_ &&
+         CryptosEqual(cryptos_, other.cryptos_) &&
+         rtp_header_extensions_ == other.rtp_header_extensions_ &&
+         rtp_header_extensions_set_ == other.rtp_header_extensions_set_ &&
+         streams_ == other.streams_ &&
+         conference_mode_ == other.conference_mode_ &&
+         connection_address_ == other.connection_address_;
+}
+
 const ContentInfo* FindContentInfoByName(const ContentInfos& contents,
                                          const std::string& name) {
   for (ContentInfos::const_iterator content = contents.begin();
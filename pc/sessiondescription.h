@@ -80,6 +80,10 @@ class MediaContentDescription {
 
   virtual MediaContentDescription* Copy() const = 0;
 
+  // Returns true if |other| is of the same media type and has the same
+  // contents, so that applying it in place of this one would change nothing.
+  virtual bool Equals(const MediaContentDescription& other) const;
+
   // |protocol| is the expected media transport protocol, such as RTP/AVPF,
   // RTP/SAVPF or SCTP/DTLS.
   std::string protocol() const { return protocol_; }
@@ -210,7 +214,15 @@ class MediaContentDescriptionImpl : public MediaContentDescription {
   // Codecs should be in preference order (most preferred codec first).
   const std::vector<C>& codecs() const { return codecs_; }
   void set_codecs(const std::vector<C>& codecs) { codecs_ = codecs; }
+  std::vector<C>& mutable_codecs() { return codecs_; }
   virtual bool has_codecs() const { return !codecs_.empty(); }
+  bool Equals(const MediaContentDescription& other) const override {
+    // Descriptions of the same media type have the same codec type.
+    return MediaContentDescription::Equals(other) &&
+           codecs_ ==
+               static_cast<const MediaContentDescriptionImpl<C>&>(other)
+                   .codecs_;
+  }
   bool HasCodec(int id) {
     bool found = false;
     for (typename std::vector<C>::iterator iter = codecs_.begin();
@@ -277,6 +289,11 @@ class DataContentDescription : public MediaContentDescriptionImpl<DataCodec> {
   virtual DataContentDescription* as_data() { return this; }
   virtual const DataContentDescription* as_data() const { return this; }
 
+  bool Equals(const MediaContentDescription& other) const override {
+    return MediaContentDescriptionImpl<DataCodec>::Equals(other) &&
+           use_sctpmap_ == other.as_data()->use_sctpmap_;
+  }
+
   bool use_sctpmap() const { return use_sctpmap_; }
   void set_use_sctpmap(bool enable) { use_sctpmap_ = enable; }
 
@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "pc/srtpdecryptionpool.h"
+
+#include <algorithm>
+#include <string>
+
+#include "rtc_base/atomicops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/trace_event.h"
+
+namespace webrtc {
+
+SrtpDecryptionPool::QueuedPacket::QueuedPacket(SrtpDecryptionPool* pool)
+    : pool_(pool) {
+  pool_->OnPacketQueued();
+}
+
+SrtpDecryptionPool::QueuedPacket::QueuedPacket(QueuedPacket&& other)
+    : pool_(other.pool_) {
+  other.pool_ = nullptr;
+}
+
+SrtpDecryptionPool::QueuedPacket::~QueuedPacket() {
+  if (pool_) {
+    pool_->OnPacketDone();
+  }
+}
+
+SrtpDecryptionPool::SrtpDecryptionPool(size_t num_workers)
+    : num_assigned_(num_workers, 0) {
+  RTC_DCHECK_GT(num_workers, 0);
+  for (size_t i = 0; i < num_workers; ++i) {
+    std::unique_ptr<rtc::Thread> worker = rtc::Thread::Create();
+    worker->SetName("SrtpDecryption" + std::to_string(i), nullptr);
+    worker->Start();
+    workers_.push_back(std::move(worker));
+  }
+}
+
+SrtpDecryptionPool::~SrtpDecryptionPool() {
+  RTC_DCHECK_EQ(0, queue_depth());
+}
+
+rtc::Thread* SrtpDecryptionPool::AssignWorker() {
+  rtc::CritScope lock(&crit_);
+  size_t index = std::min_element(num_assigned_.begin(), num_assigned_.end()) -
+                 num_assigned_.begin();
+  ++num_assigned_[index];
+  return workers_[index].get();
+}
+
+int SrtpDecryptionPool::queue_depth() const {
+  return rtc::AtomicOps::AcquireLoad(&queue_depth_);
+}
+
+int SrtpDecryptionPool::max_queue_depth() const {
+  return rtc::AtomicOps::AcquireLoad(&max_queue_depth_);
+}
+
+void SrtpDecryptionPool::OnPacketQueued() {
+  int depth = rtc::AtomicOps::Increment(&queue_depth_);
+  int max_depth = max_queue_depth();
+  while (depth > max_depth) {
+    int previous =
+        rtc::AtomicOps::CompareAndSwap(&max_queue_depth_, max_depth, depth);
+    if (previous == max_depth) {
+      break;
+    }
+    max_depth = previous;
+  }
+  TRACE_COUNTER1("webrtc", "SrtpDecryptionQueueDepth", depth);
+}
+
+void SrtpDecryptionPool::OnPacketDone() {
+  int depth = rtc::AtomicOps::Decrement(&queue_depth_);
+  TRACE_COUNTER1("webrtc", "SrtpDecryptionQueueDepth", depth);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef PC_SRTPDECRYPTIONPOOL_H_
+#define PC_SRTPDECRYPTIONPOOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// A pool of worker threads that SrtpTransports decrypt their received packets
+// on, so that a busy session doesn't hold up the socket reads of the other
+// sessions on the network thread. A libsrtp session can't be used on two
+// threads at once, so each transport is assigned a single worker, on which
+// its packets, and thus the packets of each of its SSRCs, are decrypted in the
+// order they were received.
+//
+// The pool may be shared by the transports of any network thread, and must
+// outlive them.
+class SrtpDecryptionPool {
+ public:
+  // Counts a packet as queued for decryption for as long as it is alive.
+  class QueuedPacket {
+   public:
+    explicit QueuedPacket(SrtpDecryptionPool* pool);
+    QueuedPacket(QueuedPacket&& other);
+    ~QueuedPacket();
+
+   private:
+    SrtpDecryptionPool* pool_;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(QueuedPacket);
+  };
+
+  explicit SrtpDecryptionPool(size_t num_workers);
+  ~SrtpDecryptionPool();
+
+  // Returns the worker with the fewest transports assigned so far.
+  rtc::Thread* AssignWorker();
+
+  // The number of packets waiting for, or being, decrypted.
+  int queue_depth() const;
+  // The highest queue depth seen so far.
+  int max_queue_depth() const;
+
+ private:
+  void OnPacketQueued();
+  void OnPacketDone();
+
+  std::vector<std::unique_ptr<rtc::Thread>> workers_;
+  rtc::CriticalSection crit_;
+  std::vector<size_t> num_assigned_ RTC_GUARDED_BY(crit_);
+  volatile int queue_depth_ = 0;
+  volatile int max_queue_depth_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SrtpDecryptionPool);
+};
+
+}  // namespace webrtc
+
+#endif  // PC_SRTPDECRYPTIONPOOL_H_
@@ -105,6 +105,56 @@ bool SrtpSession::ProtectRtp(void* p,
   return (index) ? GetSendStreamPacketIndex(p, in_len, index) : true;
 }
 
+size_t SrtpSession::ProtectRtpPackets(
+    std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    for (rtc::CopyOnWriteBuffer& packet : *packets) {
+      packet.Clear();
+    }
+    return 0;
+  }
+
+  size_t num_protected = 0;
+  // The last sequence number is only needed for logging, so it is read from
+  // the last protected packet rather than from every packet.
+  const rtc::CopyOnWriteBuffer* last_protected = nullptr;
+  for (rtc::CopyOnWriteBuffer& packet : *packets) {
+    int in_len = static_cast<int>(packet.size());
+    int max_len = static_cast<int>(packet.capacity());
+    int need_len = in_len + rtp_auth_tag_len_;  // NOLINT
+    int err = srtp_err_status_ok;
+    int out_len = in_len;
+    if (max_len >= need_len) {
+      err = srtp_protect(session_, packet.data(), &out_len);
+    }
+    if (max_len < need_len || err != srtp_err_status_ok) {
+      if (last_protected) {
+        GetRtpSeqNum(last_protected->data(), last_protected->size(),
+                     &last_send_seq_num_);
+        last_protected = nullptr;
+      }
+      int seq_num;
+      GetRtpSeqNum(packet.data(), in_len, &seq_num);
+      RTC_LOG(LS_WARNING) << "Failed to protect SRTP packet, seqnum="
+                          << seq_num << ", len=" << in_len
+                          << ", capacity=" << max_len << ", err=" << err
+                          << ", last seqnum=" << last_send_seq_num_;
+      packet.Clear();
+      continue;
+    }
+    packet.SetSize(out_len);
+    last_protected = &packet;
+    ++num_protected;
+  }
+  if (last_protected) {
+    GetRtpSeqNum(last_protected->data(), last_protected->size(),
+                 &last_send_seq_num_);
+  }
+  return num_protected;
+}
+
 bool SrtpSession::ProtectRtcp(void* p, int in_len, int max_len, int* out_len) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   if (!session_) {
@@ -146,6 +196,34 @@ bool SrtpSession::UnprotectRtp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+size_t SrtpSession::UnprotectRtpPackets(
+    std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    for (rtc::CopyOnWriteBuffer& packet : *packets) {
+      packet.Clear();
+    }
+    return 0;
+  }
+
+  size_t num_unprotected = 0;
+  for (rtc::CopyOnWriteBuffer& packet : *packets) {
+    int out_len = static_cast<int>(packet.size());
+    int err = srtp_unprotect(session_, packet.data(), &out_len);
+    if (err != srtp_err_status_ok) {
+      RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err;
+      RTC_HISTOGRAM_ENUMERATION("WebRTC.PeerConnection.SrtpUnprotectError",
+                                static_cast<int>(err), kSrtpErrorCodeBoundary);
+      packet.Clear();
+      continue;
+    }
+    packet.SetSize(out_len);
+    ++num_unprotected;
+  }
+  return num_unprotected;
+}
+
 bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   if (!session_) {
@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/thread_checker.h"
 
@@ -23,6 +24,10 @@ struct srtp_ctx_t_;
 namespace cricket {
 
 // Class that wraps a libSRTP session.
+//
+// A session must be used on a single thread, but sessions don't share any
+// state while they protect or unprotect packets, so different sessions can
+// be used on different threads at the same time.
 class SrtpSession {
  public:
   SrtpSession();
@@ -65,6 +70,16 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Encrypts/signs a batch of RTP packets in-place, in order. The capacity of
+  // each packet must fit the auth tag. The packets that can't be protected are
+  // cleared, and the number of protected packets is returned. The session is
+  // checked once per batch rather than once per packet.
+  size_t ProtectRtpPackets(std::vector<rtc::CopyOnWriteBuffer>* packets);
+  // Decrypts/verifies a batch of RTP packets in-place, in order. The packets
+  // that fail, e.g. replays, are cleared, and the number of unprotected
+  // packets is returned.
+  size_t UnprotectRtpPackets(std::vector<rtc::CopyOnWriteBuffer>* packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
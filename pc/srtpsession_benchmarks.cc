@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "pc/srtpsession.h"
+#include "pc/srtptestutil.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/byteorder.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/sslstreamadapter.h"  // For rtc::SRTP_*
+
+namespace rtc {
+namespace {
+
+const size_t kRtpHeaderSize = 12;
+// Room for the auth tag.
+const size_t kMaxTrailerSize = 16;
+// Number of packets protected up front for the unprotect benchmark.
+const size_t kNumPackets = 1024;
+
+// Writes an RTP header with sequence number |seq_num| and a payload of
+// |payload_size| bytes into |packet|, and returns the packet size.
+int MakeRtpPacket(uint16_t seq_num, size_t payload_size, Buffer* packet) {
+  packet->SetSize(kRtpHeaderSize + payload_size + kMaxTrailerSize);
+  memset(packet->data(), 0xab, packet->size());
+  uint8_t* data = packet->data();
+  data[0] = 0x80;
+  data[1] = 0x60;
+  SetBE16(data + 2, seq_num);
+  SetBE32(data + 4, 90000);
+  SetBE32(data + 8, 0x12345678);
+  return static_cast<int>(kRtpHeaderSize + payload_size);
+}
+
+void BM_SrtpProtectRtp(benchmark::State& state) {
+  cricket::SrtpSession session;
+  RTC_CHECK(session.SetSend(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen,
+                            std::vector<int>()));
+  Buffer packet;
+  uint16_t seq_num = 0;
+
+  for (auto _ : state) {
+    // Every packet needs a new sequence number, or it is rejected as a
+    // replay.
+    const int len = MakeRtpPacket(seq_num++, state.range(0), &packet);
+    int out_len = 0;
+    RTC_CHECK(session.ProtectRtp(packet.data(), len,
+                                 static_cast<int>(packet.size()), &out_len));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SrtpProtectRtp)->Arg(160)->Arg(1200);
+
+void BM_SrtpUnprotectRtp(benchmark::State& state) {
+  cricket::SrtpSession send_session;
+  cricket::SrtpSession recv_session;
+  RTC_CHECK(send_session.SetSend(SRTP_AES128_CM_SHA1_80, kTestKey1,
+                                 kTestKeyLen, std::vector<int>()));
+  RTC_CHECK(recv_session.SetRecv(SRTP_AES128_CM_SHA1_80, kTestKey1,
+                                 kTestKeyLen, std::vector<int>()));
+  std::vector<Buffer> protected_packets(kNumPackets);
+  std::vector<int> protected_lens(kNumPackets);
+  uint16_t seq_num = 0;
+  size_t next_packet = kNumPackets;
+
+  for (auto _ : state) {
+    if (next_packet == kNumPackets) {
+      // Packets are unprotected in place, so protect a new batch with the
+      // following sequence numbers once all have been used.
+      state.PauseTiming();
+      for (size_t i = 0; i < kNumPackets; ++i) {
+        const int len = MakeRtpPacket(seq_num++, state.range(0),
+                                      &protected_packets[i]);
+        RTC_CHECK(send_session.ProtectRtp(
+            protected_packets[i].data(), len,
+            static_cast<int>(protected_packets[i].size()),
+            &protected_lens[i]));
+      }
+      next_packet = 0;
+      state.ResumeTiming();
+    }
+    int out_len = 0;
+    RTC_CHECK(recv_session.UnprotectRtp(protected_packets[next_packet].data(),
+                                        protected_lens[next_packet],
+                                        &out_len));
+    ++next_packet;
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SrtpUnprotectRtp)->Arg(160)->Arg(1200);
+
+}  // namespace
+}  // namespace rtc
@@ -11,10 +11,13 @@
 #include "pc/srtpsession.h"
 
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "media/base/fakertp.h"
 #include "pc/srtptestutil.h"
+#include "rtc_base/byteorder.h"
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/sslstreamadapter.h"  // For rtc::SRTP_*
 #include "system_wrappers/include/metrics_default.h"
@@ -135,6 +138,43 @@ TEST_F(SrtpSessionTest, TestGetSendStreamPacketIndex) {
   EXPECT_EQ(be64_index, index);
 }
 
+// Test that a batch of RTP packets is protected and unprotected in-place, and
+// that the packets that fail are cleared without stopping the batch.
+TEST_F(SrtpSessionTest, TestProtectAndUnprotectRtpPackets) {
+  EXPECT_TRUE(s1_.SetSend(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+  EXPECT_TRUE(s2_.SetRecv(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+  const size_t kProtectedLen =
+      sizeof(kPcmuFrame) + rtp_auth_tag_len(CS_AES_CM_128_HMAC_SHA1_80);
+  std::vector<CopyOnWriteBuffer> packets;
+  for (uint16_t seqnum = 1; seqnum <= 3; ++seqnum) {
+    packets.emplace_back(kPcmuFrame, sizeof(kPcmuFrame), kProtectedLen);
+    SetBE16(packets.back().data() + 2, seqnum);
+  }
+  // No room for the auth tag.
+  packets.emplace_back(kPcmuFrame, sizeof(kPcmuFrame));
+  SetBE16(packets.back().data() + 2, 4);
+
+  EXPECT_EQ(3u, s1_.ProtectRtpPackets(&packets));
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(kProtectedLen, packets[i].size());
+    EXPECT_NE(0, memcmp(packets[i].data() + 12, kPcmuFrame + 12,
+                        sizeof(kPcmuFrame) - 12));
+  }
+  EXPECT_EQ(0u, packets[3].size());
+
+  // Replace the failed packet with a replay of the second one.
+  packets[3] = packets[1];
+  EXPECT_EQ(3u, s2_.UnprotectRtpPackets(&packets));
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(sizeof(kPcmuFrame), packets[i].size());
+    EXPECT_EQ(0, memcmp(packets[i].data() + 4, kPcmuFrame + 4,
+                        sizeof(kPcmuFrame) - 4));
+  }
+  EXPECT_EQ(0u, packets[3].size());
+}
+
 // Test that we fail to unprotect if someone tampers with the RTP/RTCP paylaods.
 TEST_F(SrtpSessionTest, TestTamperReject) {
   int out_len;
@@ -11,6 +11,7 @@
 #include "pc/srtptransport.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"
@@ -26,6 +27,20 @@
 
 namespace webrtc {
 
+namespace {
+
+// Runs |functor| on |thread|, or right away if there is no |thread|.
+template <class FunctorT>
+void InvokeOn(rtc::Thread* thread, FunctorT&& functor) {
+  if (thread) {
+    thread->Invoke<void>(RTC_FROM_HERE, std::forward<FunctorT>(functor));
+  } else {
+    functor();
+  }
+}
+
+}  // namespace
+
 SrtpTransport::SrtpTransport(bool rtcp_mux_enabled)
     : RtpTransport(rtcp_mux_enabled) {}
 
@@ -199,6 +214,34 @@ void SrtpTransport::OnRtpPacketReceived(rtc::CopyOnWriteBuffer* packet,
         << "Inactive SRTP transport received an RTP packet. Drop it.";
     return;
   }
+  if (decryption_thread_) {
+    QueueForDecryption(/*rtcp=*/false, packet, packet_time);
+    return;
+  }
+  if (!UnprotectRtpPacket(packet)) {
+    return;
+  }
+  DemuxPacket(packet, packet_time);
+}
+
+void SrtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer* packet,
+                                         const rtc::PacketTime& packet_time) {
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_WARNING)
+        << "Inactive SRTP transport received an RTCP packet. Drop it.";
+    return;
+  }
+  if (decryption_thread_) {
+    QueueForDecryption(/*rtcp=*/true, packet, packet_time);
+    return;
+  }
+  if (!UnprotectRtcpPacket(packet)) {
+    return;
+  }
+  SignalRtcpPacketReceived(packet, packet_time);
+}
+
+bool SrtpTransport::UnprotectRtpPacket(rtc::CopyOnWriteBuffer* packet) {
   TRACE_EVENT0("webrtc", "SRTP Decode");
   char* data = packet->data<char>();
   int len = rtc::checked_cast<int>(packet->size());
@@ -209,19 +252,13 @@ void SrtpTransport::OnRtpPacketReceived(rtc::CopyOnWriteBuffer* packet,
     cricket::GetRtpSsrc(data, len, &ssrc);
     RTC_LOG(LS_ERROR) << "Failed to unprotect RTP packet: size=" << len
                       << ", seqnum=" << seq_num << ", SSRC=" << ssrc;
-    return;
+    return false;
   }
   packet->SetSize(len);
-  DemuxPacket(packet, packet_time);
+  return true;
 }
 
-void SrtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer* packet,
-                                         const rtc::PacketTime& packet_time) {
-  if (!IsSrtpActive()) {
-    RTC_LOG(LS_WARNING)
-        << "Inactive SRTP transport received an RTCP packet. Drop it.";
-    return;
-  }
+bool SrtpTransport::UnprotectRtcpPacket(rtc::CopyOnWriteBuffer* packet) {
   TRACE_EVENT0("webrtc", "SRTP Decode");
   char* data = packet->data<char>();
   int len = rtc::checked_cast<int>(packet->size());
@@ -230,10 +267,33 @@ void SrtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer* packet,
     cricket::GetRtcpType(data, len, &type);
     RTC_LOG(LS_ERROR) << "Failed to unprotect RTCP packet: size=" << len
                       << ", type=" << type;
-    return;
+    return false;
   }
   packet->SetSize(len);
-  SignalRtcpPacketReceived(packet, packet_time);
+  return true;
+}
+
+void SrtpTransport::QueueForDecryption(bool rtcp,
+                                       rtc::CopyOnWriteBuffer* packet,
+                                       const rtc::PacketTime& packet_time) {
+  invoker_.AsyncInvoke<void>(
+      RTC_FROM_HERE, decryption_thread_,
+      [this, rtcp, packet = std::move(*packet), packet_time,
+       queued = SrtpDecryptionPool::QueuedPacket(decryption_pool_)]() mutable {
+        if (rtcp ? !UnprotectRtcpPacket(&packet)
+                 : !UnprotectRtpPacket(&packet)) {
+          return;
+        }
+        invoker_.AsyncInvoke<void>(
+            RTC_FROM_HERE, network_thread_,
+            [this, rtcp, packet = std::move(packet), packet_time]() mutable {
+              if (rtcp) {
+                SignalRtcpPacketReceived(&packet, packet_time);
+              } else {
+                DemuxPacket(&packet, packet_time);
+              }
+            });
+      });
 }
 
 void SrtpTransport::OnNetworkRouteChanged(
@@ -282,10 +342,13 @@ bool SrtpTransport::SetRtpParams(int send_cs,
     return false;
   }
 
-  ret = new_sessions ? recv_session_->SetRecv(recv_cs, recv_key, recv_key_len,
-                                              recv_extension_ids)
-                     : recv_session_->UpdateRecv(
-                           recv_cs, recv_key, recv_key_len, recv_extension_ids);
+  InvokeOn(decryption_thread_, [&] {
+    ret = new_sessions
+              ? recv_session_->SetRecv(recv_cs, recv_key, recv_key_len,
+                                       recv_extension_ids)
+              : recv_session_->UpdateRecv(recv_cs, recv_key, recv_key_len,
+                                          recv_extension_ids);
+  });
   if (!ret) {
     ResetParams();
     return false;
@@ -319,9 +382,13 @@ bool SrtpTransport::SetRtcpParams(int send_cs,
     return false;
   }
 
-  recv_rtcp_session_.reset(new cricket::SrtpSession());
-  if (!recv_rtcp_session_->SetRecv(recv_cs, recv_key, recv_key_len,
-                                   recv_extension_ids)) {
+  bool ret = false;
+  InvokeOn(decryption_thread_, [&] {
+    recv_rtcp_session_.reset(new cricket::SrtpSession());
+    ret = recv_rtcp_session_->SetRecv(recv_cs, recv_key, recv_key_len,
+                                      recv_extension_ids);
+  });
+  if (!ret) {
     return false;
   }
 
@@ -342,16 +409,19 @@ bool SrtpTransport::IsWritable(bool rtcp) const {
 
 void SrtpTransport::ResetParams() {
   send_session_ = nullptr;
-  recv_session_ = nullptr;
   send_rtcp_session_ = nullptr;
-  recv_rtcp_session_ = nullptr;
+  InvokeOn(decryption_thread_, [this] {
+    recv_session_ = nullptr;
+    recv_rtcp_session_ = nullptr;
+  });
   MaybeUpdateWritableState();
   RTC_LOG(LS_INFO) << "The params in SRTP transport are reset.";
 }
 
 void SrtpTransport::CreateSrtpSessions() {
   send_session_.reset(new cricket::SrtpSession());
-  recv_session_.reset(new cricket::SrtpSession());
+  InvokeOn(decryption_thread_,
+           [this] { recv_session_.reset(new cricket::SrtpSession()); });
   if (external_auth_enabled_) {
     send_session_->EnableExternalAuth();
   }
@@ -396,7 +466,8 @@ bool SrtpTransport::ProtectRtcp(void* p,
 }
 
 bool SrtpTransport::UnprotectRtp(void* p, int in_len, int* out_len) {
-  if (!IsSrtpActive()) {
+  // Only the receive sessions may be looked at on the decryption thread.
+  if (!recv_session_) {
     RTC_LOG(LS_WARNING) << "Failed to UnprotectRtp: SRTP not active";
     return false;
   }
@@ -405,7 +476,7 @@ bool SrtpTransport::UnprotectRtp(void* p, int in_len, int* out_len) {
 }
 
 bool SrtpTransport::UnprotectRtcp(void* p, int in_len, int* out_len) {
-  if (!IsSrtpActive()) {
+  if (!recv_session_) {
     RTC_LOG(LS_WARNING) << "Failed to UnprotectRtcp: SRTP not active";
     return false;
   }
@@ -449,6 +520,15 @@ bool SrtpTransport::IsExternalAuthEnabled() const {
   return external_auth_enabled_;
 }
 
+void SrtpTransport::SetDecryptionPool(SrtpDecryptionPool* pool) {
+  RTC_DCHECK(!IsSrtpActive());
+  RTC_DCHECK(!recv_rtcp_session_);
+  decryption_pool_ = pool;
+  decryption_thread_ = pool ? pool->AssignWorker() : nullptr;
+  network_thread_ = rtc::Thread::Current();
+  RTC_DCHECK(network_thread_);
+}
+
 bool SrtpTransport::IsExternalAuthActive() const {
   if (!IsSrtpActive()) {
     RTC_LOG(LS_WARNING)
@@ -20,9 +20,12 @@
 #include "p2p/base/dtlstransportinternal.h"
 #include "p2p/base/icetransportinternal.h"
 #include "pc/rtptransport.h"
+#include "pc/srtpdecryptionpool.h"
 #include "pc/srtpsession.h"
+#include "rtc_base/asyncinvoker.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/thread.h"
 
 namespace webrtc {
 
@@ -87,6 +90,12 @@ class SrtpTransport : public RtpTransport {
   void EnableExternalAuth();
   bool IsExternalAuthEnabled() const;
 
+  // Decrypts the received packets on a worker of |pool| instead of the network
+  // thread, and delivers them back on the network thread in the order they
+  // were received. Must be called on the network thread before the params have
+  // been set. |pool| must outlive the transport.
+  void SetDecryptionPool(SrtpDecryptionPool* pool);
+
   // A SrtpTransport supports external creation of the auth tag if a non-GCM
   // cipher is used. This method is only valid after the RTP params have
   // been set.
@@ -138,14 +147,26 @@ class SrtpTransport : public RtpTransport {
 
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Unprotects |packet| in place, logging the packets that fail.
+  bool UnprotectRtpPacket(rtc::CopyOnWriteBuffer* packet);
+  bool UnprotectRtcpPacket(rtc::CopyOnWriteBuffer* packet);
+
+  // Hands |packet| to the decryption worker, which posts it back to the
+  // network thread once it is unprotected.
+  void QueueForDecryption(bool rtcp,
+                          rtc::CopyOnWriteBuffer* packet,
+                          const rtc::PacketTime& packet_time);
+
   bool MaybeSetKeyParams();
   bool ParseKeyParams(const std::string& key_params, uint8_t* key, size_t len);
 
   const std::string content_name_;
 
   std::unique_ptr<cricket::SrtpSession> send_session_;
-  std::unique_ptr<cricket::SrtpSession> recv_session_;
   std::unique_ptr<cricket::SrtpSession> send_rtcp_session_;
+  // With a decryption pool, the receive sessions are only created, keyed and
+  // used on |decryption_thread_|.
+  std::unique_ptr<cricket::SrtpSession> recv_session_;
   std::unique_ptr<cricket::SrtpSession> recv_rtcp_session_;
 
   absl::optional<cricket::CryptoParams> send_params_;
@@ -160,6 +181,13 @@ class SrtpTransport : public RtpTransport {
   bool external_auth_enabled_ = false;
 
   int rtp_abs_sendtime_extn_id_ = -1;
+
+  SrtpDecryptionPool* decryption_pool_ = nullptr;
+  rtc::Thread* decryption_thread_ = nullptr;
+  rtc::Thread* network_thread_ = nullptr;
+  // Declared last, so that the pending decryptions are cancelled before the
+  // sessions they use are destroyed.
+  rtc::AsyncInvoker invoker_;
 };
 
 }  // namespace webrtc
@@ -18,6 +18,7 @@
 #include "p2p/base/fakepackettransport.h"
 #include "pc/rtptransport.h"
 #include "pc/rtptransporttestutil.h"
+#include "pc/srtpdecryptionpool.h"
 #include "pc/srtptestutil.h"
 #include "rtc_base/asyncpacketsocket.h"
 #include "rtc_base/gunit.h"
@@ -399,6 +400,77 @@ INSTANTIATE_TEST_CASE_P(ExternalAuth,
                         SrtpTransportTestWithExternalAuth,
                         ::testing::Values(true, false));
 
+// Records the sequence numbers of the received RTP packets.
+class SequenceNumberRecorder : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override {
+    sequence_numbers_.push_back(packet.SequenceNumber());
+  }
+
+  const std::vector<uint16_t>& sequence_numbers() const {
+    return sequence_numbers_;
+  }
+
+ private:
+  std::vector<uint16_t> sequence_numbers_;
+};
+
+// Test that the packets decrypted on a decryption pool are delivered back on
+// the network thread in the order they were received.
+TEST_F(SrtpTransportTest, DecryptOnDecryptionPoolInOrder) {
+  const int kNumPackets = 100;
+  const int kTimeoutMs = 10000;
+  SrtpDecryptionPool pool(2);
+  srtp_transport2_->SetDecryptionPool(&pool);
+  std::vector<int> extension_ids;
+  ASSERT_TRUE(srtp_transport1_->SetRtpParams(
+      rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen, extension_ids,
+      rtc::SRTP_AES128_CM_SHA1_80, kTestKey2, kTestKeyLen, extension_ids));
+  ASSERT_TRUE(srtp_transport2_->SetRtpParams(
+      rtc::SRTP_AES128_CM_SHA1_80, kTestKey2, kTestKeyLen, extension_ids,
+      rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen, extension_ids));
+
+  SequenceNumberRecorder recorder;
+  srtp_transport2_->UnregisterRtpDemuxerSink(&rtp_sink2_);
+  RtpDemuxerCriteria demuxer_criteria;
+  demuxer_criteria.payload_types = {0x00};
+  srtp_transport2_->RegisterRtpDemuxerSink(demuxer_criteria, &recorder);
+
+  size_t rtp_len = sizeof(kPcmuFrame);
+  size_t packet_size =
+      rtp_len + rtc::rtp_auth_tag_len(rtc::CS_AES_CM_128_HMAC_SHA1_80);
+  rtc::PacketOptions options;
+  for (int i = 0; i < kNumPackets; ++i) {
+    rtc::CopyOnWriteBuffer packet(kPcmuFrame, rtp_len, packet_size);
+    rtc::SetBE16(packet.data() + 2, i);
+    ASSERT_TRUE(srtp_transport1_->SendRtpPacket(&packet, options,
+                                                cricket::PF_SRTP_BYPASS));
+    // The RTCP packets use the same session, and are kept in order with the
+    // RTP packets.
+    if (i == kNumPackets / 2) {
+      rtc::CopyOnWriteBuffer rtcp_packet(
+          ::kRtcpReport, sizeof(::kRtcpReport),
+          sizeof(::kRtcpReport) + 4 +
+              rtc::rtcp_auth_tag_len(rtc::CS_AES_CM_128_HMAC_SHA1_80));
+      ASSERT_TRUE(srtp_transport1_->SendRtcpPacket(&rtcp_packet, options,
+                                                   cricket::PF_SRTP_BYPASS));
+    }
+  }
+  EXPECT_GE(pool.max_queue_depth(), 1);
+
+  EXPECT_EQ_WAIT(static_cast<size_t>(kNumPackets),
+                 recorder.sequence_numbers().size(), kTimeoutMs);
+  for (int i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(static_cast<uint16_t>(i), recorder.sequence_numbers()[i]);
+  }
+  EXPECT_EQ(1, rtp_sink2_.rtcp_count());
+  EXPECT_EQ_WAIT(0, pool.queue_depth(), kTimeoutMs);
+
+  // The pool must outlive the transport.
+  srtp_transport2_->UnregisterRtpDemuxerSink(&recorder);
+  srtp_transport2_.reset();
+}
+
 // Test directly setting the params with bogus keys.
 TEST_F(SrtpTransportTest, TestSetParamsKeyTooShort) {
   std::vector<int> extension_ids;
@@ -129,6 +129,27 @@ void SetAudioProcessingStats(StatsReport* report,
     report->AddFloat(StatsReport::kStatsValueNameAecDivergentFilterFraction,
                      static_cast<float>(*apm_stats.divergent_filter_fraction));
   }
+  const TypeForAdd<absl::optional<double>> apm_times[] = {
+      {StatsReport::kStatsValueNameApmHighPassFilterTimeUs,
+       apm_stats.high_pass_filter_time_us},
+      {StatsReport::kStatsValueNameApmEchoCancellerTimeUs,
+       apm_stats.echo_canceller_time_us},
+      {StatsReport::kStatsValueNameApmNoiseSuppressorTimeUs,
+       apm_stats.noise_suppressor_time_us},
+      {StatsReport::kStatsValueNameApmGainControlTimeUs,
+       apm_stats.gain_control_time_us},
+      {StatsReport::kStatsValueNameApmGainController2TimeUs,
+       apm_stats.gain_controller2_time_us},
+      {StatsReport::kStatsValueNameApmLevelEstimatorTimeUs,
+       apm_stats.level_estimator_time_us},
+      {StatsReport::kStatsValueNameApmVoiceDetectionTimeUs,
+       apm_stats.voice_detection_time_us},
+  };
+  for (const auto& apm_time : apm_times) {
+    if (apm_time.value) {
+      report->AddFloat(apm_time.name, static_cast<float>(*apm_time.value));
+    }
+  }
 }
 
 void ExtractStats(const cricket::VoiceReceiverInfo& info, StatsReport* report) {
@@ -11,6 +11,7 @@
 #ifndef PC_TEST_FAKEDATACHANNELPROVIDER_H_
 #define PC_TEST_FAKEDATACHANNELPROVIDER_H_
 
+#include <map>
 #include <set>
 
 #include "pc/datachannel.h"
@@ -87,6 +88,21 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
 
   bool ReadyToSendData() const override { return ready_to_send_; }
 
+  void SetNetworkThreadObserver(
+      int sid,
+      webrtc::DataChannelObserver* observer) override {
+    if (observer) {
+      network_thread_observers_[sid] = observer;
+    } else {
+      network_thread_observers_.erase(sid);
+    }
+  }
+
+  webrtc::DataChannelObserver* network_thread_observer(int sid) const {
+    auto it = network_thread_observers_.find(sid);
+    return it == network_thread_observers_.end() ? nullptr : it->second;
+  }
+
   // Set true to emulate the SCTP stream being blocked by congestion control.
   void set_send_blocked(bool blocked) {
     send_blocked_ = blocked;
@@ -151,5 +167,6 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
   std::set<webrtc::DataChannel*> connected_channels_;
   std::set<uint32_t> send_ssrcs_;
   std::set<uint32_t> recv_ssrcs_;
+  std::map<int, webrtc::DataChannelObserver*> network_thread_observers_;
 };
 #endif  // PC_TEST_FAKEDATACHANNELPROVIDER_H_
@@ -26,6 +26,9 @@ class FakeSctpTransport : public cricket::SctpTransportInternal {
     remote_port_.emplace(remote_port);
     return true;
   }
+  void SetOptions(const cricket::SctpOptions& options) override {
+    options_ = options;
+  }
   bool OpenStream(int sid) override { return true; }
   bool ResetStream(int sid) override { return true; }
   bool SendData(const cricket::SendDataParams& params,
@@ -38,8 +41,10 @@ class FakeSctpTransport : public cricket::SctpTransportInternal {
 
   int local_port() const { return *local_port_; }
   int remote_port() const { return *remote_port_; }
+  const cricket::SctpOptions& options() const { return options_; }
 
  private:
+  cricket::SctpOptions options_;
   absl::optional<int> local_port_;
   absl::optional<int> remote_port_;
 };
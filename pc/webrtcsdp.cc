@@ -36,10 +36,12 @@
 #include "p2p/base/p2pconstants.h"
 #include "p2p/base/port.h"
 #include "pc/mediasession.h"
+#include "rtc_base/arena.h"
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/messagedigest.h"
+#include "rtc_base/string_to_number.h"
 #include "rtc_base/stringutils.h"
 
 using cricket::AudioContentDescription;
@@ -229,6 +231,27 @@ struct SsrcInfo {
 typedef std::vector<SsrcInfo> SsrcInfoVec;
 typedef std::vector<SsrcGroup> SsrcGroupVec;
 
+// The candidates of the media sections of a session description, which only
+// live until they are added to the JsepSessionDescription. They are created in
+// an arena, so that parsing an offer with many candidates doesn't leave the
+// heap fragmented by them.
+class ParsedCandidates {
+ public:
+  void Add(const std::string& mid,
+           int mline_index,
+           const Candidate& candidate) {
+    candidates_.push_back(
+        arena_.Create<JsepIceCandidate>(mid, mline_index, candidate));
+  }
+  const std::vector<JsepIceCandidate*>& candidates() const {
+    return candidates_;
+  }
+
+ private:
+  rtc::Arena arena_;
+  std::vector<JsepIceCandidate*> candidates_;
+};
+
 template <class T>
 static void AddFmtpLine(const T& codec, std::string* message);
 static void BuildMediaDescription(const ContentInfo* content_info,
@@ -273,7 +296,7 @@ static bool ParseMediaDescription(
     size_t* pos,
     const rtc::SocketAddress& session_connection_addr,
     cricket::SessionDescription* desc,
-    std::vector<JsepIceCandidate*>* candidates,
+    ParsedCandidates* candidates,
     SdpParseError* error);
 static bool ParseContent(const std::string& message,
                          const cricket::MediaType media_type,
@@ -286,7 +309,7 @@ static bool ParseContent(const std::string& message,
                          int* msid_signaling,
                          MediaContentDescription* media_desc,
                          TransportDescription* transport,
-                         std::vector<JsepIceCandidate*>* candidates,
+                         ParsedCandidates* candidates,
                          SdpParseError* error);
 static bool ParseSsrcAttribute(const std::string& line,
                                SsrcInfoVec* ssrc_infos,
@@ -452,7 +475,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Reuse the capacity of |line|, which holds the previous line.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -570,12 +594,25 @@ static bool CaseInsensitiveFind(std::string str1, std::string str2) {
   return str1.find(str2) != std::string::npos;
 }
 
+// Parses the integer |s| into |t|. The plain decimal numbers that SDP almost
+// always has are parsed without the cost of a std::istringstream. Anything
+// else falls back to rtc::FromString, so that the same values are accepted.
+template <class T>
+static bool ParseNumber(const std::string& s, T* t) {
+  absl::optional<T> value = rtc::StringToNumber<T>(s);
+  if (value) {
+    *t = *value;
+    return true;
+  }
+  return rtc::FromString(s, t);
+}
+
 template <class T>
 static bool GetValueFromString(const std::string& line,
                                const std::string& s,
                                T* t,
                                SdpParseError* error) {
-  if (!rtc::FromString(s, t)) {
+  if (!ParseNumber(s, t)) {
     std::ostringstream description;
     description << "Invalid value: " << s << ".";
     return ParseFailed(line, description.str(), error);
@@ -796,7 +833,11 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc) {
     return "";
   }
 
+  // Avoid reallocating the message for each of many m= sections; a section
+  // takes roughly this many bytes.
+  const size_t kEstimatedMediaSectionSize = 1500;
   std::string message;
+  message.reserve(256 + desc->contents().size() * kEstimatedMediaSectionSize);
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -910,7 +951,7 @@ bool SdpDeserialize(const std::string& message,
   RtpHeaderExtensions session_extmaps;
   rtc::SocketAddress session_connection_addr;
   cricket::SessionDescription* desc = new cricket::SessionDescription();
-  std::vector<JsepIceCandidate*> candidates;
+  ParsedCandidates candidates;
   size_t current_pos = 0;
 
   // Session Description
@@ -926,20 +967,13 @@ bool SdpDeserialize(const std::string& message,
                              session_connection_addr, desc, &candidates,
                              error)) {
     delete desc;
-    for (std::vector<JsepIceCandidate*>::const_iterator it = candidates.begin();
-         it != candidates.end(); ++it) {
-      delete *it;
-    }
     return false;
   }
 
   jdesc->Initialize(desc, session_id, session_version);
 
-  for (std::vector<JsepIceCandidate*>::const_iterator it = candidates.begin();
-       it != candidates.end(); ++it) {
-    jdesc->AddCandidate(*it);
-    delete *it;
-  }
+  for (const JsepIceCandidate* candidate : candidates.candidates())
+    jdesc->AddCandidate(candidate);
   return true;
 }
 
@@ -1190,7 +1224,7 @@ bool ParseSctpPort(const std::string& line,
   if (fields.size() < expected_min_fields) {
     return ParseFailedExpectMinFieldNum(line, expected_min_fields, error);
   }
-  if (!rtc::FromString(fields[1], sctp_port)) {
+  if (!ParseNumber(fields[1], sctp_port)) {
     return ParseFailed(line, "Invalid sctp port value.", error);
   }
   return true;
@@ -1716,10 +1750,12 @@ void AddFmtpLine(const T& codec, std::string* message) {
 
 template <class T>
 void AddRtcpFbLines(const T& codec, std::string* message) {
+  std::ostringstream os;
   for (std::vector<cricket::FeedbackParam>::const_iterator iter =
            codec.feedback_params.params().begin();
        iter != codec.feedback_params.params().end(); ++iter) {
-    std::ostringstream os;
+    // Reuse the stream for all the rtcp-fb lines of the codec.
+    os.str("");
     WriteRtcpFbHeader(codec.id, &os);
     os << " " << iter->id();
     if (!iter->param().empty()) {
@@ -1761,7 +1797,7 @@ bool GetParameter(const std::string& name,
   if (found == params.end()) {
     return false;
   }
-  if (!rtc::FromString(found->second, value)) {
+  if (!ParseNumber(found->second, value)) {
     return false;
   }
   return true;
@@ -2339,9 +2375,11 @@ static C* ParseContentDescription(const std::string& message,
                                   bool* bundle_only,
                                   int* msid_signaling,
                                   TransportDescription* transport,
-                                  std::vector<JsepIceCandidate*>* candidates,
+                                  ParsedCandidates* candidates,
                                   webrtc::SdpParseError* error) {
   C* media_desc = new C();
+  // Codecs aren't cheap to move, so make room for the ones of the m= line.
+  media_desc->mutable_codecs().reserve(payload_types.size());
   switch (media_type) {
     case cricket::MEDIA_TYPE_AUDIO:
       *content_name = cricket::CN_AUDIO;
@@ -2371,14 +2409,13 @@ static C* ParseContentDescription(const std::string& message,
   for (int pt : payload_types) {
     payload_type_preferences[pt] = preference--;
   }
-  std::vector<typename C::CodecType> codecs = media_desc->codecs();
+  std::vector<typename C::CodecType>& codecs = media_desc->mutable_codecs();
   std::sort(codecs.begin(), codecs.end(),
             [&payload_type_preferences](const typename C::CodecType& a,
                                         const typename C::CodecType& b) {
               return payload_type_preferences[a.id] >
                      payload_type_preferences[b.id];
             });
-  media_desc->set_codecs(codecs);
   return media_desc;
 }
 
@@ -2388,7 +2425,7 @@ bool ParseMediaDescription(const std::string& message,
                            size_t* pos,
                            const rtc::SocketAddress& session_connection_addr,
                            cricket::SessionDescription* desc,
-                           std::vector<JsepIceCandidate*>* candidates,
+                           ParsedCandidates* candidates,
                            SdpParseError* error) {
   RTC_DCHECK(desc != NULL);
   std::string line;
@@ -2417,7 +2454,7 @@ bool ParseMediaDescription(const std::string& message,
     }
 
     int port = 0;
-    if (!rtc::FromString<int>(fields[1], &port) || !IsValidPort(port)) {
+    if (!ParseNumber(fields[1], &port) || !IsValidPort(port)) {
       return ParseFailed(line, "The port number is invalid", error);
     }
     std::string protocol = fields[2];
@@ -2471,7 +2508,7 @@ bool ParseMediaDescription(const std::string& message,
 
       if (data_desc && IsDtlsSctp(protocol)) {
         int p;
-        if (rtc::FromString(fields[3], &p)) {
+        if (ParseNumber(fields[3], &p)) {
           if (!AddSctpDataCodec(data_desc, p)) {
             return false;
           }
@@ -2609,40 +2646,23 @@ void AddFeedbackParameters(const cricket::FeedbackParams& feedback_params,
   }
 }
 
-// Gets the current codec setting associated with |payload_type|. If there
-// is no Codec associated with that payload type it returns an empty codec
-// with that payload type.
-template <class T>
-T GetCodecWithPayloadType(const std::vector<T>& codecs, int payload_type) {
-  const T* codec = FindCodecById(codecs, payload_type);
-  if (codec)
-    return *codec;
-  // Return empty codec with |payload_type|.
-  T ret_val;
-  ret_val.id = payload_type;
-  return ret_val;
-}
-
-// Updates or creates a new codec entry in the audio description.
+// Returns the codec of |content_desc| associated with |payload_type|. If there
+// is no Codec associated with that payload type, an empty codec with that
+// payload type is added. The codec is updated in place, rather than copied
+// along with the codec list, since this is done for every rtpmap, fmtp and
+// rtcp-fb line.
 template <class T, class U>
-void AddOrReplaceCodec(MediaContentDescription* content_desc, const U& codec) {
-  T* desc = static_cast<T*>(content_desc);
-  std::vector<U> codecs = desc->codecs();
-  bool found = false;
-
-  typename std::vector<U>::iterator iter;
-  for (iter = codecs.begin(); iter != codecs.end(); ++iter) {
-    if (iter->id == codec.id) {
-      *iter = codec;
-      found = true;
-      break;
+U* GetOrAddCodec(MediaContentDescription* content_desc, int payload_type) {
+  std::vector<U>& codecs = static_cast<T*>(content_desc)->mutable_codecs();
+  for (U& codec : codecs) {
+    if (codec.id == payload_type) {
+      return &codec;
     }
   }
-  if (!found) {
-    desc->AddCodec(codec);
-    return;
-  }
-  desc->set_codecs(codecs);
+  U codec;
+  codec.id = payload_type;
+  codecs.push_back(std::move(codec));
+  return &codecs.back();
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -2652,10 +2672,7 @@ void UpdateCodec(MediaContentDescription* content_desc,
                  int payload_type,
                  const cricket::CodecParameterMap& parameters) {
   // Codec might already have been populated (from rtpmap).
-  U new_codec = GetCodecWithPayloadType(static_cast<T*>(content_desc)->codecs(),
-                                        payload_type);
-  AddParameters(parameters, &new_codec);
-  AddOrReplaceCodec<T, U>(content_desc, new_codec);
+  AddParameters(parameters, GetOrAddCodec<T, U>(content_desc, payload_type));
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -2665,10 +2682,8 @@ void UpdateCodec(MediaContentDescription* content_desc,
                  int payload_type,
                  const cricket::FeedbackParam& feedback_param) {
   // Codec might already have been populated (from rtpmap).
-  U new_codec = GetCodecWithPayloadType(static_cast<T*>(content_desc)->codecs(),
-                                        payload_type);
-  AddFeedbackParameter(feedback_param, &new_codec);
-  AddOrReplaceCodec<T, U>(content_desc, new_codec);
+  AddFeedbackParameter(feedback_param,
+                       GetOrAddCodec<T, U>(content_desc, payload_type));
 }
 
 template <class T>
@@ -2685,15 +2700,13 @@ bool PopWildcardCodec(std::vector<T>* codecs, T* wildcard_codec) {
 
 template <class T>
 void UpdateFromWildcardCodecs(cricket::MediaContentDescriptionImpl<T>* desc) {
-  auto codecs = desc->codecs();
   T wildcard_codec;
-  if (!PopWildcardCodec(&codecs, &wildcard_codec)) {
+  if (!PopWildcardCodec(&desc->mutable_codecs(), &wildcard_codec)) {
     return;
   }
-  for (auto& codec : codecs) {
+  for (auto& codec : desc->mutable_codecs()) {
     AddFeedbackParameters(wildcard_codec.feedback_params, &codec);
   }
-  desc->set_codecs(codecs);
 }
 
 void AddAudioAttribute(const std::string& name,
@@ -2702,12 +2715,9 @@ void AddAudioAttribute(const std::string& name,
   if (value.empty()) {
     return;
   }
-  std::vector<cricket::AudioCodec> codecs = audio_desc->codecs();
-  for (std::vector<cricket::AudioCodec>::iterator iter = codecs.begin();
-       iter != codecs.end(); ++iter) {
-    iter->params[name] = value;
+  for (cricket::AudioCodec& codec : audio_desc->mutable_codecs()) {
+    codec.params[name] = value;
   }
-  audio_desc->set_codecs(codecs);
 }
 
 bool ParseContent(const std::string& message,
@@ -2721,7 +2731,7 @@ bool ParseContent(const std::string& message,
                   int* msid_signaling,
                   MediaContentDescription* media_desc,
                   TransportDescription* transport,
-                  std::vector<JsepIceCandidate*>* candidates,
+                  ParsedCandidates* candidates,
                   SdpParseError* error) {
   RTC_DCHECK(media_desc != NULL);
   RTC_DCHECK(content_name != NULL);
@@ -3022,7 +3032,7 @@ bool ParseContent(const std::string& message,
     (*it).set_username(transport->ice_ufrag);
     RTC_DCHECK((*it).password().empty());
     (*it).set_password(transport->ice_pwd);
-    candidates->push_back(new JsepIceCandidate(mline_id, mline_index, *it));
+    candidates->Add(mline_id, mline_index, *it);
   }
   return true;
 }
@@ -3175,14 +3185,13 @@ void UpdateCodec(int payload_type,
                  AudioContentDescription* audio_desc) {
   // Codec may already be populated with (only) optional parameters
   // (from an fmtp).
-  cricket::AudioCodec codec =
-      GetCodecWithPayloadType(audio_desc->codecs(), payload_type);
-  codec.name = name;
-  codec.clockrate = clockrate;
-  codec.bitrate = bitrate;
-  codec.channels = channels;
-  AddOrReplaceCodec<AudioContentDescription, cricket::AudioCodec>(audio_desc,
-                                                                  codec);
+  cricket::AudioCodec* codec =
+      GetOrAddCodec<AudioContentDescription, cricket::AudioCodec>(
+          audio_desc, payload_type);
+  codec->name = name;
+  codec->clockrate = clockrate;
+  codec->bitrate = bitrate;
+  codec->channels = channels;
 }
 
 // Updates or creates a new codec entry in the video description according to
@@ -3192,11 +3201,9 @@ void UpdateCodec(int payload_type,
                  VideoContentDescription* video_desc) {
   // Codec may already be populated with (only) optional parameters
   // (from an fmtp).
-  cricket::VideoCodec codec =
-      GetCodecWithPayloadType(video_desc->codecs(), payload_type);
-  codec.name = name;
-  AddOrReplaceCodec<VideoContentDescription, cricket::VideoCodec>(video_desc,
-                                                                  codec);
+  GetOrAddCodec<VideoContentDescription, cricket::VideoCodec>(video_desc,
+                                                              payload_type)
+      ->name = name;
 }
 
 bool ParseRtpmapAttribute(const std::string& line,
@@ -3355,7 +3362,7 @@ bool ParseRtcpFbAttribute(const std::string& line,
     return true;
   }
   std::vector<std::string> rtcp_fb_fields;
-  rtc::split(line.c_str(), kSdpDelimiterSpace, &rtcp_fb_fields);
+  rtc::split(line, kSdpDelimiterSpace, &rtcp_fb_fields);
   if (rtcp_fb_fields.size() < 2) {
     return ParseFailedGetValue(line, kAttributeRtcpFb, error);
   }
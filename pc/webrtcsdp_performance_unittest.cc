@@ -0,0 +1,194 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <sstream>
+#include <string>
+
+#include "api/jsepsessiondescription.h"
+#include "pc/sessiondescription.h"
+#include "pc/webrtcsdp.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+// Measures the time that SdpDeserialize and SdpSerialize take for unified
+// plan offers with many m= sections, as an SFU sends to its clients.
+
+namespace webrtc {
+namespace {
+
+const int kNumIterations = 20;
+
+const char kSessionSection[] =
+    "v=0\r\n"
+    "o=- 18446744069414584320 18446462598732840960 IN IP4 127.0.0.1\r\n"
+    "s=-\r\n"
+    "t=0 0\r\n";
+
+const char kTransportAttributes[] =
+    "c=IN IP4 0.0.0.0\r\n"
+    "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+    "a=ice-ufrag:ufrag\r\n"
+    "a=ice-pwd:pwd_pwd_pwd_pwd_pwd_pwd\r\n"
+    "a=ice-options:trickle\r\n"
+    "a=fingerprint:sha-1 "
+    "4A:AD:B9:B1:3F:82:18:3B:54:02:12:DF:3E:5D:49:6B:19:E5:7C:AB\r\n"
+    "a=setup:actpass\r\n";
+
+const char kAudioAttributes[] =
+    "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+    "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/"
+    "abs-send-time\r\n"
+    "a=extmap:4 http://www.ietf.org/id/"
+    "draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+    "a=rtcp-mux\r\n"
+    "a=rtpmap:111 opus/48000/2\r\n"
+    "a=rtcp-fb:111 transport-cc\r\n"
+    "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+    "a=rtpmap:103 ISAC/16000\r\n"
+    "a=rtpmap:104 ISAC/32000\r\n"
+    "a=rtpmap:9 G722/8000\r\n"
+    "a=rtpmap:0 PCMU/8000\r\n"
+    "a=rtpmap:8 PCMA/8000\r\n"
+    "a=rtpmap:106 CN/32000\r\n"
+    "a=rtpmap:105 CN/16000\r\n"
+    "a=rtpmap:13 CN/8000\r\n"
+    "a=rtpmap:110 telephone-event/48000\r\n"
+    "a=rtpmap:112 telephone-event/32000\r\n"
+    "a=rtpmap:113 telephone-event/16000\r\n"
+    "a=rtpmap:126 telephone-event/8000\r\n";
+
+const char kVideoAttributes[] =
+    "a=extmap:2 urn:ietf:params:rtp-hdrext:toffset\r\n"
+    "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/"
+    "abs-send-time\r\n"
+    "a=extmap:4 urn:3gpp:video-orientation\r\n"
+    "a=extmap:5 http://www.ietf.org/id/"
+    "draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+    "a=extmap:6 http://www.webrtc.org/experiments/rtp-hdrext/"
+    "playout-delay\r\n"
+    "a=rtcp-mux\r\n"
+    "a=rtcp-rsize\r\n";
+
+const char kVideoCodecs[][16] = {"VP8", "VP9", "H264", "H264"};
+
+void AppendVideoCodecAttributes(std::ostringstream* os) {
+  int payload_type = 96;
+  for (const char* name : kVideoCodecs) {
+    int rtx_payload_type = payload_type + 1;
+    *os << "a=rtpmap:" << payload_type << " " << name << "/90000\r\n"
+        << "a=rtcp-fb:" << payload_type << " goog-remb\r\n"
+        << "a=rtcp-fb:" << payload_type << " transport-cc\r\n"
+        << "a=rtcp-fb:" << payload_type << " ccm fir\r\n"
+        << "a=rtcp-fb:" << payload_type << " nack\r\n"
+        << "a=rtcp-fb:" << payload_type << " nack pli\r\n";
+    if (payload_type == 100) {
+      *os << "a=fmtp:" << payload_type
+          << " level-asymmetry-allowed=1;packetization-mode=1;"
+             "profile-level-id=42001f\r\n";
+    } else if (payload_type == 102) {
+      *os << "a=fmtp:" << payload_type
+          << " level-asymmetry-allowed=1;packetization-mode=1;"
+             "profile-level-id=42e01f\r\n";
+    }
+    *os << "a=rtpmap:" << rtx_payload_type << " rtx/90000\r\n"
+        << "a=fmtp:" << rtx_payload_type << " apt=" << payload_type << "\r\n";
+    payload_type += 2;
+  }
+  *os << "a=rtpmap:104 red/90000\r\n"
+      << "a=rtpmap:105 rtx/90000\r\n"
+      << "a=fmtp:105 apt=104\r\n"
+      << "a=rtpmap:106 ulpfec/90000\r\n";
+}
+
+void AppendSsrcAttributes(int index, std::ostringstream* os) {
+  uint32_t ssrc = 1000 + 2 * index;
+  std::ostringstream track;
+  track << "stream_" << index << " track_" << index;
+  *os << "a=msid:" << track.str() << "\r\n";
+  for (uint32_t i = ssrc; i < ssrc + 2; ++i) {
+    *os << "a=ssrc:" << i << " cname:cname_" << index << "\r\n"
+        << "a=ssrc:" << i << " msid:" << track.str() << "\r\n";
+  }
+}
+
+// Creates an offer with |num_sections| m= sections, every other one of them
+// audio and the rest video, all bundled, with a sending track each.
+std::string CreateOfferSdp(int num_sections) {
+  std::ostringstream os;
+  os << kSessionSection << "a=group:BUNDLE";
+  for (int i = 0; i < num_sections; ++i) {
+    os << " " << i;
+  }
+  os << "\r\na=msid-semantic: WMS\r\n";
+  for (int i = 0; i < num_sections; ++i) {
+    bool audio = (i % 2 == 0);
+    if (audio) {
+      os << "m=audio 9 UDP/TLS/RTP/SAVPF "
+            "111 103 104 9 0 8 106 105 13 110 112 113 126\r\n";
+    } else {
+      os << "m=video 9 UDP/TLS/RTP/SAVPF "
+            "96 97 98 99 100 101 102 103 104 105 106\r\n";
+    }
+    os << kTransportAttributes << "a=mid:" << i << "\r\n";
+    if (audio) {
+      os << kAudioAttributes;
+    } else {
+      os << kVideoAttributes;
+      AppendVideoCodecAttributes(&os);
+    }
+    os << "a=sendrecv\r\n";
+    if (!audio) {
+      os << "a=ssrc-group:FID " << 1000 + 2 * i << " " << 1001 + 2 * i
+         << "\r\n";
+    }
+    AppendSsrcAttributes(i, &os);
+  }
+  return os.str();
+}
+
+class WebRtcSdpPerformanceTest : public testing::TestWithParam<int> {};
+
+TEST_P(WebRtcSdpPerformanceTest, DeserializeAndSerialize) {
+  const int num_sections = GetParam();
+  const std::string sdp = CreateOfferSdp(num_sections);
+
+  int64_t deserialize_us = 0;
+  int64_t serialize_us = 0;
+  for (int i = 0; i < kNumIterations; ++i) {
+    JsepSessionDescription jdesc(SdpType::kOffer);
+    SdpParseError error;
+    int64_t start_us = rtc::TimeMicros();
+    ASSERT_TRUE(SdpDeserialize(sdp, &jdesc, &error)) << error.description;
+    deserialize_us += rtc::TimeMicros() - start_us;
+    ASSERT_EQ(static_cast<size_t>(num_sections),
+              jdesc.description()->contents().size());
+
+    start_us = rtc::TimeMicros();
+    std::string serialized = SdpSerialize(jdesc);
+    serialize_us += rtc::TimeMicros() - start_us;
+    EXPECT_FALSE(serialized.empty());
+  }
+
+  const std::string modifier = "_" + std::to_string(num_sections) + "_mlines";
+  test::PrintResult("sdp_deserialize", modifier, "offer",
+                    deserialize_us / 1000.0 / kNumIterations, "ms", false);
+  test::PrintResult("sdp_serialize", modifier, "offer",
+                    serialize_us / 1000.0 / kNumIterations, "ms", false);
+  test::PrintResult("sdp_size", modifier, "offer", sdp.size() / 1024.0, "KB",
+                    false);
+}
+
+INSTANTIATE_TEST_CASE_P(WebRtcSdpPerformanceTest,
+                        WebRtcSdpPerformanceTest,
+                        testing::Values(10, 100, 200));
+
+}  // namespace
+}  // namespace webrtc
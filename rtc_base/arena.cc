@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/arena.h"
+
+#include <stdint.h>
+
+#include "rtc_base/checks.h"
+
+namespace rtc {
+
+Arena::Arena(size_t block_size) : block_size_(block_size) {
+  RTC_DCHECK_GE(block_size_, 4 * sizeof(Destructor));
+}
+
+Arena::~Arena() {
+  RunDestructors();
+}
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  RTC_DCHECK_GT(alignment, 0);
+  RTC_DCHECK_EQ(alignment & (alignment - 1), 0);
+  RTC_DCHECK_LE(alignment, alignof(std::max_align_t));
+  if (size == 0)
+    size = 1;
+
+  // Blocks start out aligned for any type, so only the position within the
+  // current block needs to be aligned.
+  if (current_) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(current_);
+    const size_t padding = -address & (alignment - 1);
+    if (padding + size <= static_cast<size_t>(end_ - current_)) {
+      char* result = current_ + padding;
+      current_ = result + size;
+      bytes_used_ += padding + size;
+      return result;
+    }
+  }
+
+  if (size > block_size_ / 4) {
+    // Large requests would waste much of a shared block; keep the current
+    // block for later requests.
+    char* result = AddBlock(size);
+    bytes_used_ += size;
+    return result;
+  }
+  current_ = AddBlock(block_size_);
+  end_ = current_ + block_size_;
+  char* result = current_;
+  current_ += size;
+  bytes_used_ += size;
+  return result;
+}
+
+void Arena::Reset() {
+  RunDestructors();
+  if (blocks_.empty())
+    return;
+  // Keep the first regular block, if it is one.
+  blocks_.resize(1);
+  if (blocks_[0].size != block_size_) {
+    blocks_.clear();
+    current_ = end_ = nullptr;
+    bytes_reserved_ = 0;
+  } else {
+    current_ = blocks_[0].data.get();
+    end_ = current_ + block_size_;
+    bytes_reserved_ = block_size_;
+  }
+  bytes_used_ = 0;
+}
+
+void Arena::RunDestructors() {
+  while (destructors_) {
+    Destructor* destructor = destructors_;
+    destructors_ = destructor->next;
+    destructor->destroy(destructor->object);
+  }
+}
+
+char* Arena::AddBlock(size_t size) {
+  Block block;
+  block.data.reset(new char[size]);
+  block.size = size;
+  char* data = block.data.get();
+  blocks_.push_back(std::move(block));
+  bytes_reserved_ += size;
+  return data;
+}
+
+}  // namespace rtc
@@ -0,0 +1,110 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_ARENA_H_
+#define RTC_BASE_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+
+namespace rtc {
+
+// Memory for many small objects that die together, such as the temporaries of
+// parsing a session description. Objects are carved out of large blocks by
+// bumping a pointer, and are all freed at once when the arena is destroyed or
+// reset, so that they neither cost a heap allocation each nor fragment the
+// heap around longer lived objects. Objects created with Create() are
+// destroyed then, in the reverse order of their creation.
+//
+// The arena isn't thread safe, and objects may not outlive it.
+class Arena {
+ public:
+  static const size_t kDefaultBlockSize = 4096;
+
+  explicit Arena(size_t block_size = kDefaultBlockSize);
+  ~Arena();
+
+  // Returns |size| bytes aligned to |alignment|, which must be a power of two
+  // no larger than alignof(std::max_align_t). Requests larger than a quarter
+  // of the block size get a block of their own.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  // Constructs a T in the arena. Unless T is trivially destructible, its
+  // destructor runs when the arena is destroyed or reset.
+  template <typename T, typename... Args>
+  T* Create(Args&&... args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned types aren't supported.");
+    if (std::is_trivially_destructible<T>::value)
+      return new (Allocate(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+    Destructor* destructor = static_cast<Destructor*>(
+        Allocate(sizeof(Destructor), alignof(Destructor)));
+    T* object =
+        new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    destructor->destroy = &Destroy<T>;
+    destructor->object = object;
+    destructor->next = destructors_;
+    destructors_ = destructor;
+    return object;
+  }
+
+  // Destroys the objects and frees all memory but the first block, which is
+  // kept for reuse.
+  void Reset();
+
+  // Bytes handed out by Allocate() since construction or the last Reset(),
+  // including padding and destructor records.
+  size_t bytes_used() const { return bytes_used_; }
+  // Bytes in the blocks the arena holds.
+  size_t bytes_reserved() const { return bytes_reserved_; }
+
+ private:
+  struct Destructor {
+    void (*destroy)(void*);
+    void* object;
+    Destructor* next;
+  };
+
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  template <typename T>
+  static void Destroy(void* object) {
+    static_cast<T*>(object)->~T();
+  }
+
+  void RunDestructors();
+  char* AddBlock(size_t size);
+
+  const size_t block_size_;
+  std::vector<Block> blocks_;
+  // The free part of the current block.
+  char* current_ = nullptr;
+  char* end_ = nullptr;
+  // An intrusive list, most recently created object first.
+  Destructor* destructors_ = nullptr;
+  size_t bytes_used_ = 0;
+  size_t bytes_reserved_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(Arena);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_ARENA_H_
@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/arena.h"
+#include "test/gtest.h"
+
+namespace rtc {
+
+namespace {
+
+class Tracked {
+ public:
+  Tracked(int id, std::vector<int>* destroyed)
+      : id_(id), destroyed_(destroyed) {}
+  ~Tracked() { destroyed_->push_back(id_); }
+
+  int id() const { return id_; }
+
+ private:
+  const int id_;
+  std::vector<int>* const destroyed_;
+};
+
+bool IsAligned(const void* pointer, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+}
+
+}  // namespace
+
+TEST(ArenaTest, AllocatesAlignedMemory) {
+  Arena arena(256);
+  char* c = static_cast<char*>(arena.Allocate(1, 1));
+  double* d = static_cast<double*>(arena.Allocate(sizeof(double), 8));
+  EXPECT_NE(nullptr, c);
+  EXPECT_TRUE(IsAligned(d, 8));
+  *c = 'a';
+  *d = 1.5;
+  EXPECT_EQ('a', *c);
+  EXPECT_EQ(1.5, *d);
+  EXPECT_EQ(16u, arena.bytes_used());
+  EXPECT_EQ(256u, arena.bytes_reserved());
+}
+
+TEST(ArenaTest, AddsBlocksAsNeeded) {
+  Arena arena(256);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(IsAligned(arena.Allocate(60), alignof(std::max_align_t)));
+  // Four 64 byte allocations fit in a block.
+  EXPECT_EQ(3 * 256u, arena.bytes_reserved());
+
+  // Large requests get a block of their own and don't waste the current one.
+  arena.Allocate(1000);
+  EXPECT_EQ(3 * 256u + 1000u, arena.bytes_reserved());
+  arena.Allocate(60);
+  EXPECT_EQ(3 * 256u + 1000u, arena.bytes_reserved());
+}
+
+TEST(ArenaTest, DestroysObjectsInReverseOrder) {
+  std::vector<int> destroyed;
+  {
+    Arena arena;
+    Tracked* first = arena.Create<Tracked>(1, &destroyed);
+    std::string* string = arena.Create<std::string>(100, 'x');
+    Tracked* second = arena.Create<Tracked>(2, &destroyed);
+    EXPECT_EQ(1, first->id());
+    EXPECT_EQ(2, second->id());
+    EXPECT_EQ(100u, string->size());
+    EXPECT_TRUE(destroyed.empty());
+  }
+  EXPECT_EQ(std::vector<int>({2, 1}), destroyed);
+}
+
+TEST(ArenaTest, ResetKeepsFirstBlock) {
+  std::vector<int> destroyed;
+  Arena arena(256);
+  arena.Create<Tracked>(1, &destroyed);
+  for (int i = 0; i < 10; ++i)
+    arena.Allocate(60);
+  EXPECT_GT(arena.bytes_reserved(), 256u);
+
+  arena.Reset();
+  EXPECT_EQ(std::vector<int>({1}), destroyed);
+  EXPECT_EQ(0u, arena.bytes_used());
+  EXPECT_EQ(256u, arena.bytes_reserved());
+
+  // Objects created after a reset are destroyed with the arena, once.
+  arena.Create<Tracked>(2, &destroyed);
+  EXPECT_EQ(256u, arena.bytes_reserved());
+  arena.Reset();
+  arena.Reset();
+  EXPECT_EQ(std::vector<int>({1, 2}), destroyed);
+}
+
+}  // namespace rtc
@@ -10,6 +10,8 @@
 
 #include "rtc_base/asyncpacketsocket.h"
 
+#include "rtc_base/checks.h"
+
 namespace rtc {
 
 PacketTimeUpdateParams::PacketTimeUpdateParams() = default;
@@ -24,10 +26,49 @@ PacketOptions::PacketOptions(DiffServCodePoint dscp) : dscp(dscp) {}
 PacketOptions::PacketOptions(const PacketOptions& other) = default;
 PacketOptions::~PacketOptions() = default;
 
+OutgoingPacket::OutgoingPacket() = default;
+OutgoingPacket::OutgoingPacket(const void* data,
+                               size_t size,
+                               const SocketAddress& remote_address,
+                               const PacketOptions& options)
+    : data(data), size(size), remote_address(remote_address), options(options) {}
+OutgoingPacket::OutgoingPacket(const OutgoingPacket& other) = default;
+OutgoingPacket::~OutgoingPacket() = default;
+
 AsyncPacketSocket::AsyncPacketSocket() = default;
 
 AsyncPacketSocket::~AsyncPacketSocket() = default;
 
+void AsyncPacketSocket::SetReadPacketCallback(ReadPacketCallback callback) {
+  RTC_DCHECK(!callback || !read_packet_callback_ ||
+             callback == read_packet_callback_)
+      << "A socket has a single ReadPacketCallback.";
+  read_packet_callback_ = callback;
+}
+
+void AsyncPacketSocket::NotifyPacketRead(const char* data,
+                                         size_t size,
+                                         const SocketAddress& remote_address,
+                                         const PacketTime& packet_time) {
+  if (read_packet_callback_) {
+    read_packet_callback_(this, data, size, remote_address, packet_time);
+    return;
+  }
+  SignalReadPacket(this, data, size, remote_address, packet_time);
+}
+
+int AsyncPacketSocket::SendToBatch(const std::vector<OutgoingPacket>& packets) {
+  size_t sent = 0;
+  for (; sent < packets.size(); ++sent) {
+    const OutgoingPacket& packet = packets[sent];
+    if (SendTo(packet.data, packet.size, packet.remote_address,
+               packet.options) < 0) {
+      return sent == 0 ? -1 : static_cast<int>(sent);
+    }
+  }
+  return static_cast<int>(sent);
+}
+
 void CopySocketInformationToPacketInfo(size_t packet_size_bytes,
                                        const AsyncPacketSocket& socket_from,
                                        bool is_connectionless,
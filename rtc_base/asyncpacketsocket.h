@@ -11,8 +11,11 @@
 #ifndef RTC_BASE_ASYNCPACKETSOCKET_H_
 #define RTC_BASE_ASYNCPACKETSOCKET_H_
 
+#include <vector>
+
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/dscp.h"
+#include "rtc_base/methodcallback.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "rtc_base/timeutils.h"
@@ -50,6 +53,23 @@ struct PacketOptions {
   PacketInfo info_signaled_after_sent;
 };
 
+// A single packet passed to AsyncPacketSocket::SendToBatch(). |data| must stay
+// valid for the duration of the call.
+struct OutgoingPacket {
+  OutgoingPacket();
+  OutgoingPacket(const void* data,
+                 size_t size,
+                 const SocketAddress& remote_address,
+                 const PacketOptions& options);
+  OutgoingPacket(const OutgoingPacket& other);
+  ~OutgoingPacket();
+
+  const void* data = nullptr;
+  size_t size = 0;
+  SocketAddress remote_address;
+  PacketOptions options;
+};
+
 // This structure will have the information about when packet is actually
 // received by socket.
 struct PacketTime {
@@ -70,10 +90,26 @@ inline PacketTime CreatePacketTime(int64_t not_before) {
   return PacketTime(TimeMicros(), not_before);
 }
 
+// A single packet delivered through AsyncPacketSocket::SignalReadPacketBatch.
+// |data| points into storage owned by the socket and is only valid for the
+// duration of the signal.
+struct ReceivedPacket {
+  const char* data = nullptr;
+  size_t size = 0;
+  SocketAddress remote_address;
+  PacketTime packet_time;
+};
+
 // Provides the ability to receive packets asynchronously. Sends are not
 // buffered since it is acceptable to drop packets under high load.
 class AsyncPacketSocket : public sigslot::has_slots<> {
  public:
+  using ReadPacketCallback = MethodCallback<void(AsyncPacketSocket*,
+                                                 const char*,
+                                                 size_t,
+                                                 const SocketAddress&,
+                                                 const PacketTime&)>;
+
   enum State {
     STATE_CLOSED,
     STATE_BINDING,
@@ -98,6 +134,11 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
                      size_t cb,
                      const SocketAddress& addr,
                      const PacketOptions& options) = 0;
+  // Sends |packets| in order, letting the socket coalesce them into as few
+  // system calls as it can. Returns the number of packets sent, which may be
+  // less than packets.size(), or a negative value if the first packet could
+  // not be sent. The default implementation calls SendTo() for each packet.
+  virtual int SendToBatch(const std::vector<OutgoingPacket>& packets);
 
   // Close the socket.
   virtual int Close() = 0;
@@ -114,8 +155,15 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int GetError() const = 0;
   virtual void SetError(int error) = 0;
 
-  // Emitted each time a packet is read. Used only for UDP and
-  // connected TCP sockets.
+  // Makes |callback| the receiver of the packets read from this socket, which
+  // are then passed to it instead of being emitted through SignalReadPacket.
+  // For the single receiver of a socket on the media path, where the cost of
+  // the signal shows; an empty callback restores SignalReadPacket. The
+  // receiver must reset the callback before it is destroyed.
+  void SetReadPacketCallback(ReadPacketCallback callback);
+
+  // Emitted each time a packet is read, unless a ReadPacketCallback is set.
+  // Used only for UDP and connected TCP sockets.
   sigslot::signal5<AsyncPacketSocket*,
                    const char*,
                    size_t,
@@ -123,6 +171,11 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
                    const PacketTime&>
       SignalReadPacket;
 
+  // Emitted instead of SignalReadPacket when a socket in batched receive mode
+  // has read several packets in one go and this signal has a connected slot.
+  sigslot::signal3<AsyncPacketSocket*, const ReceivedPacket*, size_t>
+      SignalReadPacketBatch;
+
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
 
@@ -146,7 +199,17 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   // Used only for listening TCP sockets.
   sigslot::signal2<AsyncPacketSocket*, AsyncPacketSocket*> SignalNewConnection;
 
+ protected:
+  // Passes a packet read from the socket to the ReadPacketCallback, or emits
+  // SignalReadPacket if there is none.
+  void NotifyPacketRead(const char* data,
+                        size_t size,
+                        const SocketAddress& remote_address,
+                        const PacketTime& packet_time);
+
  private:
+  ReadPacketCallback read_packet_callback_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AsyncPacketSocket);
 };
 
@@ -11,6 +11,7 @@
 #include "rtc_base/asyncudpsocket.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/zerocopyreceivescope.h"
 
 namespace rtc {
 
@@ -80,6 +81,29 @@ int AsyncUDPSocket::SendTo(const void* pv,
   return ret;
 }
 
+int AsyncUDPSocket::SendToBatch(const std::vector<OutgoingPacket>& packets) {
+  outgoing_.resize(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    outgoing_[i].data = packets[i].data;
+    outgoing_[i].size = packets[i].size;
+    outgoing_[i].remote_address = packets[i].remote_address;
+  }
+  int64_t send_time_ms = rtc::TimeMillis();
+  int ret = socket_->SendToBatch(outgoing_.data(), outgoing_.size());
+  // As in SendTo(), the first packet is reported even if sending failed.
+  size_t reported = ret > 0 ? static_cast<size_t>(ret) : 1;
+  for (size_t i = 0; i < reported && i < packets.size(); ++i) {
+    const OutgoingPacket& packet = packets[i];
+    rtc::SentPacket sent_packet(packet.options.packet_id, send_time_ms,
+                                packet.options.info_signaled_after_sent);
+    CopySocketInformationToPacketInfo(packet.size, *this, true,
+                                      &sent_packet.info);
+    sent_packet.info.remote_socket_address = packet.remote_address;
+    SignalSentPacket(this, sent_packet);
+  }
+  return ret;
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -104,9 +128,42 @@ void AsyncUDPSocket::SetError(int error) {
   return socket_->SetError(error);
 }
 
+void AsyncUDPSocket::SetReceiveBatchSize(size_t max_batch_size,
+                                         size_t slot_size) {
+  RTC_DCHECK_GT(max_batch_size, 0);
+  RTC_DCHECK_GT(slot_size, 0);
+  if (max_batch_size <= 1) {
+    batch_buffer_.clear();
+    datagrams_.clear();
+    packets_.clear();
+    return;
+  }
+  batch_buffer_.resize(max_batch_size * slot_size);
+  datagrams_.resize(max_batch_size);
+  packets_.resize(max_batch_size);
+  for (size_t i = 0; i < max_batch_size; ++i) {
+    datagrams_[i].buffer = &batch_buffer_[i * slot_size];
+    datagrams_[i].buffer_size = slot_size;
+  }
+}
+
+void AsyncUDPSocket::SetZeroCopyReceiveBufferSize(size_t buffer_size) {
+  zero_copy_buffer_size_ = buffer_size;
+  receive_buffer_ = CopyOnWriteBuffer();
+}
+
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
+  if (datagrams_.size() > 1) {
+    ReadBatch();
+    return;
+  }
+  if (zero_copy_buffer_size_ > 0) {
+    ReadZeroCopy();
+    return;
+  }
+
   SocketAddress remote_addr;
   int64_t timestamp;
   int len = socket_->RecvFrom(buf_, size_, &remote_addr, &timestamp);
@@ -123,8 +180,63 @@ void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
 
   // TODO: Make sure that we got all of the packet.
   // If we did not, then we should resize our buffer to be large enough.
-  SignalReadPacket(
-      this, buf_, static_cast<size_t>(len), remote_addr,
+  NotifyPacketRead(
+      buf_, static_cast<size_t>(len), remote_addr,
+      (timestamp > -1 ? PacketTime(timestamp, 0) : CreatePacketTime(0)));
+}
+
+void AsyncUDPSocket::ReadBatch() {
+  int count = socket_->RecvFromBatch(datagrams_.data(), datagrams_.size());
+  if (count < 0) {
+    // See OnReadEvent() for why errors are only logged here.
+    SocketAddress local_addr = socket_->GetLocalAddress();
+    RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
+                     << "] batched receive failed with error "
+                     << socket_->GetError();
+    return;
+  }
+
+  for (int i = 0; i < count; ++i) {
+    const ReceivedDatagram& datagram = datagrams_[i];
+    ReceivedPacket& packet = packets_[i];
+    packet.data = static_cast<const char*>(datagram.buffer);
+    packet.size = datagram.size;
+    packet.remote_address = datagram.remote_address;
+    packet.packet_time = datagram.timestamp > -1
+                             ? PacketTime(datagram.timestamp, 0)
+                             : CreatePacketTime(0);
+  }
+
+  if (!SignalReadPacketBatch.is_empty()) {
+    SignalReadPacketBatch(this, packets_.data(), static_cast<size_t>(count));
+    return;
+  }
+  for (int i = 0; i < count; ++i) {
+    const ReceivedPacket& packet = packets_[i];
+    NotifyPacketRead(packet.data, packet.size, packet.remote_address,
+                     packet.packet_time);
+  }
+}
+
+void AsyncUDPSocket::ReadZeroCopy() {
+  // Only reallocates if the previous buffer was taken by a receiver.
+  receive_buffer_.SetSize(zero_copy_buffer_size_);
+  SocketAddress remote_addr;
+  int64_t timestamp;
+  int len = socket_->RecvFrom(receive_buffer_.data<char>(),
+                              receive_buffer_.size(), &remote_addr, &timestamp);
+  if (len < 0) {
+    // See OnReadEvent() for why errors are only logged here.
+    SocketAddress local_addr = socket_->GetLocalAddress();
+    RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
+                     << "] receive failed with error " << socket_->GetError();
+    return;
+  }
+  receive_buffer_.SetSize(static_cast<size_t>(len));
+
+  ZeroCopyReceiveScope scope(&receive_buffer_);
+  NotifyPacketRead(
+      receive_buffer_.cdata<char>(), receive_buffer_.size(), remote_addr,
       (timestamp > -1 ? PacketTime(timestamp, 0) : CreatePacketTime(0)));
 }
 
@@ -12,8 +12,10 @@
 #define RTC_BASE_ASYNCUDPSOCKET_H_
 
 #include <memory>
+#include <vector>
 
 #include "rtc_base/asyncpacketsocket.h"
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/socketfactory.h"
 
 namespace rtc {
@@ -22,6 +24,8 @@ namespace rtc {
 // buffered since it is acceptable to drop packets under high load.
 class AsyncUDPSocket : public AsyncPacketSocket {
  public:
+  static const size_t kDefaultBatchSlotSize = 2048;
+
   // Binds |socket| and creates AsyncUDPSocket for it. Takes ownership
   // of |socket|. Returns null if bind() fails (|socket| is destroyed
   // in that case).
@@ -43,6 +47,7 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  int SendToBatch(const std::vector<OutgoingPacket>& packets) override;
   int Close() override;
 
   State GetState() const override;
@@ -51,15 +56,43 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int GetError() const override;
   void SetError(int error) override;
 
+  // Enables batched receive: every read event drains up to |max_batch_size|
+  // datagrams with Socket::RecvFromBatch() into a ring of |slot_size| byte
+  // buffers, and delivers them through SignalReadPacketBatch (or one
+  // SignalReadPacket per datagram if nothing is connected to it). Datagrams
+  // larger than |slot_size| are truncated. A |max_batch_size| of 1 restores
+  // the default one packet per read event behavior.
+  void SetReceiveBatchSize(size_t max_batch_size,
+                           size_t slot_size = kDefaultBatchSlotSize);
+
+  // Enables zero-copy receive: datagrams are read straight into a
+  // CopyOnWriteBuffer of |buffer_size| bytes and delivered inside a
+  // ZeroCopyReceiveScope, so that a receiver may take ownership of the buffer
+  // instead of copying it. A fresh buffer is allocated whenever one was taken.
+  // Datagrams larger than |buffer_size| are truncated. A |buffer_size| of 0
+  // disables it. Batched receive, if enabled, takes precedence.
+  void SetZeroCopyReceiveBufferSize(size_t buffer_size);
+
  private:
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(AsyncSocket* socket);
+  void ReadBatch();
+  void ReadZeroCopy();
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
 
   std::unique_ptr<AsyncSocket> socket_;
   char* buf_;
   size_t size_;
+  // Batched receive state, used when |datagrams_| has more than one slot.
+  std::vector<char> batch_buffer_;
+  std::vector<ReceivedDatagram> datagrams_;
+  std::vector<ReceivedPacket> packets_;
+  // Zero-copy receive state, used when |zero_copy_buffer_size_| is non-zero.
+  size_t zero_copy_buffer_size_ = 0;
+  CopyOnWriteBuffer receive_buffer_;
+  // Scratch storage for SendToBatch().
+  std::vector<OutgoingDatagram> outgoing_;
 };
 
 }  // namespace rtc
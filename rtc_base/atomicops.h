@@ -46,6 +46,10 @@ class AtomicOps {
     return *ptr;
   }
   template <typename T>
+  static void ReleaseStorePtr(T* volatile* ptr, T* value) {
+    *ptr = value;
+  }
+  template <typename T>
   static T* CompareAndSwapPtr(T* volatile* ptr, T* old_value, T* new_value) {
     return static_cast<T*>(::InterlockedCompareExchangePointer(
         reinterpret_cast<PVOID volatile*>(ptr), new_value, old_value));
@@ -68,6 +72,10 @@ class AtomicOps {
     return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
   }
   template <typename T>
+  static void ReleaseStorePtr(T* volatile* ptr, T* value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+  }
+  template <typename T>
   static T* CompareAndSwapPtr(T* volatile* ptr, T* old_value, T* new_value) {
     return __sync_val_compare_and_swap(ptr, old_value, new_value);
   }
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <limits>
 
+#include "rtc_base/byteorder.h"
 #include "rtc_base/checks.h"
 
 namespace {
@@ -69,6 +70,24 @@ size_t CountBits(uint64_t val) {
   return bit_count;
 }
 
+// Returns the number of leading zero bits in |val|, which must not be zero.
+int CountLeadingZeros32(uint32_t val) {
+  RTC_DCHECK_NE(val, 0);
+#if defined(__GNUC__)
+  return __builtin_clz(val);
+#else
+  // The number of leading zero bits in each 4 bit value.
+  static const uint8_t kNibbleLeadingZeros[16] = {4, 3, 2, 2, 1, 1, 1, 1,
+                                                  0, 0, 0, 0, 0, 0, 0, 0};
+  int count = 0;
+  while ((val >> 28) == 0) {
+    count += 4;
+    val <<= 4;
+  }
+  return count + kNibbleLeadingZeros[val >> 28];
+#endif
+}
+
 }  // namespace
 
 namespace rtc {
@@ -111,6 +130,17 @@ bool BitBuffer::PeekBits(uint32_t* val, size_t bit_count) {
   if (!val || bit_count > RemainingBitCount() || bit_count > 32) {
     return false;
   }
+  if (bit_count == 0) {
+    *val = 0;
+    return true;
+  }
+  // With at least 8 bytes left, the at most 32 + 7 bits that are needed can
+  // be taken from a single load instead of byte by byte.
+  if (byte_count_ - byte_offset_ >= sizeof(uint64_t)) {
+    uint64_t bits = GetBE64(bytes_ + byte_offset_);
+    *val = static_cast<uint32_t>((bits << bit_offset_) >> (64 - bit_count));
+    return true;
+  }
   const uint8_t* bytes = bytes_ + byte_offset_;
   size_t remaining_bits_in_current_byte = 8 - bit_offset_;
   uint32_t bits = LowestBits(*bytes++, remaining_bits_in_current_byte);
@@ -164,22 +194,22 @@ bool BitBuffer::ReadExponentialGolomb(uint32_t* val) {
   size_t original_byte_offset = byte_offset_;
   size_t original_bit_offset = bit_offset_;
 
-  // Count the number of leading 0 bits by peeking/consuming them one at a time.
-  size_t zero_bit_count = 0;
-  uint32_t peeked_bit;
-  while (PeekBits(&peeked_bit, 1) && peeked_bit == 0) {
-    zero_bit_count++;
-    ConsumeBits(1);
+  // Count the number of leading 0 bits in the next (up to) 32 bits at once.
+  // The value bit count is the number of zeros + 1, so if none of those bits
+  // are 1 the value either doesn't fit in a uint32_t or is truncated.
+  size_t peek_bit_count =
+      static_cast<size_t>(std::min<uint64_t>(32, RemainingBitCount()));
+  uint32_t peeked_bits;
+  if (!PeekBits(&peeked_bits, peek_bit_count) || peeked_bits == 0) {
+    return false;
   }
+  size_t zero_bit_count =
+      CountLeadingZeros32(peeked_bits << (32 - peek_bit_count));
+  ConsumeBits(zero_bit_count);
 
-  // We should either be at the end of the stream, or the next bit should be 1.
-  RTC_DCHECK(!PeekBits(&peeked_bit, 1) || peeked_bit == 1);
-
-  // The bit count of the value is the number of zeros + 1. Make sure that many
-  // bits fits in a uint32_t and that we have enough bits left for it, and then
-  // read the value.
+  // Make sure that we have enough bits left for the value, and then read it.
   size_t value_bit_count = zero_bit_count + 1;
-  if (value_bit_count > 32 || !ReadBits(val, value_bit_count)) {
+  if (!ReadBits(val, value_bit_count)) {
     RTC_CHECK(Seek(original_byte_offset, original_bit_offset));
     return false;
   }
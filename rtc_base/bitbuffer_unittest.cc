@@ -9,9 +9,14 @@
  */
 
 #include "rtc_base/bitbuffer.h"
+
+#include <vector>
+
 #include "rtc_base/arraysize.h"
 #include "rtc_base/bytebuffer.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
 
 namespace rtc {
 
@@ -136,6 +141,37 @@ TEST(BitBufferTest, ReadBits) {
   EXPECT_FALSE(buffer.ReadBits(&val, 1));
 }
 
+// Reads |bit_count| bits at |bit_offset| one bit at a time.
+uint32_t ReadBitsOneByOne(const uint8_t* bytes,
+                          size_t bit_offset,
+                          size_t bit_count) {
+  uint32_t val = 0;
+  for (size_t i = bit_offset; i < bit_offset + bit_count; ++i)
+    val = (val << 1) | ((bytes[i / 8] >> (7 - i % 8)) & 1);
+  return val;
+}
+
+TEST(BitBufferTest, PeekBitsAtAllOffsets) {
+  uint8_t bytes[16];
+  for (size_t i = 0; i < arraysize(bytes); ++i)
+    bytes[i] = static_cast<uint8_t>(i * 0x9D + 0x3B);
+  const size_t total_bits = arraysize(bytes) * 8;
+  BitBuffer buffer(bytes, arraysize(bytes));
+  // Covers both the reads from a single load and the reads of the last bytes.
+  for (size_t bit_offset = 0; bit_offset < total_bits; ++bit_offset) {
+    for (size_t bit_count = 0;
+         bit_count <= 32 && bit_offset + bit_count <= total_bits; ++bit_count) {
+      ASSERT_TRUE(buffer.Seek(bit_offset / 8, bit_offset % 8));
+      uint32_t val;
+      ASSERT_TRUE(buffer.PeekBits(&val, bit_count));
+      EXPECT_EQ(ReadBitsOneByOne(bytes, bit_offset, bit_count), val)
+          << "offset " << bit_offset << ", count " << bit_count;
+    }
+    uint32_t val;
+    EXPECT_FALSE(buffer.PeekBits(&val, total_bits - bit_offset + 1));
+  }
+}
+
 TEST(BitBufferTest, SetOffsetValues) {
   uint8_t bytes[4] = {0};
   BitBufferWriter buffer(bytes, 4);
@@ -243,6 +279,75 @@ TEST(BitBufferTest, NoGolombOverread) {
   EXPECT_EQ(0x01FEu, decoded_val);
 }
 
+TEST(BitBufferTest, GolombValuesAtEndOfBuffer) {
+  // 0, 1, 2, 3, 4 and 14, followed by the first 16 of the 23 bits of 2047.
+  const uint8_t bytes[] = {0xA6, 0x42, 0x8F, 0x00, 0x10};
+  BitBuffer buffer(bytes, arraysize(bytes));
+  const uint32_t kExpected[] = {0, 1, 2, 3, 4, 14};
+  for (uint32_t expected : kExpected) {
+    uint32_t decoded_val;
+    ASSERT_TRUE(buffer.ReadExponentialGolomb(&decoded_val));
+    EXPECT_EQ(expected, decoded_val);
+  }
+  uint64_t remaining_bits = buffer.RemainingBitCount();
+  uint32_t decoded_val;
+  EXPECT_FALSE(buffer.ReadExponentialGolomb(&decoded_val));
+  EXPECT_EQ(remaining_bits, buffer.RemainingBitCount());
+}
+
+// The exponential golomb decoding BitBuffer used to do, one bit at a time.
+bool ReadExponentialGolombOneByOne(BitBuffer* buffer, uint32_t* val) {
+  size_t zero_bit_count = 0;
+  uint32_t peeked_bit;
+  while (buffer->PeekBits(&peeked_bit, 1) && peeked_bit == 0) {
+    zero_bit_count++;
+    buffer->ConsumeBits(1);
+  }
+  if (zero_bit_count + 1 > 32 || !buffer->ReadBits(val, zero_bit_count + 1))
+    return false;
+  *val -= 1;
+  return true;
+}
+
+// Compares the exponential golomb decoding to decoding one bit at a time, as
+// for the ue(v) fields in H.264 headers.
+TEST(BitBufferTest, DISABLED_GolombReadPerformance) {
+  const int kNumValues = 10000;
+  const int kNumIterations = 1000;
+  std::vector<uint8_t> bytes(kNumValues * 4);
+  BitBufferWriter value_writer(bytes.data(), bytes.size());
+  for (int i = 0; i < kNumValues; ++i)
+    ASSERT_TRUE(value_writer.WriteExponentialGolomb((i * 37) % 300));
+
+  uint32_t sum = 0;
+  int64_t start_us = TimeMicros();
+  for (int n = 0; n < kNumIterations; ++n) {
+    BitBuffer buffer(bytes.data(), bytes.size());
+    uint32_t val;
+    for (int i = 0; i < kNumValues; ++i) {
+      ReadExponentialGolombOneByOne(&buffer, &val);
+      sum += val;
+    }
+  }
+  int64_t one_by_one_us = TimeMicros() - start_us;
+
+  start_us = TimeMicros();
+  for (int n = 0; n < kNumIterations; ++n) {
+    BitBuffer buffer(bytes.data(), bytes.size());
+    uint32_t val;
+    for (int i = 0; i < kNumValues; ++i) {
+      buffer.ReadExponentialGolomb(&val);
+      sum -= val;
+    }
+  }
+  int64_t golomb_us = TimeMicros() - start_us;
+
+  EXPECT_EQ(0u, sum);
+  RTC_LOG(LS_INFO) << "Decoded " << kNumValues * kNumIterations
+                   << " golomb values in " << golomb_us << " us, "
+                   << one_by_one_us << " us one bit at a time.";
+}
+
 TEST(BitBufferWriterTest, SymmetricReadWrite) {
   uint8_t bytes[16] = {0};
   BitBufferWriter buffer(bytes, 4);
@@ -18,6 +18,7 @@
 #include <utility>
 
 #include "api/array_view.h"
+#include "rtc_base/bufferpool.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/type_traits.h"
 #include "rtc_base/zero_memory.h"
@@ -41,6 +42,12 @@ struct BufferCompat {
            : (std::is_same<T, typename std::remove_const<U>::type>::value));
 };
 
+// (Internal; please don't use outside this file.) Releases BufferT storage,
+// which is allocated from BufferPool.
+struct BufferPoolDeleter {
+  void operator()(void* data) const { BufferPool::Free(data); }
+};
+
 }  // namespace internal
 
 // Basic buffer class, can be grown and shrunk dynamically.
@@ -87,7 +94,7 @@ class BufferT {
   BufferT(size_t size, size_t capacity)
       : size_(size),
         capacity_(std::max(size, capacity)),
-        data_(capacity_ > 0 ? new T[capacity_] : nullptr) {
+        data_(capacity_ > 0 ? AllocateData(capacity_) : nullptr) {
     RTC_DCHECK(IsConsistent());
   }
 
@@ -350,6 +357,12 @@ class BufferT {
   }
 
  private:
+  using DataPtr = std::unique_ptr<T[], internal::BufferPoolDeleter>;
+
+  static T* AllocateData(size_t capacity) {
+    return static_cast<T*>(BufferPool::Allocate(capacity * sizeof(T)));
+  }
+
   void EnsureCapacityWithHeadroom(size_t capacity, bool extra_headroom) {
     RTC_DCHECK(IsConsistent());
     if (capacity <= capacity_)
@@ -364,7 +377,7 @@ class BufferT {
         extra_headroom ? std::max(capacity, capacity_ + capacity_ / 2)
                        : capacity;
 
-    std::unique_ptr<T[]> new_data(new T[new_capacity]);
+    DataPtr new_data(AllocateData(new_capacity));
     std::memcpy(new_data.get(), data_.get(), size_ * sizeof(T));
     MaybeZeroCompleteBuffer();
     data_ = std::move(new_data);
@@ -414,7 +427,7 @@ class BufferT {
 
   size_t size_;
   size_t capacity_;
-  std::unique_ptr<T[]> data_;
+  DataPtr data_;
 };
 
 // By far the most common sort of buffer.
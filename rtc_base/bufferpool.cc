@@ -0,0 +1,294 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/bufferpool.h"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <cstddef>
+
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+
+namespace rtc {
+
+namespace {
+
+const size_t kSizeClasses[] = {64, 256, 1024, BufferPool::kMaxPooledSize};
+const size_t kNumSizeClasses = sizeof(kSizeClasses) / sizeof(kSizeClasses[0]);
+const size_t kUnpooled = kNumSizeClasses;
+
+// Maximum number of free blocks per size class in a thread's cache. When the
+// cache is full, half of it is moved to the shared free list.
+const size_t kMaxThreadCacheBlocks = 32;
+// Maximum number of free blocks per size class on the shared free list. Any
+// further blocks are returned to the heap.
+const size_t kMaxSharedBlocks = 1024;
+
+// Prepended to every block; |next| links free blocks together.
+union BlockHeader {
+  struct {
+    BlockHeader* next;
+    size_t size_class;
+  } info;
+  std::max_align_t alignment;
+};
+
+struct FreeList {
+  BlockHeader* head = nullptr;
+  size_t count = 0;
+
+  void Push(BlockHeader* block) {
+    block->info.next = head;
+    head = block;
+    ++count;
+  }
+
+  BlockHeader* Pop() {
+    BlockHeader* block = head;
+    if (block) {
+      head = block->info.next;
+      --count;
+    }
+    return block;
+  }
+};
+
+struct SharedState {
+  std::atomic<bool> enabled{false};
+  std::atomic<int64_t> hits{0};
+  std::atomic<int64_t> misses{0};
+  std::atomic<int64_t> outstanding_bytes{0};
+
+  CriticalSection crit;
+  FreeList free_lists[kNumSizeClasses];
+};
+
+struct ThreadCache {
+  FreeList free_lists[kNumSizeClasses];
+};
+
+SharedState* GetSharedState() {
+  // Leaked, since blocks may still be freed during static destruction.
+  static SharedState* const state = new SharedState();
+  return state;
+}
+
+size_t GetSizeClass(size_t size) {
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    if (size <= kSizeClasses[i])
+      return i;
+  }
+  return kUnpooled;
+}
+
+BlockHeader* AllocateFromHeap(size_t size, size_t size_class) {
+  BlockHeader* block =
+      static_cast<BlockHeader*>(malloc(sizeof(BlockHeader) + size));
+  RTC_CHECK(block);
+  block->info.next = nullptr;
+  block->info.size_class = size_class;
+  return block;
+}
+
+// Moves up to |count| blocks from |from| to |to|.
+void MoveBlocks(FreeList* from, FreeList* to, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    BlockHeader* block = from->Pop();
+    if (!block)
+      break;
+    to->Push(block);
+  }
+}
+
+void FreeBlocks(FreeList* list) {
+  while (BlockHeader* block = list->Pop())
+    free(block);
+}
+
+// Returns all but |keep| free blocks of |cache| to the shared free lists.
+void Flush(ThreadCache* cache, size_t keep) {
+  SharedState* state = GetSharedState();
+  CritScope cs(&state->crit);
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    FreeList* local = &cache->free_lists[i];
+    FreeList* shared = &state->free_lists[i];
+    while (local->count > keep) {
+      BlockHeader* block = local->Pop();
+      if (shared->count < kMaxSharedBlocks) {
+        shared->Push(block);
+      } else {
+        free(block);
+      }
+    }
+  }
+}
+
+#if defined(WEBRTC_POSIX)
+void DestroyThreadCache(void* value) {
+  ThreadCache* cache = static_cast<ThreadCache*>(value);
+  Flush(cache, 0);
+  delete cache;
+}
+
+pthread_key_t GetThreadCacheKey() {
+  static const pthread_key_t key = [] {
+    pthread_key_t key;
+    pthread_key_create(&key, &DestroyThreadCache);
+    return key;
+  }();
+  return key;
+}
+
+ThreadCache* GetThreadCache() {
+  pthread_key_t key = GetThreadCacheKey();
+  ThreadCache* cache = static_cast<ThreadCache*>(pthread_getspecific(key));
+  if (!cache) {
+    cache = new ThreadCache();
+    pthread_setspecific(key, cache);
+  }
+  return cache;
+}
+#else
+// There is no portable way to flush a thread's cache when it exits, so only
+// the shared free list is used.
+ThreadCache* GetThreadCache() {
+  return nullptr;
+}
+#endif
+
+BlockHeader* AllocatePooled(size_t size_class) {
+  SharedState* state = GetSharedState();
+  ThreadCache* cache = GetThreadCache();
+  BlockHeader* block = nullptr;
+  if (cache) {
+    FreeList* local = &cache->free_lists[size_class];
+    if (!local->head) {
+      CritScope cs(&state->crit);
+      MoveBlocks(&state->free_lists[size_class], local,
+                 kMaxThreadCacheBlocks / 2);
+    }
+    block = local->Pop();
+  } else {
+    CritScope cs(&state->crit);
+    block = state->free_lists[size_class].Pop();
+  }
+
+  if (block) {
+    state->hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    state->misses.fetch_add(1, std::memory_order_relaxed);
+    block = AllocateFromHeap(kSizeClasses[size_class], size_class);
+  }
+  state->outstanding_bytes.fetch_add(kSizeClasses[size_class],
+                                     std::memory_order_relaxed);
+  return block;
+}
+
+void FreePooled(BlockHeader* block) {
+  SharedState* state = GetSharedState();
+  const size_t size_class = block->info.size_class;
+  state->outstanding_bytes.fetch_sub(kSizeClasses[size_class],
+                                     std::memory_order_relaxed);
+  if (!state->enabled.load(std::memory_order_relaxed)) {
+    free(block);
+    return;
+  }
+
+  ThreadCache* cache = GetThreadCache();
+  if (!cache) {
+    CritScope cs(&state->crit);
+    FreeList* shared = &state->free_lists[size_class];
+    if (shared->count < kMaxSharedBlocks) {
+      shared->Push(block);
+    } else {
+      free(block);
+    }
+    return;
+  }
+
+  FreeList* local = &cache->free_lists[size_class];
+  if (local->count >= kMaxThreadCacheBlocks)
+    Flush(cache, kMaxThreadCacheBlocks / 2);
+  local->Push(block);
+}
+
+}  // namespace
+
+// static
+void BufferPool::SetEnabled(bool enabled) {
+  GetSharedState()->enabled.store(enabled, std::memory_order_relaxed);
+  if (!enabled)
+    Trim();
+}
+
+// static
+bool BufferPool::IsEnabled() {
+  return GetSharedState()->enabled.load(std::memory_order_relaxed);
+}
+
+// static
+void* BufferPool::Allocate(size_t size) {
+  SharedState* state = GetSharedState();
+  BlockHeader* block;
+  if (!state->enabled.load(std::memory_order_relaxed)) {
+    block = AllocateFromHeap(size, kUnpooled);
+  } else {
+    const size_t size_class = GetSizeClass(size);
+    if (size_class == kUnpooled) {
+      state->misses.fetch_add(1, std::memory_order_relaxed);
+      block = AllocateFromHeap(size, kUnpooled);
+    } else {
+      block = AllocatePooled(size_class);
+    }
+  }
+  return block + 1;
+}
+
+// static
+void BufferPool::Free(void* p) {
+  if (!p)
+    return;
+  BlockHeader* block = static_cast<BlockHeader*>(p) - 1;
+  RTC_DCHECK_LE(block->info.size_class, kUnpooled);
+  if (block->info.size_class == kUnpooled) {
+    free(block);
+    return;
+  }
+  FreePooled(block);
+}
+
+// static
+BufferPool::Stats BufferPool::GetStats() {
+  SharedState* state = GetSharedState();
+  Stats stats;
+  stats.hits = state->hits.load(std::memory_order_relaxed);
+  stats.misses = state->misses.load(std::memory_order_relaxed);
+  stats.outstanding_bytes =
+      state->outstanding_bytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// static
+void BufferPool::Trim() {
+  SharedState* state = GetSharedState();
+  if (ThreadCache* cache = GetThreadCache())
+    Flush(cache, 0);
+  CritScope cs(&state->crit);
+  for (FreeList& list : state->free_lists)
+    FreeBlocks(&list);
+}
+
+}  // namespace rtc
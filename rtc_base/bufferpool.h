@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_BUFFERPOOL_H_
+#define RTC_BASE_BUFFERPOOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rtc {
+
+// Process wide allocator for packet sized memory blocks, used by rtc::BufferT
+// and rtc::CopyOnWriteBuffer. Requests are rounded up to one of a few size
+// classes, the largest of which holds a full MTU sized packet plus SRTP
+// overhead, and freed blocks are kept for reuse instead of being returned to
+// the heap. On POSIX every thread has a small cache of free blocks, so that
+// the common case of allocating and freeing on the same thread takes no lock;
+// the caches are backed by a shared, bounded free list.
+//
+// The pool is disabled by default, in which case Allocate() and Free() are
+// thin wrappers around malloc() and free(). Blocks may be freed on any thread
+// and regardless of whether the pool was enabled when they were allocated.
+class BufferPool {
+ public:
+  // The largest request that is served from the pool. Larger requests always
+  // go to the heap.
+  static const size_t kMaxPooledSize = 2048;
+
+  struct Stats {
+    // Allocations served from a cache of free blocks.
+    int64_t hits = 0;
+    // Allocations made while the pool was enabled that had to go to the heap,
+    // because no free block was available or the request was too large.
+    int64_t misses = 0;
+    // Bytes in pooled blocks that are currently allocated.
+    int64_t outstanding_bytes = 0;
+  };
+
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled();
+
+  // Returns a block of at least |size| bytes, aligned for any type. Never
+  // returns null for a non-zero |size|.
+  static void* Allocate(size_t size);
+  // Frees a block returned by Allocate(). Null is ignored.
+  static void Free(void* block);
+
+  static Stats GetStats();
+  // Returns the free blocks on the shared free list and in the calling
+  // thread's cache to the heap.
+  static void Trim();
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_BUFFERPOOL_H_
@@ -0,0 +1,140 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/bufferpool.h"
+
+#include <string.h>
+
+#include <memory>
+
+#include "rtc_base/buffer.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/platform_thread.h"
+
+namespace rtc {
+
+namespace {
+
+class BufferPoolTest : public testing::Test {
+ protected:
+  BufferPoolTest() { BufferPool::SetEnabled(true); }
+  ~BufferPoolTest() override { BufferPool::SetEnabled(false); }
+};
+
+void FreeBlock(void* block) {
+  BufferPool::Free(block);
+}
+
+}  // namespace
+
+TEST(BufferPoolDisabledTest, AllocatesFromHeap) {
+  ASSERT_FALSE(BufferPool::IsEnabled());
+  BufferPool::Stats before = BufferPool::GetStats();
+  void* block = BufferPool::Allocate(100);
+  ASSERT_TRUE(block);
+  memset(block, 0xab, 100);
+  BufferPool::Free(block);
+  BufferPool::Stats after = BufferPool::GetStats();
+  EXPECT_EQ(before.hits, after.hits);
+  EXPECT_EQ(before.misses, after.misses);
+  EXPECT_EQ(before.outstanding_bytes, after.outstanding_bytes);
+}
+
+TEST_F(BufferPoolTest, ReusesFreedBlocks) {
+  BufferPool::Stats before = BufferPool::GetStats();
+  void* first = BufferPool::Allocate(1500);
+  BufferPool::Stats allocated = BufferPool::GetStats();
+  EXPECT_EQ(before.misses + 1, allocated.misses);
+  EXPECT_EQ(before.outstanding_bytes + 2048, allocated.outstanding_bytes);
+
+  BufferPool::Free(first);
+  EXPECT_EQ(before.outstanding_bytes,
+            BufferPool::GetStats().outstanding_bytes);
+
+  void* second = BufferPool::Allocate(1200);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(before.hits + 1, BufferPool::GetStats().hits);
+  BufferPool::Free(second);
+}
+
+TEST_F(BufferPoolTest, LargeAllocationsBypassPool) {
+  BufferPool::Stats before = BufferPool::GetStats();
+  void* block = BufferPool::Allocate(BufferPool::kMaxPooledSize + 1);
+  ASSERT_TRUE(block);
+  BufferPool::Stats allocated = BufferPool::GetStats();
+  EXPECT_EQ(before.misses + 1, allocated.misses);
+  EXPECT_EQ(before.outstanding_bytes, allocated.outstanding_bytes);
+  BufferPool::Free(block);
+}
+
+TEST_F(BufferPoolTest, BlocksAllocatedWhileDisabledCanBeFreed) {
+  BufferPool::SetEnabled(false);
+  void* block = BufferPool::Allocate(100);
+  BufferPool::SetEnabled(true);
+  BufferPool::Free(block);
+
+  block = BufferPool::Allocate(100);
+  BufferPool::SetEnabled(false);
+  BufferPool::Free(block);
+  BufferPool::SetEnabled(true);
+}
+
+TEST_F(BufferPoolTest, BlocksAreAligned) {
+  for (size_t size : {1, 64, 65, 2048, 4096}) {
+    void* block = BufferPool::Allocate(size);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % alignof(double));
+    BufferPool::Free(block);
+  }
+}
+
+TEST_F(BufferPoolTest, BlocksFreedOnAnotherThread) {
+  void* block = BufferPool::Allocate(1000);
+  BufferPool::Stats allocated = BufferPool::GetStats();
+  PlatformThread thread(&FreeBlock, block, "BufferPoolTest");
+  thread.Start();
+  thread.Stop();
+  EXPECT_EQ(allocated.outstanding_bytes - 1024,
+            BufferPool::GetStats().outstanding_bytes);
+}
+
+TEST_F(BufferPoolTest, BufferDrawsFromPool) {
+  BufferPool::Stats before = BufferPool::GetStats();
+  {
+    Buffer buffer(1200);
+    EXPECT_EQ(before.outstanding_bytes + 2048,
+              BufferPool::GetStats().outstanding_bytes);
+  }
+  BufferPool::Stats freed = BufferPool::GetStats();
+  EXPECT_EQ(before.outstanding_bytes, freed.outstanding_bytes);
+
+  Buffer buffer(1200);
+  EXPECT_EQ(freed.hits + 1, BufferPool::GetStats().hits);
+}
+
+TEST_F(BufferPoolTest, CopyOnWriteBufferDrawsFromPool) {
+  const uint8_t kData[] = {1, 2, 3, 4};
+  BufferPool::Stats before = BufferPool::GetStats();
+  {
+    CopyOnWriteBuffer buffer(kData, sizeof(kData), 1500);
+    CopyOnWriteBuffer copy = buffer;
+    // Both the refcounted Buffer and its data come from the pool, and are
+    // shared by the copies.
+    BufferPool::Stats allocated = BufferPool::GetStats();
+    EXPECT_EQ(before.hits + before.misses + 2,
+              allocated.hits + allocated.misses);
+    EXPECT_EQ(before.outstanding_bytes + 64 + 2048,
+              allocated.outstanding_bytes);
+  }
+  EXPECT_EQ(before.outstanding_bytes,
+            BufferPool::GetStats().outstanding_bytes);
+}
+
+}  // namespace rtc
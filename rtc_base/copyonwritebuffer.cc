@@ -17,54 +17,64 @@ CopyOnWriteBuffer::CopyOnWriteBuffer() {
 }
 
 CopyOnWriteBuffer::CopyOnWriteBuffer(const CopyOnWriteBuffer& buf)
-    : buffer_(buf.buffer_) {}
+    : buffer_(buf.buffer_), offset_(buf.offset_), size_(buf.size_) {}
 
 CopyOnWriteBuffer::CopyOnWriteBuffer(CopyOnWriteBuffer&& buf)
-    : buffer_(std::move(buf.buffer_)) {}
+    : buffer_(std::move(buf.buffer_)), offset_(buf.offset_), size_(buf.size_) {
+  buf.offset_ = 0;
+  buf.size_ = 0;
+}
 
 CopyOnWriteBuffer::CopyOnWriteBuffer(const std::string& s)
     : CopyOnWriteBuffer(s.data(), s.length()) {}
 
 CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size)
-    : buffer_(size > 0 ? new RefCountedObject<Buffer>(size) : nullptr) {
+    : buffer_(size > 0 ? new RefCountedBuffer(size) : nullptr),
+      size_(size) {
   RTC_DCHECK(IsConsistent());
 }
 
 CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size, size_t capacity)
-    : buffer_(size > 0 || capacity > 0
-                  ? new RefCountedObject<Buffer>(size, capacity)
-                  : nullptr) {
+    : buffer_(size > 0 || capacity > 0 ? new RefCountedBuffer(size, capacity)
+                                       : nullptr),
+      size_(size) {
   RTC_DCHECK(IsConsistent());
 }
 
 CopyOnWriteBuffer::~CopyOnWriteBuffer() = default;
 
 bool CopyOnWriteBuffer::operator==(const CopyOnWriteBuffer& buf) const {
-  // Must either use the same buffer internally or have the same contents.
+  // Must either be the same view of the same buffer or have the same
+  // contents.
   RTC_DCHECK(IsConsistent());
   RTC_DCHECK(buf.IsConsistent());
-  return buffer_.get() == buf.buffer_.get() ||
-         (buffer_.get() && buf.buffer_.get() &&
-          *buffer_.get() == *buf.buffer_.get());
+  if (size_ != buf.size_)
+    return false;
+  if (buffer_.get() == buf.buffer_.get() && offset_ == buf.offset_)
+    return true;
+  return size_ == 0 || std::memcmp(cdata(), buf.cdata(), size_) == 0;
 }
 
 void CopyOnWriteBuffer::SetSize(size_t size) {
   RTC_DCHECK(IsConsistent());
   if (!buffer_) {
     if (size > 0) {
-      buffer_ = new RefCountedObject<Buffer>(size);
+      buffer_ = new RefCountedBuffer(size);
+      size_ = size;
     }
     RTC_DCHECK(IsConsistent());
     return;
   }
 
-  // Clone data if referenced.
-  if (!buffer_->HasOneRef()) {
-    buffer_ = new RefCountedObject<Buffer>(buffer_->data(),
-                                           std::min(buffer_->size(), size),
-                                           std::max(buffer_->capacity(), size));
+  // Shrinking only narrows the view, so the data may stay shared.
+  if (size <= size_) {
+    size_ = size;
+    return;
   }
-  buffer_->SetSize(size);
+
+  CloneDataIfReferenced(std::max(capacity(), size));
+  buffer_->SetSize(offset_ + size);
+  size_ = size;
   RTC_DCHECK(IsConsistent());
 }
 
@@ -72,16 +82,16 @@ void CopyOnWriteBuffer::EnsureCapacity(size_t capacity) {
   RTC_DCHECK(IsConsistent());
   if (!buffer_) {
     if (capacity > 0) {
-      buffer_ = new RefCountedObject<Buffer>(0, capacity);
+      buffer_ = new RefCountedBuffer(0, capacity);
     }
     RTC_DCHECK(IsConsistent());
     return;
-  } else if (capacity <= buffer_->capacity()) {
+  } else if (capacity <= this->capacity()) {
     return;
   }
 
-  CloneDataIfReferenced(std::max(buffer_->capacity(), capacity));
-  buffer_->EnsureCapacity(capacity);
+  CloneDataIfReferenced(std::max(this->capacity(), capacity));
+  buffer_->EnsureCapacity(offset_ + capacity);
   RTC_DCHECK(IsConsistent());
 }
 
@@ -92,8 +102,10 @@ void CopyOnWriteBuffer::Clear() {
   if (buffer_->HasOneRef()) {
     buffer_->Clear();
   } else {
-    buffer_ = new RefCountedObject<Buffer>(0, buffer_->capacity());
+    buffer_ = new RefCountedBuffer(0, capacity());
   }
+  offset_ = 0;
+  size_ = 0;
   RTC_DCHECK(IsConsistent());
 }
 
@@ -102,8 +114,9 @@ void CopyOnWriteBuffer::CloneDataIfReferenced(size_t new_capacity) {
     return;
   }
 
-  buffer_ = new RefCountedObject<Buffer>(buffer_->data(), buffer_->size(),
-                                         new_capacity);
+  buffer_ =
+      new RefCountedBuffer(buffer_->data() + offset_, size_, new_capacity);
+  offset_ = 0;
   RTC_DCHECK(IsConsistent());
 }
 
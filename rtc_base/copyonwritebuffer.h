@@ -15,6 +15,7 @@
 #include <utility>
 
 #include "rtc_base/buffer.h"
+#include "rtc_base/bufferpool.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/refcountedobject.h"
@@ -84,8 +85,8 @@ class CopyOnWriteBuffer {
     if (!buffer_) {
       return nullptr;
     }
-    CloneDataIfReferenced(buffer_->capacity());
-    return buffer_->data<T>();
+    CloneDataIfReferenced(capacity());
+    return buffer_->data<T>() + offset_;
   }
 
   // Get const pointer to the data. This will not create a copy of the
@@ -98,17 +99,17 @@ class CopyOnWriteBuffer {
     if (!buffer_) {
       return nullptr;
     }
-    return buffer_->data<T>();
+    return buffer_->data<T>() + offset_;
   }
 
   size_t size() const {
     RTC_DCHECK(IsConsistent());
-    return buffer_ ? buffer_->size() : 0;
+    return size_;
   }
 
   size_t capacity() const {
     RTC_DCHECK(IsConsistent());
-    return buffer_ ? buffer_->capacity() : 0;
+    return buffer_ ? buffer_->capacity() - offset_ : 0;
   }
 
   CopyOnWriteBuffer& operator=(const CopyOnWriteBuffer& buf) {
@@ -116,6 +117,8 @@ class CopyOnWriteBuffer {
     RTC_DCHECK(buf.IsConsistent());
     if (&buf != this) {
       buffer_ = buf.buffer_;
+      offset_ = buf.offset_;
+      size_ = buf.size_;
     }
     return *this;
   }
@@ -124,6 +127,10 @@ class CopyOnWriteBuffer {
     RTC_DCHECK(IsConsistent());
     RTC_DCHECK(buf.IsConsistent());
     buffer_ = std::move(buf.buffer_);
+    offset_ = buf.offset_;
+    size_ = buf.size_;
+    buf.offset_ = 0;
+    buf.size_ = 0;
     return *this;
   }
 
@@ -151,12 +158,14 @@ class CopyOnWriteBuffer {
   void SetData(const T* data, size_t size) {
     RTC_DCHECK(IsConsistent());
     if (!buffer_) {
-      buffer_ = size > 0 ? new RefCountedObject<Buffer>(data, size) : nullptr;
+      buffer_ = size > 0 ? new RefCountedBuffer(data, size) : nullptr;
     } else if (!buffer_->HasOneRef()) {
-      buffer_ = new RefCountedObject<Buffer>(data, size, buffer_->capacity());
+      buffer_ = new RefCountedBuffer(data, size, capacity());
     } else {
       buffer_->SetData(data, size);
     }
+    offset_ = 0;
+    size_ = size;
     RTC_DCHECK(IsConsistent());
   }
 
@@ -173,6 +182,8 @@ class CopyOnWriteBuffer {
     RTC_DCHECK(buf.IsConsistent());
     if (&buf != this) {
       buffer_ = buf.buffer_;
+      offset_ = buf.offset_;
+      size_ = buf.size_;
     }
   }
 
@@ -183,14 +194,17 @@ class CopyOnWriteBuffer {
   void AppendData(const T* data, size_t size) {
     RTC_DCHECK(IsConsistent());
     if (!buffer_) {
-      buffer_ = new RefCountedObject<Buffer>(data, size);
+      buffer_ = new RefCountedBuffer(data, size);
+      size_ = size;
       RTC_DCHECK(IsConsistent());
       return;
     }
 
-    CloneDataIfReferenced(
-        std::max(buffer_->capacity(), buffer_->size() + size));
+    CloneDataIfReferenced(std::max(capacity(), size_ + size));
+    // Drop what lies beyond this view, if the buffer was sliced or shrunk.
+    buffer_->SetSize(offset_ + size_);
     buffer_->AppendData(data, size);
+    size_ += size;
     RTC_DCHECK(IsConsistent());
   }
 
@@ -221,21 +235,56 @@ class CopyOnWriteBuffer {
   // buffer has been moved from.
   void Clear();
 
+  // Returns a buffer that refers to |length| bytes of this buffer, starting
+  // at |offset|, without copying them. Like any copy, the slice shares the
+  // memory until either of them is modified.
+  CopyOnWriteBuffer Slice(size_t offset, size_t length) const {
+    RTC_DCHECK_LE(offset, size());
+    RTC_DCHECK_LE(length, size() - offset);
+    CopyOnWriteBuffer slice(*this);
+    slice.offset_ += offset;
+    slice.size_ = length;
+    RTC_DCHECK(slice.IsConsistent());
+    return slice;
+  }
+
   // Swaps two buffers.
   friend void swap(CopyOnWriteBuffer& a, CopyOnWriteBuffer& b) {
     std::swap(a.buffer_, b.buffer_);
+    std::swap(a.offset_, b.offset_);
+    std::swap(a.size_, b.size_);
   }
 
  private:
-  // Create a copy of the underlying data if it is referenced from other Buffer
-  // objects.
+  // The shared Buffer, which like its contents is allocated from BufferPool.
+  class RefCountedBuffer : public RefCountedObject<Buffer> {
+   public:
+    using RefCountedObject<Buffer>::RefCountedObject;
+
+    static void* operator new(size_t size) {
+      return BufferPool::Allocate(size);
+    }
+    static void operator delete(void* p) { BufferPool::Free(p); }
+  };
+
+  // Create a copy of the data of this view if the underlying Buffer is
+  // referenced from other CopyOnWriteBuffer objects.
   void CloneDataIfReferenced(size_t new_capacity);
 
   // Pre- and postcondition of all methods.
-  bool IsConsistent() const { return (!buffer_ || buffer_->capacity() > 0); }
+  bool IsConsistent() const {
+    if (!buffer_)
+      return offset_ == 0 && size_ == 0;
+    return buffer_->capacity() > 0 && offset_ <= buffer_->size() &&
+           size_ <= buffer_->size() - offset_;
+  }
 
   // buffer_ is either null, or points to an rtc::Buffer with capacity > 0.
-  scoped_refptr<RefCountedObject<Buffer>> buffer_;
+  scoped_refptr<RefCountedBuffer> buffer_;
+  // This buffer is the |size_| bytes of |buffer_| starting at |offset_|.
+  // Slices and shrinking leave bytes of |buffer_| outside of the view.
+  size_t offset_ = 0;
+  size_t size_ = 0;
 };
 
 }  // namespace rtc
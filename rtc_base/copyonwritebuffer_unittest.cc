@@ -316,4 +316,65 @@ TEST(CopyOnWriteBufferTest, TestBacketWrite) {
   EXPECT_EQ(0, memcmp(buf2.cdata(), kTestData, 3));
 }
 
+TEST(CopyOnWriteBufferTest, SliceSharesData) {
+  const CopyOnWriteBuffer buf(kTestData, 10, 10);
+  const CopyOnWriteBuffer slice = buf.Slice(3, 4);
+
+  EXPECT_EQ(4u, slice.size());
+  EXPECT_EQ(7u, slice.capacity());
+  EXPECT_EQ(buf.cdata() + 3, slice.cdata());
+  EXPECT_EQ(0, memcmp(slice.cdata(), kTestData + 3, 4));
+  EXPECT_EQ(CopyOnWriteBuffer(kTestData + 3, 4), slice);
+  EXPECT_EQ(kTestData[5], slice[2]);
+
+  const CopyOnWriteBuffer nested = slice.Slice(1, 2);
+  EXPECT_EQ(buf.cdata() + 4, nested.cdata());
+  EXPECT_EQ(2u, nested.size());
+}
+
+TEST(CopyOnWriteBufferTest, WritingToSliceDoesntChangeOriginal) {
+  CopyOnWriteBuffer buf(kTestData, 10, 10);
+  const uint8_t* const original_allocation = buf.cdata();
+  CopyOnWriteBuffer slice = buf.Slice(3, 4);
+
+  slice[0] = 0xff;
+
+  EnsureBuffersDontShareData(buf, slice);
+  EXPECT_EQ(original_allocation, buf.cdata());
+  EXPECT_EQ(0, memcmp(buf.cdata(), kTestData, 10));
+  EXPECT_EQ(0xff, slice[0]);
+  EXPECT_EQ(0, memcmp(slice.cdata() + 1, kTestData + 4, 3));
+}
+
+TEST(CopyOnWriteBufferTest, AppendToSliceDropsDataBeyondIt) {
+  CopyOnWriteBuffer buf(kTestData, 10, 10);
+  CopyOnWriteBuffer slice = buf.Slice(2, 2);
+  // Only the slice refers to the data now.
+  buf.Clear();
+
+  slice.AppendData(kTestData, 3);
+
+  EXPECT_EQ(5u, slice.size());
+  EXPECT_EQ(0, memcmp(slice.cdata(), kTestData + 2, 2));
+  EXPECT_EQ(0, memcmp(slice.cdata() + 2, kTestData, 3));
+}
+
+TEST(CopyOnWriteBufferTest, ShrinkingKeepsDataShared) {
+  CopyOnWriteBuffer buf1(kTestData, 10, 10);
+  CopyOnWriteBuffer buf2(buf1);
+
+  buf2.SetSize(4);
+
+  EXPECT_EQ(buf1.cdata(), buf2.cdata());
+  EXPECT_EQ(10u, buf1.size());
+  EXPECT_EQ(4u, buf2.size());
+  EXPECT_NE(buf1, buf2);
+
+  // Growing again clones the data and leaves the original alone.
+  buf2.SetSize(6);
+  EnsureBuffersDontShareData(buf1, buf2);
+  EXPECT_EQ(0, memcmp(buf2.cdata(), kTestData, 4));
+  EXPECT_EQ(10u, buf1.size());
+}
+
 }  // namespace rtc
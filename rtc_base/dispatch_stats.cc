@@ -0,0 +1,278 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/dispatch_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+// The number of locations per queue written by LogStats().
+const size_t kMaxLoggedLocations = 10;
+
+std::atomic<bool> g_recording(false);
+
+void LogStatsPeriodically(void* param);
+
+struct DispatchStatsRegistry {
+  CriticalSection crit;
+  std::map<std::string, std::unique_ptr<DispatchStatsRecorder>> recorders
+      RTC_GUARDED_BY(crit);
+  // Set while the stats are logged periodically.
+  std::unique_ptr<PlatformThread> log_thread;
+  Event stop_logging{false, false};
+  int log_interval_ms = 0;
+};
+
+DispatchStatsRegistry* GetRegistry() {
+  // Leaked, so that queues may record during static destruction.
+  static DispatchStatsRegistry* const registry = new DispatchStatsRegistry();
+  return registry;
+}
+
+void LogStatsPeriodically(void* /* param */) {
+  DispatchStatsRegistry* registry = GetRegistry();
+  while (!registry->stop_logging.Wait(registry->log_interval_ms))
+    DispatchStatsRecorder::LogStats();
+}
+
+// Records a task when it runs.
+class RecordedTask : public QueuedTask {
+ public:
+  RecordedTask(std::unique_ptr<QueuedTask> task,
+               DispatchStatsRecorder* recorder,
+               int64_t delay_ms)
+      : task_(std::move(task)),
+        recorder_(recorder),
+        due_time_us_(delay_ms == kDispatchDelayUnknown
+                         ? -1
+                         : TimeMicros() + delay_ms * kNumMicrosecsPerMillisec) {
+  }
+
+ private:
+  bool Run() override {
+    const int64_t start_time_us = TimeMicros();
+    const int64_t start_cpu_time_ns = GetThreadCpuTimeNanos();
+    // A task that returns false has taken ownership of itself, e.g. to post
+    // itself again.
+    if (!task_->Run())
+      task_.release();
+    const int64_t queue_delay_us =
+        due_time_us_ < 0 ? -1 : std::max<int64_t>(0, start_time_us -
+                                                          due_time_us_);
+    recorder_->Record(nullptr, queue_delay_us, TimeMicros() - start_time_us,
+                      GetThreadCpuTimeNanos() - start_cpu_time_ns);
+    return true;
+  }
+
+  std::unique_ptr<QueuedTask> task_;
+  DispatchStatsRecorder* const recorder_;
+  const int64_t due_time_us_;
+};
+
+}  // namespace
+
+DispatchHistogram::DispatchHistogram() {
+  buckets_.fill(0);
+}
+
+void DispatchHistogram::Add(int64_t value) {
+  int bucket = 0;
+  while (bucket < kNumBuckets - 1 && value >= (int64_t{1} << bucket))
+    ++bucket;
+  ++buckets_[bucket];
+  ++count_;
+  sum_ += value;
+  max_ = std::max(max_, value);
+}
+
+int64_t DispatchHistogram::Percentile(int percentile) const {
+  RTC_DCHECK_GE(percentile, 0);
+  RTC_DCHECK_LE(percentile, 100);
+  if (count_ == 0)
+    return 0;
+  // The number of values at or below the percentile, rounded up.
+  const int64_t rank = std::max<int64_t>(1, (count_ * percentile + 99) / 100);
+  int64_t seen = 0;
+  for (int bucket = 0; bucket < kNumBuckets - 1; ++bucket) {
+    seen += buckets_[bucket];
+    if (seen >= rank)
+      return std::min(max_, int64_t{1} << bucket);
+  }
+  return max_;
+}
+
+DispatchLocationStats::DispatchLocationStats() = default;
+
+DispatchLocationStats::DispatchLocationStats(const DispatchLocationStats&) =
+    default;
+
+DispatchLocationStats::~DispatchLocationStats() = default;
+
+DispatchQueueStats::DispatchQueueStats() = default;
+
+DispatchQueueStats::DispatchQueueStats(const DispatchQueueStats&) = default;
+
+DispatchQueueStats::~DispatchQueueStats() = default;
+
+DispatchStatsRecorder::DispatchStatsRecorder(const std::string& queue_name)
+    : queue_name_(queue_name) {}
+
+// static
+DispatchStatsRecorder* DispatchStatsRecorder::ForQueue(
+    const std::string& queue_name) {
+  DispatchStatsRegistry* registry = GetRegistry();
+  CritScope lock(&registry->crit);
+  std::unique_ptr<DispatchStatsRecorder>& recorder =
+      registry->recorders[queue_name];
+  if (!recorder)
+    recorder.reset(new DispatchStatsRecorder(queue_name));
+  return recorder.get();
+}
+
+// static
+void DispatchStatsRecorder::StartRecording(int log_interval_ms) {
+  DispatchStatsRegistry* registry = GetRegistry();
+  RTC_DCHECK(!registry->log_thread);
+  g_recording.store(true);
+  if (log_interval_ms > 0) {
+    registry->log_interval_ms = log_interval_ms;
+    registry->log_thread.reset(new PlatformThread(
+        &LogStatsPeriodically, nullptr, "DispatchStatsLog", kLowPriority));
+    registry->log_thread->Start();
+  }
+}
+
+// static
+void DispatchStatsRecorder::StopRecording() {
+  g_recording.store(false);
+  DispatchStatsRegistry* registry = GetRegistry();
+  if (registry->log_thread) {
+    registry->stop_logging.Set();
+    registry->log_thread->Stop();
+    registry->log_thread.reset();
+  }
+}
+
+// static
+bool DispatchStatsRecorder::IsRecording() {
+  return g_recording.load(std::memory_order_relaxed);
+}
+
+// static
+std::vector<DispatchQueueStats> DispatchStatsRecorder::GetStats() {
+  std::vector<DispatchStatsRecorder*> recorders;
+  {
+    DispatchStatsRegistry* registry = GetRegistry();
+    CritScope lock(&registry->crit);
+    for (const auto& kv : registry->recorders)
+      recorders.push_back(kv.second.get());
+  }
+  std::vector<DispatchQueueStats> stats;
+  for (const DispatchStatsRecorder* recorder : recorders) {
+    stats.push_back(recorder->GetQueueStats());
+    if (stats.back().locations.empty())
+      stats.pop_back();
+  }
+  return stats;
+}
+
+// static
+void DispatchStatsRecorder::ResetStats() {
+  DispatchStatsRegistry* registry = GetRegistry();
+  CritScope lock(&registry->crit);
+  for (const auto& kv : registry->recorders)
+    kv.second->Reset();
+}
+
+// static
+void DispatchStatsRecorder::LogStats() {
+  for (const DispatchQueueStats& queue : GetStats()) {
+    RTC_LOG(LS_INFO) << "Dispatch stats of " << queue.queue_name
+                     << ": cpu_time_ms=" << queue.cpu_time_ns / 1000000;
+    const size_t num_locations =
+        std::min(queue.locations.size(), kMaxLoggedLocations);
+    for (size_t i = 0; i < num_locations; ++i) {
+      const DispatchLocationStats& location = queue.locations[i];
+      RTC_LOG(LS_INFO) << "  "
+                       << (location.location.empty() ? "(task)"
+                                                     : location.location)
+                       << ": count=" << location.run_time_us.count()
+                       << ", delay_us p50=" << location.queue_delay_us
+                                                   .Percentile(50)
+                       << " p99=" << location.queue_delay_us.Percentile(99)
+                       << " max=" << location.queue_delay_us.max()
+                       << ", run_us p50=" << location.run_time_us.Percentile(50)
+                       << " p99=" << location.run_time_us.Percentile(99)
+                       << " max=" << location.run_time_us.max()
+                       << ", cpu_time_ms=" << location.cpu_time_ns / 1000000;
+    }
+  }
+}
+
+void DispatchStatsRecorder::Record(const char* location,
+                                   int64_t queue_delay_us,
+                                   int64_t run_time_us,
+                                   int64_t cpu_time_ns) {
+  CritScope lock(&crit_);
+  cpu_time_ns_ += cpu_time_ns;
+  DispatchLocationStats& stats = locations_[location];
+  if (stats.location.empty() && location)
+    stats.location = location;
+  if (queue_delay_us >= 0)
+    stats.queue_delay_us.Add(queue_delay_us);
+  stats.run_time_us.Add(run_time_us);
+  stats.cpu_time_ns += cpu_time_ns;
+}
+
+DispatchQueueStats DispatchStatsRecorder::GetQueueStats() const {
+  DispatchQueueStats stats;
+  stats.queue_name = queue_name_;
+  {
+    CritScope lock(&crit_);
+    stats.cpu_time_ns = cpu_time_ns_;
+    for (const auto& kv : locations_)
+      stats.locations.push_back(kv.second);
+  }
+  std::sort(stats.locations.begin(), stats.locations.end(),
+            [](const DispatchLocationStats& a, const DispatchLocationStats& b) {
+              return a.run_time_us.sum() > b.run_time_us.sum();
+            });
+  return stats;
+}
+
+void DispatchStatsRecorder::Reset() {
+  CritScope lock(&crit_);
+  cpu_time_ns_ = 0;
+  locations_.clear();
+}
+
+std::unique_ptr<QueuedTask> WrapTaskForDispatchStats(
+    std::unique_ptr<QueuedTask> task,
+    DispatchStatsRecorder* recorder,
+    int64_t delay_ms) {
+  if (!DispatchStatsRecorder::IsRecording())
+    return task;
+  return std::unique_ptr<QueuedTask>(
+      new RecordedTask(std::move(task), recorder, delay_ms));
+}
+
+}  // namespace rtc
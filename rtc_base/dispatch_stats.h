@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_DISPATCH_STATS_H_
+#define RTC_BASE_DISPATCH_STATS_H_
+
+#include <stdint.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+
+// Counts values in buckets of powers of two.
+class DispatchHistogram {
+ public:
+  // Bucket 0 counts the values below 1, bucket i > 0 the values in
+  // [2^(i-1), 2^i), and the last bucket everything above.
+  static const int kNumBuckets = 26;
+
+  DispatchHistogram();
+
+  void Add(int64_t value);
+
+  // Returns the upper bound of the bucket in which the |percentile| (0 to 100)
+  // of the values falls, or 0 if there are no values.
+  int64_t Percentile(int percentile) const;
+
+  int64_t count() const { return count_; }
+  int64_t sum() const { return sum_; }
+  int64_t max() const { return max_; }
+  const std::array<int64_t, kNumBuckets>& buckets() const { return buckets_; }
+
+ private:
+  std::array<int64_t, kNumBuckets> buckets_;
+  int64_t count_ = 0;
+  int64_t sum_ = 0;
+  int64_t max_ = 0;
+};
+
+struct DispatchLocationStats {
+  DispatchLocationStats();
+  DispatchLocationStats(const DispatchLocationStats&);
+  ~DispatchLocationStats();
+
+  // The RTC_FROM_HERE file and line the messages were posted from. Empty for
+  // TaskQueue tasks, which don't record where they were posted from.
+  std::string location;
+  // The time from when a message was due to run until it started.
+  DispatchHistogram queue_delay_us;
+  DispatchHistogram run_time_us;
+  int64_t cpu_time_ns = 0;
+};
+
+struct DispatchQueueStats {
+  DispatchQueueStats();
+  DispatchQueueStats(const DispatchQueueStats&);
+  ~DispatchQueueStats();
+
+  std::string queue_name;
+  // The thread CPU time spent running the messages of the queue.
+  int64_t cpu_time_ns = 0;
+  // Sorted by the total run time, longest first.
+  std::vector<DispatchLocationStats> locations;
+};
+
+// Records how long the messages of rtc::MessageQueue and the tasks of
+// rtc::TaskQueue wait to run and how long they run, per queue and per
+// location the messages were posted from. Recording is off by default, in
+// which case the queues only check IsRecording() per message.
+class DispatchStatsRecorder {
+ public:
+  // Returns the recorder of the queues named |queue_name|. Recorders live
+  // until the process exits, so that the pointer can be kept.
+  static DispatchStatsRecorder* ForQueue(const std::string& queue_name);
+
+  // Starts recording, and if |log_interval_ms| is positive, logs the stats
+  // that often. StartRecording and StopRecording must be called on the same
+  // thread.
+  static void StartRecording(int log_interval_ms);
+  static void StopRecording();
+  static bool IsRecording();
+
+  static std::vector<DispatchQueueStats> GetStats();
+  static void ResetStats();
+  // Logs the busiest locations of each queue.
+  static void LogStats();
+
+  // |location| is the RTC_FROM_HERE file and line, or null. A negative
+  // |queue_delay_us| means the delay is unknown.
+  void Record(const char* location,
+              int64_t queue_delay_us,
+              int64_t run_time_us,
+              int64_t cpu_time_ns);
+
+ private:
+  explicit DispatchStatsRecorder(const std::string& queue_name);
+
+  DispatchQueueStats GetQueueStats() const;
+  void Reset();
+
+  const std::string queue_name_;
+  CriticalSection crit_;
+  int64_t cpu_time_ns_ RTC_GUARDED_BY(crit_) = 0;
+  // Keyed by the RTC_FROM_HERE string, which has a fixed address per call
+  // site.
+  std::map<const char*, DispatchLocationStats> locations_
+      RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DispatchStatsRecorder);
+};
+
+// Passed as |delay_ms| for tasks for which the time they were due to run is
+// not known.
+const int64_t kDispatchDelayUnknown = -1;
+
+// Returns |task| wrapped such that |recorder| records it when it runs, if
+// recording is on, or else |task| itself. |delay_ms| is the time from now
+// until the task is due to run.
+std::unique_ptr<QueuedTask> WrapTaskForDispatchStats(
+    std::unique_ptr<QueuedTask> task,
+    DispatchStatsRecorder* recorder,
+    int64_t delay_ms);
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_DISPATCH_STATS_H_
@@ -0,0 +1,152 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/dispatch_stats.h"
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+
+namespace {
+
+const DispatchQueueStats* FindQueue(
+    const std::vector<DispatchQueueStats>& stats,
+    const std::string& queue_name) {
+  for (const DispatchQueueStats& queue : stats) {
+    if (queue.queue_name == queue_name)
+      return &queue;
+  }
+  return nullptr;
+}
+
+class SignalingHandler : public MessageHandler {
+ public:
+  void OnMessage(Message* msg) override { done.Set(); }
+
+  Event done{false, false};
+};
+
+}  // namespace
+
+TEST(DispatchHistogramTest, CountsValuesInPowerOfTwoBuckets) {
+  DispatchHistogram histogram;
+  EXPECT_EQ(0, histogram.Percentile(50));
+  histogram.Add(0);
+  histogram.Add(1);
+  histogram.Add(3);
+  histogram.Add(1000);
+
+  EXPECT_EQ(4, histogram.count());
+  EXPECT_EQ(1004, histogram.sum());
+  EXPECT_EQ(1000, histogram.max());
+  EXPECT_EQ(1, histogram.buckets()[0]);
+  EXPECT_EQ(1, histogram.buckets()[1]);
+  EXPECT_EQ(1, histogram.buckets()[2]);
+  EXPECT_EQ(1, histogram.buckets()[10]);
+  EXPECT_EQ(4, histogram.Percentile(75));
+  EXPECT_EQ(1000, histogram.Percentile(100));
+}
+
+TEST(DispatchStatsRecorderTest, RecordsPerLocation) {
+  DispatchStatsRecorder* recorder =
+      DispatchStatsRecorder::ForQueue("RecordsPerLocation");
+  EXPECT_EQ(recorder, DispatchStatsRecorder::ForQueue("RecordsPerLocation"));
+  const char* const kLocation = "file.cc:1";
+  recorder->Record(kLocation, 10, 100, 1000);
+  recorder->Record(kLocation, -1, 200, 2000);
+  recorder->Record(nullptr, 5, 1000, 3000);
+
+  const std::vector<DispatchQueueStats> stats =
+      DispatchStatsRecorder::GetStats();
+  const DispatchQueueStats* queue = FindQueue(stats, "RecordsPerLocation");
+  ASSERT_TRUE(queue);
+  EXPECT_EQ(6000, queue->cpu_time_ns);
+  ASSERT_EQ(2u, queue->locations.size());
+  // Sorted by the total run time.
+  EXPECT_EQ("", queue->locations[0].location);
+  EXPECT_EQ(kLocation, queue->locations[1].location);
+  EXPECT_EQ(2, queue->locations[1].run_time_us.count());
+  EXPECT_EQ(300, queue->locations[1].run_time_us.sum());
+  // The unknown queue delay is left out.
+  EXPECT_EQ(1, queue->locations[1].queue_delay_us.count());
+  EXPECT_EQ(3000, queue->locations[1].cpu_time_ns);
+
+  DispatchStatsRecorder::ResetStats();
+  EXPECT_FALSE(
+      FindQueue(DispatchStatsRecorder::GetStats(), "RecordsPerLocation"));
+}
+
+TEST(DispatchStatsRecorderTest, RecordsThreadMessages) {
+  DispatchStatsRecorder::ResetStats();
+  DispatchStatsRecorder::StartRecording(0);
+  std::unique_ptr<Thread> thread(Thread::Create());
+  thread->SetName("RecordsThreadMessages", nullptr);
+  thread->Start();
+  SignalingHandler handler;
+  thread->Post(RTC_FROM_HERE, &handler);
+  EXPECT_TRUE(handler.done.Wait(Event::kForever));
+  thread->PostDelayed(RTC_FROM_HERE, 1, &handler);
+  EXPECT_TRUE(handler.done.Wait(Event::kForever));
+  thread->Stop();
+  DispatchStatsRecorder::StopRecording();
+
+  const std::vector<DispatchQueueStats> stats =
+      DispatchStatsRecorder::GetStats();
+  const DispatchQueueStats* queue = FindQueue(stats, "RecordsThreadMessages");
+  ASSERT_TRUE(queue);
+  ASSERT_EQ(2u, queue->locations.size());
+  for (const DispatchLocationStats& location : queue->locations) {
+    EXPECT_NE(std::string::npos,
+              location.location.find("dispatch_stats_unittest.cc"));
+    EXPECT_EQ(1, location.run_time_us.count());
+    EXPECT_EQ(1, location.queue_delay_us.count());
+  }
+}
+
+TEST(DispatchStatsRecorderTest, RecordsTaskQueueTasks) {
+  DispatchStatsRecorder::ResetStats();
+  DispatchStatsRecorder::StartRecording(0);
+  {
+    TaskQueue queue("RecordsTaskQueueTasks");
+    Event done(false, false);
+    queue.PostTask([] {});
+    queue.PostDelayedTask([&done] { done.Set(); }, 1);
+    EXPECT_TRUE(done.Wait(Event::kForever));
+  }
+  DispatchStatsRecorder::StopRecording();
+
+  const std::vector<DispatchQueueStats> stats =
+      DispatchStatsRecorder::GetStats();
+  const DispatchQueueStats* queue = FindQueue(stats, "RecordsTaskQueueTasks");
+  ASSERT_TRUE(queue);
+  ASSERT_EQ(1u, queue->locations.size());
+  EXPECT_EQ(2, queue->locations[0].run_time_us.count());
+  EXPECT_EQ(2, queue->locations[0].queue_delay_us.count());
+}
+
+TEST(DispatchStatsRecorderTest, DoesNotRecordWhenOff) {
+  DispatchStatsRecorder::ResetStats();
+  {
+    TaskQueue queue("DoesNotRecordWhenOff");
+    Event done(false, false);
+    queue.PostTask([&done] { done.Set(); });
+    EXPECT_TRUE(done.Wait(Event::kForever));
+  }
+  EXPECT_FALSE(
+      FindQueue(DispatchStatsRecorder::GetStats(), "DoesNotRecordWhenOff"));
+}
+
+}  // namespace rtc
@@ -21,6 +21,7 @@
 #endif
 
 #include "rtc_base/checks.h"
+#include "rtc_base/virtual_time.h"
 
 namespace rtc {
 
@@ -39,13 +40,21 @@ Event::~Event() {
 
 void Event::Set() {
   SetEvent(event_handle_);
+  if (VirtualTimeController* virtual_time = VirtualTimeController::Get())
+    virtual_time->OnEventSet();
 }
 
 void Event::Reset() {
   ResetEvent(event_handle_);
 }
 
+bool Event::TryConsume() {
+  return WaitForSingleObject(event_handle_, 0) == WAIT_OBJECT_0;
+}
+
 bool Event::Wait(int milliseconds) {
+  if (VirtualTimeController* virtual_time = VirtualTimeController::Get())
+    return virtual_time->Wait(this, milliseconds);
   DWORD ms = (milliseconds == kForever) ? INFINITE : milliseconds;
   return (WaitForSingleObject(event_handle_, ms) == WAIT_OBJECT_0);
 }
@@ -91,6 +100,8 @@ void Event::Set() {
   event_status_ = true;
   pthread_cond_broadcast(&event_cond_);
   pthread_mutex_unlock(&event_mutex_);
+  if (VirtualTimeController* virtual_time = VirtualTimeController::Get())
+    virtual_time->OnEventSet();
 }
 
 void Event::Reset() {
@@ -99,7 +110,19 @@ void Event::Reset() {
   pthread_mutex_unlock(&event_mutex_);
 }
 
+bool Event::TryConsume() {
+  pthread_mutex_lock(&event_mutex_);
+  bool signaled = event_status_;
+  if (!is_manual_reset_)
+    event_status_ = false;
+  pthread_mutex_unlock(&event_mutex_);
+  return signaled;
+}
+
 bool Event::Wait(int milliseconds) {
+  if (VirtualTimeController* virtual_time = VirtualTimeController::Get())
+    return virtual_time->Wait(this, milliseconds);
+
   int error = 0;
 
   struct timespec ts;
@@ -37,6 +37,12 @@ class Event {
   bool Wait(int milliseconds);
 
  private:
+  friend class VirtualTimeController;
+
+  // Returns whether the event is signaled, and resets it if it isn't a
+  // manual reset event, without waiting.
+  bool TryConsume();
+
 #if defined(WEBRTC_WIN)
   HANDLE event_handle_;
 #elif defined(WEBRTC_POSIX)
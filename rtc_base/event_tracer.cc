@@ -10,7 +10,13 @@
 #include "rtc_base/event_tracer.h"
 
 #include <inttypes.h>
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -79,6 +85,228 @@ static void EventTracingThreadFunc(void* params);
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
 
+static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
+
+// TRACE_EVENT call sites cache the pointer returned by GetCategoryEnabled() in
+// a static, so every category gets an enabled flag at a fixed address. The
+// flag is only set while a capture which selects the category is running,
+// which makes a disabled call site cost a single load.
+struct Category {
+  // Must be the first member, since the category enabled pointers handed out
+  // point to it.
+  unsigned char enabled;
+  const char* name;
+};
+
+static const size_t kMaxCategories = 128;
+static const unsigned char kCategoryDisabled = 0;
+
+struct TraceArg {
+  const char* name;
+  unsigned char type;
+  // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
+  union TraceArgValue {
+    bool as_bool;
+    unsigned long long as_uint;
+    long long as_int;
+    double as_double;
+    const void* as_pointer;
+    const char* as_string;
+  } value;
+
+  // Assert that the size of the union is equal to the size of the as_uint
+  // field since we are assigning to arbitrary types using it.
+  static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
+                "Size of TraceArg value union is not equal to the size of "
+                "the uint field of that union.");
+};
+
+// The trace_event.h macros take at most two arguments.
+static const int kMaxTraceArgs = 2;
+
+struct TraceEvent {
+  const char* name;
+  const char* category;
+  char phase;
+  int num_args;
+  TraceArg args[kMaxTraceArgs];
+  uint64_t timestamp;
+  int pid;
+  rtc::PlatformThreadId tid;
+};
+
+void DeleteCopiedStrings(TraceEvent* event) {
+  for (int i = 0; i < event->num_args; ++i) {
+    TraceArg& arg = event->args[i];
+    if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+      delete[] arg.value.as_string;
+      arg.value.as_string = nullptr;
+    }
+  }
+}
+
+// Holds the events of one thread until the logging thread writes them. Only
+// the owning thread pushes and only the logging thread pops, so the ring
+// needs no lock.
+class ThreadEventBuffer {
+ public:
+  enum State { kInUse, kAbandoned, kFree };
+
+  // Returns false, without taking |event|, if the buffer is full.
+  bool Push(const TraceEvent& event) {
+    const size_t write_index = write_index_.load(std::memory_order_relaxed);
+    if (write_index - read_index_.load(std::memory_order_acquire) ==
+        kCapacity) {
+      return false;
+    }
+    events_[write_index % kCapacity] = event;
+    write_index_.store(write_index + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves all events pushed so far to |events|.
+  void PopAll(std::vector<TraceEvent>* events) {
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    const size_t write_index = write_index_.load(std::memory_order_acquire);
+    for (size_t i = read_index; i != write_index; ++i) {
+      events->push_back(events_[i % kCapacity]);
+    }
+    read_index_.store(write_index, std::memory_order_release);
+  }
+
+  // kAbandoned once the owning thread has exited, and kFree once the logging
+  // thread has written the remaining events, so that the buffer can be handed
+  // to a new thread.
+  std::atomic<int> state{kInUse};
+
+ private:
+  static const size_t kCapacity = 2048;
+  TraceEvent events_[kCapacity];
+  std::atomic<size_t> write_index_{0};
+  std::atomic<size_t> read_index_{0};
+};
+
+struct TracerState {
+  rtc::CriticalSection crit;
+  Category categories[kMaxCategories] RTC_GUARDED_BY(crit);
+  size_t num_categories RTC_GUARDED_BY(crit) = 0;
+  std::string category_filter RTC_GUARDED_BY(crit);
+  bool capturing RTC_GUARDED_BY(crit) = false;
+  std::vector<std::unique_ptr<ThreadEventBuffer>> thread_buffers
+      RTC_GUARDED_BY(crit);
+  // Used where a thread's buffer can't be released when it exits. Pushes to
+  // it are serialized by |crit|.
+  ThreadEventBuffer shared_buffer;
+  std::atomic<int> dropped_events{0};
+};
+
+TracerState* GetTracerState() {
+  // Leaked, since threads may still trace during static destruction.
+  static TracerState* const state = new TracerState();
+  return state;
+}
+
+// Returns whether the comma-separated |filter| selects |name|. The empty
+// filter selects all but the disabled-by-default categories.
+bool IsCategorySelected(const std::string& filter, const char* name) {
+  if (filter.empty()) {
+    return strncmp(name, kDisabledTracePrefix, strlen(kDisabledTracePrefix)) !=
+           0;
+  }
+  size_t begin = 0;
+  while (begin <= filter.size()) {
+    size_t end = filter.find(',', begin);
+    if (end == std::string::npos)
+      end = filter.size();
+    if (filter.compare(begin, end - begin, name) == 0)
+      return true;
+    begin = end + 1;
+  }
+  return false;
+}
+
+void UpdateCategoriesEnabled(TracerState* state)
+    RTC_EXCLUSIVE_LOCKS_REQUIRED(state->crit) {
+  for (size_t i = 0; i < state->num_categories; ++i) {
+    Category& category = state->categories[i];
+    category.enabled =
+        state->capturing &&
+        IsCategorySelected(state->category_filter, category.name);
+  }
+}
+
+#if defined(WEBRTC_POSIX)
+void AbandonThreadBuffer(void* value) {
+  static_cast<ThreadEventBuffer*>(value)->state.store(
+      ThreadEventBuffer::kAbandoned, std::memory_order_release);
+}
+
+pthread_key_t GetThreadBufferKey() {
+  static const pthread_key_t key = [] {
+    pthread_key_t key;
+    pthread_key_create(&key, &AbandonThreadBuffer);
+    return key;
+  }();
+  return key;
+}
+
+ThreadEventBuffer* GetThreadBuffer() {
+  pthread_key_t key = GetThreadBufferKey();
+  ThreadEventBuffer* buffer =
+      static_cast<ThreadEventBuffer*>(pthread_getspecific(key));
+  if (!buffer) {
+    TracerState* state = GetTracerState();
+    rtc::CritScope lock(&state->crit);
+    for (const auto& thread_buffer : state->thread_buffers) {
+      if (thread_buffer->state.load(std::memory_order_relaxed) ==
+          ThreadEventBuffer::kFree) {
+        buffer = thread_buffer.get();
+        break;
+      }
+    }
+    if (!buffer) {
+      state->thread_buffers.emplace_back(new ThreadEventBuffer());
+      buffer = state->thread_buffers.back().get();
+    }
+    buffer->state.store(ThreadEventBuffer::kInUse, std::memory_order_relaxed);
+    pthread_setspecific(key, buffer);
+  }
+  return buffer;
+}
+#else
+// There is no portable way to release a thread's buffer when it exits, so
+// only the shared buffer is used.
+ThreadEventBuffer* GetThreadBuffer() {
+  return nullptr;
+}
+#endif
+
+// Moves the events of all threads to |events|, sorted by time.
+void CollectEvents(std::vector<TraceEvent>* events) {
+  TracerState* state = GetTracerState();
+  std::vector<ThreadEventBuffer*> buffers;
+  {
+    rtc::CritScope lock(&state->crit);
+    for (const auto& thread_buffer : state->thread_buffers)
+      buffers.push_back(thread_buffer.get());
+  }
+  for (ThreadEventBuffer* buffer : buffers) {
+    const int buffer_state = buffer->state.load(std::memory_order_acquire);
+    if (buffer_state == ThreadEventBuffer::kFree)
+      continue;
+    buffer->PopAll(events);
+    if (buffer_state == ThreadEventBuffer::kAbandoned) {
+      rtc::CritScope lock(&state->crit);
+      buffer->state.store(ThreadEventBuffer::kFree, std::memory_order_relaxed);
+    }
+  }
+  state->shared_buffer.PopAll(events);
+  std::stable_sort(events->begin(), events->end(),
+                   [](const TraceEvent& a, const TraceEvent& b) {
+                     return a.timestamp < b.timestamp;
+                   });
+}
+
 // TODO(pbos): Log metadata for all threads, etc.
 class EventLogger final {
  public:
@@ -90,37 +318,6 @@ class EventLogger final {
         shutdown_event_(false, false) {}
   ~EventLogger() { RTC_DCHECK(thread_checker_.CalledOnValidThread()); }
 
-  void AddTraceEvent(const char* name,
-                     const unsigned char* category_enabled,
-                     char phase,
-                     int num_args,
-                     const char** arg_names,
-                     const unsigned char* arg_types,
-                     const unsigned long long* arg_values,
-                     uint64_t timestamp,
-                     int pid,
-                     rtc::PlatformThreadId thread_id) {
-    std::vector<TraceArg> args(num_args);
-    for (int i = 0; i < num_args; ++i) {
-      TraceArg& arg = args[i];
-      arg.name = arg_names[i];
-      arg.type = arg_types[i];
-      arg.value.as_uint = arg_values[i];
-
-      // Value is a pointer to a temporary string, so we have to make a copy.
-      if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-        // Space for the string and for the terminating null character.
-        size_t str_length = strlen(arg.value.as_string) + 1;
-        char* str_copy = new char[str_length];
-        memcpy(str_copy, arg.value.as_string, str_length);
-        arg.value.as_string = str_copy;
-      }
-    }
-    rtc::CritScope lock(&crit_);
-    trace_events_.push_back(
-        {name, category_enabled, phase, args, timestamp, 1, thread_id});
-  }
-
   // The TraceEvent format is documented here:
   // https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
   void Log() {
@@ -128,36 +325,27 @@ class EventLogger final {
     static const int kLoggingIntervalMs = 100;
     fprintf(output_file_, "{ \"traceEvents\": [\n");
     bool has_logged_event = false;
+    std::vector<TraceEvent> events;
     while (true) {
       bool shutting_down = shutdown_event_.Wait(kLoggingIntervalMs);
-      std::vector<TraceEvent> events;
-      {
-        rtc::CritScope lock(&crit_);
-        trace_events_.swap(events);
-      }
+      events.clear();
+      CollectEvents(&events);
       std::string args_str;
       args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
       for (TraceEvent& e : events) {
         args_str.clear();
-        if (!e.args.empty()) {
+        if (e.num_args > 0) {
           args_str += ", \"args\": {";
-          bool is_first_argument = true;
-          for (TraceArg& arg : e.args) {
-            if (!is_first_argument)
+          for (int i = 0; i < e.num_args; ++i) {
+            if (i > 0)
               args_str += ",";
-            is_first_argument = false;
             args_str += " \"";
-            args_str += arg.name;
+            args_str += e.args[i].name;
             args_str += "\": ";
-            args_str += TraceArgValueAsString(arg);
-
-            // Delete our copy of the string.
-            if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-              delete[] arg.value.as_string;
-              arg.value.as_string = nullptr;
-            }
+            args_str += TraceArgValueAsString(e.args[i]);
           }
           args_str += " }";
+          DeleteCopiedStrings(&e);
         }
         fprintf(output_file_,
                 "%s{ \"name\": \"%s\""
@@ -172,8 +360,8 @@ class EventLogger final {
 #endif  // defined(WEBRTC_WIN)
                 "%s"
                 "}\n",
-                has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid, args_str.c_str());
+                has_logged_event ? "," : " ", e.name, e.category, e.phase,
+                e.timestamp, e.pid, e.tid, args_str.c_str());
         has_logged_event = true;
       }
       if (shutting_down)
@@ -191,13 +379,20 @@ class EventLogger final {
     RTC_DCHECK(!output_file_);
     output_file_ = file;
     output_file_owned_ = owned;
+    // Since the atomic fast-path for adding events can be bypassed while the
+    // logging thread is shutting down there may be some stale events in the
+    // buffers, hence they need to be dropped to not log events from a previous
+    // logging session (which may be days old).
+    std::vector<TraceEvent> stale_events;
+    CollectEvents(&stale_events);
+    for (TraceEvent& e : stale_events)
+      DeleteCopiedStrings(&e);
+    TracerState* state = GetTracerState();
+    state->dropped_events.store(0, std::memory_order_relaxed);
     {
-      rtc::CritScope lock(&crit_);
-      // Since the atomic fast-path for adding events to the queue can be
-      // bypassed while the logging thread is shutting down there may be some
-      // stale events in the queue, hence the vector needs to be cleared to not
-      // log events from a previous logging session (which may be days old).
-      trace_events_.clear();
+      rtc::CritScope lock(&state->crit);
+      state->capturing = true;
+      UpdateCategoriesEnabled(state);
     }
     // Enable event logging (fast-path). This should be disabled since starting
     // shouldn't be done twice.
@@ -215,44 +410,27 @@ class EventLogger final {
     // Try to stop. Abort if we're not currently logging.
     if (rtc::AtomicOps::CompareAndSwap(&g_event_logging_active, 1, 0) == 0)
       return;
+    TracerState* state = GetTracerState();
+    {
+      rtc::CritScope lock(&state->crit);
+      state->capturing = false;
+      UpdateCategoriesEnabled(state);
+    }
 
     // Wake up logging thread to finish writing.
     shutdown_event_.Set();
     // Join the logging thread.
     logging_thread_.Stop();
+
+    const int dropped_events = state->dropped_events.load();
+    if (dropped_events > 0) {
+      RTC_LOG(LS_WARNING) << "Dropped " << dropped_events
+                          << " trace events because a thread's buffer was "
+                          << "full.";
+    }
   }
 
  private:
-  struct TraceArg {
-    const char* name;
-    unsigned char type;
-    // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
-    union TraceArgValue {
-      bool as_bool;
-      unsigned long long as_uint;
-      long long as_int;
-      double as_double;
-      const void* as_pointer;
-      const char* as_string;
-    } value;
-
-    // Assert that the size of the union is equal to the size of the as_uint
-    // field since we are assigning to arbitrary types using it.
-    static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
-                  "Size of TraceArg value union is not equal to the size of "
-                  "the uint field of that union.");
-  };
-
-  struct TraceEvent {
-    const char* name;
-    const unsigned char* category_enabled;
-    char phase;
-    std::vector<TraceArg> args;
-    uint64_t timestamp;
-    int pid;
-    rtc::PlatformThreadId tid;
-  };
-
   static std::string TraceArgValueAsString(TraceArg arg) {
     std::string output;
 
@@ -313,8 +491,6 @@ class EventLogger final {
     return output;
   }
 
-  rtc::CriticalSection crit_;
-  std::vector<TraceEvent> trace_events_ RTC_GUARDED_BY(crit_);
   rtc::PlatformThread logging_thread_;
   rtc::Event shutdown_event_;
   rtc::ThreadChecker thread_checker_;
@@ -327,17 +503,24 @@ static void EventTracingThreadFunc(void* params) {
 }
 
 static EventLogger* volatile g_event_logger = nullptr;
-static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
+
 const unsigned char* InternalGetCategoryEnabled(const char* name) {
-  const char* prefix_ptr = &kDisabledTracePrefix[0];
-  const char* name_ptr = name;
-  // Check whether name contains the default-disabled prefix.
-  while (*prefix_ptr == *name_ptr && *prefix_ptr != '\0') {
-    ++prefix_ptr;
-    ++name_ptr;
+  TracerState* state = GetTracerState();
+  rtc::CritScope lock(&state->crit);
+  for (size_t i = 0; i < state->num_categories; ++i) {
+    if (strcmp(state->categories[i].name, name) == 0)
+      return &state->categories[i].enabled;
+  }
+  if (state->num_categories == kMaxCategories) {
+    RTC_LOG(LS_WARNING) << "Too many trace categories, not tracing " << name
+                        << ".";
+    return &kCategoryDisabled;
   }
-  return reinterpret_cast<const unsigned char*>(*prefix_ptr == '\0' ? ""
-                                                                    : name);
+  Category& category = state->categories[state->num_categories++];
+  category.name = name;
+  category.enabled =
+      state->capturing && IsCategorySelected(state->category_filter, name);
+  return &category.enabled;
 }
 
 void InternalAddTraceEvent(char phase,
@@ -353,9 +536,44 @@ void InternalAddTraceEvent(char phase,
   if (rtc::AtomicOps::AcquireLoad(&g_event_logging_active) == 0)
     return;
 
-  g_event_logger->AddTraceEvent(name, category_enabled, phase, num_args,
-                                arg_names, arg_types, arg_values,
-                                rtc::TimeMicros(), 1, rtc::CurrentThreadId());
+  RTC_DCHECK_LE(num_args, kMaxTraceArgs);
+  TraceEvent event;
+  event.name = name;
+  event.category = reinterpret_cast<const Category*>(category_enabled)->name;
+  event.phase = phase;
+  event.num_args = std::min(num_args, kMaxTraceArgs);
+  event.timestamp = rtc::TimeMicros();
+  event.pid = 1;
+  event.tid = rtc::CurrentThreadId();
+  for (int i = 0; i < event.num_args; ++i) {
+    TraceArg& arg = event.args[i];
+    arg.name = arg_names[i];
+    arg.type = arg_types[i];
+    arg.value.as_uint = arg_values[i];
+
+    // Value is a pointer to a temporary string, so we have to make a copy.
+    if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+      // Space for the string and for the terminating null character.
+      size_t str_length = strlen(arg.value.as_string) + 1;
+      char* str_copy = new char[str_length];
+      memcpy(str_copy, arg.value.as_string, str_length);
+      arg.value.as_string = str_copy;
+    }
+  }
+
+  TracerState* state = GetTracerState();
+  ThreadEventBuffer* buffer = GetThreadBuffer();
+  bool pushed;
+  if (buffer) {
+    pushed = buffer->Push(event);
+  } else {
+    rtc::CritScope lock(&state->crit);
+    pushed = state->shared_buffer.Push(event);
+  }
+  if (!pushed) {
+    DeleteCopiedStrings(&event);
+    state->dropped_events.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 }  // namespace
@@ -367,6 +585,13 @@ void SetupInternalTracer() {
   webrtc::SetupEventTracer(InternalGetCategoryEnabled, InternalAddTraceEvent);
 }
 
+void SetInternalCaptureCategories(const char* categories) {
+  TracerState* state = GetTracerState();
+  rtc::CritScope lock(&state->crit);
+  state->category_filter = categories ? categories : "";
+  UpdateCategoriesEnabled(state);
+}
+
 void StartInternalCaptureToFile(FILE* file) {
   if (g_event_logger) {
     g_event_logger->Start(file, false);
@@ -71,6 +71,10 @@ namespace rtc {
 namespace tracing {
 // Set up internal event tracer.
 void SetupInternalTracer();
+// Selects the categories recorded by the internal capture, as a
+// comma-separated list of category names. The default, the empty list,
+// records all categories except the TRACE_DISABLED_BY_DEFAULT() ones.
+void SetInternalCaptureCategories(const char* categories);
 bool StartInternalCapture(const char* filename);
 void StartInternalCaptureToFile(FILE* file);
 void StopInternalCapture();
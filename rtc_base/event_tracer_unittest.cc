@@ -10,6 +10,14 @@
 
 #include "rtc_base/event_tracer.h"
 
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/trace_event.h"
 #include "test/gtest.h"
 
@@ -52,6 +60,34 @@ static void AddTraceEventHandler(char phase,
   TestStatistics::Get()->Increment();
 }
 
+// Returns what has been written to |file|.
+std::string ReadFile(FILE* file) {
+  std::string contents;
+  rewind(file);
+  char buffer[1024];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, read);
+  return contents;
+}
+
+size_t CountOccurrences(const std::string& haystack,
+                        const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+const int kEventsPerThread = 100;
+
+void TraceFromThread(void* /* param */) {
+  for (int i = 0; i < kEventsPerThread; ++i)
+    TRACE_EVENT_INSTANT1("test", "TraceFromThread", "i", i);
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -69,4 +105,66 @@ TEST(EventTracerTest, ScopedTraceEvent) {
   TestStatistics::Get()->Reset();
 }
 
+TEST(EventTracerTest, InternalCaptureFromMultipleThreads) {
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file);
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalCaptureToFile(file);
+  const size_t kNumThreads = 4;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.push_back(absl::make_unique<rtc::PlatformThread>(
+        &TraceFromThread, nullptr, "TraceFromThread"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  rtc::tracing::StopInternalCapture();
+  rtc::tracing::ShutdownInternalTracer();
+
+  const std::string trace = ReadFile(file);
+  fclose(file);
+  EXPECT_EQ(kNumThreads * kEventsPerThread,
+            CountOccurrences(trace, "\"name\": \"TraceFromThread\""));
+  EXPECT_EQ(kNumThreads, CountOccurrences(trace, "\"i\": 99"));
+  EXPECT_NE(std::string::npos, trace.find("\"cat\": \"test\""));
+}
+
+TEST(EventTracerTest, InternalCaptureRecordsSelectedCategories) {
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file);
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::SetInternalCaptureCategories("selected");
+  rtc::tracing::StartInternalCaptureToFile(file);
+  TRACE_EVENT_INSTANT0("selected", "SelectedEvent");
+  TRACE_EVENT_INSTANT0("unselected", "UnselectedEvent");
+  rtc::tracing::StopInternalCapture();
+  // Events after the capture has stopped are not recorded.
+  TRACE_EVENT_INSTANT0("selected", "EventAfterStop");
+  rtc::tracing::SetInternalCaptureCategories("");
+  rtc::tracing::ShutdownInternalTracer();
+
+  const std::string trace = ReadFile(file);
+  fclose(file);
+  EXPECT_NE(std::string::npos, trace.find("SelectedEvent"));
+  EXPECT_EQ(std::string::npos, trace.find("UnselectedEvent"));
+  EXPECT_EQ(std::string::npos, trace.find("EventAfterStop"));
+}
+
+TEST(EventTracerTest, InternalCaptureSkipsDisabledByDefaultCategories) {
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file);
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalCaptureToFile(file);
+  TRACE_EVENT_INSTANT0(TRACE_DISABLED_BY_DEFAULT("test"), "DisabledEvent");
+  TRACE_EVENT_INSTANT0("test", "EnabledEvent");
+  rtc::tracing::StopInternalCapture();
+  rtc::tracing::ShutdownInternalTracer();
+
+  const std::string trace = ReadFile(file);
+  fclose(file);
+  EXPECT_EQ(std::string::npos, trace.find("DisabledEvent"));
+  EXPECT_NE(std::string::npos, trace.find("EnabledEvent"));
+}
+
 }  // namespace webrtc
@@ -0,0 +1,424 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/iouringsocketserver.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+// The io_uring system calls have the same number on all architectures, but
+// are missing from older C library headers.
+#if !defined(__NR_io_uring_setup)
+#define __NR_io_uring_setup 425
+#endif
+#if !defined(__NR_io_uring_enter)
+#define __NR_io_uring_enter 426
+#endif
+#if !defined(POLLRDHUP)
+#define POLLRDHUP 0x2000
+#endif
+
+namespace rtc {
+
+namespace {
+
+// Number of submission queue entries. The completion queue gets twice as many.
+const unsigned kRingEntries = 1024;
+
+// Tokens of requests that are not poll requests for a dispatcher. Dispatcher
+// tokens count up from 1 and never get near these.
+const uint64_t kIgnoredToken = ~static_cast<uint64_t>(0);
+const uint64_t kWakeupToken = kIgnoredToken - 1;
+const uint64_t kTimeoutTokenFlag = static_cast<uint64_t>(1) << 62;
+
+int IoUringSetup(unsigned entries, struct io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd,
+                 unsigned to_submit,
+                 unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+}  // namespace
+
+std::unique_ptr<IoUringSocketServer> IoUringSocketServer::Create() {
+  std::unique_ptr<IoUringSocketServer> ss(new IoUringSocketServer());
+  if (!ss->Initialize())
+    return nullptr;
+  return ss;
+}
+
+IoUringSocketServer::IoUringSocketServer() {}
+
+IoUringSocketServer::~IoUringSocketServer() {
+  if (sqes_)
+    munmap(sqes_, sqes_size_);
+  if (cq_ring_ && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_)
+    munmap(sq_ring_, sq_ring_size_);
+  if (ring_fd_ >= 0)
+    close(ring_fd_);
+  if (wakeup_fd_ >= 0)
+    close(wakeup_fd_);
+}
+
+bool IoUringSocketServer::Initialize() {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = IoUringSetup(kRingEntries, &params);
+  if (ring_fd_ < 0) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "io_uring_setup";
+    return false;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    RTC_LOG_E(LS_ERROR, EN, errno) << "mmap IORING_OFF_SQ_RING";
+    return false;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      cq_ring_ = nullptr;
+      RTC_LOG_E(LS_ERROR, EN, errno) << "mmap IORING_OFF_CQ_RING";
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    RTC_LOG_E(LS_ERROR, EN, errno) << "mmap IORING_OFF_SQES";
+    return false;
+  }
+  sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+  char* sq = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  char* cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeup_fd_ < 0) {
+    RTC_LOG_E(LS_ERROR, EN, errno) << "eventfd";
+    return false;
+  }
+  return true;
+}
+
+uint32_t IoUringSocketServer::GetPollMask(uint32_t requested_events) {
+  uint32_t mask = 0;
+  if (requested_events & (DE_READ | DE_ACCEPT))
+    mask |= POLLIN;
+  if (requested_events & (DE_WRITE | DE_CONNECT))
+    mask |= POLLOUT;
+  return mask;
+}
+
+struct io_uring_sqe* IoUringSocketServer::GetSqe() {
+  unsigned tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    // The submission queue is full; hand what we have to the kernel.
+    Submit(0, 0);
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+      RTC_LOG(LS_ERROR) << "io_uring submission queue is full";
+      return nullptr;
+    }
+  }
+  unsigned index = tail & sq_mask_;
+  struct io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+int IoUringSocketServer::Submit(unsigned min_complete, unsigned flags) {
+  unsigned to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (to_submit == 0 && min_complete == 0)
+    return 0;
+  int ret = IoUringEnter(ring_fd_, to_submit, min_complete, flags);
+  if (ret < 0 && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+    RTC_LOG_E(LS_ERROR, EN, errno) << "io_uring_enter";
+  return ret;
+}
+
+void IoUringSocketServer::QueuePoll(uint64_t token,
+                                    int fd,
+                                    uint32_t poll_mask) {
+  struct io_uring_sqe* sqe = GetSqe();
+  if (!sqe)
+    return;
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll_events = static_cast<uint16_t>(poll_mask | POLLRDHUP);
+  sqe->user_data = token;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+}
+
+void IoUringSocketServer::QueuePollRemove(uint64_t token) {
+  struct io_uring_sqe* sqe = GetSqe();
+  if (!sqe)
+    return;
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = token;
+  sqe->user_data = kIgnoredToken;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+}
+
+void IoUringSocketServer::QueueTimeout(int64_t timeout_ms) {
+  struct io_uring_sqe* sqe = GetSqe();
+  if (!sqe)
+    return;
+  timeout_spec_.tv_sec = timeout_ms / kNumMillisecsPerSec;
+  timeout_spec_.tv_nsec =
+      (timeout_ms % kNumMillisecsPerSec) * kNumNanosecsPerMillisec;
+  timeout_token_ = kTimeoutTokenFlag | next_token_++;
+  sqe->opcode = IORING_OP_TIMEOUT;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(&timeout_spec_);
+  sqe->len = 1;
+  sqe->user_data = timeout_token_;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  timeout_armed_ = true;
+}
+
+void IoUringSocketServer::QueueTimeoutRemove() {
+  struct io_uring_sqe* sqe = GetSqe();
+  if (!sqe)
+    return;
+  sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = timeout_token_;
+  sqe->user_data = kIgnoredToken;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  timeout_armed_ = false;
+}
+
+void IoUringSocketServer::ArmWakeup() {
+  if (wakeup_armed_)
+    return;
+  QueuePoll(kWakeupToken, wakeup_fd_, POLLIN);
+  wakeup_armed_ = true;
+}
+
+void IoUringSocketServer::MaybeSubmitNow() {
+  if (in_kernel_wait_)
+    Submit(0, 0);
+}
+
+void IoUringSocketServer::WakeUp() {
+  uint64_t value = 1;
+  ssize_t res = write(wakeup_fd_, &value, sizeof(value));
+  RTC_DCHECK_EQ(res, sizeof(value));
+}
+
+void IoUringSocketServer::DrainWakeup() {
+  uint64_t value;
+  while (read(wakeup_fd_, &value, sizeof(value)) == sizeof(value)) {
+  }
+}
+
+void IoUringSocketServer::Add(Dispatcher* dispatcher) {
+  CritScope cs(&crit_);
+  uint64_t& token = tokens_[dispatcher];
+  RTC_DCHECK_EQ(token, 0);
+  int fd = dispatcher->GetDescriptor();
+  uint32_t mask = GetPollMask(dispatcher->GetRequestedEvents());
+  if (fd == INVALID_SOCKET || mask == 0)
+    return;
+  token = next_token_++;
+  registrations_[token] = Registration{dispatcher, fd, mask};
+  QueuePoll(token, fd, mask);
+  MaybeSubmitNow();
+}
+
+void IoUringSocketServer::Remove(Dispatcher* dispatcher) {
+  CritScope cs(&crit_);
+  auto it = tokens_.find(dispatcher);
+  if (it == tokens_.end()) {
+    RTC_LOG(LS_WARNING) << "IoUringSocketServer asked to remove a unknown "
+                        << "dispatcher, potentially from a duplicate call to "
+                        << "Add.";
+    return;
+  }
+  if (it->second != 0) {
+    registrations_.erase(it->second);
+    QueuePollRemove(it->second);
+    MaybeSubmitNow();
+  }
+  tokens_.erase(it);
+}
+
+void IoUringSocketServer::Update(Dispatcher* dispatcher) {
+  CritScope cs(&crit_);
+  auto it = tokens_.find(dispatcher);
+  if (it == tokens_.end())
+    return;
+  int fd = dispatcher->GetDescriptor();
+  uint32_t mask = GetPollMask(dispatcher->GetRequestedEvents());
+  if (it->second != 0) {
+    const Registration& registration = registrations_[it->second];
+    if (registration.fd == fd && registration.poll_mask == mask)
+      return;
+    registrations_.erase(it->second);
+    QueuePollRemove(it->second);
+    it->second = 0;
+  }
+  if (fd != INVALID_SOCKET && mask != 0) {
+    it->second = next_token_++;
+    registrations_[it->second] = Registration{dispatcher, fd, mask};
+    QueuePoll(it->second, fd, mask);
+  }
+  MaybeSubmitNow();
+}
+
+bool IoUringSocketServer::ReapCompletions() {
+  bool timed_out = false;
+  unsigned head = *cq_head_;
+  while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+    uint64_t token = cqe.user_data;
+    int res = cqe.res;
+    // Release the slot before delivering events, which may queue new work.
+    ++head;
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+    if (token == kIgnoredToken)
+      continue;
+    if (token == kWakeupToken) {
+      wakeup_armed_ = false;
+      DrainWakeup();
+      wait_ = false;
+      continue;
+    }
+    if (token & kTimeoutTokenFlag) {
+      if (timeout_armed_ && token == timeout_token_) {
+        timeout_armed_ = false;
+        timed_out = true;
+      }
+      continue;
+    }
+
+    auto it = registrations_.find(token);
+    if (it == registrations_.end()) {
+      // Cancelled request or removed dispatcher.
+      continue;
+    }
+    Dispatcher* dispatcher = it->second.dispatcher;
+    registrations_.erase(it);
+    tokens_[dispatcher] = 0;
+    if (res < 0) {
+      RTC_LOG(LS_WARNING) << "io_uring poll failed with error " << -res;
+      continue;
+    }
+
+    bool readable = (res & (POLLIN | POLLPRI));
+    bool writable = (res & POLLOUT);
+    bool check_error = (res & (POLLRDHUP | POLLERR | POLLHUP));
+    ProcessEvents(dispatcher, readable, writable, check_error);
+
+    // Poll requests are one-shot; re-arm unless the dispatcher was removed or
+    // already re-armed by an Update() from its event handler.
+    auto token_it = tokens_.find(dispatcher);
+    if (token_it != tokens_.end() && token_it->second == 0)
+      Update(dispatcher);
+  }
+  return timed_out;
+}
+
+bool IoUringSocketServer::WaitForWakeupOnly(int cms) {
+  struct pollfd fds = {0};
+  fds.fd = wakeup_fd_;
+  fds.events = POLLIN;
+  int res = poll(&fds, 1, cms == kForever ? -1 : cms);
+  if (res < 0 && errno != EINTR) {
+    RTC_LOG_E(LS_ERROR, EN, errno) << "poll";
+    return false;
+  }
+  if (res > 0)
+    DrainWakeup();
+  return true;
+}
+
+bool IoUringSocketServer::Wait(int cmsWait, bool process_io) {
+  if (!process_io)
+    return WaitForWakeupOnly(cmsWait);
+
+  int64_t stop = (cmsWait == kForever) ? -1 : TimeAfter(cmsWait);
+  crit_.Enter();
+  wait_ = true;
+  bool success = true;
+  while (wait_) {
+    ArmWakeup();
+    if (cmsWait != kForever && !timeout_armed_)
+      QueueTimeout(std::max<int64_t>(0, TimeDiff(stop, TimeMillis())));
+
+    unsigned to_submit =
+        *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    in_kernel_wait_ = true;
+    crit_.Leave();
+    int ret = IoUringEnter(ring_fd_, to_submit, 1, IORING_ENTER_GETEVENTS);
+    int error = errno;
+    crit_.Enter();
+    in_kernel_wait_ = false;
+    if (ret < 0 && error != EINTR && error != EBUSY && error != EAGAIN) {
+      RTC_LOG_E(LS_ERROR, EN, error) << "io_uring_enter";
+      success = false;
+      break;
+    }
+
+    if (ReapCompletions())
+      break;
+    if (cmsWait != kForever && TimeDiff(stop, TimeMillis()) <= 0)
+      break;
+  }
+  if (timeout_armed_)
+    QueueTimeoutRemove();
+  crit_.Leave();
+  return success;
+}
+
+}  // namespace rtc
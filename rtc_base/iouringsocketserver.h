@@ -0,0 +1,126 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_IOURINGSOCKETSERVER_H_
+#define RTC_BASE_IOURINGSOCKETSERVER_H_
+
+#include <linux/io_uring.h>
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/physicalsocketserver.h"
+
+namespace rtc {
+
+// A PhysicalSocketServer that waits for socket readiness with io_uring
+// instead of epoll. Every dispatcher has a one-shot poll request posted on the
+// ring, which is re-armed after its events have been delivered. Poll requests,
+// cancellations, the wakeup and the wait timeout are queued and submitted to
+// the kernel together, so a busy loop costs one system call per iteration
+// instead of one epoll_ctl() per interest change plus epoll_wait().
+//
+// The Dispatcher and AsyncSocket contracts are the same as for
+// PhysicalSocketServer, so the two are interchangeable:
+//
+//   std::unique_ptr<SocketServer> ss = IoUringSocketServer::Create();
+//   if (!ss)
+//     ss.reset(new PhysicalSocketServer());
+//   Thread thread(std::move(ss));
+//   thread.Start();
+class IoUringSocketServer : public PhysicalSocketServer {
+ public:
+  // Returns null if the kernel does not support io_uring (or it is blocked,
+  // e.g. by a seccomp policy).
+  static std::unique_ptr<IoUringSocketServer> Create();
+  ~IoUringSocketServer() override;
+
+  // SocketServer:
+  bool Wait(int cms, bool process_io) override;
+  void WakeUp() override;
+
+  // PhysicalSocketServer:
+  void Add(Dispatcher* dispatcher) override;
+  void Remove(Dispatcher* dispatcher) override;
+  void Update(Dispatcher* dispatcher) override;
+
+ private:
+  struct Registration {
+    Dispatcher* dispatcher;
+    int fd;
+    uint32_t poll_mask;
+  };
+
+  IoUringSocketServer();
+  bool Initialize();
+
+  // Ring helpers. All of them require |crit_| to be held.
+  struct io_uring_sqe* GetSqe();
+  int Submit(unsigned min_complete, unsigned flags);
+  void QueuePoll(uint64_t token, int fd, uint32_t poll_mask);
+  void QueuePollRemove(uint64_t token);
+  void QueueTimeout(int64_t timeout_ms);
+  void QueueTimeoutRemove();
+  void ArmWakeup();
+  // Submits the queued requests right away if the loop thread is blocked in
+  // the kernel, since it would otherwise only submit them when it wakes up.
+  void MaybeSubmitNow();
+  // Delivers all available completions. Returns true if the current wait
+  // timeout has fired.
+  bool ReapCompletions();
+  void DrainWakeup();
+  bool WaitForWakeupOnly(int cms);
+
+  static uint32_t GetPollMask(uint32_t requested_events);
+
+  CriticalSection crit_;
+  int ring_fd_ = -1;
+  int wakeup_fd_ = -1;
+
+  // Submission and completion queue mappings.
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  size_t cq_ring_size_ = 0;
+  struct io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  struct io_uring_cqe* cqes_ = nullptr;
+
+  // Number of queued but not yet submitted requests.
+  unsigned pending_submissions_ = 0;
+  // True while the loop thread is blocked in io_uring_enter().
+  bool in_kernel_wait_ = false;
+  bool wakeup_armed_ = false;
+  bool wait_ = false;
+  // The wait timeout currently posted on the ring, if any.
+  bool timeout_armed_ = false;
+  uint64_t timeout_token_ = 0;
+  struct __kernel_timespec timeout_spec_;
+
+  // Each poll request is tagged with a unique token, so that completions of
+  // cancelled requests or removed dispatchers can be told apart.
+  uint64_t next_token_ = 1;
+  std::unordered_map<uint64_t, Registration> registrations_;
+  std::map<Dispatcher*, uint64_t> tokens_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_IOURINGSOCKETSERVER_H_
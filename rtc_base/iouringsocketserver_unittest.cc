@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/iouringsocketserver.h"
+
+#include <memory>
+
+#include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/socket_unittest.h"
+#include "rtc_base/testutils.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+
+// io_uring may be unavailable on the bot's kernel or blocked by seccomp.
+#define MAYBE_SKIP_NO_IO_URING                        \
+  if (!server_) {                                     \
+    RTC_LOG(LS_INFO) << "No io_uring... skipping";    \
+    return;                                           \
+  }
+
+class IoUringSocketServerTest : public SocketTest {
+ protected:
+  IoUringSocketServerTest() : server_(IoUringSocketServer::Create()) {
+    if (server_)
+      thread_.reset(new AutoSocketServerThread(server_.get()));
+  }
+
+  std::unique_ptr<IoUringSocketServer> server_;
+  std::unique_ptr<AutoSocketServerThread> thread_;
+};
+
+TEST_F(IoUringSocketServerTest, TestConnectIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestConnectIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestConnectFailIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestConnectFailIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestServerCloseIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestServerCloseIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestCloseInClosedCallbackIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestCloseInClosedCallbackIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestSocketServerWaitIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestSocketServerWaitIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestTcpIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestTcpIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestUdpIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestUdpIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestUdpReadyToSendIPv4) {
+  MAYBE_SKIP_NO_IO_URING;
+  SocketTest::TestUdpReadyToSendIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, WaitTimesOut) {
+  MAYBE_SKIP_NO_IO_URING;
+  int64_t start = TimeMillis();
+  EXPECT_TRUE(server_->Wait(50, true));
+  EXPECT_GE(TimeMillis() - start, 50);
+}
+
+TEST_F(IoUringSocketServerTest, WakeUpInterruptsWait) {
+  MAYBE_SKIP_NO_IO_URING;
+  server_->WakeUp();
+  int64_t start = TimeMillis();
+  EXPECT_TRUE(server_->Wait(SocketServer::kForever, true));
+  EXPECT_LT(TimeMillis() - start, 1000);
+}
+
+}  // namespace rtc
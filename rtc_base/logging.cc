@@ -29,14 +29,23 @@ static const int kMaxLogLineSize = 1024 - 60;
 #include <limits.h>
 #include <time.h>
 
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <algorithm>
+#include <atomic>
 #include <cstdarg>
 #include <iomanip>
+#include <memory>
 #include <ostream>
 #include <vector>
 
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/platform_thread_types.h"
 #include "rtc_base/stringencode.h"
 #include "rtc_base/strings/string_builder.h"
@@ -76,8 +85,221 @@ std::ostream& GetNoopStream() {
 
 // Global lock for log subsystem, only needed to serialize access to streams_.
 CriticalSection g_log_crit;
+
+// Mirrors |streams_.empty()|, so that IsNoop() doesn't need to take the lock.
+std::atomic<bool> g_no_streams(true);
+
+struct QueuedLogMessage {
+  std::string str;
+  LoggingSeverity severity;
+  const char* tag;
+};
+
+// Holds the messages of one thread until the async log writer writes them.
+// Only the owning thread pushes and only the writer pops, so the ring needs no
+// lock.
+class LogMessageQueue {
+ public:
+  enum State { kInUse, kAbandoned, kFree };
+
+  // Returns false, leaving |message| untouched, if the queue is full.
+  bool Push(QueuedLogMessage* message) {
+    const size_t write_index = write_index_.load(std::memory_order_relaxed);
+    if (write_index - read_index_.load(std::memory_order_acquire) ==
+        kCapacity) {
+      return false;
+    }
+    QueuedLogMessage& slot = messages_[write_index % kCapacity];
+    slot.str.swap(message->str);
+    slot.severity = message->severity;
+    slot.tag = message->tag;
+    write_index_.store(write_index + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves all messages pushed so far to |messages|.
+  void PopAll(std::vector<QueuedLogMessage>* messages) {
+    const size_t read_index = read_index_.load(std::memory_order_relaxed);
+    const size_t write_index = write_index_.load(std::memory_order_acquire);
+    for (size_t i = read_index; i != write_index; ++i) {
+      QueuedLogMessage& slot = messages_[i % kCapacity];
+      messages->push_back({std::string(), slot.severity, slot.tag});
+      messages->back().str.swap(slot.str);
+    }
+    read_index_.store(write_index, std::memory_order_release);
+  }
+
+  // kAbandoned once the owning thread has exited, and kFree once the writer
+  // has written the remaining messages, so that the queue can be handed to a
+  // new thread.
+  std::atomic<int> state{kInUse};
+
+ private:
+  static const size_t kCapacity = 1024;
+  QueuedLogMessage messages_[kCapacity];
+  std::atomic<size_t> write_index_{0};
+  std::atomic<size_t> read_index_{0};
+};
+
+struct AsyncLogState {
+  CriticalSection crit;
+  std::vector<std::unique_ptr<LogMessageQueue>> queues RTC_GUARDED_BY(crit);
+  // Used where a thread's queue can't be released when it exits. Pushes to it
+  // are serialized by |crit|.
+  LogMessageQueue shared_queue;
+  std::unique_ptr<PlatformThread> writer_thread;
+  Event wake_up{false, false};
+  std::atomic<bool> stopping{false};
+  std::atomic<int> dropped_messages{0};
+};
+
+// Set while async logging is on. Threads that have seen it set are counted in
+// |g_async_producers| until they have queued their message.
+std::atomic<bool> g_async_logging(false);
+std::atomic<int> g_async_producers(0);
+
+AsyncLogState* GetAsyncLogState() {
+  // Leaked, since threads may still log during static destruction.
+  static AsyncLogState* const state = new AsyncLogState();
+  return state;
+}
+
+#if defined(WEBRTC_POSIX)
+void AbandonLogMessageQueue(void* value) {
+  static_cast<LogMessageQueue*>(value)->state.store(
+      LogMessageQueue::kAbandoned, std::memory_order_release);
+}
+
+pthread_key_t GetLogMessageQueueKey() {
+  static const pthread_key_t key = [] {
+    pthread_key_t key;
+    pthread_key_create(&key, &AbandonLogMessageQueue);
+    return key;
+  }();
+  return key;
+}
+
+LogMessageQueue* GetThreadLogMessageQueue() {
+  pthread_key_t key = GetLogMessageQueueKey();
+  LogMessageQueue* queue =
+      static_cast<LogMessageQueue*>(pthread_getspecific(key));
+  if (!queue) {
+    AsyncLogState* state = GetAsyncLogState();
+    CritScope cs(&state->crit);
+    for (const auto& thread_queue : state->queues) {
+      if (thread_queue->state.load(std::memory_order_relaxed) ==
+          LogMessageQueue::kFree) {
+        queue = thread_queue.get();
+        break;
+      }
+    }
+    if (!queue) {
+      state->queues.emplace_back(new LogMessageQueue());
+      queue = state->queues.back().get();
+    }
+    queue->state.store(LogMessageQueue::kInUse, std::memory_order_relaxed);
+    pthread_setspecific(key, queue);
+  }
+  return queue;
+}
+#else
+// There is no portable way to release a thread's queue when it exits, so only
+// the shared queue is used.
+LogMessageQueue* GetThreadLogMessageQueue() {
+  return nullptr;
+}
+#endif
+
+// Queues |message| for the async log writer, and returns false if async
+// logging is off.
+bool QueueAsyncLogMessage(QueuedLogMessage* message) {
+  g_async_producers.fetch_add(1);
+  if (!g_async_logging.load()) {
+    g_async_producers.fetch_sub(1);
+    return false;
+  }
+  AsyncLogState* state = GetAsyncLogState();
+  LogMessageQueue* queue = GetThreadLogMessageQueue();
+  bool pushed;
+  if (queue) {
+    pushed = queue->Push(message);
+  } else {
+    CritScope cs(&state->crit);
+    pushed = state->shared_queue.Push(message);
+  }
+  if (!pushed)
+    state->dropped_messages.fetch_add(1, std::memory_order_relaxed);
+  g_async_producers.fetch_sub(1);
+  return true;
+}
+
+void YieldThread() {
+#if defined(WEBRTC_WIN)
+  ::Sleep(0);
+#else
+  sched_yield();
+#endif
+}
+
+// Moves the messages of all threads to |messages|.
+void CollectQueuedLogMessages(std::vector<QueuedLogMessage>* messages) {
+  AsyncLogState* state = GetAsyncLogState();
+  std::vector<LogMessageQueue*> queues;
+  {
+    CritScope cs(&state->crit);
+    for (const auto& thread_queue : state->queues)
+      queues.push_back(thread_queue.get());
+  }
+  for (LogMessageQueue* queue : queues) {
+    const int queue_state = queue->state.load(std::memory_order_acquire);
+    if (queue_state == LogMessageQueue::kFree)
+      continue;
+    queue->PopAll(messages);
+    if (queue_state == LogMessageQueue::kAbandoned) {
+      CritScope cs(&state->crit);
+      queue->state.store(LogMessageQueue::kFree, std::memory_order_relaxed);
+    }
+  }
+  state->shared_queue.PopAll(messages);
+}
 }  // namespace
 
+// Writes the queued messages in the background while async logging is on.
+class AsyncLogWriter {
+ public:
+  static void Run(void* /* param */) {
+    static const int kWriteIntervalMs = 10;
+    AsyncLogState* state = GetAsyncLogState();
+    std::vector<QueuedLogMessage> messages;
+    int reported_dropped_messages = 0;
+    while (true) {
+      state->wake_up.Wait(kWriteIntervalMs);
+      const bool stopping = state->stopping.load();
+      if (stopping) {
+        // Wait for the threads which are about to queue a message.
+        while (g_async_producers.load() > 0)
+          YieldThread();
+      }
+      messages.clear();
+      CollectQueuedLogMessages(&messages);
+      for (const QueuedLogMessage& message : messages)
+        LogMessage::Output(message.str, message.severity, message.tag);
+
+      const int dropped_messages = state->dropped_messages.load();
+      if (dropped_messages != reported_dropped_messages) {
+        char buffer[64];
+        SimpleStringBuilder warning(buffer);
+        warning << "Dropped " << dropped_messages - reported_dropped_messages
+                << " log messages.\n";
+        LogMessage::Output(warning.str(), LS_WARNING, "libjingle");
+        reported_dropped_messages = dropped_messages;
+      }
+      if (stopping)
+        break;
+    }
+  }
+};
+
 // Inefficient default implementation, override is recommended.
 void LogSink::OnLogMessage(const std::string& msg,
                            LoggingSeverity severity,
@@ -213,21 +435,34 @@ LogMessage::~LogMessage() {
   // of the constructed string. This means that we always end up creating
   // two copies here (one owned by the stream, one by the return value of
   // |str()|). It would be nice to switch to something else.
-  const std::string str = print_stream_.str();
+#if defined(WEBRTC_ANDROID)
+  QueuedLogMessage message = {print_stream_.str(), severity_, tag_};
+#else
+  QueuedLogMessage message = {print_stream_.str(), severity_, nullptr};
+#endif
+  if (QueueAsyncLogMessage(&message))
+    return;
+
+  Output(message.str, message.severity, message.tag);
+}
 
-  if (severity_ >= g_dbg_sev) {
+// static
+void LogMessage::Output(const std::string& str,
+                        LoggingSeverity severity,
+                        const char* tag) {
+  if (severity >= g_dbg_sev) {
 #if defined(WEBRTC_ANDROID)
-    OutputToDebug(str, severity_, tag_);
+    OutputToDebug(str, severity, tag);
 #else
-    OutputToDebug(str, severity_);
+    OutputToDebug(str, severity);
 #endif
   }
 
   CritScope cs(&g_log_crit);
   for (auto& kv : streams_) {
-    if (severity_ >= kv.second) {
+    if (severity >= kv.second) {
 #if defined(WEBRTC_ANDROID)
-      kv.first->OnLogMessage(str, severity_, tag_);
+      kv.first->OnLogMessage(str, severity, tag);
 #else
       kv.first->OnLogMessage(str);
 #endif
@@ -365,6 +600,34 @@ void LogMessage::ConfigureLogging(const char* params) {
   LogToDebug(debug_level);
 }
 
+void LogMessage::StartAsyncLogging() {
+  AsyncLogState* state = GetAsyncLogState();
+  if (state->writer_thread)
+    return;
+  state->stopping.store(false);
+  state->dropped_messages.store(0);
+  state->writer_thread.reset(
+      new PlatformThread(&AsyncLogWriter::Run, nullptr, "AsyncLogWriter"));
+  state->writer_thread->Start();
+  g_async_logging.store(true);
+}
+
+void LogMessage::StopAsyncLogging() {
+  AsyncLogState* state = GetAsyncLogState();
+  if (!state->writer_thread)
+    return;
+  g_async_logging.store(false);
+  // The writer drains the queues once more before it exits.
+  state->stopping.store(true);
+  state->wake_up.Set();
+  state->writer_thread->Stop();
+  state->writer_thread.reset();
+}
+
+int LogMessage::GetDroppedLogMessages() {
+  return GetAsyncLogState()->dropped_messages.load();
+}
+
 void LogMessage::UpdateMinLogSeverity()
     RTC_EXCLUSIVE_LOCKS_REQUIRED(g_log_crit) {
   LoggingSeverity min_sev = g_dbg_sev;
@@ -373,6 +636,7 @@ void LogMessage::UpdateMinLogSeverity()
     min_sev = std::min(min_sev, sev);
   }
   g_min_sev = min_sev;
+  g_no_streams.store(streams_.empty(), std::memory_order_relaxed);
 }
 
 #if defined(WEBRTC_ANDROID)
@@ -479,11 +743,7 @@ bool LogMessage::IsNoop(LoggingSeverity severity) {
   if (severity >= g_dbg_sev)
     return false;
 
-  // TODO(tommi): We're grabbing this lock for every LogMessage instance that
-  // is going to be logged. This introduces unnecessary synchronization for
-  // a feature that's mostly used for testing.
-  CritScope cs(&g_log_crit);
-  return streams_.size() == 0;
+  return g_no_streams.load(std::memory_order_relaxed);
 }
 
 void LogMessage::FinishPrintStream() {
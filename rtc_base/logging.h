@@ -464,14 +464,32 @@ class LogMessage {
   // Useful for configuring logging from the command line.
   static void ConfigureLogging(const char* params);
 
+  //  AsyncLogging: While on, a message is only formatted on the logging thread
+  //   and put in a queue owned by that thread. A background thread writes the
+  //   queued messages to the debug output and the streams, so that slow
+  //   streams don't block the threads that log. If a thread logs faster than
+  //   the messages are written its queue fills up, and further messages are
+  //   dropped and counted. StopAsyncLogging writes the queued messages before
+  //   returning. Both must be called on the same thread.
+  static void StartAsyncLogging();
+  static void StopAsyncLogging();
+  // The number of messages dropped since async logging was last started.
+  static int GetDroppedLogMessages();
+
  private:
   friend class LogMessageForTesting;
+  friend class AsyncLogWriter;
   typedef std::pair<LogSink*, LoggingSeverity> StreamAndSeverity;
   typedef std::list<StreamAndSeverity> StreamList;
 
   // Updates min_sev_ appropriately when debug sinks change.
   static void UpdateMinLogSeverity();
 
+  // Writes |str| to the debug output and the streams, on the calling thread.
+  static void Output(const std::string& str,
+                     LoggingSeverity severity,
+                     const char* tag);
+
 // These write out the actual log messages.
 #if defined(WEBRTC_ANDROID)
   static void OutputToDebug(const std::string& msg,
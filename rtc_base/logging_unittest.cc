@@ -9,6 +9,10 @@
  */
 
 #include "rtc_base/logging.h"
+
+#include <string>
+#include <vector>
+
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
@@ -355,6 +359,76 @@ TEST(LogTest, CheckNoopLogEntry) {
   EXPECT_TRUE(stream.empty());
 }
 
+// Records the messages it gets and the thread they are written on.
+class RecordingLogSink : public LogSink {
+ public:
+  void OnLogMessage(const std::string& message) override {
+    messages_.push_back(message);
+    thread_ = CurrentThreadId();
+  }
+
+  std::vector<std::string> messages_;
+  PlatformThreadId thread_ = 0;
+};
+
+TEST(LogTest, AsyncLoggingWritesOnBackgroundThread) {
+  RecordingLogSink sink;
+  LogMessage::AddLogToStream(&sink, LS_INFO);
+  LogMessage::StartAsyncLogging();
+  RTC_LOG(LS_INFO) << "First";
+  RTC_LOG(LS_INFO) << "Second";
+  RTC_LOG(LS_VERBOSE) << "Filtered";
+  LogMessage::StopAsyncLogging();
+  LogMessage::RemoveLogToStream(&sink);
+
+  ASSERT_EQ(2u, sink.messages_.size());
+  EXPECT_NE(std::string::npos, sink.messages_[0].find("First"));
+  EXPECT_NE(std::string::npos, sink.messages_[1].find("Second"));
+  EXPECT_NE(CurrentThreadId(), sink.thread_);
+  EXPECT_EQ(0, LogMessage::GetDroppedLogMessages());
+}
+
+// Blocks the async log writer in the first message until Release() is called.
+class BlockingLogSink : public LogSink {
+ public:
+  void OnLogMessage(const std::string& message) override {
+    if (num_messages_++ == 0) {
+      blocked_.Set();
+      release_.Wait(Event::kForever);
+    }
+  }
+
+  void WaitUntilBlocked() { blocked_.Wait(Event::kForever); }
+  void Release() { release_.Set(); }
+
+  int num_messages_ = 0;
+
+ private:
+  Event blocked_{false, false};
+  Event release_{false, false};
+};
+
+TEST(LogTest, AsyncLoggingCountsDroppedMessages) {
+  BlockingLogSink sink;
+  LogMessage::AddLogToStream(&sink, LS_INFO);
+  LogMessage::StartAsyncLogging();
+  RTC_LOG(LS_INFO) << "Block";
+  sink.WaitUntilBlocked();
+  // The queue of this thread can't be emptied while the writer is blocked.
+  static const int kNumMessages = 2000;
+  for (int i = 0; i < kNumMessages; ++i)
+    RTC_LOG(LS_INFO) << "Message " << i;
+  const int dropped = LogMessage::GetDroppedLogMessages();
+  EXPECT_GT(dropped, 0);
+  sink.Release();
+  LogMessage::StopAsyncLogging();
+  LogMessage::RemoveLogToStream(&sink);
+
+  // Everything that wasn't dropped is written, followed by a warning about the
+  // dropped messages.
+  EXPECT_EQ(1 + kNumMessages - dropped + 1, sink.num_messages_);
+}
+
 // Test the time required to write 1000 80-character logs to a string.
 TEST(LogTest, Perf) {
   std::string str;
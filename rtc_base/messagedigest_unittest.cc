@@ -10,6 +10,7 @@
 
 #include "rtc_base/messagedigest.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/openssldigest.h"
 #include "rtc_base/stringencode.h"
 
 namespace rtc {
@@ -151,4 +152,26 @@ TEST(MessageDigestTest, TestBadHmac) {
   EXPECT_EQ("", ComputeHmac("sha-9000", "key", "abc"));
 }
 
+TEST(MessageDigestTest, TestSha1HmacWithReusedKey) {
+  const std::string key(80, '\xaa');
+  OpenSSLHmac hmac(DIGEST_SHA_1, key.data(), key.size());
+  ASSERT_EQ(20u, hmac.Size());
+  char output[20];
+  for (int i = 0; i < 2; ++i) {
+    // Both HMACs are computed with the key schedule computed once.
+    const std::string input1 = "Test Using Larger Than Block-Size Key and ";
+    const std::string input2 = "Larger Than One Block-Size Data";
+    hmac.Update(input1.data(), input1.size());
+    hmac.Update(input2.data(), input2.size());
+    EXPECT_EQ(sizeof(output), hmac.Finish(output, sizeof(output)));
+    EXPECT_EQ("e8e99d0f45237d786d6bbaa7965c7808bbff1a91",
+              hex_encode(output, sizeof(output)));
+  }
+  EXPECT_EQ(0u, hmac.Finish(output, sizeof(output) - 1));
+
+  OpenSSLHmac bad_hmac("sha-9000", key.data(), key.size());
+  EXPECT_EQ(0u, bad_hmac.Size());
+  EXPECT_EQ(0u, bad_hmac.Finish(output, sizeof(output)));
+}
+
 }  // namespace rtc
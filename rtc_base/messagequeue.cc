@@ -8,9 +8,12 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <algorithm>
+#include <new>
 
 #include "rtc_base/atomicops.h"
+#include "rtc_base/bufferpool.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/messagequeue.h"
 #include "rtc_base/stringencode.h"
@@ -175,10 +178,18 @@ void MessageQueueManager::ProcessAllMessageQueuesInternal() {
 // MessageQueue
 MessageQueue::MessageQueue(SocketServer* ss, bool init_queue)
     : fPeekKeep_(false),
+      incoming_(nullptr),
+      incoming_size_(0),
+      msgq_head_(nullptr),
+      msgq_tail_(nullptr),
+      msgq_size_(0),
+      dmsgq_(new TimerWheel<DelayedMessage>()),
       dmsgq_next_num_(0),
       fInitialized_(false),
       fDestroyed_(false),
       stop_(0),
+      dispatch_stats_name_("MessageQueue"),
+      dispatch_stats_(nullptr),
       ss_(ss) {
   RTC_DCHECK(ss);
   // Currently, MessageQueue holds a socket server, and is the base class for
@@ -236,6 +247,88 @@ void MessageQueue::WakeUpSocketServer() {
   ss_->WakeUp();
 }
 
+bool MessageQueue::PushIncoming(MessageNode* node) {
+  // Counted before the push, so that DrainIncoming() never sees more nodes
+  // than have been counted.
+  incoming_size_.fetch_add(1, std::memory_order_relaxed);
+  MessageNode* head = incoming_.load(std::memory_order_relaxed);
+  do {
+    node->next = head;
+  } while (!incoming_.compare_exchange_weak(
+      head, node, std::memory_order_release, std::memory_order_relaxed));
+  return head == nullptr;
+}
+
+void MessageQueue::DrainIncoming() {
+  MessageNode* node = incoming_.exchange(nullptr, std::memory_order_acquire);
+  if (!node)
+    return;
+
+  // Reverse the stack into FIFO order.
+  MessageNode* const last = node;
+  MessageNode* first = nullptr;
+  size_t count = 0;
+  while (node) {
+    MessageNode* next = node->next;
+    node->next = first;
+    first = node;
+    node = next;
+    ++count;
+  }
+  incoming_size_.fetch_sub(count, std::memory_order_relaxed);
+
+  if (msgq_tail_) {
+    msgq_tail_->next = first;
+  } else {
+    msgq_head_ = first;
+  }
+  msgq_tail_ = last;
+  msgq_size_ += count;
+}
+
+void MessageQueue::AppendMessage(const Message& msg) {
+  // Messages that were posted earlier go first.
+  DrainIncoming();
+  MessageNode* node = NewNode(msg);
+  if (msgq_tail_) {
+    msgq_tail_->next = node;
+  } else {
+    msgq_head_ = node;
+  }
+  msgq_tail_ = node;
+  ++msgq_size_;
+}
+
+bool MessageQueue::PopMessage(Message* msg) {
+  if (!msgq_head_)
+    DrainIncoming();
+  MessageNode* node = msgq_head_;
+  if (!node)
+    return false;
+  msgq_head_ = node->next;
+  if (!msgq_head_)
+    msgq_tail_ = nullptr;
+  --msgq_size_;
+  *msg = node->msg;
+  DeleteNode(node);
+  return true;
+}
+
+// static
+MessageQueue::MessageNode* MessageQueue::NewNode(const Message& msg) {
+  MessageNode* node =
+      new (BufferPool::Allocate(sizeof(MessageNode))) MessageNode();
+  node->msg = msg;
+  node->next = nullptr;
+  return node;
+}
+
+// static
+void MessageQueue::DeleteNode(MessageNode* node) {
+  node->~MessageNode();
+  BufferPool::Free(node);
+}
+
 void MessageQueue::Quit() {
   AtomicOps::ReleaseStore(&stop_, 1);
   WakeUpSocketServer();
@@ -298,22 +391,17 @@ bool MessageQueue::Get(Message* pmsg, int cmsWait, bool process_io) {
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
-          while (!dmsgq_.empty()) {
-            if (msCurrent < dmsgq_.top().msTrigger_) {
-              cmsDelayNext = TimeDiff(dmsgq_.top().msTrigger_, msCurrent);
-              break;
-            }
-            msgq_.push_back(dmsgq_.top().msg_);
-            dmsgq_.pop();
-          }
+          dmsgq_->Advance(msCurrent, &expired_dmsgs_);
+          for (const DelayedMessage& dmsg : expired_dmsgs_)
+            AppendMessage(dmsg.msg_);
+          expired_dmsgs_.clear();
+          int64_t msNext = dmsgq_->NextAdvanceTime();
+          if (msNext >= 0)
+            cmsDelayNext = std::max<int64_t>(0, TimeDiff(msNext, msCurrent));
         }
         // Pull a message off the message queue, if available.
-        if (msgq_.empty()) {
+        if (!PopMessage(pmsg))
           break;
-        } else {
-          *pmsg = msgq_.front();
-          msgq_.pop_front();
-        }
       }  // crit_ is released here.
 
       // Log a warning for time-sensitive messages that we're late to deliver.
@@ -378,22 +466,22 @@ void MessageQueue::Post(const Location& posted_from,
     return;
 
   // Keep thread safe
-  // Add the message to the end of the queue
-  // Signal for the multiplexer to return
-
-  {
-    CritScope cs(&crit_);
-    Message msg;
-    msg.posted_from = posted_from;
-    msg.phandler = phandler;
-    msg.message_id = id;
-    msg.pdata = pdata;
-    if (time_sensitive) {
-      msg.ts_sensitive = TimeMillis() + kMaxMsgLatency;
-    }
-    msgq_.push_back(msg);
+  // Add the message to the end of the queue without locking
+  // Signal for the multiplexer to return, unless an earlier post that has not
+  // been picked up yet already did
+
+  Message msg;
+  msg.posted_from = posted_from;
+  msg.phandler = phandler;
+  msg.message_id = id;
+  msg.pdata = pdata;
+  if (time_sensitive) {
+    msg.ts_sensitive = TimeMillis() + kMaxMsgLatency;
   }
-  WakeUpSocketServer();
+  if (DispatchStatsRecorder::IsRecording())
+    msg.due_time_us = TimeMicros();
+  if (PushIncoming(NewNode(msg)))
+    WakeUpSocketServer();
 }
 
 void MessageQueue::PostDelayed(const Location& posted_from,
@@ -435,7 +523,7 @@ void MessageQueue::DoDelayPost(const Location& posted_from,
   }
 
   // Keep thread safe
-  // Add to the priority queue. Gets sorted soonest first.
+  // Add to the timer wheel. Expires soonest first.
   // Signal for the multiplexer to return.
 
   {
@@ -445,8 +533,10 @@ void MessageQueue::DoDelayPost(const Location& posted_from,
     msg.phandler = phandler;
     msg.message_id = id;
     msg.pdata = pdata;
+    if (DispatchStatsRecorder::IsRecording())
+      msg.due_time_us = tstamp * kNumMicrosecsPerMillisec;
     DelayedMessage dmsg(cmsDelay, tstamp, dmsgq_next_num_, msg);
-    dmsgq_.push(dmsg);
+    dmsgq_->Insert(TimeMillis(), tstamp, dmsg);
     // If this message queue processes 1 message every millisecond for 50 days,
     // we will wrap this number.  Even then, only messages with identical times
     // will be misordered, and then only briefly.  This is probably ok.
@@ -459,11 +549,12 @@ void MessageQueue::DoDelayPost(const Location& posted_from,
 int MessageQueue::GetDelay() {
   CritScope cs(&crit_);
 
-  if (!msgq_.empty())
+  if (msgq_head_ || incoming_.load(std::memory_order_relaxed))
     return 0;
 
-  if (!dmsgq_.empty()) {
-    int delay = TimeUntil(dmsgq_.top().msTrigger_);
+  int64_t next = dmsgq_->NextAdvanceTime();
+  if (next >= 0) {
+    int delay = TimeUntil(next);
     if (delay < 0)
       delay = 0;
     return delay;
@@ -490,51 +581,102 @@ void MessageQueue::Clear(MessageHandler* phandler,
 
   // Remove from ordered message queue
 
-  for (MessageList::iterator it = msgq_.begin(); it != msgq_.end();) {
-    if (it->Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(*it);
-      } else {
-        delete it->pdata;
-      }
-      it = msgq_.erase(it);
+  // Matching messages are unlinked before their data is deleted, since that
+  // may clear this queue again re-entrantly.
+  DrainIncoming();
+  MessageNode* cleared_head = nullptr;
+  MessageNode** cleared_link = &cleared_head;
+  MessageNode** link = &msgq_head_;
+  msgq_tail_ = nullptr;
+  while (MessageNode* node = *link) {
+    if (node->msg.Match(phandler, id)) {
+      *link = node->next;
+      --msgq_size_;
+      node->next = nullptr;
+      *cleared_link = node;
+      cleared_link = &node->next;
+    } else {
+      msgq_tail_ = node;
+      link = &node->next;
+    }
+  }
+  while (MessageNode* node = cleared_head) {
+    cleared_head = node->next;
+    if (removed) {
+      removed->push_back(node->msg);
     } else {
-      ++it;
+      delete node->msg.pdata;
     }
+    DeleteNode(node);
   }
 
-  // Remove from priority queue. Not directly iterable, so use this approach
+  // Remove from the timer wheel
 
-  PriorityQueue::container_type::iterator new_end = dmsgq_.container().begin();
-  for (PriorityQueue::container_type::iterator it = new_end;
-       it != dmsgq_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(it->msg_);
-      } else {
-        delete it->msg_.pdata;
-      }
+  std::vector<DelayedMessage> cleared;
+  dmsgq_->RemoveIf(
+      [phandler, id](const DelayedMessage& dmsg) {
+        return dmsg.msg_.Match(phandler, id);
+      },
+      &cleared);
+  for (const DelayedMessage& dmsg : cleared) {
+    if (removed) {
+      removed->push_back(dmsg.msg_);
     } else {
-      *new_end++ = *it;
+      delete dmsg.msg_.pdata;
     }
   }
-  dmsgq_.container().erase(new_end, dmsgq_.container().end());
-  dmsgq_.reheap();
+}
+
+void MessageQueue::SetDelayedMessageResolution(int64_t resolution_ms) {
+  CritScope cs(&crit_);
+  if (resolution_ms == dmsgq_->resolution_ms())
+    return;
+  std::vector<DelayedMessage> dmsgs;
+  dmsgq_->RemoveIf([](const DelayedMessage&) { return true; }, &dmsgs);
+  // Keep the FIFO order of messages with the same trigger time.
+  std::sort(dmsgs.begin(), dmsgs.end(),
+            [](const DelayedMessage& a, const DelayedMessage& b) {
+              return b < a;
+            });
+  dmsgq_.reset(new TimerWheel<DelayedMessage>(resolution_ms));
+  const int64_t now = TimeMillis();
+  for (const DelayedMessage& dmsg : dmsgs)
+    dmsgq_->Insert(now, dmsg.msTrigger_, dmsg);
 }
 
 void MessageQueue::Dispatch(Message* pmsg) {
   TRACE_EVENT2("webrtc", "MessageQueue::Dispatch", "src_file_and_line",
                pmsg->posted_from.file_and_line(), "src_func",
                pmsg->posted_from.function_name());
-  int64_t start_time = TimeMillis();
+  const bool record_stats = DispatchStatsRecorder::IsRecording();
+  int64_t start_cpu_time_ns = 0;
+  if (record_stats)
+    start_cpu_time_ns = GetThreadCpuTimeNanos();
+  int64_t start_time_us = TimeMicros();
   pmsg->phandler->OnMessage(pmsg);
-  int64_t end_time = TimeMillis();
-  int64_t diff = TimeDiff(end_time, start_time);
+  int64_t end_time_us = TimeMicros();
+  int64_t diff = (end_time_us - start_time_us) / kNumMicrosecsPerMillisec;
   if (diff >= kSlowDispatchLoggingThreshold) {
     RTC_LOG(LS_INFO) << "Message took " << diff
                      << "ms to dispatch. Posted from: "
                      << pmsg->posted_from.ToString();
   }
+  if (record_stats) {
+    if (!dispatch_stats_)
+      dispatch_stats_ = DispatchStatsRecorder::ForQueue(dispatch_stats_name_);
+    const int64_t queue_delay_us =
+        pmsg->due_time_us < 0
+            ? -1
+            : std::max<int64_t>(0, start_time_us - pmsg->due_time_us);
+    dispatch_stats_->Record(pmsg->posted_from.file_and_line(), queue_delay_us,
+                            end_time_us - start_time_us,
+                            GetThreadCpuTimeNanos() - start_cpu_time_ns);
+  }
+}
+
+void MessageQueue::SetDispatchStatsName(const std::string& name) {
+  dispatch_stats_name_ = name;
+  dispatch_stats_ = nullptr;
 }
 
 }  // namespace rtc
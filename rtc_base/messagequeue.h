@@ -14,20 +14,23 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <memory>
-#include <queue>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/dispatch_stats.h"
 #include "rtc_base/location.h"
 #include "rtc_base/messagehandler.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/socketserver.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "rtc_base/thread_annotations.h"
+#include "rtc_base/timerwheel.h"
 #include "rtc_base/timeutils.h"
 
 namespace rtc {
@@ -158,7 +161,11 @@ const uint32_t MQID_DISPOSE = static_cast<uint32_t>(-2);
 
 struct Message {
   Message()
-      : phandler(nullptr), message_id(0), pdata(nullptr), ts_sensitive(0) {}
+      : phandler(nullptr),
+        message_id(0),
+        pdata(nullptr),
+        ts_sensitive(0),
+        due_time_us(-1) {}
   inline bool Match(MessageHandler* handler, uint32_t id) const {
     return (handler == nullptr || handler == phandler) &&
            (id == MQID_ANY || id == message_id);
@@ -168,11 +175,14 @@ struct Message {
   uint32_t message_id;
   MessageData* pdata;
   int64_t ts_sensitive;
+  // When the message was due to be dispatched, in TimeMicros(). Only set
+  // while DispatchStatsRecorder is recording, and -1 otherwise.
+  int64_t due_time_us;
 };
 
 typedef std::list<Message> MessageList;
 
-// DelayedMessage goes into a priority queue, sorted by trigger time.  Messages
+// DelayedMessage goes into a timer wheel, keyed by trigger time.  Messages
 // with the same trigger time are processed in num_ (FIFO) order.
 
 class DelayedMessage {
@@ -266,10 +276,17 @@ class MessageQueue {
   // Amount of time until the next message can be retrieved
   virtual int GetDelay();
 
+  // Sets the tick resolution of the timer wheel holding delayed messages.
+  // Delayed messages are delivered at the first tick at or after their trigger
+  // time, so a coarser resolution trades timer precision for fewer wakeups.
+  // Defaults to DefaultTimerWheelResolution().
+  void SetDelayedMessageResolution(int64_t resolution_ms);
+
   bool empty() const { return size() == 0u; }
   size_t size() const {
-    CritScope cs(&crit_);  // msgq_.size() is not thread safe.
-    return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u);
+    CritScope cs(&crit_);  // dmsgq_->size() is not thread safe.
+    return msgq_size_ + incoming_size_.load(std::memory_order_relaxed) +
+           dmsgq_->size() + (fPeekKeep_ ? 1u : 0u);
   }
 
   // Internally posts a message which causes the doomed object to be deleted
@@ -285,10 +302,11 @@ class MessageQueue {
   sigslot::signal0<> SignalQueueDestroyed;
 
  protected:
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
+  // A message waiting to be delivered. Nodes are allocated from BufferPool
+  // and linked into |incoming_| or |msgq_head_|.
+  struct MessageNode {
+    Message msg;
+    MessageNode* next;
   };
 
   void DoDelayPost(const Location& posted_from,
@@ -308,10 +326,34 @@ class MessageQueue {
 
   void WakeUpSocketServer();
 
+  // Sets the name under which the dispatched messages are recorded by
+  // DispatchStatsRecorder. Must not be called while messages are dispatched.
+  void SetDispatchStatsName(const std::string& name);
+
+  // Pushes |node| onto |incoming_| without taking |crit_|. Returns true if
+  // |incoming_| was empty, i.e. if the socket server needs to be woken up.
+  bool PushIncoming(MessageNode* node);
+  // Moves the nodes in |incoming_| to the end of |msgq_head_|, oldest first.
+  void DrainIncoming() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void AppendMessage(const Message& msg) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  bool PopMessage(Message* msg) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  static MessageNode* NewNode(const Message& msg);
+  static void DeleteNode(MessageNode* node);
+
   bool fPeekKeep_;
   Message msgPeek_;
-  MessageList msgq_ RTC_GUARDED_BY(crit_);
-  PriorityQueue dmsgq_ RTC_GUARDED_BY(crit_);
+  // Posted messages, newest first. This is an intrusive lock-free stack that
+  // any thread can push onto; it is drained into |msgq_head_| by whichever
+  // thread next takes |crit_| to read or clear the queue.
+  std::atomic<MessageNode*> incoming_;
+  std::atomic<size_t> incoming_size_;
+  // Messages ready for delivery, oldest first.
+  MessageNode* msgq_head_ RTC_GUARDED_BY(crit_);
+  MessageNode* msgq_tail_ RTC_GUARDED_BY(crit_);
+  size_t msgq_size_ RTC_GUARDED_BY(crit_);
+  std::unique_ptr<TimerWheel<DelayedMessage>> dmsgq_ RTC_GUARDED_BY(crit_);
+  // Scratch storage for messages expired from |dmsgq_|.
+  std::vector<DelayedMessage> expired_dmsgs_ RTC_GUARDED_BY(crit_);
   uint32_t dmsgq_next_num_ RTC_GUARDED_BY(crit_);
   CriticalSection crit_;
   bool fInitialized_;
@@ -320,6 +362,10 @@ class MessageQueue {
  private:
   volatile int stop_;
 
+  // Only used by the thread that dispatches the messages.
+  std::string dispatch_stats_name_;
+  DispatchStatsRecorder* dispatch_stats_;
+
   // The SocketServer might not be owned by MessageQueue.
   SocketServer* const ss_;
   // Used if SocketServer ownership lies with |this|.
@@ -18,6 +18,7 @@
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/nullsocketserver.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/refcountedobject.h"
 #include "rtc_base/thread.h"
@@ -120,6 +121,124 @@ TEST_F(MessageQueueTest, DiposeHandlerWithPostedMessagePending) {
   EXPECT_TRUE(deleted);
 }
 
+TEST_F(MessageQueueTest, PostsAreDeliveredInOrder) {
+  for (uint32_t i = 0; i < 10; ++i)
+    Post(RTC_FROM_HERE, nullptr, i);
+  EXPECT_EQ(10u, size());
+  Clear(nullptr, 5);
+  EXPECT_EQ(9u, size());
+
+  Message msg;
+  for (uint32_t i = 0; i < 10; ++i) {
+    if (i == 5)
+      continue;
+    ASSERT_TRUE(Get(&msg, 0));
+    EXPECT_EQ(i, msg.message_id);
+    // Posts made while the queue is being read go to the back.
+    if (i == 0)
+      Post(RTC_FROM_HERE, nullptr, 10);
+  }
+  ASSERT_TRUE(Get(&msg, 0));
+  EXPECT_EQ(10u, msg.message_id);
+  EXPECT_FALSE(Get(&msg, 0));
+  EXPECT_TRUE(empty());
+}
+
+TEST_F(MessageQueueTest, ChangingDelayedMessageResolutionKeepsOrder) {
+  int64_t now = TimeMillis();
+  PostAt(RTC_FROM_HERE, now + 20, nullptr, 2);
+  PostAt(RTC_FROM_HERE, now + 10, nullptr, 0);
+  PostAt(RTC_FROM_HERE, now + 10, nullptr, 1);
+  SetDelayedMessageResolution(8);
+  EXPECT_EQ(3u, size());
+
+  Message msg;
+  for (uint32_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(Get(&msg, 1000));
+    EXPECT_EQ(i, msg.message_id);
+    // Delayed messages are never delivered early.
+    EXPECT_GE(TimeMillis(), now + (i < 2 ? 10 : 20));
+  }
+}
+
+namespace {
+
+class WakeUpCountingSocketServer : public NullSocketServer {
+ public:
+  void WakeUp() override {
+    ++wakeups_;
+    NullSocketServer::WakeUp();
+  }
+  int wakeups() const { return wakeups_; }
+
+ private:
+  int wakeups_ = 0;
+};
+
+}  // namespace
+
+TEST(MessageQueue, WakeUpsAreCoalesced) {
+  WakeUpCountingSocketServer ss;
+  MessageQueue queue(&ss, true);
+  queue.Post(RTC_FROM_HERE, nullptr, 1);
+  queue.Post(RTC_FROM_HERE, nullptr, 2);
+  queue.Post(RTC_FROM_HERE, nullptr, 3);
+  EXPECT_EQ(1, ss.wakeups());
+
+  Message msg;
+  EXPECT_TRUE(queue.Get(&msg, 0));
+  queue.Post(RTC_FROM_HERE, nullptr, 4);
+  EXPECT_EQ(2, ss.wakeups());
+  queue.Clear(nullptr);
+}
+
+namespace {
+
+const uint32_t kMessagesPerProducer = 1000;
+
+struct Producer {
+  MessageQueue* queue;
+  uint32_t index;
+};
+
+void ProduceMessages(void* param) {
+  Producer* producer = static_cast<Producer*>(param);
+  for (uint32_t i = 0; i < kMessagesPerProducer; ++i) {
+    producer->queue->Post(RTC_FROM_HERE, nullptr,
+                          producer->index * kMessagesPerProducer + i);
+  }
+}
+
+}  // namespace
+
+TEST(MessageQueue, PostsFromManyThreads) {
+  NullSocketServer ss;
+  MessageQueue queue(&ss, true);
+  const uint32_t kNumProducers = 4;
+  Producer producers[kNumProducers];
+  std::unique_ptr<PlatformThread> threads[kNumProducers];
+  for (uint32_t i = 0; i < kNumProducers; ++i) {
+    producers[i] = {&queue, i};
+    threads[i].reset(
+        new PlatformThread(&ProduceMessages, &producers[i], "Producer"));
+    threads[i]->Start();
+  }
+
+  // Messages of each producer arrive in the order they were posted.
+  uint32_t next[kNumProducers] = {};
+  for (uint32_t received = 0; received < kNumProducers * kMessagesPerProducer;
+       ++received) {
+    Message msg;
+    ASSERT_TRUE(queue.Get(&msg, 10000));
+    uint32_t producer = msg.message_id / kMessagesPerProducer;
+    ASSERT_LT(producer, kNumProducers);
+    EXPECT_EQ(next[producer]++, msg.message_id % kMessagesPerProducer);
+  }
+  for (std::unique_ptr<PlatformThread>& thread : threads)
+    thread->Stop();
+  EXPECT_TRUE(queue.empty());
+}
+
 struct UnwrapMainThreadScope {
   UnwrapMainThreadScope() : rewrap_(Thread::Current() != nullptr) {
     if (rewrap_)
@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_METHODCALLBACK_H_
+#define RTC_BASE_METHODCALLBACK_H_
+
+#include "rtc_base/checks.h"
+
+// MethodCallback is a callback to a method of an object, for an event that has
+// a single receiver and is raised too often for a sigslot signal, such as the
+// arrival of a packet. Emitting a signal locks its mutex and walks its list of
+// connections; invoking a MethodCallback is one indirect call. Like
+// FunctionView, it is just two pointers and never allocates, but unlike
+// FunctionView it may be stored, since it only refers to the object.
+//
+// There is no automatic disconnection: the receiver must reset the callback
+// before it is destroyed, and it is invoked on the thread it is raised on.
+//
+// Example use:
+//
+//   using ReadCallback = rtc::MethodCallback<void(const char*, size_t)>;
+//   ReadCallback callback =
+//       ReadCallback::Create<Receiver, &Receiver::OnRead>(&receiver);
+//   ...
+//   if (callback)
+//     callback(data, size);
+
+namespace rtc {
+
+template <typename T>
+class MethodCallback;  // Undefined.
+
+template <typename... ArgT>
+class MethodCallback<void(ArgT...)> final {
+ public:
+  MethodCallback() = default;
+
+  template <typename T, void (T::*method)(ArgT...)>
+  static MethodCallback Create(T* object) {
+    RTC_DCHECK(object);
+    return MethodCallback(object, &CallMethod<T, method>);
+  }
+
+  explicit operator bool() const { return object_ != nullptr; }
+
+  bool operator==(const MethodCallback& other) const {
+    return object_ == other.object_ && call_ == other.call_;
+  }
+  bool operator!=(const MethodCallback& other) const {
+    return !(*this == other);
+  }
+
+  void operator()(ArgT... args) const {
+    RTC_DCHECK(object_);
+    call_(object_, args...);
+  }
+
+ private:
+  MethodCallback(void* object, void (*call)(void*, ArgT...))
+      : object_(object), call_(call) {}
+
+  template <typename T, void (T::*method)(ArgT...)>
+  static void CallMethod(void* object, ArgT... args) {
+    (static_cast<T*>(object)->*method)(args...);
+  }
+
+  void* object_ = nullptr;
+  void (*call_)(void*, ArgT...) = nullptr;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_METHODCALLBACK_H_
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+
+#include "rtc_base/methodcallback.h"
+#include "test/gtest.h"
+
+namespace rtc {
+
+namespace {
+
+class Receiver {
+ public:
+  void OnValue(int value) { sum_ += value; }
+  void OnOtherValue(int value) { sum_ -= value; }
+  void OnString(const std::string& string, size_t* length) {
+    *length = string.size();
+  }
+
+  int sum() const { return sum_; }
+
+ private:
+  int sum_ = 0;
+};
+
+using IntCallback = MethodCallback<void(int)>;
+
+}  // namespace
+
+TEST(MethodCallbackTest, EmptyByDefault) {
+  IntCallback callback;
+  EXPECT_FALSE(callback);
+  EXPECT_EQ(IntCallback(), callback);
+}
+
+TEST(MethodCallbackTest, CallsMethodOfObject) {
+  Receiver a;
+  Receiver b;
+  IntCallback callback = IntCallback::Create<Receiver, &Receiver::OnValue>(&a);
+  EXPECT_TRUE(callback);
+  callback(3);
+  callback(4);
+  EXPECT_EQ(7, a.sum());
+  EXPECT_EQ(0, b.sum());
+
+  callback = IntCallback::Create<Receiver, &Receiver::OnValue>(&b);
+  callback(5);
+  EXPECT_EQ(7, a.sum());
+  EXPECT_EQ(5, b.sum());
+}
+
+TEST(MethodCallbackTest, PassesReferenceArguments) {
+  Receiver receiver;
+  auto callback = MethodCallback<void(const std::string&, size_t*)>::Create<
+      Receiver, &Receiver::OnString>(&receiver);
+  size_t length = 0;
+  callback("four", &length);
+  EXPECT_EQ(4u, length);
+}
+
+TEST(MethodCallbackTest, ComparesObjectAndMethod) {
+  Receiver a;
+  Receiver b;
+  IntCallback callback = IntCallback::Create<Receiver, &Receiver::OnValue>(&a);
+  EXPECT_EQ((IntCallback::Create<Receiver, &Receiver::OnValue>(&a)), callback);
+  EXPECT_NE((IntCallback::Create<Receiver, &Receiver::OnValue>(&b)), callback);
+  EXPECT_NE((IntCallback::Create<Receiver, &Receiver::OnOtherValue>(&a)),
+            callback);
+  callback = IntCallback();
+  EXPECT_FALSE(callback);
+}
+
+}  // namespace rtc
@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/networkthreadpool.h"
+
+#include <string>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/physicalsocketserver.h"
+
+namespace rtc {
+
+size_t NetworkThreadPool::RoundRobinShardSelector::SelectShard(
+    const SocketAddress& local_address,
+    size_t num_shards) {
+  size_t shard = next_ % num_shards;
+  next_ = shard + 1;
+  return shard;
+}
+
+NetworkThreadPool::NetworkThreadPool(size_t num_shards)
+    : NetworkThreadPool(num_shards,
+                        std::unique_ptr<ShardSelector>(
+                            new RoundRobinShardSelector())) {}
+
+NetworkThreadPool::NetworkThreadPool(size_t num_shards,
+                                     std::unique_ptr<ShardSelector> selector)
+    : selector_(std::move(selector)) {
+  RTC_DCHECK_GT(num_shards, 0);
+  RTC_DCHECK(selector_);
+  for (size_t i = 0; i < num_shards; ++i) {
+    std::unique_ptr<Thread> thread(new Thread(
+        std::unique_ptr<SocketServer>(new PhysicalSocketServer())));
+    thread->SetName("NetworkShard" + std::to_string(i), nullptr);
+    shards_.push_back(std::move(thread));
+  }
+}
+
+NetworkThreadPool::~NetworkThreadPool() {
+  Stop();
+}
+
+void NetworkThreadPool::Start() {
+  for (auto& shard : shards_)
+    shard->Start();
+}
+
+void NetworkThreadPool::Stop() {
+  for (auto& shard : shards_)
+    shard->Stop();
+}
+
+Thread* NetworkThreadPool::SelectShard(const SocketAddress& local_address) {
+  size_t index;
+  {
+    CritScope cs(&crit_);
+    index = selector_->SelectShard(local_address, shards_.size());
+  }
+  RTC_DCHECK_LT(index, shards_.size());
+  return shards_[index].get();
+}
+
+}  // namespace rtc
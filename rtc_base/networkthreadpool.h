@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_NETWORKTHREADPOOL_H_
+#define RTC_BASE_NETWORKTHREADPOOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/socketaddress.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+
+// Runs a fixed number of network threads ("shards"), each with its own
+// PhysicalSocketServer and therefore its own epoll loop, so that socket I/O
+// can be spread over several cores in one process.
+//
+// A socket created on a shard's socket server signals all of its events on
+// that shard's thread, so everything that handles those events must live on
+// the same shard.
+class NetworkThreadPool {
+ public:
+  // Decides which shard a new socket is placed on. Called under a lock, so
+  // implementations do not need to be thread safe themselves.
+  class ShardSelector {
+   public:
+    virtual ~ShardSelector() {}
+    virtual size_t SelectShard(const SocketAddress& local_address,
+                               size_t num_shards) = 0;
+  };
+
+  // Places sockets on shards in turn.
+  class RoundRobinShardSelector : public ShardSelector {
+   public:
+    size_t SelectShard(const SocketAddress& local_address,
+                       size_t num_shards) override;
+
+   private:
+    size_t next_ = 0;
+  };
+
+  // Uses a RoundRobinShardSelector.
+  explicit NetworkThreadPool(size_t num_shards);
+  NetworkThreadPool(size_t num_shards,
+                    std::unique_ptr<ShardSelector> selector);
+  ~NetworkThreadPool();
+
+  // Starts and stops all shard threads.
+  void Start();
+  void Stop();
+
+  size_t size() const { return shards_.size(); }
+  Thread* shard(size_t index) const { return shards_[index].get(); }
+
+  // Returns the shard a socket bound to |local_address| should be created on.
+  // Can be called from any thread.
+  Thread* SelectShard(const SocketAddress& local_address);
+
+ private:
+  std::vector<std::unique_ptr<Thread>> shards_;
+  CriticalSection crit_;
+  std::unique_ptr<ShardSelector> selector_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetworkThreadPool);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_NETWORKTHREADPOOL_H_
@@ -0,0 +1,65 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/networkthreadpool.h"
+
+#include <memory>
+
+#include "rtc_base/gunit.h"
+#include "rtc_base/ipaddress.h"
+
+namespace rtc {
+
+TEST(NetworkThreadPoolTest, EachShardHasItsOwnSocketServer) {
+  NetworkThreadPool pool(3);
+  ASSERT_EQ(3u, pool.size());
+  EXPECT_NE(pool.shard(0)->socketserver(), pool.shard(1)->socketserver());
+  EXPECT_NE(pool.shard(1)->socketserver(), pool.shard(2)->socketserver());
+}
+
+TEST(NetworkThreadPoolTest, RoundRobinSelection) {
+  NetworkThreadPool pool(2);
+  SocketAddress address("127.0.0.1", 0);
+  EXPECT_EQ(pool.shard(0), pool.SelectShard(address));
+  EXPECT_EQ(pool.shard(1), pool.SelectShard(address));
+  EXPECT_EQ(pool.shard(0), pool.SelectShard(address));
+}
+
+class LastShardSelector : public NetworkThreadPool::ShardSelector {
+ public:
+  size_t SelectShard(const SocketAddress& local_address,
+                     size_t num_shards) override {
+    return num_shards - 1;
+  }
+};
+
+TEST(NetworkThreadPoolTest, CustomSelector) {
+  NetworkThreadPool pool(4, std::unique_ptr<NetworkThreadPool::ShardSelector>(
+                                new LastShardSelector()));
+  EXPECT_EQ(pool.shard(3), pool.SelectShard(SocketAddress("127.0.0.1", 0)));
+}
+
+#if defined(WEBRTC_POSIX)
+TEST(NetworkThreadPoolTest, ShardsCanShareAPortWithReusePort) {
+  NetworkThreadPool pool(2);
+  const IPAddress loopback(INADDR_LOOPBACK);
+  std::unique_ptr<AsyncSocket> first(
+      pool.shard(0)->socketserver()->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> second(
+      pool.shard(1)->socketserver()->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, first->SetOption(Socket::OPT_REUSEPORT, 1));
+  ASSERT_EQ(0, second->SetOption(Socket::OPT_REUSEPORT, 1));
+  ASSERT_EQ(0, first->Bind(SocketAddress(loopback, 0)));
+  EXPECT_EQ(0, second->Bind(first->GetLocalAddress()));
+  EXPECT_EQ(first->GetLocalAddress(), second->GetLocalAddress());
+}
+#endif
+
+}  // namespace rtc
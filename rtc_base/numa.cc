@@ -0,0 +1,116 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/numa.h"
+
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <stdlib.h>
+
+#include <utility>
+
+namespace rtc {
+
+namespace {
+
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+// Reads the first line of a sysfs file, without the line break.
+bool ReadSysfsLine(const std::string& path, std::string* line) {
+  FILE* file = fopen(path.c_str(), "r");
+  if (!file)
+    return false;
+  char buffer[1024];
+  const bool success = fgets(buffer, sizeof(buffer), file) != nullptr;
+  fclose(file);
+  if (!success)
+    return false;
+  *line = buffer;
+  while (!line->empty() && (line->back() == '\n' || line->back() == '\r'))
+    line->pop_back();
+  return true;
+}
+#endif
+
+// Larger CPU and node numbers are taken for malformed lists, so that a range
+// can't exhaust the memory.
+constexpr long kMaxNumber = 1 << 16;  // NOLINT
+
+// Parses a non-negative decimal number at |*pos|, and advances |*pos| past it.
+bool ParseNumber(const char** pos, int* value) {
+  char* end = nullptr;
+  const long parsed = strtol(*pos, &end, 10);  // NOLINT
+  if (end == *pos || **pos < '0' || **pos > '9' || parsed > kMaxNumber)
+    return false;
+  *value = static_cast<int>(parsed);
+  *pos = end;
+  return true;
+}
+
+}  // namespace
+
+std::vector<NumaNode> GetNumaNodes() {
+  std::vector<NumaNode> nodes;
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  const std::string kNodeDirectory = "/sys/devices/system/node/";
+  std::string line;
+  if (!ReadSysfsLine(kNodeDirectory + "online", &line))
+    return nodes;
+  for (int id : ParseNumaList(line)) {
+    NumaNode node;
+    node.id = id;
+    // Nodes without CPUs, e.g. of memory only, have an empty list.
+    if (ReadSysfsLine(kNodeDirectory + "node" + std::to_string(id) + "/cpulist",
+                      &line)) {
+      node.cpus = ParseNumaList(line);
+    }
+    nodes.push_back(std::move(node));
+  }
+#endif
+  return nodes;
+}
+
+int CurrentNumaNode() {
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(__NR_getcpu, &cpu, &node, nullptr) == 0)
+    return static_cast<int>(node);
+#endif
+  return 0;
+}
+
+std::vector<int> ParseNumaList(const std::string& list) {
+  std::vector<int> values;
+  const char* pos = list.c_str();
+  while (*pos) {
+    int first = 0;
+    if (!ParseNumber(&pos, &first))
+      return std::vector<int>();
+    int last = first;
+    if (*pos == '-') {
+      ++pos;
+      if (!ParseNumber(&pos, &last) || last < first)
+        return std::vector<int>();
+    }
+    for (int value = first; value <= last; ++value)
+      values.push_back(value);
+    if (*pos == ',' && *(pos + 1))
+      ++pos;
+    else if (*pos)
+      return std::vector<int>();
+  }
+  return values;
+}
+
+}  // namespace rtc
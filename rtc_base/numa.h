@@ -0,0 +1,45 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_NUMA_H_
+#define RTC_BASE_NUMA_H_
+
+#include <string>
+#include <vector>
+
+namespace rtc {
+
+// The NUMA topology of the machine, for keeping the threads and the memory of
+// a session on one node of a multi-socket server. Linux places memory on the
+// node of the thread that first touches it, so threads pinned to the CPUs of
+// one node, e.g. with SetCurrentThreadCpuAffinity() from a
+// ThreadStartObserver, allocate on that node; pools that recycle memory keep
+// it on its node by handing it to threads of the same node.
+struct NumaNode {
+  int id;
+  std::vector<int> cpus;
+};
+
+// Returns the online nodes, or an empty vector if the topology isn't known,
+// which is the case on all platforms but Linux and Android.
+std::vector<NumaNode> GetNumaNodes();
+
+// Returns the node of the CPU that the calling thread runs on, or 0 if it
+// isn't known. Unless the thread is pinned to the CPUs of one node, the node
+// may have changed by the time this returns.
+int CurrentNumaNode();
+
+// Parses a Linux CPU or node list, such as "0-3,8,10-11". Returns an empty
+// vector if |list| is malformed.
+std::vector<int> ParseNumaList(const std::string& list);
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_NUMA_H_
@@ -0,0 +1,47 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <vector>
+
+#include "rtc_base/numa.h"
+#include "test/gtest.h"
+
+namespace rtc {
+
+TEST(NumaTest, ParsesLists) {
+  EXPECT_EQ(std::vector<int>({0}), ParseNumaList("0"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+            ParseNumaList("0-3,8,10-11"));
+  EXPECT_TRUE(ParseNumaList("").empty());
+}
+
+TEST(NumaTest, RejectsMalformedLists) {
+  EXPECT_TRUE(ParseNumaList("0,").empty());
+  EXPECT_TRUE(ParseNumaList("3-1").empty());
+  EXPECT_TRUE(ParseNumaList("-1").empty());
+  EXPECT_TRUE(ParseNumaList("0-").empty());
+  EXPECT_TRUE(ParseNumaList("0 1").empty());
+  EXPECT_TRUE(ParseNumaList("0-100000000").empty());
+}
+
+TEST(NumaTest, CurrentNodeIsOnline) {
+  const std::vector<NumaNode> nodes = GetNumaNodes();
+  const int current = CurrentNumaNode();
+  if (nodes.empty()) {
+    EXPECT_EQ(0, current);
+    return;
+  }
+  bool found = false;
+  for (const NumaNode& node : nodes)
+    found |= node.id == current;
+  EXPECT_TRUE(found);
+}
+
+}  // namespace rtc
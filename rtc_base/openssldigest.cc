@@ -55,6 +55,48 @@ size_t OpenSSLDigest::Finish(void* buf, size_t len) {
   return md_len;
 }
 
+OpenSSLHmac::OpenSSLHmac(const std::string& algorithm,
+                         const void* key,
+                         size_t key_len) {
+  ctx_ = HMAC_CTX_new();
+  RTC_CHECK(ctx_ != nullptr);
+  if (OpenSSLDigest::GetDigestEVP(algorithm, &md_)) {
+    HMAC_Init_ex(ctx_, key, key_len, md_, nullptr);
+  } else {
+    md_ = nullptr;
+  }
+}
+
+OpenSSLHmac::~OpenSSLHmac() {
+  HMAC_CTX_free(ctx_);
+}
+
+size_t OpenSSLHmac::Size() const {
+  if (!md_) {
+    return 0;
+  }
+  return EVP_MD_size(md_);
+}
+
+void OpenSSLHmac::Update(const void* buf, size_t len) {
+  if (!md_) {
+    return;
+  }
+  HMAC_Update(ctx_, static_cast<const unsigned char*>(buf), len);
+}
+
+size_t OpenSSLHmac::Finish(void* buf, size_t len) {
+  if (!md_ || len < Size()) {
+    return 0;
+  }
+  unsigned int md_len;
+  HMAC_Final(ctx_, static_cast<unsigned char*>(buf), &md_len);
+  // Without a key, this restores the states computed from the current one.
+  HMAC_Init_ex(ctx_, nullptr, 0, nullptr, nullptr);
+  RTC_DCHECK(md_len == Size());
+  return md_len;
+}
+
 bool OpenSSLDigest::GetDigestEVP(const std::string& algorithm,
                                  const EVP_MD** mdp) {
   const EVP_MD* md;
@@ -12,6 +12,7 @@
 #define RTC_BASE_OPENSSLDIGEST_H_
 
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
 
 #include "rtc_base/messagedigest.h"
 
@@ -42,6 +43,30 @@ class OpenSSLDigest : public MessageDigest {
   const EVP_MD* md_;
 };
 
+// Computes RFC 2104 HMACs of many messages with one key. The key schedule,
+// i.e. the digest states after the padded key, is computed once and restored
+// for each message, so that an HMAC costs only the hashing of the message and
+// does not allocate.
+class OpenSSLHmac {
+ public:
+  // Keys the HMAC with |key_len| bytes of |key|, using |algorithm| as the hash
+  // algorithm.
+  OpenSSLHmac(const std::string& algorithm, const void* key, size_t key_len);
+  ~OpenSSLHmac();
+  // Returns the HMAC output size, or 0 if |algorithm| is unknown.
+  size_t Size() const;
+  // Updates the HMAC with |len| bytes from |buf|.
+  void Update(const void* buf, size_t len);
+  // Outputs the HMAC of the data since the last Finish() to |buf| with length
+  // |len|, and starts over with the same key. Returns the number of bytes
+  // written, or 0 if |len| is too small.
+  size_t Finish(void* buf, size_t len);
+
+ private:
+  HMAC_CTX* ctx_ = nullptr;
+  const EVP_MD* md_;
+};
+
 }  // namespace rtc
 
 #endif  // RTC_BASE_OPENSSLDIGEST_H_
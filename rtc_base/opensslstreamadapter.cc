@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/openssl.h"
@@ -32,6 +33,7 @@
 #include "rtc_base/openssldigest.h"
 #include "rtc_base/opensslidentity.h"
 #include "rtc_base/stream.h"
+#include "rtc_base/stringencode.h"
 #include "rtc_base/stringutils.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/timeutils.h"
@@ -262,6 +264,43 @@ static long stream_ctrl(BIO* b, int cmd, long num, void* ptr) {
   }
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// DTLS session cache
+/////////////////////////////////////////////////////////////////////////////
+
+// The length of the session ticket keys given to
+// SSL_CTX_set_tlsext_ticket_keys.
+#if defined(OPENSSL_IS_BORINGSSL) || (OPENSSL_VERSION_NUMBER < 0x10101000L)
+static const size_t kTicketKeysLength = 48;
+#else
+static const size_t kTicketKeysLength = 80;
+#endif
+
+static CriticalSection* GetDtlsSessionCacheLock() {
+  static CriticalSection* const lock = new CriticalSection();
+  return lock;
+}
+
+// Returns the cache of the sessions of the adapters with session resumption
+// enabled, which may run on any thread, so it must only be used with
+// GetDtlsSessionCacheLock() held. Its SSL_CTX holds the session ticket keys,
+// which the servers share to resume the sessions of each other's tickets.
+// Like the keys, the cache lives as long as the process.
+static OpenSSLSessionCache* GetDtlsSessionCache() {
+  static OpenSSLSessionCache* const cache = [] {
+    SSL_CTX* ctx = SSL_CTX_new(DTLS_method());
+    RTC_CHECK(ctx);
+    unsigned char keys[kTicketKeysLength];
+    RTC_CHECK_EQ(1, RAND_bytes(keys, sizeof(keys)));
+    RTC_CHECK(SSL_CTX_set_tlsext_ticket_keys(ctx, keys, sizeof(keys)));
+    OpenSSLSessionCache* cache = new OpenSSLSessionCache(SSL_MODE_DTLS, ctx);
+    // The cache holds its own reference.
+    SSL_CTX_free(ctx);
+    return cache;
+  }();
+  return cache;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // OpenSSLStreamAdapter
 /////////////////////////////////////////////////////////////////////////////
@@ -469,6 +508,10 @@ bool OpenSSLStreamAdapter::IsTlsConnected() {
   return state_ == SSL_CONNECTED;
 }
 
+bool OpenSSLStreamAdapter::IsSessionResumed() const {
+  return state_ == SSL_CONNECTED && SSL_session_reused(ssl_);
+}
+
 int OpenSSLStreamAdapter::StartSSL() {
   if (state_ != SSL_NONE) {
     // Don't allow StartSSL to be called twice.
@@ -786,6 +829,21 @@ int OpenSSLStreamAdapter::BeginSSL() {
   SSL_set_app_data(ssl_, this);
 
   SSL_set_bio(ssl_, bio, bio);  // the SSL object owns the bio now.
+
+  if (session_resumption_enabled() && ssl_mode_ == SSL_MODE_DTLS) {
+    // Without the peer certificate digest, there is no way to tell whether a
+    // session was negotiated with this peer.
+    session_cache_key_ = GetSessionCacheKey();
+    if (role_ == SSL_CLIENT && !session_cache_key_.empty()) {
+      CritScope cs(GetDtlsSessionCacheLock());
+      SSL_SESSION* cached =
+          GetDtlsSessionCache()->LookupSession(session_cache_key_);
+      if (cached && SSL_set_session(ssl_, cached) == 0) {
+        RTC_LOG(LS_WARNING) << "Failed to apply SSL session from cache";
+      }
+    }
+  }
+
   if (ssl_mode_ == SSL_MODE_DTLS) {
 #ifdef OPENSSL_IS_BORINGSSL
     DTLSv1_set_initial_timeout_duration(ssl_, dtls_handshake_timeout_ms_);
@@ -828,6 +886,10 @@ int OpenSSLStreamAdapter::ContinueSSL() {
   switch (ssl_error = SSL_get_error(ssl_, code)) {
     case SSL_ERROR_NONE:
       RTC_LOG(LS_VERBOSE) << " -- success";
+      if (!peer_cert_chain_ && SSL_session_reused(ssl_) &&
+          !RestorePeerCertificate()) {
+        return -1;
+      }
       // By this point, OpenSSL should have given us a certificate, or errored
       // out if one was missing.
       RTC_DCHECK(peer_cert_chain_ || !client_auth_enabled());
@@ -1054,6 +1116,11 @@ SSL_CTX* OpenSSLStreamAdapter::SetupSSLContext() {
     }
   }
 
+  if (session_resumption_enabled() && !ConfigureSessionResumption(ctx)) {
+    SSL_CTX_free(ctx);
+    return nullptr;
+  }
+
   return ctx;
 }
 
@@ -1131,6 +1198,83 @@ int OpenSSLStreamAdapter::SSLVerifyCallback(X509_STORE_CTX* store, void* arg) {
   return 1;
 }
 
+std::string OpenSSLStreamAdapter::GetSessionCacheKey() const {
+  if (!identity_ || !has_peer_certificate_digest()) {
+    return std::string();
+  }
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  size_t digest_length;
+  if (!identity_->certificate().ComputeDigest(DIGEST_SHA_256, digest,
+                                              sizeof(digest), &digest_length)) {
+    return std::string();
+  }
+  return hex_encode(reinterpret_cast<const char*>(digest), digest_length) +
+         " " + peer_certificate_digest_algorithm_ + " " +
+         hex_encode(peer_certificate_digest_value_.data<char>(),
+                    peer_certificate_digest_value_.size());
+}
+
+bool OpenSSLStreamAdapter::ConfigureSessionResumption(SSL_CTX* ctx) {
+  // Only the DTLS sessions are shared.
+  if (ssl_mode_ != SSL_MODE_DTLS || !identity_) {
+    return true;
+  }
+  // Servers only resume the sessions of their own certificate.
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  size_t digest_length;
+  if (!identity_->certificate().ComputeDigest(DIGEST_SHA_256, digest,
+                                              sizeof(digest), &digest_length) ||
+      digest_length > SSL_MAX_SID_CTX_LENGTH ||
+      !SSL_CTX_set_session_id_context(ctx, digest, digest_length)) {
+    return false;
+  }
+  unsigned char keys[kTicketKeysLength];
+  {
+    CritScope cs(GetDtlsSessionCacheLock());
+    if (!SSL_CTX_get_tlsext_ticket_keys(
+            GetDtlsSessionCache()->GetSSLContext(), keys, sizeof(keys))) {
+      return false;
+    }
+  }
+  if (!SSL_CTX_set_tlsext_ticket_keys(ctx, keys, sizeof(keys))) {
+    return false;
+  }
+  // The sessions are resumed with tickets, so the servers don't need to cache
+  // them. The clients keep them in the shared cache only, as the sessions
+  // that the context stores are made unresumable when it is freed.
+  SSL_CTX_set_session_cache_mode(
+      ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(ctx, &OpenSSLStreamAdapter::NewSSLSessionCallback);
+  return true;
+}
+
+bool OpenSSLStreamAdapter::RestorePeerCertificate() {
+  X509* cert = SSL_get_peer_certificate(ssl_);
+  if (!cert) {
+    RTC_LOG(LS_WARNING) << "Resumed session has no peer certificate.";
+    return false;
+  }
+  peer_cert_chain_.reset(new SSLCertChain(new OpenSSLCertificate(cert)));
+  X509_free(cert);
+  if (peer_certificate_digest_algorithm_.empty()) {
+    return true;
+  }
+  return VerifyPeerCertificate();
+}
+
+int OpenSSLStreamAdapter::NewSSLSessionCallback(SSL* ssl,
+                                                SSL_SESSION* session) {
+  OpenSSLStreamAdapter* stream =
+      reinterpret_cast<OpenSSLStreamAdapter*>(SSL_get_app_data(ssl));
+  if (stream->session_cache_key_.empty()) {
+    return 0;  // OpenSSL should free the session.
+  }
+  RTC_LOG(LS_INFO) << "Caching DTLS session";
+  CritScope cs(GetDtlsSessionCacheLock());
+  GetDtlsSessionCache()->AddSession(stream->session_cache_key_, session);
+  return 1;  // We've taken ownership of the session; OpenSSL shouldn't free it.
+}
+
 bool OpenSSLStreamAdapter::IsBoringSsl() {
 #ifdef OPENSSL_IS_BORINGSSL
   return true;
@@ -1215,3 +1359,4 @@ void OpenSSLStreamAdapter::enable_time_callback_for_testing() {
 }
 
 }  // namespace rtc
+
@@ -19,6 +19,7 @@
 
 #include "rtc_base/buffer.h"
 #include "rtc_base/opensslidentity.h"
+#include "rtc_base/opensslsessioncache.h"
 #include "rtc_base/sslstreamadapter.h"
 
 namespace rtc {
@@ -106,6 +107,7 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   bool GetDtlsSrtpCryptoSuite(int* crypto_suite) override;
 
   bool IsTlsConnected() override;
+  bool IsSessionResumed() const override;
 
   // Capabilities interfaces.
   static bool IsBoringSsl();
@@ -170,6 +172,18 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   // SSL_CTX_set_cert_verify_callback.
   static int SSLVerifyCallback(X509_STORE_CTX* store, void* arg);
 
+  // Session resumption. The sessions are cached by local certificate and
+  // peer certificate digest, so a session is only offered to the peer that it
+  // was negotiated with.
+  std::string GetSessionCacheKey() const;
+  // Sets up |ctx| to take part in the resumption of the shared sessions.
+  bool ConfigureSessionResumption(SSL_CTX* ctx);
+  // Records the peer certificate of a resumed session, for which the
+  // verification callback is not called, and verifies it if the digest is
+  // known.
+  bool RestorePeerCertificate();
+  static int NewSSLSessionCallback(SSL* ssl, SSL_SESSION* session);
+
   bool waiting_to_verify_peer_certificate() const {
     return client_auth_enabled() && !peer_certificate_verified_;
   }
@@ -199,6 +213,9 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   // The digest of the certificate that the peer must present.
   Buffer peer_certificate_digest_value_;
   std::string peer_certificate_digest_algorithm_;
+  // The key of the session in the shared cache, set when the handshake
+  // starts. Empty if the session is not cached.
+  std::string session_cache_key_;
 
   // The DtlsSrtp ciphers
   std::string srtp_ciphers_;
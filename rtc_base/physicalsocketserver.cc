@@ -91,6 +91,17 @@ int64_t GetSocketRecvTimestamp(int socket) {
 typedef char* SockOptArg;
 #endif
 
+#if defined(WEBRTC_LINUX)
+#include <netinet/udp.h>
+// UDP_SEGMENT is only defined starting with Linux 4.18 headers.
+#if !defined(SOL_UDP)
+#define SOL_UDP 17
+#endif
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#endif  // WEBRTC_LINUX
+
 #if defined(WEBRTC_USE_EPOLL)
 // POLLRDHUP / EPOLLRDHUP are only defined starting with Linux 2.6.17.
 #if !defined(POLLRDHUP)
@@ -365,6 +376,122 @@ int PhysicalSocket::SendTo(const void* buffer,
   return sent;
 }
 
+#if defined(WEBRTC_LINUX)
+namespace {
+// Kernel limits for a single UDP_SEGMENT send.
+const size_t kMaxGsoSegments = 64;
+const size_t kMaxGsoBytes = 0xffff - 8 - 40;
+}  // namespace
+
+int PhysicalSocket::SendToBatch(const OutgoingDatagram* datagrams,
+                                size_t count) {
+  if (!udp_)
+    return AsyncSocket::SendToBatch(datagrams, count);
+  if (count == 0)
+    return 0;
+  if (CanSendWithGso(datagrams, count)) {
+    int sent = SendWithGso(datagrams, count);
+    if (sent >= 0 || gso_supported_)
+      return sent;
+    // GSO was rejected; fall through and send the datagrams one by one.
+  }
+  return SendWithSendmmsg(datagrams, count);
+}
+
+bool PhysicalSocket::CanSendWithGso(const OutgoingDatagram* datagrams,
+                                    size_t count) const {
+  if (!gso_supported_ || count < 2 || count > kMaxGsoSegments)
+    return false;
+  const size_t segment_size = datagrams[0].size;
+  if (segment_size == 0 || segment_size * count > kMaxGsoBytes)
+    return false;
+  for (size_t i = 1; i < count; ++i) {
+    if (datagrams[i].remote_address != datagrams[0].remote_address)
+      return false;
+    // Every segment except the last one must have the same size.
+    if (datagrams[i].size > segment_size ||
+        (i + 1 < count && datagrams[i].size != segment_size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int PhysicalSocket::SendWithGso(const OutgoingDatagram* datagrams,
+                                size_t count) {
+  if (send_iovecs_.size() < count)
+    send_iovecs_.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    send_iovecs_[i].iov_base = const_cast<void*>(datagrams[i].data);
+    send_iovecs_[i].iov_len = datagrams[i].size;
+  }
+  sockaddr_storage saddr;
+  size_t len = datagrams[0].remote_address.ToSockAddrStorage(&saddr);
+
+  char control[CMSG_SPACE(sizeof(uint16_t))] = {0};
+  struct msghdr hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.msg_name = &saddr;
+  hdr.msg_namelen = static_cast<socklen_t>(len);
+  hdr.msg_iov = send_iovecs_.data();
+  hdr.msg_iovlen = count;
+  hdr.msg_control = control;
+  hdr.msg_controllen = sizeof(control);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  uint16_t segment_size = static_cast<uint16_t>(datagrams[0].size);
+  memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+
+  int sent = ::sendmsg(s_, &hdr, MSG_NOSIGNAL);
+  UpdateLastError();
+  if (sent < 0) {
+    int error = GetError();
+    if (error == EIO || error == EINVAL || error == ENOPROTOOPT) {
+      // EIO means the egress device can't checksum the segments, the others
+      // that the kernel predates UDP_SEGMENT. Either way, stop trying.
+      RTC_LOG(LS_INFO) << "UDP GSO not available, error " << error;
+      gso_supported_ = false;
+    } else if (IsBlockingError(error)) {
+      EnableEvents(DE_WRITE);
+    }
+    return -1;
+  }
+  return static_cast<int>(count);
+}
+
+int PhysicalSocket::SendWithSendmmsg(const OutgoingDatagram* datagrams,
+                                     size_t count) {
+  if (send_msgs_.size() < count) {
+    send_msgs_.resize(count);
+    send_iovecs_.resize(count);
+    send_addrs_.resize(count);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    send_iovecs_[i].iov_base = const_cast<void*>(datagrams[i].data);
+    send_iovecs_[i].iov_len = datagrams[i].size;
+    size_t len = datagrams[i].remote_address.ToSockAddrStorage(&send_addrs_[i]);
+    struct msghdr& hdr = send_msgs_[i].msg_hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = &send_addrs_[i];
+    hdr.msg_namelen = static_cast<socklen_t>(len);
+    hdr.msg_iov = &send_iovecs_[i];
+    hdr.msg_iovlen = 1;
+    send_msgs_[i].msg_len = 0;
+  }
+  int sent = ::sendmmsg(s_, send_msgs_.data(), static_cast<unsigned>(count),
+                        MSG_NOSIGNAL);
+  UpdateLastError();
+  MaybeRemapSendError();
+  if ((sent >= 0 && sent < static_cast<int>(count)) ||
+      (sent < 0 && IsBlockingError(GetError()))) {
+    EnableEvents(DE_WRITE);
+  }
+  return sent;
+}
+#endif  // WEBRTC_LINUX
+
 int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
   int received =
       ::recv(s_, static_cast<char*>(buffer), static_cast<int>(length), 0);
@@ -420,6 +547,71 @@ int PhysicalSocket::RecvFrom(void* buffer,
   return received;
 }
 
+#if defined(WEBRTC_LINUX)
+int PhysicalSocket::RecvFromBatch(ReceivedDatagram* datagrams, size_t count) {
+  if (!udp_)
+    return AsyncSocket::RecvFromBatch(datagrams, count);
+  if (count == 0)
+    return 0;
+  if (!recv_timestamps_enabled_) {
+    // With recvmmsg() SIOCGSTAMP only reports the time of the last datagram,
+    // so ask the kernel to attach a timestamp to every datagram instead.
+    int value = 1;
+    ::setsockopt(s_, SOL_SOCKET, SO_TIMESTAMP, &value, sizeof(value));
+    recv_timestamps_enabled_ = true;
+  }
+
+  const size_t kControlSize = CMSG_SPACE(sizeof(struct timeval));
+  if (recv_msgs_.size() < count) {
+    recv_msgs_.resize(count);
+    recv_iovecs_.resize(count);
+    recv_addrs_.resize(count);
+    recv_control_.resize(count * kControlSize);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    recv_iovecs_[i].iov_base = datagrams[i].buffer;
+    recv_iovecs_[i].iov_len = datagrams[i].buffer_size;
+    struct msghdr& hdr = recv_msgs_[i].msg_hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = &recv_addrs_[i];
+    hdr.msg_namelen = sizeof(recv_addrs_[i]);
+    hdr.msg_iov = &recv_iovecs_[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = &recv_control_[i * kControlSize];
+    hdr.msg_controllen = kControlSize;
+    recv_msgs_[i].msg_len = 0;
+  }
+
+  int received = ::recvmmsg(s_, recv_msgs_.data(), static_cast<unsigned>(count),
+                            0, nullptr);
+  UpdateLastError();
+  int error = GetError();
+  bool success = (received >= 0) || IsBlockingError(error);
+  EnableEvents(DE_READ);
+  if (!success) {
+    RTC_LOG_F(LS_VERBOSE) << "Error = " << error;
+  }
+  for (int i = 0; i < received; ++i) {
+    ReceivedDatagram& datagram = datagrams[i];
+    struct msghdr& hdr = recv_msgs_[i].msg_hdr;
+    datagram.size = recv_msgs_[i].msg_len;
+    SocketAddressFromSockAddrStorage(recv_addrs_[i], &datagram.remote_address);
+    datagram.timestamp = -1;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP) {
+        struct timeval tv;
+        memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+        datagram.timestamp =
+            rtc::kNumMicrosecsPerSec * static_cast<int64_t>(tv.tv_sec) +
+            static_cast<int64_t>(tv.tv_usec);
+      }
+    }
+  }
+  return received;
+}
+#endif  // WEBRTC_LINUX
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
@@ -563,6 +755,24 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
       return -1;
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
+    case OPT_REUSEPORT:
+#if defined(SO_REUSEPORT)
+      *slevel = SOL_SOCKET;
+      *sopt = SO_REUSEPORT;
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+      return -1;
+#endif
+    case OPT_TCP_NOTSENT_LOWAT:
+#if defined(TCP_NOTSENT_LOWAT)
+      *slevel = IPPROTO_TCP;
+      *sopt = TCP_NOTSENT_LOWAT;
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_TCP_NOTSENT_LOWAT not supported.";
+      return -1;
+#endif
     default:
       RTC_NOTREACHED();
       return -1;
@@ -1336,10 +1546,10 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
   return WaitSelect(cmsWait, process_io);
 }
 
-static void ProcessEvents(Dispatcher* dispatcher,
-                          bool readable,
-                          bool writable,
-                          bool check_error) {
+void PhysicalSocketServer::ProcessEvents(Dispatcher* dispatcher,
+                                         bool readable,
+                                         bool writable,
+                                         bool check_error) {
   int errcode = 0;
   // TODO(pthatcher): Should we set errcode if getsockopt fails?
   if (check_error) {
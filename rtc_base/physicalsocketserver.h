@@ -77,9 +77,11 @@ class PhysicalSocketServer : public SocketServer {
   bool Wait(int cms, bool process_io) override;
   void WakeUp() override;
 
-  void Add(Dispatcher* dispatcher);
-  void Remove(Dispatcher* dispatcher);
-  void Update(Dispatcher* dispatcher);
+  // Virtual so that subclasses can use a different event notification
+  // mechanism (see IoUringSocketServer).
+  virtual void Add(Dispatcher* dispatcher);
+  virtual void Remove(Dispatcher* dispatcher);
+  virtual void Update(Dispatcher* dispatcher);
 
 #if defined(WEBRTC_POSIX)
   // Sets the function to be executed in response to the specified POSIX signal.
@@ -96,6 +98,13 @@ class PhysicalSocketServer : public SocketServer {
 
  protected:
   Dispatcher* signal_dispatcher();
+
+  // Translates the readiness of |dispatcher|'s descriptor into DE_* events
+  // and delivers them.
+  static void ProcessEvents(Dispatcher* dispatcher,
+                            bool readable,
+                            bool writable,
+                            bool check_error);
 #endif
 
  private:
@@ -157,12 +166,22 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   int SendTo(const void* buffer,
              size_t length,
              const SocketAddress& addr) override;
+#if defined(WEBRTC_LINUX)
+  // Uses UDP generic segmentation offload when all datagrams go to the same
+  // destination and have the same size (the last one may be shorter), and
+  // sendmmsg() otherwise.
+  int SendToBatch(const OutgoingDatagram* datagrams, size_t count) override;
+#endif
 
   int Recv(void* buffer, size_t length, int64_t* timestamp) override;
   int RecvFrom(void* buffer,
                size_t length,
                SocketAddress* out_addr,
                int64_t* timestamp) override;
+#if defined(WEBRTC_LINUX)
+  // Uses recvmmsg() to read several datagrams with a single system call.
+  int RecvFromBatch(ReceivedDatagram* datagrams, size_t count) override;
+#endif
 
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
@@ -200,6 +219,13 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 
   static int TranslateOption(Option opt, int* slevel, int* sopt);
 
+#if defined(WEBRTC_LINUX)
+  // Helpers for SendToBatch().
+  bool CanSendWithGso(const OutgoingDatagram* datagrams, size_t count) const;
+  int SendWithGso(const OutgoingDatagram* datagrams, size_t count);
+  int SendWithSendmmsg(const OutgoingDatagram* datagrams, size_t count);
+#endif
+
   PhysicalSocketServer* ss_;
   SOCKET s_;
   bool udp_;
@@ -214,6 +240,20 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
 
  private:
   uint8_t enabled_events_ = 0;
+#if defined(WEBRTC_LINUX)
+  // Scratch storage for RecvFromBatch(), reused between calls.
+  std::vector<struct mmsghdr> recv_msgs_;
+  std::vector<struct iovec> recv_iovecs_;
+  std::vector<sockaddr_storage> recv_addrs_;
+  std::vector<char> recv_control_;
+  bool recv_timestamps_enabled_ = false;
+  // Scratch storage for SendToBatch(), reused between calls.
+  std::vector<struct mmsghdr> send_msgs_;
+  std::vector<struct iovec> send_iovecs_;
+  std::vector<sockaddr_storage> send_addrs_;
+  // Cleared if the kernel or device rejects UDP_SEGMENT.
+  bool gso_supported_ = true;
+#endif
 };
 
 class SocketDispatcher : public Dispatcher, public PhysicalSocket {
@@ -12,6 +12,7 @@
 #include <stdarg.h>
 #include <memory>
 
+#include "rtc_base/arraysize.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/networkmonitor.h"
@@ -457,6 +458,101 @@ TEST_F(PhysicalSocketTest, TestSocketRecvTimestampIPv6) {
 }
 #endif
 
+#if defined(WEBRTC_LINUX)
+TEST_F(PhysicalSocketTest, RecvFromBatchReadsAllPendingDatagrams) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> socket(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SocketAddress address = socket->GetLocalAddress();
+
+  EXPECT_EQ(1, socket->SendTo("a", 1, address));
+  EXPECT_EQ(2, socket->SendTo("bb", 2, address));
+  EXPECT_EQ(3, socket->SendTo("ccc", 3, address));
+
+  char buffers[4][16];
+  ReceivedDatagram datagrams[4];
+  for (size_t i = 0; i < arraysize(datagrams); ++i) {
+    datagrams[i].buffer = buffers[i];
+    datagrams[i].buffer_size = sizeof(buffers[i]);
+  }
+  ASSERT_EQ(3, socket->RecvFromBatch(datagrams, arraysize(datagrams)));
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(i + 1, datagrams[i].size);
+    EXPECT_EQ(address, datagrams[i].remote_address);
+    EXPECT_GT(datagrams[i].timestamp, -1);
+  }
+  EXPECT_EQ(0, memcmp("bb", buffers[1], 2));
+
+  // Nothing left to read.
+  EXPECT_EQ(-1, socket->RecvFromBatch(datagrams, arraysize(datagrams)));
+  EXPECT_TRUE(socket->IsBlocking());
+}
+
+// Equal-sized datagrams to a single destination take the UDP GSO path (when
+// the kernel supports it) and must still arrive as separate datagrams.
+TEST_F(PhysicalSocketTest, SendToBatchSameDestination) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> socket(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SocketAddress address = socket->GetLocalAddress();
+
+  OutgoingDatagram outgoing[3];
+  outgoing[0].data = "aaaa";
+  outgoing[1].data = "bbbb";
+  outgoing[2].data = "cc";
+  for (size_t i = 0; i < arraysize(outgoing); ++i) {
+    outgoing[i].size = strlen(static_cast<const char*>(outgoing[i].data));
+    outgoing[i].remote_address = address;
+  }
+  EXPECT_EQ(3, socket->SendToBatch(outgoing, arraysize(outgoing)));
+
+  char buffers[4][16];
+  ReceivedDatagram datagrams[4];
+  for (size_t i = 0; i < arraysize(datagrams); ++i) {
+    datagrams[i].buffer = buffers[i];
+    datagrams[i].buffer_size = sizeof(buffers[i]);
+  }
+  ASSERT_EQ(3, socket->RecvFromBatch(datagrams, arraysize(datagrams)));
+  EXPECT_EQ(4u, datagrams[0].size);
+  EXPECT_EQ(4u, datagrams[1].size);
+  EXPECT_EQ(2u, datagrams[2].size);
+  EXPECT_EQ(0, memcmp("bbbb", buffers[1], 4));
+  EXPECT_EQ(0, memcmp("cc", buffers[2], 2));
+}
+
+TEST_F(PhysicalSocketTest, SendToBatchMultipleDestinations) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> receiver1(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> receiver2(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, receiver1->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, receiver2->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  OutgoingDatagram outgoing[2];
+  outgoing[0].data = "one";
+  outgoing[0].size = 3;
+  outgoing[0].remote_address = receiver1->GetLocalAddress();
+  outgoing[1].data = "two";
+  outgoing[1].size = 3;
+  outgoing[1].remote_address = receiver2->GetLocalAddress();
+  EXPECT_EQ(2, sender->SendToBatch(outgoing, arraysize(outgoing)));
+
+  char buffer[16];
+  SocketAddress from;
+  EXPECT_EQ(3, receiver1->RecvFrom(buffer, sizeof(buffer), &from, nullptr));
+  EXPECT_EQ(0, memcmp("one", buffer, 3));
+  EXPECT_EQ(sender->GetLocalAddress(), from);
+  EXPECT_EQ(3, receiver2->RecvFrom(buffer, sizeof(buffer), &from, nullptr));
+  EXPECT_EQ(0, memcmp("two", buffer, 3));
+}
+#endif
+
 // Verify that if the socket was unable to be bound to a real network interface
 // (not loopback), Bind will return an error.
 TEST_F(PhysicalSocketTest,
@@ -13,9 +13,12 @@
 #include "rtc_base/atomicops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/timeutils.h"
+#include "rtc_base/virtual_time.h"
 
-#if defined(WEBRTC_LINUX)
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+#include <sched.h>
 #include <sys/prctl.h>
+#include <sys/resource.h>
 #include <sys/syscall.h>
 #endif
 
@@ -33,7 +36,66 @@ struct ThreadAttributes {
   pthread_attr_t attr;
 };
 #endif  // defined(WEBRTC_WIN)
+
+#if defined(WEBRTC_WIN)
+bool SetPriorityOfThread(HANDLE thread, ThreadPriority priority) {
+  return ::SetThreadPriority(thread, priority) != FALSE;
+}
+#else
+bool SetPriorityOfThread(pthread_t thread, ThreadPriority priority) {
+#if defined(__native_client__) || defined(WEBRTC_FUCHSIA)
+  // Setting thread priorities is not supported in NaCl or Fuchsia.
+  return true;
+#elif defined(WEBRTC_CHROMIUM_BUILD) && defined(WEBRTC_LINUX)
+  // TODO(tommi): Switch to the same mechanism as Chromium uses for changing
+  // thread priorities.
+  return true;
+#else
+#ifdef WEBRTC_THREAD_RR
+  const int policy = SCHED_RR;
+#else
+  const int policy = SCHED_FIFO;
+#endif
+  const int min_prio = sched_get_priority_min(policy);
+  const int max_prio = sched_get_priority_max(policy);
+  if (min_prio == -1 || max_prio == -1) {
+    return false;
+  }
+
+  if (max_prio - min_prio <= 2)
+    return false;
+
+  // Convert webrtc priority to system priorities:
+  sched_param param;
+  const int top_prio = max_prio - 1;
+  const int low_prio = min_prio + 1;
+  switch (priority) {
+    case kLowPriority:
+      param.sched_priority = low_prio;
+      break;
+    case kNormalPriority:
+      // The -1 ensures that the kHighPriority is always greater or equal to
+      // kNormalPriority.
+      param.sched_priority = (low_prio + top_prio - 1) / 2;
+      break;
+    case kHighPriority:
+      param.sched_priority = std::max(top_prio - 2, low_prio);
+      break;
+    case kHighestPriority:
+      param.sched_priority = std::max(top_prio - 1, low_prio);
+      break;
+    case kRealtimePriority:
+      param.sched_priority = top_prio;
+      break;
+  }
+  return pthread_setschedparam(thread, policy, &param) == 0;
+#endif
 }
+#endif  // defined(WEBRTC_WIN)
+
+ThreadStartObserver* volatile g_thread_start_observer = nullptr;
+
+}  // namespace
 
 PlatformThread::PlatformThread(ThreadRunFunctionDeprecated func,
                                void* obj,
@@ -86,6 +148,9 @@ void* PlatformThread::StartThread(void* param) {
 void PlatformThread::Start() {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   RTC_DCHECK(!thread_) << "Thread already started?";
+  virtual_time_ = VirtualTimeController::Get();
+  if (virtual_time_)
+    virtual_time_->AddThread();
 #if defined(WEBRTC_WIN)
   stop_ = false;
 
@@ -157,12 +222,15 @@ void PlatformThread::Run() {
   // Attach the worker thread checker to this thread.
   RTC_DCHECK(spawned_thread_checker_.CalledOnValidThread());
   rtc::SetCurrentThreadName(name_.c_str());
+  VirtualTimeController::ThreadScope virtual_time_scope(virtual_time_);
 
   if (run_function_) {
     SetPriority(priority_);
+    NotifyThreadStarted(name_.c_str());
     run_function_(obj_);
     return;
   }
+  NotifyThreadStarted(name_.c_str());
 
 // TODO(tommi): Delete the rest of this function when looping isn't supported.
 #if RTC_DCHECK_IS_ON
@@ -184,7 +252,9 @@ void PlatformThread::Run() {
       break;
 #if RTC_DCHECK_IS_ON
     auto id = sequence_nr % kMaxLoopCount;
-    loop_stamps[id] = rtc::TimeMillis();
+    // On the system clock, so that a fake or virtual clock standing still
+    // isn't taken for a busy loop.
+    loop_stamps[id] = rtc::SystemTimeMillis();
     if (sequence_nr > kMaxLoopCount) {
       auto compare_id = (id + 1) % kMaxLoopCount;
       auto diff = loop_stamps[id] - loop_stamps[compare_id];
@@ -228,55 +298,7 @@ bool PlatformThread::SetPriority(ThreadPriority priority) {
   }
 #endif
 
-#if defined(WEBRTC_WIN)
-  return SetThreadPriority(thread_, priority) != FALSE;
-#elif defined(__native_client__) || defined(WEBRTC_FUCHSIA)
-  // Setting thread priorities is not supported in NaCl or Fuchsia.
-  return true;
-#elif defined(WEBRTC_CHROMIUM_BUILD) && defined(WEBRTC_LINUX)
-  // TODO(tommi): Switch to the same mechanism as Chromium uses for changing
-  // thread priorities.
-  return true;
-#else
-#ifdef WEBRTC_THREAD_RR
-  const int policy = SCHED_RR;
-#else
-  const int policy = SCHED_FIFO;
-#endif
-  const int min_prio = sched_get_priority_min(policy);
-  const int max_prio = sched_get_priority_max(policy);
-  if (min_prio == -1 || max_prio == -1) {
-    return false;
-  }
-
-  if (max_prio - min_prio <= 2)
-    return false;
-
-  // Convert webrtc priority to system priorities:
-  sched_param param;
-  const int top_prio = max_prio - 1;
-  const int low_prio = min_prio + 1;
-  switch (priority) {
-    case kLowPriority:
-      param.sched_priority = low_prio;
-      break;
-    case kNormalPriority:
-      // The -1 ensures that the kHighPriority is always greater or equal to
-      // kNormalPriority.
-      param.sched_priority = (low_prio + top_prio - 1) / 2;
-      break;
-    case kHighPriority:
-      param.sched_priority = std::max(top_prio - 2, low_prio);
-      break;
-    case kHighestPriority:
-      param.sched_priority = std::max(top_prio - 1, low_prio);
-      break;
-    case kRealtimePriority:
-      param.sched_priority = top_prio;
-      break;
-  }
-  return pthread_setschedparam(thread_, policy, &param) == 0;
-#endif  // defined(WEBRTC_WIN)
+  return SetPriorityOfThread(thread_, priority);
 }
 
 #if defined(WEBRTC_WIN)
@@ -288,4 +310,48 @@ bool PlatformThread::QueueAPC(PAPCFUNC function, ULONG_PTR data) {
 }
 #endif
 
+void SetThreadStartObserver(ThreadStartObserver* observer) {
+  AtomicOps::ReleaseStorePtr(&g_thread_start_observer, observer);
+}
+
+void NotifyThreadStarted(const char* name) {
+  ThreadStartObserver* observer =
+      AtomicOps::AcquireLoadPtr(&g_thread_start_observer);
+  if (observer)
+    observer->OnThreadStarted(name);
+}
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+#if defined(WEBRTC_WIN)
+  return SetPriorityOfThread(GetCurrentThread(), priority);
+#else
+  return SetPriorityOfThread(pthread_self(), priority);
+#endif
+}
+
+bool SetCurrentThreadCpuAffinity(const std::vector<int>& cpus) {
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+      return false;
+    CPU_SET(cpu, &cpu_set);
+  }
+  // A pid of 0 is the calling thread.
+  return !cpus.empty() && sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
+bool SetCurrentThreadNiceValue(int nice_value) {
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+  // Linux applies the nice value of a "process" to the thread with that id.
+  return setpriority(PRIO_PROCESS, CurrentThreadId(), nice_value) == 0;
+#else
+  return false;
+#endif
+}
+
 }  // namespace rtc
@@ -12,6 +12,7 @@
 #define RTC_BASE_PLATFORM_THREAD_H_
 
 #include <string>
+#include <vector>
 
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/event.h"
@@ -20,6 +21,8 @@
 
 namespace rtc {
 
+class VirtualTimeController;
+
 // Callback function that the spawned thread will enter once spawned.
 // A return value of false is interpreted as that the function has no
 // more work to do and that the thread can be released.
@@ -42,6 +45,37 @@ enum ThreadPriority {
 #endif
 };
 
+// Lets embedders configure the threads that WebRTC starts, e.g. to pin audio
+// and pacing threads to CPUs of their own, or to give them real-time
+// scheduling. It is called on every thread that a PlatformThread or an
+// rtc::Thread starts, which includes the network, worker and signaling
+// threads, task queues, process threads and decoder threads. It is called on
+// the new thread, once it is named, before it runs anything else. Threads with
+// a PlatformThread::SetPriority() priority have it set by then, unless they
+// use the deprecated run function.
+class ThreadStartObserver {
+ public:
+  virtual void OnThreadStarted(const char* name) = 0;
+
+ protected:
+  virtual ~ThreadStartObserver() {}
+};
+
+// Sets the observer of the threads that start from now on, or clears it if
+// |observer| is null. The observer must outlive the threads.
+void SetThreadStartObserver(ThreadStartObserver* observer);
+// Calls the observer, if any. For the threads of rtc_base.
+void NotifyThreadStarted(const char* name);
+
+// Helpers for observers. They return false if the platform doesn't support
+// the setting, or refuses it, e.g. for lack of privileges.
+bool SetCurrentThreadPriority(ThreadPriority priority);
+// Restricts the current thread to run on |cpus|. Linux and Android only.
+bool SetCurrentThreadCpuAffinity(const std::vector<int>& cpus);
+// Sets the nice value of the current thread, which Linux and Android apply per
+// thread. It only matters to threads without a real-time priority.
+bool SetCurrentThreadNiceValue(int nice_value);
+
 // Represents a simple worker thread.  The implementation must be assumed
 // to be single threaded, meaning that all methods of the class, must be
 // called from the same thread, including instantiation.
@@ -93,6 +127,9 @@ class PlatformThread {
   const std::string name_;
   rtc::ThreadChecker thread_checker_;
   rtc::ThreadChecker spawned_thread_checker_;
+  // The controller the thread takes part in, if it was started on virtual
+  // time.
+  VirtualTimeController* virtual_time_ = nullptr;
 #if defined(WEBRTC_WIN)
   static DWORD WINAPI StartThread(void* param);
 
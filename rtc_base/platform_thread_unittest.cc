@@ -10,6 +10,11 @@
 
 #include "rtc_base/platform_thread.h"
 
+#include <string>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+
 #include "system_wrappers/include/sleep.h"
 #include "test/gtest.h"
 
@@ -41,6 +46,36 @@ void SetFlagRunFunction(void* obj) {
   *obj_as_bool = true;
 }
 
+void SaveThreadRefRunFunction(void* obj) {
+  *static_cast<PlatformThreadRef*>(obj) = CurrentThreadRef();
+}
+
+class RecordingThreadStartObserver : public ThreadStartObserver {
+ public:
+  RecordingThreadStartObserver() { SetThreadStartObserver(this); }
+  ~RecordingThreadStartObserver() override { SetThreadStartObserver(nullptr); }
+
+  void OnThreadStarted(const char* name) override {
+    CritScope lock(&crit_);
+    names_.push_back(name);
+    threads_.push_back(CurrentThreadRef());
+  }
+
+  std::vector<std::string> names() const {
+    CritScope lock(&crit_);
+    return names_;
+  }
+  std::vector<PlatformThreadRef> threads() const {
+    CritScope lock(&crit_);
+    return threads_;
+  }
+
+ private:
+  CriticalSection crit_;
+  std::vector<std::string> names_;
+  std::vector<PlatformThreadRef> threads_;
+};
+
 }  // namespace
 
 TEST(PlatformThreadTest, StartStopDeprecated) {
@@ -113,6 +148,41 @@ TEST(PlatformThreadTest, RunFunctionIsCalled) {
   EXPECT_TRUE(flag);
 }
 
+TEST(PlatformThreadTest, ObserverIsCalledOnStartedThread) {
+  PlatformThreadRef thread_ref;
+  RecordingThreadStartObserver observer;
+  PlatformThread thread(&SaveThreadRefRunFunction, &thread_ref,
+                        "ObservedThread", kNormalPriority);
+  thread.Start();
+  thread.Stop();
+  SetThreadStartObserver(nullptr);
+
+  PlatformThread unobserved(&NullRunFunction, nullptr, "UnobservedThread");
+  unobserved.Start();
+  unobserved.Stop();
+
+  EXPECT_EQ(std::vector<std::string>({"ObservedThread"}), observer.names());
+  ASSERT_EQ(1u, observer.threads().size());
+  EXPECT_TRUE(IsThreadRefEqual(thread_ref, observer.threads()[0]));
+}
+
+#if defined(WEBRTC_LINUX) || defined(WEBRTC_ANDROID)
+// On a thread of its own, so that the test thread stays unpinned.
+void SetCpuAffinityRunFunction(void* obj) {
+  EXPECT_FALSE(SetCurrentThreadCpuAffinity({}));
+  EXPECT_FALSE(SetCurrentThreadCpuAffinity({-1}));
+  *static_cast<bool*>(obj) = SetCurrentThreadCpuAffinity({0});
+}
+
+TEST(PlatformThreadTest, SetsCurrentThreadCpuAffinity) {
+  bool pinned = false;
+  PlatformThread thread(&SetCpuAffinityRunFunction, &pinned, "PinnedThread");
+  thread.Start();
+  thread.Stop();
+  EXPECT_TRUE(pinned);
+}
+#endif
+
 // This test is disabled since it will cause a crash.
 // There might be a way to implement this as a death test, but it looks like
 // a death test requires an expression to be checked but does not allow a
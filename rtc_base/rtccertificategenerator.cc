@@ -15,6 +15,7 @@
 
 #include "rtc_base/checks.h"
 #include "rtc_base/refcountedobject.h"
+#include "rtc_base/rtccertificatepool.h"
 #include "rtc_base/sslidentity.h"
 
 namespace rtc {
@@ -55,6 +56,12 @@ class RTCCertificateGenerationTask : public RefCountInterface,
   }
   ~RTCCertificateGenerationTask() override {}
 
+  // Sets a certificate that was generated ahead of time, for the task to hand
+  // to the callback on |MSG_GENERATE_DONE| instead of generating one.
+  void set_certificate(const scoped_refptr<RTCCertificate>& certificate) {
+    certificate_ = certificate;
+  }
+
   // Handles |MSG_GENERATE| and its follow-up |MSG_GENERATE_DONE|.
   void OnMessage(Message* msg) override {
     switch (msg->message_id) {
@@ -132,7 +139,14 @@ scoped_refptr<RTCCertificate> RTCCertificateGenerator::GenerateCertificate(
 
 RTCCertificateGenerator::RTCCertificateGenerator(Thread* signaling_thread,
                                                  Thread* worker_thread)
-    : signaling_thread_(signaling_thread), worker_thread_(worker_thread) {
+    : RTCCertificateGenerator(signaling_thread, worker_thread, nullptr) {}
+
+RTCCertificateGenerator::RTCCertificateGenerator(Thread* signaling_thread,
+                                                 Thread* worker_thread,
+                                                 RTCCertificatePool* pool)
+    : signaling_thread_(signaling_thread),
+      worker_thread_(worker_thread),
+      pool_(pool) {
   RTC_DCHECK(signaling_thread_);
   RTC_DCHECK(worker_thread_);
 }
@@ -152,6 +166,17 @@ void RTCCertificateGenerator::GenerateCertificateAsync(
           new RefCountedObject<RTCCertificateGenerationTask>(
               signaling_thread_, worker_thread_, key_params, expires_ms,
               callback));
+  // The pooled certificates have the default expiration time.
+  if (pool_ && !expires_ms) {
+    scoped_refptr<RTCCertificate> certificate = pool_->Take(key_params);
+    if (certificate) {
+      // The callback is still invoked asynchronously.
+      msg_data->data()->set_certificate(certificate);
+      signaling_thread_->Post(RTC_FROM_HERE, msg_data->data().get(),
+                              MSG_GENERATE_DONE, msg_data);
+      return;
+    }
+  }
   worker_thread_->Post(RTC_FROM_HERE, msg_data->data().get(), MSG_GENERATE,
                        msg_data);
 }
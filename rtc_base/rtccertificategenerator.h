@@ -20,6 +20,8 @@
 
 namespace rtc {
 
+class RTCCertificatePool;
+
 // See |RTCCertificateGeneratorInterface::GenerateCertificateAsync|.
 class RTCCertificateGeneratorCallback : public RefCountInterface {
  public:
@@ -63,6 +65,11 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
       const absl::optional<uint64_t>& expires_ms);
 
   RTCCertificateGenerator(Thread* signaling_thread, Thread* worker_thread);
+  // Takes the certificates from |pool| when it has one ready, instead of
+  // generating them. |pool| must outlive the generator.
+  RTCCertificateGenerator(Thread* signaling_thread,
+                          Thread* worker_thread,
+                          RTCCertificatePool* pool);
   ~RTCCertificateGenerator() override {}
 
   // |RTCCertificateGeneratorInterface| overrides.
@@ -78,6 +85,7 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
  private:
   Thread* const signaling_thread_;
   Thread* const worker_thread_;
+  RTCCertificatePool* const pool_;
 };
 
 }  // namespace rtc
@@ -17,6 +17,7 @@
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/refcountedobject.h"
+#include "rtc_base/rtccertificatepool.h"
 #include "rtc_base/thread.h"
 
 namespace rtc {
@@ -35,6 +36,12 @@ class RTCCertificateGeneratorFixture : public RTCCertificateGeneratorCallback {
   ~RTCCertificateGeneratorFixture() override {}
 
   RTCCertificateGenerator* generator() const { return generator_.get(); }
+  Thread* worker_thread() const { return worker_thread_.get(); }
+
+  void UsePool(RTCCertificatePool* pool) {
+    generator_.reset(new RTCCertificateGenerator(
+        signaling_thread_, worker_thread_.get(), pool));
+  }
   RTCCertificate* certificate() const { return certificate_.get(); }
 
   void OnSuccess(const scoped_refptr<RTCCertificate>& certificate) override {
@@ -101,6 +108,29 @@ TEST_F(RTCCertificateGeneratorTest, GenerateAsyncECDSA) {
   EXPECT_TRUE(fixture_->certificate());
 }
 
+TEST_F(RTCCertificateGeneratorTest, GenerateAsyncTakesFromPool) {
+  RTCCertificatePool pool(fixture_->worker_thread());
+  RTCCertificatePool::Config config;
+  config.size = 1;
+  pool.SetConfig(config);
+  EXPECT_EQ_WAIT(1u, pool.size(), kGenerationTimeoutMs);
+  fixture_->UsePool(&pool);
+
+  fixture_->generator()->GenerateCertificateAsync(KeyParams::ECDSA(),
+                                                  absl::nullopt, fixture_);
+  EXPECT_EQ(0u, pool.size());
+  // The callback is still asynchronous.
+  EXPECT_FALSE(fixture_->GenerateAsyncCompleted());
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+
+  // A certificate with an expiration time is generated.
+  fixture_->generator()->GenerateCertificateAsync(KeyParams::ECDSA(), 60000,
+                                                  fixture_);
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+}
+
 TEST_F(RTCCertificateGeneratorTest, GenerateWithExpires) {
   // By generating two certificates with different expiration we can compare the
   // two expiration times relative to each other without knowing the current
@@ -0,0 +1,154 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/rtccertificatepool.h"
+
+#include <algorithm>
+
+#include "absl/types/optional.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/rtccertificategenerator.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+enum {
+  MSG_REFILL,
+};
+
+bool SameKeyParams(const KeyParams& a, const KeyParams& b) {
+  if (a.type() != b.type()) {
+    return false;
+  }
+  switch (a.type()) {
+    case KT_RSA:
+      return a.rsa_params().mod_size == b.rsa_params().mod_size &&
+             a.rsa_params().pub_exp == b.rsa_params().pub_exp;
+    case KT_ECDSA:
+      return a.ec_curve() == b.ec_curve();
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+RTCCertificatePool::RTCCertificatePool(Thread* worker_thread)
+    : worker_thread_(worker_thread) {
+  RTC_DCHECK(worker_thread_);
+}
+
+RTCCertificatePool::~RTCCertificatePool() {
+  // Also waits for a refill in progress to finish.
+  worker_thread_->Invoke<void>(RTC_FROM_HERE,
+                               [this] { worker_thread_->Clear(this); });
+}
+
+void RTCCertificatePool::SetConfig(const Config& config) {
+  RTC_DCHECK(config.key_params.IsValid());
+  RTC_DCHECK_GE(config.refill_interval_ms, 0);
+  RTC_DCHECK_GT(config.max_age_ms, 0);
+  CritScope cs(&crit_);
+  if (!SameKeyParams(config.key_params, config_.key_params)) {
+    certificates_.clear();
+  }
+  config_ = config;
+  // Keep the newest certificates.
+  while (certificates_.size() > config_.size) {
+    certificates_.pop_front();
+  }
+  ScheduleRefillLocked(TimeMillis());
+}
+
+scoped_refptr<RTCCertificate> RTCCertificatePool::Take(
+    const KeyParams& key_params) {
+  CritScope cs(&crit_);
+  const int64_t now = TimeMillis();
+  DropExpiredLocked(now);
+  if (certificates_.empty() ||
+      !SameKeyParams(key_params, config_.key_params)) {
+    return nullptr;
+  }
+  scoped_refptr<RTCCertificate> certificate =
+      std::move(certificates_.front().certificate);
+  certificates_.pop_front();
+  ScheduleRefillLocked(now);
+  return certificate;
+}
+
+size_t RTCCertificatePool::size() const {
+  CritScope cs(&crit_);
+  return certificates_.size();
+}
+
+void RTCCertificatePool::OnMessage(Message* msg) {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  RTC_DCHECK_EQ(MSG_REFILL, msg->message_id);
+  KeyParams key_params;
+  {
+    CritScope cs(&crit_);
+    const int64_t now = TimeMillis();
+    DropExpiredLocked(now);
+    if (certificates_.size() >= config_.size ||
+        (last_generation_ms_ != 0 &&
+         now < last_generation_ms_ + config_.refill_interval_ms)) {
+      ScheduleRefillLocked(now);
+      return;
+    }
+    key_params = config_.key_params;
+  }
+
+  // Generate without the lock, so that Take() doesn't wait for it.
+  scoped_refptr<RTCCertificate> certificate =
+      RTCCertificateGenerator::GenerateCertificate(key_params, absl::nullopt);
+  if (!certificate) {
+    RTC_LOG(LS_WARNING) << "Failed to generate a pooled certificate.";
+  }
+
+  CritScope cs(&crit_);
+  const int64_t now = TimeMillis();
+  last_generation_ms_ = now;
+  // The config may have changed during the generation.
+  if (certificate && SameKeyParams(key_params, config_.key_params) &&
+      certificates_.size() < config_.size) {
+    certificates_.push_back({std::move(certificate), now});
+  }
+  ScheduleRefillLocked(now);
+}
+
+void RTCCertificatePool::DropExpiredLocked(int64_t now) {
+  // The certificates are ordered by creation time.
+  while (!certificates_.empty() &&
+         now - certificates_.front().created_ms >= config_.max_age_ms) {
+    certificates_.pop_front();
+  }
+}
+
+void RTCCertificatePool::ScheduleRefillLocked(int64_t now) {
+  worker_thread_->Clear(this, MSG_REFILL);
+  int64_t next_refill_ms;
+  if (certificates_.size() < config_.size) {
+    next_refill_ms = last_generation_ms_ == 0
+                         ? now
+                         : last_generation_ms_ + config_.refill_interval_ms;
+  } else if (!certificates_.empty()) {
+    next_refill_ms = certificates_.front().created_ms + config_.max_age_ms;
+  } else {
+    return;
+  }
+  const int64_t delay_ms = std::max<int64_t>(next_refill_ms - now, 0);
+  worker_thread_->PostDelayed(RTC_FROM_HERE, static_cast<int>(delay_ms), this,
+                              MSG_REFILL);
+}
+
+}  // namespace rtc
@@ -0,0 +1,89 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_RTCCERTIFICATEPOOL_H_
+#define RTC_BASE_RTCCERTIFICATEPOOL_H_
+
+#include <deque>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/messagehandler.h"
+#include "rtc_base/rtccertificate.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/sslidentity.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+
+// Keeps certificates generated ahead of time on the worker thread, so that
+// |RTCCertificateGenerator| can hand one out without waiting for the key
+// generation. The pool generates at most one certificate per refill interval,
+// and replaces the certificates that it has kept for longer than their
+// maximum age, so that the same key is not handed out long after it was made.
+// The certificates have the default expiration time.
+//
+// Take() may be called on any thread; the pool is filled on the worker
+// thread, which must outlive it.
+class RTCCertificatePool : public MessageHandler {
+ public:
+  struct Config {
+    // The number of certificates to keep ready. 0 disables the pool.
+    size_t size = 0;
+    KeyParams key_params = KeyParams::ECDSA();
+    // The minimum time between two certificate generations.
+    int refill_interval_ms = 100;
+    // The time after which an unused certificate is replaced.
+    int64_t max_age_ms = 60 * 60 * 1000;
+  };
+
+  explicit RTCCertificatePool(Thread* worker_thread);
+  ~RTCCertificatePool() override;
+
+  // Drops the certificates that don't match |config|, and starts filling the
+  // pool up to |config.size|.
+  void SetConfig(const Config& config);
+
+  // Returns a ready certificate with |key_params|, or null if there is none.
+  // Never blocks on a certificate generation.
+  scoped_refptr<RTCCertificate> Take(const KeyParams& key_params);
+
+  // The number of certificates ready to be taken.
+  size_t size() const;
+
+  // MessageHandler implementation.
+  void OnMessage(Message* msg) override;
+
+ private:
+  struct Entry {
+    scoped_refptr<RTCCertificate> certificate;
+    int64_t created_ms;
+  };
+
+  // Drops the certificates past their maximum age. Must be called with
+  // |crit_| held.
+  void DropExpiredLocked(int64_t now);
+  // Replaces the pending refill, if any, with one at the time that the pool
+  // next needs it. Must be called with |crit_| held.
+  void ScheduleRefillLocked(int64_t now);
+
+  Thread* const worker_thread_;
+  CriticalSection crit_;
+  Config config_ RTC_GUARDED_BY(crit_);
+  std::deque<Entry> certificates_ RTC_GUARDED_BY(crit_);
+  int64_t last_generation_ms_ RTC_GUARDED_BY(crit_) = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RTCCertificatePool);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_RTCCERTIFICATEPOOL_H_
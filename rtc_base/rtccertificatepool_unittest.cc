@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/rtccertificatepool.h"
+
+#include <memory>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/fakeclock.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+
+namespace {
+
+const int kGenerationTimeoutMs = 10000;
+
+}  // namespace
+
+class RTCCertificatePoolTest : public testing::Test {
+ public:
+  RTCCertificatePoolTest() : worker_thread_(Thread::Create()) {
+    RTC_CHECK(worker_thread_->Start());
+    pool_.reset(new RTCCertificatePool(worker_thread_.get()));
+  }
+
+ protected:
+  std::unique_ptr<Thread> worker_thread_;
+  std::unique_ptr<RTCCertificatePool> pool_;
+};
+
+TEST_F(RTCCertificatePoolTest, FillsAndRefillsTheTakenCertificates) {
+  RTCCertificatePool::Config config;
+  config.size = 2;
+  config.refill_interval_ms = 0;
+  pool_->SetConfig(config);
+  EXPECT_EQ_WAIT(2u, pool_->size(), kGenerationTimeoutMs);
+
+  scoped_refptr<RTCCertificate> certificate = pool_->Take(KeyParams::ECDSA());
+  ASSERT_TRUE(certificate);
+  scoped_refptr<RTCCertificate> other = pool_->Take(KeyParams::ECDSA());
+  ASSERT_TRUE(other);
+  EXPECT_NE(certificate, other);
+  EXPECT_EQ_WAIT(2u, pool_->size(), kGenerationTimeoutMs);
+}
+
+TEST_F(RTCCertificatePoolTest, DoesNotTakeOtherKeyParams) {
+  RTCCertificatePool::Config config;
+  config.size = 1;
+  pool_->SetConfig(config);
+  EXPECT_EQ_WAIT(1u, pool_->size(), kGenerationTimeoutMs);
+  EXPECT_FALSE(pool_->Take(KeyParams::RSA()));
+  EXPECT_EQ(1u, pool_->size());
+}
+
+TEST_F(RTCCertificatePoolTest, SizeZeroDropsTheCertificates) {
+  RTCCertificatePool::Config config;
+  config.size = 1;
+  pool_->SetConfig(config);
+  EXPECT_EQ_WAIT(1u, pool_->size(), kGenerationTimeoutMs);
+  config.size = 0;
+  pool_->SetConfig(config);
+  EXPECT_EQ(0u, pool_->size());
+  EXPECT_FALSE(pool_->Take(KeyParams::ECDSA()));
+}
+
+TEST_F(RTCCertificatePoolTest, DropsCertificatesPastTheMaximumAge) {
+  ScopedFakeClock clock;
+  clock.AdvanceTime(webrtc::TimeDelta::seconds(1));
+  RTCCertificatePool::Config config;
+  config.size = 1;
+  config.max_age_ms = 1000;
+  // Keeps the pool from generating a replacement during the test.
+  config.refill_interval_ms = 60 * 60 * 1000;
+  pool_->SetConfig(config);
+  EXPECT_EQ_WAIT(1u, pool_->size(), kGenerationTimeoutMs);
+
+  clock.AdvanceTime(webrtc::TimeDelta::ms(config.max_age_ms));
+  EXPECT_EQ_WAIT(0u, pool_->size(), kGenerationTimeoutMs);
+  EXPECT_FALSE(pool_->Take(KeyParams::ECDSA()));
+}
+
+}  // namespace rtc
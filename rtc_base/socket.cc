@@ -24,4 +24,26 @@ SentPacket::SentPacket(int64_t packet_id,
                        const rtc::PacketInfo& info)
     : packet_id(packet_id), send_time_ms(send_time_ms), info(info) {}
 
+int Socket::SendToBatch(const OutgoingDatagram* datagrams, size_t count) {
+  size_t sent = 0;
+  for (; sent < count; ++sent) {
+    const OutgoingDatagram& datagram = datagrams[sent];
+    if (SendTo(datagram.data, datagram.size, datagram.remote_address) < 0)
+      return sent == 0 ? -1 : static_cast<int>(sent);
+  }
+  return static_cast<int>(sent);
+}
+
+int Socket::RecvFromBatch(ReceivedDatagram* datagrams, size_t count) {
+  if (count == 0)
+    return 0;
+  int received =
+      RecvFrom(datagrams[0].buffer, datagrams[0].buffer_size,
+               &datagrams[0].remote_address, &datagrams[0].timestamp);
+  if (received < 0)
+    return received;
+  datagrams[0].size = static_cast<size_t>(received);
+  return 1;
+}
+
 }  // namespace rtc
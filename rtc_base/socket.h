@@ -167,6 +167,25 @@ struct SentPacket {
   rtc::PacketInfo info;
 };
 
+// Describes one datagram for Socket::RecvFromBatch(). The caller supplies
+// |buffer| and |buffer_size|; the socket fills in the remaining fields.
+struct ReceivedDatagram {
+  void* buffer = nullptr;
+  size_t buffer_size = 0;
+  // Number of bytes written to |buffer|.
+  size_t size = 0;
+  SocketAddress remote_address;
+  // Receive time in microseconds, or -1 if not available.
+  int64_t timestamp = -1;
+};
+
+// Describes one datagram for Socket::SendToBatch().
+struct OutgoingDatagram {
+  const void* data = nullptr;
+  size_t size = 0;
+  SocketAddress remote_address;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -185,12 +204,22 @@ class Socket {
   virtual int Connect(const SocketAddress& addr) = 0;
   virtual int Send(const void* pv, size_t cb) = 0;
   virtual int SendTo(const void* pv, size_t cb, const SocketAddress& addr) = 0;
+  // Sends the |count| datagrams in |datagrams| in order. Returns the number of
+  // datagrams sent, which may be less than |count|, or a negative value if
+  // the first datagram could not be sent (GetError() is set as for SendTo).
+  // The default implementation calls SendTo() for each datagram.
+  virtual int SendToBatch(const OutgoingDatagram* datagrams, size_t count);
   // |timestamp| is in units of microseconds.
   virtual int Recv(void* pv, size_t cb, int64_t* timestamp) = 0;
   virtual int RecvFrom(void* pv,
                        size_t cb,
                        SocketAddress* paddr,
                        int64_t* timestamp) = 0;
+  // Receives up to |count| datagrams into |datagrams| without blocking.
+  // Returns the number of datagrams received, or a negative value on error
+  // (in which case GetError() is set as for RecvFrom). The default
+  // implementation reads a single datagram with RecvFrom().
+  virtual int RecvFromBatch(ReceivedDatagram* datagrams, size_t count);
   virtual int Listen(int backlog) = 0;
   virtual Socket* Accept(SocketAddress* paddr) = 0;
   virtual int Close() = 0;
@@ -211,6 +240,11 @@ class Socket {
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
+    OPT_REUSEPORT,             // Allow several sockets to bind the same port
+                               // (SO_REUSEPORT). Must be set before Bind().
+    OPT_TCP_NOTSENT_LOWAT,     // Unsent bytes in the send buffer above which
+                               // the socket isn't writable. Keeps the queue
+                               // in user space, where it can be dropped.
   };
   virtual int GetOption(Option opt, int* value) = 0;
   virtual int SetOption(Option opt, int value) = 0;
@@ -148,6 +148,10 @@ bool SSLStreamAdapter::GetDtlsSrtpCryptoSuite(int* crypto_suite) {
   return false;
 }
 
+bool SSLStreamAdapter::IsSessionResumed() const {
+  return false;
+}
+
 bool SSLStreamAdapter::IsBoringSsl() {
   return OpenSSLStreamAdapter::IsBoringSsl();
 }
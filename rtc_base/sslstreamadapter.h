@@ -91,6 +91,11 @@ struct CryptoOptions {
   // If set to true, encrypted RTP header extensions as defined in RFC 6904
   // will be negotiated. They will only be used if both peers support them.
   bool enable_encrypted_rtp_header_extensions = false;
+
+  // If set to true, DTLS sessions are resumed with the session tickets of
+  // earlier connections between the same two certificates, which avoids the
+  // key exchange of a full handshake. Both peers must enable it to resume.
+  bool enable_dtls_session_resumption = false;
 };
 
 // Returns supported crypto suites, given |crypto_options|.
@@ -150,6 +155,18 @@ class SSLStreamAdapter : public StreamAdapterInterface {
   void set_client_auth_enabled(bool enabled) { client_auth_enabled_ = enabled; }
   bool client_auth_enabled() const { return client_auth_enabled_; }
 
+  // Resume the session of an earlier connection with the same local identity
+  // and peer certificate digest, if there is one, and keep this session for
+  // the next ones. The peer certificate of a resumed session is verified
+  // against the digest like that of a full handshake.
+  // This should only be called before StartSSL().
+  void set_session_resumption_enabled(bool enabled) {
+    session_resumption_enabled_ = enabled;
+  }
+  bool session_resumption_enabled() const {
+    return session_resumption_enabled_;
+  }
+
   // Specify our SSL identity: key and certificate. SSLStream takes ownership
   // of the SSLIdentity object and will free it when appropriate. Should be
   // called no more than once on a given SSLStream instance.
@@ -248,6 +265,9 @@ class SSLStreamAdapter : public StreamAdapterInterface {
   // SS_OPENING but IsTlsConnected should return true.
   virtual bool IsTlsConnected() = 0;
 
+  // Returns true if the connection resumed the session of an earlier one.
+  virtual bool IsSessionResumed() const;
+
   // Capabilities testing.
   // Used to have "DTLS supported", "DTLS-SRTP supported" etc. methods, but now
   // that's assumed.
@@ -279,6 +299,10 @@ class SSLStreamAdapter : public StreamAdapterInterface {
   // handshake. If no certificate is given, handshake fails. This applies to
   // server mode only.
   bool client_auth_enabled_;
+
+  // If true, sessions are resumed with the session cache shared by the
+  // adapters of the process. False by default.
+  bool session_resumption_enabled_ = false;
 };
 
 }  // namespace rtc
@@ -12,6 +12,7 @@
 #define RTC_BASE_SWAP_QUEUE_H_
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 #include <vector>
 
@@ -207,6 +208,113 @@ class SwapQueue {
   RTC_DISALLOW_COPY_AND_ASSIGN(SwapQueue);
 };
 
+// A SwapQueue for one producer and one consumer, which never locks. Insert()
+// and Remove() each swap one slot and publish it with an atomic index, so the
+// producer and the consumer never wait for each other, e.g. when a real-time
+// audio thread is preempted in the middle of a call.
+//
+// Only one thread may call Insert() at a time, and only one thread may call
+// Remove() at a time. The threads may change when a lock orders the calls,
+// e.g. when a producer that finds the queue full empties it under the lock of
+// the consumer. Clear() must not be called concurrently with the other
+// methods.
+template <typename T, typename QueueItemVerifier = SwapQueueItemVerifier<T>>
+class SpscSwapQueue {
+ public:
+  // Creates a queue of size size and fills it with default constructed Ts.
+  explicit SpscSwapQueue(size_t size) : queue_(size) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Same as above and accepts an item verification functor.
+  SpscSwapQueue(size_t size, const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier), queue_(size) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Creates a queue of size size and fills it with copies of prototype.
+  SpscSwapQueue(size_t size, const T& prototype) : queue_(size, prototype) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Same as above and accepts an item verification functor.
+  SpscSwapQueue(size_t size,
+                const T& prototype,
+                const QueueItemVerifier& queue_item_verifier)
+      : queue_item_verifier_(queue_item_verifier), queue_(size, prototype) {
+    RTC_DCHECK(VerifyQueueSlots());
+  }
+
+  // Resets the queue to have zero content wile maintaining the queue size.
+  void Clear() {
+    next_write_index_.store(0, std::memory_order_relaxed);
+    next_read_index_.store(0, std::memory_order_relaxed);
+  }
+
+  // Same as SwapQueue::Insert(). Only called by the producer.
+  bool Insert(T* input) RTC_WARN_UNUSED_RESULT {
+    RTC_DCHECK(input);
+    RTC_DCHECK(queue_item_verifier_(*input));
+
+    const size_t write_index =
+        next_write_index_.load(std::memory_order_relaxed);
+    // Acquire the slots that the consumer has released.
+    const size_t read_index = next_read_index_.load(std::memory_order_acquire);
+    if (write_index - read_index == queue_.size()) {
+      return false;
+    }
+
+    using std::swap;
+    swap(*input, queue_[write_index % queue_.size()]);
+
+    // Release the filled slot to the consumer.
+    next_write_index_.store(write_index + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Same as SwapQueue::Remove(). Only called by the consumer.
+  bool Remove(T* output) RTC_WARN_UNUSED_RESULT {
+    RTC_DCHECK(output);
+    RTC_DCHECK(queue_item_verifier_(*output));
+
+    const size_t read_index = next_read_index_.load(std::memory_order_relaxed);
+    // Acquire the slots that the producer has filled.
+    const size_t write_index =
+        next_write_index_.load(std::memory_order_acquire);
+    if (write_index == read_index) {
+      return false;
+    }
+
+    using std::swap;
+    swap(*output, queue_[read_index % queue_.size()]);
+
+    // Release the emptied slot to the producer.
+    next_read_index_.store(read_index + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // Verify that the queue slots complies with the ItemVerifier test.
+  bool VerifyQueueSlots() {
+    for (const auto& v : queue_) {
+      RTC_DCHECK(queue_item_verifier_(v));
+    }
+    return true;
+  }
+
+  QueueItemVerifier queue_item_verifier_;
+
+  // Number of items inserted and removed since the last Clear(). The queue
+  // holds next_write_index_ - next_read_index_ items.
+  std::atomic<size_t> next_write_index_{0};
+  std::atomic<size_t> next_read_index_{0};
+
+  // queue_.size() is constant.
+  std::vector<T> queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SpscSwapQueue);
+};
+
 }  // namespace webrtc
 
 #endif  // RTC_BASE_SWAP_QUEUE_H_
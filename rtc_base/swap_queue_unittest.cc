@@ -12,6 +12,8 @@
 
 #include <vector>
 
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -222,4 +224,110 @@ TEST(SwapQueueTest, OneSlotQueue) {
   EXPECT_FALSE(queue.Remove(&i));
 }
 
+TEST(SpscSwapQueueTest, BasicOperation) {
+  std::vector<int> i(kChunkSize, 0);
+  SpscSwapQueue<std::vector<int>> queue(2, i);
+
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+  EXPECT_TRUE(queue.Remove(&i));
+  EXPECT_EQ(i.size(), kChunkSize);
+}
+
+TEST(SpscSwapQueueTest, FullQueueWrapsAround) {
+  SpscSwapQueue<int> queue(2);
+
+  for (int k = 0; k < 5; ++k) {
+    int i = 2 * k;
+    EXPECT_TRUE(queue.Insert(&i));
+    i = 2 * k + 1;
+    EXPECT_TRUE(queue.Insert(&i));
+    i = -1;
+    EXPECT_FALSE(queue.Insert(&i));
+    EXPECT_EQ(-1, i);
+
+    EXPECT_TRUE(queue.Remove(&i));
+    EXPECT_EQ(2 * k, i);
+    EXPECT_TRUE(queue.Remove(&i));
+    EXPECT_EQ(2 * k + 1, i);
+    EXPECT_FALSE(queue.Remove(&i));
+  }
+}
+
+TEST(SpscSwapQueueTest, Clear) {
+  SpscSwapQueue<int> queue(2);
+  int i = 0;
+
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  queue.Clear();
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_TRUE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Insert(&i));
+}
+
+TEST(SpscSwapQueueTest, ZeroSlotQueue) {
+  SpscSwapQueue<int> queue(0);
+  int i = 42;
+  EXPECT_FALSE(queue.Insert(&i));
+  EXPECT_FALSE(queue.Remove(&i));
+  EXPECT_EQ(i, 42);
+}
+
+#if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
+TEST(SpscSwapQueueTest, UnSuccessfulItemVerifyInsert) {
+  std::vector<int> valid_chunk(kChunkSize, 0);
+  std::vector<int> invalid_chunk(kChunkSize - 1, 0);
+  SpscSwapQueue<
+      std::vector<int>,
+      SwapQueueItemVerifier<std::vector<int>, &LengthVerifierFunction>>
+      queue(2, valid_chunk);
+  EXPECT_DEATH(static_cast<void>(queue.Insert(&invalid_chunk)), "");
+}
+#endif
+
+namespace {
+
+constexpr int kNumConcurrentItems = 10000;
+
+void ProduceItems(void* obj) {
+  auto* queue = static_cast<SpscSwapQueue<std::vector<int>>*>(obj);
+  std::vector<int> item(kChunkSize);
+  for (int k = 0; k < kNumConcurrentItems; ++k) {
+    for (size_t j = 0; j < kChunkSize; ++j)
+      item[j] = k;
+    while (!queue->Insert(&item)) {
+      rtc::Thread::SleepMs(0);
+    }
+  }
+}
+
+}  // namespace
+
+// Verifies that items passed between two threads arrive complete and in
+// order.
+TEST(SpscSwapQueueTest, ConcurrentProducerAndConsumer) {
+  std::vector<int> item(kChunkSize);
+  SpscSwapQueue<std::vector<int>> queue(4, item);
+  rtc::PlatformThread producer(&ProduceItems, &queue, "SpscProducer");
+  producer.Start();
+
+  for (int k = 0; k < kNumConcurrentItems; ++k) {
+    while (!queue.Remove(&item)) {
+      rtc::Thread::SleepMs(0);
+    }
+    ASSERT_EQ(kChunkSize, item.size());
+    for (size_t j = 0; j < kChunkSize; ++j)
+      ASSERT_EQ(k, item[j]);
+  }
+
+  producer.Stop();
+  EXPECT_FALSE(queue.Remove(&item));
+}
+
 }  // namespace webrtc
@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SYNCHRONIZATION_SEQUENCE_LOCK_H_
+#define RTC_BASE_SYNCHRONIZATION_SEQUENCE_LOCK_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <type_traits>
+
+namespace rtc {
+
+// Holds a small value that one thread writes and any number of threads read,
+// without either side ever waiting on a lock. The value is copied in and out
+// word by word behind a version counter, and readers retry while a write is in
+// progress, so reads get more expensive the more often and the larger the
+// value is written.
+//
+// Writes must be serialized by the caller.
+template <typename T>
+class SequenceLocked {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SequenceLocked value is copied with memcpy");
+
+  SequenceLocked() : SequenceLocked(T()) {}
+  explicit SequenceLocked(const T& value) { StoreWords(value); }
+  SequenceLocked(const SequenceLocked&) = delete;
+  SequenceLocked& operator=(const SequenceLocked&) = delete;
+
+  void Write(const T& value) {
+    uint32_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    StoreWords(value);
+    version_.store(version + 2, std::memory_order_release);
+  }
+
+  T Read() const {
+    uint64_t words[kNumWords];
+    while (true) {
+      uint32_t version = version_.load(std::memory_order_acquire);
+      if (version & 1)
+        continue;
+      for (size_t i = 0; i < kNumWords; ++i)
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (version_.load(std::memory_order_relaxed) == version)
+        break;
+    }
+    T value;
+    memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+ private:
+  static constexpr size_t kNumWords =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  void StoreWords(const T& value) {
+    uint64_t words[kNumWords] = {};
+    memcpy(words, &value, sizeof(T));
+    for (size_t i = 0; i < kNumWords; ++i)
+      words_[i].store(words[i], std::memory_order_relaxed);
+  }
+
+  // Odd while a write is in progress.
+  std::atomic<uint32_t> version_{0};
+  std::atomic<uint64_t> words_[kNumWords];
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_SYNCHRONIZATION_SEQUENCE_LOCK_H_
@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/sequence_lock.h"
+
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+// Odd size, to check the last partial word.
+struct Value {
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+};
+
+constexpr uint32_t kNumWrites = 100000;
+
+void WriteValues(void* value) {
+  for (uint32_t i = 1; i <= kNumWrites; ++i)
+    static_cast<SequenceLocked<Value>*>(value)->Write({i, i * 2, i * 3});
+}
+
+TEST(SequenceLockedTest, ReadsLastWrittenValue) {
+  SequenceLocked<Value> value({1, 2, 3});
+  Value read = value.Read();
+  EXPECT_EQ(1u, read.a);
+  EXPECT_EQ(2u, read.b);
+  EXPECT_EQ(3u, read.c);
+
+  value.Write({4, 5, 6});
+  read = value.Read();
+  EXPECT_EQ(4u, read.a);
+  EXPECT_EQ(5u, read.b);
+  EXPECT_EQ(6u, read.c);
+}
+
+TEST(SequenceLockedTest, DefaultConstructsValue) {
+  SequenceLocked<int64_t> value;
+  EXPECT_EQ(0, value.Read());
+}
+
+TEST(SequenceLockedTest, ReadsConsistentValueWhileWritten) {
+  SequenceLocked<Value> value({0, 0, 0});
+  PlatformThread writer(&WriteValues, &value, "Writer");
+  writer.Start();
+
+  uint32_t last_a = 0;
+  while (last_a < kNumWrites) {
+    Value read = value.Read();
+    ASSERT_EQ(read.a * 2, read.b);
+    ASSERT_EQ(read.a * 3, read.c);
+    ASSERT_GE(read.a, last_a);
+    last_a = read.a;
+  }
+  writer.Stop();
+}
+
+}  // namespace
+}  // namespace rtc
@@ -19,10 +19,12 @@
 #include <dispatch/dispatch.h>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/dispatch_stats.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/refcountedobject.h"
 #include "rtc_base/task_queue_posix.h"
+#include "rtc_base/virtual_time.h"
 
 namespace rtc {
 namespace {
@@ -54,6 +56,8 @@ class TaskQueue::Impl : public RefCountInterface {
   // Used for DCHECKing the current queue.
   bool IsCurrent() const;
 
+  DispatchStatsRecorder* dispatch_stats() const { return dispatch_stats_; }
+
   void PostTask(std::unique_ptr<QueuedTask> task);
   void PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                         std::unique_ptr<QueuedTask> reply,
@@ -62,6 +66,8 @@ class TaskQueue::Impl : public RefCountInterface {
   void PostDelayedTask(std::unique_ptr<QueuedTask> task, uint32_t milliseconds);
 
  private:
+  DispatchStatsRecorder* const dispatch_stats_;
+
   struct QueueContext {
     explicit QueueContext(TaskQueue* q) : queue(q), is_active(true) {}
 
@@ -139,10 +145,13 @@ class TaskQueue::Impl : public RefCountInterface {
 TaskQueue::Impl::Impl(const char* queue_name,
                       TaskQueue* task_queue,
                       Priority priority)
-    : queue_(dispatch_queue_create(queue_name, DISPATCH_QUEUE_SERIAL)),
+    : dispatch_stats_(DispatchStatsRecorder::ForQueue(queue_name)),
+      queue_(dispatch_queue_create(queue_name, DISPATCH_QUEUE_SERIAL)),
       context_(new QueueContext(task_queue)) {
   RTC_DCHECK(queue_name);
   RTC_CHECK(queue_);
+  RTC_CHECK(!VirtualTimeController::Get())
+      << "Virtual time needs the libevent TaskQueue.";
   dispatch_set_context(queue_, context_);
   // Assign a finalizer that will delete the context when the last reference
   // to the queue is released.  This may run after the TaskQueue object has
@@ -218,25 +227,33 @@ bool TaskQueue::IsCurrent() const {
 }
 
 void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
-  return TaskQueue::impl_->PostTask(std::move(task));
+  return TaskQueue::impl_->PostTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0));
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply,
                                  TaskQueue* reply_queue) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            reply_queue->impl_.get());
+  // The reply is due once the task has run, which isn't known here.
+  return TaskQueue::impl_->PostTaskAndReply(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0),
+      WrapTaskForDispatchStats(std::move(reply),
+                               reply_queue->impl_->dispatch_stats(),
+                               kDispatchDelayUnknown),
+      reply_queue->impl_.get());
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            impl_.get());
+  return PostTaskAndReply(std::move(task), std::move(reply), this);
 }
 
 void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                 uint32_t milliseconds) {
-  return TaskQueue::impl_->PostDelayedTask(std::move(task), milliseconds);
+  return TaskQueue::impl_->PostDelayedTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(),
+                               milliseconds),
+      milliseconds);
 }
 
 }  // namespace rtc
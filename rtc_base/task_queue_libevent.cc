@@ -14,11 +14,16 @@
 #include <signal.h>
 #include <string.h>
 #include <unistd.h>
+
+#include <algorithm>
 #include <list>
+#include <vector>
 
 #include "base/third_party/libevent/event.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/dispatch_stats.h"
+#include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/platform_thread.h"
@@ -27,7 +32,9 @@
 #include "rtc_base/system/unused.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/task_queue_posix.h"
+#include "rtc_base/timerwheel.h"
 #include "rtc_base/timeutils.h"
+#include "rtc_base/virtual_time.h"
 
 namespace rtc {
 using internal::GetQueuePtrTls;
@@ -61,14 +68,6 @@ void IgnoreSigPipeSignalOnCurrentThread() {
   pthread_sigmask(SIG_BLOCK, &sigpipe_mask, nullptr);
 }
 
-struct TimerEvent {
-  explicit TimerEvent(std::unique_ptr<QueuedTask> task)
-      : task(std::move(task)) {}
-  ~TimerEvent() { event_del(&ev); }
-  event ev;
-  std::unique_ptr<QueuedTask> task;
-};
-
 bool SetNonBlocking(int fd) {
   const int flags = fcntl(fd, F_GETFL);
   RTC_CHECK(flags != -1);
@@ -124,6 +123,8 @@ class TaskQueue::Impl : public RefCountInterface {
   // Used for DCHECKing the current queue.
   bool IsCurrent() const;
 
+  DispatchStatsRecorder* dispatch_stats() const { return dispatch_stats_; }
+
   void PostTask(std::unique_ptr<QueuedTask> task);
   void PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                         std::unique_ptr<QueuedTask> reply,
@@ -132,20 +133,31 @@ class TaskQueue::Impl : public RefCountInterface {
   void PostDelayedTask(std::unique_ptr<QueuedTask> task, uint32_t milliseconds);
 
  private:
+  DispatchStatsRecorder* const dispatch_stats_;
+
   static void ThreadMain(void* context);
+  // Replaces the libevent loop on virtual time, whose threads must only wait
+  // on rtc::Event.
+  void RunVirtualTimeLoop();
   static void OnWakeup(int socket, short flags, void* context);  // NOLINT
   static void RunTask(int fd, short flags, void* context);       // NOLINT
-  static void RunTimer(int fd, short flags, void* context);      // NOLINT
+  static void RunTimers(int fd, short flags, void* context);     // NOLINT
 
   class ReplyTaskOwner;
   class PostAndReplyTask;
   class SetTimerTask;
+  class VirtualTimeTimerTask;
+  class VirtualTimePostAndReplyTask;
 
   typedef RefCountedObject<ReplyTaskOwner> ReplyTaskOwnerRef;
 
   void PrepareReplyTask(scoped_refptr<ReplyTaskOwnerRef> reply_task);
 
   struct QueueContext;
+  // Arms |ctx->timer_event| for the next time the timer wheel needs to be
+  // advanced, unless it is already armed for that time or earlier.
+  static void ScheduleTimers(QueueContext* ctx);
+
   TaskQueue* const queue_;
   int wakeup_pipe_in_ = -1;
   int wakeup_pipe_out_ = -1;
@@ -156,14 +168,26 @@ class TaskQueue::Impl : public RefCountInterface {
   std::list<std::unique_ptr<QueuedTask>> pending_ RTC_GUARDED_BY(pending_lock_);
   std::list<scoped_refptr<ReplyTaskOwnerRef>> pending_replies_
       RTC_GUARDED_BY(pending_lock_);
+
+  // Set if the queue was created on virtual time. Tasks are then put in
+  // |pending_| and |virtual_time_wakeup_| is set, and delayed tasks are kept
+  // by the controller until they are due.
+  VirtualTimeController* const virtual_time_;
+  Event virtual_time_wakeup_;
+  bool virtual_time_quit_ RTC_GUARDED_BY(pending_lock_) = false;
 };
 
 struct TaskQueue::Impl::QueueContext {
   explicit QueueContext(TaskQueue::Impl* q) : queue(q), is_active(true) {}
   TaskQueue::Impl* queue;
   bool is_active;
-  // Holds a list of events pending timers for cleanup when the loop exits.
-  std::list<TimerEvent*> pending_timers_;
+  // Delayed tasks. A single libevent timer, |timer_event|, is armed for the
+  // next time the wheel needs to be advanced. Tasks still pending when the
+  // loop exits are deleted with the wheel.
+  TimerWheel<std::unique_ptr<QueuedTask>> timers;
+  event timer_event;
+  // The time |timer_event| is armed for, or -1 if it is not armed.
+  int64_t timer_event_time = -1;
 };
 
 // Posting a reply task is tricky business. This class owns the reply task
@@ -273,16 +297,60 @@ class TaskQueue::Impl::SetTimerTask : public QueuedTask {
   const uint32_t posted_;
 };
 
+// Posts a delayed task to its queue once the VirtualTimeController finds it
+// due.
+class TaskQueue::Impl::VirtualTimeTimerTask : public QueuedTask {
+ public:
+  VirtualTimeTimerTask(TaskQueue::Impl* queue, std::unique_ptr<QueuedTask> task)
+      : queue_(queue), task_(std::move(task)) {}
+
+ private:
+  bool Run() override {
+    queue_->PostTask(std::move(task_));
+    return true;
+  }
+
+  TaskQueue::Impl* const queue_;
+  std::unique_ptr<QueuedTask> task_;
+};
+
+// Posts the reply once the task has run. Without the reply pipe, the reply
+// queue has to outlive the task.
+class TaskQueue::Impl::VirtualTimePostAndReplyTask : public QueuedTask {
+ public:
+  VirtualTimePostAndReplyTask(std::unique_ptr<QueuedTask> task,
+                              std::unique_ptr<QueuedTask> reply,
+                              TaskQueue::Impl* reply_queue)
+      : task_(std::move(task)),
+        reply_(std::move(reply)),
+        reply_queue_(reply_queue) {}
+
+ private:
+  bool Run() override {
+    if (!task_->Run())
+      task_.release();
+    reply_queue_->PostTask(std::move(reply_));
+    return true;
+  }
+
+  std::unique_ptr<QueuedTask> task_;
+  std::unique_ptr<QueuedTask> reply_;
+  TaskQueue::Impl* const reply_queue_;
+};
+
 TaskQueue::Impl::Impl(const char* queue_name,
                       TaskQueue* queue,
                       Priority priority /*= NORMAL*/)
-    : queue_(queue),
+    : dispatch_stats_(DispatchStatsRecorder::ForQueue(queue_name)),
+      queue_(queue),
       event_base_(event_base_new()),
       wakeup_event_(new event()),
       thread_(&TaskQueue::Impl::ThreadMain,
               this,
               queue_name,
-              TaskQueuePriorityToThreadPriority(priority)) {
+              TaskQueuePriorityToThreadPriority(priority)),
+      virtual_time_(VirtualTimeController::Get()),
+      virtual_time_wakeup_(false, false) {
   RTC_DCHECK(queue_name);
   int fds[2];
   RTC_CHECK(pipe(fds) == 0);
@@ -299,14 +367,24 @@ TaskQueue::Impl::Impl(const char* queue_name,
 
 TaskQueue::Impl::~Impl() {
   RTC_DCHECK(!IsCurrent());
-  struct timespec ts;
-  char message = kQuit;
-  while (write(wakeup_pipe_in_, &message, sizeof(message)) != sizeof(message)) {
-    // The queue is full, so we have no choice but to wait and retry.
-    RTC_CHECK_EQ(EAGAIN, errno);
-    ts.tv_sec = 0;
-    ts.tv_nsec = 1000000;
-    nanosleep(&ts, nullptr);
+  if (virtual_time_) {
+    virtual_time_->CancelDelayedTasks(this);
+    {
+      CritScope lock(&pending_lock_);
+      virtual_time_quit_ = true;
+    }
+    virtual_time_wakeup_.Set();
+  } else {
+    struct timespec ts;
+    char message = kQuit;
+    while (write(wakeup_pipe_in_, &message, sizeof(message)) !=
+           sizeof(message)) {
+      // The queue is full, so we have no choice but to wait and retry.
+      RTC_CHECK_EQ(EAGAIN, errno);
+      ts.tv_sec = 0;
+      ts.tv_nsec = 1000000;
+      nanosleep(&ts, nullptr);
+    }
   }
 
   thread_.Stop();
@@ -345,6 +423,14 @@ bool TaskQueue::Impl::IsCurrent() const {
 
 void TaskQueue::Impl::PostTask(std::unique_ptr<QueuedTask> task) {
   RTC_DCHECK(task.get());
+  if (virtual_time_) {
+    {
+      CritScope lock(&pending_lock_);
+      pending_.push_back(std::move(task));
+    }
+    virtual_time_wakeup_.Set();
+    return;
+  }
   // libevent isn't thread safe.  This means that we can't use methods such
   // as event_base_once to post tasks to the worker thread from a different
   // thread.  However, we can use it when posting from the worker thread itself.
@@ -372,16 +458,22 @@ void TaskQueue::Impl::PostTask(std::unique_ptr<QueuedTask> task) {
 
 void TaskQueue::Impl::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                       uint32_t milliseconds) {
+  if (virtual_time_) {
+    virtual_time_->PostDelayedTask(
+        this,
+        std::unique_ptr<QueuedTask>(
+            new VirtualTimeTimerTask(this, std::move(task))),
+        milliseconds * kNumMicrosecsPerMillisec);
+    return;
+  }
   if (IsCurrent()) {
-    TimerEvent* timer = new TimerEvent(std::move(task));
-    EventAssign(&timer->ev, event_base_, -1, 0, &TaskQueue::Impl::RunTimer,
-                timer);
     QueueContext* ctx =
         static_cast<QueueContext*>(pthread_getspecific(GetQueuePtrTls()));
-    ctx->pending_timers_.push_back(timer);
-    timeval tv = {rtc::dchecked_cast<int>(milliseconds / 1000),
-                  rtc::dchecked_cast<int>(milliseconds % 1000) * 1000};
-    event_add(&timer->ev, &tv);
+    // Like libevent's own timers, the wheel runs on the system clock, so that
+    // delayed tasks are not held up by a fake clock.
+    int64_t now = SystemTimeMillis();
+    ctx->timers.Insert(now, now + milliseconds, std::move(task));
+    ScheduleTimers(ctx);
   } else {
     PostTask(std::unique_ptr<QueuedTask>(
         new SetTimerTask(std::move(task), milliseconds)));
@@ -391,6 +483,11 @@ void TaskQueue::Impl::PostDelayedTask(std::unique_ptr<QueuedTask> task,
 void TaskQueue::Impl::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                        std::unique_ptr<QueuedTask> reply,
                                        TaskQueue::Impl* reply_queue) {
+  if (virtual_time_) {
+    PostTask(std::unique_ptr<QueuedTask>(new VirtualTimePostAndReplyTask(
+        std::move(task), std::move(reply), reply_queue)));
+    return;
+  }
   std::unique_ptr<QueuedTask> wrapper_task(
       new PostAndReplyTask(std::move(task), std::move(reply), reply_queue,
                            reply_queue->wakeup_pipe_in_));
@@ -402,15 +499,41 @@ void TaskQueue::Impl::ThreadMain(void* context) {
   TaskQueue::Impl* me = static_cast<TaskQueue::Impl*>(context);
 
   QueueContext queue_context(me);
+  EventAssign(&queue_context.timer_event, me->event_base_, -1, 0,
+              &TaskQueue::Impl::RunTimers, &queue_context);
   pthread_setspecific(GetQueuePtrTls(), &queue_context);
 
-  while (queue_context.is_active)
-    event_base_loop(me->event_base_, 0);
+  if (me->virtual_time_) {
+    me->RunVirtualTimeLoop();
+  } else {
+    while (queue_context.is_active)
+      event_base_loop(me->event_base_, 0);
+  }
 
   pthread_setspecific(GetQueuePtrTls(), nullptr);
 
-  for (TimerEvent* timer : queue_context.pending_timers_)
-    delete timer;
+  event_del(&queue_context.timer_event);
+}
+
+void TaskQueue::Impl::RunVirtualTimeLoop() {
+  while (true) {
+    std::unique_ptr<QueuedTask> task;
+    {
+      CritScope lock(&pending_lock_);
+      if (virtual_time_quit_)
+        return;
+      if (!pending_.empty()) {
+        task = std::move(pending_.front());
+        pending_.pop_front();
+      }
+    }
+    if (!task) {
+      virtual_time_wakeup_.Wait(Event::kForever);
+      continue;
+    }
+    if (!task->Run())
+      task.release();
+  }
 }
 
 // static
@@ -470,14 +593,32 @@ void TaskQueue::Impl::RunTask(int fd, short flags, void* context) {  // NOLINT
 }
 
 // static
-void TaskQueue::Impl::RunTimer(int fd, short flags, void* context) {  // NOLINT
-  TimerEvent* timer = static_cast<TimerEvent*>(context);
-  if (!timer->task->Run())
-    timer->task.release();
-  QueueContext* ctx =
-      static_cast<QueueContext*>(pthread_getspecific(GetQueuePtrTls()));
-  ctx->pending_timers_.remove(timer);
-  delete timer;
+void TaskQueue::Impl::RunTimers(int fd, short flags, void* context) {  // NOLINT
+  QueueContext* ctx = static_cast<QueueContext*>(context);
+  ctx->timer_event_time = -1;
+  std::vector<std::unique_ptr<QueuedTask>> expired;
+  ctx->timers.Advance(SystemTimeMillis(), &expired);
+  for (std::unique_ptr<QueuedTask>& task : expired) {
+    if (!task->Run())
+      task.release();
+    task.reset();
+  }
+  ScheduleTimers(ctx);
+}
+
+// static
+void TaskQueue::Impl::ScheduleTimers(QueueContext* ctx) {
+  int64_t next = ctx->timers.NextAdvanceTime();
+  if (next < 0)
+    return;
+  if (ctx->timer_event_time >= 0 && ctx->timer_event_time <= next)
+    return;
+  int64_t delay_ms = std::max<int64_t>(0, next - SystemTimeMillis());
+  timeval tv = {rtc::dchecked_cast<int>(delay_ms / 1000),
+                rtc::dchecked_cast<int>(delay_ms % 1000) * 1000};
+  // Re-adding a pending event reschedules it.
+  event_add(&ctx->timer_event, &tv);
+  ctx->timer_event_time = next;
 }
 
 void TaskQueue::Impl::PrepareReplyTask(
@@ -504,25 +645,33 @@ bool TaskQueue::IsCurrent() const {
 }
 
 void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
-  return TaskQueue::impl_->PostTask(std::move(task));
+  return TaskQueue::impl_->PostTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0));
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply,
                                  TaskQueue* reply_queue) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            reply_queue->impl_.get());
+  // The reply is due once the task has run, which isn't known here.
+  return TaskQueue::impl_->PostTaskAndReply(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0),
+      WrapTaskForDispatchStats(std::move(reply),
+                               reply_queue->impl_->dispatch_stats(),
+                               kDispatchDelayUnknown),
+      reply_queue->impl_.get());
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            impl_.get());
+  return PostTaskAndReply(std::move(task), std::move(reply), this);
 }
 
 void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                 uint32_t milliseconds) {
-  return TaskQueue::impl_->PostDelayedTask(std::move(task), milliseconds);
+  return TaskQueue::impl_->PostDelayedTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(),
+                               milliseconds),
+      milliseconds);
 }
 
 }  // namespace rtc
@@ -0,0 +1,526 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// A TaskQueue implementation that runs all queues on a shared pool of worker
+// threads instead of giving every queue a thread of its own. Each queue is a
+// strand: its tasks run in FIFO order, on at most one worker at a time. A
+// queue with pending tasks sits in the run queue of one worker; idle workers
+// steal queues from busy ones.
+//
+// Since workers are shared, a task that blocks (e.g. waits on an rtc::Event
+// set by another queue) holds up a worker for as long as it blocks. The pool
+// always has a few more workers than there are cores, but code that blocks
+// for long periods should have a queue of its own on the default backend.
+//
+// Queue priorities are ignored.
+
+#include "rtc_base/task_queue.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/dispatch_stats.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/task_queue_posix.h"
+#include "rtc_base/timerwheel.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/virtual_time.h"
+
+namespace rtc {
+using internal::GetQueuePtrTls;
+
+namespace {
+// The number of tasks a worker runs from one queue before it gives the other
+// queues in its run queue a turn.
+const int kMaxTasksPerTurn = 16;
+
+// Workers blocked in a task should not starve the whole process on machines
+// with few cores, so the pool never has fewer than this many workers.
+const int kMinWorkers = 4;
+const int kMaxWorkers = 64;
+}  // namespace
+
+class TaskQueue::Impl : public RefCountInterface {
+ public:
+  class WorkerPool;
+
+  Impl(const char* queue_name, TaskQueue* queue);
+  ~Impl() override;
+
+  static TaskQueue::Impl* Current();
+  static TaskQueue* CurrentQueue();
+
+  // Used for DCHECKing the current queue.
+  bool IsCurrent() const;
+
+  DispatchStatsRecorder* dispatch_stats() const { return dispatch_stats_; }
+
+  void PostTask(std::unique_ptr<QueuedTask> task);
+  void PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                        std::unique_ptr<QueuedTask> reply,
+                        TaskQueue::Impl* reply_queue);
+
+  void PostDelayedTask(std::unique_ptr<QueuedTask> task, uint32_t milliseconds);
+
+  // Called when the TaskQueue is deleted. Waits for a running task to finish
+  // and deletes the pending and delayed tasks. Tasks posted afterwards are
+  // deleted right away.
+  void Stop();
+
+ private:
+  DispatchStatsRecorder* const dispatch_stats_;
+
+  class PostAndReplyTask;
+
+  // Runs up to kMaxTasksPerTurn tasks on the calling worker thread. Returns
+  // true if tasks are left and the queue needs to be scheduled again.
+  bool RunTasks(void* worker);
+
+  TaskQueue* const queue_;
+  // The worker running this queue, only used on that worker's thread.
+  void* worker_ = nullptr;
+  // Signaled every time a worker is done running tasks of this queue.
+  Event not_running_;
+  rtc::CriticalSection crit_;
+  std::deque<std::unique_ptr<QueuedTask>> pending_ RTC_GUARDED_BY(crit_);
+  // True while the queue is in a run queue or a worker runs its tasks.
+  bool scheduled_ RTC_GUARDED_BY(crit_) = false;
+  bool running_ RTC_GUARDED_BY(crit_) = false;
+  bool stopped_ RTC_GUARDED_BY(crit_) = false;
+};
+
+class TaskQueue::Impl::WorkerPool {
+ public:
+  // The pool is created on first use and never deleted.
+  static WorkerPool* Instance();
+
+  // Puts |queue| in a run queue, preferring the one of the calling worker.
+  void Schedule(scoped_refptr<TaskQueue::Impl> queue);
+  void PostDelayedTask(scoped_refptr<TaskQueue::Impl> queue,
+                       std::unique_ptr<QueuedTask> task,
+                       uint32_t milliseconds);
+  void CancelDelayedTasks(TaskQueue::Impl* queue);
+
+ private:
+  struct Worker {
+    Worker(WorkerPool* pool, size_t index);
+
+    WorkerPool* const pool;
+    const size_t index;
+    Event wakeup;
+    rtc::CriticalSection crit;
+    std::deque<scoped_refptr<TaskQueue::Impl>> run_queue RTC_GUARDED_BY(crit);
+    std::unique_ptr<PlatformThread> thread;
+  };
+
+  struct DelayedTask {
+    scoped_refptr<TaskQueue::Impl> queue;
+    std::unique_ptr<QueuedTask> task;
+  };
+
+  explicit WorkerPool(size_t num_workers);
+
+  static void WorkerMain(void* context);
+  static void TimerMain(void* context);
+
+  void RunWorker(Worker* worker);
+  void RunTimers();
+  // Takes the oldest queue from the run queue of |worker|, or steals the
+  // newest one from another worker. Returns null if there is no work.
+  scoped_refptr<TaskQueue::Impl> Take(Worker* worker);
+  void WakeIdleWorker();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_worker_{0};
+
+  rtc::CriticalSection idle_crit_;
+  std::vector<Worker*> idle_workers_ RTC_GUARDED_BY(idle_crit_);
+
+  // Delayed tasks of all queues. The timer thread advances the wheel and
+  // posts the expired tasks to their queues.
+  Event timer_wakeup_;
+  rtc::CriticalSection timer_crit_;
+  TimerWheel<DelayedTask> timers_ RTC_GUARDED_BY(timer_crit_);
+  // The time the timer thread is going to wake up, or -1 if it waits for new
+  // timers only.
+  int64_t timer_wakeup_time_ RTC_GUARDED_BY(timer_crit_) = -1;
+  PlatformThread timer_thread_;
+};
+
+class TaskQueue::Impl::PostAndReplyTask : public QueuedTask {
+ public:
+  PostAndReplyTask(std::unique_ptr<QueuedTask> task,
+                   std::unique_ptr<QueuedTask> reply,
+                   TaskQueue::Impl* reply_queue)
+      : task_(std::move(task)),
+        reply_(std::move(reply)),
+        reply_queue_(reply_queue) {}
+
+ private:
+  bool Run() override {
+    if (!task_->Run())
+      task_.release();
+    // If the reply queue has been deleted in the meantime, the reply is
+    // deleted by PostTask().
+    reply_queue_->PostTask(std::move(reply_));
+    return true;
+  }
+
+  std::unique_ptr<QueuedTask> task_;
+  std::unique_ptr<QueuedTask> reply_;
+  scoped_refptr<TaskQueue::Impl> reply_queue_;
+};
+
+TaskQueue::Impl::WorkerPool::Worker::Worker(WorkerPool* pool, size_t index)
+    : pool(pool), index(index), wakeup(false, false) {}
+
+TaskQueue::Impl::WorkerPool::WorkerPool(size_t num_workers)
+    : timer_wakeup_(false, false),
+      timer_thread_(&WorkerPool::TimerMain, this, "TaskQueuePoolTimer") {
+  for (size_t i = 0; i < num_workers; ++i) {
+    std::unique_ptr<Worker> worker(new Worker(this, i));
+    worker->thread.reset(
+        new PlatformThread(&WorkerPool::WorkerMain, worker.get(),
+                           "TaskQueuePoolWorker"));
+    workers_.push_back(std::move(worker));
+  }
+  for (auto& worker : workers_)
+    worker->thread->Start();
+  timer_thread_.Start();
+}
+
+// static
+TaskQueue::Impl::WorkerPool* TaskQueue::Impl::WorkerPool::Instance() {
+  static WorkerPool* const pool = [] {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int num_workers = std::min(
+        kMaxWorkers, std::max(kMinWorkers, static_cast<int>(cores) + 2));
+    RTC_LOG(LS_INFO) << "Starting TaskQueue pool with " << num_workers
+                     << " workers.";
+    return new WorkerPool(num_workers);
+  }();
+  return pool;
+}
+
+void TaskQueue::Impl::WorkerPool::Schedule(
+    scoped_refptr<TaskQueue::Impl> queue) {
+  TaskQueue::Impl* current = TaskQueue::Impl::Current();
+  Worker* worker = current ? static_cast<Worker*>(current->worker_) : nullptr;
+  if (!worker)
+    worker = workers_[next_worker_++ % workers_.size()].get();
+  {
+    CritScope lock(&worker->crit);
+    worker->run_queue.push_back(std::move(queue));
+  }
+  WakeIdleWorker();
+}
+
+void TaskQueue::Impl::WorkerPool::PostDelayedTask(
+    scoped_refptr<TaskQueue::Impl> queue,
+    std::unique_ptr<QueuedTask> task,
+    uint32_t milliseconds) {
+  // Like the libevent backend, the wheel runs on the system clock, so that
+  // delayed tasks are not held up by a fake clock.
+  bool wake_up;
+  {
+    CritScope lock(&timer_crit_);
+    int64_t now = SystemTimeMillis();
+    timers_.Insert(now, now + milliseconds,
+                   DelayedTask{std::move(queue), std::move(task)});
+    int64_t next = timers_.NextAdvanceTime();
+    wake_up = timer_wakeup_time_ < 0 || next < timer_wakeup_time_;
+  }
+  if (wake_up)
+    timer_wakeup_.Set();
+}
+
+void TaskQueue::Impl::WorkerPool::CancelDelayedTasks(TaskQueue::Impl* queue) {
+  std::vector<DelayedTask> cancelled;
+  {
+    CritScope lock(&timer_crit_);
+    timers_.RemoveIf(
+        [queue](const DelayedTask& t) { return t.queue.get() == queue; },
+        &cancelled);
+  }
+  // The tasks are deleted here, without holding |timer_crit_|.
+}
+
+// static
+void TaskQueue::Impl::WorkerPool::WorkerMain(void* context) {
+  Worker* worker = static_cast<Worker*>(context);
+  worker->pool->RunWorker(worker);
+}
+
+// static
+void TaskQueue::Impl::WorkerPool::TimerMain(void* context) {
+  static_cast<WorkerPool*>(context)->RunTimers();
+}
+
+void TaskQueue::Impl::WorkerPool::RunWorker(Worker* worker) {
+  while (true) {
+    scoped_refptr<TaskQueue::Impl> queue = Take(worker);
+    if (!queue) {
+      // Register as idle before looking for work once more, so that a queue
+      // scheduled in between is not missed.
+      {
+        CritScope lock(&idle_crit_);
+        idle_workers_.push_back(worker);
+      }
+      queue = Take(worker);
+      if (!queue)
+        worker->wakeup.Wait(Event::kForever);
+      {
+        CritScope lock(&idle_crit_);
+        auto it =
+            std::find(idle_workers_.begin(), idle_workers_.end(), worker);
+        if (it != idle_workers_.end())
+          idle_workers_.erase(it);
+      }
+      if (!queue)
+        continue;
+    }
+    if (queue->RunTasks(worker)) {
+      bool others_waiting;
+      {
+        CritScope lock(&worker->crit);
+        others_waiting = !worker->run_queue.empty();
+        worker->run_queue.push_back(std::move(queue));
+      }
+      if (others_waiting)
+        WakeIdleWorker();
+    }
+  }
+}
+
+void TaskQueue::Impl::WorkerPool::RunTimers() {
+  std::vector<DelayedTask> expired;
+  while (true) {
+    int64_t now = SystemTimeMillis();
+    int64_t next;
+    {
+      CritScope lock(&timer_crit_);
+      timers_.Advance(now, &expired);
+      next = timers_.NextAdvanceTime();
+      timer_wakeup_time_ = next;
+    }
+    for (DelayedTask& delayed : expired)
+      delayed.queue->PostTask(std::move(delayed.task));
+    expired.clear();
+    timer_wakeup_.Wait(next < 0 ? Event::kForever
+                                : static_cast<int>(std::max<int64_t>(
+                                      0, next - SystemTimeMillis())));
+  }
+}
+
+scoped_refptr<TaskQueue::Impl> TaskQueue::Impl::WorkerPool::Take(
+    Worker* worker) {
+  scoped_refptr<TaskQueue::Impl> queue;
+  {
+    CritScope lock(&worker->crit);
+    if (!worker->run_queue.empty()) {
+      queue = std::move(worker->run_queue.front());
+      worker->run_queue.pop_front();
+      return queue;
+    }
+  }
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker* victim = workers_[(worker->index + i) % workers_.size()].get();
+    CritScope lock(&victim->crit);
+    if (!victim->run_queue.empty()) {
+      queue = std::move(victim->run_queue.back());
+      victim->run_queue.pop_back();
+      return queue;
+    }
+  }
+  return queue;
+}
+
+void TaskQueue::Impl::WorkerPool::WakeIdleWorker() {
+  Worker* idle = nullptr;
+  {
+    CritScope lock(&idle_crit_);
+    if (!idle_workers_.empty()) {
+      idle = idle_workers_.back();
+      idle_workers_.pop_back();
+    }
+  }
+  if (idle)
+    idle->wakeup.Set();
+}
+
+TaskQueue::Impl::Impl(const char* queue_name, TaskQueue* queue)
+    : dispatch_stats_(DispatchStatsRecorder::ForQueue(queue_name)),
+      queue_(queue),
+      not_running_(false, false) {
+  RTC_CHECK(!VirtualTimeController::Get())
+      << "Virtual time needs the libevent TaskQueue.";
+}
+
+TaskQueue::Impl::~Impl() {
+  RTC_DCHECK(pending_.empty());
+}
+
+// static
+TaskQueue::Impl* TaskQueue::Impl::Current() {
+  return static_cast<TaskQueue::Impl*>(pthread_getspecific(GetQueuePtrTls()));
+}
+
+// static
+TaskQueue* TaskQueue::Impl::CurrentQueue() {
+  TaskQueue::Impl* current = Current();
+  if (current) {
+    return current->queue_;
+  }
+  return nullptr;
+}
+
+bool TaskQueue::Impl::IsCurrent() const {
+  return Current() == this;
+}
+
+void TaskQueue::Impl::PostTask(std::unique_ptr<QueuedTask> task) {
+  RTC_DCHECK(task.get());
+  {
+    CritScope lock(&crit_);
+    // Tasks posted to a deleted queue are deleted when |task| goes out of
+    // scope, after the lock has been released.
+    if (stopped_)
+      return;
+    pending_.push_back(std::move(task));
+    if (scheduled_)
+      return;
+    scheduled_ = true;
+  }
+  WorkerPool::Instance()->Schedule(this);
+}
+
+void TaskQueue::Impl::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                      uint32_t milliseconds) {
+  WorkerPool::Instance()->PostDelayedTask(this, std::move(task), milliseconds);
+}
+
+void TaskQueue::Impl::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                       std::unique_ptr<QueuedTask> reply,
+                                       TaskQueue::Impl* reply_queue) {
+  PostTask(std::unique_ptr<QueuedTask>(
+      new PostAndReplyTask(std::move(task), std::move(reply), reply_queue)));
+}
+
+void TaskQueue::Impl::Stop() {
+  RTC_DCHECK(!IsCurrent());
+  std::deque<std::unique_ptr<QueuedTask>> pending;
+  {
+    CritScope lock(&crit_);
+    stopped_ = true;
+    pending.swap(pending_);
+  }
+  WorkerPool::Instance()->CancelDelayedTasks(this);
+  while (true) {
+    {
+      CritScope lock(&crit_);
+      if (!running_)
+        break;
+    }
+    not_running_.Wait(Event::kForever);
+  }
+}
+
+bool TaskQueue::Impl::RunTasks(void* worker) {
+  RTC_DCHECK(!Current());
+  worker_ = worker;
+  pthread_setspecific(GetQueuePtrTls(), this);
+  for (int i = 0; i < kMaxTasksPerTurn; ++i) {
+    std::unique_ptr<QueuedTask> task;
+    {
+      CritScope lock(&crit_);
+      if (stopped_ || pending_.empty())
+        break;
+      task = std::move(pending_.front());
+      pending_.pop_front();
+      running_ = true;
+    }
+    if (!task->Run())
+      task.release();
+  }
+  pthread_setspecific(GetQueuePtrTls(), nullptr);
+  worker_ = nullptr;
+
+  bool run_again;
+  {
+    CritScope lock(&crit_);
+    running_ = false;
+    run_again = !stopped_ && !pending_.empty();
+    scheduled_ = run_again;
+  }
+  not_running_.Set();
+  return run_again;
+}
+
+TaskQueue::TaskQueue(const char* queue_name, Priority priority)
+    : impl_(new RefCountedObject<TaskQueue::Impl>(queue_name, this)) {
+  RTC_DCHECK(queue_name);
+}
+
+TaskQueue::~TaskQueue() {
+  impl_->Stop();
+}
+
+// static
+TaskQueue* TaskQueue::Current() {
+  return TaskQueue::Impl::CurrentQueue();
+}
+
+// Used for DCHECKing the current queue.
+bool TaskQueue::IsCurrent() const {
+  return impl_->IsCurrent();
+}
+
+void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
+  return TaskQueue::impl_->PostTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0));
+}
+
+void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                 std::unique_ptr<QueuedTask> reply,
+                                 TaskQueue* reply_queue) {
+  // The reply is due once the task has run, which isn't known here.
+  return TaskQueue::impl_->PostTaskAndReply(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0),
+      WrapTaskForDispatchStats(std::move(reply),
+                               reply_queue->impl_->dispatch_stats(),
+                               kDispatchDelayUnknown),
+      reply_queue->impl_.get());
+}
+
+void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                 std::unique_ptr<QueuedTask> reply) {
+  return PostTaskAndReply(std::move(task), std::move(reply), this);
+}
+
+void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                uint32_t milliseconds) {
+  return TaskQueue::impl_->PostDelayedTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(),
+                               milliseconds),
+      milliseconds);
+}
+
+}  // namespace rtc
@@ -30,6 +30,7 @@
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/dispatch_stats.h"
 #include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
@@ -37,6 +38,7 @@
 #include "rtc_base/refcount.h"
 #include "rtc_base/refcountedobject.h"
 #include "rtc_base/timeutils.h"
+#include "rtc_base/virtual_time.h"
 
 namespace rtc {
 namespace {
@@ -181,6 +183,8 @@ class TaskQueue::Impl : public RefCountInterface {
   // Used for DCHECKing the current queue.
   bool IsCurrent() const;
 
+  DispatchStatsRecorder* dispatch_stats() const { return dispatch_stats_; }
+
   template <class Closure,
             typename std::enable_if<!std::is_convertible<
                 Closure,
@@ -199,6 +203,8 @@ class TaskQueue::Impl : public RefCountInterface {
   void RunPendingTasks();
 
  private:
+  DispatchStatsRecorder* const dispatch_stats_;
+
   static void ThreadMain(void* context);
 
   class WorkerThread : public PlatformThread {
@@ -257,7 +263,8 @@ class TaskQueue::Impl : public RefCountInterface {
 TaskQueue::Impl::Impl(const char* queue_name,
                       TaskQueue* queue,
                       Priority priority)
-    : queue_(queue),
+    : dispatch_stats_(DispatchStatsRecorder::ForQueue(queue_name)),
+      queue_(queue),
       thread_(&TaskQueue::Impl::ThreadMain,
               this,
               queue_name,
@@ -265,6 +272,8 @@ TaskQueue::Impl::Impl(const char* queue_name,
       in_queue_(::CreateEvent(nullptr, true, false, nullptr)) {
   RTC_DCHECK(queue_name);
   RTC_DCHECK(in_queue_);
+  RTC_CHECK(!VirtualTimeController::Get())
+      << "Virtual time needs the libevent TaskQueue.";
   thread_.Start();
   Event event(false, false);
   ThreadStartupData startup = {&event, this};
@@ -497,25 +506,33 @@ bool TaskQueue::IsCurrent() const {
 }
 
 void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
-  return TaskQueue::impl_->PostTask(std::move(task));
+  return TaskQueue::impl_->PostTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0));
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply,
                                  TaskQueue* reply_queue) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            reply_queue->impl_.get());
+  // The reply is due once the task has run, which isn't known here.
+  return TaskQueue::impl_->PostTaskAndReply(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(), 0),
+      WrapTaskForDispatchStats(std::move(reply),
+                               reply_queue->impl_->dispatch_stats(),
+                               kDispatchDelayUnknown),
+      reply_queue->impl_.get());
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            impl_.get());
+  return PostTaskAndReply(std::move(task), std::move(reply), this);
 }
 
 void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                 uint32_t milliseconds) {
-  return TaskQueue::impl_->PostDelayedTask(std::move(task), milliseconds);
+  return TaskQueue::impl_->PostDelayedTask(
+      WrapTaskForDispatchStats(std::move(task), impl_->dispatch_stats(),
+                               milliseconds),
+      milliseconds);
 }
 
 }  // namespace rtc
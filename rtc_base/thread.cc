@@ -31,6 +31,7 @@
 #include "rtc_base/stringutils.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
+#include "rtc_base/virtual_time.h"
 
 namespace rtc {
 
@@ -170,6 +171,11 @@ std::unique_ptr<Thread> Thread::Create() {
 bool Thread::SleepMs(int milliseconds) {
   AssertBlockingIsAllowedOnCurrentThread();
 
+  if (VirtualTimeController* virtual_time = VirtualTimeController::Get()) {
+    virtual_time->Sleep(milliseconds * kNumMicrosecsPerMillisec);
+    return true;
+  }
+
 #if defined(WEBRTC_WIN)
   ::Sleep(milliseconds);
   return true;
@@ -197,6 +203,7 @@ bool Thread::SetName(const std::string& name, const void* obj) {
     sprintfn(buf, sizeof(buf), " 0x%p", obj);
     name_ += buf;
   }
+  SetDispatchStatsName(name);
   return true;
 }
 
@@ -217,9 +224,15 @@ bool Thread::Start(Runnable* runnable) {
   ThreadInit* init = new ThreadInit;
   init->thread = this;
   init->runnable = runnable;
+  init->virtual_time = VirtualTimeController::Get();
+  if (init->virtual_time)
+    init->virtual_time->AddThread();
 #if defined(WEBRTC_WIN)
   thread_ = CreateThread(nullptr, 0, PreRun, init, 0, &thread_id_);
   if (!thread_) {
+    if (init->virtual_time)
+      init->virtual_time->RemoveThread();
+    delete init;
     return false;
   }
 #elif defined(WEBRTC_POSIX)
@@ -230,6 +243,9 @@ bool Thread::Start(Runnable* runnable) {
   if (0 != error_code) {
     RTC_LOG(LS_ERROR) << "Unable to create pthread, error " << error_code;
     thread_ = 0;
+    if (init->virtual_time)
+      init->virtual_time->RemoveThread();
+    delete init;
     return false;
   }
   RTC_DCHECK(thread_);
@@ -309,10 +325,14 @@ void* Thread::PreRun(void* pv) {
   ThreadInit* init = static_cast<ThreadInit*>(pv);
   ThreadManager::Instance()->SetCurrentThread(init->thread);
   rtc::SetCurrentThreadName(init->thread->name_.c_str());
-  if (init->runnable) {
-    init->runnable->Run(init->thread);
-  } else {
-    init->thread->Run();
+  rtc::NotifyThreadStarted(init->thread->name_.c_str());
+  {
+    VirtualTimeController::ThreadScope virtual_time_scope(init->virtual_time);
+    if (init->runnable) {
+      init->runnable->Run(init->thread);
+    } else {
+      init->thread->Run();
+    }
   }
   ThreadManager::Instance()->SetCurrentThread(nullptr);
   delete init;
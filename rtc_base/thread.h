@@ -32,6 +32,7 @@
 namespace rtc {
 
 class Thread;
+class VirtualTimeController;
 
 class ThreadManager {
  public:
@@ -245,6 +246,8 @@ class RTC_LOCKABLE Thread : public MessageQueue {
   struct ThreadInit {
     Thread* thread;
     Runnable* runnable;
+    // Set if the thread was started on virtual time.
+    VirtualTimeController* virtual_time;
   };
 
 #if defined(WEBRTC_WIN)
@@ -13,6 +13,7 @@
 #import <Foundation/Foundation.h>
 
 #include "rtc_base/platform_thread.h"
+#include "rtc_base/virtual_time.h"
 
 /*
  * This file contains platform-specific implementations for several
@@ -50,7 +51,9 @@ void* Thread::PreRun(void* pv) {
   ThreadInit* init = static_cast<ThreadInit*>(pv);
   ThreadManager::Instance()->SetCurrentThread(init->thread);
   rtc::SetCurrentThreadName(init->thread->name_.c_str());
+  rtc::NotifyThreadStarted(init->thread->name_.c_str());
   @autoreleasepool {
+    VirtualTimeController::ThreadScope virtual_time_scope(init->virtual_time);
     if (init->runnable) {
       init->runnable->Run(init->thread);
     } else {
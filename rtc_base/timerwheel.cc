@@ -0,0 +1,32 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/timerwheel.h"
+
+#include <atomic>
+
+namespace rtc {
+
+namespace {
+
+std::atomic<int64_t> g_default_resolution_ms(1);
+
+}  // namespace
+
+void SetDefaultTimerWheelResolution(int64_t resolution_ms) {
+  RTC_DCHECK_GT(resolution_ms, 0);
+  g_default_resolution_ms.store(resolution_ms, std::memory_order_relaxed);
+}
+
+int64_t DefaultTimerWheelResolution() {
+  return g_default_resolution_ms.load(std::memory_order_relaxed);
+}
+
+}  // namespace rtc
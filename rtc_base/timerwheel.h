@@ -0,0 +1,374 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TIMERWHEEL_H_
+#define RTC_BASE_TIMERWHEEL_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/constructormagic.h"
+
+namespace rtc {
+
+// The tick resolution used by timer wheels that are not given one explicitly,
+// i.e. by MessageQueue and TaskQueue. Defaults to 1 ms. Changing it only
+// affects queues created afterwards.
+void SetDefaultTimerWheelResolution(int64_t resolution_ms);
+int64_t DefaultTimerWheelResolution();
+
+// A hierarchical timer wheel holding values of type T until their deadline.
+// Insert() and Cancel() are O(1); Advance() costs O(1) per expired timer plus
+// an amortized O(1) per timer for every time it moves down a level.
+//
+// Time is divided into ticks of |resolution_ms|. The wheel has kNumLevels
+// levels of kSlotsPerLevel slots, where a slot on level k spans 64^k ticks.
+// A timer is put on the lowest level whose span reaches its deadline from the
+// current tick, and is moved to the level below when the current tick enters
+// its slot. Timers never expire early; they expire at the first tick boundary
+// at or after their deadline.
+//
+// Not thread safe.
+template <typename T>
+class TimerWheel {
+ public:
+  class Timer {
+   public:
+    int64_t deadline_ms() const { return deadline_ms_; }
+    const T& value() const { return value_; }
+
+   private:
+    friend class TimerWheel;
+
+    Timer(int64_t deadline_ms, uint64_t sequence, T value)
+        : deadline_ms_(deadline_ms),
+          sequence_(sequence),
+          value_(std::move(value)) {}
+
+    const int64_t deadline_ms_;
+    // Used to expire timers with the same deadline in insertion order.
+    const uint64_t sequence_;
+    T value_;
+    int level_ = -1;
+    int slot_ = 0;
+    Timer* prev_ = nullptr;
+    Timer* next_ = nullptr;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(Timer);
+  };
+
+  explicit TimerWheel(int64_t resolution_ms = DefaultTimerWheelResolution())
+      : resolution_ms_(resolution_ms) {
+    RTC_DCHECK_GT(resolution_ms_, 0);
+  }
+
+  ~TimerWheel() {
+    RemoveIf([](const T&) { return true; }, nullptr);
+  }
+
+  int64_t resolution_ms() const { return resolution_ms_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Adds a timer expiring at |deadline_ms|. |now_ms| is only used to start
+  // counting ticks when the wheel is empty. The returned handle stays valid
+  // until the timer expires or is cancelled.
+  Timer* Insert(int64_t now_ms, int64_t deadline_ms, T value) {
+    if (size_ == 0)
+      current_tick_ = FloorTick(now_ms);
+    Timer* timer = new Timer(deadline_ms, next_sequence_++, std::move(value));
+    Place(timer);
+    ++size_;
+    return timer;
+  }
+
+  // Removes |timer| and returns its value.
+  T Cancel(Timer* timer) {
+    RTC_DCHECK(timer);
+    Unlink(timer);
+    --size_;
+    T value = std::move(timer->value_);
+    delete timer;
+    return value;
+  }
+
+  // Removes all timers whose value satisfies |predicate|, appending their
+  // values to |removed| unless it is null. The timers are all unlinked before
+  // any value is destroyed, so destructors may use the wheel.
+  template <typename Predicate>
+  void RemoveIf(Predicate predicate, std::vector<T>* removed) {
+    std::vector<Timer*> timers;
+    CollectIf(&due_, predicate, &timers);
+    for (int level = 0; level < kNumLevels; ++level) {
+      uint64_t occupied = occupied_[level];
+      while (occupied) {
+        int slot = LowestSetBit(occupied);
+        occupied &= occupied - 1;
+        CollectIf(&slots_[level][slot], predicate, &timers);
+      }
+    }
+    size_ -= timers.size();
+    for (Timer* timer : timers) {
+      if (removed)
+        removed->push_back(std::move(timer->value_));
+      delete timer;
+    }
+  }
+
+  // Expires all timers with a deadline at or before the tick containing
+  // |now_ms|, appending their values to |expired| in deadline order (and in
+  // insertion order for equal deadlines).
+  void Advance(int64_t now_ms, std::vector<T>* expired) {
+    const int64_t target = FloorTick(now_ms);
+    if (target < current_tick_) {
+      // The clock went backwards, e.g. because a fake clock was installed.
+      Rebase(target);
+    }
+    while (true) {
+      int64_t next = NextEventTick();
+      if (next < 0 || next > target)
+        break;
+      current_tick_ = next;
+      // Cascade from the top, so that timers reaching level 0 expire now.
+      for (int level = kNumLevels - 1; level > 0; --level) {
+        if ((current_tick_ & LevelMask(level)) != 0)
+          continue;
+        CascadeSlot(level, Digit(current_tick_, level));
+      }
+      const int slot = Digit(current_tick_, 0);
+      if (occupied_[0] & (uint64_t{1} << slot)) {
+        List* list = &slots_[0][slot];
+        while (Timer* timer = list->head) {
+          Unlink(timer);
+          Append(&due_, timer, -1, 0);
+        }
+      }
+    }
+    current_tick_ = std::max(current_tick_, target);
+
+    if (!due_.head)
+      return;
+    std::vector<Timer*> timers;
+    while (Timer* timer = due_.head) {
+      Unlink(timer);
+      timers.push_back(timer);
+    }
+    std::sort(timers.begin(), timers.end(), [](Timer* a, Timer* b) {
+      return a->deadline_ms_ != b->deadline_ms_
+                 ? a->deadline_ms_ < b->deadline_ms_
+                 : a->sequence_ < b->sequence_;
+    });
+    size_ -= timers.size();
+    for (Timer* timer : timers) {
+      expired->push_back(std::move(timer->value_));
+      delete timer;
+    }
+  }
+
+  // Returns the time at which Advance() next needs to be called, or -1 if the
+  // wheel is empty. This is never later than the earliest deadline, but may be
+  // earlier when timers need to be moved down a level.
+  int64_t NextAdvanceTime() const {
+    if (due_.head)
+      return current_tick_ * resolution_ms_;
+    int64_t next = NextEventTick();
+    return next < 0 ? -1 : next * resolution_ms_;
+  }
+
+ private:
+  static const int kBitsPerLevel = 6;
+  static const int kSlotsPerLevel = 1 << kBitsPerLevel;
+  // Enough levels to cover all 64 bit tick values.
+  static const int kNumLevels = (64 + kBitsPerLevel - 1) / kBitsPerLevel;
+
+  struct List {
+    Timer* head = nullptr;
+    Timer* tail = nullptr;
+  };
+
+  static int Digit(int64_t tick, int level) {
+    return static_cast<int>((static_cast<uint64_t>(tick) >>
+                             (level * kBitsPerLevel)) &
+                            (kSlotsPerLevel - 1));
+  }
+
+  // Mask of the tick bits below |level|.
+  static int64_t LevelMask(int level) {
+    return static_cast<int64_t>((uint64_t{1} << (level * kBitsPerLevel)) - 1);
+  }
+
+  static int LowestSetBit(uint64_t value) {
+    RTC_DCHECK_NE(value, 0);
+    int bit = 0;
+    while (!(value & 0xff)) {
+      value >>= 8;
+      bit += 8;
+    }
+    while (!(value & 1)) {
+      value >>= 1;
+      ++bit;
+    }
+    return bit;
+  }
+
+  int64_t FloorTick(int64_t time_ms) const {
+    int64_t tick = time_ms / resolution_ms_;
+    return (time_ms % resolution_ms_ < 0) ? tick - 1 : tick;
+  }
+
+  int64_t CeilTick(int64_t time_ms) const {
+    int64_t tick = FloorTick(time_ms);
+    return tick * resolution_ms_ < time_ms ? tick + 1 : tick;
+  }
+
+  // Puts |timer| on the level and slot for its deadline relative to
+  // |current_tick_|, or on |due_| if it has expired.
+  void Place(Timer* timer) {
+    const int64_t deadline_tick = CeilTick(timer->deadline_ms_);
+    if (deadline_tick <= current_tick_) {
+      Append(&due_, timer, -1, 0);
+      return;
+    }
+    // The level is the highest digit in which the deadline differs from the
+    // current tick. Timers on level k thus share all digits above k with the
+    // current tick, and have a larger digit k.
+    uint64_t diff = static_cast<uint64_t>(deadline_tick ^ current_tick_);
+    int level = 0;
+    while (diff >> kBitsPerLevel) {
+      diff >>= kBitsPerLevel;
+      ++level;
+    }
+    const int slot = Digit(deadline_tick, level);
+    Append(&slots_[level][slot], timer, level, slot);
+    occupied_[level] |= uint64_t{1} << slot;
+  }
+
+  void Append(List* list, Timer* timer, int level, int slot) {
+    timer->level_ = level;
+    timer->slot_ = slot;
+    timer->next_ = nullptr;
+    timer->prev_ = list->tail;
+    if (list->tail) {
+      list->tail->next_ = timer;
+    } else {
+      list->head = timer;
+    }
+    list->tail = timer;
+  }
+
+  void Unlink(Timer* timer) {
+    List* list =
+        timer->level_ < 0 ? &due_ : &slots_[timer->level_][timer->slot_];
+    if (timer->prev_) {
+      timer->prev_->next_ = timer->next_;
+    } else {
+      list->head = timer->next_;
+    }
+    if (timer->next_) {
+      timer->next_->prev_ = timer->prev_;
+    } else {
+      list->tail = timer->prev_;
+    }
+    if (timer->level_ >= 0 && !list->head)
+      occupied_[timer->level_] &= ~(uint64_t{1} << timer->slot_);
+    timer->prev_ = timer->next_ = nullptr;
+  }
+
+  void CascadeSlot(int level, int slot) {
+    if (!(occupied_[level] & (uint64_t{1} << slot)))
+      return;
+    List* list = &slots_[level][slot];
+    while (Timer* timer = list->head) {
+      Unlink(timer);
+      Place(timer);
+    }
+  }
+
+  // Returns the next tick at which a slot needs to be expired or cascaded, or
+  // -1 if there is none.
+  int64_t NextEventTick() const {
+    // Timers on lower levels always expire before those on higher levels, so
+    // the first occupied slot found is the next one.
+    for (int level = 0; level < kNumLevels; ++level) {
+      const int digit = Digit(current_tick_, level);
+      const uint64_t later =
+          digit + 1 < kSlotsPerLevel
+              ? occupied_[level] & ~((uint64_t{2} << digit) - 1)
+              : 0;
+      if (!later)
+        continue;
+      const int shift = (level + 1) * kBitsPerLevel;
+      const uint64_t base =
+          shift < 64
+              ? (static_cast<uint64_t>(current_tick_) >> shift) << shift
+              : 0;
+      return static_cast<int64_t>(
+          base | (static_cast<uint64_t>(LowestSetBit(later))
+                  << (level * kBitsPerLevel)));
+    }
+    return -1;
+  }
+
+  // Re-places all timers relative to |tick|.
+  void Rebase(int64_t tick) {
+    std::vector<Timer*> timers;
+    CollectAll(&due_, &timers);
+    for (int level = 0; level < kNumLevels; ++level) {
+      while (occupied_[level]) {
+        CollectAll(&slots_[level][LowestSetBit(occupied_[level])], &timers);
+      }
+    }
+    current_tick_ = tick;
+    for (Timer* timer : timers)
+      Place(timer);
+  }
+
+  void CollectAll(List* list, std::vector<Timer*>* timers) {
+    while (Timer* timer = list->head) {
+      Unlink(timer);
+      timers->push_back(timer);
+    }
+  }
+
+  template <typename Predicate>
+  void CollectIf(List* list,
+                 Predicate& predicate,
+                 std::vector<Timer*>* timers) {
+    Timer* timer = list->head;
+    while (timer) {
+      Timer* next = timer->next_;
+      if (predicate(static_cast<const T&>(timer->value_))) {
+        Unlink(timer);
+        timers->push_back(timer);
+      }
+      timer = next;
+    }
+  }
+
+  const int64_t resolution_ms_;
+  int64_t current_tick_ = 0;
+  uint64_t next_sequence_ = 0;
+  size_t size_ = 0;
+  // Timers that have expired but not yet been returned by Advance().
+  List due_;
+  List slots_[kNumLevels][kSlotsPerLevel];
+  // Bit i of occupied_[k] is set if slots_[k][i] is not empty.
+  uint64_t occupied_[kNumLevels] = {};
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_TIMERWHEEL_H_
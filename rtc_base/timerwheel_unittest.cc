@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/timerwheel.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/gunit.h"
+#include "rtc_base/random.h"
+
+namespace rtc {
+
+TEST(TimerWheelTest, ExpiresAtDeadline) {
+  TimerWheel<int> wheel(1);
+  wheel.Insert(1000, 1010, 1);
+  wheel.Insert(1000, 1005, 2);
+  EXPECT_EQ(2u, wheel.size());
+  EXPECT_EQ(1005, wheel.NextAdvanceTime());
+
+  std::vector<int> expired;
+  wheel.Advance(1004, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(1005, &expired);
+  EXPECT_EQ(std::vector<int>({2}), expired);
+  expired.clear();
+  wheel.Advance(1100, &expired);
+  EXPECT_EQ(std::vector<int>({1}), expired);
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(-1, wheel.NextAdvanceTime());
+}
+
+TEST(TimerWheelTest, ExpiredDeadlinesAreDueImmediately) {
+  TimerWheel<int> wheel(1);
+  wheel.Insert(1000, 990, 1);
+  wheel.Insert(1000, 1000, 2);
+  EXPECT_EQ(1000, wheel.NextAdvanceTime());
+  std::vector<int> expired;
+  wheel.Advance(1000, &expired);
+  EXPECT_EQ(std::vector<int>({1, 2}), expired);
+}
+
+TEST(TimerWheelTest, EqualDeadlinesExpireInInsertionOrder) {
+  TimerWheel<int> wheel(1);
+  // The first timer starts out on a higher level than the second one, which
+  // is inserted just before the deadline.
+  wheel.Insert(0, 5000, 1);
+  std::vector<int> expired;
+  wheel.Advance(4990, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Insert(4990, 5000, 2);
+  wheel.Insert(4990, 4999, 0);
+  wheel.Advance(5000, &expired);
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), expired);
+}
+
+TEST(TimerWheelTest, Cancel) {
+  TimerWheel<std::unique_ptr<int>> wheel(1);
+  auto* first = wheel.Insert(0, 100, std::unique_ptr<int>(new int(1)));
+  wheel.Insert(0, 100, std::unique_ptr<int>(new int(2)));
+  auto* third = wheel.Insert(0, 100000, std::unique_ptr<int>(new int(3)));
+  EXPECT_EQ(1, *wheel.Cancel(first));
+  EXPECT_EQ(3, *wheel.Cancel(third));
+  EXPECT_EQ(1u, wheel.size());
+
+  std::vector<std::unique_ptr<int>> expired;
+  wheel.Advance(100000, &expired);
+  ASSERT_EQ(1u, expired.size());
+  EXPECT_EQ(2, *expired[0]);
+}
+
+TEST(TimerWheelTest, RemoveIf) {
+  TimerWheel<int> wheel(1);
+  for (int i = 0; i < 10; ++i)
+    wheel.Insert(0, i * 1000, i);
+  std::vector<int> removed;
+  wheel.RemoveIf([](int value) { return value % 2 == 1; }, &removed);
+  EXPECT_EQ(5u, removed.size());
+  EXPECT_EQ(5u, wheel.size());
+
+  std::vector<int> expired;
+  wheel.Advance(10000, &expired);
+  EXPECT_EQ(std::vector<int>({0, 2, 4, 6, 8}), expired);
+}
+
+TEST(TimerWheelTest, CoarseResolutionNeverExpiresEarly) {
+  TimerWheel<int> wheel(10);
+  wheel.Insert(0, 15, 1);
+  EXPECT_EQ(20, wheel.NextAdvanceTime());
+  std::vector<int> expired;
+  wheel.Advance(19, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(20, &expired);
+  EXPECT_EQ(std::vector<int>({1}), expired);
+}
+
+TEST(TimerWheelTest, ClockGoingBackwards) {
+  TimerWheel<int> wheel(1);
+  wheel.Insert(100000, 100050, 1);
+  std::vector<int> expired;
+  wheel.Advance(10, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(100049, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(100050, &expired);
+  EXPECT_EQ(std::vector<int>({1}), expired);
+}
+
+TEST(TimerWheelTest, MatchesSortedOrderForRandomDeadlines) {
+  webrtc::Random random(12345);
+  TimerWheel<int64_t> wheel(1);
+  int64_t now = 1000000;
+  std::vector<int64_t> expired;
+  int64_t last_expired = 0;
+  size_t inserted = 0;
+  for (int step = 0; step < 2000; ++step) {
+    for (int i = 0; i < 5; ++i) {
+      // Mix short timers with ones spanning several levels.
+      int64_t delay = random.Rand(0, 3) == 0 ? random.Rand(0, 5000000)
+                                               : random.Rand(0, 100);
+      wheel.Insert(now, now + delay, now + delay);
+      ++inserted;
+    }
+    int64_t next = wheel.NextAdvanceTime();
+    ASSERT_GE(next, 0);
+    now = std::max(now, next) + random.Rand(0, 20);
+    size_t first = expired.size();
+    wheel.Advance(now, &expired);
+    for (size_t i = first; i < expired.size(); ++i) {
+      EXPECT_LE(expired[i], now);
+      EXPECT_GE(expired[i], last_expired);
+      last_expired = expired[i];
+    }
+    EXPECT_TRUE(wheel.empty() || wheel.NextAdvanceTime() > now);
+  }
+  wheel.Advance(now + 10000000, &expired);
+  EXPECT_EQ(inserted, expired.size());
+  EXPECT_TRUE(wheel.empty());
+}
+
+}  // namespace rtc
@@ -0,0 +1,301 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/virtual_time.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+
+namespace rtc {
+namespace {
+const int64_t kNoDeadline = std::numeric_limits<int64_t>::max();
+}  // namespace
+
+struct VirtualTimeController::Waiter {
+  Waiter(Event* event, int64_t deadline_us, bool included)
+      : event(event), deadline_us(deadline_us), included(included) {}
+
+  // Null for Sleep().
+  Event* const event;
+  const int64_t deadline_us;
+  // Whether the waiting thread is counted in |busy_threads_| when awake.
+  const bool included;
+  bool done = false;
+  bool signaled = false;
+};
+
+std::atomic<VirtualTimeController*> VirtualTimeController::current_(nullptr);
+
+VirtualTimeController::VirtualTimeController(int64_t start_time_us)
+    : previous_clock_(SetClockForTesting(this)),
+      time_us_(start_time_us),
+      busy_threads_(1) {
+#if defined(WEBRTC_WIN)
+  InitializeCriticalSection(&lock_);
+  InitializeConditionVariable(&signal_);
+  thread_key_ = TlsAlloc();
+  RTC_CHECK_NE(TLS_OUT_OF_INDEXES, thread_key_);
+#elif defined(WEBRTC_POSIX)
+  RTC_CHECK_EQ(0, pthread_mutex_init(&lock_, nullptr));
+  RTC_CHECK_EQ(0, pthread_cond_init(&signal_, nullptr));
+  RTC_CHECK_EQ(0, pthread_key_create(&thread_key_, nullptr));
+#endif
+  VirtualTimeController* expected = nullptr;
+  RTC_CHECK(current_.compare_exchange_strong(expected, this))
+      << "Only one VirtualTimeController may exist at a time.";
+  SetCurrentThreadIncluded(true);
+}
+
+VirtualTimeController::~VirtualTimeController() {
+  RTC_DCHECK(IsCurrentThreadIncluded());
+  Lock();
+  RTC_DCHECK_EQ(1, busy_threads_) << "Threads are still running.";
+  RTC_DCHECK(!running_delayed_tasks_);
+  delayed_tasks_.clear();
+  Unlock();
+  SetCurrentThreadIncluded(false);
+  current_.store(nullptr);
+  SetClockForTesting(previous_clock_);
+#if defined(WEBRTC_WIN)
+  TlsFree(thread_key_);
+  DeleteCriticalSection(&lock_);
+#elif defined(WEBRTC_POSIX)
+  pthread_key_delete(thread_key_);
+  pthread_cond_destroy(&signal_);
+  pthread_mutex_destroy(&lock_);
+#endif
+}
+
+int64_t VirtualTimeController::TimeNanos() const {
+  return time_us_.load() * kNumNanosecsPerMicrosec;
+}
+
+bool VirtualTimeController::Wait(Event* event, int milliseconds) {
+  Lock();
+  int64_t deadline_us =
+      milliseconds == Event::kForever
+          ? kNoDeadline
+          : time_us_.load() + milliseconds * kNumMicrosecsPerMillisec;
+  bool signaled = WaitLocked(event, deadline_us);
+  Unlock();
+  return signaled;
+}
+
+void VirtualTimeController::OnEventSet() {
+  Lock();
+  bool woken = false;
+  for (auto it = waiters_.begin(); it != waiters_.end();) {
+    Waiter* waiter = *it;
+    // Only one waiter of an auto-reset event consumes the signal.
+    if (waiter->event && waiter->event->TryConsume()) {
+      it = waiters_.erase(it);
+      Wake(waiter, true);
+      woken = true;
+    } else {
+      ++it;
+    }
+  }
+  if (woken)
+    SignalAll();
+  Unlock();
+}
+
+void VirtualTimeController::Sleep(int64_t microseconds) {
+  Lock();
+  WaitLocked(nullptr, time_us_.load() + std::max<int64_t>(0, microseconds));
+  Unlock();
+}
+
+void VirtualTimeController::PostDelayedTask(const void* owner,
+                                            std::unique_ptr<QueuedTask> task,
+                                            int64_t microseconds) {
+  Lock();
+  delayed_tasks_.emplace(time_us_.load() + std::max<int64_t>(0, microseconds),
+                         DelayedTask{owner, std::move(task)});
+  Unlock();
+}
+
+void VirtualTimeController::CancelDelayedTasks(const void* owner) {
+  std::vector<std::unique_ptr<QueuedTask>> cancelled;
+  Lock();
+  while (running_delayed_tasks_)
+    WaitForSignal();
+  for (auto it = delayed_tasks_.begin(); it != delayed_tasks_.end();) {
+    if (it->second.owner == owner) {
+      cancelled.push_back(std::move(it->second.task));
+      it = delayed_tasks_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  Unlock();
+  // Deleted without the lock, in case they own objects using it.
+  cancelled.clear();
+}
+
+void VirtualTimeController::AddThread() {
+  Lock();
+  ++busy_threads_;
+  Unlock();
+}
+
+void VirtualTimeController::RemoveThread() {
+  Lock();
+  RTC_DCHECK_GT(busy_threads_, 0);
+  --busy_threads_;
+  MaybeAdvanceTime();
+  Unlock();
+}
+
+VirtualTimeController::ThreadScope::ThreadScope(
+    VirtualTimeController* controller)
+    : controller_(controller) {
+  if (controller_)
+    controller_->SetCurrentThreadIncluded(true);
+}
+
+VirtualTimeController::ThreadScope::~ThreadScope() {
+  if (controller_ && controller_ == VirtualTimeController::Get()) {
+    controller_->SetCurrentThreadIncluded(false);
+    controller_->RemoveThread();
+  }
+}
+
+bool VirtualTimeController::IsCurrentThreadIncluded() const {
+#if defined(WEBRTC_WIN)
+  return TlsGetValue(thread_key_) != nullptr;
+#elif defined(WEBRTC_POSIX)
+  return pthread_getspecific(thread_key_) != nullptr;
+#endif
+}
+
+void VirtualTimeController::SetCurrentThreadIncluded(bool included) {
+  void* value = included ? this : nullptr;
+#if defined(WEBRTC_WIN)
+  TlsSetValue(thread_key_, value);
+#elif defined(WEBRTC_POSIX)
+  pthread_setspecific(thread_key_, value);
+#endif
+}
+
+void VirtualTimeController::Lock() {
+#if defined(WEBRTC_WIN)
+  EnterCriticalSection(&lock_);
+#elif defined(WEBRTC_POSIX)
+  pthread_mutex_lock(&lock_);
+#endif
+}
+
+void VirtualTimeController::Unlock() {
+#if defined(WEBRTC_WIN)
+  LeaveCriticalSection(&lock_);
+#elif defined(WEBRTC_POSIX)
+  pthread_mutex_unlock(&lock_);
+#endif
+}
+
+void VirtualTimeController::WaitForSignal() {
+#if defined(WEBRTC_WIN)
+  SleepConditionVariableCS(&signal_, &lock_, INFINITE);
+#elif defined(WEBRTC_POSIX)
+  pthread_cond_wait(&signal_, &lock_);
+#endif
+}
+
+void VirtualTimeController::SignalAll() {
+#if defined(WEBRTC_WIN)
+  WakeAllConditionVariable(&signal_);
+#elif defined(WEBRTC_POSIX)
+  pthread_cond_broadcast(&signal_);
+#endif
+}
+
+bool VirtualTimeController::WaitLocked(Event* event, int64_t deadline_us) {
+  if (event && event->TryConsume())
+    return true;
+  if (deadline_us <= time_us_.load())
+    return false;
+
+  Waiter waiter(event, deadline_us, IsCurrentThreadIncluded());
+  waiters_.push_back(&waiter);
+  if (waiter.included) {
+    RTC_DCHECK_GT(busy_threads_, 0);
+    --busy_threads_;
+  }
+  MaybeAdvanceTime();
+  while (!waiter.done)
+    WaitForSignal();
+  return waiter.signaled;
+}
+
+void VirtualTimeController::Wake(Waiter* waiter, bool signaled) {
+  waiter->done = true;
+  waiter->signaled = signaled;
+  // Counted as busy right away, so that time doesn't advance before the
+  // thread has had a chance to run.
+  if (waiter->included)
+    ++busy_threads_;
+}
+
+void VirtualTimeController::MaybeAdvanceTime() {
+  while (busy_threads_ == 0 && !running_delayed_tasks_) {
+    int64_t next_us = kNoDeadline;
+    for (const Waiter* waiter : waiters_)
+      next_us = std::min(next_us, waiter->deadline_us);
+    if (!delayed_tasks_.empty())
+      next_us = std::min(next_us, delayed_tasks_.begin()->first);
+    // Everyone waits for someone else; time can't help.
+    if (next_us == kNoDeadline)
+      return;
+    if (next_us > time_us_.load())
+      time_us_.store(next_us);
+
+    const int64_t now_us = time_us_.load();
+    for (auto it = waiters_.begin(); it != waiters_.end();) {
+      if ((*it)->deadline_us <= now_us) {
+        Wake(*it, false);
+        it = waiters_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    SignalAll();
+
+    std::vector<std::unique_ptr<QueuedTask>> due;
+    while (!delayed_tasks_.empty() && delayed_tasks_.begin()->first <= now_us) {
+      due.push_back(std::move(delayed_tasks_.begin()->second.task));
+      delayed_tasks_.erase(delayed_tasks_.begin());
+    }
+    if (due.empty())
+      continue;
+    // The tasks typically post to a queue, which sets an event and so needs
+    // the lock. Counting as busy meanwhile keeps time where it is.
+    running_delayed_tasks_ = true;
+    ++busy_threads_;
+    Unlock();
+    for (std::unique_ptr<QueuedTask>& task : due) {
+      if (!task->Run())
+        task.release();
+      task.reset();
+    }
+    Lock();
+    --busy_threads_;
+    running_delayed_tasks_ = false;
+    // Wakes up CancelDelayedTasks().
+    SignalAll();
+  }
+}
+
+}  // namespace rtc
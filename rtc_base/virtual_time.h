@@ -0,0 +1,148 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_VIRTUAL_TIME_H_
+#define RTC_BASE_VIRTUAL_TIME_H_
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#elif defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+
+class Event;
+
+// Runs the threads of a test on virtual time, which stands still while any of
+// them has work to do and then jumps straight to the next time one of them
+// is due to wake up. Tests of timers, pacing and congestion control thereby
+// run as fast as the CPU allows, independently of the time they simulate.
+//
+// While it exists, the controller is the clock of rtc::TimeNanos(), and so of
+// webrtc::Clock::GetRealTimeClock() too. The thread creating it, and every
+// thread started with PlatformThread or rtc::Thread after that, takes part,
+// and is busy except while it waits on an rtc::Event, in SleepMs() or, on a
+// TaskQueue, for the next task. Delayed tasks of TaskQueues and rtc::Threads,
+// ProcessThread modules and EventTimerWrapper timers run on virtual time as
+// well. A thread blocking in any other way, e.g. in a socket server that
+// isn't a NullSocketServer, counts as busy and holds time still.
+//
+// Only one controller may exist at a time, and the threads and task queues
+// taking part must be started and stopped while it exists.
+class VirtualTimeController : public ClockInterface {
+ public:
+  explicit VirtualTimeController(int64_t start_time_us);
+  ~VirtualTimeController() override;
+
+  // Returns the existing controller, or null.
+  static VirtualTimeController* Get() { return current_.load(); }
+
+  // ClockInterface implementation.
+  int64_t TimeNanos() const override;
+
+  int64_t TimeMicros() const { return time_us_.load(); }
+
+  // Waits on |event| for at most |milliseconds| of virtual time, or forever
+  // if it is Event::kForever. Used by Event::Wait().
+  bool Wait(Event* event, int milliseconds);
+  // Wakes up the waiters of an event that has been set. Used by Event::Set().
+  void OnEventSet();
+
+  // Blocks the calling thread for |microseconds| of virtual time.
+  void Sleep(int64_t microseconds);
+
+  // Runs |task| once virtual time has advanced by |microseconds|. Tasks run
+  // on the thread advancing time, and so must only hand work over to other
+  // threads, like posting it to a queue, and not block.
+  void PostDelayedTask(const void* owner,
+                       std::unique_ptr<QueuedTask> task,
+                       int64_t microseconds);
+  // Deletes the tasks of |owner| which haven't run, and waits for any that is
+  // running to return.
+  void CancelDelayedTasks(const void* owner);
+
+  // Thread accounting. A thread is added before it is started, and then
+  // runs with a ThreadScope. Threads whose start fails are removed again.
+  void AddThread();
+  void RemoveThread();
+
+  // Makes the current thread take part in virtual time for its lifetime, if
+  // |controller| has been passed for it by AddThread().
+  class ThreadScope {
+   public:
+    explicit ThreadScope(VirtualTimeController* controller);
+    ~ThreadScope();
+
+   private:
+    VirtualTimeController* const controller_;
+    RTC_DISALLOW_COPY_AND_ASSIGN(ThreadScope);
+  };
+
+ private:
+  struct Waiter;
+  struct DelayedTask {
+    const void* owner;
+    std::unique_ptr<QueuedTask> task;
+  };
+
+  // Returns whether the current thread takes part in virtual time.
+  bool IsCurrentThreadIncluded() const;
+  void SetCurrentThreadIncluded(bool included);
+
+  void Lock();
+  void Unlock();
+  void WaitForSignal();
+  void SignalAll();
+
+  // All below are called with the lock held.
+  bool WaitLocked(Event* event, int64_t deadline_us);
+  void Wake(Waiter* waiter, bool signaled);
+  // Advances time for as long as no thread is busy.
+  void MaybeAdvanceTime();
+
+  static std::atomic<VirtualTimeController*> current_;
+
+  ClockInterface* const previous_clock_;
+  std::atomic<int64_t> time_us_;
+
+#if defined(WEBRTC_WIN)
+  CRITICAL_SECTION lock_;
+  CONDITION_VARIABLE signal_;
+  DWORD thread_key_;
+#elif defined(WEBRTC_POSIX)
+  pthread_mutex_t lock_;
+  pthread_cond_t signal_;
+  pthread_key_t thread_key_;
+#endif
+
+  // All below are guarded by |lock_|.
+  // Threads taking part which aren't waiting.
+  int busy_threads_;
+  std::list<Waiter*> waiters_;
+  std::multimap<int64_t, DelayedTask> delayed_tasks_;
+  // Set while the thread advancing time runs delayed tasks without the lock.
+  bool running_delayed_tasks_ = false;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(VirtualTimeController);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_VIRTUAL_TIME_H_
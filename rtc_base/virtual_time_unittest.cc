@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/virtual_time.h"
+
+#include <memory>
+
+#include "rtc_base/event.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+namespace {
+
+const int64_t kStartTimeUs = 1000000;
+
+struct SleepParams {
+  int sleep_ms;
+  int64_t woke_at_ms;
+  Event* done;
+};
+
+bool SleepThenSignal(void* obj) {
+  SleepParams* params = static_cast<SleepParams*>(obj);
+  Thread::SleepMs(params->sleep_ms);
+  params->woke_at_ms = TimeMillis();
+  params->done->Set();
+  return false;
+}
+
+struct SpinParams {
+  int64_t spin_real_ms;
+  Event* done;
+};
+
+bool SpinThenSignal(void* obj) {
+  SpinParams* params = static_cast<SpinParams*>(obj);
+  const int64_t end_ms = SystemTimeMillis() + params->spin_real_ms;
+  while (SystemTimeMillis() < end_ms) {
+  }
+  params->done->Set();
+  return false;
+}
+
+class RecordTimeTask : public QueuedTask {
+ public:
+  RecordTimeTask(int64_t* ran_at_ms, Event* done)
+      : ran_at_ms_(ran_at_ms), done_(done) {}
+
+ private:
+  bool Run() override {
+    *ran_at_ms_ = TimeMillis();
+    done_->Set();
+    return true;
+  }
+
+  int64_t* const ran_at_ms_;
+  Event* const done_;
+};
+
+struct RecordTimeHandler : public MessageHandler {
+  RecordTimeHandler() : done(false, false) {}
+  void OnMessage(Message* msg) override {
+    ran_at_ms = TimeMillis();
+    done.Set();
+  }
+
+  int64_t ran_at_ms = 0;
+  Event done;
+};
+
+}  // namespace
+
+TEST(VirtualTimeTest, ClockStartsAtStartTime) {
+  VirtualTimeController virtual_time(kStartTimeUs);
+  EXPECT_EQ(kStartTimeUs, TimeMicros());
+  EXPECT_EQ(kStartTimeUs / 1000, TimeMillis());
+}
+
+TEST(VirtualTimeTest, EventWaitTimesOutWithoutRealWaiting) {
+  const int64_t real_start_ms = SystemTimeMillis();
+  VirtualTimeController virtual_time(kStartTimeUs);
+  Event event(false, false);
+  EXPECT_FALSE(event.Wait(10000));
+  EXPECT_EQ(kStartTimeUs / 1000 + 10000, TimeMillis());
+  EXPECT_LT(SystemTimeMillis() - real_start_ms, 1000);
+}
+
+TEST(VirtualTimeTest, SleepingThreadsWakeInOrder) {
+  VirtualTimeController virtual_time(kStartTimeUs);
+  Event first_done(false, false);
+  Event second_done(false, false);
+  SleepParams first = {200, 0, &first_done};
+  SleepParams second = {100, 0, &second_done};
+  PlatformThread first_thread(&SleepThenSignal, &first, "first");
+  PlatformThread second_thread(&SleepThenSignal, &second, "second");
+  first_thread.Start();
+  second_thread.Start();
+  EXPECT_TRUE(first_done.Wait(Event::kForever));
+  EXPECT_TRUE(second_done.Wait(Event::kForever));
+  first_thread.Stop();
+  second_thread.Stop();
+  EXPECT_EQ(kStartTimeUs / 1000 + 200, first.woke_at_ms);
+  EXPECT_EQ(kStartTimeUs / 1000 + 100, second.woke_at_ms);
+}
+
+TEST(VirtualTimeTest, TimeStandsStillWhileAThreadIsBusy) {
+  VirtualTimeController virtual_time(kStartTimeUs);
+  Event done(false, false);
+  SpinParams params = {100, &done};
+  PlatformThread thread(&SpinThenSignal, &params, "spin");
+  thread.Start();
+  EXPECT_TRUE(done.Wait(50));
+  thread.Stop();
+  EXPECT_EQ(kStartTimeUs, TimeMicros());
+}
+
+TEST(VirtualTimeTest, TaskQueueDelayedTaskRunsOnTime) {
+  VirtualTimeController virtual_time(kStartTimeUs);
+  int64_t ran_at_ms = 0;
+  Event done(false, false);
+  {
+    TaskQueue queue("delayed");
+    queue.PostDelayedTask(
+        std::unique_ptr<QueuedTask>(new RecordTimeTask(&ran_at_ms, &done)),
+        5000);
+    EXPECT_TRUE(done.Wait(Event::kForever));
+  }
+  EXPECT_EQ(kStartTimeUs / 1000 + 5000, ran_at_ms);
+}
+
+TEST(VirtualTimeTest, TaskQueuePostTaskAndReply) {
+  VirtualTimeController virtual_time(kStartTimeUs);
+  int64_t ran_at_ms = 0;
+  int64_t replied_at_ms = 0;
+  Event ran(false, false);
+  Event replied(false, false);
+  {
+    TaskQueue post_queue("post");
+    TaskQueue reply_queue("reply");
+    post_queue.PostTaskAndReply(
+        std::unique_ptr<QueuedTask>(new RecordTimeTask(&ran_at_ms, &ran)),
+        std::unique_ptr<QueuedTask>(
+            new RecordTimeTask(&replied_at_ms, &replied)),
+        &reply_queue);
+    EXPECT_TRUE(replied.Wait(Event::kForever));
+    EXPECT_TRUE(ran.Wait(0));
+  }
+  EXPECT_EQ(kStartTimeUs / 1000, ran_at_ms);
+  EXPECT_EQ(kStartTimeUs / 1000, replied_at_ms);
+}
+
+TEST(VirtualTimeTest, ThreadPostDelayedRunsOnTime) {
+  VirtualTimeController virtual_time(kStartTimeUs);
+  RecordTimeHandler handler;
+  std::unique_ptr<Thread> thread(Thread::Create());
+  thread->Start();
+  thread->PostDelayed(RTC_FROM_HERE, 3000, &handler);
+  EXPECT_TRUE(handler.done.Wait(Event::kForever));
+  thread->Stop();
+  EXPECT_EQ(kStartTimeUs / 1000 + 3000, handler.ran_at_ms);
+}
+
+}  // namespace rtc
@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/zerocopyreceivescope.h"
+
+#include <utility>
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "rtc_base/checks.h"
+
+namespace rtc {
+
+namespace {
+
+#if defined(WEBRTC_WIN)
+DWORD GetKey() {
+  static const DWORD key = TlsAlloc();
+  return key;
+}
+
+ZeroCopyReceiveScope* GetCurrentScope() {
+  return static_cast<ZeroCopyReceiveScope*>(TlsGetValue(GetKey()));
+}
+
+void SetCurrentScope(ZeroCopyReceiveScope* scope) {
+  TlsSetValue(GetKey(), scope);
+}
+#else
+pthread_key_t GetKey() {
+  static const pthread_key_t key = [] {
+    pthread_key_t key;
+    pthread_key_create(&key, nullptr);
+    return key;
+  }();
+  return key;
+}
+
+ZeroCopyReceiveScope* GetCurrentScope() {
+  return static_cast<ZeroCopyReceiveScope*>(pthread_getspecific(GetKey()));
+}
+
+void SetCurrentScope(ZeroCopyReceiveScope* scope) {
+  pthread_setspecific(GetKey(), scope);
+}
+#endif
+
+}  // namespace
+
+ZeroCopyReceiveScope::ZeroCopyReceiveScope(CopyOnWriteBuffer* buffer)
+    : buffer_(buffer), previous_(GetCurrentScope()) {
+  RTC_DCHECK(buffer_);
+  SetCurrentScope(this);
+}
+
+ZeroCopyReceiveScope::~ZeroCopyReceiveScope() {
+  RTC_DCHECK_EQ(this, GetCurrentScope());
+  SetCurrentScope(previous_);
+}
+
+// static
+bool ZeroCopyReceiveScope::TakeBuffer(const void* data,
+                                      size_t size,
+                                      CopyOnWriteBuffer* buffer) {
+  ZeroCopyReceiveScope* scope = GetCurrentScope();
+  if (!scope || scope->taken_ || size == 0)
+    return false;
+  const CopyOnWriteBuffer& received = *scope->buffer_;
+  if (received.cdata() != data || received.size() != size)
+    return false;
+  *buffer = std::move(*scope->buffer_);
+  scope->taken_ = true;
+  return true;
+}
+
+}  // namespace rtc
@@ -0,0 +1,54 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_ZEROCOPYRECEIVESCOPE_H_
+#define RTC_BASE_ZEROCOPYRECEIVESCOPE_H_
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
+
+namespace rtc {
+
+// Lets a socket that received a packet straight into a CopyOnWriteBuffer hand
+// that buffer to code further down the (data, size) signal chain, such as
+// RtpTransport, instead of having it copy the payload.
+//
+// The socket puts a scope around the signal that delivers the packet. A
+// receiver that is handed exactly the bytes of the innermost scope on its
+// thread may take the buffer with TakeBuffer(); it then owns the only
+// reference, so it can be modified (e.g. decrypted) in place. Anything that
+// was transformed on the way (TURN framing, DTLS) does not match and has to be
+// copied as before.
+class ZeroCopyReceiveScope {
+ public:
+  explicit ZeroCopyReceiveScope(CopyOnWriteBuffer* buffer);
+  ~ZeroCopyReceiveScope();
+
+  // True if a receiver took the buffer during this scope.
+  bool taken() const { return taken_; }
+
+  // If |data| and |size| are the contents of the innermost scope's buffer on
+  // the current thread, moves that buffer into |*buffer| and returns true.
+  // Returns false, leaving |*buffer| alone, otherwise.
+  static bool TakeBuffer(const void* data,
+                         size_t size,
+                         CopyOnWriteBuffer* buffer);
+
+ private:
+  CopyOnWriteBuffer* const buffer_;
+  ZeroCopyReceiveScope* const previous_;
+  bool taken_ = false;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ZeroCopyReceiveScope);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_ZEROCOPYRECEIVESCOPE_H_
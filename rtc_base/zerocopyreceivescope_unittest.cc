@@ -0,0 +1,133 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/zerocopyreceivescope.h"
+
+#include <memory>
+#include <string>
+
+#include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/virtualsocketserver.h"
+
+namespace rtc {
+
+namespace {
+
+const uint8_t kTestData[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7};
+
+class ZeroCopyReceiver : public sigslot::has_slots<> {
+ public:
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const PacketTime& packet_time) {
+    received_data = data;
+    CopyOnWriteBuffer buffer;
+    if (ZeroCopyReceiveScope::TakeBuffer(data, size, &buffer)) {
+      taken_data = buffer.cdata<char>();
+      packet = std::move(buffer);
+    } else {
+      taken_data = nullptr;
+      packet.SetData(data, size);
+    }
+  }
+
+  const char* received_data = nullptr;
+  const char* taken_data = nullptr;
+  CopyOnWriteBuffer packet;
+};
+
+}  // namespace
+
+TEST(ZeroCopyReceiveScopeTest, NoScope) {
+  CopyOnWriteBuffer buffer;
+  EXPECT_FALSE(
+      ZeroCopyReceiveScope::TakeBuffer(kTestData, sizeof(kTestData), &buffer));
+  EXPECT_EQ(0u, buffer.size());
+}
+
+TEST(ZeroCopyReceiveScopeTest, TakesMatchingBufferOnce) {
+  CopyOnWriteBuffer received(kTestData, sizeof(kTestData));
+  const uint8_t* data = received.cdata();
+  ZeroCopyReceiveScope scope(&received);
+
+  CopyOnWriteBuffer buffer;
+  EXPECT_TRUE(ZeroCopyReceiveScope::TakeBuffer(data, sizeof(kTestData),
+                                               &buffer));
+  EXPECT_TRUE(scope.taken());
+  EXPECT_EQ(data, buffer.cdata());
+  EXPECT_EQ(sizeof(kTestData), buffer.size());
+
+  CopyOnWriteBuffer second;
+  EXPECT_FALSE(ZeroCopyReceiveScope::TakeBuffer(data, sizeof(kTestData),
+                                                &second));
+}
+
+TEST(ZeroCopyReceiveScopeTest, DoesNotTakeOtherData) {
+  CopyOnWriteBuffer received(kTestData, sizeof(kTestData));
+  ZeroCopyReceiveScope scope(&received);
+
+  CopyOnWriteBuffer buffer;
+  // Same bytes at a different address, e.g. after unwrapping.
+  EXPECT_FALSE(
+      ZeroCopyReceiveScope::TakeBuffer(kTestData, sizeof(kTestData), &buffer));
+  // A part of the received packet.
+  EXPECT_FALSE(ZeroCopyReceiveScope::TakeBuffer(received.cdata() + 1,
+                                                sizeof(kTestData) - 1,
+                                                &buffer));
+  EXPECT_FALSE(scope.taken());
+  EXPECT_EQ(sizeof(kTestData), received.size());
+}
+
+TEST(ZeroCopyReceiveScopeTest, InnermostScopeWins) {
+  CopyOnWriteBuffer outer_buffer(kTestData, sizeof(kTestData));
+  CopyOnWriteBuffer inner_buffer(kTestData, sizeof(kTestData));
+  CopyOnWriteBuffer buffer;
+  ZeroCopyReceiveScope outer(&outer_buffer);
+  {
+    ZeroCopyReceiveScope inner(&inner_buffer);
+    EXPECT_FALSE(ZeroCopyReceiveScope::TakeBuffer(
+        outer_buffer.cdata(), outer_buffer.size(), &buffer));
+  }
+  EXPECT_TRUE(ZeroCopyReceiveScope::TakeBuffer(outer_buffer.cdata(),
+                                               sizeof(kTestData), &buffer));
+  EXPECT_TRUE(outer.taken());
+}
+
+TEST(ZeroCopyReceiveScopeTest, AsyncUDPSocketHandsOverReceiveBuffer) {
+  VirtualSocketServer ss;
+  AutoSocketServerThread thread(&ss);
+  SocketAddress address("127.0.0.1", 0);
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(&ss, address));
+  std::unique_ptr<AsyncUDPSocket> sender(AsyncUDPSocket::Create(&ss, address));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  receiver->SetZeroCopyReceiveBufferSize(AsyncUDPSocket::kDefaultBatchSlotSize);
+
+  ZeroCopyReceiver sink;
+  receiver->SignalReadPacket.connect(&sink, &ZeroCopyReceiver::OnReadPacket);
+
+  PacketOptions options;
+  for (int i = 0; i < 2; ++i) {
+    std::string payload = "packet" + std::to_string(i);
+    sink.received_data = nullptr;
+    sender->SendTo(payload.data(), payload.size(),
+                   receiver->GetLocalAddress(), options);
+    EXPECT_TRUE_WAIT(sink.received_data != nullptr, 1000);
+    EXPECT_EQ(sink.received_data, sink.taken_data);
+    EXPECT_EQ(payload, std::string(sink.packet.cdata<char>(),
+                                   sink.packet.size()));
+  }
+}
+
+}  // namespace rtc
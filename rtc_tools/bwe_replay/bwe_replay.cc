@@ -0,0 +1,225 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/bwe_replay/bwe_replay.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "modules/congestion_controller/rtp/transport_feedback_adapter.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+const int64_t kTargetRateSampleIntervalUs = 100000;
+const int64_t kStartBitrateBps = 300000;
+
+int64_t Percentile(std::vector<int64_t>* values, int percent) {
+  RTC_DCHECK(!values->empty());
+  size_t index = values->size() * percent / 100;
+  std::nth_element(values->begin(), values->begin() + index, values->end());
+  return (*values)[index];
+}
+
+int64_t Mean(const std::vector<int64_t>& values) {
+  RTC_DCHECK(!values.empty());
+  int64_t sum = 0;
+  for (int64_t value : values)
+    sum += value;
+  return sum / static_cast<int64_t>(values.size());
+}
+
+PacketResult PacketResultFromPacketFeedback(const PacketFeedback& pf) {
+  PacketResult result;
+  if (pf.arrival_time_ms == PacketFeedback::kNotReceived)
+    result.receive_time = Timestamp::Infinity();
+  else
+    result.receive_time = Timestamp::ms(pf.arrival_time_ms);
+  if (pf.send_time_ms != PacketFeedback::kNoSendTime) {
+    result.sent_packet = SentPacket();
+    result.sent_packet->sequence_number = pf.long_sequence_number;
+    result.sent_packet->send_time = Timestamp::ms(pf.send_time_ms);
+    result.sent_packet->size = DataSize::bytes(pf.payload_size);
+    result.sent_packet->pacing_info = pf.pacing_info;
+  }
+  return result;
+}
+}  // namespace
+
+BweReplayResult ReplayEventLog(const ParsedRtcEventLogNew& parsed_log,
+                               NetworkControllerFactoryInterface* factory) {
+  const int64_t kNoEvent = std::numeric_limits<int64_t>::max();
+  BweReplayResult result;
+
+  std::multimap<int64_t, const LoggedRtpPacket*> outgoing_rtp;
+  for (const auto& stream : parsed_log.outgoing_rtp_packets_by_ssrc()) {
+    for (const LoggedRtpPacketOutgoing& packet : stream.outgoing_packets) {
+      if (packet.rtp.header.extension.hasTransportSequenceNumber)
+        outgoing_rtp.emplace(packet.log_time_us(), &packet.rtp);
+    }
+  }
+  const std::vector<LoggedRtcpPacketTransportFeedback>& incoming_rtcp =
+      parsed_log.transport_feedbacks(kIncomingPacket);
+  if (outgoing_rtp.empty())
+    return result;
+
+  auto rtp_iterator = outgoing_rtp.begin();
+  auto rtcp_iterator = incoming_rtcp.begin();
+  auto NextRtpTime = [&]() {
+    return rtp_iterator != outgoing_rtp.end() ? rtp_iterator->first : kNoEvent;
+  };
+  auto NextRtcpTime = [&]() {
+    return rtcp_iterator != incoming_rtcp.end()
+               ? rtcp_iterator->log_time_us()
+               : kNoEvent;
+  };
+
+  const int64_t start_time_us = std::min(NextRtpTime(), NextRtcpTime());
+  SimulatedClock clock(start_time_us);
+  webrtc_cc::TransportFeedbackAdapter feedback_adapter(&clock);
+
+  NetworkControllerConfig config;
+  config.constraints.at_time = Timestamp::us(start_time_us);
+  config.constraints.min_data_rate = DataRate::Zero();
+  config.constraints.max_data_rate = DataRate::Infinity();
+  config.starting_bandwidth = DataRate::bps(kStartBitrateBps);
+  std::unique_ptr<NetworkControllerInterface> controller =
+      factory->Create(config);
+  const TimeDelta process_interval = factory->GetProcessInterval();
+
+  absl::optional<DataRate> target_rate;
+  auto Apply = [&](const NetworkControlUpdate& update) {
+    if (update.target_rate)
+      target_rate = update.target_rate->target_rate;
+  };
+
+  std::vector<int64_t> target_rates_bps;
+  std::vector<int64_t> one_way_delays_ms;
+  size_t lost_packets = 0;
+  int64_t received_bytes = 0;
+  int64_t first_arrival_ms = kNoEvent;
+  int64_t last_arrival_ms = 0;
+
+  int64_t next_process_us = start_time_us;
+  int64_t next_sample_us = start_time_us;
+  int64_t time_us = start_time_us;
+  while (NextRtpTime() != kNoEvent || NextRtcpTime() != kNoEvent) {
+    time_us = std::min(
+        {NextRtpTime(), NextRtcpTime(), next_process_us, next_sample_us});
+    clock.AdvanceTimeMicroseconds(time_us - clock.TimeInMicroseconds());
+    const Timestamp now = Timestamp::us(time_us);
+
+    if (time_us == next_process_us) {
+      ProcessInterval msg;
+      msg.at_time = now;
+      Apply(controller->OnProcessInterval(msg));
+      // Controllers without periodic processing still need the first call.
+      next_process_us = process_interval.IsFinite()
+                            ? time_us + process_interval.us()
+                            : kNoEvent;
+    }
+
+    if (time_us == NextRtpTime()) {
+      const LoggedRtpPacket& rtp = *rtp_iterator->second;
+      uint16_t sequence_number = rtp.header.extension.transportSequenceNumber;
+      feedback_adapter.AddPacket(rtp.header.ssrc, sequence_number,
+                                 rtp.total_length, PacedPacketInfo());
+      feedback_adapter.OnSentPacket(sequence_number, time_us / 1000);
+      absl::optional<PacketFeedback> packet =
+          feedback_adapter.GetPacket(sequence_number);
+      if (packet) {
+        SentPacket msg;
+        msg.size = DataSize::bytes(packet->payload_size);
+        msg.send_time = Timestamp::ms(packet->send_time_ms);
+        msg.sequence_number = packet->long_sequence_number;
+        msg.data_in_flight =
+            DataSize::bytes(feedback_adapter.GetOutstandingBytes());
+        Apply(controller->OnSentPacket(msg));
+      }
+      ++result.packets;
+      ++rtp_iterator;
+    }
+
+    if (time_us == NextRtcpTime()) {
+      DataSize prior_in_flight =
+          DataSize::bytes(feedback_adapter.GetOutstandingBytes());
+      feedback_adapter.OnTransportFeedback(rtcp_iterator->transport_feedback);
+      std::vector<PacketFeedback> feedback_vector =
+          feedback_adapter.GetTransportFeedbackVector();
+      std::sort(feedback_vector.begin(), feedback_vector.end(),
+                PacketFeedbackComparator());
+      if (!feedback_vector.empty()) {
+        TransportPacketsFeedback msg;
+        msg.feedback_time = now;
+        msg.prior_in_flight = prior_in_flight;
+        msg.data_in_flight =
+            DataSize::bytes(feedback_adapter.GetOutstandingBytes());
+        for (const PacketFeedback& packet : feedback_vector) {
+          msg.packet_feedbacks.push_back(
+              PacketResultFromPacketFeedback(packet));
+          if (packet.send_time_ms == PacketFeedback::kNoSendTime)
+            continue;
+          if (packet.arrival_time_ms == PacketFeedback::kNotReceived) {
+            ++lost_packets;
+            continue;
+          }
+          received_bytes += packet.payload_size;
+          first_arrival_ms = std::min(first_arrival_ms, packet.arrival_time_ms);
+          last_arrival_ms = std::max(last_arrival_ms, packet.arrival_time_ms);
+          one_way_delays_ms.push_back(packet.arrival_time_ms -
+                                      packet.send_time_ms);
+        }
+        Apply(controller->OnTransportPacketsFeedback(msg));
+      }
+      ++result.feedbacks;
+      ++rtcp_iterator;
+    }
+
+    if (time_us == next_sample_us) {
+      if (target_rate)
+        target_rates_bps.push_back(target_rate->bps());
+      next_sample_us += kTargetRateSampleIntervalUs;
+    }
+  }
+
+  result.duration = TimeDelta::us(time_us - start_time_us);
+  if (!target_rates_bps.empty()) {
+    result.mean_target_rate = DataRate::bps(Mean(target_rates_bps));
+    result.p10_target_rate = DataRate::bps(Percentile(&target_rates_bps, 10));
+    result.p90_target_rate = DataRate::bps(Percentile(&target_rates_bps, 90));
+  }
+  if (last_arrival_ms > first_arrival_ms) {
+    result.acked_rate = DataRate::bps(received_bytes * 8 * 1000 /
+                                      (last_arrival_ms - first_arrival_ms));
+  }
+  if (!one_way_delays_ms.empty()) {
+    // The clocks of the endpoints are not synchronized, so the smallest delay
+    // stands in for the propagation delay.
+    int64_t min_delay_ms =
+        *std::min_element(one_way_delays_ms.begin(), one_way_delays_ms.end());
+    for (int64_t& delay_ms : one_way_delays_ms)
+      delay_ms -= min_delay_ms;
+    result.mean_queue_delay = TimeDelta::ms(Mean(one_way_delays_ms));
+    result.p95_queue_delay =
+        TimeDelta::ms(Percentile(&one_way_delays_ms, 95));
+  }
+  size_t reported_packets = one_way_delays_ms.size() + lost_packets;
+  if (reported_packets > 0)
+    result.loss_ratio = static_cast<double>(lost_packets) / reported_packets;
+  return result;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_BWE_REPLAY_BWE_REPLAY_H_
+#define RTC_TOOLS_BWE_REPLAY_BWE_REPLAY_H_
+
+#include <stddef.h>
+
+#include "api/transport/network_control.h"
+#include "logging/rtc_event_log/rtc_event_log_parser_new.h"
+
+namespace webrtc {
+
+struct BweReplayResult {
+  // Log time from the first to the last replayed event.
+  TimeDelta duration = TimeDelta::Zero();
+  size_t packets = 0;
+  size_t feedbacks = 0;
+  // Target rate of the controller, sampled at a fixed interval once it has
+  // produced one.
+  DataRate mean_target_rate = DataRate::Zero();
+  DataRate p10_target_rate = DataRate::Zero();
+  DataRate p90_target_rate = DataRate::Zero();
+  // Payload reported as received per second between the first and the last
+  // reported arrival.
+  DataRate acked_rate = DataRate::Zero();
+  // One way delay of the received packets above the smallest one seen.
+  TimeDelta mean_queue_delay = TimeDelta::Zero();
+  TimeDelta p95_queue_delay = TimeDelta::Zero();
+  double loss_ratio = 0;
+};
+
+// Feeds the outgoing RTP packets with a transport sequence number and the
+// incoming transport feedback of |parsed_log| to a network controller created
+// by |factory|, in log time order. The controller outputs only affect the
+// reported target rate, the replayed traffic is the one that was logged.
+BweReplayResult ReplayEventLog(const ParsedRtcEventLogNew& parsed_log,
+                               NetworkControllerFactoryInterface* factory);
+
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_BWE_REPLAY_BWE_REPLAY_H_
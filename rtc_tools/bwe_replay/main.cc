@@ -0,0 +1,197 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "logging/rtc_event_log/rtc_event_log.h"
+#include "logging/rtc_event_log/rtc_event_log_parser_new.h"
+#include "modules/congestion_controller/bbr/bbr_factory.h"
+#include "modules/congestion_controller/goog_cc/include/goog_cc_factory.h"
+#include "rtc_base/atomicops.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_tools/bwe_replay/bwe_replay.h"
+#include "system_wrappers/include/field_trial_default.h"
+#include "test/field_trial.h"
+
+DEFINE_string(controller,
+              "goog_cc",
+              "The network controller to replay the logs with, \"goog_cc\" or "
+              "\"bbr\".");
+DEFINE_int(threads, 4, "Number of logs to replay in parallel.");
+DEFINE_string(
+    force_fieldtrials,
+    "",
+    "Field trials control experimental feature code which can be forced. "
+    "E.g. running with --force_fieldtrials=WebRTC-FooFeature/Enabled/"
+    " will assign the group Enabled to field trial WebRTC-FooFeature. Multiple "
+    "trials are separated by \"/\"");
+DEFINE_bool(help, false, "prints this message");
+
+namespace webrtc {
+namespace {
+
+struct ReplayJob {
+  std::string filename;
+  bool parsed = false;
+  BweReplayResult result;
+};
+
+// Shared by the worker threads, which pick the next job with |next_job|.
+struct ReplayQueue {
+  std::vector<ReplayJob> jobs;
+  volatile int next_job = -1;
+};
+
+std::unique_ptr<NetworkControllerFactoryInterface> CreateFactory(
+    RtcEventLog* event_log) {
+  if (strcmp(FLAG_controller, "bbr") == 0)
+    return absl::make_unique<BbrNetworkControllerFactory>();
+  return absl::make_unique<GoogCcNetworkControllerFactory>(event_log);
+}
+
+void ReplayWorker(void* obj) {
+  ReplayQueue* queue = static_cast<ReplayQueue*>(obj);
+  // The factories and controllers are not thread safe, so each worker has its
+  // own.
+  std::unique_ptr<RtcEventLog> event_log = RtcEventLog::CreateNull();
+  std::unique_ptr<NetworkControllerFactoryInterface> factory =
+      CreateFactory(event_log.get());
+  for (;;) {
+    size_t index = rtc::AtomicOps::Increment(&queue->next_job);
+    if (index >= queue->jobs.size())
+      return;
+    ReplayJob& job = queue->jobs[index];
+    ParsedRtcEventLogNew parsed_log(
+        ParsedRtcEventLogNew::UnconfiguredHeaderExtensions::
+            kAttemptWebrtcDefaultConfig);
+    job.parsed = parsed_log.ParseFile(job.filename);
+    job.result = ReplayEventLog(parsed_log, factory.get());
+  }
+}
+
+void PrintHeader() {
+  printf(
+      "log,complete,duration_s,packets,feedbacks,mean_target_kbps,"
+      "p10_target_kbps,p90_target_kbps,acked_kbps,mean_queue_delay_ms,"
+      "p95_queue_delay_ms,loss_percent\n");
+}
+
+void PrintRow(const std::string& name,
+              bool complete,
+              const BweReplayResult& result) {
+  printf("%s,%d,%.1f,%zu,%zu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f\n",
+         name.c_str(), complete ? 1 : 0, result.duration.seconds<double>(),
+         result.packets, result.feedbacks,
+         result.mean_target_rate.kbps<double>(),
+         result.p10_target_rate.kbps<double>(),
+         result.p90_target_rate.kbps<double>(),
+         result.acked_rate.kbps<double>(), result.mean_queue_delay.ms<double>(),
+         result.p95_queue_delay.ms<double>(), result.loss_ratio * 100);
+}
+
+// Averages the per log metrics, weighted by the replayed duration.
+BweReplayResult Aggregate(const std::vector<ReplayJob>& jobs) {
+  BweReplayResult total;
+  double weight_sum = 0;
+  double mean_target = 0, p10_target = 0, p90_target = 0, acked = 0;
+  double mean_delay = 0, p95_delay = 0, loss = 0;
+  for (const ReplayJob& job : jobs) {
+    const BweReplayResult& result = job.result;
+    double weight = result.duration.seconds<double>();
+    total.duration += result.duration;
+    total.packets += result.packets;
+    total.feedbacks += result.feedbacks;
+    mean_target += weight * result.mean_target_rate.bps<double>();
+    p10_target += weight * result.p10_target_rate.bps<double>();
+    p90_target += weight * result.p90_target_rate.bps<double>();
+    acked += weight * result.acked_rate.bps<double>();
+    mean_delay += weight * result.mean_queue_delay.us<double>();
+    p95_delay += weight * result.p95_queue_delay.us<double>();
+    loss += weight * result.loss_ratio;
+    weight_sum += weight;
+  }
+  if (weight_sum > 0) {
+    total.mean_target_rate = DataRate::bps(mean_target / weight_sum);
+    total.p10_target_rate = DataRate::bps(p10_target / weight_sum);
+    total.p90_target_rate = DataRate::bps(p90_target / weight_sum);
+    total.acked_rate = DataRate::bps(acked / weight_sum);
+    total.mean_queue_delay = TimeDelta::us(mean_delay / weight_sum);
+    total.p95_queue_delay = TimeDelta::us(p95_delay / weight_sum);
+    total.loss_ratio = loss / weight_sum;
+  }
+  return total;
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Replays the send side of WebRTC event logs through a network "
+      "controller and prints CSV metrics for each log and for all of them.\n"
+      "Example usage:\n" +
+      program_name + " --controller=bbr <logfile> [<logfile> ...] > out.csv\n" +
+      "Run " + program_name + " --help for a list of command line options\n";
+
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (argc < 2 || FLAG_help) {
+    std::cout << usage;
+    if (FLAG_help)
+      rtc::FlagList::Print(nullptr, false);
+    return 0;
+  }
+  if (strcmp(FLAG_controller, "goog_cc") != 0 &&
+      strcmp(FLAG_controller, "bbr") != 0) {
+    std::cerr << "Unknown controller: " << FLAG_controller << std::endl;
+    return 1;
+  }
+
+  webrtc::test::ValidateFieldTrialsStringOrDie(FLAG_force_fieldtrials);
+  // InitFieldTrialsFromString stores the char*, so the char array must outlive
+  // the application.
+  webrtc::field_trial::InitFieldTrialsFromString(FLAG_force_fieldtrials);
+
+  webrtc::ReplayQueue queue;
+  for (int i = 1; i < argc; ++i) {
+    queue.jobs.emplace_back();
+    queue.jobs.back().filename = argv[i];
+  }
+
+  int num_threads = std::max(1, std::min<int>(FLAG_threads, argc - 1));
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(absl::make_unique<rtc::PlatformThread>(
+        &webrtc::ReplayWorker, &queue, "BweReplay"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+
+  webrtc::PrintHeader();
+  for (const webrtc::ReplayJob& job : queue.jobs) {
+    if (!job.parsed)
+      std::cerr << "Could not parse the entire log " << job.filename
+                << ", replayed the events before the error." << std::endl;
+    webrtc::PrintRow(job.filename, job.parsed, job.result);
+  }
+  webrtc::PrintRow("all", true, webrtc::Aggregate(queue.jobs));
+  return 0;
+}
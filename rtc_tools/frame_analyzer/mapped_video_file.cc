@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/frame_analyzer/mapped_video_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "rtc_base/checks.h"
+#include "rtc_tools/frame_analyzer/video_quality_analysis.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const char kY4mFileSignature[] = "YUV4MPEG2";
+const char kY4mFrameDelimiter[] = "FRAME";
+const size_t kY4mFrameHeaderSize = 6;
+const size_t kY4mFileHeaderMaxSize = 200;
+
+// Maps the whole file. Sets |data| to null for an empty file.
+bool MapFile(const std::string& file_name,
+             const uint8_t** data,
+             size_t* size) {
+#if defined(WEBRTC_WIN)
+  HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    return false;
+  }
+  *size = static_cast<size_t>(file_size.QuadPart);
+  *data = nullptr;
+  if (*size > 0) {
+    HANDLE mapping =
+        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+      *data = static_cast<const uint8_t*>(
+          MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+      // The view keeps the mapping alive.
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+  return *size == 0 || *data;
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return false;
+  }
+  *size = static_cast<size_t>(file_stat.st_size);
+  *data = nullptr;
+  if (*size > 0) {
+    void* mapped = mmap(nullptr, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped != MAP_FAILED) {
+      *data = static_cast<const uint8_t*>(mapped);
+      // Frames are mostly read in order, if by several threads.
+      madvise(mapped, *size, MADV_SEQUENTIAL);
+    }
+  }
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  return *size == 0 || *data;
+#endif
+}
+
+void UnmapFile(const uint8_t* data, size_t size) {
+  if (!data)
+    return;
+#if defined(WEBRTC_WIN)
+  UnmapViewOfFile(data);
+#else
+  munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
+
+}  // namespace
+
+std::unique_ptr<MappedVideoFile> MappedVideoFile::Open(
+    const std::string& file_name,
+    int width,
+    int height) {
+  RTC_CHECK_GT(width, 0);
+  RTC_CHECK_GT(height, 0);
+  const uint8_t* data;
+  size_t size;
+  if (!MapFile(file_name, &data, &size)) {
+    fprintf(stderr, "Couldn't map input file for reading: %s\n",
+            file_name.c_str());
+    return nullptr;
+  }
+
+  const size_t frame_size = GetI420FrameSize(width, height);
+  size_t first_frame_offset = 0;
+  size_t frame_stride = frame_size;
+  const size_t signature_size = sizeof(kY4mFileSignature) - 1;
+  if (size >= signature_size &&
+      memcmp(data, kY4mFileSignature, signature_size) == 0) {
+    // The file header ends where the first frame header starts.
+    const std::string header(reinterpret_cast<const char*>(data),
+                             std::min(size, kY4mFileHeaderMaxSize));
+    const size_t delimiter = header.find(kY4mFrameDelimiter);
+    if (delimiter == std::string::npos) {
+      fprintf(stderr, "Corrupted Y4M header, could not find \"FRAME\" in %s\n",
+              file_name.c_str());
+      UnmapFile(data, size);
+      return nullptr;
+    }
+    first_frame_offset = delimiter + kY4mFrameHeaderSize;
+    frame_stride = frame_size + kY4mFrameHeaderSize;
+  }
+  return std::unique_ptr<MappedVideoFile>(new MappedVideoFile(
+      data, size, frame_size, first_frame_offset, frame_stride));
+}
+
+MappedVideoFile::MappedVideoFile(const uint8_t* data,
+                                 size_t size,
+                                 size_t frame_size,
+                                 size_t first_frame_offset,
+                                 size_t frame_stride)
+    : data_(data),
+      size_(size),
+      frame_size_(frame_size),
+      first_frame_offset_(first_frame_offset),
+      frame_stride_(frame_stride),
+      // Only complete frames count.
+      num_frames_(size >= first_frame_offset + frame_size
+                      ? (size - first_frame_offset - frame_size) /
+                                frame_stride +
+                            1
+                      : 0) {}
+
+MappedVideoFile::~MappedVideoFile() {
+  UnmapFile(data_, size_);
+}
+
+const uint8_t* MappedVideoFile::GetFrame(size_t frame_number) const {
+  RTC_CHECK_LT(frame_number, num_frames_);
+  return data_ + first_frame_offset_ + frame_number * frame_stride_;
+}
+
+}  // namespace test
+}  // namespace webrtc
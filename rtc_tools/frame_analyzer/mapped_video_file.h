@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_FRAME_ANALYZER_MAPPED_VIDEO_FILE_H_
+#define RTC_TOOLS_FRAME_ANALYZER_MAPPED_VIDEO_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+namespace test {
+
+// An I420 video file, raw or Y4M, mapped into memory for reading. Frames are
+// accessed in place, from any thread, without being read into buffers. Y4M
+// files are expected to have plain "FRAME\n" frame headers, like the rest of
+// frame_analyzer does.
+class MappedVideoFile {
+ public:
+  // Returns null if the file can't be opened or mapped. Whether it is a Y4M
+  // file is told by its header.
+  static std::unique_ptr<MappedVideoFile> Open(const std::string& file_name,
+                                               int width,
+                                               int height);
+  ~MappedVideoFile();
+
+  size_t num_frames() const { return num_frames_; }
+  size_t frame_size() const { return frame_size_; }
+
+  // Returns the I420 data of frame |frame_number|, which must be less than
+  // num_frames().
+  const uint8_t* GetFrame(size_t frame_number) const;
+
+ private:
+  MappedVideoFile(const uint8_t* data,
+                  size_t size,
+                  size_t frame_size,
+                  size_t first_frame_offset,
+                  size_t frame_stride);
+
+  const uint8_t* const data_;
+  const size_t size_;
+  const size_t frame_size_;
+  const size_t first_frame_offset_;
+  const size_t frame_stride_;
+  const size_t num_frames_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MappedVideoFile);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_FRAME_ANALYZER_MAPPED_VIDEO_FILE_H_
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/frame_analyzer/parallel_video_analysis.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "rtc_base/platform_thread.h"
+#include "rtc_tools/frame_analyzer/mapped_video_file.h"
+#include "rtc_tools/frame_analyzer/video_quality_analysis.h"
+#include "system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+struct AnalysisContext {
+  const MappedVideoFile* reference;
+  const MappedVideoFile* test;
+  int width;
+  int height;
+  const std::vector<FrameQualityMetric*>* extra_metrics;
+  std::vector<FrameQuality>* results;
+  std::atomic<size_t> next_frame;
+};
+
+// Analyzes frames until there are none left. Each frame is claimed by one
+// thread, which writes its own entry in the results.
+bool AnalyzeFrames(void* obj) {
+  AnalysisContext* context = static_cast<AnalysisContext*>(obj);
+  while (true) {
+    const size_t frame_number = context->next_frame++;
+    if (frame_number >= context->results->size())
+      return false;
+    const uint8_t* ref_frame = context->reference->GetFrame(frame_number);
+    const uint8_t* test_frame = context->test->GetFrame(frame_number);
+    FrameQuality* result = &(*context->results)[frame_number];
+    result->frame_number = static_cast<int>(frame_number);
+    result->psnr = CalculateMetrics(kPSNR, ref_frame, test_frame,
+                                    context->width, context->height);
+    result->ssim = CalculateMetrics(kSSIM, ref_frame, test_frame,
+                                    context->width, context->height);
+    for (FrameQualityMetric* metric : *context->extra_metrics) {
+      result->extra_metrics.push_back(metric->Calculate(
+          ref_frame, test_frame, context->width, context->height));
+    }
+  }
+}
+
+}  // namespace
+
+bool AnalyzeVideoFilesInParallel(
+    const std::string& reference_file_name,
+    const std::string& test_file_name,
+    int width,
+    int height,
+    size_t num_threads,
+    const std::vector<FrameQualityMetric*>& extra_metrics,
+    std::vector<FrameQuality>* results) {
+  std::unique_ptr<MappedVideoFile> reference =
+      MappedVideoFile::Open(reference_file_name, width, height);
+  std::unique_ptr<MappedVideoFile> test =
+      MappedVideoFile::Open(test_file_name, width, height);
+  if (!reference || !test)
+    return false;
+
+  results->clear();
+  results->resize(std::min(reference->num_frames(), test->num_frames()));
+
+  AnalysisContext context;
+  context.reference = reference.get();
+  context.test = test.get();
+  context.width = width;
+  context.height = height;
+  context.extra_metrics = &extra_metrics;
+  context.results = results;
+  context.next_frame = 0;
+
+  if (num_threads == 0)
+    num_threads = CpuInfo::DetectNumberOfCores();
+  num_threads = std::max<size_t>(1, std::min(num_threads, results->size()));
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&AnalyzeFrames, &context, "FrameAnalysis"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  return true;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_FRAME_ANALYZER_PARALLEL_VIDEO_ANALYSIS_H_
+#define RTC_TOOLS_FRAME_ANALYZER_PARALLEL_VIDEO_ANALYSIS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace webrtc {
+namespace test {
+
+// A quality metric computed in addition to PSNR and SSIM, e.g. VMAF through
+// an external library. Calculate() is called concurrently for different
+// frames, from several threads.
+class FrameQualityMetric {
+ public:
+  virtual ~FrameQualityMetric() = default;
+
+  virtual std::string Name() const = 0;
+  // |ref_frame| and |test_frame| are I420 frames of |width| x |height|.
+  virtual double Calculate(const uint8_t* ref_frame,
+                           const uint8_t* test_frame,
+                           int width,
+                           int height) = 0;
+};
+
+struct FrameQuality {
+  int frame_number = 0;
+  double psnr = 0.0;
+  double ssim = 0.0;
+  // One value per extra FrameQualityMetric, in the order given.
+  std::vector<double> extra_metrics;
+};
+
+// Compares each frame of the test file with the frame at the same position in
+// the reference file, until either file runs out of frames, like
+// psnr_ssim_analyzer. Both are I420 files, raw or Y4M, and are read through
+// memory mappings. Frames are analyzed in parallel on |num_threads| threads,
+// or on one per core if 0. Returns false if a file can't be opened.
+bool AnalyzeVideoFilesInParallel(
+    const std::string& reference_file_name,
+    const std::string& test_file_name,
+    int width,
+    int height,
+    size_t num_threads,
+    const std::vector<FrameQualityMetric*>& extra_metrics,
+    std::vector<FrameQuality>* results);
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_FRAME_ANALYZER_PARALLEL_VIDEO_ANALYSIS_H_
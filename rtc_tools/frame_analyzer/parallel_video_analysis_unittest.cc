@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/frame_analyzer/parallel_video_analysis.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "rtc_tools/frame_analyzer/mapped_video_file.h"
+#include "rtc_tools/frame_analyzer/video_quality_analysis.h"
+#include "test/gtest.h"
+#include "test/testsupport/fileutils.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const int kWidth = 64;
+const int kHeight = 48;
+
+class CountingMetric : public FrameQualityMetric {
+ public:
+  std::string Name() const override { return "Counting"; }
+  double Calculate(const uint8_t* ref_frame,
+                   const uint8_t* test_frame,
+                   int width,
+                   int height) override {
+    return ref_frame[0];
+  }
+};
+
+class ParallelVideoAnalysisTest : public ::testing::Test {
+ protected:
+  ParallelVideoAnalysisTest() : random_(1234) {}
+
+  void TearDown() override {
+    for (const std::string& file_name : file_names_)
+      remove(file_name.c_str());
+  }
+
+  // Writes |num_frames| random frames, followed by |trailing_bytes| of an
+  // incomplete frame. Frame i starts with the value i.
+  std::string WriteVideoFile(int num_frames, bool y4m, size_t trailing_bytes) {
+    const std::string file_name =
+        TempFilename(OutputPath(), "parallel_video_analysis");
+    file_names_.push_back(file_name);
+    FILE* file = fopen(file_name.c_str(), "wb");
+    if (y4m)
+      fprintf(file, "YUV4MPEG2 W%d H%d F30:1 C420\n", kWidth, kHeight);
+    std::vector<uint8_t> frame(GetI420FrameSize(kWidth, kHeight));
+    for (int i = 0; i < num_frames; ++i) {
+      for (uint8_t& pixel : frame)
+        pixel = random_.Rand<uint8_t>();
+      frame[0] = static_cast<uint8_t>(i);
+      if (y4m)
+        fprintf(file, "FRAME\n");
+      fwrite(frame.data(), 1, frame.size(), file);
+    }
+    fwrite(frame.data(), 1, trailing_bytes, file);
+    fclose(file);
+    return file_name;
+  }
+
+  Random random_;
+  std::vector<std::string> file_names_;
+};
+
+}  // namespace
+
+TEST_F(ParallelVideoAnalysisTest, MapsRawAndY4mFiles) {
+  const std::string yuv_file = WriteVideoFile(5, false, 100);
+  const std::string y4m_file = WriteVideoFile(7, true, 0);
+
+  std::unique_ptr<MappedVideoFile> yuv =
+      MappedVideoFile::Open(yuv_file, kWidth, kHeight);
+  ASSERT_TRUE(yuv);
+  EXPECT_EQ(5u, yuv->num_frames());
+  std::unique_ptr<MappedVideoFile> y4m =
+      MappedVideoFile::Open(y4m_file, kWidth, kHeight);
+  ASSERT_TRUE(y4m);
+  EXPECT_EQ(7u, y4m->num_frames());
+
+  std::vector<uint8_t> frame(GetI420FrameSize(kWidth, kHeight));
+  for (size_t i = 0; i < y4m->num_frames(); ++i) {
+    ASSERT_TRUE(ExtractFrameFromY4mFile(y4m_file.c_str(), kWidth, kHeight,
+                                        static_cast<int>(i), frame.data()));
+    EXPECT_EQ(0, memcmp(frame.data(), y4m->GetFrame(i), frame.size()));
+  }
+}
+
+TEST_F(ParallelVideoAnalysisTest, MissingFile) {
+  std::vector<FrameQuality> results;
+  EXPECT_FALSE(AnalyzeVideoFilesInParallel(
+      OutputPath() + "does_not_exist.yuv", OutputPath() + "does_not_exist.yuv",
+      kWidth, kHeight, 2, std::vector<FrameQualityMetric*>(), &results));
+}
+
+TEST_F(ParallelVideoAnalysisTest, MatchesSequentialAnalysis) {
+  const std::string reference_file = WriteVideoFile(20, true, 0);
+  const std::string test_file = WriteVideoFile(17, false, 0);
+  std::unique_ptr<MappedVideoFile> reference =
+      MappedVideoFile::Open(reference_file, kWidth, kHeight);
+  std::unique_ptr<MappedVideoFile> test =
+      MappedVideoFile::Open(test_file, kWidth, kHeight);
+  ASSERT_TRUE(reference && test);
+
+  for (size_t num_threads : {1, 4, 0}) {
+    CountingMetric metric;
+    std::vector<FrameQuality> results;
+    ASSERT_TRUE(AnalyzeVideoFilesInParallel(
+        reference_file, test_file, kWidth, kHeight, num_threads, {&metric},
+        &results));
+    ASSERT_EQ(17u, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      const uint8_t* ref_frame = reference->GetFrame(i);
+      const uint8_t* test_frame = test->GetFrame(i);
+      EXPECT_EQ(static_cast<int>(i), results[i].frame_number);
+      EXPECT_EQ(CalculateMetrics(kPSNR, ref_frame, test_frame, kWidth, kHeight),
+                results[i].psnr);
+      EXPECT_EQ(CalculateMetrics(kSSIM, ref_frame, test_frame, kWidth, kHeight),
+                results[i].ssim);
+      ASSERT_EQ(1u, results[i].extra_metrics.size());
+      EXPECT_EQ(static_cast<double>(i), results[i].extra_metrics[0]);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/frame_analyzer/ssim.h"
+
+#include <float.h>
+
+#include <limits>
+#include <vector>
+
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// The constants of libyuv, (64^2 * (0.01 * 255)^2) and (64^2 * (0.03 *
+// 255)^2), scaled by the number of pixels in a window.
+const int64_t kWindowPixels = 64;
+const int64_t kC1 = (26634 * kWindowPixels * kWindowPixels) >> 12;
+const int64_t kC2 = (239708 * kWindowPixels * kWindowPixels) >> 12;
+
+typedef void (*SsimBlockSumsFunction)(const uint8_t* src_a,
+                                      int stride_a,
+                                      const uint8_t* src_b,
+                                      int stride_b,
+                                      int num_blocks,
+                                      SsimBlockSums* sums);
+
+SsimBlockSumsFunction GetSsimBlockSumsFunction() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2))
+    return &CalculateSsimBlockSums_SSE2;
+#endif
+  return &CalculateSsimBlockSums_C;
+}
+
+// The SSIM of the 8x8 window made of the blocks |top| and |bottom| and their
+// right neighbours, computed like libyuv's Ssim8x8_C().
+double WindowSsim(const SsimBlockSums* top, const SsimBlockSums* bottom) {
+  const int64_t sum_a = static_cast<int64_t>(top[0].sum_a) + top[1].sum_a +
+                        bottom[0].sum_a + bottom[1].sum_a;
+  const int64_t sum_b = static_cast<int64_t>(top[0].sum_b) + top[1].sum_b +
+                        bottom[0].sum_b + bottom[1].sum_b;
+  const int64_t sum_sq_a = static_cast<int64_t>(top[0].sum_sq_a) +
+                           top[1].sum_sq_a + bottom[0].sum_sq_a +
+                           bottom[1].sum_sq_a;
+  const int64_t sum_sq_b = static_cast<int64_t>(top[0].sum_sq_b) +
+                           top[1].sum_sq_b + bottom[0].sum_sq_b +
+                           bottom[1].sum_sq_b;
+  const int64_t sum_axb = static_cast<int64_t>(top[0].sum_axb) +
+                          top[1].sum_axb + bottom[0].sum_axb +
+                          bottom[1].sum_axb;
+
+  const int64_t sum_a_x_sum_b = sum_a * sum_b;
+  const int64_t ssim_n =
+      (2 * sum_a_x_sum_b + kC1) *
+      (2 * kWindowPixels * sum_axb - 2 * sum_a_x_sum_b + kC2);
+  const int64_t sum_a_sq = sum_a * sum_a;
+  const int64_t sum_b_sq = sum_b * sum_b;
+  const int64_t ssim_d =
+      (sum_a_sq + sum_b_sq + kC1) *
+      (kWindowPixels * sum_sq_a - sum_a_sq + kWindowPixels * sum_sq_b -
+       sum_b_sq + kC2);
+  if (ssim_d == 0)
+    return DBL_MAX;
+  return ssim_n * 1.0 / ssim_d;
+}
+
+}  // namespace
+
+void CalculateSsimBlockSums_C(const uint8_t* src_a,
+                              int stride_a,
+                              const uint8_t* src_b,
+                              int stride_b,
+                              int num_blocks,
+                              SsimBlockSums* sums) {
+  for (int block = 0; block < num_blocks; ++block) {
+    SsimBlockSums* block_sums = &sums[block];
+    *block_sums = SsimBlockSums();
+    const uint8_t* a = src_a + 4 * block;
+    const uint8_t* b = src_b + 4 * block;
+    for (int row = 0; row < 4; ++row) {
+      for (int col = 0; col < 4; ++col) {
+        block_sums->sum_a += a[col];
+        block_sums->sum_b += b[col];
+        block_sums->sum_sq_a += a[col] * a[col];
+        block_sums->sum_sq_b += b[col] * b[col];
+        block_sums->sum_axb += a[col] * b[col];
+      }
+      a += stride_a;
+      b += stride_b;
+    }
+  }
+}
+
+double CalculatePlaneSsim(const uint8_t* src_a,
+                          int stride_a,
+                          const uint8_t* src_b,
+                          int stride_b,
+                          int width,
+                          int height) {
+  // libyuv starts a window every 4 pixels for as long as it starts less than
+  // 8 pixels from the end.
+  const int num_windows_x = width > 8 ? (width - 8 + 3) / 4 : 0;
+  const int num_windows_y = height > 8 ? (height - 8 + 3) / 4 : 0;
+  if (num_windows_x == 0 || num_windows_y == 0)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  const SsimBlockSumsFunction block_sums_function = GetSsimBlockSumsFunction();
+  const int num_blocks_x = num_windows_x + 1;
+  std::vector<SsimBlockSums> top(num_blocks_x);
+  std::vector<SsimBlockSums> bottom(num_blocks_x);
+  block_sums_function(src_a, stride_a, src_b, stride_b, num_blocks_x,
+                      top.data());
+
+  double ssim_total = 0.0;
+  for (int window_y = 0; window_y < num_windows_y; ++window_y) {
+    const int bottom_row = 4 * (window_y + 1);
+    block_sums_function(src_a + bottom_row * stride_a, stride_a,
+                        src_b + bottom_row * stride_b, stride_b,
+                        num_blocks_x, bottom.data());
+    for (int window_x = 0; window_x < num_windows_x; ++window_x)
+      ssim_total += WindowSsim(&top[window_x], &bottom[window_x]);
+    top.swap(bottom);
+  }
+  return ssim_total / (num_windows_x * num_windows_y);
+}
+
+double CalculateI420Ssim(const uint8_t* src_y_a,
+                         int stride_y_a,
+                         const uint8_t* src_u_a,
+                         int stride_u_a,
+                         const uint8_t* src_v_a,
+                         int stride_v_a,
+                         const uint8_t* src_y_b,
+                         int stride_y_b,
+                         const uint8_t* src_u_b,
+                         int stride_u_b,
+                         const uint8_t* src_v_b,
+                         int stride_v_b,
+                         int width,
+                         int height) {
+  const double ssim_y = CalculatePlaneSsim(src_y_a, stride_y_a, src_y_b,
+                                           stride_y_b, width, height);
+  const int width_uv = (width + 1) >> 1;
+  const int height_uv = (height + 1) >> 1;
+  const double ssim_u = CalculatePlaneSsim(src_u_a, stride_u_a, src_u_b,
+                                           stride_u_b, width_uv, height_uv);
+  const double ssim_v = CalculatePlaneSsim(src_v_a, stride_v_a, src_v_b,
+                                           stride_v_b, width_uv, height_uv);
+  return ssim_y * 0.8 + 0.1 * (ssim_u + ssim_v);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_FRAME_ANALYZER_SSIM_H_
+#define RTC_TOOLS_FRAME_ANALYZER_SSIM_H_
+
+#include <stdint.h>
+
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+namespace test {
+
+// Pixel sums of a 4x4 block of two planes a and b.
+struct SsimBlockSums {
+  uint32_t sum_a;
+  uint32_t sum_b;
+  uint32_t sum_sq_a;
+  uint32_t sum_sq_b;
+  uint32_t sum_axb;
+};
+
+// Calculates the sums of |num_blocks| horizontally adjacent 4x4 blocks,
+// starting at the top left corner of |src_a| and |src_b|.
+void CalculateSsimBlockSums_C(const uint8_t* src_a,
+                              int stride_a,
+                              const uint8_t* src_b,
+                              int stride_b,
+                              int num_blocks,
+                              SsimBlockSums* sums);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void CalculateSsimBlockSums_SSE2(const uint8_t* src_a,
+                                 int stride_a,
+                                 const uint8_t* src_b,
+                                 int stride_b,
+                                 int num_blocks,
+                                 SsimBlockSums* sums);
+#endif
+
+// Returns the same SSIM as libyuv::CalcFrameSsim(), the mean over 8x8 windows
+// placed on a 4 pixel grid. The windows overlap, so the sums of each 4x4
+// block are calculated once, with SSE2 where available, and shared by the
+// four windows covering it. Returns NaN for planes of 8 pixels or less in
+// either direction, like libyuv.
+double CalculatePlaneSsim(const uint8_t* src_a,
+                          int stride_a,
+                          const uint8_t* src_b,
+                          int stride_b,
+                          int width,
+                          int height);
+
+// Returns the same SSIM as libyuv::I420Ssim(), i.e. weighs the Y plane by 0.8
+// and the U and V planes by 0.1 each.
+double CalculateI420Ssim(const uint8_t* src_y_a,
+                         int stride_y_a,
+                         const uint8_t* src_u_a,
+                         int stride_u_a,
+                         const uint8_t* src_v_a,
+                         int stride_v_a,
+                         const uint8_t* src_y_b,
+                         int stride_y_b,
+                         const uint8_t* src_u_b,
+                         int stride_u_b,
+                         const uint8_t* src_v_b,
+                         int stride_v_b,
+                         int width,
+                         int height);
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_FRAME_ANALYZER_SSIM_H_
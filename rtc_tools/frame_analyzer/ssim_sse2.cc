@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+
+#include "rtc_tools/frame_analyzer/ssim.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// |v| holds pair sums of 8 pixels. Stores the sum of the first four pixels in
+// |first| and that of the last four in |second|.
+void StoreBlockPair(__m128i v, uint32_t* first, uint32_t* second) {
+  v = _mm_add_epi32(v, _mm_srli_epi64(v, 32));
+  *first = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+  *second = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+}
+
+}  // namespace
+
+void CalculateSsimBlockSums_SSE2(const uint8_t* src_a,
+                                 int stride_a,
+                                 const uint8_t* src_b,
+                                 int stride_b,
+                                 int num_blocks,
+                                 SsimBlockSums* sums) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+  int block = 0;
+  // Two blocks at a time, 8 pixels per row.
+  for (; block + 2 <= num_blocks; block += 2) {
+    const uint8_t* a = src_a + 4 * block;
+    const uint8_t* b = src_b + 4 * block;
+    __m128i sum_a = zero;
+    __m128i sum_b = zero;
+    __m128i sum_sq_a = zero;
+    __m128i sum_sq_b = zero;
+    __m128i sum_axb = zero;
+    for (int row = 0; row < 4; ++row) {
+      const __m128i a16 = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a)), zero);
+      const __m128i b16 = _mm_unpacklo_epi8(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b)), zero);
+      sum_a = _mm_add_epi32(sum_a, _mm_madd_epi16(a16, ones));
+      sum_b = _mm_add_epi32(sum_b, _mm_madd_epi16(b16, ones));
+      sum_sq_a = _mm_add_epi32(sum_sq_a, _mm_madd_epi16(a16, a16));
+      sum_sq_b = _mm_add_epi32(sum_sq_b, _mm_madd_epi16(b16, b16));
+      sum_axb = _mm_add_epi32(sum_axb, _mm_madd_epi16(a16, b16));
+      a += stride_a;
+      b += stride_b;
+    }
+    StoreBlockPair(sum_a, &sums[block].sum_a, &sums[block + 1].sum_a);
+    StoreBlockPair(sum_b, &sums[block].sum_b, &sums[block + 1].sum_b);
+    StoreBlockPair(sum_sq_a, &sums[block].sum_sq_a, &sums[block + 1].sum_sq_a);
+    StoreBlockPair(sum_sq_b, &sums[block].sum_sq_b, &sums[block + 1].sum_sq_b);
+    StoreBlockPair(sum_axb, &sums[block].sum_axb, &sums[block + 1].sum_axb);
+  }
+  // An odd block is left; reading 8 pixels for it could overrun the plane.
+  if (block < num_blocks) {
+    CalculateSsimBlockSums_C(src_a + 4 * block, stride_a, src_b + 4 * block,
+                             stride_b, num_blocks - block, &sums[block]);
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/frame_analyzer/ssim.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+#include "third_party/libyuv/include/libyuv/compare.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// A random plane and a noisy copy of it, so that the SSIM is neither close to
+// 1 nor to 0.
+void GeneratePlanes(Random* random,
+                    int stride,
+                    int height,
+                    std::vector<uint8_t>* a,
+                    std::vector<uint8_t>* b) {
+  a->resize(stride * height);
+  b->resize(stride * height);
+  for (size_t i = 0; i < a->size(); ++i) {
+    const int pixel = random->Rand(0, 255);
+    const int noise = random->Rand(-20, 20);
+    (*a)[i] = static_cast<uint8_t>(pixel);
+    (*b)[i] = static_cast<uint8_t>(std::min(255, std::max(0, pixel + noise)));
+  }
+}
+
+}  // namespace
+
+TEST(SsimTest, PlaneSsimMatchesLibyuv) {
+  Random random(100);
+  const int kSizes[][2] = {{16, 16}, {176, 144}, {17, 9}, {33, 21}, {9, 400}};
+  for (const auto& size : kSizes) {
+    const int width = size[0];
+    const int height = size[1];
+    // A stride wider than the plane, to catch reads past its right edge.
+    const int stride = width + 3;
+    std::vector<uint8_t> a;
+    std::vector<uint8_t> b;
+    GeneratePlanes(&random, stride, height, &a, &b);
+    EXPECT_EQ(
+        libyuv::CalcFrameSsim(a.data(), stride, b.data(), stride, width,
+                              height),
+        CalculatePlaneSsim(a.data(), stride, b.data(), stride, width, height))
+        << width << "x" << height;
+  }
+}
+
+TEST(SsimTest, IdenticalPlanes) {
+  Random random(101);
+  std::vector<uint8_t> a;
+  std::vector<uint8_t> b;
+  GeneratePlanes(&random, 64, 48, &a, &b);
+  EXPECT_DOUBLE_EQ(1.0,
+                   CalculatePlaneSsim(a.data(), 64, a.data(), 64, 64, 48));
+}
+
+TEST(SsimTest, TooSmallPlane) {
+  std::vector<uint8_t> a(8 * 64, 128);
+  EXPECT_TRUE(isnan(CalculatePlaneSsim(a.data(), 8, a.data(), 8, 8, 64)));
+  EXPECT_TRUE(isnan(CalculatePlaneSsim(a.data(), 64, a.data(), 64, 64, 8)));
+}
+
+TEST(SsimTest, I420SsimMatchesLibyuv) {
+  Random random(102);
+  const int kWidth = 352;
+  const int kHeight = 288;
+  const int kHalfWidth = (kWidth + 1) / 2;
+  const int kHalfHeight = (kHeight + 1) / 2;
+  std::vector<uint8_t> y_a, y_b, u_a, u_b, v_a, v_b;
+  GeneratePlanes(&random, kWidth, kHeight, &y_a, &y_b);
+  GeneratePlanes(&random, kHalfWidth, kHalfHeight, &u_a, &u_b);
+  GeneratePlanes(&random, kHalfWidth, kHalfHeight, &v_a, &v_b);
+  EXPECT_EQ(
+      libyuv::I420Ssim(y_a.data(), kWidth, u_a.data(), kHalfWidth, v_a.data(),
+                       kHalfWidth, y_b.data(), kWidth, u_b.data(), kHalfWidth,
+                       v_b.data(), kHalfWidth, kWidth, kHeight),
+      CalculateI420Ssim(y_a.data(), kWidth, u_a.data(), kHalfWidth,
+                        v_a.data(), kHalfWidth, y_b.data(), kWidth,
+                        u_b.data(), kHalfWidth, v_b.data(), kHalfWidth, kWidth,
+                        kHeight));
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(SsimTest, Sse2BlockSumsMatchC) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  Random random(103);
+  const int kStride = 64;
+  std::vector<uint8_t> a;
+  std::vector<uint8_t> b;
+  GeneratePlanes(&random, kStride, 4, &a, &b);
+  // Odd counts end with a block the SSE2 version leaves to C.
+  for (int num_blocks = 1; num_blocks <= kStride / 4; ++num_blocks) {
+    std::vector<SsimBlockSums> expected(num_blocks);
+    std::vector<SsimBlockSums> actual(num_blocks);
+    CalculateSsimBlockSums_C(a.data(), kStride, b.data(), kStride, num_blocks,
+                             expected.data());
+    CalculateSsimBlockSums_SSE2(a.data(), kStride, b.data(), kStride,
+                                num_blocks, actual.data());
+    for (int i = 0; i < num_blocks; ++i) {
+      EXPECT_EQ(expected[i].sum_a, actual[i].sum_a);
+      EXPECT_EQ(expected[i].sum_b, actual[i].sum_b);
+      EXPECT_EQ(expected[i].sum_sq_a, actual[i].sum_sq_a);
+      EXPECT_EQ(expected[i].sum_sq_b, actual[i].sum_sq_b);
+      EXPECT_EQ(expected[i].sum_axb, actual[i].sum_axb);
+    }
+  }
+}
+#endif
+
+}  // namespace test
+}  // namespace webrtc
@@ -18,6 +18,7 @@
 #include <string>
 #include <utility>
 
+#include "rtc_tools/frame_analyzer/ssim.h"
 #include "test/testsupport/perf_test.h"
 
 #define STATS_LINE_LENGTH 32
@@ -212,9 +213,10 @@ double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
       result = (result > 48.0) ? 48.0 : result;
       break;
     case kSSIM:
-      result = libyuv::I420Ssim(src_y_a, stride_y, src_u_a, stride_uv, src_v_a,
-                                stride_uv, src_y_b, stride_y, src_u_b,
-                                stride_uv, src_v_b, stride_uv, width, height);
+      // Same result as libyuv::I420Ssim(), which has no SIMD version.
+      result = CalculateI420Ssim(src_y_a, stride_y, src_u_a, stride_uv,
+                                 src_v_a, stride_uv, src_y_b, stride_y, src_u_b,
+                                 stride_uv, src_v_b, stride_uv, width, height);
       break;
     default:
       assert(false);
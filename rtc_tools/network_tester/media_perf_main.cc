@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "rtc_base/flags.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/physicalsocketserver.h"
+#include "rtc_base/ssladapter.h"
+#include "rtc_base/thread.h"
+#include "rtc_tools/network_tester/media_perf_session.h"
+#include "system_wrappers/include/field_trial_default.h"
+#include "test/testsupport/perf_test.h"
+
+DEFINE_int(listen_port,
+           0,
+           "Wait for the other end to connect on this TCP port. The other "
+           "end must be given --connect.");
+DEFINE_string(connect,
+              "",
+              "Connect to the other end at this host:port, where it listens "
+              "with --listen_port.");
+DEFINE_string(stun_server,
+              "",
+              "STUN server for reaching the other end from behind a NAT, e.g. "
+              "stun:stun.l.google.com:19302.");
+DEFINE_bool(audio, true, "Send audio.");
+DEFINE_bool(video, true, "Send video.");
+DEFINE_int(width, 640, "Video width.");
+DEFINE_int(height, 480, "Video height.");
+DEFINE_int(fps, 30, "Video frame rate.");
+DEFINE_int(connect_timeout_s,
+           60,
+           "Give up if the call hasn't connected after this many seconds.");
+DEFINE_int(warmup_s,
+           10,
+           "Time for the bandwidth estimate to ramp up before the stats are "
+           "recorded, in seconds.");
+DEFINE_int(duration_s, 60, "Measurement duration, in seconds.");
+DEFINE_int(stats_interval_ms, 1000, "Interval between the stats samples.");
+DEFINE_string(stats_file,
+              "",
+              "Write every sampled RTCStatsReport to this file, as one JSON "
+              "object per line.");
+DEFINE_string(event_log, "", "Write the RtcEventLog of the call to this file.");
+DEFINE_string(label,
+              "media_perf",
+              "Name of the trace in the perf results, e.g. the version of the "
+              "stack and the network path.");
+DEFINE_string(force_fieldtrials,
+              "",
+              "Field trials control experimental feature code which can be "
+              "forced. E.g. running with "
+              "--force_fieldtrials=WebRTC-FooFeature/Enable/ will assign the "
+              "group Enable to field trial WebRTC-FooFeature.");
+DEFINE_string(isolated_script_test_perf_output,
+              "",
+              "Path where the perf results should be stored in the JSON "
+              "format of test/testsupport/perf_test.h.");
+DEFINE_bool(logs, false, "Print logs to stderr.");
+DEFINE_bool(help, false, "Print this message.");
+
+int main(int argc, char* argv[]) {
+  const std::string usage =
+      "Runs a PeerConnection call with audio and video between two hosts "
+      "and reports the achieved bitrate, losses and latencies.\n"
+      "Usage: " +
+      std::string(argv[0]) +
+      " --listen_port=<port> [options]\n"
+      "   or: " +
+      std::string(argv[0]) + " --connect=<host>:<port> [options]\n";
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) || FLAG_help ||
+      argc != 1 || (FLAG_listen_port > 0) == (strlen(FLAG_connect) > 0) ||
+      FLAG_duration_s <= 0 || FLAG_stats_interval_ms <= 0) {
+    printf("%s", usage.c_str());
+    if (FLAG_help) {
+      rtc::FlagList::Print(nullptr, false);
+      return 0;
+    }
+    return 1;
+  }
+  rtc::LogMessage::LogToDebug(FLAG_logs ? rtc::LS_INFO : rtc::LS_ERROR);
+  // InitFieldTrialsFromString stores the char*, so the flag must outlive the
+  // application.
+  webrtc::field_trial::InitFieldTrialsFromString(FLAG_force_fieldtrials);
+
+  webrtc::MediaPerfSession::Config config;
+  config.listen_port = FLAG_listen_port;
+  if (strlen(FLAG_connect) > 0 &&
+      !config.remote_address.FromString(FLAG_connect)) {
+    fprintf(stderr, "Invalid address: %s\n", FLAG_connect);
+    return 1;
+  }
+  config.stun_server = FLAG_stun_server;
+  config.audio = FLAG_audio;
+  config.video = FLAG_video;
+  config.video_config.width = FLAG_width;
+  config.video_config.height = FLAG_height;
+  config.video_config.frames_per_second = FLAG_fps;
+  config.connect_timeout_s = FLAG_connect_timeout_s;
+  config.warmup_s = FLAG_warmup_s;
+  config.duration_s = FLAG_duration_s;
+  config.stats_interval_ms = FLAG_stats_interval_ms;
+  config.stats_file = FLAG_stats_file;
+  config.event_log_file = FLAG_event_log;
+
+  rtc::InitializeSSL();
+  int result = 0;
+  {
+    rtc::PhysicalSocketServer socket_server;
+    rtc::AutoSocketServerThread main_thread(&socket_server);
+    webrtc::MediaPerfSession session(config);
+    if (session.Run()) {
+      webrtc::MediaPerfStats::PrintSummary(session.stats().GetSummary(),
+                                           FLAG_label);
+    } else {
+      result = 1;
+    }
+  }
+  rtc::CleanupSSL();
+
+  if (result == 0 && strlen(FLAG_isolated_script_test_perf_output) > 0)
+    webrtc::test::WritePerfResults(FLAG_isolated_script_test_perf_output);
+  return result;
+}
@@ -0,0 +1,430 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/network_tester/media_perf_session.h"
+
+#include <string.h>
+
+#include <functional>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/audio_codecs/builtin_audio_encoder_factory.h"
+#include "api/video_codecs/builtin_video_decoder_factory.h"
+#include "api/video_codecs/builtin_video_encoder_factory.h"
+#include "logging/rtc_event_log/output/rtc_event_log_output_file.h"
+#include "pc/test/fakeaudiocapturemodule.h"
+#include "rtc_base/asynctcpsocket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+
+// Signaling messages are a prefix followed by the payload.
+constexpr char kOfferPrefix[] = "offer\n";
+constexpr char kAnswerPrefix[] = "answer\n";
+constexpr char kHangUpMessage[] = "bye\n";
+
+constexpr int kPollIntervalMs = 10;
+constexpr int64_t kEventLogOutputPeriodMs = 5000;
+const char kStreamId[] = "media_perf";
+
+bool StartsWith(const std::string& message, const char* prefix) {
+  return message.compare(0, strlen(prefix), prefix) == 0;
+}
+
+class CreateDescriptionObserver : public CreateSessionDescriptionObserver {
+ public:
+  CreateDescriptionObserver(
+      std::function<void(SessionDescriptionInterface*)> on_success,
+      std::function<void(const std::string&)> on_failure)
+      : on_success_(std::move(on_success)),
+        on_failure_(std::move(on_failure)) {}
+
+  void OnSuccess(SessionDescriptionInterface* description) override {
+    on_success_(description);
+  }
+  void OnFailure(RTCError error) override { on_failure_(error.message()); }
+
+ private:
+  const std::function<void(SessionDescriptionInterface*)> on_success_;
+  const std::function<void(const std::string&)> on_failure_;
+};
+
+class SetDescriptionObserver : public SetSessionDescriptionObserver {
+ public:
+  explicit SetDescriptionObserver(
+      std::function<void(const std::string&)> on_failure)
+      : on_failure_(std::move(on_failure)) {}
+
+  void OnSuccess() override {}
+  void OnFailure(RTCError error) override { on_failure_(error.message()); }
+
+ private:
+  const std::function<void(const std::string&)> on_failure_;
+};
+
+class StatsCallback : public RTCStatsCollectorCallback {
+ public:
+  explicit StatsCallback(
+      std::function<void(const rtc::scoped_refptr<const RTCStatsReport>&)>
+          callback)
+      : callback_(std::move(callback)) {}
+
+  void OnStatsDelivered(
+      const rtc::scoped_refptr<const RTCStatsReport>& report) override {
+    callback_(report);
+  }
+
+ private:
+  const std::function<void(const rtc::scoped_refptr<const RTCStatsReport>&)>
+      callback_;
+};
+
+}  // namespace
+
+MediaPerfSession::MediaPerfSession(const Config& config)
+    : config_(config),
+      signaling_thread_(rtc::Thread::Current()),
+      network_thread_(rtc::Thread::CreateWithSocketServer()),
+      worker_thread_(rtc::Thread::Create()) {
+  RTC_CHECK(signaling_thread_);
+  RTC_CHECK((config_.listen_port > 0) != !config_.remote_address.IsNil())
+      << "Either listen on a port or connect to a remote address.";
+  network_thread_->SetName("MediaPerfNetwork", nullptr);
+  worker_thread_->SetName("MediaPerfWorker", nullptr);
+  RTC_CHECK(network_thread_->Start());
+  RTC_CHECK(worker_thread_->Start());
+  factory_ = CreatePeerConnectionFactory(
+      network_thread_.get(), worker_thread_.get(), signaling_thread_,
+      rtc::scoped_refptr<AudioDeviceModule>(FakeAudioCaptureModule::Create()),
+      CreateBuiltinAudioEncoderFactory(), CreateBuiltinAudioDecoderFactory(),
+      CreateBuiltinVideoEncoderFactory(), CreateBuiltinVideoDecoderFactory(),
+      nullptr /* audio_mixer */, nullptr /* audio_processing */);
+  RTC_CHECK(factory_);
+}
+
+MediaPerfSession::~MediaPerfSession() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  signaling_socket_.reset();
+  listen_socket_.reset();
+  if (peer_connection_)
+    peer_connection_->Close();
+  peer_connection_ = nullptr;
+  if (video_source_)
+    video_source_->Stop();
+  video_source_ = nullptr;
+  factory_ = nullptr;
+  if (stats_file_)
+    fclose(stats_file_);
+}
+
+bool MediaPerfSession::Run() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  if (!config_.stats_file.empty()) {
+    stats_file_ = fopen(config_.stats_file.c_str(), "w");
+    if (!stats_file_) {
+      RTC_LOG(LS_ERROR) << "Failed to open " << config_.stats_file;
+      return false;
+    }
+  }
+  if (!StartSignaling())
+    return false;
+
+  const int64_t start_time_ms = rtc::TimeMillis();
+  int64_t next_stats_time_ms = -1;
+  int64_t end_time_ms = -1;
+  bool final_stats_requested = false;
+  while (!failed_) {
+    signaling_thread_->ProcessMessages(kPollIntervalMs);
+    const int64_t now_ms = rtc::TimeMillis();
+    if (connected_time_ms_ < 0) {
+      if (remote_hung_up_) {
+        Fail("The remote end hung up before the call was connected.");
+      } else if (now_ms - start_time_ms >
+                 config_.connect_timeout_s * rtc::kNumMillisecsPerSec) {
+        Fail("Timed out waiting for the call to connect.");
+      }
+      continue;
+    }
+    if (next_stats_time_ms < 0) {
+      next_stats_time_ms =
+          connected_time_ms_ + config_.warmup_s * rtc::kNumMillisecsPerSec;
+      end_time_ms =
+          next_stats_time_ms + config_.duration_s * rtc::kNumMillisecsPerSec;
+    }
+    if (stats_pending_)
+      continue;
+    if (now_ms >= end_time_ms || remote_hung_up_) {
+      // Take a last report at the end of the call.
+      if (final_stats_requested)
+        break;
+      final_stats_requested = true;
+      RequestStats();
+    } else if (now_ms >= next_stats_time_ms) {
+      next_stats_time_ms += config_.stats_interval_ms;
+      RequestStats();
+    }
+  }
+  if (failed_)
+    return false;
+
+  if (!remote_hung_up_)
+    SendSignalingMessage(kHangUpMessage);
+  peer_connection_->StopRtcEventLog();
+  if (stats_.num_reports() < 2) {
+    RTC_LOG(LS_ERROR) << "The call ended before there were stats.";
+    return false;
+  }
+  return true;
+}
+
+void MediaPerfSession::OnIceConnectionChange(
+    PeerConnectionInterface::IceConnectionState new_state) {
+  RTC_LOG(LS_INFO) << "ICE connection state: " << new_state;
+  if (connected_time_ms_ < 0 &&
+      (new_state == PeerConnectionInterface::kIceConnectionConnected ||
+       new_state == PeerConnectionInterface::kIceConnectionCompleted)) {
+    connected_time_ms_ = rtc::TimeMillis();
+  } else if (new_state == PeerConnectionInterface::kIceConnectionFailed) {
+    Fail("ICE failed.");
+  }
+}
+
+void MediaPerfSession::OnIceGatheringChange(
+    PeerConnectionInterface::IceGatheringState new_state) {
+  // The descriptions are sent once they have all candidates, so that no
+  // candidates need to be trickled.
+  if (new_state != PeerConnectionInterface::kIceGatheringComplete ||
+      description_sent_) {
+    return;
+  }
+  const SessionDescriptionInterface* description =
+      peer_connection_->local_description();
+  RTC_DCHECK(description);
+  std::string sdp;
+  description->ToString(&sdp);
+  description_sent_ = true;
+  SendSignalingMessage((description->GetType() == SdpType::kOffer
+                            ? kOfferPrefix
+                            : kAnswerPrefix) +
+                       sdp);
+}
+
+bool MediaPerfSession::StartSignaling() {
+  rtc::SocketServer* socket_server = signaling_thread_->socketserver();
+  rtc::AsyncSocket* socket =
+      socket_server->CreateAsyncSocket(AF_INET, SOCK_STREAM);
+  if (config_.listen_port > 0) {
+    if (socket->Bind(rtc::SocketAddress(rtc::GetAnyIP(AF_INET),
+                                        config_.listen_port)) < 0) {
+      RTC_LOG(LS_ERROR) << "Failed to bind to port " << config_.listen_port;
+      delete socket;
+      return false;
+    }
+    listen_socket_ = absl::make_unique<rtc::AsyncTCPSocket>(socket, true);
+    listen_socket_->SignalNewConnection.connect(
+        this, &MediaPerfSession::OnNewConnection);
+    RTC_LOG(LS_INFO) << "Waiting for a connection on port "
+                     << config_.listen_port;
+    return true;
+  }
+  signaling_socket_.reset(rtc::AsyncTCPSocket::Create(
+      socket, rtc::SocketAddress(rtc::GetAnyIP(AF_INET), 0),
+      config_.remote_address));
+  if (!signaling_socket_) {
+    RTC_LOG(LS_ERROR) << "Failed to connect to "
+                      << config_.remote_address.ToString();
+    return false;
+  }
+  signaling_socket_->SignalConnect.connect(
+      this, &MediaPerfSession::OnSignalingConnect);
+  signaling_socket_->SignalClose.connect(this,
+                                         &MediaPerfSession::OnSignalingClose);
+  signaling_socket_->SignalReadPacket.connect(
+      this, &MediaPerfSession::OnSignalingMessage);
+  return true;
+}
+
+void MediaPerfSession::OnNewConnection(rtc::AsyncPacketSocket* listener,
+                                       rtc::AsyncPacketSocket* socket) {
+  if (signaling_socket_) {
+    // Only one call at a time.
+    delete socket;
+    return;
+  }
+  RTC_LOG(LS_INFO) << "Connection from "
+                   << socket->GetRemoteAddress().ToString();
+  signaling_socket_.reset(socket);
+  signaling_socket_->SignalClose.connect(this,
+                                         &MediaPerfSession::OnSignalingClose);
+  signaling_socket_->SignalReadPacket.connect(
+      this, &MediaPerfSession::OnSignalingMessage);
+}
+
+void MediaPerfSession::OnSignalingConnect(rtc::AsyncPacketSocket* socket) {
+  if (!CreatePeerConnection())
+    return;
+  peer_connection_->CreateOffer(
+      new rtc::RefCountedObject<CreateDescriptionObserver>(
+          [this](SessionDescriptionInterface* description) {
+            OnSessionDescriptionCreated(description);
+          },
+          [this](const std::string& error) {
+            Fail("CreateOffer failed: " + error);
+          }),
+      PeerConnectionInterface::RTCOfferAnswerOptions());
+}
+
+void MediaPerfSession::OnSignalingClose(rtc::AsyncPacketSocket* socket,
+                                        int error) {
+  RTC_LOG(LS_INFO) << "The signaling connection was closed: " << error;
+  remote_hung_up_ = true;
+}
+
+void MediaPerfSession::OnSignalingMessage(
+    rtc::AsyncPacketSocket* socket,
+    const char* data,
+    size_t len,
+    const rtc::SocketAddress& remote_address,
+    const rtc::PacketTime& packet_time) {
+  const std::string message(data, len);
+  if (StartsWith(message, kOfferPrefix) && config_.listen_port > 0) {
+    OnRemoteDescription(SdpType::kOffer, message.substr(strlen(kOfferPrefix)));
+  } else if (StartsWith(message, kAnswerPrefix) && config_.listen_port == 0) {
+    OnRemoteDescription(SdpType::kAnswer,
+                        message.substr(strlen(kAnswerPrefix)));
+  } else if (message == kHangUpMessage) {
+    RTC_LOG(LS_INFO) << "The remote end hung up.";
+    remote_hung_up_ = true;
+  } else {
+    Fail("Unexpected signaling message: " + message.substr(0, 20));
+  }
+}
+
+void MediaPerfSession::SendSignalingMessage(const std::string& message) {
+  if (signaling_socket_->Send(message.data(), message.size(),
+                              rtc::PacketOptions()) < 0) {
+    Fail("Failed to send a signaling message.");
+  }
+}
+
+bool MediaPerfSession::CreatePeerConnection() {
+  PeerConnectionInterface::RTCConfiguration configuration;
+  configuration.sdp_semantics = SdpSemantics::kUnifiedPlan;
+  if (!config_.stun_server.empty()) {
+    PeerConnectionInterface::IceServer server;
+    server.uri = config_.stun_server;
+    configuration.servers.push_back(server);
+  }
+  peer_connection_ = factory_->CreatePeerConnection(
+      configuration, PeerConnectionDependencies(this));
+  if (!peer_connection_) {
+    Fail("Failed to create the PeerConnection.");
+    return false;
+  }
+  if (!config_.event_log_file.empty() &&
+      !peer_connection_->StartRtcEventLog(
+          absl::make_unique<RtcEventLogOutputFile>(config_.event_log_file),
+          kEventLogOutputPeriodMs)) {
+    Fail("Failed to start the event log.");
+    return false;
+  }
+
+  if (config_.audio) {
+    rtc::scoped_refptr<AudioTrackInterface> track = factory_->CreateAudioTrack(
+        "audio", factory_->CreateAudioSource(cricket::AudioOptions()));
+    if (!peer_connection_->AddTrack(track, {kStreamId}).ok()) {
+      Fail("Failed to add the audio track.");
+      return false;
+    }
+  }
+  if (config_.video) {
+    video_source_ =
+        new rtc::RefCountedObject<FrameGeneratorCapturerVideoTrackSource>(
+            config_.video_config, Clock::GetRealTimeClock());
+    video_source_->Start();
+    rtc::scoped_refptr<VideoTrackInterface> track =
+        factory_->CreateVideoTrack("video", video_source_);
+    if (!peer_connection_->AddTrack(track, {kStreamId}).ok()) {
+      Fail("Failed to add the video track.");
+      return false;
+    }
+  }
+  return true;
+}
+
+void MediaPerfSession::OnRemoteDescription(SdpType type,
+                                           const std::string& sdp) {
+  SdpParseError error;
+  std::unique_ptr<SessionDescriptionInterface> description =
+      CreateSessionDescription(type, sdp, &error);
+  if (!description) {
+    Fail("Failed to parse the remote description: " + error.description);
+    return;
+  }
+  if (type == SdpType::kOffer && !CreatePeerConnection())
+    return;
+  peer_connection_->SetRemoteDescription(
+      new rtc::RefCountedObject<SetDescriptionObserver>(
+          [this](const std::string& error) {
+            Fail("SetRemoteDescription failed: " + error);
+          }),
+      description.release());
+  if (type != SdpType::kOffer)
+    return;
+  peer_connection_->CreateAnswer(
+      new rtc::RefCountedObject<CreateDescriptionObserver>(
+          [this](SessionDescriptionInterface* description) {
+            OnSessionDescriptionCreated(description);
+          },
+          [this](const std::string& error) {
+            Fail("CreateAnswer failed: " + error);
+          }),
+      PeerConnectionInterface::RTCOfferAnswerOptions());
+}
+
+void MediaPerfSession::OnSessionDescriptionCreated(
+    SessionDescriptionInterface* description) {
+  // The description is sent once ICE gathering is complete.
+  peer_connection_->SetLocalDescription(
+      new rtc::RefCountedObject<SetDescriptionObserver>(
+          [this](const std::string& error) {
+            Fail("SetLocalDescription failed: " + error);
+          }),
+      description);
+}
+
+void MediaPerfSession::RequestStats() {
+  stats_pending_ = true;
+  peer_connection_->GetStats(new rtc::RefCountedObject<StatsCallback>(
+      [this](const rtc::scoped_refptr<const RTCStatsReport>& report) {
+        OnStatsDelivered(report);
+      }));
+}
+
+void MediaPerfSession::OnStatsDelivered(
+    const rtc::scoped_refptr<const RTCStatsReport>& report) {
+  stats_pending_ = false;
+  stats_.AddReport(*report);
+  if (stats_file_)
+    fprintf(stats_file_, "%s\n", report->ToJson().c_str());
+}
+
+void MediaPerfSession::Fail(const std::string& error) {
+  RTC_LOG(LS_ERROR) << error;
+  failed_ = true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_NETWORK_TESTER_MEDIA_PERF_SESSION_H_
+#define RTC_TOOLS_NETWORK_TESTER_MEDIA_PERF_SESSION_H_
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+
+#include "api/peerconnectioninterface.h"
+#include "pc/test/framegeneratorcapturervideotracksource.h"
+#include "rtc_base/asyncpacketsocket.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/socketaddress.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/thread.h"
+#include "rtc_tools/network_tester/media_perf_stats.h"
+
+namespace webrtc {
+
+// One end of a PeerConnection call between two hosts, for measuring the media
+// stack on a real network path. Both ends send audio and video, from a
+// FakeAudioCaptureModule and a FrameGeneratorCapturer. One end listens for
+// the other on a TCP port, over which the offer and the answer are exchanged;
+// the descriptions carry all ICE candidates, so the path must allow a direct
+// connection, possibly with the help of a STUN server.
+//
+// Once ICE is connected and the warm-up has passed, the RTC stats are
+// sampled for the duration of the call, written to |stats_file| as one JSON
+// report per line, and summarized by stats(). The RtcEventLog is written to
+// |event_log_file|, for analysis with the event_log_visualizer.
+class MediaPerfSession : public PeerConnectionObserver,
+                         public sigslot::has_slots<> {
+ public:
+  struct Config {
+    // The listening end has a |listen_port|, the other a |remote_address|.
+    int listen_port = 0;
+    rtc::SocketAddress remote_address;
+    // As in an RTCIceServer, e.g. "stun:stun.l.google.com:19302".
+    std::string stun_server;
+    bool audio = true;
+    bool video = true;
+    FrameGeneratorCapturerVideoTrackSource::Config video_config;
+    int connect_timeout_s = 60;
+    int warmup_s = 10;
+    int duration_s = 60;
+    int stats_interval_ms = 1000;
+    std::string stats_file;
+    std::string event_log_file;
+  };
+
+  explicit MediaPerfSession(const Config& config);
+  ~MediaPerfSession() override;
+
+  // Sets up the call, runs it until the configured duration has passed or
+  // the remote end hangs up, and returns whether it succeeded. Must be called
+  // on a thread with a socket server, which becomes the signaling thread.
+  bool Run();
+
+  const MediaPerfStats& stats() const { return stats_; }
+
+ private:
+  // PeerConnectionObserver implementation.
+  void OnSignalingChange(
+      PeerConnectionInterface::SignalingState new_state) override {}
+  void OnDataChannel(
+      rtc::scoped_refptr<DataChannelInterface> data_channel) override {}
+  void OnRenegotiationNeeded() override {}
+  void OnIceConnectionChange(
+      PeerConnectionInterface::IceConnectionState new_state) override;
+  void OnIceGatheringChange(
+      PeerConnectionInterface::IceGatheringState new_state) override;
+  void OnIceCandidate(const IceCandidateInterface* candidate) override {}
+
+  bool StartSignaling();
+  void OnNewConnection(rtc::AsyncPacketSocket* listener,
+                       rtc::AsyncPacketSocket* socket);
+  void OnSignalingConnect(rtc::AsyncPacketSocket* socket);
+  void OnSignalingClose(rtc::AsyncPacketSocket* socket, int error);
+  void OnSignalingMessage(rtc::AsyncPacketSocket* socket,
+                          const char* data,
+                          size_t len,
+                          const rtc::SocketAddress& remote_address,
+                          const rtc::PacketTime& packet_time);
+  void SendSignalingMessage(const std::string& message);
+
+  bool CreatePeerConnection();
+  void OnRemoteDescription(SdpType type, const std::string& sdp);
+  void OnSessionDescriptionCreated(SessionDescriptionInterface* description);
+  void RequestStats();
+  void OnStatsDelivered(const rtc::scoped_refptr<const RTCStatsReport>& report);
+  void Fail(const std::string& error);
+
+  const Config config_;
+  rtc::Thread* const signaling_thread_;
+  std::unique_ptr<rtc::Thread> network_thread_;
+  std::unique_ptr<rtc::Thread> worker_thread_;
+  rtc::scoped_refptr<PeerConnectionFactoryInterface> factory_;
+  rtc::scoped_refptr<FrameGeneratorCapturerVideoTrackSource> video_source_;
+  rtc::scoped_refptr<PeerConnectionInterface> peer_connection_;
+
+  std::unique_ptr<rtc::AsyncPacketSocket> listen_socket_;
+  std::unique_ptr<rtc::AsyncPacketSocket> signaling_socket_;
+
+  bool failed_ = false;
+  bool remote_hung_up_ = false;
+  bool description_sent_ = false;
+  // -1 until ICE has connected.
+  int64_t connected_time_ms_ = -1;
+  bool stats_pending_ = false;
+  MediaPerfStats stats_;
+  FILE* stats_file_ = nullptr;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MediaPerfSession);
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_NETWORK_TESTER_MEDIA_PERF_SESSION_H_
@@ -0,0 +1,225 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/network_tester/media_perf_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "api/stats/rtcstats_objects.h"
+#include "rtc_base/timeutils.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// Nearest-rank percentile of |values|, 0 if there are none.
+double Percentile(std::vector<double> values, double percentile) {
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  const size_t rank = static_cast<size_t>(
+      std::ceil(percentile / 100 * values.size()));
+  return values[std::max<size_t>(rank, 1) - 1];
+}
+
+double Mean(const std::vector<double>& values) {
+  if (values.empty())
+    return 0.0;
+  return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+template <typename T>
+T ValueOrZero(const RTCStatsMember<T>& member) {
+  return member.is_defined() ? *member : T();
+}
+
+bool IsKind(const RTCStatsMember<std::string>& member, const char* kind) {
+  return member.is_defined() && *member == kind;
+}
+
+}  // namespace
+
+MediaPerfStats::MediaPerfStats() = default;
+
+MediaPerfStats::~MediaPerfStats() = default;
+
+void MediaPerfStats::AddReport(const RTCStatsReport& report) {
+  const Totals totals = GetTotals(report);
+  if (first_) {
+    const double interval_s =
+        static_cast<double>(totals.timestamp_us - last_.timestamp_us) /
+        rtc::kNumMicrosecsPerSec;
+    if (interval_s > 0) {
+      video_receive_bitrates_kbps_.push_back(
+          (totals.video_bytes_received - last_.video_bytes_received) * 8 /
+          interval_s / 1000);
+    }
+  } else {
+    first_ = totals;
+  }
+  last_ = totals;
+  ++num_reports_;
+
+  for (const RTCInboundRTPStreamStats* inbound :
+       report.GetStatsOfType<RTCInboundRTPStreamStats>()) {
+    if (IsKind(inbound->media_type, RTCMediaStreamTrackKind::kVideo) &&
+        inbound->jitter.is_defined()) {
+      video_jitters_ms_.push_back(*inbound->jitter * 1000);
+    }
+  }
+  for (const RTCTransportStats* transport :
+       report.GetStatsOfType<RTCTransportStats>()) {
+    if (!transport->selected_candidate_pair_id.is_defined())
+      continue;
+    const RTCStats* stats = report.Get(*transport->selected_candidate_pair_id);
+    if (!stats)
+      continue;
+    const auto& pair = stats->cast_to<RTCIceCandidatePairStats>();
+    if (pair.current_round_trip_time.is_defined())
+      rtts_ms_.push_back(*pair.current_round_trip_time * 1000);
+    if (pair.available_outgoing_bitrate.is_defined()) {
+      available_outgoing_bitrates_kbps_.push_back(
+          *pair.available_outgoing_bitrate / 1000);
+    }
+  }
+}
+
+MediaPerfStats::Summary MediaPerfStats::GetSummary() const {
+  Summary summary;
+  if (!first_)
+    return summary;
+  const Totals& first = *first_;
+  summary.duration_s =
+      static_cast<double>(last_.timestamp_us - first.timestamp_us) /
+      rtc::kNumMicrosecsPerSec;
+  if (summary.duration_s > 0) {
+    const double kbits_per_byte_and_s = 8.0 / 1000 / summary.duration_s;
+    summary.video_send_bitrate_kbps =
+        (last_.video_bytes_sent - first.video_bytes_sent) *
+        kbits_per_byte_and_s;
+    summary.audio_send_bitrate_kbps =
+        (last_.audio_bytes_sent - first.audio_bytes_sent) *
+        kbits_per_byte_and_s;
+    summary.video_receive_bitrate_kbps =
+        (last_.video_bytes_received - first.video_bytes_received) *
+        kbits_per_byte_and_s;
+    summary.audio_receive_bitrate_kbps =
+        (last_.audio_bytes_received - first.audio_bytes_received) *
+        kbits_per_byte_and_s;
+  }
+  summary.video_receive_bitrate_p5_kbps =
+      Percentile(video_receive_bitrates_kbps_, 5);
+  summary.available_outgoing_bitrate_kbps =
+      Mean(available_outgoing_bitrates_kbps_);
+
+  summary.packets_received = last_.packets_received - first.packets_received;
+  summary.packets_lost = last_.packets_lost - first.packets_lost;
+  if (summary.packets_received + summary.packets_lost > 0) {
+    summary.loss_percent = 100.0 * summary.packets_lost /
+                           (summary.packets_received + summary.packets_lost);
+  }
+  summary.nacks_sent = last_.nacks_sent - first.nacks_sent;
+  summary.plis_sent = last_.plis_sent - first.plis_sent;
+  summary.firs_sent = last_.firs_sent - first.firs_sent;
+  summary.frames_decoded = last_.frames_decoded - first.frames_decoded;
+  summary.frames_dropped = last_.frames_dropped - first.frames_dropped;
+  const uint64_t samples_received =
+      last_.audio_samples_received - first.audio_samples_received;
+  if (samples_received > 0) {
+    summary.concealed_audio_percent =
+        100.0 *
+        (last_.audio_samples_concealed - first.audio_samples_concealed) /
+        samples_received;
+  }
+
+  summary.rtt_p50_ms = Percentile(rtts_ms_, 50);
+  summary.rtt_p95_ms = Percentile(rtts_ms_, 95);
+  summary.rtt_p99_ms = Percentile(rtts_ms_, 99);
+  summary.video_jitter_p50_ms = Percentile(video_jitters_ms_, 50);
+  summary.video_jitter_p95_ms = Percentile(video_jitters_ms_, 95);
+  return summary;
+}
+
+void MediaPerfStats::PrintSummary(const Summary& summary,
+                                  const std::string& trace) {
+  test::PrintResult("video_send_bitrate", "", trace,
+                    summary.video_send_bitrate_kbps, "kbps", true);
+  test::PrintResult("audio_send_bitrate", "", trace,
+                    summary.audio_send_bitrate_kbps, "kbps", false);
+  test::PrintResult("video_receive_bitrate", "", trace,
+                    summary.video_receive_bitrate_kbps, "kbps", true);
+  test::PrintResult("audio_receive_bitrate", "", trace,
+                    summary.audio_receive_bitrate_kbps, "kbps", false);
+  test::PrintResult("video_receive_bitrate_p5", "", trace,
+                    summary.video_receive_bitrate_p5_kbps, "kbps", false);
+  test::PrintResult("available_outgoing_bitrate", "", trace,
+                    summary.available_outgoing_bitrate_kbps, "kbps", false);
+  test::PrintResult("packet_loss", "", trace, summary.loss_percent, "%",
+                    true);
+  test::PrintResult("nacks_sent", "", trace, summary.nacks_sent, "nacks",
+                    false);
+  test::PrintResult("plis_sent", "", trace, summary.plis_sent, "plis", false);
+  test::PrintResult("firs_sent", "", trace, summary.firs_sent, "firs", false);
+  test::PrintResult("frames_decoded", "", trace, summary.frames_decoded,
+                    "frames", false);
+  test::PrintResult("frames_dropped", "", trace, summary.frames_dropped,
+                    "frames", true);
+  test::PrintResult("concealed_audio", "", trace,
+                    summary.concealed_audio_percent, "%", true);
+  test::PrintResult("rtt_p50", "", trace, summary.rtt_p50_ms, "ms", false);
+  test::PrintResult("rtt_p95", "", trace, summary.rtt_p95_ms, "ms", true);
+  test::PrintResult("rtt_p99", "", trace, summary.rtt_p99_ms, "ms", false);
+  test::PrintResult("video_jitter_p50", "", trace, summary.video_jitter_p50_ms,
+                    "ms", false);
+  test::PrintResult("video_jitter_p95", "", trace, summary.video_jitter_p95_ms,
+                    "ms", true);
+}
+
+MediaPerfStats::Totals MediaPerfStats::GetTotals(const RTCStatsReport& report) {
+  Totals totals;
+  totals.timestamp_us = report.timestamp_us();
+  for (const RTCOutboundRTPStreamStats* outbound :
+       report.GetStatsOfType<RTCOutboundRTPStreamStats>()) {
+    if (IsKind(outbound->media_type, RTCMediaStreamTrackKind::kVideo))
+      totals.video_bytes_sent += ValueOrZero(outbound->bytes_sent);
+    else if (IsKind(outbound->media_type, RTCMediaStreamTrackKind::kAudio))
+      totals.audio_bytes_sent += ValueOrZero(outbound->bytes_sent);
+  }
+  for (const RTCInboundRTPStreamStats* inbound :
+       report.GetStatsOfType<RTCInboundRTPStreamStats>()) {
+    if (IsKind(inbound->media_type, RTCMediaStreamTrackKind::kVideo))
+      totals.video_bytes_received += ValueOrZero(inbound->bytes_received);
+    else if (IsKind(inbound->media_type, RTCMediaStreamTrackKind::kAudio))
+      totals.audio_bytes_received += ValueOrZero(inbound->bytes_received);
+    totals.packets_received += ValueOrZero(inbound->packets_received);
+    totals.packets_lost += ValueOrZero(inbound->packets_lost);
+    totals.nacks_sent += ValueOrZero(inbound->nack_count);
+    totals.plis_sent += ValueOrZero(inbound->pli_count);
+    totals.firs_sent += ValueOrZero(inbound->fir_count);
+  }
+  for (const RTCMediaStreamTrackStats* track :
+       report.GetStatsOfType<RTCMediaStreamTrackStats>()) {
+    if (!track->remote_source.is_defined() || !*track->remote_source)
+      continue;
+    if (IsKind(track->kind, RTCMediaStreamTrackKind::kVideo)) {
+      totals.frames_decoded += ValueOrZero(track->frames_decoded);
+      totals.frames_dropped += ValueOrZero(track->frames_dropped);
+    } else if (IsKind(track->kind, RTCMediaStreamTrackKind::kAudio)) {
+      totals.audio_samples_received +=
+          ValueOrZero(track->total_samples_received);
+      totals.audio_samples_concealed += ValueOrZero(track->concealed_samples);
+    }
+  }
+  return totals;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_NETWORK_TESTER_MEDIA_PERF_STATS_H_
+#define RTC_TOOLS_NETWORK_TESTER_MEDIA_PERF_STATS_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/stats/rtcstatsreport.h"
+
+namespace webrtc {
+
+// Summarizes the RTCStatsReports sampled during a call of a MediaPerfSession:
+// the achieved bitrates, the losses and how they were recovered, and the
+// latency percentiles.
+class MediaPerfStats {
+ public:
+  struct Summary {
+    double duration_s = 0.0;
+    // Mean RTP bitrates, of all streams of a kind.
+    double video_send_bitrate_kbps = 0.0;
+    double audio_send_bitrate_kbps = 0.0;
+    double video_receive_bitrate_kbps = 0.0;
+    double audio_receive_bitrate_kbps = 0.0;
+    // The video receive bitrate of the 5% worst sampling intervals; how far
+    // it dropped on congestion.
+    double video_receive_bitrate_p5_kbps = 0.0;
+    // Mean bandwidth estimate.
+    double available_outgoing_bitrate_kbps = 0.0;
+    // Losses of the received streams, and the requests sent to recover from
+    // them.
+    int64_t packets_received = 0;
+    int64_t packets_lost = 0;
+    double loss_percent = 0.0;
+    int64_t nacks_sent = 0;
+    int64_t plis_sent = 0;
+    int64_t firs_sent = 0;
+    int64_t frames_decoded = 0;
+    int64_t frames_dropped = 0;
+    double concealed_audio_percent = 0.0;
+    // Percentiles of the sampled round trip time and video jitter.
+    double rtt_p50_ms = 0.0;
+    double rtt_p95_ms = 0.0;
+    double rtt_p99_ms = 0.0;
+    double video_jitter_p50_ms = 0.0;
+    double video_jitter_p95_ms = 0.0;
+  };
+
+  MediaPerfStats();
+  ~MediaPerfStats();
+
+  // Reports must be added in the order of their timestamps. The counters of
+  // the first report are the baseline that the summary is relative to.
+  void AddReport(const RTCStatsReport& report);
+  size_t num_reports() const { return num_reports_; }
+
+  Summary GetSummary() const;
+
+  // Prints |summary| with test::PrintResult(), under |trace|.
+  static void PrintSummary(const Summary& summary, const std::string& trace);
+
+ private:
+  // Counters of a report, summed up over the streams.
+  struct Totals {
+    int64_t timestamp_us = 0;
+    uint64_t video_bytes_sent = 0;
+    uint64_t audio_bytes_sent = 0;
+    uint64_t video_bytes_received = 0;
+    uint64_t audio_bytes_received = 0;
+    int64_t packets_received = 0;
+    int64_t packets_lost = 0;
+    int64_t nacks_sent = 0;
+    int64_t plis_sent = 0;
+    int64_t firs_sent = 0;
+    int64_t frames_decoded = 0;
+    int64_t frames_dropped = 0;
+    uint64_t audio_samples_received = 0;
+    uint64_t audio_samples_concealed = 0;
+  };
+
+  static Totals GetTotals(const RTCStatsReport& report);
+
+  size_t num_reports_ = 0;
+  absl::optional<Totals> first_;
+  Totals last_;
+  std::vector<double> video_receive_bitrates_kbps_;
+  std::vector<double> available_outgoing_bitrates_kbps_;
+  std::vector<double> rtts_ms_;
+  std::vector<double> video_jitters_ms_;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_NETWORK_TESTER_MEDIA_PERF_STATS_H_
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/network_tester/media_perf_stats.h"
+
+#include "absl/memory/memory.h"
+#include "api/stats/rtcstats_objects.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// A report |time_s| into a call in which video is sent and received at
+// |video_kbps|, audio at 32 kbps, and 1% of the received packets are lost.
+rtc::scoped_refptr<RTCStatsReport> CreateReport(int64_t time_s,
+                                                int video_kbps,
+                                                double rtt_ms) {
+  const int64_t timestamp_us = time_s * rtc::kNumMicrosecsPerSec;
+  rtc::scoped_refptr<RTCStatsReport> report =
+      RTCStatsReport::Create(timestamp_us);
+
+  auto video_out =
+      absl::make_unique<RTCOutboundRTPStreamStats>("video_out", timestamp_us);
+  video_out->media_type = RTCMediaStreamTrackKind::kVideo;
+  video_out->bytes_sent = static_cast<uint64_t>(time_s * video_kbps * 125);
+  report->AddStats(std::move(video_out));
+  auto audio_out =
+      absl::make_unique<RTCOutboundRTPStreamStats>("audio_out", timestamp_us);
+  audio_out->media_type = RTCMediaStreamTrackKind::kAudio;
+  audio_out->bytes_sent = static_cast<uint64_t>(time_s * 32 * 125);
+  report->AddStats(std::move(audio_out));
+
+  auto video_in =
+      absl::make_unique<RTCInboundRTPStreamStats>("video_in", timestamp_us);
+  video_in->media_type = RTCMediaStreamTrackKind::kVideo;
+  video_in->bytes_received = static_cast<uint64_t>(time_s * video_kbps * 125);
+  video_in->packets_received = static_cast<uint32_t>(time_s * 99);
+  video_in->packets_lost = static_cast<int32_t>(time_s);
+  video_in->nack_count = static_cast<uint32_t>(time_s);
+  video_in->pli_count = 0;
+  video_in->fir_count = 0;
+  video_in->jitter = 0.005;
+  report->AddStats(std::move(video_in));
+
+  auto track = absl::make_unique<RTCMediaStreamTrackStats>(
+      "video_track", timestamp_us, RTCMediaStreamTrackKind::kVideo);
+  track->remote_source = true;
+  track->frames_decoded = static_cast<uint32_t>(time_s * 30);
+  track->frames_dropped = 0;
+  report->AddStats(std::move(track));
+
+  auto pair = absl::make_unique<RTCIceCandidatePairStats>("pair", timestamp_us);
+  pair->current_round_trip_time = rtt_ms / 1000;
+  pair->available_outgoing_bitrate = 2000000;
+  report->AddStats(std::move(pair));
+  auto transport =
+      absl::make_unique<RTCTransportStats>("transport", timestamp_us);
+  transport->selected_candidate_pair_id = "pair";
+  report->AddStats(std::move(transport));
+  return report;
+}
+
+}  // namespace
+
+TEST(MediaPerfStatsTest, EmptyWithoutReports) {
+  MediaPerfStats stats;
+  EXPECT_EQ(0.0, stats.GetSummary().duration_s);
+  EXPECT_EQ(0.0, stats.GetSummary().video_receive_bitrate_kbps);
+}
+
+TEST(MediaPerfStatsTest, SummarizesRelativeToFirstReport) {
+  MediaPerfStats stats;
+  // The counters of the first report, e.g. from the warm-up, don't count.
+  for (int64_t time_s = 10; time_s <= 20; ++time_s)
+    stats.AddReport(*CreateReport(time_s, 1000, 50 + time_s));
+  const MediaPerfStats::Summary summary = stats.GetSummary();
+
+  EXPECT_EQ(10.0, summary.duration_s);
+  EXPECT_DOUBLE_EQ(1000.0, summary.video_send_bitrate_kbps);
+  EXPECT_DOUBLE_EQ(32.0, summary.audio_send_bitrate_kbps);
+  EXPECT_DOUBLE_EQ(1000.0, summary.video_receive_bitrate_kbps);
+  EXPECT_DOUBLE_EQ(0.0, summary.audio_receive_bitrate_kbps);
+  EXPECT_DOUBLE_EQ(2000.0, summary.available_outgoing_bitrate_kbps);
+  EXPECT_EQ(990, summary.packets_received);
+  EXPECT_EQ(10, summary.packets_lost);
+  EXPECT_DOUBLE_EQ(1.0, summary.loss_percent);
+  EXPECT_EQ(10, summary.nacks_sent);
+  EXPECT_EQ(300, summary.frames_decoded);
+  EXPECT_DOUBLE_EQ(5.0, summary.video_jitter_p95_ms);
+}
+
+TEST(MediaPerfStatsTest, ComputesPercentiles) {
+  MediaPerfStats stats;
+  // 100 samples of 1 to 100 ms.
+  for (int i = 1; i <= 100; ++i)
+    stats.AddReport(*CreateReport(i, i < 10 ? 100 : 1000, i));
+  const MediaPerfStats::Summary summary = stats.GetSummary();
+
+  EXPECT_DOUBLE_EQ(50.0, summary.rtt_p50_ms);
+  EXPECT_DOUBLE_EQ(95.0, summary.rtt_p95_ms);
+  EXPECT_DOUBLE_EQ(99.0, summary.rtt_p99_ms);
+  // 8 of the 99 intervals had a low bitrate.
+  EXPECT_NEAR(100.0, summary.video_receive_bitrate_p5_kbps, 1e-6);
+}
+
+}  // namespace webrtc
@@ -8,73 +8,44 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-#include <map>
 #include <string>
 #include <vector>
 
-#include "rtc_tools/frame_analyzer/video_quality_analysis.h"
+#include "rtc_tools/frame_analyzer/parallel_video_analysis.h"
 #include "rtc_tools/simple_command_line_parser.h"
 
-#define MAX_NUM_FRAMES_PER_FILE INT_MAX
-
 void CompareFiles(const char* reference_file_name,
                   const char* test_file_name,
                   const char* results_file_name,
                   int width,
-                  int height) {
-  // Check if the reference_file_name ends with "y4m".
-  bool y4m_mode = false;
-  if (std::string(reference_file_name).find("y4m") != std::string::npos) {
-    y4m_mode = true;
+                  int height,
+                  size_t num_threads) {
+  std::vector<webrtc::test::FrameQuality> results;
+  if (!webrtc::test::AnalyzeVideoFilesInParallel(
+          reference_file_name, test_file_name, width, height, num_threads,
+          std::vector<webrtc::test::FrameQualityMetric*>(), &results)) {
+    return;
   }
 
   FILE* results_file = fopen(results_file_name, "w");
-
-  int size = webrtc::test::GetI420FrameSize(width, height);
-
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* ref_frame = new uint8_t[size];
-
-  bool read_result = true;
-  for (int frame_counter = 0; frame_counter < MAX_NUM_FRAMES_PER_FILE;
-       ++frame_counter) {
-    read_result &=
-        (y4m_mode)
-            ? webrtc::test::ExtractFrameFromY4mFile(
-                  reference_file_name, width, height, frame_counter, ref_frame)
-            : webrtc::test::ExtractFrameFromYuvFile(
-                  reference_file_name, width, height, frame_counter, ref_frame);
-    read_result &= webrtc::test::ExtractFrameFromYuvFile(
-        test_file_name, width, height, frame_counter, test_frame);
-
-    if (!read_result)
-      break;
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr = webrtc::test::CalculateMetrics(
-        webrtc::test::kPSNR, ref_frame, test_frame, width, height);
-    double result_ssim = webrtc::test::CalculateMetrics(
-        webrtc::test::kSSIM, ref_frame, test_frame, width, height);
-    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n", frame_counter,
-            result_psnr, result_ssim);
+  for (const webrtc::test::FrameQuality& result : results) {
+    fprintf(results_file, "Frame: %d, PSNR: %f, SSIM: %f\n",
+            result.frame_number, result.psnr, result.ssim);
   }
-  delete[] test_frame;
-  delete[] ref_frame;
-
   fclose(results_file);
 }
 
 /*
  * A tool running PSNR and SSIM analysis on two videos - a reference video and a
- * test video. The two videos should be I420 YUV videos.
+ * test video. The two videos should be I420 YUV or Y4M videos.
  * The tool just runs PSNR and SSIM on the corresponding frames in the test and
  * the reference videos until either the first or the second video runs out of
- * frames. The result is written in a results text file in the format:
+ * frames. Frames are analyzed in parallel, on one thread per core unless
+ * --num_threads says otherwise. The result is written in a results text file
+ * in the format:
  * Frame: <frame_number>, PSNR: <psnr_value>, SSIM: <ssim_value>
  * Frame: <frame_number>, ........
  *
@@ -83,7 +54,7 @@ void CompareFiles(const char* reference_file_name,
  * Usage:
  * psnr_ssim_analyzer --reference_file=<name_of_file> --test_file=<name_of_file>
  * --results_file=<name_of_file> --width=<width_of_frames>
- * --height=<height_of_frames>
+ * --height=<height_of_frames> [--num_threads=<number_of_threads>]
  */
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
@@ -104,7 +75,9 @@ int main(int argc, char* argv[]) {
       "  - test_file(string): The test YUV file to run the analysis for."
       " Default: test_file.yuv\n"
       "  - results_file(string): The full name of the file where the results "
-      "will be written. Default: results.txt\n";
+      "will be written. Default: results.txt\n"
+      "  - num_threads(int): The number of frames analyzed in parallel, or 0 "
+      "for one per core. Default: 0\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -118,6 +91,7 @@ int main(int argc, char* argv[]) {
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
   parser.SetFlag("results_file", "results.txt");
+  parser.SetFlag("num_threads", "0");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -134,9 +108,15 @@ int main(int argc, char* argv[]) {
     fprintf(stderr, "Error: width or height cannot be <= 0!\n");
     return -1;
   }
+  int num_threads = strtol((parser.GetFlag("num_threads")).c_str(), NULL, 10);
+  if (num_threads < 0) {
+    fprintf(stderr, "Error: num_threads cannot be < 0!\n");
+    return -1;
+  }
 
   CompareFiles(parser.GetFlag("reference_file").c_str(),
                parser.GetFlag("test_file").c_str(),
-               parser.GetFlag("results_file").c_str(), width, height);
+               parser.GetFlag("results_file").c_str(), width, height,
+               num_threads);
   return 0;
 }
@@ -54,6 +54,12 @@ namespace jni {
 
 enum { kMaxWarningLogFrames = 2 };
 
+// MediaCodecVideoDecoder is a VideoDecoder implementation that delegates to
+// org.webrtc.MediaCodecVideoDecoder. It runs on its own codec thread, which
+// polls the decoded output every kMediaCodecPollMs. With |use_surface|, frames
+// are decoded into a SurfaceTexture and delivered as texture buffers, without
+// reading them back to the CPU. New code should use HardwareVideoDecoder,
+// which blocks on a dedicated output thread instead of polling.
 class MediaCodecVideoDecoder : public VideoDecoder, public rtc::MessageHandler {
  public:
   explicit MediaCodecVideoDecoder(JNIEnv* jni,
@@ -88,6 +88,12 @@ __android_log_print(ANDROID_LOG_VERBOSE, TAG_ENCODER, __VA_ARGS__)
 // delegating all of the interesting work to org.webrtc.MediaCodecVideoEncoder.
 // MediaCodecVideoEncoder must be operated on a single task queue, currently
 // this is the encoder queue from ViE encoder.
+//
+// The encoded output is polled from the encoder queue, every
+// kMediaCodecPollMs while frames are in flight, and is handed on in place,
+// wrapping the direct ByteBuffer of MediaCodec without a copy. New code should
+// use HardwareVideoEncoder, which blocks on a dedicated output thread instead
+// of polling.
 class MediaCodecVideoEncoder : public VideoEncoder {
  public:
   ~MediaCodecVideoEncoder() override;
@@ -187,6 +187,17 @@ rtc::scoped_refptr<I420BufferInterface> AndroidVideoBuffer::ToI420() {
   return AndroidVideoI420Buffer::Adopt(jni, width_, height_, j_i420_buffer);
 }
 
+rtc::scoped_refptr<VideoFrameBuffer> AndroidVideoBuffer::CropAndScaleNative(
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) {
+  return CropAndScale(AttachCurrentThreadIfNeeded(), offset_x, offset_y,
+                      crop_width, crop_height, scaled_width, scaled_height);
+}
+
 VideoFrame JavaToNativeFrame(JNIEnv* jni,
                              const JavaRef<jobject>& j_video_frame,
                              uint32_t timestamp_rtp) {
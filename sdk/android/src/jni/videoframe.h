@@ -61,6 +61,14 @@ class AndroidVideoBuffer : public VideoFrameBuffer {
   int height() const override;
 
   rtc::scoped_refptr<I420BufferInterface> ToI420() override;
+  // Crops and scales the Java buffer, e.g. a texture on the GPU.
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScaleNative(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override;
 
   const int width_;
   const int height_;
@@ -279,6 +279,8 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   std::unique_ptr<webrtc::BitrateAdjuster> _bitrateAdjuster;
   uint32_t _targetBitrateBps;
   uint32_t _encoderBitrateBps;
+  uint32_t _encoderFramerate;
+  uint32_t _maxFramerate;
   RTCH264PacketizationMode _packetizationMode;
   CFStringRef _profile;
   RTCVideoEncoderCallback _callback;
@@ -327,6 +329,7 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   _width = settings.width;
   _height = settings.height;
   _mode = settings.mode;
+  _maxFramerate = settings.maxFramerate;
 
   // We can only set average bitrate on the HW encoder.
   _targetBitrateBps = settings.startBitrate * 1000;  // startBitrate is in kbps.
@@ -379,15 +382,17 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
       }
       int dstWidth = CVPixelBufferGetWidth(pixelBuffer);
       int dstHeight = CVPixelBufferGetHeight(pixelBuffer);
+      // Keep the temporary buffer between frames; at 4K it is several megabytes.
+      uint8_t *frameScaleBuffer = nullptr;
       if ([rtcPixelBuffer requiresScalingToWidth:dstWidth height:dstHeight]) {
-        int size =
+        size_t size =
             [rtcPixelBuffer bufferSizeForCroppingAndScalingToWidth:dstWidth height:dstHeight];
-        _frameScaleBuffer.resize(size);
-      } else {
-        _frameScaleBuffer.clear();
+        if (_frameScaleBuffer.size() < size) {
+          _frameScaleBuffer.resize(size);
+        }
+        frameScaleBuffer = _frameScaleBuffer.data();
       }
-      _frameScaleBuffer.shrink_to_fit();
-      if (![rtcPixelBuffer cropAndScaleTo:pixelBuffer withTempBuffer:_frameScaleBuffer.data()]) {
+      if (![rtcPixelBuffer cropAndScaleTo:pixelBuffer withTempBuffer:frameScaleBuffer]) {
         CVBufferRelease(pixelBuffer);
         return WEBRTC_VIDEO_CODEC_ERROR;
       }
@@ -474,6 +479,7 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   _targetBitrateBps = 1000 * bitrateKbit;
   _bitrateAdjuster->SetTargetBitrateBps(_targetBitrateBps);
   [self setBitrateBps:_bitrateAdjuster->GetAdjustedBitrateBps()];
+  [self setEncoderFramerate:framerate];
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -622,6 +628,8 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   SetVTSessionProperty(_compressionSession, kVTCompressionPropertyKey_ProfileLevel, _profile);
   SetVTSessionProperty(_compressionSession, kVTCompressionPropertyKey_AllowFrameReordering, false);
   [self setEncoderBitrateBps:_targetBitrateBps];
+  _encoderFramerate = 0;
+  [self setEncoderFramerate:_maxFramerate];
   // TODO(tkchin): Look at entropy mode and colorspace matrices.
   // TODO(tkchin): Investigate to see if there's any way to make this work.
   // May need it to interop with Android. Currently this call just fails.
@@ -688,6 +696,17 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   }
 }
 
+// The expected frame rate lets VideoToolbox provision the hardware encoder
+// for the throughput of high resolution, high frame rate streams such as 4K
+// screen sharing, instead of adapting to the rate of incoming frames.
+- (void)setEncoderFramerate:(uint32_t)framerate {
+  if (_compressionSession && framerate > 0 && framerate != _encoderFramerate) {
+    SetVTSessionProperty(
+        _compressionSession, kVTCompressionPropertyKey_ExpectedFrameRate, framerate);
+    _encoderFramerate = framerate;
+  }
+}
+
 - (void)frameWasEncoded:(OSStatus)status
                   flags:(VTEncodeInfoFlags)infoFlags
            sampleBuffer:(CMSampleBufferRef)sampleBuffer
@@ -10,9 +10,12 @@
 
 #include "api/stats/rtcstats.h"
 
+#include <string.h>
+
 #include <iomanip>
 #include <sstream>
 
+#include "rtc_base/byteorder.h"
 #include "rtc_base/stringencode.h"
 
 namespace webrtc {
@@ -72,6 +75,124 @@ std::string VectorToStringAsDouble(const std::vector<T>& vector) {
   return oss.str();
 }
 
+// Writers for |RTCStats::ToBinary|.
+void WriteVarint(uint64_t value, rtc::Buffer* buffer) {
+  buffer->AppendData(10, [value](rtc::ArrayView<uint8_t> bytes) mutable {
+    size_t size = 0;
+    while (value >= 0x80) {
+      bytes[size++] = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    bytes[size++] = static_cast<uint8_t>(value);
+    return size;
+  });
+}
+
+void WriteFixed64(uint64_t value, rtc::Buffer* buffer) {
+  buffer->AppendData(8, [value](rtc::ArrayView<uint8_t> bytes) {
+    rtc::SetLE64(bytes.data(), value);
+    return bytes.size();
+  });
+}
+
+void WriteValue(bool value, rtc::Buffer* buffer) {
+  buffer->AppendData(static_cast<uint8_t>(value ? 1 : 0));
+}
+
+void WriteValue(uint32_t value, rtc::Buffer* buffer) {
+  WriteVarint(value, buffer);
+}
+
+void WriteValue(uint64_t value, rtc::Buffer* buffer) {
+  WriteVarint(value, buffer);
+}
+
+void WriteValue(int64_t value, rtc::Buffer* buffer) {
+  // Zigzag encoding, so that small negative values are short too.
+  uint64_t bits = static_cast<uint64_t>(value);
+  WriteVarint((bits << 1) ^ (value < 0 ? ~uint64_t{0} : 0), buffer);
+}
+
+void WriteValue(int32_t value, rtc::Buffer* buffer) {
+  WriteValue(static_cast<int64_t>(value), buffer);
+}
+
+void WriteValue(double value, rtc::Buffer* buffer) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(value), "");
+  memcpy(&bits, &value, sizeof(bits));
+  WriteFixed64(bits, buffer);
+}
+
+void WriteString(const char* data, size_t size, rtc::Buffer* buffer) {
+  WriteVarint(size, buffer);
+  buffer->AppendData(reinterpret_cast<const uint8_t*>(data), size);
+}
+
+void WriteValue(const std::string& value, rtc::Buffer* buffer) {
+  WriteString(value.data(), value.size(), buffer);
+}
+
+template <typename T>
+void WriteValue(const std::vector<T>& values, rtc::Buffer* buffer) {
+  WriteVarint(values.size(), buffer);
+  for (const T& value : values)
+    WriteValue(static_cast<T>(value), buffer);
+}
+
+template <typename T>
+void WriteMemberValue(const RTCStatsMemberInterface& member,
+                      rtc::Buffer* buffer) {
+  WriteValue(*member.cast_to<RTCStatsMember<T>>(), buffer);
+}
+
+void WriteMember(const RTCStatsMemberInterface& member, rtc::Buffer* buffer) {
+  switch (member.type()) {
+    case RTCStatsMemberInterface::kBool:
+      WriteMemberValue<bool>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kInt32:
+      WriteMemberValue<int32_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kUint32:
+      WriteMemberValue<uint32_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kInt64:
+      WriteMemberValue<int64_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kUint64:
+      WriteMemberValue<uint64_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kDouble:
+      WriteMemberValue<double>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kString:
+      WriteMemberValue<std::string>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceBool:
+      WriteMemberValue<std::vector<bool>>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceInt32:
+      WriteMemberValue<std::vector<int32_t>>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceUint32:
+      WriteMemberValue<std::vector<uint32_t>>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceInt64:
+      WriteMemberValue<std::vector<int64_t>>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceUint64:
+      WriteMemberValue<std::vector<uint64_t>>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceDouble:
+      WriteMemberValue<std::vector<double>>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceString:
+      WriteMemberValue<std::vector<std::string>>(member, buffer);
+      break;
+  }
+}
+
 }  // namespace
 
 bool RTCStats::operator==(const RTCStats& other) const {
@@ -113,6 +234,25 @@ std::string RTCStats::ToJson() const {
   return oss.str();
 }
 
+void RTCStats::ToBinary(rtc::Buffer* buffer) const {
+  WriteString(type(), strlen(type()), buffer);
+  WriteValue(id_, buffer);
+  WriteFixed64(static_cast<uint64_t>(timestamp_us_), buffer);
+  std::vector<const RTCStatsMemberInterface*> members = Members();
+  size_t num_defined = 0;
+  for (const RTCStatsMemberInterface* member : members) {
+    if (member->is_defined())
+      ++num_defined;
+  }
+  WriteVarint(num_defined, buffer);
+  for (size_t i = 0; i < members.size(); ++i) {
+    if (members[i]->is_defined()) {
+      WriteVarint(i, buffer);
+      WriteMember(*members[i], buffer);
+    }
+  }
+}
+
 std::vector<const RTCStatsMemberInterface*> RTCStats::Members() const {
   return MembersOfThisObjectAndAncestors(0);
 }
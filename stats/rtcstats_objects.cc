@@ -446,7 +446,9 @@ RTCMediaStreamTrackStats::~RTCMediaStreamTrackStats() {}
 // clang-format off
 WEBRTC_RTCSTATS_IMPL(RTCPeerConnectionStats, RTCStats, "peer-connection",
     &data_channels_opened,
-    &data_channels_closed);
+    &data_channels_closed,
+    &video_memory_bytes,
+    &video_memory_peak_bytes);
 // clang-format on
 
 RTCPeerConnectionStats::RTCPeerConnectionStats(const std::string& id,
@@ -457,13 +459,17 @@ RTCPeerConnectionStats::RTCPeerConnectionStats(std::string&& id,
                                                int64_t timestamp_us)
     : RTCStats(std::move(id), timestamp_us),
       data_channels_opened("dataChannelsOpened"),
-      data_channels_closed("dataChannelsClosed") {}
+      data_channels_closed("dataChannelsClosed"),
+      video_memory_bytes("videoMemoryBytes"),
+      video_memory_peak_bytes("videoMemoryPeakBytes") {}
 
 RTCPeerConnectionStats::RTCPeerConnectionStats(
     const RTCPeerConnectionStats& other)
     : RTCStats(other.id(), other.timestamp_us()),
       data_channels_opened(other.data_channels_opened),
-      data_channels_closed(other.data_channels_closed) {}
+      data_channels_closed(other.data_channels_closed),
+      video_memory_bytes(other.video_memory_bytes),
+      video_memory_peak_bytes(other.video_memory_peak_bytes) {}
 
 RTCPeerConnectionStats::~RTCPeerConnectionStats() {}
 
@@ -538,7 +544,11 @@ WEBRTC_RTCSTATS_IMPL(
     &burst_discard_rate,
     &gap_loss_rate,
     &gap_discard_rate,
-    &frames_decoded);
+    &frames_decoded,
+    &frame_latency_stages,
+    &frame_latency_p50,
+    &frame_latency_p95,
+    &frame_latency_p99);
 // clang-format on
 
 RTCInboundRTPStreamStats::RTCInboundRTPStreamStats(const std::string& id,
@@ -564,7 +574,11 @@ RTCInboundRTPStreamStats::RTCInboundRTPStreamStats(std::string&& id,
       burst_discard_rate("burstDiscardRate"),
       gap_loss_rate("gapLossRate"),
       gap_discard_rate("gapDiscardRate"),
-      frames_decoded("framesDecoded") {}
+      frames_decoded("framesDecoded"),
+      frame_latency_stages("frameLatencyStages"),
+      frame_latency_p50("frameLatencyP50"),
+      frame_latency_p95("frameLatencyP95"),
+      frame_latency_p99("frameLatencyP99") {}
 
 RTCInboundRTPStreamStats::RTCInboundRTPStreamStats(
     const RTCInboundRTPStreamStats& other)
@@ -585,7 +599,11 @@ RTCInboundRTPStreamStats::RTCInboundRTPStreamStats(
       burst_discard_rate(other.burst_discard_rate),
       gap_loss_rate(other.gap_loss_rate),
       gap_discard_rate(other.gap_discard_rate),
-      frames_decoded(other.frames_decoded) {}
+      frames_decoded(other.frames_decoded),
+      frame_latency_stages(other.frame_latency_stages),
+      frame_latency_p50(other.frame_latency_p50),
+      frame_latency_p95(other.frame_latency_p95),
+      frame_latency_p99(other.frame_latency_p99) {}
 
 RTCInboundRTPStreamStats::~RTCInboundRTPStreamStats() {}
 
@@ -628,7 +646,8 @@ WEBRTC_RTCSTATS_IMPL(RTCTransportStats, RTCStats, "transport",
     &dtls_state,
     &selected_candidate_pair_id,
     &local_certificate_id,
-    &remote_certificate_id);
+    &remote_certificate_id,
+    &srtp_cipher);
 // clang-format on
 
 RTCTransportStats::RTCTransportStats(const std::string& id,
@@ -643,7 +662,8 @@ RTCTransportStats::RTCTransportStats(std::string&& id, int64_t timestamp_us)
       dtls_state("dtlsState"),
       selected_candidate_pair_id("selectedCandidatePairId"),
       local_certificate_id("localCertificateId"),
-      remote_certificate_id("remoteCertificateId") {}
+      remote_certificate_id("remoteCertificateId"),
+      srtp_cipher("srtpCipher") {}
 
 RTCTransportStats::RTCTransportStats(const RTCTransportStats& other)
     : RTCStats(other.id(), other.timestamp_us()),
@@ -653,7 +673,8 @@ RTCTransportStats::RTCTransportStats(const RTCTransportStats& other)
       dtls_state(other.dtls_state),
       selected_candidate_pair_id(other.selected_candidate_pair_id),
       local_certificate_id(other.local_certificate_id),
-      remote_certificate_id(other.remote_certificate_id) {}
+      remote_certificate_id(other.remote_certificate_id),
+      srtp_cipher(other.srtp_cipher) {}
 
 RTCTransportStats::~RTCTransportStats() {}
 
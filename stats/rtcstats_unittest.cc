@@ -330,6 +330,45 @@ TEST(RTCStatsTest, RTCStatsPrintsValidJson) {
   std::cout << stats.ToJson() << std::endl;
 }
 
+TEST(RTCStatsTest, ToBinaryWritesDefinedMembersByIndex) {
+  RTCGrandChildStats stats("g", 0x0102);
+  stats.grandchild_int = -2;
+  rtc::Buffer buffer;
+  stats.ToBinary(&buffer);
+
+  const uint8_t kType[] = "grandchild-stats";
+  rtc::Buffer expected;
+  expected.AppendData(static_cast<uint8_t>(sizeof(kType) - 1));
+  expected.AppendData(kType, sizeof(kType) - 1);
+  // The ID, the timestamp, one defined member, and the zigzag encoded value
+  // of the second member.
+  const uint8_t kRest[] = {1, 'g', 0x02, 0x01, 0, 0, 0, 0, 0, 0, 1, 1, 3};
+  expected.AppendData(kRest);
+  EXPECT_EQ(expected, buffer);
+
+  // Appends, so that a buffer can be reused.
+  stats.ToBinary(&buffer);
+  EXPECT_EQ(2 * expected.size(), buffer.size());
+}
+
+TEST(RTCStatsTest, ToBinaryWritesSequencesAndStrings) {
+  RTCTestStats stats("t", 0);
+  stats.m_string = "xyz";
+  stats.m_sequence_uint32 = std::vector<uint32_t>{300};
+  stats.m_sequence_string = std::vector<std::string>{"ab", ""};
+  rtc::Buffer buffer;
+  stats.ToBinary(&buffer);
+
+  // Three defined members, each written as its index in the member list, then
+  // its value.
+  const uint8_t kMembers[] = {3, 6,  3, 'x', 'y', 'z', 9, 1, 0xAC,
+                              2, 13, 2, 2,   'a', 'b', 0};
+  ASSERT_GE(buffer.size(), sizeof(kMembers));
+  EXPECT_EQ(rtc::Buffer(kMembers),
+            rtc::Buffer(buffer.data() + buffer.size() - sizeof(kMembers),
+                        sizeof(kMembers)));
+}
+
 TEST(RTCStatsTest, IsStandardized) {
   RTCStatsMember<int32_t> standardized("standardized");
   RTCNonStandardStatsMember<int32_t> unstandardized("unstandardized");
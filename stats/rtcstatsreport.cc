@@ -12,6 +12,8 @@
 
 #include <sstream>
 
+#include "rtc_base/byteorder.h"
+
 namespace webrtc {
 
 RTCStatsReport::ConstIterator::ConstIterator(
@@ -104,6 +106,32 @@ void RTCStatsReport::TakeMembersFrom(
   victim->stats_.clear();
 }
 
+void RTCStatsReport::GetDelta(const RTCStatsReport& previous,
+                              std::vector<const RTCStats*>* changed,
+                              std::vector<const RTCStats*>* removed) const {
+  // Both maps are ordered on ID, so they are merged in a single pass instead
+  // of looking up each ID in the other report.
+  StatsMap::const_iterator it = stats_.begin();
+  StatsMap::const_iterator previous_it = previous.stats_.begin();
+  while (it != stats_.end() || previous_it != previous.stats_.end()) {
+    if (previous_it == previous.stats_.end() ||
+        (it != stats_.end() && it->first < previous_it->first)) {
+      if (changed)
+        changed->push_back(it->second.get());
+      ++it;
+    } else if (it == stats_.end() || previous_it->first < it->first) {
+      if (removed)
+        removed->push_back(previous_it->second.get());
+      ++previous_it;
+    } else {
+      if (changed && *it->second != *previous_it->second)
+        changed->push_back(it->second.get());
+      ++it;
+      ++previous_it;
+    }
+  }
+}
+
 RTCStatsReport::ConstIterator RTCStatsReport::begin() const {
   return ConstIterator(rtc::scoped_refptr<const RTCStatsReport>(this),
                        stats_.cbegin());
@@ -127,4 +155,17 @@ std::string RTCStatsReport::ToJson() const {
   return oss.str();
 }
 
+void RTCStatsReport::ToBinary(rtc::Buffer* buffer) const {
+  buffer->AppendData(8, [this](rtc::ArrayView<uint8_t> bytes) {
+    rtc::SetLE64(bytes.data(), static_cast<uint64_t>(timestamp_us_));
+    return bytes.size();
+  });
+  buffer->AppendData(4, [this](rtc::ArrayView<uint8_t> bytes) {
+    rtc::SetLE32(bytes.data(), static_cast<uint32_t>(stats_.size()));
+    return bytes.size();
+  });
+  for (const auto& stats : stats_)
+    stats.second->ToBinary(buffer);
+}
+
 }  // namespace webrtc
@@ -139,4 +139,51 @@ TEST(RTCStatsReport, TakeMembersFrom) {
   EXPECT_EQ(i, static_cast<int64_t>(6));
 }
 
+TEST(RTCStatsReport, GetDelta) {
+  rtc::scoped_refptr<RTCStatsReport> previous = RTCStatsReport::Create(1);
+  std::unique_ptr<RTCTestStats1> unchanged(new RTCTestStats1("a", 1));
+  unchanged->integer = 1;
+  previous->AddStats(unchanged->copy());
+  std::unique_ptr<RTCTestStats1> changed(new RTCTestStats1("b", 1));
+  changed->integer = 2;
+  previous->AddStats(changed->copy());
+  previous->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats2("c", 1)));
+
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(2);
+  std::unique_ptr<RTCTestStats1> later_unchanged(new RTCTestStats1("a", 2));
+  later_unchanged->integer = 1;
+  report->AddStats(std::move(later_unchanged));
+  changed->integer = 3;
+  report->AddStats(std::move(changed));
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats3("d", 2)));
+
+  std::vector<const RTCStats*> changed_stats;
+  std::vector<const RTCStats*> removed_stats;
+  report->GetDelta(*previous, &changed_stats, &removed_stats);
+  ASSERT_EQ(2u, changed_stats.size());
+  EXPECT_EQ(report->Get("b"), changed_stats[0]);
+  EXPECT_EQ(report->Get("d"), changed_stats[1]);
+  ASSERT_EQ(1u, removed_stats.size());
+  EXPECT_EQ(previous->Get("c"), removed_stats[0]);
+
+  changed_stats.clear();
+  report->GetDelta(*report, &changed_stats, nullptr);
+  EXPECT_TRUE(changed_stats.empty());
+}
+
+TEST(RTCStatsReport, ToBinary) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(7);
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats1("a", 0)));
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats2("b", 0)));
+  rtc::Buffer buffer;
+  report->ToBinary(&buffer);
+
+  // The timestamp and the number of stats, followed by the stats in ID order.
+  const uint8_t kHeader[] = {7, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0};
+  rtc::Buffer expected(kHeader);
+  report->Get("a")->ToBinary(&expected);
+  report->Get("b")->ToBinary(&expected);
+  EXPECT_EQ(expected, buffer);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef SYSTEM_WRAPPERS_INCLUDE_METRICS_REGISTRY_H_
+#define SYSTEM_WRAPPERS_INCLUDE_METRICS_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// A snapshot of one metric, as returned by MetricsRegistry::Collect().
+struct MetricValue {
+  enum class Type { kCounter, kGauge, kHistogram };
+
+  MetricValue();
+  MetricValue(const MetricValue&);
+  ~MetricValue();
+
+  Type type = Type::kCounter;
+  std::string name;
+  std::string help;
+  // The value of a counter or a gauge.
+  int64_t value = 0;
+  // The inclusive upper bounds of the buckets of a histogram, and the number
+  // of samples per bucket. |bucket_counts| has one more entry than
+  // |bucket_bounds|, for the samples above the last bound.
+  std::vector<int64_t> bucket_bounds;
+  std::vector<int64_t> bucket_counts;
+  int64_t sum = 0;
+  int64_t count = 0;
+};
+
+// Registry of counters, gauges and histograms for native embedders which
+// export metrics themselves instead of through Chrome's UMA. Metrics are
+// looked up by name once, and the returned pointer is kept by the caller and
+// stays valid until the process exits. Counters and histograms are updated in
+// one of a fixed number of shards picked by the calling thread, so that
+// threads updating the same metric rarely touch the same cache line. The
+// shards are summed up when the metrics are collected.
+//
+// When system_wrappers:metrics_default is used and metrics::Enable() has been
+// called, the RTC_HISTOGRAM_* macros feed histograms of the same name here.
+class MetricsRegistry {
+ public:
+  static const int kNumShards = 16;
+
+  class Counter {
+   public:
+    void Increment(int64_t value = 1);
+    int64_t Value() const;
+
+   private:
+    friend class MetricsRegistry;
+    struct alignas(64) Shard {
+      std::atomic<int64_t> value{0};
+    };
+
+    Counter();
+    void Reset();
+
+    Shard shards_[kNumShards];
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(Counter);
+  };
+
+  class Gauge {
+   public:
+    void Set(int64_t value);
+    void Add(int64_t delta);
+    int64_t Value() const;
+
+   private:
+    friend class MetricsRegistry;
+    Gauge();
+
+    std::atomic<int64_t> value_{0};
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(Gauge);
+  };
+
+  class Histogram {
+   public:
+    ~Histogram();
+
+    void Add(int64_t sample);
+    const std::vector<int64_t>& bucket_bounds() const { return bounds_; }
+
+   private:
+    friend class MetricsRegistry;
+    struct Shard {
+      explicit Shard(size_t num_buckets);
+      ~Shard();
+
+      std::unique_ptr<std::atomic<int64_t>[]> bucket_counts;
+      std::atomic<int64_t> sum{0};
+    };
+
+    explicit Histogram(std::vector<int64_t> bounds);
+    void Collect(MetricValue* value) const;
+    void Reset();
+
+    // Sorted and unique.
+    const std::vector<int64_t> bounds_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(Histogram);
+  };
+
+  // Returns the registry used by the RTC_HISTOGRAM_* macros. It is never
+  // destroyed.
+  static MetricsRegistry* Global();
+
+  // Upper bounds of |bucket_count| buckets as used by the RTC_HISTOGRAM_*
+  // macros: one for the samples below |min|, the ones between |min| and |max|
+  // spaced linearly or exponentially, and the last for the samples at or
+  // above |max|. Take one bound less than |bucket_count|, since the last
+  // bucket is unbounded.
+  static std::vector<int64_t> LinearBounds(int min, int max, int bucket_count);
+  static std::vector<int64_t> ExponentialBounds(int min,
+                                                int max,
+                                                int bucket_count);
+
+  MetricsRegistry();
+  ~MetricsRegistry();
+
+  // Return the metric named |name|, created on the first call. A name must
+  // only be used for one type of metric. |help| and |bucket_bounds| are only
+  // used when the metric is created.
+  Counter* GetCounter(const std::string& name, const std::string& help);
+  Gauge* GetGauge(const std::string& name, const std::string& help);
+  Histogram* GetHistogram(const std::string& name,
+                          const std::string& help,
+                          std::vector<int64_t> bucket_bounds);
+
+  // Returns the current value of all metrics, sorted by name.
+  std::vector<MetricValue> Collect() const;
+
+  // Clears counters and histograms, for tests. Gauges keep their value.
+  void Reset();
+
+ private:
+  template <typename T>
+  struct Entry {
+    std::string help;
+    std::unique_ptr<T> metric;
+  };
+
+  bool IsNameUnused(const std::string& name) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  rtc::CriticalSection crit_;
+  std::map<std::string, Entry<Counter>> counters_ RTC_GUARDED_BY(crit_);
+  std::map<std::string, Entry<Gauge>> gauges_ RTC_GUARDED_BY(crit_);
+  std::map<std::string, Entry<Histogram>> histograms_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MetricsRegistry);
+};
+
+// Formats |metrics| in the Prometheus text exposition format. Characters
+// which are not allowed in Prometheus metric names, like the dots in the
+// RTC_HISTOGRAM names, are replaced by underscores.
+std::string FormatPrometheusText(const std::vector<MetricValue>& metrics);
+
+}  // namespace webrtc
+
+#endif  // SYSTEM_WRAPPERS_INCLUDE_METRICS_REGISTRY_H_
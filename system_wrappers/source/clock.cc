@@ -27,6 +27,7 @@
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/synchronization/rw_lock_wrapper.h"
 #include "rtc_base/timeutils.h"
+#include "rtc_base/virtual_time.h"
 
 namespace webrtc {
 
@@ -41,7 +42,7 @@ class RealTimeClock : public Clock {
 
   // Retrieve an NTP absolute timestamp.
   NtpTime CurrentNtpTime() const override {
-    timeval tv = CurrentTimeVal();
+    timeval tv = WallClockTimeVal();
     double microseconds_in_seconds;
     uint32_t seconds;
     Adjust(tv, &seconds, &microseconds_in_seconds);
@@ -52,7 +53,7 @@ class RealTimeClock : public Clock {
 
   // Retrieve an NTP absolute timestamp in milliseconds.
   int64_t CurrentNtpInMilliseconds() const override {
-    timeval tv = CurrentTimeVal();
+    timeval tv = WallClockTimeVal();
     uint32_t seconds;
     double microseconds_in_seconds;
     Adjust(tv, &seconds, &microseconds_in_seconds);
@@ -63,6 +64,22 @@ class RealTimeClock : public Clock {
  protected:
   virtual timeval CurrentTimeVal() const = 0;
 
+  // On virtual time, wall clock time is virtual too, like rtc::TimeUTCMicros()
+  // is with any clock set for testing.
+  timeval WallClockTimeVal() const {
+    if (rtc::VirtualTimeController::Get())
+      return MicrosToTimeVal(rtc::TimeUTCMicros());
+    return CurrentTimeVal();
+  }
+
+  static timeval MicrosToTimeVal(int64_t us) {
+    timeval tv;
+    tv.tv_sec = static_cast<decltype(tv.tv_sec)>(us / rtc::kNumMicrosecsPerSec);
+    tv.tv_usec =
+        static_cast<decltype(tv.tv_usec)>(us % rtc::kNumMicrosecsPerSec);
+    return tv;
+  }
+
   static void Adjust(const timeval& tv,
                      uint32_t* adjusted_s,
                      double* adjusted_us_in_s) {
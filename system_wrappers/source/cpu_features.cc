@@ -45,9 +45,40 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
                    : "a"(info_type));
 }
 #endif
+#if defined(__pic__) && defined(__i386__)
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
+  __asm__ volatile(
+      "mov %%ebx, %%edi\n"
+      "cpuid\n"
+      "xchg %%edi, %%ebx\n"
+      : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]),
+        "=d"(cpu_info[3])
+      : "a"(info_type), "c"(sub_type));
+}
+#else
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
+  __asm__ volatile("cpuid\n"
+                   : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]),
+                     "=d"(cpu_info[3])
+                   : "a"(info_type), "c"(sub_type));
+}
+#endif
 #endif  // _MSC_VER
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Returns the value of the extended control register |xcr|.
+static uint64_t GetXcr(uint32_t xcr) {
+#if defined(_MSC_VER)
+  return _xgetbv(xcr);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
 #if defined(WEBRTC_ARCH_X86_FAMILY)
 // Actual feature detection for x86.
 static int GetCPUInfo(CPUFeature feature) {
@@ -59,6 +90,23 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kAVX2 || feature == kFMA3) {
+    // Besides the CPU, the OS must support AVX by saving the YMM registers.
+    const int kOsxsaveAndAvx = 0x18000000;
+    if ((cpu_info[2] & kOsxsaveAndAvx) != kOsxsaveAndAvx ||
+        (GetXcr(0) & 0x6) != 0x6) {
+      return 0;
+    }
+    if (feature == kFMA3) {
+      return 0 != (cpu_info[2] & 0x00001000);
+    }
+    __cpuid(cpu_info, 0);
+    if (cpu_info[0] < 7) {
+      return 0;
+    }
+    __cpuidex(cpu_info, 7, 0);
+    return 0 != (cpu_info[1] & 0x00000020);
+  }
   return 0;
 }
 #else
@@ -23,6 +23,8 @@
 #include <unistd.h>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/virtual_time.h"
+#include "system_wrappers/source/event_timer_virtual.h"
 
 #if defined(HAVE_PTHREAD_COND_TIMEDWAIT_MONOTONIC)
 // Chromium build is always defining this macro if __ANDROID_API__ < 20.
@@ -39,6 +41,8 @@ namespace webrtc {
 
 // static
 EventTimerWrapper* EventTimerWrapper::Create() {
+  if (rtc::VirtualTimeController::Get())
+    return new EventTimerVirtual();
   return new EventTimerPosix();
 }
 
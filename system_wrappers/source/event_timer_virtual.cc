@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "system_wrappers/source/event_timer_virtual.h"
+
+#include <algorithm>
+
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+
+EventTimerVirtual::EventTimerVirtual() : event_(false, false) {}
+
+EventTimerVirtual::~EventTimerVirtual() {}
+
+bool EventTimerVirtual::Set() {
+  event_.Set();
+  return true;
+}
+
+EventTypeWrapper EventTimerVirtual::Wait(unsigned long max_time) {
+  int64_t now_ms = rtc::TimeMillis();
+  const int64_t end_ms =
+      max_time == WEBRTC_EVENT_INFINITE ? -1 : now_ms + max_time;
+  while (true) {
+    if (ConsumeTick(now_ms))
+      return kEventSignaled;
+    if (end_ms >= 0 && now_ms >= end_ms)
+      return kEventTimeout;
+    int64_t wake_up_ms = NextTickMs();
+    if (end_ms >= 0)
+      wake_up_ms = wake_up_ms < 0 ? end_ms : std::min(wake_up_ms, end_ms);
+    int wait_ms = wake_up_ms < 0 ? rtc::Event::kForever
+                                 : static_cast<int>(wake_up_ms - now_ms);
+    if (event_.Wait(wait_ms))
+      return kEventSignaled;
+    now_ms = rtc::TimeMillis();
+  }
+}
+
+bool EventTimerVirtual::StartTimer(bool periodic, unsigned long time) {
+  rtc::CritScope lock(&lock_);
+  // Like EventTimerPosix, a periodic timer can't be restarted, but a one
+  // shot timer can be rearmed.
+  if (running_ && periodic_)
+    return false;
+  running_ = true;
+  periodic_ = periodic;
+  start_ms_ = rtc::TimeMillis();
+  period_ms_ = time;
+  ticks_ = 0;
+  return true;
+}
+
+bool EventTimerVirtual::StopTimer() {
+  rtc::CritScope lock(&lock_);
+  running_ = false;
+  return true;
+}
+
+int64_t EventTimerVirtual::NextTickMs() const {
+  rtc::CritScope lock(&lock_);
+  if (!running_)
+    return -1;
+  return start_ms_ + (ticks_ + 1) * period_ms_;
+}
+
+bool EventTimerVirtual::ConsumeTick(int64_t now_ms) {
+  rtc::CritScope lock(&lock_);
+  if (!running_ || now_ms < start_ms_ + (ticks_ + 1) * period_ms_)
+    return false;
+  if (!periodic_) {
+    running_ = false;
+    return true;
+  }
+  // Ticks missed while nobody waited are signaled once, like a set event.
+  ticks_ = std::max<int64_t>(ticks_ + 1,
+                             (now_ms - start_ms_) / std::max<int64_t>(
+                                                        1, period_ms_));
+  return true;
+}
+
+}  // namespace webrtc
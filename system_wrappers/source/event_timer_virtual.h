@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef SYSTEM_WRAPPERS_SOURCE_EVENT_TIMER_VIRTUAL_H_
+#define SYSTEM_WRAPPERS_SOURCE_EVENT_TIMER_VIRTUAL_H_
+
+#include <stdint.h>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "system_wrappers/include/event_wrapper.h"
+
+namespace webrtc {
+
+// Timer created by EventTimerWrapper::Create() on virtual time, see
+// rtc::VirtualTimeController. Instead of a timer thread, Wait() computes the
+// time of the next tick from rtc::TimeMillis() and waits on an rtc::Event
+// until then.
+class EventTimerVirtual : public EventTimerWrapper {
+ public:
+  EventTimerVirtual();
+  ~EventTimerVirtual() override;
+
+  EventTypeWrapper Wait(unsigned long max_time) override;
+  bool Set() override;
+
+  bool StartTimer(bool periodic, unsigned long time) override;
+  bool StopTimer() override;
+
+ private:
+  // Returns the time of the next tick, or -1 if the timer isn't running.
+  int64_t NextTickMs() const;
+  // Returns whether a tick is due at |now_ms|, and moves on past it if so.
+  bool ConsumeTick(int64_t now_ms);
+
+  rtc::Event event_;
+  rtc::CriticalSection lock_;
+  bool running_ RTC_GUARDED_BY(lock_) = false;
+  bool periodic_ RTC_GUARDED_BY(lock_) = false;
+  int64_t start_ms_ RTC_GUARDED_BY(lock_) = 0;
+  int64_t period_ms_ RTC_GUARDED_BY(lock_) = 0;
+  // Number of ticks consumed since |start_ms_|.
+  int64_t ticks_ RTC_GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // SYSTEM_WRAPPERS_SOURCE_EVENT_TIMER_VIRTUAL_H_
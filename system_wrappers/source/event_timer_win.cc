@@ -12,10 +12,15 @@
 
 #include "mmsystem.h"
 
+#include "rtc_base/virtual_time.h"
+#include "system_wrappers/source/event_timer_virtual.h"
+
 namespace webrtc {
 
 // static
 EventTimerWrapper* EventTimerWrapper::Create() {
+  if (rtc::VirtualTimeController::Get())
+    return new EventTimerVirtual();
   return new EventTimerWin();
 }
 
@@ -10,23 +10,29 @@
 #include "system_wrappers/include/field_trial_default.h"
 #include "system_wrappers/include/field_trial.h"
 
+#include <atomic>
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 // Simple field trial implementation, which allows client to
 // specify desired flags in InitFieldTrialsFromString.
 namespace webrtc {
 namespace field_trial {
 
-static const char* trials_init_string = NULL;
+namespace {
 
-std::string FindFullName(const std::string& name) {
-  if (trials_init_string == NULL)
-    return std::string();
+using FieldTrialTable = std::map<std::string, std::string>;
 
-  std::string trials_string(trials_init_string);
-  if (trials_string.empty())
-    return std::string();
+const char* trials_init_string = NULL;
+// Parsed once per InitFieldTrialsFromString, so that lookups don't have to
+// parse the string again.
+std::atomic<const FieldTrialTable*> trials_table(nullptr);
 
+std::unique_ptr<FieldTrialTable> ParseTrials(const std::string& trials_string) {
+  std::unique_ptr<FieldTrialTable> table(new FieldTrialTable());
   static const char kPersistentStringSeparator = '/';
   size_t next_item = 0;
   while (next_item < trials_string.length()) {
@@ -46,15 +52,37 @@ std::string FindFullName(const std::string& name) {
                             field_value_end - field_name_end - 1);
     next_item = field_value_end + 1;
 
-    if (name == field_name)
-      return field_value;
+    // The first value of a trial wins.
+    table->emplace(std::move(field_name), std::move(field_value));
   }
-  return std::string();
+  return table;
+}
+
+}  // namespace
+
+std::string FindFullName(const std::string& name) {
+  const FieldTrialTable* table = trials_table.load(std::memory_order_acquire);
+  if (table == nullptr)
+    return std::string();
+  auto it = table->find(name);
+  if (it == table->end())
+    return std::string();
+  return it->second;
 }
 
 // Optionally initialize field trial from a string.
 void InitFieldTrialsFromString(const char* trials_string) {
+  // Tables that were replaced are kept, since other threads may still be
+  // reading them. Tests are the only ones replacing the trials repeatedly.
+  static std::vector<std::unique_ptr<FieldTrialTable>>* tables =
+      new std::vector<std::unique_ptr<FieldTrialTable>>();
   trials_init_string = trials_string;
+  const FieldTrialTable* table = nullptr;
+  if (trials_string != NULL) {
+    tables->push_back(ParseTrials(trials_string));
+    table = tables->back().get();
+  }
+  trials_table.store(table, std::memory_order_release);
 }
 
 const char* GetFieldTrialString() {
@@ -0,0 +1,60 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "system_wrappers/include/field_trial_default.h"
+
+#include <string>
+
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace field_trial {
+
+class FieldTrialDefaultTest : public ::testing::Test {
+ protected:
+  FieldTrialDefaultTest() : previous_trials_(GetFieldTrialString()) {}
+  ~FieldTrialDefaultTest() override {
+    InitFieldTrialsFromString(previous_trials_);
+  }
+
+ private:
+  const char* const previous_trials_;
+};
+
+TEST_F(FieldTrialDefaultTest, FindsTrials) {
+  static const char kTrials[] = "WebRTC-A/Enabled/WebRTC-B/Disabled,5/";
+  InitFieldTrialsFromString(kTrials);
+  EXPECT_EQ(kTrials, GetFieldTrialString());
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-A"));
+  EXPECT_EQ("Disabled,5", FindFullName("WebRTC-B"));
+  EXPECT_EQ("", FindFullName("WebRTC-C"));
+  EXPECT_TRUE(IsEnabled("WebRTC-A"));
+  EXPECT_TRUE(IsDisabled("WebRTC-B"));
+}
+
+TEST_F(FieldTrialDefaultTest, KeepsFirstValueAndStopsAtMalformedTrial) {
+  InitFieldTrialsFromString("WebRTC-A/1/WebRTC-A/2/WebRTC-B//WebRTC-C/3/");
+  EXPECT_EQ("1", FindFullName("WebRTC-A"));
+  EXPECT_EQ("", FindFullName("WebRTC-B"));
+  EXPECT_EQ("", FindFullName("WebRTC-C"));
+}
+
+TEST_F(FieldTrialDefaultTest, ReplacesTrials) {
+  InitFieldTrialsFromString("WebRTC-A/Enabled/");
+  InitFieldTrialsFromString("WebRTC-B/Enabled/");
+  EXPECT_EQ("", FindFullName("WebRTC-A"));
+  EXPECT_EQ("Enabled", FindFullName("WebRTC-B"));
+  InitFieldTrialsFromString(nullptr);
+  EXPECT_EQ("", FindFullName("WebRTC-B"));
+}
+
+}  // namespace field_trial
+}  // namespace webrtc
@@ -10,10 +10,13 @@
 #include "system_wrappers/include/metrics_default.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/metrics.h"
+#include "system_wrappers/include/metrics_registry.h"
 
 // Default implementation of histogram methods for WebRTC clients that do not
 // want to provide their own implementation.
@@ -30,12 +33,23 @@ const int kMaxSampleMapSize = 300;
 
 class RtcHistogram {
  public:
-  RtcHistogram(const std::string& name, int min, int max, int bucket_count)
-      : min_(min), max_(max), info_(name, min, max, bucket_count) {
+  RtcHistogram(const std::string& name,
+               int min,
+               int max,
+               int bucket_count,
+               std::vector<int64_t> registry_bounds)
+      : min_(min),
+        max_(max),
+        info_(name, min, max, bucket_count),
+        registry_histogram_(MetricsRegistry::Global()->GetHistogram(
+            name,
+            "",
+            std::move(registry_bounds))) {
     RTC_DCHECK_GT(bucket_count, 0);
   }
 
   void Add(int sample) {
+    registry_histogram_->Add(sample);
     sample = std::min(sample, max_);
     sample = std::max(sample, min_ - 1);  // Underflow bucket.
 
@@ -94,6 +108,9 @@ class RtcHistogram {
   const int min_;
   const int max_;
   SampleInfo info_ RTC_GUARDED_BY(crit_);
+  // The samples are also added to the histogram of the same name in the
+  // global MetricsRegistry, which is not reset by GetAndReset().
+  MetricsRegistry::Histogram* const registry_histogram_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
 };
@@ -106,13 +123,20 @@ class RtcHistogramMap {
   Histogram* GetCountsHistogram(const std::string& name,
                                 int min,
                                 int max,
-                                int bucket_count) {
+                                int bucket_count,
+                                bool exponential) {
     rtc::CritScope cs(&crit_);
     const auto& it = map_.find(name);
     if (it != map_.end())
       return reinterpret_cast<Histogram*>(it->second.get());
 
-    RtcHistogram* hist = new RtcHistogram(name, min, max, bucket_count);
+    const int registry_bucket_count = std::max(bucket_count, 3);
+    RtcHistogram* hist = new RtcHistogram(
+        name, min, max, bucket_count,
+        exponential ? MetricsRegistry::ExponentialBounds(min, max,
+                                                         registry_bucket_count)
+                    : MetricsRegistry::LinearBounds(min, max,
+                                                    registry_bucket_count));
     map_[name].reset(hist);
     return reinterpret_cast<Histogram*>(hist);
   }
@@ -123,7 +147,9 @@ class RtcHistogramMap {
     if (it != map_.end())
       return reinterpret_cast<Histogram*>(it->second.get());
 
-    RtcHistogram* hist = new RtcHistogram(name, 1, boundary, boundary + 1);
+    RtcHistogram* hist = new RtcHistogram(
+        name, 1, boundary, boundary + 1,
+        MetricsRegistry::LinearBounds(1, boundary, std::max(boundary + 1, 3)));
     map_[name].reset(hist);
     return reinterpret_cast<Histogram*>(hist);
   }
@@ -215,8 +241,14 @@ Histogram* HistogramFactoryGetCounts(const std::string& name,
                                      int max,
                                      int bucket_count) {
   // TODO(asapersson): Alternative implementation will be needed if this
-  // histogram type should be truly exponential.
-  return HistogramFactoryGetCountsLinear(name, min, max, bucket_count);
+  // histogram type should be truly exponential. Only the histogram fed to the
+  // MetricsRegistry has exponentially spaced buckets.
+  RtcHistogramMap* map = GetMap();
+  if (!map)
+    return nullptr;
+
+  return map->GetCountsHistogram(name, min, max, bucket_count,
+                                 /*exponential=*/true);
 }
 
 // Histogram with linearly spaced buckets.
@@ -231,7 +263,8 @@ Histogram* HistogramFactoryGetCountsLinear(const std::string& name,
   if (!map)
     return nullptr;
 
-  return map->GetCountsHistogram(name, min, max, bucket_count);
+  return map->GetCountsHistogram(name, min, max, bucket_count,
+                                 /*exponential=*/false);
 }
 
 // Histogram with linearly spaced buckets.
@@ -9,7 +9,12 @@
  */
 
 #include "system_wrappers/include/metrics_default.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "system_wrappers/include/metrics.h"
+#include "system_wrappers/include/metrics_registry.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -158,4 +163,24 @@ TEST_F(MetricsDefaultTest, TestMinMaxBucket) {
   EXPECT_EQ(1u, histograms.begin()->second->samples.size());
 }
 
+TEST_F(MetricsDefaultTest, FeedsMetricsRegistry) {
+  const std::string kName = "FeedsMetricsRegistry";
+  RTC_HISTOGRAM_PERCENTAGE(kName, 5);
+  RTC_HISTOGRAM_PERCENTAGE(kName, 50);
+  metrics::Reset();
+
+  const std::vector<MetricValue> values =
+      MetricsRegistry::Global()->Collect();
+  const auto it = std::find_if(
+      values.begin(), values.end(),
+      [&](const MetricValue& value) { return value.name == kName; });
+  ASSERT_NE(values.end(), it);
+  EXPECT_EQ(MetricValue::Type::kHistogram, it->type);
+  // One bucket per percentage, and the overflow bucket.
+  EXPECT_EQ(102u, it->bucket_counts.size());
+  EXPECT_EQ(1, it->bucket_counts[5]);
+  EXPECT_EQ(1, it->bucket_counts[50]);
+  EXPECT_EQ(2, it->count);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,333 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "system_wrappers/include/metrics_registry.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/platform_thread_types.h"
+
+namespace webrtc {
+
+namespace {
+
+// Picks the shard of the calling thread. CurrentThreadRef() is cheap on all
+// platforms, unlike CurrentThreadId(), which is a system call on Linux.
+size_t CurrentShard() {
+  const uint64_t ref = static_cast<uint64_t>(
+      std::hash<rtc::PlatformThreadRef>()(rtc::CurrentThreadRef()));
+  // pthread_t is often an aligned address, so mix the high bits in.
+  return static_cast<size_t>((ref * 0x9E3779B97F4A7C15ull) >> 32) %
+         MetricsRegistry::kNumShards;
+}
+
+std::string PrometheusName(const std::string& name) {
+  std::string result = name;
+  for (size_t i = 0; i < result.size(); ++i) {
+    const char c = result[i];
+    const bool is_digit = c >= '0' && c <= '9';
+    const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                         c == '_' || c == ':' || (i > 0 && is_digit);
+    if (!allowed)
+      result[i] = '_';
+  }
+  return result;
+}
+
+std::string EscapeHelp(const std::string& help) {
+  std::string result;
+  for (char c : help) {
+    if (c == '\\') {
+      result += "\\\\";
+    } else if (c == '\n') {
+      result += "\\n";
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+MetricValue::MetricValue() = default;
+
+MetricValue::MetricValue(const MetricValue&) = default;
+
+MetricValue::~MetricValue() = default;
+
+MetricsRegistry::Counter::Counter() = default;
+
+void MetricsRegistry::Counter::Increment(int64_t value) {
+  shards_[CurrentShard()].value.fetch_add(value, std::memory_order_relaxed);
+}
+
+int64_t MetricsRegistry::Counter::Value() const {
+  int64_t value = 0;
+  for (const Shard& shard : shards_)
+    value += shard.value.load(std::memory_order_relaxed);
+  return value;
+}
+
+void MetricsRegistry::Counter::Reset() {
+  for (Shard& shard : shards_)
+    shard.value.store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry::Gauge::Gauge() = default;
+
+void MetricsRegistry::Gauge::Set(int64_t value) {
+  value_.store(value, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::Gauge::Add(int64_t delta) {
+  value_.fetch_add(delta, std::memory_order_relaxed);
+}
+
+int64_t MetricsRegistry::Gauge::Value() const {
+  return value_.load(std::memory_order_relaxed);
+}
+
+MetricsRegistry::Histogram::Shard::Shard(size_t num_buckets)
+    : bucket_counts(new std::atomic<int64_t>[num_buckets]) {
+  for (size_t i = 0; i < num_buckets; ++i)
+    bucket_counts[i].store(0, std::memory_order_relaxed);
+}
+
+MetricsRegistry::Histogram::Shard::~Shard() = default;
+
+MetricsRegistry::Histogram::Histogram(std::vector<int64_t> bounds)
+    : bounds_(std::move(bounds)) {
+  RTC_DCHECK(std::is_sorted(bounds_.begin(), bounds_.end()));
+  RTC_DCHECK(std::adjacent_find(bounds_.begin(), bounds_.end()) ==
+             bounds_.end());
+  for (int i = 0; i < kNumShards; ++i)
+    shards_.emplace_back(new Shard(bounds_.size() + 1));
+}
+
+MetricsRegistry::Histogram::~Histogram() = default;
+
+void MetricsRegistry::Histogram::Add(int64_t sample) {
+  const size_t bucket =
+      std::lower_bound(bounds_.begin(), bounds_.end(), sample) -
+      bounds_.begin();
+  Shard* shard = shards_[CurrentShard()].get();
+  shard->bucket_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard->sum.fetch_add(sample, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::Histogram::Collect(MetricValue* value) const {
+  value->bucket_bounds = bounds_;
+  value->bucket_counts.assign(bounds_.size() + 1, 0);
+  value->sum = 0;
+  value->count = 0;
+  for (const auto& shard : shards_) {
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+      const int64_t count =
+          shard->bucket_counts[i].load(std::memory_order_relaxed);
+      value->bucket_counts[i] += count;
+      value->count += count;
+    }
+    value->sum += shard->sum.load(std::memory_order_relaxed);
+  }
+}
+
+void MetricsRegistry::Histogram::Reset() {
+  for (const auto& shard : shards_) {
+    for (size_t i = 0; i <= bounds_.size(); ++i)
+      shard->bucket_counts[i].store(0, std::memory_order_relaxed);
+    shard->sum.store(0, std::memory_order_relaxed);
+  }
+}
+
+// static
+MetricsRegistry* MetricsRegistry::Global() {
+  // Leaked, since the histogram pointers are cached by the RTC_HISTOGRAM_*
+  // macros.
+  static MetricsRegistry* const registry = new MetricsRegistry();
+  return registry;
+}
+
+// static
+std::vector<int64_t> MetricsRegistry::LinearBounds(int min,
+                                                   int max,
+                                                   int bucket_count) {
+  RTC_DCHECK_LT(min, max);
+  RTC_DCHECK_GE(bucket_count, 3);
+  std::vector<int64_t> bounds;
+  bounds.push_back(min - 1);
+  const int num_ranges = bucket_count - 2;
+  for (int i = 1; i <= num_ranges; ++i) {
+    // Each range ends right before the next one starts, and the last one
+    // right before |max|.
+    const int64_t bound =
+        min - 1 + (static_cast<int64_t>(max - min) * i + num_ranges - 1) /
+                      num_ranges;
+    if (bound > bounds.back())
+      bounds.push_back(bound);
+  }
+  return bounds;
+}
+
+// static
+std::vector<int64_t> MetricsRegistry::ExponentialBounds(int min,
+                                                        int max,
+                                                        int bucket_count) {
+  RTC_DCHECK_LT(min, max);
+  RTC_DCHECK_GE(bucket_count, 3);
+  std::vector<int64_t> bounds;
+  bounds.push_back(min - 1);
+  const double log_min = log(std::max(min, 1));
+  const double log_max = log(max);
+  const int num_ranges = bucket_count - 2;
+  for (int i = 1; i < num_ranges; ++i) {
+    const double start = exp(log_min + (log_max - log_min) * i / num_ranges);
+    // Values which round to the previous bucket start get a bucket each.
+    const int64_t bound = std::max<int64_t>(
+        bounds.back() + 1, static_cast<int64_t>(start + 0.5) - 1);
+    if (bound >= max - 1)
+      break;
+    bounds.push_back(bound);
+  }
+  bounds.push_back(max - 1);
+  return bounds;
+}
+
+MetricsRegistry::MetricsRegistry() = default;
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry::Counter* MetricsRegistry::GetCounter(
+    const std::string& name,
+    const std::string& help) {
+  rtc::CritScope lock(&crit_);
+  auto it = counters_.find(name);
+  if (it != counters_.end())
+    return it->second.metric.get();
+  RTC_DCHECK(IsNameUnused(name)) << name;
+  Entry<Counter>& entry = counters_[name];
+  entry.help = help;
+  entry.metric.reset(new Counter());
+  return entry.metric.get();
+}
+
+MetricsRegistry::Gauge* MetricsRegistry::GetGauge(const std::string& name,
+                                                  const std::string& help) {
+  rtc::CritScope lock(&crit_);
+  auto it = gauges_.find(name);
+  if (it != gauges_.end())
+    return it->second.metric.get();
+  RTC_DCHECK(IsNameUnused(name)) << name;
+  Entry<Gauge>& entry = gauges_[name];
+  entry.help = help;
+  entry.metric.reset(new Gauge());
+  return entry.metric.get();
+}
+
+MetricsRegistry::Histogram* MetricsRegistry::GetHistogram(
+    const std::string& name,
+    const std::string& help,
+    std::vector<int64_t> bucket_bounds) {
+  rtc::CritScope lock(&crit_);
+  auto it = histograms_.find(name);
+  if (it != histograms_.end())
+    return it->second.metric.get();
+  RTC_DCHECK(IsNameUnused(name)) << name;
+  Entry<Histogram>& entry = histograms_[name];
+  entry.help = help;
+  entry.metric.reset(new Histogram(std::move(bucket_bounds)));
+  return entry.metric.get();
+}
+
+std::vector<MetricValue> MetricsRegistry::Collect() const {
+  std::vector<MetricValue> values;
+  rtc::CritScope lock(&crit_);
+  for (const auto& kv : counters_) {
+    values.emplace_back();
+    values.back().type = MetricValue::Type::kCounter;
+    values.back().name = kv.first;
+    values.back().help = kv.second.help;
+    values.back().value = kv.second.metric->Value();
+  }
+  for (const auto& kv : gauges_) {
+    values.emplace_back();
+    values.back().type = MetricValue::Type::kGauge;
+    values.back().name = kv.first;
+    values.back().help = kv.second.help;
+    values.back().value = kv.second.metric->Value();
+  }
+  for (const auto& kv : histograms_) {
+    values.emplace_back();
+    values.back().type = MetricValue::Type::kHistogram;
+    values.back().name = kv.first;
+    values.back().help = kv.second.help;
+    kv.second.metric->Collect(&values.back());
+  }
+  std::sort(values.begin(), values.end(),
+            [](const MetricValue& a, const MetricValue& b) {
+              return a.name < b.name;
+            });
+  return values;
+}
+
+void MetricsRegistry::Reset() {
+  rtc::CritScope lock(&crit_);
+  for (const auto& kv : counters_)
+    kv.second.metric->Reset();
+  for (const auto& kv : histograms_)
+    kv.second.metric->Reset();
+}
+
+bool MetricsRegistry::IsNameUnused(const std::string& name) const {
+  return counters_.count(name) == 0 && gauges_.count(name) == 0 &&
+         histograms_.count(name) == 0;
+}
+
+std::string FormatPrometheusText(const std::vector<MetricValue>& metrics) {
+  std::ostringstream text;
+  for (const MetricValue& metric : metrics) {
+    const std::string name = PrometheusName(metric.name);
+    if (!metric.help.empty())
+      text << "# HELP " << name << " " << EscapeHelp(metric.help) << "\n";
+    switch (metric.type) {
+      case MetricValue::Type::kCounter:
+        text << "# TYPE " << name << " counter\n"
+             << name << " " << metric.value << "\n";
+        break;
+      case MetricValue::Type::kGauge:
+        text << "# TYPE " << name << " gauge\n"
+             << name << " " << metric.value << "\n";
+        break;
+      case MetricValue::Type::kHistogram: {
+        text << "# TYPE " << name << " histogram\n";
+        // Prometheus buckets are cumulative.
+        int64_t count = 0;
+        for (size_t i = 0; i < metric.bucket_bounds.size(); ++i) {
+          count += metric.bucket_counts[i];
+          text << name << "_bucket{le=\"" << metric.bucket_bounds[i] << "\"} "
+               << count << "\n";
+        }
+        text << name << "_bucket{le=\"+Inf\"} " << metric.count << "\n"
+             << name << "_sum " << metric.sum << "\n"
+             << name << "_count " << metric.count << "\n";
+        break;
+      }
+    }
+  }
+  return text.str();
+}
+
+}  // namespace webrtc
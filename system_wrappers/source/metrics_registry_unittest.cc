@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "system_wrappers/include/metrics_registry.h"
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/platform_thread.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+using ::testing::ElementsAre;
+
+namespace webrtc {
+
+namespace {
+
+const int kNumThreads = 4;
+const int kIncrementsPerThread = 10000;
+
+void IncrementCounter(void* param) {
+  MetricsRegistry::Counter* counter =
+      static_cast<MetricsRegistry::Counter*>(param);
+  for (int i = 0; i < kIncrementsPerThread; ++i)
+    counter->Increment();
+}
+
+}  // namespace
+
+TEST(MetricsRegistryTest, ReturnsSameMetricForName) {
+  MetricsRegistry registry;
+  MetricsRegistry::Counter* counter = registry.GetCounter("counter", "");
+  EXPECT_EQ(counter, registry.GetCounter("counter", ""));
+  EXPECT_NE(counter, registry.GetCounter("other_counter", ""));
+  MetricsRegistry::Gauge* gauge = registry.GetGauge("gauge", "");
+  EXPECT_EQ(gauge, registry.GetGauge("gauge", ""));
+  MetricsRegistry::Histogram* histogram =
+      registry.GetHistogram("histogram", "", {1, 2});
+  EXPECT_EQ(histogram, registry.GetHistogram("histogram", "", {5}));
+  EXPECT_THAT(histogram->bucket_bounds(), ElementsAre(1, 2));
+}
+
+TEST(MetricsRegistryTest, SumsCounterOverThreads) {
+  MetricsRegistry registry;
+  MetricsRegistry::Counter* counter = registry.GetCounter("counter", "");
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&IncrementCounter, counter, "Increment"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  EXPECT_EQ(kNumThreads * kIncrementsPerThread, counter->Value());
+
+  registry.Reset();
+  EXPECT_EQ(0, counter->Value());
+}
+
+TEST(MetricsRegistryTest, SetsGauge) {
+  MetricsRegistry registry;
+  MetricsRegistry::Gauge* gauge = registry.GetGauge("gauge", "");
+  gauge->Set(10);
+  gauge->Add(-3);
+  EXPECT_EQ(7, gauge->Value());
+  registry.Reset();
+  EXPECT_EQ(7, gauge->Value());
+}
+
+TEST(MetricsRegistryTest, CountsHistogramSamplesPerBucket) {
+  MetricsRegistry registry;
+  MetricsRegistry::Histogram* histogram =
+      registry.GetHistogram("histogram", "", {0, 10, 100});
+  histogram->Add(-5);
+  histogram->Add(10);
+  histogram->Add(11);
+  histogram->Add(1000);
+
+  const std::vector<MetricValue> values = registry.Collect();
+  ASSERT_EQ(1u, values.size());
+  EXPECT_EQ(MetricValue::Type::kHistogram, values[0].type);
+  EXPECT_THAT(values[0].bucket_counts, ElementsAre(1, 1, 1, 1));
+  EXPECT_EQ(4, values[0].count);
+  EXPECT_EQ(1016, values[0].sum);
+}
+
+TEST(MetricsRegistryTest, CollectsSortedByName) {
+  MetricsRegistry registry;
+  registry.GetHistogram("a", "", {1});
+  registry.GetCounter("c", "")->Increment(3);
+  registry.GetGauge("b", "")->Set(2);
+
+  const std::vector<MetricValue> values = registry.Collect();
+  ASSERT_EQ(3u, values.size());
+  EXPECT_EQ("a", values[0].name);
+  EXPECT_EQ("b", values[1].name);
+  EXPECT_EQ(2, values[1].value);
+  EXPECT_EQ("c", values[2].name);
+  EXPECT_EQ(3, values[2].value);
+}
+
+TEST(MetricsRegistryTest, MakesBoundsLikeHistogramMacros) {
+  // One bucket per value of an enumeration with boundary 4.
+  EXPECT_THAT(MetricsRegistry::LinearBounds(1, 4, 5),
+              ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(MetricsRegistry::LinearBounds(1, 101, 4),
+              ElementsAre(0, 50, 100));
+  EXPECT_THAT(MetricsRegistry::ExponentialBounds(1, 10000, 6),
+              ElementsAre(0, 9, 99, 999, 9999));
+  // Small ranges get one bucket per value.
+  EXPECT_THAT(MetricsRegistry::ExponentialBounds(1, 4, 50),
+              ElementsAre(0, 1, 2, 3));
+}
+
+TEST(MetricsRegistryTest, FormatsPrometheusText) {
+  MetricsRegistry registry;
+  registry.GetCounter("WebRTC.Packets", "Sent packets.")->Increment(5);
+  registry.GetGauge("streams", "")->Set(2);
+  MetricsRegistry::Histogram* histogram =
+      registry.GetHistogram("delay", "", {10, 100});
+  histogram->Add(5);
+  histogram->Add(50);
+  histogram->Add(500);
+
+  EXPECT_EQ(
+      "# HELP WebRTC_Packets Sent packets.\n"
+      "# TYPE WebRTC_Packets counter\n"
+      "WebRTC_Packets 5\n"
+      "# TYPE delay histogram\n"
+      "delay_bucket{le=\"10\"} 1\n"
+      "delay_bucket{le=\"100\"} 2\n"
+      "delay_bucket{le=\"+Inf\"} 3\n"
+      "delay_sum 555\n"
+      "delay_count 3\n"
+      "# TYPE streams gauge\n"
+      "streams 2\n",
+      FormatPrometheusText(registry.Collect()));
+}
+
+}  // namespace webrtc
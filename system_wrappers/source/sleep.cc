@@ -19,9 +19,17 @@
 #include <time.h>
 #endif
 
+#include "rtc_base/timeutils.h"
+#include "rtc_base/virtual_time.h"
+
 namespace webrtc {
 
 void SleepMs(int msecs) {
+  if (rtc::VirtualTimeController* virtual_time =
+          rtc::VirtualTimeController::Get()) {
+    virtual_time->Sleep(msecs * rtc::kNumMicrosecsPerMillisec);
+    return;
+  }
 #ifdef _WIN32
   Sleep(msecs);
 #else
@@ -22,6 +22,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
 #include "rtc_base/experiments/congestion_controller_experiment.h"
+#include "rtc_base/timeutils.h"
 #include "test/fake_encoder.h"
 #include "test/testsupport/fileutils.h"
 
@@ -32,8 +33,14 @@ namespace {
 const int kVideoRotationRtpExtensionId = 4;
 }
 
-CallTest::CallTest()
-    : clock_(Clock::GetRealTimeClock()),
+CallTest::CallTest() : CallTest(false) {}
+
+CallTest::CallTest(bool use_virtual_time)
+    : virtual_time_(use_virtual_time ? new rtc::VirtualTimeController(
+                                           rtc::SystemTimeNanos() /
+                                           rtc::kNumNanosecsPerMicrosec)
+                                     : nullptr),
+      clock_(Clock::GetRealTimeClock()),
       send_event_log_(RtcEventLog::CreateNull()),
       recv_event_log_(RtcEventLog::CreateNull()),
       sender_call_transport_controller_(nullptr),
@@ -17,6 +17,7 @@
 #include "call/rtp_transport_controller_send.h"
 #include "logging/rtc_event_log/rtc_event_log.h"
 #include "modules/audio_device/include/test_audio_device.h"
+#include "rtc_base/virtual_time.h"
 #include "test/encoder_settings.h"
 #include "test/fake_decoder.h"
 #include "test/fake_videorenderer.h"
@@ -33,6 +34,9 @@ class BaseTest;
 class CallTest : public ::testing::Test {
  public:
   CallTest();
+  // With |use_virtual_time|, the test runs on an rtc::VirtualTimeController,
+  // so that timeouts and pacing don't take real time.
+  explicit CallTest(bool use_virtual_time);
   virtual ~CallTest();
 
   static constexpr size_t kNumSsrcs = 6;
@@ -166,6 +170,9 @@ class CallTest : public ::testing::Test {
   VideoSendStream* GetVideoSendStream();
   FlexfecReceiveStream::Config* GetFlexFecConfig();
 
+  // Created first and destroyed last, as all threads of the test must run
+  // within its lifetime.
+  const std::unique_ptr<rtc::VirtualTimeController> virtual_time_;
   Clock* const clock_;
 
   std::unique_ptr<webrtc::RtcEventLog> send_event_log_;
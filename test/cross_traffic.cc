@@ -0,0 +1,250 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "test/cross_traffic.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// Segments this far behind an acknowledged one are lost, like after three
+// duplicate acknowledgements.
+constexpr uint64_t kReorderingThreshold = 3;
+// The timeout before there is an RTT estimate, as in RFC 6298.
+constexpr int64_t kInitialRtoUs = 1000 * rtc::kNumMicrosecsPerMillisec;
+
+}  // namespace
+
+TcpCrossTraffic::TcpCrossTraffic(NetworkEmulation* emulation,
+                                 EmulatedEndpoint* sender,
+                                 EmulatedEndpoint* receiver,
+                                 Config config)
+    : emulation_(emulation),
+      sender_endpoint_(sender),
+      receiver_endpoint_(receiver),
+      config_(config),
+      sender_(this),
+      receiver_(this),
+      window_(config.initial_window_packets * config.packet_size),
+      slow_start_threshold_(std::numeric_limits<double>::max()) {
+  RTC_DCHECK_GT(config.packet_size, 0);
+  sender_endpoint_->SetReceiver(&sender_);
+  receiver_endpoint_->SetReceiver(&receiver_);
+}
+
+TcpCrossTraffic::~TcpCrossTraffic() = default;
+
+void TcpCrossTraffic::Start() {
+  emulation_->PostTaskAt(emulation_->NowUs(), [this]() {
+    sending_ = true;
+    SendSegments();
+  });
+}
+
+void TcpCrossTraffic::Stop() {
+  emulation_->PostTaskAt(emulation_->NowUs(), [this]() { sending_ = false; });
+}
+
+TcpCrossTraffic::Stats TcpCrossTraffic::GetStats() const {
+  Stats stats;
+  emulation_->Invoke([this, &stats]() {
+    stats = stats_;
+    stats.window_packets = window_ / config_.packet_size;
+    stats.smoothed_rtt_ms =
+        std::max<int64_t>(smoothed_rtt_us_, 0) / rtc::kNumMicrosecsPerMillisec;
+  });
+  return stats;
+}
+
+void TcpCrossTraffic::Sender::OnPacketReceived(EmulatedPacket packet) {
+  traffic_->OnAck(packet.sequence_number);
+}
+
+void TcpCrossTraffic::Receiver::OnPacketReceived(EmulatedPacket packet) {
+  traffic_->receiver_endpoint_->SendPacket(
+      traffic_->sender_endpoint_, traffic_->config_.ack_size,
+      rtc::CopyOnWriteBuffer(), packet.sequence_number);
+}
+
+void TcpCrossTraffic::OnAck(uint64_t sequence_number) {
+  if (sequence_number < first_sequence_number_ ||
+      sequence_number >= first_sequence_number_ + segments_.size()) {
+    return;
+  }
+  Segment& segment = segments_[sequence_number - first_sequence_number_];
+  if (segment.done)
+    return;  // Already counted as lost.
+  segment.done = true;
+  bytes_in_flight_ -= config_.packet_size;
+  stats_.bytes_acked += config_.packet_size;
+
+  // Update the RTT estimate as in RFC 6298.
+  const int64_t now_us = emulation_->NowUs();
+  const int64_t rtt_us = now_us - segment.send_time_us;
+  if (smoothed_rtt_us_ < 0) {
+    smoothed_rtt_us_ = rtt_us;
+    rtt_variation_us_ = rtt_us / 2;
+  } else {
+    rtt_variation_us_ =
+        (3 * rtt_variation_us_ + std::abs(smoothed_rtt_us_ - rtt_us)) / 4;
+    smoothed_rtt_us_ = (7 * smoothed_rtt_us_ + rtt_us) / 8;
+  }
+  last_progress_time_us_ = now_us;
+
+  for (uint64_t lost = first_sequence_number_;
+       lost + kReorderingThreshold <= sequence_number; ++lost) {
+    if (!segments_[lost - first_sequence_number_].done)
+      OnLoss(lost);
+  }
+
+  if (sequence_number >= recovery_sequence_number_) {
+    if (window_ < slow_start_threshold_) {
+      window_ += config_.packet_size;
+    } else {
+      window_ += static_cast<double>(config_.packet_size) *
+                 config_.packet_size / window_;
+    }
+  }
+
+  while (!segments_.empty() && segments_.front().done) {
+    segments_.pop_front();
+    ++first_sequence_number_;
+  }
+  SendSegments();
+}
+
+void TcpCrossTraffic::OnLoss(uint64_t sequence_number) {
+  segments_[sequence_number - first_sequence_number_].done = true;
+  bytes_in_flight_ -= config_.packet_size;
+  ++stats_.packets_lost;
+  if (sequence_number >= recovery_sequence_number_) {
+    slow_start_threshold_ =
+        std::max(window_ / 2, 2.0 * config_.packet_size);
+    window_ = slow_start_threshold_;
+    recovery_sequence_number_ = next_sequence_number_;
+  }
+}
+
+void TcpCrossTraffic::SendSegments() {
+  if (!sending_)
+    return;
+  const int64_t now_us = emulation_->NowUs();
+  if (bytes_in_flight_ == 0)
+    last_progress_time_us_ = now_us;
+  while (bytes_in_flight_ + config_.packet_size <= window_) {
+    segments_.push_back({now_us, false});
+    bytes_in_flight_ += config_.packet_size;
+    ++stats_.packets_sent;
+    sender_endpoint_->SendPacket(receiver_endpoint_, config_.packet_size,
+                                 rtc::CopyOnWriteBuffer(),
+                                 next_sequence_number_++);
+  }
+  ScheduleTimeout();
+}
+
+void TcpCrossTraffic::ScheduleTimeout() {
+  if (timeout_scheduled_ || bytes_in_flight_ == 0)
+    return;
+  timeout_scheduled_ = true;
+  emulation_->PostTaskAt(last_progress_time_us_ + RtoUs(),
+                         [this]() { OnTimeout(); });
+}
+
+void TcpCrossTraffic::OnTimeout() {
+  timeout_scheduled_ = false;
+  if (bytes_in_flight_ == 0)
+    return;
+  const int64_t now_us = emulation_->NowUs();
+  if (now_us < last_progress_time_us_ + RtoUs()) {
+    // There has been progress since the timeout was scheduled.
+    ScheduleTimeout();
+    return;
+  }
+  for (const Segment& segment : segments_) {
+    if (!segment.done)
+      ++stats_.packets_lost;
+  }
+  first_sequence_number_ = next_sequence_number_;
+  segments_.clear();
+  bytes_in_flight_ = 0;
+  ++stats_.timeouts;
+  slow_start_threshold_ = std::max(window_ / 2, 2.0 * config_.packet_size);
+  window_ = config_.packet_size;
+  recovery_sequence_number_ = next_sequence_number_;
+  SendSegments();
+}
+
+int64_t TcpCrossTraffic::RtoUs() const {
+  if (smoothed_rtt_us_ < 0)
+    return kInitialRtoUs;
+  return std::max(config_.min_rto_ms * rtc::kNumMicrosecsPerMillisec,
+                  smoothed_rtt_us_ + 4 * rtt_variation_us_);
+}
+
+OnOffCrossTraffic::OnOffCrossTraffic(NetworkEmulation* emulation,
+                                     EmulatedEndpoint* sender,
+                                     const EmulatedEndpoint* receiver,
+                                     Config config)
+    : emulation_(emulation),
+      sender_(sender),
+      receiver_(receiver),
+      config_(config),
+      packet_interval_us_(config.packet_size * 8 *
+                          rtc::kNumMillisecsPerSec / config.rate_kbps) {
+  RTC_DCHECK_GT(config.rate_kbps, 0);
+  RTC_DCHECK_GT(config.on_ms, 0);
+  RTC_DCHECK_GE(config.off_ms, 0);
+}
+
+OnOffCrossTraffic::~OnOffCrossTraffic() = default;
+
+void OnOffCrossTraffic::Start() {
+  emulation_->PostTaskAt(emulation_->NowUs(), [this]() {
+    if (sending_)
+      return;
+    sending_ = true;
+    phase_start_time_us_ = emulation_->NowUs();
+    SendPacket(++generation_);
+  });
+}
+
+void OnOffCrossTraffic::Stop() {
+  emulation_->PostTaskAt(emulation_->NowUs(), [this]() { sending_ = false; });
+}
+
+void OnOffCrossTraffic::SendPacket(int generation) {
+  if (!sending_ || generation != generation_)
+    return;
+  const int64_t now_us = emulation_->NowUs();
+  const int64_t on_us = config_.on_ms * rtc::kNumMicrosecsPerMillisec;
+  const int64_t period_us =
+      on_us + config_.off_ms * rtc::kNumMicrosecsPerMillisec;
+  const int64_t time_in_period_us = (now_us - phase_start_time_us_) % period_us;
+  int64_t next_time_us = now_us + packet_interval_us_;
+  if (time_in_period_us < on_us) {
+    sender_->SendPacket(receiver_, config_.packet_size,
+                        rtc::CopyOnWriteBuffer(), 0);
+  } else {
+    // Resume at the start of the next period.
+    next_time_us = now_us + period_us - time_in_period_us;
+  }
+  emulation_->PostTaskAt(next_time_us,
+                         [this, generation]() { SendPacket(generation); });
+}
+
+}  // namespace test
+}  // namespace webrtc
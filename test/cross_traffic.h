@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef TEST_CROSS_TRAFFIC_H_
+#define TEST_CROSS_TRAFFIC_H_
+
+#include <deque>
+
+#include "rtc_base/constructormagic.h"
+#include "test/network_emulation.h"
+
+namespace webrtc {
+namespace test {
+
+// A bulk transfer with TCP Reno-like congestion control between two endpoints
+// of a NetworkEmulation, which need routes in both directions. Every segment
+// is acknowledged on its own, so the acknowledgements should take a lossless
+// route. A segment is lost once three later segments have been acknowledged,
+// or when nothing has been acknowledged for a retransmission timeout; lost
+// data isn't retransmitted, since only the load matters. The window is halved
+// at most once per window of data, and restarts from one segment after a
+// timeout.
+//
+// Both kinds of cross traffic must outlive the processing of the emulation.
+class TcpCrossTraffic {
+ public:
+  struct Config {
+    size_t packet_size = 1500;
+    size_t ack_size = 40;
+    int initial_window_packets = 10;
+    int64_t min_rto_ms = 200;
+  };
+
+  struct Stats {
+    int64_t packets_sent = 0;
+    int64_t packets_lost = 0;
+    int64_t timeouts = 0;
+    int64_t bytes_acked = 0;
+    double window_packets = 0.0;
+    int64_t smoothed_rtt_ms = 0;
+  };
+
+  TcpCrossTraffic(NetworkEmulation* emulation,
+                  EmulatedEndpoint* sender,
+                  EmulatedEndpoint* receiver,
+                  Config config);
+  ~TcpCrossTraffic();
+
+  // Start() and Stop() may be called on any thread.
+  void Start();
+  void Stop();
+
+  Stats GetStats() const;
+
+ private:
+  class Sender : public EmulatedNetworkReceiverInterface {
+   public:
+    explicit Sender(TcpCrossTraffic* traffic) : traffic_(traffic) {}
+    // Receives the acknowledgements.
+    void OnPacketReceived(EmulatedPacket packet) override;
+
+   private:
+    TcpCrossTraffic* const traffic_;
+  };
+
+  class Receiver : public EmulatedNetworkReceiverInterface {
+   public:
+    explicit Receiver(TcpCrossTraffic* traffic) : traffic_(traffic) {}
+    void OnPacketReceived(EmulatedPacket packet) override;
+
+   private:
+    TcpCrossTraffic* const traffic_;
+  };
+
+  struct Segment {
+    int64_t send_time_us;
+    bool done;
+  };
+
+  void OnAck(uint64_t sequence_number);
+  void OnLoss(uint64_t sequence_number);
+  void SendSegments();
+  void ScheduleTimeout();
+  void OnTimeout();
+  int64_t RtoUs() const;
+
+  NetworkEmulation* const emulation_;
+  EmulatedEndpoint* const sender_endpoint_;
+  EmulatedEndpoint* const receiver_endpoint_;
+  const Config config_;
+  Sender sender_;
+  Receiver receiver_;
+
+  bool sending_ = false;
+  // In bytes.
+  double window_;
+  double slow_start_threshold_;
+  size_t bytes_in_flight_ = 0;
+  uint64_t next_sequence_number_ = 0;
+  // The window isn't reduced again for losses of segments sent before this.
+  uint64_t recovery_sequence_number_ = 0;
+  // The segments from |first_sequence_number_| on, until the last one sent.
+  std::deque<Segment> segments_;
+  uint64_t first_sequence_number_ = 0;
+  int64_t smoothed_rtt_us_ = -1;
+  int64_t rtt_variation_us_ = 0;
+  // The last time a segment was acknowledged, or the window became
+  // non-empty.
+  int64_t last_progress_time_us_ = 0;
+  bool timeout_scheduled_ = false;
+  Stats stats_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(TcpCrossTraffic);
+};
+
+// Traffic which doesn't react to congestion, like a UDP stream: sends at
+// |rate_kbps| for |on_ms|, pauses for |off_ms|, and so on. With |off_ms| 0 the
+// rate is constant.
+class OnOffCrossTraffic {
+ public:
+  struct Config {
+    int rate_kbps = 1000;
+    size_t packet_size = 1200;
+    int64_t on_ms = 1000;
+    int64_t off_ms = 0;
+  };
+
+  OnOffCrossTraffic(NetworkEmulation* emulation,
+                    EmulatedEndpoint* sender,
+                    const EmulatedEndpoint* receiver,
+                    Config config);
+  ~OnOffCrossTraffic();
+
+  // Start() and Stop() may be called on any thread.
+  void Start();
+  void Stop();
+
+ private:
+  void SendPacket(int generation);
+
+  NetworkEmulation* const emulation_;
+  EmulatedEndpoint* const sender_;
+  const EmulatedEndpoint* const receiver_;
+  const Config config_;
+  const int64_t packet_interval_us_;
+  bool sending_ = false;
+  int64_t phase_start_time_us_ = 0;
+  // Guards against the timer of a previous Start() after Stop().
+  int generation_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(OnOffCrossTraffic);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_CROSS_TRAFFIC_H_
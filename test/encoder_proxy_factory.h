@@ -74,6 +74,12 @@ class EncoderProxyFactory final : public VideoEncoderFactory {
     VideoEncoder::ScalingSettings GetScalingSettings() const override {
       return encoder_->GetScalingSettings();
     }
+    bool SetSpeedSteps(int steps) override {
+      return encoder_->SetSpeedSteps(steps);
+    }
+    bool Reconfigure(const VideoCodec& codec_settings) override {
+      return encoder_->Reconfigure(codec_settings);
+    }
     int32_t RegisterEncodeCompleteCallback(
         EncodedImageCallback* callback) override {
       return encoder_->RegisterEncodeCompleteCallback(callback);
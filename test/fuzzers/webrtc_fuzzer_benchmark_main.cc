@@ -0,0 +1,244 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file replaces libFuzzer's main() to turn a fuzzer into a benchmark. It
+// replays the inputs of a corpus, one file per input, and measures how fast
+// FuzzOneInput() processes them. Since the corpus has been grown to cover as
+// much of the parser as possible, this catches inputs that are much more
+// expensive than their size suggests, e.g. quadratic behaviour that a remote
+// peer could use to exhaust a server.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "test/testsupport/fileutils.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+extern void FuzzOneInput(const uint8_t* data, size_t size);
+}  // namespace webrtc
+
+DEFINE_int(min_time_ms,
+           10,
+           "Each input is replayed until at least this much time has passed.");
+DEFINE_int(scale,
+           8,
+           "Each input is also replayed repeated this many times, to find "
+           "inputs whose processing time grows faster than their size. Set "
+           "to 1 to disable.");
+DEFINE_int(max_len,
+           0,
+           "Longer inputs are truncated, like libFuzzer's -max_len does. 0 "
+           "means no limit. Repeated inputs longer than this aren't "
+           "replayed.");
+DEFINE_int(num_slowest, 3, "Number of slowest inputs to print.");
+DEFINE_string(name,
+              "",
+              "Name of the trace in the perf results, by default the name of "
+              "the executable.");
+DEFINE_string(isolated_script_test_perf_output,
+              "",
+              "Path where the perf results should be stored in the JSON "
+              "format of test/testsupport/perf_test.h.");
+DEFINE_bool(help, false, "Print this message.");
+
+namespace webrtc {
+namespace {
+
+struct Input {
+  std::string path;
+  std::vector<uint8_t> data;
+  // Time per FuzzOneInput() call, for |data| and for |data| repeated
+  // FLAG_scale times.
+  double time_ns = 0.0;
+  double scaled_time_ns = 0.0;
+
+  double NsPerByte() const {
+    return time_ns / std::max<size_t>(data.size(), 1);
+  }
+  // How the processing time grows with the size; 1 is linear, 2 quadratic.
+  double ScalingExponent() const {
+    if (time_ns <= 0.0 || scaled_time_ns <= 0.0)
+      return 0.0;
+    return std::log(scaled_time_ns / time_ns) / std::log(FLAG_scale);
+  }
+};
+
+bool ReadInput(const std::string& path, std::vector<Input>* inputs) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file)
+    return false;
+  Input input;
+  input.path = path;
+  uint8_t buffer[4096];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    input.data.insert(input.data.end(), buffer, buffer + read);
+  fclose(file);
+  if (FLAG_max_len > 0 && input.data.size() > static_cast<size_t>(FLAG_max_len))
+    input.data.resize(FLAG_max_len);
+  inputs->push_back(std::move(input));
+  return true;
+}
+
+// Adds the files of |path|, which is either a corpus directory or a single
+// input, to |inputs|.
+bool ReadCorpus(const std::string& path, std::vector<Input>* inputs) {
+  if (!test::DirExists(path))
+    return ReadInput(path, inputs);
+  absl::optional<std::vector<std::string>> files = test::ReadDirectory(path);
+  if (!files)
+    return false;
+  std::sort(files->begin(), files->end());
+  for (const std::string& file : *files) {
+    if (!test::DirExists(file) && !ReadInput(file, inputs))
+      return false;
+  }
+  return true;
+}
+
+// Returns the mean time of a FuzzOneInput() call for |data|. The input is
+// copied into a buffer of its exact size, as libFuzzer does, so that
+// sanitizers catch reads past its end.
+double TimeInput(const std::vector<uint8_t>& data) {
+  const std::vector<uint8_t> copy(data);
+  const int64_t min_time_ns =
+      static_cast<int64_t>(FLAG_min_time_ms) * rtc::kNumNanosecsPerMillisec;
+  const int64_t start_ns = rtc::TimeNanos();
+  int64_t elapsed_ns = 0;
+  int64_t iterations = 0;
+  do {
+    FuzzOneInput(copy.data(), copy.size());
+    ++iterations;
+    elapsed_ns = rtc::TimeNanos() - start_ns;
+  } while (elapsed_ns < min_time_ns);
+  return static_cast<double>(elapsed_ns) / iterations;
+}
+
+std::vector<uint8_t> Repeat(const std::vector<uint8_t>& data, int times) {
+  std::vector<uint8_t> repeated;
+  repeated.reserve(data.size() * times);
+  for (int i = 0; i < times; ++i)
+    repeated.insert(repeated.end(), data.begin(), data.end());
+  return repeated;
+}
+
+// Returns the name of the executable, without directory and extension.
+std::string ExecutableName(const std::string& path) {
+  const size_t slash = path.find_last_of("/\\");
+  std::string name =
+      slash == std::string::npos ? path : path.substr(slash + 1);
+  return name.substr(0, name.find('.'));
+}
+
+int Run(const std::string& trace, const std::vector<std::string>& corpora) {
+  std::vector<Input> inputs;
+  for (const std::string& corpus : corpora) {
+    if (!ReadCorpus(corpus, &inputs)) {
+      fprintf(stderr, "Failed to read %s\n", corpus.c_str());
+      return 1;
+    }
+  }
+  if (inputs.empty()) {
+    fprintf(stderr, "The corpus is empty.\n");
+    return 1;
+  }
+
+  double total_time_ns = 0.0;
+  size_t total_bytes = 0;
+  for (Input& input : inputs) {
+    input.time_ns = TimeInput(input.data);
+    const size_t scaled_size = input.data.size() * FLAG_scale;
+    if (FLAG_scale > 1 &&
+        (FLAG_max_len == 0 || scaled_size <= static_cast<size_t>(FLAG_max_len)))
+      input.scaled_time_ns = TimeInput(Repeat(input.data, FLAG_scale));
+    total_time_ns += input.time_ns;
+    total_bytes += input.data.size();
+  }
+
+  std::vector<const Input*> slowest;
+  for (const Input& input : inputs)
+    slowest.push_back(&input);
+  std::sort(slowest.begin(), slowest.end(),
+            [](const Input* a, const Input* b) {
+              return a->NsPerByte() > b->NsPerByte();
+            });
+  const Input* worst_scaling = *std::max_element(
+      slowest.begin(), slowest.end(), [](const Input* a, const Input* b) {
+        return a->ScalingExponent() < b->ScalingExponent();
+      });
+
+  printf("Replayed %zu inputs, %zu bytes.\n", inputs.size(), total_bytes);
+  const size_t num_slowest =
+      std::min<size_t>(std::max(FLAG_num_slowest, 0), slowest.size());
+  for (size_t i = 0; i < num_slowest; ++i) {
+    printf("Slow input: %s, %zu bytes, %.1f ns/byte\n",
+           slowest[i]->path.c_str(), slowest[i]->data.size(),
+           slowest[i]->NsPerByte());
+  }
+  if (FLAG_scale > 1) {
+    printf("Worst scaling input: %s, time grows as size^%.2f\n",
+           worst_scaling->path.c_str(), worst_scaling->ScalingExponent());
+  }
+
+  // MB per second is the same as bytes per microsecond.
+  test::PrintResult("fuzzer_corpus_throughput", "", trace,
+                    total_bytes * 1000.0 / total_time_ns, "MB/s", true);
+  test::PrintResult("fuzzer_corpus_time", "", trace,
+                    total_time_ns / rtc::kNumNanosecsPerMicrosec, "us",
+                    false);
+  test::PrintResult("fuzzer_slowest_input", "", trace,
+                    slowest.front()->NsPerByte(), "ns/byte", false);
+  if (FLAG_scale > 1) {
+    test::PrintResult("fuzzer_worst_scaling_exponent", "", trace,
+                      worst_scaling->ScalingExponent(), "exponent", false);
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  const std::string usage =
+      "Replays fuzzer corpora and measures how fast the fuzzer processes "
+      "them.\n"
+      "Usage: " +
+      std::string(argv[0]) + " [options] <corpus dir or file>...\n";
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) || FLAG_help ||
+      argc < 2 || FLAG_min_time_ms < 0 || FLAG_scale < 1 || FLAG_max_len < 0) {
+    printf("%s", usage.c_str());
+    if (FLAG_help) {
+      rtc::FlagList::Print(nullptr, false);
+      return 0;
+    }
+    return 1;
+  }
+  // Logging slows the fuzzers down a lot, see webrtc_fuzzer_main.cc.
+  rtc::LogMessage::LogToDebug(rtc::LS_NONE);
+
+  const std::string trace =
+      strlen(FLAG_name) > 0 ? FLAG_name : webrtc::ExecutableName(argv[0]);
+  const int result =
+      webrtc::Run(trace, std::vector<std::string>(argv + 1, argv + argc));
+  if (result == 0 && strlen(FLAG_isolated_script_test_perf_output) > 0)
+    webrtc::test::WritePerfResults(FLAG_isolated_script_test_perf_output);
+  return result;
+}
@@ -0,0 +1,418 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "test/network_emulation.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+constexpr int64_t kNever = std::numeric_limits<int64_t>::max();
+
+}  // namespace
+
+int64_t EmulatedNetworkNode::Stats::DelayPercentileMs(
+    double percentile) const {
+  int64_t count = 0;
+  for (int64_t packets : delay_histogram_ms)
+    count += packets;
+  const int64_t rank = static_cast<int64_t>(count * percentile / 100);
+  int64_t seen = 0;
+  for (size_t delay_ms = 0; delay_ms < delay_histogram_ms.size(); ++delay_ms) {
+    seen += delay_histogram_ms[delay_ms];
+    if (seen > rank)
+      return delay_ms;
+  }
+  return max_delay_ms;
+}
+
+EmulatedNetworkNode::EmulatedNetworkNode(
+    NetworkEmulation* emulation,
+    std::unique_ptr<NetworkSimulationInterface> network)
+    : emulation_(emulation),
+      network_(std::move(network)),
+      scheduled_process_time_us_(kNever) {}
+
+EmulatedNetworkNode::~EmulatedNetworkNode() = default;
+
+void EmulatedNetworkNode::OnPacketReceived(EmulatedPacket packet) {
+  RTC_DCHECK(emulation_->IsCurrent());
+  ++stats_.packets_received;
+  const int to = packet.to_endpoint_id;
+  if (to < 0 || static_cast<size_t>(to) >= routing_.size() || !routing_[to]) {
+    ++stats_.packets_dropped;
+    return;
+  }
+  const uint64_t packet_id = first_packet_id_ + packets_.size();
+  if (!network_->EnqueuePacket(PacketInFlightInfo(
+          packet.size, packet.arrival_time_us, packet_id))) {
+    ++stats_.packets_dropped;
+    return;
+  }
+  packets_.push_back({std::move(packet)});
+  ++packets_in_flight_;
+  stats_.max_packets_in_flight =
+      std::max(stats_.max_packets_in_flight, packets_in_flight_);
+  ScheduleProcess();
+}
+
+EmulatedNetworkNode::Stats EmulatedNetworkNode::GetStats() const {
+  Stats stats;
+  emulation_->Invoke([this, &stats]() {
+    stats = stats_;
+    if (stats.packets_forwarded > 0) {
+      stats.mean_delay_ms =
+          total_delay_us_ / 1000.0 / stats.packets_forwarded;
+    }
+  });
+  return stats;
+}
+
+void EmulatedNetworkNode::ResetStats() {
+  emulation_->Invoke([this]() {
+    stats_ = Stats();
+    total_delay_us_ = 0;
+  });
+}
+
+void EmulatedNetworkNode::SetReceiver(
+    int endpoint_id,
+    EmulatedNetworkReceiverInterface* receiver) {
+  if (routing_.size() <= static_cast<size_t>(endpoint_id))
+    routing_.resize(endpoint_id + 1, nullptr);
+  RTC_CHECK(!routing_[endpoint_id] || routing_[endpoint_id] == receiver)
+      << "Routes to an endpoint can't diverge after a shared node.";
+  routing_[endpoint_id] = receiver;
+}
+
+void EmulatedNetworkNode::Process(int64_t time_us) {
+  if (time_us >= scheduled_process_time_us_)
+    scheduled_process_time_us_ = kNever;
+  for (const PacketDeliveryInfo& delivery :
+       network_->DequeueDeliverablePackets(time_us)) {
+    RTC_DCHECK_GE(delivery.packet_id, first_packet_id_);
+    StoredPacket& stored = packets_[delivery.packet_id - first_packet_id_];
+    RTC_DCHECK(!stored.removed);
+    stored.removed = true;
+    --packets_in_flight_;
+    EmulatedPacket packet = std::move(stored.packet);
+    while (!packets_.empty() && packets_.front().removed) {
+      packets_.pop_front();
+      ++first_packet_id_;
+    }
+
+    if (delivery.receive_time_us == PacketDeliveryInfo::kNotReceived) {
+      ++stats_.packets_lost;
+      continue;
+    }
+    const int64_t delay_us = delivery.receive_time_us - packet.arrival_time_us;
+    const size_t delay_ms = static_cast<size_t>(std::max<int64_t>(
+        (delay_us + rtc::kNumMicrosecsPerMillisec / 2) /
+            rtc::kNumMicrosecsPerMillisec,
+        0));
+    if (stats_.delay_histogram_ms.size() <= delay_ms)
+      stats_.delay_histogram_ms.resize(delay_ms + 1, 0);
+    ++stats_.delay_histogram_ms[delay_ms];
+    stats_.max_delay_ms =
+        std::max(stats_.max_delay_ms, static_cast<int64_t>(delay_ms));
+    total_delay_us_ += delay_us;
+    ++stats_.packets_forwarded;
+    stats_.bytes_forwarded += packet.size;
+
+    packet.arrival_time_us = delivery.receive_time_us;
+    EmulatedNetworkReceiverInterface* receiver =
+        routing_[packet.to_endpoint_id];
+    receiver->OnPacketReceived(std::move(packet));
+  }
+  ScheduleProcess();
+}
+
+void EmulatedNetworkNode::ScheduleProcess() {
+  const absl::optional<int64_t> next_time_us = network_->NextDeliveryTimeUs();
+  if (next_time_us && *next_time_us < scheduled_process_time_us_) {
+    scheduled_process_time_us_ = *next_time_us;
+    emulation_->PostEvent(*next_time_us, this, nullptr);
+  }
+}
+
+EmulatedEndpoint::EmulatedEndpoint(NetworkEmulation* emulation, int id)
+    : emulation_(emulation), id_(id), receiver_(this) {}
+
+void EmulatedEndpoint::SendPacket(const EmulatedEndpoint* to,
+                                  size_t size,
+                                  rtc::CopyOnWriteBuffer payload,
+                                  uint64_t sequence_number) {
+  EmulatedPacket packet;
+  packet.from_endpoint_id = id_;
+  packet.to_endpoint_id = to->id();
+  packet.size = size;
+  packet.payload = std::move(payload);
+  packet.send_time_us = emulation_->NowUs();
+  packet.arrival_time_us = packet.send_time_us;
+  packet.sequence_number = sequence_number;
+  emulation_->SendPacket(std::move(packet));
+}
+
+void EmulatedEndpoint::SetReceiver(EmulatedNetworkReceiverInterface* receiver) {
+  packet_receiver_ = receiver;
+}
+
+EmulatedEndpoint::Stats EmulatedEndpoint::GetStats(
+    const EmulatedEndpoint* from) const {
+  Stats stats;
+  emulation_->Invoke([this, from, &stats]() {
+    if (static_cast<size_t>(from->id()) < stats_.size())
+      stats = stats_[from->id()];
+  });
+  return stats;
+}
+
+void EmulatedEndpoint::ResetStats() {
+  emulation_->Invoke([this]() { stats_.assign(stats_.size(), Stats()); });
+}
+
+void EmulatedEndpoint::Receiver::OnPacketReceived(EmulatedPacket packet) {
+  RTC_DCHECK(endpoint_->emulation_->IsCurrent());
+  const size_t from = packet.from_endpoint_id;
+  if (endpoint_->stats_.size() <= from)
+    endpoint_->stats_.resize(from + 1);
+  Stats& stats = endpoint_->stats_[from];
+  ++stats.packets_received;
+  stats.bytes_received += packet.size;
+  const int64_t delay_us = packet.arrival_time_us - packet.send_time_us;
+  stats.total_delay_us += delay_us;
+  stats.max_delay_us = std::max(stats.max_delay_us, delay_us);
+  if (stats.first_packet_time_us < 0)
+    stats.first_packet_time_us = packet.arrival_time_us;
+  stats.last_packet_time_us = packet.arrival_time_us;
+  if (endpoint_->packet_receiver_)
+    endpoint_->packet_receiver_->OnPacketReceived(std::move(packet));
+}
+
+NetworkEmulation::NetworkEmulation()
+    : now_us_(rtc::TimeMicros()), next_wakeup_us_(kNever) {}
+
+NetworkEmulation::~NetworkEmulation() {
+  // Stop the task queue before the nodes and endpoints its tasks use go away.
+  task_queue_.reset();
+}
+
+EmulatedNetworkNode* NetworkEmulation::CreateNode(
+    const SimulatedNetwork::Config& config) {
+  return CreateNode(absl::make_unique<SimulatedNetwork>(
+      config, /*random_seed=*/nodes_.size() + 1));
+}
+
+EmulatedNetworkNode* NetworkEmulation::CreateNode(
+    std::unique_ptr<NetworkSimulationInterface> network) {
+  RTC_DCHECK(!task_queue_);
+  nodes_.push_back(
+      absl::make_unique<EmulatedNetworkNode>(this, std::move(network)));
+  return nodes_.back().get();
+}
+
+EmulatedEndpoint* NetworkEmulation::CreateEndpoint() {
+  RTC_DCHECK(!task_queue_);
+  endpoints_.emplace_back(new EmulatedEndpoint(this, endpoints_.size()));
+  return endpoints_.back().get();
+}
+
+void NetworkEmulation::CreateRoute(EmulatedEndpoint* from,
+                                   const std::vector<EmulatedNetworkNode*>& via,
+                                   EmulatedEndpoint* to) {
+  RTC_DCHECK(!task_queue_);
+  EmulatedNetworkReceiverInterface* next = &to->receiver_;
+  for (auto node = via.rbegin(); node != via.rend(); ++node) {
+    (*node)->SetReceiver(to->id(), next);
+    next = *node;
+  }
+  if (from->routing_.size() <= static_cast<size_t>(to->id()))
+    from->routing_.resize(to->id() + 1, nullptr);
+  from->routing_[to->id()] = next;
+}
+
+void NetworkEmulation::PostTaskAt(int64_t time_us, std::function<void()> task) {
+  RTC_DCHECK(task);
+  PostEvent(time_us, nullptr, std::move(task));
+}
+
+int64_t NetworkEmulation::NowUs() const {
+  return task_queue_ ? rtc::TimeMicros() : now_us_;
+}
+
+void NetworkEmulation::RunFor(int64_t duration_us) {
+  RTC_DCHECK(!task_queue_);
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  const int64_t end_time_us = now_us_ + duration_us;
+  ProcessEvents(end_time_us);
+  now_us_ = end_time_us;
+}
+
+void NetworkEmulation::Start() {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  RTC_DCHECK(!task_queue_);
+  task_queue_ = absl::make_unique<rtc::TaskQueue>("NetworkEmulation");
+  task_queue_->PostTask([this]() { ProcessOnTaskQueue(); });
+}
+
+double NetworkEmulation::FairnessIndex(const std::vector<double>& throughputs) {
+  double sum = 0.0;
+  double sum_of_squares = 0.0;
+  for (double throughput : throughputs) {
+    sum += throughput;
+    sum_of_squares += throughput * throughput;
+  }
+  if (sum_of_squares == 0.0)
+    return 1.0;
+  return sum * sum / (throughputs.size() * sum_of_squares);
+}
+
+bool NetworkEmulation::IsCurrent() const {
+  return task_queue_ ? task_queue_->IsCurrent()
+                     : thread_checker_.CalledOnValidThread();
+}
+
+void NetworkEmulation::Invoke(std::function<void()> task) {
+  if (IsCurrent() || !task_queue_) {
+    task();
+    return;
+  }
+  rtc::Event done(false, false);
+  task_queue_->PostTask([&task, &done]() {
+    task();
+    done.Set();
+  });
+  done.Wait(rtc::Event::kForever);
+}
+
+void NetworkEmulation::PostEvent(int64_t time_us,
+                                 EmulatedNetworkNode* node,
+                                 std::function<void()> task) {
+  if (task_queue_ && !task_queue_->IsCurrent()) {
+    // Capture by a copy; the closure may outlive this call.
+    task_queue_->PostTask([this, time_us, node, task]() {
+      PostEvent(time_us, node, task);
+    });
+    return;
+  }
+  RTC_DCHECK(IsCurrent());
+  events_.push_back(
+      {time_us, next_event_sequence_number_++, node, std::move(task)});
+  std::push_heap(events_.begin(), events_.end(), std::greater<Event>());
+  if (task_queue_ && !processing_events_ && time_us < next_wakeup_us_) {
+    // Outside of ProcessEvents(), which reschedules when it is done.
+    next_wakeup_us_ = time_us;
+    task_queue_->PostTask([this]() { ProcessOnTaskQueue(); });
+  }
+}
+
+void NetworkEmulation::SendPacket(EmulatedPacket packet) {
+  if (task_queue_ && !task_queue_->IsCurrent()) {
+    // Packets from Calls, which send on their own threads.
+    task_queue_->PostTask([this, packet]() { SendPacket(packet); });
+    return;
+  }
+  RTC_DCHECK(IsCurrent());
+  const EmulatedEndpoint* from = endpoints_[packet.from_endpoint_id].get();
+  const size_t to = packet.to_endpoint_id;
+  RTC_CHECK(to < from->routing_.size() && from->routing_[to])
+      << "No route from endpoint " << from->id() << " to endpoint " << to;
+  from->routing_[to]->OnPacketReceived(std::move(packet));
+}
+
+void NetworkEmulation::ProcessEvents(int64_t time_us) {
+  processing_events_ = true;
+  while (!events_.empty() && events_.front().time_us <= time_us) {
+    std::pop_heap(events_.begin(), events_.end(), std::greater<Event>());
+    Event event = std::move(events_.back());
+    events_.pop_back();
+    now_us_ = std::max(now_us_, event.time_us);
+    if (event.node) {
+      event.node->Process(event.time_us);
+    } else {
+      event.task();
+    }
+  }
+  processing_events_ = false;
+}
+
+void NetworkEmulation::ProcessOnTaskQueue() {
+  RTC_DCHECK(task_queue_->IsCurrent());
+  const int64_t now_us = rtc::TimeMicros();
+  if (now_us >= next_wakeup_us_)
+    next_wakeup_us_ = kNever;
+  ProcessEvents(now_us);
+  if (events_.empty() || events_.front().time_us >= next_wakeup_us_)
+    return;
+  // Task queues have millisecond resolution, so wake up at the first
+  // millisecond boundary at which the next event is due.
+  const int64_t delay_ms =
+      (std::max<int64_t>(events_.front().time_us - now_us, 0) +
+       rtc::kNumMicrosecsPerMillisec - 1) /
+      rtc::kNumMicrosecsPerMillisec;
+  next_wakeup_us_ = now_us + delay_ms * rtc::kNumMicrosecsPerMillisec;
+  task_queue_->PostDelayedTask([this]() { ProcessOnTaskQueue(); },
+                               static_cast<uint32_t>(delay_ms));
+}
+
+EmulatedCallTransport::EmulatedCallTransport(EmulatedEndpoint* local,
+                                             const EmulatedEndpoint* remote,
+                                             Call* send_call)
+    : local_(local), remote_(remote), send_call_(send_call) {
+  if (send_call_) {
+    send_call_->SignalChannelNetworkState(MediaType::AUDIO, kNetworkUp);
+    send_call_->SignalChannelNetworkState(MediaType::VIDEO, kNetworkUp);
+  }
+}
+
+EmulatedCallTransport::~EmulatedCallTransport() = default;
+
+bool EmulatedCallTransport::SendRtp(const uint8_t* packet,
+                                    size_t length,
+                                    const PacketOptions& options) {
+  if (send_call_) {
+    send_call_->OnSentPacket(
+        rtc::SentPacket(options.packet_id, rtc::TimeMillis()));
+  }
+  local_->SendPacket(remote_, length, rtc::CopyOnWriteBuffer(packet, length),
+                     0);
+  return true;
+}
+
+bool EmulatedCallTransport::SendRtcp(const uint8_t* packet, size_t length) {
+  local_->SendPacket(remote_, length, rtc::CopyOnWriteBuffer(packet, length),
+                     0);
+  return true;
+}
+
+EmulatedPacketReceiver::EmulatedPacketReceiver(PacketReceiver* receiver)
+    : receiver_(receiver) {}
+
+EmulatedPacketReceiver::~EmulatedPacketReceiver() = default;
+
+void EmulatedPacketReceiver::OnPacketReceived(EmulatedPacket packet) {
+  // Cross traffic sharing the endpoint has no payload.
+  if (packet.payload.size() == 0)
+    return;
+  receiver_->DeliverPacket(MediaType::ANY, std::move(packet.payload),
+                           packet.arrival_time_us);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,317 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef TEST_NETWORK_EMULATION_H_
+#define TEST_NETWORK_EMULATION_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "api/call/transport.h"
+#include "api/test/simulated_network.h"
+#include "call/call.h"
+#include "call/simulated_network.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_checker.h"
+
+namespace webrtc {
+namespace test {
+
+class EmulatedEndpoint;
+class NetworkEmulation;
+
+// A packet travelling between two endpoints of a NetworkEmulation. Cross
+// traffic has no payload, only a size.
+struct EmulatedPacket {
+  int from_endpoint_id = -1;
+  int to_endpoint_id = -1;
+  size_t size = 0;
+  rtc::CopyOnWriteBuffer payload;
+  // The time the packet left its sender, and the time it arrived at the node
+  // or endpoint it is at.
+  int64_t send_time_us = 0;
+  int64_t arrival_time_us = 0;
+  // For models of transport protocols, like TcpCrossTraffic.
+  uint64_t sequence_number = 0;
+};
+
+class EmulatedNetworkReceiverInterface {
+ public:
+  virtual ~EmulatedNetworkReceiverInterface() = default;
+  // Called on the sequence of the NetworkEmulation.
+  virtual void OnPacketReceived(EmulatedPacket packet) = 0;
+};
+
+// A node of the emulated network: a link with a queue, delay and loss, as
+// modelled by a NetworkSimulationInterface, followed by a routing table that
+// forwards the packets leaving the link to the next node or endpoint on their
+// way. Routes of many flows may share a node, which makes it their shared
+// bottleneck.
+class EmulatedNetworkNode : public EmulatedNetworkReceiverInterface {
+ public:
+  struct Stats {
+    int64_t packets_received = 0;
+    int64_t packets_forwarded = 0;
+    int64_t bytes_forwarded = 0;
+    // Packets that didn't fit in the queue, and packets lost on the link.
+    int64_t packets_dropped = 0;
+    int64_t packets_lost = 0;
+    size_t max_packets_in_flight = 0;
+    // Time from entering to leaving the node, i.e. queueing, capacity and
+    // propagation delay, of the forwarded packets.
+    double mean_delay_ms = 0.0;
+    int64_t max_delay_ms = 0;
+    // Returns the delay, in whole milliseconds, which |percentile| percent of
+    // the forwarded packets didn't exceed.
+    int64_t DelayPercentileMs(double percentile) const;
+    // Number of packets per delay in milliseconds.
+    std::vector<int64_t> delay_histogram_ms;
+  };
+
+  EmulatedNetworkNode(NetworkEmulation* emulation,
+                      std::unique_ptr<NetworkSimulationInterface> network);
+  ~EmulatedNetworkNode() override;
+
+  // Enqueues |packet| on the link. Packets to an endpoint without a route
+  // through this node are dropped.
+  void OnPacketReceived(EmulatedPacket packet) override;
+
+  // May be called on any thread.
+  Stats GetStats() const;
+  void ResetStats();
+
+ private:
+  friend class NetworkEmulation;
+
+  struct StoredPacket {
+    EmulatedPacket packet;
+    bool removed = false;
+  };
+
+  void SetReceiver(int endpoint_id, EmulatedNetworkReceiverInterface* receiver);
+  // Forwards the packets which have passed the link by |time_us|.
+  void Process(int64_t time_us);
+  void ScheduleProcess();
+
+  NetworkEmulation* const emulation_;
+  const std::unique_ptr<NetworkSimulationInterface> network_;
+  // Indexed by endpoint id.
+  std::vector<EmulatedNetworkReceiverInterface*> routing_;
+  // The packets on the link, by packet id - |first_packet_id_|. Packets are
+  // mostly delivered in order, so removed packets are popped off the front.
+  std::deque<StoredPacket> packets_;
+  uint64_t first_packet_id_ = 0;
+  size_t packets_in_flight_ = 0;
+  // The time of the earliest pending Process() call.
+  int64_t scheduled_process_time_us_;
+  Stats stats_;
+  int64_t total_delay_us_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(EmulatedNetworkNode);
+};
+
+// A host attached to the emulated network. Packets sent from it follow the
+// route that NetworkEmulation::CreateRoute() set up to their destination.
+class EmulatedEndpoint {
+ public:
+  struct Stats {
+    int64_t packets_received = 0;
+    int64_t bytes_received = 0;
+    // One-way delay from the sender.
+    int64_t total_delay_us = 0;
+    int64_t max_delay_us = 0;
+    int64_t first_packet_time_us = -1;
+    int64_t last_packet_time_us = -1;
+  };
+
+  int id() const { return id_; }
+
+  // Sends |size| bytes to |to|. |payload| may be empty for cross traffic.
+  // May be called on any thread while the emulation runs on its task queue.
+  void SendPacket(const EmulatedEndpoint* to,
+                  size_t size,
+                  rtc::CopyOnWriteBuffer payload,
+                  uint64_t sequence_number);
+
+  // Packets arriving at this endpoint are passed to |receiver|. Must be
+  // called before the emulation runs.
+  void SetReceiver(EmulatedNetworkReceiverInterface* receiver);
+
+  // Statistics of the packets received from |from|. May be called on any
+  // thread.
+  Stats GetStats(const EmulatedEndpoint* from) const;
+  void ResetStats();
+
+ private:
+  friend class NetworkEmulation;
+
+  class Receiver : public EmulatedNetworkReceiverInterface {
+   public:
+    explicit Receiver(EmulatedEndpoint* endpoint) : endpoint_(endpoint) {}
+    void OnPacketReceived(EmulatedPacket packet) override;
+
+   private:
+    EmulatedEndpoint* const endpoint_;
+  };
+
+  EmulatedEndpoint(NetworkEmulation* emulation, int id);
+
+  NetworkEmulation* const emulation_;
+  const int id_;
+  Receiver receiver_;
+  EmulatedNetworkReceiverInterface* packet_receiver_ = nullptr;
+  // The first hop towards each endpoint, indexed by endpoint id.
+  std::vector<EmulatedNetworkReceiverInterface*> routing_;
+  // Indexed by the id of the sending endpoint.
+  std::vector<Stats> stats_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(EmulatedEndpoint);
+};
+
+// Emulates a network of endpoints and nodes as a discrete event simulation,
+// for studying congestion control and queueing of many flows sharing a
+// bottleneck, e.g. the calls of an SFU competing with TCP cross traffic.
+//
+// Without Start(), the emulation has its own clock, which only advances in
+// RunFor(), as fast as the events can be processed; this suits models that
+// are driven by the emulation, like the ones of test/cross_traffic.h, and
+// simulates hundreds of flows faster than real time. After Start(), events
+// are processed on a task queue as rtc::TimeMicros() reaches them, so that
+// Calls, which send on threads of their own, can be routed through the
+// emulation; with rtc::VirtualTimeController that is fast as well.
+//
+// Nodes, endpoints and routes must be created before the emulation runs.
+class NetworkEmulation {
+ public:
+  NetworkEmulation();
+  ~NetworkEmulation();
+
+  // The emulation owns the nodes and endpoints it creates.
+  EmulatedNetworkNode* CreateNode(const SimulatedNetwork::Config& config);
+  EmulatedNetworkNode* CreateNode(
+      std::unique_ptr<NetworkSimulationInterface> network);
+  EmulatedEndpoint* CreateEndpoint();
+
+  // Packets from |from| to |to| pass |via| in order. A node may be part of
+  // any number of routes.
+  void CreateRoute(EmulatedEndpoint* from,
+                   const std::vector<EmulatedNetworkNode*>& via,
+                   EmulatedEndpoint* to);
+
+  // Runs |task| at |time_us| on the emulation's sequence; for models driven
+  // by the emulation.
+  void PostTaskAt(int64_t time_us, std::function<void()> task);
+
+  int64_t NowUs() const;
+
+  // Runs |task| on the emulation's sequence and waits for it, e.g. to read
+  // the state of models while the emulation runs on its task queue.
+  void Invoke(std::function<void()> task);
+
+  // Processes the events of the next |duration_us|. Not allowed after
+  // Start().
+  void RunFor(int64_t duration_us);
+
+  // Processes events on a task queue from now on, until the emulation is
+  // destroyed.
+  void Start();
+
+  // Jain's fairness index of |throughputs|, between 1 / size for one flow
+  // getting everything and 1 for equal shares.
+  static double FairnessIndex(const std::vector<double>& throughputs);
+
+ private:
+  friend class EmulatedEndpoint;
+  friend class EmulatedNetworkNode;
+
+  struct Event {
+    int64_t time_us;
+    // Breaks ties in the order the events were posted.
+    uint64_t sequence_number;
+    // Either a node to process or a task.
+    EmulatedNetworkNode* node;
+    std::function<void()> task;
+
+    bool operator>(const Event& other) const {
+      return time_us != other.time_us ? time_us > other.time_us
+                                      : sequence_number > other.sequence_number;
+    }
+  };
+
+  bool IsCurrent() const;
+  void PostEvent(int64_t time_us,
+                 EmulatedNetworkNode* node,
+                 std::function<void()> task);
+  void SendPacket(EmulatedPacket packet);
+  // Processes the events due by |time_us|.
+  void ProcessEvents(int64_t time_us);
+  // Processes the events due now and schedules the task queue to wake up for
+  // the next one.
+  void ProcessOnTaskQueue();
+
+  rtc::ThreadChecker thread_checker_;
+  std::vector<std::unique_ptr<EmulatedNetworkNode>> nodes_;
+  std::vector<std::unique_ptr<EmulatedEndpoint>> endpoints_;
+  // A min-heap on the event times.
+  std::vector<Event> events_;
+  uint64_t next_event_sequence_number_ = 0;
+  int64_t now_us_;
+  bool processing_events_ = false;
+  // The earliest time the task queue is scheduled to wake up.
+  int64_t next_wakeup_us_;
+  // Declared last, so that no task runs while the members are destroyed.
+  std::unique_ptr<rtc::TaskQueue> task_queue_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetworkEmulation);
+};
+
+// Sends the packets of a Call from |local| to |remote|, like DirectTransport,
+// and, if |send_call| isn't null, reports them to it as sent.
+class EmulatedCallTransport : public Transport {
+ public:
+  EmulatedCallTransport(EmulatedEndpoint* local,
+                        const EmulatedEndpoint* remote,
+                        Call* send_call);
+  ~EmulatedCallTransport() override;
+
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override;
+  bool SendRtcp(const uint8_t* packet, size_t length) override;
+
+ private:
+  EmulatedEndpoint* const local_;
+  const EmulatedEndpoint* const remote_;
+  Call* const send_call_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(EmulatedCallTransport);
+};
+
+// Delivers the packets arriving at an endpoint to a PacketReceiver, such as
+// Call::Receiver(), on the sequence of the emulation.
+class EmulatedPacketReceiver : public EmulatedNetworkReceiverInterface {
+ public:
+  explicit EmulatedPacketReceiver(PacketReceiver* receiver);
+  ~EmulatedPacketReceiver() override;
+
+  void OnPacketReceived(EmulatedPacket packet) override;
+
+ private:
+  PacketReceiver* const receiver_;
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_NETWORK_EMULATION_H_
@@ -0,0 +1,271 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "test/network_emulation.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "rtc_base/event.h"
+#include "rtc_base/timeutils.h"
+#include "test/cross_traffic.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+constexpr int64_t kUsPerMs = rtc::kNumMicrosecsPerMillisec;
+constexpr int64_t kUsPerSec = rtc::kNumMicrosecsPerSec;
+
+class ArrivalRecorder : public EmulatedNetworkReceiverInterface {
+ public:
+  void OnPacketReceived(EmulatedPacket packet) override {
+    arrival_times_us.push_back(packet.arrival_time_us - packet.send_time_us);
+  }
+  std::vector<int64_t> arrival_times_us;
+};
+
+SimulatedNetwork::Config LinkConfig(int delay_ms, int capacity_kbps) {
+  SimulatedNetwork::Config config;
+  config.queue_delay_ms = delay_ms;
+  config.link_capacity_kbps = capacity_kbps;
+  return config;
+}
+
+}  // namespace
+
+TEST(NetworkEmulationTest, AppliesDelayAndCapacityOfLink) {
+  NetworkEmulation emulation;
+  EmulatedNetworkNode* link = emulation.CreateNode(LinkConfig(50, 1000));
+  EmulatedEndpoint* sender = emulation.CreateEndpoint();
+  EmulatedEndpoint* receiver = emulation.CreateEndpoint();
+  emulation.CreateRoute(sender, {link}, receiver);
+  ArrivalRecorder recorder;
+  receiver->SetReceiver(&recorder);
+
+  // At 1000 kbps, 1250 bytes take 10 ms.
+  for (int i = 0; i < 10; ++i)
+    sender->SendPacket(receiver, 1250, rtc::CopyOnWriteBuffer(), i);
+  emulation.RunFor(kUsPerSec);
+
+  ASSERT_EQ(10u, recorder.arrival_times_us.size());
+  EXPECT_NEAR(60 * kUsPerMs, recorder.arrival_times_us.front(), kUsPerMs);
+  EXPECT_NEAR(150 * kUsPerMs, recorder.arrival_times_us.back(), kUsPerMs);
+  EmulatedNetworkNode::Stats stats = link->GetStats();
+  EXPECT_EQ(10, stats.packets_forwarded);
+  EXPECT_EQ(12500, stats.bytes_forwarded);
+  EXPECT_EQ(150, stats.max_delay_ms);
+  EXPECT_EQ(10u, stats.max_packets_in_flight);
+  EmulatedEndpoint::Stats endpoint_stats = receiver->GetStats(sender);
+  EXPECT_EQ(10, endpoint_stats.packets_received);
+  EXPECT_EQ(150 * kUsPerMs, endpoint_stats.max_delay_us);
+}
+
+TEST(NetworkEmulationTest, RoutesFlowsThroughSharedBottleneck) {
+  NetworkEmulation emulation;
+  EmulatedNetworkNode* access_a = emulation.CreateNode(LinkConfig(10, 0));
+  EmulatedNetworkNode* access_b = emulation.CreateNode(LinkConfig(15, 0));
+  EmulatedNetworkNode* bottleneck = emulation.CreateNode(LinkConfig(5, 1000));
+  EmulatedEndpoint* sender_a = emulation.CreateEndpoint();
+  EmulatedEndpoint* sender_b = emulation.CreateEndpoint();
+  EmulatedEndpoint* receiver = emulation.CreateEndpoint();
+  emulation.CreateRoute(sender_a, {access_a, bottleneck}, receiver);
+  emulation.CreateRoute(sender_b, {access_b, bottleneck}, receiver);
+
+  sender_a->SendPacket(receiver, 1250, rtc::CopyOnWriteBuffer(), 0);
+  sender_b->SendPacket(receiver, 1250, rtc::CopyOnWriteBuffer(), 0);
+  emulation.RunFor(kUsPerSec);
+
+  EXPECT_EQ(2, bottleneck->GetStats().packets_forwarded);
+  EmulatedEndpoint::Stats stats_a = receiver->GetStats(sender_a);
+  EmulatedEndpoint::Stats stats_b = receiver->GetStats(sender_b);
+  EXPECT_EQ(1, stats_a.packets_received);
+  EXPECT_EQ(1, stats_b.packets_received);
+  // 10 ms access delay, 10 ms to pass the bottleneck and 5 ms delay.
+  EXPECT_NEAR(25 * kUsPerMs, stats_a.max_delay_us, kUsPerMs);
+  // Queued for 5 ms behind the packet of |sender_a|.
+  EXPECT_NEAR(35 * kUsPerMs, stats_b.max_delay_us, kUsPerMs);
+}
+
+TEST(NetworkEmulationTest, CountsLostPackets) {
+  NetworkEmulation emulation;
+  SimulatedNetwork::Config config = LinkConfig(10, 0);
+  config.loss_percent = 10;
+  EmulatedNetworkNode* link = emulation.CreateNode(config);
+  EmulatedEndpoint* sender = emulation.CreateEndpoint();
+  EmulatedEndpoint* receiver = emulation.CreateEndpoint();
+  emulation.CreateRoute(sender, {link}, receiver);
+
+  for (int i = 0; i < 1000; ++i) {
+    sender->SendPacket(receiver, 100, rtc::CopyOnWriteBuffer(), i);
+    emulation.RunFor(kUsPerMs);
+  }
+  emulation.RunFor(kUsPerSec);
+
+  EmulatedNetworkNode::Stats stats = link->GetStats();
+  EXPECT_EQ(1000, stats.packets_received);
+  EXPECT_EQ(1000, stats.packets_forwarded + stats.packets_lost);
+  EXPECT_NEAR(100, stats.packets_lost, 40);
+  EXPECT_EQ(stats.packets_forwarded,
+            receiver->GetStats(sender).packets_received);
+}
+
+TEST(NetworkEmulationTest, DropsPacketsThatDontFitInQueue) {
+  NetworkEmulation emulation;
+  SimulatedNetwork::Config config = LinkConfig(0, 100);
+  config.queue_length_packets = 5;
+  EmulatedNetworkNode* link = emulation.CreateNode(config);
+  EmulatedEndpoint* sender = emulation.CreateEndpoint();
+  EmulatedEndpoint* receiver = emulation.CreateEndpoint();
+  emulation.CreateRoute(sender, {link}, receiver);
+
+  for (int i = 0; i < 20; ++i)
+    sender->SendPacket(receiver, 1000, rtc::CopyOnWriteBuffer(), i);
+  emulation.RunFor(10 * kUsPerSec);
+
+  EmulatedNetworkNode::Stats stats = link->GetStats();
+  EXPECT_GT(stats.packets_dropped, 0);
+  EXPECT_EQ(20, stats.packets_forwarded + stats.packets_dropped);
+}
+
+// Both flows share a 10 Mbps bottleneck with 40 ms round trip time.
+TEST(NetworkEmulationTest, TcpFlowsShareBottleneckFairly) {
+  NetworkEmulation emulation;
+  SimulatedNetwork::Config config = LinkConfig(20, 10000);
+  config.queue_length_packets = 50;
+  EmulatedNetworkNode* bottleneck = emulation.CreateNode(config);
+  EmulatedNetworkNode* reverse = emulation.CreateNode(LinkConfig(20, 0));
+  std::vector<EmulatedEndpoint*> senders;
+  std::vector<EmulatedEndpoint*> receivers;
+  std::vector<std::unique_ptr<TcpCrossTraffic>> flows;
+  for (int i = 0; i < 2; ++i) {
+    senders.push_back(emulation.CreateEndpoint());
+    receivers.push_back(emulation.CreateEndpoint());
+    emulation.CreateRoute(senders[i], {bottleneck}, receivers[i]);
+    emulation.CreateRoute(receivers[i], {reverse}, senders[i]);
+    flows.push_back(absl::make_unique<TcpCrossTraffic>(
+        &emulation, senders[i], receivers[i], TcpCrossTraffic::Config()));
+  }
+  for (auto& flow : flows)
+    flow->Start();
+  emulation.RunFor(5 * kUsPerSec);
+  bottleneck->ResetStats();
+  for (EmulatedEndpoint* receiver : receivers)
+    receiver->ResetStats();
+  emulation.RunFor(20 * kUsPerSec);
+
+  std::vector<double> throughputs;
+  double total_kbps = 0.0;
+  for (int i = 0; i < 2; ++i) {
+    const double kbps =
+        receivers[i]->GetStats(senders[i]).bytes_received * 8.0 / 20 / 1000;
+    throughputs.push_back(kbps);
+    total_kbps += kbps;
+    EXPECT_GT(flows[i]->GetStats().packets_lost, 0);
+    EXPECT_GE(flows[i]->GetStats().smoothed_rtt_ms, 40);
+  }
+  EXPECT_GT(total_kbps, 0.85 * 10000);
+  EXPECT_LE(total_kbps, 10000);
+  EXPECT_GT(NetworkEmulation::FairnessIndex(throughputs), 0.9);
+  // The queue fills up until packets are dropped.
+  EXPECT_GT(bottleneck->GetStats().DelayPercentileMs(95), 40);
+}
+
+TEST(NetworkEmulationTest, SimulatesHundredTcpFlows) {
+  constexpr int kNumFlows = 100;
+  NetworkEmulation emulation;
+  SimulatedNetwork::Config config = LinkConfig(20, 100000);
+  config.queue_length_packets = 500;
+  EmulatedNetworkNode* bottleneck = emulation.CreateNode(config);
+  EmulatedNetworkNode* reverse = emulation.CreateNode(LinkConfig(20, 0));
+  std::vector<EmulatedEndpoint*> senders;
+  std::vector<EmulatedEndpoint*> receivers;
+  std::vector<std::unique_ptr<TcpCrossTraffic>> flows;
+  for (int i = 0; i < kNumFlows; ++i) {
+    senders.push_back(emulation.CreateEndpoint());
+    receivers.push_back(emulation.CreateEndpoint());
+    emulation.CreateRoute(senders[i], {bottleneck}, receivers[i]);
+    emulation.CreateRoute(receivers[i], {reverse}, senders[i]);
+    flows.push_back(absl::make_unique<TcpCrossTraffic>(
+        &emulation, senders[i], receivers[i], TcpCrossTraffic::Config()));
+    flows.back()->Start();
+  }
+  const int64_t start_time_us = rtc::TimeMicros();
+  emulation.RunFor(10 * kUsPerSec);
+  const int64_t elapsed_us = rtc::TimeMicros() - start_time_us;
+
+  std::vector<double> throughputs;
+  for (int i = 0; i < kNumFlows; ++i) {
+    const int64_t bytes = receivers[i]->GetStats(senders[i]).bytes_received;
+    EXPECT_GT(bytes, 0);
+    throughputs.push_back(bytes);
+  }
+  EXPECT_GT(bottleneck->GetStats().bytes_forwarded * 8 / 10,
+            0.8 * 100000 * 1000);
+  EXPECT_GT(NetworkEmulation::FairnessIndex(throughputs), 0.5);
+  // Far faster than real time even in debug builds.
+  EXPECT_LT(elapsed_us, 10 * kUsPerSec);
+}
+
+TEST(NetworkEmulationTest, OnOffTrafficSendsAtRateWhileOn) {
+  NetworkEmulation emulation;
+  EmulatedNetworkNode* link = emulation.CreateNode(LinkConfig(10, 0));
+  EmulatedEndpoint* sender = emulation.CreateEndpoint();
+  EmulatedEndpoint* receiver = emulation.CreateEndpoint();
+  emulation.CreateRoute(sender, {link}, receiver);
+  OnOffCrossTraffic::Config config;
+  config.rate_kbps = 960;
+  config.packet_size = 1200;
+  config.on_ms = 100;
+  config.off_ms = 100;
+  OnOffCrossTraffic traffic(&emulation, sender, receiver, config);
+
+  traffic.Start();
+  emulation.RunFor(kUsPerSec);
+  traffic.Stop();
+  emulation.RunFor(kUsPerSec);
+
+  // 10 ms per packet while on, for half of the time.
+  EXPECT_NEAR(50, receiver->GetStats(sender).packets_received, 1);
+}
+
+TEST(NetworkEmulationTest, DeliversPacketsSentFromOtherThreads) {
+  NetworkEmulation emulation;
+  EmulatedNetworkNode* link = emulation.CreateNode(LinkConfig(10, 0));
+  EmulatedEndpoint* sender = emulation.CreateEndpoint();
+  EmulatedEndpoint* receiver = emulation.CreateEndpoint();
+  emulation.CreateRoute(sender, {link}, receiver);
+  class Receiver : public EmulatedNetworkReceiverInterface {
+   public:
+    void OnPacketReceived(EmulatedPacket packet) override {
+      payload = packet.payload;
+      received.Set();
+    }
+    rtc::Event received{false, false};
+    rtc::CopyOnWriteBuffer payload;
+  } packet_receiver;
+  receiver->SetReceiver(&packet_receiver);
+  emulation.Start();
+
+  const uint8_t kPayload[] = {1, 2, 3};
+  const int64_t send_time_ms = rtc::TimeMillis();
+  sender->SendPacket(receiver, sizeof(kPayload),
+                     rtc::CopyOnWriteBuffer(kPayload, sizeof(kPayload)), 0);
+  ASSERT_TRUE(packet_receiver.received.Wait(1000));
+  EXPECT_GE(rtc::TimeMillis() - send_time_ms, 10);
+  EXPECT_EQ(rtc::CopyOnWriteBuffer(kPayload, sizeof(kPayload)),
+            packet_receiver.payload);
+  EXPECT_EQ(1, link->GetStats().packets_forwarded);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -32,11 +32,14 @@ absl::optional<VideoFrame> VideoCapturer::AdaptFrame(const VideoFrame& frame) {
 
   absl::optional<VideoFrame> out_frame;
   if (out_height != frame.height() || out_width != frame.width()) {
-    // Video adapter has requested a down-scale. Allocate a new buffer and
-    // return scaled version.
-    rtc::scoped_refptr<I420Buffer> scaled_buffer =
-        I420Buffer::Create(out_width, out_height);
-    scaled_buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
+    // Video adapter has requested a down-scale. Crop and scale the frame
+    // natively if its buffer supports it, e.g. on the GPU, and in NV12 for
+    // NV12 frames.
+    rtc::scoped_refptr<VideoFrameBuffer> scaled_buffer =
+        cricket::CropAndScaleFrameBuffer(
+            frame.video_frame_buffer(), (frame.width() - cropped_width) / 2,
+            (frame.height() - cropped_height) / 2, cropped_width,
+            cropped_height, out_width, out_height);
     out_frame.emplace(
         VideoFrame(scaled_buffer, kVideoRotation_0, frame.timestamp_us()));
   } else {
@@ -0,0 +1,393 @@
+#!/usr/bin/env python
+# Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+#
+# Use of this source code is governed by a BSD-style license
+# that can be found in the LICENSE file in the root of the source
+# tree. An additional intellectual property rights grant can be found
+# in the file PATENTS.  All contributing project authors may
+# be found in the AUTHORS file in the root of the source tree.
+
+"""
+Runs the native performance tests on a fixed machine profile and compares the
+results against a stored baseline.
+
+The tests are listed in a profile (see perf_regression_profile.json). Each one
+is run --repetitions times, pinned to the CPUs of the profile, and every run
+gives one sample per trace. Results are written in the chartjson format of
+test/testsupport/perf_test.h, with every trace a list of samples:
+
+  {
+    "format_version": "1.0",
+    "charts": {
+      <graph>: {
+        <trace>: {
+          "type": "list_of_scalar_values",
+          "values": [<one sample per run>],
+          "units": <units>,
+          "improvement_direction": "up" | "down"   (if known)
+        }
+      }
+    },
+    "machine": {<the machine profile the samples were taken on>}
+  }
+
+A file in this format can be used as the baseline of a later run. A trace has
+regressed when a Mann-Whitney U test says its samples differ from those of the
+baseline with p < significance_level, and its median has moved by more than
+min_relative_change in the direction that isn't its improvement direction.
+Traces without an improvement direction are reported, but never fail.
+
+Example:
+  perf_regression.py out/Release --output=new.json --baseline=baseline.json
+  perf_regression.py --compare new.json --baseline=baseline.json
+"""
+
+import argparse
+import json
+import logging
+import math
+import multiprocessing
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_PROFILE = os.path.join(SCRIPT_DIR, 'perf_regression_profile.json')
+
+# Machine properties that must match for results to be comparable.
+MACHINE_KEYS = ('profile', 'cpu_model', 'num_cpus', 'cpu_affinity',
+                'cpu_governor')
+
+
+def _ParseArgs(argv=None):
+  parser = argparse.ArgumentParser(
+      description='Run the native perf tests and compare with a baseline.')
+  parser.add_argument('build_dir', nargs='?',
+      help='Path to the build directory (e.g. out/Release).')
+  parser.add_argument('--profile', default=DEFAULT_PROFILE,
+      help='Machine and test profile. Default: %(default)s')
+  parser.add_argument('--repetitions', type=int, default=None,
+      help='Runs per test, overriding the profile.')
+  parser.add_argument('--filter', default=None,
+      help='Only run the tests with this name.')
+  parser.add_argument('--output', default=None,
+      help='Where to write the results.')
+  parser.add_argument('--baseline', default=None,
+      help='Results to compare with.')
+  parser.add_argument('--compare', default=None,
+      help='Compare these results with the baseline instead of running the '
+           'tests.')
+  parser.add_argument('--ignore-machine-mismatch', action='store_true',
+      help='Run and compare even if the machine does not match the profile '
+           'or the baseline.')
+  args = parser.parse_args(argv)
+  if not args.build_dir and not args.compare:
+    parser.error('Either build_dir or --compare is required.')
+  if args.compare and not args.baseline:
+    parser.error('--compare requires --baseline.')
+  return args
+
+
+def _ReadFile(path):
+  try:
+    with open(path) as f:
+      return f.read().strip()
+  except IOError:
+    return None
+
+
+def GetMachineProfile(profile):
+  """Describes the machine, for deciding whether results are comparable."""
+  cpu_model = platform.processor()
+  cpuinfo = _ReadFile('/proc/cpuinfo')
+  if cpuinfo:
+    for line in cpuinfo.splitlines():
+      if line.startswith('model name'):
+        cpu_model = line.split(':', 1)[1].strip()
+        break
+  return {
+      'profile': profile['name'],
+      'cpu_model': cpu_model,
+      'num_cpus': _NumCpus(),
+      'cpu_affinity': profile.get('cpu_affinity'),
+      'cpu_governor': _ReadFile(
+          '/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor'),
+      'os': platform.platform(),
+  }
+
+
+def _NumCpus():
+  try:
+    return multiprocessing.cpu_count()
+  except NotImplementedError:
+    return None
+
+
+def CheckMachineProfile(profile, machine):
+  """Returns an error message if the machine doesn't match the profile."""
+  governor = profile.get('cpu_governor')
+  if governor and machine['cpu_governor'] not in (None, governor):
+    return ('CPU frequency governor is %s, the profile needs %s.' %
+            (machine['cpu_governor'], governor))
+  num_cpus = profile.get('num_cpus')
+  if num_cpus and machine['num_cpus'] != num_cpus:
+    return ('Machine has %s CPUs, the profile needs %d.' %
+            (machine['num_cpus'], num_cpus))
+  return None
+
+
+def _AddSample(charts, graph, trace, value, units, improvement_direction):
+  result = charts.setdefault(graph, {}).setdefault(trace, {
+      'type': 'list_of_scalar_values',
+      'values': [],
+      'units': units,
+  })
+  if improvement_direction:
+    result['improvement_direction'] = improvement_direction
+  result['values'].append(value)
+
+
+def _ImprovementDirection(test, graph):
+  return test.get('improvement_directions', {}).get(graph)
+
+
+def AddChartJsonSamples(charts, test, chartjson):
+  """Adds one sample per trace of a perf_test.h chartjson result."""
+  for graph, traces in chartjson.get('charts', {}).items():
+    direction = _ImprovementDirection(test, graph)
+    for trace, result in traces.items():
+      if result['type'] == 'scalar':
+        value = result['value']
+      else:
+        # A list of values, e.g. one per stream, counts as their mean.
+        values = result['values']
+        if not values:
+          continue
+        value = sum(values) / float(len(values))
+      _AddSample(charts, graph, trace, value, result['units'], direction)
+
+
+def AddGoogleBenchmarkSamples(charts, test, benchmark_json):
+  """Adds the CPU time of each benchmark as a sample."""
+  for benchmark in benchmark_json.get('benchmarks', []):
+    # Mean, median and stddev entries of --benchmark_repetitions.
+    if benchmark.get('run_type') == 'aggregate':
+      continue
+    _AddSample(charts, 'benchmark_cpu_time', benchmark['name'],
+               benchmark['cpu_time'], benchmark.get('time_unit', 'ns'), 'down')
+
+
+def _RunTest(build_dir, profile, test, charts):
+  # Like on the bots, tests run from the build directory, so that paths to
+  # their data files are relative to it.
+  build_dir = os.path.abspath(build_dir)
+  binary = os.path.join(build_dir, test['binary'])
+  if sys.platform == 'win32':
+    binary += '.exe'
+  fd, output_file = tempfile.mkstemp(suffix='.json')
+  os.close(fd)
+  try:
+    command = [binary] + test.get('args', [])
+    if test['format'] == 'google_benchmark':
+      command += ['--benchmark_out=%s' % output_file,
+                  '--benchmark_out_format=json']
+    else:
+      command += ['--isolated_script_test_perf_output=%s' % output_file]
+    affinity = profile.get('cpu_affinity')
+    if affinity and sys.platform.startswith('linux'):
+      command = ['taskset', '-c', affinity] + command
+    logging.info('Running %r', command)
+    subprocess.check_call(command, cwd=build_dir)
+    with open(output_file) as f:
+      results = json.load(f)
+  finally:
+    os.remove(output_file)
+
+  if test['format'] == 'google_benchmark':
+    AddGoogleBenchmarkSamples(charts, test, results)
+  else:
+    AddChartJsonSamples(charts, test, results)
+
+
+def RunTests(build_dir, profile, repetitions, test_filter):
+  charts = {}
+  for test in profile['tests']:
+    if test_filter and test['name'] != test_filter:
+      continue
+    for repetition in range(repetitions):
+      logging.info('%s: run %d of %d', test['name'], repetition + 1,
+                   repetitions)
+      _RunTest(build_dir, profile, test, charts)
+  return charts
+
+
+def _Median(values):
+  values = sorted(values)
+  middle = len(values) // 2
+  if len(values) % 2:
+    return values[middle]
+  return (values[middle - 1] + values[middle]) / 2.0
+
+
+def MannWhitneyU(a, b):
+  """Two-sided p value of the Mann-Whitney U test of samples a and b.
+
+  Uses the normal approximation with tie and continuity correction, which is
+  close enough to the exact test for the 5 or more samples per side it is used
+  with. Unlike a t-test, it isn't thrown off by the occasional outlier run.
+  """
+  n_a = len(a)
+  n_b = len(b)
+  if n_a == 0 or n_b == 0:
+    return 1.0
+  combined = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+  # Rank with ties getting their average rank.
+  rank_sum_a = 0.0
+  tie_term = 0.0
+  i = 0
+  while i < len(combined):
+    j = i
+    while j < len(combined) and combined[j][0] == combined[i][0]:
+      j += 1
+    rank = (i + j + 1) / 2.0
+    tied = j - i
+    tie_term += tied ** 3 - tied
+    rank_sum_a += rank * sum(1 for k in range(i, j) if combined[k][1] == 0)
+    i = j
+  u_a = rank_sum_a - n_a * (n_a + 1) / 2.0
+  mean_u = n_a * n_b / 2.0
+  n = n_a + n_b
+  variance = n_a * n_b / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+  if variance <= 0:
+    # All samples are equal.
+    return 1.0
+  z = (abs(u_a - mean_u) - 0.5) / math.sqrt(variance)
+  if z <= 0:
+    return 1.0
+  return math.erfc(z / math.sqrt(2))
+
+
+class Change(object):
+  IMPROVEMENT = 'improvement'
+  REGRESSION = 'REGRESSION'
+  CHANGE = 'change'
+  NONE = ''
+
+  def __init__(self, graph, trace, units, baseline_median, median, p_value,
+               kind):
+    self.graph = graph
+    self.trace = trace
+    self.units = units
+    self.baseline_median = baseline_median
+    self.median = median
+    self.p_value = p_value
+    self.kind = kind
+
+  def RelativeChange(self):
+    if self.baseline_median == 0:
+      return 0.0
+    return (self.median - self.baseline_median) / abs(self.baseline_median)
+
+
+def Compare(baseline_charts, charts, significance_level, min_relative_change):
+  """Compares every trace that is in both results. Returns a list of Change."""
+  changes = []
+  for graph in sorted(charts):
+    for trace in sorted(charts[graph]):
+      baseline = baseline_charts.get(graph, {}).get(trace)
+      if not baseline:
+        continue
+      result = charts[graph][trace]
+      change = Change(graph, trace, result['units'],
+                      _Median(baseline['values']), _Median(result['values']),
+                      MannWhitneyU(baseline['values'], result['values']),
+                      Change.NONE)
+      relative_change = change.RelativeChange()
+      if (change.p_value < significance_level and
+          abs(relative_change) > min_relative_change):
+        direction = (result.get('improvement_direction') or
+                     baseline.get('improvement_direction'))
+        if not direction:
+          change.kind = Change.CHANGE
+        elif (relative_change > 0) == (direction == 'up'):
+          change.kind = Change.IMPROVEMENT
+        else:
+          change.kind = Change.REGRESSION
+      changes.append(change)
+  return changes
+
+
+def PrintChanges(changes):
+  print('%-40s %-40s %14s %14s %8s %8s' %
+        ('graph', 'trace', 'baseline', 'current', 'change', 'p'))
+  for change in changes:
+    print(('%-40s %-40s %14.6g %14.6g %+7.1f%% %8.4f  %s' %
+           (change.graph, change.trace, change.baseline_median, change.median,
+            100.0 * change.RelativeChange(), change.p_value,
+            change.kind)).rstrip())
+
+
+def MachineMismatch(baseline_machine, machine):
+  """Returns the machine properties that differ."""
+  return [key for key in MACHINE_KEYS
+          if baseline_machine.get(key) != machine.get(key)]
+
+
+def main(argv=None):
+  logging.basicConfig(level=logging.INFO)
+  args = _ParseArgs(argv)
+
+  with open(args.profile) as f:
+    profile = json.load(f)
+
+  if args.compare:
+    with open(args.compare) as f:
+      results = json.load(f)
+  else:
+    machine = GetMachineProfile(profile)
+    error = CheckMachineProfile(profile, machine)
+    if error and not args.ignore_machine_mismatch:
+      logging.error('%s Results would not be comparable.', error)
+      return 1
+    repetitions = args.repetitions or profile['repetitions']
+    results = {
+        'format_version': '1.0',
+        'charts': RunTests(args.build_dir, profile, repetitions, args.filter),
+        'machine': machine,
+    }
+    if args.output:
+      with open(args.output, 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+
+  if not args.baseline:
+    return 0
+
+  with open(args.baseline) as f:
+    baseline = json.load(f)
+  mismatch = MachineMismatch(baseline.get('machine', {}),
+                             results.get('machine', {}))
+  if mismatch:
+    logging.log(logging.WARNING if args.ignore_machine_mismatch
+                else logging.ERROR,
+                'The baseline was taken on a different machine (%s).',
+                ', '.join(mismatch))
+    if not args.ignore_machine_mismatch:
+      return 1
+
+  changes = Compare(baseline['charts'], results['charts'],
+                    profile['significance_level'],
+                    profile['min_relative_change'])
+  PrintChanges(changes)
+  regressions = [c for c in changes if c.kind == Change.REGRESSION]
+  if regressions:
+    logging.error('%d of %d traces regressed.', len(regressions),
+                  len(changes))
+    return 1
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,145 @@
+#!/usr/bin/env python
+# Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+#
+# Use of this source code is governed by a BSD-style license
+# that can be found in the LICENSE file in the root of the source
+# tree. An additional intellectual property rights grant can be found
+# in the file PATENTS.  All contributing project authors may
+# be found in the AUTHORS file in the root of the source tree.
+
+import unittest
+
+import perf_regression
+
+
+def _Trace(values, direction=None, units='ms'):
+  trace = {'type': 'list_of_scalar_values', 'values': values, 'units': units}
+  if direction:
+    trace['improvement_direction'] = direction
+  return trace
+
+
+class MannWhitneyUTest(unittest.TestCase):
+  def testSeparatedSamplesAreSignificant(self):
+    p_value = perf_regression.MannWhitneyU([1, 2, 3, 4, 5, 6, 7],
+                                           [8, 9, 10, 11, 12, 13, 14])
+    self.assertLess(p_value, 0.01)
+
+  def testInterleavedSamplesAreNotSignificant(self):
+    p_value = perf_regression.MannWhitneyU([1, 3, 5, 7, 9, 11, 13],
+                                           [2, 4, 6, 8, 10, 12, 14])
+    self.assertGreater(p_value, 0.5)
+
+  def testIsSymmetric(self):
+    a = [10.1, 10.4, 9.8, 10.0, 10.2]
+    b = [10.9, 11.2, 10.3, 11.0, 10.8]
+    self.assertAlmostEqual(perf_regression.MannWhitneyU(a, b),
+                           perf_regression.MannWhitneyU(b, a))
+
+  def testEqualSamples(self):
+    self.assertEqual(1.0, perf_regression.MannWhitneyU([5] * 7, [5] * 7))
+
+  def testTies(self):
+    p_value = perf_regression.MannWhitneyU([1, 1, 1, 2, 2, 2, 2],
+                                           [3, 3, 3, 3, 4, 4, 4])
+    self.assertLess(p_value, 0.01)
+
+
+class CompareTest(unittest.TestCase):
+  def _Compare(self, baseline, current):
+    changes = perf_regression.Compare({'graph': {'trace': baseline}},
+                                      {'graph': {'trace': current}},
+                                      significance_level=0.01,
+                                      min_relative_change=0.03)
+    self.assertEqual(1, len(changes))
+    return changes[0]
+
+  def testSlowerIsRegressionWhenLowerIsBetter(self):
+    change = self._Compare(_Trace([100, 101, 99, 100, 102, 98, 100], 'down'),
+                           _Trace([110, 111, 109, 112, 110, 108, 111], 'down'))
+    self.assertEqual(perf_regression.Change.REGRESSION, change.kind)
+    self.assertAlmostEqual(0.1, change.RelativeChange())
+
+  def testSlowerIsImprovementWhenHigherIsBetter(self):
+    change = self._Compare(_Trace([100, 101, 99, 100, 102, 98, 100], 'up'),
+                           _Trace([110, 111, 109, 112, 110, 108, 111], 'up'))
+    self.assertEqual(perf_regression.Change.IMPROVEMENT, change.kind)
+
+  def testSmallChangeIsIgnored(self):
+    change = self._Compare(_Trace([100, 100, 100, 100, 100], 'down'),
+                           _Trace([101, 101, 101, 101, 101], 'down'))
+    self.assertEqual(perf_regression.Change.NONE, change.kind)
+
+  def testNoisyChangeIsIgnored(self):
+    change = self._Compare(_Trace([80, 120, 90, 130, 100, 70, 110], 'down'),
+                           _Trace([85, 125, 95, 140, 105, 75, 115], 'down'))
+    self.assertEqual(perf_regression.Change.NONE, change.kind)
+
+  def testUnknownDirectionDoesNotRegress(self):
+    change = self._Compare(_Trace([100, 101, 99, 100, 102, 98, 100]),
+                           _Trace([110, 111, 109, 112, 110, 108, 111]))
+    self.assertEqual(perf_regression.Change.CHANGE, change.kind)
+
+  def testTracesMissingFromBaselineAreSkipped(self):
+    changes = perf_regression.Compare({}, {'graph': {'trace': _Trace([1])}},
+                                      0.01, 0.03)
+    self.assertEqual([], changes)
+
+
+class SamplesTest(unittest.TestCase):
+  def testChartJson(self):
+    test = {'improvement_directions': {'cpu_usage': 'down'}}
+    charts = {}
+    for cpu_usage in (10.0, 12.0):
+      perf_regression.AddChartJsonSamples(charts, test, {
+          'format_version': '1.0',
+          'charts': {
+              'cpu_usage': {
+                  'call': {'type': 'scalar', 'value': cpu_usage, 'units': '%'},
+              },
+              'decode_fps': {
+                  'call': {'type': 'list_of_scalar_values',
+                           'values': [29.0, 31.0], 'units': 'fps'},
+              },
+          },
+      })
+    self.assertEqual(_Trace([10.0, 12.0], 'down', '%'),
+                     charts['cpu_usage']['call'])
+    self.assertEqual(_Trace([30.0, 30.0], units='fps'),
+                     charts['decode_fps']['call'])
+
+  def testGoogleBenchmarkSkipsAggregates(self):
+    charts = {}
+    perf_regression.AddGoogleBenchmarkSamples(charts, {}, {
+        'benchmarks': [
+            {'name': 'BM_Parse', 'run_type': 'iteration', 'cpu_time': 50.0,
+             'time_unit': 'ns'},
+            {'name': 'BM_Parse_mean', 'run_type': 'aggregate',
+             'cpu_time': 50.0, 'time_unit': 'ns'},
+        ],
+    })
+    self.assertEqual({'BM_Parse': _Trace([50.0], 'down', 'ns')},
+                     charts['benchmark_cpu_time'])
+
+
+class MachineProfileTest(unittest.TestCase):
+  def testMismatch(self):
+    machine = {'profile': 'p', 'cpu_model': 'a', 'num_cpus': 4,
+               'cpu_affinity': '0-3', 'cpu_governor': 'performance'}
+    other = dict(machine, cpu_model='b', os='other')
+    self.assertEqual([], perf_regression.MachineMismatch(machine, machine))
+    self.assertEqual(['cpu_model'],
+                     perf_regression.MachineMismatch(machine, other))
+
+  def testCheck(self):
+    profile = {'num_cpus': 4, 'cpu_governor': 'performance'}
+    self.assertIsNone(perf_regression.CheckMachineProfile(
+        profile, {'num_cpus': 4, 'cpu_governor': 'performance'}))
+    self.assertIsNotNone(perf_regression.CheckMachineProfile(
+        profile, {'num_cpus': 4, 'cpu_governor': 'powersave'}))
+    self.assertIsNotNone(perf_regression.CheckMachineProfile(
+        profile, {'num_cpus': 8, 'cpu_governor': 'performance'}))
+
+
+if __name__ == '__main__':
+  unittest.main()
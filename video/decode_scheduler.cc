@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/decode_scheduler.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/trace_event.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+DecodeScheduler::StreamState::StreamState(Stream* stream)
+    : stream(stream),
+      next_decode_ms(0),
+      decoding(false),
+      woken_up(false),
+      decoding_done(nullptr) {}
+
+DecodeScheduler::Worker::Worker(DecodeScheduler* scheduler)
+    : scheduler(scheduler),
+      thread(&DecodeScheduler::Run,
+             this,
+             "DecodeWorker",
+             rtc::kHighestPriority),
+      wake_up(false, false) {}
+
+DecodeScheduler::DecodeScheduler(Clock* clock, int num_workers)
+    : clock_(clock), running_(false) {
+  RTC_DCHECK(clock_);
+  RTC_DCHECK_GT(num_workers, 0);
+  for (int i = 0; i < num_workers; ++i)
+    workers_.push_back(absl::make_unique<Worker>(this));
+}
+
+DecodeScheduler::~DecodeScheduler() {
+  RTC_DCHECK(streams_.empty());
+  Stop();
+}
+
+void DecodeScheduler::Start() {
+  {
+    rtc::CritScope lock(&crit_);
+    if (running_)
+      return;
+    running_ = true;
+  }
+  for (auto& worker : workers_)
+    worker->thread.Start();
+}
+
+void DecodeScheduler::Stop() {
+  {
+    rtc::CritScope lock(&crit_);
+    if (!running_)
+      return;
+    running_ = false;
+  }
+  for (auto& worker : workers_) {
+    worker->wake_up.Set();
+    worker->thread.Stop();
+  }
+}
+
+void DecodeScheduler::RegisterStream(Stream* stream) {
+  RTC_DCHECK(stream);
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(streams_.find(stream) == streams_.end());
+  Worker* worker = workers_.front().get();
+  for (auto& candidate : workers_) {
+    if (candidate->streams.size() < worker->streams.size())
+      worker = candidate.get();
+  }
+  worker->streams.emplace_back(stream);
+  worker->streams.back().next_decode_ms = clock_->TimeInMilliseconds();
+  streams_[stream] = {worker, std::prev(worker->streams.end())};
+  worker->wake_up.Set();
+}
+
+void DecodeScheduler::DeRegisterStream(Stream* stream) {
+  rtc::Event decoding_done(false, false);
+  {
+    rtc::CritScope lock(&crit_);
+    auto it = streams_.find(stream);
+    if (it == streams_.end())
+      return;
+    if (!it->second.state->decoding) {
+      it->second.worker->streams.erase(it->second.state);
+      streams_.erase(it);
+      return;
+    }
+    it->second.state->decoding_done = &decoding_done;
+  }
+
+  decoding_done.Wait(rtc::Event::kForever);
+
+  rtc::CritScope lock(&crit_);
+  auto it = streams_.find(stream);
+  RTC_DCHECK(it != streams_.end());
+  it->second.worker->streams.erase(it->second.state);
+  streams_.erase(it);
+}
+
+void DecodeScheduler::WakeUp(Stream* stream) {
+  rtc::CritScope lock(&crit_);
+  auto it = streams_.find(stream);
+  if (it == streams_.end())
+    return;
+  StreamState* state = &*it->second.state;
+  if (state->decoding) {
+    state->woken_up = true;
+    return;
+  }
+  state->next_decode_ms =
+      std::min(state->next_decode_ms, clock_->TimeInMilliseconds());
+  it->second.worker->wake_up.Set();
+}
+
+// static
+void DecodeScheduler::Run(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  while (worker->scheduler->Process(worker)) {
+  }
+}
+
+bool DecodeScheduler::Process(Worker* worker) {
+  StreamState* next = nullptr;
+  int wait_ms = rtc::Event::kForever;
+  {
+    rtc::CritScope lock(&crit_);
+    if (!running_)
+      return false;
+
+    for (StreamState& state : worker->streams) {
+      if (state.decoding_done)
+        continue;
+      if (!next || state.next_decode_ms < next->next_decode_ms)
+        next = &state;
+    }
+    int64_t now_ms = clock_->TimeInMilliseconds();
+    if (next && next->next_decode_ms > now_ms) {
+      wait_ms = static_cast<int>(next->next_decode_ms - now_ms);
+      next = nullptr;
+    } else if (next) {
+      next->decoding = true;
+      next->woken_up = false;
+    }
+  }
+
+  if (!next) {
+    worker->wake_up.Wait(wait_ms);
+    return true;
+  }
+
+  int64_t decode_wait_ms;
+  {
+    TRACE_EVENT0("webrtc", "DecodeScheduler::DecodeNextFrame");
+    decode_wait_ms = next->stream->DecodeNextFrame();
+  }
+
+  rtc::CritScope lock(&crit_);
+  next->decoding = false;
+  next->next_decode_ms = clock_->TimeInMilliseconds();
+  if (!next->woken_up)
+    next->next_decode_ms += std::max<int64_t>(decode_wait_ms, 0);
+  if (next->decoding_done)
+    next->decoding_done->Set();
+  return true;
+}
+
+}  // namespace webrtc
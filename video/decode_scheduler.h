@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_DECODE_SCHEDULER_H_
+#define VIDEO_DECODE_SCHEDULER_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class Clock;
+
+// Runs the decoding of many video receive streams on a bounded pool of worker
+// threads, instead of one decode thread per stream.
+//
+// Each registered stream is assigned to one worker for as long as it is
+// registered, since decoders and the VCM expect to be called on a single
+// thread. A stream is never decoded on two threads at the same time, so its
+// frames are decoded in order. Every worker decodes the stream whose next
+// frame is due the earliest, as reported by the stream from the render time
+// of that frame.
+class DecodeScheduler {
+ public:
+  class Stream {
+   public:
+    // Decodes the next frame if it is due. Returns the time in ms until the
+    // stream wants to be called again, which should be zero if another frame
+    // may already be due.
+    virtual int64_t DecodeNextFrame() = 0;
+
+   protected:
+    virtual ~Stream() {}
+  };
+
+  DecodeScheduler(Clock* clock, int num_workers);
+  ~DecodeScheduler();
+
+  // Starts and stops the worker threads. Registered streams are not decoded
+  // while the scheduler is stopped.
+  void Start();
+  void Stop();
+
+  // Adds |stream| to the worker with the fewest streams and decodes it as
+  // soon as possible.
+  void RegisterStream(Stream* stream);
+  // Removes |stream|, waiting for a DecodeNextFrame call in progress on a
+  // worker to return. Must not be called from DecodeNextFrame.
+  void DeRegisterStream(Stream* stream);
+
+  // Decodes |stream| as soon as possible instead of after the time it
+  // returned from its last DecodeNextFrame, e.g. when a new frame has been
+  // inserted in its frame buffer. Can be called on any thread, and for streams
+  // that are not registered.
+  void WakeUp(Stream* stream);
+
+ private:
+  struct StreamState {
+    explicit StreamState(Stream* stream);
+
+    Stream* const stream;
+    int64_t next_decode_ms;
+    bool decoding;
+    // Set if WakeUp is called while the stream is being decoded.
+    bool woken_up;
+    // Set by DeRegisterStream while the stream is being decoded, the stream
+    // isn't decoded again once it is set.
+    rtc::Event* decoding_done;
+  };
+
+  struct Worker {
+    explicit Worker(DecodeScheduler* scheduler);
+
+    DecodeScheduler* const scheduler;
+    rtc::PlatformThread thread;
+    rtc::Event wake_up;
+    std::list<StreamState> streams;
+  };
+
+  struct StreamEntry {
+    Worker* worker;
+    std::list<StreamState>::iterator state;
+  };
+
+  static void Run(void* obj);
+  // Decodes the stream of |worker| that is due the earliest, or waits until a
+  // stream is due. Returns false when the scheduler is stopped.
+  bool Process(Worker* worker);
+
+  Clock* const clock_;
+  rtc::CriticalSection crit_;
+  // Created by the constructor, the |streams| of the workers are guarded by
+  // |crit_|.
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::map<Stream*, StreamEntry> streams_ RTC_GUARDED_BY(crit_);
+  bool running_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DecodeScheduler);
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_DECODE_SCHEDULER_H_
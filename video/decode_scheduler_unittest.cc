@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/decode_scheduler.h"
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kTimeoutMs = 1000;
+
+class FakeStream : public DecodeScheduler::Stream {
+ public:
+  FakeStream(int64_t first_wait_ms, int64_t wait_ms)
+      : first_wait_ms_(first_wait_ms), wait_ms_(wait_ms) {}
+
+  int64_t DecodeNextFrame() override {
+    {
+      rtc::CritScope lock(&crit_);
+      EXPECT_FALSE(decoding_);
+      decoding_ = true;
+      if (num_decodes_ == 0)
+        thread_ = rtc::CurrentThreadRef();
+      else
+        EXPECT_TRUE(rtc::IsThreadRefEqual(thread_, rtc::CurrentThreadRef()));
+      ++num_decodes_;
+    }
+    if (on_decode_)
+      on_decode_(this);
+    if (decode_time_ms_ > 0)
+      rtc::Event(false, false).Wait(decode_time_ms_);
+    rtc::CritScope lock(&crit_);
+    decoding_ = false;
+    decoded_event_.Set();
+    return num_decodes_ == 1 ? first_wait_ms_ : wait_ms_;
+  }
+
+  int num_decodes() const {
+    rtc::CritScope lock(&crit_);
+    return num_decodes_;
+  }
+
+  bool decoding() const {
+    rtc::CritScope lock(&crit_);
+    return decoding_;
+  }
+
+  bool WaitForDecodes(int num_decodes) {
+    while (this->num_decodes() < num_decodes) {
+      if (!decoded_event_.Wait(kTimeoutMs))
+        return false;
+    }
+    return true;
+  }
+
+  void set_decode_time_ms(int decode_time_ms) {
+    decode_time_ms_ = decode_time_ms;
+  }
+  void set_on_decode(std::function<void(FakeStream*)> on_decode) {
+    on_decode_ = std::move(on_decode);
+  }
+
+ private:
+  const int64_t first_wait_ms_;
+  const int64_t wait_ms_;
+  int decode_time_ms_ = 0;
+  std::function<void(FakeStream*)> on_decode_;
+  rtc::Event decoded_event_{false, false};
+  rtc::CriticalSection crit_;
+  bool decoding_ RTC_GUARDED_BY(crit_) = false;
+  int num_decodes_ RTC_GUARDED_BY(crit_) = 0;
+  rtc::PlatformThreadRef thread_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace
+
+TEST(DecodeSchedulerTest, DecodesStreamsOnOneWorkerEach) {
+  DecodeScheduler scheduler(Clock::GetRealTimeClock(), 2);
+  std::vector<std::unique_ptr<FakeStream>> streams;
+  for (int i = 0; i < 5; ++i) {
+    streams.push_back(std::unique_ptr<FakeStream>(new FakeStream(1, 1)));
+    scheduler.RegisterStream(streams.back().get());
+  }
+  scheduler.Start();
+  for (auto& stream : streams)
+    EXPECT_TRUE(stream->WaitForDecodes(10));
+  for (auto& stream : streams)
+    scheduler.DeRegisterStream(stream.get());
+  scheduler.Stop();
+}
+
+TEST(DecodeSchedulerTest, DecodesStreamDueFirst) {
+  DecodeScheduler scheduler(Clock::GetRealTimeClock(), 1);
+  rtc::CriticalSection crit;
+  std::vector<FakeStream*> decode_order;
+  FakeStream late_stream(60, kTimeoutMs);
+  FakeStream early_stream(30, kTimeoutMs);
+  auto on_decode = [&](FakeStream* stream) {
+    rtc::CritScope lock(&crit);
+    decode_order.push_back(stream);
+  };
+  late_stream.set_on_decode(on_decode);
+  early_stream.set_on_decode(on_decode);
+  scheduler.RegisterStream(&late_stream);
+  scheduler.RegisterStream(&early_stream);
+  scheduler.Start();
+
+  EXPECT_TRUE(late_stream.WaitForDecodes(2));
+  EXPECT_TRUE(early_stream.WaitForDecodes(2));
+  scheduler.DeRegisterStream(&late_stream);
+  scheduler.DeRegisterStream(&early_stream);
+  scheduler.Stop();
+
+  rtc::CritScope lock(&crit);
+  ASSERT_EQ(4u, decode_order.size());
+  EXPECT_EQ(&early_stream, decode_order[2]);
+  EXPECT_EQ(&late_stream, decode_order[3]);
+}
+
+TEST(DecodeSchedulerTest, WakeUpDecodesStreamBeforeItIsDue) {
+  DecodeScheduler scheduler(Clock::GetRealTimeClock(), 1);
+  FakeStream stream(10 * kTimeoutMs, 10 * kTimeoutMs);
+  scheduler.RegisterStream(&stream);
+  scheduler.Start();
+  ASSERT_TRUE(stream.WaitForDecodes(1));
+
+  scheduler.WakeUp(&stream);
+  EXPECT_TRUE(stream.WaitForDecodes(2));
+  scheduler.DeRegisterStream(&stream);
+  scheduler.Stop();
+
+  // Waking up a stream that isn't registered has no effect.
+  scheduler.WakeUp(&stream);
+}
+
+TEST(DecodeSchedulerTest, DeRegisterWaitsForDecodeInProgress) {
+  DecodeScheduler scheduler(Clock::GetRealTimeClock(), 1);
+  FakeStream stream(0, 0);
+  stream.set_decode_time_ms(50);
+  rtc::Event decode_started(false, false);
+  stream.set_on_decode([&](FakeStream*) { decode_started.Set(); });
+  scheduler.RegisterStream(&stream);
+  scheduler.Start();
+
+  ASSERT_TRUE(decode_started.Wait(kTimeoutMs));
+  scheduler.DeRegisterStream(&stream);
+  EXPECT_FALSE(stream.decoding());
+  int num_decodes = stream.num_decodes();
+  rtc::Event(false, false).Wait(50);
+  EXPECT_EQ(num_decodes, stream.num_decodes());
+  scheduler.Stop();
+}
+
+}  // namespace webrtc
@@ -10,21 +10,65 @@
 
 #include "video/encoder_rtcp_feedback.h"
 
+#include <algorithm>
+
 #include "api/video/video_stream_encoder_interface.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/experiments/field_trial_parser.h"
+#include "system_wrappers/include/field_trial.h"
+#include "system_wrappers/include/metrics.h"
 
 static const int kMinKeyFrameRequestIntervalMs = 300;
+static const char kCoalescingFieldTrial[] = "WebRTC-KeyFrameRequestCoalescing";
 
 namespace webrtc {
 
+EncoderRtcpFeedback::Config::Config()
+    : min_interval_ms(kMinKeyFrameRequestIntervalMs), aggregation_window_ms(0) {
+  FieldTrialParameter<int> min_interval("min_interval_ms",
+                                        kMinKeyFrameRequestIntervalMs);
+  FieldTrialParameter<int> aggregation_window("aggregation_window_ms", 0);
+  ParseFieldTrial({&min_interval, &aggregation_window},
+                  field_trial::FindFullName(kCoalescingFieldTrial));
+  min_interval_ms = std::max(min_interval.Get(), 0);
+  aggregation_window_ms = std::max(aggregation_window.Get(), 0);
+}
+
 EncoderRtcpFeedback::EncoderRtcpFeedback(Clock* clock,
                                          const std::vector<uint32_t>& ssrcs,
                                          VideoStreamEncoderInterface* encoder)
+    : EncoderRtcpFeedback(clock, ssrcs, encoder, nullptr, Config()) {}
+
+EncoderRtcpFeedback::EncoderRtcpFeedback(Clock* clock,
+                                         const std::vector<uint32_t>& ssrcs,
+                                         VideoStreamEncoderInterface* encoder,
+                                         rtc::TaskQueue* task_queue,
+                                         const Config& config)
     : clock_(clock),
       ssrcs_(ssrcs),
       video_stream_encoder_(encoder),
-      time_last_intra_request_ms_(ssrcs.size(), -1) {
+      task_queue_(task_queue),
+      config_(config),
+      time_last_key_frame_request_ms_(-1),
+      key_frame_pending_(false),
+      stats_(ssrcs.size()),
+      weak_ptr_factory_(this) {
   RTC_DCHECK(!ssrcs.empty());
+  weak_ptr_ = weak_ptr_factory_.GetWeakPtr();
+}
+
+EncoderRtcpFeedback::~EncoderRtcpFeedback() {
+  rtc::CritScope lock(&crit_);
+  int requests = 0;
+  int suppressed_requests = 0;
+  for (const SsrcStats& stats : stats_) {
+    requests += stats.key_frame_requests;
+    suppressed_requests += stats.suppressed_key_frame_requests;
+  }
+  if (requests > 0) {
+    RTC_HISTOGRAM_PERCENTAGE("WebRTC.Video.SuppressedKeyFrameRequestsPercent",
+                             suppressed_requests * 100 / requests);
+  }
 }
 
 bool EncoderRtcpFeedback::HasSsrc(uint32_t ssrc) {
@@ -53,15 +97,56 @@ void EncoderRtcpFeedback::OnReceivedIntraFrameRequest(uint32_t ssrc) {
     // it easier to test there.
     int64_t now_ms = clock_->TimeInMilliseconds();
     rtc::CritScope lock(&crit_);
-    if (time_last_intra_request_ms_[index] + kMinKeyFrameRequestIntervalMs >
-        now_ms) {
+    ++stats_[index].key_frame_requests;
+    if (key_frame_pending_) {
+      ++stats_[index].suppressed_key_frame_requests;
       return;
     }
-    time_last_intra_request_ms_[index] = now_ms;
+    int64_t delay_ms = config_.aggregation_window_ms;
+    if (time_last_key_frame_request_ms_ >= 0) {
+      delay_ms = std::max(delay_ms, time_last_key_frame_request_ms_ +
+                                        config_.min_interval_ms - now_ms);
+    }
+    if (delay_ms > 0) {
+      if (!task_queue_) {
+        ++stats_[index].suppressed_key_frame_requests;
+        return;
+      }
+      key_frame_pending_ = true;
+      rtc::WeakPtr<EncoderRtcpFeedback> feedback = weak_ptr_;
+      task_queue_->PostDelayedTask(
+          [feedback] {
+            if (feedback)
+              feedback->SendPendingKeyFrame();
+          },
+          static_cast<uint32_t>(delay_ms));
+      return;
+    }
+    time_last_key_frame_request_ms_ = now_ms;
   }
 
   // Always produce key frame for all streams.
   video_stream_encoder_->SendKeyFrame();
 }
 
+std::map<uint32_t, EncoderRtcpFeedback::SsrcStats>
+EncoderRtcpFeedback::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  std::map<uint32_t, SsrcStats> stats;
+  for (size_t i = 0; i < ssrcs_.size(); ++i)
+    stats[ssrcs_[i]] = stats_[i];
+  return stats;
+}
+
+void EncoderRtcpFeedback::SendPendingKeyFrame() {
+  RTC_DCHECK(task_queue_->IsCurrent());
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(key_frame_pending_);
+    key_frame_pending_ = false;
+    time_last_key_frame_request_ms_ = clock_->TimeInMilliseconds();
+  }
+  video_stream_encoder_->SendKeyFrame();
+}
+
 }  // namespace webrtc
@@ -10,33 +10,81 @@
 #ifndef VIDEO_ENCODER_RTCP_FEEDBACK_H_
 #define VIDEO_ENCODER_RTCP_FEEDBACK_H_
 
+#include <map>
 #include <vector>
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/weak_ptr.h"
 #include "system_wrappers/include/clock.h"
 
 namespace webrtc {
 
 class VideoStreamEncoderInterface;
 
+// Turns the PLIs and FIRs of the receivers into key frame requests of the
+// encoder. Since every request makes all streams send a key frame, requests
+// are coalesced across the SSRCs, so that a storm of them, e.g. from
+// receivers joining a conference together, results in a single key frame.
 class EncoderRtcpFeedback : public RtcpIntraFrameObserver {
  public:
+  struct Config {
+    // Set from the "WebRTC-KeyFrameRequestCoalescing" field trial, e.g.
+    // "min_interval_ms:500,aggregation_window_ms:100".
+    Config();
+
+    // Key frames are requested at most this often. Requests in between are
+    // answered by one key frame at the end of the interval, or, without a
+    // task queue, dropped.
+    int min_interval_ms;
+    // When above zero, the key frame of a request is requested this much
+    // later, to answer the requests that follow within the window too.
+    int aggregation_window_ms;
+  };
+
+  struct SsrcStats {
+    int key_frame_requests = 0;
+    // The requests that didn't make the encoder send a key frame of their
+    // own, as they were answered by a key frame already requested, or
+    // dropped.
+    int suppressed_key_frame_requests = 0;
+  };
+
   EncoderRtcpFeedback(Clock* clock,
                       const std::vector<uint32_t>& ssrcs,
                       VideoStreamEncoderInterface* encoder);
+  // Deferred key frame requests are posted to |task_queue|, which must be
+  // the one that the feedback is created and destroyed on.
+  EncoderRtcpFeedback(Clock* clock,
+                      const std::vector<uint32_t>& ssrcs,
+                      VideoStreamEncoderInterface* encoder,
+                      rtc::TaskQueue* task_queue,
+                      const Config& config);
+  ~EncoderRtcpFeedback() override;
+
   void OnReceivedIntraFrameRequest(uint32_t ssrc) override;
 
+  std::map<uint32_t, SsrcStats> GetStats() const;
+
  private:
   bool HasSsrc(uint32_t ssrc);
   size_t GetStreamIndex(uint32_t ssrc);
+  void SendPendingKeyFrame();
 
   Clock* const clock_;
   const std::vector<uint32_t> ssrcs_;
   VideoStreamEncoderInterface* const video_stream_encoder_;
+  rtc::TaskQueue* const task_queue_;
+  const Config config_;
 
   rtc::CriticalSection crit_;
-  std::vector<int64_t> time_last_intra_request_ms_ RTC_GUARDED_BY(crit_);
+  int64_t time_last_key_frame_request_ms_ RTC_GUARDED_BY(crit_);
+  bool key_frame_pending_ RTC_GUARDED_BY(crit_);
+  std::vector<SsrcStats> stats_ RTC_GUARDED_BY(crit_);
+
+  rtc::WeakPtr<EncoderRtcpFeedback> weak_ptr_;
+  rtc::WeakPtrFactory<EncoderRtcpFeedback> weak_ptr_factory_;
 };
 
 }  // namespace webrtc
@@ -12,10 +12,12 @@
 
 #include <memory>
 
+#include "rtc_base/event.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 #include "video/test/mock_video_stream_encoder.h"
 
+using ::testing::Invoke;
 using ::testing::NiceMock;
 
 namespace webrtc {
@@ -57,4 +59,92 @@ TEST_F(VieKeyRequestTest, TooManyOnReceivedIntraFrameRequest) {
   encoder_rtcp_feedback_.OnReceivedIntraFrameRequest(kSsrc);
 }
 
+namespace {
+constexpr uint32_t kSsrc1 = 1111;
+constexpr uint32_t kSsrc2 = 2222;
+constexpr int kWaitMs = 5000;
+}  // namespace
+
+class KeyFrameRequestCoalescingTest : public ::testing::Test {
+ public:
+  KeyFrameRequestCoalescingTest()
+      : clock_(123456789), queue_("KeyFrameRequestCoalescingTest") {
+    ON_CALL(encoder_, SendKeyFrame()).WillByDefault(Invoke([this] {
+      ++num_key_frames_;
+      key_frame_.Set();
+    }));
+  }
+  ~KeyFrameRequestCoalescingTest() override {
+    RunOnQueue([this] { feedback_.reset(); });
+  }
+
+ protected:
+  template <typename Closure>
+  void RunOnQueue(Closure&& closure) {
+    rtc::Event done(false, false);
+    queue_.PostTask([&] {
+      closure();
+      done.Set();
+    });
+    done.Wait(rtc::Event::kForever);
+  }
+
+  void CreateFeedback(int min_interval_ms, int aggregation_window_ms) {
+    EncoderRtcpFeedback::Config config;
+    config.min_interval_ms = min_interval_ms;
+    config.aggregation_window_ms = aggregation_window_ms;
+    RunOnQueue([&] {
+      feedback_.reset(new EncoderRtcpFeedback(
+          &clock_, {kSsrc1, kSsrc2}, &encoder_, &queue_, config));
+    });
+  }
+
+  SimulatedClock clock_;
+  NiceMock<MockVideoStreamEncoder> encoder_;
+  rtc::Event key_frame_{false, false};
+  int num_key_frames_ = 0;
+  rtc::TaskQueue queue_;
+  std::unique_ptr<EncoderRtcpFeedback> feedback_;
+};
+
+TEST_F(KeyFrameRequestCoalescingTest, LimitsKeyFramesAcrossSsrcs) {
+  CreateFeedback(300, 0);
+  feedback_->OnReceivedIntraFrameRequest(kSsrc1);
+  EXPECT_EQ(1, num_key_frames_);
+  key_frame_.Reset();
+
+  // The requests within the interval get one key frame at its end.
+  clock_.AdvanceTimeMilliseconds(10);
+  feedback_->OnReceivedIntraFrameRequest(kSsrc2);
+  feedback_->OnReceivedIntraFrameRequest(kSsrc1);
+  feedback_->OnReceivedIntraFrameRequest(kSsrc2);
+  ASSERT_TRUE(key_frame_.Wait(kWaitMs));
+  RunOnQueue([] {});
+  EXPECT_EQ(2, num_key_frames_);
+
+  std::map<uint32_t, EncoderRtcpFeedback::SsrcStats> stats =
+      feedback_->GetStats();
+  EXPECT_EQ(2, stats[kSsrc1].key_frame_requests);
+  EXPECT_EQ(1, stats[kSsrc1].suppressed_key_frame_requests);
+  EXPECT_EQ(2, stats[kSsrc2].key_frame_requests);
+  EXPECT_EQ(1, stats[kSsrc2].suppressed_key_frame_requests);
+}
+
+TEST_F(KeyFrameRequestCoalescingTest, AggregatesRequestsOfWindow) {
+  CreateFeedback(0, 20);
+  feedback_->OnReceivedIntraFrameRequest(kSsrc1);
+  feedback_->OnReceivedIntraFrameRequest(kSsrc2);
+  EXPECT_EQ(0, num_key_frames_);
+  ASSERT_TRUE(key_frame_.Wait(kWaitMs));
+  RunOnQueue([] {});
+  EXPECT_EQ(1, num_key_frames_);
+  EXPECT_EQ(1, feedback_->GetStats()[kSsrc2].suppressed_key_frame_requests);
+
+  // The next request opens a new window.
+  feedback_->OnReceivedIntraFrameRequest(kSsrc2);
+  ASSERT_TRUE(key_frame_.Wait(kWaitMs));
+  RunOnQueue([] {});
+  EXPECT_EQ(2, num_key_frames_);
+}
+
 }  // namespace webrtc
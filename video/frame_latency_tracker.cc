@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/frame_latency_tracker.h"
+
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+
+namespace {
+
+// Stages taking longer are kept in a map instead of an array.
+const uint32_t kMaxCommonStageMs = 500;
+
+enum Stage {
+  // Includes the wait in the VideoStreamEncoder queue.
+  kCaptureToEncode,
+  kEncode,
+  kPacketization,
+  kPacer,
+  // From the last packet leaving the pacer until it is received. Only known
+  // once the sender's clock has been estimated.
+  kNetwork,
+  kJitterBuffer,
+  kDecode,
+  // From the end of decoding until the frame is due to be rendered.
+  kRender,
+  kNumStages
+};
+
+const char* const kStageNames[kNumStages] = {
+    "capture_to_encode", "encode",        "packetization", "pacer",
+    "network",           "jitter_buffer", "decode",        "render"};
+
+}  // namespace
+
+FrameLatencyTracker::FrameLatencyTracker()
+    : stages_(kNumStages, rtc::HistogramPercentileCounter(kMaxCommonStageMs)) {}
+
+FrameLatencyTracker::~FrameLatencyTracker() = default;
+
+void FrameLatencyTracker::AddTimingFrame(const TimingFrameInfo& info) {
+  if (info.IsInvalid() || info.rtp_timestamp == last_rtp_timestamp_)
+    return;
+  last_rtp_timestamp_ = info.rtp_timestamp;
+
+  AddStage(kCaptureToEncode, info.capture_time_ms, info.encode_start_ms);
+  AddStage(kEncode, info.encode_start_ms, info.encode_finish_ms);
+  AddStage(kPacketization, info.encode_finish_ms,
+           info.packetization_finish_ms);
+  AddStage(kPacer, info.packetization_finish_ms, info.pacer_exit_ms);
+  // The sender's timestamps are negative until its clock has been estimated.
+  if (info.capture_time_ms >= 0)
+    AddStage(kNetwork, info.pacer_exit_ms, info.receive_finish_ms);
+  AddStage(kJitterBuffer, info.receive_finish_ms, info.decode_start_ms);
+  AddStage(kDecode, info.decode_start_ms, info.decode_finish_ms);
+  AddStage(kRender, info.decode_finish_ms, info.render_time_ms);
+}
+
+std::vector<FrameLatencyStageStats> FrameLatencyTracker::GetStageStats() {
+  std::vector<FrameLatencyStageStats> stats;
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    absl::optional<uint32_t> p50 = stages_[i].GetPercentile(0.5f);
+    if (!p50)
+      continue;
+    FrameLatencyStageStats stage;
+    stage.stage = kStageNames[i];
+    stage.p50_ms = *p50;
+    stage.p95_ms = *stages_[i].GetPercentile(0.95f);
+    stage.p99_ms = *stages_[i].GetPercentile(0.99f);
+    stats.push_back(stage);
+  }
+  return stats;
+}
+
+void FrameLatencyTracker::AddStage(size_t stage,
+                                   int64_t start_ms,
+                                   int64_t end_ms) {
+  if (end_ms < start_ms)
+    return;
+  stages_[stage].Add(rtc::saturated_cast<uint32_t>(end_ms - start_ms));
+}
+
+}  // namespace webrtc
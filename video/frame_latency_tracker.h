@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_FRAME_LATENCY_TRACKER_H_
+#define VIDEO_FRAME_LATENCY_TRACKER_H_
+
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/video/video_timing.h"
+#include "rtc_base/numerics/histogram_percentile_counter.h"
+
+namespace webrtc {
+
+// Splits the lifetime of the timing frames of a received stream, as reported
+// by TimingFrameInfo, into the stages of the video pipeline and keeps the
+// percentiles of the time spent in each. The sender's stages come from the
+// video-timing header extension and the receiver's from local timestamps.
+class FrameLatencyTracker {
+ public:
+  FrameLatencyTracker();
+  ~FrameLatencyTracker();
+
+  // The same frame may be reported more than once, and is only added the
+  // first time.
+  void AddTimingFrame(const TimingFrameInfo& info);
+
+  // Returns the stages for which frames have been added, in pipeline order.
+  std::vector<FrameLatencyStageStats> GetStageStats();
+
+ private:
+  // Adds |end_ms| - |start_ms| to |stage|, unless it is negative, which happens
+  // when the sender's and the receiver's clocks drift apart.
+  void AddStage(size_t stage, int64_t start_ms, int64_t end_ms);
+
+  std::vector<rtc::HistogramPercentileCounter> stages_;
+  absl::optional<uint32_t> last_rtp_timestamp_;
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_FRAME_LATENCY_TRACKER_H_
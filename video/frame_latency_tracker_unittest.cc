@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/frame_latency_tracker.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+// Returns a frame which spends |stage_ms| in every stage.
+TimingFrameInfo MakeTimingFrame(uint32_t rtp_timestamp,
+                                int64_t capture_time_ms,
+                                int64_t stage_ms) {
+  TimingFrameInfo info;
+  info.rtp_timestamp = rtp_timestamp;
+  info.capture_time_ms = capture_time_ms;
+  info.encode_start_ms = info.capture_time_ms + stage_ms;
+  info.encode_finish_ms = info.encode_start_ms + stage_ms;
+  info.packetization_finish_ms = info.encode_finish_ms + stage_ms;
+  info.pacer_exit_ms = info.packetization_finish_ms + stage_ms;
+  info.receive_start_ms = info.pacer_exit_ms + stage_ms;
+  info.receive_finish_ms = info.receive_start_ms;
+  info.decode_start_ms = info.receive_finish_ms + stage_ms;
+  info.decode_finish_ms = info.decode_start_ms + stage_ms;
+  info.render_time_ms = info.decode_finish_ms + stage_ms;
+  return info;
+}
+
+}  // namespace
+
+TEST(FrameLatencyTrackerTest, ReportsNothingWithoutFrames) {
+  FrameLatencyTracker tracker;
+  EXPECT_TRUE(tracker.GetStageStats().empty());
+}
+
+TEST(FrameLatencyTrackerTest, ReportsPercentilesPerStage) {
+  FrameLatencyTracker tracker;
+  // 1 to 100 ms per stage.
+  for (uint32_t i = 1; i <= 100; ++i)
+    tracker.AddTimingFrame(MakeTimingFrame(i, 1000, i));
+
+  const std::vector<FrameLatencyStageStats> stats = tracker.GetStageStats();
+  ASSERT_EQ(8u, stats.size());
+  EXPECT_EQ("capture_to_encode", stats[0].stage);
+  EXPECT_EQ("network", stats[4].stage);
+  EXPECT_EQ("render", stats[7].stage);
+  for (const FrameLatencyStageStats& stage : stats) {
+    EXPECT_EQ(50, stage.p50_ms) << stage.stage;
+    EXPECT_EQ(95, stage.p95_ms) << stage.stage;
+    EXPECT_EQ(99, stage.p99_ms) << stage.stage;
+  }
+}
+
+TEST(FrameLatencyTrackerTest, AddsRepeatedFrameOnce) {
+  FrameLatencyTracker tracker;
+  tracker.AddTimingFrame(MakeTimingFrame(1, 1000, 10));
+  tracker.AddTimingFrame(MakeTimingFrame(1, 1000, 10));
+  tracker.AddTimingFrame(MakeTimingFrame(1, 1000, 10));
+  tracker.AddTimingFrame(MakeTimingFrame(2, 1000, 20));
+
+  const std::vector<FrameLatencyStageStats> stats = tracker.GetStageStats();
+  ASSERT_FALSE(stats.empty());
+  EXPECT_EQ(10, stats[0].p50_ms);
+  EXPECT_EQ(20, stats[0].p99_ms);
+}
+
+TEST(FrameLatencyTrackerTest, SkipsNetworkUntilSenderClockIsEstimated) {
+  FrameLatencyTracker tracker;
+  tracker.AddTimingFrame(MakeTimingFrame(1, -1000, 10));
+
+  const std::vector<FrameLatencyStageStats> stats = tracker.GetStageStats();
+  ASSERT_EQ(7u, stats.size());
+  for (const FrameLatencyStageStats& stage : stats)
+    EXPECT_NE("network", stage.stage);
+}
+
+TEST(FrameLatencyTrackerTest, IgnoresInvalidFrames) {
+  FrameLatencyTracker tracker;
+  TimingFrameInfo info = MakeTimingFrame(1, 1000, 10);
+  info.flags = VideoSendTiming::kInvalid;
+  tracker.AddTimingFrame(info);
+  EXPECT_TRUE(tracker.GetStageStats().empty());
+}
+
+}  // namespace webrtc
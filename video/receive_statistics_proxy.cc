@@ -583,6 +583,7 @@ VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
   stats_.interframe_delay_max_ms =
       interframe_delay_max_moving_.Max(now_ms).value_or(-1);
   stats_.timing_frame_info = timing_frame_info_counter_.Max(now_ms);
+  stats_.frame_latency_stages = frame_latency_tracker_.GetStageStats();
   stats_.content_type = last_content_type_;
   return stats_;
 }
@@ -640,6 +641,7 @@ void ReceiveStatisticsProxy::OnTimingFrameInfoUpdated(
   rtc::CritScope lock(&crit_);
   int64_t now_ms = clock_->TimeInMilliseconds();
   timing_frame_info_counter_.Add(info, now_ms);
+  frame_latency_tracker_.AddTimingFrame(info);
 }
 
 void ReceiveStatisticsProxy::RtcpPacketTypesCounterUpdated(
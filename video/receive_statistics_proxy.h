@@ -29,6 +29,7 @@
 #include "rtc_base/ratetracker.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
+#include "video/frame_latency_tracker.h"
 #include "video/quality_threshold.h"
 #include "video/report_block_stats.h"
 #include "video/stats_counter.h"
@@ -191,6 +192,8 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   // called from const GetStats().
   mutable rtc::MovingMaxCounter<TimingFrameInfo> timing_frame_info_counter_
       RTC_GUARDED_BY(&crit_);
+  // Mutable for the same reason as |timing_frame_info_counter_|.
+  mutable FrameLatencyTracker frame_latency_tracker_ RTC_GUARDED_BY(&crit_);
   absl::optional<int> num_unique_frames_ RTC_GUARDED_BY(crit_);
   rtc::ThreadChecker decode_thread_;
   rtc::ThreadChecker network_thread_;
@@ -13,6 +13,7 @@
 #include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame.h"
@@ -406,6 +407,31 @@ TEST_F(ReceiveStatisticsProxyTest,
   EXPECT_EQ(kExpectedRtpTimestamp, result->rtp_timestamp);
 }
 
+TEST_F(ReceiveStatisticsProxyTest, ReportsFrameLatencyStages) {
+  EXPECT_TRUE(statistics_proxy_->GetStats().frame_latency_stages.empty());
+  TimingFrameInfo info;
+  info.rtp_timestamp = 1;
+  info.capture_time_ms = 0;
+  info.encode_start_ms = 5;
+  info.encode_finish_ms = 15;
+  info.packetization_finish_ms = 16;
+  info.pacer_exit_ms = 20;
+  info.receive_start_ms = 40;
+  info.receive_finish_ms = 50;
+  info.decode_start_ms = 60;
+  info.decode_finish_ms = 70;
+  info.render_time_ms = 80;
+  statistics_proxy_->OnTimingFrameInfoUpdated(info);
+
+  const std::vector<FrameLatencyStageStats> stages =
+      statistics_proxy_->GetStats().frame_latency_stages;
+  ASSERT_EQ(8u, stages.size());
+  EXPECT_EQ("encode", stages[1].stage);
+  EXPECT_EQ(10, stages[1].p99_ms);
+  EXPECT_EQ("network", stages[4].stage);
+  EXPECT_EQ(30, stages[4].p50_ms);
+}
+
 TEST_F(ReceiveStatisticsProxyTest, RespectsReportingIntervalForTimingFrames) {
   TimingFrameInfo info;
   const int64_t kShortEndToEndDelay = 10;
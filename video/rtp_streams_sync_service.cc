@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/rtp_streams_sync_service.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/trace_event.h"
+#include "video/rtp_streams_synchronizer.h"
+
+namespace webrtc {
+namespace {
+const int64_t kSyncIntervalMs = 1000;
+}  // namespace
+
+RtpStreamsSyncService::RtpStreamsSyncService()
+    : last_sync_time_(rtc::TimeNanos()) {
+  process_thread_checker_.DetachFromThread();
+}
+
+RtpStreamsSyncService::~RtpStreamsSyncService() {
+  RTC_DCHECK(synchronizers_.empty());
+}
+
+void RtpStreamsSyncService::AddSynchronizer(
+    RtpStreamsSynchronizer* synchronizer) {
+  RTC_DCHECK(synchronizer);
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(std::find(synchronizers_.begin(), synchronizers_.end(),
+                       synchronizer) == synchronizers_.end());
+  synchronizers_.push_back(synchronizer);
+}
+
+void RtpStreamsSyncService::RemoveSynchronizer(
+    RtpStreamsSynchronizer* synchronizer) {
+  rtc::CritScope lock(&crit_);
+  auto it =
+      std::find(synchronizers_.begin(), synchronizers_.end(), synchronizer);
+  RTC_DCHECK(it != synchronizers_.end());
+  if (it != synchronizers_.end())
+    synchronizers_.erase(it);
+}
+
+int64_t RtpStreamsSyncService::TimeUntilNextProcess() {
+  RTC_DCHECK_RUN_ON(&process_thread_checker_);
+  return kSyncIntervalMs -
+         (rtc::TimeNanos() - last_sync_time_) / rtc::kNumNanosecsPerMillisec;
+}
+
+void RtpStreamsSyncService::Process() {
+  RTC_DCHECK_RUN_ON(&process_thread_checker_);
+  last_sync_time_ = rtc::TimeNanos();
+
+  rtc::CritScope lock(&crit_);
+  TRACE_EVENT1("webrtc", "RtpStreamsSyncService::Process", "streams",
+               synchronizers_.size());
+  for (RtpStreamsSynchronizer* synchronizer : synchronizers_)
+    synchronizer->UpdateDelays();
+}
+
+}  // namespace webrtc
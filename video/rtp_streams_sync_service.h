@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_RTP_STREAMS_SYNC_SERVICE_H_
+#define VIDEO_RTP_STREAMS_SYNC_SERVICE_H_
+
+#include <vector>
+
+#include "modules/include/module.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/thread_checker.h"
+
+namespace webrtc {
+
+class RtpStreamsSynchronizer;
+
+// Updates the audio/video sync of all the video receive streams of a call in
+// one pass a second on the module process thread, instead of every stream
+// being a module of its own. Only the synchronizers of streams that are
+// rendered and synced with an audio stream are added, so that other streams
+// don't pay for sync.
+class RtpStreamsSyncService : public Module {
+ public:
+  RtpStreamsSyncService();
+  ~RtpStreamsSyncService() override;
+
+  void AddSynchronizer(RtpStreamsSynchronizer* synchronizer);
+  // Waits for an update of |synchronizer| in progress to finish.
+  void RemoveSynchronizer(RtpStreamsSynchronizer* synchronizer);
+
+  // Implements Module.
+  int64_t TimeUntilNextProcess() override;
+  void Process() override;
+
+ private:
+  rtc::CriticalSection crit_;
+  std::vector<RtpStreamsSynchronizer*> synchronizers_ RTC_GUARDED_BY(crit_);
+
+  rtc::ThreadChecker process_thread_checker_;
+  int64_t last_sync_time_ RTC_GUARDED_BY(&process_thread_checker_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpStreamsSyncService);
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_RTP_STREAMS_SYNC_SERVICE_H_
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/rtp_streams_sync_service.h"
+
+#include "call/syncable.h"
+#include "test/gtest.h"
+#include "video/rtp_streams_synchronizer.h"
+
+namespace webrtc {
+namespace {
+
+// Counts the GetInfo calls of the synchronizer, which has no info to sync
+// with.
+class FakeSyncable : public Syncable {
+ public:
+  explicit FakeSyncable(int id) : id_(id) {}
+
+  int id() const override { return id_; }
+  absl::optional<Info> GetInfo() const override {
+    ++num_get_info_calls_;
+    return absl::nullopt;
+  }
+  uint32_t GetPlayoutTimestamp() const override { return 0; }
+  void SetMinimumPlayoutDelay(int delay_ms) override {}
+
+  int num_get_info_calls() const { return num_get_info_calls_; }
+
+ private:
+  const int id_;
+  mutable int num_get_info_calls_ = 0;
+};
+
+}  // namespace
+
+TEST(RtpStreamsSyncServiceTest, UpdatesAddedSynchronizersTogether) {
+  RtpStreamsSyncService service;
+  FakeSyncable video1(1);
+  FakeSyncable video2(2);
+  FakeSyncable audio1(3);
+  FakeSyncable audio2(4);
+  RtpStreamsSynchronizer sync1(&video1);
+  RtpStreamsSynchronizer sync2(&video2);
+  sync1.ConfigureSync(&audio1);
+  sync2.ConfigureSync(&audio2);
+
+  service.AddSynchronizer(&sync1);
+  service.AddSynchronizer(&sync2);
+  EXPECT_GT(service.TimeUntilNextProcess(), 0);
+  service.Process();
+  EXPECT_EQ(1, audio1.num_get_info_calls());
+  EXPECT_EQ(1, audio2.num_get_info_calls());
+
+  service.RemoveSynchronizer(&sync1);
+  service.Process();
+  EXPECT_EQ(1, audio1.num_get_info_calls());
+  EXPECT_EQ(2, audio2.num_get_info_calls());
+  service.RemoveSynchronizer(&sync2);
+}
+
+}  // namespace webrtc
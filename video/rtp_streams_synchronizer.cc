@@ -37,8 +37,7 @@ bool UpdateMeasurements(StreamSynchronization::Measurements* stream,
 RtpStreamsSynchronizer::RtpStreamsSynchronizer(Syncable* syncable_video)
     : syncable_video_(syncable_video),
       syncable_audio_(nullptr),
-      sync_(),
-      last_sync_time_(rtc::TimeNanos()) {
+      sync_() {
   RTC_DCHECK(syncable_video);
   process_thread_checker_.DetachFromThread();
 }
@@ -58,17 +57,8 @@ void RtpStreamsSynchronizer::ConfigureSync(Syncable* syncable_audio) {
   }
 }
 
-int64_t RtpStreamsSynchronizer::TimeUntilNextProcess() {
+void RtpStreamsSynchronizer::UpdateDelays() {
   RTC_DCHECK_RUN_ON(&process_thread_checker_);
-  const int64_t kSyncIntervalMs = 1000;
-  return kSyncIntervalMs -
-         (rtc::TimeNanos() - last_sync_time_) / rtc::kNumNanosecsPerMillisec;
-}
-
-void RtpStreamsSynchronizer::Process() {
-  RTC_DCHECK_RUN_ON(&process_thread_checker_);
-  last_sync_time_ = rtc::TimeNanos();
-
   rtc::CritScope lock(&crit_);
   if (!syncable_audio_) {
     return;
@@ -9,14 +9,14 @@
  */
 
 // RtpStreamsSynchronizer is responsible for synchronization audio and video for
-// a given voice engine channel and video receive stream.
+// a given voice engine channel and video receive stream. The delays are
+// updated by the RtpStreamsSyncService of the call.
 
 #ifndef VIDEO_RTP_STREAMS_SYNCHRONIZER_H_
 #define VIDEO_RTP_STREAMS_SYNCHRONIZER_H_
 
 #include <memory>
 
-#include "modules/include/module.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/thread_checker.h"
 #include "video/stream_synchronization.h"
@@ -29,15 +29,15 @@ namespace vcm {
 class VideoReceiver;
 }  // namespace vcm
 
-class RtpStreamsSynchronizer : public Module {
+class RtpStreamsSynchronizer {
  public:
   explicit RtpStreamsSynchronizer(Syncable* syncable_video);
 
   void ConfigureSync(Syncable* syncable_audio);
 
-  // Implements Module.
-  int64_t TimeUntilNextProcess() override;
-  void Process() override;
+  // Sets the minimum playout delays of the audio and video streams to get
+  // them in sync. To be called about once a second, on a single thread.
+  void UpdateDelays();
 
   // Gets the sync offset between the current played out audio frame and the
   // video |frame|. Returns true on success, false otherwise.
@@ -58,7 +58,6 @@ class RtpStreamsSynchronizer : public Module {
   StreamSynchronization::Measurements video_measurement_ RTC_GUARDED_BY(crit_);
 
   rtc::ThreadChecker process_thread_checker_;
-  int64_t last_sync_time_ RTC_GUARDED_BY(&process_thread_checker_);
 };
 
 }  // namespace webrtc
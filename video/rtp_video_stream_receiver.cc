@@ -204,6 +204,11 @@ int32_t RtpVideoStreamReceiver::OnReceivedPayloadData(
       nack_module_ ? nack_module_->OnReceivedPacket(packet) : -1;
   packet.receive_time_ms = clock_->TimeInMilliseconds();
 
+  // Dropped after the NACK module has seen the packet, so that it isn't
+  // NACKed.
+  if (FilterLayers(&packet))
+    return 0;
+
   if (packet.sizeBytes == 0) {
     NotifyReceiverOfEmptyPacket(packet.seqNum);
     return 0;
@@ -483,6 +488,41 @@ void RtpVideoStreamReceiver::NotifyReceiverOfEmptyPacket(uint16_t seq_num) {
   packet_buffer_->PaddingReceived(seq_num);
 }
 
+bool RtpVideoStreamReceiver::FilterLayers(VCMPacket* packet) {
+  const auto& type_header = packet->video_header.video_type_header;
+  if (packet->codec == kVideoCodecVP8) {
+    const auto* vp8 = absl::get_if<RTPVideoHeaderVP8>(&type_header);
+    if (!vp8 || !config_.max_temporal_layer ||
+        vp8->temporalIdx == kNoTemporalIdx ||
+        vp8->temporalIdx <= *config_.max_temporal_layer) {
+      return false;
+    }
+    // Frames of lower layers must not wait for the dropped frame.
+    if (vp8->pictureId != kNoPictureId)
+      reference_finder_->FrameDroppedVp8(vp8->pictureId);
+    return true;
+  }
+
+  if (packet->codec == kVideoCodecVP9) {
+    const auto* vp9 = absl::get_if<RTPVideoHeaderVP9>(&type_header);
+    if (!vp9)
+      return false;
+    if (config_.max_temporal_layer && vp9->temporal_idx != kNoTemporalIdx &&
+        vp9->temporal_idx > *config_.max_temporal_layer) {
+      return true;
+    }
+    if (config_.max_spatial_layer && vp9->spatial_idx != kNoSpatialIdx) {
+      if (vp9->spatial_idx > *config_.max_spatial_layer)
+        return true;
+      // The marker bit, which ends the frame in the packet buffer, is on the
+      // last packet of the top layer, which is dropped.
+      if (vp9->spatial_idx == *config_.max_spatial_layer && vp9->end_of_frame)
+        packet->markerBit = true;
+    }
+  }
+  return false;
+}
+
 void RtpVideoStreamReceiver::NotifyReceiverOfFecPacket(
     const RTPHeader& header) {
   if (nack_module_) {
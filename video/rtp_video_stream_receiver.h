@@ -149,6 +149,10 @@ class RtpVideoStreamReceiver : public RtpData,
                                          size_t packet_length,
                                          const RTPHeader& header);
   void NotifyReceiverOfEmptyPacket(uint16_t seq_num);
+  // Returns true if |packet| is of a layer above |config_.max_spatial_layer|
+  // or |config_.max_temporal_layer|. Marks the last kept packet of a VP9
+  // superframe whose top layers are dropped as its end.
+  bool FilterLayers(VCMPacket* packet);
   void NotifyReceiverOfFecPacket(const RTPHeader& header);
   bool IsPacketRetransmitted(const RTPHeader& header) const;
   void UpdateHistograms();
@@ -21,6 +21,7 @@
 #include "modules/video_coding/include/video_coding_defines.h"
 #include "modules/video_coding/packet.h"
 #include "modules/video_coding/rtp_frame_reference_finder.h"
+#include "rtc_base/arraysize.h"
 #include "rtc_base/bytebuffer.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
@@ -406,6 +407,71 @@ TEST_F(RtpVideoStreamReceiverTest, PaddingInMediaStream) {
   rtp_video_stream_receiver_->OnReceivedPayloadData(nullptr, 0, &header);
 }
 
+TEST_F(RtpVideoStreamReceiverTest, DropsVp8TemporalLayersAboveMax) {
+  config_.max_temporal_layer = 1;
+  const std::vector<uint8_t> data({1, 2, 3, 4});
+  mock_on_complete_frame_callback_.AppendExpectedBitstream(data.data(),
+                                                           data.size());
+  // A 0212 pattern, of which the frames of layer 2 are dropped. The frames of
+  // layer 1 that reference the frames before them of layer 2 in the pattern
+  // don't wait for those.
+  const uint8_t kTemporalIdx[] = {0, 2, 1, 2, 0, 2, 1, 2, 0};
+  EXPECT_CALL(mock_on_complete_frame_callback_, DoOnCompleteFrame(_)).Times(5);
+  for (uint16_t i = 0; i < arraysize(kTemporalIdx); ++i) {
+    WebRtcRTPHeader rtp_header = {};
+    rtp_header.header.sequenceNumber = i;
+    rtp_header.header.markerBit = true;
+    rtp_header.frameType = i == 0 ? kVideoFrameKey : kVideoFrameDelta;
+    rtp_header.video_header().is_first_packet_in_frame = true;
+    rtp_header.video_header().codec = kVideoCodecVP8;
+    RTPVideoHeaderVP8& vp8 = rtp_header.video_header().vp8();
+    vp8.InitRTPVideoHeaderVP8();
+    vp8.pictureId = 100 + i;
+    vp8.tl0PicIdx = i / 4;
+    vp8.temporalIdx = kTemporalIdx[i];
+    vp8.layerSync = i == 2;
+    rtp_video_stream_receiver_->OnReceivedPayloadData(data.data(), data.size(),
+                                                      &rtp_header);
+  }
+}
+
+TEST_F(RtpVideoStreamReceiverTest, DropsVp9SpatialLayersAboveMax) {
+  config_.max_spatial_layer = 0;
+  const std::vector<uint8_t> base_layer({1, 2, 3, 4});
+  const std::vector<uint8_t> top_layer({5, 6, 7});
+  mock_on_complete_frame_callback_.AppendExpectedBitstream(base_layer.data(),
+                                                           base_layer.size());
+  EXPECT_CALL(mock_on_complete_frame_callback_, DoOnCompleteFrame(_));
+
+  // A key frame of two spatial layers, of which only the base layer is kept.
+  WebRtcRTPHeader rtp_header = {};
+  rtp_header.frameType = kVideoFrameKey;
+  rtp_header.video_header().codec = kVideoCodecVP9;
+  RTPVideoHeaderVP9& vp9 = rtp_header.video_header()
+                               .video_type_header.emplace<RTPVideoHeaderVP9>();
+  vp9.InitRTPVideoHeaderVP9();
+  vp9.flexible_mode = true;
+  vp9.picture_id = 10;
+  vp9.temporal_idx = 0;
+  vp9.num_spatial_layers = 2;
+  vp9.beginning_of_frame = true;
+  vp9.end_of_frame = true;
+
+  rtp_header.header.sequenceNumber = 1;
+  rtp_header.video_header().is_first_packet_in_frame = true;
+  vp9.spatial_idx = 0;
+  rtp_video_stream_receiver_->OnReceivedPayloadData(
+      base_layer.data(), base_layer.size(), &rtp_header);
+
+  rtp_header.header.sequenceNumber = 2;
+  rtp_header.header.markerBit = true;
+  rtp_header.video_header().is_first_packet_in_frame = false;
+  vp9.spatial_idx = 1;
+  vp9.inter_layer_predicted = true;
+  rtp_video_stream_receiver_->OnReceivedPayloadData(
+      top_layer.data(), top_layer.size(), &rtp_header);
+}
+
 TEST_F(RtpVideoStreamReceiverTest, RequestKeyframeIfFirstFrameIsDelta) {
   WebRtcRTPHeader rtp_header = {};
   const std::vector<uint8_t> data({1, 2, 3, 4});
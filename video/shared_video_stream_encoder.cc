@@ -0,0 +1,451 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/shared_video_stream_encoder.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "api/video/video_stream_encoder_create.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/strings/string_builder.h"
+
+namespace webrtc {
+namespace {
+
+// Returns a string that differs between two configurations if the encoder
+// would be configured differently with them.
+std::string ConfigurationKey(const VideoEncoderConfig& config) {
+  char buf[8 * 1024];
+  rtc::SimpleStringBuilder ss(buf);
+  ss << config.ToString();
+  ss << ", video_format: " << config.video_format.name;
+  for (const auto& parameter : config.video_format.parameters)
+    ss << " " << parameter.first << "=" << parameter.second;
+  ss << ", video_stream_factory: "
+     << reinterpret_cast<uintptr_t>(config.video_stream_factory.get());
+  ss << ", encoder_specific_settings: "
+     << reinterpret_cast<uintptr_t>(config.encoder_specific_settings.get());
+  ss << ", max_bitrate_bps: " << config.max_bitrate_bps;
+  ss << ", bitrate_priority: " << config.bitrate_priority;
+  ss << ", number_of_streams: " << config.number_of_streams;
+  for (const VideoStream& layer : config.simulcast_layers)
+    ss << ", " << layer.ToString();
+  for (const SpatialLayer& layer : config.spatial_layers) {
+    ss << ", {" << layer.width << "x" << layer.height << " "
+       << layer.numberOfTemporalLayers << " " << layer.minBitrate << "-"
+       << layer.targetBitrate << "-" << layer.maxBitrate << " " << layer.qpMax
+       << " " << layer.active << "}";
+  }
+  return ss.str();
+}
+
+}  // namespace
+
+// The encoder interface of one send stream. Calls from the stream are
+// aggregated with those of the other streams by the SharedVideoStreamEncoder.
+class SharedVideoStreamEncoder::StreamEncoder
+    : public VideoStreamEncoderInterface {
+ public:
+  StreamEncoder(SharedVideoStreamEncoder* shared_encoder,
+                VideoStreamEncoderObserver* stats_observer)
+      : shared_encoder_(shared_encoder), stats_observer(stats_observer) {}
+
+  ~StreamEncoder() override {
+    if (!stopped_)
+      Stop();
+  }
+
+  void SetSource(rtc::VideoSourceInterface<VideoFrame>* source,
+                 const DegradationPreference& preference) override {
+    this->source = source;
+    degradation_preference = preference;
+    shared_encoder_->UpdateSource();
+  }
+
+  void SetSink(EncoderSink* sink, bool rotation_applied) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    this->sink = sink;
+    this->rotation_applied = rotation_applied;
+    shared_encoder_->UpdateSink();
+  }
+
+  void SetStartBitrate(int start_bitrate_bps) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    this->start_bitrate_bps = start_bitrate_bps;
+    shared_encoder_->UpdateStartBitrate();
+  }
+
+  void SendKeyFrame() override { shared_encoder_->encoder_->SendKeyFrame(); }
+
+  void OnBitrateUpdated(uint32_t bitrate_bps,
+                        uint8_t fraction_lost,
+                        int64_t round_trip_time_ms) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    this->bitrate_bps = bitrate_bps;
+    this->fraction_lost = fraction_lost;
+    this->round_trip_time_ms = round_trip_time_ms;
+    shared_encoder_->UpdateBitrate();
+  }
+
+  void SetBitrateAllocationObserver(
+      VideoBitrateAllocationObserver* bitrate_observer) override {
+    rtc::CritScope lock(&shared_encoder_->crit_);
+    this->bitrate_observer = bitrate_observer;
+  }
+
+  void ConfigureEncoder(VideoEncoderConfig config,
+                        size_t max_data_payload_length) override {
+    {
+      rtc::CritScope lock(&shared_encoder_->crit_);
+      this->max_data_payload_length = max_data_payload_length;
+    }
+    shared_encoder_->UpdateConfiguration(this, std::move(config));
+  }
+
+  void Stop() override {
+    stopped_ = true;
+    shared_encoder_->RemoveStream(this);
+  }
+
+  void OnFrame(const VideoFrame& frame) override {
+    shared_encoder_->encoder_->OnFrame(frame);
+  }
+
+  // Set on the thread of the SharedVideoStreamEncoder.
+  rtc::VideoSourceInterface<VideoFrame>* source = nullptr;
+  DegradationPreference degradation_preference =
+      DegradationPreference::DISABLED;
+
+  // Guarded by the |crit_| of the SharedVideoStreamEncoder.
+  VideoStreamEncoderObserver* const stats_observer;
+  EncoderSink* sink = nullptr;
+  bool rotation_applied = false;
+  absl::optional<int> start_bitrate_bps;
+  uint32_t bitrate_bps = 0;
+  uint8_t fraction_lost = 0;
+  int64_t round_trip_time_ms = 0;
+  VideoBitrateAllocationObserver* bitrate_observer = nullptr;
+  size_t max_data_payload_length = std::numeric_limits<size_t>::max();
+
+ private:
+  SharedVideoStreamEncoder* const shared_encoder_;
+  bool stopped_ = false;
+};
+
+SharedVideoStreamEncoder::SharedVideoStreamEncoder()
+    : SharedVideoStreamEncoder([](uint32_t number_of_cores,
+                                  VideoStreamEncoderObserver* observer,
+                                  const VideoStreamEncoderSettings& settings) {
+        return CreateVideoStreamEncoder(number_of_cores, observer, settings);
+      }) {}
+
+SharedVideoStreamEncoder::SharedVideoStreamEncoder(
+    EncoderFactory encoder_factory)
+    : encoder_factory_(std::move(encoder_factory)),
+      source_(nullptr),
+      max_data_payload_length_(0) {
+  thread_checker_.DetachFromThread();
+}
+
+SharedVideoStreamEncoder::~SharedVideoStreamEncoder() {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  RTC_DCHECK(!encoder_);
+  RTC_DCHECK(streams_.empty());
+}
+
+std::unique_ptr<VideoStreamEncoderInterface>
+SharedVideoStreamEncoder::CreateStreamEncoder(
+    uint32_t number_of_cores,
+    VideoStreamEncoderObserver* encoder_stats_observer,
+    const VideoStreamEncoderSettings& settings) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  if (!encoder_) {
+    encoder_ = encoder_factory_(number_of_cores, this, settings);
+    encoder_->SetBitrateAllocationObserver(this);
+  }
+  auto stream = absl::make_unique<StreamEncoder>(this, encoder_stats_observer);
+  rtc::CritScope lock(&crit_);
+  streams_.push_back(stream.get());
+  RTC_LOG(LS_INFO) << "Added stream to shared encoder, " << streams_.size()
+                   << " streams.";
+  return std::move(stream);
+}
+
+void SharedVideoStreamEncoder::RemoveStream(StreamEncoder* stream) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  bool last_stream;
+  {
+    // Once removed, the stream is not called back, even if an encoded image is
+    // being delivered to the other streams.
+    rtc::CritScope lock(&crit_);
+    auto it = std::find(streams_.begin(), streams_.end(), stream);
+    RTC_DCHECK(it != streams_.end());
+    streams_.erase(it);
+    last_stream = streams_.empty();
+    if (!last_stream) {
+      UpdateSink();
+      UpdateStartBitrate();
+      UpdateBitrate();
+    }
+  }
+  RTC_LOG(LS_INFO) << "Removed stream from shared encoder.";
+
+  if (!last_stream) {
+    UpdateSource();
+    return;
+  }
+  // Not stopped while holding |crit_|, since Stop waits for the encoder queue,
+  // which may be delivering an encoded image.
+  encoder_->Stop();
+  encoder_.reset();
+  source_ = nullptr;
+  rtc::CritScope lock(&crit_);
+  rotation_applied_.reset();
+  start_bitrate_bps_.reset();
+  bitrate_bps_.reset();
+  encoder_config_.clear();
+  max_data_payload_length_ = 0;
+  encoder_configuration_.reset();
+}
+
+void SharedVideoStreamEncoder::UpdateSource() {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  // The frames come from the source of the oldest stream that has one.
+  const StreamEncoder* source_stream = nullptr;
+  {
+    rtc::CritScope lock(&crit_);
+    for (const StreamEncoder* stream : streams_) {
+      if (stream->source) {
+        source_stream = stream;
+        break;
+      }
+    }
+  }
+  rtc::VideoSourceInterface<VideoFrame>* source =
+      source_stream ? source_stream->source : nullptr;
+  if (source == source_ && source)
+    return;
+  source_ = source;
+  encoder_->SetSource(source, source_stream
+                                  ? source_stream->degradation_preference
+                                  : DegradationPreference::DISABLED);
+}
+
+void SharedVideoStreamEncoder::UpdateSink() {
+  // Rotation is applied at the source if any of the receivers doesn't support
+  // the rotation extension.
+  bool rotation_applied = false;
+  for (const StreamEncoder* stream : streams_)
+    rotation_applied |= stream->sink && stream->rotation_applied;
+  if (rotation_applied_ == rotation_applied)
+    return;
+  rotation_applied_ = rotation_applied;
+  encoder_->SetSink(this, rotation_applied);
+}
+
+void SharedVideoStreamEncoder::UpdateStartBitrate() {
+  absl::optional<int> start_bitrate_bps;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->start_bitrate_bps) {
+      start_bitrate_bps = std::min(
+          start_bitrate_bps.value_or(std::numeric_limits<int>::max()),
+          *stream->start_bitrate_bps);
+    }
+  }
+  if (!start_bitrate_bps || start_bitrate_bps == start_bitrate_bps_)
+    return;
+  start_bitrate_bps_ = start_bitrate_bps;
+  encoder_->SetStartBitrate(*start_bitrate_bps);
+}
+
+void SharedVideoStreamEncoder::UpdateBitrate() {
+  // Paused streams, with a zero target, don't limit the others. The encoder is
+  // paused when all the streams are.
+  uint32_t bitrate_bps = 0;
+  uint8_t fraction_lost = 0;
+  int64_t round_trip_time_ms = 0;
+  for (const StreamEncoder* stream : streams_) {
+    if (stream->bitrate_bps == 0)
+      continue;
+    bitrate_bps = bitrate_bps == 0
+                      ? stream->bitrate_bps
+                      : std::min(bitrate_bps, stream->bitrate_bps);
+    fraction_lost = std::max(fraction_lost, stream->fraction_lost);
+    round_trip_time_ms =
+        std::max(round_trip_time_ms, stream->round_trip_time_ms);
+  }
+  // Don't signal the pause more than once.
+  if (bitrate_bps == 0 && bitrate_bps_ == 0u)
+    return;
+  bitrate_bps_ = bitrate_bps;
+  encoder_->OnBitrateUpdated(bitrate_bps, fraction_lost, round_trip_time_ms);
+}
+
+void SharedVideoStreamEncoder::UpdateConfiguration(StreamEncoder* stream,
+                                                   VideoEncoderConfig config) {
+  absl::optional<EncoderConfiguration> current_configuration;
+  EncoderSink* sink = nullptr;
+  {
+    rtc::CritScope lock(&crit_);
+    size_t max_data_payload_length = std::numeric_limits<size_t>::max();
+    for (const StreamEncoder* s : streams_) {
+      max_data_payload_length =
+          std::min(max_data_payload_length, s->max_data_payload_length);
+    }
+    std::string encoder_config = ConfigurationKey(config);
+    if (encoder_config != encoder_config_ ||
+        max_data_payload_length != max_data_payload_length_) {
+      encoder_config_ = encoder_config;
+      max_data_payload_length_ = max_data_payload_length;
+      encoder_->ConfigureEncoder(std::move(config), max_data_payload_length);
+      return;
+    }
+    // The encoder already runs with this configuration, the stream only needs
+    // to know the resulting streams.
+    current_configuration = encoder_configuration_;
+    sink = stream->sink;
+  }
+  if (current_configuration && sink) {
+    sink->OnEncoderConfigurationChanged(
+        std::move(current_configuration->streams),
+        current_configuration->min_transmit_bitrate_bps);
+  }
+}
+
+EncodedImageCallback::Result SharedVideoStreamEncoder::OnEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const RTPFragmentationHeader* fragmentation) {
+  rtc::CritScope lock(&crit_);
+  absl::optional<EncodedImageCallback::Result> result;
+  for (StreamEncoder* stream : streams_) {
+    if (!stream->sink)
+      continue;
+    EncodedImageCallback::Result stream_result = stream->sink->OnEncodedImage(
+        encoded_image, codec_specific_info, fragmentation);
+    if (!result)
+      result = stream_result;
+  }
+  return result.value_or(EncodedImageCallback::Result(
+      EncodedImageCallback::Result::ERROR_SEND_FAILED));
+}
+
+void SharedVideoStreamEncoder::OnDroppedFrame(
+    EncodedImageCallback::DropReason reason) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_) {
+    if (stream->sink)
+      stream->sink->OnDroppedFrame(reason);
+  }
+}
+
+void SharedVideoStreamEncoder::OnEncoderConfigurationChanged(
+    std::vector<VideoStream> streams,
+    int min_transmit_bitrate_bps) {
+  rtc::CritScope lock(&crit_);
+  encoder_configuration_ = EncoderConfiguration{streams,
+                                                min_transmit_bitrate_bps};
+  for (StreamEncoder* stream : streams_) {
+    if (stream->sink)
+      stream->sink->OnEncoderConfigurationChanged(streams,
+                                                  min_transmit_bitrate_bps);
+  }
+}
+
+void SharedVideoStreamEncoder::OnEncodedFrameTimeMeasured(
+    int encode_duration_ms,
+    int encode_usage_percent) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_) {
+    stream->stats_observer->OnEncodedFrameTimeMeasured(encode_duration_ms,
+                                                       encode_usage_percent);
+  }
+}
+
+void SharedVideoStreamEncoder::OnIncomingFrame(int width, int height) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_)
+    stream->stats_observer->OnIncomingFrame(width, height);
+}
+
+void SharedVideoStreamEncoder::OnSendEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_info) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_)
+    stream->stats_observer->OnSendEncodedImage(encoded_image, codec_info);
+}
+
+void SharedVideoStreamEncoder::OnFrameDropped(
+    VideoStreamEncoderObserver::DropReason reason) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_)
+    stream->stats_observer->OnFrameDropped(reason);
+}
+
+void SharedVideoStreamEncoder::OnEncoderReconfigured(
+    const VideoEncoderConfig& encoder_config,
+    const std::vector<VideoStream>& streams) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_)
+    stream->stats_observer->OnEncoderReconfigured(encoder_config, streams);
+}
+
+void SharedVideoStreamEncoder::OnAdaptationChanged(
+    AdaptationReason reason,
+    const AdaptationSteps& cpu_steps,
+    const AdaptationSteps& quality_steps) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_) {
+    stream->stats_observer->OnAdaptationChanged(reason, cpu_steps,
+                                                quality_steps);
+  }
+}
+
+void SharedVideoStreamEncoder::OnMinPixelLimitReached() {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_)
+    stream->stats_observer->OnMinPixelLimitReached();
+}
+
+void SharedVideoStreamEncoder::OnInitialQualityResolutionAdaptDown() {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_)
+    stream->stats_observer->OnInitialQualityResolutionAdaptDown();
+}
+
+void SharedVideoStreamEncoder::OnSuspendChange(bool is_suspended) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_)
+    stream->stats_observer->OnSuspendChange(is_suspended);
+}
+
+int SharedVideoStreamEncoder::GetInputFrameRate() const {
+  // All the streams see the same input.
+  rtc::CritScope lock(&crit_);
+  if (streams_.empty())
+    return 0;
+  return streams_.front()->stats_observer->GetInputFrameRate();
+}
+
+void SharedVideoStreamEncoder::OnBitrateAllocationUpdated(
+    const VideoBitrateAllocation& allocation) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_) {
+    if (stream->bitrate_observer)
+      stream->bitrate_observer->OnBitrateAllocationUpdated(allocation);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_SHARED_VIDEO_STREAM_ENCODER_H_
+#define VIDEO_SHARED_VIDEO_STREAM_ENCODER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/video/video_bitrate_allocator.h"
+#include "api/video/video_stream_encoder_interface.h"
+#include "api/video/video_stream_encoder_observer.h"
+#include "api/video/video_stream_encoder_settings.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/thread_checker.h"
+
+namespace webrtc {
+
+// Encodes the frames of one source once for several VideoSendStreams, e.g.
+// when the same source is sent to many receivers over separate
+// PeerConnections. Set as VideoSendStream::Config::shared_encoder of each of
+// the streams, which then packetize and send the same encoded images
+// independently, instead of each running its own VideoStreamEncoder.
+//
+// The encoder is created with the settings of the first stream and runs at the
+// lowest target bitrate of the streams that are not paused, with the highest
+// packet loss and round trip time among them. A key frame requested by any
+// stream is sent on all of them. The streams should be configured with the
+// same VideoEncoderConfig; the last configuration set is used.
+//
+// The streams must be created and destroyed on the same thread, e.g. the
+// worker thread of the PeerConnectionFactory shared by the PeerConnections,
+// and the shared encoder must outlive them.
+class SharedVideoStreamEncoder
+    : public VideoStreamEncoderInterface::EncoderSink,
+      public VideoStreamEncoderObserver,
+      public VideoBitrateAllocationObserver {
+ public:
+  using EncoderFactory =
+      std::function<std::unique_ptr<VideoStreamEncoderInterface>(
+          uint32_t number_of_cores,
+          VideoStreamEncoderObserver* encoder_stats_observer,
+          const VideoStreamEncoderSettings& settings)>;
+
+  SharedVideoStreamEncoder();
+  // Creates the encoder with |encoder_factory| instead of
+  // CreateVideoStreamEncoder, for tests.
+  explicit SharedVideoStreamEncoder(EncoderFactory encoder_factory);
+  ~SharedVideoStreamEncoder() override;
+
+  // Returns the encoder interface used by one send stream, which reports its
+  // encoder stats to |encoder_stats_observer|. The shared encoder is created
+  // with |number_of_cores| and |settings| if the stream is the only one.
+  std::unique_ptr<VideoStreamEncoderInterface> CreateStreamEncoder(
+      uint32_t number_of_cores,
+      VideoStreamEncoderObserver* encoder_stats_observer,
+      const VideoStreamEncoderSettings& settings);
+
+  // Implements VideoStreamEncoderInterface::EncoderSink.
+  EncodedImageCallback::Result OnEncodedImage(
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const RTPFragmentationHeader* fragmentation) override;
+  void OnDroppedFrame(EncodedImageCallback::DropReason reason) override;
+  void OnEncoderConfigurationChanged(std::vector<VideoStream> streams,
+                                     int min_transmit_bitrate_bps) override;
+
+  // Implements VideoStreamEncoderObserver.
+  void OnEncodedFrameTimeMeasured(int encode_duration_ms,
+                                  int encode_usage_percent) override;
+  void OnIncomingFrame(int width, int height) override;
+  void OnSendEncodedImage(const EncodedImage& encoded_image,
+                          const CodecSpecificInfo* codec_info) override;
+  void OnFrameDropped(VideoStreamEncoderObserver::DropReason reason) override;
+  void OnEncoderReconfigured(const VideoEncoderConfig& encoder_config,
+                             const std::vector<VideoStream>& streams) override;
+  void OnAdaptationChanged(AdaptationReason reason,
+                           const AdaptationSteps& cpu_steps,
+                           const AdaptationSteps& quality_steps) override;
+  void OnMinPixelLimitReached() override;
+  void OnInitialQualityResolutionAdaptDown() override;
+  void OnSuspendChange(bool is_suspended) override;
+  int GetInputFrameRate() const override;
+
+  // Implements VideoBitrateAllocationObserver.
+  void OnBitrateAllocationUpdated(
+      const VideoBitrateAllocation& allocation) override;
+
+ private:
+  class StreamEncoder;
+
+  struct EncoderConfiguration {
+    std::vector<VideoStream> streams;
+    int min_transmit_bitrate_bps;
+  };
+
+  void RemoveStream(StreamEncoder* stream);
+  void UpdateSource();
+  void UpdateSink() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateStartBitrate() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateBitrate() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void UpdateConfiguration(StreamEncoder* stream, VideoEncoderConfig config);
+
+  const EncoderFactory encoder_factory_;
+  rtc::ThreadChecker thread_checker_;
+  // Created for the first stream and destroyed with the last one, on the
+  // thread of |thread_checker_|. Used by the streams on any thread in between.
+  std::unique_ptr<VideoStreamEncoderInterface> encoder_;
+  rtc::VideoSourceInterface<VideoFrame>* source_
+      RTC_GUARDED_BY(thread_checker_);
+
+  // Guards the streams, which are called back on the encoder queue, and the
+  // state that they update from their worker queues.
+  rtc::CriticalSection crit_;
+  std::vector<StreamEncoder*> streams_ RTC_GUARDED_BY(crit_);
+  absl::optional<bool> rotation_applied_ RTC_GUARDED_BY(crit_);
+  absl::optional<int> start_bitrate_bps_ RTC_GUARDED_BY(crit_);
+  absl::optional<uint32_t> bitrate_bps_ RTC_GUARDED_BY(crit_);
+  std::string encoder_config_ RTC_GUARDED_BY(crit_);
+  size_t max_data_payload_length_ RTC_GUARDED_BY(crit_);
+  // The last configuration reported by the encoder, passed on to streams that
+  // are added later.
+  absl::optional<EncoderConfiguration> encoder_configuration_
+      RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedVideoStreamEncoder);
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_SHARED_VIDEO_STREAM_ENCODER_H_
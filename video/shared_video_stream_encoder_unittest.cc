@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/shared_video_stream_encoder.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "video/test/mock_video_stream_encoder.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class MockEncoderSink : public VideoStreamEncoderInterface::EncoderSink {
+ public:
+  MOCK_METHOD3(OnEncodedImage,
+               Result(const EncodedImage&,
+                      const CodecSpecificInfo*,
+                      const RTPFragmentationHeader*));
+  MOCK_METHOD1(OnDroppedFrame, void(EncodedImageCallback::DropReason));
+  MOCK_METHOD2(OnEncoderConfigurationChanged,
+               void(std::vector<VideoStream>, int));
+};
+
+class MockEncoderStatsObserver : public VideoStreamEncoderObserver {
+ public:
+  MOCK_METHOD2(OnEncodedFrameTimeMeasured, void(int, int));
+  MOCK_METHOD2(OnIncomingFrame, void(int, int));
+  MOCK_METHOD2(OnSendEncodedImage,
+               void(const EncodedImage&, const CodecSpecificInfo*));
+  MOCK_METHOD1(OnFrameDropped, void(DropReason));
+  MOCK_METHOD2(OnEncoderReconfigured,
+               void(const VideoEncoderConfig&,
+                    const std::vector<VideoStream>&));
+  MOCK_METHOD3(OnAdaptationChanged,
+               void(AdaptationReason,
+                    const AdaptationSteps&,
+                    const AdaptationSteps&));
+  MOCK_METHOD0(OnMinPixelLimitReached, void());
+  MOCK_METHOD0(OnInitialQualityResolutionAdaptDown, void());
+  MOCK_METHOD1(OnSuspendChange, void(bool));
+  MOCK_CONST_METHOD0(GetInputFrameRate, int());
+};
+
+class SharedVideoStreamEncoderTest : public ::testing::Test {
+ protected:
+  SharedVideoStreamEncoderTest()
+      : shared_encoder_([this](uint32_t, VideoStreamEncoderObserver*,
+                               const VideoStreamEncoderSettings&) {
+          ++num_created_encoders_;
+          auto encoder = absl::make_unique<NiceMock<MockVideoStreamEncoder>>();
+          encoder_ = encoder.get();
+          return std::move(encoder);
+        }) {}
+
+  std::unique_ptr<VideoStreamEncoderInterface> CreateStream(
+      VideoStreamEncoderInterface::EncoderSink* sink) {
+    std::unique_ptr<VideoStreamEncoderInterface> stream =
+        shared_encoder_.CreateStreamEncoder(1, &stats_observer_, settings_);
+    stream->SetSink(sink, false);
+    return stream;
+  }
+
+  int num_created_encoders_ = 0;
+  NiceMock<MockVideoStreamEncoder>* encoder_ = nullptr;
+  NiceMock<MockEncoderStatsObserver> stats_observer_;
+  SharedVideoStreamEncoder shared_encoder_;
+  const VideoStreamEncoderSettings settings_;
+};
+
+}  // namespace
+
+TEST_F(SharedVideoStreamEncoderTest, CreatesEncoderOnceAndStopsWithLastStream) {
+  NiceMock<MockEncoderSink> sink1;
+  NiceMock<MockEncoderSink> sink2;
+  std::unique_ptr<VideoStreamEncoderInterface> stream1 = CreateStream(&sink1);
+  std::unique_ptr<VideoStreamEncoderInterface> stream2 = CreateStream(&sink2);
+  EXPECT_EQ(1, num_created_encoders_);
+
+  EXPECT_CALL(*encoder_, Stop()).Times(0);
+  stream1->Stop();
+  ::testing::Mock::VerifyAndClearExpectations(encoder_);
+
+  EXPECT_CALL(*encoder_, Stop());
+  stream2->Stop();
+}
+
+TEST_F(SharedVideoStreamEncoderTest, DeliversEncodedImagesToAllStreams) {
+  NiceMock<MockEncoderSink> sink1;
+  NiceMock<MockEncoderSink> sink2;
+  std::unique_ptr<VideoStreamEncoderInterface> stream1 = CreateStream(&sink1);
+  std::unique_ptr<VideoStreamEncoderInterface> stream2 = CreateStream(&sink2);
+
+  const EncodedImageCallback::Result kOk(EncodedImageCallback::Result::OK);
+  EncodedImage image;
+  EXPECT_CALL(sink1, OnEncodedImage(_, _, _)).WillOnce(Return(kOk));
+  EXPECT_CALL(sink2, OnEncodedImage(_, _, _)).WillOnce(Return(kOk));
+  shared_encoder_.OnEncodedImage(image, nullptr, nullptr);
+
+  // A stopped stream is not called back.
+  stream1->Stop();
+  EXPECT_CALL(sink1, OnEncodedImage(_, _, _)).Times(0);
+  EXPECT_CALL(sink2, OnEncodedImage(_, _, _)).WillOnce(Return(kOk));
+  shared_encoder_.OnEncodedImage(image, nullptr, nullptr);
+}
+
+TEST_F(SharedVideoStreamEncoderTest, EncodesAtLowestBitrateOfActiveStreams) {
+  NiceMock<MockEncoderSink> sink1;
+  NiceMock<MockEncoderSink> sink2;
+  std::unique_ptr<VideoStreamEncoderInterface> stream1 = CreateStream(&sink1);
+  std::unique_ptr<VideoStreamEncoderInterface> stream2 = CreateStream(&sink2);
+
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(500000, 10, 100));
+  stream1->OnBitrateUpdated(500000, 10, 100);
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(300000, 20, 100));
+  stream2->OnBitrateUpdated(300000, 20, 50);
+
+  // A paused stream doesn't limit the other one.
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(500000, 10, 100));
+  stream2->OnBitrateUpdated(0, 0, 50);
+
+  // The encoder is paused once all the streams are.
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(0, 0, 0));
+  stream1->OnBitrateUpdated(0, 0, 100);
+  ::testing::Mock::VerifyAndClearExpectations(encoder_);
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(_, _, _)).Times(0);
+  stream2->OnBitrateUpdated(0, 0, 50);
+}
+
+TEST_F(SharedVideoStreamEncoderTest, RequestsKeyFrameForAnyStream) {
+  NiceMock<MockEncoderSink> sink1;
+  NiceMock<MockEncoderSink> sink2;
+  std::unique_ptr<VideoStreamEncoderInterface> stream1 = CreateStream(&sink1);
+  std::unique_ptr<VideoStreamEncoderInterface> stream2 = CreateStream(&sink2);
+
+  EXPECT_CALL(*encoder_, SendKeyFrame()).Times(2);
+  stream1->SendKeyFrame();
+  stream2->SendKeyFrame();
+}
+
+TEST_F(SharedVideoStreamEncoderTest, ReconfiguresEncoderOnlyOnChange) {
+  NiceMock<MockEncoderSink> sink1;
+  NiceMock<MockEncoderSink> sink2;
+  std::unique_ptr<VideoStreamEncoderInterface> stream1 = CreateStream(&sink1);
+  std::unique_ptr<VideoStreamEncoderInterface> stream2 = CreateStream(&sink2);
+
+  VideoEncoderConfig config;
+  config.number_of_streams = 1;
+  EXPECT_CALL(*encoder_, MockedConfigureEncoder(_, 1200));
+  stream1->ConfigureEncoder(config.Copy(), 1200);
+  EXPECT_CALL(sink1, OnEncoderConfigurationChanged(_, 100000));
+  EXPECT_CALL(sink2, OnEncoderConfigurationChanged(_, 100000));
+  shared_encoder_.OnEncoderConfigurationChanged(std::vector<VideoStream>(1),
+                                                100000);
+  ::testing::Mock::VerifyAndClearExpectations(encoder_);
+
+  // The same configuration is only passed on to the stream that sets it.
+  EXPECT_CALL(*encoder_, MockedConfigureEncoder(_, _)).Times(0);
+  EXPECT_CALL(sink1, OnEncoderConfigurationChanged(_, _)).Times(0);
+  EXPECT_CALL(sink2, OnEncoderConfigurationChanged(_, 100000));
+  stream2->ConfigureEncoder(config.Copy(), 1200);
+  ::testing::Mock::VerifyAndClearExpectations(encoder_);
+
+  config.number_of_streams = 2;
+  EXPECT_CALL(*encoder_, MockedConfigureEncoder(_, 1200));
+  stream2->ConfigureEncoder(config.Copy(), 1200);
+}
+
+}  // namespace webrtc
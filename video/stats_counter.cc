@@ -12,7 +12,7 @@
 
 #include <algorithm>
 #include <limits>
-#include <map>
+#include <vector>
 
 #include "rtc_base/checks.h"
 #include "system_wrappers/include/clock.h"
@@ -85,17 +85,19 @@ class Samples {
   ~Samples() {}
 
   void Add(int sample, uint32_t stream_id) {
-    samples_[stream_id].Add(sample);
+    GetStats(stream_id)->Add(sample);
     ++total_count_;
   }
   void Set(int64_t sample, uint32_t stream_id) {
-    samples_[stream_id].Set(sample);
+    GetStats(stream_id)->Set(sample);
     ++total_count_;
   }
   void SetLast(int64_t sample, uint32_t stream_id) {
-    samples_[stream_id].SetLast(sample);
+    GetStats(stream_id)->SetLast(sample);
+  }
+  int64_t GetLast(uint32_t stream_id) {
+    return GetStats(stream_id)->GetLast();
   }
-  int64_t GetLast(uint32_t stream_id) { return samples_[stream_id].GetLast(); }
 
   int64_t Count() const { return total_count_; }
   bool Empty() const { return total_count_ == 0; }
@@ -103,20 +105,20 @@ class Samples {
   int64_t Sum() const {
     int64_t sum = 0;
     for (const auto& it : samples_)
-      sum += it.second.sum_;
+      sum += it.stats.sum_;
     return sum;
   }
 
   int Max() const {
     int max = std::numeric_limits<int>::min();
     for (const auto& it : samples_)
-      max = std::max(it.second.max_, max);
+      max = std::max(it.stats.max_, max);
     return max;
   }
 
   void Reset() {
     for (auto& it : samples_)
-      it.second.Reset();
+      it.stats.Reset();
     total_count_ = 0;
   }
 
@@ -124,8 +126,8 @@ class Samples {
     int64_t sum_diff = 0;
     int count = 0;
     for (const auto& it : samples_) {
-      if (it.second.count_ > 0) {
-        int64_t diff = it.second.sum_ - it.second.last_sum_;
+      if (it.stats.count_ > 0) {
+        int64_t diff = it.stats.sum_ - it.stats.last_sum_;
         if (diff >= 0) {
           sum_diff += diff;
           ++count;
@@ -162,8 +164,24 @@ class Samples {
     int64_t last_sum_ = 0;
   };
 
+  struct StreamStats {
+    uint32_t stream_id;
+    Stats stats;
+  };
+
+  // Counters have samples of one stream, or a few, and samples are added
+  // per frame or packet, so the streams are searched in a flat array.
+  Stats* GetStats(uint32_t stream_id) {
+    for (auto& it : samples_) {
+      if (it.stream_id == stream_id)
+        return &it.stats;
+    }
+    samples_.push_back({stream_id, Stats()});
+    return &samples_.back().stats;
+  }
+
   int64_t total_count_;
-  std::map<uint32_t, Stats> samples_;  // Gathered samples mapped by stream id.
+  std::vector<StreamStats> samples_;  // Gathered samples of each stream id.
 };
 
 // StatsCounter class.
@@ -322,6 +322,20 @@ TEST_F(StatsCounterTest, TestRateAccCounter_NegativeRateIgnored) {
   EXPECT_EQ(200, stats.average);
 }
 
+TEST_F(StatsCounterTest, TestRateAccCounter_SumsRatesOfStreams) {
+  const uint32_t kStreamId2 = kStreamId + 1;
+  StatsCounterObserverImpl* observer = new StatsCounterObserverImpl();
+  RateAccCounter counter(&clock_, observer, true);
+  counter.SetLast(1000, kStreamId2);
+  counter.Set(200, kStreamId);
+  counter.Set(1400, kStreamId2);
+  clock_.AdvanceTimeMilliseconds(kDefaultProcessIntervalMs);
+  // Trigger process (sample included in next interval).
+  counter.Set(2000, kStreamId);
+  EXPECT_EQ(1, observer->num_calls_);
+  EXPECT_EQ((200 + 400) / 2, observer->last_sample_);
+}
+
 TEST_F(StatsCounterTest, TestAvgCounter_IntervalsWithoutSamplesIncluded) {
   // Samples: | 6 | x | x | 8 |  // x: empty interval
   // Stats:   | 6 | 6 | 6 | 8 |  // x -> last value reported
@@ -12,12 +12,14 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <utility>
 
 #include "absl/memory/memory.h"
 #include "absl/types/optional.h"
+#include "api/video/video_memory_accountant.h"
 #include "call/rtp_stream_receiver_controller_interface.h"
 #include "call/rtx_receive_stream.h"
 #include "common_types.h"  // NOLINT(build/include)
@@ -30,7 +32,7 @@
 #include "modules/video_coding/include/video_coding.h"
 #include "modules/video_coding/jitter_estimator.h"
 #include "modules/video_coding/timing.h"
-#include "modules/video_coding/utility/ivf_file_writer.h"
+#include "modules/video_coding/utility/async_ivf_file_writer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/location.h"
 #include "rtc_base/logging.h"
@@ -43,6 +45,9 @@
 namespace webrtc {
 
 namespace {
+constexpr int kMaxWaitForFrameMs = 3000;
+constexpr int kMaxWaitForKeyFrameMs = 200;
+
 VideoCodec CreateDecoderVideoCodec(const VideoReceiveStream::Decoder& decoder) {
   VideoCodec codec;
   memset(&codec, 0, sizeof(codec));
@@ -74,6 +79,14 @@ VideoCodec CreateDecoderVideoCodec(const VideoReceiveStream::Decoder& decoder) {
 
   return codec;
 }
+
+bool HasDecoderInstances(const VideoReceiveStream::Config& config) {
+  for (const VideoReceiveStream::Decoder& decoder : config.decoders) {
+    if (decoder.decoder)
+      return true;
+  }
+  return false;
+}
 }  // namespace
 
 namespace internal {
@@ -84,9 +97,12 @@ VideoReceiveStream::VideoReceiveStream(
     PacketRouter* packet_router,
     VideoReceiveStream::Config config,
     ProcessThread* process_thread,
-    CallStats* call_stats)
+    CallStats* call_stats,
+    DecodeScheduler* decode_scheduler,
+    RtpStreamsSyncService* sync_service)
     : transport_adapter_(config.rtcp_send_transport),
       config_(std::move(config)),
+      decoding_enabled_(HasDecoderInstances(config_)),
       num_cpu_cores_(num_cpu_cores),
       process_thread_(process_thread),
       clock_(Clock::GetRealTimeClock()),
@@ -94,6 +110,7 @@ VideoReceiveStream::VideoReceiveStream(
                      this,
                      "DecodingThread",
                      rtc::kHighestPriority),
+      decode_scheduler_(decode_scheduler),
       call_stats_(call_stats),
       rtp_receive_statistics_(ReceiveStatistics::Create(clock_)),
       timing_(new VCMTiming(clock_)),
@@ -109,7 +126,8 @@ VideoReceiveStream::VideoReceiveStream(
                                  this,   // NackSender
                                  this,   // KeyFrameRequestSender
                                  this),  // OnCompleteFrameCallback
-      rtp_stream_sync_(this) {
+      rtp_stream_sync_(this),
+      sync_service_(sync_service) {
   RTC_LOG(LS_INFO) << "VideoReceiveStream: " << config_.ToString();
 
   RTC_DCHECK(process_thread_);
@@ -119,8 +137,11 @@ VideoReceiveStream::VideoReceiveStream(
 
   RTC_DCHECK(!config_.decoders.empty());
   std::set<int> decoder_payload_types;
+  RTC_CHECK(decoding_enabled_ || config_.encoded_frame_sink)
+      << "Decoders without decoder instances require an encoded frame sink.";
   for (const Decoder& decoder : config_.decoders) {
-    RTC_CHECK(decoder.decoder);
+    RTC_CHECK_EQ(decoding_enabled_, decoder.decoder != nullptr)
+        << "Either all or none of the decoders must have decoder instances.";
     RTC_CHECK(decoder_payload_types.find(decoder.payload_type) ==
               decoder_payload_types.end())
         << "Duplicate payload type (" << decoder.payload_type
@@ -133,8 +154,18 @@ VideoReceiveStream::VideoReceiveStream(
   jitter_estimator_.reset(new VCMJitterEstimator(clock_));
   frame_buffer_.reset(new video_coding::FrameBuffer(
       clock_, jitter_estimator_.get(), timing_.get(), &stats_proxy_));
-
-  process_thread_->RegisterModule(&rtp_stream_sync_, RTC_FROM_HERE);
+  if (config_.decode_immediately || !decoding_enabled_)
+    frame_buffer_->SetDecodeImmediately(true);
+  if (!config_.jitter_estimator_state.empty()) {
+    absl::optional<VCMJitterEstimator::State> jitter_state =
+        VCMJitterEstimator::State::Parse(config_.jitter_estimator_state);
+    if (jitter_state) {
+      frame_buffer_->SetJitterEstimatorState(*jitter_state);
+    } else {
+      RTC_LOG(LS_WARNING) << "Ignoring malformed jitter estimator state: "
+                          << config_.jitter_estimator_state;
+    }
+  }
 
   // Register with RtpStreamReceiverController.
   media_receiver_ = receiver_controller->CreateReceiver(
@@ -152,8 +183,6 @@ VideoReceiveStream::~VideoReceiveStream() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
   RTC_LOG(LS_INFO) << "~VideoReceiveStream: " << config_.ToString();
   Stop();
-
-  process_thread_->DeRegisterModule(&rtp_stream_sync_);
 }
 
 void VideoReceiveStream::SignalNetworkState(NetworkState state) {
@@ -168,11 +197,13 @@ bool VideoReceiveStream::DeliverRtcp(const uint8_t* packet, size_t length) {
 void VideoReceiveStream::SetSync(Syncable* audio_syncable) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
   rtp_stream_sync_.ConfigureSync(audio_syncable);
+  has_audio_sync_ = audio_syncable != nullptr;
+  UpdateSyncRegistration();
 }
 
 void VideoReceiveStream::Start() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
-  if (decode_thread_.IsRunning())
+  if (decode_thread_.IsRunning() || decoding_scheduled_ || forwarding_frames_)
     return;
 
   bool protected_by_fec = config_.rtp.protected_by_flexfec ||
@@ -186,9 +217,23 @@ void VideoReceiveStream::Start() {
   }
 
   transport_adapter_.Enable();
+
+  if (!decoding_enabled_) {
+    // Frames are passed on from OnCompleteFrame as they become ready, so
+    // neither the VCM decoders nor a decode thread are needed.
+    for (const Decoder& decoder : config_.decoders) {
+      VideoCodec codec = CreateDecoderVideoCodec(decoder);
+      rtp_video_stream_receiver_.AddReceiveCodec(codec, decoder.codec_params);
+    }
+    call_stats_->RegisterStatsObserver(this);
+    forwarding_frames_ = true;
+    rtp_video_stream_receiver_.StartReceive();
+    return;
+  }
+
   rtc::VideoSinkInterface<VideoFrame>* renderer = nullptr;
   if (config_.renderer) {
-    if (config_.disable_prerenderer_smoothing) {
+    if (config_.disable_prerenderer_smoothing || config_.decode_immediately) {
       renderer = this;
     } else {
       incoming_video_stream_.reset(
@@ -222,7 +267,14 @@ void VideoReceiveStream::Start() {
   // Start the decode thread
   video_receiver_.DecoderThreadStarting();
   stats_proxy_.DecoderThreadStarting();
-  decode_thread_.Start();
+  if (decode_scheduler_) {
+    decode_timeout_ms_ = clock_->TimeInMilliseconds() + MaxWaitForFrameMs();
+    decode_scheduler_->RegisterStream(this);
+    decoding_scheduled_ = true;
+  } else {
+    decode_thread_.Start();
+  }
+  UpdateSyncRegistration();
   rtp_video_stream_receiver_.StartReceive();
 }
 
@@ -237,13 +289,18 @@ void VideoReceiveStream::Stop() {
   call_stats_->DeregisterStatsObserver(this);
   process_thread_->DeRegisterModule(&video_receiver_);
 
-  if (decode_thread_.IsRunning()) {
+  if (decode_thread_.IsRunning() || decoding_scheduled_) {
     // TriggerDecoderShutdown will release any waiting decoder thread and make
     // it stop immediately, instead of waiting for a timeout. Needs to be called
     // before joining the decoder thread.
     video_receiver_.TriggerDecoderShutdown();
 
-    decode_thread_.Stop();
+    if (decoding_scheduled_) {
+      decode_scheduler_->DeRegisterStream(this);
+      decoding_scheduled_ = false;
+    } else {
+      decode_thread_.Stop();
+    }
     video_receiver_.DecoderThreadStopped();
     stats_proxy_.DecoderThreadStopped();
     // Deregister external decoders so they are no longer running during
@@ -253,26 +310,50 @@ void VideoReceiveStream::Stop() {
     for (const Decoder& decoder : config_.decoders)
       video_receiver_.RegisterExternalDecoder(nullptr, decoder.payload_type);
   }
+  forwarding_frames_ = false;
 
   video_stream_decoder_.reset();
   incoming_video_stream_.reset();
+  UpdateSyncRegistration();
   transport_adapter_.Disable();
 }
 
+void VideoReceiveStream::UpdateSyncRegistration() {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
+  const bool sync = sync_service_ && video_stream_decoder_ && has_audio_sync_;
+  if (sync == sync_registered_)
+    return;
+  if (sync) {
+    sync_service_->AddSynchronizer(&rtp_stream_sync_);
+  } else {
+    sync_service_->RemoveSynchronizer(&rtp_stream_sync_);
+  }
+  sync_registered_ = sync;
+}
+
 VideoReceiveStream::Stats VideoReceiveStream::GetStats() const {
   return stats_proxy_.GetStats();
 }
 
+std::string VideoReceiveStream::GetJitterEstimatorState() const {
+  return frame_buffer_->GetJitterEstimatorState().ToString();
+}
+
 void VideoReceiveStream::EnableEncodedFrameRecording(rtc::PlatformFile file,
                                                      size_t byte_limit) {
+  std::unique_ptr<AsyncIvfFileWriter> ivf_writer;
+  if (file != rtc::kInvalidPlatformFileValue) {
+    ivf_writer =
+        AsyncIvfFileWriter::Wrap(rtc::File(file), byte_limit,
+                                 AsyncIvfFileWriter::kDefaultMaxQueuedBytes);
+  }
   {
     rtc::CritScope lock(&ivf_writer_lock_);
-    if (file == rtc::kInvalidPlatformFileValue) {
-      ivf_writer_.reset();
-    } else {
-      ivf_writer_ = IvfFileWriter::Wrap(rtc::File(file), byte_limit);
-    }
+    ivf_writer_.swap(ivf_writer);
   }
+  // The previous writer, if any, finishes its queued writes without holding
+  // up decoding.
+  ivf_writer.reset();
 
   if (file != rtc::kInvalidPlatformFileValue) {
     // Make a keyframe appear as early as possible in the logs, to give actually
@@ -350,16 +431,48 @@ void VideoReceiveStream::OnCompleteFrame(
   // partially enabled inter-layer prediction.
   frame->id.spatial_layer = 0;
 
+  // Drop frames instead of buffering them while video frames use more memory
+  // than allowed, then wait for a key frame to decode from.
+  if (VideoMemoryAccountant::IsOverCap()) {
+    if (!dropping_frames_for_memory_cap_) {
+      RTC_LOG(LS_WARNING) << "Dropping received frames due to the video "
+                             "memory cap.";
+    }
+    dropping_frames_for_memory_cap_ = true;
+    keyframe_requested_for_memory_cap_ = false;
+    return;
+  }
+  if (dropping_frames_for_memory_cap_) {
+    if (!frame->is_keyframe()) {
+      if (!keyframe_requested_for_memory_cap_) {
+        RequestKeyFrame();
+        keyframe_requested_for_memory_cap_ = true;
+      }
+      return;
+    }
+    dropping_frames_for_memory_cap_ = false;
+  }
+
   int64_t last_continuous_pid = frame_buffer_->InsertFrame(std::move(frame));
-  if (last_continuous_pid != -1)
+  if (last_continuous_pid != -1) {
     rtp_video_stream_receiver_.FrameContinuous(last_continuous_pid);
+    if (!decoding_enabled_) {
+      ForwardEncodedFrames();
+      return;
+    }
+    // The new frame may be decodable before the frame the scheduler is
+    // waiting for.
+    if (decode_scheduler_)
+      decode_scheduler_->WakeUp(this);
+  }
 }
 
 void VideoReceiveStream::OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&module_process_sequence_checker_);
   frame_buffer_->UpdateRtt(max_rtt_ms);
   rtp_video_stream_receiver_.UpdateRtt(max_rtt_ms);
-  video_stream_decoder_->UpdateRtt(max_rtt_ms);
+  if (decoding_enabled_)
+    video_stream_decoder_->UpdateRtt(max_rtt_ms);
 }
 
 int VideoReceiveStream::id() const {
@@ -396,10 +509,7 @@ void VideoReceiveStream::DecodeThreadFunction(void* ptr) {
 
 bool VideoReceiveStream::Decode() {
   TRACE_EVENT0("webrtc", "VideoReceiveStream::Decode");
-  static const int kMaxWaitForFrameMs = 3000;
-  static const int kMaxWaitForKeyFrameMs = 200;
-
-  int wait_ms = keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
+  int wait_ms = MaxWaitForFrameMs();
   std::unique_ptr<video_coding::EncodedFrame> frame;
   // TODO(philipel): Call NextFrame with |keyframe_required| argument when
   //                 downstream project has been fixed.
@@ -411,52 +521,106 @@ bool VideoReceiveStream::Decode() {
   }
 
   if (frame) {
-    int64_t now_ms = clock_->TimeInMilliseconds();
     RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kFrameFound);
-    int decode_result = video_receiver_.Decode(frame.get());
-    if (decode_result == WEBRTC_VIDEO_CODEC_OK ||
-        decode_result == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME) {
-      keyframe_required_ = false;
-      frame_decoded_ = true;
-      rtp_video_stream_receiver_.FrameDecoded(frame->id.picture_id);
-
-      if (decode_result == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME)
-        RequestKeyFrame();
-    } else if (!frame_decoded_ || !keyframe_required_ ||
-               (last_keyframe_request_ms_ + kMaxWaitForKeyFrameMs < now_ms)) {
-      keyframe_required_ = true;
-      // TODO(philipel): Remove this keyframe request when downstream project
-      //                 has been fixed.
-      RequestKeyFrame();
-      last_keyframe_request_ms_ = now_ms;
-    }
+    HandleEncodedFrame(std::move(frame));
   } else {
     RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kTimeout);
-    int64_t now_ms = clock_->TimeInMilliseconds();
-    absl::optional<int64_t> last_packet_ms =
-        rtp_video_stream_receiver_.LastReceivedPacketMs();
-    absl::optional<int64_t> last_keyframe_packet_ms =
-        rtp_video_stream_receiver_.LastReceivedKeyframePacketMs();
-
-    // To avoid spamming keyframe requests for a stream that is not active we
-    // check if we have received a packet within the last 5 seconds.
-    bool stream_is_active = last_packet_ms && now_ms - *last_packet_ms < 5000;
-    if (!stream_is_active)
-      stats_proxy_.OnStreamInactive();
-
-    // If we recently have been receiving packets belonging to a keyframe then
-    // we assume a keyframe is currently being received.
-    bool receiving_keyframe =
-        last_keyframe_packet_ms &&
-        now_ms - *last_keyframe_packet_ms < kMaxWaitForKeyFrameMs;
-
-    if (stream_is_active && !receiving_keyframe) {
-      RTC_LOG(LS_WARNING) << "No decodable frame in " << wait_ms
-                          << " ms, requesting keyframe.";
-      RequestKeyFrame();
-    }
+    HandleFrameBufferTimeout(wait_ms);
   }
   return true;
 }
+
+int64_t VideoReceiveStream::DecodeNextFrame() {
+  TRACE_EVENT0("webrtc", "VideoReceiveStream::DecodeNextFrame");
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  std::unique_ptr<video_coding::EncodedFrame> frame;
+  int64_t wait_ms = 0;
+  video_coding::FrameBuffer::ReturnReason res = frame_buffer_->PollNextFrame(
+      std::max<int64_t>(decode_timeout_ms_ - now_ms, 0), &frame, &wait_ms);
+
+  // Stop deregisters the stream right after stopping the frame buffer.
+  if (res == video_coding::FrameBuffer::ReturnReason::kStopped)
+    return kMaxWaitForFrameMs;
+
+  if (frame) {
+    RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kFrameFound);
+    HandleEncodedFrame(std::move(frame));
+  } else if (wait_ms > 0) {
+    return wait_ms;
+  } else {
+    HandleFrameBufferTimeout(MaxWaitForFrameMs());
+  }
+  decode_timeout_ms_ = clock_->TimeInMilliseconds() + MaxWaitForFrameMs();
+  return 0;
+}
+
+void VideoReceiveStream::HandleEncodedFrame(
+    std::unique_ptr<video_coding::EncodedFrame> frame) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  if (config_.encoded_frame_sink)
+    config_.encoded_frame_sink->OnFrame(*frame);
+  int decode_result = video_receiver_.Decode(frame.get());
+  if (decode_result == WEBRTC_VIDEO_CODEC_OK ||
+      decode_result == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME) {
+    keyframe_required_ = false;
+    frame_decoded_ = true;
+    rtp_video_stream_receiver_.FrameDecoded(frame->id.picture_id);
+
+    if (decode_result == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME)
+      RequestKeyFrame();
+  } else if (!frame_decoded_ || !keyframe_required_ ||
+             (last_keyframe_request_ms_ + kMaxWaitForKeyFrameMs < now_ms)) {
+    keyframe_required_ = true;
+    // TODO(philipel): Remove this keyframe request when downstream project
+    //                 has been fixed.
+    RequestKeyFrame();
+    last_keyframe_request_ms_ = now_ms;
+  }
+}
+
+void VideoReceiveStream::HandleFrameBufferTimeout(int wait_ms) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  absl::optional<int64_t> last_packet_ms =
+      rtp_video_stream_receiver_.LastReceivedPacketMs();
+  absl::optional<int64_t> last_keyframe_packet_ms =
+      rtp_video_stream_receiver_.LastReceivedKeyframePacketMs();
+
+  // To avoid spamming keyframe requests for a stream that is not active we
+  // check if we have received a packet within the last 5 seconds.
+  bool stream_is_active = last_packet_ms && now_ms - *last_packet_ms < 5000;
+  if (!stream_is_active)
+    stats_proxy_.OnStreamInactive();
+
+  // If we recently have been receiving packets belonging to a keyframe then
+  // we assume a keyframe is currently being received.
+  bool receiving_keyframe =
+      last_keyframe_packet_ms &&
+      now_ms - *last_keyframe_packet_ms < kMaxWaitForKeyFrameMs;
+
+  if (stream_is_active && !receiving_keyframe) {
+    RTC_LOG(LS_WARNING) << "No decodable frame in " << wait_ms
+                        << " ms, requesting keyframe.";
+    RequestKeyFrame();
+  }
+}
+
+int VideoReceiveStream::MaxWaitForFrameMs() const {
+  return keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
+}
+
+void VideoReceiveStream::ForwardEncodedFrames() {
+  TRACE_EVENT0("webrtc", "VideoReceiveStream::ForwardEncodedFrames");
+  std::unique_ptr<video_coding::EncodedFrame> frame;
+  int64_t wait_ms = 0;
+  // The frame buffer is in decode immediately mode, so every frame that is
+  // ready is returned without waiting.
+  while (frame_buffer_->PollNextFrame(0, &frame, &wait_ms) ==
+         video_coding::FrameBuffer::ReturnReason::kFrameFound) {
+    config_.encoded_frame_sink->OnFrame(*frame);
+    // Lets the packet buffer and reference finder drop the state of frames
+    // up to this one, as if it had been decoded.
+    rtp_video_stream_receiver_.FrameDecoded(frame->id.picture_id);
+  }
+}
 }  // namespace internal
 }  // namespace webrtc
@@ -23,7 +23,9 @@
 #include "modules/video_coding/video_coding_impl.h"
 #include "rtc_base/sequenced_task_checker.h"
 #include "system_wrappers/include/clock.h"
+#include "video/decode_scheduler.h"
 #include "video/receive_statistics_proxy.h"
+#include "video/rtp_streams_sync_service.h"
 #include "video/rtp_streams_synchronizer.h"
 #include "video/rtp_video_stream_receiver.h"
 #include "video/transport_adapter.h"
@@ -32,7 +34,7 @@
 namespace webrtc {
 
 class CallStats;
-class IvfFileWriter;
+class AsyncIvfFileWriter;
 class ProcessThread;
 class RTPFragmentationHeader;
 class RtpStreamReceiverInterface;
@@ -50,14 +52,18 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
                            public KeyFrameRequestSender,
                            public video_coding::OnCompleteFrameCallback,
                            public Syncable,
-                           public CallStatsObserver {
+                           public CallStatsObserver,
+                           public DecodeScheduler::Stream {
  public:
+  // If |decode_scheduler| is null the stream decodes on a thread of its own.
   VideoReceiveStream(RtpStreamReceiverControllerInterface* receiver_controller,
                      int num_cpu_cores,
                      PacketRouter* packet_router,
                      VideoReceiveStream::Config config,
                      ProcessThread* process_thread,
-                     CallStats* call_stats);
+                     CallStats* call_stats,
+                     DecodeScheduler* decode_scheduler,
+                     RtpStreamsSyncService* sync_service);
   ~VideoReceiveStream() override;
 
   const Config& config() const { return config_; }
@@ -72,6 +78,7 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   void Stop() override;
 
   webrtc::VideoReceiveStream::Stats GetStats() const override;
+  std::string GetJitterEstimatorState() const override;
 
   // Takes ownership of the file, is responsible for closing it later.
   // Calling this method will close and finalize any current log.
@@ -112,20 +119,41 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   uint32_t GetPlayoutTimestamp() const override;
   void SetMinimumPlayoutDelay(int delay_ms) override;
 
+  // Implements DecodeScheduler::Stream.
+  int64_t DecodeNextFrame() override;
+
  private:
   static void DecodeThreadFunction(void* ptr);
   bool Decode();
+  void HandleEncodedFrame(std::unique_ptr<video_coding::EncodedFrame> frame);
+  void HandleFrameBufferTimeout(int wait_ms);
+  int MaxWaitForFrameMs() const;
+  // Passes the frames that are ready in |frame_buffer_| on to
+  // |config_.encoded_frame_sink|, when frames are not decoded.
+  void ForwardEncodedFrames();
+  // Adds |rtp_stream_sync_| to |sync_service_| while frames are decoded for
+  // rendering and there is an audio stream to sync with, and removes it
+  // otherwise.
+  void UpdateSyncRegistration();
 
   rtc::SequencedTaskChecker worker_sequence_checker_;
   rtc::SequencedTaskChecker module_process_sequence_checker_;
 
   TransportAdapter transport_adapter_;
   const VideoReceiveStream::Config config_;
+  // False if |config_.decoders| have no decoder instances, in which case frames
+  // are only passed on to |config_.encoded_frame_sink|.
+  const bool decoding_enabled_;
   const int num_cpu_cores_;
   ProcessThread* const process_thread_;
   Clock* const clock_;
 
   rtc::PlatformThread decode_thread_;
+  DecodeScheduler* const decode_scheduler_;
+  // If the stream is registered with |decode_scheduler_|.
+  bool decoding_scheduled_ = false;
+  // If the stream is started without decoding frames.
+  bool forwarding_frames_ = false;
 
   CallStats* const call_stats_;
 
@@ -140,9 +168,13 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   RtpVideoStreamReceiver rtp_video_stream_receiver_;
   std::unique_ptr<VideoStreamDecoder> video_stream_decoder_;
   RtpStreamsSynchronizer rtp_stream_sync_;
+  RtpStreamsSyncService* const sync_service_;
+  bool has_audio_sync_ = false;
+  bool sync_registered_ = false;
 
   rtc::CriticalSection ivf_writer_lock_;
-  std::unique_ptr<IvfFileWriter> ivf_writer_ RTC_GUARDED_BY(ivf_writer_lock_);
+  std::unique_ptr<AsyncIvfFileWriter> ivf_writer_
+      RTC_GUARDED_BY(ivf_writer_lock_);
 
   // Members for the new jitter buffer experiment.
   std::unique_ptr<VCMJitterEstimator> jitter_estimator_;
@@ -160,6 +192,15 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   bool frame_decoded_ = false;
 
   int64_t last_keyframe_request_ms_ = 0;
+
+  // When DecodeNextFrame gives up waiting for a decodable frame, the scheduled
+  // counterpart of the NextFrame timeout of the decode thread.
+  int64_t decode_timeout_ms_ = 0;
+
+  // Set while received frames are dropped because of the video memory cap,
+  // until a key frame can be inserted. Only used by OnCompleteFrame.
+  bool dropping_frames_for_memory_cap_ = false;
+  bool keyframe_requested_for_memory_cap_ = false;
 };
 }  // namespace internal
 }  // namespace webrtc
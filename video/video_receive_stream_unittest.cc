@@ -13,6 +13,7 @@
 #include "test/gmock.h"
 #include "test/gtest.h"
 
+#include "api/video/encoded_frame.h"
 #include "api/video_codecs/video_decoder.h"
 #include "call/rtp_stream_receiver_controller.h"
 #include "media/base/fakevideorenderer.h"
@@ -61,6 +62,20 @@ class MockVideoDecoder : public VideoDecoder {
   const char* ImplementationName() const { return "MockVideoDecoder"; }
 };
 
+class FakeEncodedFrameSink
+    : public rtc::VideoSinkInterface<video_coding::EncodedFrame> {
+ public:
+  void OnFrame(const video_coding::EncodedFrame& frame) override {
+    EXPECT_TRUE(frame.is_keyframe());
+    frame_event_.Set();
+  }
+
+  bool WaitForFrame() { return frame_event_.Wait(kDefaultTimeOutMs); }
+
+ private:
+  rtc::Event frame_event_{false, false};
+};
+
 }  // namespace
 
 class VideoReceiveStreamTest : public testing::Test {
@@ -91,7 +106,8 @@ class VideoReceiveStreamTest : public testing::Test {
 
     video_receive_stream_.reset(new webrtc::internal::VideoReceiveStream(
         &rtp_stream_receiver_controller_, kDefaultNumCpuCores, &packet_router_,
-        config_.Copy(), process_thread_.get(), &call_stats_));
+        config_.Copy(), process_thread_.get(), &call_stats_, nullptr,
+        nullptr));
   }
 
  protected:
@@ -136,4 +152,37 @@ TEST_F(VideoReceiveStreamTest, CreateFrameFromH264FmtpSpropAndIdr) {
   init_decode_event_.Wait(kDefaultTimeOutMs);
 }
 
+TEST_F(VideoReceiveStreamTest, PassesFramesToSinkWithoutDecoders) {
+  FakeEncodedFrameSink encoded_frame_sink;
+  VideoReceiveStream::Config config = config_.Copy();
+  config.rtp.remote_ssrc = 3333;
+  config.renderer = nullptr;
+  config.encoded_frame_sink = &encoded_frame_sink;
+  for (VideoReceiveStream::Decoder& decoder : config.decoders)
+    decoder.decoder = nullptr;
+  webrtc::internal::VideoReceiveStream passthrough_stream(
+      &rtp_stream_receiver_controller_, 2, &packet_router_, std::move(config),
+      process_thread_.get(), &call_stats_, nullptr);
+
+  constexpr uint8_t idr_nalu[] = {0x05, 0xFF, 0xFF, 0xFF};
+  RtpPacketToSend rtppacket(nullptr);
+  uint8_t* payload = rtppacket.AllocatePayload(sizeof(idr_nalu));
+  memcpy(payload, idr_nalu, sizeof(idr_nalu));
+  rtppacket.SetMarker(true);
+  rtppacket.SetSsrc(3333);
+  rtppacket.SetPayloadType(99);
+  rtppacket.SetSequenceNumber(1);
+  rtppacket.SetTimestamp(0);
+
+  // No decoder is initialized or called for the frame.
+  EXPECT_CALL(mock_h264_video_decoder_, InitDecode(_, _)).Times(0);
+  EXPECT_CALL(mock_h264_video_decoder_, Decode(_, _, _, _)).Times(0);
+  passthrough_stream.Start();
+  RtpPacketReceived parsed_packet;
+  ASSERT_TRUE(parsed_packet.Parse(rtppacket.data(), rtppacket.size()));
+  rtp_stream_receiver_controller_.OnRtpPacket(parsed_packet);
+  EXPECT_TRUE(encoded_frame_sink.WaitForFrame());
+  passthrough_stream.Stop();
+}
+
 }  // namespace webrtc
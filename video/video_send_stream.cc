@@ -14,6 +14,7 @@
 #include "api/video/video_stream_encoder_create.h"
 #include "modules/rtp_rtcp/source/rtp_sender.h"
 #include "rtc_base/logging.h"
+#include "video/shared_video_stream_encoder.h"
 #include "video/video_send_stream_impl.h"
 
 namespace webrtc {
@@ -78,9 +79,15 @@ VideoSendStream::VideoSendStream(
       content_type_(encoder_config.content_type) {
   RTC_DCHECK(config_.encoder_settings.encoder_factory);
 
-  video_stream_encoder_ = CreateVideoStreamEncoder(num_cpu_cores, &stats_proxy_,
-                                                   config_.encoder_settings,
-                                                   config_.pre_encode_callback);
+  if (config_.shared_encoder) {
+    RTC_DCHECK(!config_.pre_encode_callback);
+    video_stream_encoder_ = config_.shared_encoder->CreateStreamEncoder(
+        num_cpu_cores, &stats_proxy_, config_.encoder_settings);
+  } else {
+    video_stream_encoder_ = CreateVideoStreamEncoder(
+        num_cpu_cores, &stats_proxy_, config_.encoder_settings,
+        config_.pre_encode_callback);
+  }
   // TODO(srte): Initialization should not be done posted on a task queue.
   // Note that the posted task must not outlive this scope since the closure
   // references local variables.
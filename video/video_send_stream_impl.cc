@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "call/rtp_transport_controller_send_interface.h"
 #include "modules/pacing/packet_router.h"
@@ -218,7 +219,9 @@ VideoSendStreamImpl::VideoSendStreamImpl(
       video_stream_encoder_(video_stream_encoder),
       encoder_feedback_(Clock::GetRealTimeClock(),
                         config_->rtp.ssrcs,
-                        video_stream_encoder),
+                        video_stream_encoder,
+                        worker_queue,
+                        EncoderRtcpFeedback::Config()),
       bandwidth_observer_(transport->GetBandwidthObserver()),
       rtp_video_sender_(
           transport_->CreateRtpVideoSender(config_->rtp.ssrcs,
@@ -357,6 +360,8 @@ void VideoSendStreamImpl::UpdateActiveSimulcastLayers(
   RTC_LOG(LS_INFO) << "VideoSendStream::UpdateActiveSimulcastLayers";
   bool previously_active = rtp_video_sender_->IsActive();
   rtp_video_sender_->SetActiveModules(active_layers);
+  // Paused layers are no longer encoded, without reconfiguring the encoder.
+  video_stream_encoder_->SetActiveLayers(active_layers);
   if (!rtp_video_sender_->IsActive() && previously_active) {
     // Payload router switched from active to inactive.
     StopVideoSendStream();
@@ -433,6 +438,17 @@ void VideoSendStreamImpl::SignalEncoderTimedOut() {
 void VideoSendStreamImpl::OnBitrateAllocationUpdated(
     const VideoBitrateAllocation& allocation) {
   rtp_video_sender_->OnBitrateAllocationUpdated(allocation);
+  // Let the pacer share the link between the simulcast streams in proportion
+  // to their allocations. Spatial layers of a single stream share its SSRC.
+  const std::vector<uint32_t>& ssrcs = config_->rtp.ssrcs;
+  if (ssrcs.size() == 1) {
+    transport_->SetStreamAllocation(ssrcs[0], allocation.get_sum_bps());
+    return;
+  }
+  for (size_t i = 0; i < ssrcs.size(); ++i) {
+    transport_->SetStreamAllocation(ssrcs[i],
+                                    allocation.GetSpatialLayerSum(i));
+  }
 }
 
 void VideoSendStreamImpl::SignalEncoderActive() {
@@ -623,16 +639,19 @@ uint32_t VideoSendStreamImpl::OnBitrateUpdated(uint32_t bitrate_bps,
 void VideoSendStreamImpl::EnableEncodedFrameRecording(
     const std::vector<rtc::PlatformFile>& files,
     size_t byte_limit) {
+  std::unique_ptr<AsyncIvfFileWriter> file_writers[kMaxSimulcastStreams];
+  for (size_t i = 0; i < files.size() && i < kMaxSimulcastStreams; ++i) {
+    file_writers[i] =
+        AsyncIvfFileWriter::Wrap(rtc::File(files[i]), byte_limit,
+                                 AsyncIvfFileWriter::kDefaultMaxQueuedBytes);
+  }
   {
     rtc::CritScope lock(&ivf_writers_crit_);
-    for (unsigned int i = 0; i < kMaxSimulcastStreams; ++i) {
-      if (i < files.size()) {
-        file_writers_[i] = IvfFileWriter::Wrap(rtc::File(files[i]), byte_limit);
-      } else {
-        file_writers_[i].reset();
-      }
-    }
+    for (size_t i = 0; i < kMaxSimulcastStreams; ++i)
+      file_writers_[i].swap(file_writers[i]);
   }
+  // The previous writers, if any, finish their queued writes when going out
+  // of scope, without holding up the encoder.
 
   if (!files.empty()) {
     // Make a keyframe appear as early as possible in the logs, to give actually
@@ -16,7 +16,10 @@
 #include <utility>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
+#include "api/video/video_memory_accountant.h"
 #include "common_video/include/video_frame.h"
+#include "common_video/libyuv/include/parallel_libyuv.h"
 #include "modules/video_coding/include/video_codec_initializer.h"
 #include "modules/video_coding/include/video_coding.h"
 #include "rtc_base/arraysize.h"
@@ -45,6 +48,11 @@ const int64_t kPendingFrameTimeoutMs = 1000;
 // to try and achieve desired bitrate.
 const int kMaxInitialFramedrop = 4;
 
+// Number of frames encoded after the screen content stops changing, which
+// refine its quality, and the interval at which it is encoded after that.
+const int kNumUnchangedFramesToEncode = 2;
+const int64_t kUnchangedFrameIntervalMs = 1000;
+
 // Initial limits for BALANCED degradation preference.
 int MinFps(int pixels) {
   if (pixels <= 320 * 240) {
@@ -106,10 +114,19 @@ CpuOveruseOptions GetCpuOveruseOptions(
 // (encoder_queue_) where the encoder reports its VideoSinkWants.
 class VideoStreamEncoder::VideoSourceProxy {
  public:
-  explicit VideoSourceProxy(VideoStreamEncoder* video_stream_encoder)
+  VideoSourceProxy(VideoStreamEncoder* video_stream_encoder,
+                   bool drop_frames_at_source)
       : video_stream_encoder_(video_stream_encoder),
         degradation_preference_(DegradationPreference::DISABLED),
-        source_(nullptr) {}
+        source_(nullptr) {
+    if (drop_frames_at_source) {
+      // A frame that arrives while another one is waiting to be encoded
+      // replaces it, so the source can as well drop the new one.
+      sink_wants_.is_busy = [video_stream_encoder] {
+        return video_stream_encoder->posted_frames_waiting_for_encode_ > 0;
+      };
+    }
+  }
 
   void SetSource(rtc::VideoSourceInterface<VideoFrame>* source,
                  const DegradationPreference& degradation_preference) {
@@ -320,7 +337,8 @@ VideoStreamEncoder::VideoStreamEncoder(
       number_of_cores_(number_of_cores),
       initial_rampup_(0),
       quality_scaling_experiment_enabled_(QualityScalingExperiment::Enabled()),
-      source_proxy_(new VideoSourceProxy(this)),
+      source_proxy_(
+          new VideoSourceProxy(this, settings.drop_frames_at_source)),
       sink_(nullptr),
       settings_(settings),
       video_sender_(Clock::GetRealTimeClock(), this),
@@ -336,6 +354,7 @@ VideoStreamEncoder::VideoStreamEncoder(
       encoder_paused_and_dropped_frame_(false),
       clock_(Clock::GetRealTimeClock()),
       degradation_preference_(DegradationPreference::DISABLED),
+      encoder_speed_steps_(0),
       posted_frames_waiting_for_encode_(0),
       last_captured_timestamp_(0),
       delta_ntp_internal_ms_(clock_->CurrentNtpInMilliseconds() -
@@ -343,6 +362,8 @@ VideoStreamEncoder::VideoStreamEncoder(
       last_frame_log_ms_(clock_->TimeInMilliseconds()),
       captured_frame_count_(0),
       dropped_frame_count_(0),
+      num_unchanged_frames_encoded_(0),
+      encode_next_frame_(true),
       bitrate_observer_(nullptr),
       encoder_queue_("EncoderQueue") {
   RTC_DCHECK(encoder_stats_observer);
@@ -481,6 +502,7 @@ void VideoStreamEncoder::ConfigureEncoderOnTaskQueue(
 // "soft" reconfiguration.
 void VideoStreamEncoder::ReconfigureEncoder() {
   RTC_DCHECK(pending_encoder_reconfiguration_);
+  encode_next_frame_ = true;
   std::vector<VideoStream> streams =
       encoder_config_.video_stream_factory->CreateEncoderStreams(
           last_frame_info_->width, last_frame_info_->height, encoder_config_);
@@ -533,6 +555,9 @@ void VideoStreamEncoder::ReconfigureEncoder() {
   codec.expect_encode_from_texture = last_frame_info_->is_texture;
   max_framerate_ = codec.maxFramerate;
   RTC_DCHECK_LE(max_framerate_, kMaxFramerateFps);
+  send_codec_ = codec;
+  if (!active_layers_.empty())
+    UpdateRateAllocator();
 
   // Keep the same encoder, as long as the video_format is unchanged.
   if (pending_encoder_creation_) {
@@ -558,14 +583,19 @@ void VideoStreamEncoder::ReconfigureEncoder() {
     video_sender_.RegisterExternalEncoder(encoder_.get(),
                                           info.has_internal_source);
   }
-  // RegisterSendCodec implies an unconditional call to
-  // encoder_->InitEncode().
+  // RegisterSendCodec calls encoder_->InitEncode(), unless the change is one
+  // that the encoder can apply in place, e.g. a lower resolution.
   bool success = video_sender_.RegisterSendCodec(
                      &codec, number_of_cores_,
                      static_cast<uint32_t>(max_data_payload_length_)) == VCM_OK;
   if (!success) {
     RTC_LOG(LS_ERROR) << "Failed to configure encoder.";
     rate_allocator_.reset();
+  } else if (encoder_speed_steps_ > 0 &&
+             !encoder_->SetSpeedSteps(encoder_speed_steps_)) {
+    // InitEncode reset the speed, which can't be sped up as much, e.g. for a
+    // new codec.
+    encoder_speed_steps_ = 0;
   }
 
   video_sender_.UpdateChannelParameters(rate_allocator_.get(),
@@ -672,6 +702,16 @@ void VideoStreamEncoder::OnFrame(const VideoFrame& video_frame) {
 
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
 
+  if (VideoMemoryAccountant::IsOverCap()) {
+    // Don't hold on to more frames while video frames use more memory than
+    // allowed.
+    RTC_LOG(LS_VERBOSE)
+        << "Incoming frame dropped due to the video memory cap.";
+    encoder_stats_observer_->OnFrameDropped(
+        VideoStreamEncoderObserver::DropReason::kEncoderQueue);
+    return;
+  }
+
   int64_t post_time_us = rtc::TimeMicros();
   ++posted_frames_waiting_for_encode_;
 
@@ -813,9 +853,31 @@ void VideoStreamEncoder::MaybeEncodeVideoFrame(const VideoFrame& video_frame,
   }
 
   pending_frame_.reset();
+  if (DropUnchangedFrame(video_frame, now_ms))
+    return;
   EncodeVideoFrame(video_frame, time_when_posted_us);
 }
 
+bool VideoStreamEncoder::DropUnchangedFrame(const VideoFrame& video_frame,
+                                            int64_t now_ms) {
+  const bool unchanged =
+      encoder_config_.content_type ==
+          VideoEncoderConfig::ContentType::kScreen &&
+      video_frame.update_rect() && video_frame.update_rect()->IsEmpty();
+  if (unchanged && !encode_next_frame_ &&
+      num_unchanged_frames_encoded_ >= kNumUnchangedFramesToEncode &&
+      last_encode_time_ms_ &&
+      now_ms - *last_encode_time_ms_ < kUnchangedFrameIntervalMs) {
+    RTC_LOG(LS_VERBOSE) << "Dropping frame with unchanged content.";
+    return true;
+  }
+  num_unchanged_frames_encoded_ =
+      unchanged && !encode_next_frame_ ? num_unchanged_frames_encoded_ + 1 : 0;
+  last_encode_time_ms_ = now_ms;
+  encode_next_frame_ = false;
+  return false;
+}
+
 void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
                                           int64_t time_when_posted_us) {
   RTC_DCHECK_RUN_ON(&encoder_queue_);
@@ -826,17 +888,35 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
   if (crop_width_ > 0 || crop_height_ > 0) {
     int cropped_width = video_frame.width() - crop_width_;
     int cropped_height = video_frame.height() - crop_height_;
-    rtc::scoped_refptr<I420Buffer> cropped_buffer =
-        I420Buffer::Create(cropped_width, cropped_height);
+    rtc::scoped_refptr<VideoFrameBuffer> cropped_buffer;
     // TODO(ilnik): Remove scaling if cropping is too big, as it should never
     // happen after SinkWants signaled correctly from ReconfigureEncoder.
-    if (crop_width_ < 4 && crop_height_ < 4) {
-      cropped_buffer->CropAndScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420(), crop_width_ / 2,
-          crop_height_ / 2, cropped_width, cropped_height);
+    if (video_frame.video_frame_buffer()->type() ==
+        VideoFrameBuffer::Type::kNV12) {
+      // Keep NV12 frames in NV12, the encoder converts them if it has to.
+      rtc::scoped_refptr<NV12Buffer> nv12_buffer =
+          NV12Buffer::Create(cropped_width, cropped_height);
+      const NV12BufferInterface& src =
+          *video_frame.video_frame_buffer()->GetNV12();
+      if (crop_width_ < 4 && crop_height_ < 4) {
+        nv12_buffer->CropAndScaleFrom(src, crop_width_ / 2, crop_height_ / 2,
+                                      cropped_width, cropped_height);
+      } else {
+        nv12_buffer->ScaleFrom(src);
+      }
+      cropped_buffer = nv12_buffer;
     } else {
-      cropped_buffer->ScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420().get());
+      rtc::scoped_refptr<I420Buffer> i420_buffer =
+          I420Buffer::Create(cropped_width, cropped_height);
+      if (crop_width_ < 4 && crop_height_ < 4) {
+        ParallelCropAndScaleI420(*video_frame.video_frame_buffer()->ToI420(),
+                                 crop_width_ / 2, crop_height_ / 2,
+                                 cropped_width, cropped_height, i420_buffer);
+      } else {
+        ParallelScaleI420(*video_frame.video_frame_buffer()->ToI420(),
+                          i420_buffer);
+      }
+      cropped_buffer = i420_buffer;
     }
     out_frame =
         VideoFrame(cropped_buffer, video_frame.timestamp(),
@@ -852,6 +932,44 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
   video_sender_.AddVideoFrame(out_frame, nullptr);
 }
 
+void VideoStreamEncoder::SetActiveLayers(std::vector<bool> active_layers) {
+  encoder_queue_.PostTask([this, active_layers] {
+    RTC_DCHECK_RUN_ON(&encoder_queue_);
+    if (active_layers == active_layers_)
+      return;
+    active_layers_ = active_layers;
+    // Otherwise the layers are applied when the encoder is configured.
+    if (!rate_allocator_ || pending_encoder_reconfiguration_)
+      return;
+    UpdateRateAllocator();
+    // The encoder gets the new allocation with the next frame. Reallocate
+    // the last bitrate estimate, since the previous allocation left out the
+    // bitrate that the paused layers would have used.
+    if (last_observed_bitrate_bps_ > 0) {
+      video_sender_.SetChannelParameters(
+          last_observed_bitrate_bps_, last_observed_fraction_lost_,
+          last_observed_rtt_ms_, rate_allocator_.get(), bitrate_observer_);
+    } else {
+      video_sender_.UpdateChannelParameters(rate_allocator_.get(),
+                                            bitrate_observer_);
+    }
+  });
+}
+
+void VideoStreamEncoder::UpdateRateAllocator() {
+  VideoCodec codec = send_codec_;
+  const size_t num_streams =
+      std::max<size_t>(1, codec.numberOfSimulcastStreams);
+  bool any_active = false;
+  for (size_t i = 0; i < num_streams; ++i) {
+    if (i < active_layers_.size())
+      codec.simulcastStream[i].active = active_layers_[i];
+    any_active |= codec.simulcastStream[i].active;
+  }
+  codec.active = any_active;
+  rate_allocator_ = VideoCodecInitializer::CreateBitrateAllocator(codec);
+}
+
 void VideoStreamEncoder::SendKeyFrame() {
   if (!encoder_queue_.IsCurrent()) {
     encoder_queue_.PostTask([this] { SendKeyFrame(); });
@@ -859,6 +977,7 @@ void VideoStreamEncoder::SendKeyFrame() {
   }
   RTC_DCHECK_RUN_ON(&encoder_queue_);
   TRACE_EVENT0("webrtc", "OnKeyFrameRequest");
+  encode_next_frame_ = true;
   video_sender_.IntraFrameRequest(0);
 }
 
@@ -951,6 +1070,8 @@ void VideoStreamEncoder::OnBitrateUpdated(uint32_t bitrate_bps,
   bool video_is_suspended = bitrate_bps == 0;
   bool video_suspension_changed = video_is_suspended != EncoderPaused();
   last_observed_bitrate_bps_ = bitrate_bps;
+  last_observed_fraction_lost_ = fraction_lost;
+  last_observed_rtt_ms_ = round_trip_time_ms;
 
   if (video_suspension_changed) {
     RTC_LOG(LS_INFO) << "Video suspend state changed to: "
@@ -1018,6 +1139,15 @@ void VideoStreamEncoder::AdaptDown(AdaptReason reason) {
       return;
   }
 
+  if (reason == kCpu && settings_.encoder_speed_adaptation &&
+      encoder_->SetSpeedSteps(encoder_speed_steps_ + 1)) {
+    // Not recorded as |last_adaptation_request_|, which would keep the
+    // resolution from being lowered once the encoder can't be sped up more.
+    ++encoder_speed_steps_;
+    RTC_LOG(LS_INFO) << "Encoder speed steps: " << encoder_speed_steps_;
+    return;
+  }
+
   switch (degradation_preference_) {
     case DegradationPreference::BALANCED: {
       // Try scale down framerate, if lower.
@@ -1071,8 +1201,16 @@ void VideoStreamEncoder::AdaptUp(AdaptReason reason) {
 
   const AdaptCounter& adapt_counter = GetConstAdaptCounter();
   int num_downgrades = adapt_counter.TotalCount(reason);
-  if (num_downgrades == 0)
+  if (num_downgrades == 0) {
+    // The encoder is slowed down once the resolution and framerate are
+    // restored.
+    if (reason == kCpu && encoder_speed_steps_ > 0 &&
+        encoder_->SetSpeedSteps(encoder_speed_steps_ - 1)) {
+      --encoder_speed_steps_;
+      RTC_LOG(LS_INFO) << "Encoder speed steps: " << encoder_speed_steps_;
+    }
     return;
+  }
   RTC_DCHECK_GT(num_downgrades, 0);
 
   AdaptationRequest adaptation_request = {
@@ -68,6 +68,8 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   void ConfigureEncoder(VideoEncoderConfig config,
                         size_t max_data_payload_length) override;
 
+  void SetActiveLayers(std::vector<bool> active_layers) override;
+
   // Permanently stop encoding. After this method has returned, it is
   // guaranteed that no encoded frames will be delivered to the sink.
   void Stop() override;
@@ -104,6 +106,8 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   void ConfigureEncoderOnTaskQueue(VideoEncoderConfig config,
                                    size_t max_data_payload_length);
   void ReconfigureEncoder() RTC_RUN_ON(&encoder_queue_);
+  // Creates the bitrate allocator for |send_codec_| with |active_layers_|.
+  void UpdateRateAllocator() RTC_RUN_ON(&encoder_queue_);
 
   void ConfigureQualityScaler();
 
@@ -119,6 +123,10 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   // Indicates wether frame should be dropped because the pixel count is too
   // large for the current bitrate configuration.
   bool DropDueToSize(uint32_t pixel_count) const RTC_RUN_ON(&encoder_queue_);
+  // Returns true if |video_frame| is screen content that is the same as the
+  // previous frame, and doesn't need to be encoded.
+  bool DropUnchangedFrame(const VideoFrame& video_frame, int64_t now_ms)
+      RTC_RUN_ON(&encoder_queue_);
 
   // Implements EncodedImageCallback.
   EncodedImageCallback::Result OnEncodedImage(
@@ -221,6 +229,11 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   uint32_t encoder_start_bitrate_bps_ RTC_GUARDED_BY(&encoder_queue_);
   size_t max_data_payload_length_ RTC_GUARDED_BY(&encoder_queue_);
   uint32_t last_observed_bitrate_bps_ RTC_GUARDED_BY(&encoder_queue_);
+  uint8_t last_observed_fraction_lost_ RTC_GUARDED_BY(&encoder_queue_) = 0;
+  int64_t last_observed_rtt_ms_ RTC_GUARDED_BY(&encoder_queue_) = 0;
+  // The codec that the encoder was last configured with.
+  VideoCodec send_codec_ RTC_GUARDED_BY(&encoder_queue_);
+  std::vector<bool> active_layers_ RTC_GUARDED_BY(&encoder_queue_);
   bool encoder_paused_and_dropped_frame_ RTC_GUARDED_BY(&encoder_queue_);
   Clock* const clock_;
   // Counters used for deciding if the video resolution or framerate is
@@ -232,6 +245,9 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
       RTC_GUARDED_BY(&encoder_queue_);
   // Set depending on degradation preferences.
   DegradationPreference degradation_preference_ RTC_GUARDED_BY(&encoder_queue_);
+  // The speed steps set on the encoder by cpu adaptation, if
+  // VideoStreamEncoderSettings::encoder_speed_adaptation is set.
+  int encoder_speed_steps_ RTC_GUARDED_BY(&encoder_queue_);
 
   struct AdaptationRequest {
     // The pixel count produced by the source at the time of the adaptation.
@@ -261,6 +277,13 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   absl::optional<VideoFrame> pending_frame_ RTC_GUARDED_BY(&encoder_queue_);
   int64_t pending_frame_post_time_us_ RTC_GUARDED_BY(&encoder_queue_);
 
+  // Unchanged screen content is only encoded to refine the quality after a
+  // change, and then at a low rate to keep the stream alive.
+  int num_unchanged_frames_encoded_ RTC_GUARDED_BY(&encoder_queue_);
+  absl::optional<int64_t> last_encode_time_ms_ RTC_GUARDED_BY(&encoder_queue_);
+  // Set when a key frame is requested, which unchanged frames must not delay.
+  bool encode_next_frame_ RTC_GUARDED_BY(&encoder_queue_);
+
   VideoBitrateAllocationObserver* bitrate_observer_
       RTC_GUARDED_BY(&encoder_queue_);
   absl::optional<int64_t> last_parameters_update_ms_
@@ -13,6 +13,7 @@
 #include <utility>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/video_memory_accountant.h"
 #include "media/base/videoadapter.h"
 #include "modules/video_coding/codecs/vp8/temporal_layers.h"
 #include "modules/video_coding/codecs/vp9/include/vp9_globals.h"
@@ -527,6 +528,24 @@ class VideoStreamEncoderTest : public ::testing::Test {
       force_init_encode_failed_ = force_failure;
     }
 
+    void SetMaxSpeedSteps(int max_speed_steps) {
+      rtc::CritScope lock(&local_crit_sect_);
+      max_speed_steps_ = max_speed_steps;
+    }
+
+    int speed_steps() const {
+      rtc::CritScope lock(&local_crit_sect_);
+      return speed_steps_;
+    }
+
+    bool SetSpeedSteps(int steps) override {
+      rtc::CritScope lock(&local_crit_sect_);
+      if (steps < 0 || steps > max_speed_steps_)
+        return false;
+      speed_steps_ = steps;
+      return true;
+    }
+
    private:
     int32_t Encode(const VideoFrame& input_image,
                    const CodecSpecificInfo* codec_specific_info,
@@ -583,6 +602,8 @@ class VideoStreamEncoderTest : public ::testing::Test {
     std::vector<std::unique_ptr<TemporalLayers>> allocated_temporal_layers_
         RTC_GUARDED_BY(local_crit_sect_);
     bool force_init_encode_failed_ RTC_GUARDED_BY(local_crit_sect_) = false;
+    int max_speed_steps_ RTC_GUARDED_BY(local_crit_sect_) = 0;
+    int speed_steps_ RTC_GUARDED_BY(local_crit_sect_) = 0;
   };
 
   class TestSink : public VideoStreamEncoder::EncoderSink {
@@ -742,6 +763,22 @@ TEST_F(VideoStreamEncoderTest, DropsFramesWhenRateSetToZero) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, DropsFramesOverVideoMemoryCap) {
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  VideoMemoryAccountant::SetCapBytes(1);
+  VideoMemoryAccountant::OnAllocated(2);
+  rtc::Event frame_destroyed_event(false, false);
+  video_source_.IncomingCapturedFrame(CreateFrame(1, &frame_destroyed_event));
+  EXPECT_TRUE(frame_destroyed_event.Wait(kDefaultTimeoutMs));
+  ExpectDroppedFrame();
+
+  VideoMemoryAccountant::OnReleased(2);
+  VideoMemoryAccountant::SetCapBytes(0);
+  video_source_.IncomingCapturedFrame(CreateFrame(2, nullptr));
+  WaitForEncodedFrame(2);
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, DropsFramesWithSameOrOldNtpTimestamp) {
   video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
   video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
@@ -784,6 +821,78 @@ TEST_F(VideoStreamEncoderTest, DropsPendingFramesOnSlowEncode) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, ReportsBusyToSourceWhileFrameIsWaiting) {
+  video_send_config_.encoder_settings.drop_frames_at_source = true;
+  ConfigureEncoder(video_encoder_config_.Copy());
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  ASSERT_TRUE(video_source_.sink_wants().is_busy);
+  EXPECT_FALSE(video_source_.sink_wants().is_busy());
+
+  fake_encoder_.BlockNextEncode();
+  video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
+  WaitForEncodedFrame(1);
+  // The encoder thread is blocked, so the next frame waits to be encoded.
+  video_source_.IncomingCapturedFrame(CreateFrame(2, nullptr));
+  EXPECT_TRUE(video_source_.sink_wants().is_busy());
+  fake_encoder_.ContinueEncode();
+  WaitForEncodedFrame(2);
+  EXPECT_FALSE(video_source_.sink_wants().is_busy());
+
+  video_stream_encoder_->Stop();
+}
+
+TEST_F(VideoStreamEncoderTest, DoesNotReportBusyToSourceByDefault) {
+  EXPECT_FALSE(video_source_.sink_wants().is_busy);
+  video_stream_encoder_->Stop();
+}
+
+TEST_F(VideoStreamEncoderTest, SkipsUnchangedScreenshareFrames) {
+  ResetEncoder("VP8", 1, 1, 1, true);
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  auto create_unchanged_frame = [this](int64_t ntp_time_ms) {
+    VideoFrame frame = CreateFrame(ntp_time_ms, nullptr);
+    frame.set_update_rect(VideoFrame::UpdateRect{0, 0, 0, 0});
+    return frame;
+  };
+
+  video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
+  WaitForEncodedFrame(1);
+  // A couple of unchanged frames are encoded to refine the quality.
+  video_source_.IncomingCapturedFrame(create_unchanged_frame(2));
+  WaitForEncodedFrame(2);
+  video_source_.IncomingCapturedFrame(create_unchanged_frame(3));
+  WaitForEncodedFrame(3);
+  video_source_.IncomingCapturedFrame(create_unchanged_frame(4));
+  ExpectDroppedFrame();
+
+  // Unchanged frames are still encoded once a second.
+  fake_clock_.AdvanceTimeMicros(rtc::kNumMicrosecsPerSec);
+  video_source_.IncomingCapturedFrame(create_unchanged_frame(5));
+  WaitForEncodedFrame(5);
+  video_source_.IncomingCapturedFrame(create_unchanged_frame(6));
+  ExpectDroppedFrame();
+
+  // And when a key frame is requested.
+  video_stream_encoder_->SendKeyFrame();
+  video_source_.IncomingCapturedFrame(create_unchanged_frame(7));
+  WaitForEncodedFrame(7);
+
+  video_source_.IncomingCapturedFrame(CreateFrame(8, nullptr));
+  WaitForEncodedFrame(8);
+  video_stream_encoder_->Stop();
+}
+
+TEST_F(VideoStreamEncoderTest, EncodesUnchangedRealtimeVideoFrames) {
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  for (int64_t i = 1; i <= 5; ++i) {
+    VideoFrame frame = CreateFrame(i, nullptr);
+    frame.set_update_rect(VideoFrame::UpdateRect{0, 0, 0, 0});
+    video_source_.IncomingCapturedFrame(frame);
+    WaitForEncodedFrame(i);
+  }
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest,
        ConfigureEncoderTriggersOnEncoderConfigurationChanged) {
   video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
@@ -1101,6 +1210,58 @@ TEST_F(VideoStreamEncoderTest, StatsTracksCpuAdaptationStats) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, SpeedsUpEncoderBeforeCpuAdaptingResolution) {
+  video_send_config_.encoder_settings.encoder_speed_adaptation = true;
+  ConfigureEncoder(video_encoder_config_.Copy());
+  fake_encoder_.SetMaxSpeedSteps(2);
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  const int kWidth = 1280;
+  const int kHeight = 720;
+  video_source_.IncomingCapturedFrame(CreateFrame(1, kWidth, kHeight));
+  WaitForEncodedFrame(1);
+
+  // The encoder is sped up as long as it can be.
+  video_stream_encoder_->TriggerCpuOveruse();
+  video_stream_encoder_->TriggerCpuOveruse();
+  EXPECT_EQ(2, fake_encoder_.speed_steps());
+  VerifyNoLimitation(video_source_.sink_wants());
+  EXPECT_FALSE(stats_proxy_->GetStats().cpu_limited_resolution);
+
+  // Then the resolution is reduced.
+  video_stream_encoder_->TriggerCpuOveruse();
+  video_source_.IncomingCapturedFrame(CreateFrame(2, kWidth, kHeight));
+  WaitForEncodedFrame(2);
+  VerifyFpsMaxResolutionLt(video_source_.sink_wants(), kWidth * kHeight);
+  EXPECT_TRUE(stats_proxy_->GetStats().cpu_limited_resolution);
+
+  // The resolution is restored before the encoder is slowed down.
+  video_stream_encoder_->TriggerCpuNormalUsage();
+  VerifyNoLimitation(video_source_.sink_wants());
+  EXPECT_EQ(2, fake_encoder_.speed_steps());
+  video_stream_encoder_->TriggerCpuNormalUsage();
+  video_stream_encoder_->TriggerCpuNormalUsage();
+  EXPECT_EQ(0, fake_encoder_.speed_steps());
+
+  video_stream_encoder_->Stop();
+}
+
+TEST_F(VideoStreamEncoderTest, DoesNotSpeedUpEncoderByDefault) {
+  fake_encoder_.SetMaxSpeedSteps(2);
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  const int kWidth = 1280;
+  const int kHeight = 720;
+  video_source_.IncomingCapturedFrame(CreateFrame(1, kWidth, kHeight));
+  WaitForEncodedFrame(1);
+
+  video_stream_encoder_->TriggerCpuOveruse();
+  EXPECT_EQ(0, fake_encoder_.speed_steps());
+  VerifyFpsMaxResolutionLt(video_source_.sink_wants(), kWidth * kHeight);
+
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, SwitchingSourceKeepsCpuAdaptation) {
   video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
 
@@ -2070,6 +2231,38 @@ TEST_F(VideoStreamEncoderTest, CallsBitrateObserver) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, SetActiveLayersPausesLayersWithoutReconfigure) {
+  ResetEncoder("VP8", 2, 1, 1, false);
+  MockBitrateObserver bitrate_observer;
+  VideoBitrateAllocation allocation;
+  EXPECT_CALL(bitrate_observer, OnBitrateAllocationUpdated(_))
+      .WillRepeatedly(::testing::SaveArg<0>(&allocation));
+  video_stream_encoder_->SetBitrateAllocationObserver(&bitrate_observer);
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+  video_source_.IncomingCapturedFrame(
+      CreateFrame(1, codec_width_, codec_height_));
+  WaitForEncodedFrame(1);
+  EXPECT_GT(allocation.GetSpatialLayerSum(0), 0u);
+  EXPECT_GT(allocation.GetSpatialLayerSum(1), 0u);
+  const int num_reconfigurations = sink_.number_of_reconfigurations();
+
+  video_stream_encoder_->SetActiveLayers({false, true});
+  video_source_.IncomingCapturedFrame(
+      CreateFrame(2, codec_width_, codec_height_));
+  WaitForEncodedFrame(2);
+  EXPECT_EQ(0u, allocation.GetSpatialLayerSum(0));
+  EXPECT_GT(allocation.GetSpatialLayerSum(1), 0u);
+
+  video_stream_encoder_->SetActiveLayers({true, true});
+  video_source_.IncomingCapturedFrame(
+      CreateFrame(3, codec_width_, codec_height_));
+  WaitForEncodedFrame(3);
+  EXPECT_GT(allocation.GetSpatialLayerSum(0), 0u);
+  EXPECT_EQ(num_reconfigurations, sink_.number_of_reconfigurations());
+
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, OveruseDetectorUpdatedOnReconfigureAndAdaption) {
   const int kFrameWidth = 1280;
   const int kFrameHeight = 720;